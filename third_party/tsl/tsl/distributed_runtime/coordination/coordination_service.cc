@@ -93,6 +93,15 @@ struct CoordinatedTaskEqual {
   }
 };
 
+// Returns a fingerprint of `tasks` that does not depend on their order.
+uint64_t TasksFingerprint(const std::vector<CoordinatedTask>& tasks) {
+  uint64_t fingerprint = 0;
+  for (const CoordinatedTask& task : tasks) {
+    fingerprint += CoordinatedTaskHash()(task);
+  }
+  return fingerprint;
+}
+
 // Standalone implementation of the coordination service.
 class CoordinationServiceStandaloneImpl : public CoordinationServiceInterface {
  public:
@@ -162,17 +171,19 @@ class CoordinationServiceStandaloneImpl : public CoordinationServiceInterface {
     absl::flat_hash_map<CoordinatedTask, bool, CoordinatedTaskHash,
                         CoordinatedTaskEqual>
         tasks_at_barrier;
+    // Order-independent fingerprint of the participating tasks, to validate
+    // the tasks specified by each call in constant time.
+    uint64_t tasks_fingerprint = 0;
     std::vector<StatusCallback> done_callbacks;
   };
   void PassBarrier(absl::string_view barrier_id, Status result,
                    BarrierState* barrier)
       TF_EXCLUSIVE_LOCKS_REQUIRED(state_mu_);
   // Check if participating tasks are specified correctly across barrier calls.
-  bool ValidateTaskArgs(
-      const std::vector<CoordinatedTask>& tasks_args,
-      const absl::flat_hash_map<CoordinatedTask, bool, CoordinatedTaskHash,
-                                CoordinatedTaskEqual>& tasks_at_barrier,
-      int64_t cluster_size);
+  // `tasks_fingerprint` is the TasksFingerprint() of `tasks_args`.
+  bool ValidateTaskArgs(const std::vector<CoordinatedTask>& tasks_args,
+                        uint64_t tasks_fingerprint,
+                        const BarrierState& barrier, int64_t cluster_size);
   bool isRecoverableJob(absl::string_view task_name) const;
 
   class TaskState {
@@ -483,8 +494,13 @@ void CoordinationServiceStandaloneImpl::StartCheckStaleness() {
 
 void CoordinationServiceStandaloneImpl::Stop(bool shut_staleness_thread) {
   {
-    mutex_lock l(kv_mu_);
-    for (const auto& [key, get_kv_callbacks] : get_cb_) {
+    absl::flat_hash_map<std::string, std::vector<StatusOrValueCallback>>
+        get_cb;
+    {
+      mutex_lock l(kv_mu_);
+      std::swap(get_cb, get_cb_);
+    }
+    for (const auto& [key, get_kv_callbacks] : get_cb) {
       for (const auto& get_kv_callback : get_kv_callbacks) {
         get_kv_callback(errors::Cancelled(
             absl::StrCat("Coordination service is shutting down. Cancelling "
@@ -492,7 +508,6 @@ void CoordinationServiceStandaloneImpl::Stop(bool shut_staleness_thread) {
                          key)));
       }
     }
-    get_cb_.clear();
   }
   {
     mutex_lock l(state_mu_);
@@ -882,18 +897,25 @@ Status CoordinationServiceStandaloneImpl::InsertKeyValue(
     const std::string& key, const std::string& value) {
   VLOG(3) << "InsertKeyValue(): " << key << ": " << value;
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
-  if (kv_store_.find(norm_key) != kv_store_.end()) {
-    return MakeCoordinationError(
-        errors::AlreadyExists("Config key ", key, " already exists."));
-  }
-  kv_store_.emplace(norm_key, value);
-  auto iter = get_cb_.find(norm_key);
-  if (iter != get_cb_.end()) {
-    for (const auto& cb : iter->second) {
-      cb(value);
+  std::vector<StatusOrValueCallback> callbacks;
+  {
+    mutex_lock l(kv_mu_);
+    if (kv_store_.find(norm_key) != kv_store_.end()) {
+      return MakeCoordinationError(
+          errors::AlreadyExists("Config key ", key, " already exists."));
+    }
+    kv_store_.emplace(norm_key, value);
+    auto iter = get_cb_.find(norm_key);
+    if (iter != get_cb_.end()) {
+      callbacks = std::move(iter->second);
+      get_cb_.erase(iter);
     }
-    get_cb_.erase(iter);
+  }
+  // Respond to the pending requests without holding kv_mu_, so that other
+  // key-value operations are not serialized behind the responses when many
+  // tasks wait for the same key.
+  for (const auto& cb : callbacks) {
+    cb(value);
   }
   return OkStatus();
 }
@@ -902,18 +924,17 @@ void CoordinationServiceStandaloneImpl::GetKeyValueAsync(
     const std::string& key, StatusOrValueCallback done) {
   VLOG(3) << "GetKeyValue(): " << key;
   const std::string& norm_key = NormalizeKey(key);
-  mutex_lock l(kv_mu_);
-  const auto& iter = kv_store_.find(norm_key);
-  if (iter != kv_store_.end()) {
-    done(iter->second);
-    return;
-  }
-  auto cb_iter = get_cb_.find(norm_key);
-  if (cb_iter == get_cb_.end()) {
-    cb_iter =
-        get_cb_.emplace(norm_key, std::vector<StatusOrValueCallback>()).first;
+  std::string value;
+  {
+    mutex_lock l(kv_mu_);
+    const auto& iter = kv_store_.find(norm_key);
+    if (iter == kv_store_.end()) {
+      get_cb_[norm_key].emplace_back(std::move(done));
+      return;
+    }
+    value = iter->second;
   }
-  cb_iter->second.emplace_back(std::move(done));
+  done(value);
 }
 
 StatusOr<std::string> CoordinationServiceStandaloneImpl::TryGetKeyValue(
@@ -1000,6 +1021,9 @@ void CoordinationServiceStandaloneImpl::BarrierAsync(
     StatusCallback done) {
   VLOG(3) << "Task " << GetTaskName(task) << "invoked BarrierAsync("
           << barrier_id << ").";
+  // Hash the participating tasks before taking the lock, as each of the
+  // tasks calls the barrier with the same list.
+  const uint64_t tasks_fingerprint = TasksFingerprint(participating_tasks);
   mutex_lock l(state_mu_);
   auto pair = barriers_.try_emplace(barrier_id);
   auto it = pair.first;
@@ -1013,7 +1037,9 @@ void CoordinationServiceStandaloneImpl::BarrierAsync(
     if (participating_tasks.empty()) {
       for (const auto& task_state : cluster_state_) {
         absl::string_view task_name = task_state.first;
-        barrier->tasks_at_barrier[GetTaskFromName(task_name)] = false;
+        const CoordinatedTask cluster_task = GetTaskFromName(task_name);
+        barrier->tasks_at_barrier[cluster_task] = false;
+        barrier->tasks_fingerprint += CoordinatedTaskHash()(cluster_task);
       }
     } else {
       for (const auto& task : participating_tasks) {
@@ -1032,6 +1058,7 @@ void CoordinationServiceStandaloneImpl::BarrierAsync(
         }
         barrier->tasks_at_barrier[task] = false;
       }
+      barrier->tasks_fingerprint = tasks_fingerprint;
     }
     barrier->num_pending_tasks = barrier->tasks_at_barrier.size();
 
@@ -1098,7 +1125,7 @@ void CoordinationServiceStandaloneImpl::BarrierAsync(
   }
 
   // Check if task args are specified consistently across barrier calls.
-  if (!ValidateTaskArgs(participating_tasks, barrier->tasks_at_barrier,
+  if (!ValidateTaskArgs(participating_tasks, tasks_fingerprint, *barrier,
                         cluster_state_.size())) {
     Status error = MakeCoordinationError(errors::InvalidArgument(absl::StrCat(
         "Conflicting tasks specified for the same barrier: ", barrier_id)));
@@ -1204,23 +1231,15 @@ void CoordinationServiceStandaloneImpl::PassBarrier(
 }
 
 bool CoordinationServiceStandaloneImpl::ValidateTaskArgs(
-
-    const std::vector<CoordinatedTask>& tasks_args,
-    const absl::flat_hash_map<CoordinatedTask, bool, CoordinatedTaskHash,
-                              CoordinatedTaskEqual>& tasks_at_barrier,
-    int64_t cluster_size) {
+    const std::vector<CoordinatedTask>& tasks_args, uint64_t tasks_fingerprint,
+    const BarrierState& barrier, int64_t cluster_size) {
   if (tasks_args.empty()) {
-    return tasks_at_barrier.size() == cluster_size;
-  } else if (tasks_at_barrier.size() != tasks_args.size()) {
-    return false;
-  } else {
-    for (const auto& task : tasks_args) {
-      if (!tasks_at_barrier.contains(task)) {
-        return false;
-      }
-    }
+    return barrier.tasks_at_barrier.size() == cluster_size;
   }
-  return true;
+  // Comparing the fingerprints instead of looking up every task keeps the
+  // barrier linear in the number of tasks.
+  return barrier.tasks_at_barrier.size() == tasks_args.size() &&
+         barrier.tasks_fingerprint == tasks_fingerprint;
 }
 
 void CoordinationServiceStandaloneImpl::AggregateClusterDevices() {
@@ -545,6 +545,32 @@ TEST_F(CoordinateTwoTasksTest, TestSetGetValues) {
   EXPECT_FALSE(n4->HasBeenNotified());
 }
 
+TEST_F(CoordinateTwoTasksTest, GetKeyValueCallbacksCanAccessStore) {
+  EnableCoordinationService();
+
+  // Callbacks run without the key-value lock held, so they may use the store.
+  absl::Notification n;
+  StatusOr<std::string> ret;
+  coord_service_->GetKeyValueAsync(
+      "key0", [&](const StatusOr<std::string>& status_or_value) {
+        TF_EXPECT_OK(coord_service_->InsertKeyValue("key1", "value1"));
+        ret = coord_service_->TryGetKeyValue("key0");
+        n.Notify();
+      });
+  TF_ASSERT_OK(coord_service_->InsertKeyValue("key0", "value0"));
+  n.WaitForNotification();
+  EXPECT_EQ(ret.value(), "value0");
+
+  absl::Notification n2;
+  coord_service_->GetKeyValueAsync(
+      "key1", [&](const StatusOr<std::string>& status_or_value) {
+        ret = coord_service_->TryGetKeyValue("key0");
+        n2.Notify();
+      });
+  n2.WaitForNotification();
+  EXPECT_EQ(ret.value(), "value0");
+}
+
 TEST(CoordinationServiceTest, TryGetKeyValue) {
   const CoordinationServiceConfig config =
       GetCoordinationServiceConfig(/*num_tasks=*/1);
@@ -910,6 +936,25 @@ TEST_F(CoordinationBarrierTest, BarrierWithSubsetOfTasks) {
   TF_EXPECT_OK(barrier_status_1);
 }
 
+TEST_F(CoordinationBarrierTest, BarrierWithTasksInDifferentOrder) {
+  const std::string barrier_id = "barrier_id";
+  absl::Duration timeout = absl::Seconds(5);
+  Status barrier_status_0;
+  Status barrier_status_1;
+
+  GetCoordinationService()->BarrierAsync(
+      barrier_id, timeout, GetTask(0),
+      /*participating_tasks=*/{GetTask(0), GetTask(1)},
+      [&barrier_status_0](Status s) { barrier_status_0 = s; });
+  GetCoordinationService()->BarrierAsync(
+      barrier_id, timeout, GetTask(1),
+      /*participating_tasks=*/{GetTask(1), GetTask(0)},
+      [&barrier_status_1](Status s) { barrier_status_1 = s; });
+
+  TF_EXPECT_OK(barrier_status_0);
+  TF_EXPECT_OK(barrier_status_1);
+}
+
 TEST_F(CoordinationBarrierTest, BarrierWithMismatchedTasks) {
   const std::string barrier_id = "barrier_id";
   absl::Duration timeout = absl::Seconds(5);
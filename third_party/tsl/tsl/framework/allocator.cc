@@ -28,7 +28,7 @@ limitations under the License.
 namespace tsl {
 
 string AllocatorStats::DebugString() const {
-  return strings::Printf(
+  string result = strings::Printf(
       "Limit:            %20lld\n"
       "InUse:            %20lld\n"
       "MaxInUse:         %20lld\n"
@@ -45,6 +45,11 @@ string AllocatorStats::DebugString() const {
       static_cast<long long>(this->bytes_reserved),
       static_cast<long long>(this->peak_bytes_reserved),
       static_cast<long long>(this->largest_free_block_bytes));
+  if (this->fragmentation_metric) {
+    strings::Appendf(&result, "Fragmentation:    %20.4f\n",
+                     *this->fragmentation_metric);
+  }
+  return result;
 }
 
 constexpr size_t Allocator::kAllocatorAlignment;
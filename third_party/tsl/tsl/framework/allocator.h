@@ -93,6 +93,11 @@ struct AllocatorStats {
   std::optional<int64_t> pool_bytes;
   std::optional<int64_t> peak_pool_bytes;
 
+  // External fragmentation of the free memory held by the allocator, within
+  // [0, 1]: 0 if all free memory is in one block, approaching 1 if it is
+  // scattered over many small blocks. Only set by pooling allocators.
+  std::optional<double> fragmentation_metric;
+
   AllocatorStats()
       : num_allocs(0),
         bytes_in_use(0),
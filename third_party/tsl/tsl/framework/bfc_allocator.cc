@@ -511,6 +511,10 @@ int64_t BFCAllocator::LargestFreeChunk() {
 double BFCAllocator::GetFragmentation() {
   int64_t bytes_available = *stats_.pool_bytes - stats_.bytes_in_use;
   DCHECK_GE(bytes_available, 0);
+  if (bytes_available <= 0) {
+    // A pool without free memory is not fragmented.
+    return 0.0;
+  }
   return static_cast<double>(bytes_available - LargestFreeChunk()) /
          bytes_available;
 }
@@ -1207,7 +1211,10 @@ MemoryDump BFCAllocator::RecordMemoryMapInternal() {
 
 absl::optional<AllocatorStats> BFCAllocator::GetStats() {
   mutex_lock l(lock_);
-  return stats_;
+  AllocatorStats stats = stats_;
+  stats.largest_free_block_bytes = LargestFreeChunk();
+  stats.fragmentation_metric = GetFragmentation();
+  return stats;
 }
 
 bool BFCAllocator::ClearStats() {
@@ -20,6 +20,11 @@ limitations under the License.
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "tsl/platform/mutex.h"
 #include "tsl/platform/raw_coding.h"
 
@@ -159,6 +164,73 @@ class HandleTable {
   }
 };
 
+// Estimates the access frequencies of the recent keys, for the TinyLFU
+// admission policy described in:
+// Einziger, Gil, Roy Friedman, and Ben Manes. "TinyLFU: A highly efficient
+// cache admission policy." ACM Transactions on Storage 13.4 (2017): 1-31.
+//
+// This is a count-min sketch with kDepth rows of saturating 4-bit counters.
+// All counters are halved after every 10 * width increments, so that the
+// estimates follow the recent accesses.
+class FrequencySketch {
+ public:
+  explicit FrequencySketch(size_t expected_entries) : width_bits_(4) {
+    while ((size_t{1} << width_bits_) < expected_entries && width_bits_ < 24) {
+      width_bits_++;
+    }
+    counters_.assign(size_t{kDepth} << width_bits_, 0);
+    sample_size_ = size_t{10} << width_bits_;
+  }
+
+  void Increment(uint32_t hash) {
+    bool incremented = false;
+    for (int i = 0; i < kDepth; i++) {
+      uint8_t& counter = counters_[Index(hash, i)];
+      if (counter < kMaxCount) {
+        counter++;
+        incremented = true;
+      }
+    }
+    if (incremented && ++additions_ >= sample_size_) {
+      Reset();
+    }
+  }
+
+  int Estimate(uint32_t hash) const {
+    int estimate = kMaxCount;
+    for (int i = 0; i < kDepth; i++) {
+      estimate = std::min<int>(estimate, counters_[Index(hash, i)]);
+    }
+    return estimate;
+  }
+
+ private:
+  static constexpr int kDepth = 4;
+  static constexpr int kMaxCount = 15;
+
+  size_t Index(uint32_t hash, int row) const {
+    // Odd multipliers, one per row. The high bits of the hash select the
+    // shard, so they are first mixed into the low bits.
+    static constexpr uint32_t kSeeds[kDepth] = {0x97cb3127, 0xab5b8c5b,
+                                                0x65d5e7ab, 0xc7b7a6a5};
+    const uint32_t h = (hash ^ (hash >> 16)) * kSeeds[row];
+    return (static_cast<size_t>(row) << width_bits_) +
+           (h >> (32 - width_bits_));
+  }
+
+  void Reset() {
+    for (uint8_t& counter : counters_) {
+      counter >>= 1;
+    }
+    additions_ /= 2;
+  }
+
+  int width_bits_;
+  std::vector<uint8_t> counters_;
+  size_t sample_size_;
+  size_t additions_ = 0;
+};
+
 // A single shard of sharded cache.
 class LRUCache {
  public:
@@ -168,6 +240,12 @@ class LRUCache {
   // Separate from constructor so caller can easily make an array of LRUCache
   void SetCapacity(size_t capacity) { capacity_ = capacity; }
 
+  // Enables the TinyLFU admission policy.
+  void SetAdmissionPolicy(size_t expected_entries) {
+    mutex_lock l(mutex_);
+    sketch_ = std::make_unique<FrequencySketch>(expected_entries);
+  }
+
   // Like Cache methods, but with an extra "hash" parameter.
   Cache::Handle* Insert(const Slice& key, uint32_t hash, void* value,
                         size_t charge,
@@ -187,6 +265,10 @@ class LRUCache {
   void Ref(LRUHandle* e);
   void Unref(LRUHandle* e);
   bool FinishErase(LRUHandle* e) TF_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Returns whether a new entry should be cached, according to the admission
+  // policy.  Entries replacing a cached entry with the same key are admitted.
+  bool Admit(const Slice& key, uint32_t hash, size_t charge)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   // Initialized before use.
   size_t capacity_;
@@ -205,6 +287,9 @@ class LRUCache {
   LRUHandle in_use_ TF_GUARDED_BY(mutex_);
 
   HandleTable table_ TF_GUARDED_BY(mutex_);
+
+  // Access frequencies of the keys, if the admission policy is enabled.
+  std::unique_ptr<FrequencySketch> sketch_ TF_GUARDED_BY(mutex_);
 };
 
 LRUCache::LRUCache() : capacity_(0), usage_(0) {
@@ -264,6 +349,9 @@ void LRUCache::LRU_Append(LRUHandle* list, LRUHandle* e) {
 
 Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash) {
   mutex_lock l(mutex_);
+  if (sketch_ != nullptr) {
+    sketch_->Increment(hash);
+  }
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     Ref(e);
@@ -293,7 +381,10 @@ Cache::Handle* LRUCache::Insert(const Slice& key, uint32_t hash, void* value,
   e->refs = 1;  // for the returned handle.
   memcpy(e->key_data, key.data(), key.size());
 
-  if (capacity_ > 0) {
+  if (sketch_ != nullptr) {
+    sketch_->Increment(hash);
+  }
+  if (capacity_ > 0 && Admit(key, hash, charge)) {
     e->refs++;  // for the cache's reference.
     e->in_cache = true;
     LRU_Append(&in_use_, e);
@@ -315,6 +406,25 @@ Cache::Handle* LRUCache::Insert(const Slice& key, uint32_t hash, void* value,
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
+bool LRUCache::Admit(const Slice& key, uint32_t hash, size_t charge) {
+  if (sketch_ == nullptr || usage_ + charge <= capacity_ ||
+      table_.Lookup(key, hash) != nullptr) {
+    return true;
+  }
+  // The entry is only admitted if it is accessed more often than each of the
+  // least recently used entries that are evicted to make room for it.
+  const int frequency = sketch_->Estimate(hash);
+  size_t usage = usage_ + charge;
+  for (LRUHandle* e = lru_.next; e != &lru_ && usage > capacity_;
+       e = e->next) {
+    if (sketch_->Estimate(e->hash) >= frequency) {
+      return false;
+    }
+    usage -= e->charge;
+  }
+  return true;
+}
+
 // If e != nullptr, finish removing *e from the cache; it has already been
 // removed from the hash table.  Return whether e != nullptr.
 bool LRUCache::FinishErase(LRUHandle* e) {
@@ -345,12 +455,13 @@ void LRUCache::Prune() {
   }
 }
 
-static const int kNumShardBits = 4;
-static const int kNumShards = 1 << kNumShardBits;
+static const int kMaxNumShardBits = 16;
 
 class ShardedLRUCache : public Cache {
  private:
-  LRUCache shard_[kNumShards];
+  const int num_shard_bits_;
+  const int num_shards_;
+  std::unique_ptr<LRUCache[]> shard_;
   mutex id_mutex_;
   uint64_t last_id_;
 
@@ -358,13 +469,24 @@ class ShardedLRUCache : public Cache {
     return Hash(s.data(), s.size(), 0);
   }
 
-  static uint32_t Shard(uint32_t hash) { return hash >> (32 - kNumShardBits); }
+  uint32_t Shard(uint32_t hash) const {
+    return num_shard_bits_ > 0 ? hash >> (32 - num_shard_bits_) : 0;
+  }
 
  public:
-  explicit ShardedLRUCache(size_t capacity) : last_id_(0) {
-    const size_t per_shard = (capacity + (kNumShards - 1)) / kNumShards;
-    for (int s = 0; s < kNumShards; s++) {
+  explicit ShardedLRUCache(const CacheOptions& options)
+      : num_shard_bits_(
+            std::clamp(options.num_shard_bits, 0, kMaxNumShardBits)),
+        num_shards_(1 << num_shard_bits_),
+        shard_(new LRUCache[num_shards_]),
+        last_id_(0) {
+    const size_t per_shard =
+        (options.capacity + (num_shards_ - 1)) / num_shards_;
+    for (int s = 0; s < num_shards_; s++) {
       shard_[s].SetCapacity(per_shard);
+      if (options.use_admission_policy) {
+        shard_[s].SetAdmissionPolicy(options.expected_entries_per_shard);
+      }
     }
   }
   ~ShardedLRUCache() override {}
@@ -393,13 +515,13 @@ class ShardedLRUCache : public Cache {
     return ++(last_id_);
   }
   void Prune() override {
-    for (int s = 0; s < kNumShards; s++) {
+    for (int s = 0; s < num_shards_; s++) {
       shard_[s].Prune();
     }
   }
   size_t TotalCharge() const override {
     size_t total = 0;
-    for (int s = 0; s < kNumShards; s++) {
+    for (int s = 0; s < num_shards_; s++) {
       total += shard_[s].TotalCharge();
     }
     return total;
@@ -443,7 +565,15 @@ class ShardedLRUCache : public Cache {
 
 }  // end anonymous namespace
 
-Cache* NewLRUCache(size_t capacity) { return new ShardedLRUCache(capacity); }
+Cache* NewLRUCache(size_t capacity) {
+  CacheOptions options;
+  options.capacity = capacity;
+  return NewCache(options);
+}
+
+Cache* NewCache(const CacheOptions& options) {
+  return new ShardedLRUCache(options);
+}
 
 }  // namespace table
 
@@ -29,9 +29,10 @@ limitations under the License.
 // the string.
 //
 // A builtin cache implementation with a least-recently-used eviction
-// policy is provided.  Clients may use their own implementations if
-// they want something more sophisticated (like scan-resistance, a
-// custom eviction policy, variable cache sizing, etc.)
+// policy is provided, optionally with a frequency-based admission policy
+// for scan-resistance.  Clients may use their own implementations if
+// they want something more sophisticated (like a custom eviction policy,
+// variable cache sizing, etc.)
 
 namespace tsl {
 
@@ -45,6 +46,32 @@ class Cache;
 // of Cache uses a least-recently-used eviction policy.
 Cache* NewLRUCache(size_t capacity);
 
+// Options of the caches created by NewCache().
+struct CacheOptions {
+  // Combined charge of the entries above which entries are evicted.
+  size_t capacity = 0;
+
+  // The cache is split into 2^num_shard_bits shards, each with its own lock
+  // and an equal share of the capacity.  More shards reduce the contention
+  // between threads, at the cost of a less precise eviction order.
+  int num_shard_bits = 4;
+
+  // Whether a new entry is only cached if its key was accessed more often
+  // than the least recently used entries it would evict (TinyLFU).  The
+  // access frequencies of the recent keys, cached or not, are estimated with
+  // a small sketch.  This keeps the hot entries of workloads that also scan
+  // many keys once, which would otherwise flush the cache.
+  bool use_admission_policy = false;
+
+  // The number of entries a shard is expected to hold, which sizes the
+  // frequency sketch of the admission policy.
+  size_t expected_entries_per_shard = 1024;
+};
+
+// Create a new cache with the given options.  NewLRUCache(capacity) is the
+// same as NewCache({capacity}).
+Cache* NewCache(const CacheOptions& options);
+
 class Cache {
  public:
   Cache() = default;
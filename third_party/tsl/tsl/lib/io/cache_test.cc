@@ -235,5 +235,70 @@ TEST_F(CacheTest, ZeroSizeCache) {
   ASSERT_EQ(-1, Lookup(1));
 }
 
+TEST_F(CacheTest, SingleShard) {
+  delete cache_;
+  CacheOptions options;
+  options.capacity = 10;
+  options.num_shard_bits = 0;
+  cache_ = NewCache(options);
+
+  for (int i = 0; i < 10; i++) {
+    Insert(i, 100 + i);
+  }
+  ASSERT_EQ(100, Lookup(0));
+
+  // With a single shard, the least recently used entry is evicted.
+  Insert(10, 110);
+  ASSERT_EQ(100, Lookup(0));
+  ASSERT_EQ(-1, Lookup(1));
+  ASSERT_EQ(102, Lookup(2));
+  ASSERT_EQ(110, Lookup(10));
+  ASSERT_EQ(10, cache_->TotalCharge());
+}
+
+TEST_F(CacheTest, AdmissionPolicyKeepsHotEntries) {
+  delete cache_;
+  CacheOptions options;
+  options.capacity = 100;
+  options.num_shard_bits = 0;
+  options.use_admission_policy = true;
+  options.expected_entries_per_shard = 100;
+  cache_ = NewCache(options);
+
+  const int kNumHotKeys = 50;
+  for (int i = 0; i < kNumHotKeys; i++) {
+    Insert(i, 100 + i);
+  }
+
+  // Scan many keys once, while accessing the hot keys. A plain LRU cache
+  // would evict the hot entries between two of their accesses. Once the
+  // frequencies of the hot keys are established, they are not evicted.
+  const int kWarmup = 4 * kNumHotKeys;
+  int hot_misses = 0;
+  for (int i = 0; i < 10000; i++) {
+    for (int key : {1000 + 2 * i, 1001 + 2 * i}) {
+      if (Lookup(key) == -1) {
+        Insert(key, key);
+      }
+    }
+    const int hot_key = i % kNumHotKeys;
+    if (Lookup(hot_key) == -1) {
+      if (i >= kWarmup) {
+        hot_misses++;
+      }
+      Insert(hot_key, 100 + hot_key);
+    }
+  }
+  ASSERT_EQ(0, hot_misses);
+  for (int i = 0; i < kNumHotKeys; i++) {
+    ASSERT_EQ(100 + i, Lookup(i));
+  }
+  ASSERT_LE(cache_->TotalCharge(), options.capacity);
+
+  // Entries replacing a cached entry are always admitted.
+  Insert(0, 200);
+  ASSERT_EQ(200, Lookup(0));
+}
+
 }  // namespace table
 }  // namespace tsl
@@ -0,0 +1,255 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tsl/lib/io/parallel_record_reader.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tsl/lib/hash/crc32c.h"
+#include "tsl/lib/io/record_reader.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/raw_coding.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+constexpr size_t kHeaderSize = RecordReader::kHeaderSize;
+constexpr size_t kFooterSize = RecordReader::kFooterSize;
+
+// The data of a record within a chunk.
+struct RecordSpan {
+  size_t offset;
+  size_t length;
+};
+
+// Parses the complete records at the start of `data`, which is at `offset` in
+// the file, and checks the checksums of their lengths. Sets `*end` to the end
+// of the last complete record and, if the header of the following record is
+// in `data`, `*next_size` to its size (and to 0 otherwise).
+Status ParseRecords(uint64 offset, const std::string& data,
+                    std::vector<RecordSpan>* records, size_t* end,
+                    size_t* next_size) {
+  *end = 0;
+  *next_size = 0;
+  while (data.size() - *end >= kHeaderSize) {
+    const char* header = data.data() + *end;
+    const uint32 masked_crc = core::DecodeFixed32(header + sizeof(uint64));
+    if (crc32c::Unmask(masked_crc) != crc32c::Value(header, sizeof(uint64))) {
+      return errors::DataLoss("corrupted record at ", offset + *end);
+    }
+    const uint64 length = core::DecodeFixed64(header);
+    if (length >= SIZE_MAX - kHeaderSize - kFooterSize) {
+      return errors::DataLoss("record size too large at ", offset + *end);
+    }
+    const size_t size = kHeaderSize + length + kFooterSize;
+    if (size > data.size() - *end) {
+      *next_size = size;
+      break;
+    }
+    records->push_back(RecordSpan{*end + kHeaderSize, length});
+    *end += size;
+  }
+  return OkStatus();
+}
+
+}  // namespace
+
+struct ParallelRecordReader::Chunk {
+  // Offset of `data` in the file.
+  uint64 offset = 0;
+  std::string data;
+  std::vector<RecordSpan> records;
+  // Status to return after the last record: OUT_OF_RANGE at the end of the
+  // file, an error if reading or parsing the chunk failed, OK otherwise.
+  Status end_status;
+
+  // Set under `mu_` once the checksums of the records have been verified. The
+  // first `num_verified` records are valid, and `verify_status` is the error
+  // of the next one.
+  bool verified = false;
+  size_t num_verified = 0;
+  Status verify_status;
+};
+
+ParallelRecordReader::ParallelRecordReader(
+    RandomAccessFile* file, thread::ThreadPool* thread_pool,
+    const ParallelRecordReaderOptions& options)
+    : file_(file), thread_pool_(thread_pool), options_(options) {
+  options_.chunk_size = std::max<int64_t>(options_.chunk_size, kHeaderSize);
+  options_.max_buffered_chunks = std::max(options_.max_buffered_chunks, 1);
+  mutex_lock lock(mu_);
+  MaybeScheduleReadLocked();
+}
+
+ParallelRecordReader::~ParallelRecordReader() {
+  mutex_lock lock(mu_);
+  cancelled_ = true;
+  while (num_pending_tasks_ > 0) {
+    cv_.wait(lock);
+  }
+}
+
+void ParallelRecordReader::MaybeScheduleReadLocked() {
+  if (reading_ || done_reading_ || cancelled_ ||
+      chunks_.size() >= static_cast<size_t>(options_.max_buffered_chunks)) {
+    return;
+  }
+  reading_ = true;
+  ++num_pending_tasks_;
+  uint64 offset = next_chunk_offset_;
+  thread_pool_->Schedule([this, offset] { ReadChunk(offset); });
+}
+
+void ParallelRecordReader::ReadChunk(uint64 offset) {
+  auto chunk = std::make_shared<Chunk>();
+  chunk->offset = offset;
+  size_t end = 0;
+  size_t n = options_.chunk_size;
+  while (true) {
+    chunk->data.resize(n);
+    StringPiece result;
+    Status s = file_->Read(offset, n, &result, &chunk->data[0]);
+    if (!s.ok() && !errors::IsOutOfRange(s)) {
+      chunk->data.clear();
+      chunk->end_status = s;
+      break;
+    }
+    if (result.data() != chunk->data.data()) {
+      std::memmove(&chunk->data[0], result.data(), result.size());
+    }
+    chunk->data.resize(result.size());
+    const bool eof = result.size() < n;
+
+    size_t next_size;
+    chunk->records.clear();
+    chunk->end_status =
+        ParseRecords(offset, chunk->data, &chunk->records, &end, &next_size);
+    if (!chunk->end_status.ok()) break;
+
+    if (eof) {
+      if (end < chunk->data.size()) {
+        chunk->end_status = errors::DataLoss("truncated record at ",
+                                             offset + end);
+      } else {
+        chunk->end_status = errors::OutOfRange("eof");
+      }
+      break;
+    }
+    if (!chunk->records.empty()) break;
+    // A single record is larger than the chunk: read it at once.
+    n = std::max(next_size, n + kHeaderSize);
+  }
+  // The partial record at the end is read again with the next chunk.
+  chunk->data.resize(end);
+
+  {
+    mutex_lock lock(mu_);
+    chunks_.push_back(chunk);
+    reading_ = false;
+    if (chunk->end_status.ok()) {
+      next_chunk_offset_ = offset + end;
+    } else {
+      done_reading_ = true;
+    }
+    MaybeScheduleReadLocked();
+    cv_.notify_all();
+  }
+
+  // Verify the checksums while the next chunk is read.
+  size_t num_verified = 0;
+  Status verify_status;
+  for (const RecordSpan& record : chunk->records) {
+    const char* data = chunk->data.data() + record.offset;
+    const uint32 masked_crc = core::DecodeFixed32(data + record.length);
+    if (crc32c::Unmask(masked_crc) != crc32c::Value(data, record.length)) {
+      verify_status = errors::DataLoss("corrupted record at ",
+                                       offset + record.offset - kHeaderSize);
+      break;
+    }
+    ++num_verified;
+  }
+
+  mutex_lock lock(mu_);
+  chunk->num_verified = num_verified;
+  chunk->verify_status = verify_status;
+  chunk->verified = true;
+  --num_pending_tasks_;
+  cv_.notify_all();
+}
+
+std::shared_ptr<ParallelRecordReader::Chunk> ParallelRecordReader::NextChunk(
+    bool wait_for_verification) {
+  mutex_lock lock(mu_);
+  while (true) {
+    while (chunks_.empty()) {
+      MaybeScheduleReadLocked();
+      cv_.wait(lock);
+    }
+    std::shared_ptr<Chunk> chunk = chunks_.front();
+    if (next_record_ >= chunk->records.size()) {
+      if (!chunk->end_status.ok()) return chunk;
+      chunks_.pop_front();
+      next_record_ = 0;
+      MaybeScheduleReadLocked();
+      continue;
+    }
+    while (wait_for_verification && !chunk->verified) {
+      cv_.wait(lock);
+    }
+    return chunk;
+  }
+}
+
+Status ParallelRecordReader::ReadRecord(tstring* record) {
+  std::shared_ptr<Chunk> chunk = NextChunk(/*wait_for_verification=*/true);
+  if (next_record_ >= chunk->records.size()) {
+    return chunk->end_status;
+  }
+  if (next_record_ >= chunk->num_verified) {
+    return chunk->verify_status;
+  }
+  const RecordSpan& span = chunk->records[next_record_++];
+  record->assign(chunk->data.data() + span.offset, span.length);
+  offset_ = chunk->offset + span.offset + span.length + kFooterSize;
+  return OkStatus();
+}
+
+Status ParallelRecordReader::SkipRecords(int num_to_skip, int* num_skipped) {
+  *num_skipped = 0;
+  while (*num_skipped < num_to_skip) {
+    std::shared_ptr<Chunk> chunk = NextChunk(/*wait_for_verification=*/false);
+    if (next_record_ >= chunk->records.size()) {
+      return chunk->end_status;
+    }
+    size_t n = std::min<size_t>(chunk->records.size() - next_record_,
+                                num_to_skip - *num_skipped);
+    next_record_ += n;
+    *num_skipped += n;
+    const RecordSpan& span = chunk->records[next_record_ - 1];
+    offset_ = chunk->offset + span.offset + span.length + kFooterSize;
+  }
+  return OkStatus();
+}
+
+}  // namespace io
+}  // namespace tsl
@@ -0,0 +1,121 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_TSL_LIB_IO_PARALLEL_RECORD_READER_H_
+#define TENSORFLOW_TSL_LIB_IO_PARALLEL_RECORD_READER_H_
+
+#include <deque>
+#include <memory>
+
+#include "tsl/platform/mutex.h"
+#include "tsl/platform/status.h"
+#include "tsl/platform/thread_annotations.h"
+#include "tsl/platform/threadpool.h"
+#include "tsl/platform/types.h"
+
+namespace tsl {
+class RandomAccessFile;
+
+namespace io {
+
+struct ParallelRecordReaderOptions {
+  // Number of bytes read from the file at once. Chunks are cut at the last
+  // record boundary, and extended if a single record does not fit.
+  int64_t chunk_size = 16 << 20;
+
+  // Maximum number of chunks read ahead of the records returned so far.
+  int max_buffered_chunks = 4;
+};
+
+// Reads uncompressed TFRecord files, reading ahead and verifying checksums on
+// a thread pool while records are returned.
+//
+// The file is read sequentially in chunks that end at record boundaries. As
+// soon as a chunk is read, the next read is scheduled, and the checksums of
+// the records of the chunk are verified. At most `max_buffered_chunks` chunks
+// are buffered; file reads resume as records are consumed.
+//
+// Compressed files are not supported, as compression is applied to the whole
+// stream and can't be decoded in parallel. Use SequentialRecordReader instead.
+//
+// Note: this class is not thread safe; external synchronization required.
+class ParallelRecordReader {
+ public:
+  // Create a reader that will return records from "*file", using
+  // "*thread_pool" to read and verify chunks. Both must remain live while this
+  // reader is in use.
+  ParallelRecordReader(RandomAccessFile* file, thread::ThreadPool* thread_pool,
+                       const ParallelRecordReaderOptions& options =
+                           ParallelRecordReaderOptions());
+
+  // Waits for the outstanding reads.
+  ~ParallelRecordReader();
+
+  // Read the next record in the file into *record. Returns OK on success,
+  // OUT_OF_RANGE for end of file, or something else for an error.
+  Status ReadRecord(tstring* record);
+
+  // Skip the next num_to_skip record in the file. Return OK on success,
+  // OUT_OF_RANGE for end of file, or something else for an error.
+  // "*num_skipped" records the number of records that are actually skipped.
+  // It should be equal to num_to_skip on success.
+  //
+  // Records are skipped using the offsets found while reading chunks, without
+  // verifying their checksums.
+  Status SkipRecords(int num_to_skip, int* num_skipped);
+
+  // Return the offset in the file of the next record.
+  uint64 TellOffset() const { return offset_; }
+
+ private:
+  struct Chunk;
+
+  // Schedules the read of the next chunk if there is room for it.
+  void MaybeScheduleReadLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Reads, parses and then verifies the chunk starting at `offset`.
+  void ReadChunk(uint64 offset);
+
+  // Returns the chunk holding the next record, or the chunk that ended the
+  // file (or failed) if there are no records left.
+  std::shared_ptr<Chunk> NextChunk(bool wait_for_verification);
+
+  RandomAccessFile* file_;
+  thread::ThreadPool* thread_pool_;
+  ParallelRecordReaderOptions options_;
+
+  // The record returned next is `next_record_` of the first chunk of
+  // `chunks_`, at `offset_` in the file. Only accessed by the caller thread.
+  size_t next_record_ = 0;
+  uint64 offset_ = 0;
+
+  mutable mutex mu_;
+  condition_variable cv_;
+  std::deque<std::shared_ptr<Chunk>> chunks_ TF_GUARDED_BY(mu_);
+  bool reading_ TF_GUARDED_BY(mu_) = false;
+  // Set once a chunk ended the file or failed, after which nothing is read.
+  bool done_reading_ TF_GUARDED_BY(mu_) = false;
+  uint64 next_chunk_offset_ TF_GUARDED_BY(mu_) = 0;
+  int num_pending_tasks_ TF_GUARDED_BY(mu_) = 0;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+
+  ParallelRecordReader(const ParallelRecordReader&) = delete;
+  void operator=(const ParallelRecordReader&) = delete;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // TENSORFLOW_TSL_LIB_IO_PARALLEL_RECORD_READER_H_
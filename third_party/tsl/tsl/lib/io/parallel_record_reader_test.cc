@@ -0,0 +1,162 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tsl/lib/io/parallel_record_reader.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/lib/io/record_reader.h"
+#include "tsl/lib/io/record_writer.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/status.h"
+#include "tsl/platform/strcat.h"
+#include "tsl/platform/test.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+std::vector<string> MakeRecords() {
+  std::vector<string> records;
+  for (int i = 0; i < 100; ++i) {
+    records.push_back(string(i * 7 % 150, 'a' + i % 26));
+  }
+  // Larger than the chunks used below.
+  records.push_back(string(1000, 'x'));
+  records.push_back("last");
+  return records;
+}
+
+string WriteRecords(const string& name, const std::vector<string>& records) {
+  Env* env = Env::Default();
+  string fname = strings::StrCat(testing::TmpDir(), "/", name);
+  std::unique_ptr<WritableFile> file;
+  TF_CHECK_OK(env->NewWritableFile(fname, &file));
+  RecordWriter writer(file.get());
+  for (const string& record : records) {
+    TF_CHECK_OK(writer.WriteRecord(record));
+  }
+  TF_CHECK_OK(writer.Close());
+  TF_CHECK_OK(file->Close());
+  return fname;
+}
+
+// Record offsets in a file written by WriteRecords.
+uint64 OffsetOf(const std::vector<string>& records, size_t index) {
+  uint64 offset = 0;
+  for (size_t i = 0; i < index; ++i) {
+    offset += RecordReader::kHeaderSize + records[i].size() +
+              RecordReader::kFooterSize;
+  }
+  return offset;
+}
+
+class ParallelRecordReaderTest : public ::testing::TestWithParam<int64_t> {
+ protected:
+  ParallelRecordReaderOptions Options() const {
+    ParallelRecordReaderOptions options;
+    options.chunk_size = GetParam();
+    options.max_buffered_chunks = 2;
+    return options;
+  }
+
+  thread::ThreadPool thread_pool_{Env::Default(), "test", 4};
+};
+
+TEST_P(ParallelRecordReaderTest, ReadsAllRecords) {
+  std::vector<string> records = MakeRecords();
+  string fname = WriteRecords("parallel_record_reader_read", records);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  ParallelRecordReader reader(file.get(), &thread_pool_, Options());
+  tstring record;
+  for (size_t i = 0; i < records.size(); ++i) {
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+    EXPECT_EQ(record, records[i]);
+    EXPECT_EQ(reader.TellOffset(), OffsetOf(records, i + 1));
+  }
+  EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&record)));
+  EXPECT_TRUE(errors::IsOutOfRange(reader.ReadRecord(&record)));
+}
+
+TEST_P(ParallelRecordReaderTest, SkipsRecords) {
+  std::vector<string> records = MakeRecords();
+  string fname = WriteRecords("parallel_record_reader_skip", records);
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  ParallelRecordReader reader(file.get(), &thread_pool_, Options());
+  int num_skipped;
+  TF_ASSERT_OK(reader.SkipRecords(37, &num_skipped));
+  EXPECT_EQ(num_skipped, 37);
+  EXPECT_EQ(reader.TellOffset(), OffsetOf(records, 37));
+
+  tstring record;
+  TF_ASSERT_OK(reader.ReadRecord(&record));
+  EXPECT_EQ(record, records[37]);
+
+  Status s = reader.SkipRecords(1000, &num_skipped);
+  EXPECT_TRUE(errors::IsOutOfRange(s));
+  EXPECT_EQ(num_skipped, static_cast<int>(records.size()) - 38);
+}
+
+TEST_P(ParallelRecordReaderTest, ReportsCorruptedRecords) {
+  std::vector<string> records = MakeRecords();
+  string fname = WriteRecords("parallel_record_reader_corrupted", records);
+  string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), fname, &contents));
+  // Flip a bit in the data of record 10.
+  contents[OffsetOf(records, 10) + RecordReader::kHeaderSize] ^= 1;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), fname, contents));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  ParallelRecordReader reader(file.get(), &thread_pool_, Options());
+  tstring record;
+  for (int i = 0; i < 10; ++i) {
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+  }
+  EXPECT_TRUE(errors::IsDataLoss(reader.ReadRecord(&record)));
+}
+
+TEST_P(ParallelRecordReaderTest, ReportsTruncatedFiles) {
+  std::vector<string> records = MakeRecords();
+  string fname = WriteRecords("parallel_record_reader_truncated", records);
+  string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), fname, &contents));
+  contents.resize(contents.size() - 2);
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), fname, contents));
+  std::unique_ptr<RandomAccessFile> file;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file));
+
+  ParallelRecordReader reader(file.get(), &thread_pool_, Options());
+  tstring record;
+  for (size_t i = 0; i + 1 < records.size(); ++i) {
+    TF_ASSERT_OK(reader.ReadRecord(&record));
+  }
+  EXPECT_TRUE(errors::IsDataLoss(reader.ReadRecord(&record)));
+}
+
+INSTANTIATE_TEST_SUITE_P(ChunkSizes, ParallelRecordReaderTest,
+                         ::testing::Values(1, 100, 4096, 16 << 20));
+
+}  // namespace
+}  // namespace io
+}  // namespace tsl
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tsl/platform/cloud/ram_file_block_cache.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -48,6 +49,11 @@ std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::Lookup(
     }
   }
 
+  return InsertBlock_Locked(key);
+}
+
+std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::InsertBlock_Locked(
+    const Key& key) {
   // Insert a new empty block, setting the bookkeeping to sentinel values
   // in order to update them as appropriate.
   auto new_entry = std::make_shared<Block>();
@@ -63,7 +69,19 @@ std::shared_ptr<RamFileBlockCache::Block> RamFileBlockCache::Lookup(
 // Remove blocks from the cache until we do not exceed our maximum size.
 void RamFileBlockCache::Trim() {
   while (!lru_list_.empty() && cache_size_ > max_bytes_) {
-    RemoveBlock(block_map_.find(lru_list_.back()));
+    auto entry = block_map_.find(lru_list_.back());
+    if (readahead_state_.empty()) {
+      RemoveBlock(entry);
+      continue;
+    }
+    // Forget the readahead state of files that have no cached blocks left, so
+    // that it doesn't keep an entry for every file ever read.
+    const string filename = entry->first.first;
+    RemoveBlock(entry);
+    auto next = block_map_.lower_bound(std::make_pair(filename, 0));
+    if (next == block_map_.end() || next->first.first != filename) {
+      readahead_state_.erase(filename);
+    }
   }
 }
 
@@ -83,13 +101,15 @@ Status RamFileBlockCache::UpdateLRU(const Key& key,
 
   // Check for inconsistent state. If there is a block later in the same file
   // in the cache, and our current block is not block size, this likely means
-  // we have inconsistent state within the cache. Note: it's possible some
-  // incomplete reads may still go undetected.
+  // we have inconsistent state within the cache. Prefetched blocks past the end
+  // of the file are expected until their fetch completes, and are ignored.
+  // Note: it's possible some incomplete reads may still go undetected.
   if (block->data.size() < block_size_) {
-    Key fmax = std::make_pair(key.first, std::numeric_limits<size_t>::max());
-    auto fcmp = block_map_.upper_bound(fmax);
-    if (fcmp != block_map_.begin() && key < (--fcmp)->first) {
-      return errors::Internal("Block cache contents are inconsistent.");
+    for (auto it = block_map_.upper_bound(key);
+         it != block_map_.end() && it->first.first == key.first; ++it) {
+      if (!IsPendingPrefetch(it->second)) {
+        return errors::Internal("Block cache contents are inconsistent.");
+      }
     }
   }
 
@@ -178,6 +198,7 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
     // fetcher without breaking it up into blocks.
     return block_fetcher_(filename, offset, n, buffer, bytes_transferred);
   }
+  MaybeReadahead(filename, offset, n);
   // Calculate the block-aligned start and end of the read.
   size_t start = block_size_ * (offset / block_size_);
   size_t finish = block_size_ * ((offset + n) / block_size_);
@@ -229,6 +250,75 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
   return OkStatus();
 }
 
+void RamFileBlockCache::MaybeReadahead(const string& filename, size_t offset,
+                                       size_t n) {
+  if (!readahead_pool_) return;
+  {
+    mutex_lock lock(mu_);
+    ReadaheadState& state = readahead_state_[filename];
+    const bool sequential = offset == state.next_offset;
+    state.next_offset = offset + n;
+    if (!sequential) return;
+  }
+  // Fetch the blocks following the ones covering this read, while they are
+  // read.
+  size_t finish = block_size_ * ((offset + n + block_size_ - 1) / block_size_);
+  Prefetch(filename, finish, readahead_blocks_ * block_size_);
+}
+
+void RamFileBlockCache::Prefetch(const string& filename, size_t offset,
+                                 size_t n) {
+  if (!readahead_pool_ || n == 0) return;
+  size_t start = block_size_ * (offset / block_size_);
+  size_t finish = block_size_ * ((offset + n + block_size_ - 1) / block_size_);
+  mutex_lock lock(mu_);
+  auto state = readahead_state_.find(filename);
+  if (state != readahead_state_.end()) {
+    finish = std::min(finish, state->second.file_size);
+  }
+  for (size_t pos = start; pos < finish; pos += block_size_) {
+    Key key = std::make_pair(filename, pos);
+    if (block_map_.find(key) != block_map_.end()) continue;
+    std::shared_ptr<Block> block = InsertBlock_Locked(key);
+    block->prefetched = true;
+    readahead_pool_->Schedule(
+        [this, key, block] { PrefetchBlock(key, block); });
+  }
+}
+
+void RamFileBlockCache::PrefetchBlock(const Key& key,
+                                      const std::shared_ptr<Block>& block) {
+  Status status = MaybeFetch(key, block);
+  mutex_lock lock(mu_);
+  auto entry = block_map_.find(key);
+  if (entry == block_map_.end() || entry->second != block) {
+    // The block was evicted from another thread.
+    return;
+  }
+  if (!status.ok()) {
+    // Let the next read of the block fetch it again and report the error.
+    VLOG(1) << "Prefetching " << key.first << "@" << key.second
+            << " failed: " << status;
+    RemoveBlock(entry);
+    return;
+  }
+  if (block->data.size() < block_size_) {
+    // Don't prefetch past the end of the file again.
+    readahead_state_[key.first].file_size = key.second + block->data.size();
+  }
+  if (block->data.empty()) {
+    RemoveBlock(entry);
+    return;
+  }
+  Trim();
+}
+
+bool RamFileBlockCache::IsPendingPrefetch(const std::shared_ptr<Block>& block) {
+  if (!block->prefetched) return false;
+  mutex_lock l(block->mu);
+  return block->state != FetchState::FINISHED || block->data.empty();
+}
+
 bool RamFileBlockCache::ValidateAndUpdateFileSignature(const string& filename,
                                                        int64_t file_signature) {
   mutex_lock lock(mu_);
@@ -273,6 +363,7 @@ void RamFileBlockCache::Flush() {
   block_map_.clear();
   lru_list_.clear();
   lra_list_.clear();
+  readahead_state_.clear();
   cache_size_ = 0;
 }
 
@@ -289,6 +380,7 @@ void RamFileBlockCache::RemoveFile_Locked(const string& filename) {
     RemoveBlock(it);
     it = next;
   }
+  readahead_state_.erase(filename);
 }
 
 void RamFileBlockCache::RemoveBlock(BlockMap::iterator entry) {
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_TSL_PLATFORM_CLOUD_RAM_FILE_BLOCK_CACHE_H_
 
 #include <functional>
+#include <limits>
 #include <list>
 #include <map>
 #include <memory>
@@ -30,6 +31,7 @@ limitations under the License.
 #include "tsl/platform/status.h"
 #include "tsl/platform/stringpiece.h"
 #include "tsl/platform/thread_annotations.h"
+#include "tsl/platform/threadpool.h"
 #include "tsl/platform/types.h"
 
 namespace tsl {
@@ -38,6 +40,11 @@ namespace tsl {
 ///
 /// This class should be shared by read-only random access files on a remote
 /// filesystem (e.g. GCS).
+///
+/// If `readahead_blocks` is positive, reads that continue where the previous
+/// read of the same file ended are treated as a sequential scan, and the next
+/// `readahead_blocks` blocks are fetched concurrently in the background, so
+/// that a single reader keeps several block fetches in flight.
 class RamFileBlockCache : public FileBlockCache {
  public:
   /// The callback executed when a block is not found in the cache, and needs to
@@ -51,21 +58,30 @@ class RamFileBlockCache : public FileBlockCache {
       BlockFetcher;
 
   RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
-                    BlockFetcher block_fetcher, Env* env = Env::Default())
+                    BlockFetcher block_fetcher, Env* env = Env::Default(),
+                    size_t readahead_blocks = 0)
       : block_size_(block_size),
         max_bytes_(max_bytes),
         max_staleness_(max_staleness),
         block_fetcher_(block_fetcher),
-        env_(env) {
+        env_(env),
+        readahead_blocks_(readahead_blocks) {
     if (max_staleness_ > 0) {
       pruning_thread_.reset(env_->StartThread(ThreadOptions(), "TF_prune_FBC",
                                               [this] { Prune(); }));
     }
+    if (IsCacheEnabled() && readahead_blocks_ > 0) {
+      readahead_pool_ = std::make_unique<thread::ThreadPool>(
+          env_, "TF_readahead_FBC", readahead_blocks_);
+    }
     VLOG(1) << "GCS file block cache is "
             << (IsCacheEnabled() ? "enabled" : "disabled");
   }
 
   ~RamFileBlockCache() override {
+    // Destroying readahead_pool_ will block until the scheduled fetches are
+    // done.
+    readahead_pool_.reset();
     if (pruning_thread_) {
       stop_pruning_thread_.Notify();
       // Destroying pruning_thread_ will block until Prune() receives the above
@@ -91,6 +107,13 @@ class RamFileBlockCache : public FileBlockCache {
   Status Read(const string& filename, size_t offset, size_t n, char* buffer,
               size_t* bytes_transferred) override;
 
+  /// Fetch the blocks of `filename` covering `n` bytes at `offset` into the
+  /// cache in the background, so that a later Read of that range doesn't wait
+  /// for the remote filesystem. Blocks that are already cached or being
+  /// fetched are skipped. Does nothing unless readahead is enabled.
+  void Prefetch(const string& filename, size_t offset, size_t n)
+      TF_LOCKS_EXCLUDED(mu_);
+
   // Validate the given file signature with the existing file signature in the
   // cache. Returns true if the signature doesn't change or the file doesn't
   // exist before. If the signature changes, update the existing signature with
@@ -109,6 +132,7 @@ class RamFileBlockCache : public FileBlockCache {
   size_t block_size() const override { return block_size_; }
   size_t max_bytes() const override { return max_bytes_; }
   uint64 max_staleness() const override { return max_staleness_; }
+  size_t readahead_blocks() const { return readahead_blocks_; }
 
   /// The current size (in bytes) of the cache.
   size_t CacheSize() const override TF_LOCKS_EXCLUDED(mu_);
@@ -131,6 +155,8 @@ class RamFileBlockCache : public FileBlockCache {
   const BlockFetcher block_fetcher_;
   /// The Env from which we read timestamps.
   Env* const env_;  // not owned
+  /// The number of blocks fetched ahead of sequential reads.
+  const size_t readahead_blocks_;
 
   /// \brief The key type for the file block cache.
   ///
@@ -175,6 +201,9 @@ class RamFileBlockCache : public FileBlockCache {
     std::list<Key>::iterator lra_iterator;
     /// The timestamp (seconds since epoch) at which the block was cached.
     uint64 timestamp;
+    /// Whether the block was inserted by a prefetch, in which case it may be
+    /// past the end of the file until its fetch completes.
+    bool prefetched = false;
     /// Mutex to guard state variable
     mutex mu;
     /// The state of the block.
@@ -197,6 +226,10 @@ class RamFileBlockCache : public FileBlockCache {
   /// Look up a Key in the block cache.
   std::shared_ptr<Block> Lookup(const Key& key) TF_LOCKS_EXCLUDED(mu_);
 
+  /// Insert a new empty block at `key`, which must not be in the cache.
+  std::shared_ptr<Block> InsertBlock_Locked(const Key& key)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   Status MaybeFetch(const Key& key, const std::shared_ptr<Block>& block)
       TF_LOCKS_EXCLUDED(mu_);
 
@@ -215,6 +248,19 @@ class RamFileBlockCache : public FileBlockCache {
   /// cache size accordingly.
   void RemoveBlock(BlockMap::iterator entry) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Prefetch the blocks following a read of `n` bytes at `offset` if it
+  /// continues the previous read of the file.
+  void MaybeReadahead(const string& filename, size_t offset, size_t n)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  /// Fetch the prefetched `block` at `key` on the readahead pool.
+  void PrefetchBlock(const Key& key, const std::shared_ptr<Block>& block)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  /// Returns true if `block` was prefetched and is not known to hold data.
+  bool IsPendingPrefetch(const std::shared_ptr<Block>& block)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// The cache pruning thread that removes files with expired blocks.
   std::unique_ptr<Thread> pruning_thread_;
 
@@ -243,6 +289,21 @@ class RamFileBlockCache : public FileBlockCache {
 
   // A filename->file_signature map.
   std::map<string, int64_t> file_signature_map_ TF_GUARDED_BY(mu_);
+
+  /// \brief The readahead state of a file.
+  struct ReadaheadState {
+    /// The end of the last read, where a sequential read continues.
+    size_t next_offset = 0;
+    /// The size of the file, once a prefetch reached its end.
+    size_t file_size = std::numeric_limits<size_t>::max();
+  };
+
+  /// A filename->readahead state map. Entries are dropped with the last cached
+  /// block of their file.
+  std::map<string, ReadaheadState> readahead_state_ TF_GUARDED_BY(mu_);
+
+  /// The threads fetching blocks ahead of sequential reads, if enabled.
+  std::unique_ptr<thread::ThreadPool> readahead_pool_;
 };
 
 }  // namespace tsl
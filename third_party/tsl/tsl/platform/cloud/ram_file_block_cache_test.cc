@@ -15,12 +15,15 @@ limitations under the License.
 
 #include "tsl/platform/cloud/ram_file_block_cache.h"
 
+#include <algorithm>
 #include <cstring>
+#include <map>
 
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/blocking_counter.h"
 #include "tsl/platform/cloud/now_seconds_env.h"
 #include "tsl/platform/env.h"
+#include "tsl/platform/mutex.h"
 #include "tsl/platform/notification.h"
 #include "tsl/platform/test.h"
 
@@ -566,5 +569,78 @@ TEST(RamFileBlockCacheTest, Flush) {
   EXPECT_EQ(calls, 2);
 }
 
+TEST(RamFileBlockCacheTest, SequentialReadahead) {
+  // A 50 byte file read sequentially, with 2 blocks of readahead.
+  const size_t block_size = 16;
+  const size_t file_size = 50;
+  mutex mu;
+  std::map<size_t, int> calls;
+  auto fetcher = [&mu, &calls, file_size](const string& filename,
+                                          size_t offset, size_t n,
+                                          char* buffer,
+                                          size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      calls[offset]++;
+    }
+    *bytes_transferred = offset < file_size ? std::min(n, file_size - offset)
+                                            : 0;
+    memset(buffer, 'x', *bytes_transferred);
+    return OkStatus();
+  };
+  std::vector<char> out;
+  {
+    RamFileBlockCache cache(block_size, 1024, 0, fetcher, Env::Default(),
+                            /*readahead_blocks=*/2);
+    EXPECT_EQ(cache.readahead_blocks(), 2);
+    for (size_t offset = 0; offset < file_size; offset += block_size) {
+      TF_EXPECT_OK(ReadCache(&cache, "", offset, block_size, &out));
+      EXPECT_EQ(out.size(), std::min(block_size, file_size - offset));
+    }
+    TF_EXPECT_OK(ReadCache(&cache, "", 0, file_size, &out));
+    EXPECT_EQ(out.size(), file_size);
+    // The block past the end of the file may be prefetched, but is not kept.
+    EXPECT_LE(cache.CacheSize(), 4 * block_size);
+  }
+  // Each block of the file was fetched once, either by a read or ahead of it.
+  for (size_t offset = 0; offset < file_size; offset += block_size) {
+    EXPECT_EQ(calls[offset], 1) << offset;
+  }
+  EXPECT_LE(calls.size(), 6);
+}
+
+TEST(RamFileBlockCacheTest, Prefetch) {
+  const size_t block_size = 16;
+  mutex mu;
+  int calls = 0;
+  auto fetcher = [&mu, &calls](const string& filename, size_t offset,
+                               size_t n, char* buffer,
+                               size_t* bytes_transferred) {
+    {
+      mutex_lock l(mu);
+      calls++;
+    }
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    return OkStatus();
+  };
+  std::vector<char> out;
+  // Without readahead, prefetching does nothing.
+  RamFileBlockCache cache(block_size, 1024, 0, fetcher);
+  cache.Prefetch("", 0, 2 * block_size);
+  EXPECT_EQ(cache.CacheSize(), 0);
+
+  RamFileBlockCache readahead_cache(block_size, 1024, 0, fetcher,
+                                    Env::Default(), /*readahead_blocks=*/2);
+  readahead_cache.Prefetch("", block_size / 2, 2 * block_size);
+  // Reads of the prefetched blocks wait for their fetch instead of issuing
+  // another one.
+  TF_EXPECT_OK(ReadCache(&readahead_cache, "", 40, 8, &out));
+  TF_EXPECT_OK(ReadCache(&readahead_cache, "", 0, 32, &out));
+  EXPECT_EQ(out.size(), 32);
+  mutex_lock l(mu);
+  EXPECT_EQ(calls, 3);
+}
+
 }  // namespace
 }  // namespace tsl
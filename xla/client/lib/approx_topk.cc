@@ -261,19 +261,72 @@ XlaOp ApproxTopKFallback(XlaBuilder* builder, absl::Span<const XlaOp> operands,
                          const XlaComputation& comparator, float recall_target,
                          bool aggregate_to_topk,
                          int64_t reduction_input_size_override) {
+  if (operands.size() != init_values.size()) {
+    return builder->ReportError(
+        InvalidArgument("operands and init_values size mismatch: %d vs %d",
+                        operands.size(), init_values.size()));
+  }
   auto operands_shapes = builder->GetOperandShapes(operands).value();
+  auto status_or_optypes = GetOperandTypes(builder, operands, init_values);
+  if (!status_or_optypes.ok()) {
+    return builder->ReportError(status_or_optypes.status());
+  }
+  auto op_types = status_or_optypes.value();
   int64_t rank = operands_shapes[0].rank();
+  if (reduction_dim < 0 || reduction_dim >= rank) {
+    return builder->ReportError(
+        InvalidArgument("reduction_dim should range in [0,%d)", rank));
+  }
   uint64_t n = operands_shapes[0].dimensions(reduction_dim);
-  // Align the output size with ApproxTopK.
+  // Use the same windows as ApproxTopK, so that the recall is the same.
   auto status_or_approx_output_size = ApproxTopKReductionOutputSize(
-      n, rank, top_k, recall_target, aggregate_to_topk,
+      n, rank, top_k, recall_target, /*aggregate_to_topk=*/false,
       reduction_input_size_override);
   if (!status_or_approx_output_size.ok()) {
     return builder->ReportError(status_or_approx_output_size.status());
   }
-  auto output_size = status_or_approx_output_size.value().first;
-  return AggregateToTopKBuilder(builder, operands, init_values, output_size,
-                                reduction_dim, comparator);
+  int64_t approx_output_size, log2_reduction;
+  std::tie(approx_output_size, log2_reduction) =
+      status_or_approx_output_size.value();
+  if (log2_reduction == 0) {
+    return AggregateToTopKBuilder(
+        builder, operands, init_values,
+        aggregate_to_topk ? top_k : approx_output_size, reduction_dim,
+        comparator);
+  }
+
+  // Computes the top-1 of each of the `approx_output_size` windows. Element `i`
+  // of the padded operands belongs to the window `i % approx_output_size`.
+  const int64_t window_size = int64_t{1} << log2_reduction;
+  const int64_t padded_size = approx_output_size * window_size;
+  std::vector<int64_t> windowed_dims(operands_shapes[0].dimensions().begin(),
+                                     operands_shapes[0].dimensions().end());
+  windowed_dims[reduction_dim] = approx_output_size;
+  windowed_dims.insert(windowed_dims.begin() + reduction_dim, window_size);
+  PaddingConfig padding_config = MakeNoPaddingConfig(rank);
+  padding_config.mutable_dimensions(reduction_dim)
+      ->set_edge_padding_high(padded_size - n);
+  std::vector<XlaOp> windowed_operands;
+  windowed_operands.reserve(operands.size());
+  for (int i = 0; i < operands.size(); ++i) {
+    windowed_operands.push_back(
+        Reshape(Pad(operands[i], init_values[i], padding_config),
+                windowed_dims));
+  }
+  auto reduction_computation =
+      BuildReductionComputation(builder, op_types, comparator);
+  auto window_top1 = Reduce(builder, windowed_operands, init_values,
+                            reduction_computation, {reduction_dim});
+  std::vector<XlaOp> results;
+  results.reserve(operands.size());
+  for (int i = 0; i < operands.size(); ++i) {
+    results.push_back(GetTupleElement(window_top1, i));
+  }
+  if (aggregate_to_topk) {
+    return AggregateToTopKBuilder(builder, results, init_values, top_k,
+                                  reduction_dim, comparator);
+  }
+  return Tuple(builder, results);
 }
 
 }  // namespace xla
@@ -56,7 +56,9 @@ XlaOp ApproxTopK(XlaBuilder* builder, absl::Span<const XlaOp> operands,
                  float recall_target = 0.9, bool aggregate_to_topk = true,
                  int64_t reduction_input_size_override = -1);
 
-// Fallback for platforms that haven't been optimized.
+// Fallback for platforms that haven't been optimized. Reduces the operands to
+// the same windows as ApproxTopK, so that the recall contract holds, and then
+// computes the exact top-k of the window results when `aggregate_to_topk`.
 XlaOp ApproxTopKFallback(XlaBuilder* builder, absl::Span<const XlaOp> operands,
                          absl::Span<const XlaOp> init_values, int64_t top_k,
                          int64_t reduction_dim,
@@ -19,10 +19,12 @@ limitations under the License.
 #include <cmath>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "xla/client/lib/constants.h"
 #include "xla/client/xla_builder.h"
 #include "xla/primitive_util.h"
@@ -140,27 +142,36 @@ XlaOp Uint32sToUint64(std::array<XlaOp, 2> u32s) {
                    ConstantR0WithType(builder, U64, 32));
 }
 
+// Returns whether the indices of `num_elems` elements fit in 32 bits, in which
+// case the counters are computed with 32-bit operations only. 64-bit integer
+// operations are emulated on GPUs, and take twice the vector lanes on CPUs.
+bool IndicesFitInU32(int64_t num_elems) {
+  return num_elems <= std::numeric_limits<uint32_t>::max();
+}
+
 // Given the initial state and the request shape of random numbers to be
 // generated, returns the input for the random number generator and a new state.
+//
+// The input of the element at the row-major index i is `initial_state + i`.
 std::pair<ThreeFry2x32State, XlaOp> GetThreeFryInputsAndUpdatedState(
     XlaOp initial_state, const Shape& shape) {
   XlaBuilder* builder = initial_state.builder();
-  auto u64_shape = ShapeUtil::MakeShape(U64, shape.dimensions());
+  const int64_t num_elems = ShapeUtil::ElementsIn(shape);
   // initial_state is an R1, so reshape it to a scalar.
-  auto input_u64 = Broadcast(Reshape(initial_state, {}), shape.dimensions());
-  int64_t trailing_dims_product = 1;
-  for (int64_t i = shape.rank() - 1; i >= 0; --i) {
-    if (shape.dimensions(i) < 2) {
-      continue;
-    }
-    input_u64 =
-        input_u64 + (Iota(builder, u64_shape, i) *
-                     ConstantR0<uint64_t>(builder, trailing_dims_product));
-    trailing_dims_product *= shape.dimensions(i);
+  XlaOp initial_u64 = Reshape(initial_state, {});
+  ThreeFry2x32State inputs;
+  if (IndicesFitInU32(num_elems)) {
+    std::array<XlaOp, 2> initial = Uint64ToUint32s(initial_u64);
+    XlaOp index = Reshape(Iota(builder, U32, num_elems), shape.dimensions());
+    XlaOp low = initial[0] + index;
+    XlaOp carry = ConvertElementType(Lt(low, initial[0]), U32);
+    inputs = {low, initial[1] + carry};
+  } else {
+    XlaOp index = Reshape(Iota(builder, U64, num_elems), shape.dimensions());
+    inputs = Uint64ToUint32s(initial_u64 + index);
   }
-  XlaOp new_state = initial_state +
-                    ConstantR0<uint64_t>(builder, ShapeUtil::ElementsIn(shape));
-  return std::make_pair(Uint64ToUint32s(input_u64), new_state);
+  XlaOp new_state = initial_state + ConstantR0<uint64_t>(builder, num_elems);
+  return std::make_pair(inputs, new_state);
 }
 
 // Result for SplitShapeIntoHalves().
@@ -373,6 +384,24 @@ std::array<XlaOp, 2> Uint128AddUint64(
   return {new_u128_low, new_u128_high};
 }
 
+// Adds an U128 represented as 4 U32s, from the least significant one to the
+// most significant one, with an U32 tensor. The U128 is broadcast to the shape
+// of the U32 tensor if it is a scalar.
+std::array<XlaOp, 4> Uint128AddUint32(const std::array<XlaOp, 4>& u128,
+                                      XlaOp u32) {
+  XlaOp zero = ConstantR0<uint32_t>(u32.builder(), 0);
+  std::array<XlaOp, 4> result;
+  result[0] = u128[0] + u32;
+  XlaOp carry = Lt(result[0], u128[0]);
+  for (int i = 1; i < 4; ++i) {
+    result[i] = u128[i] + ConvertElementType(carry, U32);
+    if (i < 3) {
+      carry = And(carry, Eq(result[i], zero));
+    }
+  }
+  return result;
+}
+
 std::array<XlaOp, 2> Uint32sToUint128(const std::array<XlaOp, 4>& u32s) {
   return {Uint32sToUint64({u32s[0], u32s[1]}),
           Uint32sToUint64({u32s[2], u32s[3]})};
@@ -394,35 +423,63 @@ XlaOp Uint128ToOp(std::array<XlaOp, 2> u128) {
   return ConcatScalars(u128[0].builder(), {u128[0], u128[1]});
 }
 
-// Returns the pair (state + [0, 1, ..., n-1], state + n), which should be used
-// as the inputs fed to `Philox4x32` and the updated state. `state` is an U128
+// Returns the pair (state + offsets, state + n), which should be used as the
+// inputs fed to `Philox4x32` and the updated state. `state` is an U128
 // represented as 4 U32s in the order from the least significant one to the most
-// significant one.
+// significant one, and `offsets` is an U32 or U64 array of `num_offsets`
+// elements.
 std::pair<Philox4x32State, XlaOp> GetPhiloxInputsAndUpdatedState(
-    const Philox4x32State& state, int64_t n) {
+    const Philox4x32State& state, XlaOp offsets, int64_t num_offsets,
+    int64_t n) {
   XlaBuilder* builder = state[0].builder();
-  XlaOp iota = Iota(builder, U64, n);
   auto state_u128 = Uint32sToUint128(state);
-  auto inputs = Uint128ToUint32s(Uint128AddUint64(state_u128, iota, {n}));
+  std::array<XlaOp, 4> inputs;
+  if (builder->GetShape(offsets)->element_type() == U32) {
+    inputs = Uint128AddUint32(state, offsets);
+  } else {
+    inputs =
+        Uint128ToUint32s(Uint128AddUint64(state_u128, offsets, {num_offsets}));
+  }
   XlaOp new_state = Uint128ToOp(
       Uint128AddUint64(state_u128, ConstantR0<uint64_t>(builder, n)));
   return std::make_pair(inputs, new_state);
 }
 
-// Generates CeilOfRatio(num_elems, 4)*4 32bit Philox random numbers, as Philox
-// numbers are generated in the unit of 128bits.
-std::pair<Philox4x32State, XlaOp> GeneratePhiloxBits(int64_t num_elems,
-                                                     XlaOp initial_state,
-                                                     Philox4x32Key key) {
-  Philox4x32State state;
-  state = Uint128ToUint32s(Uint128FromOp(initial_state));
-  const int64_t num_vector4 = CeilOfRatio<int64_t>(num_elems, 4);
-  Philox4x32State inputs;
+// The 128 bits Philox random numbers used by each element of an array, with
+// the index of the part of the number that the element takes.
+struct PhiloxBlocks {
+  Philox4x32State bits;
+  XlaOp index_in_block;
   XlaOp new_state;
-  std::tie(inputs, new_state) =
-      GetPhiloxInputsAndUpdatedState(state, num_vector4);
-  auto outputs = Philox4x32(inputs, key);
-  return std::make_pair(outputs, new_state);
+};
+
+// Generates the Philox random numbers of `num_elems` elements, each taking one
+// of the `elems_per_block` parts of a 128 bits number.
+//
+// Element i uses the number at the counter `state + i / elems_per_block`,
+// which is computed in place rather than materialized and interleaved with the
+// other elements: the generated array is then a plain elementwise computation
+// of an iota, which fuses with its consumers and keeps the fusions small.
+PhiloxBlocks GeneratePhiloxBlocks(int64_t num_elems, int64_t elems_per_block,
+                                  XlaOp initial_state, Philox4x32Key key) {
+  XlaBuilder* builder = initial_state.builder();
+  Philox4x32State state = Uint128ToUint32s(Uint128FromOp(initial_state));
+  XlaOp index =
+      Iota(builder, IndicesFitInU32(num_elems) ? U32 : U64, num_elems);
+  XlaOp block_size = ScalarLike(index, elems_per_block);
+  auto [inputs, new_state] = GetPhiloxInputsAndUpdatedState(
+      state, index / block_size, num_elems,
+      CeilOfRatio<int64_t>(num_elems, elems_per_block));
+  return {Philox4x32(inputs, key), index % block_size, new_state};
+}
+
+// Returns the element of `values` selected by the unsigned `index`.
+XlaOp SelectByIndex(XlaOp index, absl::Span<const XlaOp> values) {
+  XlaOp result = values.back();
+  for (int64_t i = values.size() - 2; i >= 0; --i) {
+    result = Select(Eq(index, ScalarLike(index, i)), values[i], result);
+  }
+  return result;
 }
 
 // Generates an array of primitive type U32 with the given shape containing
@@ -430,26 +487,15 @@ std::pair<Philox4x32State, XlaOp> GeneratePhiloxBits(int64_t num_elems,
 // state of the random number generator.
 RngOutput PhiloxRngBit32(XlaOp op_key, XlaOp initial_state,
                          const Shape& shape) {
-  XlaBuilder* builder = op_key.builder();
   const int64_t num_elems = ShapeUtil::ElementsIn(shape);
 
   Philox4x32Key key = Uint64ToUint32s(op_key);
-  Philox4x32State bits;
-  XlaOp new_state;
-  std::tie(bits, new_state) = GeneratePhiloxBits(num_elems, initial_state, key);
-  // Combining bits[i] in a round-robin fashion, to align with non-XLA
-  // implementations
-  int64_t bits_len = (num_elems + 3) / 4;
-  for (auto i = 0; i < 4; ++i) {
-    bits[i] = Reshape(bits[i], {bits_len, 1});
-  }
-  XlaOp numbers = ConcatInDim(builder, {bits[0], bits[1], bits[2], bits[3]},
-                              /*dimension=*/1);
-  numbers = Reshape(numbers, {bits_len * 4});
-  numbers = Slice(numbers, /*start_indices=*/{0},
-                  /*limit_indices=*/{num_elems},
-                  /*strides=*/{1});
-  return {Reshape(numbers, shape.dimensions()), new_state};
+  PhiloxBlocks blocks = GeneratePhiloxBlocks(
+      num_elems, /*elems_per_block=*/4, initial_state, key);
+  // Taking the words of each number in a round-robin fashion, to align with
+  // non-XLA implementations.
+  XlaOp numbers = SelectByIndex(blocks.index_in_block, blocks.bits);
+  return {Reshape(numbers, shape.dimensions()), blocks.new_state};
 }
 
 // Generates an array of primitive type U16 with the given shape containing
@@ -474,32 +520,19 @@ RngOutput PhiloxRngBitNarrow(XlaOp op_key, XlaOp initial_state,
 // state of the random number generator.
 RngOutput PhiloxRngBit64(XlaOp op_key, XlaOp initial_state,
                          const Shape& shape) {
-  XlaBuilder* builder = op_key.builder();
   const int64_t num_elems = ShapeUtil::ElementsIn(shape);
 
   Philox4x32Key key = Uint64ToUint32s(op_key);
-  Philox4x32State bits32;
-  XlaOp new_state;
-  std::tie(bits32, new_state) =
-      GeneratePhiloxBits(num_elems * 2, initial_state, key);
-
-  std::array<XlaOp, 2> bits64;
-  bits64[0] = Uint32sToUint64({bits32[0], bits32[1]});
-  bits64[1] = Uint32sToUint64({bits32[2], bits32[3]});
-
-  // Combining bits64[i] in a round-robin fashion, to align with non-XLA
-  // implementations
-  int64_t bits64_len = (num_elems + 1) / 2;
-  for (auto i = 0; i < 2; ++i) {
-    bits64[i] = Reshape(bits64[i], {bits64_len, 1});
-  }
-  XlaOp numbers = ConcatInDim(builder, {bits64[0], bits64[1]},
-                              /*dimension=*/1);
-  numbers = Reshape(numbers, {bits64_len * 2});
-  numbers = Slice(numbers, /*start_indices=*/{0},
-                  /*limit_indices=*/{num_elems},
-                  /*strides=*/{1});
-  return {Reshape(numbers, shape.dimensions()), new_state};
+  PhiloxBlocks blocks = GeneratePhiloxBlocks(
+      num_elems, /*elems_per_block=*/2, initial_state, key);
+  std::array<XlaOp, 2> bits64 = {
+      Uint32sToUint64({blocks.bits[0], blocks.bits[1]}),
+      Uint32sToUint64({blocks.bits[2], blocks.bits[3]})};
+
+  // Taking the halves of each number in a round-robin fashion, to align with
+  // non-XLA implementations.
+  XlaOp numbers = SelectByIndex(blocks.index_in_block, bits64);
+  return {Reshape(numbers, shape.dimensions()), blocks.new_state};
 }
 
 XlaOp ConvertRandomBitsToUniformFloatingPoint(XlaOp bits, XlaOp minval,
@@ -20,8 +20,10 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "xla/client/lib/constants.h"
 #include "xla/client/xla_builder.h"
+#include "xla/literal_util.h"
 #include "xla/primitive_util.h"
 #include "xla/shape.h"
+#include "xla/shape_util.h"
 #include "xla/statusor.h"
 #include "xla/test.h"
 #include "xla/tests/client_library_test_base.h"
@@ -91,5 +93,40 @@ XLA_TEST_F(PrngTest, RandomBitsToUniformFloatingPointInvalidArguments) {
                                                                  1.0f);
 }
 
+XLA_TEST_F(PrngTest, PhiloxBitGenerator32) {
+  XlaBuilder builder(TestName());
+  XlaOp key = ConstantR0<uint64_t>(&builder, 42);
+  XlaOp state = ConstantR1<uint64_t>(&builder, {5, 0});
+  RngOutput output =
+      PhiloxBitGenerator(key, state, ShapeUtil::MakeShape(U32, {2, 3}));
+  // The words of the numbers at counters 5 and 6 are taken in order.
+  Tuple(&builder, {Reshape(output.value, {6}), output.state});
+  ComputeAndCompareTuple(
+      &builder,
+      LiteralUtil::MakeTupleOwned(
+          LiteralUtil::CreateR1<uint32_t>({1352259593u, 1260434898u,
+                                           222410210u, 174404615u, 968438092u,
+                                           3191751210u}),
+          LiteralUtil::CreateR1<uint64_t>({7, 0})),
+      {});
+}
+
+XLA_TEST_F(PrngTest, PhiloxBitGenerator64) {
+  XlaBuilder builder(TestName());
+  XlaOp key = ConstantR0<uint64_t>(&builder, 42);
+  XlaOp state = ConstantR1<uint64_t>(&builder, {5, 0});
+  RngOutput output =
+      PhiloxBitGenerator(key, state, ShapeUtil::MakeShape(U64, {3}));
+  Tuple(&builder, {output.value, output.state});
+  ComputeAndCompareTuple(
+      &builder,
+      LiteralUtil::MakeTupleOwned(
+          LiteralUtil::CreateR1<uint64_t>({5413526666999355401ull,
+                                           749062117918881250ull,
+                                           13708467064886866252ull}),
+          LiteralUtil::CreateR1<uint64_t>({7, 0})),
+      {});
+}
+
 }  // namespace
 }  // namespace xla
@@ -16,9 +16,12 @@ limitations under the License.
 
 #include <memory>
 #include <numeric>
+#include <optional>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "xla/client/lib/arithmetic.h"
 #include "xla/client/lib/comparators.h"
 #include "xla/client/lib/constants.h"
@@ -31,6 +34,7 @@ limitations under the License.
 #include "xla/shape_util.h"
 #include "xla/status_macros.h"
 #include "xla/statusor.h"
+#include "xla/util.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/errors.h"
 
@@ -391,9 +395,9 @@ StatusOr<JacobiRotation> MakeJacobi(XlaOp ps, XlaOp qs, XlaOp pqs, XlaOp eps) {
 //  [b_pp, 0]
 //  [0, b_qq]
 //
-// def jacobi_rot(a, p, q, eps):
-//     t = a[p, p] + a[q, q]
-//     d = a[q, p] - a[p, q]
+// def jacobi_rot(a_pp, a_pq, a_qp, a_qq, eps):
+//     t = a_pp + a_qq
+//     d = a_qp - a_pq
 //
 //     if np.abs(d) < eps:
 //         s = 0.0
@@ -405,20 +409,20 @@ StatusOr<JacobiRotation> MakeJacobi(XlaOp ps, XlaOp qs, XlaOp pqs, XlaOp eps) {
 //         c = u / tmp
 //
 //     rot = np.array([[c, s], [-s, c]])
-//     m_tmp = rot.T @ a[[p, q], [p, q]]
+//     m_tmp = rot.T @ np.array([[a_pp, a_pq], [a_qp, a_qq]])
 //     c_r, s_r = make_jacobi(m_tmp[0, 0], m_tmp[1, 1], m_tmp[0, 1])
 //     rot_r = np.array([[c_r, s_r], [-s_r, c_r]])
 //     rot_l = rot @ rot_r
 //    return rot_l, rot_r
 //
-StatusOr<OneSidedJacobiRotation> GetOneSidedJacobiRotation(XlaOp a, XlaOp p,
-                                                           XlaOp q, XlaOp eps) {
-  XlaOp a_pp = DynamicSliceInMinorDims(a, {p, p}, {1, 1});
-  XlaOp a_pq = DynamicSliceInMinorDims(a, {p, q}, {1, 1});
-  XlaOp a_qp = DynamicSliceInMinorDims(a, {q, p}, {1, 1});
-  XlaOp a_qq = DynamicSliceInMinorDims(a, {q, q}, {1, 1});
-
-  XlaOp one = ScalarLike(a, 1.0);
+// The entries may be arrays, in which case the rotations are computed
+// elementwise.
+StatusOr<OneSidedJacobiRotation> GetOneSidedJacobiRotation(XlaOp a_pp,
+                                                           XlaOp a_pq,
+                                                           XlaOp a_qp,
+                                                           XlaOp a_qq,
+                                                           XlaOp eps) {
+  XlaOp one = ScalarLike(a_pp, 1.0);
 
   XlaOp t = a_pp + a_qq;
   XlaOp d = a_qp - a_pq;
@@ -448,119 +452,205 @@ StatusOr<OneSidedJacobiRotation> GetOneSidedJacobiRotation(XlaOp a, XlaOp p,
   return rots;
 }
 
-// Apply one-sided Jacobi on elements at indices pp, pq, qp, qq.
-StatusOr<SVDResult> OneSidedJacobiUpdate(SVDResult svd_result, XlaOp p, XlaOp q,
-                                         XlaOp eps) {
-  XlaOp u = svd_result.u;
-  XlaOp v = svd_result.v;
-  XlaOp d = svd_result.d;
-  XlaBuilder* builder = d.builder();
-  TF_ASSIGN_OR_RETURN(Shape d_shape, builder->GetShape(d));
-  const int64_t num_dims = d_shape.rank();
-  const int64_t num_batch_dims = num_dims - 2;
-  std::vector<int64_t> batch_dims(num_batch_dims);
-  for (int i = 0; i < num_batch_dims; ++i) {
-    batch_dims[i] = ShapeUtil::GetDimension(d_shape, i);
-  }
-  const int64_t m = ShapeUtil::GetDimension(d_shape, -2);
-  const int64_t n = ShapeUtil::GetDimension(d_shape, -1);
-
-  TF_ASSIGN_OR_RETURN(OneSidedJacobiRotation onesided_jacobi,
-                      GetOneSidedJacobiRotation(d, p, q, eps));
-
-  auto zero = ScalarLike(p, 0);
-
-  // Zero out a_{pq} explicitly.
-  std::vector<int64_t> pq_dims(batch_dims.begin(), batch_dims.end());
-  pq_dims.push_back(1);
-  pq_dims.push_back(1);
-  auto pq_zero = ScalarLike(d, 0.0);
-  auto pq_zeros = Broadcast(pq_zero, pq_dims);
-
-  std::vector<int64_t> broadcast_dims(batch_dims.size());
+// Rotates the rows of `top` and `bottom` pairwise: row i of `top` and row i of
+// `bottom` are rotated by the i-th rotation of `rot`.
+//
+// top, bottom = (
+//   top * c[:, None] - bottom * s[:, None],
+//   top * s[:, None] + bottom * c[:, None],
+// )
+Status ApplyJacobiRotationOverRows(const JacobiRotation& rot, XlaOp& top,
+                                   XlaOp& bottom) {
+  TF_ASSIGN_OR_RETURN(Shape shape, top.builder()->GetShape(top));
+  std::vector<int64_t> broadcast_dims(shape.rank() - 1);
   std::iota(broadcast_dims.begin(), broadcast_dims.end(), 0);
-  broadcast_dims.push_back(num_dims - 1);
-
-  // Apply Jacobi Rotation on the left.
-  auto slice_p = DynamicSliceInMinorDims(d, {p, zero}, {1, n});
-  auto slice_q = DynamicSliceInMinorDims(d, {q, zero}, {1, n});
-  auto slice_p_new =
-      onesided_jacobi.rot_l.c * slice_p - onesided_jacobi.rot_l.s * slice_q;
-  auto slice_q_new =
-      onesided_jacobi.rot_l.s * slice_p + onesided_jacobi.rot_l.c * slice_q;
-  d = DynamicUpdateSliceInMinorDims(d, slice_p_new, {p, zero});
-  d = DynamicUpdateSliceInMinorDims(d, slice_q_new, {q, zero});
-
-  // Apply Jacobi Rotation on the right.
-  slice_p = DynamicSliceInMinorDims(d, {zero, p}, {m, 1});
-  slice_q = DynamicSliceInMinorDims(d, {zero, q}, {m, 1});
-  slice_p_new =
-      onesided_jacobi.rot_r.c * slice_p - onesided_jacobi.rot_r.s * slice_q;
-  slice_q_new =
-      onesided_jacobi.rot_r.s * slice_p + onesided_jacobi.rot_r.c * slice_q;
-  d = DynamicUpdateSliceInMinorDims(d, slice_p_new, {zero, p});
-  d = DynamicUpdateSliceInMinorDims(d, slice_q_new, {zero, q});
-
-  d = DynamicUpdateSliceInMinorDims(d, pq_zeros, {p, q});
-  d = DynamicUpdateSliceInMinorDims(d, pq_zeros, {q, p});
-
-  // Apply left Jacobi Rotation on U.
-  slice_p = DynamicSliceInMinorDims(u, {zero, p}, {m, 1});
-  slice_q = DynamicSliceInMinorDims(u, {zero, q}, {m, 1});
-  slice_p_new =
-      onesided_jacobi.rot_l.c * slice_p - onesided_jacobi.rot_l.s * slice_q;
-
-  slice_p_new = Mul(
-      slice_p_new,
-      Rsqrt(Reduce(Square(slice_p_new), pq_zero,
-                   CreateScalarAddComputation(d_shape.element_type(), builder),
-                   {num_dims - 2})),
-      broadcast_dims);
-
-  slice_q_new =
-      onesided_jacobi.rot_l.s * slice_p + onesided_jacobi.rot_l.c * slice_q;
-
-  slice_q_new = Mul(
-      slice_q_new,
-      Rsqrt(Reduce(Square(slice_q_new), pq_zero,
-                   CreateScalarAddComputation(d_shape.element_type(), builder),
-                   {num_dims - 2})),
-      broadcast_dims);
+  auto c = BroadcastInDim(rot.c, shape.dimensions(), broadcast_dims);
+  auto s = BroadcastInDim(rot.s, shape.dimensions(), broadcast_dims);
+  std::tie(top, bottom) =
+      std::make_tuple(top * c - bottom * s, top * s + bottom * c);
+  return OkStatus();
+}
 
-  u = DynamicUpdateSliceInMinorDims(u, slice_p_new, {zero, p});
-  u = DynamicUpdateSliceInMinorDims(u, slice_q_new, {zero, q});
+// Rotates the columns of `left` and `right` pairwise: column i of `left` and
+// column i of `right` are rotated by the i-th rotation of `rot`.
+//
+// left, right = (
+//   left * c[None, :] - right * s[None, :],
+//   left * s[None, :] + right * c[None, :],
+// )
+Status ApplyJacobiRotationOverCols(const JacobiRotation& rot, XlaOp& left,
+                                   XlaOp& right) {
+  TF_ASSIGN_OR_RETURN(Shape shape, left.builder()->GetShape(left));
+  std::vector<int64_t> broadcast_dims(shape.rank() - 1);
+  std::iota(broadcast_dims.begin(), broadcast_dims.end(), 0);
+  broadcast_dims.back() = shape.rank() - 1;
+  auto c = BroadcastInDim(rot.c, shape.dimensions(), broadcast_dims);
+  auto s = BroadcastInDim(rot.s, shape.dimensions(), broadcast_dims);
+  std::tie(left, right) =
+      std::make_tuple(left * c - right * s, left * s + right * c);
+  return OkStatus();
+}
 
-  // Apply right Jacobi Rotation on V.
-  slice_p = DynamicSliceInMinorDims(v, {zero, p}, {n, 1});
-  slice_q = DynamicSliceInMinorDims(v, {zero, q}, {n, 1});
-  slice_p_new =
-      onesided_jacobi.rot_r.c * slice_p - onesided_jacobi.rot_r.s * slice_q;
+// Scales the columns of `x` to unit norm. Zero columns are left unchanged.
+StatusOr<XlaOp> NormalizeColumns(XlaOp x) {
+  XlaBuilder* builder = x.builder();
+  TF_ASSIGN_OR_RETURN(Shape shape, builder->GetShape(x));
+  const int64_t num_dims = shape.rank();
+  std::vector<int64_t> broadcast_dims(num_dims - 1);
+  std::iota(broadcast_dims.begin(), broadcast_dims.end(), 0);
+  broadcast_dims.back() = num_dims - 1;
+  auto zero = ScalarLike(x, 0.0);
+  auto sq_norm =
+      Reduce(Square(x), zero,
+             CreateScalarAddComputation(shape.element_type(), builder),
+             {num_dims - 2});
+  auto scale = Select(Gt(sq_norm, ZerosLike(sq_norm)), Rsqrt(sq_norm),
+                      ZerosLike(sq_norm));
+  return Mul(x, scale, broadcast_dims);
+}
 
-  slice_p_new = Mul(
-      slice_p_new,
-      Rsqrt(Reduce(Square(slice_p_new), pq_zero,
-                   CreateScalarAddComputation(d_shape.element_type(), builder),
-                   {num_dims - 2})),
-      broadcast_dims);
+// def permute_rows_in_col(top, bottom):
+//   top_out = np.zeros_like(l)
+//   top_out[0] = top[0]
+//   top_out[1] = bottom[0]
+//   top_out[2:] = top[1:-1]
+//   bottom_out = np.zeros_like(r)
+//   bottom_out[:-1] = bottom[1:]
+//   bottom_out[-1] = top[-1]
+//   return top_out, bottom_out
+Status PermuteRowsInColumn(XlaOp& top, XlaOp& bottom) {
+  XlaBuilder* builder = top.builder();
+  TF_ASSIGN_OR_RETURN(Shape shape, builder->GetShape(top));
+  const int64_t k = ShapeUtil::GetDimension(shape, -2);
+  const int64_t cols = ShapeUtil::GetDimension(shape, -1);
+  if (k <= 1) {
+    return OkStatus();
+  }
+  const int64_t num_dims = shape.rank();
+  std::tie(top, bottom) = std::make_tuple(
+      ConcatInDim(builder,
+                  {SliceInMinorDims(top, {0, 0}, {1, cols}),
+                   SliceInMinorDims(bottom, {0, 0}, {1, cols}),
+                   SliceInMinorDims(top, {1, 0}, {k - 1, cols})},
+                  num_dims - 2),
+      ConcatInDim(builder,
+                  {SliceInMinorDims(bottom, {1, 0}, {k, cols}),
+                   SliceInMinorDims(top, {k - 1, 0}, {k, cols})},
+                  num_dims - 2));
+  return OkStatus();
+}
 
-  slice_q_new =
-      onesided_jacobi.rot_r.s * slice_p + onesided_jacobi.rot_r.c * slice_q;
+// Same as PermuteRowsInColumn, for the columns of `left` and `right`.
+Status PermuteColumnsInRow(XlaOp& left, XlaOp& right) {
+  XlaBuilder* builder = left.builder();
+  TF_ASSIGN_OR_RETURN(Shape shape, builder->GetShape(left));
+  const int64_t k = ShapeUtil::GetDimension(shape, -1);
+  if (k <= 1) {
+    return OkStatus();
+  }
+  const int64_t num_dims = shape.rank();
+  std::tie(left, right) =
+      std::make_tuple(ConcatInDim(builder,
+                                  {SliceInMinorDims(left, {0}, {1}),
+                                   SliceInMinorDims(right, {0}, {1}),
+                                   SliceInMinorDims(left, {1}, {k - 1})},
+                                  num_dims - 1),
+                      ConcatInDim(builder,
+                                  {SliceInMinorDims(right, {1}, {k}),
+                                   SliceInMinorDims(left, {k - 1}, {k})},
+                                  num_dims - 1));
+  return OkStatus();
+}
 
-  slice_q_new = Mul(
-      slice_q_new,
-      Rsqrt(Reduce(Square(slice_q_new), pq_zero,
-                   CreateScalarAddComputation(d_shape.element_type(), builder),
-                   {num_dims - 2})),
-      broadcast_dims);
+// The state of the parallel Jacobi iterations. The leading n rows and columns
+// of D are split in halves, padded with zeros to the same size k when n is odd,
+// so that the rows (resp. columns) i of the top (resp. left) and bottom (resp.
+// right) halves form the pairs rotated in a round. The columns of U and V are
+// split the same way. The trailing m - n rows of D are only rotated by columns,
+// and the trailing m - n columns of U are never rotated.
+struct ParallelJacobiState {
+  XlaOp d_tl, d_tr, d_bl, d_br;
+  // The trailing m - n rows of D, if m > n, split by columns like above.
+  std::optional<XlaOp> d_rest_l, d_rest_r;
+  XlaOp u_l, u_r;
+  XlaOp v_l, v_r;
+
+  std::vector<XlaOp> ToValues() const {
+    std::vector<XlaOp> values = {d_tl, d_tr, d_bl, d_br, u_l, u_r, v_l, v_r};
+    if (d_rest_l) {
+      values.push_back(*d_rest_l);
+      values.push_back(*d_rest_r);
+    }
+    return values;
+  }
 
-  v = DynamicUpdateSliceInMinorDims(v, slice_p_new, {zero, p});
-  v = DynamicUpdateSliceInMinorDims(v, slice_q_new, {zero, q});
+  static ParallelJacobiState FromValues(absl::Span<const XlaOp> values) {
+    ParallelJacobiState state;
+    std::tie(state.d_tl, state.d_tr, state.d_bl, state.d_br, state.u_l,
+             state.u_r, state.v_l, state.v_r) =
+        std::make_tuple(values[0], values[1], values[2], values[3], values[4],
+                        values[5], values[6], values[7]);
+    if (values.size() > 8) {
+      state.d_rest_l = values[8];
+      state.d_rest_r = values[9];
+    }
+    return state;
+  }
+};
 
-  svd_result.d = d;
-  svd_result.u = u;
-  svd_result.v = v;
+// Performs one round of parallel one-sided Jacobi rotations; 2k - 1 rounds make
+// a sweep. The pairs on the diagonals of the quadrants of D don't share any
+// row or column, hence they are all rotated at once. Then the rows and columns
+// are permuted, so that all pairs of indices end up on the diagonals of the
+// quadrants once within a sweep, as in the Brent/Luk parallel ordering:
+// Brent, Richard P., and Franklin T. Luk. "The solution of singular-value and
+// symmetric eigenvalue problems on multiprocessor arrays." SIAM Journal on
+// Scientific and Statistical Computing 6.1 (1985): 69-84.
+// After a sweep the rows and columns are back to their original order.
+Status ApplyRotations(ParallelJacobiState& state, XlaOp eps) {
+  TF_ASSIGN_OR_RETURN(
+      OneSidedJacobiRotation rots,
+      GetOneSidedJacobiRotation(
+          GetMatrixDiagonal(state.d_tl), GetMatrixDiagonal(state.d_tr),
+          GetMatrixDiagonal(state.d_bl), GetMatrixDiagonal(state.d_br), eps));
+
+  TF_RETURN_IF_ERROR(
+      ApplyJacobiRotationOverRows(rots.rot_l, state.d_tl, state.d_bl));
+  TF_RETURN_IF_ERROR(
+      ApplyJacobiRotationOverRows(rots.rot_l, state.d_tr, state.d_br));
+  TF_RETURN_IF_ERROR(
+      ApplyJacobiRotationOverCols(rots.rot_r, state.d_tl, state.d_tr));
+  TF_RETURN_IF_ERROR(
+      ApplyJacobiRotationOverCols(rots.rot_r, state.d_bl, state.d_br));
+  if (state.d_rest_l) {
+    TF_RETURN_IF_ERROR(ApplyJacobiRotationOverCols(
+        rots.rot_r, *state.d_rest_l, *state.d_rest_r));
+  }
+  // Zero out a_{pq} and a_{qp} explicitly.
+  auto zeros = ZerosLike(rots.rot_l.c);
+  state.d_tr = SetMatrixDiagonal(state.d_tr, zeros);
+  state.d_bl = SetMatrixDiagonal(state.d_bl, zeros);
+
+  // Apply the rotations on U and V, and renormalize the columns for numeric
+  // stability.
+  TF_RETURN_IF_ERROR(
+      ApplyJacobiRotationOverCols(rots.rot_l, state.u_l, state.u_r));
+  TF_RETURN_IF_ERROR(
+      ApplyJacobiRotationOverCols(rots.rot_r, state.v_l, state.v_r));
+  for (XlaOp* x : {&state.u_l, &state.u_r, &state.v_l, &state.v_r}) {
+    TF_ASSIGN_OR_RETURN(*x, NormalizeColumns(*x));
+  }
 
-  return svd_result;
+  TF_RETURN_IF_ERROR(PermuteColumnsInRow(state.d_tl, state.d_tr));
+  TF_RETURN_IF_ERROR(PermuteColumnsInRow(state.d_bl, state.d_br));
+  TF_RETURN_IF_ERROR(PermuteRowsInColumn(state.d_tl, state.d_bl));
+  TF_RETURN_IF_ERROR(PermuteRowsInColumn(state.d_tr, state.d_br));
+  if (state.d_rest_l) {
+    TF_RETURN_IF_ERROR(PermuteColumnsInRow(*state.d_rest_l, *state.d_rest_r));
+  }
+  TF_RETURN_IF_ERROR(PermuteColumnsInRow(state.u_l, state.u_r));
+  TF_RETURN_IF_ERROR(PermuteColumnsInRow(state.v_l, state.v_r));
+  return OkStatus();
 }
 
 StatusOr<XlaOp> ComputeToleranceComparison(XlaOp w, XlaOp epsilon) {
@@ -599,21 +689,28 @@ StatusOr<XlaOp> ComputeToleranceComparison(XlaOp w, XlaOp epsilon) {
                                      ZerosLike(w_sliced), w_sliced)));
 }
 
-// Main boby of One-sided Jacobi Method.
-StatusOr<std::vector<XlaOp>> WhileLoopFn(
-    absl::Span<const XlaOp> initial_values,  //
-    int matrix_dimension,                    //
-    int max_sweep_updates,                   //
-    absl::string_view name,                  //
-    XlaBuilder* builder) {
+// Main body of the parallel one-sided Jacobi method. `initial_values` are the
+// iteration count, epsilon and the values of a ParallelJacobiState.
+StatusOr<std::vector<XlaOp>> Sweeps(absl::Span<const XlaOp> initial_values,
+                                    int64_t k, int max_sweep_updates,
+                                    XlaBuilder* builder) {
   auto while_cond_fn = [&](absl::Span<const XlaOp> values,
                            XlaBuilder* cond_builder) -> StatusOr<XlaOp> {
-    auto k = values[0];
-    auto max_sweeps = ScalarLike(k, max_sweep_updates);
-    auto sweep_update_cond = Gt(max_sweeps, k);
-
+    auto iter = values[0];
+    auto max_sweeps = ScalarLike(iter, max_sweep_updates);
+    auto sweep_update_cond = Gt(max_sweeps, iter);
+
+    ParallelJacobiState state =
+        ParallelJacobiState::FromValues(values.subspan(2));
+    TF_ASSIGN_OR_RETURN(Shape shape, cond_builder->GetShape(state.d_tl));
+    const int64_t num_dims = shape.rank();
+    auto d = ConcatInDim(
+        cond_builder,
+        {ConcatInDim(cond_builder, {state.d_tl, state.d_tr}, num_dims - 1),
+         ConcatInDim(cond_builder, {state.d_bl, state.d_br}, num_dims - 1)},
+        num_dims - 2);
     TF_ASSIGN_OR_RETURN(auto tolerance_comparison,
-                        ComputeToleranceComparison(values[3], values[4]));
+                        ComputeToleranceComparison(d, values[1]));
     auto tolerance_cond = ReduceAll(
         tolerance_comparison, xla::ConstantR0<bool>(cond_builder, false),
         CreateScalarOrComputation(PRED, cond_builder));
@@ -624,108 +721,31 @@ StatusOr<std::vector<XlaOp>> WhileLoopFn(
   auto while_body_fn =
       [&](absl::Span<const XlaOp> values,
           XlaBuilder* body_builder) -> StatusOr<std::vector<XlaOp>> {
-    auto while_cond_fn_inner =
-        [&](absl::Span<const XlaOp> values_inner,
-            XlaBuilder* inner_cond_builder) -> StatusOr<XlaOp> {
-      auto p = values_inner[0];
-      return Lt(p, ScalarLike(p, matrix_dimension - 1));
-    };
-
-    auto while_body_fn_inner =
-        [&](absl::Span<const XlaOp> values_inner,
-            XlaBuilder* inner_body_builder) -> StatusOr<std::vector<XlaOp>> {
-      auto while_cond_fn_innermost =
-          [&](absl::Span<const XlaOp> values_innermost,
-              XlaBuilder* innermost_cond_builder) -> StatusOr<XlaOp> {
-        auto q = values_innermost[1];
-        return Lt(q, ScalarLike(q, matrix_dimension));
-      };
-      auto while_body_fn_innermost =
-          [&](absl::Span<const XlaOp> values_innermost,
-              XlaBuilder* innermost_body_builder)
-          -> StatusOr<std::vector<XlaOp>> {
-        auto p = values_innermost[0];
-        auto q = values_innermost[1];
-
-        SVDResult onesided_jacobi_update;
-        onesided_jacobi_update.u = values_innermost[2];
-        onesided_jacobi_update.v = values_innermost[3];
-        onesided_jacobi_update.d = values_innermost[4];
-
-        auto eps = values_innermost[5];
-
-        TF_ASSIGN_OR_RETURN(
-            onesided_jacobi_update,
-            OneSidedJacobiUpdate(onesided_jacobi_update, p, q, eps));
-
-        std::vector<XlaOp> updated_values_innermost;
-        updated_values_innermost.reserve(values_innermost.size());
-
-        updated_values_innermost.push_back(p);
-        updated_values_innermost.push_back(q + ScalarLike(q, 1));
-        updated_values_innermost.push_back(onesided_jacobi_update.u);
-        updated_values_innermost.push_back(onesided_jacobi_update.v);
-        updated_values_innermost.push_back(onesided_jacobi_update.d);
-        updated_values_innermost.push_back(eps);
-
-        return updated_values_innermost;
-      };
-
-      std::vector<XlaOp> values_innermost(6);
-      auto p = values_inner[0];
-      auto q = p + ScalarLike(p, 1);
-      values_innermost[0] = p;                // index p.
-      values_innermost[1] = q;                // index q.
-      values_innermost[2] = values_inner[1];  // u.
-      values_innermost[3] = values_inner[2];  // v.
-      values_innermost[4] = values_inner[3];  // d.
-      values_innermost[5] = values_inner[4];  // eps.
-      TF_ASSIGN_OR_RETURN(
-          values_innermost,
-          WhileLoopHelper(while_cond_fn_innermost, while_body_fn_innermost,
-                          values_innermost, absl::StrCat(name, "-Innermost"),
-                          inner_body_builder));
-
-      std::vector<XlaOp> updated_values_inner;
-      updated_values_inner.reserve(values_inner.size());
-
-      updated_values_inner.push_back(p + ScalarLike(p, 1));
-      updated_values_inner.push_back(values_innermost[2]);
-      updated_values_inner.push_back(values_innermost[3]);
-      updated_values_inner.push_back(values_innermost[4]);
-      updated_values_inner.push_back(values_innermost[5]);
-      return updated_values_inner;
-    };
-    // Indexes.
-    XlaOp k = values[0];
-
-    std::vector<XlaOp> values_inner(5);
-    values_inner[0] = ScalarLike(k, 0);  // index p.
-    values_inner[1] = values[1];         // u.
-    values_inner[2] = values[2];         // v.
-    values_inner[3] = values[3];         // d.
-    values_inner[4] = values[4];         // eps.
+    std::vector<XlaOp> sweep_values(values.begin() + 1, values.end());
     TF_ASSIGN_OR_RETURN(
-        values_inner,
-        WhileLoopHelper(while_cond_fn_inner, while_body_fn_inner, values_inner,
-                        absl::StrCat(name, "-Inner"), body_builder));
-
-    std::vector<XlaOp> updated_values;
-    updated_values.reserve(values_inner.size());
-
-    updated_values.push_back(k + ScalarLike(k, 1));
-    updated_values.push_back(values_inner[1]);
-    updated_values.push_back(values_inner[2]);
-    updated_values.push_back(values_inner[3]);
-    updated_values.push_back(values_inner[4]);
-
+        sweep_values,
+        ForEachIndex(
+            2 * k - 1, S32,
+            [&](XlaOp iter, absl::Span<const XlaOp> values,
+                XlaBuilder* builder) -> StatusOr<std::vector<XlaOp>> {
+              ParallelJacobiState state =
+                  ParallelJacobiState::FromValues(values.subspan(1));
+              TF_RETURN_IF_ERROR(ApplyRotations(state, values[0]));
+              std::vector<XlaOp> updated_values = {values[0]};
+              for (XlaOp value : state.ToValues()) {
+                updated_values.push_back(value);
+              }
+              return updated_values;
+            },
+            sweep_values, "ApplyRotations", body_builder));
+    std::vector<XlaOp> updated_values(values.size());
+    updated_values[0] = values[0] + ScalarLike(values[0], 1);
+    std::copy(sweep_values.begin(), sweep_values.end(),
+              updated_values.begin() + 1);
     return updated_values;
   };
-  std::vector<XlaOp> values;
-  TF_ASSIGN_OR_RETURN(values, WhileLoopHelper(while_cond_fn, while_body_fn,
-                                              initial_values, name, builder));
-
-  return values;
+  return WhileLoopHelper(while_cond_fn, while_body_fn, initial_values,
+                         "ParallelOneSidedJacobi", builder);
 }
 
 // Sort singular values in decending order, and make sure they are non-negative
@@ -806,6 +826,8 @@ StatusOr<SVDResult> SortBySingularValuesAndPostProcessing(SVDResult result) {
 //        frobenius_norm - diag_norm) * np.sqrt(frobenius_norm + diag_norm)
 //    while off_diag_norm > 1e-6 * frobenius_norm and iter < max_iter:
 //        iter += 1
+//        # The pairs are visited in the parallel order of ApplyRotations, and
+//        # the rotations of the disjoint pairs of a round are applied at once.
 //        for p in range(m - 1):
 //            for q in range(p + 1, n):
 //                rot_l, rot_r = jacobi_rot(D[p][p], D[p][q], D[q][p], D[q][q])
@@ -858,27 +880,74 @@ SVDResult SVD(XlaOp a, int64_t max_iter, float epsilon,
   }
   SVDResult svd_result = svd_result_or.value();
 
-  auto output_with_status = WhileLoopFn(
-      {
-          Zero(builder, S32),  // k
-          svd_result.u,        // u
-          svd_result.v,        // v
-          svd_result.d,        // d
-          eps,                 // epsilon
-      },                       //
-      n,                       //
-      max_iter,                //
-      "CyclicOneSidedJacobi",  //
-      builder);
+  auto output_with_status = [&]() -> StatusOr<std::vector<XlaOp>> {
+    // d_tl = D[:k, :k], d_tr = D[:k, k:n]
+    // d_bl = D[k:n, :k], d_br = D[k:n, k:n]
+    const int64_t k = CeilOfRatio(n, int64_t{2});
+    auto zero = ScalarLike(a, 0.0);
+    auto pad_to_k = [&](XlaOp x, int64_t dim) {
+      return n % 2 ? PadInDim(x, zero, dim, /*pad_lo=*/0, /*pad_hi=*/1) : x;
+    };
+    ParallelJacobiState state;
+    state.d_tl = SliceInMinorDims(svd_result.d, {0, 0}, {k, k});
+    state.d_tr = pad_to_k(SliceInMinorDims(svd_result.d, {0, k}, {k, n}),
+                          num_dims - 1);
+    state.d_bl = pad_to_k(SliceInMinorDims(svd_result.d, {k, 0}, {n, k}),
+                          num_dims - 2);
+    state.d_br = pad_to_k(
+        pad_to_k(SliceInMinorDims(svd_result.d, {k, k}, {n, n}), num_dims - 1),
+        num_dims - 2);
+    if (m > n) {
+      state.d_rest_l = SliceInMinorDims(svd_result.d, {n, 0}, {m, k});
+      state.d_rest_r = pad_to_k(SliceInMinorDims(svd_result.d, {n, k}, {m, n}),
+                                num_dims - 1);
+    }
+    state.u_l = SliceInMinorDims(svd_result.u, {0, 0}, {m, k});
+    state.u_r = pad_to_k(SliceInMinorDims(svd_result.u, {0, k}, {m, n}),
+                         num_dims - 1);
+    state.v_l = SliceInMinorDims(svd_result.v, {0, 0}, {n, k});
+    state.v_r = pad_to_k(SliceInMinorDims(svd_result.v, {0, k}, {n, n}),
+                         num_dims - 1);
+
+    std::vector<XlaOp> values = {Zero(builder, S32), eps};
+    for (XlaOp value : state.ToValues()) {
+      values.push_back(value);
+    }
+    TF_ASSIGN_OR_RETURN(values, Sweeps(values, k, max_iter, builder));
+    state = ParallelJacobiState::FromValues(
+        absl::MakeConstSpan(values).subspan(2));
+
+    // Drops the padding, and reassembles the matrices.
+    auto concat_cols = [&](XlaOp left, XlaOp right, int64_t rows) {
+      return SliceInMinorDims(
+          ConcatInDim(builder, {left, right}, num_dims - 1), {0, 0},
+          {rows, n});
+    };
+    std::vector<XlaOp> d_rows = {
+        ConcatInDim(builder,
+                    {concat_cols(state.d_tl, state.d_tr, k),
+                     concat_cols(state.d_bl, state.d_br, n - k)},
+                    num_dims - 2)};
+    if (m > n) {
+      d_rows.push_back(concat_cols(*state.d_rest_l, *state.d_rest_r, m - n));
+    }
+    std::vector<XlaOp> u_cols = {concat_cols(state.u_l, state.u_r, m)};
+    if (m > n) {
+      u_cols.push_back(SliceInMinorDims(svd_result.u, {0, n}, {m, m}));
+    }
+    return std::vector<XlaOp>{ConcatInDim(builder, u_cols, num_dims - 1),
+                              concat_cols(state.v_l, state.v_r, n),
+                              ConcatInDim(builder, d_rows, num_dims - 2)};
+  }();
   if (!output_with_status.status().ok()) {
     return return_error(output_with_status.status());
   }
 
   auto output = output_with_status.value();
 
-  svd_result.u = output[1];
-  svd_result.v = output[2];
-  svd_result.d = output[3];
+  svd_result.u = output[0];
+  svd_result.v = output[1];
+  svd_result.d = output[2];
 
   svd_result_or = SortBySingularValuesAndPostProcessing(svd_result);
   if (!svd_result_or.ok()) {
@@ -144,6 +144,21 @@ XLA_TEST_F(SVDTest, Test_VWVt_EQ_A_2x4x5) {
                              ErrorSpec(1e-3, 1e-3));
 }
 
+// Odd number of columns, and more rows than columns, in a batch.
+XLA_TEST_F(SVDTest, Test_VWVt_EQ_A_3x9x7) {
+  XlaBuilder builder(TestName());
+
+  Array3D<float> a_val(3, 9, 7);
+  a_val.FillRandom(10 /* stddev */, 2 /* mean */);
+  XlaOp a;
+  auto a_data = CreateR3Parameter<float>(a_val, 0, "a", &builder, &a);
+  auto result = SVD(a, 100, 1e-8);
+  ComputeMatmulUDVT(result, &builder);
+
+  ComputeAndCompareR3<float>(&builder, a_val, {a_data.get()},
+                             ErrorSpec(1e-3, 1e-3));
+}
+
 XLA_TEST_F(SVDTest, Test_Orthogonality_U) {
   XlaBuilder builder(TestName());
 
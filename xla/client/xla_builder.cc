@@ -918,12 +918,38 @@ StatusOr<XlaOp> XlaBuilder::AddBroadcastSequence(const Shape& output_shape,
 XlaOp XlaBuilder::UnaryOp(HloOpcode unop, XlaOp operand) {
   return ReportErrorOrReturn([&]() -> StatusOr<XlaOp> {
     TF_ASSIGN_OR_RETURN(const Shape* operand_shape, GetShapePtr(operand));
-    TF_ASSIGN_OR_RETURN(
-        Shape shape, ShapeInference::InferUnaryOpShape(unop, *operand_shape));
+    TF_ASSIGN_OR_RETURN(Shape shape,
+                        InferUnaryOrBinaryOpShape(unop, *operand_shape,
+                                                  /*rhs=*/nullptr,
+                                                  /*broadcast_dimensions=*/{}));
     return AddOpWithShape(unop, shape, {operand});
   });
 }
 
+StatusOr<Shape> XlaBuilder::InferUnaryOrBinaryOpShape(
+    HloOpcode opcode, const Shape& lhs, const Shape* rhs,
+    absl::Span<const int64_t> broadcast_dimensions) {
+  OpSignature signature{opcode, lhs, std::nullopt,
+                        std::vector<int64_t>(broadcast_dimensions.begin(),
+                                             broadcast_dimensions.end())};
+  if (rhs != nullptr) {
+    signature.rhs = *rhs;
+  }
+  auto it = inferred_op_shapes_.find(signature);
+  if (it != inferred_op_shapes_.end()) {
+    return it->second;
+  }
+  // Errors are not cached, they are reported once anyway.
+  TF_ASSIGN_OR_RETURN(
+      Shape shape,
+      rhs == nullptr
+          ? ShapeInference::InferUnaryOpShape(opcode, lhs)
+          : ShapeInference::InferBinaryOpShape(opcode, lhs, *rhs,
+                                               broadcast_dimensions));
+  inferred_op_shapes_.emplace(std::move(signature), shape);
+  return shape;
+}
+
 XlaOp XlaBuilder::BinaryOp(HloOpcode binop, XlaOp lhs, XlaOp rhs,
                            absl::Span<const int64_t> broadcast_dimensions,
                            std::optional<ComparisonDirection> direction,
@@ -931,9 +957,9 @@ XlaOp XlaBuilder::BinaryOp(HloOpcode binop, XlaOp lhs, XlaOp rhs,
   return ReportErrorOrReturn([&]() -> StatusOr<XlaOp> {
     TF_ASSIGN_OR_RETURN(const Shape* lhs_shape, GetShapePtr(lhs));
     TF_ASSIGN_OR_RETURN(const Shape* rhs_shape, GetShapePtr(rhs));
-    TF_ASSIGN_OR_RETURN(
-        Shape shape, ShapeInference::InferBinaryOpShape(
-                         binop, *lhs_shape, *rhs_shape, broadcast_dimensions));
+    TF_ASSIGN_OR_RETURN(Shape shape,
+                        InferUnaryOrBinaryOpShape(binop, *lhs_shape, rhs_shape,
+                                                  broadcast_dimensions));
 
     const int64_t lhs_rank = lhs_shape->rank();
     const int64_t rhs_rank = rhs_shape->rank();
@@ -1034,6 +1034,13 @@ class XlaBuilder {
   virtual XlaOp BinaryOpNoBroadcast(HloOpcode binop, const Shape& shape,
                                     XlaOp lhs, XlaOp rhs);
 
+  // Returns the shape of a unary op (if `rhs` is null) or of a binary op,
+  // reusing the result of a previous inference with the same opcode, operand
+  // shapes and broadcast dimensions.
+  StatusOr<Shape> InferUnaryOrBinaryOpShape(
+      HloOpcode opcode, const Shape& lhs, const Shape* rhs,
+      absl::Span<const int64_t> broadcast_dimensions);
+
   // Internal helper method that does the building for an arbitrary ternary op.
   XlaOp TernaryOp(HloOpcode triop, XlaOp lhs, XlaOp rhs, XlaOp ehs);
 
@@ -1128,6 +1135,28 @@ class XlaBuilder {
 
   absl::flat_hash_map<int64_t, ImportedInstruction> handle_to_imported_index_;
 
+  // The signature of a unary or binary op, used to cache shape inference.
+  // Traced programs build ops with the same signature many times.
+  struct OpSignature {
+    HloOpcode opcode;
+    Shape lhs;
+    std::optional<Shape> rhs;
+    std::vector<int64_t> broadcast_dimensions;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const OpSignature& signature) {
+      return H::combine(std::move(h), signature.opcode, signature.lhs,
+                        signature.rhs, signature.broadcast_dimensions);
+    }
+    bool operator==(const OpSignature& other) const {
+      return opcode == other.opcode && lhs == other.lhs && rhs == other.rhs &&
+             broadcast_dimensions == other.broadcast_dimensions;
+    }
+  };
+
+  // The inferred shapes of the unary and binary ops built so far.
+  absl::flat_hash_map<OpSignature, Shape> inferred_op_shapes_;
+
   // The embedded computations used by this computation. Each computation was
   // the entry computation of some XlaComputation, the key is the unique id of
   // that XlaComputation.
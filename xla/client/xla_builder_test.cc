@@ -298,6 +298,32 @@ TEST_F(XlaBuilderTest, BinopHasDegenerateBroadcast) {
                                 m::Broadcast(m::Reshape(m::Parameter(1))))));
 }
 
+TEST_F(XlaBuilderTest, RepeatedOpSignaturesInferSameShapes) {
+  XlaBuilder b(TestName());
+  auto x = Parameter(&b, 0, ShapeUtil::MakeShape(F32, {2, 3}), "x");
+  auto y = Parameter(&b, 1, ShapeUtil::MakeShape(F32, {3}), "y");
+  auto add = Add(x, y, /*broadcast_dimensions=*/{1});
+  auto other_add = Add(x, y, /*broadcast_dimensions=*/{1});
+  auto compare = Lt(x, y, /*broadcast_dimensions=*/{1});
+  auto neg = Neg(x);
+  auto other_neg = Neg(x);
+  TF_ASSERT_OK_AND_ASSIGN(Shape add_shape, b.GetShape(add));
+  TF_ASSERT_OK_AND_ASSIGN(Shape other_add_shape, b.GetShape(other_add));
+  TF_ASSERT_OK_AND_ASSIGN(Shape compare_shape, b.GetShape(compare));
+  TF_ASSERT_OK_AND_ASSIGN(Shape neg_shape, b.GetShape(neg));
+  TF_ASSERT_OK_AND_ASSIGN(Shape other_neg_shape, b.GetShape(other_neg));
+  EXPECT_TRUE(ShapeUtil::Equal(add_shape, ShapeUtil::MakeShape(F32, {2, 3})));
+  EXPECT_TRUE(ShapeUtil::Equal(other_add_shape, add_shape));
+  EXPECT_TRUE(
+      ShapeUtil::Equal(compare_shape, ShapeUtil::MakeShape(PRED, {2, 3})));
+  EXPECT_TRUE(ShapeUtil::Equal(neg_shape, other_neg_shape));
+
+  // Failed inferences are not cached.
+  auto invalid = Add(x, y, /*broadcast_dimensions=*/{0});
+  EXPECT_FALSE(b.GetShape(invalid).ok());
+  EXPECT_FALSE(b.Build().ok());
+}
+
 TEST_F(XlaBuilderTest, BinopHasInDimAndDegenerateBroadcast) {
   XlaBuilder b(TestName());
   auto x = Parameter(&b, 0, ShapeUtil::MakeShape(F32, {2, 3}), "x");
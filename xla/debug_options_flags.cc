@@ -167,6 +167,7 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_cpu_matmul_tiling_n_dim(8);
   opts.set_xla_cpu_matmul_tiling_k_dim(8);
   opts.set_xla_cpu_enable_mlir_fusion_outlining(true);
+  opts.set_xla_cpu_enable_mlir_matmul_packing(false);
   opts.set_xla_cpu_enable_experimental_deallocation(true);
 
   opts.set_xla_partitioning_algorithm(
@@ -203,6 +204,37 @@ DebugOptions DefaultDebugOptionsIgnoringFlags() {
   opts.set_xla_gpu_ensure_minor_dot_contraction_dims(false);
   opts.set_xla_gpu_filter_kernels_spilling_registers_on_autotuning(true);
   opts.set_xla_gpu_llvm_verification_level(0);
+  opts.set_xla_gpu_persistent_kernel_cache_dir("");
+  opts.set_xla_cpu_parallel_codegen_split_count(1);
+  opts.set_xla_gpu_enable_incremental_compilation(false);
+  opts.set_xla_hlo_pass_pipeline_parallelism(1);
+  opts.set_xla_gpu_shared_autotune_cache_dir("");
+  opts.set_xla_gpu_share_autotune_results_between_hosts(false);
+  opts.set_xla_cpu_parallel_task_machine_model("");
+  // The magic constant 1000 is determined by correlating computation with flop
+  // estimate. It is a crude heuristic to find computations that take less than
+  // the thread context switch time (~5us).
+  opts.set_xla_cpu_inline_execution_flop_threshold(1000);
+  opts.set_xla_gpu_enable_nccl_group_launch(false);
+  opts.set_xla_gpu_all_reduce_blueconnect_min_decompose_bytes(0);
+  opts.set_xla_gpu_threshold_for_windowed_einsum_mib(100000);
+  opts.set_xla_gpu_unroll_windowed_einsum(false);
+  opts.set_xla_gpu_enable_cub_radix_sort(true);
+  opts.set_xla_cpu_enable_onednn_rewriter(false);
+  opts.set_xla_cpu_jit_object_cache_dir("");
+  opts.set_xla_gpu_enable_cost_based_layout_assignment(false);
+  opts.set_xla_gpu_conditional_to_select_overhead_us(0);
+  opts.set_xla_gpu_while_loop_iteration_overhead_us(0);
+  opts.set_xla_gpu_temp_buffer_arenas(0);
+  opts.set_xla_gpu_enable_eager_nccl_comm_init(false);
+  opts.set_xla_gpu_p2p_chunk_size_bytes(0);
+  opts.set_xla_gpu_all_to_all_devices_per_node(0);
+  opts.set_xla_gpu_hierarchical_all_to_all_max_bytes(1024 * 1024);
+  opts.set_xla_gpu_enable_cusolver_batched_eigh(true);
+  opts.set_xla_gpu_num_thunk_streams(1);
+  opts.set_xla_gpu_enable_auto_combine_thresholds(false);
+  opts.set_xla_gpu_enable_copy_engine_collective_permute(false);
+  opts.set_xla_gpu_hoist_fused_scalar_constants(false);
 
   return opts;
 }
@@ -728,6 +760,19 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
                 bool_setter_for(&DebugOptions::set_xla_dump_compress_protos),
                 debug_options->xla_dump_compress_protos(),
                 "Gzip-compress protos dumped by --xla_dump_hlo_as_proto."));
+  flag_list->push_back(
+      tsl::Flag("xla_dump_compress_text",
+                bool_setter_for(&DebugOptions::set_xla_dump_compress_text),
+                debug_options->xla_dump_compress_text(),
+                "Gzip-compress the HLO text and buffer assignment files dumped "
+                "by --xla_dump_hlo_as_text to *.txt.gz files."));
+  flag_list->push_back(tsl::Flag(
+      "xla_dump_hlo_constants_separately",
+      bool_setter_for(&DebugOptions::set_xla_dump_hlo_constants_separately),
+      debug_options->xla_dump_hlo_constants_separately(),
+      "Writes the data of large constants of protos dumped by "
+      "--xla_dump_hlo_as_proto into a .constants file next to the proto, "
+      "which the HLO module loader maps into memory."));
   flag_list->push_back(tsl::Flag(
       "xla_hlo_graph_addresses",
       bool_setter_for(&DebugOptions::set_xla_hlo_graph_addresses),
@@ -893,6 +938,14 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       "ReduceScatter-AllReduce-AllGather sequence, with the initial "
       "ReduceScatter being performed over all of the devices in the same host. "
       "Set to < 1 to disable all-reduce decomposition."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_all_reduce_blueconnect_min_decompose_bytes",
+      int64_setter_for(
+          &DebugOptions::
+              set_xla_gpu_all_reduce_blueconnect_min_decompose_bytes),
+      debug_options->xla_gpu_all_reduce_blueconnect_min_decompose_bytes(),
+      "All-reduces smaller than this many bytes are not decomposed by the "
+      "BlueConnect pass, as they are latency rather than bandwidth bound."));
   flag_list->push_back(tsl::Flag(
       "xla_gpu_enable_while_loop_reduce_scatter_code_motion",
       bool_setter_for(
@@ -1101,6 +1154,11 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       int64_setter_for(&DebugOptions::set_xla_cpu_matmul_tiling_k_dim),
       debug_options->xla_cpu_matmul_tiling_k_dim(),
       "Custom tile size for matmul's K dimension."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_enable_mlir_matmul_packing",
+      bool_setter_for(&DebugOptions::set_xla_cpu_enable_mlir_matmul_packing),
+      debug_options->xla_cpu_enable_mlir_matmul_packing(),
+      "Pack matmul operands into tiles before MLIR tiling and fusion."));
   flag_list->push_back(tsl::Flag(
       "xla_cpu_enable_experimental_deallocation",
       bool_setter_for(
@@ -1324,6 +1382,99 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       debug_options->xla_gpu_ensure_minor_dot_contraction_dims(),
       "Ensure that the contracting dimensions for matmul operands are the most "
       "minor by changing layouts accordingly"));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_cost_based_layout_assignment",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_cost_based_layout_assignment),
+      debug_options->xla_gpu_enable_cost_based_layout_assignment(),
+      "Choose the layouts of matmul operands that need the fewest copies and "
+      "transposes to produce, instead of the default layout"));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_conditional_to_select_overhead_us",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_conditional_to_select_overhead_us),
+      debug_options->xla_gpu_conditional_to_select_overhead_us(),
+      "Estimated cost of a conditional in microseconds. Conditionals whose "
+      "branches are cheaper than that are executed as selects between the "
+      "results of both branches. 0 disables the conversion."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_while_loop_iteration_overhead_us",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_while_loop_iteration_overhead_us),
+      debug_options->xla_gpu_while_loop_iteration_overhead_us(),
+      "Estimated overhead of a while loop iteration in microseconds. Loops "
+      "whose body is cheap compared to it are partially unrolled. 0 disables "
+      "the unrolling."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_temp_buffer_arenas",
+      int64_setter_for(&DebugOptions::set_xla_gpu_temp_buffer_arenas),
+      debug_options->xla_gpu_temp_buffer_arenas(),
+      "Maximum number of sets of temp buffers that a GPU executable keeps for "
+      "each device and reuses across runs, so that concurrent runs on "
+      "different streams don't allocate them. The sets are allocated from the "
+      "device directly. 0 allocates the temp buffers for every run."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_eager_nccl_comm_init",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_eager_nccl_comm_init),
+      debug_options->xla_gpu_enable_eager_nccl_comm_init(),
+      "Create the NCCL communicators of all the collectives of a GPU "
+      "executable concurrently before its first run on each device."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_p2p_chunk_size_bytes",
+      int64_setter_for(&DebugOptions::set_xla_gpu_p2p_chunk_size_bytes),
+      debug_options->xla_gpu_p2p_chunk_size_bytes(),
+      "Maximum size of each NCCL send and recv of a point-to-point transfer; "
+      "larger buffers are transferred in chunks. 0 transfers them at once."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_all_to_all_devices_per_node",
+      int64_setter_for(&DebugOptions::set_xla_gpu_all_to_all_devices_per_node),
+      debug_options->xla_gpu_all_to_all_devices_per_node(),
+      "Number of devices of each node. If greater than 1, all-to-alls across "
+      "nodes with small messages are decomposed into an all-to-all within "
+      "each node followed by one across nodes."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_hierarchical_all_to_all_max_bytes",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_hierarchical_all_to_all_max_bytes),
+      debug_options->xla_gpu_hierarchical_all_to_all_max_bytes(),
+      "Maximum number of bytes sent to each peer by an all-to-all decomposed "
+      "according to xla_gpu_all_to_all_devices_per_node."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_cusolver_batched_eigh",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_cusolver_batched_eigh),
+      debug_options->xla_gpu_enable_cusolver_batched_eigh(),
+      "Compute the eigendecomposition of batches of Hermitian matrices of at "
+      "most 32x32 elements with cuSOLVER's batched Jacobi solver."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_num_thunk_streams",
+      int32_setter_for(&DebugOptions::set_xla_gpu_num_thunk_streams),
+      debug_options->xla_gpu_num_thunk_streams(),
+      "Number of streams to run independent kernels, memsets and copies of "
+      "GPU executables on. 1 runs all of them on the main stream."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_auto_combine_thresholds",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_auto_combine_thresholds),
+      debug_options->xla_gpu_enable_auto_combine_thresholds(),
+      "Pick the byte thresholds of the collective combiners from the "
+      "collective performance model. The "
+      "xla_gpu_*_combine_threshold_bytes flags are then upper bounds."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_copy_engine_collective_permute",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_copy_engine_collective_permute),
+      debug_options->xla_gpu_enable_copy_engine_collective_permute(),
+      "Copy the data of collective permutes between devices of the same "
+      "process with copy engines instead of NCCL kernels, when the devices "
+      "have peer access to each other."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_hoist_fused_scalar_constants",
+      bool_setter_for(&DebugOptions::set_xla_gpu_hoist_fused_scalar_constants),
+      debug_options->xla_gpu_hoist_fused_scalar_constants(),
+      "Pass the scalar constants of loop and input fusions to their kernels as "
+      "arguments, so that fusions differing only in these constants share one "
+      "compiled kernel."));
   flag_list->push_back(tsl::Flag(
       "xla_gpu_filter_kernels_spilling_registers_on_autotuning",
       bool_setter_for(
@@ -1342,6 +1493,116 @@ void MakeDebugOptionsFlags(std::vector<tsl::Flag>* flag_list,
       debug_options->xla_gpu_llvm_verification_level(),
       "Sets how often we verify the generated llvm modules. Higher "
       "levels mean more frequent verification. Currently supported: 0, 1."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_persistent_kernel_cache_dir",
+      string_setter_for(
+          &DebugOptions::set_xla_gpu_persistent_kernel_cache_dir),
+      debug_options->xla_gpu_persistent_kernel_cache_dir(),
+      "If non-empty, compiled PTX and cubins are persisted in this directory "
+      "and reused by later compilations of identical kernels, skipping LLVM "
+      "optimization and ptxas. The directory can be shared between "
+      "processes."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_parallel_codegen_split_count",
+      int32_setter_for(&DebugOptions::set_xla_cpu_parallel_codegen_split_count),
+      debug_options->xla_cpu_parallel_codegen_split_count(),
+      "If greater than 1, split the LLVM module emitted by the CPU backend "
+      "into up to this many partitions and compile them in parallel. Calls "
+      "between partitions can't be inlined."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_incremental_compilation",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_enable_incremental_compilation),
+      debug_options->xla_gpu_enable_incremental_compilation(),
+      "Keep the optimized HLO and the compiled kernels of GPU compilations in "
+      "memory and reuse them when the same module, or a module with some "
+      "unchanged kernels, is compiled again."));
+  flag_list->push_back(tsl::Flag(
+      "xla_hlo_pass_pipeline_parallelism",
+      int32_setter_for(&DebugOptions::set_xla_hlo_pass_pipeline_parallelism),
+      debug_options->xla_hlo_pass_pipeline_parallelism(),
+      "If greater than 1, run HLO passes that process one computation at a "
+      "time on up to this many computations that don't call each other in "
+      "parallel."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_shared_autotune_cache_dir",
+      string_setter_for(&DebugOptions::set_xla_gpu_shared_autotune_cache_dir),
+      debug_options->xla_gpu_shared_autotune_cache_dir(),
+      "If not empty, look up GPU autotuning results in this directory before "
+      "autotuning and publish newly measured results to it. The directory "
+      "may be shared between hosts."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_share_autotune_results_between_hosts",
+      bool_setter_for(
+          &DebugOptions::set_xla_gpu_share_autotune_results_between_hosts),
+      debug_options->xla_gpu_share_autotune_results_between_hosts(),
+      "Share GPU autotuning results between the hosts of a multi-host job "
+      "through the key-value store of the distributed runtime."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_parallel_task_machine_model",
+      string_setter_for(
+          &DebugOptions::set_xla_cpu_parallel_task_machine_model),
+      debug_options->xla_cpu_parallel_task_machine_model(),
+      "If not empty, pick the number of parallel tasks of CPU instructions "
+      "with a model of the host's cores, caches and memory bandwidth. "
+      "\"probe\" measures the host; any other value is the path of a "
+      "CpuMachineModelProto text file."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_inline_execution_flop_threshold",
+      int64_setter_for(
+          &DebugOptions::set_xla_cpu_inline_execution_flop_threshold),
+      debug_options->xla_cpu_inline_execution_flop_threshold(),
+      "Executables with a FLOP estimate below this threshold run "
+      "synchronously on the caller thread of the TFRT CPU client when all "
+      "their inputs are ready."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_nccl_group_launch",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_nccl_group_launch),
+      debug_options->xla_gpu_enable_nccl_group_launch(),
+      "Launch consecutive, independent synchronous all-reduce, reduce-scatter "
+      "and all-gather thunks as a single NCCL group to amortize launch "
+      "latency."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_threshold_for_windowed_einsum_mib",
+      int64_setter_for(
+          &DebugOptions::set_xla_gpu_threshold_for_windowed_einsum_mib),
+      debug_options->xla_gpu_threshold_for_windowed_einsum_mib(),
+      "Threshold in MiB of an einsum operand above which the SPMD partitioner "
+      "emits a windowed einsum loop that overlaps collective-permutes with "
+      "partial dots."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_unroll_windowed_einsum",
+      bool_setter_for(&DebugOptions::set_xla_gpu_unroll_windowed_einsum),
+      debug_options->xla_gpu_unroll_windowed_einsum(),
+      "Unroll windowed einsum loops by a factor of two."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_enable_cub_radix_sort",
+      bool_setter_for(&DebugOptions::set_xla_gpu_enable_cub_radix_sort),
+      debug_options->xla_gpu_enable_cub_radix_sort(),
+      "Rewrite sorts along the minor dimension of long rows into "
+      "cub::DeviceRadixSort calls. Batched sorts are run as segmented sorts."));
+  flag_list->push_back(tsl::Flag(
+      "xla_gpu_perf_model_device_profile",
+      string_setter_for(&DebugOptions::set_xla_gpu_perf_model_device_profile),
+      debug_options->xla_gpu_perf_model_device_profile(),
+      "Path to a device profile written by hlo_op_profiler_run. Calibrates "
+      "the GPU performance model with the measured op costs, memory "
+      "bandwidth and kernel launch overhead."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_enable_onednn_rewriter",
+      bool_setter_for(&DebugOptions::set_xla_cpu_enable_onednn_rewriter),
+      debug_options->xla_cpu_enable_onednn_rewriter(),
+      "Rewrite dots, convolutions with bias and ReLU epilogues, and softmaxes "
+      "into calls to oneDNN primitives. Only has an effect in builds with "
+      "oneDNN v3 enabled."));
+  flag_list->push_back(tsl::Flag(
+      "xla_cpu_jit_object_cache_dir",
+      string_setter_for(&DebugOptions::set_xla_cpu_jit_object_cache_dir),
+      debug_options->xla_cpu_jit_object_cache_dir(),
+      "If non-empty, object files compiled by the CPU JIT are persisted in "
+      "this directory and reused by later compilations of identical LLVM "
+      "modules, skipping LLVM optimization and code generation. The "
+      "directory can be shared between processes."));
 }  // NOLINT(readability/fn_size)
 
 // Allocates flag_values and flag_objects; this function must not be called more
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef XLA_ERROR_SPEC_H_
 #define XLA_ERROR_SPEC_H_
 
+#include <cstdint>
+
 namespace xla {
 
 // Structure describing permissible absolute and relative error bounds.
@@ -47,6 +49,11 @@ struct ErrorSpec {
   // (We could have a symmetric more_infs_ok flag if necessary; right now it
   // appears not to be.)
   bool fewer_infs_ok = false;
+
+  // If positive, the comparison stops after finding this many mismatches, and
+  // the error message only describes the elements compared so far. This makes
+  // failing comparisons of large literals fast.
+  int64_t max_mismatches = 0;
 };
 
 }  // namespace xla
@@ -124,6 +124,16 @@ ExecutableRunOptions::gpu_executable_run_options() const {
   return gpu_executable_run_options_;
 }
 
+ExecutableRunOptions& ExecutableRunOptions::set_onednn_weights_cache(
+    cpu::OneDnnWeightsCache* onednn_weights_cache) {
+  onednn_weights_cache_ = onednn_weights_cache;
+  return *this;
+}
+
+cpu::OneDnnWeightsCache* ExecutableRunOptions::onednn_weights_cache() const {
+  return onednn_weights_cache_;
+}
+
 ExecutableRunOptions& ExecutableRunOptions::set_rng_seed(int rng_seed) {
   rng_seed_ = rng_seed;
   return *this;
@@ -55,6 +55,10 @@ namespace gpu {
 class GpuExecutableRunOptions;
 }  // namespace gpu
 
+namespace cpu {
+class OneDnnWeightsCache;
+}  // namespace cpu
+
 // A unique identifier for a particular "logical execution" of an XLA model.
 //
 // A logical execution might encompass multiple executions of one or more
@@ -216,6 +220,12 @@ class ExecutableRunOptions {
       const gpu::GpuExecutableRunOptions* gpu_executable_run_options);
   const gpu::GpuExecutableRunOptions* gpu_executable_run_options() const;
 
+  // Cache of prepacked oneDNN weights of the running CPU executable. Set by
+  // CpuExecutable for the oneDNN runtime calls.
+  ExecutableRunOptions& set_onednn_weights_cache(
+      cpu::OneDnnWeightsCache* onednn_weights_cache);
+  cpu::OneDnnWeightsCache* onednn_weights_cache() const;
+
  private:
   stream_executor::DeviceMemoryAllocator* allocator_ = nullptr;
   int device_ordinal_ = -1;
@@ -232,6 +242,7 @@ class ExecutableRunOptions {
   RecvDeviceMemoryFunction* recv_device_memory_function_ = nullptr;
   RunId run_id_;
   const gpu::GpuExecutableRunOptions* gpu_executable_run_options_ = nullptr;
+  cpu::OneDnnWeightsCache* onednn_weights_cache_ = nullptr;
 };
 
 }  // namespace xla
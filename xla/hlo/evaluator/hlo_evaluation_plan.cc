@@ -0,0 +1,401 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/hlo/evaluator/hlo_evaluation_plan.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "absl/types/span.h"
+#include "xla/comparison_util.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/literal.h"
+#include "xla/primitive_util.h"
+#include "xla/shape_util.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+#include "xla/util.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+using Kernel = void (*)(int64_t* slots, int64_t dst, const int64_t* operands);
+
+bool IsSupportedType(PrimitiveType type) {
+  return type == PRED || (primitive_util::IsIntegralType(type) &&
+                          !primitive_util::Is4BitType(type));
+}
+
+// Returns `f(T{})` for the native type T of the supported `type`.
+template <typename R, typename F>
+R SwitchSupportedType(PrimitiveType type, F&& f) {
+  return primitive_util::PrimitiveTypeSwitch<R>(
+      [&](auto primitive_type) -> R {
+        if constexpr (primitive_type == PRED ||
+                      (primitive_util::IsIntegralType(primitive_type) &&
+                       !primitive_util::Is4BitType(primitive_type))) {
+          return f(primitive_util::NativeTypeOf<primitive_type>{});
+        }
+        return R{};
+      },
+      type);
+}
+
+// The operations below wrap around on overflow and handle divisions by zero
+// like HloEvaluator.
+struct AddOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return static_cast<T>(static_cast<uint64_t>(lhs) +
+                          static_cast<uint64_t>(rhs));
+  }
+};
+
+struct SubtractOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return static_cast<T>(static_cast<uint64_t>(lhs) -
+                          static_cast<uint64_t>(rhs));
+  }
+};
+
+struct MultiplyOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return static_cast<T>(static_cast<uint64_t>(lhs) *
+                          static_cast<uint64_t>(rhs));
+  }
+};
+
+struct DivideOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    if (rhs == 0) {
+      return std::is_signed_v<T> ? static_cast<T>(-1)
+                                 : std::numeric_limits<T>::max();
+    }
+    if constexpr (std::is_signed_v<T>) {
+      if (rhs == -1 && lhs == std::numeric_limits<T>::min()) return lhs;
+    }
+    return lhs / rhs;
+  }
+};
+
+struct RemainderOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    if (rhs == 0) return lhs;
+    if constexpr (std::is_signed_v<T>) {
+      if (rhs == -1 && lhs == std::numeric_limits<T>::min()) return 0;
+    }
+    return lhs % rhs;
+  }
+};
+
+struct MaximumOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return std::max(lhs, rhs);
+  }
+};
+
+struct MinimumOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return std::min(lhs, rhs);
+  }
+};
+
+struct AndOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return static_cast<T>(lhs & rhs);
+  }
+};
+
+struct OrOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return static_cast<T>(lhs | rhs);
+  }
+};
+
+struct XorOp {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return static_cast<T>(lhs ^ rhs);
+  }
+};
+
+struct NotOp {
+  template <typename T>
+  static T Apply(T operand) {
+    if constexpr (std::is_same_v<T, bool>) {
+      return !operand;
+    } else {
+      return static_cast<T>(~operand);
+    }
+  }
+};
+
+struct NegateOp {
+  template <typename T>
+  static T Apply(T operand) {
+    return static_cast<T>(uint64_t{0} - static_cast<uint64_t>(operand));
+  }
+};
+
+struct AbsOp {
+  template <typename T>
+  static T Apply(T operand) {
+    if constexpr (std::is_signed_v<T>) {
+      if (operand < 0) return NegateOp::Apply(operand);
+    }
+    return operand;
+  }
+};
+
+template <typename T, typename Op>
+void UnaryKernel(int64_t* slots, int64_t dst, const int64_t* operands) {
+  slots[dst] = static_cast<int64_t>(
+      Op::template Apply<T>(static_cast<T>(slots[operands[0]])));
+}
+
+template <typename T, typename Op>
+void BinaryKernel(int64_t* slots, int64_t dst, const int64_t* operands) {
+  slots[dst] = static_cast<int64_t>(Op::template Apply<T>(
+      static_cast<T>(slots[operands[0]]), static_cast<T>(slots[operands[1]])));
+}
+
+template <typename T, typename Compare>
+void CompareKernel(int64_t* slots, int64_t dst, const int64_t* operands) {
+  slots[dst] = Compare()(static_cast<T>(slots[operands[0]]),
+                         static_cast<T>(slots[operands[1]]));
+}
+
+// Converts between any supported types, as the slots of all of them hold the
+// value cast to int64_t.
+template <typename T>
+void ConvertKernel(int64_t* slots, int64_t dst, const int64_t* operands) {
+  slots[dst] = static_cast<int64_t>(static_cast<T>(slots[operands[0]]));
+}
+
+void SelectKernel(int64_t* slots, int64_t dst, const int64_t* operands) {
+  slots[dst] = slots[operands[0]] != 0 ? slots[operands[1]]
+                                       : slots[operands[2]];
+}
+
+// Returns the kernel of an operation on integers, or on integers and
+// predicates if `allow_pred`.
+template <typename Op, bool kUnary = false>
+Kernel GetElementwiseKernel(PrimitiveType type, bool allow_pred) {
+  if (type == PRED && !allow_pred) return nullptr;
+  return SwitchSupportedType<Kernel>(type, [](auto native) -> Kernel {
+    using T = decltype(native);
+    if constexpr (kUnary) {
+      return &UnaryKernel<T, Op>;
+    } else {
+      return &BinaryKernel<T, Op>;
+    }
+  });
+}
+
+Kernel GetCompareKernel(PrimitiveType type, ComparisonDirection direction) {
+  return SwitchSupportedType<Kernel>(type, [&](auto native) -> Kernel {
+    using T = decltype(native);
+    switch (direction) {
+      case ComparisonDirection::kEq:
+        return &CompareKernel<T, std::equal_to<T>>;
+      case ComparisonDirection::kNe:
+        return &CompareKernel<T, std::not_equal_to<T>>;
+      case ComparisonDirection::kGe:
+        return &CompareKernel<T, std::greater_equal<T>>;
+      case ComparisonDirection::kGt:
+        return &CompareKernel<T, std::greater<T>>;
+      case ComparisonDirection::kLe:
+        return &CompareKernel<T, std::less_equal<T>>;
+      case ComparisonDirection::kLt:
+        return &CompareKernel<T, std::less<T>>;
+    }
+    return nullptr;
+  });
+}
+
+Kernel GetKernel(const HloInstruction* instruction) {
+  const PrimitiveType type = instruction->shape().element_type();
+  switch (instruction->opcode()) {
+    case HloOpcode::kAdd:
+      return GetElementwiseKernel<AddOp>(type, /*allow_pred=*/false);
+    case HloOpcode::kSubtract:
+      return GetElementwiseKernel<SubtractOp>(type, /*allow_pred=*/false);
+    case HloOpcode::kMultiply:
+      return GetElementwiseKernel<MultiplyOp>(type, /*allow_pred=*/false);
+    case HloOpcode::kDivide:
+      return GetElementwiseKernel<DivideOp>(type, /*allow_pred=*/false);
+    case HloOpcode::kRemainder:
+      return GetElementwiseKernel<RemainderOp>(type, /*allow_pred=*/false);
+    case HloOpcode::kMaximum:
+      return GetElementwiseKernel<MaximumOp>(type, /*allow_pred=*/true);
+    case HloOpcode::kMinimum:
+      return GetElementwiseKernel<MinimumOp>(type, /*allow_pred=*/true);
+    case HloOpcode::kAnd:
+      return GetElementwiseKernel<AndOp>(type, /*allow_pred=*/true);
+    case HloOpcode::kOr:
+      return GetElementwiseKernel<OrOp>(type, /*allow_pred=*/true);
+    case HloOpcode::kXor:
+      return GetElementwiseKernel<XorOp>(type, /*allow_pred=*/true);
+    case HloOpcode::kNot:
+      return GetElementwiseKernel<NotOp, /*kUnary=*/true>(type,
+                                                         /*allow_pred=*/true);
+    case HloOpcode::kNegate:
+      return GetElementwiseKernel<NegateOp, /*kUnary=*/true>(
+          type, /*allow_pred=*/false);
+    case HloOpcode::kAbs:
+      return GetElementwiseKernel<AbsOp, /*kUnary=*/true>(type,
+                                                         /*allow_pred=*/false);
+    case HloOpcode::kCompare:
+      return GetCompareKernel(instruction->operand(0)->shape().element_type(),
+                              instruction->comparison_direction());
+    case HloOpcode::kSelect:
+      return &SelectKernel;
+    case HloOpcode::kConvert:
+    case HloOpcode::kCopy:
+      return SwitchSupportedType<Kernel>(type, [](auto native) -> Kernel {
+        return &ConvertKernel<decltype(native)>;
+      });
+    default:
+      return nullptr;
+  }
+}
+
+Status CheckScalar(const Shape& shape, PrimitiveType type, int64_t index) {
+  if (!ShapeUtil::IsScalarWithElementType(shape, type)) {
+    return InvalidArgument("Expected input %d to be a %s scalar, but got %s",
+                           index, PrimitiveType_Name(type),
+                           ShapeUtil::HumanString(shape));
+  }
+  return OkStatus();
+}
+
+int64_t ReadSlot(const Literal& literal) {
+  return SwitchSupportedType<int64_t>(
+      literal.shape().element_type(), [&](auto native) -> int64_t {
+        using T = decltype(native);
+        return static_cast<int64_t>(literal.GetFirstElement<T>());
+      });
+}
+
+void WriteSlot(int64_t slot, Literal* literal) {
+  SwitchSupportedType<bool>(literal->shape().element_type(),
+                            [&](auto native) -> bool {
+                              using T = decltype(native);
+                              literal->Set<T>({}, static_cast<T>(slot));
+                              return true;
+                            });
+}
+
+}  // namespace
+
+/*static*/ StatusOr<HloEvaluationPlan> HloEvaluationPlan::Compile(
+    const HloInstruction* root,
+    absl::Span<const HloInstruction* const> inputs) {
+  HloEvaluationPlan plan;
+  for (const HloInstruction* input : inputs) {
+    const PrimitiveType type = input->shape().element_type();
+    if (!ShapeUtil::IsScalar(input->shape()) || !IsSupportedType(type)) {
+      return Unimplemented("Can't lower input %s", input->ToShortString());
+    }
+    const int64_t slot = plan.slots_.size();
+    if (!plan.instruction_slots_.emplace(input, slot).second) {
+      return InvalidArgument("Duplicate input %s", input->name());
+    }
+    plan.slots_.push_back(0);
+    plan.input_slots_.push_back(slot);
+    plan.input_types_.push_back(type);
+  }
+  TF_ASSIGN_OR_RETURN(plan.root_slot_, plan.Lower(root));
+  plan.root_type_ = root->shape().element_type();
+  plan.instruction_slots_.clear();
+  return std::move(plan);
+}
+
+StatusOr<int64_t> HloEvaluationPlan::Lower(const HloInstruction* instruction) {
+  if (auto it = instruction_slots_.find(instruction);
+      it != instruction_slots_.end()) {
+    return it->second;
+  }
+  if (!ShapeUtil::IsScalar(instruction->shape()) ||
+      !IsSupportedType(instruction->shape().element_type())) {
+    return Unimplemented("Can't lower %s", instruction->ToShortString());
+  }
+
+  const int64_t num_operands = instruction->operand_count();
+  Step step{nullptr, 0, {0, 0, 0}};
+  if (instruction->opcode() == HloOpcode::kConstant) {
+    step.dst = slots_.size();
+    slots_.push_back(ReadSlot(instruction->literal()));
+    instruction_slots_[instruction] = step.dst;
+    return step.dst;
+  }
+  step.kernel = num_operands <= step.operands.size() ? GetKernel(instruction)
+                                                     : nullptr;
+  if (step.kernel == nullptr) {
+    return Unimplemented("Can't lower %s", instruction->ToShortString());
+  }
+  for (int64_t i = 0; i < num_operands; ++i) {
+    TF_ASSIGN_OR_RETURN(step.operands[i], Lower(instruction->operand(i)));
+  }
+  step.dst = slots_.size();
+  slots_.push_back(0);
+  steps_.push_back(step);
+  instruction_slots_[instruction] = step.dst;
+  return step.dst;
+}
+
+Status HloEvaluationPlan::Evaluate(absl::Span<const Literal* const> inputs,
+                                   Literal* result) {
+  if (inputs.size() != input_slots_.size()) {
+    return InvalidArgument("Expected %d inputs, but got %d",
+                           input_slots_.size(), inputs.size());
+  }
+  for (int64_t i = 0; i < inputs.size(); ++i) {
+    TF_RETURN_IF_ERROR(CheckScalar(inputs[i]->shape(), input_types_[i], i));
+    slots_[input_slots_[i]] = ReadSlot(*inputs[i]);
+  }
+  for (const Step& step : steps_) {
+    step.kernel(slots_.data(), step.dst, step.operands.data());
+  }
+  if (!ShapeUtil::IsScalarWithElementType(result->shape(), root_type_)) {
+    *result = Literal(ShapeUtil::MakeScalarShape(root_type_));
+  }
+  WriteSlot(slots_[root_slot_], result);
+  return OkStatus();
+}
+
+StatusOr<Literal> HloEvaluationPlan::Evaluate(
+    absl::Span<const Literal* const> inputs) {
+  Literal result(ShapeUtil::MakeScalarShape(root_type_));
+  TF_RETURN_IF_ERROR(Evaluate(inputs, &result));
+  return std::move(result);
+}
+
+}  // namespace xla
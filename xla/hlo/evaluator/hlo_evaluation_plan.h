@@ -0,0 +1,94 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_HLO_EVALUATOR_HLO_EVALUATION_PLAN_H_
+#define XLA_HLO_EVALUATOR_HLO_EVALUATION_PLAN_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/literal.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla {
+
+// Instructions lowered once into a sequence of typed kernels over preallocated
+// scalar slots, so that they can be evaluated many times much more cheaply than
+// with HloEvaluator, which dispatches on the opcode and the element type and
+// allocates literals for every instruction of every evaluation. This is meant
+// for the small scalar computations that are evaluated repeatedly, e.g. the
+// condition and induction variable update of a while loop while brute-forcing
+// its trip count.
+//
+// Only scalar integer and predicate instructions with elementwise opcodes,
+// compares, selects, converts and constants can be lowered; Compile fails for
+// anything else, and callers are expected to fall back to HloEvaluator. The
+// results are the same as HloEvaluator's, including for integer overflows and
+// divisions by zero.
+//
+// Note: this class is not thread safe, as evaluations share the slots.
+class HloEvaluationPlan {
+ public:
+  // Lowers `root` and the instructions it depends on, except for `inputs`
+  // whose values are given to each evaluation.
+  static StatusOr<HloEvaluationPlan> Compile(
+      const HloInstruction* root,
+      absl::Span<const HloInstruction* const> inputs);
+
+  // Evaluates the plan for the scalar literals `inputs`, in the order given to
+  // Compile, and sets `*result` to the value of the root. `*result` is only
+  // reallocated if it doesn't have the shape of the root already.
+  Status Evaluate(absl::Span<const Literal* const> inputs, Literal* result);
+
+  StatusOr<Literal> Evaluate(absl::Span<const Literal* const> inputs);
+
+ private:
+  // Computes `slots[dst]` from `slots[operands[i]]`. Slots hold the values of
+  // the instructions cast to int64_t, which is lossless for all the supported
+  // element types.
+  using Kernel = void (*)(int64_t* slots, int64_t dst, const int64_t* operands);
+
+  struct Step {
+    Kernel kernel;
+    int64_t dst;
+    std::array<int64_t, 3> operands;
+  };
+
+  HloEvaluationPlan() = default;
+
+  // Returns the slot holding the value of `instruction`, lowering it first if
+  // needed.
+  StatusOr<int64_t> Lower(const HloInstruction* instruction);
+
+  std::vector<Step> steps_;
+  // Slots of the constants are set once by Compile.
+  std::vector<int64_t> slots_;
+  std::vector<int64_t> input_slots_;
+  std::vector<PrimitiveType> input_types_;
+  int64_t root_slot_ = 0;
+  PrimitiveType root_type_ = PRIMITIVE_TYPE_INVALID;
+  // Slots of the instructions lowered so far, only used by Compile.
+  absl::flat_hash_map<const HloInstruction*, int64_t> instruction_slots_;
+};
+
+}  // namespace xla
+
+#endif  // XLA_HLO_EVALUATOR_HLO_EVALUATION_PLAN_H_
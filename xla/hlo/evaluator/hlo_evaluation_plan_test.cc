@@ -0,0 +1,166 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/hlo/evaluator/hlo_evaluation_plan.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "xla/hlo/evaluator/hlo_evaluator.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/test.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+class HloEvaluationPlanTest : public HloTestBase {
+ protected:
+  // Checks that the plan of the entry computation of `hlo` computes the same
+  // values as HloEvaluator for all the `inputs`.
+  template <typename T>
+  void ExpectSameAsEvaluator(absl::string_view hlo,
+                             absl::Span<const T> inputs) {
+    TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo));
+    const HloComputation* entry = module->entry_computation();
+    TF_ASSERT_OK_AND_ASSIGN(
+        HloEvaluationPlan plan,
+        HloEvaluationPlan::Compile(entry->root_instruction(),
+                                   {entry->parameter_instruction(0)}));
+    Literal result;
+    for (T input : inputs) {
+      Literal input_literal = LiteralUtil::CreateR0<T>(input);
+      TF_ASSERT_OK(plan.Evaluate({&input_literal}, &result));
+      HloEvaluator evaluator;
+      TF_ASSERT_OK_AND_ASSIGN(Literal expected,
+                              evaluator.Evaluate(*entry, {&input_literal}));
+      EXPECT_EQ(result, expected) << input;
+    }
+  }
+};
+
+TEST_F(HloEvaluationPlanTest, SignedArithmetic) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+ENTRY e {
+  p = s8[] parameter(0)
+  c = s8[] constant(-1)
+  zero = s8[] constant(0)
+  add = s8[] add(p, p)
+  mul = s8[] multiply(add, p)
+  div = s8[] divide(mul, c)
+  div_by_zero = s8[] divide(p, zero)
+  rem = s8[] remainder(div, p)
+  neg = s8[] negate(rem)
+  abs = s8[] abs(neg)
+  max = s8[] maximum(abs, div_by_zero)
+  ROOT sub = s8[] subtract(max, p)
+})";
+  const int8_t kInputs[] = {0,   1,
+                            -1,  7,
+                            100, std::numeric_limits<int8_t>::min(),
+                            std::numeric_limits<int8_t>::max()};
+  ExpectSameAsEvaluator<int8_t>(kHlo, kInputs);
+}
+
+TEST_F(HloEvaluationPlanTest, UnsignedArithmeticAndConverts) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+ENTRY e {
+  p = u32[] parameter(0)
+  c = u32[] constant(3)
+  zero = u32[] constant(0)
+  div = u32[] divide(p, c)
+  div_by_zero = u32[] divide(p, zero)
+  rem_by_zero = u32[] remainder(p, zero)
+  xor = u32[] xor(div, div_by_zero)
+  or = u32[] or(xor, rem_by_zero)
+  not = u32[] not(or)
+  s64 = s64[] convert(not)
+  s16 = s16[] convert(s64)
+  ROOT pred = pred[] convert(s16)
+})";
+  const uint32_t kInputs[] = {0, 1, 3, 65536, 4294967295u};
+  ExpectSameAsEvaluator<uint32_t>(kHlo, kInputs);
+}
+
+TEST_F(HloEvaluationPlanTest, CompareAndSelect) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+ENTRY e {
+  p = s64[] parameter(0)
+  c = s64[] constant(10)
+  lt = pred[] compare(p, c), direction=LT
+  ge = pred[] compare(p, c), direction=GE
+  both = pred[] and(lt, ge)
+  either = pred[] or(lt, both)
+  one = s64[] constant(1)
+  inc = s64[] add(p, one)
+  sel = s64[] select(either, inc, p)
+  ROOT eq = pred[] compare(sel, c), direction=EQ
+})";
+  const int64_t kInputs[] = {0, 9, 10, 11, std::numeric_limits<int64_t>::min(),
+                             std::numeric_limits<int64_t>::max()};
+  ExpectSameAsEvaluator<int64_t>(kHlo, kInputs);
+}
+
+TEST_F(HloEvaluationPlanTest, RejectsUnsupportedInstructions) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+ENTRY e {
+  p = f32[] parameter(0)
+  ROOT add = f32[] add(p, p)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  const HloComputation* entry = module->entry_computation();
+  EXPECT_FALSE(HloEvaluationPlan::Compile(entry->root_instruction(),
+                                          {entry->parameter_instruction(0)})
+                   .ok());
+  // Parameters that are not inputs can't be lowered either.
+  EXPECT_FALSE(
+      HloEvaluationPlan::Compile(entry->root_instruction(), {}).ok());
+}
+
+TEST_F(HloEvaluationPlanTest, RejectsInputsOfTheWrongType) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+ENTRY e {
+  p = s32[] parameter(0)
+  ROOT neg = s32[] negate(p)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  const HloComputation* entry = module->entry_computation();
+  TF_ASSERT_OK_AND_ASSIGN(
+      HloEvaluationPlan plan,
+      HloEvaluationPlan::Compile(entry->root_instruction(),
+                                 {entry->parameter_instruction(0)}));
+  Literal input = LiteralUtil::CreateR0<int64_t>(1);
+  EXPECT_FALSE(plan.Evaluate({&input}).ok());
+}
+
+}  // namespace
+}  // namespace xla
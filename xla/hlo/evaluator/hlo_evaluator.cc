@@ -30,6 +30,7 @@ limitations under the License.
 #include <optional>
 #include <random>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -1154,6 +1155,48 @@ DimensionVector HloEvaluator::MakeDimMultipliers(const Shape& shape) {
   return v;
 }
 
+/*static*/ bool HloEvaluator::IsLinearlyIndexable(
+    const Shape& shape, absl::Span<const Literal* const> operands) {
+  if (!LayoutUtil::IsDenseArray(shape) || !shape.has_layout() ||
+      shape.is_dynamic()) {
+    return false;
+  }
+  return absl::c_all_of(operands, [&](const Literal* operand) {
+    const Shape& operand_shape = operand->shape();
+    return LayoutUtil::IsDenseArray(operand_shape) &&
+           !operand_shape.is_dynamic() &&
+           ShapeUtil::SameDimensions(shape, operand_shape) &&
+           LayoutUtil::MinorToMajor(shape) ==
+               LayoutUtil::MinorToMajor(operand_shape);
+  });
+}
+
+/*static*/ void HloEvaluator::ParallelForLinearIndices(
+    int64_t num_elements, absl::FunctionRef<void(int64_t, int64_t)> fn,
+    int64_t cost_per_element) {
+  // Don't bother with the thread pool for small literals, scheduling overheads
+  // dominate simple elementwise loops below this size.
+  static constexpr int64_t kMinElementsPerChunk = 64 * 1024;
+
+  const int64_t num_chunks = std::min<int64_t>(
+      std::min(ShapeUtil::GetForEachIndexParallelThreadCount(), num_elements),
+      CeilOfRatio(num_elements * std::max<int64_t>(cost_per_element, 1),
+                  kMinElementsPerChunk));
+  if (num_chunks <= 1) {
+    fn(0, num_elements);
+    return;
+  }
+
+  const int64_t chunk_size = CeilOfRatio(num_elements, num_chunks);
+  ShapeUtil::ForEachIndexParallel(
+      ShapeUtil::MakeShape(S64, {num_chunks}),
+      [&](absl::Span<const int64_t> chunk, int) -> StatusOr<bool> {
+        int64_t begin = chunk[0] * chunk_size;
+        fn(begin, std::min(begin + chunk_size, num_elements));
+        return true;
+      });
+}
+
 Status HloEvaluator::EvaluateInternal(
     const HloInstruction* instruction, const ShapeIndex& shape_index,
     bool recursively_evaluate_nonconstant_operands) {
@@ -4167,18 +4210,119 @@ Status HloEvaluator::HandleStochasticConvert(
   return OkStatus();
 }
 
-static bool IsScalarAdd(HloComputation* computation) {
+// Returns the opcode of a reduction computation which applies a single
+// commutative binary operation to its two scalar parameters, e.g.
+// `add(p0, p1)`, or std::nullopt if the computation has any other form.
+static std::optional<HloOpcode> GetScalarReductionOpcode(
+    HloComputation* computation) {
   HloInstruction* instruction = computation->root_instruction();
-  if (instruction->opcode() == HloOpcode::kAdd &&
-      computation->num_parameters() == 2) {
-    const HloInstruction* lhs = instruction->operand(0);
-    const HloInstruction* rhs = instruction->operand(1);
-    return lhs->opcode() == HloOpcode::kParameter &&
-           ShapeUtil::IsScalar(lhs->shape()) &&
-           rhs->opcode() == HloOpcode::kParameter &&
-           ShapeUtil::IsScalar(rhs->shape()) && lhs != rhs;
-  }
-  return false;
+  switch (instruction->opcode()) {
+    case HloOpcode::kAdd:
+    case HloOpcode::kMultiply:
+    case HloOpcode::kMaximum:
+    case HloOpcode::kMinimum:
+      break;
+    default:
+      return std::nullopt;
+  }
+  if (computation->num_parameters() != 2) return std::nullopt;
+
+  const HloInstruction* lhs = instruction->operand(0);
+  const HloInstruction* rhs = instruction->operand(1);
+  if (lhs->opcode() == HloOpcode::kParameter &&
+      ShapeUtil::IsScalar(lhs->shape()) &&
+      rhs->opcode() == HloOpcode::kParameter &&
+      ShapeUtil::IsScalar(rhs->shape()) && lhs != rhs &&
+      ShapeUtil::Equal(lhs->shape(), instruction->shape()) &&
+      ShapeUtil::Equal(rhs->shape(), instruction->shape())) {
+    return instruction->opcode();
+  }
+  return std::nullopt;
+}
+
+static bool IsScalarAdd(HloComputation* computation) {
+  return GetScalarReductionOpcode(computation) == HloOpcode::kAdd;
+}
+
+// Returns true if reductions with `opcode` over `type` elements can be
+// computed directly on native values, with results identical to evaluating
+// the reduction computation with the HloEvaluator. Reduced precision types
+// are excluded, as the evaluator computes them in a wider type.
+static bool IsFastReductionSupported(HloOpcode opcode, PrimitiveType type) {
+  switch (type) {
+    case S8:
+    case S16:
+    case S32:
+    case S64:
+    case U8:
+    case U16:
+    case U32:
+    case U64:
+      return true;
+    case F32:
+    case F64:
+      // Floating point additions use the double precision fast path below.
+      return opcode != HloOpcode::kAdd;
+    default:
+      return false;
+  }
+}
+
+// Applies reduction `opcode` to native values with the HloEvaluator semantics:
+// integer arithmetic wraps around and minimum/maximum propagate NaNs.
+template <typename NativeT>
+static NativeT ApplyScalarReduction(HloOpcode opcode, NativeT lhs,
+                                    NativeT rhs) {
+  if constexpr (std::is_integral_v<NativeT>) {
+    switch (opcode) {
+      case HloOpcode::kAdd:
+        return static_cast<NativeT>(ToArithmeticSafeType(lhs) +
+                                    ToArithmeticSafeType(rhs));
+      case HloOpcode::kMultiply:
+        return static_cast<NativeT>(ToArithmeticSafeType(lhs) *
+                                    ToArithmeticSafeType(rhs));
+      default:
+        break;
+    }
+  } else {
+    switch (opcode) {
+      case HloOpcode::kAdd:
+        return lhs + rhs;
+      case HloOpcode::kMultiply:
+        return lhs * rhs;
+      default:
+        break;
+    }
+    if (std::isnan(lhs)) return lhs;
+    if (std::isnan(rhs)) return rhs;
+  }
+  return opcode == HloOpcode::kMaximum ? std::max(lhs, rhs)
+                                       : std::min(lhs, rhs);
+}
+
+// Reduces elements of `input` selected by `base`, `counts` and `steps` into
+// the `output_index` element of `result` without evaluating the reduction
+// computation for every element.
+template <typename NativeT>
+static void ReduceOutputElementWithOpcode(
+    HloOpcode opcode, const Literal& input, const Literal& init_value,
+    Literal& result, absl::Span<const int64_t> output_index,
+    absl::Span<const int64_t> base, absl::Span<const int64_t> counts,
+    absl::Span<const int64_t> steps) {
+  const Shape& shape = input.shape();
+  absl::Span<const int64_t> minor_to_major = LayoutUtil::MinorToMajor(shape);
+  absl::Span<const NativeT> data = input.data<NativeT>();
+
+  NativeT accumulator = init_value.Get<NativeT>({});
+  ShapeUtil::ForEachIndexNoStatus(
+      shape, base, counts, steps, [&](absl::Span<const int64_t> input_index) {
+        int64_t linear_index = IndexUtil::MultidimensionalIndexToLinearIndex(
+            shape, minor_to_major, input_index);
+        accumulator =
+            ApplyScalarReduction(opcode, accumulator, data[linear_index]);
+        return true;
+      });
+  result.Set<NativeT>(output_index, accumulator);
 }
 
 // Run a single step of an inner loop while running reduction, which applies
@@ -4245,7 +4389,8 @@ static StatusOr<bool> GenerateReduceOutputElement(
 
     absl::Span<const int64_t> arg_dim_steps,
     absl::Span<const int64_t> arg_dim_counts,
-    absl::Span<const int64_t> result_to_arg_index) {
+    absl::Span<const int64_t> result_to_arg_index,
+    std::optional<HloOpcode> fast_reduction_opcode) {
   bool use_fast_add = ShapeUtil::ElementIsFloating(init_values[0]->shape()) &&
                       IsScalarAdd(function) && !is_tuple;
 
@@ -4294,6 +4439,27 @@ static StatusOr<bool> GenerateReduceOutputElement(
     return true;
   }
 
+  if (fast_reduction_opcode.has_value()) {
+    primitive_util::PrimitiveTypeSwitch<void>(
+        [&](auto primitive_type_constant) {
+          if constexpr (primitive_util::IsArrayType(primitive_type_constant)) {
+            using NativeT =
+                primitive_util::NativeTypeOf<primitive_type_constant>;
+            if constexpr ((std::is_integral_v<NativeT> &&
+                           !std::is_same_v<NativeT, bool>) ||
+                          std::is_same_v<NativeT, float> ||
+                          std::is_same_v<NativeT, double>) {
+              ReduceOutputElementWithOpcode<NativeT>(
+                  *fast_reduction_opcode, *input_args[0], *init_values[0],
+                  results[0], output_index, base, arg_dim_counts,
+                  arg_dim_steps);
+            }
+          }
+        },
+        arg_shape.element_type());
+    return true;
+  }
+
   // Iterates only over reduced shape, as counts and steps are set to zero
   // for all non-reduced dimensions.
   TF_RETURN_IF_ERROR(ShapeUtil::ForEachIndexWithStatus(
@@ -4369,11 +4535,28 @@ Status HloEvaluator::HandleReduce(const HloInstruction* hlo) {
     }
   }
 
+  // Simple single-operand reductions, e.g. max or integer add, are computed
+  // directly on native values instead of evaluating the reduction computation
+  // for every input element.
+  std::optional<HloOpcode> fast_reduction_opcode;
+  if (!is_tuple) {
+    std::optional<HloOpcode> opcode = GetScalarReductionOpcode(function);
+    if (opcode.has_value() &&
+        arg_shape.element_type() == output_shape.element_type() &&
+        init_values[0]->shape().element_type() == arg_shape.element_type() &&
+        LayoutUtil::IsDenseArray(arg_shape) &&
+        IsFastReductionSupported(*opcode, arg_shape.element_type())) {
+      fast_reduction_opcode = opcode;
+    }
+  }
+
   const int num_threads = ShapeUtil::GetForEachIndexParallelThreadCount() + 1;
   std::vector<std::unique_ptr<HloEvaluator>> embedded_evaluators;
-  embedded_evaluators.reserve(num_threads);
-  for (int i = 0; i < num_threads; ++i) {
-    embedded_evaluators.push_back(CreateEmbedded(max_loop_iterations_));
+  if (!fast_reduction_opcode.has_value()) {
+    embedded_evaluators.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      embedded_evaluators.push_back(CreateEmbedded(max_loop_iterations_));
+    }
   }
 
   absl::InlinedVector<Literal, 1> results(num_args);
@@ -4386,8 +4569,11 @@ Status HloEvaluator::HandleReduce(const HloInstruction* hlo) {
         return GenerateReduceOutputElement(
             is_tuple, output_index, init_values, input_args,
             absl::Span<Literal>(results), function,
-            embedded_evaluators[thread_id + 1].get(), arg_dim_steps,
-            arg_dim_counts, result_to_arg_index);
+            fast_reduction_opcode.has_value()
+                ? nullptr
+                : embedded_evaluators[thread_id + 1].get(),
+            arg_dim_steps, arg_dim_counts, result_to_arg_index,
+            fast_reduction_opcode);
       }));
 
   if (is_tuple) {
@@ -4651,11 +4837,19 @@ std::unique_ptr<Array2D<T>> MatmulArray2DImpl(
   // Because Eigen is a header-oriented library, make sure that the Eigen code
   // is the same as the code used by the CPU backend (otherwise the linker will
   // randomly pick *some* definition).
-  impl_fn(
-      /*run_options_ptr=*/nullptr, result->data(), rhs.data(), lhs.data(), n, m,
-      k,
-      /*transpose_lhs=*/0,
-      /*transpose_rhs=*/0);
+  //
+  // The matrices are row major, so each chunk of rows of `lhs` is contiguous
+  // and computes the same rows of the result, in parallel with the others.
+  HloEvaluator::ParallelForLinearIndices(
+      m,
+      [&](int64_t begin, int64_t end) {
+        impl_fn(
+            /*run_options_ptr=*/nullptr, result->data() + begin * n,
+            rhs.data(), lhs.data() + begin * k, n, end - begin, k,
+            /*transpose_lhs=*/0,
+            /*transpose_rhs=*/0);
+      },
+      /*cost_per_element=*/int64_t{n} * k);
   return result;
 }
 }  // namespace
@@ -24,6 +24,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/types/span.h"
 #include "xla/array2d.h"
 #include "xla/hlo/ir/dfs_hlo_visitor_with_default.h"
@@ -233,6 +234,14 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
   static std::unique_ptr<Array2D<int32_t>> MatmulArray2D(
       const Array2D<int32_t>& lhs, const Array2D<int32_t>& rhs);
 
+  // Splits linear indices [0, num_elements) into contiguous chunks and calls
+  // `fn(begin, end)` for each of them. Large ranges are processed in parallel
+  // on the ShapeUtil::ForEachIndexParallel thread pool. `cost_per_element` is
+  // the work of one index relative to a simple elementwise operation.
+  static void ParallelForLinearIndices(
+      int64_t num_elements, absl::FunctionRef<void(int64_t, int64_t)> fn,
+      int64_t cost_per_element = 1);
+
  protected:
   // Evaluates the given instruction, and stores the evaluation result in the
   // evaluated_ map.
@@ -433,6 +442,12 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
   bool use_fast_path_ = false;
 
  private:
+  // Returns true if all `operands` are dense arrays with the same dimensions
+  // and physical layout as `shape`, so that an elementwise operation can
+  // iterate over their data linearly instead of going through multi-indices.
+  static bool IsLinearlyIndexable(const Shape& shape,
+                                  absl::Span<const Literal* const> operands);
+
   template <typename ReturnT, typename NativeT>
   static StatusOr<Literal> ElementWiseUnaryOpImpl(
       const HloInstruction* instruction,
@@ -443,6 +458,18 @@ class HloEvaluator : public ConstDfsHloVisitorWithDefault {
     TF_RET_CHECK(ShapeUtil::SameDimensions(shape, operand->shape()));
 
     Literal result(shape);
+    if (IsLinearlyIndexable(shape, {&operand_literal})) {
+      absl::Span<const NativeT> operand_data = operand_literal.data<NativeT>();
+      absl::Span<ReturnT> result_data = result.data<ReturnT>();
+      ParallelForLinearIndices(
+          result_data.size(), [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+              result_data[i] = unary_op(operand_data[i]);
+            }
+          });
+      return std::move(result);
+    }
+
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return unary_op(operand_literal.Get<NativeT>(multi_index));
@@ -14,7 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "xla/hlo/evaluator/hlo_evaluator.h"
 
+#include <cmath>
 #include <initializer_list>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -4998,6 +5000,116 @@ TEST_F(HloEvaluatorTest, SlowReduceWindow) {
               ::testing::ElementsAreArray(expected));
 }
 
+TEST_F(HloEvaluatorTest, ReduceMaxPropagatesNaN) {
+  constexpr absl::string_view kHloModule = R"(
+    HloModule ReduceMax
+    %max {
+      %lhs = f32[] parameter(0)
+      %rhs = f32[] parameter(1)
+      ROOT %max = f32[] maximum(%lhs, %rhs)
+    }
+    ENTRY reduce_max {
+      %input = f32[2,3] parameter(0)
+      %init = f32[] constant(-inf)
+      ROOT %reduce = f32[2] reduce(%input, %init), dimensions={1}, to_apply=%max
+    }
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> hlo_module,
+                          ParseAndReturnVerifiedModule(kHloModule));
+  const float kNaN = std::numeric_limits<float>::quiet_NaN();
+  auto input = LiteralUtil::CreateR2<float>({{1.f, 5.f, 3.f}, {2.f, kNaN, 7.f}});
+  HloEvaluator evaluator;
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal actual_literal,
+      evaluator.Evaluate(*hlo_module->entry_computation(), {&input}));
+  EXPECT_EQ(actual_literal.Get<float>({0}), 5.f);
+  EXPECT_TRUE(std::isnan(actual_literal.Get<float>({1})));
+}
+
+TEST_F(HloEvaluatorTest, ReduceMultiplyWrapsAround) {
+  constexpr absl::string_view kHloModule = R"(
+    HloModule ReduceMultiply
+    %mul {
+      %lhs = s8[] parameter(0)
+      %rhs = s8[] parameter(1)
+      ROOT %mul = s8[] multiply(%lhs, %rhs)
+    }
+    ENTRY reduce_multiply {
+      %input = s8[2,2] parameter(0)
+      %init = s8[] constant(1)
+      ROOT %reduce = s8[2] reduce(%input, %init), dimensions={0}, to_apply=%mul
+    }
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> hlo_module,
+                          ParseAndReturnVerifiedModule(kHloModule));
+  auto input = LiteralUtil::CreateR2<int8_t>({{16, -3}, {16, 5}});
+  HloEvaluator evaluator;
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal actual_literal,
+      evaluator.Evaluate(*hlo_module->entry_computation(), {&input}));
+  // 16 * 16 = 256 wraps around to 0.
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<int8_t>({0, -15}),
+                                     actual_literal));
+}
+
+TEST_F(HloEvaluatorTest, ReduceMultiplyU16WrapsAround) {
+  constexpr absl::string_view kHloModule = R"(
+    HloModule ReduceMultiply
+    %mul {
+      %lhs = u16[] parameter(0)
+      %rhs = u16[] parameter(1)
+      ROOT %mul = u16[] multiply(%lhs, %rhs)
+    }
+    ENTRY reduce_multiply {
+      %input = u16[3] parameter(0)
+      %init = u16[] constant(1)
+      ROOT %reduce = u16[] reduce(%input, %init), dimensions={0}, to_apply=%mul
+    }
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> hlo_module,
+                          ParseAndReturnVerifiedModule(kHloModule));
+  auto input = LiteralUtil::CreateR1<uint16_t>({65535, 65535, 3});
+  HloEvaluator evaluator;
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal actual_literal,
+      evaluator.Evaluate(*hlo_module->entry_computation(), {&input}));
+  // 65535 * 65535 overflows int, but must wrap around modulo 2^16 to 1.
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR0<uint16_t>(3),
+                                     actual_literal));
+}
+
+TEST_F(HloEvaluatorTest, ElementwiseOpsWithMismatchingLayouts) {
+  constexpr absl::string_view kHloModule = R"(
+    HloModule ElementwiseLayouts
+    ENTRY elementwise {
+      %lhs = s32[2,3]{1,0} parameter(0)
+      %rhs = s32[2,3]{0,1} parameter(1)
+      %pred = pred[2,3]{1,0} parameter(2)
+      %add = s32[2,3]{1,0} add(%lhs, %rhs)
+      %neg = s32[2,3]{1,0} negate(%add)
+      ROOT %select = s32[2,3]{1,0} select(%pred, %add, %neg)
+    }
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> hlo_module,
+                          ParseAndReturnVerifiedModule(kHloModule));
+  auto lhs = LiteralUtil::CreateR2<int32_t>({{1, 2, 3}, {4, 5, 6}});
+  auto rhs = LiteralUtil::CreateR2WithLayout<int32_t>(
+      {{10, 20, 30}, {40, 50, 60}}, LayoutUtil::MakeLayout({0, 1}));
+  auto pred = LiteralUtil::CreateR2<bool>(
+      {{true, false, true}, {false, true, false}});
+  HloEvaluator evaluator;
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal actual_literal,
+      evaluator.Evaluate(*hlo_module->entry_computation(), {&lhs, &rhs, &pred}));
+  EXPECT_TRUE(LiteralTestUtil::Equal(
+      LiteralUtil::CreateR2<int32_t>({{11, -22, 33}, {-44, 55, -66}}),
+      actual_literal));
+}
+
 class PatternMatchParseWhileLoopTest : public HloTestBase {};
 
 TEST_F(PatternMatchParseWhileLoopTest, LoopBoundDefinedInsideOfCond) {
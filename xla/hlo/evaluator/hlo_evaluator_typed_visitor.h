@@ -1006,8 +1006,14 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     return HandleDotSlowPath(dot);
   }
 
-  template <typename NativeT, typename std::enable_if_t<
-                                  std::is_same_v<NativeT, float>>* = nullptr>
+  // Types with an Eigen based HloEvaluator::MatmulArray2D implementation.
+  template <typename NativeT>
+  static constexpr bool kHasFastMatmul =
+      std::is_same_v<NativeT, float> || std::is_same_v<NativeT, double> ||
+      std::is_same_v<NativeT, complex64> || std::is_same_v<NativeT, complex128>;
+
+  template <typename NativeT,
+            typename std::enable_if_t<kHasFastMatmul<NativeT>>* = nullptr>
   Status HandleDot(const HloInstruction* dot) {
     const HloInstruction* lhs = dot->operand(0);
     const HloInstruction* rhs = dot->operand(1);
@@ -1071,8 +1077,8 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     return OkStatus();
   }
 
-  template <typename NativeT, typename std::enable_if_t<
-                                  !std::is_same_v<NativeT, float>>* = nullptr>
+  template <typename NativeT,
+            typename std::enable_if_t<!kHasFastMatmul<NativeT>>* = nullptr>
   Status HandleDot(const HloInstruction* dot) {
     return HandleDotSlowPath(dot);
   }
@@ -1594,10 +1600,13 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
     return std::move(result_literal);
   }
 
-  StatusOr<Literal> ElementWiseBinaryOp(
-      const HloInstruction* instruction,
-      const std::function<ElementwiseT(ElementwiseT, ElementwiseT)>&
-          binary_op) {
+  // `BinaryOp` is a callable with an ElementwiseT(ElementwiseT, ElementwiseT)
+  // signature. We take it as a template argument and not as std::function, so
+  // that the linear loop below can inline it and the compiler can vectorize
+  // simple arithmetic.
+  template <typename BinaryOp>
+  StatusOr<Literal> ElementWiseBinaryOp(const HloInstruction* instruction,
+                                        const BinaryOp& binary_op) {
     const auto& shape = instruction->shape();
     const auto* lhs = instruction->operand(0);
     const auto* rhs = instruction->operand(1);
@@ -1609,9 +1618,28 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
 
     Literal result(shape);
 
+    // Fast path for operands with the same physical layout as the result.
+    if (HloEvaluator::IsLinearlyIndexable(shape,
+                                          {&lhs_literal, &rhs_literal})) {
+      absl::Span<const ReturnT> lhs_data = lhs_literal.data<ReturnT>();
+      absl::Span<const ReturnT> rhs_data = rhs_literal.data<ReturnT>();
+      absl::Span<ReturnT> result_data = result.data<ReturnT>();
+      HloEvaluator::ParallelForLinearIndices(
+          result_data.size(), [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+              result_data[i] = static_cast<ReturnT>(
+                  binary_op(static_cast<ElementwiseT>(lhs_data[i]),
+                            static_cast<ElementwiseT>(rhs_data[i])));
+            }
+          });
+      return std::move(result);
+    }
+
+    const std::function<ElementwiseT(ElementwiseT, ElementwiseT)> binary_fn =
+        binary_op;
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
-          return ConvertBinaryFunction(binary_op)(
+          return ConvertBinaryFunction(binary_fn)(
               lhs_literal.Get<ReturnT>(multi_index),
               rhs_literal.Get<ReturnT>(multi_index));
         }));
@@ -1636,6 +1664,23 @@ class HloEvaluatorTypedVisitor : public ConstDfsHloVisitorWithDefault {
 
     Literal result(shape);
 
+    // Fast path for operands with the same physical layout as the result.
+    if (HloEvaluator::IsLinearlyIndexable(
+            shape, {&lhs_literal, &rhs_literal, &ehs_literal})) {
+      absl::Span<const LhsType> lhs_data = lhs_literal.data<LhsType>();
+      absl::Span<const RhsType> rhs_data = rhs_literal.data<RhsType>();
+      absl::Span<const EhsType> ehs_data = ehs_literal.data<EhsType>();
+      absl::Span<ReturnT> result_data = result.data<ReturnT>();
+      HloEvaluator::ParallelForLinearIndices(
+          result_data.size(), [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; ++i) {
+              result_data[i] =
+                  ternary_op(lhs_data[i], rhs_data[i], ehs_data[i]);
+            }
+          });
+      return std::move(result);
+    }
+
     TF_RETURN_IF_ERROR(result.PopulateParallel<ReturnT>(
         [&](absl::Span<const int64_t> multi_index, int) {
           return ternary_op(lhs_literal.Get<LhsType>(multi_index),
@@ -2450,7 +2450,8 @@ AutoShardingSolverResult CallSolver(
     bool compute_iis, int64_t solver_timeout_in_seconds,
     bool allow_alias_to_follower_conversion,
     const absl::flat_hash_map<std::string, const HloInstruction*>&
-        sharding_propagation_solution) {
+        sharding_propagation_solution,
+    bool use_solution_cache) {
   // Serialize edges and edge costs to 1d numpy arrays
   AutoShardingSolverRequest request;
   request.num_nodes = leaf_strategies.size();
@@ -2461,6 +2462,7 @@ AutoShardingSolverResult CallSolver(
   request.solver_timeout_in_seconds = solver_timeout_in_seconds;
   request.crash_at_infinity_costs_check = crash_at_infinity_costs_check;
   request.compute_iis = compute_iis;
+  request.use_solution_cache = use_solution_cache;
   for (const auto& iter : cost_graph.edge_costs_) {
     request.e.push_back(iter.first);
     std::vector<double> rij;
@@ -39,7 +39,8 @@ AutoShardingSolverResult Solve(
       cost_graph, alias_set, /*s_hint*/ {}, option.memory_budget_per_device,
       /*crash_at_infinity_costs_check*/ !option.try_multiple_mesh_shapes,
       /*compute_iis*/ true, option.solver_timeout_in_seconds,
-      option.allow_alias_to_follower_conversion, sharding_propagation_solution);
+      option.allow_alias_to_follower_conversion, sharding_propagation_solution,
+      option.use_solver_solution_cache);
 }
 
 void PopulateTemporalValues(const CostGraph& cost_graph,
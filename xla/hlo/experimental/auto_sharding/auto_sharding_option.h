@@ -180,6 +180,12 @@ struct AutoShardingOption {
   // a simple replicated default.
   bool use_sharding_propagation_for_default_shardings = true;
 
+  // Reuse the solutions of previous solver invocations in this process: an
+  // identical problem, e.g. from recompiling the same model, is not solved
+  // again. A problem with the same structure but different costs, e.g. after
+  // changing the batch size, is warm started with the previous solution.
+  bool use_solver_solution_cache = false;
+
   std::string ToString() {
     std::vector<std::string> lines;
     lines.push_back(absl::StrCat("preserve_shardings: ", preserve_shardings));
@@ -244,6 +250,9 @@ struct AutoShardingOption {
     lines.push_back(absl::StrCat("device_mesh_beta: [",
                                  absl::StrJoin(device_mesh_beta, ","), "]"));
 
+    lines.push_back(absl::StrCat("use_solver_solution_cache: ",
+                                 use_solver_solution_cache));
+
     lines.push_back(absl::StrCat("load_strategy: ", load_strategy));
     if (load_strategy) {
       lines.push_back(absl::StrCat("strategy_vector: [",
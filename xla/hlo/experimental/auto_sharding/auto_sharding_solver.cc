@@ -31,11 +31,13 @@ limitations under the License.
 #endif
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "xla/hlo/experimental/auto_sharding/auto_sharding_strategy.h"
 #include "xla/util.h"
@@ -197,8 +199,124 @@ double MinimumMemoryBudgetRequired(const AutoShardingSolverRequest& request) {
 // Serialize parameters of the ILP problem as numpy arrays and call the python
 // solver.
 
+namespace {
+
+// Returns a fingerprint of the variables and constraints of the problem, but
+// not of its costs. Requests with the same structure have the same strategy
+// variables, so the solution of one is a valid hint for the other.
+uint64_t FingerprintStructure(const AutoShardingSolverRequest& request) {
+  return absl::HashOf(request.num_nodes, request.s_len, request.s_follow,
+                      request.e, request.live, request.a, request.v);
+}
+
+// Returns a fingerprint of everything that influences the solution.
+uint64_t FingerprintProblem(const AutoShardingSolverRequest& request) {
+  return absl::HashOf(FingerprintStructure(request), request.memory_budget,
+                      request.c, request.d, request.m, request.p, request.r,
+                      request.t, request.overbudget_coeff,
+                      request.makespan_coeff, request.max_departures,
+                      request.saltiplier, request.crash_at_infinity_costs_check);
+}
+
+// Process-wide cache of optimal solver solutions.
+class SolutionCache {
+ public:
+  static SolutionCache& Global() {
+    static auto* cache = new SolutionCache();
+    return *cache;
+  }
+
+  std::optional<AutoShardingSolverResult> Lookup(
+      uint64_t problem_key, const AutoShardingSolverRequest& request) {
+    absl::MutexLock lock(&mu_);
+    auto it = solutions_.find(problem_key);
+    if (it == solutions_.end()) return std::nullopt;
+    // Guard against fingerprint collisions.
+    if (it->second.s_len != request.s_len) return std::nullopt;
+    return it->second.result;
+  }
+
+  std::optional<std::vector<NodeStrategyIdx>> LookupHint(
+      uint64_t structure_key) {
+    absl::MutexLock lock(&mu_);
+    auto it = hints_.find(structure_key);
+    if (it == hints_.end()) return std::nullopt;
+    return it->second;
+  }
+
+  void Insert(uint64_t problem_key, uint64_t structure_key,
+              const AutoShardingSolverRequest& request,
+              const AutoShardingSolverResult& result) {
+    absl::MutexLock lock(&mu_);
+    solutions_.insert_or_assign(problem_key, Entry{request.s_len, result});
+    hints_.insert_or_assign(structure_key, std::get<0>(*result.status));
+  }
+
+  void Clear() {
+    absl::MutexLock lock(&mu_);
+    solutions_.clear();
+    hints_.clear();
+  }
+
+ private:
+  struct Entry {
+    std::vector<int> s_len;
+    AutoShardingSolverResult result;
+  };
+
+  absl::Mutex mu_;
+  absl::flat_hash_map<uint64_t, Entry> solutions_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<uint64_t, std::vector<NodeStrategyIdx>> hints_
+      ABSL_GUARDED_BY(mu_);
+};
+
+AutoShardingSolverResult SolveWithoutCache(
+    const AutoShardingSolverRequest& request);
+
+}  // namespace
+
 AutoShardingSolverResult CallORToolsSolver(
     const AutoShardingSolverRequest& request) {
+  if (!request.use_solution_cache) {
+    return SolveWithoutCache(request);
+  }
+
+  SolutionCache& cache = SolutionCache::Global();
+  const uint64_t problem_key = FingerprintProblem(request);
+  if (std::optional<AutoShardingSolverResult> cached =
+          cache.Lookup(problem_key, request)) {
+    LOG(INFO) << "Reusing the cached auto-sharding solution.";
+    return *std::move(cached);
+  }
+
+  const uint64_t structure_key = FingerprintStructure(request);
+  std::optional<std::vector<NodeStrategyIdx>> hint;
+  if (request.s_hint.empty()) {
+    hint = cache.LookupHint(structure_key);
+  }
+
+  AutoShardingSolverResult result = [&] {
+    if (!hint.has_value()) return SolveWithoutCache(request);
+    LOG(INFO) << "Warm starting the solver with the solution of a "
+                 "structurally identical request.";
+    AutoShardingSolverRequest hinted_request = request;
+    hinted_request.s_hint = *std::move(hint);
+    return SolveWithoutCache(hinted_request);
+  }();
+
+  // Only optimal solutions are returned with an OK status.
+  if (result.status.ok()) {
+    cache.Insert(problem_key, structure_key, request, result);
+  }
+  return result;
+}
+
+void ClearAutoShardingSolutionCache() { SolutionCache::Global().Clear(); }
+
+namespace {
+
+AutoShardingSolverResult SolveWithoutCache(
+    const AutoShardingSolverRequest& request) {
   size_t num_edges = request.e.size();
 
   int32_t num_workers = 32;
@@ -503,6 +621,8 @@ AutoShardingSolverResult CallORToolsSolver(
                                  *solver);
 }
 
+}  // namespace
+
 AutoShardingSolverResult SolveAndExtractSolution(
     const AutoShardingSolverRequest& request,
     const std::vector<std::vector<MPVariable*>>& s,
@@ -58,6 +58,11 @@ struct AutoShardingSolverRequest {
   bool crash_at_infinity_costs_check = false;
   bool compute_iis = true;
   double saltiplier = 0.001;  // Modifies each objective term by at most 0.1%
+  // If true, optimal solutions are cached for the lifetime of the process.
+  // Identical requests reuse the cached solution. Requests with the same
+  // structure, e.g. from recompiling a model for another batch size, use the
+  // latest solution as a hint if they don't already have one.
+  bool use_solution_cache = false;
 };
 
 struct AutoShardingSolverResult {
@@ -77,6 +82,9 @@ struct AutoShardingSolverResult {
 AutoShardingSolverResult CallORToolsSolver(
     const AutoShardingSolverRequest& request);
 
+// Drops all solutions cached for requests with `use_solution_cache` set.
+void ClearAutoShardingSolutionCache();
+
 enum AutoShardingViolationCode {
   kAliasViolationCode,     // Some node's strategy does not match its alias
   kFollowerViolationCode,  // Some node's strategy does not match its follower
@@ -191,6 +191,44 @@ TEST(CallORToolsSolverTest, UsesHint) {
   EXPECT_EQ(result, expected_result);
 }
 
+TEST(CallORToolsSolverTest, ReusesCachedSolutions) {
+  ClearAutoShardingSolutionCache();
+  AutoShardingSolverRequest request = DefaultAutoShardingSolverRequest();
+  request.use_solution_cache = true;
+
+  const AutoShardingSolverResult result = CallORToolsSolver(request);
+  const AutoShardingSolverResult cached_result = CallORToolsSolver(request);
+
+  const std::vector<NodeStrategyIdx> s_val = {0, 0, 0, 0, 0};
+  const std::vector<EdgeStrategyIdx> e_val = {0, 0};
+  const double objective_value = 7650.0;
+  const AutoShardingSolverResult expected_result = {
+      std::make_tuple(
+          std::move(s_val), std::move(e_val), objective_value), false};
+  EXPECT_EQ(result, expected_result);
+  EXPECT_EQ(cached_result, expected_result);
+}
+
+TEST(CallORToolsSolverTest, WarmStartsStructurallyIdenticalRequests) {
+  ClearAutoShardingSolutionCache();
+  AutoShardingSolverRequest request = DefaultAutoShardingSolverRequest();
+  request.use_solution_cache = true;
+  ASSERT_TRUE(CallORToolsSolver(request).status.ok());
+
+  // Changing the costs keeps the structure, so the previous solution is used
+  // as a hint. The result must still be the optimum of the new problem.
+  request.c[0][0] = request.c[0][1] = request.c[0][2] = kInfinityCost;
+  const AutoShardingSolverResult result = CallORToolsSolver(request);
+
+  const std::vector<NodeStrategyIdx> s_val = {3, 0, 0, 0, 0};
+  const std::vector<EdgeStrategyIdx> e_val = {12, 0};
+  const double objective_value = 10683.0;
+  const AutoShardingSolverResult expected_result = {
+      std::make_tuple(
+          std::move(s_val), std::move(e_val), objective_value), false};
+  EXPECT_EQ(result, expected_result);
+}
+
 TEST(AutoShardingEvaluatorTest, NoViolations) {
   const AutoShardingSolverRequest request = DefaultAutoShardingSolverRequest();
   const std::vector<NodeStrategyIdx> s_val = {3, 1, 2, 2, 1};
@@ -41,7 +41,8 @@ AutoShardingSolverResult CallSolver(
     bool compute_iis, int64_t solver_timeout_in_seconds,
     bool allow_alias_to_follower_conversion,
     const absl::flat_hash_map<std::string, const HloInstruction*>&
-        sharding_propagation_solution = {});
+        sharding_propagation_solution = {},
+    bool use_solution_cache = false);
 
 }  // namespace spmd
 }  // namespace xla
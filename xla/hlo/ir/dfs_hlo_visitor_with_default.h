@@ -315,6 +315,10 @@ class DfsHloRewriteVisitor : public DfsHloVisitorWithDefault {
 
   bool changed() const { return changed_; }
 
+  // Returns the number of changes made so far, e.g. to find out whether
+  // handling a given instruction changed anything.
+  int64_t num_changes() const { return num_changes_; }
+
  protected:
   // Replaces the existing HLO instruction old_instruction, with
   // new_instruction, and marks the optimizer status as changed.
@@ -329,6 +333,7 @@ class DfsHloRewriteVisitor : public DfsHloVisitorWithDefault {
         old_instruction, std::move(new_instruction));
     if (ABSL_PREDICT_TRUE(status.ok())) {
       changed_ = true;
+      ++num_changes_;
     }
     return status;
   }
@@ -344,8 +349,9 @@ class DfsHloRewriteVisitor : public DfsHloVisitorWithDefault {
             << "\n  new: " << new_instruction->ToString();
     StatusOr<bool> changed_or = old_instruction->parent()->ReplaceInstruction(
         old_instruction, new_instruction, preserve_sharding);
-    if (ABSL_PREDICT_TRUE(changed_or.ok())) {
-      changed_ |= changed_or.value();
+    if (ABSL_PREDICT_TRUE(changed_or.ok()) && changed_or.value()) {
+      changed_ = true;
+      ++num_changes_;
     }
     return changed_or;
   }
@@ -362,10 +368,14 @@ class DfsHloRewriteVisitor : public DfsHloVisitorWithDefault {
   }
 
   // Mark the computation as having changed.
-  void MarkAsChanged() { changed_ = true; }
+  void MarkAsChanged() {
+    changed_ = true;
+    ++num_changes_;
+  }
 
  private:
   bool changed_ = false;
+  int64_t num_changes_ = 0;
 };
 
 // (Const)FunctionVisitor lets you transform an
@@ -137,8 +137,7 @@ HloInstruction* HloComputation::AddInstruction(
 HloInstruction* HloComputation::AddInstructionInternal(
     std::unique_ptr<HloInstruction> instruction) {
   if (parent() != nullptr) {
-    instruction->UniquifyName(&parent()->instruction_name_uniquer());
-    instruction->SetUniqueId(parent()->NewUniqueInstructionId());
+    parent()->UniquifyInstructionNameAndId(instruction.get());
   }
   instruction->set_parent(this);
   HloInstruction* pinst = instruction.get();
@@ -1398,11 +1397,13 @@ std::unique_ptr<HloComputation> HloComputation::CloneInContext(
   // does -- we only care about operand dependencies -- so let's just do it
   // ourselves.
   std::vector<const HloInstruction*> postorder;
+  postorder.reserve(instruction_count());
   absl::flat_hash_map<const HloInstruction*, VisitState> visited;
+  visited.reserve(instruction_count());
+  std::vector<const HloInstruction*> dfs_stack;
   for (const auto& instr : instructions_) {
-    std::vector<const HloInstruction*> dfs_stack;
     const HloInstruction* new_instr = replace(instr.get());
-    if (!new_instr) {
+    if (!new_instr || visited.contains(new_instr)) {
       continue;
     }
     dfs_stack.push_back(new_instr);
@@ -1424,7 +1425,7 @@ std::unique_ptr<HloComputation> HloComputation::CloneInContext(
       visited.insert({cur, kVisiting});
       for (HloInstruction* operand : cur->operands()) {
         const HloInstruction* new_operand = replace(operand);
-        if (new_operand) {
+        if (new_operand && !visited.contains(new_operand)) {
           dfs_stack.emplace_back(new_operand);
         }
       }
@@ -1432,14 +1433,16 @@ std::unique_ptr<HloComputation> HloComputation::CloneInContext(
   }
 
   std::vector<std::unique_ptr<HloInstruction>> instructions;
+  instructions.reserve(extra_parameters.size() + postorder.size());
   // First add the extra parameters to 'instructions'.
   for (const auto& instr : extra_parameters) {
     CHECK_EQ(instr->opcode(), HloOpcode::kParameter)
         << "Only parameter instructions are allowed in 'extra_parameters'";
     instructions.emplace_back(instr->Clone());
   }
+  std::vector<HloInstruction*> new_operands;
   for (auto instr : postorder) {
-    std::vector<HloInstruction*> new_operands;
+    new_operands.clear();
     for (auto operand : instr->operands()) {
       auto replaced_operand = replace(operand);
       CHECK_NE(replaced_operand, nullptr)
@@ -2297,7 +2297,7 @@ void HloInstruction::DetachFromOperandsAndUsers() {
     if (operand == nullptr) {
       continue;
     }
-    if (operand->user_map_.find(this) != operand->user_map_.end()) {
+    if (operand->HasUser(this)) {
       operand->RemoveUser(this);
     }
     operands_[operand_num] = nullptr;
@@ -2571,17 +2571,50 @@ void HloInstruction::RemoveOperandsAtAscendingIndices(
   operands_.resize(operands_.size() - removed_count);
 }
 
+bool HloInstruction::HasUser(const HloInstruction* user) const {
+  if (user_map_ != nullptr) {
+    return user_map_->contains(user);
+  }
+  return absl::c_find(users_, user) != users_.end();
+}
+
+void HloInstruction::RebuildUserMap() {
+  if (users_.size() <= kMaxUsersWithoutUserMap) {
+    user_map_.reset();
+    return;
+  }
+  if (user_map_ == nullptr) {
+    user_map_ =
+        std::make_unique<absl::flat_hash_map<const HloInstruction*, int64_t>>();
+  }
+  user_map_->clear();
+  user_map_->reserve(users_.size());
+  for (int64_t i = 0; i < users_.size(); ++i) {
+    user_map_->emplace(users_[i], i);
+  }
+}
+
 void HloInstruction::AddUser(HloInstruction* user) {
-  if (!ContainsKey(user_map_, user)) {
-    user_map_.emplace(user, users_.size());
-    users_.push_back(user);
+  if (HasUser(user)) {
+    return;
+  }
+  users_.push_back(user);
+  if (user_map_ != nullptr) {
+    user_map_->emplace(user, users_.size() - 1);
+  } else if (users_.size() > kMaxUsersWithoutUserMap) {
+    RebuildUserMap();
   }
 }
 
 int64_t HloInstruction::UserId(HloInstruction* user) {
-  auto result = user_map_.find(user);
-  CHECK(result != user_map_.end());
-  return result->second;
+  if (user_map_ != nullptr) {
+    auto result = user_map_->find(user);
+    CHECK(result != user_map_->end());
+    return result->second;
+  }
+  auto it = absl::c_find(users_, user);
+  CHECK(it != users_.end());
+  return it - users_.begin();
 }
 
 bool HloInstruction::HasConstantOperand() const {
@@ -2746,19 +2779,19 @@ bool HloInstruction::IdenticalSlowPath(
 }
 
 void HloInstruction::RemoveUser(HloInstruction* user) {
-  auto map_it = user_map_.find(user);
-  CHECK(map_it != user_map_.end());
-
-  const int64_t index = map_it->second;
+  const int64_t index = UserId(user);
   CHECK_EQ(users_[index], user);
 
   // Move the last user into the position of the removed user.
   users_[index] = users_.back();
-  user_map_[users_.back()] = index;
+  if (user_map_ != nullptr) {
+    (*user_map_)[users_.back()] = index;
+    // Remove the user from the map.
+    user_map_->erase(user);
+  }
 
-  // Remove the user from the map and drop the last slot from the vector what
-  // have been moved to the position of the original user.
-  user_map_.erase(map_it);
+  // Drop the last slot from the vector what have been moved to the position of
+  // the original user.
   users_.pop_back();
 }
 
@@ -2905,7 +2938,7 @@ Status HloInstruction::ReplaceAllUsesWithDifferentShape(
     }
   }
   users_.clear();
-  user_map_.clear();
+  user_map_.reset();
   if (new_producer_is_user) {
     AddUser(new_producer);
   }
@@ -4716,10 +4749,7 @@ void HloInstruction::SortInstructionUsersAndControlLists(
     LOG(ERROR) << "Failed to sort instruction users for " << name() << "; "
                << status;
   }
-  user_map_.clear();
-  for (uint64_t i = 0; i < users_.size(); ++i) {
-    user_map_[users_[i]] = i;
-  }
+  RebuildUserMap();
   status = Sorter::Sort(map_fn, Sorter::IndexAfterMappedElementsFn(),
                         sorted_instruction.control_predecessors_,
                         control_predecessors_);
@@ -1277,7 +1277,7 @@ class HloInstruction {
 
   // Returns true if this instruction is a user of 'instruction'.
   bool IsUserOf(const HloInstruction* instruction) const {
-    return instruction->user_map_.contains(this);
+    return instruction->HasUser(this);
   }
 
   // Adds a control dependency from this instruction to the given
@@ -2449,13 +2449,27 @@ class HloInstruction {
   // not sure if it matters.
   std::vector<HloInstruction*> control_predecessors_;
 
+  // Returns true if `user` is in users_.
+  bool HasUser(const HloInstruction* user) const;
+
+  // Rebuilds user_map_ from users_ if the instruction has enough users for the
+  // map to pay off, and drops it otherwise.
+  void RebuildUserMap();
+
+  // Instructions with at most this many users don't have a user_map_. A linear
+  // scan over a few users is faster than a hash lookup, and most instructions
+  // have a single user, so this saves a heap allocation per instruction when
+  // building or cloning modules.
+  static constexpr int64_t kMaxUsersWithoutUserMap = 16;
+
   // The users of this instruction. Users are HLOs where this instruction is an
-  // operand. The vector users_ and the map user_map_ contain identical members.
-  // The map enables fast membership testing and the vector enables fast, stable
-  // iteration. The value in the map contains the index of the instruction in
-  // the vector what enables fast removal.
+  // operand. The vector users_ enables fast, stable iteration. Once there are
+  // more than kMaxUsersWithoutUserMap users, the map user_map_ contains the
+  // same members as users_, mapped to their index in the vector, which enables
+  // fast membership testing and removal.
   std::vector<HloInstruction*> users_;
-  absl::flat_hash_map<const HloInstruction*, int64_t> user_map_;
+  std::unique_ptr<absl::flat_hash_map<const HloInstruction*, int64_t>>
+      user_map_;
 
   // The set of control successors of this instruction.
   std::vector<HloInstruction*> control_successors_;
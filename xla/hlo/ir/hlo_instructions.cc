@@ -1553,6 +1553,13 @@ HloConstantInstruction::HloConstantInstruction(std::shared_ptr<Literal> literal,
 HloConstantInstruction::HloConstantInstruction(const Shape& shape)
     : HloInstruction(HloOpcode::kConstant, shape) {}
 
+void HloConstantInstruction::SetLiteral(Literal literal) {
+  CHECK(!HasLiteral()) << "Constant " << name() << " already has a literal";
+  CHECK(Shape::Equal().MinorToMajorOnlyInLayout()(literal.shape(), shape()))
+      << literal.shape().ToString(true) << " vs " << shape().ToString(true);
+  literal_ = std::make_shared<Literal>(std::move(literal));
+}
+
 HloInstructionProto HloConstantInstruction::ToProto() const {
   HloInstructionProto proto = HloInstruction::ToProto();
   if (literal_) {
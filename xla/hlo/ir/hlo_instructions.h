@@ -1170,6 +1170,10 @@ class HloConstantInstruction : public HloInstruction {
   }
   // Returns whether there is literal associated with this instruction.
   bool HasLiteral() const { return static_cast<bool>(literal_); }
+  // Attaches `literal` to a constant created without one, e.g. by a loader that
+  // converts large literals separately. The literal's shape must match the
+  // instruction's shape, ignoring the layout beyond minor-to-major order.
+  void SetLiteral(Literal literal);
   // Returns a serialized representation of this instruction.
   HloInstructionProto ToProto() const override;
 
@@ -0,0 +1,238 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/hlo/ir/hlo_interval_reachability.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+
+namespace xla {
+namespace {
+
+// Calls 'fn' on the users and control successors of 'instruction'.
+template <typename Fn>
+void ForEachSuccessor(const HloInstruction* instruction, Fn&& fn) {
+  for (const HloInstruction* user : instruction->users()) fn(user);
+  for (const HloInstruction* successor : instruction->control_successors()) {
+    fn(successor);
+  }
+}
+
+// Calls 'fn' on the operands and control predecessors of 'instruction'.
+template <typename Fn>
+void ForEachPredecessor(const HloInstruction* instruction, Fn&& fn) {
+  for (const HloInstruction* operand : instruction->operands()) fn(operand);
+  for (const HloInstruction* predecessor :
+       instruction->control_predecessors()) {
+    fn(predecessor);
+  }
+}
+
+// Returns the operands and control predecessors of 'instruction'.
+std::vector<const HloInstruction*> Predecessors(
+    const HloInstruction* instruction) {
+  std::vector<const HloInstruction*> predecessors;
+  ForEachPredecessor(instruction, [&](const HloInstruction* predecessor) {
+    predecessors.push_back(predecessor);
+  });
+  return predecessors;
+}
+
+}  // namespace
+
+HloIntervalReachability::HloIntervalReachability(
+    absl::Span<const HloInstruction* const> instructions)
+    : instructions_(instructions.begin(), instructions.end()),
+      visit_stamps_(instructions.size(), 0) {
+  labels_.reserve(instructions.size());
+  for (size_t i = 0; i < instructions.size(); ++i) {
+    indices_[GetKey(instructions[i])] = i;
+    labels_.push_back(Point(next_rank_++));
+  }
+}
+
+/*static*/ HloIntervalReachability::Label HloIntervalReachability::Point(
+    int64_t rank) {
+  Label label;
+  label.fill(Interval{rank, rank});
+  return label;
+}
+
+/*static*/ bool HloIntervalReachability::Contains(const Label& outer,
+                                                  const Label& inner) {
+  for (int i = 0; i < kNumOrders; ++i) {
+    if (inner[i].lo < outer[i].lo || inner[i].hi > outer[i].hi) return false;
+  }
+  return true;
+}
+
+/*static*/ void HloIntervalReachability::Extend(Label& label,
+                                                const Label& other) {
+  for (int i = 0; i < kNumOrders; ++i) {
+    label[i].lo = std::min(label[i].lo, other[i].lo);
+    label[i].hi = std::max(label[i].hi, other[i].hi);
+  }
+}
+
+int64_t HloIntervalReachability::FindIndex(
+    const HloInstruction* instruction) const {
+  auto it = indices_.find(GetKey(instruction));
+  return it == indices_.end() ? -1 : static_cast<int64_t>(it->second);
+}
+
+std::unique_ptr<HloIntervalReachability> HloIntervalReachability::Build(
+    const HloComputation* computation) {
+  const auto& all = computation->MakeInstructionPostOrder();
+  auto result = std::make_unique<HloIntervalReachability>(all);
+  const size_t n = all.size();
+
+  // The first order is the post order, in which the constructor ranked the
+  // instructions. The second one is the post order of a search that starts
+  // from the last instructions and visits the predecessors in reverse.
+  constexpr int64_t kNotVisited = -1;
+  constexpr int64_t kVisiting = -2;
+  std::vector<int64_t> second_ranks(n, kNotVisited);
+  int64_t next_rank = 0;
+  struct Frame {
+    Index index;
+    // Predecessors that remain to be visited, from the last one.
+    std::vector<const HloInstruction*> predecessors;
+  };
+  std::vector<Frame> stack;
+  auto push = [&](Index index) {
+    second_ranks[index] = kVisiting;
+    stack.push_back({index, Predecessors(all[index])});
+  };
+  for (size_t i = n; i-- > 0;) {
+    if (second_ranks[i] != kNotVisited) continue;
+    push(i);
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+      if (frame.predecessors.empty()) {
+        second_ranks[frame.index] = next_rank++;
+        stack.pop_back();
+        continue;
+      }
+      Index index = result->GetIndex(frame.predecessors.back());
+      frame.predecessors.pop_back();
+      if (second_ranks[index] == kNotVisited) push(index);
+    }
+  }
+  for (size_t i = 0; i < n; ++i) {
+    result->labels_[i][1] = Interval{second_ranks[i], second_ranks[i]};
+  }
+
+  // Successors come after their predecessors in both orders, so the labels can
+  // be computed in reverse post order.
+  for (size_t i = n; i-- > 0;) {
+    Label& label = result->labels_[i];
+    ForEachSuccessor(all[i], [&](const HloInstruction* successor) {
+      Extend(label, result->labels_[result->GetIndex(successor)]);
+    });
+  }
+  return result;
+}
+
+bool HloIntervalReachability::IsReachable(Index a, Index b) const {
+  if (a == b) return true;
+  const Label& target = labels_[b];
+  if (!Contains(labels_[a], target)) return false;
+
+  if (++visit_stamp_ == 0) {
+    std::fill(visit_stamps_.begin(), visit_stamps_.end(), 0);
+    visit_stamp_ = 1;
+  }
+  std::vector<Index> stack = {a};
+  visit_stamps_[a] = visit_stamp_;
+  bool found = false;
+  while (!stack.empty() && !found) {
+    Index index = stack.back();
+    stack.pop_back();
+    ForEachSuccessor(instructions_[index],
+                     [&](const HloInstruction* successor) {
+                       int64_t i = FindIndex(successor);
+                       if (found || i < 0 ||
+                           visit_stamps_[i] == visit_stamp_) {
+                         return;
+                       }
+                       visit_stamps_[i] = visit_stamp_;
+                       if (static_cast<Index>(i) == b) {
+                         found = true;
+                       } else if (Contains(labels_[i], target)) {
+                         stack.push_back(i);
+                       }
+                     });
+  }
+  return found;
+}
+
+void HloIntervalReachability::UpdateReachabilityThroughInstruction(
+    const HloInstruction* instruction) {
+  auto [it, inserted] =
+      indices_.try_emplace(GetKey(instruction), instructions_.size());
+  Index index = it->second;
+  if (inserted) {
+    instructions_.push_back(instruction);
+    visit_stamps_.push_back(0);
+    std::optional<Label> label;
+    ForEachSuccessor(instruction, [&](const HloInstruction* successor) {
+      int64_t i = FindIndex(successor);
+      if (i < 0) return;
+      if (label.has_value()) {
+        Extend(*label, labels_[i]);
+      } else {
+        label = labels_[i];
+      }
+    });
+    labels_.push_back(label.has_value() ? *label : Point(next_rank_++));
+  }
+  PropagateToPredecessors(index);
+}
+
+void HloIntervalReachability::PropagateToPredecessors(Index index) {
+  std::vector<Index> worklist = {index};
+  while (!worklist.empty()) {
+    Index current = worklist.back();
+    worklist.pop_back();
+    ForEachPredecessor(instructions_[current],
+                       [&](const HloInstruction* predecessor) {
+                         int64_t i = FindIndex(predecessor);
+                         if (i < 0 || Contains(labels_[i], labels_[current])) {
+                           return;
+                         }
+                         Extend(labels_[i], labels_[current]);
+                         worklist.push_back(i);
+                       });
+  }
+}
+
+void HloIntervalReachability::Replace(const HloInstruction* original,
+                                      const HloInstruction* replacement) {
+  if (GetKey(original) != GetKey(replacement)) {
+    Index index = GetIndex(original);
+    indices_[GetKey(replacement)] = index;
+    indices_.erase(GetKey(original));
+    instructions_[index] = replacement;
+  }
+}
+
+}  // namespace xla
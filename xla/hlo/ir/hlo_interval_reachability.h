@@ -0,0 +1,139 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_HLO_IR_HLO_INTERVAL_REACHABILITY_H_
+#define XLA_HLO_IR_HLO_INTERVAL_REACHABILITY_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/span.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+
+namespace xla {
+
+// A reachability index for HloInstructions that uses O(N) memory, as opposed
+// to the O(N^2) bits of HloReachabilityMap, for computations with hundreds of
+// thousands of instructions.
+//
+// Every instruction is labeled with one interval per topological order of the
+// computation, such that the labels of an instruction contain the labels of
+// everything reachable from it. Queries for which the labels are not nested
+// are answered immediately; the others run a depth-first search from 'a' that
+// prunes the instructions whose labels don't contain the labels of 'b'. The
+// answers are thus exact, and the labels only make them fast.
+//
+// Queries use internal scratch state, so concurrent queries on the same index
+// are not safe.
+class HloIntervalReachability {
+ public:
+  using Index = size_t;
+
+  // Sets up an index with no edges and where the nodes correspond to the given
+  // instructions.
+  explicit HloIntervalReachability(
+      absl::Span<const HloInstruction* const> instructions);
+
+  // Computes and returns the reachability between HLO instructions in the
+  // computation. IsReachable(a, b) returns true iff there exists a directed
+  // path (from producer to consumer) from 'a' to 'b'. Both data dependencies
+  // (operands) and control dependencies are considered for reachability.
+  // Trivially an instruction is reachable from itself.
+  static std::unique_ptr<HloIntervalReachability> Build(
+      const HloComputation* computation);
+
+  Index GetIndex(const HloInstruction* instruction) const {
+    return indices_.at(GetKey(instruction));
+  }
+
+  // Updates the index after the immediate predecessor set (operands and
+  // control predecessors) of 'instruction' has changed, or after
+  // 'instruction' was added to the computation. Instructions that are not in
+  // the index are not traversed by queries.
+  void UpdateReachabilityThroughInstruction(const HloInstruction* instruction);
+
+  // Returns true if "b" is reachable from "a".
+  bool IsReachable(const HloInstruction* a, const HloInstruction* b) const {
+    return IsReachable(GetIndex(a), GetIndex(b));
+  }
+  bool IsReachable(Index a, Index b) const;
+
+  // Returns true if "b" is reachable from "a" or "a" is reachable from "b".
+  bool IsConnected(const HloInstruction* a, const HloInstruction* b) const {
+    return IsConnected(GetIndex(a), GetIndex(b));
+  }
+  bool IsConnected(Index a, Index b) const {
+    return IsReachable(a, b) || IsReachable(b, a);
+  }
+
+  // Checks if an instruction is in the index.
+  bool IsPresent(const HloInstruction* instruction) const {
+    return indices_.contains(GetKey(instruction));
+  }
+
+  // Replace the instruction "original" with "replacement" in the index.
+  void Replace(const HloInstruction* original,
+               const HloInstruction* replacement);
+
+ private:
+  // Number of topological orders used to label the instructions. Each order
+  // filters out a different set of unreachable pairs.
+  static constexpr int kNumOrders = 2;
+
+  struct Interval {
+    int64_t lo;
+    int64_t hi;
+  };
+  using Label = std::array<Interval, kNumOrders>;
+
+  static Label Point(int64_t rank);
+  static bool Contains(const Label& outer, const Label& inner);
+  static void Extend(Label& label, const Label& other);
+
+  using Key = std::pair<int, int>;  // module ID, instruction ID.
+  static Key GetKey(const HloInstruction* instruction) {
+    return {instruction->GetModule()->unique_id(), instruction->unique_id()};
+  }
+
+  // Returns the index of 'instruction', or -1 if it is not in the index.
+  int64_t FindIndex(const HloInstruction* instruction) const;
+
+  // Extends the labels of the predecessors of the instruction at 'index',
+  // transitively, so that they contain its label.
+  void PropagateToPredecessors(Index index);
+
+  // Map from instruction to index in the vectors below.
+  absl::flat_hash_map<Key, Index> indices_;
+  std::vector<const HloInstruction*> instructions_;
+  std::vector<Label> labels_;
+
+  // Rank given to the next instruction added without users.
+  int64_t next_rank_ = 0;
+
+  // Scratch state of the searches run by IsReachable. An instruction was
+  // visited by the current search iff its stamp is 'visit_stamp_'.
+  mutable std::vector<uint32_t> visit_stamps_;
+  mutable uint32_t visit_stamp_ = 0;
+};
+
+}  // namespace xla
+
+#endif  // XLA_HLO_IR_HLO_INTERVAL_REACHABILITY_H_
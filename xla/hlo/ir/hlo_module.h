@@ -30,6 +30,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "xla/hlo/ir/dynamic_parameter_binding.h"
 #include "xla/hlo/ir/hlo_clone_context.h"
@@ -490,6 +491,16 @@ class HloModule {
   // Returns the NameUniquer for uniquing instruction names in this module.
   NameUniquer& instruction_name_uniquer() { return instruction_name_uniquer_; }
 
+  // Gives `instruction` a name and an id that are unique in the module. Unlike
+  // instruction_name_uniquer() and NewUniqueInstructionId(), this may be called
+  // concurrently, which lets passes add instructions to different computations
+  // in parallel.
+  void UniquifyInstructionNameAndId(HloInstruction* instruction) {
+    absl::MutexLock lock(&instruction_uniquing_mu_);
+    instruction->UniquifyName(&instruction_name_uniquer_);
+    instruction->SetUniqueId(NewUniqueInstructionId());
+  }
+
   // Assign a new unique dense id for an instruction
   int NewUniqueInstructionId() {
     int result = next_unique_id_;
@@ -720,6 +731,9 @@ class HloModule {
   mutable std::mt19937_64 rng_{42};
   mutable absl::Mutex rng_mutex_;
 
+  // Serializes UniquifyInstructionNameAndId.
+  absl::Mutex instruction_uniquing_mu_;
+
   // Unique name generator for computation and instruction names, which are
   // unique per module.
   NameUniquer computation_name_uniquer_{/*separator=*/"."};
@@ -106,7 +106,7 @@ Layout::Layout(const Layout& other)
       dynamic_shape_metadata_prefix_bytes_(
           other.dynamic_shape_metadata_prefix_bytes_) {}
 
-Layout::Layout(Layout&& other) = default;
+Layout::Layout(Layout&& other) noexcept = default;
 
 Layout::~Layout() = default;
 
@@ -132,7 +132,7 @@ Layout& Layout::operator=(const Layout& other) {
   return *this;
 }
 
-Layout& Layout::operator=(Layout&& other) = default;
+Layout& Layout::operator=(Layout&& other) noexcept = default;
 
 /* static */ Layout Layout::CreateFromProto(const LayoutProto& proto) {
   Layout layout;
@@ -96,7 +96,7 @@ class Layout {
  public:
   Layout();
   Layout(const Layout& other);
-  Layout(Layout&& other);
+  Layout(Layout&& other) noexcept;
   ~Layout();
 
   // Constructs a dense layout with the given minor-to-major order.
@@ -116,7 +116,7 @@ class Layout {
                   int64_t dynamic_shape_metadata_prefix_bytes = 0);
 
   Layout& operator=(const Layout& other);
-  Layout& operator=(Layout&& other);
+  Layout& operator=(Layout&& other) noexcept;
 
   // Construct a shape from a LayoutProto.
   static Layout CreateFromProto(const LayoutProto& proto);
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/literal.h"
 
 #include <algorithm>
+#include <atomic>
 #include <complex>
 #include <cstdint>
 #include <cstring>
@@ -548,6 +549,94 @@ std::vector<Literal> Literal::DecomposeTuple() {
 
 namespace {
 
+// Literals with at least this many elements are processed in parallel by
+// Convert, Relayout and operator==, in tasks of that many elements.
+constexpr int64_t kMinElementsPerParallelTask = int64_t{1} << 20;
+
+// Calls `fn(begin, end)` on consecutive ranges covering [0, n). Ranges are
+// processed in parallel on the ShapeUtil::ForEachIndexParallel thread pool if
+// `n` is large. Returns false if any call returned false; ranges processed
+// after that may be skipped.
+bool ForEachElementRange(int64_t n,
+                         absl::FunctionRef<bool(int64_t, int64_t)> fn) {
+  if (n < 2 * kMinElementsPerParallelTask) {
+    return fn(0, n);
+  }
+  const int64_t num_tasks = CeilOfRatio(n, kMinElementsPerParallelTask);
+  std::atomic<bool> result = true;
+  ShapeUtil::ForEachIndexParallel(
+      ShapeUtil::MakeShape(PRED, {num_tasks}),
+      [&](absl::Span<const int64_t> task, int /*thread_id*/) -> StatusOr<bool> {
+        if (result.load(std::memory_order_relaxed)) {
+          const int64_t begin = task[0] * kMinElementsPerParallelTask;
+          if (!fn(begin, std::min(begin + kMinElementsPerParallelTask, n))) {
+            result.store(false, std::memory_order_relaxed);
+          }
+        }
+        return true;
+      });
+  return result.load();
+}
+
+// Calls `fn(a_index, b_index)` with the linear indices of the same element in
+// arrays of shapes `a` and `b`, which must have the same dimensions, for the
+// elements at linear indices [begin, end) of `a`. Elements are visited in the
+// physical order of `a`, updating the index into `b` incrementally instead of
+// recomputing both linear indices for every element. Stops and returns false
+// as soon as `fn` returns false.
+template <typename Fn>
+bool ForEachLinearIndexPair(const Shape& a, const Shape& b, int64_t begin,
+                            int64_t end, const Fn& fn) {
+  if (begin >= end) {
+    return true;
+  }
+  const int64_t rank = a.rank();
+  if (rank == 0) {
+    return fn(0, 0);
+  }
+  // The distance between consecutive elements of each dimension in `b`.
+  DimensionVector b_strides(rank);
+  int64_t stride = 1;
+  for (int64_t dim : LayoutUtil::MinorToMajor(b)) {
+    b_strides[dim] = stride;
+    stride *= b.dimensions(dim);
+  }
+  absl::Span<const int64_t> minor_to_major = LayoutUtil::MinorToMajor(a);
+  std::vector<int64_t> index =
+      IndexUtil::LinearIndexToMultidimensionalIndex(a, begin);
+  int64_t b_index = IndexUtil::MultidimensionalIndexToLinearIndex(b, index);
+  const int64_t minor_dim = minor_to_major[0];
+  const int64_t minor_size = a.dimensions(minor_dim);
+  const int64_t minor_stride = b_strides[minor_dim];
+  int64_t a_index = begin;
+  while (true) {
+    // Walk the rest of the most minor dimension.
+    const int64_t count =
+        std::min(minor_size - index[minor_dim], end - a_index);
+    for (int64_t i = 0; i < count; ++i) {
+      if (!fn(a_index + i, b_index + i * minor_stride)) {
+        return false;
+      }
+    }
+    a_index += count;
+    if (a_index == end) {
+      return true;
+    }
+    b_index -= index[minor_dim] * minor_stride;
+    index[minor_dim] = 0;
+    // Move on to the next index in the more major dimensions.
+    for (int64_t i = 1; i < rank; ++i) {
+      const int64_t dim = minor_to_major[i];
+      b_index += b_strides[dim];
+      if (++index[dim] < a.dimensions(dim)) {
+        break;
+      }
+      b_index -= index[dim] * b_strides[dim];
+      index[dim] = 0;
+    }
+  }
+}
+
 // Copies the elements in 'src' to 'dest'. The shape and layout of the data in
 // the array slices are indicated by dest_shape and src_shape respectively.
 template <typename NativeT>
@@ -557,14 +646,15 @@ void CopyElementsBetween(absl::Span<NativeT> dest,
   DCHECK(LayoutUtil::IsDenseArray(dest_shape));
   DCHECK(LayoutUtil::IsDenseArray(src_shape));
   DCHECK(ShapeUtil::Compatible(dest_shape, src_shape));
-  if (ShapeUtil::IsZeroElementArray(dest_shape)) {
-    return;
-  }
-  std::vector<int64_t> index(dest_shape.rank());
-  do {
-    dest[IndexUtil::MultidimensionalIndexToLinearIndex(dest_shape, index)] =
-        src[IndexUtil::MultidimensionalIndexToLinearIndex(src_shape, index)];
-  } while (IndexUtil::BumpIndices(dest_shape, absl::MakeSpan(index)));
+  ForEachElementRange(
+      ShapeUtil::ElementsIn(dest_shape), [&](int64_t begin, int64_t end) {
+        return ForEachLinearIndexPair(
+            dest_shape, src_shape, begin, end,
+            [&](int64_t dest_index, int64_t src_index) {
+              dest[dest_index] = src[src_index];
+              return true;
+            });
+      });
 }
 }  // namespace
 
@@ -1026,6 +1116,19 @@ StatusOr<Literal> BroadcastHelper(const LiteralBase& src,
     }
   }
 
+  const char* source_data = static_cast<const char*>(src.untyped_data());
+  char* dest_data = static_cast<char*>(result.untyped_data());
+
+  // Fast path for broadcasting a scalar: every destination element is a copy of
+  // the same source element, so we can fill the result linearly.
+  if (src_shape.rank() == 0) {
+    const int64_t num_elements = result.element_count();
+    for (int64_t i = 0; i < num_elements; ++i) {
+      memcpy(dest_data + PRIMITIVE_SIZE * i, source_data, PRIMITIVE_SIZE);
+    }
+    return std::move(result);
+  }
+
   // scratch_source_index is temporary storage space for the computed index into
   // the input literal.  We put it here to avoid allocating an std::vector in
   // every iteration of ShapeUtil::ForEachIndex.
@@ -1036,9 +1139,6 @@ StatusOr<Literal> BroadcastHelper(const LiteralBase& src,
   absl::Span<int64_t> scratch_source_span(scratch_source_index);
   int64_t* scratch_source_array = scratch_source_span.data();
 
-  const char* source_data = static_cast<const char*>(src.untyped_data());
-  char* dest_data = static_cast<char*>(result.untyped_data());
-
   auto src_minor_to_major = LayoutUtil::MinorToMajor(src_shape);
   auto result_minor_to_major = LayoutUtil::MinorToMajor(result_shape);
 
@@ -1676,9 +1776,12 @@ void ConvertBetweenNativeTypes(absl::Span<const NativeSrcT> src_data,
   };
 
   NativeDestT* dest_data = static_cast<NativeDestT*>(dst_base);
-  for (const NativeSrcT& src : src_data) {
-    *(dest_data++) = converter(src);
-  }
+  ForEachElementRange(src_data.size(), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      dest_data[i] = converter(src_data[i]);
+    }
+    return true;
+  });
 }
 
 template <PrimitiveType kSrcType>
@@ -1858,7 +1961,38 @@ bool LiteralBase::Piece::EqualElements(const LiteralBase::Piece& other) const {
     CHECK(LayoutUtil::IsDenseArray(subshape()))
         << __func__ << " is only supported for dense arrays: " << subshape();
     CHECK_EQ(size_bytes_dense(), other.size_bytes_dense());
-    return memcmp(buffer(), other.buffer(), size_bytes_dense()) == 0;
+    return ForEachElementRange(
+        size_bytes_dense(), [&](int64_t begin, int64_t end) {
+          return memcmp(buffer() + begin, other.buffer() + begin,
+                        end - begin) == 0;
+        });
+  }
+
+  // Arrays with different layouts are compared element by element, walking
+  // this array in its physical order.
+  if (subshape().is_static() && other.subshape().is_static() &&
+      subshape().IsArray() &&
+      ShapeUtil::Compatible(subshape(), other.subshape())) {
+    return primitive_util::PrimitiveTypeSwitch<bool>(
+        [&](auto primitive_type_constant) -> bool {
+          if constexpr (primitive_util::IsArrayType(primitive_type_constant)) {
+            using NativeT = NativeTypeOf<primitive_type_constant>;
+            auto data = this->data<NativeT>();
+            auto other_data = other.data<NativeT>();
+            return ForEachElementRange(
+                data.size(), [&](int64_t begin, int64_t end) {
+                  return ForEachLinearIndexPair(
+                      subshape(), other.subshape(), begin, end,
+                      [&](int64_t index, int64_t other_index) {
+                        return data[index] == other_data[other_index];
+                      });
+                });
+          }
+          LOG(FATAL)
+              << "Unimplemented: LiteralBase::Piece::EqualElements for type "
+              << PrimitiveType_Name(subshape().element_type());
+        },
+        subshape().element_type());
   }
 
   std::vector<int64_t> multi_index;
@@ -19,7 +19,9 @@ limitations under the License.
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <limits>
@@ -268,6 +270,84 @@ class NearComparator {
     }
   };
 
+  // The number of mismatches to report in the output, sorted by relative error
+  // magnitude.
+  static constexpr int64_t kTopRelativeErrorCount = 5;
+
+  // Actual values are bucketed by absolute value. kAbsValueBucketBounds is the
+  // bounds of these buckets.
+  static constexpr std::array<float, 7> kAbsValueBucketBounds = {
+      0.0, 0.0001, 0.001, 0.01, 0.1, 1, std::numeric_limits<float>::infinity()};
+
+  // Buckets for relative and absolute errors. The relative error buckets only
+  // contains those elements which exceed the *absolute* error bound, and vice
+  // versa. This makes it easy to see the effect of adjusting the relative (or
+  // absolute) error bound on the success of the comparison. kErrorBucketBounds
+  // are the lower bounds of the buckets in both vectors. The error buckets are
+  // a cumulative distribution so an error value may appear in more than one
+  // bucket. For example an error value of 0.003 may appear in the buckets
+  // bounded by 0.01, 0.1, and 1.0.
+  static constexpr std::array<float, 5> kErrorBucketBounds = {0.0001, 0.001,
+                                                              0.01, 0.1, 1};
+
+  // Literals with at least this many elements are compared in blocks of
+  // kParallelBlockSize elements on a thread pool.
+  static constexpr int64_t kMinParallelElementCount = int64_t{1} << 20;
+  static constexpr int64_t kParallelBlockSize = int64_t{1} << 16;
+
+  // Mismatch statistics of a set of elements. Blocks of elements compared in
+  // parallel have their own statistics, which are merged in order.
+  struct Stats {
+    Stats()
+        : abs_value_buckets(kAbsValueBucketBounds.size() - 1, {0, 0}),
+          abs_error_buckets(kErrorBucketBounds.size(), 0),
+          rel_error_buckets(kErrorBucketBounds.size(), 0) {}
+
+    // Adds the statistics of other elements.
+    void Merge(const Stats& other) {
+      num_mismatches += other.num_mismatches;
+      num_nan_mismatches += other.num_nan_mismatches;
+      num_abs_mismatches += other.num_abs_mismatches;
+      num_rel_mismatches += other.num_rel_mismatches;
+      for (const Mismatch& mismatch : other.top_rel_mismatches) {
+        top_rel_mismatches.insert(mismatch);
+        if (top_rel_mismatches.size() > kTopRelativeErrorCount) {
+          top_rel_mismatches.erase(top_rel_mismatches.begin());
+        }
+      }
+      for (int i = 0; i < abs_value_buckets.size(); ++i) {
+        abs_value_buckets[i].first += other.abs_value_buckets[i].first;
+        abs_value_buckets[i].second += other.abs_value_buckets[i].second;
+      }
+      for (int i = 0; i < kErrorBucketBounds.size(); ++i) {
+        abs_error_buckets[i] += other.abs_error_buckets[i];
+        rel_error_buckets[i] += other.rel_error_buckets[i];
+      }
+    }
+
+    // Number of element mismatches encountered so far.
+    int64_t num_mismatches = 0;
+
+    // Number of elements with a nan mismatch.
+    int64_t num_nan_mismatches = 0;
+
+    // Number of elements which exceed the absolute/relative error bound.
+    int64_t num_abs_mismatches = 0;
+    int64_t num_rel_mismatches = 0;
+
+    // The set of mismatches with the largest relative error. The size of this
+    // set is bounded by kTopRelativeErrorCount.
+    std::multiset<Mismatch> top_rel_mismatches;
+
+    // A pair for each bucket of kAbsValueBucketBounds: the element count and
+    // failure count.
+    std::vector<std::pair<int64_t, int64_t>> abs_value_buckets;
+
+    // The error buckets bounded by kErrorBucketBounds.
+    std::vector<int64_t> abs_error_buckets;
+    std::vector<int64_t> rel_error_buckets;
+  };
+
   NearComparator(const LiteralSlice& expected, const LiteralSlice& actual,
                  const ShapeIndex& shape_index, ErrorSpec error,
                  bool detailed_message,
@@ -277,10 +357,7 @@ class NearComparator {
         shape_index_(shape_index),
         error_(error),
         detailed_message_(detailed_message),
-        miscompare_callback_(miscompare_callback),
-        abs_value_buckets_(kAbsValueBucketBounds.size() - 1, {0, 0}),
-        abs_error_buckets_(kErrorBucketBounds.size(), 0),
-        rel_error_buckets_(kErrorBucketBounds.size(), 0) {}
+        miscompare_callback_(miscompare_callback) {}
 
   // Runs the comparison between expected and actual literals.
   Status Run() {
@@ -297,31 +374,31 @@ class NearComparator {
 
     CompareLiterals();
 
-    if (num_mismatches_ == 0) {
+    if (stats_.num_mismatches == 0) {
       return OkStatus();
     } else if (!VLOG_IS_ON(1) && miscompare_callback_ != nullptr) {
       miscompare_callback_(
           expected_, actual_, mismatches_, shape_index_,
-          ErrorBuckets(abs_error_buckets_, rel_error_buckets_));
+          ErrorBuckets(stats_.abs_error_buckets, stats_.rel_error_buckets));
     }
     return InvalidArgument("%s", ErrorMessage());
   }
 
   // Insert the given absolute value into the absolute value bucket vector. The
   // bounds of the buckets are given by kAbsValueBucketBounds.
-  void UpdateAbsValueBucket(NativeT value, bool is_mismatch) {
+  void UpdateAbsValueBucket(NativeT value, bool is_mismatch, Stats& stats) {
     // Adjust the bucket containing the absolute values of the 'actual'
     // elements.
     const double abs_value = FpAbsoluteValue(value);
-    for (int i = 0; i < abs_value_buckets_.size(); ++i) {
-      if (i == abs_value_buckets_.size() - 1 ||
+    for (int i = 0; i < stats.abs_value_buckets.size(); ++i) {
+      if (i == stats.abs_value_buckets.size() - 1 ||
           (abs_value >= kAbsValueBucketBounds[i] &&
            abs_value < kAbsValueBucketBounds[i + 1])) {
         // The first value of the pair is the count of elements in the bucket,
         // the second is the count of mismatches in the bucket.
-        abs_value_buckets_[i].first++;
+        stats.abs_value_buckets[i].first++;
         if (is_mismatch) {
-          abs_value_buckets_[i].second++;
+          stats.abs_value_buckets[i].second++;
         }
         return;
       }
@@ -341,7 +418,8 @@ class NearComparator {
   // Compares the two given elements from the expected and actual literals at
   // the given literal_index and keeps track of various mismatch statistics.
   template <typename T>
-  void CompareValues(T expected, T actual, int64_t linear_index) {
+  void CompareValues(T expected, T actual, int64_t linear_index,
+                     Stats& stats) {
     double abs_error;
     double rel_error;
     if (CompareEqual<T>(expected, actual, {linear_index})) {
@@ -353,7 +431,7 @@ class NearComparator {
         rel_error = 0;
       } else if ((!error_.relaxed_nans && IsNan(expected) != IsNan(actual)) ||
                  (error_.relaxed_nans && !IsNan(expected) && IsNan(actual))) {
-        num_nan_mismatches_++;
+        stats.num_nan_mismatches++;
         // A nan mismatch is considered to have infinite error. rel_error is
         // used for sorting a std::set of the top mismatches, and a nan value
         // here will result in undefined behavior because nan's do not satisfy
@@ -402,30 +480,30 @@ class NearComparator {
     // Update the error of the relative bucket only if the *absolute* error
     // bound is exceeded and vice versa.
     if (is_abs_mismatch) {
-      num_abs_mismatches_++;
-      UpdateErrorBucket(rel_error, absl::MakeSpan(rel_error_buckets_));
+      stats.num_abs_mismatches++;
+      UpdateErrorBucket(rel_error, absl::MakeSpan(stats.rel_error_buckets));
     }
     if (is_rel_mismatch) {
-      num_rel_mismatches_++;
-      UpdateErrorBucket(abs_error, absl::MakeSpan(abs_error_buckets_));
+      stats.num_rel_mismatches++;
+      UpdateErrorBucket(abs_error, absl::MakeSpan(stats.abs_error_buckets));
     }
 
-    UpdateAbsValueBucket(actual, is_mismatch);
+    UpdateAbsValueBucket(actual, is_mismatch, stats);
 
     if (!is_mismatch) {
       return;
     }
 
-    num_mismatches_++;
+    stats.num_mismatches++;
 
     // Keep track of the kTopRelativeErrorCount relative error mismatches.
-    if (top_rel_mismatches_.size() < kTopRelativeErrorCount ||
-        rel_error > top_rel_mismatches_.begin()->rel_error) {
+    if (stats.top_rel_mismatches.size() < kTopRelativeErrorCount ||
+        rel_error > stats.top_rel_mismatches.begin()->rel_error) {
       Mismatch mismatch = {actual, expected, rel_error, abs_error,
                            linear_index};
-      top_rel_mismatches_.insert(mismatch);
-      if (top_rel_mismatches_.size() > kTopRelativeErrorCount) {
-        top_rel_mismatches_.erase(top_rel_mismatches_.begin());
+      stats.top_rel_mismatches.insert(mismatch);
+      if (stats.top_rel_mismatches.size() > kTopRelativeErrorCount) {
+        stats.top_rel_mismatches.erase(stats.top_rel_mismatches.begin());
       }
     }
 
@@ -433,34 +511,54 @@ class NearComparator {
   }
 
   // For complex types, we compare real and imaginary parts individually.
-  void CompareValues(complex64 expected, complex64 actual,
-                     int64_t linear_index) {
-    const auto both_parts_mismatch = num_mismatches_ + 2;
-    CompareValues<float>(expected.real(), actual.real(), linear_index);
-    CompareValues<float>(expected.imag(), actual.imag(), linear_index);
-    if (num_mismatches_ == both_parts_mismatch) {
+  void CompareValues(complex64 expected, complex64 actual, int64_t linear_index,
+                     Stats& stats) {
+    const auto both_parts_mismatch = stats.num_mismatches + 2;
+    CompareValues<float>(expected.real(), actual.real(), linear_index, stats);
+    CompareValues<float>(expected.imag(), actual.imag(), linear_index, stats);
+    if (stats.num_mismatches == both_parts_mismatch) {
       // The mismatch counter had been incremented by each CompareValues() call,
       // which means that both real and imaginary parts of the passed-in complex
       // values are different. However, the counter should reflect a single
       // mismatch between these complex values.
-      num_mismatches_--;
+      stats.num_mismatches--;
     }
   }
 
   void CompareValues(complex128 expected, complex128 actual,
-                     int64_t linear_index) {
-    const auto both_parts_mismatch = num_mismatches_ + 2;
-    CompareValues<double>(expected.real(), actual.real(), linear_index);
-    CompareValues<double>(expected.imag(), actual.imag(), linear_index);
-    if (num_mismatches_ == both_parts_mismatch) {
+                     int64_t linear_index, Stats& stats) {
+    const auto both_parts_mismatch = stats.num_mismatches + 2;
+    CompareValues<double>(expected.real(), actual.real(), linear_index, stats);
+    CompareValues<double>(expected.imag(), actual.imag(), linear_index, stats);
+    if (stats.num_mismatches == both_parts_mismatch) {
       // The mismatch counter had been incremented by each CompareValues() call,
       // which means that both real and imaginary parts of the passed-in complex
       // values are different. However, the counter should reflect a single
       // mismatch between these complex values.
-      num_mismatches_--;
+      stats.num_mismatches--;
     }
   }
 
+  // Returns true if the comparison should stop, as `num_mismatches`
+  // mismatches were found.
+  bool MismatchBudgetExhausted(int64_t num_mismatches) const {
+    return error_.max_mismatches > 0 && num_mismatches >= error_.max_mismatches;
+  }
+
+  // Compares the elements at linear indices [begin, end) of the data of the
+  // literals, adding to `stats`. Returns false if the comparison stopped early.
+  bool CompareRange(absl::Span<const NativeT> expected_data,
+                    absl::Span<const NativeT> actual_data, int64_t begin,
+                    int64_t end, Stats& stats) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (MismatchBudgetExhausted(stats.num_mismatches)) {
+        return false;
+      }
+      CompareValues(expected_data[i], actual_data[i], i, stats);
+    }
+    return true;
+  }
+
   // Compares the two literals elementwise.
   void CompareLiterals() {
     // Fast path optimization for the case were layouts match and the shapes are
@@ -471,9 +569,36 @@ class NearComparator {
       absl::Span<const NativeT> expected_data = expected_.data<NativeT>();
       absl::Span<const NativeT> actual_data = actual_.data<NativeT>();
       const int64_t len = expected_data.size();
-      for (int64_t i = 0; i < len; ++i) {
-        CompareValues(expected_data[i], actual_data[i], i);
+      if (len < kMinParallelElementCount) {
+        stopped_early_ =
+            !CompareRange(expected_data, actual_data, 0, len, stats_);
+        return;
+      }
+      const int64_t num_blocks = CeilOfRatio(len, kParallelBlockSize);
+      std::vector<Stats> block_stats(num_blocks);
+      std::atomic<int64_t> num_mismatches = 0;
+      std::atomic<bool> stopped_early = false;
+      ShapeUtil::ForEachIndexParallel(
+          ShapeUtil::MakeShape(PRED, {num_blocks}),
+          [&](absl::Span<const int64_t> block, int) -> StatusOr<bool> {
+            if (MismatchBudgetExhausted(num_mismatches)) {
+              stopped_early = true;
+              return true;
+            }
+            const int64_t begin = block[0] * kParallelBlockSize;
+            Stats& stats = block_stats[block[0]];
+            if (!CompareRange(expected_data, actual_data, begin,
+                              std::min(begin + kParallelBlockSize, len),
+                              stats)) {
+              stopped_early = true;
+            }
+            num_mismatches += stats.num_mismatches;
+            return true;
+          });
+      for (const Stats& stats : block_stats) {
+        stats_.Merge(stats);
       }
+      stopped_early_ = stopped_early;
       return;
     }
     std::vector<int64_t> multi_index(actual_.shape().rank(), 0);
@@ -486,10 +611,15 @@ class NearComparator {
   void CompareLiteralsSlow(int64_t dimension,
                            std::vector<int64_t>* multi_index) {
     if (dimension == multi_index->size()) {
+      if (MismatchBudgetExhausted(stats_.num_mismatches)) {
+        stopped_early_ = true;
+        return;
+      }
       CompareValues(expected_.Get<NativeT>(*multi_index),
                     actual_.Get<NativeT>(*multi_index),
                     IndexUtil::MultidimensionalIndexToLinearIndex(
-                        actual_.shape(), *multi_index));
+                        actual_.shape(), *multi_index),
+                    stats_);
     } else {
       int64_t upper_bound = expected_.shape().dimensions(dimension);
       if (expected_.shape().is_dynamic_dimension(dimension)) {
@@ -519,15 +649,21 @@ class NearComparator {
         &out,
         "\nMismatch count %d (%s) in shape %s (%d elements), abs bound "
         "%g, rel bound %g\n",
-        num_mismatches_, percent_string(num_mismatches_, element_count),
+        stats_.num_mismatches,
+        percent_string(stats_.num_mismatches, element_count),
         ShapeUtil::HumanString(actual_.shape()),
         ShapeUtil::ElementsIn(actual_.shape()), error_.abs, error_.rel);
-    if (num_nan_mismatches_ > 0) {
-      StrAppend(&out, "nan mismatches ", num_nan_mismatches_, "\n");
+    if (stopped_early_) {
+      StrAppend(&out, "Comparison stopped after ", stats_.num_mismatches,
+                " mismatches; the statistics only cover the elements compared "
+                "so far\n");
+    }
+    if (stats_.num_nan_mismatches > 0) {
+      StrAppend(&out, "nan mismatches ", stats_.num_nan_mismatches, "\n");
     }
     StrAppendFormat(&out, "Top relative error mismatches:\n");
-    for (auto it = top_rel_mismatches_.rbegin();
-         it != top_rel_mismatches_.rend(); ++it) {
+    for (auto it = stats_.top_rel_mismatches.rbegin();
+         it != stats_.top_rel_mismatches.rend(); ++it) {
       StrAppend(&out, "  ", it->ToString(actual_.shape()), "\n");
     }
 
@@ -536,10 +672,10 @@ class NearComparator {
     }
 
     StrAppend(&out, "Absolute magnitude breakdown of actual values:\n");
-    CHECK_EQ(abs_value_buckets_.size() + 1, kAbsValueBucketBounds.size());
-    for (int i = 0; i < abs_value_buckets_.size(); ++i) {
-      const int64_t bucket_size = abs_value_buckets_[i].first;
-      const int64_t bucket_mismatches = abs_value_buckets_[i].second;
+    CHECK_EQ(stats_.abs_value_buckets.size() + 1, kAbsValueBucketBounds.size());
+    for (int i = 0; i < stats_.abs_value_buckets.size(); ++i) {
+      const int64_t bucket_size = stats_.abs_value_buckets[i].first;
+      const int64_t bucket_mismatches = stats_.abs_value_buckets[i].second;
       std::string mismatch_str =
           bucket_mismatches > 0
               ? absl::StrFormat(", mismatches %d", bucket_mismatches)
@@ -563,17 +699,17 @@ class NearComparator {
       }
     };
     StrAppendFormat(&out, "Elements exceeding abs error bound %g: %d (%s)\n",
-                    error_.abs, num_abs_mismatches_,
-                    percent_string(num_abs_mismatches_, element_count));
+                    error_.abs, stats_.num_abs_mismatches,
+                    percent_string(stats_.num_abs_mismatches, element_count));
     print_accum_buckets(
         "Relative error breakdown of elements exceeding abs error bound",
-        num_abs_mismatches_, rel_error_buckets_);
+        stats_.num_abs_mismatches, stats_.rel_error_buckets);
     StrAppendFormat(&out, "Elements exceeding rel error bound %g: %d (%s)\n",
-                    error_.rel, num_rel_mismatches_,
-                    percent_string(num_rel_mismatches_, element_count));
+                    error_.rel, stats_.num_rel_mismatches,
+                    percent_string(stats_.num_rel_mismatches, element_count));
     print_accum_buckets(
         "Absolute error breakdown of elements exceeding rel error bound",
-        num_rel_mismatches_, abs_error_buckets_);
+        stats_.num_rel_mismatches, stats_.abs_error_buckets);
     return out;
   }
 
@@ -593,48 +729,17 @@ class NearComparator {
   // Callback to invoke on miscompare.
   MiscompareCallback miscompare_callback_;
 
-  // Number of element mismatches encountered so far.
-  int64_t num_mismatches_ = 0;
-
-  // Number of elements with a nan mismatch.
-  int64_t num_nan_mismatches_ = 0;
-
-  // Number of elements which exceed the absolute/relative error bound.
-  int64_t num_abs_mismatches_ = 0;
-  int64_t num_rel_mismatches_ = 0;
-
   // A Literal containing which elements did not match in the expected and
   // actual literals. mismatches_ contains PREDs and is of the same sizes as
   // the comparison literals.
   Literal mismatches_;
 
-  // The number of mismatches to report in the output, sorted by relative error
-  // magnitude.
-  static constexpr int64_t kTopRelativeErrorCount = 5;
-
-  // The set of mismatches with the largest relative error. The size of this set
-  // is bounded by kTopRelativeErrorCount.
-  std::multiset<Mismatch> top_rel_mismatches_;
-
-  // Actual values are bucketed by absolute value. kAbsValueBucketBounds is the
-  // bounds of these buckets. abs_value_buckets_ contains a pair for each
-  // bucket: the element count and failure count.
-  static constexpr std::array<float, 7> kAbsValueBucketBounds = {
-      0.0, 0.0001, 0.001, 0.01, 0.1, 1, std::numeric_limits<float>::infinity()};
-  std::vector<std::pair<int64_t, int64_t>> abs_value_buckets_;
+  // The mismatch statistics of all the elements compared.
+  Stats stats_;
 
-  // Buckets for relative and absolute errors. The relative error buckets only
-  // contains those elements which exceed the *absolute* error bound, and vice
-  // versa. This makes it easy to see the effect of adjusting the relative (or
-  // absolute) error bound on the success of the comparison. kErrorBucketBounds
-  // are the lower bounds of the buckets in both vectors. The error buckets are
-  // a cumulative distribution so an error value may appear in more than one
-  // bucket. For example an error value of 0.003 may appear in the buckets
-  // bounded by 0.01, 0.1, and 1.0.
-  static constexpr std::array<float, 5> kErrorBucketBounds = {0.0001, 0.001,
-                                                              0.01, 0.1, 1};
-  std::vector<int64_t> abs_error_buckets_;
-  std::vector<int64_t> rel_error_buckets_;
+  // Whether the comparison stopped after error_.max_mismatches mismatches,
+  // before comparing all elements.
+  bool stopped_early_ = false;
 };
 
 template <typename NativeT>
@@ -479,6 +479,29 @@ TEST_F(LiteralUtilTest, DifferentLayoutEquality) {
   EXPECT_EQ(rowmajor, colmajor);
 }
 
+TEST_F(LiteralUtilTest, LargeLiteralRelayoutConvertAndEquality) {
+  // Large enough for the element loops to be split across threads.
+  Literal rowmajor(
+      ShapeUtil::MakeShapeWithDenseLayout(S32, {3, 1111, 1234}, {2, 1, 0}));
+  TF_ASSERT_OK(rowmajor.PopulateInplace(
+      [](void* dest, absl::Span<const int64_t> indices) {
+        *static_cast<int32_t*>(dest) =
+            (indices[0] * 1111 + indices[1]) * 1234 + indices[2];
+      }));
+  Literal colmajor = rowmajor.Relayout(LayoutUtil::MakeLayout({0, 1, 2}));
+  EXPECT_EQ(colmajor.Get<int32_t>({2, 1000, 1}), (2 * 1111 + 1000) * 1234 + 1);
+  EXPECT_EQ(rowmajor, colmajor);
+  EXPECT_EQ(rowmajor, colmajor.Relayout(rowmajor.shape().layout()));
+
+  colmajor.Set<int32_t>({2, 1110, 1233}, -1);
+  EXPECT_NE(rowmajor, colmajor);
+  EXPECT_NE(rowmajor, colmajor.Relayout(rowmajor.shape().layout()));
+
+  TF_ASSERT_OK_AND_ASSIGN(Literal converted, rowmajor.Convert(F32));
+  EXPECT_EQ(converted.Get<float>({1, 2, 3}), (1111 + 2) * 1234 + 3);
+  EXPECT_EQ(converted.Get<float>({2, 1110, 1233}), 3 * 1111 * 1234 - 1);
+}
+
 TEST_F(LiteralUtilTest, TupleEquality) {
   // Test equality with tuples.
   auto scalar = LiteralUtil::CreateR0<float>(1.0);
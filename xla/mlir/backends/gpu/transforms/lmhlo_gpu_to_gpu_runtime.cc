@@ -879,6 +879,17 @@ class RadixSortOpLowering : public OpRewritePattern<RadixSortOp> {
                                               TypeRange(), op.getOperands());
     call->setAttr(b.getStringAttr("descending"), op.getDescendingAttr());
 
+    // Multi-dimensional inputs are sorted along their minor-most dimension.
+    const auto& dims =
+        op.getInputs().front().getType().cast<mlir::MemRefType>().getShape();
+    int64_t batch_size =
+        dims.size() > 1
+            ? std::accumulate(dims.begin(), dims.end() - 1, int64_t{1},
+                              [](int64_t a, int64_t b) { return a * b; })
+            : 1;
+    call->setAttr(b.getStringAttr("batch_size"),
+                  b.getI64IntegerAttr(batch_size));
+
     // Erase the original operation.
     rewriter.eraseOp(op);
 
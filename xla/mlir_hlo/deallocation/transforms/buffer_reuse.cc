@@ -40,6 +40,14 @@ namespace mlir {
 namespace deallocation {
 namespace {
 
+// Returns whether the size of `alloc` is the same in all iterations of the loop
+// `parent`, i.e. all its dynamic sizes are defined outside of it.
+bool hasLoopInvariantSize(memref::AllocOp alloc, Operation* parent) {
+  return llvm::all_of(alloc.getDynamicSizes(), [&](Value size) {
+    return size.getParentRegion()->isAncestor(parent->getParentRegion());
+  });
+}
+
 SmallVector<Value> hoistAllocs(Operation* parent, Region& region,
                                SmallVector<Value> freeAllocs) {
   if (region.empty()) return freeAllocs;
@@ -52,7 +60,7 @@ SmallVector<Value> hoistAllocs(Operation* parent, Region& region,
   auto* op = &region.front().front();
   while (op) {
     auto alloc = llvm::dyn_cast<memref::AllocOp>(op);
-    if (alloc && alloc.getDynamicSizes().empty()) {
+    if (alloc && hasLoopInvariantSize(alloc, parent)) {
       auto dealloc = llvm::find_if(op->getUsers(), [&](Operation* user) {
         return llvm::isa<memref::DeallocOp>(user) &&
                user->getParentRegion() == &region;
@@ -63,7 +71,10 @@ SmallVector<Value> hoistAllocs(Operation* parent, Region& region,
       }
 
       auto* reusable = llvm::find_if(freeAllocs, [&](Value free) {
-        return free && free.getType() == alloc.getType();
+        if (!free || free.getType() != alloc.getType()) return false;
+        auto freeAlloc = free.getDefiningOp<memref::AllocOp>();
+        return freeAlloc && llvm::equal(freeAlloc.getDynamicSizes(),
+                                        alloc.getDynamicSizes());
       });
       if (reusable == freeAllocs.end()) {
         dealloc->moveAfter(parent);
@@ -61,6 +61,45 @@ func.func @hoist_from_nested_for(%lb: index, %ub: index, %step: index) {
 
 // -----
 
+func.func @hoist_loop_invariant_dynamic_alloc(%lb: index, %ub: index,
+                                              %step: index, %size: index) {
+  scf.for %i = %lb to %ub step %step {
+    %alloc = memref.alloc(%size) : memref<?xf32>
+    "test.use"(%alloc) : (memref<?xf32>) -> ()
+    memref.dealloc %alloc : memref<?xf32>
+  }
+  return
+}
+
+// CHECK-LABEL: @hoist_loop_invariant_dynamic_alloc
+// CHECK-SAME:    %[[SIZE:[a-z0-9]*]]: index)
+// CHECK-NEXT: %[[ALLOC:.*]] = memref.alloc(%[[SIZE]]) : memref<?xf32>
+// CHECK-NEXT: scf.for
+// CHECK-NEXT:   test.use
+// CHECK-NEXT: }
+// CHECK-NEXT: memref.dealloc %[[ALLOC]]
+
+// -----
+
+func.func @no_hoist_loop_variant_dynamic_alloc(%lb: index, %ub: index,
+                                               %step: index) {
+  scf.for %i = %lb to %ub step %step {
+    %alloc = memref.alloc(%i) : memref<?xf32>
+    "test.use"(%alloc) : (memref<?xf32>) -> ()
+    memref.dealloc %alloc : memref<?xf32>
+  }
+  return
+}
+
+// CHECK-LABEL: @no_hoist_loop_variant_dynamic_alloc
+// CHECK-NEXT: scf.for
+// CHECK-NEXT:   memref.alloc
+// CHECK-NEXT:   test.use
+// CHECK-NEXT:   memref.dealloc
+// CHECK-NEXT: }
+
+// -----
+
 func.func @hoist_from_while() {
   scf.while() : () -> () {
     %0 = "test.make_condition"() : () -> i1
@@ -619,12 +619,14 @@ void AbstractTfrtCpuBuffer::CopyFromLiteral(
 /*static*/ StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
 AbstractTfrtCpuBuffer::AllocateTrackedDeviceBuffer(
     const Shape& on_device_shape,
-    absl::InlinedVector<tsl::AsyncValueRef<CpuEvent>, 4> definition_events) {
+    absl::InlinedVector<tsl::AsyncValueRef<CpuEvent>, 4> definition_events,
+    int numa_node) {
   absl::InlinedVector<std::shared_ptr<MaybeOwningCpuMemory>, 4> buffers;
   if (!on_device_shape.IsTuple()) {
     size_t byte_size = ShapeUtil::ByteSizeOf(on_device_shape);
-    TF_ASSIGN_OR_RETURN(std::shared_ptr<MaybeOwningCpuMemory> device_buffer,
-                        MaybeOwningCpuMemory::AllocateShared(byte_size));
+    TF_ASSIGN_OR_RETURN(
+        std::shared_ptr<MaybeOwningCpuMemory> device_buffer,
+        MaybeOwningCpuMemory::AllocateShared(byte_size, numa_node));
     buffers.push_back(std::move(device_buffer));
     return std::make_unique<TrackedTfrtCpuDeviceBuffer>(
         /*is_tuple=*/false, std::move(buffers), std::move(definition_events));
@@ -633,8 +635,9 @@ AbstractTfrtCpuBuffer::AllocateTrackedDeviceBuffer(
   buffers.reserve(on_device_shape.tuple_shapes().size());
   for (const auto& leaf_shape : on_device_shape.tuple_shapes()) {
     size_t byte_size = ShapeUtil::ByteSizeOf(leaf_shape);
-    TF_ASSIGN_OR_RETURN(std::shared_ptr<MaybeOwningCpuMemory> device_buffer,
-                        MaybeOwningCpuMemory::AllocateShared(byte_size));
+    TF_ASSIGN_OR_RETURN(
+        std::shared_ptr<MaybeOwningCpuMemory> device_buffer,
+        MaybeOwningCpuMemory::AllocateShared(byte_size, numa_node));
     buffers.push_back(std::move(device_buffer));
   }
   return std::make_unique<TrackedTfrtCpuDeviceBuffer>(
@@ -663,7 +666,7 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
     PjRtClient::HostBufferSemantics host_buffer_semantics,
     std::function<void()> on_done_with_host_buffer, const Shape& shape,
     AsyncWorkRunner* async_work_runner, absl::Mutex* transpose_mu,
-    TransposePlanCache* transpose_cache) {
+    TransposePlanCache* transpose_cache, int numa_node) {
   bool has_default_layout =
       !byte_strides || HasMajorToMinorLayout(type, dims, *byte_strides);
   // If the input buffer has a default layout and is sufficiently aligned, we
@@ -685,8 +688,9 @@ AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
     buffers.push_back(std::move(device_buffer));
     on_delete_callback = std::move(on_done_with_host_buffer);
   } else {
-    TF_ASSIGN_OR_RETURN(std::shared_ptr<MaybeOwningCpuMemory> device_buffer,
-                        MaybeOwningCpuMemory::AllocateShared(byte_size));
+    TF_ASSIGN_OR_RETURN(
+        std::shared_ptr<MaybeOwningCpuMemory> device_buffer,
+        MaybeOwningCpuMemory::AllocateShared(byte_size, numa_node));
     auto dst_data_ptr = device_buffer->data();
     buffers.push_back(device_buffer);
     if (!has_default_layout) {
@@ -244,12 +244,13 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
       AsyncWorkRunner* async_work_runner);
 
   // Allocates a new `TrackedTfrtCpuDeviceBuffer` with the given shape and
-  // definition events.
+  // definition events. Large leaf buffers are placed on `numa_node`.
   static StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
   AllocateTrackedDeviceBuffer(
       const Shape& on_device_shape,
       absl::InlinedVector<tsl::AsyncValueRef<runtime::CpuEvent>, 4>
-          definition_events);
+          definition_events,
+      int numa_node = tsl::port::kNUMANoAffinity);
 
   // Allocates new cpu events to `avs` and `definition_events`. If `shape` is a
   // tuple, multiple events will be allocated. Otherwise, `avs` and
@@ -263,7 +264,7 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
   // A helper function for PjRtClient::BufferFromHostBuffer. Creates a new cpu
   // device buffer from the host buffer (maybe zero-copy or async).
   // `transpose_mu` and `transpose_cache` are used to transpose the input
-  // layout.
+  // layout. Copies of large host buffers are placed on `numa_node`.
   static StatusOr<std::unique_ptr<TrackedTfrtCpuDeviceBuffer>>
   BufferFromHostBufferHelper(
       const void* data, PrimitiveType type, absl::Span<int64_t const> dims,
@@ -271,7 +272,8 @@ class AbstractTfrtCpuBuffer : public PjRtBuffer {
       PjRtClient::HostBufferSemantics host_buffer_semantics,
       std::function<void()> on_done_with_host_buffer, const Shape& shape,
       AsyncWorkRunner* async_work_runner, absl::Mutex* transpose_mu,
-      TransposePlanCache* transpose_cache);
+      TransposePlanCache* transpose_cache,
+      int numa_node = tsl::port::kNUMANoAffinity);
 
  protected:
   virtual absl::string_view buffer_name() const = 0;
@@ -0,0 +1,81 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_C_PJRT_C_API_BATCHED_EXECUTE_EXTENSION_H_
+#define XLA_PJRT_C_PJRT_C_API_BATCHED_EXECUTE_EXTENSION_H_
+
+#include <stddef.h>
+
+#include "xla/pjrt/c/pjrt_c_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PJRT_API_BATCHED_EXECUTE_EXTENSION_VERSION 0
+
+// Called once per execution when it completes on its device. `error` is
+// nullptr on success. Otherwise it is owned by the plugin and only valid for
+// the duration of the call.
+typedef void (*PJRT_ExecuteBatch_OnDone)(PJRT_Error* error, size_t execution,
+                                         void* user_arg);
+
+struct PJRT_LoadedExecutable_ExecuteBatch_Args {
+  size_t struct_size;
+  void* priv;
+  PJRT_LoadedExecutable* executable;
+  // Only needs to stay alive for the duration of the call. Send and recv
+  // callbacks are not supported.
+  PJRT_ExecuteOptions* options;
+  size_t num_executions;
+  // The addressable device of each execution, of size `num_executions`.
+  PJRT_Device* const* execute_devices;
+  // Inputs of size [`num_executions`, `num_args`], in row-major order. Only
+  // needs to stay alive for the duration of the call.
+  PJRT_Buffer* const* argument_lists;
+  size_t num_args;
+  // Outputs of size [`num_executions`, `num_outputs`], in row-major order,
+  // allocated by the caller, where `num_outputs` is the number of outputs
+  // of the executable. PJRT_Buffer_Destroy must be called on the output
+  // PJRT_Buffer*. If an error is returned, the outputs of the executions that
+  // were enqueued before the error are set, and the others are nullptr.
+  PJRT_Buffer** output_lists;  // in/out
+  size_t num_outputs;
+  // Optional. Called when each execution completes, instead of creating
+  // events. Only called for executions that were enqueued.
+  PJRT_ExecuteBatch_OnDone on_done;
+  void* on_done_user_arg;
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_LoadedExecutable_ExecuteBatch_Args,
+                          on_done_user_arg);
+
+// Enqueues `num_executions` executions of a single-device program, each on one
+// device, in one call. Equivalent to calling PJRT_LoadedExecutable_Execute
+// with `execute_device` set for each execution, without the per-call argument
+// conversions and completion events.
+typedef PJRT_Error* PJRT_LoadedExecutable_ExecuteBatch(
+    PJRT_LoadedExecutable_ExecuteBatch_Args* args);
+
+typedef struct PJRT_BatchedExecute_Extension {
+  PJRT_Structure_Type type;
+  const void* next;
+  PJRT_LoadedExecutable_ExecuteBatch* execute_batch;
+} PJRT_BatchedExecute_Extension;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // XLA_PJRT_C_PJRT_C_API_BATCHED_EXECUTE_EXTENSION_H_
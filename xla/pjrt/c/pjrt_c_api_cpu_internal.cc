@@ -19,6 +19,7 @@ limitations under the License.
 #include <utility>
 
 #include "xla/pjrt/c/pjrt_c_api.h"
+#include "xla/pjrt/c/pjrt_c_api_batched_execute_extension.h"
 #include "xla/pjrt/c/pjrt_c_api_helpers.h"
 #include "xla/pjrt/c/pjrt_c_api_wrapper_impl.h"
 #include "xla/pjrt/pjrt_client.h"
@@ -47,10 +48,17 @@ PJRT_Error* PJRT_CpuDeviceTopology_Create(
       "Topology not supported for CPU compilation.")};
 }
 
-constexpr PJRT_Api pjrt_api =
-    pjrt::CreatePjrtApi(pjrt::cpu_plugin::PJRT_Client_Create,
-                        pjrt::cpu_plugin::PJRT_CpuDeviceTopology_Create,
-                        pjrt::PJRT_Plugin_Initialize_NoOp);
+PJRT_BatchedExecute_Extension batched_execute_extension{
+    /*type=*/PJRT_Structure_Type::PJRT_Structure_Type_BatchedExecute,
+    /*next=*/nullptr,
+    /*execute_batch=*/pjrt::PJRT_LoadedExecutable_ExecuteBatch,
+};
+
+constexpr PJRT_Api pjrt_api = pjrt::CreatePjrtApi(
+    pjrt::cpu_plugin::PJRT_Client_Create,
+    pjrt::cpu_plugin::PJRT_CpuDeviceTopology_Create,
+    pjrt::PJRT_Plugin_Initialize_NoOp,
+    static_cast<void*>(&batched_execute_extension));
 
 const PJRT_Api* GetCpuPjrtApi() { return &pjrt_api; }
 
@@ -14,15 +14,223 @@ limitations under the License.
 ==============================================================================*/
 #include "xla/pjrt/c/pjrt_c_api_cpu.h"
 
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/client/executable_build_options.h"
+#include "xla/pjrt/c/pjrt_c_api.h"
+#include "xla/pjrt/c/pjrt_c_api_batched_execute_extension.h"
+#include "xla/pjrt/c/pjrt_c_api_helpers.h"
 #include "xla/pjrt/c/pjrt_c_api_test.h"
+#include "xla/pjrt/c/pjrt_c_api_test_base.h"
 #include "xla/pjrt/c/pjrt_c_api_wrapper_impl.h"
+#include "xla/pjrt/compile_options.pb.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/service/computation_placer.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/status.h"
+#include "tsl/platform/status_matchers.h"
 
 namespace pjrt {
 namespace {
 
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::tsl::testing::StatusIs;
+
 const bool kUnused = (RegisterPjRtCApiTestFactory([]() { return GetPjrtApi(); },
                                                   /*platform_name=*/"cpu"),
                       true);
 
+constexpr absl::string_view kModuleAddToItself = R"(module {
+func.func @main(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+  %0 = mhlo.add %arg0, %arg0 : tensor<4xf32>
+  return %0 : tensor<4xf32>
+}})";
+
+class PjrtCApiCpuBatchedExecuteTest : public PjrtCApiTestBase {
+ protected:
+  PjrtCApiCpuBatchedExecuteTest() : PjrtCApiTestBase(GetPjrtApi()) {}
+
+  void SetUp() override {
+    const PJRT_Structure_Base* next =
+        reinterpret_cast<const PJRT_Structure_Base*>(api_->extension_start);
+    while (next != nullptr &&
+           next->type !=
+               PJRT_Structure_Type::PJRT_Structure_Type_BatchedExecute) {
+      next = next->next;
+    }
+    ASSERT_NE(next, nullptr);
+    extension_ = reinterpret_cast<const PJRT_BatchedExecute_Extension*>(next);
+
+    xla::ExecutableBuildOptions build_options;
+    build_options.set_device_ordinal(0);
+    xla::DeviceAssignment device_assignment(1, 1);
+    device_assignment(0, 0) = 0;
+    build_options.set_device_assignment(device_assignment);
+    xla::CompileOptions options;
+    options.executable_build_options = build_options;
+    absl::StatusOr<xla::CompileOptionsProto> options_proto = options.ToProto();
+    TF_ASSERT_OK(options_proto.status());
+    std::string options_str = options_proto->SerializeAsString();
+
+    std::string format(::pjrt::kMlirFormat);
+    std::string program_code(kModuleAddToItself);
+    PJRT_Program program{
+        .struct_size = PJRT_Program_STRUCT_SIZE,
+        .priv = nullptr,
+        .code = program_code.data(),
+        .code_size = program_code.size(),
+        .format = format.c_str(),
+        .format_size = format.size(),
+    };
+    PJRT_Client_Compile_Args args{
+        .struct_size = PJRT_Client_Compile_Args_STRUCT_SIZE,
+        .priv = nullptr,
+        .client = client_,
+        .program = &program,
+        .compile_options = options_str.c_str(),
+        .compile_options_size = options_str.size(),
+    };
+    auto error = ToUniquePtr(api_->PJRT_Client_Compile(&args));
+    ASSERT_EQ(error, nullptr);
+    executable_ = args.executable;
+  }
+
+  void TearDown() override {
+    if (executable_ != nullptr) {
+      PJRT_LoadedExecutable_Destroy_Args args{
+          .struct_size = PJRT_LoadedExecutable_Destroy_Args_STRUCT_SIZE,
+          .priv = nullptr,
+          .executable = executable_,
+      };
+      auto error = ToUniquePtr(api_->PJRT_LoadedExecutable_Destroy(&args));
+      EXPECT_EQ(error, nullptr);
+    }
+  }
+
+  // Returns the values of a f32[4] buffer.
+  std::vector<float> ToHostVector(PJRT_Buffer* buffer) {
+    std::vector<float> values(4);
+    PJRT_Buffer_ToHostBuffer_Args args{
+        .struct_size = PJRT_Buffer_ToHostBuffer_Args_STRUCT_SIZE,
+        .priv = nullptr,
+        .src = buffer,
+        .host_layout = nullptr,
+        .dst = values.data(),
+        .dst_size = values.size() * sizeof(float),
+        .event = nullptr,
+    };
+    auto error = ToUniquePtr(api_->PJRT_Buffer_ToHostBuffer(&args));
+    CHECK(error == nullptr);
+    TF_CHECK_OK(::pjrt::ConvertCEventToCppFuture(args.event, api_).Await());
+    return values;
+  }
+
+  const PJRT_BatchedExecute_Extension* extension_ = nullptr;
+  PJRT_LoadedExecutable* executable_ = nullptr;
+};
+
+struct OnDoneState {
+  absl::Mutex mu;
+  std::vector<size_t> done_executions;
+};
+
+void OnDone(PJRT_Error* error, size_t execution, void* user_arg) {
+  auto* state = static_cast<OnDoneState*>(user_arg);
+  absl::MutexLock lock(&state->mu);
+  if (error == nullptr) {
+    state->done_executions.push_back(execution);
+  }
+}
+
+TEST_F(PjrtCApiCpuBatchedExecuteTest, ExecutesEveryArgumentList) {
+  PJRT_Device* device = GetClientAddressableDevices()[0];
+  auto buffer0 = create_buffer(device).first;
+  auto buffer1 = create_buffer(device).first;
+  std::vector<PJRT_Buffer*> argument_lists = {buffer0.get(), buffer1.get()};
+  std::vector<PJRT_Device*> execute_devices = {device, device};
+  std::vector<PJRT_Buffer*> output_lists(2);
+
+  PJRT_ExecuteOptions options{};
+  options.struct_size = PJRT_ExecuteOptions_STRUCT_SIZE;
+  OnDoneState state;
+  PJRT_LoadedExecutable_ExecuteBatch_Args args{
+      .struct_size = PJRT_LoadedExecutable_ExecuteBatch_Args_STRUCT_SIZE,
+      .priv = nullptr,
+      .executable = executable_,
+      .options = &options,
+      .num_executions = 2,
+      .execute_devices = execute_devices.data(),
+      .argument_lists = argument_lists.data(),
+      .num_args = 1,
+      .output_lists = output_lists.data(),
+      .num_outputs = 1,
+      .on_done = &OnDone,
+      .on_done_user_arg = &state,
+  };
+  auto error = ToUniquePtr(extension_->execute_batch(&args));
+  ASSERT_EQ(error, nullptr);
+
+  auto buffer_deleter = ::pjrt::MakeBufferDeleter(api_);
+  for (PJRT_Buffer* output : output_lists) {
+    ASSERT_NE(output, nullptr);
+    // The buffers created by create_buffer() hold 41, 42, 43 and 44.
+    EXPECT_THAT(ToHostVector(output), ElementsAre(82, 84, 86, 88));
+    buffer_deleter(output);
+  }
+  absl::MutexLock lock(&state.mu);
+  state.mu.Await(absl::Condition(
+      +[](std::vector<size_t>* done) { return done->size() == 2; },
+      &state.done_executions));
+}
+
+TEST_F(PjrtCApiCpuBatchedExecuteTest, RejectsWrongNumOutputsBeforeExecuting) {
+  PJRT_Device* device = GetClientAddressableDevices()[0];
+  auto buffer = create_buffer(device).first;
+  std::vector<PJRT_Buffer*> argument_lists = {buffer.get()};
+  std::vector<PJRT_Device*> execute_devices = {device};
+  // Outputs start out non-null so the test sees that they get cleared.
+  int sentinel = 0;
+  PJRT_Buffer* unset = reinterpret_cast<PJRT_Buffer*>(&sentinel);
+  std::vector<PJRT_Buffer*> output_lists(2, unset);
+
+  PJRT_ExecuteOptions options{};
+  options.struct_size = PJRT_ExecuteOptions_STRUCT_SIZE;
+  OnDoneState state;
+  PJRT_LoadedExecutable_ExecuteBatch_Args args{
+      .struct_size = PJRT_LoadedExecutable_ExecuteBatch_Args_STRUCT_SIZE,
+      .priv = nullptr,
+      .executable = executable_,
+      .options = &options,
+      .num_executions = 1,
+      .execute_devices = execute_devices.data(),
+      .argument_lists = argument_lists.data(),
+      .num_args = 1,
+      .output_lists = output_lists.data(),
+      .num_outputs = 2,
+      .on_done = &OnDone,
+      .on_done_user_arg = &state,
+  };
+  auto error = ToUniquePtr(extension_->execute_batch(&args));
+  ASSERT_NE(error, nullptr);
+  EXPECT_THAT(::pjrt::PjrtErrorToStatus(error.get(), api_),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("num_outputs=2")));
+  // Nothing was executed.
+  EXPECT_THAT(output_lists, ElementsAre(nullptr, nullptr));
+  absl::MutexLock lock(&state.mu);
+  EXPECT_TRUE(state.done_executions.empty());
+}
+
 }  // namespace
 }  // namespace pjrt
@@ -28,6 +28,7 @@ limitations under the License.
 #include "xla/backends/profiler/plugin/profiler_c_api.h"
 #include "xla/backends/profiler/plugin/profiler_error.h"
 #include "xla/pjrt/c/pjrt_c_api.h"
+#include "xla/pjrt/c/pjrt_c_api_batched_execute_extension.h"
 #include "xla/pjrt/c/pjrt_c_api_gpu_extension.h"
 #include "xla/pjrt/c/pjrt_c_api_helpers.h"
 #include "xla/pjrt/c/pjrt_c_api_profiler_extension.h"
@@ -137,9 +138,15 @@ PLUGIN_Profiler_Api profiler_api{
     /*collect_data=*/xla::profiler::PLUGIN_Profiler_CollectData,
 };
 
+PJRT_BatchedExecute_Extension batched_execute_extension{
+    /*type=*/PJRT_Structure_Type::PJRT_Structure_Type_BatchedExecute,
+    /*next=*/nullptr,
+    /*execute_batch=*/pjrt::PJRT_LoadedExecutable_ExecuteBatch,
+};
+
 PJRT_Profiler_Extension profiler_extension{
     /*type=*/PJRT_Structure_Type::PJRT_Structure_Type_Profiler,
-    /*next=*/nullptr,
+    /*next=*/&batched_execute_extension,
     /*profiler_api=*/&profiler_api,
 };
 
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/pjrt/c/pjrt_c_api_wrapper_impl.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -43,6 +44,7 @@ limitations under the License.
 #include "xla/layout.h"
 #include "xla/literal.h"
 #include "xla/pjrt/c/pjrt_c_api.h"
+#include "xla/pjrt/c/pjrt_c_api_batched_execute_extension.h"
 #include "xla/pjrt/c/pjrt_c_api_helpers.h"
 #include "xla/pjrt/compile_options.pb.h"
 #include "xla/pjrt/mlir_to_hlo.h"
@@ -1309,6 +1311,19 @@ static std::vector<std::vector<xla::PjRtBuffer*>> Convert2DCBuffersToCppBuffers(
   return cpp_lists;
 }
 
+static xla::ExecuteOptions ToCppExecuteOptions(
+    const PJRT_ExecuteOptions& c_options) {
+  xla::ExecuteOptions options;
+  options.launch_id = c_options.launch_id;
+  options.strict_shape_checking = true;
+  options.arguments_are_tupled = false;
+  options.untuple_result = true;
+  options.context = nullptr;
+  options.multi_slice_config = nullptr;
+  options.use_major_to_minor_data_layout_for_callbacks = true;
+  return options;
+}
+
 PJRT_Error* PJRT_LoadedExecutable_Execute(
     PJRT_LoadedExecutable_Execute_Args* args) {
   PJRT_RETURN_IF_ERROR(ActualStructSizeIsGreaterOrEqual(
@@ -1317,14 +1332,7 @@ PJRT_Error* PJRT_LoadedExecutable_Execute(
   PJRT_RETURN_IF_ERROR(ActualStructSizeIsGreaterOrEqual(
       "PJRT_ExecuteOptions", PJRT_ExecuteOptions_STRUCT_SIZE,
       args->options->struct_size));
-  xla::ExecuteOptions options;
-  options.launch_id = args->options->launch_id;
-  options.strict_shape_checking = true;
-  options.arguments_are_tupled = false;
-  options.untuple_result = true;
-  options.context = nullptr;
-  options.multi_slice_config = nullptr;
-  options.use_major_to_minor_data_layout_for_callbacks = true;
+  xla::ExecuteOptions options = ToCppExecuteOptions(*args->options);
 
   std::vector<std::vector<xla::PjRtBuffer*>> cpp_argument_lists =
       Convert2DCBuffersToCppBuffers(args->argument_lists, args->num_devices,
@@ -1437,6 +1445,83 @@ PJRT_Error* PJRT_LoadedExecutable_Execute(
   return nullptr;
 }
 
+PJRT_Error* PJRT_LoadedExecutable_ExecuteBatch(
+    PJRT_LoadedExecutable_ExecuteBatch_Args* args) {
+  PJRT_RETURN_IF_ERROR(ActualStructSizeIsGreaterOrEqual(
+      "PJRT_LoadedExecutable_ExecuteBatch_Args",
+      PJRT_LoadedExecutable_ExecuteBatch_Args_STRUCT_SIZE, args->struct_size));
+  PJRT_RETURN_IF_ERROR(ActualStructSizeIsGreaterOrEqual(
+      "PJRT_ExecuteOptions", PJRT_ExecuteOptions_STRUCT_SIZE,
+      args->options->struct_size));
+  if (args->options->num_send_ops > 0 || args->options->num_recv_ops > 0) {
+    return new PJRT_Error{xla::Unimplemented(
+        "PJRT_LoadedExecutable_ExecuteBatch doesn't support send/recv "
+        "callbacks.")};
+  }
+  xla::ExecuteOptions options = ToCppExecuteOptions(*args->options);
+  xla::PjRtLoadedExecutable* executable = args->executable->get();
+  PJRT_ASSIGN_OR_RETURN(xla::CompileOptions compile_options,
+                        executable->GetCompileOptions());
+  const bool portable = compile_options.compile_portable_executable;
+  const bool fill_future = args->on_done != nullptr;
+
+  std::fill_n(args->output_lists, args->num_executions * args->num_outputs,
+              nullptr);
+  // Check the output count up front so that a mismatch can't leave some
+  // executions in flight with nowhere to put their results.
+  PJRT_ASSIGN_OR_RETURN(std::vector<xla::Shape> output_shapes,
+                        executable->GetOutputShapes());
+  if (output_shapes.size() != 1) {
+    return new PJRT_Error{
+        xla::Unimplemented("MPMD execution not supported by PJRT C API (in "
+                           "function PJRT_LoadedExecutable_ExecuteBatch).")};
+  }
+  const size_t num_outputs = output_shapes[0].IsTuple()
+                                 ? output_shapes[0].tuple_shapes_size()
+                                 : 1;
+  if (num_outputs != args->num_outputs) {
+    return new PJRT_Error{xla::InvalidArgument(
+        "PJRT_LoadedExecutable_ExecuteBatch got num_outputs=%d, but the "
+        "executable has %d outputs.",
+        args->num_outputs, num_outputs)};
+  }
+  std::vector<xla::PjRtBuffer*> cpp_arguments(args->num_args);
+  for (size_t i = 0; i < args->num_executions; ++i) {
+    PJRT_Buffer* const* c_arguments = args->argument_lists + i * args->num_args;
+    for (size_t j = 0; j < args->num_args; ++j) {
+      cpp_arguments[j] = c_arguments[j]->buffer.get();
+    }
+    xla::PjRtDevice* device = args->execute_devices[i]->device;
+    std::optional<xla::PjRtFuture<xla::Status>> returned_future;
+    std::vector<std::unique_ptr<xla::PjRtBuffer>> cpp_outputs;
+    if (portable) {
+      PJRT_ASSIGN_OR_RETURN(
+          cpp_outputs,
+          executable->ExecutePortable(cpp_arguments, device, options,
+                                      returned_future, fill_future));
+    } else {
+      PJRT_ASSIGN_OR_RETURN(
+          cpp_outputs,
+          executable->ExecuteSharded(cpp_arguments, device, options,
+                                     returned_future, fill_future));
+    }
+    PJRT_Buffer** c_outputs = args->output_lists + i * args->num_outputs;
+    for (size_t j = 0; j < cpp_outputs.size(); ++j) {
+      c_outputs[j] =
+          new PJRT_Buffer{std::move(cpp_outputs[j]), args->executable->client};
+    }
+    if (fill_future) {
+      returned_future->OnReady([on_done = args->on_done,
+                                user_arg = args->on_done_user_arg,
+                                i](xla::Status status) {
+        PJRT_Error error{std::move(status)};
+        on_done(error.status.ok() ? nullptr : &error, i, user_arg);
+      });
+    }
+  }
+  return nullptr;
+}
+
 PJRT_Error* PJRT_Executable_Serialize(PJRT_Executable_Serialize_Args* args) {
   PJRT_RETURN_IF_ERROR(ActualStructSizeIsGreaterOrEqual(
       "PJRT_Executable_Serialize_Args",
@@ -26,7 +26,7 @@ namespace xla {
 EventPool::Handle::~Handle() {
   if (pool_ && event_) {
     absl::MutexLock lock(&pool_->mu_);
-    pool_->free_events_.push(std::move(event_));
+    pool_->free_events_.push_back(std::move(event_));
   }
 }
 
@@ -41,8 +41,8 @@ StatusOr<EventPool::Handle> EventPool::AllocateEvent(
     event.pool_ = this;
     absl::MutexLock lock(&mu_);
     if (!free_events_.empty()) {
-      event.event_ = std::move(free_events_.top());
-      free_events_.pop();
+      event.event_ = std::move(free_events_.back());
+      free_events_.pop_back();
     }
   }
   if (!event.event_) {
@@ -52,14 +52,30 @@ StatusOr<EventPool::Handle> EventPool::AllocateEvent(
   return event;
 }
 
-void EventPool::ThenRecordEvent(se::Stream* stream, EventPool::Handle& handle) {
-  absl::MutexLock lock(&mu_);
+void EventPool::ThenRecordEventLocked(se::Stream* stream,
+                                      EventPool::Handle& handle) {
   stream->ThenRecordEvent(handle.event_.get());
   handle.sequence_number_ = next_sequence_number_++;
 }
 
+void EventPool::ThenRecordEvent(se::Stream* stream, EventPool::Handle& handle) {
+  absl::MutexLock lock(&mu_);
+  ThenRecordEventLocked(stream, handle);
+}
+
 StatusOr<EventPool::Handle> EventPool::ThenAllocateAndRecordEvent(
     se::Stream* stream) {
+  if (allow_reuse_) {
+    absl::MutexLock lock(&mu_);
+    if (!free_events_.empty()) {
+      Handle handle;
+      handle.pool_ = this;
+      handle.event_ = std::move(free_events_.back());
+      free_events_.pop_back();
+      ThenRecordEventLocked(stream, handle);
+      return handle;
+    }
+  }
   TF_ASSIGN_OR_RETURN(EventPool::Handle handle,
                       AllocateEvent(stream->parent()));
   ThenRecordEvent(stream, handle);
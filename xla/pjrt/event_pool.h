@@ -17,7 +17,7 @@ limitations under the License.
 #define XLA_PJRT_EVENT_POOL_H_
 
 #include <memory>
-#include <stack>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "xla/statusor.h"
@@ -75,7 +75,11 @@ class EventPool {
   // cudaEventRecord even if that event may still be in use on the device; APIs
   // such as cudaStreamWaitEvent capture the state of the event at the time of
   // the host-side call and are not affected by a later host-side
-  // cudaEventRecord.
+  // cudaEventRecord. Hence events are reused as soon as their handles are
+  // deleted, without waiting for them to complete.
+  //
+  // Reusing an event takes the pool lock once, around both taking the event
+  // from the free list and recording it.
   StatusOr<Handle> ThenAllocateAndRecordEvent(se::Stream* stream);
 
   // Version of ThenAllocateAndRecordEvent split into two phases; this is
@@ -84,10 +88,16 @@ class EventPool {
   void ThenRecordEvent(se::Stream* stream, EventPool::Handle& handle);
 
  private:
+  // Records `handle` on `stream` and assigns its sequence number.
+  void ThenRecordEventLocked(se::Stream* stream, Handle& handle)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   const bool allow_reuse_;
 
   absl::Mutex mu_;
-  std::stack<std::unique_ptr<se::Event>> free_events_ ABSL_GUARDED_BY(mu_);
+  // Used as a stack, so that the most recently used events, whose state is
+  // likely to be cached by the driver, are reused first.
+  std::vector<std::unique_ptr<se::Event>> free_events_ ABSL_GUARDED_BY(mu_);
   uint64_t next_sequence_number_ ABSL_GUARDED_BY(mu_);
 };
 
@@ -0,0 +1,115 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/execution_admission_queue.h"
+
+#include <cstdint>
+
+#include "tsl/platform/logging.h"
+
+namespace xla {
+
+ExecutionAdmissionQueue::ExecutionAdmissionQueue(
+    int64_t max_inflight_executions, int64_t max_inflight_bytes)
+    : max_inflight_executions_(max_inflight_executions),
+      max_inflight_bytes_(max_inflight_bytes) {
+  CHECK_GT(max_inflight_executions, 0);
+  CHECK_GT(max_inflight_bytes, 0);
+}
+
+bool ExecutionAdmissionQueue::CanAdmit(CanAdmitArgs* args) {
+  ExecutionAdmissionQueue* queue = args->queue;
+  // Only the oldest waiter of the highest priority may be admitted next.
+  if (queue->waiters_.begin()->second.front() != args->waiter) {
+    return false;
+  }
+  if (queue->inflight_executions_ >= queue->max_inflight_executions_) {
+    return false;
+  }
+  return queue->inflight_executions_ == 0 ||
+         queue->inflight_bytes_ + args->waiter->bytes <=
+             queue->max_inflight_bytes_;
+}
+
+ExecutionAdmissionQueue::Ticket ExecutionAdmissionQueue::Admit(
+    int priority, int64_t bytes) {
+  CHECK_GE(bytes, 0);
+  Waiter waiter{bytes};
+  CanAdmitArgs args{this, &waiter};
+
+  absl::MutexLock lock(&mu_);
+  auto it = waiters_.try_emplace(priority).first;
+  it->second.push_back(&waiter);
+  mu_.Await(absl::Condition(&CanAdmit, &args));
+
+  it->second.pop_front();
+  if (it->second.empty()) {
+    waiters_.erase(it);
+  }
+  ++inflight_executions_;
+  inflight_bytes_ += bytes;
+  return Ticket(this, bytes);
+}
+
+void ExecutionAdmissionQueue::Release(int64_t bytes) {
+  absl::MutexLock lock(&mu_);
+  --inflight_executions_;
+  inflight_bytes_ -= bytes;
+}
+
+int64_t ExecutionAdmissionQueue::inflight_executions() const {
+  absl::MutexLock lock(&mu_);
+  return inflight_executions_;
+}
+
+int64_t ExecutionAdmissionQueue::inflight_bytes() const {
+  absl::MutexLock lock(&mu_);
+  return inflight_bytes_;
+}
+
+int64_t ExecutionAdmissionQueue::pending_executions() const {
+  absl::MutexLock lock(&mu_);
+  int64_t pending = 0;
+  for (const auto& [priority, waiters] : waiters_) {
+    pending += waiters.size();
+  }
+  return pending;
+}
+
+ExecutionAdmissionQueue::Ticket::~Ticket() {
+  if (queue_) {
+    queue_->Release(bytes_);
+  }
+}
+
+ExecutionAdmissionQueue::Ticket::Ticket(Ticket&& other) noexcept
+    : queue_(other.queue_), bytes_(other.bytes_) {
+  other.queue_ = nullptr;
+}
+
+ExecutionAdmissionQueue::Ticket& ExecutionAdmissionQueue::Ticket::operator=(
+    Ticket&& other) noexcept {
+  if (this != &other) {
+    if (queue_) {
+      queue_->Release(bytes_);
+    }
+    queue_ = other.queue_;
+    bytes_ = other.bytes_;
+    other.queue_ = nullptr;
+  }
+  return *this;
+}
+
+}  // namespace xla
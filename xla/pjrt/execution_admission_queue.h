@@ -0,0 +1,103 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_EXECUTION_ADMISSION_QUEUE_H_
+#define XLA_PJRT_EXECUTION_ADMISSION_QUEUE_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+
+#include "absl/synchronization/mutex.h"
+
+namespace xla {
+
+// Bounds the number of executions and the number of bytes they reference that
+// are in flight on a device, and admits pending executions in priority order.
+//
+// Executions with a higher priority are admitted before any pending execution
+// with a lower priority; executions with the same priority are admitted in
+// FIFO order. Unlike a plain Semaphore this avoids head-of-line blocking of
+// latency-critical executions behind a backlog of batch executions, at the
+// cost of possibly starving low priority executions under sustained load.
+//
+// An execution that references more bytes than the limit is admitted once
+// nothing else is in flight, so that it can't deadlock.
+class ExecutionAdmissionQueue {
+ public:
+  ExecutionAdmissionQueue(int64_t max_inflight_executions,
+                          int64_t max_inflight_bytes);
+
+  // An admitted execution. Releases its capacity when destroyed.
+  class Ticket {
+   public:
+    Ticket() = default;
+    Ticket(ExecutionAdmissionQueue* queue, int64_t bytes)
+        : queue_(queue), bytes_(bytes) {}
+    ~Ticket();
+
+    Ticket(const Ticket&) = delete;
+    Ticket(Ticket&& other) noexcept;
+    Ticket& operator=(const Ticket&) = delete;
+    Ticket& operator=(Ticket&& other) noexcept;
+
+    int64_t bytes() const { return bytes_; }
+
+   private:
+    ExecutionAdmissionQueue* queue_ = nullptr;
+    int64_t bytes_ = 0;
+  };
+
+  // Blocks until an execution referencing `bytes` bytes can be admitted with
+  // the given priority.
+  Ticket Admit(int priority, int64_t bytes);
+
+  int64_t max_inflight_executions() const { return max_inflight_executions_; }
+  int64_t max_inflight_bytes() const { return max_inflight_bytes_; }
+
+  int64_t inflight_executions() const;
+  int64_t inflight_bytes() const;
+  // Number of executions blocked in Admit().
+  int64_t pending_executions() const;
+
+ private:
+  struct Waiter {
+    int64_t bytes;
+  };
+
+  struct CanAdmitArgs {
+    ExecutionAdmissionQueue* queue;
+    const Waiter* waiter;
+  };
+  static bool CanAdmit(CanAdmitArgs* args)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(args->queue->mu_);
+
+  void Release(int64_t bytes);
+
+  const int64_t max_inflight_executions_;
+  const int64_t max_inflight_bytes_;
+
+  mutable absl::Mutex mu_;
+  int64_t inflight_executions_ ABSL_GUARDED_BY(mu_) = 0;
+  int64_t inflight_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  // Pending executions, by decreasing priority.
+  std::map<int, std::deque<const Waiter*>, std::greater<int>> waiters_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_EXECUTION_ADMISSION_QUEUE_H_
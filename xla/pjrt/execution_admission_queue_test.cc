@@ -0,0 +1,118 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/execution_admission_queue.h"
+
+#include <optional>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "xla/test.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla {
+namespace {
+
+using ::testing::ElementsAre;
+
+TEST(ExecutionAdmissionQueueTest, UnthreadedTests) {
+  ExecutionAdmissionQueue queue(/*max_inflight_executions=*/2,
+                                /*max_inflight_bytes=*/100);
+  {
+    auto a = queue.Admit(/*priority=*/0, /*bytes=*/60);
+    EXPECT_EQ(a.bytes(), 60);
+    auto b = queue.Admit(/*priority=*/0, /*bytes=*/40);
+    EXPECT_EQ(queue.inflight_executions(), 2);
+    EXPECT_EQ(queue.inflight_bytes(), 100);
+  }
+  EXPECT_EQ(queue.inflight_executions(), 0);
+  EXPECT_EQ(queue.inflight_bytes(), 0);
+
+  // Executions larger than the byte limit are admitted when the device is
+  // otherwise idle.
+  {
+    auto c = queue.Admit(/*priority=*/0, /*bytes=*/1000);
+    EXPECT_EQ(queue.inflight_bytes(), 1000);
+  }
+
+  ExecutionAdmissionQueue::Ticket moved;
+  {
+    auto d = queue.Admit(/*priority=*/0, /*bytes=*/10);
+    moved = std::move(d);
+  }
+  EXPECT_EQ(queue.inflight_bytes(), 10);
+}
+
+TEST(ExecutionAdmissionQueueTest, HigherPriorityIsAdmittedFirst) {
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "test", 2);
+  ExecutionAdmissionQueue queue(/*max_inflight_executions=*/1,
+                                /*max_inflight_bytes=*/100);
+  std::optional<ExecutionAdmissionQueue::Ticket> blocker =
+      queue.Admit(/*priority=*/0, /*bytes=*/1);
+
+  absl::Mutex mu;
+  std::vector<int> admitted;
+  auto admit = [&](int priority, absl::Notification* done) {
+    pool.Schedule([&, priority, done] {
+      auto ticket = queue.Admit(priority, /*bytes=*/1);
+      {
+        absl::MutexLock lock(&mu);
+        admitted.push_back(priority);
+      }
+      done->Notify();
+    });
+  };
+
+  absl::Notification low_done;
+  admit(/*priority=*/0, &low_done);
+  while (queue.pending_executions() < 1) {
+    tsl::Env::Default()->SleepForMicroseconds(100);
+  }
+  absl::Notification high_done;
+  admit(/*priority=*/1, &high_done);
+  while (queue.pending_executions() < 2) {
+    tsl::Env::Default()->SleepForMicroseconds(100);
+  }
+
+  blocker.reset();
+  low_done.WaitForNotification();
+  high_done.WaitForNotification();
+  EXPECT_THAT(admitted, ElementsAre(1, 0));
+}
+
+TEST(ExecutionAdmissionQueueTest, WaitsForBytes) {
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "test", 1);
+  ExecutionAdmissionQueue queue(/*max_inflight_executions=*/8,
+                                /*max_inflight_bytes=*/100);
+  std::optional<ExecutionAdmissionQueue::Ticket> a =
+      queue.Admit(/*priority=*/0, /*bytes=*/80);
+
+  absl::Notification b_done;
+  pool.Schedule([&] {
+    auto b = queue.Admit(/*priority=*/0, /*bytes=*/40);
+    b_done.Notify();
+  });
+  while (queue.pending_executions() < 1) {
+    tsl::Env::Default()->SleepForMicroseconds(100);
+  }
+  EXPECT_FALSE(b_done.HasBeenNotified());
+  a.reset();
+  b_done.WaitForNotification();
+}
+
+}  // namespace
+}  // namespace xla
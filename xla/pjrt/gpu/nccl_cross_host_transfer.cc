@@ -0,0 +1,212 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/gpu/nccl_cross_host_transfer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+#include "xla/util.h"
+#include "tsl/platform/errors.h"
+
+#ifdef XLA_ENABLE_XCCL
+#include "xla/service/gpu/nccl_utils.h"
+#include "xla/stream_executor/gpu/gpu_activation.h"
+#include "xla/stream_executor/gpu/gpu_stream.h"
+#endif  // XLA_ENABLE_XCCL
+
+namespace xla {
+
+std::string NcclTransferDescriptor::Serialize() const {
+  return absl::StrCat(index, ",", count, ",", id);
+}
+
+StatusOr<NcclTransferDescriptor> NcclTransferDescriptor::Parse(
+    absl::string_view serialized) {
+  // The id is binary and may contain commas, so it is last.
+  std::vector<absl::string_view> parts =
+      absl::StrSplit(serialized, absl::MaxSplits(',', 2));
+  NcclTransferDescriptor descriptor;
+  if (parts.size() != 3 || !absl::SimpleAtoi(parts[0], &descriptor.index) ||
+      !absl::SimpleAtoi(parts[1], &descriptor.count) || parts[2].empty() ||
+      descriptor.count <= 0 || descriptor.index < 0 ||
+      descriptor.index >= descriptor.count) {
+    return InvalidArgument("Malformed cross-host transfer descriptor.");
+  }
+  descriptor.id = std::string(parts[2]);
+  return descriptor;
+}
+
+#ifdef XLA_ENABLE_XCCL
+
+// Non-blocking communicators, with which the waits for the peer can time out,
+// were added in NCCL 2.14.
+#if NCCL_VERSION_CODE >= 21400
+#define XLA_NCCL_NON_BLOCKING 1
+#else
+#define XLA_NCCL_NON_BLOCKING 0
+#endif
+
+namespace {
+
+#if XLA_NCCL_NON_BLOCKING
+// Waits for the pending operations of the non-blocking communicator `comm` to
+// complete. Aborts `comm` if they fail or don't complete by `deadline`.
+Status WaitForComm(ncclComm_t comm, absl::Time deadline) {
+  ncclResult_t state = ncclInProgress;
+  Status status = OkStatus();
+  while (status.ok() && state == ncclInProgress) {
+    status = XLA_CUDA_STATUS(ncclCommGetAsyncError(comm, &state));
+    if (status.ok() && state == ncclInProgress) {
+      if (absl::Now() > deadline) {
+        status = absl::DeadlineExceededError(
+            "Timed out waiting for the peer of a cross-host transfer.");
+      } else {
+        absl::SleepFor(absl::Milliseconds(1));
+      }
+    } else if (status.ok()) {
+      status = XLA_CUDA_STATUS(state);
+    }
+  }
+  if (!status.ok()) XLA_CUDA_WARN_IF_ERROR(ncclCommAbort(comm));
+  return status;
+}
+#endif  // XLA_NCCL_NON_BLOCKING
+
+}  // namespace
+
+StatusOr<std::string> CreateNcclTransferId() {
+  ncclUniqueId id;
+  XLA_CUDA_RETURN_IF_ERROR(ncclGetUniqueId(&id));
+  return std::string(id.internal, NCCL_UNIQUE_ID_BYTES);
+}
+
+StatusOr<std::unique_ptr<NcclTransferComm>> NcclTransferComm::Create(
+    se::StreamExecutor* executor, absl::string_view id, int rank,
+    absl::Duration timeout) {
+  if (id.size() != NCCL_UNIQUE_ID_BYTES) {
+    return InvalidArgument(
+        "Cross-host transfer descriptor has %d bytes, expected a NCCL unique "
+        "id of %d bytes.",
+        id.size(), NCCL_UNIQUE_ID_BYTES);
+  }
+  ncclUniqueId unique_id;
+  std::memcpy(unique_id.internal, id.data(), NCCL_UNIQUE_ID_BYTES);
+
+  se::gpu::ScopedActivateExecutorContext activation(executor);
+  ncclComm_t comm = nullptr;
+#if XLA_NCCL_NON_BLOCKING
+  ncclConfig_t config = NCCL_CONFIG_INITIALIZER;
+  config.blocking = 0;
+  ncclResult_t result = ncclCommInitRankConfig(&comm, /*nranks=*/2, unique_id,
+                                               rank, &config);
+  if (result != ncclInProgress) XLA_CUDA_RETURN_IF_ERROR(result);
+  TF_RETURN_IF_ERROR(WaitForComm(comm, absl::Now() + timeout));
+#else   // XLA_NCCL_NON_BLOCKING
+  XLA_CUDA_RETURN_IF_ERROR(
+      ncclCommInitRank(&comm, /*nranks=*/2, unique_id, rank));
+#endif  // XLA_NCCL_NON_BLOCKING
+  return absl::WrapUnique(new NcclTransferComm(executor, comm, timeout));
+}
+
+NcclTransferComm::~NcclTransferComm() {
+  // The communicator was aborted if one of its operations failed.
+  if (comm_ == nullptr) return;
+  se::gpu::ScopedActivateExecutorContext activation(executor_);
+  XLA_CUDA_WARN_IF_ERROR(ncclCommDestroy(comm_));
+}
+
+Status NcclTransferComm::Send(se::Stream* stream,
+                              se::DeviceMemoryBase buffer) {
+  if (comm_ == nullptr) {
+    return FailedPrecondition("Cross-host transfer was aborted.");
+  }
+  se::gpu::ScopedActivateExecutorContext activation(executor_);
+  ncclResult_t result =
+      ncclSend(buffer.opaque(), buffer.size(), ncclUint8, kReceiverRank,
+               comm_, se::gpu::AsGpuStreamValue(stream));
+#if XLA_NCCL_NON_BLOCKING
+  if (result == ncclInProgress) {
+    Status status = WaitForComm(comm_, absl::Now() + timeout_);
+    if (!status.ok()) comm_ = nullptr;
+    return status;
+  }
+#endif  // XLA_NCCL_NON_BLOCKING
+  XLA_CUDA_RETURN_IF_ERROR(result);
+  return OkStatus();
+}
+
+Status NcclTransferComm::Recv(se::Stream* stream,
+                              se::DeviceMemoryBase buffer) {
+  if (comm_ == nullptr) {
+    return FailedPrecondition("Cross-host transfer was aborted.");
+  }
+  se::gpu::ScopedActivateExecutorContext activation(executor_);
+  ncclResult_t result =
+      ncclRecv(buffer.opaque(), buffer.size(), ncclUint8, kSenderRank, comm_,
+               se::gpu::AsGpuStreamValue(stream));
+#if XLA_NCCL_NON_BLOCKING
+  if (result == ncclInProgress) {
+    Status status = WaitForComm(comm_, absl::Now() + timeout_);
+    if (!status.ok()) comm_ = nullptr;
+    return status;
+  }
+#endif  // XLA_NCCL_NON_BLOCKING
+  XLA_CUDA_RETURN_IF_ERROR(result);
+  return OkStatus();
+}
+
+#undef XLA_NCCL_NON_BLOCKING
+
+#else  // XLA_ENABLE_XCCL
+
+StatusOr<std::string> CreateNcclTransferId() {
+  return FailedPrecondition("NCCL support was not built into XLA binary.");
+}
+
+StatusOr<std::unique_ptr<NcclTransferComm>> NcclTransferComm::Create(
+    se::StreamExecutor* executor, absl::string_view id, int rank,
+    absl::Duration timeout) {
+  return FailedPrecondition("NCCL support was not built into XLA binary.");
+}
+
+NcclTransferComm::~NcclTransferComm() = default;
+
+Status NcclTransferComm::Send(se::Stream* stream,
+                              se::DeviceMemoryBase buffer) {
+  return FailedPrecondition("NCCL support was not built into XLA binary.");
+}
+
+Status NcclTransferComm::Recv(se::Stream* stream,
+                              se::DeviceMemoryBase buffer) {
+  return FailedPrecondition("NCCL support was not built into XLA binary.");
+}
+
+#endif  // XLA_ENABLE_XCCL
+
+}  // namespace xla
@@ -0,0 +1,99 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_GPU_NCCL_CROSS_HOST_TRANSFER_H_
+#define XLA_PJRT_GPU_NCCL_CROSS_HOST_TRANSFER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+#include "xla/stream_executor/device_memory.h"
+#include "xla/stream_executor/stream.h"
+#include "xla/stream_executor/stream_executor.h"
+
+struct ncclComm;
+
+namespace xla {
+
+// Point-to-point transfers between GPUs on different hosts, used to implement
+// cross-host sends and receives of the GPU PjRt client. Transfers go through
+// NCCL, which copies directly between device memories over GPUDirect RDMA when
+// the network supports it, and only falls back to staging through host memory
+// otherwise.
+//
+// A transfer is identified by a NCCL unique id, created by the receiver and
+// sent to the sender within the serialized cross-host receive descriptors. Both
+// sides then join a two-rank communicator created from that id: the sender as
+// rank 0 and the receiver as rank 1. All the buffers of one cross-host receive
+// share one transfer, and are sent and received over its communicator in order.
+
+// Returns a new serialized NCCL unique id, identifying one transfer.
+StatusOr<std::string> CreateNcclTransferId();
+
+// The descriptor of the `index`-th of the `count` buffers of the transfer
+// identified by `id`.
+struct NcclTransferDescriptor {
+  std::string id;
+  int64_t index = 0;
+  int64_t count = 1;
+
+  std::string Serialize() const;
+  static StatusOr<NcclTransferDescriptor> Parse(absl::string_view serialized);
+};
+
+// The communicator of one side of a transfer.
+class NcclTransferComm {
+ public:
+  static constexpr int kSenderRank = 0;
+  static constexpr int kReceiverRank = 1;
+
+  // Joins the transfer identified by `id` on the device of `executor`. Blocks
+  // until the peer joins too, or fails with a DeadlineExceeded error after
+  // `timeout`. The timeout is only enforced with NCCL 2.14 or later, which
+  // supports non-blocking communicators.
+  static StatusOr<std::unique_ptr<NcclTransferComm>> Create(
+      se::StreamExecutor* executor, absl::string_view id, int rank,
+      absl::Duration timeout);
+
+  ~NcclTransferComm();
+
+  // Enqueues the send of `buffer` to the receiver onto `stream`.
+  Status Send(se::Stream* stream, se::DeviceMemoryBase buffer);
+
+  // Enqueues the receive of `buffer` from the sender onto `stream`. The sender
+  // must send a buffer of the same size.
+  Status Recv(se::Stream* stream, se::DeviceMemoryBase buffer);
+
+ private:
+  NcclTransferComm(se::StreamExecutor* executor, ncclComm* comm,
+                   absl::Duration timeout)
+      : executor_(executor), comm_(comm), timeout_(timeout) {}
+
+  se::StreamExecutor* executor_;
+  ncclComm* comm_;
+  absl::Duration timeout_;
+
+  NcclTransferComm(const NcclTransferComm&) = delete;
+  void operator=(const NcclTransferComm&) = delete;
+};
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_GPU_NCCL_CROSS_HOST_TRANSFER_H_
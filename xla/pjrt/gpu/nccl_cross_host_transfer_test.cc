@@ -0,0 +1,51 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/gpu/nccl_cross_host_transfer.h"
+
+#include <string>
+
+#include "xla/test.h"
+#include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+using ::tsl::testing::StatusIs;
+
+TEST(NcclTransferDescriptorTest, RoundTrips) {
+  // Ids are binary, and may contain the separator.
+  NcclTransferDescriptor descriptor{std::string("a,b\0c", 5), 2, 3};
+  TF_ASSERT_OK_AND_ASSIGN(
+      NcclTransferDescriptor parsed,
+      NcclTransferDescriptor::Parse(descriptor.Serialize()));
+  EXPECT_EQ(parsed.id, descriptor.id);
+  EXPECT_EQ(parsed.index, 2);
+  EXPECT_EQ(parsed.count, 3);
+}
+
+TEST(NcclTransferDescriptorTest, RejectsMalformedDescriptors) {
+  for (const char* serialized :
+       {"", "id", "0,id", "x,1,id", "0,y,id", "0,1,", "1,1,id", "-1,1,id",
+        "0,0,id"}) {
+    EXPECT_THAT(NcclTransferDescriptor::Parse(serialized),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << serialized;
+  }
+}
+
+}  // namespace
+}  // namespace xla
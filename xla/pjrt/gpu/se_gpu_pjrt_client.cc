@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "xla/pjrt/gpu/se_gpu_pjrt_client.h"
 
+#include <cstdint>
 #include <fstream>
+#include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <optional>
@@ -34,13 +37,16 @@ limitations under the License.
 #include "absl/strings/ascii.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "absl/time/time.h"
 #include "xla/client/local_client.h"
 #include "xla/client/xla_computation.h"
+#include "xla/debug_options_flags.h"
 #include "xla/pjrt/distributed/topology_util.h"
+#include "xla/pjrt/gpu/nccl_cross_host_transfer.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_compiler.h"
 #include "xla/pjrt/pjrt_executable.h"
@@ -65,6 +71,7 @@ limitations under the License.
 #include "xla/pjrt/gpu/nccl_id_store.h"
 #include "xla/pjrt/metrics.h"
 #include "xla/pjrt/stream_executor_executable.pb.h"
+#include "xla/service/gpu/autotuner_util.h"
 #include "xla/service/gpu/gpu_compiler.h"
 #include "xla/xla.pb.h"
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -404,6 +411,49 @@ class AsyncHostToDeviceTransferManager
   }
 };
 
+StreamExecutorGpuMemorySpace::StreamExecutorGpuMemorySpace(
+    int id, PjRtDevice* device, absl::string_view kind)
+    : id_(id),
+      device_(device),
+      kind_(kind),
+      debug_string_(absl::StrFormat(
+          "StreamExecutorGpuMemorySpace(id=%i, kind=%s, device=%s)", id,
+          kind, device->DebugString())),
+      to_string_(absl::StrFormat("%s(id=%i, device_id=%i)", kind, id,
+                                 device->id())) {}
+
+StreamExecutorGpuClient::StreamExecutorGpuClient(
+    std::string platform_name, LocalClient* client,
+    std::vector<std::unique_ptr<PjRtStreamExecutorDevice>> devices,
+    int process_index, std::unique_ptr<se::DeviceMemoryAllocator> allocator,
+    std::unique_ptr<tsl::Allocator> host_memory_allocator,
+    bool should_stage_host_to_device_transfers,
+    std::unique_ptr<gpu::GpuExecutableRunOptions> gpu_run_options)
+    : xla::PjRtStreamExecutorClient(
+          platform_name, client, std::move(devices), process_index,
+          std::move(allocator), std::move(host_memory_allocator),
+          should_stage_host_to_device_transfers, std::move(gpu_run_options)),
+      topology_(xla::StreamExecutorGpuTopologyDescription::Create(
+          tsl::Fingerprint64(platform_name), platform_name,
+          devices_.back()->device_kind(), devices_)) {
+  const absl::string_view kinds[] = {
+      StreamExecutorGpuMemorySpace::kDeviceKind,
+      StreamExecutorGpuMemorySpace::kPinnedHostKind};
+  for (PjRtDevice* device : addressable_devices_) {
+    auto* gpu_device = tensorflow::down_cast<StreamExecutorGpuDevice*>(device);
+    for (int i = 0; i < std::size(kinds); ++i) {
+      const absl::string_view kind = kinds[i];
+      // IDs are unique across hosts, as device IDs are.
+      const int id = device->id() * std::size(kinds) + i;
+      auto memory_space =
+          std::make_unique<StreamExecutorGpuMemorySpace>(id, device, kind);
+      gpu_device->AttachMemorySpace(memory_space.get());
+      memory_spaces_.push_back(memory_space.get());
+      owned_memory_spaces_.push_back(std::move(memory_space));
+    }
+  }
+}
+
 absl::string_view StreamExecutorGpuClient::platform_version() const {
 #define STRINGIFY2(X) #X
 #define STRINGIFY(X) STRINGIFY2(X)
@@ -530,9 +580,422 @@ PjRtFuture<absl::Status> StreamExecutorGpuClient::CopyRawSubBufferToHost(
       });
 }
 
+absl::Span<PjRtMemorySpace* const> StreamExecutorGpuClient::memory_spaces()
+    const {
+  return memory_spaces_;
+}
+
+StatusOr<std::unique_ptr<PjRtBuffer>>
+StreamExecutorGpuClient::CopyBufferToMemorySpace(
+    PjRtBuffer* pjrt_buffer, PjRtMemorySpace* dst_memory_space) {
+  auto* buffer = tensorflow::down_cast<PjRtStreamExecutorBuffer*>(pjrt_buffer);
+  PjRtStreamExecutorDevice* device = buffer->device();
+  if (dst_memory_space->client() != this ||
+      dst_memory_space->devices().size() != 1 ||
+      dst_memory_space->devices().front() != device) {
+    return InvalidArgument(
+        "CopyToMemorySpace only copies between memory spaces of the device of "
+        "the buffer, use CopyToDevice to copy to %s.",
+        dst_memory_space->DebugString());
+  }
+  auto* dst = tensorflow::down_cast<StreamExecutorGpuMemorySpace*>(
+      dst_memory_space);
+  const bool src_is_host =
+      buffer->memory_space() != nullptr &&
+      tensorflow::down_cast<StreamExecutorGpuMemorySpace*>(
+          buffer->memory_space())
+          ->is_pinned_host();
+  if (src_is_host == dst->is_pinned_host()) {
+    if (!src_is_host) return buffer->CopyToDevice(device);
+    return Unimplemented("Copies within pinned host memory not implemented.");
+  }
+
+  LocalDeviceState* local_device = device->local_device_state();
+  se::StreamExecutor* executor = local_device->executor();
+  PjRtStreamExecutorBuffer::ScopedHold src_hold(
+      buffer->GetBufferWithUsageHold());
+  TF_RETURN_IF_ERROR(src_hold.status());
+  if (src_hold->device_memory().size() != 1) {
+    return Unimplemented("Copies of tuples to memory spaces not implemented.");
+  }
+  se::DeviceMemoryBase src_memory = src_hold->device_memory()[0];
+  const uint64_t size = src_memory.size();
+
+  // Pinned host memory is freed by the on-delete callback of the tracked
+  // buffer, device memory by its allocator.
+  se::DeviceMemoryAllocator* dst_allocator = nullptr;
+  std::function<void()> on_delete_callback;
+  se::DeviceMemoryBase dst_memory;
+  se::Stream* stream;
+  if (dst->is_pinned_host()) {
+    void* host_memory = executor->HostMemoryAllocate(size);
+    if (host_memory == nullptr && size > 0) {
+      return ResourceExhausted("Failed to allocate %d bytes of pinned host "
+                               "memory.",
+                               size);
+    }
+    dst_memory = se::DeviceMemoryBase(host_memory, size);
+    on_delete_callback = [executor, host_memory]() {
+      if (host_memory != nullptr) executor->HostMemoryDeallocate(host_memory);
+    };
+    stream = local_device->GetDeviceToHostStream();
+  } else {
+    TF_ASSIGN_OR_RETURN(
+        se::OwningDeviceMemory device_memory,
+        allocator()->Allocate(local_device->device_ordinal(), size));
+    dst_memory = device_memory.Release();
+    dst_allocator = allocator();
+    stream = local_device->host_to_device_stream();
+  }
+  auto definition_event =
+      std::make_shared<BufferSequencingEvent>(this->thread_pool());
+  auto dst_buffer = std::make_shared<TrackedDeviceBuffer>(
+      dst_allocator, local_device->device_ordinal(),
+      absl::MakeConstSpan(&dst_memory, 1),
+      absl::MakeConstSpan(&definition_event, 1),
+      std::move(on_delete_callback));
+
+  WaitForBufferDefinitionEventsOnStream(*src_hold, stream);
+  if (size > 0) {
+    if (dst->is_pinned_host()) {
+      stream->ThenMemcpy(dst_memory.opaque(), src_memory, size);
+    } else {
+      stream->ThenMemcpy(&dst_memory, src_memory.opaque(), size);
+    }
+  }
+  TF_ASSIGN_OR_RETURN(
+      EventPool::Handle event,
+      local_device->event_pool().ThenAllocateAndRecordEvent(stream));
+  definition_event->SetSequencingEvent(std::move(event), stream);
+  // Keep the source alive until the copy is complete.
+  local_device->ThenRelease(stream, src_hold.buffer());
+  src_hold.ConvertUsageHold(stream, definition_event, /*reference_held=*/true);
+
+  return std::unique_ptr<PjRtBuffer>(std::make_unique<PjRtStreamExecutorBuffer>(
+      buffer->on_device_shape(), std::move(dst_buffer), this, device,
+      dst->is_pinned_host() ? dst : nullptr));
+}
+
+namespace {
+
+// How long cross-host transfers wait for their peers.
+constexpr absl::Duration kCrossHostTransferTimeout = absl::Minutes(5);
+
+// The number of cross-host transfers that can wait for their peers at a time.
+constexpr int kNumCrossHostTransferThreads = 8;
+
+}  // namespace
+
+struct StreamExecutorGpuClient::OutgoingTransfer {
+  struct Send {
+    se::DeviceMemoryBase source;
+    std::shared_ptr<BufferSequencingEvent> usage_event;
+    PjRtBuffer::RemoteSendCallback on_done;
+  };
+
+  LocalDeviceState* local_device;
+  int64_t count;
+  // Borrowed, see EnqueueCrossHostReceive.
+  se::Stream* stream;
+  // Only accessed by the thread enqueuing the sends.
+  std::shared_ptr<NcclTransferComm> comm;
+
+  // The fields below are guarded by `outgoing_transfers_mu_`.
+  // The error of the first failed send, which fails all the later ones.
+  Status status;
+  bool enqueuing = false;
+  int64_t next_index = 0;
+  // The number of sends enqueued or failed.
+  int64_t num_done = 0;
+  absl::flat_hash_map<int64_t, Send> pending;
+};
+
+tsl::thread::ThreadPool*
+StreamExecutorGpuClient::cross_host_transfer_thread_pool() const {
+  // The transfers don't use the client thread pool, as they block their thread
+  // until the peer joins.
+  absl::call_once(cross_host_transfer_thread_pool_once_, [this] {
+    cross_host_transfer_thread_pool_ =
+        std::make_unique<tsl::thread::ThreadPool>(
+            tsl::Env::Default(), "gpu_cross_host_transfers",
+            kNumCrossHostTransferThreads);
+  });
+  return cross_host_transfer_thread_pool_.get();
+}
+
+Status StreamExecutorGpuClient::EnqueueCrossHostReceive(
+    absl::Span<const std::unique_ptr<PjRtBuffer>> buffers,
+    std::shared_ptr<BufferSequencingEvent> definition_event,
+    PjRtCrossHostRecvNotifier notifier,
+    std::optional<std::vector<GatherDetails>> gather_details) const {
+  if (gather_details.has_value()) {
+    return Unimplemented("Cross host receives with gather not implemented.");
+  }
+  auto* device = tensorflow::down_cast<PjRtStreamExecutorDevice*>(
+      buffers.front()->device());
+  LocalDeviceState* local_device = device->local_device_state();
+
+  PjRtCrossHostRecvState state;
+  TF_ASSIGN_OR_RETURN(std::string id, CreateNcclTransferId());
+  std::vector<PjRtStreamExecutorBuffer::ScopedHold> holds;
+  std::vector<se::DeviceMemoryBase> destinations;
+  const int64_t count = buffers.size();
+  for (int64_t i = 0; i < count; ++i) {
+    NcclTransferDescriptor descriptor{id, i, count};
+    state.descriptors.emplace_back();
+    state.descriptors.back().serialized_descriptors.push_back(
+        descriptor.Serialize());
+
+    auto* buffer =
+        tensorflow::down_cast<PjRtStreamExecutorBuffer*>(buffers[i].get());
+    holds.push_back(buffer->GetBufferWithUsageHold());
+    TF_RETURN_IF_ERROR(holds.back().status());
+    if (holds.back()->device_memory().size() != 1) {
+      return Unimplemented("Cross host receives of tuples not implemented.");
+    }
+    destinations.push_back(holds.back()->device_memory()[0]);
+  }
+  state.cancel_notifier = [](absl::string_view serialized_descriptor,
+                             Status reason,
+                             std::function<void(Status)> on_canceled) {
+    on_canceled(Unimplemented("Canceling cross host receives not supported."));
+  };
+
+  // Always borrow a stream, as the receives block the stream until the data
+  // arrives, which may depend on computations of other hosts that are waiting
+  // for transfers on the usual streams.
+  se::Stream* stream = local_device->BorrowStreamFromPool().release();
+  for (PjRtStreamExecutorBuffer::ScopedHold& hold : holds) {
+    // The definition event is recorded once all the receives are enqueued.
+    hold.ConvertUsageHold(stream, definition_event, /*reference_held=*/false);
+  }
+  notifier(std::move(state));
+
+  // The receives of all the buffers share one communicator, and are enqueued
+  // in order, as the sender sends them.
+  cross_host_transfer_thread_pool()->Schedule(
+      [local_device, stream, id = std::move(id),
+       destinations = std::move(destinations),
+       definition_event = std::move(definition_event)]() {
+        StatusOr<std::unique_ptr<NcclTransferComm>> comm =
+            NcclTransferComm::Create(local_device->executor(), id,
+                                     NcclTransferComm::kReceiverRank,
+                                     kCrossHostTransferTimeout);
+        Status status = comm.status();
+        for (size_t i = 0; status.ok() && i < destinations.size(); ++i) {
+          status = (*comm)->Recv(stream, destinations[i]);
+        }
+        if (status.ok()) {
+          StatusOr<EventPool::Handle> event =
+              local_device->event_pool().ThenAllocateAndRecordEvent(stream);
+          status = event.status();
+          if (status.ok()) {
+            definition_event->SetSequencingEvent(*std::move(event), stream);
+          }
+        }
+        if (!status.ok()) {
+          LOG(ERROR) << "Cross host receive failed: " << status;
+          definition_event->SetDefinedStatus(status);
+        }
+        std::shared_ptr<NcclTransferComm> shared_comm;
+        if (comm.ok()) shared_comm = *std::move(comm);
+        local_device->ThenExecuteCallback(
+            stream, [local_device, stream, shared_comm]() {
+              local_device->ReturnStreamToPool(
+                  std::unique_ptr<se::Stream>(stream));
+            });
+      });
+  return OkStatus();
+}
+
+void StreamExecutorGpuClient::CopyToRemoteDevice(
+    PjRtBuffer* pjrt_buffer, absl::string_view serialized_descriptor,
+    PjRtBuffer::RemoteSendCallback on_done) const {
+  auto* buffer = tensorflow::down_cast<PjRtStreamExecutorBuffer*>(pjrt_buffer);
+  LocalDeviceState* local_device = buffer->device()->local_device_state();
+
+  StatusOr<NcclTransferDescriptor> descriptor =
+      NcclTransferDescriptor::Parse(serialized_descriptor);
+  if (!descriptor.ok()) {
+    on_done(descriptor.status(), /*sends_were_enqueued=*/false);
+    return;
+  }
+  PjRtStreamExecutorBuffer::ScopedHold hold(buffer->GetBufferWithUsageHold());
+  if (!hold.ok()) {
+    on_done(hold.status(), /*sends_were_enqueued=*/false);
+    return;
+  }
+  if (hold->device_memory().size() != 1) {
+    on_done(Unimplemented("Cross host sends of tuples not implemented."),
+            /*sends_were_enqueued=*/false);
+    return;
+  }
+
+  // The sends of all the buffers of a receive share one transfer, which keeps
+  // the pending sends until the ones before them are enqueued.
+  Status status;
+  bool schedule = false;
+  {
+    absl::MutexLock lock(&outgoing_transfers_mu_);
+    std::shared_ptr<OutgoingTransfer>& transfer =
+        outgoing_transfers_[descriptor->id];
+    if (transfer == nullptr) {
+      transfer = std::make_shared<OutgoingTransfer>();
+      transfer->local_device = local_device;
+      transfer->count = descriptor->count;
+      // See EnqueueCrossHostReceive for why a stream is borrowed.
+      transfer->stream = local_device->BorrowStreamFromPool().release();
+    }
+    if (transfer->local_device != local_device ||
+        transfer->count != descriptor->count ||
+        descriptor->index < transfer->next_index ||
+        transfer->pending.contains(descriptor->index)) {
+      status = InvalidArgument(
+          "The buffers of a cross host receive must each be sent once, from "
+          "the same device.");
+    } else if (!transfer->status.ok()) {
+      // Don't enqueue sends that the receiver will never receive.
+      status = transfer->status;
+      if (++transfer->num_done == transfer->count) {
+        std::shared_ptr<OutgoingTransfer> finished = std::move(transfer);
+        outgoing_transfers_.erase(descriptor->id);
+        local_device->ThenExecuteCallback(
+            finished->stream, [local_device, finished]() {
+              local_device->ReturnStreamToPool(
+                  std::unique_ptr<se::Stream>(finished->stream));
+            });
+      }
+    } else {
+      se::DeviceMemoryBase source = hold->device_memory()[0];
+      WaitForBufferDefinitionEventsOnStream(*hold, transfer->stream);
+      auto usage_event = std::make_shared<BufferSequencingEvent>(
+          const_cast<tsl::thread::ThreadPool*>(&thread_pool_));
+      // This usage hold will prevent the buffer from being deleted before the
+      // send is complete.
+      hold.ConvertUsageHold(transfer->stream, usage_event,
+                            /*reference_held=*/false);
+      transfer->pending[descriptor->index] = OutgoingTransfer::Send{
+          source, std::move(usage_event), std::move(on_done)};
+      schedule = !transfer->enqueuing;
+      transfer->enqueuing = true;
+    }
+  }
+  if (!status.ok()) {
+    on_done(status, /*sends_were_enqueued=*/false);
+  } else if (schedule) {
+    cross_host_transfer_thread_pool()->Schedule(
+        [this, id = std::move(descriptor->id)]() {
+          EnqueueOutgoingSends(id);
+        });
+  }
+}
+
+void StreamExecutorGpuClient::EnqueueOutgoingSends(
+    const std::string& id) const {
+  std::shared_ptr<OutgoingTransfer> transfer;
+  {
+    absl::MutexLock lock(&outgoing_transfers_mu_);
+    transfer = outgoing_transfers_.at(id);
+  }
+  LocalDeviceState* local_device = transfer->local_device;
+  se::Stream* stream = transfer->stream;
+  if (transfer->comm == nullptr) {
+    StatusOr<std::unique_ptr<NcclTransferComm>> comm = NcclTransferComm::Create(
+        local_device->executor(), id, NcclTransferComm::kSenderRank,
+        kCrossHostTransferTimeout);
+    if (comm.ok()) {
+      transfer->comm = *std::move(comm);
+    } else {
+      absl::MutexLock lock(&outgoing_transfers_mu_);
+      transfer->status = comm.status();
+    }
+  }
+
+  while (true) {
+    // Either the next send in order, or all the pending sends if one failed.
+    std::vector<OutgoingTransfer::Send> sends;
+    Status status;
+    bool finished;
+    {
+      absl::MutexLock lock(&outgoing_transfers_mu_);
+      status = transfer->status;
+      if (!status.ok()) {
+        for (auto& [index, send] : transfer->pending) {
+          sends.push_back(std::move(send));
+        }
+        transfer->pending.clear();
+      } else if (auto it = transfer->pending.find(transfer->next_index);
+                 it != transfer->pending.end()) {
+        sends.push_back(std::move(it->second));
+        transfer->pending.erase(it);
+        ++transfer->next_index;
+      }
+      transfer->num_done += sends.size();
+      // Once a send failed, CopyToRemoteDevice may finish the transfer instead.
+      finished = !sends.empty() && transfer->num_done == transfer->count;
+      if (finished) {
+        outgoing_transfers_.erase(id);
+      } else if (sends.empty()) {
+        transfer->enqueuing = false;
+        return;
+      }
+    }
+
+    for (OutgoingTransfer::Send& send : sends) {
+      if (status.ok()) status = transfer->comm->Send(stream, send.source);
+      // The usage event is recorded even if the send fails, so that the
+      // buffer can be deleted.
+      StatusOr<EventPool::Handle> event =
+          local_device->event_pool().ThenAllocateAndRecordEvent(stream);
+      CHECK_OK(event.status()) << "Failed to record cross host send event";
+      send.usage_event->SetSequencingEvent(*std::move(event), stream);
+      if (status.ok()) {
+        local_device->ThenExecuteCallback(
+            stream, [on_done = std::move(send.on_done)]() {
+              on_done(OkStatus(), /*sends_were_enqueued=*/true);
+            });
+      } else {
+        LOG(ERROR) << "Cross host send failed: " << status;
+        send.on_done(status, /*sends_were_enqueued=*/false);
+      }
+    }
+    if (!status.ok()) {
+      absl::MutexLock lock(&outgoing_transfers_mu_);
+      transfer->status = status;
+    }
+
+    if (finished) {
+      local_device->ThenExecuteCallback(
+          stream, [local_device, stream, comm = std::move(transfer->comm)]() {
+            local_device->ReturnStreamToPool(
+                std::unique_ptr<se::Stream>(stream));
+          });
+      return;
+    }
+  }
+}
+
 StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
 StreamExecutorGpuClient::Compile(const XlaComputation& computation,
                                  CompileOptions options) {
+  if (remote_compile_callback_) {
+    if (!options.target_config.has_value()) {
+      se::StreamExecutor* executor =
+          client()->backend().default_stream_executor();
+      options.target_config = Compiler::TargetConfig(executor);
+      // Lets the worker find the autotuning results measured on these GPUs,
+      // which are keyed by the model of the device.
+      options.target_config->device_description_str =
+          executor->GetDeviceDescription().model_str();
+    }
+    RemoteCompileRequestProto request;
+    *request.mutable_computation() = computation.proto();
+    TF_ASSIGN_OR_RETURN(*request.mutable_compile_options(), options.ToProto());
+    TF_ASSIGN_OR_RETURN(std::string serialized,
+                        remote_compile_callback_(request));
+    return LoadSerialized(serialized, std::nullopt, LoadOptions());
+  }
+
   auto executable = PjRtStreamExecutorClient::Compile(computation, options);
 
 #if defined(GOOGLE_CUDA) || defined(TENSORFLOW_USE_ROCM)
@@ -694,9 +1157,10 @@ StatusOr<std::unique_ptr<se::MultiDeviceAdapter>> CreateCudaAsyncAllocator(
 
 #endif  // defined(GOOGLE_CUDA) && CUDA_VERSION >= 11020
 
-// Builds a LocalDeviceState for each GPU present.
+// Builds a LocalDeviceState for each GPU present, each admitting executions
+// with at most `max_inflight_bytes` argument bytes in flight.
 StatusOr<std::map<int, std::unique_ptr<LocalDeviceState>>>
-BuildLocalDeviceStates(LocalClient* xla_client) {
+BuildLocalDeviceStates(LocalClient* xla_client, int64_t max_inflight_bytes) {
   std::map<int, std::unique_ptr<LocalDeviceState>> addressable_devices;
   for (se::StreamExecutor* executor :
        xla_client->backend().stream_executors()) {
@@ -705,7 +1169,9 @@ BuildLocalDeviceStates(LocalClient* xla_client) {
         std::make_unique<LocalDeviceState>(
             executor, xla_client, LocalDeviceState::kComputeSynchronized,
             /*max_inflight_computations=*/32,
-            /*allow_event_reuse=*/true, /*use_callback_stream=*/true));
+            /*allow_event_reuse=*/true, /*use_callback_stream=*/true,
+            /*device_ordinal=*/-1, /*stream_options=*/std::nullopt,
+            max_inflight_bytes));
   }
   return std::move(addressable_devices);
 }
@@ -726,6 +1192,12 @@ GetStreamExecutorGpuDeviceAllocator(
       if (allocator_or.ok()) {
         LOG(INFO) << "Using CUDA async allocator.";
         allocator = std::move(allocator_or.value());
+        // The allocator frees memory in the order of the compute stream, so
+        // buffers last used on other streams can be released as soon as the
+        // compute stream waits for those uses.
+        for (const auto& ordinal_and_device : addressable_devices) {
+          ordinal_and_device.second->set_order_frees_on_compute_stream(true);
+        }
         break;
       }
       LOG(ERROR) << "Failed to initialize CUDA async allocator: "
@@ -955,6 +1427,23 @@ absl::string_view StreamExecutorGpuDevice::device_vendor() const {
   return device_vendor_;
 }
 
+absl::Span<PjRtMemorySpace* const> StreamExecutorGpuDevice::memory_spaces()
+    const {
+  return memory_spaces_;
+}
+
+StatusOr<PjRtMemorySpace*> StreamExecutorGpuDevice::default_memory_space()
+    const {
+  if (memory_spaces_.empty()) {
+    return Unimplemented("No memory spaces attached to %s.", DebugString());
+  }
+  return memory_spaces_.front();
+}
+
+void StreamExecutorGpuDevice::AttachMemorySpace(PjRtMemorySpace* memory_space) {
+  memory_spaces_.push_back(memory_space);
+}
+
 absl::StatusOr<tsl::AllocatorStats> StreamExecutorGpuDevice::GetAllocatorStats()
     const {
   if (!IsAddressable()) {
@@ -980,11 +1469,13 @@ StatusOr<std::unique_ptr<PjRtClient>> GetStreamExecutorGpuClient(
     std::optional<std::string> platform_name,
     bool should_stage_host_to_device_transfers,
     PjRtClient::KeyValueGetCallback kv_get,
-    PjRtClient::KeyValuePutCallback kv_put, bool enable_mock_nccl) {
+    PjRtClient::KeyValuePutCallback kv_put, bool enable_mock_nccl,
+    int64_t max_inflight_bytes) {
   TF_ASSIGN_OR_RETURN(LocalClient * xla_client,
                       GetGpuXlaClient(platform_name, allowed_devices));
   std::map<int, std::unique_ptr<LocalDeviceState>> local_device_states;
-  TF_ASSIGN_OR_RETURN(local_device_states, BuildLocalDeviceStates(xla_client));
+  TF_ASSIGN_OR_RETURN(local_device_states,
+                      BuildLocalDeviceStates(xla_client, max_inflight_bytes));
   EnablePeerAccess(xla_client->backend().stream_executors());
   TF_ASSIGN_OR_RETURN(
       auto allocator,
@@ -1044,6 +1535,27 @@ StatusOr<std::unique_ptr<PjRtClient>> GetStreamExecutorGpuClient(
     TF_RETURN_IF_ERROR(BuildDistributedDevices(
         std::move(local_device_states), node_id, num_nodes, &devices,
         gpu_run_options.get(), kv_get, kv_put));
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+    if (!enable_mock_nccl &&
+        GetDebugOptionsFromFlags()
+            .xla_gpu_share_autotune_results_between_hosts()) {
+      // Autotune results that haven't been published yet are misses, so look
+      // them up without waiting.
+      auto get = [kv_get](const std::string& key)
+          -> StatusOr<std::optional<std::string>> {
+        StatusOr<std::string> value = kv_get(key, absl::ZeroDuration());
+        if (absl::IsNotFound(value.status()) ||
+            absl::IsDeadlineExceeded(value.status())) {
+          return std::nullopt;
+        }
+        TF_RETURN_IF_ERROR(value.status());
+        return *std::move(value);
+      };
+      gpu::AutotunerUtil::SetResultStore(
+          std::make_shared<gpu::KeyValueAutotuneResultStore>(std::move(get),
+                                                             kv_put));
+    }
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   } else {
     devices = BuildLocalDevices(std::move(local_device_states), node_id);
   }
@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef XLA_PJRT_GPU_SE_GPU_PJRT_CLIENT_H_
 #define XLA_PJRT_GPU_SE_GPU_PJRT_CLIENT_H_
 
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <optional>
@@ -24,15 +27,24 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/base/call_once.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "xla/pjrt/distributed/client.h"
 #include "xla/pjrt/gpu/gpu_helpers.h"
 #include "xla/pjrt/gpu/gpu_topology.h"
+#include "xla/pjrt/gpu/remote_compile.pb.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_executable.h"
 #include "xla/pjrt/pjrt_stream_executor_client.h"
+#include "xla/pjrt/tracked_device_buffer.h"
 #include "xla/statusor.h"
 #include "tsl/platform/fingerprint.h"
+#include "tsl/platform/threadpool.h"
 
 namespace stream_executor {
 
@@ -135,6 +147,42 @@ class StreamExecutorGpuTopologyDescription : public PjRtTopologyDescription {
   absl::flat_hash_map<std::string, xla::PjRtDeviceAttribute> attributes_;
 };
 
+// A memory space of a GPU device: either the memory of the device, or
+// page-locked host memory mapped into the address space of the device. Copies
+// to and from pinned host memory are asynchronous DMAs, and kernels can read
+// and write it directly, which makes it the target of host offloading.
+class StreamExecutorGpuMemorySpace : public PjRtMemorySpace {
+ public:
+  static constexpr absl::string_view kDeviceKind = "device";
+  static constexpr absl::string_view kPinnedHostKind = "pinned_host";
+
+  StreamExecutorGpuMemorySpace(int id, PjRtDevice* device,
+                               absl::string_view kind);
+
+  PjRtClient* client() const override { return device_->client(); }
+
+  absl::Span<PjRtDevice* const> devices() const override {
+    return absl::Span<PjRtDevice* const>(&device_, 1);
+  }
+
+  int id() const override { return id_; }
+
+  absl::string_view memory_space_kind() const override { return kind_; }
+
+  absl::string_view DebugString() const override { return debug_string_; }
+
+  absl::string_view ToString() const override { return to_string_; }
+
+  bool is_pinned_host() const { return kind_ == kPinnedHostKind; }
+
+ private:
+  int id_;
+  PjRtDevice* device_;
+  absl::string_view kind_;
+  std::string debug_string_;
+  std::string to_string_;
+};
+
 class StreamExecutorGpuDevice : public PjRtStreamExecutorDevice {
  public:
   StreamExecutorGpuDevice(int id,
@@ -148,11 +196,25 @@ class StreamExecutorGpuDevice : public PjRtStreamExecutorDevice {
 
   absl::StatusOr<tsl::AllocatorStats> GetAllocatorStats() const override;
 
+  absl::Span<PjRtMemorySpace* const> memory_spaces() const override;
+
+  // The memory of the device, which is the first attached memory space.
+  StatusOr<PjRtMemorySpace*> default_memory_space() const override;
+
+  void AttachMemorySpace(PjRtMemorySpace* memory_space);
+
  private:
   std::string device_vendor_;
   int slice_index_;
+  std::vector<PjRtMemorySpace*> memory_spaces_;
 };
 
+// Sends `request` to a remote compile worker, which typically runs
+// HandleRemoteCompileRequest on a host without GPUs, and returns the serialized
+// executable compiled by the worker.
+using RemoteCompileCallback = std::function<absl::StatusOr<std::string>(
+    const RemoteCompileRequestProto& request)>;
+
 // A custom PjRtClient that overrides the device assignment method.
 class StreamExecutorGpuClient : public xla::PjRtStreamExecutorClient {
  public:
@@ -164,14 +226,7 @@ class StreamExecutorGpuClient : public xla::PjRtStreamExecutorClient {
       int process_index, std::unique_ptr<se::DeviceMemoryAllocator> allocator,
       std::unique_ptr<tsl::Allocator> host_memory_allocator,
       bool should_stage_host_to_device_transfers,
-      std::unique_ptr<gpu::GpuExecutableRunOptions> gpu_run_options)
-      : xla::PjRtStreamExecutorClient(
-            platform_name, client, std::move(devices), process_index,
-            std::move(allocator), std::move(host_memory_allocator),
-            should_stage_host_to_device_transfers, std::move(gpu_run_options)),
-        topology_(xla::StreamExecutorGpuTopologyDescription::Create(
-            tsl::Fingerprint64(platform_name), platform_name,
-            devices_.back()->device_kind(), devices_)) {}
+      std::unique_ptr<gpu::GpuExecutableRunOptions> gpu_run_options);
 
   xla::StatusOr<xla::DeviceAssignment> GetDefaultDeviceAssignment(
       int num_replicas, int num_partitions) const override;
@@ -186,6 +241,13 @@ class StreamExecutorGpuClient : public xla::PjRtStreamExecutorClient {
                                             int64_t offset,
                                             int64_t transfer_size) override;
 
+  absl::Span<PjRtMemorySpace* const> memory_spaces() const override;
+
+  // Copies between the device and pinned host memory spaces of the device of
+  // `buffer`, on the device-to-host or host-to-device stream.
+  StatusOr<std::unique_ptr<PjRtBuffer>> CopyBufferToMemorySpace(
+      PjRtBuffer* buffer, PjRtMemorySpace* dst_memory_space) override;
+
   StatusOr<const xla::PjRtTopologyDescription*> GetTopologyDescription()
       const override {
     return &topology_;
@@ -213,8 +275,60 @@ class StreamExecutorGpuClient : public xla::PjRtStreamExecutorClient {
   StatusOr<std::unique_ptr<PjRtLoadedExecutable>> Compile(
       const XlaComputation& computation, CompileOptions options) override;
 
+  // Offloads the compilations of this client to remote compile workers through
+  // `callback`, or compiles locally again if `callback` is null. The
+  // computations are compiled for the GPUs of this client, unless the compile
+  // options already have a target config, and the returned executables are
+  // then loaded by this client. Must not be called concurrently with Compile.
+  void SetRemoteCompileCallback(RemoteCompileCallback callback) {
+    remote_compile_callback_ = std::move(callback);
+  }
+
+ protected:
+  // Cross-host transfers go directly between device memories through NCCL,
+  // see nccl_cross_host_transfer.h. All the buffers of one receive share one
+  // transfer, so they must all be sent from the same device, and the
+  // descriptor of each buffer is its NcclTransferDescriptor. The waits for the
+  // peers run on a dedicated thread pool and time out. Gathers, scatters and
+  // cancellation are not supported.
+  Status EnqueueCrossHostReceive(
+      absl::Span<const std::unique_ptr<PjRtBuffer>> buffers,
+      std::shared_ptr<BufferSequencingEvent> definition_event,
+      PjRtCrossHostRecvNotifier notifier,
+      std::optional<std::vector<GatherDetails>> gather_details) const override;
+
+  void CopyToRemoteDevice(
+      PjRtBuffer* buffer, absl::string_view serialized_descriptor,
+      PjRtBuffer::RemoteSendCallback on_done) const override;
+
  private:
+  // The sends to one cross-host receive, see CopyToRemoteDevice.
+  struct OutgoingTransfer;
+
+  tsl::thread::ThreadPool* cross_host_transfer_thread_pool() const;
+
+  // Enqueues the sends of the transfer `id` that are next in order, joining
+  // its communicator first if needed. Runs on the cross-host transfer thread
+  // pool, and on at most one of its threads at a time per transfer.
+  void EnqueueOutgoingSends(const std::string& id) const;
+
   xla::StreamExecutorGpuTopologyDescription topology_;
+  std::vector<std::unique_ptr<StreamExecutorGpuMemorySpace>>
+      owned_memory_spaces_;
+  // Pointers to `owned_memory_spaces_`.
+  std::vector<PjRtMemorySpace*> memory_spaces_;
+  RemoteCompileCallback remote_compile_callback_;
+
+  mutable absl::Mutex outgoing_transfers_mu_;
+  // The transfers with sends that were not all enqueued yet, keyed by id.
+  mutable absl::flat_hash_map<std::string, std::shared_ptr<OutgoingTransfer>>
+      outgoing_transfers_ ABSL_GUARDED_BY(outgoing_transfers_mu_);
+
+  // Created on the first cross-host transfer. Declared last, so that the
+  // pending transfers finish before the rest of the client is destroyed.
+  mutable absl::once_flag cross_host_transfer_thread_pool_once_;
+  mutable std::unique_ptr<tsl::thread::ThreadPool>
+      cross_host_transfer_thread_pool_;
 };
 
 std::vector<std::unique_ptr<PjRtStreamExecutorDevice>> BuildLocalDevices(
@@ -224,6 +338,9 @@ std::vector<std::unique_ptr<PjRtStreamExecutorDevice>> BuildLocalDevices(
 // kv_get and kv_put are callbacks provided by the caller to access a key-value
 // store shared between nodes. kv_get and kv_put must be non-null if num_nodes
 // > 1.
+//
+// `max_inflight_bytes` bounds the total size of the arguments of the
+// executions enqueued on each device ahead of it.
 StatusOr<std::unique_ptr<PjRtClient>> GetStreamExecutorGpuClient(
     bool asynchronous, const GpuAllocatorConfig& allocator_config, int node_id,
     int num_nodes = 1,
@@ -232,7 +349,8 @@ StatusOr<std::unique_ptr<PjRtClient>> GetStreamExecutorGpuClient(
     bool should_stage_host_to_device_transfers = true,
     PjRtClient::KeyValueGetCallback kv_get = nullptr,
     PjRtClient::KeyValuePutCallback kv_put = nullptr,
-    bool enable_mock_nccl = false);
+    bool enable_mock_nccl = false,
+    int64_t max_inflight_bytes = std::numeric_limits<int64_t>::max());
 
 }  // namespace xla
 
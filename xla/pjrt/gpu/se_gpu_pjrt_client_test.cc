@@ -29,17 +29,22 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "xla/literal.h"
 #include "xla/literal_util.h"
+#include "xla/pjrt/local_device_state.h"
 #include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_stream_executor_client.h"
 #include "xla/pjrt/utils.h"
 #include "xla/service/hlo_parser.h"
 #include "xla/statusor.h"
 #include "xla/test.h"
 #include "xla/tests/literal_test_util.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/casts.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/status_matchers.h"
@@ -434,6 +439,113 @@ TEST(StreamExecutorGpuClientTest, CopyRawToHostOutOfRange) {
   free(dst);
 }
 
+TEST(StreamExecutorGpuClientTest, CopyToPinnedHostMemorySpace) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
+                                              /*node_id=*/0));
+  PjRtDevice* device = client->addressable_devices()[0];
+  ASSERT_EQ(device->memory_spaces().size(), 2);
+  PjRtMemorySpace* device_memory = device->memory_spaces()[0];
+  PjRtMemorySpace* pinned_host = device->memory_spaces()[1];
+  EXPECT_EQ(device_memory->memory_space_kind(), "device");
+  EXPECT_EQ(pinned_host->memory_space_kind(), "pinned_host");
+  TF_ASSERT_OK_AND_ASSIGN(PjRtMemorySpace * default_memory,
+                          device->default_memory_space());
+  EXPECT_EQ(default_memory, device_memory);
+
+  auto literal = xla::LiteralUtil::CreateR1<float>({41.0f, 42.0f});
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PjRtBuffer> buffer,
+                          client->BufferFromHostLiteral(literal, device));
+  EXPECT_EQ(buffer->memory_space(), device_memory);
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PjRtBuffer> host_buffer,
+                          buffer->CopyToMemorySpace(pinned_host));
+  EXPECT_EQ(host_buffer->memory_space(), pinned_host);
+  EXPECT_EQ(host_buffer->device(), device);
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PjRtBuffer> device_buffer,
+                          host_buffer->CopyToMemorySpace(device_memory));
+  EXPECT_EQ(device_buffer->memory_space(), device_memory);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> result,
+                          device_buffer->ToLiteralSync());
+  EXPECT_TRUE(LiteralTestUtil::Equal(literal, *result));
+}
+
+TEST(StreamExecutorGpuClientTest, DonatePinnedHostBufferFails) {
+  static constexpr char const* kDonatingProgram = R"(
+    HloModule Donating, input_output_alias={ {}: (0, {}, must-alias) }
+    ENTRY main {
+      p = f32[2] parameter(0)
+      ROOT add = f32[2] add(p, p)
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
+                                              /*node_id=*/0));
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          CompileExecutable(kDonatingProgram, *client));
+  PjRtDevice* device = client->addressable_devices()[0];
+  PjRtMemorySpace* pinned_host = device->memory_spaces()[1];
+  ASSERT_EQ(pinned_host->memory_space_kind(), "pinned_host");
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PjRtBuffer> buffer,
+      client->BufferFromHostLiteral(
+          LiteralUtil::CreateR1<float>({41.0f, 42.0f}), device));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<PjRtBuffer> host_buffer,
+                          buffer->CopyToMemorySpace(pinned_host));
+
+  // Executions free donated buffers with the device allocator, which doesn't
+  // own pinned host memory.
+  EXPECT_THAT(executable->Execute({{host_buffer.get()}}, ExecuteOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Donation requested for buffer in memory "
+                                 "space")));
+  EXPECT_FALSE(host_buffer->IsDeleted());
+}
+
+TEST(StreamExecutorGpuClientTest, DonatePackedBufferFails) {
+  static constexpr char const* kDonatingProgram = R"(
+    HloModule Donating, input_output_alias={ {}: (0, {}, must-alias) }
+    ENTRY main {
+      p = f32[2] parameter(0)
+      ROOT add = f32[2] add(p, p)
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
+                                              /*node_id=*/0));
+  TF_ASSERT_OK_AND_ASSIGN(auto executable,
+                          CompileExecutable(kDonatingProgram, *client));
+  PjRtDevice* device = client->addressable_devices()[0];
+
+  // Both arrays are small enough to be packed into one device allocation.
+  std::vector<float> a = {1.0f, 2.0f};
+  std::vector<float> b = {3.0f, 4.0f};
+  std::vector<int64_t> dims = {2};
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::unique_ptr<PjRtBuffer>> buffers,
+      tensorflow::down_cast<PjRtStreamExecutorClient*>(client.get())
+          ->BuffersFromHostBuffers(
+              {{a.data(), F32, dims}, {b.data(), F32, dims}},
+              PjRtClient::HostBufferSemantics::kImmutableOnlyDuringCall,
+              /*on_done_with_host_buffers=*/nullptr, device));
+  ASSERT_EQ(buffers.size(), 2);
+
+  // Donating a view would hand the allocation of both buffers to the
+  // execution.
+  EXPECT_THAT(executable->Execute({{buffers[0].get()}}, ExecuteOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("shares its allocation")));
+  EXPECT_FALSE(buffers[0]->IsDeleted());
+
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> a_literal,
+                          buffers[0]->ToLiteralSync());
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> b_literal,
+                          buffers[1]->ToLiteralSync());
+  EXPECT_TRUE(LiteralTestUtil::Equal(
+      LiteralUtil::CreateR1<float>({1.0f, 2.0f}), *a_literal));
+  EXPECT_TRUE(LiteralTestUtil::Equal(
+      LiteralUtil::CreateR1<float>({3.0f, 4.0f}), *b_literal));
+}
+
 TEST(StreamExecutorGpuClientTest, AsyncCopyToDevice) {
   TF_ASSERT_OK_AND_ASSIGN(
       auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
@@ -589,6 +701,94 @@ TEST(StreamExecutorGpuClientTest, DistributeInit) {
   }
 }
 
+TEST(StreamExecutorGpuClientTest, CrossHostTransfer) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
+                                              /*node_id=*/0));
+  if (client->addressable_devices().size() < 2) {
+    GTEST_SKIP() << "Test requires at least two GPUs.";
+  }
+  PjRtDevice* src_device = client->addressable_devices()[0];
+  PjRtDevice* dst_device = client->addressable_devices()[1];
+
+  std::vector<Literal> literals;
+  std::vector<Shape> shapes;
+  for (int i = 0; i < 2; ++i) {
+    std::vector<float> data(i + 3);
+    std::iota(data.begin(), data.end(), static_cast<float>(10 * i));
+    literals.push_back(LiteralUtil::CreateR1<float>(data));
+    shapes.push_back(literals.back().shape());
+  }
+
+  absl::Mutex mu;
+  std::optional<StatusOr<PjRtCrossHostRecvState>> recv_state;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::unique_ptr<PjRtBuffer>> dst_buffers,
+      client->MakeCrossHostReceiveBuffers(
+          shapes, dst_device, [&](StatusOr<PjRtCrossHostRecvState> state) {
+            absl::MutexLock lock(&mu);
+            recv_state = std::move(state);
+          }));
+  {
+    absl::MutexLock lock(&mu);
+    mu.Await(absl::Condition(
+        +[](std::optional<StatusOr<PjRtCrossHostRecvState>>* state) {
+          return state->has_value();
+        },
+        &recv_state));
+  }
+  TF_ASSERT_OK(recv_state->status());
+  ASSERT_EQ((*recv_state)->descriptors.size(), 2);
+
+  // Sends the buffers out of order, as the descriptors may reach the sender in
+  // any order.
+  std::vector<std::unique_ptr<PjRtBuffer>> src_buffers(2);
+  int num_sends_done = 0;
+  for (int i = 1; i >= 0; --i) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        src_buffers[i], client->BufferFromHostLiteral(literals[i], src_device));
+    src_buffers[i]->CopyToRemoteDevice(
+        PjRtFuture<StatusOr<std::string>>(
+            (*recv_state)->descriptors[i].serialized_descriptors[0]),
+        [&](Status status, bool sends_were_enqueued) {
+          EXPECT_TRUE(status.ok()) << status;
+          EXPECT_TRUE(sends_were_enqueued);
+          absl::MutexLock lock(&mu);
+          ++num_sends_done;
+        });
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> result,
+                            dst_buffers[i]->ToLiteralSync());
+    EXPECT_TRUE(LiteralTestUtil::Equal(literals[i], *result));
+  }
+  absl::MutexLock lock(&mu);
+  mu.Await(absl::Condition(
+      +[](int* num_sends_done) { return *num_sends_done == 2; },
+      &num_sends_done));
+}
+
+TEST(StreamExecutorGpuClientTest, CrossHostSendWithMalformedDescriptor) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
+                                              /*node_id=*/0));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<PjRtBuffer> buffer,
+      client->BufferFromHostLiteral(LiteralUtil::CreateR1<float>({1, 2}),
+                                    client->addressable_devices()[0]));
+
+  absl::Notification done;
+  buffer->CopyToRemoteDevice(
+      PjRtFuture<StatusOr<std::string>>(std::string("not a descriptor")),
+      [&](Status status, bool sends_were_enqueued) {
+        EXPECT_THAT(status, StatusIs(absl::StatusCode::kInvalidArgument));
+        EXPECT_FALSE(sends_were_enqueued);
+        done.Notify();
+      });
+  done.WaitForNotification();
+}
+
 TEST(StreamExecutorGpuClientTest, GetAllocatorStatsTest) {
   TF_ASSERT_OK_AND_ASSIGN(
       auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
@@ -606,5 +806,25 @@ TEST(StreamExecutorGpuClientTest, GetAllocatorStatsTest) {
   }
 }
 
+TEST(StreamExecutorGpuClientTest, MaxInflightBytes) {
+  constexpr int64_t kMaxInflightBytes = 1024;
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client,
+      GetStreamExecutorGpuClient(
+          true, /*allocator_config=*/{}, /*node_id=*/0, /*num_nodes=*/1,
+          /*allowed_devices=*/std::nullopt, /*platform_name=*/std::nullopt,
+          /*should_stage_host_to_device_transfers=*/true, /*kv_get=*/nullptr,
+          /*kv_put=*/nullptr, /*enable_mock_nccl=*/false, kMaxInflightBytes));
+
+  for (PjRtDevice* device : client->addressable_devices()) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        LocalDeviceState * device_state,
+        tensorflow::down_cast<PjRtStreamExecutorDevice*>(device)
+            ->GetLocalDeviceState());
+    EXPECT_EQ(device_state->execution_admission_queue().max_inflight_bytes(),
+              kMaxInflightBytes);
+  }
+}
+
 }  // namespace
 }  // namespace xla
@@ -17,10 +17,13 @@ limitations under the License.
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "xla/client/xla_computation.h"
+#include "xla/pjrt/gpu/remote_compile.pb.h"
 #include "xla/pjrt/gpu/se_gpu_pjrt_client.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_compiler.h"
@@ -183,6 +186,27 @@ StreamExecutorGpuCompiler::Compile(CompileOptions options,
 #endif
 }
 
+absl::StatusOr<std::string> HandleRemoteCompileRequest(
+    const RemoteCompileRequestProto& request) {
+  TF_ASSIGN_OR_RETURN(CompileOptions options,
+                      CompileOptions::FromProto(request.compile_options()));
+  if (!options.target_config.has_value()) {
+    return absl::InvalidArgumentError(
+        "Remote compile requests must have a target config.");
+  }
+  // The topology is only used to compile on a client, which the worker has
+  // none of.
+  StreamExecutorGpuTopologyDescription topology(
+      CudaId(), CudaName(), /*platform_version=*/"", /*gpu_device_ids=*/{});
+  StreamExecutorGpuCompiler compiler;
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<PjRtExecutable> executable,
+      compiler.Compile(std::move(options),
+                       XlaComputation(request.computation()), topology,
+                       /*client=*/nullptr));
+  return executable->SerializeExecutable();
+}
+
 REGISTER_MODULE_INITIALIZER(pjrt_register_se_gpu_compiler, {
   PjRtRegisterCompiler(CudaName(),
                        std::make_unique<StreamExecutorGpuCompiler>());
@@ -18,8 +18,11 @@ limitations under the License.
 
 #include <memory>
 #include <optional>
+#include <string>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "xla/pjrt/gpu/remote_compile.pb.h"
 #include "xla/pjrt/pjrt_compiler.h"
 #include "xla/pjrt/pjrt_executable.h"
 #include "xla/service/compiler.h"
@@ -41,5 +44,13 @@ class StreamExecutorGpuCompiler : public PjRtCompiler {
       CompileOptions options, mlir::ModuleOp module,
       const PjRtTopologyDescription& topology, PjRtClient* client) override;
 };
+
+// Compiles a request sent by StreamExecutorGpuClient::Compile to a remote
+// compile worker, and returns the serialized executable. The compilation is
+// deviceless, so the worker does not need GPUs. Autotuning results are read
+// from the result store configured by the debug options of the request, and
+// the kernels that are not found there are not autotuned.
+absl::StatusOr<std::string> HandleRemoteCompileRequest(
+    const RemoteCompileRequestProto& request);
 }  // namespace xla
 #endif  // XLA_PJRT_GPU_SE_GPU_PJRT_COMPILER_H_
@@ -34,6 +34,7 @@ limitations under the License.
 #include "xla/literal.h"
 #include "xla/literal_util.h"
 #include "xla/mlir_hlo/mhlo/IR/hlo_ops.h"
+#include "xla/pjrt/gpu/remote_compile.pb.h"
 #include "xla/pjrt/gpu/se_gpu_pjrt_client.h"
 #include "xla/pjrt/gpu/se_gpu_pjrt_compiler.h"
 #include "xla/pjrt/pjrt_client.h"
@@ -174,5 +175,33 @@ TEST(StreamExecutorGpuCompilerTest, SuccessLoadFromSerializedExecutable) {
   ValidateResult(result);
 }
 
+TEST(StreamExecutorGpuCompilerTest, SuccessCompileRemotely) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client, GetStreamExecutorGpuClient(true, /*allocator_config=*/{},
+                                              /*node_id=*/0));
+  auto se_client = absl::WrapUnique(
+      tensorflow::down_cast<StreamExecutorGpuClient*>(client.release()));
+  // The worker runs in process here, the request still goes through the wire
+  // format.
+  int num_requests = 0;
+  se_client->SetRemoteCompileCallback(
+      [&](const RemoteCompileRequestProto& request) {
+        ++num_requests;
+        RemoteCompileRequestProto parsed;
+        CHECK(parsed.ParseFromString(request.SerializeAsString()));
+        return HandleRemoteCompileRequest(parsed);
+      });
+
+  TF_ASSERT_OK_AND_ASSIGN(XlaComputation computation,
+                          GetXlaComputation(kProgram));
+  TF_ASSERT_OK_AND_ASSIGN(auto loaded_executable,
+                          se_client->Compile(computation, CompileOptions()));
+  EXPECT_EQ(num_requests, 1);
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto result, loaded_executable->Execute(/*argument_handles=*/{{}}, {}));
+  ValidateResult(result);
+}
+
 }  // namespace
 }  // namespace xla
@@ -55,12 +55,6 @@ Status HostCallbackContext::OnSend(int arg_num,
   // supposed to be invoked sequentially.
   ready_count_.store(args_.size());
 
-  std::vector<void*> arg_ptrs;
-  arg_ptrs.reserve(args_.size());
-  for (auto& arg : args_) {
-    arg_ptrs.push_back(arg.data());
-  }
-
   std::vector<PjRtChunk> results;
   std::vector<void*> result_ptrs;
   results.reserve(result_channels_.size());
@@ -72,14 +66,32 @@ Status HostCallbackContext::OnSend(int arg_num,
     result_ptrs.push_back(results.back().data());
   }
 
-  auto status = host_callback_.callback(result_ptrs.data(), arg_ptrs.data());
-  // TODO(chky): Consider populating garbage data in results upon errors.
-
-  // Clear the arguments for this invocation. This won't race with next
-  // invocation as send callbacks are supposed to be invoked sequentially.
-  for (auto& arg : args_) {
-    arg = PjRtChunk{};
+  Status status;
+  if (host_callback_.callback_with_owned_inputs) {
+    // Hand the arguments of this invocation over to the callback. This won't
+    // race with next invocation as send callbacks are supposed to be invoked
+    // sequentially.
+    std::vector<PjRtChunk> args(args_.size());
+    for (int i = 0; i < args_.size(); ++i) {
+      args[i] = std::move(args_[i]);
+    }
+    status = host_callback_.callback_with_owned_inputs(result_ptrs.data(),
+                                                       std::move(args));
+  } else {
+    std::vector<void*> arg_ptrs;
+    arg_ptrs.reserve(args_.size());
+    for (auto& arg : args_) {
+      arg_ptrs.push_back(arg.data());
+    }
+    status = host_callback_.callback(result_ptrs.data(), arg_ptrs.data());
+
+    // Clear the arguments for this invocation. This won't race with next
+    // invocation as send callbacks are supposed to be invoked sequentially.
+    for (auto& arg : args_) {
+      arg = PjRtChunk{};
+    }
   }
+  // TODO(chky): Consider populating garbage data in results upon errors.
 
   // Sending the results to recv callbacks if there is any. Note that after
   // this point, this callback can be invoked again (e.g. in a loop) anytime.
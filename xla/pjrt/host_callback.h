@@ -90,6 +90,13 @@ struct HostCallback {
   // callback can also return error status to indicate the entire execution
   // should fail.
   std::function<Status(void**, void**)> callback;
+
+  // Optional alternative to `callback` that takes ownership of the input
+  // buffers instead of borrowing them, so that the callee can keep them alive
+  // past the call (e.g. as zero-copy views handed to a language runtime)
+  // instead of copying them. If set, it is used instead of `callback`.
+  std::function<Status(void**, std::vector<PjRtChunk>)>
+      callback_with_owned_inputs;
 };
 
 // A helper class that maintains the send/recv states for a host callback.
@@ -18,6 +18,7 @@ limitations under the License.
 #include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "xla/pjrt/pjrt_client.h"
@@ -168,5 +169,61 @@ TEST(HostCallbackTest, NonBlockingRecv) {
   EXPECT_TRUE(LiteralTestUtil::Equal(literal, borrowing_literal));
 }
 
+TEST(HostCallbackTest, OwnedInputs) {
+  HostCallback host_callback;
+
+  Shape shape = ShapeUtil::MakeShape(F32, {2, 2});
+  size_t byte_size = ShapeUtil::ByteSizeOf(shape);
+
+  // The callback keeps the input chunk alive past the call.
+  PjRtChunk kept_input;
+  host_callback.operands = {HostCallbackArgInfo{/*channel_id=*/1, shape}};
+  host_callback.results = {HostCallbackArgInfo{/*channel_id=*/2, shape}};
+  host_callback.callback = [](void** outputs, void** inputs) {
+    return InternalError("Unexpected call to the borrowing callback");
+  };
+  host_callback.callback_with_owned_inputs =
+      [byte_size, &kept_input](void** outputs, std::vector<PjRtChunk> inputs) {
+        std::memcpy(outputs[0], inputs[0].data(), byte_size);
+        kept_input = std::move(inputs[0]);
+        return OkStatus();
+      };
+
+  HostCallbackStates states;
+
+  auto& send_callbacks = states.send_callbacks.emplace_back();
+  auto& recv_callbacks = states.recv_callbacks.emplace_back();
+
+  auto context = CreateHostCallbackStateAndAppendSendRecvCallbacks(
+      std::move(host_callback), /*host_memory_for_device_manager=*/nullptr,
+      send_callbacks, recv_callbacks,
+      /*use_major_to_minor_data_layout_for_callbacks=*/true);
+
+  PjRtTransferMetadata metadata;
+  metadata.device_shape = shape;
+
+  auto literal = LiteralUtil::CreateR2({{1.0f, 2.0f}, {3.0f, 4.0f}});
+  auto chunk = PjRtChunk::AllocateDefault(/*size=*/byte_size);
+  ASSERT_EQ(chunk.size(), literal.size_bytes());
+  std::memcpy(chunk.data(), literal.untyped_data(), literal.size_bytes());
+  const uint8_t* sent_data = chunk.data();
+
+  TF_ASSERT_OK(context->OnSend(/*arg_num=*/0, metadata, std::move(chunk)));
+
+  // The input buffer was handed over without a copy.
+  EXPECT_EQ(kept_input.data(), sent_data);
+
+  PjRtChunk received_chunk;
+  absl::Notification done;
+  auto stream = std::make_unique<TestStream>(byte_size, /*granule_bytes=*/8,
+                                             received_chunk, done);
+  context->Receive(/*res_num=*/0, metadata, std::move(stream));
+  done.WaitForNotification();
+
+  BorrowingLiteral borrowing_literal(
+      reinterpret_cast<const char*>(received_chunk.data()), shape);
+  EXPECT_TRUE(LiteralTestUtil::Equal(literal, borrowing_literal));
+}
+
 }  // namespace
 }  // namespace xla
@@ -22,6 +22,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/stream_executor/stream.h"
 #include "xla/util.h"
@@ -36,11 +37,12 @@ LocalDeviceState::LocalDeviceState(se::StreamExecutor* executor,
                                    int max_inflight_computations,
                                    bool allow_event_reuse,
                                    bool use_callback_stream, int device_ordinal,
-                                   std::optional<StreamOptions> stream_options)
+                                   std::optional<StreamOptions> stream_options,
+                                   int64_t max_inflight_bytes)
     : allocation_model_(allocation_model),
       event_pool_(allow_event_reuse),
-      compute_semaphore_(
-          /*capacity=*/max_inflight_computations),
+      execution_admission_queue_(max_inflight_computations,
+                                 max_inflight_bytes),
       executor_(executor),
       client_(client),
       prng_seed_generator_(prng_seed_device_()),
@@ -98,8 +100,11 @@ LocalDeviceState::LocalDeviceState(se::StreamExecutor* executor,
   }
   execute_thread_ =
       std::make_unique<WorkerThread>(tsl::Env::Default(), "py_xla_execute");
-  callback_thread_ =
-      std::make_unique<WorkerThread>(tsl::Env::Default(), "py_xla_callback");
+  callback_threads_.reserve(kNumCallbackThreads);
+  for (int i = 0; i < kNumCallbackThreads; ++i) {
+    callback_threads_.push_back(std::make_unique<WorkerThread>(
+        tsl::Env::Default(), absl::StrCat("py_xla_callback_", i)));
+  }
 }
 
 LocalDeviceState::~LocalDeviceState() {
@@ -146,6 +151,12 @@ Status LocalDeviceState::ThenMemcpyDeviceToDevice(
 void LocalDeviceState::ThenExecuteCallback(se::Stream* stream,
                                            std::function<void()> callback) {
   tsl::profiler::TraceMe traceme("ThenExecuteCallback");
+  // The thread is chosen from the stream the caller passed, so that callbacks
+  // keep their order even when they are enqueued on a callback stream.
+  WorkerThread* callback_thread =
+      callback_threads_[std::hash<se::Stream*>()(stream) %
+                        callback_threads_.size()]
+          .get();
   if (callback_stream_map_.has_value()) {
     // Prevent concurrent updates to the callback stream map.
     absl::MutexLock lock(&callback_stream_map_mu_);
@@ -159,9 +170,10 @@ void LocalDeviceState::ThenExecuteCallback(se::Stream* stream,
     callback_stream->second->ThenWaitFor(stream);
     stream = callback_stream->second.get();
   }
-  stream->ThenDoHostCallback([this, callback{std::move(callback)}]() mutable {
-    callback_thread_->Schedule(std::move(callback));
-  });
+  stream->ThenDoHostCallback(
+      [callback_thread, callback{std::move(callback)}]() mutable {
+        callback_thread->Schedule(std::move(callback));
+      });
 }
 
 se::Stream* LocalDeviceState::GetDeviceToHostStream() {
@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef XLA_PJRT_LOCAL_DEVICE_STATE_H_
 #define XLA_PJRT_LOCAL_DEVICE_STATE_H_
 
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <random>
@@ -26,7 +28,7 @@ limitations under the License.
 #include "absl/synchronization/mutex.h"
 #include "xla/client/local_client.h"
 #include "xla/pjrt/event_pool.h"
-#include "xla/pjrt/semaphore.h"
+#include "xla/pjrt/execution_admission_queue.h"
 #include "xla/pjrt/worker_thread.h"
 #include "xla/status.h"
 #include "xla/stream_executor/stream.h"
@@ -99,11 +101,15 @@ class LocalDeviceState {
 
   // If asynchronous is false, the host will synchronize to the device after
   // each execution or transfer. This is intended for debugging only.
-  LocalDeviceState(se::StreamExecutor* executor, LocalClient* client,
-                   AllocationModel allocation_model,
-                   int max_inflight_computations, bool allow_event_reuse,
-                   bool use_callback_stream, int device_ordinal = -1,
-                   std::optional<StreamOptions> stream_options = std::nullopt);
+  //
+  // `max_inflight_bytes` bounds the total size of the arguments of the
+  // computations enqueued ahead of the device.
+  LocalDeviceState(
+      se::StreamExecutor* executor, LocalClient* client,
+      AllocationModel allocation_model, int max_inflight_computations,
+      bool allow_event_reuse, bool use_callback_stream, int device_ordinal = -1,
+      std::optional<StreamOptions> stream_options = std::nullopt,
+      int64_t max_inflight_bytes = std::numeric_limits<int64_t>::max());
   virtual ~LocalDeviceState();
 
   se::StreamExecutor* executor() const { return executor_; }
@@ -114,6 +120,21 @@ class LocalDeviceState {
 
   AllocationModel allocation_model() const { return allocation_model_; }
 
+  // Only meaningful in the kComputeSynchronized model. If true, a buffer that
+  // is freed while an operation on a non-compute stream may still be using it
+  // is released after making the compute stream wait for that operation,
+  // instead of being kept alive by a host callback on a borrowed stream. This
+  // suits allocators that order frees on the compute stream, e.g.
+  // cudaMallocAsync, where the memory then becomes reusable by later work on
+  // the compute stream without any host round trip. Must be set before the
+  // device is used.
+  bool order_frees_on_compute_stream() const {
+    return order_frees_on_compute_stream_;
+  }
+  void set_order_frees_on_compute_stream(bool value) {
+    order_frees_on_compute_stream_ = value;
+  }
+
   EventPool& event_pool() { return event_pool_; }
 
   se::Stream* compute_stream() const { return compute_stream_.get(); }
@@ -168,6 +189,10 @@ class LocalDeviceState {
   //    runtime and cannot perform GPU operations itself. On GPU, callbacks
   //    execute in a separate thread.
   // b) ThenDoHostCallback waits for the callback to complete.
+  // Callbacks enqueued on the same stream run in order, on one of a small
+  // pool of callback threads; callbacks of different streams may run
+  // concurrently. Callbacks that can be enqueued together should be combined
+  // by the caller, since each call adds a host function node to the stream.
   void ThenExecuteCallback(se::Stream* stream, std::function<void()> callback);
 
   // Helpers for releasing values on a worker thread at the tail of a stream on
@@ -182,7 +207,11 @@ class LocalDeviceState {
         stream, [object = std::forward<T>(object)]() { /* releases object */ });
   }
 
-  Semaphore& compute_semaphore() { return compute_semaphore_; }
+  // Admission queue that paces the computations enqueued on the compute
+  // stream, in order of their ExecuteOptions::priority.
+  ExecutionAdmissionQueue& execution_admission_queue() {
+    return execution_admission_queue_;
+  }
 
   // Returns a fresh, PRNG-generated random seed for an XLA computation.
   int GetNewPrngSeed();
@@ -191,12 +220,13 @@ class LocalDeviceState {
   Status SynchronizeAllActivity();
 
   AllocationModel allocation_model_;
+  bool order_frees_on_compute_stream_ = false;
 
   EventPool event_pool_;
 
-  // Semaphore used to limit how many programs can be enqueued on the compute
-  // stream by the host ahead of the device.
-  Semaphore compute_semaphore_;
+  // Bounds the number of computations and argument bytes enqueued on the
+  // compute stream ahead of the device.
+  ExecutionAdmissionQueue execution_admission_queue_;
 
   int device_ordinal_;
   se::StreamExecutor* const executor_;
@@ -210,6 +240,7 @@ class LocalDeviceState {
   static constexpr int kNumDeviceToHostStreams = 4;
   static constexpr int kNumDeviceToDeviceStreams = 4;
   static constexpr int kNumExternalReadyEventStreams = 4;
+  static constexpr int kNumCallbackThreads = 4;
 
   absl::Mutex mu_;
   int next_device_to_host_stream_ ABSL_GUARDED_BY(mu_) = 0;
@@ -232,11 +263,12 @@ class LocalDeviceState {
   // A worker thread, used for replicated computation launches.
   std::unique_ptr<WorkerThread> execute_thread_;
 
-  // A worker thread, used for callbacks. It is necessary that this be a
-  // different thread to the execute thread because we acquire the compute
-  // semaphore during calls to Execute but release it from a callback and if
-  // they are the same thread we might deadlock.
-  std::unique_ptr<WorkerThread> callback_thread_;
+  // Worker threads, used for callbacks. Each stream is mapped to one of the
+  // threads, so that its callbacks run in order. It is necessary that these be
+  // different threads to the execute thread because we are admitted by the
+  // execution admission queue during calls to Execute but release the ticket
+  // from a callback and if they are the same thread we might deadlock.
+  std::vector<std::unique_ptr<WorkerThread>> callback_threads_;
 };
 
 }  // namespace xla
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_PJRT_LRU_CACHE_H_
 #define XLA_PJRT_LRU_CACHE_H_
 
+#include <cstdint>
 #include <optional>
 
 #include "absl/container/node_hash_map.h"
@@ -59,6 +60,8 @@ class LRUCache {
 
     int Capacity() const { return capacity_; }
     int Size() const { return size_; }
+    // Number of entries evicted to stay within capacity so far.
+    int64_t Evictions() const { return evictions_; }
 
     void Clear();
 
@@ -66,6 +69,7 @@ class LRUCache {
     friend class LRUCache;
     int capacity_;
     int size_ = 0;
+    int64_t evictions_ = 0;
 
     // Root of a circular doubly-linked list of entries, in order from least
     // recently used to most recently used. An "empty" cache always contains
@@ -172,6 +176,7 @@ Value LRUCache<Key, Value, Hash, Eq>::GetOrCreateIfAbsent(
     // dtor to be delayed until the kv pair is fully removed from the map.
     to_remove->container->entries_.extract(*to_remove->key);
     --lru_list_->size_;
+    ++lru_list_->evictions_;
   }
   return v;
 }
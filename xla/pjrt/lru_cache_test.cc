@@ -41,6 +41,7 @@ TEST(LRUCache, Basics) {
   EXPECT_EQ(3, cache.Size());
   EXPECT_EQ(6, cache.GetOrCreateIfAbsent(1, [](int) { return 6; }));
   EXPECT_EQ(3, cache.Size());
+  EXPECT_EQ(2, list.Evictions());
   cache.Clear();
   EXPECT_EQ(0, cache.Size());
   EXPECT_EQ(6, cache.GetOrCreateIfAbsent(1, [](int) { return 6; }));
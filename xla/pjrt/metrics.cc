@@ -15,15 +15,20 @@ limitations under the License.
 
 #include "xla/pjrt/metrics.h"
 
+#include <atomic>
 #include <cstdint>
+#include <string>
 
 #include "absl/log/log.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "xla/stream_executor/gpu/gpu_init.h"
 #include "xla/stream_executor/platform.h"
 #include "xla/stream_executor/stream_executor_pimpl.h"
 #include "tsl/lib/monitoring/counter.h"
 #include "tsl/lib/monitoring/gauge.h"
+#include "tsl/lib/monitoring/sampler.h"
+#include "tsl/util/env_var.h"
 
 namespace xla {
 namespace {
@@ -50,6 +55,34 @@ auto* free_gpu_system_memory = tsl::monitoring::Gauge<int64_t, 1>::New(
     metrics::kPjrtCompilerFreeGpuSystemMemoryMetricName,
     "Record the free GPU system memory.", "gpu_id");
 
+// Buckets from 10us to ~3 hours.
+auto* pjrt_executable_step_time_usecs = tsl::monitoring::Sampler<1>::New(
+    {metrics::kPjrtExecutableStepTimeMetricName,
+     "Distribution of the time between the enqueue and the completion of "
+     "sampled executions, in microseconds.",
+     "executable"},
+    tsl::monitoring::Buckets::Exponential(10, 2, 31));
+
+auto* pjrt_host_to_device_transfer_bytes = tsl::monitoring::Counter<0>::New(
+    metrics::kPjrtHostToDeviceBytesMetricName,
+    "The number of bytes transferred from host buffers and literals to "
+    "devices.");
+
+auto* pjrt_device_to_host_transfer_bytes = tsl::monitoring::Counter<0>::New(
+    metrics::kPjrtDeviceToHostBytesMetricName,
+    "The number of bytes transferred from devices to host literals.");
+
+int64_t GetExecutionSamplingPeriod() {
+  int64_t period;
+  tsl::Status status = tsl::ReadInt64FromEnvVar(
+      "XLA_PJRT_EXECUTION_SAMPLING_PERIOD", 100, &period);
+  if (!status.ok()) {
+    LOG(ERROR) << "Disabling execution sampling: " << status;
+    return 0;
+  }
+  return period;
+}
+
 }  // namespace
 
 namespace metrics {
@@ -65,6 +98,33 @@ void ReportExecutableEnqueueTime(const uint64_t running_time_usecs) {
   }
 }
 
+bool ShouldSampleExecution() {
+  static const int64_t period = GetExecutionSamplingPeriod();
+  return ShouldSampleExecution(period);
+}
+
+bool ShouldSampleExecution(int64_t period) {
+  if (period <= 0) return false;
+  static std::atomic<uint64_t> num_executions{0};
+  return num_executions.fetch_add(1, std::memory_order_relaxed) % period == 0;
+}
+
+void ReportExecutableStepTime(absl::string_view executable_name,
+                              uint64_t step_time_usecs) {
+  pjrt_executable_step_time_usecs->GetCell(std::string(executable_name))
+      ->Add(step_time_usecs);
+}
+
+void ReportHostToDeviceTransferBytes(int64_t bytes) {
+  static auto* cell = pjrt_host_to_device_transfer_bytes->GetCell();
+  cell->IncrementBy(bytes);
+}
+
+void ReportDeviceToHostTransferBytes(int64_t bytes) {
+  static auto* cell = pjrt_device_to_host_transfer_bytes->GetCell();
+  cell->IncrementBy(bytes);
+}
+
 void RecordPjrtCompilerCompileComputationStatus(bool is_compiling) {
   pjrt_compiler_is_compiling_computation->GetCell()->Set(is_compiling);
 }
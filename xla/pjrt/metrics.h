@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef XLA_PJRT_METRICS_H_
 #define XLA_PJRT_METRICS_H_
 
+#include <cstdint>
+
 #include "absl/base/attributes.h"
 #include "absl/strings/string_view.h"
 #include "tsl/lib/monitoring/counter.h"
@@ -31,9 +33,34 @@ inline constexpr absl::string_view kPjrtCompilerCompileModuleMetricName =
     "/pjrt/compiler/is_compiling_module";
 inline constexpr absl::string_view kPjrtCompilerFreeGpuSystemMemoryMetricName =
     "/pjrt/compiler/free_gpu_system_memory";
+inline constexpr absl::string_view kPjrtExecutableStepTimeMetricName =
+    "/jax/pjrt/pjrt_executable_step_time_usecs";
+inline constexpr absl::string_view kPjrtHostToDeviceBytesMetricName =
+    "/jax/pjrt/host_to_device_transfer_bytes";
+inline constexpr absl::string_view kPjrtDeviceToHostBytesMetricName =
+    "/jax/pjrt/device_to_host_transfer_bytes";
 
 void ReportExecutableEnqueueTime(uint64_t running_time_usecs);
 
+// Returns true for one in every `period` calls, where the period is read once
+// from the XLA_PJRT_EXECUTION_SAMPLING_PERIOD environment variable (100 by
+// default, 0 disables sampling). Executions for which this returns true report
+// their step time, so that step times are continuously exported at a cost that
+// is negligible compared to tracing.
+bool ShouldSampleExecution();
+
+// Like above, with an explicit sampling period.
+bool ShouldSampleExecution(int64_t period);
+
+// Records the time between the enqueue of a sampled execution of
+// `executable_name` and the completion of its computation on the device.
+void ReportExecutableStepTime(absl::string_view executable_name,
+                              uint64_t step_time_usecs);
+
+void ReportHostToDeviceTransferBytes(int64_t bytes);
+
+void ReportDeviceToHostTransferBytes(int64_t bytes);
+
 void RecordPjrtCompilerCompileComputationStatus(bool is_compiling);
 
 void RecordPjrtCompilerCompileModuleStatus(bool is_compiling);
@@ -0,0 +1,67 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/metrics.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "tsl/lib/monitoring/cell_reader.h"
+#include "tsl/lib/monitoring/test_utils.h"
+
+namespace xla {
+namespace metrics {
+namespace {
+
+using ::tsl::monitoring::testing::CellReader;
+using ::tsl::monitoring::testing::Histogram;
+
+TEST(MetricsTest, SamplesOneInPeriodExecutions) {
+  int num_sampled = 0;
+  for (int i = 0; i < 100; ++i) {
+    num_sampled += ShouldSampleExecution(/*period=*/10);
+  }
+  EXPECT_EQ(num_sampled, 10);
+
+  EXPECT_FALSE(ShouldSampleExecution(/*period=*/0));
+  EXPECT_TRUE(ShouldSampleExecution(/*period=*/1));
+}
+
+TEST(MetricsTest, ReportsStepTimePerExecutable) {
+  CellReader<Histogram> step_time(
+      std::string(kPjrtExecutableStepTimeMetricName));
+  ReportExecutableStepTime("a", 100);
+  ReportExecutableStepTime("a", 300);
+  ReportExecutableStepTime("b", 50);
+
+  Histogram a = step_time.Delta("a");
+  EXPECT_FLOAT_EQ(a.num(), 2);
+  EXPECT_FLOAT_EQ(a.sum(), 400);
+  EXPECT_FLOAT_EQ(step_time.Delta("b").num(), 1);
+}
+
+TEST(MetricsTest, CountsTransferredBytes) {
+  CellReader<int64_t> h2d(std::string(kPjrtHostToDeviceBytesMetricName));
+  CellReader<int64_t> d2h(std::string(kPjrtDeviceToHostBytesMetricName));
+  ReportHostToDeviceTransferBytes(1024);
+  ReportDeviceToHostTransferBytes(16);
+  ReportDeviceToHostTransferBytes(16);
+  EXPECT_EQ(h2d.Delta(), 1024);
+  EXPECT_EQ(d2h.Delta(), 32);
+}
+
+}  // namespace
+}  // namespace metrics
+}  // namespace xla
@@ -18,11 +18,19 @@ limitations under the License.
 
 #include "absl/strings/string_view.h"
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
+#include "mlir/IR/MLIRContext.h"  // from @llvm-project
 #include "xla/client/xla_computation.h"
 #include "xla/status.h"
 
 namespace xla {
 
+// Makes `context` run multithreaded passes on a thread pool shared by all the
+// contexts configured this way. By default each context creates its own
+// threads, which oversubscribes the machine when modules are compiled
+// concurrently. Create the context with threading disabled to avoid creating
+// its thread pool at all.
+void UseSharedMlirThreadPool(mlir::MLIRContext& context);
+
 // Converts an MHLO/CHLO module string to an mlir::Module.
 StatusOr<mlir::OwningOpRef<mlir::ModuleOp>> ParseMlirModuleString(
     absl::string_view mlir_module_str, mlir::MLIRContext& context);
@@ -178,6 +178,20 @@ absl::StatusOr<ExecuteOptionsProto> ExecuteOptions::ToProto() const {
 
   proto.mutable_non_donatable_input_indices()->Add(
       non_donatable_input_indices.begin(), non_donatable_input_indices.end());
+  proto.set_donate_may_alias_inputs_only_if_unreferenced(
+      donate_may_alias_inputs_only_if_unreferenced);
+
+  switch (priority) {
+    case ExecutionPriority::kDefault:
+      proto.set_priority(EXECUTION_PRIORITY_DEFAULT);
+      break;
+    case ExecutionPriority::kLatencyCritical:
+      proto.set_priority(EXECUTION_PRIORITY_LATENCY_CRITICAL);
+      break;
+    case ExecutionPriority::kBatch:
+      proto.set_priority(EXECUTION_PRIORITY_BATCH);
+      break;
+  }
 
   return proto;
 }
@@ -211,6 +225,23 @@ absl::StatusOr<ExecuteOptions> ExecuteOptions::FromProto(
   options.non_donatable_input_indices.insert(
       proto.non_donatable_input_indices().begin(),
       proto.non_donatable_input_indices().end());
+  options.donate_may_alias_inputs_only_if_unreferenced =
+      proto.donate_may_alias_inputs_only_if_unreferenced();
+
+  switch (proto.priority()) {
+    case EXECUTION_PRIORITY_DEFAULT:
+      options.priority = ExecutionPriority::kDefault;
+      break;
+    case EXECUTION_PRIORITY_LATENCY_CRITICAL:
+      options.priority = ExecutionPriority::kLatencyCritical;
+      break;
+    case EXECUTION_PRIORITY_BATCH:
+      options.priority = ExecutionPriority::kBatch;
+      break;
+    default:
+      return absl::UnimplementedError(
+          absl::StrCat("Unknown execution priority: ", proto.priority()));
+  }
 
   return options;
 }
@@ -247,6 +247,13 @@ struct ExecuteOptions {
   enum class ExecutionMode { kDefault = 0, kSynchronous, kAsynchronous };
   ExecutionMode execution_mode = ExecutionMode::kDefault;
 
+  // The priority class of the execution. When a device has reached its limit
+  // of in-flight executions, pending latency-critical executions are launched
+  // before pending default ones, which are launched before batch ones.
+  // Currently only applied to StreamExecutor implementations.
+  enum class ExecutionPriority { kDefault = 0, kLatencyCritical, kBatch };
+  ExecutionPriority priority = ExecutionPriority::kDefault;
+
   // A set of indices denoting the input buffers that should not be donated.
   // An input buffer may be non-donable, for example, if it is referenced more
   // than once. Since such runtime information is not available at compile time,
@@ -256,6 +263,13 @@ struct ExecuteOptions {
   // specific input buffers.
   absl::flat_hash_set<int> non_donatable_input_indices;
 
+  // If true, input buffers that are only may-aliased to outputs are donated
+  // only when nothing else references them, instead of failing the execution:
+  // when the buffer is also passed as another argument or has an external
+  // reference, it is read in place and the aliased outputs get new buffers.
+  // Currently only applied to StreamExecutor implementations.
+  bool donate_may_alias_inputs_only_if_unreferenced = false;
+
   absl::StatusOr<ExecuteOptionsProto> ToProto() const;
   static absl::StatusOr<ExecuteOptions> FromProto(
       const ExecuteOptionsProto& proto);
@@ -0,0 +1,243 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/pjrt_executable_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/client/xla_computation.h"
+#include "xla/debug_options_flags.h"
+#include "xla/pjrt/compile_options.pb.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+#include "xla/util.h"
+#include "tsl/lib/strings/proto_serialization.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+// Bump this version whenever the key or the cached values change.
+constexpr int kVersion = 2;
+
+}  // namespace
+
+StatusOr<std::optional<std::string>> DirectoryPjRtExecutableCacheStore::Lookup(
+    const std::string& key) {
+  tsl::Env* env = tsl::Env::Default();
+  std::string path = tsl::io::JoinPath(dir_, key);
+  if (!env->FileExists(path).ok()) {
+    return std::nullopt;
+  }
+  std::string serialized_executable;
+  TF_RETURN_IF_ERROR(tsl::ReadFileToString(env, path, &serialized_executable));
+  return std::optional<std::string>(std::move(serialized_executable));
+}
+
+Status DirectoryPjRtExecutableCacheStore::Insert(
+    const std::string& key, const std::string& serialized_executable) {
+  tsl::Env* env = tsl::Env::Default();
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(dir_));
+  std::string path = tsl::io::JoinPath(dir_, key);
+  // Write through a temporary file, so that other processes never read a
+  // partially written executable.
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return FailedPrecondition("Couldn't create a temporary file name for %s",
+                              path);
+  }
+  TF_RETURN_IF_ERROR(
+      tsl::WriteStringToFile(env, tmp_path, serialized_executable));
+  return env->RenameFile(tmp_path, path);
+}
+
+StatusOr<std::optional<std::string>> KeyValuePjRtExecutableCacheStore::Lookup(
+    const std::string& key) {
+  return get_(absl::StrCat("executable:", key));
+}
+
+Status KeyValuePjRtExecutableCacheStore::Insert(
+    const std::string& key, const std::string& serialized_executable) {
+  return put_(absl::StrCat("executable:", key), serialized_executable);
+}
+
+/*static*/ StatusOr<std::string> PjRtExecutableCache::GetKey(
+    const PjRtClient& client, const XlaComputation& computation,
+    const CompileOptions& options) {
+  std::string serialized_computation;
+  if (!tsl::SerializeToStringDeterministic(computation.proto(),
+                                           &serialized_computation)) {
+    return InvalidArgument("Failed to serialize the computation %s",
+                           computation.name());
+  }
+  TF_ASSIGN_OR_RETURN(CompileOptionsProto options_proto, options.ToProto());
+  std::string serialized_options;
+  if (!tsl::SerializeToStringDeterministic(options_proto,
+                                           &serialized_options)) {
+    return InvalidArgument("Failed to serialize the compile options of %s",
+                           computation.name());
+  }
+  // Compilations without debug options use the ones of the flags.
+  std::string serialized_debug_options;
+  if (!options.executable_build_options.has_debug_options() &&
+      !tsl::SerializeToStringDeterministic(GetDebugOptionsFromFlags(),
+                                           &serialized_debug_options)) {
+    return InvalidArgument("Failed to serialize the debug options of %s",
+                           computation.name());
+  }
+  std::vector<absl::string_view> device_kinds;
+  for (const PjRtDevice* device : client.addressable_devices()) {
+    device_kinds.push_back(device->device_kind());
+  }
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(absl::StrCat(
+      kVersion, "\n", client.platform_name(), "\n", client.platform_version(),
+      "\n", absl::StrJoin(device_kinds, ","), "\n", serialized_options, "\n",
+      serialized_debug_options, "\n", serialized_computation));
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+StatusOr<std::unique_ptr<PjRtLoadedExecutable>> PjRtExecutableCache::Compile(
+    PjRtClient* client, const XlaComputation& computation,
+    CompileOptions options) {
+  StatusOr<std::string> key = GetKey(*client, computation, options);
+  if (!key.ok()) {
+    VLOG(1) << "Compiling " << computation.name()
+            << " without the executable cache: " << key.status();
+    return client->Compile(computation, std::move(options));
+  }
+
+  std::shared_ptr<Flight> flight;
+  bool is_leader = false;
+  SerializedExecutable executable;
+  {
+    absl::MutexLock lock(&mu_);
+    if (auto it = cache_.find(*key); it != cache_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+      executable = it->second.executable;
+    } else if (auto it = flights_.find(*key); it != flights_.end()) {
+      flight = it->second;
+    } else {
+      flight = std::make_shared<Flight>();
+      flights_.emplace(*key, flight);
+      is_leader = true;
+    }
+  }
+
+  if (is_leader) {
+    StatusOr<std::unique_ptr<PjRtLoadedExecutable>> loaded =
+        CompileMiss(client, computation, options, *key, &executable);
+    absl::MutexLock lock(&mu_);
+    flights_.erase(*key);
+    if (executable != nullptr) InsertInMemoryLocked(*key, executable);
+    flight->status = loaded.status();
+    flight->executable = executable;
+    flight->done.Notify();
+    return loaded;
+  }
+
+  if (flight != nullptr) {
+    flight->done.WaitForNotification();
+    TF_RETURN_IF_ERROR(flight->status);
+    executable = flight->executable;
+    if (executable == nullptr) {
+      return client->Compile(computation, std::move(options));
+    }
+  }
+  return client->DeserializeExecutable(*executable, std::move(options));
+}
+
+StatusOr<std::unique_ptr<PjRtLoadedExecutable>>
+PjRtExecutableCache::CompileMiss(PjRtClient* client,
+                                 const XlaComputation& computation,
+                                 const CompileOptions& options,
+                                 const std::string& key,
+                                 SerializedExecutable* executable) {
+  if (options_.store != nullptr) {
+    StatusOr<std::optional<std::string>> stored = options_.store->Lookup(key);
+    if (!stored.ok()) {
+      LOG(WARNING) << "Failed to look up " << computation.name()
+                   << " in the executable cache store: " << stored.status();
+    } else if (stored->has_value()) {
+      auto serialized =
+          std::make_shared<const std::string>(**std::move(stored));
+      StatusOr<std::unique_ptr<PjRtLoadedExecutable>> loaded =
+          client->DeserializeExecutable(*serialized, options);
+      if (loaded.ok()) {
+        VLOG(1) << "Executable cache store hit for " << computation.name();
+        *executable = std::move(serialized);
+        return loaded;
+      }
+      LOG(WARNING) << "Failed to load the stored executable of "
+                   << computation.name() << ": " << loaded.status();
+    }
+  }
+
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtLoadedExecutable> loaded,
+                      client->Compile(computation, options));
+  StatusOr<std::string> serialized = loaded->SerializeExecutable();
+  if (!serialized.ok()) {
+    VLOG(1) << "Not caching the executable of " << computation.name() << ": "
+            << serialized.status();
+    return loaded;
+  }
+  *executable = std::make_shared<const std::string>(*std::move(serialized));
+  if (options_.store != nullptr) {
+    if (Status status = options_.store->Insert(key, **executable);
+        !status.ok()) {
+      LOG(WARNING) << "Failed to store the executable of " << computation.name()
+                   << " in the executable cache store: " << status;
+    }
+  }
+  return loaded;
+}
+
+void PjRtExecutableCache::InsertInMemoryLocked(
+    const std::string& key, SerializedExecutable executable) {
+  const int64_t size = executable->size();
+  if (size > options_.max_memory_bytes || cache_.contains(key)) return;
+  while (memory_bytes_ + size > options_.max_memory_bytes) {
+    auto it = cache_.find(lru_.back());
+    memory_bytes_ -= it->second.executable->size();
+    cache_.erase(it);
+    lru_.pop_back();
+  }
+  lru_.push_front(key);
+  cache_.emplace(key, CachedExecutable{std::move(executable), lru_.begin()});
+  memory_bytes_ += size;
+}
+
+int64_t PjRtExecutableCache::memory_bytes() const {
+  absl::MutexLock lock(&mu_);
+  return memory_bytes_;
+}
+
+}  // namespace xla
@@ -0,0 +1,172 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_PJRT_PJRT_EXECUTABLE_CACHE_H_
+#define XLA_PJRT_PJRT_EXECUTABLE_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "xla/client/xla_computation.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/pjrt_executable.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+
+namespace xla {
+
+// Persists serialized executables, typically across processes and hosts.
+class PjRtExecutableCacheStore {
+ public:
+  virtual ~PjRtExecutableCacheStore() = default;
+
+  // Returns the executable stored for `key`, or std::nullopt if there is none.
+  virtual StatusOr<std::optional<std::string>> Lookup(
+      const std::string& key) = 0;
+
+  // Stores `serialized_executable` for `key`. If several processes store an
+  // executable for the same key, any one of them may win.
+  virtual Status Insert(const std::string& key,
+                        const std::string& serialized_executable) = 0;
+};
+
+// Stores each executable in its own file in a directory, which can be on any
+// file system supported by tsl::Env, including remote ones. Files are never
+// deleted by the store.
+class DirectoryPjRtExecutableCacheStore : public PjRtExecutableCacheStore {
+ public:
+  explicit DirectoryPjRtExecutableCacheStore(std::string dir)
+      : dir_(std::move(dir)) {}
+
+  StatusOr<std::optional<std::string>> Lookup(const std::string& key) override;
+  Status Insert(const std::string& key,
+                const std::string& serialized_executable) override;
+
+ private:
+  std::string dir_;
+};
+
+// Stores executables in a key-value store, e.g. a remote cache service. `get`
+// returns std::nullopt for keys that have not been set and must not block
+// waiting for them.
+class KeyValuePjRtExecutableCacheStore : public PjRtExecutableCacheStore {
+ public:
+  using GetCallback = std::function<StatusOr<std::optional<std::string>>(
+      const std::string& key)>;
+  using PutCallback =
+      std::function<Status(const std::string& key, const std::string& value)>;
+
+  KeyValuePjRtExecutableCacheStore(GetCallback get, PutCallback put)
+      : get_(std::move(get)), put_(std::move(put)) {}
+
+  StatusOr<std::optional<std::string>> Lookup(const std::string& key) override;
+  Status Insert(const std::string& key,
+                const std::string& serialized_executable) override;
+
+ private:
+  GetCallback get_;
+  PutCallback put_;
+};
+
+struct PjRtExecutableCacheOptions {
+  // Maximum total size of the serialized executables kept in memory. The
+  // least recently used executables are evicted first.
+  int64_t max_memory_bytes = int64_t{1} << 30;
+
+  // Where executables are persisted, or null to only keep them in memory.
+  // Errors of the store are logged and otherwise ignored.
+  std::shared_ptr<PjRtExecutableCacheStore> store;
+};
+
+// A cache of compiled executables in front of PjRtClient::Compile, keyed by
+// the fingerprint of the computation, the compile options (including the debug
+// options of the flags when the options have none), and the platform and
+// addressable device kinds of the client.
+//
+// Executables are cached in their serialized form and deserialized by each
+// caller, as loaded executables can't be shared. Concurrent compilations of
+// the same key are only compiled once: the other callers wait for the first
+// one and then load its result. Clients that can't serialize executables are
+// supported, but their executables are not cached.
+//
+// This class is thread-safe.
+class PjRtExecutableCache {
+ public:
+  explicit PjRtExecutableCache(PjRtExecutableCacheOptions options = {})
+      : options_(std::move(options)) {}
+
+  StatusOr<std::unique_ptr<PjRtLoadedExecutable>> Compile(
+      PjRtClient* client, const XlaComputation& computation,
+      CompileOptions options);
+
+  // Returns the key under which the executable of `computation` compiled by
+  // `client` is cached.
+  static StatusOr<std::string> GetKey(const PjRtClient& client,
+                                      const XlaComputation& computation,
+                                      const CompileOptions& options);
+
+  // Returns the total size of the serialized executables kept in memory.
+  int64_t memory_bytes() const;
+
+ private:
+  using SerializedExecutable = std::shared_ptr<const std::string>;
+
+  // A compilation that other callers with the same key wait for.
+  struct Flight {
+    absl::Notification done;
+    // Set before `done` is notified. `executable` is null if the compiled
+    // executable could not be serialized.
+    Status status;
+    SerializedExecutable executable;
+  };
+
+  // Compiles or loads from the store the executable for `key`.
+  StatusOr<std::unique_ptr<PjRtLoadedExecutable>> CompileMiss(
+      PjRtClient* client, const XlaComputation& computation,
+      const CompileOptions& options, const std::string& key,
+      SerializedExecutable* executable);
+
+  void InsertInMemoryLocked(const std::string& key,
+                            SerializedExecutable executable)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const PjRtExecutableCacheOptions options_;
+
+  mutable absl::Mutex mu_;
+  struct CachedExecutable {
+    SerializedExecutable executable;
+    std::list<std::string>::iterator lru_it;
+  };
+  absl::flat_hash_map<std::string, CachedExecutable> cache_
+      ABSL_GUARDED_BY(mu_);
+  // Keys of `cache_`, from the most to the least recently used.
+  std::list<std::string> lru_ ABSL_GUARDED_BY(mu_);
+  int64_t memory_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  absl::flat_hash_map<std::string, std::shared_ptr<Flight>> flights_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace xla
+
+#endif  // XLA_PJRT_PJRT_EXECUTABLE_CACHE_H_
@@ -0,0 +1,238 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/pjrt/pjrt_executable_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/client/xla_computation.h"
+#include "xla/debug_options_flags.h"
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/pjrt/tfrt_cpu_pjrt_client.h"
+#include "xla/service/hlo_parser.h"
+#include "xla/tests/literal_test_util.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla {
+namespace {
+
+constexpr char kProgram[] = R"(HloModule Constant
+ENTRY Constant {
+  ROOT %constant = f32[] constant(2)
+})";
+
+// Keeps executables in memory and counts the calls.
+class CountingStore : public PjRtExecutableCacheStore {
+ public:
+  StatusOr<std::optional<std::string>> Lookup(const std::string& key) override {
+    absl::MutexLock lock(&mu_);
+    ++num_lookups;
+    auto it = executables_.find(key);
+    if (it == executables_.end()) return std::nullopt;
+    return std::optional<std::string>(it->second);
+  }
+
+  Status Insert(const std::string& key,
+                const std::string& serialized_executable) override {
+    absl::MutexLock lock(&mu_);
+    ++num_inserts;
+    executables_[key] = serialized_executable;
+    return OkStatus();
+  }
+
+  int num_lookups = 0;
+  int num_inserts = 0;
+
+ private:
+  absl::Mutex mu_;
+  absl::flat_hash_map<std::string, std::string> executables_;
+};
+
+XlaComputation GetComputation() {
+  auto module = ParseAndReturnUnverifiedModule(kProgram, {});
+  CHECK_OK(module.status());
+  return XlaComputation((*module)->ToProto());
+}
+
+void ExpectComputesConstant(PjRtLoadedExecutable& executable) {
+  TF_ASSERT_OK_AND_ASSIGN(auto result, executable.Execute({{}}, {}));
+  ASSERT_EQ(result.size(), 1);
+  ASSERT_EQ(result[0].size(), 1);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> literal,
+                          result[0][0]->ToLiteralSync());
+  EXPECT_TRUE(
+      LiteralTestUtil::Equal(LiteralUtil::CreateR0<float>(2), *literal));
+}
+
+TEST(PjRtExecutableCacheTest, KeyDependsOnComputationAndOptions) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  XlaComputation computation = GetComputation();
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string key,
+      PjRtExecutableCache::GetKey(*client, computation, CompileOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string same_key,
+      PjRtExecutableCache::GetKey(*client, GetComputation(), CompileOptions()));
+  EXPECT_EQ(key, same_key);
+
+  CompileOptions other_options;
+  other_options.executable_build_options.set_num_replicas(2);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string other_key,
+      PjRtExecutableCache::GetKey(*client, computation, other_options));
+  EXPECT_NE(key, other_key);
+}
+
+TEST(PjRtExecutableCacheTest, KeyDependsOnDefaultDebugOptions) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  XlaComputation computation = GetComputation();
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string key,
+      PjRtExecutableCache::GetKey(*client, computation, CompileOptions()));
+
+  // Options with debug options that differ from the ones of the flags.
+  CompileOptions options;
+  *options.executable_build_options.mutable_debug_options() =
+      GetDebugOptionsFromFlags();
+  options.executable_build_options.mutable_debug_options()
+      ->set_xla_backend_optimization_level(
+          GetDebugOptionsFromFlags().xla_backend_optimization_level() + 1);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string other_key,
+      PjRtExecutableCache::GetKey(*client, computation, options));
+  EXPECT_NE(key, other_key);
+}
+
+TEST(PjRtExecutableCacheTest, KeyDependsOnAddressableDevices) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client,
+                          GetTfrtCpuClient(/*asynchronous=*/true,
+                                           /*cpu_device_count=*/1));
+  TF_ASSERT_OK_AND_ASSIGN(auto other_client,
+                          GetTfrtCpuClient(/*asynchronous=*/true,
+                                           /*cpu_device_count=*/2));
+  XlaComputation computation = GetComputation();
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string key,
+      PjRtExecutableCache::GetKey(*client, computation, CompileOptions()));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::string other_key,
+      PjRtExecutableCache::GetKey(*other_client, computation,
+                                  CompileOptions()));
+  EXPECT_NE(key, other_key);
+}
+
+TEST(PjRtExecutableCacheTest, ConcurrentCompilationsCompileOnce) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  auto store = std::make_shared<CountingStore>();
+  PjRtExecutableCache cache({/*max_memory_bytes=*/int64_t{1} << 30, store});
+  XlaComputation computation = GetComputation();
+
+  constexpr int kNumThreads = 8;
+  std::vector<std::unique_ptr<PjRtLoadedExecutable>> executables(kNumThreads);
+  {
+    tsl::thread::ThreadPool pool(tsl::Env::Default(), "compile", kNumThreads);
+    absl::BlockingCounter ready(kNumThreads);
+    for (int i = 0; i < kNumThreads; ++i) {
+      pool.Schedule([&, i] {
+        // Start all the compilations at about the same time.
+        ready.DecrementCount();
+        ready.Wait();
+        StatusOr<std::unique_ptr<PjRtLoadedExecutable>> executable =
+            cache.Compile(client.get(), computation, CompileOptions());
+        TF_EXPECT_OK(executable.status());
+        if (executable.ok()) executables[i] = *std::move(executable);
+      });
+    }
+  }
+  for (std::unique_ptr<PjRtLoadedExecutable>& executable : executables) {
+    ASSERT_NE(executable, nullptr);
+    ExpectComputesConstant(*executable);
+  }
+  // Only the first compilation missed the in-memory cache.
+  EXPECT_EQ(store->num_lookups, 1);
+  EXPECT_EQ(store->num_inserts, 1);
+}
+
+TEST(PjRtExecutableCacheTest, HitsInMemoryAndThenInStore) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  auto store = std::make_shared<CountingStore>();
+  XlaComputation computation = GetComputation();
+
+  PjRtExecutableCache cache({/*max_memory_bytes=*/int64_t{1} << 30, store});
+  for (int i = 0; i < 2; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto executable,
+        cache.Compile(client.get(), computation, CompileOptions()));
+    ExpectComputesConstant(*executable);
+  }
+  EXPECT_EQ(store->num_lookups, 1);
+  EXPECT_EQ(store->num_inserts, 1);
+  EXPECT_GT(cache.memory_bytes(), 0);
+
+  // A separate cache models a restarted process sharing the store.
+  PjRtExecutableCache other_cache({/*max_memory_bytes=*/int64_t{1} << 30,
+                                   store});
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto executable,
+      other_cache.Compile(client.get(), computation, CompileOptions()));
+  ExpectComputesConstant(*executable);
+  EXPECT_EQ(store->num_lookups, 2);
+  EXPECT_EQ(store->num_inserts, 1);
+}
+
+TEST(PjRtExecutableCacheTest, EvictsToStayWithinMemoryBudget) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  auto store = std::make_shared<CountingStore>();
+  PjRtExecutableCache cache({/*max_memory_bytes=*/0, store});
+  for (int i = 0; i < 2; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto executable,
+        cache.Compile(client.get(), GetComputation(), CompileOptions()));
+    ExpectComputesConstant(*executable);
+  }
+  EXPECT_EQ(cache.memory_bytes(), 0);
+  EXPECT_EQ(store->num_lookups, 2);
+  EXPECT_EQ(store->num_inserts, 1);
+}
+
+TEST(PjRtExecutableCacheTest, DirectoryStore) {
+  DirectoryPjRtExecutableCacheStore store(
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "executable_cache"));
+  TF_ASSERT_OK_AND_ASSIGN(std::optional<std::string> missing,
+                          store.Lookup("key"));
+  EXPECT_EQ(missing, std::nullopt);
+  TF_ASSERT_OK(store.Insert("key", "executable"));
+  TF_ASSERT_OK_AND_ASSIGN(std::optional<std::string> found,
+                          store.Lookup("key"));
+  EXPECT_EQ(found, "executable");
+}
+
+}  // namespace
+}  // namespace xla
@@ -71,6 +71,8 @@ TEST(ExecuteOptionsTest, Serialization) {
   src.strict_shape_checking = true;
   src.execution_mode = ExecuteOptions::ExecutionMode::kAsynchronous;
   src.non_donatable_input_indices = {2, 3};
+  src.priority = ExecuteOptions::ExecutionPriority::kLatencyCritical;
+  src.donate_may_alias_inputs_only_if_unreferenced = true;
 
   TF_ASSERT_OK_AND_ASSIGN(ExecuteOptionsProto proto, src.ToProto());
   TF_ASSERT_OK_AND_ASSIGN(ExecuteOptions output,
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <functional>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
@@ -141,16 +142,16 @@ class PjRtFuture {
 
   PjRtFuture() = default;
 
-  bool IsValid() const { return promise_ref_ != nullptr; }
+  bool IsValid() const {
+    return promise_ref_ != nullptr || available_value_.has_value();
+  }
 
   // Constructor for an already-available PjRtFuture.
   //
   // Typically used to eagerly return error values when async work will not
-  // be enqueued, e.g., due to invalid arguments.
-  explicit PjRtFuture(T t)
-      : promise_ref_(tsl::MakeAvailableAsyncValueRef<T>(std::move(t))),
-        on_block_start_([]() { return PjRtFutureHelpers::ProfilingKeys(); }),
-        on_block_end_([](PjRtFutureHelpers::ProfilingKeys) {}) {}
+  // be enqueued, e.g., due to invalid arguments. The value is stored in the
+  // future itself, without allocating an AsyncValue.
+  explicit PjRtFuture(T t) : available_value_(std::move(t)) {}
 
   // Constructor used by clients that natively use TFRT and already have a
   // host_ctx that should be used for awaiting promises.
@@ -193,7 +194,7 @@ class PjRtFuture {
   // network message on some backends.
   bool IsReady() {
     CHECK(IsValid());
-    return promise_ref_.IsAvailable();
+    return available_value_.has_value() || promise_ref_.IsAvailable();
   }
   // `IsKnownReady()` is guaranteed to return immediately. `IsKnownReady()` will
   // always return true if a call to `Await()` has already returned, or any
@@ -202,13 +203,14 @@ class PjRtFuture {
   // ready before `IsKnownReady()` was called.
   bool IsKnownReady() {
     CHECK(IsValid());
-    return promise_ref_.IsAvailable();
+    return available_value_.has_value() || promise_ref_.IsAvailable();
   }
 
   // Blocks the calling thread until the promise is ready, then returns the
   // final value.
   T Await() {
     CHECK(IsValid());
+    if (available_value_.has_value()) return *available_value_;
     if (!promise_ref_.IsAvailable()) {
       const auto keys = on_block_start_();
       BlockUntilReady(promise_ref_.GetAsyncValue());
@@ -227,6 +229,15 @@ class PjRtFuture {
   // client-owned threadpool.
   void OnReady(absl::AnyInvocable<void(T) &&> callback) {
     CHECK(IsValid());
+    if (available_value_.has_value()) {
+      if constexpr (std::is_copy_constructible_v<T>) {
+        std::move(callback)(*available_value_);
+      } else {
+        // As below, only one waiter may be registered for non-copyable types.
+        std::move(callback)(std::move(*available_value_));
+      }
+      return;
+    }
     promise_ref_.AndThen([promise = promise_ref_.AsPtr(),
                           callback = std::move(callback)]() mutable {
       DCHECK(promise.IsConcrete());
@@ -249,14 +260,17 @@ class PjRtFuture {
   // has no effect.
   void AssertHappensBefore(ScopedAsyncTrackingEvent* event) {
     CHECK(IsValid());
-    if (event) {
+    // An available future can't delay the event.
+    if (event && !available_value_.has_value()) {
       event->AddDependency(promise_ref_.CopyRCRef());
     }
   }
 
  private:
-  // Wrapped object to wait on.
+  // Wrapped object to wait on. Null if `available_value_` is set.
   tsl::AsyncValueRef<T> promise_ref_;
+  // The value of a future constructed as available.
+  std::optional<T> available_value_;
   // Function that is called before a thread starts blocking on the promise.
   PjRtFutureHelpers::OnBlockStartFn on_block_start_;
   // Function that is called after a thread finishes blocking on the promise.
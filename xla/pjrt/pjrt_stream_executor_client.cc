@@ -65,6 +65,7 @@ limitations under the License.
 #include "xla/pjrt/pjrt_stream_executor_client.h"
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -96,9 +97,11 @@ limitations under the License.
 #include "xla/cpu_function_runtime.h"
 #include "xla/executable_run_options.h"
 #include "xla/layout.h"
+#include "xla/layout_util.h"
 #include "xla/literal.h"
 #include "xla/pjrt/distributed/protocol.pb.h"
 #include "xla/pjrt/event_pool.h"
+#include "xla/pjrt/execution_admission_queue.h"
 #include "xla/pjrt/local_device_state.h"
 #include "xla/pjrt/metrics.h"
 #include "xla/pjrt/mlir_to_hlo.h"
@@ -737,7 +740,8 @@ PjRtStreamExecutorBuffer::DonateWithControlDependency(
   // definition event.
   new_buffer =
       std::unique_ptr<PjRtBuffer>(std::make_unique<PjRtStreamExecutorBuffer>(
-          on_device_shape(), std::move(new_device_buffer), client(), device()));
+          on_device_shape(), std::move(new_device_buffer), client(), device(),
+          memory_space_));
 
   PjRtStreamExecutorDevice* device = this->device();
   LocalDeviceState* local_device = device->local_device_state();
@@ -759,6 +763,77 @@ PjRtStreamExecutorBuffer::DonateWithControlDependency(
   return new_buffer;
 }
 
+namespace {
+
+// Size of the pinned chunks that large host-to-device transfers are staged
+// through.
+constexpr int64_t kStagingChunkSize = 4 << 20;
+
+// Host arrays up to this size are packed into a single transfer by
+// BuffersFromHostBuffers.
+constexpr int64_t kMaxPackedHostBufferSize = 256 << 10;
+
+// Returns a view of `size` bytes at `offset` in `memory`.
+se::DeviceMemoryBase DeviceMemorySlice(const se::DeviceMemoryBase& memory,
+                                       int64_t offset, int64_t size) {
+  return se::DeviceMemoryBase(static_cast<char*>(memory.opaque()) + offset,
+                              size);
+}
+
+// Enqueues a copy of `size` bytes at `data` to `dst` on the host-to-device
+// stream of `local_device`, staged through two pinned chunks: while one chunk
+// is transferred, the next one is filled on the host.
+void TransferThroughChunkedStaging(LocalDeviceState* local_device,
+                                   tsl::Allocator* host_memory_allocator,
+                                   const void* data, int64_t size,
+                                   const se::DeviceMemoryBase& dst) {
+  se::Stream* stream = local_device->host_to_device_stream();
+  struct Chunk {
+    std::shared_ptr<void> staging_buffer;
+    // Notified once the last transfer out of `staging_buffer` completed.
+    std::shared_ptr<absl::Notification> transferred;
+  };
+  std::array<Chunk, 2> chunks;
+  for (Chunk& chunk : chunks) {
+    void* ptr = host_memory_allocator->AllocateRaw(
+        tsl::Allocator::kAllocatorAlignment, kStagingChunkSize);
+    chunk.staging_buffer = std::shared_ptr<void>(
+        ptr, [host_memory_allocator](void* ptr) {
+          host_memory_allocator->DeallocateRaw(ptr);
+        });
+  }
+  for (int64_t offset = 0, i = 0; offset < size;
+       offset += kStagingChunkSize, ++i) {
+    Chunk& chunk = chunks[i % chunks.size()];
+    if (chunk.transferred) {
+      chunk.transferred->WaitForNotification();
+    }
+    int64_t chunk_size = std::min(kStagingChunkSize, size - offset);
+    std::memcpy(chunk.staging_buffer.get(),
+                static_cast<const char*>(data) + offset, chunk_size);
+    se::DeviceMemoryBase chunk_dst = DeviceMemorySlice(dst, offset, chunk_size);
+    stream->ThenMemcpy(&chunk_dst, chunk.staging_buffer.get(), chunk_size);
+    chunk.transferred = std::make_shared<absl::Notification>();
+    local_device->ThenExecuteCallback(
+        stream, [staging_buffer = chunk.staging_buffer,
+                 transferred = chunk.transferred]() { transferred->Notify(); });
+  }
+}
+
+// Returns the number of bytes of array data in a literal of `shape`.
+int64_t LiteralArrayBytes(const Shape& shape) {
+  int64_t bytes = 0;
+  ShapeUtil::ForEachSubshape(
+      shape, [&](const Shape& subshape, const ShapeIndex& /*index*/) {
+        if (subshape.IsArray()) {
+          bytes += ShapeUtil::ByteSizeOf(subshape);
+        }
+      });
+  return bytes;
+}
+
+}  // namespace
+
 StatusOr<std::unique_ptr<PjRtBuffer>>
 PjRtStreamExecutorClient::BufferFromHostBuffer(
     const void* data, PrimitiveType type, absl::Span<int64_t const> dims,
@@ -783,6 +858,7 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
     byte_strides = tmp_strides;
   }
   int64_t size = ShapeUtil::ByteSizeOf(device_shape);
+  metrics::ReportHostToDeviceTransferBytes(size);
 
   TransferManager* transfer_manager = client()->backend().transfer_manager();
   if (device_layout != nullptr) {
@@ -861,12 +937,22 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
       py_buffer->GetBufferWithUsageHold());
   CHECK(device_buffer.ok());
 
+  // Large transfers that don't need a transpose and may read the host buffer
+  // after returning are staged through two pinned chunks rather than a pinned
+  // copy of the whole buffer, so that the host-side copy overlaps the DMA.
+  bool chunked_staging =
+      host_buffer_semantics != HostBufferSemantics::kImmutableOnlyDuringCall &&
+      should_stage_host_to_device_transfers() &&
+      host_and_device_strides_equal && size >= 2 * kStagingChunkSize &&
+      transfer_manager->GetByteSizeRequirement(device_shape) == size;
+
   // If necessary, allocate a host-side buffer for staging host-to-device
   // transfers. On GPU this is a buffer in pinned memory.
   std::shared_ptr<void> staging_buffer;
-  if (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall ||
-      should_stage_host_to_device_transfers() ||
-      !host_and_device_strides_equal) {
+  if (!chunked_staging &&
+      (host_buffer_semantics == HostBufferSemantics::kImmutableOnlyDuringCall ||
+       should_stage_host_to_device_transfers() ||
+       !host_and_device_strides_equal)) {
     void* ptr = host_memory_allocator()->AllocateRaw(
         tsl::Allocator::kAllocatorAlignment, size);
     staging_buffer = std::shared_ptr<void>(
@@ -916,7 +1002,8 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
        on_device_shape{py_buffer->on_device_shape()},
        staging_buffer{std::move(staging_buffer)},
        on_done_with_host_buffer{std::move(on_done_with_host_buffer)},
-       host_buffer_semantics, transpose{std::move(transpose)}]() {
+       host_buffer_semantics, transpose{std::move(transpose)},
+       chunked_staging, host_memory_allocator{host_memory_allocator()}]() {
         PjRtStreamExecutorBuffer::ScopedHold device_buffer(
             movable_device_buffer);
         // This function uses TF_CHECK_OK and value() since we have no way
@@ -929,7 +1016,10 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
         // If applicable on the backend, stage the transfer via host memory
         // allocated via the host_memory_allocator. On GPU, this is pinned
         // memory.
-        if (staging_buffer) {
+        if (chunked_staging) {
+          TransferThroughChunkedStaging(local_device, host_memory_allocator,
+                                        data, size, buffer.root_buffer());
+        } else if (staging_buffer) {
           // If we didn't already copy the input buffer into the staging buffer,
           // do so now.
           if (host_buffer_semantics !=
@@ -992,6 +1082,131 @@ PjRtStreamExecutorClient::BufferFromHostBuffer(
                               device, /*device_layout=*/nullptr);
 }
 
+StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>>
+PjRtStreamExecutorClient::BuffersFromHostBuffers(
+    absl::Span<const HostBuffer> host_buffers,
+    HostBufferSemantics host_buffer_semantics,
+    std::function<void()> on_done_with_host_buffers, PjRtDevice* device) {
+  tsl::profiler::TraceMe traceme(
+      "PjRtStreamExecutorClient::BuffersFromHostBuffers");
+  TF_ASSIGN_OR_RETURN(LocalDeviceState * local_device,
+                      tensorflow::down_cast<PjRtStreamExecutorDevice*>(device)
+                          ->GetLocalDeviceState());
+  TransferManager* transfer_manager = client()->backend().transfer_manager();
+  bool is_cpu_platform =
+      local_device->executor()->platform()->id() == se::host::kHostPlatformId;
+
+  // The deleter runs once every transfer dropped its copy of the hold, which
+  // is when the runtime is done with all the host buffers.
+  std::shared_ptr<void> host_buffers_hold(
+      nullptr, [on_done = std::move(on_done_with_host_buffers)](void*) {
+        if (on_done) {
+          on_done();
+        }
+      });
+
+  struct PackedBuffer {
+    int64_t index;
+    Shape device_shape;
+    int64_t offset;
+    int64_t size;
+  };
+  std::vector<PackedBuffer> packed_buffers;
+  int64_t packed_size = 0;
+  std::vector<std::unique_ptr<PjRtBuffer>> buffers(host_buffers.size());
+  for (int64_t i = 0; i < host_buffers.size(); ++i) {
+    const HostBuffer& host_buffer = host_buffers[i];
+    Shape shape = ShapeUtil::MakeShape(host_buffer.type, host_buffer.dims);
+    int64_t size = ShapeUtil::ByteSizeOf(shape);
+    TF_ASSIGN_OR_RETURN(Shape device_shape,
+                        transfer_manager->ChooseCompactLayoutForShape(shape));
+    // Arrays are packed only if their device representation is the plain
+    // row-major copy of the host array.
+    bool can_pack =
+        !is_cpu_platform && size > 0 && size <= kMaxPackedHostBufferSize &&
+        LayoutUtil::IsMonotonicWithDim0Major(device_shape.layout()) &&
+        transfer_manager->GetByteSizeRequirement(device_shape) == size;
+    if (!can_pack) {
+      TF_ASSIGN_OR_RETURN(
+          buffers[i],
+          BufferFromHostBuffer(host_buffer.data, host_buffer.type,
+                               host_buffer.dims, /*byte_strides=*/std::nullopt,
+                               host_buffer_semantics,
+                               [host_buffers_hold]() {}, device));
+      continue;
+    }
+    packed_size =
+        RoundUpTo<int64_t>(packed_size, tsl::Allocator::kAllocatorAlignment);
+    packed_buffers.push_back({i, std::move(device_shape), packed_size, size});
+    packed_size += size;
+  }
+  if (packed_buffers.empty()) {
+    return buffers;
+  }
+
+  // The packed arrays are small, so they are copied into the staging buffer
+  // before returning, regardless of `host_buffer_semantics`.
+  void* ptr = host_memory_allocator()->AllocateRaw(
+      tsl::Allocator::kAllocatorAlignment, packed_size);
+  std::shared_ptr<void> staging_buffer(
+      ptr, [host_memory_allocator = host_memory_allocator()](void* ptr) {
+        host_memory_allocator->DeallocateRaw(ptr);
+      });
+  for (const PackedBuffer& packed_buffer : packed_buffers) {
+    std::memcpy(static_cast<char*>(staging_buffer.get()) + packed_buffer.offset,
+                host_buffers[packed_buffer.index].data, packed_buffer.size);
+  }
+
+  TF_ASSIGN_OR_RETURN(
+      se::OwningDeviceMemory allocation,
+      allocator()->Allocate(local_device->device_ordinal(), packed_size));
+  // The allocation is freed once all the buffers viewing it are deleted.
+  auto device_memory =
+      std::make_shared<se::OwningDeviceMemory>(std::move(allocation));
+  se::DeviceMemoryBase dst = device_memory->cref();
+
+  se::Stream* stream = local_device->host_to_device_stream();
+  if (local_device->allocation_model() ==
+      LocalDeviceState::kComputeSynchronized) {
+    stream->ThenWaitFor(local_device->compute_stream());
+  }
+  stream->ThenMemcpy(&dst, staging_buffer.get(), packed_size);
+  auto definition_event = std::make_shared<BufferSequencingEvent>(thread_pool());
+  StatusOr<EventPool::Handle> event_or =
+      local_device->event_pool().ThenAllocateAndRecordEvent(stream);
+  if (!event_or.ok()) {
+    StallStreamOnError(local_device, stream);
+    return event_or.status();
+  }
+  definition_event->SetSequencingEvent(std::move(event_or).value(), stream);
+
+  // The buffers that must be kept alive until the copy completes are released
+  // together with the staging buffer, by a single host callback.
+  std::vector<std::shared_ptr<TrackedDeviceBuffer>> buffers_to_release;
+  for (PackedBuffer& packed_buffer : packed_buffers) {
+    auto device_buffer = std::make_shared<TrackedDeviceBuffer>(
+        /*allocator=*/nullptr, local_device->device_ordinal(),
+        std::initializer_list<se::DeviceMemoryBase>{DeviceMemorySlice(
+            dst, packed_buffer.offset, packed_buffer.size)},
+        std::initializer_list<std::shared_ptr<BufferSequencingEvent>>{
+            definition_event},
+        /*on_delete_callback=*/[device_memory]() {});
+    // The allocation is shared with the other packed buffers, so it can't be
+    // handed over to an execution that donates one of them.
+    auto buffer = std::make_unique<PjRtStreamExecutorBuffer>(
+        std::move(packed_buffer.device_shape), std::move(device_buffer), this,
+        device, /*memory_space=*/nullptr, /*donatable=*/false);
+    RecordUsage(buffer->GetBufferWithUsageHold(), local_device, local_device,
+                definition_event, stream,
+                /*prefer_to_retain_reference=*/false, &buffers_to_release);
+    buffers[packed_buffer.index] = std::move(buffer);
+  }
+  local_device->ThenExecuteCallback(
+      stream, [staging_buffer = std::move(staging_buffer),
+               buffers_to_release = std::move(buffers_to_release)]() {});
+  return buffers;
+}
+
 StatusOr<std::unique_ptr<PjRtBuffer>>
 PjRtStreamExecutorClient::CreateUninitializedBuffer(const Shape& shape,
                                                     PjRtDevice* device) {
@@ -1046,6 +1261,7 @@ PjRtStreamExecutorClient::BufferFromHostLiteral(const LiteralSlice& literal,
   TF_ASSIGN_OR_RETURN(LocalDeviceState * local_device,
                       tensorflow::down_cast<PjRtStreamExecutorDevice*>(device)
                           ->GetLocalDeviceState());
+  metrics::ReportHostToDeviceTransferBytes(LiteralArrayBytes(literal.shape()));
 
   TransferManager* transfer_manager = client()->backend().transfer_manager();
   TF_ASSIGN_OR_RETURN(
@@ -1266,10 +1482,13 @@ absl::Span<PjRtMemorySpace* const> PjRtStreamExecutorClient::memory_spaces()
 
 PjRtStreamExecutorBuffer::PjRtStreamExecutorBuffer(
     Shape on_device_shape, std::shared_ptr<TrackedDeviceBuffer> device_buffer,
-    PjRtClient* client, PjRtDevice* device)
+    PjRtClient* client, PjRtDevice* device, PjRtMemorySpace* memory_space,
+    bool donatable)
     : client_(tensorflow::down_cast<PjRtStreamExecutorClient*>(client)),
       on_device_shape_(std::move(on_device_shape)),
       device_(tensorflow::down_cast<PjRtStreamExecutorDevice*>(device)),
+      memory_space_(memory_space),
+      donatable_(donatable),
       device_buffer_(std::move(device_buffer)) {
   for (int i = 0; i < ScopedHold::Type::kMaxValue; ++i) {
     holds_[i] = 0;
@@ -1283,6 +1502,13 @@ PjRtStreamExecutorBuffer::~PjRtStreamExecutorBuffer() {
   }
 }
 
+PjRtMemorySpace* PjRtStreamExecutorBuffer::memory_space() const {
+  if (memory_space_ != nullptr) return memory_space_;
+  StatusOr<PjRtMemorySpace*> default_memory_space =
+      device_->default_memory_space();
+  return default_memory_space.ok() ? *default_memory_space : nullptr;
+}
+
 void PjRtStreamExecutorBuffer::WaitForOutstandingUsageHolds() {
   auto not_in_usage_hold = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
     return holds_[ScopedHold::kUsage] == 0;
@@ -1348,11 +1574,18 @@ PjRtStreamExecutorBuffer::Release(bool wait_for_operations_to_complete) {
         // already wait for. Based on our heuristics this rare case should only
         // occur when a buffer was copied to a device and then never used there.
         // In that case we get a new stream and use it to hold onto a reference
-        // to the buffer until the events are complete.
+        // to the buffer until the events are complete, unless frees are
+        // ordered on the compute stream, in which case it is enough for the
+        // compute stream to wait for the events.
         if (!stream_and_event.reference_held &&
             !stream_and_event.event->DefinedOn(
                 local_device_state->compute_stream()) &&
             !stream_and_event.event->IsComplete()) {
+          if (local_device_state->order_frees_on_compute_stream()) {
+            stream_and_event.event->WaitForEventOnStream(
+                local_device_state->compute_stream());
+            continue;
+          }
           if (block_stream == nullptr) {
             block_stream = local_device_state->BorrowStreamFromPool();
           }
@@ -1396,6 +1629,17 @@ PjRtStreamExecutorBuffer::GetBufferForHoldLocked(ScopedHold::Type type) {
       return InvalidArgument(
           "Donation requested for buffer with external reference");
     }
+    if (memory_space_ != nullptr) {
+      return InvalidArgument(
+          "Donation requested for buffer in memory space %s, only buffers in "
+          "the default memory space of their device can be donated",
+          memory_space_->DebugString());
+    }
+    if (!donatable_) {
+      return InvalidArgument(
+          "Donation requested for buffer that shares its allocation with "
+          "other buffers");
+    }
     // First add the donation hold.
     ++holds_[type];
     // Then wait for any usage holds to be dropped or converted. No new usage
@@ -1483,6 +1727,8 @@ PjRtFuture<Status> PjRtStreamExecutorBuffer::ToLiteral(
     AcquireHoldLocked(&device_buffer);
   }
 
+  metrics::ReportDeviceToHostTransferBytes(LiteralArrayBytes(literal->shape()));
+
   auto promise = PjRtFuture<Status>::CreatePromise();
   auto usage_event =
       std::make_shared<BufferSequencingEvent>(client_->thread_pool());
@@ -1492,6 +1738,16 @@ PjRtFuture<Status> PjRtStreamExecutorBuffer::ToLiteral(
 
   auto tracked_device_buffer = device_buffer.buffer();
 
+  // Copies into pageable memory are staged by the driver and block the
+  // stream, so arrays are transferred through pinned memory when the client
+  // has it. The host memory allocator pools the staging buffers.
+  tsl::Allocator* staging_allocator =
+      client_->should_stage_host_to_device_transfers() &&
+              literal->shape().IsArray() && on_device_shape_.is_static() &&
+              literal->size_bytes() > 0
+          ? client_->host_memory_allocator()
+          : nullptr;
+
   // When using the ComputeSynchronized allocation model, retain a
   // reference to the device_buffer until the copy completes, to
   // ensure that the buffer isn't deleted or donated while it is still
@@ -1508,7 +1764,7 @@ PjRtFuture<Status> PjRtStreamExecutorBuffer::ToLiteral(
   auto async_to_literal = [usage_event, tracked_device_buffer, stream,
                            transfer_manager = std::move(transfer_manager),
                            on_device_shape{on_device_shape_}, literal, promise,
-                           local_device]() mutable {
+                           local_device, staging_allocator]() mutable {
     StatusOr<EventPool::Handle> event_or =
         local_device->event_pool().AllocateEvent(stream->parent());
     if (!event_or.ok()) {
@@ -1536,9 +1792,32 @@ PjRtFuture<Status> PjRtStreamExecutorBuffer::ToLiteral(
             ? &transfer_metadata
             : nullptr;
 
+    MutableLiteralBase* transfer_literal = literal;
+    std::shared_ptr<void> staging_buffer;
+    std::shared_ptr<MutableBorrowingLiteral> staging_literal;
+    if (staging_allocator != nullptr) {
+      if (void* ptr = staging_allocator->AllocateRaw(
+              tsl::Allocator::kAllocatorAlignment, literal->size_bytes())) {
+        staging_buffer =
+            std::shared_ptr<void>(ptr, [staging_allocator](void* ptr) {
+              staging_allocator->DeallocateRaw(ptr);
+            });
+        staging_literal = std::make_shared<MutableBorrowingLiteral>(
+            static_cast<const char*>(ptr), literal->shape());
+        transfer_literal = staging_literal.get();
+      }
+    }
+
     transfer_manager->TransferLiteralFromDevice(
-        stream, shaped_buffer, literal,
-        [promise](Status status) mutable { promise.Set(status); },
+        stream, shaped_buffer, transfer_literal,
+        [promise, literal, staging_buffer = std::move(staging_buffer),
+         staging_literal = std::move(staging_literal)](Status status) mutable {
+          if (status.ok() && staging_buffer != nullptr) {
+            std::memcpy(literal->untyped_data(), staging_buffer.get(),
+                        literal->size_bytes());
+          }
+          promise.Set(status);
+        },
         transfer_metadata_ptr);
 
     local_device->event_pool().ThenRecordEvent(stream, event_or.value());
@@ -2125,6 +2404,11 @@ Status PjRtStreamExecutorLoadedExecutable::SetUpDonation(bool tuple_inputs) {
                             executable->executable()->module(), tuple_inputs));
     parameters_that_must_be_donated_.emplace_back(
         std::move(parameters_to_donate));
+    TF_ASSIGN_OR_RETURN(std::vector<int> optional_donations,
+                        ComputeParametersThatMayBeDonated(
+                            executable->executable()->module(), tuple_inputs));
+    parameters_that_may_be_donated_.emplace_back(
+        std::move(optional_donations));
   }
   return OkStatus();
 }
@@ -2144,6 +2428,13 @@ PjRtStreamExecutorLoadedExecutable::ParametersThatMustBeDonated(
   return parameters_that_must_be_donated_[executable_idx];
 }
 
+bool PjRtStreamExecutorLoadedExecutable::DonationIsOptional(
+    int executable_idx, int parameter) const {
+  return executable_idx < parameters_that_may_be_donated_.size() &&
+         absl::c_binary_search(parameters_that_may_be_donated_[executable_idx],
+                               parameter);
+}
+
 StatusOr<std::vector<ExecutionInput>>
 PjRtStreamExecutorLoadedExecutable::MakeExecutionInputsAndWaitForEvents(
     int device_ordinal, const ExecuteOptions& options,
@@ -2368,6 +2659,30 @@ class StreamExecutorCopyToDeviceStream : public CopyToDeviceStream {
   // operation, and the event will be recorded on the stream.
   AsyncValueRef<se::Event> done_;
 };
+
+// Maps an execution priority to an ExecutionAdmissionQueue priority, where
+// larger values are admitted first.
+int AdmissionPriority(ExecuteOptions::ExecutionPriority priority) {
+  switch (priority) {
+    case ExecuteOptions::ExecutionPriority::kLatencyCritical:
+      return 1;
+    case ExecuteOptions::ExecutionPriority::kBatch:
+      return -1;
+    default:
+      return 0;
+  }
+}
+
+int64_t ArgumentSizeInBytes(
+    absl::Span<const PjRtStreamExecutorBuffer::ScopedHold> device_buffers) {
+  int64_t size = 0;
+  for (const PjRtStreamExecutorBuffer::ScopedHold& hold : device_buffers) {
+    for (const se::DeviceMemoryBase& memory : hold->device_memory()) {
+      size += memory.size();
+    }
+  }
+  return size;
+}
 }  // namespace
 
 static RecvDeviceMemoryFunction ConvertRecvCallbacksToRecvFunction(
@@ -2454,6 +2769,17 @@ PjRtStreamExecutorLoadedExecutable::EnqueueExecution(
   auto donate_it = donated_params.begin();
   absl::flat_hash_set<PjRtStreamExecutorBuffer*> used_buffers;
   absl::flat_hash_set<PjRtStreamExecutorBuffer*> donated_buffers;
+  // Buffers passed as several arguments, whose optional donations are skipped
+  // whether the donated argument comes first or not.
+  absl::flat_hash_set<PjRtBuffer*> repeated_buffers;
+  if (options.donate_may_alias_inputs_only_if_unreferenced) {
+    absl::flat_hash_set<PjRtBuffer*> seen_buffers;
+    for (PjRtBuffer* handle : argument_handles) {
+      if (!seen_buffers.insert(handle).second) {
+        repeated_buffers.insert(handle);
+      }
+    }
+  }
   for (int i = 0; i < argument_handles.size(); ++i) {
     auto* handle =
         tensorflow::down_cast<PjRtStreamExecutorBuffer*>(argument_handles[i]);
@@ -2470,7 +2796,14 @@ PjRtStreamExecutorLoadedExecutable::EnqueueExecution(
     if (must_donate) {
       ++donate_it;
     }
+    const bool optional_donation =
+        must_donate && options.donate_may_alias_inputs_only_if_unreferenced &&
+        DonationIsOptional(executable_idx, i);
     bool already_used = !used_buffers.emplace(handle).second;
+    if (optional_donation && repeated_buffers.contains(handle)) {
+      // The buffer is also read by this execution: keep it.
+      must_donate = false;
+    }
     bool already_donated =
         must_donate ? !donated_buffers.emplace(handle).second
                     : donated_buffers.find(handle) != donated_buffers.end();
@@ -2496,6 +2829,17 @@ PjRtStreamExecutorLoadedExecutable::EnqueueExecution(
     device_buffers->emplace_back(handle->GetBufferWithHold(
         must_donate ? PjRtStreamExecutorBuffer::ScopedHold::kDonation
                     : PjRtStreamExecutorBuffer::ScopedHold::kUsage));
+    if (must_donate && optional_donation && !device_buffers->back().ok()) {
+      // The buffer can't be donated, e.g. because it is externally referenced.
+      // Reading it is enough as its outputs only may alias it.
+      VLOG(2) << "Not donating argument " << i << ": "
+              << device_buffers->back().status();
+      device_buffers->pop_back();
+      donated_buffers.erase(handle);
+      must_donate = false;
+      device_buffers->emplace_back(handle->GetBufferWithHold(
+          PjRtStreamExecutorBuffer::ScopedHold::kUsage));
+    }
     PjRtStreamExecutorBuffer::ScopedHold& device_buffer =
         device_buffers->back();
     if (!device_buffer.ok()) {
@@ -2577,11 +2921,16 @@ PjRtStreamExecutorLoadedExecutable::EnqueueExecution(
   // too far, not for correctness. Placing it before the executable launch
   // allows the inputs for the next executable to be fetched even if the
   // launch is delayed.
-  std::shared_ptr<Semaphore::ScopedReservation> compute_reservation;
+  //
+  // Executions are admitted in priority order, and the size of their arguments
+  // counts against the device's limit of bytes in flight.
+  std::shared_ptr<ExecutionAdmissionQueue::Ticket> compute_reservation;
   {
     tsl::profiler::TraceMe traceme("ComputeSemaphoreAcquire");
-    compute_reservation = std::make_shared<Semaphore::ScopedReservation>(
-        device_state->compute_semaphore().ScopedAcquire(1));
+    compute_reservation = std::make_shared<ExecutionAdmissionQueue::Ticket>(
+        device_state->execution_admission_queue().Admit(
+            AdmissionPriority(options.priority),
+            ArgumentSizeInBytes(*device_buffers)));
   }
 
   StatusOr<ExecutionOutput> result_buffer_or_status =
@@ -2758,6 +3107,15 @@ PjRtStreamExecutorLoadedExecutable::ExecuteHelper(
     }
   }
 
+  if (metrics::ShouldSampleExecution()) {
+    compute_callbacks.push_back(
+        [executable_name = std::string(name()), start_time_usecs]() {
+          metrics::ReportExecutableStepTime(
+              executable_name,
+              tsl::Env::Default()->NowMicros() - start_time_usecs);
+        });
+  }
+
   std::optional<PjRtFuture<Status>> future;
   if (fill_future) {
     auto promise = PjRtFuture<Status>::CreatePromise();
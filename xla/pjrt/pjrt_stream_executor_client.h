@@ -291,6 +291,26 @@ class PjRtStreamExecutorClient : public PjRtClient {
       std::function<void()> on_done_with_host_buffer,
       PjRtDevice* device) override;
 
+  // A dense, major-to-minor host array to be transferred by
+  // BuffersFromHostBuffers.
+  struct HostBuffer {
+    const void* data;
+    PrimitiveType type;
+    absl::Span<int64_t const> dims;
+  };
+
+  // Transfers many host arrays to `device` at once. Small arrays are packed
+  // into a single staging buffer and copied to the device with one transfer;
+  // the returned buffers are views of one device allocation, which is freed
+  // once all of them are deleted, and can't be donated. Larger arrays are
+  // transferred as by BufferFromHostBuffer. `on_done_with_host_buffers` is
+  // called once the runtime no longer needs any of the host arrays, following
+  // `host_buffer_semantics`.
+  StatusOr<std::vector<std::unique_ptr<PjRtBuffer>>> BuffersFromHostBuffers(
+      absl::Span<const HostBuffer> host_buffers,
+      HostBufferSemantics host_buffer_semantics,
+      std::function<void()> on_done_with_host_buffers, PjRtDevice* device);
+
   StatusOr<std::unique_ptr<PjRtBuffer>> BufferFromHostLiteral(
       const LiteralSlice& literal, PjRtDevice* device) override;
 
@@ -379,6 +399,11 @@ class PjRtStreamExecutorClient : public PjRtClient {
         Unimplemented("Raw copies to host not implemented."));
   }
 
+  virtual StatusOr<std::unique_ptr<PjRtBuffer>> CopyBufferToMemorySpace(
+      PjRtBuffer* buffer, PjRtMemorySpace* dst_memory_space) {
+    return Unimplemented("Copies to memory spaces not implemented.");
+  }
+
   // Helper function for creating PjRtStreamExecutorExecutables. Modifies
   // `options` in-place.
   struct ExecutableExtras {
@@ -606,9 +631,16 @@ class PjRtStreamExecutorBuffer : public PjRtBuffer {
     std::shared_ptr<TrackedDeviceBuffer> buffer_;
   };
 
+  // `memory_space` is null for buffers in the memory of `device`, which is its
+  // default memory space if the client has memory spaces. Buffers in other
+  // memory spaces can't be donated, as their memory isn't owned by the device
+  // allocator that frees donated buffers. Neither can buffers that aren't
+  // `donatable`, such as views of an allocation shared with other buffers.
   PjRtStreamExecutorBuffer(Shape on_device_shape,
                            std::shared_ptr<TrackedDeviceBuffer> device_buffer,
-                           PjRtClient* client, PjRtDevice* device);
+                           PjRtClient* client, PjRtDevice* device,
+                           PjRtMemorySpace* memory_space = nullptr,
+                           bool donatable = true);
   ~PjRtStreamExecutorBuffer() override;
 
   PjRtStreamExecutorBuffer(const PjRtStreamExecutorBuffer&) = delete;
@@ -618,7 +650,7 @@ class PjRtStreamExecutorBuffer : public PjRtBuffer {
 
   const Shape& on_device_shape() const override { return on_device_shape_; }
   StatusOr<Shape> logical_on_device_shape() override;
-  PjRtMemorySpace* memory_space() const override { return nullptr; }
+  PjRtMemorySpace* memory_space() const override;
   PjRtStreamExecutorDevice* device() const override { return device_; }
   PjRtPlatformId platform_id() const { return client_->platform_id(); }
   absl::string_view platform_name() const { return client_->platform_name(); }
@@ -674,7 +706,7 @@ class PjRtStreamExecutorBuffer : public PjRtBuffer {
 
   StatusOr<std::unique_ptr<PjRtBuffer>> CopyToMemorySpace(
       PjRtMemorySpace* dst_memory_space) override {
-    return Unimplemented("Implement CopyToMemorySpace");
+    return client_->CopyBufferToMemorySpace(this, dst_memory_space);
   }
 
   void CopyToRemoteDevice(
@@ -761,6 +793,8 @@ class PjRtStreamExecutorBuffer : public PjRtBuffer {
   PjRtStreamExecutorClient* const client_;
   const Shape on_device_shape_;
   PjRtStreamExecutorDevice* const device_;
+  PjRtMemorySpace* const memory_space_;
+  const bool donatable_;
 
   mutable absl::Mutex mu_;
   std::shared_ptr<TrackedDeviceBuffer> device_buffer_ ABSL_GUARDED_BY(mu_);
@@ -893,6 +927,11 @@ class PjRtStreamExecutorLoadedExecutable : public PjRtLoadedExecutable {
   virtual absl::Span<int const> ParametersThatMustBeDonated(
       int executable_idx) const;
 
+  // Returns whether the donation of `parameter`, one of the parameters that
+  // must be donated, may be skipped: it is only may-aliased to outputs, so the
+  // executable can write them to new buffers.
+  bool DonationIsOptional(int executable_idx, int parameter) const;
+
   virtual StatusOr<std::vector<ExecutionInput>>
   MakeExecutionInputsAndWaitForEvents(
       int device_ordinal, const ExecuteOptions& options,
@@ -935,6 +974,10 @@ class PjRtStreamExecutorLoadedExecutable : public PjRtLoadedExecutable {
   // Per-executable sorted vector of parameters that have any aliased buffers
   // and thus must be donated when executing the computation.
   std::vector<std::vector<int>> parameters_that_must_be_donated_;
+  // Per-executable sorted vector of parameters whose buffers are only
+  // may-aliased, see
+  // ExecuteOptions::donate_may_alias_inputs_only_if_unreferenced.
+  std::vector<std::vector<int>> parameters_that_may_be_donated_;
   std::shared_ptr<DeviceAssignment> device_assignment_;
   CompileOptions compile_options_;
 
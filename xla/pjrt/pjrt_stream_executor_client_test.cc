@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "xla/pjrt/pjrt_stream_executor_client.h"
 
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,6 +31,7 @@ limitations under the License.
 #include "xla/literal.h"
 #include "xla/literal_comparison.h"
 #include "xla/literal_util.h"
+#include "xla/pjrt/local_device_state.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_future.h"
 #include "xla/service/platform_util.h"
@@ -42,7 +46,8 @@ limitations under the License.
 namespace xla {
 namespace {
 
-xla::StatusOr<std::unique_ptr<PjRtStreamExecutorClient>> GetClient() {
+xla::StatusOr<std::unique_ptr<PjRtStreamExecutorClient>> GetClient(
+    int64_t max_inflight_bytes = std::numeric_limits<int64_t>::max()) {
   LocalClient* local_client = xla::ClientLibrary::LocalClientOrDie();
   TF_ASSIGN_OR_RETURN(se::Platform * platform,
                       PlatformUtil::GetPlatform("Host"));
@@ -53,7 +58,9 @@ xla::StatusOr<std::unique_ptr<PjRtStreamExecutorClient>> GetClient() {
   auto device_state = std::make_unique<LocalDeviceState>(
       executor, local_client, LocalDeviceState::kSynchronous,
       /*max_inflight_computations=*/32,
-      /*allow_event_reuse=*/false, /*use_callback_stream=*/false);
+      /*allow_event_reuse=*/false, /*use_callback_stream=*/false,
+      /*device_ordinal=*/-1, /*stream_options=*/std::nullopt,
+      max_inflight_bytes);
   auto device = std::make_unique<PjRtStreamExecutorDevice>(
       0, std::move(device_state), "cpu");
   std::vector<std::unique_ptr<PjRtStreamExecutorDevice>> devices;
@@ -84,7 +91,8 @@ StatusOr<std::unique_ptr<PjRtLoadedExecutable>> ToyExecutable(
 }
 
 Status ExecuteWithSameInputBuffer(
-    absl::AnyInvocable<void(XlaBuilder&)> set_up_aliases) {
+    absl::AnyInvocable<void(XlaBuilder&)> set_up_aliases,
+    const ExecuteOptions& options = {}) {
   auto shape = xla::ShapeUtil::MakeScalarShape(xla::F32);
   TF_ASSIGN_OR_RETURN(auto client, GetClient());
   TF_ASSIGN_OR_RETURN(auto* device0, client->LookupDevice(0));
@@ -92,7 +100,7 @@ Status ExecuteWithSameInputBuffer(
                       client->CreateUninitializedBuffer(shape, device0));
   TF_ASSIGN_OR_RETURN(auto executable,
                       ToyExecutable(*client, shape, std::move(set_up_aliases)));
-  return executable->Execute({{buffer.get(), buffer.get()}}, /*options=*/{})
+  return executable->Execute({{buffer.get(), buffer.get()}}, options)
       .status();
 }
 
@@ -123,6 +131,57 @@ TEST(PjRtStreamExecutorClientTest, DonateSameBufferTwice) {
               ::testing::HasSubstr("f(donate(a), donate(a))"));
 }
 
+TEST(PjRtStreamExecutorClientTest, SkipDonationOfReferencedMayAliasInput) {
+  ExecuteOptions options;
+  options.donate_may_alias_inputs_only_if_unreferenced = true;
+
+  // f(a, donate(a)) reads `a` without donating it.
+  TF_EXPECT_OK(ExecuteWithSameInputBuffer(
+      [](XlaBuilder& builder) { builder.SetUpAlias({0}, 1, {}); }, options));
+
+  // So does f(donate(a), a), where the donated argument comes first.
+  TF_EXPECT_OK(ExecuteWithSameInputBuffer(
+      [](XlaBuilder& builder) { builder.SetUpAlias({0}, 0, {}); }, options));
+
+  // Must-alias inputs are still donated.
+  auto status = ExecuteWithSameInputBuffer(
+      [](XlaBuilder& builder) {
+        builder.SetUpAlias({0}, 1, {},
+                           HloInputOutputAliasConfig::AliasKind::kMustAlias);
+      },
+      options);
+  ASSERT_FALSE(status.ok());
+  EXPECT_THAT(status.message(), ::testing::HasSubstr("f(a, donate(a))"));
+}
+
+TEST(PjRtStreamExecutorClientTest, AdmitsExecutionsOverMaxInflightBytes) {
+  constexpr int64_t kMaxInflightBytes = 4;
+  auto shape = xla::ShapeUtil::MakeShape(xla::F32, {16});
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetClient(kMaxInflightBytes));
+  TF_ASSERT_OK_AND_ASSIGN(auto* device0, client->LookupDevice(0));
+  LocalDeviceState* device_state =
+      static_cast<PjRtStreamExecutorDevice*>(device0)->local_device_state();
+  EXPECT_EQ(device_state->execution_admission_queue().max_inflight_bytes(),
+            kMaxInflightBytes);
+
+  TF_ASSERT_OK_AND_ASSIGN(auto buffer,
+                          client->CreateUninitializedBuffer(shape, device0));
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto executable,
+      ToyExecutable(*client, shape, [](XlaBuilder& builder) {}));
+  // Each execution references more bytes than the limit, so it is admitted
+  // once nothing else is in flight instead of blocking forever.
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto results, executable->Execute({{buffer.get(), buffer.get()}},
+                                          /*options=*/{}));
+    ASSERT_EQ(results.size(), 1);
+    for (const auto& result : results[0]) {
+      TF_ASSERT_OK(result->GetReadyFuture().Await());
+    }
+  }
+}
+
 TEST(PjRtStreamExecutorClientTest, DonateWithControlDependency) {
   TF_ASSERT_OK_AND_ASSIGN(auto client, GetClient());
   auto literal = LiteralUtil::CreateR2({{1, 2, 3}, {4, 5, 6}});
@@ -161,5 +220,33 @@ TEST(PjRtStreamExecutorClientTest, DonateWithControlDependency) {
   TF_ASSERT_OK(literal_comparison::Equal(literal, *result_literal));
 }
 
+TEST(PjRtStreamExecutorClientTest, BuffersFromHostBuffers) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetClient());
+  TF_ASSERT_OK_AND_ASSIGN(auto* device0, client->LookupDevice(0));
+
+  std::vector<float> a = {1, 2, 3, 4, 5, 6};
+  std::vector<int32_t> b = {7, 8, 9};
+  std::vector<int64_t> a_dims = {2, 3};
+  std::vector<int64_t> b_dims = {3};
+  int done_count = 0;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::unique_ptr<PjRtBuffer>> buffers,
+      client->BuffersFromHostBuffers(
+          {{a.data(), F32, a_dims}, {b.data(), S32, b_dims}},
+          PjRtClient::HostBufferSemantics::kImmutableOnlyDuringCall,
+          [&done_count]() { ++done_count; }, device0));
+  EXPECT_EQ(done_count, 1);
+  ASSERT_EQ(buffers.size(), 2);
+
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> a_literal,
+                          buffers[0]->ToLiteralSync());
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> b_literal,
+                          buffers[1]->ToLiteralSync());
+  TF_ASSERT_OK(literal_comparison::Equal(
+      LiteralUtil::CreateR2<float>({{1, 2, 3}, {4, 5, 6}}), *a_literal));
+  TF_ASSERT_OK(literal_comparison::Equal(
+      LiteralUtil::CreateR1<int32_t>({7, 8, 9}), *b_literal));
+}
+
 }  // namespace
 }  // namespace xla
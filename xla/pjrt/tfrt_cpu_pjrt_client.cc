@@ -114,7 +114,7 @@ StatusOr<std::unique_ptr<TfrtCpuBuffer>> AllocateDestinationBuffer(
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<TrackedTfrtCpuDeviceBuffer> tracked_device_buffer,
       AbstractTfrtCpuBuffer::AllocateTrackedDeviceBuffer(
-          on_device_shape, std::move(definition_events)));
+          on_device_shape, std::move(definition_events), device->numa_node()));
   return std::make_unique<TfrtCpuBuffer>(
       on_device_shape, std::move(tracked_device_buffer), client, device);
 }
@@ -253,8 +253,10 @@ absl::string_view TfrtCpuDeviceDescription::ToString() const {
   return to_string_;
 }
 
-TfrtCpuDevice::TfrtCpuDevice(int id, int max_inflight_computations)
+TfrtCpuDevice::TfrtCpuDevice(int id, int max_inflight_computations,
+                             int numa_node)
     : description_(id),
+      numa_node_(numa_node),
       max_inflight_computations_semaphore_(
           /*capacity=*/max_inflight_computations) {}
 
@@ -282,11 +284,25 @@ static int CpuDeviceCount() {
 }
 
 static StatusOr<std::vector<std::unique_ptr<TfrtCpuDevice>>> GetTfrtCpuDevices(
-    int cpu_device_count, int max_inflight_computations_per_device) {
+    int cpu_device_count, int max_inflight_computations_per_device,
+    bool numa_aware) {
+  // Devices are spread over the NUMA nodes in contiguous blocks, so that
+  // devices with neighboring ids (which usually exchange the most data) share
+  // a node.
+  int num_numa_nodes = numa_aware && tsl::port::NUMAEnabled()
+                           ? tsl::port::NUMANumNodes()
+                           : 1;
+  if (num_numa_nodes > 1) {
+    LOG(INFO) << "Placing " << cpu_device_count << " CPU devices on "
+              << num_numa_nodes << " NUMA nodes.";
+  }
   std::vector<std::unique_ptr<TfrtCpuDevice>> devices;
   for (int i = 0; i < cpu_device_count; ++i) {
+    int numa_node = num_numa_nodes > 1
+                        ? i * num_numa_nodes / cpu_device_count
+                        : tsl::port::kNUMANoAffinity;
     auto device = std::make_unique<TfrtCpuDevice>(
-        /*id=*/i, max_inflight_computations_per_device);
+        /*id=*/i, max_inflight_computations_per_device, numa_node);
     devices.push_back(std::move(device));
   }
   return std::move(devices);
@@ -294,13 +310,14 @@ static StatusOr<std::vector<std::unique_ptr<TfrtCpuDevice>>> GetTfrtCpuDevices(
 
 StatusOr<std::unique_ptr<PjRtClient>> GetTfrtCpuClient(
     bool asynchronous, int cpu_device_count,
-    int max_inflight_computations_per_device) {
+    int max_inflight_computations_per_device, bool numa_aware) {
   // Need at least CpuDeviceCount threads to launch one collective.
   size_t num_threads = std::max(DefaultThreadPoolSize(), cpu_device_count);
 
-  TF_ASSIGN_OR_RETURN(std::vector<std::unique_ptr<TfrtCpuDevice>> devices,
-                      GetTfrtCpuDevices(cpu_device_count,
-                                        max_inflight_computations_per_device));
+  TF_ASSIGN_OR_RETURN(
+      std::vector<std::unique_ptr<TfrtCpuDevice>> devices,
+      GetTfrtCpuDevices(cpu_device_count, max_inflight_computations_per_device,
+                        numa_aware));
 
   return std::unique_ptr<PjRtClient>(std::make_unique<TfrtCpuClient>(
       /*process_index=*/0, std::move(devices), num_threads));
@@ -346,9 +363,56 @@ TfrtCpuClient::TfrtCpuClient(
   for (int idx = 0; idx < addressable_devices_.size(); ++idx) {
     CHECK(addressable_devices_[idx] != nullptr) << idx;
   }
+
+  // Give each NUMA node hosting devices its own pinned thread pools, so that
+  // computations and the pages they first touch stay on the node.
+  absl::flat_hash_map<int, int> numa_node_device_counts;
+  for (PjRtDevice* device : addressable_devices_) {
+    int numa_node = tensorflow::down_cast<TfrtCpuDevice*>(device)->numa_node();
+    if (numa_node != tsl::port::kNUMANoAffinity) {
+      ++numa_node_device_counts[numa_node];
+    }
+  }
+  for (const auto& [numa_node, device_count] : numa_node_device_counts) {
+    tsl::ThreadOptions thread_options;
+    thread_options.numa_node = numa_node;
+    int num_node_threads = std::max<int>(
+        1, DefaultThreadPoolSize() / numa_node_device_counts.size());
+    NumaNodeThreadPools& pools = numa_node_thread_pools_[numa_node];
+    // Like the client-wide pool, this needs at least one thread per device on
+    // the node to launch one collective.
+    pools.execute_pool = std::make_unique<tsl::thread::ThreadPool>(
+        tsl::Env::Default(), thread_options,
+        absl::StrCat("XLATfrtCpuClientNuma", numa_node),
+        std::max(num_node_threads, device_count));
+    pools.eigen_intraop_pool = std::make_unique<tsl::thread::ThreadPool>(
+        tsl::Env::Default(), thread_options,
+        absl::StrCat("XLAEigenNuma", numa_node), num_node_threads);
+    pools.eigen_intraop_device = std::make_unique<Eigen::ThreadPoolDevice>(
+        pools.eigen_intraop_pool->AsEigenThreadPool(),
+        pools.eigen_intraop_pool->NumThreads());
+  }
   LOG(INFO) << "TfrtCpuClient created.";
 }
 
+tsl::thread::ThreadPool* TfrtCpuClient::execute_thread_pool(
+    const TfrtCpuDevice& device) const {
+  auto it = numa_node_thread_pools_.find(device.numa_node());
+  if (it == numa_node_thread_pools_.end()) {
+    return pjrt_client_thread_pool_.get();
+  }
+  return it->second.execute_pool.get();
+}
+
+Eigen::ThreadPoolDevice* TfrtCpuClient::eigen_intraop_device(
+    const TfrtCpuDevice& device) const {
+  auto it = numa_node_thread_pools_.find(device.numa_node());
+  if (it == numa_node_thread_pools_.end()) {
+    return eigen_intraop_device_.get();
+  }
+  return it->second.eigen_intraop_device.get();
+}
+
 TfrtCpuClient::~TfrtCpuClient() { LOG(INFO) << "TfrtCpuClient destroyed."; }
 
 StatusOr<PjRtDevice*> TfrtCpuClient::LookupDevice(int device_id) const {
@@ -775,7 +839,8 @@ StatusOr<std::unique_ptr<PjRtBuffer>> TfrtCpuClient::BufferFromHostBuffer(
       AbstractTfrtCpuBuffer::BufferFromHostBufferHelper(
           data, type, dims, byte_strides, host_buffer_semantics,
           std::move(on_done_with_host_buffer), shape, async_work_runner(),
-          &transpose_mu_, &transpose_cache_));
+          &transpose_mu_, &transpose_cache_,
+          tensorflow::down_cast<TfrtCpuDevice*>(device)->numa_node()));
 
   return std::unique_ptr<PjRtBuffer>(std::make_unique<TfrtCpuBuffer>(
       shape, std::move(tracked_device_buffer), this,
@@ -871,13 +936,21 @@ TfrtCpuExecutable::TfrtCpuExecutable(
       addressable_device_logical_ids_(
           std::move(addressable_device_logical_ids)),
       addressable_devices_(std::move(addressable_devices)) {
-  auto hlo_cost_analysis =
-      std::make_unique<HloCostAnalysis>(cpu::CpuExecutable::ShapeSizeBytes);
-  // Cache to avoid std::map lookup in flop_count() on critical path.
-  // The magic constant 1000 is determined by correlating computation with flop
-  // estimate. It is a crude heuristic to find computation less than the thread
-  // context switch time (~5us).
-  cheap_computation_ = hlo_cost_analysis->flop_count() < 1000;
+  // Cache to avoid running the cost analysis on the critical path. If the cost
+  // can't be estimated, conservatively dispatch to the worker pool.
+  const HloModule& module = cpu_executable_->module();
+  HloCostAnalysis hlo_cost_analysis(cpu::CpuExecutable::ShapeSizeBytes);
+  Status cost_analysis_status =
+      module.entry_computation()->Accept(&hlo_cost_analysis);
+  if (cost_analysis_status.ok()) {
+    cheap_computation_ =
+        hlo_cost_analysis.flop_count() <
+        module.config().debug_options().xla_cpu_inline_execution_flop_threshold();
+  } else {
+    VLOG(1) << "Failed to estimate the cost of " << module.name() << ": "
+            << cost_analysis_status;
+    cheap_computation_ = false;
+  }
 
   const auto& computation_layout =
       cpu_executable_->module().entry_computation_layout();
@@ -1074,7 +1147,7 @@ StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
   // This also ensures that the returned `execute_event` dominates all inputs'
   // events, and thus output buffer only need to contain `execute_event` as the
   // single definition event.
-  std::vector<tsl::RCReference<tsl::AsyncValue>> input_deps;
+  absl::InlinedVector<tsl::RCReference<tsl::AsyncValue>, 4> input_deps;
   input_deps.reserve(argument_handles.size());
 
   auto donate_it = parameters_that_must_be_donated_.begin();
@@ -1174,8 +1247,8 @@ StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
   // too far, not for correctness. Placing it before the executable launch
   // allows the inputs for the next executable to be fetched even if the
   // launch is delayed.
-  auto compute_reservation = std::make_unique<Semaphore::ScopedReservation>(
-      device->max_inflight_computations_semaphore().ScopedAcquire(1));
+  Semaphore::ScopedReservation compute_reservation =
+      device->max_inflight_computations_semaphore().ScopedAcquire(1);
 
   // Call the computation function following the calling convention.
   std::vector<void*> buffer_pointers;
@@ -1190,7 +1263,7 @@ StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
   run_options.set_device_ordinal(device->local_hardware_id());
   // Need to keep device_assignment alive until execution completes.
   run_options.set_device_assignment(device_assignment.get());
-  run_options.set_intra_op_thread_pool(client_->eigen_intraop_device());
+  run_options.set_intra_op_thread_pool(client_->eigen_intraop_device(*device));
 
   // Schedule only one collective at a time.
   bool is_a_collective_launch = !!last_collective_launch_event;
@@ -1208,7 +1281,11 @@ StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
     execute_inline = true;
   }
 
-  if (input_deps.empty() && execute_inline) {
+  // Cheap computations whose inputs are all available run on the caller
+  // thread. This avoids the thread hop and the async bookkeeping below, which
+  // can take much longer than the computation itself.
+  execute_inline &= input_deps.empty();
+  if (execute_inline) {
     // Synchronously call generated function.
 
     // Set denormal and rounding behavior to match the default TF
@@ -1253,7 +1330,7 @@ StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
     std::vector<tsl::RCReference<tsl::AsyncValue>> input_deps_avs_copy =
         CopyAsyncValues(input_deps);
     EnqueueWorkWhenReady(
-        client()->pjrt_client_thread_pool(), input_deps,
+        client()->execute_thread_pool(*device), input_deps,
         [cpu_executable, result_buffer,
          buffer_pointers = std::move(buffer_pointers),
          buffer_table = std::move(buffer_table),
@@ -1341,7 +1418,10 @@ StatusOr<PjRtLoadedExecutable::Result> TfrtCpuExecutable::ExecuteHelper(
     res.push_back(std::move(tfrt_output_buffer));
   }
   std::optional<PjRtFuture<Status>> future;
-  if (fill_future) {
+  if (fill_future && execute_inline) {
+    // The computation has completed successfully, errors were returned above.
+    future = PjRtFuture<Status>(OkStatus());
+  } else if (fill_future) {
     auto done_event = tsl::MakeUnconstructedAsyncValueRef<Status>();
     execute_event.AndThen(
         [done_event = done_event.CopyRef(), event = execute_event.CopyRef()]() {
@@ -57,6 +57,7 @@ limitations under the License.
 #include "tsl/concurrency/async_value_ref.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/fingerprint.h"
+#include "tsl/platform/numa.h"
 #include "tsl/platform/threadpool.h"
 
 namespace xla {
@@ -89,7 +90,8 @@ class TfrtCpuDeviceDescription final : public PjRtDeviceDescription {
 
 class TfrtCpuDevice final : public PjRtDevice {
  public:
-  explicit TfrtCpuDevice(int id, int max_inflight_computations = 32);
+  explicit TfrtCpuDevice(int id, int max_inflight_computations = 32,
+                         int numa_node = tsl::port::kNUMANoAffinity);
 
   const TfrtCpuDeviceDescription& description() const override {
     return description_;
@@ -109,6 +111,10 @@ class TfrtCpuDevice final : public PjRtDevice {
   // Used as `device_ordinal`.
   int local_hardware_id() const override { return id(); }
 
+  // The NUMA node the device's computations and buffers are placed on, or
+  // tsl::port::kNUMANoAffinity.
+  int numa_node() const { return numa_node_; }
+
   Status TransferToInfeed(const LiteralSlice& literal) override;
 
   Status TransferFromOutfeed(MutableBorrowingLiteral literal) override;
@@ -130,6 +136,7 @@ class TfrtCpuDevice final : public PjRtDevice {
  private:
   PjRtClient* client_ = nullptr;
   TfrtCpuDeviceDescription description_;
+  int numa_node_;
 
   // TODO(zhangqiaorjc): Optimize semaphore related overhead.
   // Semaphore used to limit how many programs can be enqueued by the host
@@ -269,6 +276,13 @@ class TfrtCpuClient final : public PjRtClient {
     return eigen_intraop_device_.get();
   }
 
+  // Returns the pools used to run computations on `device`, which are pinned
+  // to the device's NUMA node if it has one.
+  tsl::thread::ThreadPool* execute_thread_pool(
+      const TfrtCpuDevice& device) const;
+  Eigen::ThreadPoolDevice* eigen_intraop_device(
+      const TfrtCpuDevice& device) const;
+
   tsl::AsyncValueRef<runtime::CpuEvent> GetLastCollectiveLaunchEvent() {
     absl::MutexLock lock(&mu_);
     return last_collective_launch_event_.CopyRef();
@@ -300,6 +314,14 @@ class TfrtCpuClient final : public PjRtClient {
   std::unique_ptr<tsl::thread::ThreadPool> eigen_intraop_pool_;
   std::unique_ptr<Eigen::ThreadPoolDevice> eigen_intraop_device_;
 
+  // Thread pools pinned to a NUMA node, for the devices placed on that node.
+  struct NumaNodeThreadPools {
+    std::unique_ptr<tsl::thread::ThreadPool> execute_pool;
+    std::unique_ptr<tsl::thread::ThreadPool> eigen_intraop_pool;
+    std::unique_ptr<Eigen::ThreadPoolDevice> eigen_intraop_device;
+  };
+  absl::flat_hash_map<int, NumaNodeThreadPools> numa_node_thread_pools_;
+
   // Launching collectives are prone to deadlock when we use fixed-sized
   // threadpools since ExecuteHelper will block until all replicas reach the
   // barrier. We ensure that
@@ -514,10 +536,13 @@ class TfrtCpuExecutable final : public PjRtLoadedExecutable {
 StatusOr<std::unique_ptr<PjRtClient>> GetTfrtCpuClient(bool asynchronous);
 
 // Similar to the function above, but you can set the number of devices and max
-// number of inflight computations per device explicitly.
+// number of inflight computations per device explicitly. If `numa_aware` is
+// true and the host has several NUMA nodes, the devices are spread over the
+// nodes, and each device runs its computations on threads pinned to its node
+// and allocates large buffers on it.
 StatusOr<std::unique_ptr<PjRtClient>> GetTfrtCpuClient(
     bool asynchronous, int cpu_device_count,
-    int max_inflight_computations_per_device = 32);
+    int max_inflight_computations_per_device = 32, bool numa_aware = false);
 
 }  // namespace xla
 
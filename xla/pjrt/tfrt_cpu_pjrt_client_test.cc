@@ -19,6 +19,8 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstring>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -33,12 +35,15 @@ limitations under the License.
 #include "xla/shape.h"
 #include "xla/shape_util.h"
 #include "xla/status.h"
+#include "xla/tests/literal_test_util.h"
 #include "xla/tests/test_utils.h"
 #include "xla/util.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/casts.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/file_system.h"
+#include "tsl/platform/numa.h"
 #include "tsl/platform/status_matchers.h"
 #include "tsl/platform/statusor.h"
 #include "tsl/platform/test.h"
@@ -96,6 +101,47 @@ ENTRY DonationWithExecutionError() -> f32[2, 2] {
               ::testing::HasSubstr("buffer has been deleted or donated."));
 }
 
+TEST(TfrtCpuClientTest, CheapComputationExecutesInline) {
+  constexpr char kProgram[] = R"(HloModule CheapComputation
+ENTRY CheapComputation {
+  %input = f32[4] parameter(0)
+  ROOT %add = f32[4] add(%input, %input)
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+  TF_ASSERT_OK_AND_ASSIGN(auto pjrt_executable,
+                          client->Compile(xla_computation, {}));
+
+  std::vector<float> data = {1, 2, 3, 4};
+  Shape shape = ShapeUtil::MakeShape(F32, {4});
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      client->BufferFromHostBuffer(
+          data.data(), shape.element_type(), shape.dimensions(),
+          /*byte_strides=*/std::nullopt,
+          PjRtClient::HostBufferSemantics::kImmutableOnlyDuringCall, nullptr,
+          client->addressable_devices()[0]));
+  TF_ASSERT_OK(buffer->GetReadyFuture().Await());
+
+  // All inputs are ready and the computation is cheap, so it completes before
+  // Execute returns.
+  std::optional<std::vector<PjRtFuture<Status>>> futures;
+  futures.emplace();
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto results, pjrt_executable->Execute({{buffer.get()}}, {}, futures));
+  ASSERT_EQ(futures->size(), 1);
+  EXPECT_TRUE((*futures)[0].IsReady());
+  TF_ASSERT_OK((*futures)[0].Await());
+
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> literal,
+                          results[0][0]->ToLiteralSync());
+  EXPECT_TRUE(LiteralTestUtil::Equal(
+      LiteralUtil::CreateR1<float>({2, 4, 6, 8}), *literal));
+}
+
 TEST(TfrtCpuClientTest, HloSnapshot) {
   constexpr char kProgram[] = R"(
     HloModule add
@@ -166,6 +212,59 @@ TEST(TfrtCpuClientTest, HloSnapshot) {
       LiteralUtil::CreateR2<float>({{11.0, 22.0}, {33.0, 44.0}, {55.0, 66.0}}));
 }
 
+TEST(TfrtCpuClientTest, NumaAwareClient) {
+  constexpr char kProgram[] = R"(
+    HloModule add
+    ENTRY add {
+      x = f32[1048576] parameter(0)
+      ROOT add = f32[1048576] add(x, x)
+    })";
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto client,
+      GetTfrtCpuClient(/*asynchronous=*/true,
+                       /*cpu_device_count=*/2,
+                       /*max_inflight_computations_per_device=*/32,
+                       /*numa_aware=*/true));
+  for (PjRtDevice* device : client->addressable_devices()) {
+    int numa_node = tensorflow::down_cast<TfrtCpuDevice*>(device)->numa_node();
+    if (tsl::port::NUMAEnabled() && tsl::port::NUMANumNodes() > 1) {
+      EXPECT_GE(numa_node, 0);
+      EXPECT_LT(numa_node, tsl::port::NUMANumNodes());
+    } else {
+      EXPECT_EQ(numa_node, tsl::port::kNUMANoAffinity);
+    }
+  }
+
+  TF_ASSERT_OK_AND_ASSIGN(auto hlo_module,
+                          ParseAndReturnUnverifiedModule(kProgram, {}));
+  XlaComputation xla_computation(hlo_module->ToProto());
+  CompileOptions options;
+  options.compile_portable_executable = true;
+  TF_ASSERT_OK_AND_ASSIGN(auto pjrt_executable,
+                          client->Compile(xla_computation, options));
+
+  // Large enough to be allocated on the device's NUMA node.
+  std::vector<float> data(1048576, 1.0f);
+  Shape shape = ShapeUtil::MakeShape(F32, {1048576});
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto buffer,
+      client->BufferFromHostBuffer(
+          data.data(), shape.element_type(), shape.dimensions(),
+          /*byte_strides=*/std::nullopt,
+          PjRtClient::HostBufferSemantics::kImmutableOnlyDuringCall, nullptr,
+          client->addressable_devices()[1]));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto result, pjrt_executable->ExecutePortable(
+                       /*argument_handles=*/{buffer.get()},
+                       client->addressable_devices()[1], /*options=*/{}));
+  ASSERT_EQ(result.size(), 1);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Literal> literal,
+                          result[0]->ToLiteralSync());
+  EXPECT_THAT(literal->data<float>(), Each(2.0f));
+}
+
 TEST(TfrtCpuClientTest, AsyncTransferRawData) {
   TF_ASSERT_OK_AND_ASSIGN(auto client, GetTfrtCpuClient(/*asynchronous=*/true));
   xla::Shape shape = ShapeUtil::MakeShape(U32, {3, 2});
@@ -43,15 +43,18 @@ void BufferSequencingEvent::SetSequencingEvent(EventPool::Handle event,
     defined_status_.emplace(OkStatus());
     CHECK(!event_.event());
     event_ = std::move(event);
+    CHECK_EQ(num_cached_streams_.load(std::memory_order_relaxed), 0);
     CHECK(streams_defined_on_.empty());
-    streams_defined_on_.push_back(stream);
+    AddDefinedOn(stream);
     sequence_number_.store(event_.sequence_number(), std::memory_order_seq_cst);
+    // Publishes `event_` to the lock-free readers.
+    state_.store(State::kRecorded, std::memory_order_release);
   }
   this->ExecuteFutureTasks();
 }
 
 bool BufferSequencingEvent::EventHasBeenRecorded() const {
-  return event_.event() != nullptr;
+  return state_.load(std::memory_order_acquire) != State::kPending;
 }
 
 uint64_t BufferSequencingEvent::sequence_number() const {
@@ -59,63 +62,101 @@ uint64_t BufferSequencingEvent::sequence_number() const {
   return seq;
 }
 
-void BufferSequencingEvent::WaitForEventOnStream(se::Stream* stream) {
-  absl::MutexLock lock(&mu_);
+void BufferSequencingEvent::WaitForEventRecorded() {
+  if (EventHasBeenRecorded()) return;
 
   // We cannot wait for an event until ThenRecordEvent has been called; on GPU
   // newly created events are deemed to have already happened past.
+  absl::MutexLock lock(&mu_);
   mu_.Await(
       absl::Condition(this, &BufferSequencingEvent::EventHasBeenRecorded));
+}
+
+bool BufferSequencingEvent::IsCachedDefinedOn(se::Stream* stream,
+                                              bool* complete) const {
+  int num_cached = num_cached_streams_.load(std::memory_order_acquire);
+  if (complete) *complete = num_cached < kMaxCachedStreams;
 
   // The set of defined streams is expected to be very small indeed (usually
   // 1-2), so a simple linear scan should be fast enough.
-  if (std::find(streams_defined_on_.begin(), streams_defined_on_.end(),
+  for (int i = 0; i < num_cached; ++i) {
+    if (cached_streams_[i].load(std::memory_order_relaxed) == stream) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void BufferSequencingEvent::AddDefinedOn(se::Stream* stream) {
+  int num_cached = num_cached_streams_.load(std::memory_order_relaxed);
+  if (num_cached < kMaxCachedStreams) {
+    cached_streams_[num_cached].store(stream, std::memory_order_relaxed);
+    num_cached_streams_.store(num_cached + 1, std::memory_order_release);
+  } else {
+    streams_defined_on_.push_back(stream);
+  }
+}
+
+void BufferSequencingEvent::WaitForEventOnStream(se::Stream* stream) {
+  WaitForEventRecorded();
+
+  // Fast path: the event already occurred, or it is already known to be
+  // defined at the tail of `stream`.
+  if (state_.load(std::memory_order_acquire) == State::kComplete ||
+      IsCachedDefinedOn(stream)) {
+    return;
+  }
+
+  absl::MutexLock lock(&mu_);
+
+  // Check again under the lock, as another thread might have added `stream`
+  // concurrently.
+  if (IsCachedDefinedOn(stream) ||
+      std::find(streams_defined_on_.begin(), streams_defined_on_.end(),
                 stream) != streams_defined_on_.end()) {
     // stream is in streams_defined_on_; it doesn't need to be waited on.
     return;
   }
 
   stream->ThenWaitFor(event_.event());
-  streams_defined_on_.push_back(stream);
+  AddDefinedOn(stream);
 }
 
 Status BufferSequencingEvent::WaitForEventOnExternalStream(
     std::intptr_t stream) {
-  absl::MutexLock lock(&mu_);
-
-  // We cannot wait for an event until ThenRecordEvent has been called; on GPU
-  // newly created events are deemed to have already happened past.
   // TODO(skyewm): do we need this? WaitForEventOnExternalStream is only
   // implemented for GPU.
-  mu_.Await(
-      absl::Condition(this, &BufferSequencingEvent::EventHasBeenRecorded));
+  WaitForEventRecorded();
 
   return event_.event()->WaitForEventOnExternalStream(stream);
 }
 
 bool BufferSequencingEvent::DefinedOn(se::Stream* stream) {
-  absl::MutexLock lock(&mu_);
+  WaitForEventRecorded();
 
-  // We cannot wait for an event until ThenRecordEvent has been called; on GPU
-  // newly created events are deemed to have already happened past.
-  mu_.Await(
-      absl::Condition(this, &BufferSequencingEvent::EventHasBeenRecorded));
+  // An event that has already occurred is defined at the tail of any stream.
+  if (state_.load(std::memory_order_acquire) == State::kComplete) return true;
 
-  // The set of defined streams is expected to be very small indeed (usually
-  // 1-2), so a simple linear scan should be fast enough.
+  bool cache_is_complete = false;
+  if (IsCachedDefinedOn(stream, &cache_is_complete)) return true;
+  if (cache_is_complete) return false;
+
+  absl::MutexLock lock(&mu_);
   return std::find(streams_defined_on_.begin(), streams_defined_on_.end(),
                    stream) != streams_defined_on_.end();
 }
 
 bool BufferSequencingEvent::IsComplete() {
-  absl::MutexLock lock(&mu_);
+  WaitForEventRecorded();
 
-  // We cannot wait for an event until ThenRecordEvent has been called; on
-  // GPU newly created events are deemed to have already happened past.
-  mu_.Await(
-      absl::Condition(this, &BufferSequencingEvent::EventHasBeenRecorded));
+  if (state_.load(std::memory_order_acquire) == State::kComplete) return true;
 
-  return event_.event()->PollForStatus() == se::Event::Status::kComplete;
+  if (event_.event()->PollForStatus() == se::Event::Status::kComplete) {
+    // Completion is final, cache it to skip polling the event next time.
+    state_.store(State::kComplete, std::memory_order_release);
+    return true;
+  }
+  return false;
 }
 
 void BufferSequencingEvent::ExecuteOrAddToFutureTasks(
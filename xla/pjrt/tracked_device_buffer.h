@@ -17,7 +17,9 @@ limitations under the License.
 #define XLA_PJRT_TRACKED_DEVICE_BUFFER_H_
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -60,6 +62,11 @@ namespace xla {
 // The dependency logic caches the set of streams at the tail of which the
 // definition event is known to have occurred; waiting for the same event on the
 // same stream causes no additional waiting.
+//
+// The event state is an atomic state machine (pending -> recorded -> complete)
+// and the first few streams the event is defined on are published in a
+// lock-free cache, so the common queries ("is the event already recorded or
+// complete", "was it already waited for on this stream") don't take a lock.
 class BufferSequencingEvent {
  public:
   explicit BufferSequencingEvent(tsl::thread::ThreadPool* thread_pool)
@@ -122,7 +129,7 @@ class BufferSequencingEvent {
   void ExecuteFutureTasks();
 
   bool IsDefined() {
-    absl::MutexLock lock(&mu_);
+    // AsyncValue state is atomic, so we can check it without taking a lock.
     return defined_status_.IsConcrete();
   }
 
@@ -136,15 +143,40 @@ class BufferSequencingEvent {
   }
 
   Status GetDefinedStatus() {
-    absl::MutexLock lock(&mu_);
+    // Once concrete, the defined status never changes.
     CHECK(defined_status_.IsConcrete());
     return defined_status_.get();
   }
 
  private:
-  bool EventHasBeenRecorded() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Event state transitions: kPending -> kRecorded -> kComplete. The event
+  // handle is immutable once the state is not kPending, and can be read
+  // without holding `mu_`.
+  enum class State : uint8_t {
+    kPending,   // sequencing event is not yet recorded
+    kRecorded,  // sequencing event is recorded on a stream
+    kComplete,  // sequencing event is known by the host to have occurred
+  };
+
+  // Maximum number of streams stored in the lock-free cache of streams the
+  // event is defined on. Additional streams are stored in
+  // `streams_defined_on_` guarded by `mu_`.
+  static constexpr int kMaxCachedStreams = 4;
+
+  bool EventHasBeenRecorded() const;
   uint64_t sequence_number() const;
 
+  // Blocks the calling thread until the sequencing event is recorded.
+  void WaitForEventRecorded();
+
+  // Returns true if `stream` is in the lock-free cache of defined streams. If
+  // `complete` is not null, it is set to true when the cache holds all streams
+  // the event is defined on, i.e. a miss is authoritative.
+  bool IsCachedDefinedOn(se::Stream* stream, bool* complete = nullptr) const;
+
+  // Records that the event is defined on `stream`.
+  void AddDefinedOn(se::Stream* stream) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // An event that is triggered when the content of one or more buffers has been
   // read or written. If this event is used as a definition event and is
   // nullptr, it is assumed that the buffer's content is always defined for
@@ -157,9 +189,17 @@ class BufferSequencingEvent {
   // refactored the EventPool API.
   std::atomic<uint64_t> sequence_number_{0};
 
+  std::atomic<State> state_{State::kPending};
+
+  // A lock-free cache of the first `kMaxCachedStreams` streams for which the
+  // buffer's content is known to be defined at the tail of the queue. Slots are
+  // written under `mu_` and published by incrementing `num_cached_streams_`.
+  std::array<std::atomic<se::Stream*>, kMaxCachedStreams> cached_streams_{};
+  std::atomic<int> num_cached_streams_{0};
+
   mutable absl::Mutex mu_;
-  // A list of all streams for which the buffer's content is known to be defined
-  // at the tail of the queue, i.e., for any newly enqueued command.
+  // A list of all other streams for which the buffer's content is known to be
+  // defined at the tail of the queue, i.e., for any newly enqueued command.
   absl::InlinedVector<se::Stream*, 2> streams_defined_on_ ABSL_GUARDED_BY(mu_);
 
   // A map of the task name and callback to execute when the
@@ -171,8 +211,9 @@ class BufferSequencingEvent {
   tsl::thread::ThreadPool* thread_pool_;
 
   // Indicates if the buffer is in an error status. And error status is used to
-  // propagate the error to the buffer consumers.
-  tsl::AsyncValueRef<Status> defined_status_ ABSL_GUARDED_BY(mu_);
+  // propagate the error to the buffer consumers. Written under `mu_`, but can
+  // be read without it as the AsyncValue state is atomic.
+  tsl::AsyncValueRef<Status> defined_status_;
 };
 
 // Class that represents a tuple of device buffers. Like a ScopedShapedBuffer it
@@ -15,15 +15,23 @@ limitations under the License.
 
 #include "xla/pjrt/tracked_device_buffer.h"
 
+#include <cstddef>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "xla/client/client_library.h"
 #include "xla/literal_util.h"
+#include "xla/pjrt/event_pool.h"
 #include "xla/shape_util.h"
 #include "xla/status_macros.h"
 #include "xla/stream_executor/device_memory_allocator.h"
+#include "xla/stream_executor/stream.h"
 #include "xla/test.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace {
@@ -112,5 +120,46 @@ TEST(TrackedDeviceBufferTest, FromScopedShapedBuffer) {
                     literal.shape())));
 }
 
+TEST(BufferSequencingEventTest, DefinedOnStreams) {
+  LocalClient* client = ClientLibrary::LocalClientOrDie();
+  se::StreamExecutor* executor = client->backend().stream_executor(0).value();
+
+  // More streams than the event caches without taking a lock.
+  std::vector<std::unique_ptr<se::Stream>> streams;
+  for (int i = 0; i < 6; ++i) {
+    streams.push_back(std::make_unique<se::Stream>(executor));
+    streams.back()->Init();
+    ASSERT_TRUE(streams.back()->ok());
+  }
+
+  tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "test", 1);
+  BufferSequencingEvent event(&thread_pool);
+  EXPECT_FALSE(event.IsDefined());
+
+  EventPool event_pool(/*allow_reuse=*/false);
+  TF_ASSERT_OK_AND_ASSIGN(
+      EventPool::Handle handle,
+      event_pool.ThenAllocateAndRecordEvent(streams[0].get()));
+  event.SetSequencingEvent(std::move(handle), streams[0].get());
+  EXPECT_TRUE(event.IsDefined());
+  TF_EXPECT_OK(event.GetDefinedStatus());
+
+  EXPECT_TRUE(event.DefinedOn(streams[0].get()));
+  for (size_t i = 1; i < streams.size(); ++i) {
+    EXPECT_FALSE(event.DefinedOn(streams[i].get()));
+  }
+
+  // Wait on every stream twice: the second wait must be a no-op.
+  for (size_t i = 1; i < streams.size(); ++i) {
+    event.WaitForEventOnStream(streams[i].get());
+    event.WaitForEventOnStream(streams[i].get());
+    EXPECT_TRUE(event.DefinedOn(streams[i].get()));
+  }
+
+  TF_ASSERT_OK(streams[0]->BlockHostUntilDone());
+  EXPECT_TRUE(event.IsComplete());
+  EXPECT_TRUE(event.IsComplete());
+}
+
 }  // namespace
 }  // namespace xla
@@ -29,6 +29,7 @@ limitations under the License.
 #include "tsl/concurrency/async_value_ref.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/mem.h"
+#include "tsl/platform/numa.h"
 #include "tsl/platform/threadpool.h"
 
 namespace xla {
@@ -42,8 +43,7 @@ class MaybeOwningCpuMemory {
       : buf_(buf), size_(size) {}
 
   // Owning.
-  using OwnedDataPtr =
-      std::unique_ptr<uint8_t[], decltype(tsl::port::AlignedFree)*>;
+  using OwnedDataPtr = std::unique_ptr<uint8_t[], std::function<void(void*)>>;
   explicit MaybeOwningCpuMemory(OwnedDataPtr data, size_t size)
       : buf_(data.get()), data_(std::move(data)), size_(size) {}
 
@@ -65,6 +65,29 @@ class MaybeOwningCpuMemory {
         OwnedDataPtr{data, tsl::port::AlignedFree}, size);
   }
 
+  // Owning, placed on `numa_node` if NUMA is supported. Falls back to the
+  // overload above for tsl::port::kNUMANoAffinity and for small allocations,
+  // as NUMA allocations are page granular and comparatively slow.
+  static StatusOr<std::shared_ptr<MaybeOwningCpuMemory>> AllocateShared(
+      size_t size, int numa_node) {
+    constexpr size_t kMinNumaAllocationSize = 1 << 20;
+    if (numa_node == tsl::port::kNUMANoAffinity ||
+        size < kMinNumaAllocationSize || !tsl::port::NUMAEnabled()) {
+      return AllocateShared(size);
+    }
+    uint8_t* data = static_cast<uint8_t*>(tsl::port::NUMAMalloc(
+        numa_node, size, cpu_function_runtime::MinAlign()));
+    if (!data) {
+      return ResourceExhausted(
+          "Out of memory allocating %d bytes on NUMA node %d.", size,
+          numa_node);
+    }
+    return std::make_shared<MaybeOwningCpuMemory>(
+        OwnedDataPtr{data,
+                     [size](void* ptr) { tsl::port::NUMAFree(ptr, size); }},
+        size);
+  }
+
   void* data() const { return buf_; }
   size_t size() const { return size_; }
   bool owns_data() const { return data_ != nullptr; }
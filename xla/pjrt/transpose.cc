@@ -74,6 +74,7 @@ limitations under the License.
 #include <cstdlib>
 #include <cstring>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <stack>
@@ -866,6 +867,304 @@ void TransposePlan::BuildPlanNodes(
   }
 }
 
+namespace {
+
+// Multi-level tilings are handled by splitting each array dimension into
+// sub-dimensions at the boundaries of the inner tiles, such that both the
+// input and the output are single-level tilings of the sub-dimensions, in
+// some order.
+
+// A sub-dimension, or if `tile` is not zero, the part of a sub-dimension that
+// indexes the tiles of size `tile` (`inner` is false) or their interior
+// (`inner` is true).
+struct SubDimPart {
+  int sub_dim;
+  int64_t tile = 0;
+  bool inner = false;
+};
+
+// A dimension of an array with multi-level tiling, as a list of sub-dimension
+// parts in most- to least-significant order.
+using TiledDim = absl::InlinedVector<SubDimPart, 2>;
+
+int64_t SubDimPartSize(const SubDimPart& part,
+                       absl::Span<int64_t const> sub_dim_sizes) {
+  int64_t size = sub_dim_sizes[part.sub_dim];
+  if (part.tile == 0) {
+    return size;
+  }
+  return part.inner ? part.tile : CeilOfRatio(size, part.tile);
+}
+
+// Splits `dim` into the parts indexing its tiles of size `tile` and their
+// interior. The most-significant part of a dimension may be padded to a
+// multiple of the tile size if `allow_padding` is true.
+Status TileDim(const TiledDim& dim, int64_t tile, bool allow_padding,
+               absl::Span<int64_t const> sub_dim_sizes, TiledDim& outer,
+               TiledDim& inner) {
+  int64_t size = 1;
+  size_t pos = dim.size();
+  while (pos > 0 &&
+         size * SubDimPartSize(dim[pos - 1], sub_dim_sizes) <= tile) {
+    size *= SubDimPartSize(dim[pos - 1], sub_dim_sizes);
+    --pos;
+  }
+  if (size == tile) {
+    outer.assign(dim.begin(), dim.begin() + pos);
+    inner.assign(dim.begin() + pos, dim.end());
+    return OkStatus();
+  }
+  if (pos == 0 && !dim.empty()) {
+    // The tile is larger than the dimension.
+    size /= SubDimPartSize(dim[0], sub_dim_sizes);
+    pos = 1;
+  }
+  if (!allow_padding || pos != 1 || dim[0].tile != 0 || tile % size != 0) {
+    return Unimplemented(
+        "Tile size %d is not a multiple of the tile sizes of the inner "
+        "tilings",
+        tile);
+  }
+  outer = {SubDimPart{dim[0].sub_dim, tile / size, /*inner=*/false}};
+  inner = {SubDimPart{dim[0].sub_dim, tile / size, /*inner=*/true}};
+  inner.insert(inner.end(), dim.begin() + 1, dim.end());
+  return OkStatus();
+}
+
+// Computes the tile sizes and the order of the sub-dimensions for which a
+// single-level tiling of the sub-dimensions has the same layout as the
+// multi-level tiling `tilings` of an array with dimensions `dims`. `tiling` is
+// indexed by sub-dimension.
+Status ToSingleLevelTiling(absl::InlinedVector<TiledDim, 4> dims,
+                           absl::Span<absl::Span<int64_t const> const> tilings,
+                           absl::Span<int64_t const> sub_dim_sizes,
+                           std::vector<int>& order,
+                           std::vector<int64_t>& tiling) {
+  for (size_t level = 0; level < tilings.size(); ++level) {
+    absl::Span<int64_t const> level_tiling = tilings[level];
+    if (level_tiling.size() > dims.size() ||
+        (level > 0 && level_tiling.size() > tilings[level - 1].size())) {
+      return InvalidArgument(
+          "Tiling (%s) must have at most as many dimensions as the array and "
+          "the previous level of tiling",
+          absl::StrJoin(level_tiling, ","));
+    }
+    size_t offset = dims.size() - level_tiling.size();
+    absl::InlinedVector<TiledDim, 4> tiled_dims(dims.begin(),
+                                                dims.begin() + offset);
+    absl::InlinedVector<TiledDim, 4> inner_dims;
+    for (size_t i = 0; i < level_tiling.size(); ++i) {
+      if (level_tiling[i] < 1) {
+        return InvalidArgument("Tiling sizes (%s) must be >= 1",
+                               absl::StrJoin(level_tiling, ","));
+      }
+      TiledDim outer, inner;
+      TF_RETURN_IF_ERROR(TileDim(dims[offset + i], level_tiling[i],
+                                 /*allow_padding=*/level == 0, sub_dim_sizes,
+                                 outer, inner));
+      tiled_dims.push_back(std::move(outer));
+      inner_dims.push_back(std::move(inner));
+    }
+    absl::c_move(inner_dims, std::back_inserter(tiled_dims));
+    dims = std::move(tiled_dims);
+  }
+
+  // The order of the sub-dimension parts in memory must be that of a
+  // single-level tiling: first the parts indexing tiles or sub-dimensions
+  // that aren't tiled, and then the parts indexing the interior of tiles or
+  // whole sub-dimensions that are tiles.
+  std::vector<SubDimPart> parts;
+  for (const TiledDim& dim : dims) {
+    parts.insert(parts.end(), dim.begin(), dim.end());
+  }
+  auto is_inner = [](const SubDimPart& p) { return p.tile != 0 && p.inner; };
+  auto is_outer = [](const SubDimPart& p) { return p.tile != 0 && !p.inner; };
+  auto first_inner = absl::c_find_if(parts, is_inner);
+  if (std::find_if(first_inner, parts.end(), is_outer) != parts.end()) {
+    return Unimplemented(
+        "Multi-level tiling is not equivalent to a single-level tiling");
+  }
+  // The partially tiled sub-dimensions must be in the same order in both.
+  absl::Span<SubDimPart const> outer_parts =
+      absl::MakeConstSpan(parts).first(first_inner - parts.begin());
+  absl::Span<SubDimPart const> inner_parts =
+      absl::MakeConstSpan(parts).subspan(outer_parts.size());
+  tiling.assign(sub_dim_sizes.size(), 1);
+  order.clear();
+  auto o = outer_parts.begin();
+  auto i = inner_parts.begin();
+  while (o != outer_parts.end() || i != inner_parts.end()) {
+    for (; o != outer_parts.end() && o->tile == 0; ++o) {
+      order.push_back(o->sub_dim);
+    }
+    for (; i != inner_parts.end() && i->tile == 0; ++i) {
+      order.push_back(i->sub_dim);
+      tiling[i->sub_dim] = sub_dim_sizes[i->sub_dim];
+    }
+    if (o == outer_parts.end() && i == inner_parts.end()) {
+      break;
+    }
+    if (o == outer_parts.end() || i == inner_parts.end() ||
+        o->sub_dim != i->sub_dim) {
+      return Unimplemented(
+          "Multi-level tiling is not equivalent to a single-level tiling");
+    }
+    order.push_back(o->sub_dim);
+    tiling[o->sub_dim] = o->tile;
+    ++o;
+    ++i;
+  }
+  return OkStatus();
+}
+
+// A transpose of the sub-dimensions of an array with multi-level tilings,
+// whose input and output have single-level tilings.
+struct ExpandedTranspose {
+  absl::InlinedVector<int64_t, 4> dims;
+  absl::InlinedVector<int64_t, 4> permutation;
+  absl::InlinedVector<int64_t, 4> input_tiling;
+  absl::InlinedVector<int64_t, 4> input_strides_in_bytes;
+  absl::InlinedVector<int64_t, 4> output_tiling;
+};
+
+StatusOr<ExpandedTranspose> ExpandMultiLevelTilings(
+    absl::Span<int64_t const> dims, absl::Span<int64_t const> permutation,
+    const std::variant<TransposePlan::Tiling, TransposePlan::Striding>&
+        input_layout,
+    const TransposePlan::Tiling& output_tiling) {
+  const int ndim = dims.size();
+  const auto* input_tiling = std::get_if<TransposePlan::Tiling>(&input_layout);
+
+  // Collects the inner tile sizes of each dimension, i.e. the boundaries at
+  // which the dimension has to be split.
+  std::vector<std::vector<int64_t>> split_points(ndim);
+  auto add_split_points =
+      [&](absl::Span<absl::Span<int64_t const> const> inner_tilings,
+          absl::Span<int64_t const> dim_of) {
+        for (absl::Span<int64_t const> level : inner_tilings) {
+          if (level.size() > ndim) {
+            break;  // Diagnosed by ToSingleLevelTiling.
+          }
+          for (size_t i = 0; i < level.size(); ++i) {
+            if (level[i] > 1) {
+              split_points[dim_of[ndim - level.size() + i]].push_back(
+                  level[i]);
+            }
+          }
+        }
+      };
+  absl::InlinedVector<int64_t, 4> identity(ndim);
+  absl::c_iota(identity, 0);
+  if (input_tiling) {
+    add_split_points(input_tiling->inner_tilings, identity);
+  }
+  add_split_points(output_tiling.inner_tilings, permutation);
+
+  // Splits every dimension into sub-dimensions, from most to least
+  // significant.
+  std::vector<int64_t> sub_dim_sizes;
+  absl::InlinedVector<TiledDim, 4> sub_dims(ndim);
+  for (int d = 0; d < ndim; ++d) {
+    std::vector<int64_t>& points = split_points[d];
+    absl::c_sort(points);
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    int64_t inner_size = 1;
+    for (int64_t point : points) {
+      if (point % inner_size != 0 || dims[d] % point != 0) {
+        return Unimplemented(
+            "Inner tile sizes (%s) of dimension %d of size %d must divide "
+            "each other and the dimension size",
+            absl::StrJoin(points, ","), d, dims[d]);
+      }
+      sub_dims[d].insert(sub_dims[d].begin(),
+                         SubDimPart{static_cast<int>(sub_dim_sizes.size())});
+      sub_dim_sizes.push_back(point / inner_size);
+      inner_size = point;
+    }
+    sub_dims[d].insert(sub_dims[d].begin(),
+                       SubDimPart{static_cast<int>(sub_dim_sizes.size())});
+    sub_dim_sizes.push_back(dims[d] / inner_size);
+  }
+
+  auto all_tilings = [](const TransposePlan::Tiling& tiling) {
+    std::vector<absl::Span<int64_t const>> tilings = {tiling.tiling};
+    tilings.insert(tilings.end(), tiling.inner_tilings.begin(),
+                   tiling.inner_tilings.end());
+    return tilings;
+  };
+
+  std::vector<int> input_order;
+  std::vector<int64_t> input_sub_dim_tiling(sub_dim_sizes.size(), 1);
+  std::vector<int64_t> input_sub_dim_strides;
+  if (input_tiling) {
+    TF_RETURN_IF_ERROR(ToSingleLevelTiling(sub_dims, all_tilings(*input_tiling),
+                                           sub_dim_sizes, input_order,
+                                           input_sub_dim_tiling));
+  } else {
+    // Without tiling, the sub-dimensions of a dimension are adjacent.
+    absl::Span<int64_t const> strides =
+        std::get<TransposePlan::Striding>(input_layout).strides_in_bytes;
+    if (strides.size() != ndim) {
+      return InvalidArgument(
+          "dims and input_strides_in_bytes must have equal sizes, got %d "
+          "and %d",
+          ndim, strides.size());
+    }
+    input_sub_dim_strides.resize(sub_dim_sizes.size());
+    for (int d = 0; d < ndim; ++d) {
+      int64_t stride = strides[d];
+      for (auto it = sub_dims[d].rbegin(); it != sub_dims[d].rend(); ++it) {
+        input_sub_dim_strides[it->sub_dim] = stride;
+        stride *= sub_dim_sizes[it->sub_dim];
+      }
+      for (const SubDimPart& part : sub_dims[d]) {
+        input_order.push_back(part.sub_dim);
+      }
+    }
+  }
+
+  absl::InlinedVector<TiledDim, 4> output_sub_dims(ndim);
+  for (int d = 0; d < ndim; ++d) {
+    output_sub_dims[d] = sub_dims[permutation[d]];
+  }
+  std::vector<int> output_order;
+  std::vector<int64_t> output_sub_dim_tiling;
+  TF_RETURN_IF_ERROR(ToSingleLevelTiling(output_sub_dims,
+                                         all_tilings(output_tiling),
+                                         sub_dim_sizes, output_order,
+                                         output_sub_dim_tiling));
+
+  ExpandedTranspose expanded;
+  std::vector<int64_t> position_in_input(sub_dim_sizes.size());
+  for (int i = 0; i < input_order.size(); ++i) {
+    int sub_dim = input_order[i];
+    position_in_input[sub_dim] = i;
+    expanded.dims.push_back(sub_dim_sizes[sub_dim]);
+    if (input_tiling) {
+      expanded.input_tiling.push_back(input_sub_dim_tiling[sub_dim]);
+    } else {
+      expanded.input_strides_in_bytes.push_back(
+          input_sub_dim_strides[sub_dim]);
+    }
+  }
+  for (int sub_dim : output_order) {
+    expanded.permutation.push_back(position_in_input[sub_dim]);
+    expanded.output_tiling.push_back(output_sub_dim_tiling[sub_dim]);
+  }
+  return expanded;
+}
+
+bool HasInnerTilings(
+    const std::variant<TransposePlan::Tiling, TransposePlan::Striding>&
+        input_layout,
+    const TransposePlan::Tiling& output_tiling) {
+  const auto* input_tiling = std::get_if<TransposePlan::Tiling>(&input_layout);
+  return (input_tiling && !input_tiling->inner_tilings.empty()) ||
+         !output_tiling.inner_tilings.empty();
+}
+
+}  // namespace
+
 StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
     size_t elem_size_in_bytes, absl::Span<int64_t const> dims,
     absl::Span<int64_t const> permutation,
@@ -890,6 +1189,34 @@ StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
                            num_threads);
   }
 
+  if (HasInnerTilings(input_layout, output_tiling) &&
+      absl::c_find(dims, 0) == dims.end()) {
+    TF_ASSIGN_OR_RETURN(
+        ExpandedTranspose expanded,
+        ExpandMultiLevelTilings(dims, permutation, input_layout,
+                                output_tiling));
+    std::variant<Tiling, Striding> expanded_input_layout;
+    if (std::holds_alternative<Striding>(input_layout)) {
+      expanded_input_layout = Striding{expanded.input_strides_in_bytes};
+    } else {
+      expanded_input_layout = Tiling{expanded.input_tiling};
+    }
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<TransposePlan> plan,
+        Create(elem_size_in_bytes, expanded.dims, expanded.permutation,
+               expanded_input_layout, Tiling{expanded.output_tiling},
+               transformation, num_threads));
+    // Report the shapes the caller asked for rather than the expanded ones.
+    plan->original_a_dims_.assign(dims.begin(), dims.end());
+    plan->original_b_dims_ = Permute(dims, permutation);
+    if (std::holds_alternative<Striding>(input_layout)) {
+      absl::Span<int64_t const> strides =
+          std::get<Striding>(input_layout).strides_in_bytes;
+      plan->original_a_strides_.assign(strides.begin(), strides.end());
+    }
+    return plan;
+  }
+
   int ndim = dims.size();
 
   auto plan = std::make_unique<TransposePlan>();
@@ -1318,6 +1645,8 @@ bool TransposePlanCacheKey::operator==(
          input_layout_is_tiling == other.input_layout_is_tiling &&
          input_layout == other.input_layout &&
          output_tiling == other.output_tiling &&
+         input_inner_tilings == other.input_inner_tilings &&
+         output_inner_tilings == other.output_inner_tilings &&
          transformation == other.transformation &&
          num_threads == other.num_threads;
 }
@@ -1327,7 +1656,8 @@ H AbslHashValue(H h, const TransposePlanCacheKey& key) {
   return H::combine(std::move(h), key.elem_size_in_bytes,
                     key.input_layout_is_tiling, key.num_threads,
                     key.transformation, key.dims, key.permutation,
-                    key.input_layout, key.output_tiling);
+                    key.input_layout, key.output_tiling,
+                    key.input_inner_tilings, key.output_inner_tilings);
 }
 
 TransposePlanCache::TransposePlanCache(int capacity)
@@ -1362,6 +1692,18 @@ StatusOr<std::shared_ptr<TransposePlan>> TransposePlanCache::GetOrCreate(
   }
   key.output_tiling.resize(output_tiling.tiling.size());
   absl::c_copy(output_tiling.tiling, key.output_tiling.begin());
+  auto copy_inner_tilings =
+      [](absl::Span<absl::Span<int64_t const> const> inner_tilings,
+         std::vector<absl::InlinedVector<int64_t, 4>>& out) {
+        for (absl::Span<int64_t const> tiling : inner_tilings) {
+          out.emplace_back(tiling.begin(), tiling.end());
+        }
+      };
+  if (const auto* input_tiling =
+          std::get_if<TransposePlan::Tiling>(&input_layout)) {
+    copy_inner_tilings(input_tiling->inner_tilings, key.input_inner_tilings);
+  }
+  copy_inner_tilings(output_tiling.inner_tilings, key.output_inner_tilings);
   key.transformation = transformation;
   key.num_threads = num_threads;
   return cache_.GetOrCreateIfAbsent(
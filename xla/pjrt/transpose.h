@@ -34,6 +34,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "xla/pjrt/lru_cache.h"
 #include "xla/statusor.h"
@@ -59,9 +60,16 @@ class TransposePlan {
   //
   // For more information about tiling, see
   // https://www.tensorflow.org/xla/tiled_layout
-  // This class supports a single level of tiling. In addition, the same
-  // dimension currently cannot have different non-trivial tiling values in
-  // both the input and output.
+  // A Tiling may have further levels of tiling in `inner_tilings`, e.g.
+  // the TPU-style tiling (8,128)(2,1) is {{8, 128}, {{2, 1}}}. Each level
+  // tiles the interior of the tiles of the previous level, must have at
+  // most as many dimensions as the previous level and its tile sizes must
+  // divide the tile sizes of the previous level, as well as the sizes of the
+  // corresponding array dimensions. Such transposes are rewritten into
+  // transposes of a higher-rank array with a single level of tiling, by
+  // splitting the array dimensions at the inner tile boundaries.
+  //
+  // Only one of the input and output may be tiled, after this rewrite.
   //
   // The size of the plan may be exponential in the number of non-trivial
   // tiled dimensions. This is acceptable because in the intended use case for
@@ -73,6 +81,8 @@ class TransposePlan {
   //   threads used may be smaller if there isn't enough work per thread.
   struct Tiling {
     absl::Span<int64_t const> tiling;
+    // Second and further levels of tiling, if any.
+    absl::Span<absl::Span<int64_t const> const> inner_tilings;
   };
   struct Striding {
     absl::Span<int64_t const> strides_in_bytes;
@@ -251,6 +261,8 @@ struct TransposePlanCacheKey {
   bool input_layout_is_tiling;
   absl::InlinedVector<int64_t, 4> input_layout;
   absl::InlinedVector<int64_t, 4> output_tiling;
+  std::vector<absl::InlinedVector<int64_t, 4>> input_inner_tilings;
+  std::vector<absl::InlinedVector<int64_t, 4>> output_inner_tilings;
   TransposePlan::Transformation transformation;
   int num_threads;
 
@@ -436,6 +436,157 @@ TEST(TransposeTest, NegativeStrides2D) {
   EXPECT_EQ(expected, output);
 }
 
+// Converts a multidimensional index `indices` into an array with `shape` and
+// the multi-level tiling `tilings` into a linear offset into a buffer, by
+// applying each level of tiling in turn.
+int64_t MultiLevelTiledLinearIndex(
+    std::vector<int64_t> shape,
+    const std::vector<std::vector<int64_t>>& tilings,
+    std::vector<int64_t> indices) {
+  for (const std::vector<int64_t>& tiling : tilings) {
+    size_t offset = shape.size() - tiling.size();
+    std::vector<int64_t> tiled_shape(shape.begin(), shape.begin() + offset);
+    std::vector<int64_t> tiled_indices(indices.begin(),
+                                       indices.begin() + offset);
+    for (size_t i = 0; i < tiling.size(); ++i) {
+      tiled_shape.push_back(CeilOfRatio(shape[offset + i], tiling[i]));
+      tiled_indices.push_back(indices[offset + i] / tiling[i]);
+    }
+    for (size_t i = 0; i < tiling.size(); ++i) {
+      tiled_shape.push_back(tiling[i]);
+      tiled_indices.push_back(indices[offset + i] % tiling[i]);
+    }
+    shape = std::move(tiled_shape);
+    indices = std::move(tiled_indices);
+  }
+  int64_t linear_index = 0;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    linear_index = linear_index * shape[i] + indices[i];
+  }
+  return linear_index;
+}
+
+// Returns the size in elements of an array with multi-level tiling.
+int64_t SizeOfMultiLevelTiledArray(
+    absl::Span<int64_t const> shape,
+    const std::vector<std::vector<int64_t>>& tilings) {
+  std::vector<int64_t> padded_shape(shape.begin(), shape.end());
+  if (!tilings.empty()) {
+    size_t offset = shape.size() - tilings[0].size();
+    for (size_t i = 0; i < tilings[0].size(); ++i) {
+      padded_shape[offset + i] = RoundUpTo(shape[offset + i], tilings[0][i]);
+    }
+  }
+  std::vector<int64_t> max_index(padded_shape.size());
+  absl::c_transform(padded_shape, max_index.begin(),
+                    [](int64_t size) { return size - 1; });
+  return MultiLevelTiledLinearIndex(padded_shape, tilings, max_index) + 1;
+}
+
+struct MultiLevelTilingTestCase {
+  std::vector<int64_t> dims;
+  std::vector<int64_t> permutation;
+  std::vector<std::vector<int64_t>> input_tilings;
+  std::vector<std::vector<int64_t>> output_tilings;
+};
+
+TEST(TransposeTest, MultiLevelTilings) {
+  std::vector<MultiLevelTilingTestCase> cases = {
+      // TPU-style tilings of a 32-bit and of a 16-bit array.
+      {{16, 256}, {1, 0}, {{8, 128}, {2, 1}}, {}},
+      {{32, 256}, {1, 0}, {{16, 128}, {2, 1}}, {}},
+      {{256, 16}, {1, 0}, {}, {{8, 128}, {2, 1}}},
+      // Padded.
+      {{12, 130}, {1, 0}, {{8, 128}, {2, 1}}, {}},
+      {{130, 6}, {1, 0}, {}, {{8, 128}, {2, 1}}},
+      {{140, 2}, {1, 0}, {}, {{8, 128}, {2, 1}}},
+      // More dimensions and levels.
+      {{3, 10, 256}, {0, 2, 1}, {}, {{8, 128}, {2, 1}}},
+      {{4, 24, 20}, {2, 0, 1}, {{8, 8}, {4, 2}, {2, 1}}, {}},
+      {{24, 20, 4}, {1, 0, 2}, {}, {{8, 4}, {2, 2}}},
+      // Identity.
+      {{16, 256}, {0, 1}, {{8, 128}, {2, 1}}, {}},
+  };
+  for (const MultiLevelTilingTestCase& test : cases) {
+    SCOPED_TRACE(absl::StrFormat(
+        "dims=[%s] permutation=[%s]", absl::StrJoin(test.dims, ","),
+        absl::StrJoin(test.permutation, ",")));
+    std::vector<int64_t> output_dims = Permute(test.dims, test.permutation);
+    auto to_tiling = [](const std::vector<std::vector<int64_t>>& tilings,
+                        std::vector<absl::Span<int64_t const>>& inner) {
+      if (tilings.empty()) {
+        return TransposePlan::Tiling{};
+      }
+      inner.assign(tilings.begin() + 1, tilings.end());
+      return TransposePlan::Tiling{tilings[0], inner};
+    };
+    std::vector<absl::Span<int64_t const>> input_inner, output_inner;
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto plan,
+        TransposePlan::Create(sizeof(int32_t), test.dims, test.permutation,
+                              to_tiling(test.input_tilings, input_inner),
+                              to_tiling(test.output_tilings, output_inner)));
+    EXPECT_THAT(plan->InputDims(), testing::ElementsAreArray(test.dims));
+    EXPECT_THAT(plan->OutputDims(), testing::ElementsAreArray(output_dims));
+    EXPECT_EQ(plan->InputNumElems(),
+              SizeOfMultiLevelTiledArray(test.dims, test.input_tilings));
+    EXPECT_EQ(plan->OutputNumElems(),
+              SizeOfMultiLevelTiledArray(output_dims, test.output_tilings));
+
+    std::vector<int32_t> input(plan->InputNumElems(), -1);
+    std::vector<int32_t> expected(plan->OutputNumElems(), -1);
+    std::vector<int64_t> indices(test.dims.size(), 0);
+    int32_t value = 0;
+    do {
+      input[MultiLevelTiledLinearIndex(test.dims, test.input_tilings,
+                                       indices)] = value;
+      expected[MultiLevelTiledLinearIndex(output_dims, test.output_tilings,
+                                          Permute(indices, test.permutation))] =
+          value;
+      ++value;
+    } while (BumpIndices(test.dims, absl::MakeSpan(indices)));
+
+    std::vector<int32_t> output(plan->OutputNumElems(), -1);
+    plan->Execute(input.data(), output.data());
+    EXPECT_EQ(expected, output);
+  }
+}
+
+TEST(TransposeTest, MultiLevelTilingWithStridedInput) {
+  // A transposed view of a [4, 6] array, written with tiling (4, 2)(2, 1).
+  std::vector<int32_t> input(24);
+  absl::c_iota(input, 0);
+  std::vector<int64_t> inner_tiling = {2, 1};
+  std::vector<absl::Span<int64_t const>> inner_tilings = {inner_tiling};
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto plan,
+      TransposePlan::Create(
+          sizeof(int32_t), /*dims=*/{6, 4}, /*permutation=*/{0, 1},
+          TransposePlan::Striding{{sizeof(int32_t), 6 * sizeof(int32_t)}},
+          TransposePlan::Tiling{{4, 2}, inner_tilings}));
+  std::vector<int32_t> output(plan->OutputNumElems(), -1);
+  plan->Execute(input.data(), output.data());
+
+  std::vector<int32_t> expected(output.size(), -1);
+  for (int64_t i = 0; i < 6; ++i) {
+    for (int64_t j = 0; j < 4; ++j) {
+      expected[MultiLevelTiledLinearIndex({6, 4}, {{4, 2}, {2, 1}}, {i, j})] =
+          input[j * 6 + i];
+    }
+  }
+  EXPECT_EQ(expected, output);
+}
+
+TEST(TransposeTest, InvalidMultiLevelTilings) {
+  std::vector<int64_t> inner_tiling = {3, 1};
+  std::vector<absl::Span<int64_t const>> inner_tilings = {inner_tiling};
+  // The dimension size is not a multiple of the inner tile size.
+  auto plan = TransposePlan::Create(
+      sizeof(float), {8, 128}, {1, 0},
+      /*input_layout=*/TransposePlan::Tiling{{8, 128}, inner_tilings});
+  EXPECT_EQ(plan.status().code(), tsl::error::UNIMPLEMENTED);
+}
+
 static std::vector<TransposeTestCase> BenchmarkCases() {
   return std::vector<TransposeTestCase>{
       TransposeTestCase(/*dims=*/{256, 256},
@@ -555,6 +706,22 @@ static void* benchmarks = []() {
   return nullptr;
 }();
 
+TEST(TransposePlanCache, InnerTilingsArePartOfTheKey) {
+  TransposePlanCache cache(2);
+  std::vector<int64_t> inner_tiling = {2, 1};
+  std::vector<absl::Span<int64_t const>> inner_tilings = {inner_tiling};
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto p1, cache.GetOrCreate(/*elem_size_in_bytes=*/4, /*dims=*/{16, 256},
+                                 /*permutation=*/{1, 0},
+                                 TransposePlan::Tiling{{8, 128}}));
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto p2,
+      cache.GetOrCreate(/*elem_size_in_bytes=*/4, /*dims=*/{16, 256},
+                        /*permutation=*/{1, 0},
+                        TransposePlan::Tiling{{8, 128}, inner_tilings}));
+  EXPECT_TRUE(p1.get() != p2.get());
+}
+
 TEST(TransposePlanCache, Basics) {
   TransposePlanCache cache(2);
   TF_ASSERT_OK_AND_ASSIGN(
@@ -19,6 +19,7 @@ limitations under the License.
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <optional>
@@ -286,6 +287,32 @@ StatusOr<std::vector<int>> ComputeParametersThatMustBeDonated(
   return parameters_to_donate;
 }
 
+StatusOr<std::vector<int>> ComputeParametersThatMayBeDonated(
+    const HloModule& module, bool tuple_inputs) {
+  std::vector<int> may_alias;
+  std::vector<int> must_alias;
+  module.input_output_alias_config().ForEachAlias(
+      [&](const ShapeIndex& output_index,
+          const HloInputOutputAliasConfig::Alias& alias) {
+        int parameter = alias.parameter_number;
+        if (tuple_inputs) {
+          if (alias.parameter_index.empty()) {
+            return;
+          }
+          parameter = alias.parameter_index.front();
+        }
+        (alias.must_alias() ? must_alias : may_alias).push_back(parameter);
+      });
+  absl::c_sort(may_alias);
+  absl::c_sort(must_alias);
+  // A parameter must be donated if any of its buffers must alias an output.
+  std::vector<int> parameters;
+  absl::c_set_difference(may_alias, must_alias, std::back_inserter(parameters));
+  parameters.erase(std::unique(parameters.begin(), parameters.end()),
+                   parameters.end());
+  return parameters;
+}
+
 int DefaultThreadPoolSize() {
   // Google's CI system exposes an environment variable NPROC that describes
   // a CPU reservation for tests.
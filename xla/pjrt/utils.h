@@ -61,6 +61,13 @@ Status DetermineArgumentLayoutsFromCompileOptions(
 StatusOr<std::vector<int>> ComputeParametersThatMustBeDonated(
     const HloModule& hlo_module, bool tuple_inputs);
 
+// Returns the sorted subset of ComputeParametersThatMustBeDonated() whose
+// buffers are only may-aliased to outputs. Donating these parameters is an
+// optimization: when they can't be donated, the executable writes the aliased
+// outputs to new buffers instead.
+StatusOr<std::vector<int>> ComputeParametersThatMayBeDonated(
+    const HloModule& module, bool tuple_inputs);
+
 // Return max parallelism level.
 int DefaultThreadPoolSize();
 
@@ -22,12 +22,14 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
 #include "pybind11/numpy.h"  // from @pybind11
 #include "pybind11/pytypes.h"  // from @pybind11
+#include "xla/pjrt/pjrt_client.h"
 #include "xla/primitive_util.h"
 #include "xla/service/custom_call_status.h"
 #include "tsl/platform/statusor.h"
@@ -36,7 +38,8 @@ namespace py = pybind11;
 
 namespace xla {
 
-Status CpuCallback::PrepareAndCallInternal(void* result, void** arg_ptrs) {
+Status CpuCallback::PrepareAndCallInternal(void* result, void** arg_ptrs,
+                                           absl::Span<PjRtChunk> owned_args) {
   absl::Span<void* const> inputs(arg_ptrs, args_.size());
   absl::Span<void* const> outputs(reinterpret_cast<void**>(result),
                                   results_.size());
@@ -51,8 +54,19 @@ Status CpuCallback::PrepareAndCallInternal(void* result, void** arg_ptrs) {
       absl::Span<ssize_t> strides(
           reinterpret_cast<ssize_t*>(args_[i].strides.data()),
           args_[i].strides.size());
-      args[i] = py::array(args_[i].dtype, args_[i].dims, strides,
-                          const_cast<void*>(inputs[i]));
+      if (owned_args.empty()) {
+        // Without a base object pybind11 copies the data, which is required
+        // here as the buffer is only alive for the duration of the call.
+        args[i] = py::array(args_[i].dtype, args_[i].dims, strides,
+                            const_cast<void*>(inputs[i]));
+      } else {
+        auto* chunk = new PjRtChunk(std::move(owned_args[i]));
+        py::capsule base(chunk, [](void* ptr) {
+          delete static_cast<PjRtChunk*>(ptr);
+        });
+        args[i] = py::array(args_[i].dtype, args_[i].dims, strides,
+                            chunk->data(), base);
+      }
       args[i].attr("flags").attr("writeable") = Py_False;
     }
   }
@@ -99,6 +113,15 @@ Status CpuCallback::PrepareAndCall(void* result, void** arg_ptrs) {
   return PrepareAndCallInternal(result, arg_ptrs);
 }
 
+Status CpuCallback::PrepareAndCall(void* result, std::vector<PjRtChunk> args) {
+  std::vector<void*> arg_ptrs;
+  arg_ptrs.reserve(args.size());
+  for (PjRtChunk& arg : args) {
+    arg_ptrs.push_back(arg.data());
+  }
+  return PrepareAndCallInternal(result, arg_ptrs.data(), absl::MakeSpan(args));
+}
+
 StatusOr<py::tuple> CpuCallback::CallInternal(py::tuple args) {
   py::object result_object;
   try {
@@ -20,7 +20,9 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "pybind11/numpy.h"  // from @pybind11
+#include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/transpose.h"
 #include "xla/python/python_ref_manager.h"
 #include "xla/service/custom_call_status.h"
@@ -80,13 +82,20 @@ class CpuCallback {
   void PrepareAndCall(void* result, void** arg_ptrs,
                       XlaCustomCallStatus* status);
   Status PrepareAndCall(void* result, void** arg_ptrs);
+  // Like above, but takes ownership of the argument buffers. The arguments are
+  // passed to Python as read-only NumPy arrays viewing `args` instead of
+  // copies; the buffers are freed once Python drops the last reference.
+  Status PrepareAndCall(void* result, std::vector<PjRtChunk> args);
 
   std::optional<pybind11::tuple> Call(pybind11::tuple args,
                                       XlaCustomCallStatus* status);
   StatusOr<pybind11::tuple> Call(pybind11::tuple args);
 
  private:
-  Status PrepareAndCallInternal(void* result, void** arg_ptrs);
+  // If `owned_args` is non-empty, it holds the buffers `arg_ptrs` point to and
+  // the NumPy arguments are created as views that take ownership of them.
+  Status PrepareAndCallInternal(void* result, void** arg_ptrs,
+                                absl::Span<PjRtChunk> owned_args = {});
   StatusOr<pybind11::tuple> CallInternal(pybind11::tuple args);
 
   pybind11::function callable_;
@@ -183,6 +183,10 @@ StatusOr<PrimitiveType> DLDataTypeToPrimitiveType(DLDataType type) {
   }
 }
 
+// Stream value with which a DLPack consumer signals that the producer must not
+// perform any synchronization.
+constexpr std::intptr_t kDLPackNoSynchronizationStream = -1;
+
 StatusOr<std::vector<int64_t>> StridesToLayout(
     absl::Span<int64_t const> dims, absl::Span<int64_t const> strides) {
   CHECK_EQ(dims.size(), strides.size());
@@ -291,7 +295,10 @@ StatusOr<py::capsule> BufferToDLPackManagedTensor(
     py::gil_scoped_release gil_release;
     TF_ASSIGN_OR_RETURN(pack->external_reference,
                         pjrt_buffer->AcquireExternalReference());
-    if (stream) {
+    if (stream == kDLPackNoSynchronizationStream) {
+      // The consumer asked us not to synchronize; it orders its own work after
+      // the producer's.
+    } else if (stream) {
       TF_RETURN_IF_ERROR(
           pack->external_reference->WaitUntilBufferReadyOnStream(*stream));
     } else {
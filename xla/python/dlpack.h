@@ -31,6 +31,9 @@ namespace xla {
 // stream, if set, is a GPU stream, e.g. cudaStream_t for CUDA GPUs, that should
 // be synchronized to the buffer as per
 // https://dmlc.github.io/dlpack/latest/python_spec.html#python-specification-for-dlpack.
+// The stream waits on the buffer's definition events on the device, without
+// blocking the host. A stream of -1 means that the consumer takes care of
+// synchronization, and the buffer is exported without waiting on it.
 StatusOr<pybind11::capsule> BufferToDLPackManagedTensor(
     pybind11::handle buffer, std::optional<std::intptr_t> stream);
 
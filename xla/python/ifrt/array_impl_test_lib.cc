@@ -30,6 +30,7 @@ namespace xla {
 namespace ifrt {
 namespace {
 
+using ::testing::ElementsAre;
 using ::testing::ElementsAreArray;
 using ::testing::SizeIs;
 
@@ -393,6 +394,69 @@ TEST(ArrayImplTest, AssembleAndDisassembleArray) {
   }
 }
 
+TEST(ArrayImplTest, AssembleAndDisassembleArraysBatched) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, test_util::GetClient());
+
+  DType dtype(DType::kF32);
+  Shape shape({2, 3});
+  std::vector<float> data(6);
+  std::iota(data.begin(), data.end(), 0);
+  Device* device0 = client->addressable_devices().at(0);
+  Device* device1 = client->addressable_devices().at(1);
+  std::shared_ptr<const Sharding> single_device_shardings[] = {
+      SingleDeviceSharding::Create(device0, MemoryKind()),
+      SingleDeviceSharding::Create(device1, MemoryKind())};
+
+  constexpr int kNumArrays = 3;
+  std::vector<std::vector<tsl::RCReference<Array>>> shards(kNumArrays);
+  for (auto& array_shards : shards) {
+    for (auto& single_device_sharding : single_device_shardings) {
+      TF_ASSERT_OK_AND_ASSIGN(
+          auto array,
+          client->MakeArrayFromHostBuffer(
+              data.data(), dtype, shape,
+              /*byte_strides=*/std::nullopt, single_device_sharding,
+              Client::HostBufferSemantics::kImmutableOnlyDuringCall,
+              /*on_done_with_host_buffer=*/{}));
+      array_shards.push_back(std::move(array));
+    }
+  }
+
+  Shape assembled_shape({4, 3});
+  std::shared_ptr<const Sharding> assembled_sharding =
+      ConcreteEvenSharding::Create(
+          DeviceList(DeviceList::Devices({device0, device1})), MemoryKind(),
+          assembled_shape, shape);
+  std::vector<Shape> shapes(kNumArrays, assembled_shape);
+  std::vector<std::shared_ptr<const Sharding>> shardings(kNumArrays,
+                                                         assembled_sharding);
+  TF_ASSERT_OK_AND_ASSIGN(auto assembled_arrays,
+                          client->AssembleArraysFromSingleDeviceArrays(
+                              shapes, shardings, absl::MakeSpan(shards),
+                              ArrayCopySemantics::kAlwaysCopy));
+  ASSERT_THAT(assembled_arrays, SizeIs(kNumArrays));
+  for (const auto& assembled_array : assembled_arrays) {
+    EXPECT_EQ(assembled_array->shape(), assembled_shape);
+    EXPECT_EQ(&assembled_array->sharding(), assembled_sharding.get());
+  }
+
+  TF_ASSERT_OK_AND_ASSIGN(auto disassembled_arrays,
+                          client->DisassembleArraysIntoSingleDeviceArrays(
+                              assembled_arrays,
+                              ArrayCopySemantics::kAlwaysCopy));
+  ASSERT_THAT(disassembled_arrays, SizeIs(kNumArrays));
+  for (const auto& single_device_arrays : disassembled_arrays) {
+    ASSERT_THAT(single_device_arrays, SizeIs(2));
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_EQ(single_device_arrays[i]->dtype(), dtype);
+      EXPECT_EQ(single_device_arrays[i]->shape(), shape);
+      EXPECT_THAT(
+          single_device_arrays[i]->sharding().devices().devices(),
+          ElementsAreArray(single_device_shardings[i]->devices().devices()));
+    }
+  }
+}
+
 TEST(ArrayImplTest, AssembleAndDisassembleSingleDeviceArray) {
   TF_ASSERT_OK_AND_ASSIGN(auto client, test_util::GetClient());
 
@@ -498,6 +562,64 @@ TEST(ArrayImplTest, ReshardToDifferentDevice) {
   EXPECT_THAT(out_data, ElementsAreArray(data));
 }
 
+TEST(ArrayImplTest, ReshardReplicatedToPermutedDevices) {
+  TF_ASSERT_OK_AND_ASSIGN(auto client, test_util::GetClient());
+
+  DType dtype(DType::kF32);
+  Shape shape({2, 3});
+  std::vector<float> data(6);
+  std::iota(data.begin(), data.end(), 0);
+  Device* device0 = client->addressable_devices().at(0);
+  Device* device1 = client->addressable_devices().at(1);
+  std::vector<tsl::RCReference<Array>> arrays;
+  for (Device* device : {device0, device1}) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        auto array,
+        client->MakeArrayFromHostBuffer(
+            data.data(), dtype, shape,
+            /*byte_strides=*/std::nullopt,
+            SingleDeviceSharding::Create(device, MemoryKind()),
+            Client::HostBufferSemantics::kImmutableOnlyDuringCall,
+            /*on_done_with_host_buffer=*/{}));
+    arrays.push_back(std::move(array));
+  }
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto array, client->AssembleArrayFromSingleDeviceArrays(
+                      shape,
+                      ConcreteEvenSharding::Create(
+                          DeviceList(DeviceList::Devices({device0, device1})),
+                          MemoryKind(), shape, shape),
+                      absl::MakeSpan(arrays), ArrayCopySemantics::kAlwaysCopy));
+
+  // Every shard holds the full array, so each destination shard can be sourced
+  // from the shard already on its device.
+  std::shared_ptr<const Sharding> new_sharding = ConcreteEvenSharding::Create(
+      DeviceList(DeviceList::Devices({device1, device0})), MemoryKind(), shape,
+      shape);
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto resharded_array,
+      array->Reshard(new_sharding, ArrayCopySemantics::kAlwaysCopy));
+  EXPECT_THAT(resharded_array->sharding().devices().devices(),
+              ElementsAre(device1, device0));
+
+  TF_ASSERT_OK_AND_ASSIGN(auto single_device_arrays,
+                          resharded_array->DisassembleIntoSingleDeviceArrays(
+                              ArrayCopySemantics::kAlwaysCopy));
+  ASSERT_THAT(single_device_arrays, SizeIs(2));
+  EXPECT_THAT(single_device_arrays[0]->sharding().devices().devices(),
+              ElementsAre(device1));
+  EXPECT_THAT(single_device_arrays[1]->sharding().devices().devices(),
+              ElementsAre(device0));
+  for (const auto& single_device_array : single_device_arrays) {
+    std::vector<float> out_data(6);
+    auto future = single_device_array->CopyToHostBuffer(
+        out_data.data(), /*byte_strides=*/std::nullopt,
+        ArrayCopySemantics::kAlwaysCopy);
+    TF_ASSERT_OK(future.Await());
+    EXPECT_THAT(out_data, ElementsAreArray(data));
+  }
+}
+
 TEST(ArrayImplTest, GetReadyFuture) {
   TF_ASSERT_OK_AND_ASSIGN(auto client, test_util::GetClient());
 
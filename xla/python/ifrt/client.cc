@@ -15,12 +15,58 @@ limitations under the License.
 
 #include "xla/python/ifrt/client.h"
 
+#include <memory>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "xla/python/ifrt/array.h"
+#include "xla/python/ifrt/shape.h"
+#include "xla/python/ifrt/sharding.h"
 #include "xla/statusor.h"
+#include "xla/util.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla {
 namespace ifrt {
 
 char Client::ID = 0;
 
+StatusOr<std::vector<tsl::RCReference<Array>>>
+Client::AssembleArraysFromSingleDeviceArrays(
+    absl::Span<const Shape> shapes,
+    absl::Span<const std::shared_ptr<const Sharding>> shardings,
+    absl::Span<std::vector<tsl::RCReference<Array>>> arrays,
+    ArrayCopySemantics semantics) {
+  if (shapes.size() != shardings.size() || shapes.size() != arrays.size()) {
+    return InvalidArgument(
+        "Shapes, shardings and arrays must have the same size: %d vs. %d vs. "
+        "%d",
+        shapes.size(), shardings.size(), arrays.size());
+  }
+  std::vector<tsl::RCReference<Array>> result;
+  result.reserve(arrays.size());
+  for (int i = 0; i < arrays.size(); ++i) {
+    TF_ASSIGN_OR_RETURN(auto array, AssembleArrayFromSingleDeviceArrays(
+                                        shapes[i], shardings[i],
+                                        absl::MakeSpan(arrays[i]), semantics));
+    result.push_back(std::move(array));
+  }
+  return result;
+}
+
+StatusOr<std::vector<std::vector<tsl::RCReference<Array>>>>
+Client::DisassembleArraysIntoSingleDeviceArrays(
+    absl::Span<const tsl::RCReference<Array>> arrays,
+    ArrayCopySemantics semantics) {
+  std::vector<std::vector<tsl::RCReference<Array>>> result;
+  result.reserve(arrays.size());
+  for (const auto& array : arrays) {
+    TF_ASSIGN_OR_RETURN(auto single_device_arrays,
+                        array->DisassembleIntoSingleDeviceArrays(semantics));
+    result.push_back(std::move(single_device_arrays));
+  }
+  return result;
+}
+
 }  // namespace ifrt
 }  // namespace xla
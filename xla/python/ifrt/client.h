@@ -19,6 +19,7 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
@@ -102,6 +103,30 @@ class Client : public llvm::RTTIExtends<Client, llvm::RTTIRoot> {
       absl::Span<tsl::RCReference<Array>> arrays,
       ArrayCopySemantics semantics) = 0;
 
+  // Batched version of `AssembleArrayFromSingleDeviceArrays()`. Builds one
+  // array for each element of `shapes`, `shardings` and `arrays`. Callers
+  // assembling many arrays with the same devices should pass the same
+  // `sharding` object for all of them instead of creating one per array.
+  //
+  // The default implementation assembles each array separately.
+  virtual StatusOr<std::vector<tsl::RCReference<Array>>>
+  AssembleArraysFromSingleDeviceArrays(
+      absl::Span<const Shape> shapes,
+      absl::Span<const std::shared_ptr<const Sharding>> shardings,
+      absl::Span<std::vector<tsl::RCReference<Array>>> arrays,
+      ArrayCopySemantics semantics);
+
+  // Batched version of `Array::DisassembleIntoSingleDeviceArrays()`. Returns
+  // the per-device arrays of each element of `arrays`. Implementations may
+  // share the per-shard shapes and shardings between arrays that have the
+  // same shape and sharding, which avoids recomputing them for every array.
+  //
+  // The default implementation disassembles each array separately.
+  virtual StatusOr<std::vector<std::vector<tsl::RCReference<Array>>>>
+  DisassembleArraysIntoSingleDeviceArrays(
+      absl::Span<const tsl::RCReference<Array>> arrays,
+      ArrayCopySemantics semantics);
+
   // Builds a tuple from a sequence of values.
   virtual StatusOr<tsl::RCReference<Tuple>> MakeTuple(
       absl::Span<tsl::RCReference<Value>> values) = 0;
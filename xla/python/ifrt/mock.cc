@@ -102,6 +102,21 @@ MockClient::MockClient(std::unique_ptr<xla::ifrt::Client> delegated)
         return delegated_->AssembleArrayFromSingleDeviceArrays(
             std::move(shape), std::move(sharding), arrays, semantics);
       });
+  ON_CALL(*this, AssembleArraysFromSingleDeviceArrays)
+      .WillByDefault(
+          [this](absl::Span<const Shape> shapes,
+                 absl::Span<const std::shared_ptr<const Sharding>> shardings,
+                 absl::Span<std::vector<tsl::RCReference<Array>>> arrays,
+                 ArrayCopySemantics semantics) {
+            return delegated_->AssembleArraysFromSingleDeviceArrays(
+                shapes, shardings, arrays, semantics);
+          });
+  ON_CALL(*this, DisassembleArraysIntoSingleDeviceArrays)
+      .WillByDefault([this](absl::Span<const tsl::RCReference<Array>> arrays,
+                            ArrayCopySemantics semantics) {
+        return delegated_->DisassembleArraysIntoSingleDeviceArrays(arrays,
+                                                                   semantics);
+      });
   ON_CALL(*this, MakeTuple)
       .WillByDefault([this](absl::Span<tsl::RCReference<Value>> values) {
         return delegated_->MakeTuple(values);
@@ -109,6 +109,18 @@ class MockClient final : public llvm::RTTIExtends<MockClient, Client> {
                absl::Span<tsl::RCReference<Array>> arrays,
                ArrayCopySemantics semantics),
               (final));
+  MOCK_METHOD(StatusOr<std::vector<tsl::RCReference<Array>>>,
+              AssembleArraysFromSingleDeviceArrays,
+              (absl::Span<const Shape> shapes,
+               absl::Span<const std::shared_ptr<const Sharding>> shardings,
+               absl::Span<std::vector<tsl::RCReference<Array>>> arrays,
+               ArrayCopySemantics semantics),
+              (final));
+  MOCK_METHOD(StatusOr<std::vector<std::vector<tsl::RCReference<Array>>>>,
+              DisassembleArraysIntoSingleDeviceArrays,
+              (absl::Span<const tsl::RCReference<Array>> arrays,
+               ArrayCopySemantics semantics),
+              (final));
   MOCK_METHOD(StatusOr<tsl::RCReference<Tuple>>, MakeTuple,
               (absl::Span<tsl::RCReference<Value>> values), (final));
   MOCK_METHOD(absl::string_view, runtime_type, (), (const, final));
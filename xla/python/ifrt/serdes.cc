@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/python/ifrt/serdes.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -24,6 +25,7 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/python/ifrt/serdes.pb.h"
@@ -53,6 +55,28 @@ Registry* registry() {
   return r;
 }
 
+// Field tags of `Serialized` for length-delimited fields (wire type 2).
+constexpr char kTypeNameTag = (Serialized::kTypeNameFieldNumber << 3) | 2;
+constexpr char kDataTag = (Serialized::kDataFieldNumber << 3) | 2;
+
+void AppendVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+SerDes* FindSerDes(const Serializable& serializable) {
+  Registry* const r = registry();
+  absl::MutexLock l(&r->mu);
+  auto it = r->type_id_to_serdes.find(serializable.dynamicClassID());
+  if (it == r->type_id_to_serdes.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
 }  // namespace
 
 char Serializable::ID = 0;
@@ -80,16 +104,10 @@ void RegisterSerDes(const void* type_id, std::unique_ptr<SerDes> serdes) {
 }
 
 absl::StatusOr<Serialized> Serialize(Serializable& serializable) {
-  SerDes* serdes;
-  {
-    Registry* const r = registry();
-    absl::MutexLock l(&r->mu);
-    auto it = r->type_id_to_serdes.find(serializable.dynamicClassID());
-    if (it == r->type_id_to_serdes.end()) {
-      return absl::UnimplementedError(
-          "Serializable has no associated SerDes implementation");
-    }
-    serdes = it->second;
+  SerDes* serdes = FindSerDes(serializable);
+  if (serdes == nullptr) {
+    return absl::UnimplementedError(
+        "Serializable has no associated SerDes implementation");
   }
   TF_ASSIGN_OR_RETURN(std::string data, serdes->Serialize(serializable));
 
@@ -99,6 +117,32 @@ absl::StatusOr<Serialized> Serialize(Serializable& serializable) {
   return proto;
 }
 
+absl::StatusOr<absl::Cord> SerializeToCord(Serializable& serializable) {
+  SerDes* serdes = FindSerDes(serializable);
+  if (serdes == nullptr) {
+    return absl::UnimplementedError(
+        "Serializable has no associated SerDes implementation");
+  }
+  TF_ASSIGN_OR_RETURN(std::string data, serdes->Serialize(serializable));
+
+  // Only the small header is encoded here; `data` is moved into the cord as
+  // is. Empty fields are omitted to match the proto3 wire format.
+  const absl::string_view type_name = serdes->type_name();
+  std::string header;
+  if (!type_name.empty()) {
+    header.push_back(kTypeNameTag);
+    AppendVarint(type_name.size(), header);
+    header.append(type_name.data(), type_name.size());
+  }
+  if (!data.empty()) {
+    header.push_back(kDataTag);
+    AppendVarint(data.size(), header);
+  }
+  absl::Cord cord(std::move(header));
+  cord.Append(std::move(data));
+  return cord;
+}
+
 absl::StatusOr<std::unique_ptr<Serializable>> Deserialize(
     const Serialized& serialized, std::unique_ptr<DeserializeOptions> options) {
   SerDes* serdes;
@@ -21,6 +21,7 @@ limitations under the License.
 #include <utility>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "llvm/Support/ExtensibleRTTI.h"
 #include "xla/python/ifrt/serdes.pb.h"
@@ -82,6 +83,15 @@ void RegisterSerDes(std::unique_ptr<SerDes> serdes) {
 // `SerDes` registered or the `SerDes` returns an error.
 absl::StatusOr<Serialized> Serialize(Serializable& serializable);
 
+// Like `Serialize()`, but returns the wire format of the `Serialized` proto
+// message as a `Cord`. The bytes produced by the `SerDes` are adopted by the
+// `Cord` instead of being copied into a proto and then again into its
+// serialized string, so large payloads such as executables can be written to a
+// file or socket chunk by chunk (see `absl::Cord::Chunks()`) without ever being
+// flattened. Parsing the result as a `Serialized` yields the same message that
+// `Serialize()` returns.
+absl::StatusOr<absl::Cord> SerializeToCord(Serializable& serializable);
+
 // Deserializes the given proto message produced by `Serialize()` back to a
 // `Serializable` object of the original type.
 //
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "llvm/Support/Casting.h"
@@ -101,6 +102,19 @@ TEST_F(TestNumberTest, RoundTrip) {
   EXPECT_EQ(obj->number, llvm::cast<TestNumber>(*deserialized).number);
 }
 
+TEST_F(TestNumberTest, SerializeToCordMatchesProto) {
+  auto obj = std::make_unique<TestNumber>(1234);
+  TF_ASSERT_OK_AND_ASSIGN(Serialized serialized, Serialize(*obj));
+  TF_ASSERT_OK_AND_ASSIGN(absl::Cord cord, SerializeToCord(*obj));
+  EXPECT_EQ(std::string(cord), serialized.SerializeAsString());
+
+  Serialized parsed;
+  ASSERT_TRUE(parsed.ParseFromString(std::string(cord)));
+  TF_ASSERT_OK_AND_ASSIGN(auto deserialized,
+                          Deserialize(parsed, /*options=*/nullptr));
+  EXPECT_EQ(obj->number, llvm::cast<TestNumber>(*deserialized).number);
+}
+
 TEST_F(TestNumberTest, WithOptions) {
   auto obj = std::make_unique<TestNumber>(1234);
   TF_ASSERT_OK_AND_ASSIGN(Serialized serialized, Serialize(*obj));
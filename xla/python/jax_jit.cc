@@ -232,9 +232,25 @@ xla::Status ParseArguments(absl::Span<PyObject* const> positional_args,
                            absl::Span<int const> static_argnums,
                            absl::Span<py::str const> static_argnames,
                            xla::PyTreeRegistry* pytree_registry,
-                           ParsedArgumentsAsBuffers& arguments) {
+                           ParsedArgumentsAsBuffers& arguments,
+                           absl::Span<const xla::PyTreeDef> expected_treedefs) {
   tsl::profiler::TraceMe traceme("ParseArguments");
 
+  int num_matched_treedefs = 0;
+  auto flatten_dynamic_arg = [&](py::handle arg) {
+    arguments.signature.dynamic_arg_treedefs.emplace_back(pytree_registry);
+    xla::PyTreeDef& pytree_def =
+        arguments.signature.dynamic_arg_treedefs.back();
+    size_t index = arguments.signature.dynamic_arg_treedefs.size() - 1;
+    if (index < expected_treedefs.size() &&
+        pytree_def.FlattenLike(arg, arguments.flat_dynamic_args,
+                               expected_treedefs[index])) {
+      ++num_matched_treedefs;
+      return;
+    }
+    pytree_def.Flatten(arg, arguments.flat_dynamic_args);
+  };
+
   arguments.flat_dynamic_args.reserve(positional_args.size() +
                                       keyword_args.size());
   if (static_argnums.empty()) {
@@ -242,10 +258,7 @@ xla::Status ParseArguments(absl::Span<PyObject* const> positional_args,
 
     // Positional arguments.
     for (int i = 0; i < positional_args.size(); ++i) {
-      arguments.signature.dynamic_arg_treedefs.emplace_back(pytree_registry);
-      xla::PyTreeDef& pytree_def =
-          arguments.signature.dynamic_arg_treedefs.back();
-      pytree_def.Flatten(positional_args[i], arguments.flat_dynamic_args);
+      flatten_dynamic_arg(positional_args[i]);
     }
   } else {
     arguments.signature.dynamic_arg_treedefs.reserve(positional_args.size());
@@ -254,10 +267,7 @@ xla::Status ParseArguments(absl::Span<PyObject* const> positional_args,
     for (int i = 0; i < positional_args.size(); ++i) {
       if (std::find(static_argnums.begin(), static_argnums.end(), i) ==
           static_argnums.end()) {
-        arguments.signature.dynamic_arg_treedefs.emplace_back(pytree_registry);
-        xla::PyTreeDef& pytree_def =
-            arguments.signature.dynamic_arg_treedefs.back();
-        pytree_def.Flatten(positional_args[i], arguments.flat_dynamic_args);
+        flatten_dynamic_arg(positional_args[i]);
       } else {
         arguments.signature.static_args.emplace_back(
             py::reinterpret_borrow<py::object>(positional_args[i]));
@@ -304,13 +314,13 @@ xla::Status ParseArguments(absl::Span<PyObject* const> positional_args,
       } else {
         arguments.signature.dynamic_arg_names.push_back(
             py::reinterpret_steal<py::object>(kwargs[i].first));
-        arguments.signature.dynamic_arg_treedefs.emplace_back(pytree_registry);
-        xla::PyTreeDef& pytree_def =
-            arguments.signature.dynamic_arg_treedefs.back();
-        pytree_def.Flatten(kwargs[i].second, arguments.flat_dynamic_args);
+        flatten_dynamic_arg(kwargs[i].second);
       }
     }
   }
+  arguments.matched_expected_treedefs =
+      num_matched_treedefs == expected_treedefs.size() &&
+      num_matched_treedefs == arguments.signature.dynamic_arg_treedefs.size();
   return ::tsl::OkStatus();
 }
 
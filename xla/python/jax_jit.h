@@ -210,6 +210,9 @@ struct ParsedArgumentsAsBuffers {
   // keyword arguments.
   absl::InlinedVector<pybind11::object, 2> flat_dynamic_args;
   std::vector<pybind11::object> keep_alive_objects;
+  // Whether `ParseArguments` flattened every dynamic argument against the
+  // corresponding expected treedef.
+  bool matched_expected_treedefs = false;
 
   xla::ifrt::Client* ifrt_client;
   // The following is only valid if the parsing succeeds.
@@ -218,13 +221,17 @@ struct ParsedArgumentsAsBuffers {
 
 // Filter out static arguments, flatten and concatenate other arguments (i.e.
 // dynamic positional and keyword arguments), filling `arguments` in place.
-xla::Status ParseArguments(absl::Span<PyObject* const> positional_args,
-                           absl::Span<PyObject* const> keyword_args,
-                           pybind11::handle kwnames,
-                           absl::Span<int const> static_argnums,
-                           absl::Span<pybind11::str const> static_argnames,
-                           xla::PyTreeRegistry* pytree_registry,
-                           ParsedArgumentsAsBuffers& arguments);
+//
+// `expected_treedefs`, if not empty, are the dynamic argument treedefs of a
+// previous call (typically the last one). Arguments with the same structure
+// are flattened with the cheaper `PyTreeDef::FlattenLike`.
+xla::Status ParseArguments(
+    absl::Span<PyObject* const> positional_args,
+    absl::Span<PyObject* const> keyword_args, pybind11::handle kwnames,
+    absl::Span<int const> static_argnums,
+    absl::Span<pybind11::str const> static_argnames,
+    xla::PyTreeRegistry* pytree_registry, ParsedArgumentsAsBuffers& arguments,
+    absl::Span<const xla::PyTreeDef> expected_treedefs = {});
 
 // The function to call in `xla.cc` to add the bindings for this module.
 void BuildJaxjitSubmodule(pybind11::module& m);
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -27,6 +28,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_format.h"
+#include "absl/time/time.h"
 #include "xla/client/executable_build_options.h"
 #include "xla/client/sharding_builder.h"
 #include "xla/client/xla_builder.h"
@@ -46,6 +48,14 @@ limitations under the License.
 // device, one queue of received outfeeds, and one thread for invoking the
 // Python callbacks.
 //
+// Batching:
+// ---------
+//
+// The callback thread passes to each callback all the outfeeds queued for its
+// device, up to BatchOptions::max_batch_size. If max_batch_delay is set, it
+// first waits up to that long for the batch to fill, so that a Python
+// callback acquires the GIL once for several outfeeds.
+//
 // Framing protocol
 // ----------------
 //
@@ -158,9 +168,11 @@ std::string OutfeedData::DebugString() const {
 class OutfeedReceiverImpl {
  public:
   OutfeedReceiverImpl(
-      OutfeedReceiver::Callback callback, absl::Span<PjRtClient* const> clients,
+      OutfeedReceiver::BatchCallback callback,
+      absl::Span<PjRtClient* const> clients,
       ssize_t max_callback_queue_size_bytes,
-      const std::optional<ExecutableBuildOptions>& executable_build_options);
+      const std::optional<ExecutableBuildOptions>& executable_build_options,
+      const OutfeedReceiver::BatchOptions& batch_options);
 
   OutfeedReceiverImpl(const OutfeedReceiverImpl&) = delete;
   OutfeedReceiverImpl& operator=(const OutfeedReceiverImpl&) = delete;
@@ -204,7 +216,8 @@ class OutfeedReceiverImpl {
   // It is not safe to restart an OutfeedReceiver after shutting down one.
   void Shutdown();
 
-  OutfeedReceiver::Callback callback_;
+  OutfeedReceiver::BatchCallback callback_;
+  OutfeedReceiver::BatchOptions batch_options_;
   // The devices on which we are listening.
   std::vector<PjRtDevice*> devices_;
   // Maximum bytes capacity of the ensemble of callback queues.
@@ -233,11 +246,15 @@ class OutfeedReceiverImpl {
 };
 
 OutfeedReceiverImpl::OutfeedReceiverImpl(
-    OutfeedReceiver::Callback callback, absl::Span<PjRtClient* const> clients,
+    OutfeedReceiver::BatchCallback callback,
+    absl::Span<PjRtClient* const> clients,
     ssize_t max_callback_queue_size_bytes,
-    const std::optional<ExecutableBuildOptions>& executable_build_options)
-    : executable_build_options_(executable_build_options) {
+    const std::optional<ExecutableBuildOptions>& executable_build_options,
+    const OutfeedReceiver::BatchOptions& batch_options)
+    : batch_options_(batch_options),
+      executable_build_options_(executable_build_options) {
   callback_ = callback;
+  batch_options_.max_batch_size = std::max(batch_options_.max_batch_size, 1);
   max_callback_queue_size_bytes_ = max_callback_queue_size_bytes;
   for (const auto& client : clients) {
     for (auto device : client->addressable_devices()) {
@@ -359,31 +376,72 @@ StatusOr<std::unique_ptr<Literal>> OutfeedReceiverImpl::ReceiveRawFromOutfeed(
   return literal;
 }
 
+namespace {
+
+// A callback queue and the number of outfeeds that make a full batch.
+struct PendingBatch {
+  std::queue<std::unique_ptr<OutfeedData>>* queue;
+  size_t max_batch_size;
+};
+
+// Whether there is no point in waiting for more outfeeds to batch.
+bool BatchIsReady(PendingBatch* batch) {
+  return batch->queue->size() >= batch->max_batch_size ||
+         batch->queue->back()->consumer_id() == kOutfeedCidShutdown;
+}
+
+}  // namespace
+
 void OutfeedReceiverImpl::CallbackThreadLoop(int device_idx) {
-  const PjRtDevice* device = devices_[device_idx];
+  PjRtDevice* device = devices_[device_idx];
   {
     absl::MutexLock lock(&mu_);
     num_working_callback_threads_++;
   }
+  const size_t max_batch_size = batch_options_.max_batch_size;
   while (true) {
-    std::unique_ptr<OutfeedData> received;
+    std::vector<std::unique_ptr<OutfeedData>> batch;
+    bool shutdown = false;
     {
       absl::MutexLock lock(&mu_);
+      std::queue<std::unique_ptr<OutfeedData>>& queue =
+          callback_queues_[device_idx];
       mu_.Await(absl::Condition(
           +[](std::queue<std::unique_ptr<OutfeedData>>* queue) {
             return !queue->empty();
           },
-          &callback_queues_[device_idx]));
-      received = std::move(callback_queues_[device_idx].front());
-      callback_queues_[device_idx].pop();
-      callback_queue_size_bytes_ -= received->literal_size_bytes();
-      VLOG(2) << "[" << device->DebugString() << "] Dequeued callback for "
-              << received->DebugString() << "; "
-              << callback_queues_[device_idx].size()
+          &queue));
+      if (max_batch_size > 1 &&
+          batch_options_.max_batch_delay > absl::ZeroDuration()) {
+        PendingBatch pending{&queue, max_batch_size};
+        mu_.AwaitWithTimeout(absl::Condition(&BatchIsReady, &pending),
+                             batch_options_.max_batch_delay);
+      }
+      while (!queue.empty() && batch.size() < max_batch_size) {
+        std::unique_ptr<OutfeedData> received = std::move(queue.front());
+        queue.pop();
+        if (received->consumer_id() == kOutfeedCidShutdown) {
+          shutdown = true;
+          break;
+        }
+        callback_queue_size_bytes_ -= received->literal_size_bytes();
+        batch.push_back(std::move(received));
+      }
+      VLOG(2) << "[" << device->DebugString() << "] Dequeued "
+              << batch.size() << " callbacks; " << queue.size()
               << " callbacks in queue of total size "
               << callback_queue_size_bytes_ << " bytes.\n";
     }
-    if (received->consumer_id() == kOutfeedCidShutdown) {
+    if (!batch.empty()) {
+      tsl::profiler::TraceMe traceme("OutfeedReceiver::Callback");
+      std::vector<OutfeedReceiver::Received> received;
+      received.reserve(batch.size());
+      for (std::unique_ptr<OutfeedData>& data : batch) {
+        received.push_back({data->consumer_id(), data->literal()});
+      }
+      callback_(device, received);
+    }
+    if (shutdown) {
       VLOG(2) << "[" << device->DebugString()
               << "] Callback loop received shutdown signal";
       {
@@ -394,11 +452,6 @@ void OutfeedReceiverImpl::CallbackThreadLoop(int device_idx) {
       VLOG(2) << "[" << device->DebugString() << "] Callback loop done";
       return;
     }
-    {
-      tsl::profiler::TraceMe traceme("OutfeedReceiver::Callback");
-      callback_(received->device(), received->consumer_id(),
-                received->literal());
-    }
   }
 }
 
@@ -488,10 +541,25 @@ StatusOr<XlaOp> OutfeedReceiverImpl::AddOutfeedToBuilder(
 OutfeedReceiver::OutfeedReceiver(
     Callback callback, absl::Span<PjRtClient* const> clients,
     ssize_t max_callback_queue_size_bytes,
-    const std::optional<ExecutableBuildOptions>& executable_build_options) {
-  p_impl_ = std::make_unique<OutfeedReceiverImpl>(callback, clients,
-                                                  max_callback_queue_size_bytes,
-                                                  executable_build_options);
+    const std::optional<ExecutableBuildOptions>& executable_build_options)
+    : OutfeedReceiver(
+          [callback = std::move(callback)](
+              PjRtDevice* device, absl::Span<const Received> received) {
+            for (const Received& r : received) {
+              callback(device, r.consumer_id, r.literal);
+            }
+          },
+          clients, max_callback_queue_size_bytes, executable_build_options,
+          BatchOptions()) {}
+
+OutfeedReceiver::OutfeedReceiver(
+    BatchCallback callback, absl::Span<PjRtClient* const> clients,
+    ssize_t max_callback_queue_size_bytes,
+    const std::optional<ExecutableBuildOptions>& executable_build_options,
+    const BatchOptions& batch_options) {
+  p_impl_ = std::make_unique<OutfeedReceiverImpl>(
+      std::move(callback), clients, max_callback_queue_size_bytes,
+      executable_build_options, batch_options);
 }
 
 OutfeedReceiver::~OutfeedReceiver() = default;
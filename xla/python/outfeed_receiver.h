@@ -22,6 +22,8 @@ limitations under the License.
 #include <optional>
 #include <vector>
 
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "xla/client/executable_build_options.h"
 #include "xla/client/xla_builder.h"
 #include "xla/literal.h"
@@ -40,6 +42,24 @@ class OutfeedReceiver {
   using Callback =
       std::function<void(PjRtDevice*, uint32_t, std::shared_ptr<Literal>)>;
 
+  // An outfeed received from a device.
+  struct Received {
+    uint32_t consumer_id;
+    std::shared_ptr<Literal> literal;
+  };
+  // A batch callback takes: device, outfeeds received from the device in
+  // order.
+  using BatchCallback =
+      std::function<void(PjRtDevice*, absl::Span<const Received>)>;
+
+  struct BatchOptions {
+    // The maximum number of outfeeds passed to a single batch callback.
+    int max_batch_size = 1;
+    // How long to wait for more outfeeds to fill a batch once one is
+    // received. With no delay, a batch holds the outfeeds already queued.
+    absl::Duration max_batch_delay = absl::ZeroDuration();
+  };
+
   // Constructs the receiver for the given clients and callback function.
   //
   // Args:
@@ -54,6 +74,14 @@ class OutfeedReceiver {
       ssize_t max_callback_queue_size_bytes,
       const std::optional<ExecutableBuildOptions>& executable_build_options);
 
+  // Same as above, but the callback is invoked with batches of outfeeds from
+  // a device, e.g. to process several outfeeds each time the GIL is acquired.
+  OutfeedReceiver(
+      BatchCallback callback, absl::Span<PjRtClient* const> clients,
+      ssize_t max_callback_queue_size_bytes,
+      const std::optional<ExecutableBuildOptions>& executable_build_options,
+      const BatchOptions& batch_options);
+
   OutfeedReceiver(const OutfeedReceiver&) = delete;
   OutfeedReceiver& operator=(const OutfeedReceiver&) = delete;
 
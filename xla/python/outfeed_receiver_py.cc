@@ -24,6 +24,8 @@ limitations under the License.
 
 #include "absl/algorithm/container.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "pybind11/cast.h"  // from @pybind11
 #include "pybind11/functional.h"  // from @pybind11
 #include "pybind11/pybind11.h"  // from @pybind11
@@ -53,13 +55,14 @@ class OutfeedReceiverForPython {
       CallbackToPython callback_python,
       std::vector<std::shared_ptr<PyClient>> clients,
       ssize_t max_callback_queue_size_bytes,
-      const std::optional<ExecutableBuildOptions>& executable_build_options)
+      const std::optional<ExecutableBuildOptions>& executable_build_options,
+      const OutfeedReceiver::BatchOptions& batch_options)
       : callback_python_(std::move(callback_python)),
         clients_(std::move(clients)) {
-    OutfeedReceiver::Callback callback =
-        [this](PjRtDevice* device, uint32_t consumer_id,
-               std::shared_ptr<Literal> literal) {
-          this->Callback(device, consumer_id, std::move(literal));
+    OutfeedReceiver::BatchCallback callback =
+        [this](PjRtDevice* device,
+               absl::Span<const OutfeedReceiver::Received> received) {
+          this->Callback(device, received);
         };
     std::vector<PjRtClient*> client_ptrs(clients_.size());
     absl::c_transform(clients_, client_ptrs.begin(),
@@ -68,7 +71,7 @@ class OutfeedReceiverForPython {
                       });
     outfeed_receiver_ = std::make_unique<OutfeedReceiver>(
         callback, client_ptrs, max_callback_queue_size_bytes,
-        executable_build_options);
+        executable_build_options, batch_options);
   }
   OutfeedReceiverForPython(const OutfeedReceiverForPython&) = delete;
   OutfeedReceiverForPython& operator=(const OutfeedReceiverForPython&) = delete;
@@ -97,8 +100,10 @@ class OutfeedReceiverForPython {
                                                   arrays, device_idx);
   }
 
-  void Callback(PjRtDevice* device, uint32_t consumer_id,
-                std::shared_ptr<Literal> literal) {
+  // Calls back to Python for each of the outfeeds received, acquiring the GIL
+  // once for the batch.
+  void Callback(PjRtDevice* device,
+                absl::Span<const OutfeedReceiver::Received> received) {
     {
       absl::MutexLock lock(&mu_);
       if (outfeed_receiver_shutting_down_) {
@@ -113,11 +118,13 @@ class OutfeedReceiverForPython {
         });
     CHECK(it != clients_.end());
     py::gil_scoped_acquire gil_acquire;  // Need GIL also for LiteralToPython
-    py::object literal_python = LiteralToPython(std::move(literal)).value();
-    // The callback_ should handle all exceptions in user-code. If we get
-    // an exception here, it is a bug in the callback and we should stop.
-    callback_python_(WrapWithClient<PjRtDevice>(*it, device), consumer_id,
-                     std::move(literal_python));
+    for (const OutfeedReceiver::Received& r : received) {
+      py::object literal_python = LiteralToPython(r.literal).value();
+      // The callback_ should handle all exceptions in user-code. If we get
+      // an exception here, it is a bug in the callback and we should stop.
+      callback_python_(WrapWithClient<PjRtDevice>(*it, device), r.consumer_id,
+                       std::move(literal_python));
+    }
   }
 
  private:
@@ -138,17 +145,24 @@ void BuildOutfeedReceiverSubmodule(py::module* m) {
       [](OutfeedReceiverForPython::CallbackToPython callback_to_python,
          std::vector<std::shared_ptr<PyClient>> clients,
          ssize_t max_callback_queue_size_bytes,
-         std::optional<ExecutableBuildOptions> executable_build_options)
+         std::optional<ExecutableBuildOptions> executable_build_options,
+         int max_callback_batch_size, int64_t max_callback_batch_delay_us)
           -> std::unique_ptr<OutfeedReceiverForPython> {
+        OutfeedReceiver::BatchOptions batch_options;
+        batch_options.max_batch_size = max_callback_batch_size;
+        batch_options.max_batch_delay =
+            absl::Microseconds(max_callback_batch_delay_us);
         auto server = std::make_unique<OutfeedReceiverForPython>(
             callback_to_python, clients, max_callback_queue_size_bytes,
-            executable_build_options);
+            executable_build_options, batch_options);
         server->Start();
         return server;
       },
       py::arg("callback_to_python"), py::arg("backends"),
       py::arg("max_queue_size_bytes") = 256 * 1024 * 1024,
       py::arg("executable_build_options") = std::nullopt,
+      py::arg("max_callback_batch_size") = 1,
+      py::arg("max_callback_batch_delay_us") = 0,
       R"(Starts a multithreaded outfeed receiver.
 
       There is one thread for each of the specified devices. When Python
@@ -163,6 +177,10 @@ void BuildOutfeedReceiverSubmodule(py::module* m) {
         * max_queue_size_bytes: an optional integer to bound the maximum size
             of arrays in the callback queue. When this limit is reached the
             device listener pauses.
+        * max_callback_batch_size: the maximum number of outfeeds from a device
+            delivered while holding the GIL once.
+        * max_callback_batch_delay_us: how long to wait for more outfeeds to
+            fill a batch, in microseconds.
       )",
       py::call_guard<py::gil_scoped_release>());
 
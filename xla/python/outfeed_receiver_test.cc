@@ -20,6 +20,8 @@ limitations under the License.
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "xla/client/client_library.h"
 #include "xla/client/executable_build_options.h"
 #include "xla/client/xla_builder.h"
@@ -231,6 +233,63 @@ TEST(OutfeedReceiverTest, ReceiveOutfeedTwoOutfeed) {
   EXPECT_EQ(ShapeUtil::MakeTupleShape({shape1}), received[1].data->shape());
 }
 
+TEST(OutfeedReceiverTest, ReceiveOutfeedBatched) {
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<PjRtClient> cpu_client,
+                          GetTfrtCpuClient(true));
+  std::vector<PjRtClient*> clients{cpu_client.get()};
+
+  auto receiver = std::make_unique<Accumulator>();
+  absl::Mutex mu;
+  std::vector<size_t> batch_sizes;
+  OutfeedReceiver::BatchCallback callback =
+      [&](PjRtDevice* device,
+          absl::Span<const OutfeedReceiver::Received> received) {
+        {
+          absl::MutexLock lock(&mu);
+          batch_sizes.push_back(received.size());
+        }
+        for (const OutfeedReceiver::Received& r : received) {
+          receiver->Receive(r.consumer_id, r.literal);
+        }
+      };
+  OutfeedReceiver::BatchOptions batch_options;
+  batch_options.max_batch_size = 2;
+  batch_options.max_batch_delay = absl::Seconds(10);
+  auto outfeed_receiver = std::make_shared<OutfeedReceiver>(
+      callback, clients, 1024, std::nullopt, batch_options);
+  outfeed_receiver->Start();
+
+  XlaBuilder builder("execute_test_outfeed");
+  constexpr int consumer_id0 = 5;
+  const Shape shape0 = ShapeUtil::MakeShape(U32, {16});
+  XlaOp data0 = Iota(&builder, shape0, 0);
+  XlaOp send0 = outfeed_receiver
+                    ->AddOutfeedToBuilder(&builder, CreateToken(&builder),
+                                          consumer_id0, {data0}, 0)
+                    .value();
+
+  constexpr int consumer_id1 = 6;
+  const Shape shape1 = ShapeUtil::MakeShape(U32, {128});
+  XlaOp data1 = Iota(&builder, shape1, 0);
+  XlaOp send1 =
+      outfeed_receiver
+          ->AddOutfeedToBuilder(&builder, send0, consumer_id1, {data1}, 0)
+          .value();
+  EXPECT_TRUE(CompileAndExecute(&builder, send1, 0, cpu_client.get()).ok());
+
+  // Shutdown the receiver, to force it to wait to deliver the callbacks.
+  outfeed_receiver = nullptr;
+  std::vector<Accumulator::Data> received = receiver->received();
+  EXPECT_EQ(2, received.size());
+  EXPECT_EQ(consumer_id0, received[0].consumer_id);
+  EXPECT_EQ(ShapeUtil::MakeTupleShape({shape0}), received[0].data->shape());
+  EXPECT_EQ(consumer_id1, received[1].consumer_id);
+  EXPECT_EQ(ShapeUtil::MakeTupleShape({shape1}), received[1].data->shape());
+  // Both outfeeds are delivered in a single callback.
+  absl::MutexLock lock(&mu);
+  EXPECT_EQ(batch_sizes, std::vector<size_t>{2});
+}
+
 TEST(OutfeedReceiverTest, DifferentShapeForConsumerIdError) {
   TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<PjRtClient> cpu_client,
                           GetTfrtCpuClient(true));
@@ -80,7 +80,9 @@ struct PjitCacheEntry {
 // - reduce the number of lru caches (hash map) across multiple JITs.
 // - make the cache global to increase cache hits (e.g. calling jit(f)(3) twice)
 //   keeping entries alive as long as the underlying function f is alive.
-// Assume the cache is protected by the GIL.
+// Assume the cache is protected by the GIL. Note that lookups can't be made
+// GIL-free: comparing CallSignatures compares static arguments, shardings and
+// extra jit context objects through Python.
 class PjitFunctionCache {
  public:
   static constexpr int kDefaultCapacity = 4096;
@@ -226,6 +228,9 @@ class PjitFunction {
   }
   const std::vector<int>& donate_argnums() const { return donate_argnums_; }
   const std::shared_ptr<PjitFunctionCache>& cache() const { return cache_; }
+  const std::vector<xla::PyTreeDef>& last_dynamic_arg_treedefs() const {
+    return last_dynamic_arg_treedefs_;
+  }
 
   int cache_capacity() const { return executables_->Size(); }
 
@@ -258,6 +263,11 @@ class PjitFunction {
   std::shared_ptr<xla::PyTreeRegistry> pytree_registry_;
   std::shared_ptr<PjitFunctionCache> cache_;
   std::shared_ptr<PjitFunctionCache::Cache> executables_;
+
+  // Dynamic argument treedefs of the last call, used to flatten the arguments
+  // of the next call without rebuilding the treedefs when the structure is
+  // unchanged.
+  std::vector<xla::PyTreeDef> last_dynamic_arg_treedefs_;
 };
 
 // thread-compatible.
@@ -461,13 +471,19 @@ xla::StatusOr<py::object> PjitFunction::Call(py::handle callable,
   absl::Span<PyObject* const> positional_args(args, num_positional_args);
   absl::Span<PyObject* const> keyword_args(args + num_positional_args,
                                            num_keyword_args);
-  auto status =
-      ParseArguments(positional_args, keyword_args, kwnames, static_argnums_,
-                     static_argnames_, pytree_registry_.get(), arguments);
+  auto status = ParseArguments(positional_args, keyword_args, kwnames,
+                               static_argnums_, static_argnames_,
+                               pytree_registry_.get(), arguments,
+                               last_dynamic_arg_treedefs_);
   if (!status.ok()) {
     VLOG(2) << "ParseArguments failed: " << status;
     return fallback_to_cache_miss();
   }
+  if (!arguments.matched_expected_treedefs) {
+    last_dynamic_arg_treedefs_.assign(
+        arguments.signature.dynamic_arg_treedefs.begin(),
+        arguments.signature.dynamic_arg_treedefs.end());
+  }
 
   // Perform a few checks for the arguments. Currently we are only allowing
   // committed PyArray inputs. For other cases, e.g. Tracers or ShapedArray, it
@@ -641,22 +657,24 @@ xla::Status PjitFunction::UpdateArgsSignature(
   dynamic_arg_signatures.reserve(arguments.flat_dynamic_args.size());
   auto& dynamic_arg_shardings = arguments.signature.dynamic_arg_shardings;
   dynamic_arg_shardings.reserve(arguments.flat_dynamic_args.size());
+  auto& committed_args = arguments.signature.committed_args;
+  committed_args.reserve(arguments.flat_dynamic_args.size());
 
   for (py::handle arg : arguments.flat_dynamic_args) {
     TF_ASSIGN_OR_RETURN(auto signature,
                         xla::PyArgSignatureOfValue(arg, jax_enable_x64));
-    arguments.signature.dynamic_arg_signatures.push_back(std::move(signature));
+    dynamic_arg_signatures.push_back(std::move(signature));
 
     // It should be already checked previously in the entry point of
     // PjitFunction::Call().
     if (arg.get_type() == xla::PyArray::type()) {
       auto py_array = py::reinterpret_borrow<xla::PyArray>(arg);
 
-      arguments.signature.dynamic_arg_shardings.push_back(py_array.sharding());
-      arguments.signature.committed_args.push_back(py_array.committed());
+      dynamic_arg_shardings.push_back(py_array.sharding());
+      committed_args.push_back(py_array.committed());
     } else {
-      arguments.signature.dynamic_arg_shardings.push_back(py::none());
-      arguments.signature.committed_args.push_back(false);
+      dynamic_arg_shardings.push_back(py::none());
+      committed_args.push_back(false);
     }
   }
 
@@ -729,9 +747,11 @@ void PjitFunction::PopulateCacheEntry(PjitCacheEntry& cache_entry,
 // Helper function used by the tp_clear GC method.
 void PjitFunction::ClearPythonReferences() {
   py::function cache_miss;
+  std::vector<xla::PyTreeDef> last_dynamic_arg_treedefs;
   // Swap values for nulls before they are destroyed. See the Python
   // Py_CLEAR() documentation for a discussion of this topic.
   std::swap(cache_miss_, cache_miss);
+  std::swap(last_dynamic_arg_treedefs_, last_dynamic_arg_treedefs);
 }
 
 struct PjitFunctionObject {
@@ -821,6 +841,11 @@ int PjitFunction_tp_traverse(PyObject* self, visitproc visit, void* arg) {
 #endif
   Py_VISIT(o->dict);
   Py_VISIT(o->fun.cache_miss().ptr());
+  for (const xla::PyTreeDef& treedef : o->fun.last_dynamic_arg_treedefs()) {
+    if (int ret = treedef.Traverse(visit, arg)) {
+      return ret;
+    }
+  }
   return 0;
 }
 
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/python/pjrt_ifrt/pjrt_array.h"
 
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <string>
 #include <utility>
@@ -228,18 +229,33 @@ PjRtArray::PjRtArray(PjRtCompatibleClient* client, DType dtype, Shape shape,
 StatusOr<std::vector<tsl::RCReference<Array>>>
 PjRtArray::DisassembleIntoSingleDeviceArrays(ArrayCopySemantics semantics) {
   DCHECK(this);
+  TF_ASSIGN_OR_RETURN(auto shape_and_shardings, sharding_->Disassemble(shape_));
+  return DisassembleIntoSingleDeviceArrays(semantics, shape_and_shardings);
+}
+
+StatusOr<std::vector<tsl::RCReference<Array>>>
+PjRtArray::DisassembleIntoSingleDeviceArrays(
+    ArrayCopySemantics semantics,
+    absl::Span<const std::pair<Shape, std::shared_ptr<const Sharding>>>
+        shard_shapes_and_shardings) {
+  DCHECK(this);
+  if (shard_shapes_and_shardings.size() != sharding_->devices().size()) {
+    return InvalidArgument(
+        "Number of shard shapes and shardings must match the number of "
+        "devices: %d vs. %d",
+        shard_shapes_and_shardings.size(), sharding_->devices().size());
+  }
   std::vector<tsl::RCReference<Array>> result;
   result.reserve(sharding_->devices().size());
-  TF_ASSIGN_OR_RETURN(auto shape_and_shardings, sharding_->Disassemble(shape_));
   for (int i = 0; i < sharding_->devices().size(); ++i) {
     PjRtBuffers buffers;
     buffers.reserve(1);
     buffers.push_back(GetPjRtBuffer(semantics, i));
     TF_ASSIGN_OR_RETURN(
-        auto array, PjRtArray::Create(client_, dtype_,
-                                      std::move(shape_and_shardings[i].first),
-                                      std::move(shape_and_shardings[i].second),
-                                      std::move(buffers)));
+        auto array,
+        PjRtArray::Create(client_, dtype_, shard_shapes_and_shardings[i].first,
+                          shard_shapes_and_shardings[i].second,
+                          std::move(buffers)));
     result.push_back(std::move(array));
   }
   return result;
@@ -327,6 +343,49 @@ StatusOr<PjRtMemorySpace*> GetMemorySpaceFromMemoryKind(
   return memory_space;
 }
 
+// Returns, for each shard of `dst_sharding`, the index of the shard of
+// `src_sharding` that holds the same slice of an array of `shape`. When
+// several source shards hold the slice (e.g., a replicated sharding), the one
+// already on the destination device is preferred so that a device-order
+// permutation does not copy any data. Shards whose slice cannot be matched
+// (or whose index domains are unavailable) are sourced positionally.
+std::vector<int> PlanReshardSources(const Shape& shape,
+                                    const Sharding& src_sharding,
+                                    const Sharding& dst_sharding) {
+  const int num_shards = dst_sharding.devices().size();
+  std::vector<int> sources(num_shards);
+  std::iota(sources.begin(), sources.end(), 0);
+  auto src_domains = src_sharding.IndexDomains(shape);
+  auto dst_domains = dst_sharding.IndexDomains(shape);
+  if (!src_domains.ok() || !dst_domains.ok() ||
+      src_domains->size() != num_shards || dst_domains->size() != num_shards) {
+    return sources;
+  }
+  for (int i = 0; i < num_shards; ++i) {
+    if ((*src_domains)[i] == (*dst_domains)[i] &&
+        src_sharding.devices()[i] == dst_sharding.devices()[i]) {
+      continue;
+    }
+    std::optional<int> match;
+    for (int j = 0; j < num_shards; ++j) {
+      if ((*src_domains)[j] != (*dst_domains)[i]) {
+        continue;
+      }
+      if (src_sharding.devices()[j] == dst_sharding.devices()[i]) {
+        match = j;
+        break;
+      }
+      if (!match.has_value()) {
+        match = j;
+      }
+    }
+    if (match.has_value()) {
+      sources[i] = *match;
+    }
+  }
+  return sources;
+}
+
 StatusOr<tsl::RCReference<Array>> PjRtArray::Reshard(
     std::shared_ptr<const Sharding> new_sharding,
     ArrayCopySemantics semantics) {
@@ -346,13 +405,21 @@ StatusOr<tsl::RCReference<Array>> PjRtArray::Reshard(
       new_sharding->memory_kind(), new_sharding->devices().front());
   bool new_sharding_has_memory_kind =
       canonicalized_sharding_memory_kind.memory_kind().has_value();
+  // Match destination shards to source shards holding the same slice, so that
+  // shards that only moved between devices are reused or copied directly from
+  // the device that already holds them.
+  std::vector<int> sources =
+      PlanReshardSources(shape_, *sharding_, *new_sharding);
+  // Donated buffers are only released once every destination shard has been
+  // sourced, since several destination shards may share a source shard.
+  std::vector<bool> donated(pjrt_buffers_.size(), false);
   for (int i = 0; i < pjrt_buffers_.size(); ++i) {
-    bool devices_equal =
-        pjrt_buffers_[i]->device() == new_sharding->devices()[i];
-    bool memories_supported = pjrt_buffers_[i]->memory_space() != nullptr;
+    const std::shared_ptr<PjRtBuffer>& pjrt_buffer = pjrt_buffers_[sources[i]];
+    bool devices_equal = pjrt_buffer->device() == new_sharding->devices()[i];
+    bool memories_supported = pjrt_buffer->memory_space() != nullptr;
     bool memory_kind_equal =
         new_sharding_has_memory_kind && memories_supported &&
-        pjrt_buffers_[i]->memory_space()->memory_space_kind() ==
+        pjrt_buffer->memory_space()->memory_space_kind() ==
             canonicalized_sharding_memory_kind.memory_kind();
 
     // No need for data transfer.
@@ -362,15 +429,15 @@ StatusOr<tsl::RCReference<Array>> PjRtArray::Reshard(
         case ArrayCopySemantics::kAlwaysCopy:
           // TODO(hyeontaek): kAlwaysCopy should clone the buffer, but the PjRt
           // API does not have efficient buffer cloning on the same device.
-          buffers.push_back(pjrt_buffers_[i]);
+          buffers.push_back(pjrt_buffer);
           break;
         case ArrayCopySemantics::kReuseInput:
-          buffers.push_back(pjrt_buffers_[i]);
+          buffers.push_back(pjrt_buffer);
           break;
         case ArrayCopySemantics::kDonateInput:
           // TODO(hyeontaek): We may try std::move(pjrt_buffers_[i]), but this
           // would be unsafe if there is a subsequent access to the buffer.
-          buffers.push_back(pjrt_buffers_[i]);
+          buffers.push_back(pjrt_buffer);
           break;
       }
     } else {
@@ -391,27 +458,32 @@ StatusOr<tsl::RCReference<Array>> PjRtArray::Reshard(
             GetMemorySpaceFromMemoryKind(new_sharding->devices()[i],
                                          canonicalized_sharding_memory_kind));
         TF_ASSIGN_OR_RETURN(std::unique_ptr<PjRtBuffer> copied_buffer,
-                            pjrt_buffers_[i]->CopyToMemorySpace(memory_space));
+                            pjrt_buffer->CopyToMemorySpace(memory_space));
         if (semantics == ArrayCopySemantics::kDonateInput) {
           if (!memory_kind_equal) {
             return Unimplemented(
                 "Donation across different memory kinds is not implemented.");
           }
-          pjrt_buffers_[i] = nullptr;
+          donated[sources[i]] = true;
         }
         buffers.push_back(std::shared_ptr<PjRtBuffer>(copied_buffer.release()));
       } else {
         // Use `PjRtBuffer::CopyToDevice` when memories are not supported.
         TF_ASSIGN_OR_RETURN(
             std::unique_ptr<xla::PjRtBuffer> copied_buffer,
-            pjrt_buffers_[i]->CopyToDevice(new_sharding->devices()[i]));
+            pjrt_buffer->CopyToDevice(new_sharding->devices()[i]));
         if (semantics == ArrayCopySemantics::kDonateInput) {
-          pjrt_buffers_[i] = nullptr;
+          donated[sources[i]] = true;
         }
         buffers.push_back(std::shared_ptr<PjRtBuffer>(copied_buffer.release()));
       }
     }
   }
+  for (int i = 0; i < pjrt_buffers_.size(); ++i) {
+    if (donated[i]) {
+      pjrt_buffers_[i] = nullptr;
+    }
+  }
   return PjRtArray::Create(client_, dtype_, shape_, std::move(new_sharding),
                            std::move(buffers));
 }
@@ -19,6 +19,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/inlined_vector.h"
@@ -119,6 +120,15 @@ class PjRtArray final
   StatusOr<std::vector<tsl::RCReference<Array>>>
   DisassembleIntoSingleDeviceArrays(ArrayCopySemantics semantics) override;
 
+  // Same as above, but uses `shard_shapes_and_shardings` that were computed by
+  // `sharding().Disassemble(shape())`. The per-shard shardings are shared with
+  // the returned arrays instead of being created for each of them.
+  StatusOr<std::vector<tsl::RCReference<Array>>>
+  DisassembleIntoSingleDeviceArrays(
+      ArrayCopySemantics semantics,
+      absl::Span<const std::pair<Shape, std::shared_ptr<const Sharding>>>
+          shard_shapes_and_shardings);
+
   ABSL_MUST_USE_RESULT
   Future<Status> CopyToHostBuffer(
       void* data, std::optional<absl::Span<const int64_t>> byte_strides,
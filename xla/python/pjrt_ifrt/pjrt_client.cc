@@ -20,6 +20,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_join.h"
@@ -181,6 +182,44 @@ PjRtClient::AssembleArrayFromSingleDeviceArrays(
                            std::move(buffers));
 }
 
+StatusOr<std::vector<std::vector<tsl::RCReference<Array>>>>
+PjRtClient::DisassembleArraysIntoSingleDeviceArrays(
+    absl::Span<const tsl::RCReference<Array>> arrays,
+    ArrayCopySemantics semantics) {
+  DCHECK(this);
+  std::vector<std::vector<tsl::RCReference<Array>>> result;
+  result.reserve(arrays.size());
+  // Arrays produced together (e.g., the outputs of an execution) often share
+  // their sharding and shape, so the disassembled shardings of the previous
+  // array are reused when they match.
+  const Sharding* last_sharding = nullptr;
+  const Shape* last_shape = nullptr;
+  std::vector<std::pair<Shape, std::shared_ptr<const Sharding>>>
+      shard_shapes_and_shardings;
+  for (const auto& array : arrays) {
+    auto* pjrt_array = llvm::dyn_cast<PjRtArray>(array.get());
+    if (pjrt_array == nullptr) {
+      TF_ASSIGN_OR_RETURN(auto single_device_arrays,
+                          array->DisassembleIntoSingleDeviceArrays(semantics));
+      result.push_back(std::move(single_device_arrays));
+      continue;
+    }
+    const Sharding* sharding = &pjrt_array->sharding();
+    if (last_sharding == nullptr || sharding != last_sharding ||
+        pjrt_array->shape() != *last_shape) {
+      TF_ASSIGN_OR_RETURN(shard_shapes_and_shardings,
+                          sharding->Disassemble(pjrt_array->shape()));
+      last_sharding = sharding;
+      last_shape = &pjrt_array->shape();
+    }
+    TF_ASSIGN_OR_RETURN(auto single_device_arrays,
+                        pjrt_array->DisassembleIntoSingleDeviceArrays(
+                            semantics, shard_shapes_and_shardings));
+    result.push_back(std::move(single_device_arrays));
+  }
+  return result;
+}
+
 StatusOr<tsl::RCReference<Tuple>> PjRtClient::MakeTuple(
     absl::Span<tsl::RCReference<Value>> values) {
   return PjRtTuple::Create(this, values);
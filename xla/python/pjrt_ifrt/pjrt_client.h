@@ -20,6 +20,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "absl/types/span.h"
 #include "llvm/Support/ExtensibleRTTI.h"
@@ -89,6 +90,11 @@ class PjRtClient final
       absl::Span<tsl::RCReference<Array>> arrays,
       ArrayCopySemantics semantics) override;
 
+  StatusOr<std::vector<std::vector<tsl::RCReference<Array>>>>
+  DisassembleArraysIntoSingleDeviceArrays(
+      absl::Span<const tsl::RCReference<Array>> arrays,
+      ArrayCopySemantics semantics) override;
+
   StatusOr<tsl::RCReference<Tuple>> MakeTuple(
       absl::Span<tsl::RCReference<Value>> values) override;
 
@@ -199,6 +199,20 @@ void BuildProfilerSubmodule(py::module* m) {
             {xspace_proto}, &fdo_profile));
         return fdo_profile.SerializeAsString();
       });
+
+  profiler.def(
+      "update_profile_store",
+      [](const std::string& tensorboard_dir, const std::string& store_dir,
+         double new_cost_weight) {
+        tensorflow::profiler::ProfiledInstructionsProto profile_proto;
+        xla::ThrowIfError(
+            xla::ConvertXplaneUnderLogdirToProfiledInstructionsProto(
+                tensorboard_dir, &profile_proto));
+        xla::ThrowIfError(
+            xla::UpdateProfileStore(profile_proto, store_dir, new_cost_weight));
+      },
+      py::arg("tensorboard_dir"), py::arg("store_dir"),
+      py::arg("new_cost_weight") = 0.5);
 }
 
 }  // namespace xla
@@ -800,6 +800,11 @@ StatusOr<PyArray> PyArray::BatchedDevicePut(
   options.allow_zero_copy =
       (!force_copy &&
        (host_buffer_semantics == ifrt::Client::HostBufferSemantics::kZeroCopy));
+  // Shards are put one after the other; with this semantics each put returns
+  // once its transfer is enqueued, so the transfers of all shards overlap.
+  options.immutable_until_transfer_completes =
+      (host_buffer_semantics ==
+       ifrt::Client::HostBufferSemantics::kImmutableUntilTransferCompletes);
 
   py::list owning_pylist(dst_devices.size());
   std::vector<tsl::RCReference<ifrt::Array>> ifrt_arrays;
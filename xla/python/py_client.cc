@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/python/py_client.h"
 
+#include <algorithm>
 #include <exception>
 #include <memory>
 #include <optional>
@@ -46,7 +47,10 @@ limitations under the License.
 #include "xla/python/transfer_guard_lib.h"
 #include "xla/service/custom_call_target_registry.h"
 #include "xla/service/platform_util.h"
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "xla/python/py_client_gpu.h"
@@ -369,24 +373,15 @@ MakeIfrtDeserializeExecutableOptions(
 StatusOr<std::shared_ptr<PyLoadedExecutable>> PyClient::Compile(
     std::string mlir_module, CompileOptions options,
     std::vector<pybind11::capsule> host_callbacks) {
-  // Pass allocated device memory size to compile options for pjrt compatible
-  // backends.
-  if ((ifrt_client_->platform_id() == xla::CudaId() ||
-       ifrt_client_->platform_id() == xla::RocmId()) &&
-      !pjrt_client()->devices().empty()) {
-    auto maybe_stats = pjrt_client()->devices()[0]->GetAllocatorStats();
-    if (maybe_stats.ok() && maybe_stats->bytes_limit) {
-      options.executable_build_options.set_device_memory_size(
-          *maybe_stats->bytes_limit);
-    }
-  }
+  SetDeviceMemorySize(options);
   std::unique_ptr<ifrt::LoadedExecutable> ifrt_loaded_executable;
   std::optional<std::string> fingerprint;
   auto ifrt_compile_options =
       MakeIfrtCompileOptions(std::move(options), std::move(host_callbacks));
   {
     py::gil_scoped_release gil_release;
-    mlir::MLIRContext context;
+    mlir::MLIRContext context(mlir::MLIRContext::Threading::DISABLED);
+    UseSharedMlirThreadPool(context);
     TF_ASSIGN_OR_RETURN(mlir::OwningOpRef<mlir::ModuleOp> module,
                         ParseMlirModuleString(mlir_module, context));
     TF_ASSIGN_OR_RETURN(
@@ -402,6 +397,80 @@ StatusOr<std::shared_ptr<PyLoadedExecutable>> PyClient::Compile(
       std::move(traceback), std::move(fingerprint));
 }
 
+StatusOr<std::vector<std::shared_ptr<PyLoadedExecutable>>>
+PyClient::CompileMany(std::vector<std::string> mlir_modules,
+                      std::vector<CompileOptions> options) {
+  if (mlir_modules.size() != options.size()) {
+    return InvalidArgument(
+        "CompileMany got %d modules but %d compile options.",
+        mlir_modules.size(), options.size());
+  }
+  const int num_modules = mlir_modules.size();
+  std::vector<std::unique_ptr<ifrt::CompileOptions>> ifrt_compile_options;
+  ifrt_compile_options.reserve(num_modules);
+  for (CompileOptions& module_options : options) {
+    SetDeviceMemorySize(module_options);
+    ifrt_compile_options.push_back(MakeIfrtCompileOptions(
+        std::move(module_options), /*host_callbacks=*/{}));
+  }
+
+  std::vector<std::unique_ptr<ifrt::LoadedExecutable>> ifrt_loaded_executables(
+      num_modules);
+  std::vector<std::optional<std::string>> fingerprints(num_modules);
+  std::vector<Status> statuses(num_modules);
+  {
+    py::gil_scoped_release gil_release;
+    auto compile = [&](int i) -> Status {
+      mlir::MLIRContext context(mlir::MLIRContext::Threading::DISABLED);
+      UseSharedMlirThreadPool(context);
+      TF_ASSIGN_OR_RETURN(mlir::OwningOpRef<mlir::ModuleOp> module,
+                          ParseMlirModuleString(mlir_modules[i], context));
+      TF_ASSIGN_OR_RETURN(
+          ifrt_loaded_executables[i],
+          ifrt_client_->GetDefaultCompiler()->Compile(
+              std::make_unique<xla::ifrt::XlaProgram>(module.get()),
+              std::move(ifrt_compile_options[i])));
+      TF_ASSIGN_OR_RETURN(fingerprints[i],
+                          ifrt_loaded_executables[i]->Fingerprint());
+      return OkStatus();
+    };
+    // The thread pool's destructor waits for all compilations to finish.
+    tsl::thread::ThreadPool pool(
+        tsl::Env::Default(), "py_client_compile_many",
+        std::max(1, std::min(num_modules, tsl::port::MaxParallelism())));
+    for (int i = 0; i < num_modules; ++i) {
+      pool.Schedule([&, i] { statuses[i] = compile(i); });
+    }
+  }
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+
+  auto traceback = Traceback::Get();
+  std::vector<std::shared_ptr<PyLoadedExecutable>> executables;
+  executables.reserve(num_modules);
+  for (int i = 0; i < num_modules; ++i) {
+    executables.push_back(std::make_shared<PyLoadedExecutable>(
+        shared_from_this(), std::move(ifrt_loaded_executables[i]), traceback,
+        std::move(fingerprints[i])));
+  }
+  return executables;
+}
+
+void PyClient::SetDeviceMemorySize(CompileOptions& options) {
+  // Pass allocated device memory size to compile options for pjrt compatible
+  // backends.
+  if ((ifrt_client_->platform_id() == xla::CudaId() ||
+       ifrt_client_->platform_id() == xla::RocmId()) &&
+      !pjrt_client()->devices().empty()) {
+    auto maybe_stats = pjrt_client()->devices()[0]->GetAllocatorStats();
+    if (maybe_stats.ok() && maybe_stats->bytes_limit) {
+      options.executable_build_options.set_device_memory_size(
+          *maybe_stats->bytes_limit);
+    }
+  }
+}
+
 StatusOr<py::bytes> PyClient::SerializeExecutable(
     const PyLoadedExecutable& executable) const {
   return executable.ifrt_loaded_executable()->Serialize();
@@ -445,7 +514,9 @@ bool HeapProfileKey::operator==(const HeapProfileKey& other) const {
   if ((traceback == nullptr) != (other.traceback == nullptr)) {
     return false;
   }
-  if (traceback && traceback->raw_frames() != other.traceback->raw_frames()) {
+  // Identical stacks usually share an interned traceback.
+  if (traceback && traceback != other.traceback &&
+      traceback->raw_frames() != other.traceback->raw_frames()) {
     return false;
   }
   return true;
@@ -180,6 +180,14 @@ class PyClient : public std::enable_shared_from_this<PyClient> {
       std::string mlir_module, CompileOptions options,
       std::vector<pybind11::capsule> host_callbacks);
 
+  // Compiles `mlir_modules[i]` with `options[i]` for every i, running the
+  // compilations concurrently with the GIL released. Meant for warming up many
+  // variants (e.g. shape buckets) of a program at once. Host callbacks are not
+  // supported.
+  StatusOr<std::vector<std::shared_ptr<PyLoadedExecutable>>> CompileMany(
+      std::vector<std::string> mlir_modules,
+      std::vector<CompileOptions> options);
+
   StatusOr<pybind11::bytes> SerializeExecutable(
       const PyLoadedExecutable& executable) const;
   StatusOr<std::shared_ptr<PyLoadedExecutable>> DeserializeExecutable(
@@ -241,6 +249,10 @@ class PyClient : public std::enable_shared_from_this<PyClient> {
   std::vector<pybind11::object> LiveArrays();
 
  private:
+  // Passes the allocated device memory size to `options` for backends that
+  // use it.
+  void SetDeviceMemorySize(CompileOptions& options);
+
   friend class PyLoadedExecutable;
   friend class PyArray;
   friend struct PyArray_Storage;
@@ -195,7 +195,8 @@ class CompileOnlyPyClient : public PyClient {
           "client.");
     }
     pybind11::gil_scoped_release gil_release;
-    mlir::MLIRContext context;
+    mlir::MLIRContext context(mlir::MLIRContext::Threading::DISABLED);
+    UseSharedMlirThreadPool(context);
     TF_ASSIGN_OR_RETURN(mlir::OwningOpRef<mlir::ModuleOp> module,
                         ParseMlirModuleString(mlir_module, context));
     auto* ifrt_client =
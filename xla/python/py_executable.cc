@@ -116,40 +116,65 @@ struct ShardedBufferAdapter<ExecuteShardedArg> {
       return std::get<std::vector<PyArray>>(arg).size();
     }
   }
-  static tsl::RCReference<ifrt::Array> GetIfRtArray(
-      const ExecuteShardedArg& arg) {
-    if (std::holds_alternative<PyArray>(arg)) {
-      CHECK(std::get<PyArray>(arg).fastpath_enabled());
-      return tsl::FormRef(std::get<PyArray>(arg).ifrt_array());
-    }
-    auto& arg_vector = std::get<std::vector<PyArray>>(arg);
+  static std::vector<tsl::RCReference<ifrt::Array>> GetIfRtArrays(
+      ifrt::Client* ifrt_client, absl::Span<const ExecuteShardedArg> args) {
+    std::vector<tsl::RCReference<ifrt::Array>> result(args.size());
 
     // TODO(hyeontaek): This on-demand Array creation is not efficient and has
     // insufficient information about the shape (a dummy shape is used). This
     // should be removed if possible and only be used in the context where the
     // shape information is unused.
-    std::vector<tsl::RCReference<ifrt::Array>> ifrt_arrays;
-    ifrt_arrays.reserve(arg_vector.size());
-    ifrt::DeviceList::Devices devices;
-    devices.reserve(arg_vector.size());
-    for (auto& arr : arg_vector) {
-      CHECK_EQ(arr.ifrt_array()->sharding().devices().size(), 1)
-          << arr.ifrt_array()->sharding().DebugString();
-      ifrt_arrays.push_back(tsl::FormRef(arr.ifrt_array()));
-      devices.push_back(arr.ifrt_array()->sharding().devices().front());
+    std::vector<int> assembled_indices;
+    std::vector<ifrt::Shape> shapes;
+    std::vector<std::shared_ptr<const ifrt::Sharding>> shardings;
+    std::vector<std::vector<tsl::RCReference<ifrt::Array>>> shards;
+    for (int i = 0; i < args.size(); ++i) {
+      const ExecuteShardedArg& arg = args[i];
+      if (std::holds_alternative<PyArray>(arg)) {
+        CHECK(std::get<PyArray>(arg).fastpath_enabled());
+        result[i] = tsl::FormRef(std::get<PyArray>(arg).ifrt_array());
+        continue;
+      }
+      auto& arg_vector = std::get<std::vector<PyArray>>(arg);
+      std::vector<tsl::RCReference<ifrt::Array>> ifrt_arrays;
+      ifrt_arrays.reserve(arg_vector.size());
+      ifrt::DeviceList::Devices devices;
+      devices.reserve(arg_vector.size());
+      for (auto& arr : arg_vector) {
+        CHECK_EQ(arr.ifrt_array()->sharding().devices().size(), 1)
+            << arr.ifrt_array()->sharding().DebugString();
+        ifrt_arrays.push_back(tsl::FormRef(arr.ifrt_array()));
+        devices.push_back(arr.ifrt_array()->sharding().devices().front());
+      }
+      CHECK(!ifrt_arrays.empty());
+      // Arguments are usually placed on the same devices, so the sharding of
+      // the previous argument is shared when the devices match.
+      // TODO(yashkatariya): Plumb sharding or memory_kind here.
+      if (shardings.empty() ||
+          shardings.back()->devices().devices() !=
+              absl::MakeConstSpan(devices)) {
+        shardings.push_back(ifrt::OpaqueSharding::Create(
+            ifrt::DeviceList(std::move(devices)), ifrt::MemoryKind()));
+      } else {
+        shardings.push_back(shardings.back());
+      }
+      // Use a dummy shape.
+      // TODO(hyeontaek): Find a way to compute a correct shape.
+      shapes.push_back(ifrt_arrays.front()->shape());
+      shards.push_back(std::move(ifrt_arrays));
+      assembled_indices.push_back(i);
+    }
+    if (assembled_indices.empty()) {
+      return result;
+    }
+    auto ifrt_arrays = ifrt_client->AssembleArraysFromSingleDeviceArrays(
+        shapes, shardings, absl::MakeSpan(shards),
+        ifrt::ArrayCopySemantics::kReuseInput);
+    TF_CHECK_OK(ifrt_arrays.status());
+    for (int i = 0; i < assembled_indices.size(); ++i) {
+      result[assembled_indices[i]] = std::move((*ifrt_arrays)[i]);
     }
-    CHECK(!ifrt_arrays.empty());
-    // Use a dummy shape.
-    // TODO(hyeontaek): Find a way to compute a correct shape.
-    // TODO(yashkatariya): Plumb sharding or memory_kind here.
-    auto ifrt_array =
-        ifrt_arrays.front()->client()->AssembleArrayFromSingleDeviceArrays(
-            ifrt_arrays.front()->shape(),
-            ifrt::OpaqueSharding::Create(ifrt::DeviceList(std::move(devices)),
-                                         ifrt::MemoryKind()),
-            absl::MakeSpan(ifrt_arrays), ifrt::ArrayCopySemantics::kReuseInput);
-    TF_CHECK_OK(ifrt_array.status());
-    return *ifrt_array;
+    return result;
   }
 };
 
@@ -161,13 +186,13 @@ void PopulateExecuteShardedResults(
   DCHECK_GT(num_computations, 0);
   int num_output_buffers = ifrt_arrays.size();
   outputs.resize(num_output_buffers);
+  auto exploded_arrays =
+      client->ifrt_client()->DisassembleArraysIntoSingleDeviceArrays(
+          ifrt_arrays, ifrt::ArrayCopySemantics::kReuseInput);
+  TF_CHECK_OK(exploded_arrays.status());
   for (int buffer_id = 0; buffer_id < num_output_buffers; ++buffer_id) {
     outputs[buffer_id].reserve(num_computations);
-    auto exploded_arrays =
-        ifrt_arrays[buffer_id]->DisassembleIntoSingleDeviceArrays(
-            ifrt::ArrayCopySemantics::kReuseInput);
-    TF_CHECK_OK(exploded_arrays.status());
-    for (auto& exploded_array : *exploded_arrays) {
+    for (auto& exploded_array : (*exploded_arrays)[buffer_id]) {
       outputs[buffer_id].push_back(PyArray::MakeFromSingleDeviceArray(
           client, traceback, std::move(exploded_array), false, true));
     }
@@ -195,10 +220,8 @@ StatusOr<PyExecuteResults> ExecuteShardedOnLocalDevicesInternal(
             }));
       }
     }
-    std::vector<tsl::RCReference<ifrt::Array>> arg_arrays(args.size());
-    absl::c_transform(args, arg_arrays.begin(), [&](const ArgT& arg) mutable {
-      return ArgAdapter::GetIfRtArray(arg);
-    });
+    std::vector<tsl::RCReference<ifrt::Array>> arg_arrays =
+        ArgAdapter::GetIfRtArrays(client->ifrt_client(), args);
     TF_ASSIGN_OR_RETURN(auto result, ifrt_loaded_executable->Execute(
                                          absl::MakeSpan(arg_arrays), options,
                                          /*devices=*/std::nullopt));
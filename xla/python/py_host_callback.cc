@@ -175,10 +175,16 @@ PyHostSendAndRecvLoadedHostCallback::Create(
   assign_arg_info(operand_shapes, send_channel_ids, host_callback->operands);
   assign_arg_info(result_shapes, recv_channel_ids, host_callback->results);
 
-  host_callback->callback = [cpu_callback = std::move(cpu_callback)](
-                                void** outputs, void** inputs) {
+  host_callback->callback = [cpu_callback](void** outputs, void** inputs) {
     return cpu_callback->PrepareAndCall(outputs, inputs);
   };
+  // The send/recv path owns the operand buffers, so they can be passed to
+  // Python without a copy.
+  host_callback->callback_with_owned_inputs =
+      [cpu_callback = std::move(cpu_callback)](
+          void** outputs, std::vector<PjRtChunk> inputs) {
+        return cpu_callback->PrepareAndCall(outputs, std::move(inputs));
+      };
   return tsl::RCReference<PyHostSendAndRecvLoadedHostCallback>(
       tsl::MakeRef<PyHostSendAndRecvLoadedHostCallback>(
           ifrt_client, std::move(host_callback), callable, operand_shapes,
@@ -249,6 +249,14 @@ StatusOr<DevicePutResult> HandleNumpyArray(py::handle h, ifrt::Client* client,
         [py_buffer_ref{
             std::move(py_buffer_ref)}]() { /* keeps py_buffer_ref alive */ };
     host_buffer_semantics = ifrt::Client::HostBufferSemantics::kZeroCopy;
+  } else if (options.immutable_until_transfer_completes) {
+    std::shared_ptr<PythonRefManager::ManagedPyObjects> py_buffer_ref =
+        GlobalPyRefManager()->ManageReference(std::move(array));
+    on_done_with_host_buffer =
+        [py_buffer_ref{
+            std::move(py_buffer_ref)}]() { /* keeps py_buffer_ref alive */ };
+    host_buffer_semantics =
+        ifrt::Client::HostBufferSemantics::kImmutableUntilTransferCompletes;
   }
   // Must release the GIL before BufferFromHostBuffer because backends may
   // decide to block/sleep for device buffer allocation.
@@ -58,6 +58,11 @@ struct DevicePutResult {
 struct DevicePutOptions {
   bool squash_64bit_types = false;
   bool allow_zero_copy = true;
+  // If zero-copy is not allowed, whether the caller promises not to mutate
+  // NumPy arrays until their transfer completes. This lets DevicePut return as
+  // soon as the transfer is enqueued instead of waiting for the runtime to be
+  // done with the host buffer, so that transfers of several arrays overlap.
+  bool immutable_until_transfer_completes = false;
 };
 StatusOr<DevicePutResult> DevicePut(pybind11::handle arg, ifrt::Client* client,
                                     ifrt::Device* to_device,
@@ -273,6 +273,152 @@ void PyTreeDef::Flatten(py::handle handle, std::vector<py::object>& leaves,
   FlattenImpl(handle, leaves, leaf_predicate);
 }
 
+bool PyTreeDef::FlattenLike(py::handle handle,
+                            absl::InlinedVector<py::object, 2>& leaves,
+                            const PyTreeDef& expected) {
+  DCHECK(traversal_.empty());
+  DCHECK_EQ(registry_, expected.registry_);
+  if (expected.traversal_.empty()) {
+    return false;
+  }
+  traversal_ = expected.traversal_;
+  const size_t start_num_leaves = leaves.size();
+  PyTypeObject* leaf_type = nullptr;
+  if (!FlattenLikeImpl(handle, leaves, traversal_.size() - 1, leaf_type)) {
+    traversal_.clear();
+    leaves.resize(start_num_leaves);
+    return false;
+  }
+  return true;
+}
+
+bool PyTreeDef::FlattenLikeImpl(py::handle handle,
+                                absl::InlinedVector<py::object, 2>& leaves,
+                                int index, PyTypeObject*& leaf_type) {
+  Node& node = traversal_[index];
+
+  // Children are stored before their parent in the post-order traversal;
+  // collect the index of each child's root node.
+  absl::InlinedVector<int, 4> children(node.arity);
+  int child = index - 1;
+  for (int i = node.arity - 1; i >= 0; --i) {
+    children[i] = child;
+    child -= traversal_[child].num_nodes;
+  }
+
+  switch (node.kind) {
+    case PyTreeKind::kLeaf: {
+      PyTypeObject* type = Py_TYPE(handle.ptr());
+      if (type != leaf_type) {
+        const PyTreeRegistry::Registration* custom;
+        if (registry_->KindOfObject(handle, &custom) != PyTreeKind::kLeaf) {
+          return false;
+        }
+        // Namedtuples are identified by an attribute rather than their type,
+        // so only cache non-tuple types.
+        if (!PyTuple_Check(handle.ptr())) {
+          leaf_type = type;
+        }
+      }
+      leaves.push_back(py::reinterpret_borrow<py::object>(handle));
+      return true;
+    }
+    case PyTreeKind::kNone:
+      return handle.is_none();
+    case PyTreeKind::kTuple:
+      if (!PyTuple_CheckExact(handle.ptr()) ||
+          PyTuple_GET_SIZE(handle.ptr()) != node.arity) {
+        return false;
+      }
+      for (int i = 0; i < node.arity; ++i) {
+        if (!FlattenLikeImpl(PyTuple_GET_ITEM(handle.ptr(), i), leaves,
+                             children[i], leaf_type)) {
+          return false;
+        }
+      }
+      return true;
+    case PyTreeKind::kList:
+      if (!PyList_CheckExact(handle.ptr()) ||
+          PyList_GET_SIZE(handle.ptr()) != node.arity) {
+        return false;
+      }
+      for (int i = 0; i < node.arity; ++i) {
+        if (!FlattenLikeImpl(PyList_GET_ITEM(handle.ptr(), i), leaves,
+                             children[i], leaf_type)) {
+          return false;
+        }
+      }
+      return true;
+    case PyTreeKind::kDict:
+      if (!PyDict_CheckExact(handle.ptr()) ||
+          PyDict_GET_SIZE(handle.ptr()) != node.arity) {
+        return false;
+      }
+      // A dict of the same size containing all the expected keys has exactly
+      // the expected keys, and thus the same sorted order.
+      for (int i = 0; i < node.arity; ++i) {
+        PyObject* value = PyDict_GetItemWithError(
+            handle.ptr(), node.sorted_dict_keys[i].ptr());
+        if (value == nullptr) {
+          if (PyErr_Occurred()) {
+            throw py::error_already_set();
+          }
+          return false;
+        }
+        if (!FlattenLikeImpl(value, leaves, children[i], leaf_type)) {
+          return false;
+        }
+      }
+      return true;
+    case PyTreeKind::kNamedTuple:
+      if (handle.get_type().ptr() != node.node_data.ptr() ||
+          PyTuple_GET_SIZE(handle.ptr()) != node.arity) {
+        return false;
+      }
+      for (int i = 0; i < node.arity; ++i) {
+        if (!FlattenLikeImpl(PyTuple_GET_ITEM(handle.ptr(), i), leaves,
+                             children[i], leaf_type)) {
+          return false;
+        }
+      }
+      return true;
+    case PyTreeKind::kCustom: {
+      if (handle.get_type().ptr() != node.custom->type.ptr()) {
+        return false;
+      }
+      py::tuple out = py::cast<py::tuple>(node.custom->to_iterable(handle));
+      if (out.size() != 2) {
+        throw xla::XlaRuntimeError(
+            "PyTree custom to_iterable function should return a pair");
+      }
+      if (node.node_data.not_equal(out[1])) {
+        return false;
+      }
+      node.node_data = out[1];
+      int i = 0;
+      for (py::handle entry : py::cast<py::iterable>(out[0])) {
+        if (i >= node.arity ||
+            !FlattenLikeImpl(entry, leaves, children[i], leaf_type)) {
+          return false;
+        }
+        ++i;
+      }
+      return i == node.arity;
+    }
+  }
+  return false;
+}
+
+int PyTreeDef::Traverse(visitproc visit, void* arg) const {
+  for (const Node& node : traversal_) {
+    Py_VISIT(node.node_data.ptr());
+    for (const py::object& key : node.sorted_dict_keys) {
+      Py_VISIT(key.ptr());
+    }
+  }
+  return 0;
+}
+
 /*static*/ std::pair<std::vector<pybind11::object>, std::unique_ptr<PyTreeDef>>
 PyTreeDef::Flatten(pybind11::handle x,
                    std::optional<pybind11::function> leaf_predicate,
@@ -1062,6 +1208,25 @@ void BuildPytreeSubmodule(py::module& m) {
         return std::make_pair(std::move(leaves), std::move(def));
       },
       py::arg("tree"), py::arg("leaf_predicate") = std::nullopt);
+  registry.def(
+      "flatten_like",
+      [](std::shared_ptr<PyTreeRegistry> registry, pybind11::handle x,
+         const PyTreeDef& expected)
+          -> std::optional<std::pair<std::vector<py::object>, PyTreeDef>> {
+        if (expected.registry() != registry.get()) {
+          throw std::invalid_argument(
+              "Expected PyTreeDef must come from the same registry");
+        }
+        absl::InlinedVector<py::object, 2> leaves;
+        PyTreeDef def(std::move(registry));
+        if (!def.FlattenLike(x, leaves, expected)) {
+          return std::nullopt;
+        }
+        return std::make_pair(
+            std::vector<py::object>(leaves.begin(), leaves.end()),
+            std::move(def));
+      },
+      py::arg("tree"), py::arg("expected"));
   registry.def("register_node", &PyTreeRegistry::Register);
   registry.def("__reduce__",
                [](py::object self) { return self.attr("__name__"); });
@@ -135,6 +135,22 @@ class PyTreeDef {
                absl::InlinedVector<pybind11::object, 2>& leaves,
                std::optional<pybind11::function> leaf_predicate = std::nullopt);
 
+  // Flattens `handle` into `leaves` and this (empty) PyTreeDef, assuming that
+  // it has the same structure as `expected`, e.g. the arguments of the previous
+  // call of a jitted function. Rather than rebuilding the traversal, the nodes
+  // of `expected` are checked against `handle`: container types are compared
+  // by identity and dict keys are looked up instead of sorted, so the registry
+  // is only consulted for leaves. Returns false, leaving `leaves` and this
+  // PyTreeDef unchanged, if the structures differ, in which case the caller
+  // should fall back to Flatten().
+  bool FlattenLike(pybind11::handle handle,
+                   absl::InlinedVector<pybind11::object, 2>& leaves,
+                   const PyTreeDef& expected);
+
+  // Visits the Python objects held by this PyTreeDef, for the tp_traverse GC
+  // method of the objects that own it.
+  int Traverse(visitproc visit, void* arg) const;
+
   // Tests whether the given list is a flat list of leaves.
   static bool AllLeaves(PyTreeRegistry* registry, const pybind11::iterable& x);
 
@@ -260,6 +276,13 @@ class PyTreeDef {
   void FlattenImpl(pybind11::handle handle, T& leaves,
                    const std::optional<pybind11::function>& leaf_predicate);
 
+  // Recursive helper used to implement FlattenLike(), matching `handle`
+  // against the subtree rooted at `traversal_[index]`. `leaf_type` caches a
+  // non-tuple type already known to be a leaf.
+  bool FlattenLikeImpl(pybind11::handle handle,
+                       absl::InlinedVector<pybind11::object, 2>& leaves,
+                       int index, PyTypeObject*& leaf_type);
+
   template <typename T>
   pybind11::object UnflattenImpl(T leaves) const;
 
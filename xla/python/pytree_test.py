@@ -87,6 +87,39 @@ class PyTreeTest(absltest.TestCase):
     self.roundtrip_node_data(ExampleType(field0=o, field1=o))
     self.roundtrip_node_data(ExampleType2(field0=o, field1=o))
 
+  def testFlattenLikeMatchesFlatten(self):
+    o = object()
+    expected = registry.flatten(
+        ({"a": o, "b": [o, None]}, ExampleType(o, o), ExampleType2(o, (o,)))
+    )[1]
+    # The dict keys are inserted in a different order, but are still sorted.
+    tree = ({"b": [2, None], "a": 1}, ExampleType(3, 4), ExampleType2(5, (6,)))
+    result = registry.flatten_like(tree, expected)
+    self.assertIsNotNone(result)
+    leaves, treedef = result
+    self.assertEqual(leaves, [1, 2, 3, 4, 5, 6])
+    self.assertEqual(treedef, expected)
+    self.assertEqual((leaves, treedef), registry.flatten(tree))
+
+  def testFlattenLikeRejectsDifferentStructures(self):
+    o = object()
+    expected = registry.flatten(({"a": o}, [o, o], ExampleType(o, o)))[1]
+    for tree in [
+        ({"b": 1}, [2, 3], ExampleType(4, 5)),
+        ({"a": 1}, [2], ExampleType(4, 5)),
+        ({"a": 1}, (2, 3), ExampleType(4, 5)),
+        ({"a": 1}, [2, 3], (4, 5)),
+        ({"a": 1}, [2, 3], ExampleType(4, (5,))),
+        ({"a": 1}, [2, None], ExampleType(4, 5)),
+        ({"a": 1, "b": 2}, [2, 3], ExampleType(4, 5)),
+    ]:
+      self.assertIsNone(registry.flatten_like(tree, expected), tree)
+
+  def testFlattenLikeRequiresSameRegistry(self):
+    expected = pytree.default_registry().flatten((1, 2))[1]
+    with self.assertRaises(ValueError):
+      registry.flatten_like((1, 2), expected)
+
 
 if __name__ == "__main__":
   absltest.main()
@@ -21,9 +21,11 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/hash/hash.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/types/span.h"
 #include "pybind11/pytypes.h"  // from @pybind11
 #include "xla/python/exceptions.h"
 #include "xla/python/python_ref_manager.h"
@@ -35,8 +37,50 @@ namespace py = pybind11;
 
 bool Traceback::enabled_ = true;
 
-Traceback::Traceback() {
+namespace {
+
+using FrameSpan = absl::Span<const std::pair<PyCodeObject*, int>>;
+
+// Hashes and compares interned tracebacks by their frames, and allows looking
+// them up by a span of frames.
+struct InternedTracebackHash {
+  using is_transparent = void;
+  size_t operator()(FrameSpan frames) const { return absl::HashOf(frames); }
+  size_t operator()(const Traceback* traceback) const {
+    return (*this)(FrameSpan(traceback->raw_frames()));
+  }
+};
+
+struct InternedTracebackEq {
+  using is_transparent = void;
+  static FrameSpan Frames(FrameSpan frames) { return frames; }
+  static FrameSpan Frames(const Traceback* traceback) {
+    return traceback->raw_frames();
+  }
+  template <typename A, typename B>
+  bool operator()(const A& a, const B& b) const {
+    return Frames(a) == Frames(b);
+  }
+};
+
+using InternedTracebacks =
+    absl::flat_hash_set<Traceback*, InternedTracebackHash, InternedTracebackEq>;
+
+// The live tracebacks returned by Traceback::Get(). Protected by GIL.
+InternedTracebacks& GetInternedTracebacks() {
+  static auto* tracebacks = new InternedTracebacks();
+  return *tracebacks;
+}
+
+}  // namespace
+
+Traceback::Traceback() : Traceback(CaptureFrames()) {}
+
+Traceback::Traceback(RawFrames frames) : frames_(std::move(frames)) {}
+
+Traceback::RawFrames Traceback::CaptureFrames() {
   DCHECK(PyGILState_Check());
+  RawFrames frames;
   PyThreadState* thread_state = PyThreadState_GET();
 
 #if PY_VERSION_HEX < 0x030b0000
@@ -52,27 +96,43 @@ Traceback::Traceback() {
   for (PyFrameObject* py_frame = thread_state->frame; py_frame != nullptr;
        py_frame = py_frame->f_back) {
     Py_INCREF(py_frame->f_code);
-    frames_.emplace_back(py_frame->f_code, py_frame->f_lasti * kLastiWordBytes);
+    frames.emplace_back(py_frame->f_code, py_frame->f_lasti * kLastiWordBytes);
   }
 #else   // PY_VERSION_HEX < 0x030b0000
   PyFrameObject* next;
   for (PyFrameObject* py_frame = PyThreadState_GetFrame(thread_state);
        py_frame != nullptr; py_frame = next) {
-    frames_.emplace_back(PyFrame_GetCode(py_frame), PyFrame_GetLasti(py_frame));
+    frames.emplace_back(PyFrame_GetCode(py_frame), PyFrame_GetLasti(py_frame));
     next = PyFrame_GetBack(py_frame);
     Py_XDECREF(py_frame);
   }
 #endif  // PY_VERSION_HEX < 0x030b0000
+  return frames;
 }
 
 Traceback::~Traceback() {
+  if (interned_) {
+    DCHECK(PyGILState_Check());
+    auto it = GetInternedTracebacks().find(this);
+    if (it != GetInternedTracebacks().end() && *it == this) {
+      GetInternedTracebacks().erase(it);
+    }
+  }
   for (auto& frame : frames_) {
     DCHECK(PyGILState_Check());
     Py_DECREF(frame.first);
   }
 }
 
-Traceback::Traceback(Traceback&& other) : frames_(std::move(other.frames_)) {
+Traceback::Traceback(Traceback&& other) {
+  // The moved-from traceback no longer describes its stack, so other callers
+  // of Get() must not find it. The new traceback is not interned.
+  if (other.interned_) {
+    DCHECK(PyGILState_Check());
+    GetInternedTracebacks().erase(&other);
+    other.interned_ = false;
+  }
+  frames_ = std::move(other.frames_);
   // absl::InlinedVector does not always clear itself if moved. Since we rely on
   // its empty() method to destroy Traceback differently, we explicitly clear
   // here.
@@ -112,7 +172,24 @@ std::shared_ptr<Traceback> Traceback::Get() {
   if (!enabled_) {
     return nullptr;
   }
-  return std::make_shared<Traceback>();
+  RawFrames frames = CaptureFrames();
+  InternedTracebacks& interned = GetInternedTracebacks();
+  auto it = interned.find(FrameSpan(frames));
+  if (it != interned.end()) {
+    // The traceback may be in the process of being destroyed, in which case
+    // it is replaced below.
+    if (std::shared_ptr<Traceback> traceback = (*it)->weak_from_this().lock()) {
+      for (auto& frame : frames) {
+        Py_DECREF(frame.first);
+      }
+      return traceback;
+    }
+    interned.erase(it);
+  }
+  auto traceback = std::make_shared<Traceback>(std::move(frames));
+  traceback->interned_ = true;
+  interned.insert(traceback.get());
+  return traceback;
 }
 
 void Traceback::SafeDestroy(Traceback traceback) {
@@ -29,9 +29,16 @@ limitations under the License.
 namespace xla {
 
 // Represents a Python traceback.
-class Traceback {
+//
+// Tracebacks returned by Get() are interned: while a traceback is alive, Get()
+// returns the same object for an identical stack, so that repeatedly capturing
+// the same stack (e.g. once per buffer created in a loop) costs a pointer
+// rather than a copy of the frames. Frames are only symbolized when inspected.
+class Traceback : public std::enable_shared_from_this<Traceback> {
  public:
-  // Require GIL. Creates a Traceback object that requires destructor to be
+  using RawFrames = absl::InlinedVector<std::pair<PyCodeObject*, int>, 32>;
+
+  // Require GIL. Returns a Traceback object that requires destructor to be
   // invoked with GIL held as well.
   static std::shared_ptr<Traceback> Get();
 
@@ -46,6 +53,9 @@ class Traceback {
 
   // Require GIL.
   Traceback();
+  // Require GIL. Takes ownership of a reference to each code object in
+  // `frames`.
+  explicit Traceback(RawFrames frames);
   // Require GIL.
   ~Traceback();
 
@@ -67,29 +77,32 @@ class Traceback {
   };
   std::vector<Frame> Frames() const;
 
-  const absl::InlinedVector<std::pair<PyCodeObject*, int>, 32>& raw_frames()
-      const {
-    return frames_;
-  }
+  const RawFrames& raw_frames() const { return frames_; }
 
   // Returns the traceback as a fake Python Traceback object, suitable for
   // using as an exception traceback.
   pybind11::object AsPythonTraceback() const;
 
   bool operator==(const Traceback& other) const {
-    return frames_ == other.frames_;
-  }
-  bool operator!=(const Traceback& other) const {
-    return frames_ != other.frames_;
+    return this == &other || frames_ == other.frames_;
   }
+  bool operator!=(const Traceback& other) const { return !(*this == other); }
 
  private:
+  // Returns the frames of the current thread, holding a reference to each
+  // code object.
+  static RawFrames CaptureFrames();
+
   // Each frame is a pair of a code object and a "lasti" instruction location
   // in bytes. The size of _Py_CODEUNIT has changed across different Python
   // versions; the lasti value here has already been multiplied by
   // sizeof(_Py_CODEUNIT) if needed and is suitable for passing to functions
   // like PyCode_Addr2Line().
-  absl::InlinedVector<std::pair<PyCodeObject*, int>, 32> frames_;
+  RawFrames frames_;
+
+  // Whether this traceback is in the table of interned tracebacks, which it
+  // must leave when destroyed.
+  bool interned_ = false;
 
   // Protected by GIL.
   static bool enabled_;
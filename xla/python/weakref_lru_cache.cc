@@ -105,6 +105,7 @@ class WeakrefLRUCache : public std::enable_shared_from_this<WeakrefLRUCache> {
     int64_t misses;
     int64_t maxsize;
     int64_t currsize;
+    int64_t evictions;
   };
 
   struct UnboundWeakrefCacheEntry {
@@ -233,10 +234,12 @@ class WeakrefLRUCache : public std::enable_shared_from_this<WeakrefLRUCache> {
     result.misses = misses_;
     result.maxsize = lru_list_.Capacity();
     result.currsize = lru_list_.Size();
+    result.evictions = lru_list_.Evictions() - evictions_at_clear_;
     return result;
   }
   void Clear() {
     total_queries_ = misses_ = 0;
+    evictions_at_clear_ = lru_list_.Evictions();
     std::vector<std::shared_ptr<Cache>> deferred_deletes;
     for (auto& entry : entries_) {
       deferred_deletes.push_back(std::move(entry.second));
@@ -253,6 +256,8 @@ class WeakrefLRUCache : public std::enable_shared_from_this<WeakrefLRUCache> {
       entries_;
   int64_t misses_ = 0;
   int64_t total_queries_ = 0;
+  // Value of `lru_list_.Evictions()` at the last Clear().
+  int64_t evictions_at_clear_ = 0;
   absl::Mutex mu_;
 };
 
@@ -273,10 +278,12 @@ void BuildWeakrefLRUCacheAPI(pybind11::module& m) {
       .def_readonly("misses", &WeakrefLRUCache::CacheInfo::misses)
       .def_readonly("maxsize", &WeakrefLRUCache::CacheInfo::maxsize)
       .def_readonly("currsize", &WeakrefLRUCache::CacheInfo::currsize)
+      .def_readonly("evictions", &WeakrefLRUCache::CacheInfo::evictions)
       .def("__repr__", [](WeakrefLRUCache::CacheInfo& info) {
         return absl::StrCat(
             "WeakrefLRUCache(hits=", info.hits, ", misses=", info.misses,
-            ", maxsize=", info.maxsize, ", currsize=", info.currsize, ")");
+            ", maxsize=", info.maxsize, ", currsize=", info.currsize,
+            ", evictions=", info.evictions, ")");
       });
   m.def(
       "weakref_lru_cache",
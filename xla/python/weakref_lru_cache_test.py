@@ -94,6 +94,25 @@ class WeakrefLRUCacheTest(absltest.TestCase):
     self.assertEqual(cache(wrkey, kwkey1="b", kwkey2="a"), 2)
     self.assertEqual(cache(wrkey, kwkey2="b", kwkey1="a"), 1)
 
+  def testCacheInfo(self):
+    class WRKey:
+      pass
+
+    cache = xla_client.weakref_lru_cache(lambda: None, lambda obj, x: x, 2)
+
+    wrkey = WRKey()
+    for x in (1, 2, 1, 3):
+      cache(wrkey, x)
+
+    info = cache.cache_info()
+    self.assertEqual(info.hits, 1)
+    self.assertEqual(info.misses, 3)
+    self.assertEqual(info.currsize, 2)
+    self.assertEqual(info.evictions, 1)
+
+    cache.cache_clear()
+    self.assertEqual(cache.cache_info().evictions, 0)
+
 
 if __name__ == "__main__":
   absltest.main()
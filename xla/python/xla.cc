@@ -461,6 +461,8 @@ static void Init(py::module_& m) {
            py::arg("computation"),
            py::arg("compile_options") = CompileOptions(),
            py::arg("host_callbacks") = std::vector<py::capsule>())
+      .def("compile_many", xla::ValueOrThrowWrapper(&PyClient::CompileMany),
+           py::arg("computations"), py::arg("compile_options"))
       .def("serialize_executable",
            xla::ValueOrThrowWrapper(&PyClient::SerializeExecutable))
       .def("deserialize_executable",
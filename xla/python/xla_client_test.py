@@ -217,6 +217,19 @@ def TestFactory(xla_backend,
           self.backend, computation.as_hlo_module())
       self.assertEqual(properties["flops"], 8.0)
 
+    @unittest.skipIf(cloud_tpu or pathways, "not implemented")
+    def testCompileMany(self):
+      module = xla_computation_to_mlir_module(self.ExampleComputation())
+      executables = self.backend.compile_many(
+          [module, module],
+          [xla_client.CompileOptions(), xla_client.CompileOptions()])
+      self.assertLen(executables, 2)
+      for executable in executables:
+        hlo_modules = executable.hlo_modules()
+        self.assertLen(hlo_modules, 1)
+        self.assertTrue(
+            hlo_modules[0].to_string().startswith("HloModule acomputation"))
+
     def testFingerprint(self):
       computation = self.ExampleComputation()
       executable = self.backend.compile(
@@ -2546,6 +2559,17 @@ def TestFactory(xla_backend,
         self.assertEqual(frames[i - 1].function_name, "AnotherFunction")
         self.assertEqual(frames[i + 1].function_name, "testNestedFunction")
 
+    def testIdenticalStacksShareTraceback(self):
+
+      def AFunction():
+        return xla_client.Traceback.get_traceback()
+
+      with xla_client.tracebacks(enabled=True):
+        tbs = [AFunction() for _ in range(2)]
+        self.assertIs(tbs[0], tbs[1])
+        # A different call site is a different stack.
+        self.assertNotEqual(tbs[0], AFunction())
+
     def testPythonTracebackHasCorrectLineNumbers(self):
       def B():
         return xla_client.Traceback.get_traceback()
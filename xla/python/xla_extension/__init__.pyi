@@ -456,6 +456,10 @@ class Client:
       self,
       computation: Union[str, bytes],
       compile_options: CompileOptions = ..., host_callbacks: Sequence[Any] = ...) -> LoadedExecutable: ...
+  def compile_many(
+      self,
+      computations: Sequence[Union[str, bytes]],
+      compile_options: Sequence[CompileOptions]) -> List[LoadedExecutable]: ...
   def serialize_executable(self, executable: LoadedExecutable) -> bytes: ...
   def deserialize_executable(
       self, serialized: bytes,
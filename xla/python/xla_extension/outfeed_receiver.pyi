@@ -30,6 +30,8 @@ def start(
     backends: Sequence[Client],
     max_queue_size_bytes: int = ...,
     compile_options: Optional[xla_extension.ExecutableBuildOptions] = ...,
+    max_callback_batch_size: int = ...,
+    max_callback_batch_delay_us: int = ...,
 ) -> OutfeedReceiverForPython:
   ...
 
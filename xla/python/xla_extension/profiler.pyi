@@ -25,6 +25,9 @@ def register_plugin_profiler(c_api: Any) -> None: ...
 
 def get_profiled_instructions_proto(tensorboard_dir: str) -> bytes: ...
 def get_fdo_profile(xspace: bytes) -> bytes: ...
+def update_profile_store(
+    tensorboard_dir: str, store_dir: str, new_cost_weight: float = ...
+) -> None: ...
 
 class ProfilerSession:
   def __init__(self, options: Optional[ProfileOptions] = ...) -> None: ...
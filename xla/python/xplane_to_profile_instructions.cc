@@ -22,16 +22,21 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/hlo.pb.h"
 #include "xla/status.h"
 #include "xla/xla.pb.h"
 #include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
 #include "tsl/platform/types.h"
 #include "tsl/profiler/convert/xla_op_utils.h"
 #include "tsl/profiler/protobuf/xplane.pb.h"
@@ -175,6 +180,16 @@ void GetXPlaneHloModuleInfo(
   });
 }
 
+// Splits a cost name of the form `<fingerprint>::<hlo name>`.
+std::optional<std::pair<std::string, std::string>> SplitCostName(
+    absl::string_view cost_name) {
+  std::vector<std::string> split_names = absl::StrSplit(cost_name, kCostNameSep);
+  if (split_names.size() != 2) {
+    return std::nullopt;
+  }
+  return std::make_pair(std::move(split_names[0]), std::move(split_names[1]));
+}
+
 }  // namespace
 
 Status ConvertXplaneUnderLogdirToProfiledInstructionsProto(
@@ -247,4 +262,74 @@ Status ConvertXplaneToProfiledInstructionsProto(
   return OkStatus();
 }
 
+Status UpdateProfileStore(
+    const tensorflow::profiler::ProfiledInstructionsProto&
+        profiled_instructions_proto,
+    const std::string& store_dir, double new_cost_weight) {
+  if (new_cost_weight <= 0.0 || new_cost_weight > 1.0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "new_cost_weight must be in (0, 1], got ", new_cost_weight));
+  }
+
+  // Group the new costs by module fingerprint.
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, double>>
+      costs_by_fingerprint;
+  for (const auto& cost : profiled_instructions_proto.costs()) {
+    std::optional<std::pair<std::string, std::string>> split_name =
+        SplitCostName(cost.name());
+    if (!split_name.has_value()) continue;
+    costs_by_fingerprint[split_name->first][split_name->second] =
+        cost.cost_us();
+  }
+
+  tsl::Env* env = tsl::Env::Default();
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(store_dir));
+  for (auto& [fingerprint, new_costs] : costs_by_fingerprint) {
+    std::string path =
+        ProfilerJoinPath(store_dir, absl::StrCat(fingerprint, ".pb"));
+
+    // Blend the costs of instructions that are already in the store and keep
+    // the ones that weren't sampled this time.
+    tensorflow::profiler::ProfiledInstructionsProto merged;
+    if (env->FileExists(path).ok()) {
+      tensorflow::profiler::ProfiledInstructionsProto stored;
+      TF_RETURN_IF_ERROR(ReadBinaryProto(env, path, &stored));
+      for (const auto& cost : stored.costs()) {
+        auto* merged_cost = merged.add_costs();
+        merged_cost->set_name(cost.name());
+        auto it = new_costs.find(cost.name());
+        if (it == new_costs.end()) {
+          merged_cost->set_cost_us(cost.cost_us());
+          continue;
+        }
+        merged_cost->set_cost_us(new_cost_weight * it->second +
+                                 (1.0 - new_cost_weight) * cost.cost_us());
+        new_costs.erase(it);
+      }
+      *merged.mutable_latencies() = stored.latencies();
+    }
+    std::vector<std::pair<std::string, double>> added(new_costs.begin(),
+                                                      new_costs.end());
+    absl::c_sort(added);
+    for (const auto& [name, cost_us] : added) {
+      auto* merged_cost = merged.add_costs();
+      merged_cost->set_name(name);
+      merged_cost->set_cost_us(cost_us);
+    }
+
+    // Write through a temporary file, so that concurrent compilations never
+    // read a partially written profile.
+    std::string tmp_path = path;
+    if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+      return absl::InternalError(
+          absl::StrCat("Couldn't create a temporary file name for ", path));
+    }
+    TF_RETURN_IF_ERROR(WriteBinaryProto(env, tmp_path, merged));
+    TF_RETURN_IF_ERROR(env->RenameFile(tmp_path, path));
+    VLOG(1) << "Updated profile " << path << " with " << merged.costs_size()
+            << " costs";
+  }
+  return OkStatus();
+}
+
 }  // namespace xla
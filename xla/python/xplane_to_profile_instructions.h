@@ -47,6 +47,21 @@ Status ConvertXplaneUnderLogdirToProfiledInstructionsProto(
     const std::string& logdir, tensorflow::profiler::ProfiledInstructionsProto*
                                    profiled_instructions_proto);
 
+// Merges the fingerprinted costs of `profiled_instructions_proto` into the
+// profile store in `store_dir`. The store holds one `<fingerprint>.pb` file
+// per HLO module, which is the layout the GPU latency hiding scheduler reads
+// when --xla_gpu_pgle_profile_file_or_directory_path points to `store_dir`,
+// so the next compilation of a profiled module picks up the new costs.
+//
+// Costs of instructions already in the store are blended with the new ones as
+// `new_cost_weight * new + (1 - new_cost_weight) * old`, so that a sequence of
+// sampled steps converges to their typical latencies. Costs without a
+// fingerprint can't be attributed to a module and are skipped.
+Status UpdateProfileStore(
+    const tensorflow::profiler::ProfiledInstructionsProto&
+        profiled_instructions_proto,
+    const std::string& store_dir, double new_cost_weight = 0.5);
+
 }  // namespace xla
 
 #endif  // XLA_PYTHON_XPLANE_TO_PROFILE_INSTRUCTIONS_H_
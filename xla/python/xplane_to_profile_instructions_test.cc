@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "xla/service/hlo.pb.h"
 #include "xla/tests/verified_hlo_module.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/test.h"
 #include "tsl/profiler/convert/xla_op_utils.h"
 #include "tsl/profiler/protobuf/profiled_instructions.pb.h"
@@ -263,5 +264,34 @@ TEST(XplaneToProfiledInstructionsProtoTest,
   EXPECT_EQ(profile_proto.costs(0).name(), "08a5::custom-call");
 }
 
+TEST(XplaneToProfiledInstructionsProtoTest, UpdateProfileStore) {
+  std::string store_dir = testing::TempDir() + "/profile_store";
+  tensorflow::profiler::ProfiledInstructionsProto profile_proto;
+  auto* cost = profile_proto.add_costs();
+  cost->set_name("08a5::custom-call");
+  cost->set_cost_us(10);
+  // Costs without a fingerprint can't be attributed to a module.
+  cost = profile_proto.add_costs();
+  cost->set_name("fusion");
+  cost->set_cost_us(5);
+  EXPECT_TRUE(UpdateProfileStore(profile_proto, store_dir).ok());
+
+  std::string path = tsl::profiler::ProfilerJoinPath(store_dir, "08a5.pb");
+  tensorflow::profiler::ProfiledInstructionsProto stored;
+  EXPECT_TRUE(ReadBinaryProto(tsl::Env::Default(), path, &stored).ok());
+  ASSERT_EQ(stored.costs_size(), 1);
+  EXPECT_EQ(stored.costs(0).name(), "custom-call");
+  EXPECT_EQ(stored.costs(0).cost_us(), 10);
+
+  // New samples are blended with the stored costs.
+  profile_proto.mutable_costs(0)->set_cost_us(20);
+  EXPECT_TRUE(UpdateProfileStore(profile_proto, store_dir,
+                                 /*new_cost_weight=*/0.25)
+                  .ok());
+  EXPECT_TRUE(ReadBinaryProto(tsl::Env::Default(), path, &stored).ok());
+  ASSERT_EQ(stored.costs_size(), 1);
+  EXPECT_EQ(stored.costs(0).cost_us(), 12.5);
+}
+
 }  // namespace
 }  // namespace xla
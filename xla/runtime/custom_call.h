@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <any>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -130,6 +131,22 @@ class CustomCall {
     // attributes, as the custom call handler uses pre-computed attributes
     // offsets based on the binding specification.
     bool exact_attrs = true;
+
+    // Skip attribute names checks on repeated calls from the same call site,
+    // and only check attribute types on them. Encoded attributes are constants
+    // of the compiled executable, so after their names were found at the
+    // expected offsets, they will be found there again. Only used with
+    // `RuntimeChecks::kDefault` and exact attributes.
+    //
+    // The handler remembers only the last call site that passed the checks,
+    // so this pays off for handlers called repeatedly from one site (e.g. in a
+    // loop). Calls alternating between several sites check names every time.
+    //
+    // Call sites are identified by the address of their encoded attributes,
+    // so executables calling the handler must not be destroyed while the
+    // handler is still in use (e.g. process-wide executables), otherwise a new
+    // executable might reuse the address with different attributes.
+    bool check_attr_names_once = false;
   };
 
   static constexpr bool CheckNames(RuntimeChecks checks) {
@@ -979,11 +996,31 @@ class CustomCallHandler : public CustomCall {
     using ArgsIs = typename internal::IndexArgs<0, Ts...>::Is;
     using RetsIs = typename internal::IndexRets<0, Ts...>::Is;
 
-    return call(decoded_args, decoded_attrs, decoded_rets, user_data,
-                diagnostic, Is{}, ArgsIs{}, RetsIs{});
+    // Skip attribute names checks if we already checked them for the call
+    // site (see `Options::check_attr_names_once`).
+    if constexpr (checks == RuntimeChecks::kDefault) {
+      if (check_attr_names_once_) {
+        if (LLVM_LIKELY(checked_attrs_.load(std::memory_order_relaxed) ==
+                        attrs))
+          return call<RuntimeChecks::kLess>(
+              decoded_args, decoded_attrs, decoded_rets, user_data, diagnostic,
+              Is{}, ArgsIs{}, RetsIs{});
+
+        LogicalResult result =
+            call<checks>(decoded_args, decoded_attrs, decoded_rets, user_data,
+                         diagnostic, Is{}, ArgsIs{}, RetsIs{});
+        if (succeeded(result))
+          checked_attrs_.store(attrs, std::memory_order_relaxed);
+        return result;
+      }
+    }
+
+    return call<checks>(decoded_args, decoded_attrs, decoded_rets, user_data,
+                        diagnostic, Is{}, ArgsIs{}, RetsIs{});
   }
 
-  template <size_t... Is, size_t... ArgsIs, size_t... RetsIs>
+  template <RuntimeChecks decode_checks, size_t... Is, size_t... ArgsIs,
+            size_t... RetsIs>
   ABSL_ATTRIBUTE_ALWAYS_INLINE LogicalResult
   call(internal::DecodedArgs args, internal::DecodedAttrs attrs,
        internal::DecodedRets rets, const UserData* user_data,
@@ -1001,7 +1038,7 @@ class CustomCallHandler : public CustomCall {
     // that initializer list will be evaluated left-to-right, and we can rely
     // on correct offsets computation.
     std::tuple<FailureOr<FnArgType<Ts>>...> fn_args = {
-        internal::Decode<Ts, checks>::call(offsets, ctx)...};
+        internal::Decode<Ts, decode_checks>::call(offsets, ctx)...};
 
     // Check if all operands and results were decoded.
     bool all_decoded = (succeeded(std::get<Is>(fn_args)) && ...);
@@ -1066,6 +1103,7 @@ class CustomCallHandler : public CustomCall {
         attrs_(std::move(attrs)),
         values_(std::move(values)),
         opts_(opts),
+        check_attr_names_once_(opts.check_attr_names_once && opts.exact_attrs),
         attrs_idx_(attrs_.size()) {
     // Sort attributes names and remove duplicates. These unique attributes are
     // what we'll be looking for in the encoded custom call attributes.
@@ -1089,6 +1127,11 @@ class CustomCallHandler : public CustomCall {
   std::vector<std::any> values_;
   Options opts_;
 
+  // Encoded attributes of the last call site that passed attribute names
+  // checks, if `check_attr_names_once_` is true.
+  bool check_attr_names_once_;
+  mutable std::atomic<void**> checked_attrs_{nullptr};
+
   // A mapping from the attribute index to its index in the lexicographically
   // sorter vector of attribute names. Attributes passed in the custom call
   // handler sorted by the name, we use this index to efficiently find the
@@ -1146,6 +1146,43 @@ TEST(CustomCallTest, OptionalAttr) {
   EXPECT_EQ(attrs[1], 42);
 }
 
+TEST(CustomCallTest, CheckAttrNamesOnce) {
+  absl::string_view source = R"(
+    func.func private @custom_call()
+      attributes { rt.dynamic, rt.custom_call = "test.custom_call" }
+
+    func.func @test() {
+      call @custom_call() { attr0 = 1 : i64, attr1 = 2 : i64 }: () -> ()
+      call @custom_call() { attr0 = 3 : i64, attr1 = 4 : i64 }: () -> ()
+      call @custom_call() { attr0 = 1 : i64, attr1 = 2 : i64 }: () -> ()
+      call @custom_call() { attr0 = 5 : i64, attr2 = 6 : i64 }: () -> ()
+      return
+    }
+  )";
+
+  std::vector<int64_t> attrs;
+
+  auto handler = [&](int64_t attr0, int64_t attr1) -> LogicalResult {
+    attrs.push_back(attr0);
+    attrs.push_back(attr1);
+    return success();
+  };
+
+  CustomCall::Options opts;
+  opts.check_attr_names_once = true;
+
+  CustomCallRegistry registry = {[&](DynamicCustomCallRegistry& registry) {
+    registry.Register(CustomCall::Bind("test.custom_call", opts)
+                          .Attr<int64_t>("attr0")
+                          .Attr<int64_t>("attr1")
+                          .To(handler));
+  }};
+
+  // Call sites with new attributes are checked again, so the last call fails.
+  EXPECT_FALSE(CompileAndExecute(source, /*args=*/{}, registry).ok());
+  EXPECT_EQ(attrs, std::vector<int64_t>({1, 2, 3, 4, 1, 2}));
+}
+
 TEST(CustomCallTest, StateArg) {
   absl::string_view source = R"(
     func.func private @custom_call()
@@ -1751,11 +1788,13 @@ BENCHMARK(BM_I32AttrX1None);
 // Custom call with twelve i32 attributes.
 //===----------------------------------------------------------------------===//
 
-template <CustomCall::RuntimeChecks checks>
+template <CustomCall::RuntimeChecks checks, bool check_attr_names_once = false>
 static bool I32AttrX12(ExecutionContext* ctx, void** args, void** attrs,
                        void** rets) {
+  CustomCall::Options opts;
+  opts.check_attr_names_once = check_attr_names_once;
   static auto* handler =
-      CustomCall::Bind("test.custom_call")
+      CustomCall::Bind("test.custom_call", opts)
           .Attr<int32_t>("attr0")
           .Attr<int32_t>("attr1")
           .Attr<int32_t>("attr2")
@@ -1781,7 +1820,7 @@ static bool I32AttrX12(ExecutionContext* ctx, void** args, void** attrs,
   return succeeded(Executable::Call(ctx, *handler, args, attrs, rets));
 }
 
-template <CustomCall::RuntimeChecks checks>
+template <CustomCall::RuntimeChecks checks, bool check_attr_names_once = false>
 static void I32AttrX12(bm::State& state) {
   absl::string_view source = R"(
     func.func private @custom_call()
@@ -1799,14 +1838,16 @@ static void I32AttrX12(bm::State& state) {
   )";
 
   BenchmarkCustomCall(state, source, {}, "test.custom_call",
-                      &I32AttrX12<checks>);
+                      &I32AttrX12<checks, check_attr_names_once>);
 }
 
 static void BM_I32AttrX12All(bm::State& s) { I32AttrX12<all>(s); }
 static void BM_I32AttrX12None(bm::State& s) { I32AttrX12<none>(s); }
 static void BM_I32AttrX12Types(bm::State& s) { I32AttrX12<less>(s); }
+static void BM_I32AttrX12Once(bm::State& s) { I32AttrX12<all, true>(s); }
 
 BENCHMARK(BM_I32AttrX12All);
+BENCHMARK(BM_I32AttrX12Once);
 BENCHMARK(BM_I32AttrX12Types);
 BENCHMARK(BM_I32AttrX12None);
 
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -26,6 +27,7 @@ limitations under the License.
 #include "absl/strings/str_join.h"
 #include "llvm/ADT/STLExtras.h"
 #include "xla/mlir/runtime/utils/constraints.h"
+#include "xla/runtime/async_runtime.h"
 #include "xla/runtime/errors.h"
 
 namespace xla {
@@ -96,6 +98,16 @@ static bool HasStaticShapeOperands(const FunctionType& signature) {
   task();
 }
 
+/*static*/ JitExecutable::CompilationTaskRunner
+JitExecutable::AsyncCompilationTaskRunner(AsyncTaskRunner* runner) {
+  return [runner](size_t, absl::Span<const ArgumentConstraint>, ArgumentsRef,
+                  CompilationTask task, UserData) {
+    // Async task runner requires copyable tasks.
+    auto shared_task = std::make_shared<CompilationTask>(std::move(task));
+    runner->Schedule([shared_task]() { (*shared_task)(); });
+  };
+}
+
 /*static*/ StatusOr<JitExecutable> JitExecutable::Instantiate(
     std::string_view mlir_module, Options opts,
     absl::Span<const std::string_view> exported,
@@ -184,8 +196,14 @@ JitExecutable::JitExecutable(std::string_view mlir_module, Options opts,
       functions_(std::move(functions)),
       has_default_executable_(default_executable.has_value()),
       memory_region_name_(memory_region_name),
-      runner_(std::move(runner)),
-      specializations_(std::make_unique<Specializations>()) {
+      runner_(std::move(runner)) {
+  if (opts_.max_specializations > 0) {
+    lru_specializations_ =
+        std::make_unique<LruSpecializations>(opts_.max_specializations);
+  } else {
+    specializations_ = std::make_unique<Specializations>();
+  }
+
   // Initialize default executable if it is available.
   if (has_default_executable_) {
     default_executable_ =
@@ -225,17 +243,21 @@ static llvm::hash_code CombineWithValueConstrainedOperands(
 // pre-compiled specialization. Maybe use atomic pointers (multiple atomic
 // pointers?) to keep the most commonly used specialization available without
 // doing a lookup in the AsyncValuesCache.
-//
-// TODO(ezhulenev): The number of specializations should be bounded, ideally we
-// should only keep N most common specializations, and for everything else
-// fall back on the default executable. However what to do if default executable
-// is not available, and the number of specializations is above N?
 StatusOr<AsyncValuePtr<Executable>> JitExecutable::GetExecutable(
     ArgumentsRef arguments, UserData user_data,
     const SpecializationListener* listener) {
+  StatusOr<AsyncValueRef<Executable>> executable =
+      GetExecutableRef(arguments, std::move(user_data), listener);
+  if (!executable.ok()) return executable.status();
+  return executable->AsPtr();
+}
+
+StatusOr<AsyncValueRef<Executable>> JitExecutable::GetExecutableRef(
+    ArgumentsRef arguments, UserData user_data,
+    const SpecializationListener* listener) {
   // Do not try to compile specialized executable if it is explicitly disabled.
   if (opts_.specialization == Specialization::kDisabled)
-    return DefaultExecutable();
+    return default_executable_.CopyRef();
 
   // TODO(ezhulenev): Add support for specialization and recompilation for any
   // function exported by the executable.
@@ -288,14 +310,21 @@ StatusOr<AsyncValuePtr<Executable>> JitExecutable::GetExecutable(
         CombineWithValueConstrainedOperands(*hash, arguments, fn.constraints);
 
   // Maybe return Executable from the cache.
-  if (auto cached = specializations_->Find(*hash)) {
+  AsyncValueRef<Executable> cached;
+  if (lru_specializations_) {
+    cached = lru_specializations_->Find(*hash);
+  } else if (auto ptr = specializations_->Find(*hash)) {
+    cached = ptr.CopyRef();
+  }
+
+  if (cached) {
     // Always use specialized executable if required by the compilation options.
     if (opts_.specialization == Specialization::kAlways) return cached;
 
     // Fall back on default executable if the specialization is not yet
     // available.
     if (has_default_executable_ && !cached.IsAvailable())
-      return DefaultExecutable();
+      return default_executable_.CopyRef();
 
     return cached;
   }
@@ -325,17 +354,28 @@ StatusOr<AsyncValuePtr<Executable>> JitExecutable::GetExecutable(
 
   // Allocate a placeholder for the compiled specialization only after we are
   // ready to dispatch the compilation task.
-  Specializations::Entry entry = specializations_->Allocate(*hash);
-
-  // We lost the race; some other invocation will do the compilation.
-  if (!entry.allocated) return entry.ptr;
-
-  // Get the specialization id from the size of the specializations cache.
-  size_t specialization = entry.size - 1;
+  AsyncValueRef<Executable> allocated;
+  size_t specialization;
+  if (lru_specializations_) {
+    LruSpecializations::Entry entry = lru_specializations_->Allocate(*hash);
+    // We lost the race; some other invocation will do the compilation.
+    if (!entry.allocated) return std::move(entry.ref);
+    allocated = std::move(entry.ref);
+    // Evicted specializations keep their ids, so that recompiled ones don't
+    // reuse them.
+    specialization = entry.num_allocated - 1;
+  } else {
+    Specializations::Entry entry = specializations_->Allocate(*hash);
+    // We lost the race; some other invocation will do the compilation.
+    if (!entry.allocated) return entry.ptr.CopyRef();
+    allocated = entry.ptr.CopyRef();
+    // Get the specialization id from the size of the specializations cache.
+    specialization = entry.size - 1;
+  }
 
   // Construct the task that will do the specialized executable compilation.
   auto compile = CompilationTask(
-      [compiler = std::move(*compiler), ref = entry.ptr.CopyRef(),
+      [compiler = std::move(*compiler), ref = allocated.CopyRef(),
        memory_region_name = memory_region_name_, specialization]() mutable {
         StatusOr<Executable> executable = JitCompiler::Compile(
             std::move(compiler), memory_region_name, specialization);
@@ -354,14 +394,15 @@ StatusOr<AsyncValuePtr<Executable>> JitExecutable::GetExecutable(
 
   // Use the default executable while we are compiling a specialized version if
   // this is not explicitly disabled by the compilation options.
-  if (opts_.specialization == Specialization::kAlways)
-    return entry.ptr;
-  else
-    return has_default_executable_ ? DefaultExecutable() : entry.ptr;
+  if (opts_.specialization == Specialization::kAlways ||
+      !has_default_executable_)
+    return allocated;
+  return default_executable_.CopyRef();
 }
 
 AsyncValueRef<Chain> JitExecutable::AllExecutablesCompiled() const {
-  return specializations_->AllAvailable();
+  return lru_specializations_ ? lru_specializations_->AllAvailable()
+                              : specializations_->AllAvailable();
 }
 
 }  // namespace runtime
@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_RUNTIME_JIT_EXECUTABLE_H_
 
 #include <any>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -28,12 +29,15 @@ limitations under the License.
 #include "xla/mlir/runtime/transforms/jit_compiler.h"
 #include "xla/runtime/async_values_cache.h"  // IWYU pragma: keep
 #include "xla/runtime/constraints.h"
+#include "xla/runtime/lru_async_values_cache.h"
 #include "tsl/concurrency/async_value_ref.h"
 #include "tsl/concurrency/chain.h"
 
 namespace xla {
 namespace runtime {
 
+class AsyncTaskRunner;
+
 // JitExecutable owns a default executable compiled from the MLIR module (if
 // operands constraints allow that), and orchestrates on-demand re-compilation
 // for specific argument ranks, shapes or values depending on the operands
@@ -59,6 +63,16 @@ class JitExecutable {
     // What level of specialization is enabled at runtime.
     Specialization specialization = Specialization::kAlways;
 
+    // The maximum number of specialized executables kept alive by the
+    // JitExecutable. When a new specialization is compiled, the least recently
+    // used ones are evicted, and will be recompiled if needed again. Zero means
+    // that the number of specializations is not bounded.
+    //
+    // If the number of specializations is bounded, callers must use
+    // `GetExecutableRef`, because executables returned by `GetExecutable` can
+    // be destroyed by a concurrent call that evicts them.
+    size_t max_specializations = 0;
+
     // Options for the XLA runtime JitCompiler.
     JitCompiler::Options compiler;
   };
@@ -88,6 +102,14 @@ class JitExecutable {
       absl::Span<const ArgumentConstraint> constraints, ArgumentsRef arguments,
       CompilationTask task, UserData user_data);
 
+  // Returns a compilation task runner that compiles specializations in the
+  // background on the given async task runner. With
+  // `Specialization::kEnabled`, callers keep using the default executable
+  // until the specialized one is available, and never wait for compilation.
+  // The async task runner must outlive the JitExecutable.
+  static CompilationTaskRunner AsyncCompilationTaskRunner(
+      AsyncTaskRunner* runner);
+
   // TODO(ezhulenev): Currently exported functions must be defined explicitly by
   // the user. It should be possible to define exported functions implicitly by
   // having `rt.export` operations in the compiled module, and export new
@@ -144,6 +166,12 @@ class JitExecutable {
       ArgumentsRef arguments, UserData user_data = {},
       const SpecializationListener* listener = nullptr);
 
+  // Same as `GetExecutable`, but returns a reference that keeps the executable
+  // alive even if it is evicted from the specializations cache.
+  absl::StatusOr<tsl::AsyncValueRef<Executable>> GetExecutableRef(
+      ArgumentsRef arguments, UserData user_data = {},
+      const SpecializationListener* listener = nullptr);
+
   // Returns an async value that becomes ready when all executables owned by
   // this JitExecutable are compiled (no pending compilation tasks).
   tsl::AsyncValueRef<tsl::Chain> AllExecutablesCompiled() const;
@@ -229,9 +257,12 @@ class JitExecutable {
   // A custom runner for compiling specializations.
   CompilationTaskRunner runner_;
 
-  // Executables specialized for the arguments shapes or/and values.
+  // Executables specialized for the arguments shapes or/and values. Only one
+  // of the caches is used, depending on `opts_.max_specializations`.
   using Specializations = AsyncValuesCache<llvm::hash_code, Executable>;
+  using LruSpecializations = LruAsyncValuesCache<llvm::hash_code, Executable>;
   std::unique_ptr<Specializations> specializations_;
+  std::unique_ptr<LruSpecializations> lru_specializations_;
 };
 
 }  // namespace runtime
@@ -0,0 +1,166 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_RUNTIME_LRU_ASYNC_VALUES_CACHE_H_
+#define XLA_RUNTIME_LRU_ASYNC_VALUES_CACHE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "tsl/concurrency/async_value.h"
+#include "tsl/concurrency/async_value_ref.h"
+#include "tsl/concurrency/chain.h"
+
+namespace xla {
+namespace runtime {
+
+// A cache of async values with the same interface as `AsyncValuesCache`, that
+// keeps at most `capacity` values. When a new value is allocated in a full
+// cache, the least recently used available values are evicted. Values that
+// are not yet available (e.g. executables that are still compiling) are never
+// evicted, so the cache can temporarily grow above its capacity.
+//
+// Because values can be evicted at any time, the cache returns async value
+// references instead of pointers, and an evicted value is destroyed only after
+// all users dropped their references.
+template <typename Key, typename Value>
+class LruAsyncValuesCache {
+ public:
+  struct Entry;
+
+  explicit LruAsyncValuesCache(size_t capacity) : capacity_(capacity) {
+    assert(capacity > 0 && "capacity must be positive");
+  }
+
+  // Returns a reference to the cached value if it exists, otherwise returns
+  // an empty reference. Marks the value as the most recently used one.
+  tsl::AsyncValueRef<Value> Find(Key key);
+
+  // Allocates an async value in the unconstructed state to store the cached
+  // value with the given key, evicting least recently used values if the cache
+  // is full.
+  //
+  // The `entry.allocated` value is `true` if the new async value was allocated,
+  // and the caller is responsible for eventually setting the error or emplacing
+  // the value. If it is false, then it means that the storage was already
+  // allocated, and someone else will eventually update it.
+  //
+  // The returned `entry.num_allocated` value is the number of async values ever
+  // allocated by the cache, including the evicted ones, and can be used to
+  // assign unique ids to the cached values.
+  Entry Allocate(Key key);
+
+  // Returns an async value that becomes available once all entries in the
+  // cache are available.
+  tsl::AsyncValueRef<tsl::Chain> AllAvailable() const;
+
+  // Returns the number of cached values.
+  size_t size() const;
+
+  struct Entry {
+    tsl::AsyncValueRef<Value> ref;
+    bool allocated;
+    size_t num_allocated;
+  };
+
+ private:
+  // Cached values with their position in the `lru_` list.
+  struct CachedValue {
+    tsl::AsyncValueRef<Value> ref;
+    typename std::list<Key>::iterator lru_it;
+  };
+
+  void EvictIfFull() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const size_t capacity_;
+
+  mutable absl::Mutex mu_;
+  llvm::DenseMap<Key, CachedValue> cache_ ABSL_GUARDED_BY(mu_);
+  // Keys of the cached values, from the most to the least recently used.
+  std::list<Key> lru_ ABSL_GUARDED_BY(mu_);
+  size_t num_allocated_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+template <typename Key, typename Value>
+tsl::AsyncValueRef<Value> LruAsyncValuesCache<Key, Value>::Find(Key key) {
+  absl::MutexLock lock(&mu_);
+  auto it = cache_.find(key);
+  if (it == cache_.end()) return {};
+
+  CachedValue& cached = it->getSecond();
+  lru_.splice(lru_.begin(), lru_, cached.lru_it);
+  return cached.ref.CopyRef();
+}
+
+template <typename Key, typename Value>
+auto LruAsyncValuesCache<Key, Value>::Allocate(Key key) -> Entry {
+  absl::MutexLock lock(&mu_);
+  auto it = cache_.find(key);
+  if (it != cache_.end())
+    return {it->getSecond().ref.CopyRef(), false, num_allocated_};
+
+  EvictIfFull();
+
+  lru_.push_front(key);
+  auto emplaced = cache_.try_emplace(
+      key, CachedValue{tsl::MakeUnconstructedAsyncValueRef<Value>(),
+                       lru_.begin()});
+  assert(emplaced.second && "emplace must be successful");
+  ++num_allocated_;
+  return {emplaced.first->getSecond().ref.CopyRef(), true, num_allocated_};
+}
+
+template <typename Key, typename Value>
+void LruAsyncValuesCache<Key, Value>::EvictIfFull() {
+  auto it = lru_.end();
+  while (cache_.size() >= capacity_ && it != lru_.begin()) {
+    --it;
+    auto cached = cache_.find(*it);
+    if (!cached->getSecond().ref.IsAvailable()) continue;
+    cache_.erase(cached);
+    it = lru_.erase(it);
+  }
+}
+
+template <typename Key, typename Value>
+tsl::AsyncValueRef<tsl::Chain> LruAsyncValuesCache<Key, Value>::AllAvailable()
+    const {
+  absl::MutexLock lock(&mu_);
+
+  llvm::SmallVector<tsl::AsyncValue*> avs;
+  avs.reserve(cache_.size());
+  for (auto& it : cache_) avs.push_back(it.getSecond().ref.GetAsyncValue());
+
+  tsl::AsyncValueRef<tsl::Chain> chain =
+      tsl::MakeConstructedAsyncValueRef<tsl::Chain>();
+  tsl::RunWhenReady(avs, [chain]() { chain.SetStateConcrete(); });
+  return chain;
+}
+
+template <typename Key, typename Value>
+size_t LruAsyncValuesCache<Key, Value>::size() const {
+  absl::MutexLock lock(&mu_);
+  return cache_.size();
+}
+
+}  // namespace runtime
+}  // namespace xla
+
+#endif  // XLA_RUNTIME_LRU_ASYNC_VALUES_CACHE_H_
@@ -0,0 +1,92 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/runtime/lru_async_values_cache.h"
+
+#include "tsl/concurrency/async_value_ref.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace runtime {
+namespace {
+
+using Cache = LruAsyncValuesCache<int, int>;
+
+TEST(LruAsyncValuesCacheTest, AllocateAndFind) {
+  Cache cache(2);
+  EXPECT_FALSE(cache.Find(1));
+
+  Cache::Entry entry = cache.Allocate(1);
+  EXPECT_TRUE(entry.allocated);
+  EXPECT_EQ(entry.num_allocated, 1);
+  entry.ref.emplace(42);
+
+  Cache::Entry again = cache.Allocate(1);
+  EXPECT_FALSE(again.allocated);
+  EXPECT_EQ(again.ref.get(), 42);
+
+  tsl::AsyncValueRef<int> found = cache.Find(1);
+  ASSERT_TRUE(found);
+  EXPECT_EQ(found.get(), 42);
+}
+
+TEST(LruAsyncValuesCacheTest, EvictsLeastRecentlyUsed) {
+  Cache cache(2);
+  cache.Allocate(1).ref.emplace(1);
+  tsl::AsyncValueRef<int> evicted = cache.Allocate(2).ref;
+  evicted.emplace(2);
+
+  // Use the first value, so that the second one becomes the least recently
+  // used one.
+  EXPECT_TRUE(cache.Find(1));
+
+  Cache::Entry entry = cache.Allocate(3);
+  EXPECT_TRUE(entry.allocated);
+  EXPECT_EQ(entry.num_allocated, 3);
+  entry.ref.emplace(3);
+
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_TRUE(cache.Find(1));
+  EXPECT_FALSE(cache.Find(2));
+  EXPECT_TRUE(cache.Find(3));
+
+  // References to evicted values stay valid.
+  EXPECT_EQ(evicted.get(), 2);
+}
+
+TEST(LruAsyncValuesCacheTest, DoesNotEvictUnavailableValues) {
+  Cache cache(1);
+  Cache::Entry pending = cache.Allocate(1);
+
+  // The only cached value is not available yet, so the cache grows.
+  Cache::Entry entry = cache.Allocate(2);
+  entry.ref.emplace(2);
+  EXPECT_EQ(cache.size(), 2);
+
+  tsl::AsyncValueRef<tsl::Chain> all_available = cache.AllAvailable();
+  EXPECT_FALSE(all_available.IsAvailable());
+  pending.ref.emplace(1);
+  EXPECT_TRUE(all_available.IsAvailable());
+
+  // Now that both values are available, the least recently used ones are
+  // evicted to make room for the next one.
+  cache.Allocate(3).ref.emplace(3);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_TRUE(cache.Find(3));
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace xla
@@ -493,6 +493,14 @@ int64_t GetReduceFlops(const HloInstruction* reduce) {
 void AlgebraicSimplifierVisitor::ResetState(HloComputation* computation) {
   ResetVisitStates();
   computation_ = computation;
+  worklist_.clear();
+  in_worklist_.clear();
+  if (options_.use_worklist()) {
+    first_new_id_ = 0;
+    for (const HloInstruction* instruction : computation->instructions()) {
+      first_new_id_ = std::max(first_new_id_, instruction->unique_id() + 1);
+    }
+  }
 }
 
 bool AlgebraicSimplifierVisitor::Run(HloComputation* computation,
@@ -500,9 +508,102 @@ bool AlgebraicSimplifierVisitor::Run(HloComputation* computation,
                                      AlgebraicSimplifier* simplifier) {
   ResetState(computation);
   TF_CHECK_OK(computation->Accept(this));
+  if (options_.use_worklist()) {
+    TF_CHECK_OK(ProcessWorklist());
+  }
   return changed();
 }
 
+Status AlgebraicSimplifierVisitor::Preprocess(HloInstruction* hlo) {
+  if (options_.use_worklist()) {
+    operands_before_visit_.assign(hlo->operands().begin(),
+                                  hlo->operands().end());
+    users_before_visit_.assign(hlo->users().begin(), hlo->users().end());
+    num_changes_before_visit_ = num_changes();
+  }
+  return DfsHloRewriteVisitor::Preprocess(hlo);
+}
+
+Status AlgebraicSimplifierVisitor::Postprocess(HloInstruction* hlo) {
+  if (options_.use_worklist() && num_changes() != num_changes_before_visit_) {
+    EnqueueRewriteNeighborhood(hlo);
+  }
+  return DfsHloRewriteVisitor::Postprocess(hlo);
+}
+
+void AlgebraicSimplifierVisitor::Enqueue(HloInstruction* hlo) {
+  if (hlo->parent() == computation_ && !computation_->IsMarkedAsDead(hlo) &&
+      in_worklist_.insert(hlo).second) {
+    worklist_.push_back(hlo);
+  }
+}
+
+void AlgebraicSimplifierVisitor::EnqueueRewriteNeighborhood(
+    HloInstruction* hlo) {
+  // New instructions are connected to the operands of `hlo` or to the users it
+  // had, or to `hlo` itself if it was changed in place.
+  std::vector<HloInstruction*> created;
+  absl::flat_hash_set<HloInstruction*> seen;
+  auto add_if_created = [&](HloInstruction* instruction) {
+    if (instruction->unique_id() >= first_new_id_ &&
+        seen.insert(instruction).second) {
+      created.push_back(instruction);
+    }
+  };
+  auto enqueue_with_neighbors = [&](HloInstruction* instruction) {
+    Enqueue(instruction);
+    for (HloInstruction* operand : instruction->operands()) {
+      add_if_created(operand);
+    }
+    for (HloInstruction* user : instruction->users()) {
+      add_if_created(user);
+    }
+  };
+  for (HloInstruction* operand : operands_before_visit_) {
+    enqueue_with_neighbors(operand);
+  }
+  for (HloInstruction* user : users_before_visit_) {
+    enqueue_with_neighbors(user);
+  }
+  if (!computation_->IsMarkedAsDead(hlo)) {
+    enqueue_with_neighbors(hlo);
+  }
+  int max_id = first_new_id_ - 1;
+  for (size_t i = 0; i < created.size(); ++i) {
+    HloInstruction* instruction = created[i];
+    max_id = std::max(max_id, instruction->unique_id());
+    enqueue_with_neighbors(instruction);
+    for (HloInstruction* operand : instruction->operands()) {
+      Enqueue(operand);
+    }
+    for (HloInstruction* user : instruction->users()) {
+      Enqueue(user);
+    }
+  }
+  first_new_id_ = max_id + 1;
+}
+
+Status AlgebraicSimplifierVisitor::ProcessWorklist() {
+  // Rewrites that undo each other would never empty the worklist, so stop
+  // after a few visits per instruction and leave the rest to HloPassFix.
+  constexpr int64_t kMaxVisitsPerInstruction = 8;
+  int64_t budget =
+      kMaxVisitsPerInstruction * std::max<int64_t>(
+                                     computation_->instruction_count(), 1);
+  while (!worklist_.empty() && budget-- > 0) {
+    HloInstruction* hlo = worklist_.front();
+    worklist_.pop_front();
+    in_worklist_.erase(hlo);
+    if (computation_->IsMarkedAsDead(hlo)) {
+      continue;
+    }
+    TF_RETURN_IF_ERROR(Preprocess(hlo));
+    TF_RETURN_IF_ERROR(hlo->Visit(this));
+    TF_RETURN_IF_ERROR(Postprocess(hlo));
+  }
+  return OkStatus();
+}
+
 bool AlgebraicSimplifierVisitor::SameShape(const HloInstruction* lhs,
                                            const HloInstruction* rhs) const {
   return SameShape(lhs->shape(), rhs->shape());
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <array>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -26,6 +27,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "xla/hlo/ir/dfs_hlo_visitor_with_default.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -92,6 +94,13 @@ class AlgebraicSimplifierOptions {
     associative_reordering_threshold_ = associative_reordering_threshold;
   }
 
+  // If true, the simplifier revisits the neighborhood of every instruction it
+  // rewrites until nothing changes, so that a single run reaches a fixed point
+  // without HloPassFix sweeping over the whole computation again.
+  void set_use_worklist(bool use_worklist) { use_worklist_ = use_worklist; }
+
+  bool use_worklist() const { return use_worklist_; }
+
   double associative_reordering_threshold() const {
     return associative_reordering_threshold_;
   }
@@ -266,6 +275,7 @@ class AlgebraicSimplifierOptions {
   bool enable_unconditional_reduce_of_concat_replacement_{true};
   bool use_associative_reordering_{false};
   double associative_reordering_threshold_{2.0};
+  bool use_worklist_{false};
   Metadata metadata_;
 };
 
@@ -403,6 +413,11 @@ class AlgebraicSimplifierVisitor : public DfsHloRewriteVisitor {
 
   Status HandleMap(HloInstruction* map) override;
 
+  // In worklist mode, enqueue the neighborhood of the instructions whose
+  // handlers changed the computation.
+  Status Preprocess(HloInstruction* hlo) override;
+  Status Postprocess(HloInstruction* hlo) override;
+
   // Runs the visitor on a computation.
   bool Run(HloComputation* computation,
            const AlgebraicSimplifierOptions& options,
@@ -602,6 +617,19 @@ class AlgebraicSimplifierVisitor : public DfsHloRewriteVisitor {
   // Useful when we want to use the same visitor over multiple computations.
   void ResetState(HloComputation* computation);
 
+  // Visits the instructions in `worklist_` until it is empty, or until the
+  // instructions were visited a few times each on average.
+  Status ProcessWorklist();
+
+  // Adds `hlo` to the worklist unless it is already there or was removed.
+  void Enqueue(HloInstruction* hlo);
+
+  // Enqueues the instructions whose operands or users may have changed while
+  // handling `hlo`: `hlo` itself, its operands and users before and after it
+  // was handled, and the instructions created by the handler together with
+  // their operands and users.
+  void EnqueueRewriteNeighborhood(HloInstruction* hlo);
+
   // Current HloComputation instance the AlgebraicSimplifierVisitor is
   // traversing.
   HloComputation* computation_;
@@ -609,6 +637,22 @@ class AlgebraicSimplifierVisitor : public DfsHloRewriteVisitor {
   // Cached computation for adding two scalars of a given type.
   absl::flat_hash_map<PrimitiveType, HloComputation*> scalar_add_computations_;
 
+  // Instructions to visit again in worklist mode, in the order they were
+  // enqueued.
+  std::deque<HloInstruction*> worklist_;
+  absl::flat_hash_set<HloInstruction*> in_worklist_;
+
+  // Operands and users of the instruction being visited before its handler
+  // ran, and the number of changes made until then.
+  std::vector<HloInstruction*> operands_before_visit_;
+  std::vector<HloInstruction*> users_before_visit_;
+  int64_t num_changes_before_visit_ = 0;
+
+  // Instructions with at least this unique id were created since the last
+  // rewrite neighborhood was enqueued, as ids are allocated in increasing
+  // order.
+  int first_new_id_ = 0;
+
   AlgebraicSimplifier* simplifier_ = nullptr;
 };
 
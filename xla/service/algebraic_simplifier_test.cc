@@ -9840,5 +9840,26 @@ GetUpcastDowncastTestCases() {
 INSTANTIATE_TEST_SUITE_P(AllTypes, AlgebraicSimplifierUpcastDowncastTest,
                          ::testing::ValuesIn(GetUpcastDowncastTestCases()));
 
+// Sinking the broadcast past each negate creates a new negate that a single
+// sweep doesn't visit, so without the worklist this takes several runs.
+TEST_F(AlgebraicSimplifierTest, WorklistReachesFixedPointInOneRun) {
+  const char* kModuleStr = R"(
+    HloModule m
+    test {
+      p = f32[] parameter(0)
+      b = f32[4] broadcast(p), dimensions={}
+      n0 = f32[4] negate(b)
+      ROOT n1 = f32[4] negate(n0)
+    }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto m, ParseAndReturnVerifiedModule(kModuleStr));
+  AlgebraicSimplifierOptions options = default_options_;
+  options.set_use_worklist(true);
+  ASSERT_TRUE(AlgebraicSimplifier(options).Run(m.get()).value());
+  EXPECT_THAT(m->entry_computation()->root_instruction(),
+              GmockMatch(m::Broadcast(m::Parameter(0))));
+  EXPECT_FALSE(AlgebraicSimplifier(options).Run(m.get()).value());
+}
+
 }  // namespace
 }  // namespace xla
@@ -110,30 +110,33 @@ StatusOr<StreamPool::Ptr> Backend::BorrowStream(int device_ordinal,
   return BorrowStream(executor, priority);
 }
 
+StreamPool* Backend::GetOrCreateStreamPool(se::StreamExecutor* executor) {
+  absl::MutexLock l(&mu_);
+  std::unique_ptr<StreamPool>& pool = stream_pools_[executor];
+  if (pool == nullptr) pool = std::make_unique<StreamPool>();
+  return pool.get();
+}
+
 StatusOr<StreamPool::Ptr> Backend::BorrowStream(se::StreamExecutor* executor,
                                                 se::StreamPriority priority) {
-  absl::MutexLock l(&mu_);
-  if (!stream_pools_.contains(executor)) {
-    stream_pools_.emplace(executor, std::make_unique<StreamPool>());
-  }
-  return stream_pools_.at(executor)->BorrowStream(executor, priority);
+  // Stream pools are never destroyed before the backend, so we can borrow
+  // streams without holding the backend lock.
+  return GetOrCreateStreamPool(executor)->BorrowStream(executor, priority);
 }
 
 StatusOr<std::vector<StreamPool::Ptr>> Backend::BorrowStreams(
     int device_ordinal, int num_streams, se::StreamPriority priority) {
-  absl::MutexLock l(&mu_);
   TF_ASSIGN_OR_RETURN(auto executor, stream_executor(device_ordinal));
-  if (!stream_pools_.contains(executor)) {
-    stream_pools_.emplace(executor, std::make_unique<StreamPool>());
-  }
+  return GetOrCreateStreamPool(executor)->BorrowStreams(executor, num_streams,
+                                                        priority);
+}
 
-  std::vector<StreamPool::Ptr> ptrs;
-  for (int i = 0; i < num_streams; i++) {
-    StreamPool::Ptr ptr =
-        stream_pools_.at(executor)->BorrowStream(executor, priority);
-    ptrs.push_back(std::move(ptr));
-  }
-  return ptrs;
+Status Backend::PrewarmStreams(int device_ordinal, int num_streams,
+                               se::StreamPriority priority) {
+  TF_ASSIGN_OR_RETURN(auto executor, stream_executor(device_ordinal));
+  GetOrCreateStreamPool(executor)->PrewarmStreams(executor, num_streams,
+                                                  priority);
+  return OkStatus();
 }
 
 Backend::Backend(se::Platform* platform, Compiler* compiler,
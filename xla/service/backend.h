@@ -132,6 +132,13 @@ class Backend {
       int device_ordinal, int num_streams,
       se::StreamPriority priority = se::StreamPriority::Default);
 
+  // Creates streams with the given priority in the pool of the device, so
+  // that the first `num_streams` streams borrowed with this priority don't
+  // have to be created on the hot path.
+  Status PrewarmStreams(
+      int device_ordinal, int num_streams,
+      se::StreamPriority priority = se::StreamPriority::Default);
+
   // Returns a function to borrow streams with a given priority,
   // as `BorrowStreams` above does.
   // Purely for convenience, the caller could rather make this anonymous
@@ -186,6 +193,9 @@ class Backend {
   // Vector of stream executors. stream_executors_[0] is the default executor.
   std::vector<se::StreamExecutor*> stream_executors_;
 
+  // Returns the stream pool of `executor`, creating it if needed.
+  StreamPool* GetOrCreateStreamPool(se::StreamExecutor* executor);
+
   absl::Mutex mu_;
 
   // Mapping from stream executor to stream pools, used by `BorrowStream` above.
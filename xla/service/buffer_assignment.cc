@@ -23,6 +23,7 @@ limitations under the License.
 #include <iterator>
 #include <memory>
 #include <ostream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -949,6 +950,225 @@ std::string BufferAssignment::BufferInfoString() const {
   return binfo;
 }
 
+namespace {
+
+// Returns whether recomputing `instruction` at the next use of its result is
+// about as cheap as keeping the result live.
+bool IsCheapToRecompute(const HloInstruction& instruction) {
+  switch (instruction.opcode()) {
+    case HloOpcode::kBroadcast:
+    case HloOpcode::kIota:
+    case HloOpcode::kConstant:
+    case HloOpcode::kReshape:
+    case HloOpcode::kBitcast:
+    case HloOpcode::kTranspose:
+    case HloOpcode::kCopy:
+      return true;
+    default:
+      return instruction.IsElementwise() && instruction.operand_count() <= 2;
+  }
+}
+
+}  // namespace
+
+MemoryReportProto BufferAssignment::ToMemoryReportProto() const {
+  // Maximum number of rematerialization and offloading candidates reported.
+  constexpr int kMaxCandidates = 10;
+
+  MemoryReportProto report;
+  report.set_total_allocation_bytes(stats_.total_allocation_bytes);
+  report.set_fragmentation_bytes(stats_.total_fragmentation_bytes);
+  if (hlo_live_range_ == nullptr) {
+    return report;
+  }
+  const auto& instruction_schedule = hlo_live_range_->instruction_schedule();
+  const auto& buffer_live_ranges = hlo_live_range_->buffer_live_ranges();
+
+  // The values of an HloBuffer share their slice, so the live range of the
+  // slice is the union of the live ranges of the values.
+  struct LiveBuffer {
+    const BufferAllocation* allocation;
+    const HloBuffer* buffer;
+    BufferAllocation::OffsetSize offset_size;
+    const HloValue* defining_value;
+    int64_t start;
+    int64_t end;
+  };
+  absl::btree_map<HloBuffer::Id, LiveBuffer> live_buffers;
+  for (const BufferAllocation& allocation : allocations_) {
+    if (allocation.is_thread_local()) {
+      continue;
+    }
+    for (const auto& [value, offset_size] : allocation.assigned_buffers()) {
+      auto live_range = buffer_live_ranges.find(value);
+      if (live_range == buffer_live_ranges.end()) {
+        continue;
+      }
+      const HloBuffer& buffer =
+          alias_analysis().GetBufferContainingValue(*value);
+      auto [it, inserted] = live_buffers.try_emplace(
+          buffer.id(),
+          LiveBuffer{&allocation, &buffer, offset_size, value,
+                     live_range->second.start, live_range->second.end});
+      LiveBuffer& live_buffer = it->second;
+      if (!inserted) {
+        if (live_range->second.start < live_buffer.start) {
+          live_buffer.start = live_range->second.start;
+          live_buffer.defining_value = value;
+        }
+        live_buffer.end = std::max(live_buffer.end, live_range->second.end);
+      }
+    }
+  }
+  if (live_buffers.empty()) {
+    return report;
+  }
+
+  // Sweep over the live range bounds, ends being inclusive, to find the peak.
+  std::vector<std::pair<int64_t, int64_t>> deltas;
+  deltas.reserve(2 * live_buffers.size());
+  for (const auto& [id, live_buffer] : live_buffers) {
+    deltas.emplace_back(live_buffer.start, live_buffer.offset_size.size);
+    deltas.emplace_back(live_buffer.end + 1, -live_buffer.offset_size.size);
+  }
+  absl::c_sort(deltas);
+  int64_t live_bytes = 0;
+  int64_t peak_bytes = -1;
+  int64_t peak_time = 0;
+  for (size_t i = 0; i < deltas.size(); ++i) {
+    live_bytes += deltas[i].second;
+    if (i + 1 < deltas.size() && deltas[i + 1].first == deltas[i].first) {
+      continue;
+    }
+    if (live_bytes > peak_bytes) {
+      peak_bytes = live_bytes;
+      peak_time = deltas[i].first;
+    }
+  }
+  report.set_peak_time(peak_time);
+  report.set_peak_bytes(peak_bytes);
+  const auto& sequence =
+      hlo_live_range_->flattened_instruction_sequence().instructions();
+  if (peak_time < static_cast<int64_t>(sequence.size())) {
+    report.set_peak_instruction_name(sequence[peak_time]->name());
+  }
+
+  std::vector<const LiveBuffer*> peak_buffers;
+  for (const auto& [id, live_buffer] : live_buffers) {
+    if (live_buffer.start <= peak_time && peak_time <= live_buffer.end) {
+      peak_buffers.push_back(&live_buffer);
+    }
+  }
+  absl::c_stable_sort(peak_buffers, [](const LiveBuffer* a,
+                                       const LiveBuffer* b) {
+    return a->offset_size.size > b->offset_size.size;
+  });
+
+  absl::flat_hash_map<std::string, MemoryReportProto::Group> by_op_name;
+  absl::flat_hash_map<std::string, MemoryReportProto::Group> by_category;
+  auto add_to_group = [](auto& groups, const std::string& name, int64_t size) {
+    MemoryReportProto::Group& group = groups[name];
+    group.set_name(name);
+    group.set_size(group.size() + size);
+    group.set_buffer_count(group.buffer_count() + 1);
+  };
+  for (const LiveBuffer* live_buffer : peak_buffers) {
+    const HloInstruction* instruction =
+        live_buffer->defining_value->instruction();
+    MemoryReportProto::Buffer& proto = *report.add_peak_buffers();
+    proto.set_allocation_index(live_buffer->allocation->index());
+    proto.set_offset(live_buffer->offset_size.offset);
+    proto.set_size(live_buffer->offset_size.size);
+    proto.set_instruction_name(instruction->name());
+    *proto.mutable_shape() = live_buffer->defining_value->shape().ToProto();
+    *proto.mutable_metadata() = instruction->metadata();
+    proto.set_definition_time(live_buffer->start);
+    proto.set_end_time(live_buffer->end);
+
+    int64_t next_use_time = -1;
+    for (const HloValue* value : live_buffer->buffer->values()) {
+      for (const HloUse& use : value->GetUses()) {
+        auto it = instruction_schedule.find(use.instruction);
+        if (it != instruction_schedule.end() && it->second > peak_time &&
+            (next_use_time == -1 || it->second < next_use_time)) {
+          next_use_time = it->second;
+        }
+      }
+    }
+    proto.set_next_use_time(next_use_time);
+
+    const BufferAllocation& allocation = *live_buffer->allocation;
+    if (allocation.is_entry_computation_parameter()) {
+      proto.set_category(MemoryReportProto::PARAMETER);
+    } else if (allocation.is_constant()) {
+      proto.set_category(MemoryReportProto::CONSTANT);
+    } else if (allocation.maybe_live_out()) {
+      proto.set_category(MemoryReportProto::OUTPUT);
+    } else if (live_buffer->start < peak_time && next_use_time != -1) {
+      proto.set_category(MemoryReportProto::ACTIVATION);
+    } else {
+      proto.set_category(MemoryReportProto::TEMPORARY);
+    }
+
+    add_to_group(by_op_name,
+                 instruction->metadata().op_name().empty()
+                     ? std::string("<none>")
+                     : instruction->metadata().op_name(),
+                 proto.size());
+    add_to_group(by_category,
+                 MemoryReportProto::Category_Name(proto.category()),
+                 proto.size());
+  }
+
+  auto add_groups = [](auto& groups, auto* protos) {
+    std::vector<MemoryReportProto::Group> sorted;
+    sorted.reserve(groups.size());
+    for (auto& [name, group] : groups) {
+      sorted.push_back(std::move(group));
+    }
+    absl::c_sort(sorted, [](const MemoryReportProto::Group& a,
+                            const MemoryReportProto::Group& b) {
+      return std::make_pair(-a.size(), a.name()) <
+             std::make_pair(-b.size(), b.name());
+    });
+    for (MemoryReportProto::Group& group : sorted) {
+      *protos->Add() = std::move(group);
+    }
+  };
+  add_groups(by_op_name, report.mutable_groups_by_op_name());
+  add_groups(by_category, report.mutable_groups_by_category());
+
+  // Activations are the only buffers whose peak contribution can be avoided
+  // without changing the schedule. Offloading is most useful for large buffers
+  // with a distant next use.
+  std::vector<int64_t> activations;
+  for (int64_t i = 0; i < report.peak_buffers_size(); ++i) {
+    if (report.peak_buffers(i).category() == MemoryReportProto::ACTIVATION) {
+      activations.push_back(i);
+    }
+  }
+  for (int64_t i : activations) {
+    if (report.rematerialization_candidates_size() >= kMaxCandidates) break;
+    const HloInstruction* instruction =
+        peak_buffers[i]->defining_value->instruction();
+    if (IsCheapToRecompute(*instruction)) {
+      report.add_rematerialization_candidates(i);
+    }
+  }
+  auto idle_bytes = [&](int64_t i) {
+    const MemoryReportProto::Buffer& buffer = report.peak_buffers(i);
+    return buffer.size() * (buffer.next_use_time() - peak_time);
+  };
+  absl::c_stable_sort(activations, [&](int64_t a, int64_t b) {
+    return idle_bytes(a) > idle_bytes(b);
+  });
+  for (int64_t i : activations) {
+    if (report.offload_candidates_size() >= kMaxCandidates) break;
+    report.add_offload_candidates(i);
+  }
+  return report;
+}
+
 BufferAssignmentProto BufferAssignment::ToProto() const {
   BufferAssignmentProto proto;
   // NOTE: DataflowAnalysis state is serialized here in BufferAssignment,
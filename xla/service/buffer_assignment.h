@@ -486,6 +486,11 @@ class BufferAssignment {
   std::string ToVerboseString(size_t max_buffers_to_show) const;
   std::string BufferInfoString() const;
 
+  // Returns the buffers live at the peak of the memory use, grouped by op
+  // metadata and by category, along with rematerialization and offloading
+  // candidates. The report is empty if there are no live ranges.
+  MemoryReportProto ToMemoryReportProto() const;
+
   // Convert BufferAssignment to or from a proto.
   BufferAssignmentProto ToProto() const;
   static StatusOr<std::unique_ptr<BufferAssignment>> FromProto(
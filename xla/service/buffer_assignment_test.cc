@@ -2072,6 +2072,51 @@ TEST_F(BufferAssignmentTest, PeakBuffers) {
   EXPECT_THAT(peak_instructions, UnorderedElementsAre(rev, neg, concat));
 }
 
+TEST_F(BufferAssignmentTest, MemoryReport) {
+  // Same sequence as in PeakBuffers: the peak is at the concat, where the
+  // parameter is live along with %rev, %neg and %concat.
+  auto builder = HloComputation::Builder(TestName());
+  auto param = builder.AddInstruction(
+      HloInstruction::CreateParameter(0, f32vec100_, "p"));
+  auto log = builder.AddInstruction(
+      HloInstruction::CreateUnary(f32vec100_, HloOpcode::kLog, param));
+  auto rev = builder.AddInstruction(
+      HloInstruction::CreateReverse(f32vec100_, log, {0}));
+  auto neg = builder.AddInstruction(
+      HloInstruction::CreateUnary(f32vec100_, HloOpcode::kNegate, param));
+  const Shape concat_shape = ShapeUtil::MakeShape(F32, {200});
+  auto concat = builder.AddInstruction(
+      HloInstruction::CreateConcatenate(concat_shape, {rev, neg}, 0));
+  auto root = builder.AddInstruction(HloInstruction::CreateSlice(
+      ShapeUtil::MakeShape(F32, {1}), concat, {0}, {1}, {1}));
+
+  auto module = CreateNewVerifiedModule();
+  module->AddEntryComputation(builder.Build());
+
+  auto buffers = RunBufferAssignmentWithInstructionSequence(
+      module.get(), {param, log, rev, neg, concat, root});
+  MemoryReportProto report = buffers->ToMemoryReportProto();
+
+  EXPECT_EQ(report.peak_instruction_name(), concat->name());
+  EXPECT_EQ(report.peak_bytes(), 2000);
+  ASSERT_EQ(report.peak_buffers_size(), 4);
+  EXPECT_EQ(report.peak_buffers(0).instruction_name(), concat->name());
+  int64_t total_size = 0;
+  for (const MemoryReportProto::Buffer& buffer : report.peak_buffers()) {
+    total_size += buffer.size();
+  }
+  EXPECT_EQ(total_size, report.peak_bytes());
+
+  ASSERT_EQ(report.groups_by_category_size(), 2);
+  EXPECT_EQ(report.groups_by_category(0).name(), "TEMPORARY");
+  EXPECT_EQ(report.groups_by_category(0).size(), 1600);
+  EXPECT_EQ(report.groups_by_category(1).name(), "PARAMETER");
+  EXPECT_EQ(report.groups_by_category(1).size(), 400);
+  // No temporary live at the peak is used after it.
+  EXPECT_TRUE(report.rematerialization_candidates().empty());
+  EXPECT_TRUE(report.offload_candidates().empty());
+}
+
 TEST_F(BufferAssignmentTest, AliasedBuffersShouldntCoexistInPeakBuffers) {
   std::string hlo_text = R"(
 HloModule test_module, is_scheduled=true
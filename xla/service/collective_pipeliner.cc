@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/collective_pipeliner.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -2214,9 +2215,9 @@ static Status TransformLoopBackward(const WhileLoopAnalysis& loop_analysis,
   return OkStatus();
 }
 
-StatusOr<bool> CollectivePipeliner::Run(
-    HloModule* module,
-    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+StatusOr<bool> CollectivePipeliner::RunOnLevel(
+    HloModule* module, int64_t level_to_operate_on,
+    bool insert_non_alias_custom_call) {
   bool changed = false;
   std::vector<HloInstruction*> while_loop_instructions;
   for (HloComputation* computation : module->MakeComputationPostOrder()) {
@@ -2244,7 +2245,7 @@ StatusOr<bool> CollectivePipeliner::Run(
     }
     VLOG(1) << "While iterations: "
             << loop_analysis.GetLoopIterationCount()->ToString();
-    loop_analysis.CollectCollectivesToMove(config_.level_to_operate_on,
+    loop_analysis.CollectCollectivesToMove(level_to_operate_on,
                                            config_.pipelining_direction,
                                            config_.should_process);
     if (loop_analysis.GetMoveInfos().empty()) {
@@ -2263,25 +2264,52 @@ StatusOr<bool> CollectivePipeliner::Run(
     }
     if (config_.pipelining_direction == PipeliningDirection::kForward) {
       TF_RETURN_IF_ERROR(TransformLoopForward(
-          loop_analysis, !config_.last_run, config_.level_to_operate_on,
+          loop_analysis, insert_non_alias_custom_call, level_to_operate_on,
           config_.pipeline_use_tree, config_.process_different_sized_ops,
           config_.should_process, next_channel_id));
     } else if (config_.pipelining_direction ==
                PipeliningDirection::kForwardSink) {
       TF_RETURN_IF_ERROR(TransformLoopForwardSink(
-          loop_analysis, !config_.last_run, config_.level_to_operate_on,
+          loop_analysis, insert_non_alias_custom_call, level_to_operate_on,
           config_.pipeline_use_tree, config_.process_different_sized_ops,
           config_.should_process, next_channel_id));
     } else {
       CHECK_EQ(config_.pipelining_direction, PipeliningDirection::kBackward);
       TF_RETURN_IF_ERROR(TransformLoopBackward(
-          loop_analysis, !config_.last_run, config_.level_to_operate_on,
+          loop_analysis, insert_non_alias_custom_call, level_to_operate_on,
           config_.process_different_sized_ops, config_.should_process,
           next_channel_id));
     }
     ++transformed_loops;
     changed = true;
   }
+  VLOG(1) << "Transformed loops: " << transformed_loops
+          << " and transformed instructions: " << transformed_instructions
+          << " for pipelining direction: "
+          << GetPipelineDirectionString(config_.pipelining_direction)
+          << " at level: " << level_to_operate_on;
+  return changed;
+}
+
+StatusOr<bool> CollectivePipeliner::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  bool changed = false;
+  const int64_t num_levels =
+      std::max<int64_t>(config_.num_levels_to_operate_on, 1);
+  for (int64_t i = 0; i < num_levels; ++i) {
+    const bool last_level = i == num_levels - 1;
+    TF_ASSIGN_OR_RETURN(
+        bool level_changed,
+        RunOnLevel(module, config_.level_to_operate_on + i,
+                   /*insert_non_alias_custom_call=*/!config_.last_run ||
+                       !last_level));
+    changed |= level_changed;
+    // Nothing was marked for the next level.
+    if (!level_changed) {
+      break;
+    }
+  }
   // If this is the last expected run then remove all the custom-calls that we
   // inserted as they shouldn't reach the backend.
   if (config_.last_run) {
@@ -2303,10 +2331,6 @@ StatusOr<bool> CollectivePipeliner::Run(
               instruction));
     }
   }
-  VLOG(1) << "Transformed loops: " << transformed_loops
-          << " and transformed instructions: " << transformed_instructions
-          << " for pipelining direction: "
-          << GetPipelineDirectionString(config_.pipelining_direction);
   return changed;
 }
 
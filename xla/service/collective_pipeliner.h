@@ -75,6 +75,12 @@ class CollectivePipeliner : public HloModulePass {
     bool process_different_sized_ops = false;
     PipeliningDirection pipelining_direction = PipeliningDirection::kForward;
     HloPredicate should_process;
+    // Number of consecutive levels pipelined by a single run, starting at
+    // `level_to_operate_on`. Each level pipelines the collectives feeding the
+    // buffers pipelined by the previous one, pushing chains of collectives one
+    // more iteration ahead. Equivalent to running the pass once per level with
+    // `last_run` only set on the last one.
+    int64_t num_levels_to_operate_on = 1;
   };
   static const char* const kInsertedByPreviousStep;
   static const char* const kSunkByPreviousStep;
@@ -111,6 +117,12 @@ class CollectivePipeliner : public HloModulePass {
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
 
  private:
+  // Pipelines the collectives of `level_to_operate_on` out of every loop of
+  // the module. `insert_non_alias_custom_call` marks the pipelined values for
+  // the next level.
+  StatusOr<bool> RunOnLevel(HloModule* module, int64_t level_to_operate_on,
+                            bool insert_non_alias_custom_call);
+
   const Config config_;
 };
 
@@ -681,6 +681,76 @@ ENTRY entry {
                         op::GetTupleElement(), op::Constant(), op::Constant()));
 }
 
+TEST_F(CollectivePipelinerTest, TransformWithAgMultipleLevelsInOneRun) {
+  constexpr absl::string_view hlo_string = R"(
+HloModule module
+
+add {
+  lhs = bf16[] parameter(0)
+  rhs = bf16[] parameter(1)
+  ROOT add = bf16[] add(lhs, rhs)
+}
+
+while_cond {
+  param = (s32[], bf16[3,8,128], bf16[3,8,128]) parameter(0)
+  gte = s32[] get-tuple-element(param), index=0
+  constant.1 = s32[] constant(0)
+  ROOT cmp = pred[] compare(gte, constant.1), direction=LT
+}
+
+while_body {
+  param = (s32[], bf16[3,8,128], bf16[3,8,128]) parameter(0)
+  get-tuple-element.394 = s32[] get-tuple-element(param), index=0
+  get-tuple-element.395 = bf16[3,8,128] get-tuple-element(param), index=1
+  get-tuple-element.5 = bf16[3,8,128] get-tuple-element(param), index=2
+  constant.2557 = s32[] constant(1)
+  constant.2561 = s32[] constant(0)
+  add.230 = s32[] add(get-tuple-element.394, constant.2557)
+  dynamic-slice.99 = bf16[1,8,128] dynamic-slice(get-tuple-element.5, get-tuple-element.394, constant.2561, constant.2561), dynamic_slice_sizes={1,8,128}
+  mul = bf16[1,8,128] multiply(dynamic-slice.99, dynamic-slice.99)
+  rs.1 = bf16[1,1,128] reduce-scatter(mul), replica_groups={}, to_apply=add, channel_id=1, dimensions={1}
+  ag.1 = bf16[1,8,128] all-gather(rs.1), replica_groups={}, channel_id=2, dimensions={1}
+  dynamic-update-slice.35 = bf16[3,8,128] dynamic-update-slice(get-tuple-element.395, ag.1, get-tuple-element.394, constant.2561, constant.2561)
+  ROOT tuple = (s32[], bf16[3,8,128], bf16[3,8,128]) tuple(add.230, dynamic-update-slice.35, get-tuple-element.5)
+}
+
+ENTRY entry {
+  c0 = s32[] constant(-8)
+  p0 = bf16[3,8,128] parameter(0)
+  cc = bf16[] constant(0)
+  tuple = (s32[], bf16[3,8,128], bf16[3,8,128]) tuple(c0, p0, p0)
+  while = (s32[], bf16[3,8,128], bf16[3,8,128]) while(tuple), condition=while_cond, body=while_body
+  ROOT gte1 = bf16[3,8,128] get-tuple-element(while), index=1
+}
+)";
+  auto module = ParseAndReturnUnverifiedModule(hlo_string, config_).value();
+  CollectivePipeliner::Config config = {
+      /*level_to_operate_on=*/0,
+      /*max_pipelining_per_loop=*/INT64_MAX,
+      /*last_run=*/true,
+      /*pipeline_use_tree=*/false,
+      /*process_different_sized_ops=*/true,
+      /*direction=*/
+      CollectivePipeliner::PipeliningDirection::kForward,
+      /*should_process=*/IsAllGather,
+      /*num_levels_to_operate_on=*/2,
+  };
+  EXPECT_TRUE(CollectivePipeliner(config).Run(module.get()).value());
+  XLA_VLOG_LINES(1, module->ToString());
+  // Same result as pipelining each level in a separate run, without leftover
+  // markers.
+  auto* root = module->entry_computation()->root_instruction();
+  EXPECT_THAT(root, op::DynamicUpdateSlice(
+                        _, op::AllGather(op::GetTupleElement(op::While())),
+                        op::GetTupleElement(), op::Constant(), op::Constant()));
+  for (HloComputation* computation : module->computations()) {
+    for (HloInstruction* instruction : computation->instructions()) {
+      EXPECT_FALSE(instruction->IsCustomCall(
+          CollectivePipeliner::kInsertedByPreviousStep));
+    }
+  }
+}
+
 TEST_F(CollectivePipelinerTest, PushAgOver) {
   constexpr absl::string_view hlo_string = R"(
 HloModule module, entry_computation_layout={(bf16[3,8,128]{2,1,0})->bf16[3,8,128]{2,1,0}}
@@ -15,12 +15,16 @@ limitations under the License.
 
 #include "xla/service/conditional_to_select.h"
 
+#include <vector>
+
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/service/call_graph.h"
 #include "xla/service/call_inliner.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_creation_utils.h"
+#include "xla/shape_util.h"
 #include "xla/status_macros.h"
 #include "xla/types.h"
 #include "tsl/platform/errors.h"
@@ -29,7 +33,43 @@ limitations under the License.
 
 namespace xla {
 
-static StatusOr<bool> DoConditionalToSelect(HloInstruction* conditional) {
+// Selects between the elements of the tuples `on_true` and `on_false`.
+static StatusOr<HloInstruction*> MakeTupleSelectHlo(
+    HloInstruction* pred, HloInstruction* on_true, HloInstruction* on_false,
+    HloInstruction* derived_from) {
+  if (!on_true->shape().IsTuple()) {
+    return MakeSelectHlo(pred, on_true, on_false, derived_from);
+  }
+  std::vector<HloInstruction*> elements;
+  for (int64_t i = 0; i < ShapeUtil::TupleElementCount(on_true->shape());
+       ++i) {
+    TF_ASSIGN_OR_RETURN(HloInstruction * true_element,
+                        MakeGetTupleElementHlo(on_true, i));
+    TF_ASSIGN_OR_RETURN(HloInstruction * false_element,
+                        MakeGetTupleElementHlo(on_false, i));
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * element,
+        MakeTupleSelectHlo(pred, true_element, false_element, derived_from));
+    elements.push_back(element);
+  }
+  return MaybeMakeTuple(elements);
+}
+
+static StatusOr<bool> DoConditionalToSelect(HloInstruction* conditional,
+                                            bool allow_tuples) {
+  if (conditional->operand(0)->shape().element_type() != PRED) {
+    VLOG(1) << "Not transforming conditional; not a predicated conditional:"
+            << conditional->ToString();
+    return false;
+  }
+  if (conditional->shape().IsTuple() && !allow_tuples) {
+    VLOG(1) << "Not transforming tuples to 'select'";
+    return false;
+  }
+  if (ShapeUtil::HasPrimitiveType(conditional->shape(), TOKEN)) {
+    VLOG(1) << "Not transforming tokens to 'select'";
+    return false;
+  }
   // Only allow conditional to select if the called computations
   // do not have side effects.
   if (conditional->true_computation()->HasSideEffect() ||
@@ -53,19 +93,28 @@ static StatusOr<bool> DoConditionalToSelect(HloInstruction* conditional) {
           conditional->false_computation()));
   conditional->SetupDerivedInstruction(else_call_op);
   HloInstruction* condition = conditional->mutable_operand(0);
-  if (else_call_op->shape().IsTuple()) {
-    VLOG(1) << "Not transforming tuples to 'select'";
-    return false;
-  }
   TF_ASSIGN_OR_RETURN(
       HloInstruction * select_op,
-      MakeSelectHlo(condition, if_call_op, else_call_op, conditional));
+      MakeTupleSelectHlo(condition, if_call_op, else_call_op, conditional));
   TF_RETURN_IF_ERROR(computation->ReplaceInstruction(conditional, select_op));
   TF_RETURN_IF_ERROR(CallInliner::Inline(if_call_op).status());
   TF_RETURN_IF_ERROR(CallInliner::Inline(else_call_op).status());
   return true;
 }
 
+StatusOr<bool> ConditionalToSelect::ShouldPredicate(
+    const HloInstruction* conditional) const {
+  float branches_seconds = 0;
+  for (const HloComputation* branch : conditional->branch_computations()) {
+    HloCostAnalysis cost_analysis(predication_options_->cost_analysis_options);
+    TF_RETURN_IF_ERROR(branch->Accept(&cost_analysis));
+    branches_seconds += cost_analysis.optimal_seconds();
+  }
+  VLOG(2) << "Branches of " << conditional->name() << " take "
+          << branches_seconds << "s";
+  return branches_seconds <= predication_options_->conditional_overhead_seconds;
+}
+
 StatusOr<bool> ConditionalToSelect::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
@@ -75,15 +124,29 @@ StatusOr<bool> ConditionalToSelect::Run(
   TF_RETURN_IF_ERROR(
       call_graph->VisitNodes([&](const CallGraphNode& node) -> Status {
         std::vector<HloInstruction*> ToInline;
-        if (node.context() != CallContext::kEmbedded) {
+        const bool embedded = node.context() == CallContext::kEmbedded;
+        if (!embedded && (!predication_options_.has_value() ||
+                          node.context() != CallContext::kControlFlow ||
+                          !HloInstruction::IsThreadIncluded(
+                              node.computation()->execution_thread(),
+                              execution_threads))) {
           return OkStatus();
         }
         for (const CallSite& callsite : node.callsites()) {
           if (callsite.instruction()->opcode() == HloOpcode::kConditional) {
             VLOG(1) << "Visiting conditional: " << callsite.ToString();
             HloInstruction* conditional = callsite.instruction();
-            TF_ASSIGN_OR_RETURN(bool result,
-                                DoConditionalToSelect(conditional));
+            if (!embedded) {
+              TF_ASSIGN_OR_RETURN(bool should_predicate,
+                                  ShouldPredicate(conditional));
+              if (!should_predicate) {
+                continue;
+              }
+            }
+            TF_ASSIGN_OR_RETURN(
+                bool result,
+                DoConditionalToSelect(conditional,
+                                      /*allow_tuples=*/!embedded));
             did_mutate |= result;
           }
         }
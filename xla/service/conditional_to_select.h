@@ -16,15 +16,35 @@ limitations under the License.
 #ifndef XLA_SERVICE_CONDITIONAL_TO_SELECT_H_
 #define XLA_SERVICE_CONDITIONAL_TO_SELECT_H_
 
+#include <optional>
+#include <utility>
+
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_pass_interface.h"
 
 namespace xla {
 
 // A pass which transforms conditionals to selects in places where conditionals
 // are legal, but not currently supported by the backends (e.g. inside kMap)
+//
+// If predication options are given, conditionals in sequential computations
+// are also transformed when executing both branches is estimated to be faster
+// than executing the conditional, e.g. on backends where a conditional
+// requires a device to host synchronization.
 class ConditionalToSelect : public HloModulePass {
  public:
+  struct PredicationOptions {
+    // Used to estimate the time the branches take. The per second rates must
+    // be set.
+    HloCostAnalysis::Options cost_analysis_options;
+    // The time a conditional takes on top of the time of its branch.
+    float conditional_overhead_seconds = 0;
+  };
+
+  ConditionalToSelect() = default;
+  explicit ConditionalToSelect(PredicationOptions predication_options)
+      : predication_options_(std::move(predication_options)) {}
   ~ConditionalToSelect() override = default;
   absl::string_view name() const override { return "conditional-to-select"; }
 
@@ -34,6 +54,13 @@ class ConditionalToSelect : public HloModulePass {
   StatusOr<bool> Run(
       HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+ private:
+  // Whether the conditional in a sequential computation is cheap enough to
+  // execute both branches.
+  StatusOr<bool> ShouldPredicate(const HloInstruction* conditional) const;
+
+  std::optional<PredicationOptions> predication_options_;
 };
 
 }  // namespace xla
@@ -23,6 +23,8 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/hlo/utils/hlo_matchers.h"
 #include "xla/literal.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
 #include "xla/test.h"
 #include "xla/tests/hlo_test_base.h"
 
@@ -132,5 +134,67 @@ ENTRY comp {
           _));
 }
 
+constexpr char kSequentialConditional[] = R"(
+HloModule SequentialConditional
+
+if {
+  %pif = f32[4] parameter(0)
+  %one = f32[] constant(1)
+  %ones = f32[4] broadcast(%one), dimensions={}
+  %add = f32[4] add(%pif, %ones)
+  ROOT %tuple = (f32[4], f32[4]) tuple(%add, %pif)
+}
+
+else {
+  %pelse = f32[4] parameter(0)
+  %multiply = f32[4] multiply(%pelse, %pelse)
+  ROOT %tuple = (f32[4], f32[4]) tuple(%multiply, %pelse)
+}
+
+ENTRY comp {
+  %p = pred[] parameter(0)
+  %x = f32[4] parameter(1)
+  ROOT %conditional = (f32[4], f32[4]) conditional(%p, %x, %x), true_computation=if, false_computation=else
+}
+)";
+
+ConditionalToSelect::PredicationOptions MakePredicationOptions(
+    float conditional_overhead_seconds) {
+  ConditionalToSelect::PredicationOptions options;
+  options.cost_analysis_options.shape_size = [](const Shape& shape) {
+    return ShapeUtil::ByteSizeOf(shape, /*pointer_size=*/8);
+  };
+  options.cost_analysis_options.set_flops_per_second(1e9);
+  options.cost_analysis_options.set_bytes_per_second(1e9);
+  options.conditional_overhead_seconds = conditional_overhead_seconds;
+  return options;
+}
+
+TEST_F(ConditionalToSelectTest, SequentialConditionalNotPredicatedByDefault) {
+  auto module = ParseAndReturnVerifiedModule(kSequentialConditional).value();
+  ConditionalToSelect pass;
+  EXPECT_FALSE(pass.Run(&*module).value());
+}
+
+TEST_F(ConditionalToSelectTest, CheapSequentialConditionalIsPredicated) {
+  auto module = ParseAndReturnVerifiedModule(kSequentialConditional).value();
+  ConditionalToSelect pass(
+      MakePredicationOptions(/*conditional_overhead_seconds=*/1e-5));
+  ASSERT_TRUE(pass.Run(&*module).value());
+
+  auto pred = op::Broadcast(op::Parameter(0));
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              op::Tuple(op::Select(pred, _, _), op::Select(pred, _, _)));
+}
+
+TEST_F(ConditionalToSelectTest, ExpensiveSequentialConditionalIsKept) {
+  auto module = ParseAndReturnVerifiedModule(kSequentialConditional).value();
+  ConditionalToSelect pass(
+      MakePredicationOptions(/*conditional_overhead_seconds=*/1e-9));
+  EXPECT_FALSE(pass.Run(&*module).value());
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              op::Conditional());
+}
+
 }  // namespace
 }  // namespace xla
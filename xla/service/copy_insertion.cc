@@ -1185,6 +1185,15 @@ class CopyRemover {
     // these values are never null for elements in the list.
     ValueNode* prev = nullptr;
     ValueNode* next = nullptr;
+
+    // Memoized results of LiveRangeBefore(*this, *other), keyed by 'other'.
+    // The result only depends on the uses of this node, so the map is cleared
+    // whenever 'uses' changes.
+    absl::flat_hash_map<const ValueNode*, bool> live_range_before;
+
+    // The value of CopyRemover::version_ when the list holding this node was
+    // last modified.
+    int64_t version = 0;
   };
 
   CopyRemover(const HloModule& module, const HloAliasAnalysis& alias_analysis,
@@ -1391,7 +1400,7 @@ class CopyRemover {
       VLOG(2) << copy->name() << " is not removable (shape mismatch)";
       return false;
     }
-    const CopyNodes& copy_node = copy_map_.at(copy);
+    CopyNodes& copy_node = copy_map_.at(copy);
     DCHECK(copy_node.src != nullptr);
     DCHECK(copy_node.dest != nullptr);
 
@@ -1411,6 +1420,22 @@ class CopyRemover {
         (*region_analysis_limit < 0 ||
          live_range_size1 * live_range_size2 <= *region_analysis_limit);
     *region_analysis_limit = 0;
+    // The ordering does not change while copies are removed, so a copy that
+    // could not be removed stays that way until the value list of its source
+    // or destination is modified. Skip it without repeating the (quadratic)
+    // live range checks in later fixpoint iterations.
+    if (copy_node.failed_version >= 0 &&
+        copy_node.src->version <= copy_node.failed_version &&
+        copy_node.dest->version <= copy_node.failed_version &&
+        copy_node.failed_with_region_analysis == use_region_analysis) {
+      VLOG(2) << copy->name() << " is not removable (value lists unchanged)";
+      return false;
+    }
+    auto NotRemovable = [&]() {
+      copy_node.failed_version = version_;
+      copy_node.failed_with_region_analysis = use_region_analysis;
+      return false;
+    };
     VLOG(3) << copy->name() << " copies value "
             << copy_node.src->value->ToShortString();
     VLOG(3) << "Source buffer values: " << ValueListToString(copy_node.src);
@@ -1526,7 +1551,7 @@ class CopyRemover {
       if (!live_range_before &&
           CheckLiveRangeInterference(copy_node.src, copy_node.dest,
                                      kMergeFirstDestInSource)) {
-        return false;
+        return NotRemovable();
       }
       VLOG(2) << "Splice dest after source.";
       // Splice in destination buffer values list right after 'src'.
@@ -1557,7 +1582,7 @@ class CopyRemover {
           CheckLiveRangeInterference(copy_node.src, copy_node.dest,
                                      kMergeLastSourceInDest)) {
         VLOG(2) << "Region-based analysis concludes interference.\n";
-        return false;
+        return NotRemovable();
       }
       VLOG(2) << "Splice src after prev of dest.";
       // Splice source buffer values list right after 'prev_dest'.
@@ -1566,10 +1591,13 @@ class CopyRemover {
       VLOG(2) << copy->name()
               << " copies value in middle of source buffer to value in middle "
                  "of destination buffer";
-      return false;
+      return NotRemovable();
     }
 
+    // Removing the copy node invalidates 'copy_node'.
+    ValueNode* src = copy_node.src;
     RemoveCopyValue(copy_node.dest);
+    MarkListModified(src);
 
     XLA_VLOG_LINES(4, ToString());
     TF_DCHECK_OK(Verify());
@@ -1600,6 +1628,7 @@ class CopyRemover {
     });
     CHECK(it != operand_node->uses.end());
     operand_node->uses.erase(it);
+    operand_node->live_range_before.clear();
 
     // If the elided copy has any uses which are themselves kCopy instructions
     // then patch up the copy info to reflect the that this kCopy instruction
@@ -1624,7 +1653,16 @@ class CopyRemover {
   // updated as copies are removed. Also here because the result is used
   // to directly drive copy elision, use_is_always_before_def_in_same_instr is
   // set to false.
-  bool LiveRangeBefore(const ValueNode& a, const ValueNode& b) {
+  bool LiveRangeBefore(ValueNode& a, const ValueNode& b) {
+    auto [it, inserted] = a.live_range_before.try_emplace(&b, false);
+    if (inserted) {
+      it->second = ComputeLiveRangeBefore(a, b);
+    }
+    return it->second;
+  }
+
+  // Uncached implementation of LiveRangeBefore.
+  bool ComputeLiveRangeBefore(const ValueNode& a, const ValueNode& b) {
     if (a.uses.empty()) {
       VLOG(2) << "Empty uses for " << *a.value;
       return ordering_->IsDefinedBefore(*a.value, *b.value);
@@ -1644,6 +1682,17 @@ class CopyRemover {
         /* use_is_always_before_def_in_same_instr=*/false);
   }
 
+  // Records that the list holding 'node' was modified, so that copies between
+  // its values are tried again.
+  void MarkListModified(ValueNode* node) {
+    ++version_;
+    ValueNode* p = node;
+    do {
+      p->version = version_;
+      p = p->next;
+    } while (p != node);
+  }
+
   // Returns whether 'node' is the last node in its list.
   bool IsTail(const ValueNode& node) const {
     return ContainsKey(value_lists_, node.next);
@@ -1827,8 +1876,16 @@ class CopyRemover {
     // The source and destinations values of the kCopy instruction.
     ValueNode* src = nullptr;
     ValueNode* dest = nullptr;
+
+    // The value of version_ when the copy was last found not removable, and
+    // whether region-based analysis was used then. -1 if never tried.
+    int64_t failed_version = -1;
+    bool failed_with_region_analysis = false;
   };
   absl::flat_hash_map<const HloInstruction*, CopyNodes> copy_map_;
+
+  // Incremented whenever a value list is modified.
+  int64_t version_ = 0;
 };
 
 }  // namespace
@@ -0,0 +1,79 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/buffer_arena_pool.h"
+
+#include <cstddef>
+#include <memory>
+
+#include "absl/base/dynamic_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/statusor.h"
+#include "xla/util.h"
+#include "tsl/platform/mem.h"
+
+namespace xla {
+namespace cpu {
+
+BufferArenaPool::BufferArenaPool(size_t size, size_t alignment,
+                                 size_t max_free_arenas)
+    : size_(size), alignment_(alignment), max_free_arenas_(max_free_arenas) {}
+
+BufferArenaPool::~BufferArenaPool() {
+  absl::MutexLock lock(&mu_);
+  for (std::byte* arena : free_arenas_) {
+    tsl::port::AlignedFree(arena);
+  }
+}
+
+StatusOr<std::shared_ptr<std::byte>> BufferArenaPool::Acquire() {
+  if (size_ == 0) return nullptr;
+
+  std::byte* arena = nullptr;
+  {
+    absl::MutexLock lock(&mu_);
+    if (!free_arenas_.empty()) {
+      arena = free_arenas_.back();
+      free_arenas_.pop_back();
+    }
+  }
+  if (arena == nullptr) {
+    arena = static_cast<std::byte*>(
+        tsl::port::AlignedMalloc(size_, static_cast<int>(alignment_)));
+    if (arena == nullptr) {
+      return ResourceExhausted("Failed to allocate a buffer arena of %d bytes",
+                               size_);
+    }
+    // The buffers are written by the JITed code, which msan doesn't know
+    // about. Mark them initialized so that msan doesn't flag loads from them.
+    ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(arena, size_);
+  }
+  return std::shared_ptr<std::byte>(
+      arena, [this](std::byte* arena) { Release(arena); });
+}
+
+void BufferArenaPool::Release(std::byte* arena) {
+  {
+    absl::MutexLock lock(&mu_);
+    if (free_arenas_.size() < max_free_arenas_) {
+      free_arenas_.push_back(arena);
+      return;
+    }
+  }
+  tsl::port::AlignedFree(arena);
+}
+
+}  // namespace cpu
+}  // namespace xla
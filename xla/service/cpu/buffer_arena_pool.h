@@ -0,0 +1,66 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_BUFFER_ARENA_POOL_H_
+#define XLA_SERVICE_CPU_BUFFER_ARENA_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/statusor.h"
+
+namespace xla {
+namespace cpu {
+
+// A pool of contiguous memory blocks ("arenas") of a fixed size, holding the
+// temporary buffers of one run of an executable. Concurrent runs lease
+// separate arenas, and arenas released by finished runs are kept for the
+// following runs, so that steady-state runs don't allocate.
+//
+// The pool must outlive the arenas leased from it.
+class BufferArenaPool {
+ public:
+  // Arenas are `size` bytes aligned to `alignment`. At most `max_free_arenas`
+  // released arenas are kept, the others are freed.
+  BufferArenaPool(size_t size, size_t alignment, size_t max_free_arenas);
+  ~BufferArenaPool();
+
+  // Returns an arena, which is returned to the pool once the last copy of the
+  // pointer is destroyed. The pointer is null if the arena size is 0.
+  StatusOr<std::shared_ptr<std::byte>> Acquire();
+
+  size_t size() const { return size_; }
+
+ private:
+  void Release(std::byte* arena);
+
+  const size_t size_;
+  const size_t alignment_;
+  const size_t max_free_arenas_;
+
+  absl::Mutex mu_;
+  std::vector<std::byte*> free_arenas_ ABSL_GUARDED_BY(mu_);
+
+  BufferArenaPool(const BufferArenaPool&) = delete;
+  void operator=(const BufferArenaPool&) = delete;
+};
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_CPU_BUFFER_ARENA_POOL_H_
@@ -0,0 +1,56 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/buffer_arena_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+TEST(BufferArenaPoolTest, ReusesReleasedArenas) {
+  BufferArenaPool pool(/*size=*/1000, /*alignment=*/64,
+                       /*max_free_arenas=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<std::byte> arena, pool.Acquire());
+  ASSERT_NE(arena, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(arena.get()) % 64, 0);
+  std::byte* data = arena.get();
+
+  // A concurrent run gets a separate arena.
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<std::byte> other, pool.Acquire());
+  EXPECT_NE(other.get(), data);
+
+  // Only one released arena is kept.
+  arena.reset();
+  other.reset();
+  TF_ASSERT_OK_AND_ASSIGN(arena, pool.Acquire());
+  EXPECT_EQ(arena.get(), data);
+}
+
+TEST(BufferArenaPoolTest, EmptyArena) {
+  BufferArenaPool pool(/*size=*/0, /*alignment=*/64, /*max_free_arenas=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<std::byte> arena, pool.Acquire());
+  EXPECT_EQ(arena, nullptr);
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
@@ -93,6 +93,36 @@ static std::vector<llvm::VecDesc> VectorFunctionsForTargetLibraryInfoImpl() {
        false, "_ZGV_LLVM_N16v"},
       {"llvm.log.f32", runtime::kLogV16F32SymbolName,
        llvm::ElementCount::getFixed(16), false, "_ZGV_LLVM_N16v"},
+
+      {"sinf", runtime::kSinV4F32SymbolName, llvm::ElementCount::getFixed(4),
+       false, "_ZGV_LLVM_N4v"},
+      {"llvm.sin.f32", runtime::kSinV4F32SymbolName,
+       llvm::ElementCount::getFixed(4), false, "_ZGV_LLVM_N4v"},
+
+      {"sinf", runtime::kSinV8F32SymbolName, llvm::ElementCount::getFixed(8),
+       false, "_ZGV_LLVM_N8v"},
+      {"llvm.sin.f32", runtime::kSinV8F32SymbolName,
+       llvm::ElementCount::getFixed(8), false, "_ZGV_LLVM_N8v"},
+
+      {"sinf", runtime::kSinV16F32SymbolName, llvm::ElementCount::getFixed(16),
+       false, "_ZGV_LLVM_N16v"},
+      {"llvm.sin.f32", runtime::kSinV16F32SymbolName,
+       llvm::ElementCount::getFixed(16), false, "_ZGV_LLVM_N16v"},
+
+      {"cosf", runtime::kCosV4F32SymbolName, llvm::ElementCount::getFixed(4),
+       false, "_ZGV_LLVM_N4v"},
+      {"llvm.cos.f32", runtime::kCosV4F32SymbolName,
+       llvm::ElementCount::getFixed(4), false, "_ZGV_LLVM_N4v"},
+
+      {"cosf", runtime::kCosV8F32SymbolName, llvm::ElementCount::getFixed(8),
+       false, "_ZGV_LLVM_N8v"},
+      {"llvm.cos.f32", runtime::kCosV8F32SymbolName,
+       llvm::ElementCount::getFixed(8), false, "_ZGV_LLVM_N8v"},
+
+      {"cosf", runtime::kCosV16F32SymbolName, llvm::ElementCount::getFixed(16),
+       false, "_ZGV_LLVM_N16v"},
+      {"llvm.cos.f32", runtime::kCosV16F32SymbolName,
+       llvm::ElementCount::getFixed(16), false, "_ZGV_LLVM_N16v"},
   };
   return result;
 }
@@ -102,6 +132,16 @@ llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> CompilerFunctor::operator()(
   VLOG(2) << "IR before optimizations";
   XLA_VLOG_LINES(2, llvm_ir::DumpToString(&module));
 
+  if (object_cache_ != nullptr) {
+    if (std::unique_ptr<llvm::MemoryBuffer> cached_object =
+            object_cache_->getObject(&module)) {
+      VLOG(2) << "Loaded " << module.getModuleIdentifier()
+              << " from the JIT object cache";
+      RunPostCodegenHook(*cached_object);
+      return std::move(cached_object);
+    }
+  }
+
   if (pre_optimization_hook_) {
     pre_optimization_hook_(module);
   }
@@ -211,17 +251,27 @@ llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> CompilerFunctor::operator()(
   std::unique_ptr<llvm::MemoryBuffer> memory_buffer(
       new llvm::SmallVectorMemoryBuffer(std::move(stream_buffer)));
 
+  if (object_cache_ != nullptr) {
+    object_cache_->notifyObjectCompiled(&module,
+                                        memory_buffer->getMemBufferRef());
+  }
+  RunPostCodegenHook(*memory_buffer);
+
+  return std::move(memory_buffer);
+}
+
+void CompilerFunctor::RunPostCodegenHook(
+    const llvm::MemoryBuffer& memory_buffer) const {
   if (post_codegen_hook_) {
     llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> obj_file =
-        llvm::object::ObjectFile::createObjectFile(*memory_buffer);
+        llvm::object::ObjectFile::createObjectFile(
+            memory_buffer.getMemBufferRef());
     if (obj_file) {
       post_codegen_hook_(*obj_file.get());
     } else {
       LOG(WARNING) << "Could convert memory buffer to object file!";
     }
   }
-
-  return std::move(memory_buffer);
 }
 
 }  // namespace cpu
@@ -21,6 +21,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -47,7 +48,8 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
           nullptr,
       bool dfsan_enabled = false,
       const std::vector<std::string>& dfsan_abi_list_files = {},
-      const std::vector<std::string>& convert_to_xla_runtime_abi = {})
+      const std::vector<std::string>& convert_to_xla_runtime_abi = {},
+      llvm::ObjectCache* object_cache = nullptr)
       : IRCompiler(llvm::orc::IRSymbolMapper::ManglingOptions()),
         target_machine_(target_machine),
         opt_level_(opt_level),
@@ -60,13 +62,16 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
         post_codegen_hook_(std::move(post_codegen_hook)),
         dfsan_enabled_(dfsan_enabled),
         dfsan_abi_list_files_(dfsan_abi_list_files),
-        convert_to_xla_runtime_abi_(convert_to_xla_runtime_abi) {}
+        convert_to_xla_runtime_abi_(convert_to_xla_runtime_abi),
+        object_cache_(object_cache) {}
 
   // Compile a Module to an ObjectFile.
   llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(
       llvm::Module& module) override;
 
  private:
+  void RunPostCodegenHook(const llvm::MemoryBuffer& memory_buffer) const;
+
   llvm::TargetMachine* target_machine_;
   const unsigned opt_level_;
   const bool optimize_for_size_;
@@ -79,6 +84,8 @@ class CompilerFunctor : public llvm::orc::IRCompileLayer::IRCompiler {
   const bool dfsan_enabled_ = false;
   const std::vector<std::string> dfsan_abi_list_files_;
   const std::vector<std::string> convert_to_xla_runtime_abi_;
+  // If not null, object files are looked up in and stored to this cache.
+  llvm::ObjectCache* object_cache_;
 };
 
 }  // namespace cpu
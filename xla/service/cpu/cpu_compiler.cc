@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "xla/service/cpu/cpu_compiler.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -37,13 +39,17 @@ limitations under the License.
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/LLVMContext.h"
@@ -62,6 +68,7 @@ limitations under the License.
 #include "llvm/TargetParser/Host.h"
 #include "llvm/TargetParser/Triple.h"
 #include "llvm/TargetParser/X86TargetParser.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"  // from @llvm-project
 #include "mlir/Conversion/ReconcileUnrealizedCasts/ReconcileUnrealizedCasts.h"  // from @llvm-project
 #include "mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
@@ -140,6 +147,7 @@ limitations under the License.
 #include "xla/service/cpu/cpu_instruction_fusion.h"
 #include "xla/service/cpu/cpu_layout_assignment.h"
 #include "xla/service/cpu/cpu_options.h"
+#include "xla/service/cpu/cpu_scatter_expander.h"
 #include "xla/service/cpu/dot_op_emitter.h"
 #include "xla/service/cpu/hlo_xla_runtime_pipeline.h"
 #include "xla/service/cpu/ir_emitter.h"
@@ -228,10 +236,12 @@ limitations under the License.
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/casts.h"
 #include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"  // IWYU pragma: keep
 #include "tsl/platform/status.h"
 #include "tsl/platform/statusor.h"
+#include "tsl/platform/threadpool.h"
 
 #if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
 #include "xla/service/cpu/onednn_rewriter.h"
@@ -269,13 +279,22 @@ xla::cpu::HloXlaRuntimePipelineOptions GetHloXlaRuntimePipelineOptions(
   options.experimental_deallocation =
       xla::GetDebugOptionsFromFlags()
           .xla_cpu_enable_experimental_deallocation();
-  options.enable_avx2 = [&] {
-    // Derive whether this is an x86 CPU with AVX2 enabled.
-    if (!target_triple.isX86()) return false;
-    llvm::SmallVector<llvm::StringRef> cpu_features;
+  options.enable_matmul_packing =
+      xla::GetDebugOptionsFromFlags().xla_cpu_enable_mlir_matmul_packing();
+  llvm::SmallVector<llvm::StringRef> cpu_features;
+  if (target_triple.isX86()) {
     llvm::X86::getFeaturesForCPU(cpu_name, cpu_features);
-    return llvm::is_contained(cpu_features, "avx2");
-  }();
+  }
+  // Derive whether this is an x86 CPU with AVX2 enabled.
+  options.enable_avx2 = llvm::is_contained(cpu_features, "avx2");
+  // Use as many elements per vector as there are f32 lanes in the widest
+  // vector registers. The default is kept if the CPU features are unknown.
+  if (llvm::is_contained(cpu_features, "avx512f")) {
+    options.vector_size = 16;
+  } else if (!cpu_features.empty() &&
+             !llvm::is_contained(cpu_features, "avx")) {
+    options.vector_size = 4;
+  }
   options.cpu_name = cpu_name;
   if (xla::GetDebugOptionsFromFlags().xla_cpu_enable_mlir_fusion_outlining()) {
     options.enable_fusion_outlining = true;
@@ -687,9 +706,10 @@ Status CpuCompiler::RunHloPassesThroughLayoutAssn(
   // Rewrite to custom calls with target as oneDNN library calls.
 #if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
   // AOT compiled code runs in single thread.
-  if (!is_aot_compile) {
-    // Temporarily disabling oneDNN rewriter because it causes JAX regression.
-    // pipeline.AddPass<OneDnnRewriter>();
+  // The rewriter is disabled by default because it causes a JAX regression.
+  if (!is_aot_compile &&
+      module->config().debug_options().xla_cpu_enable_onednn_rewriter()) {
+    pipeline.AddPass<OneDnnRewriter>();
   }
 #endif  // INTEL_MKL && ENABLE_ONEDNN_V3
 
@@ -747,7 +767,7 @@ Status CpuCompiler::RunHloPassesThroughLayoutAssn(
   pipeline.AddPass<DynamicPadder>(dynamic_padder_options);
   if (!is_mlir_compile) {
     pipeline.AddPass<SelectAndScatterExpander>();
-    pipeline.AddPass<ScatterExpander>(ScatterExpander::kEliminateAllScatters);
+    pipeline.AddPass<CpuScatterExpander>();
   }
   pipeline.AddPass<ConvCanonicalization>(target_machine_features);
 
@@ -966,6 +986,10 @@ llvm::CodeGenOptLevel CodeGenOptLevel(const HloModuleConfig& module_config) {
   }
 }
 
+// Module identifier prefix of the partitions created by
+// SplitModuleForParallelCompilation.
+constexpr absl::string_view kSplitModulePrefix = "__compute_module_part";
+
 std::pair<LLVMCompiler::ModuleHook, LLVMCompiler::ModuleHook> GetIRModuleHooks(
     const HloModule& hlo_module,
     const LLVMCompiler::ModuleHook& user_pre_optimization_hook,
@@ -984,7 +1008,14 @@ std::pair<LLVMCompiler::ModuleHook, LLVMCompiler::ModuleHook> GetIRModuleHooks(
     if (user_hook) {
       user_hook(llvm_module);
     }
-    llvm_ir::DumpIrIfEnabled(*hlo_module_ptr, llvm_module, optimized);
+    // Partitions of a split module are dumped to separate files.
+    absl::string_view filename_suffix;
+    if (absl::StartsWith(llvm_module.getModuleIdentifier(),
+                         kSplitModulePrefix)) {
+      filename_suffix = llvm_module.getModuleIdentifier();
+    }
+    llvm_ir::DumpIrIfEnabled(*hlo_module_ptr, llvm_module, optimized,
+                             filename_suffix);
   };
   return {[hook](const llvm::Module& llvm_module) {
             return hook(/*optimized=*/false, llvm_module);
@@ -994,6 +1025,40 @@ std::pair<LLVMCompiler::ModuleHook, LLVMCompiler::ModuleHook> GetIRModuleHooks(
           }};
 }
 
+// Splits `llvm_module` into at most `num_partitions` modules. Each partition is
+// copied into its own LLVM context, so that partitions can be compiled
+// concurrently. Calls across partitions can't be inlined, so this trades some
+// code quality for compilation speed.
+std::vector<llvm::orc::ThreadSafeModule> SplitModuleForParallelCompilation(
+    llvm::Module& llvm_module, int num_partitions) {
+  XLA_SCOPED_LOGGING_TIMER("CpuCompiler - Splitting LLVM module");
+  std::vector<llvm::orc::ThreadSafeModule> partitions;
+  llvm::SplitModule(
+      llvm_module, num_partitions,
+      [&](std::unique_ptr<llvm::Module> partition) {
+        llvm::SmallString<0> bitcode;
+        llvm::raw_svector_ostream bitcode_ostream(bitcode);
+        llvm::WriteBitcodeToFile(*partition, bitcode_ostream);
+
+        auto context = std::make_unique<llvm::LLVMContext>();
+        llvm::Expected<std::unique_ptr<llvm::Module>> copy =
+            llvm::parseBitcodeFile(
+                llvm::MemoryBufferRef(
+                    llvm::StringRef(bitcode.data(), bitcode.size()),
+                    "split_module"),
+                *context);
+        CHECK(copy) << "Failed to parse bitcode "
+                    << llvm::toString(copy.takeError());
+        (*copy)->setModuleIdentifier(
+            absl::StrCat(kSplitModulePrefix, partitions.size()));
+        partitions.emplace_back(std::move(*copy), std::move(context));
+      },
+      // Nested computations have internal linkage; externalize them so that
+      // they can be placed in a different partition than their callers.
+      /*PreserveLocals=*/false);
+  return partitions;
+}
+
 Status VerifyLlvmModule(const llvm::Module& llvm_module) {
   XLA_SCOPED_LOGGING_TIMER("CpuCompiler - Running LLVM verifier");
 
@@ -1087,7 +1152,8 @@ namespace {
 
 // Post-compilation callback functor for use by SimpleOrcJIT.
 //
-// Dumps machine code if dumping is enabled for the module.
+// Dumps machine code if dumping is enabled for the module. When the module is
+// split for parallel codegen, each object file gets its own part suffix.
 struct OrcJITPostCompilationHook {
   // Gets an std::function that implements this hook.
   static std::function<void(const llvm::object::ObjectFile& obj_file)> Create(
@@ -1110,12 +1176,17 @@ struct OrcJITPostCompilationHook {
     if (!DumpingEnabledForHloModule(*module)) {
       return;
     }
-    DumpToFileInDir(*module, /*file_prefix=*/"", /*file_suffix=*/"o",
+    // Object files of split modules are compiled concurrently.
+    int part = next_part.fetch_add(1);
+    std::string file_suffix =
+        part == 0 ? "o" : absl::StrCat("part_", part, ".o");
+    DumpToFileInDir(*module, /*file_prefix=*/"", file_suffix,
                     absl::string_view(obj_file.getData().data(),
                                       obj_file.getData().size()));
   }
 
   const HloModule* module;
+  std::atomic<int> next_part{0};
 };
 
 void InitializeLLVMCommandLineOptions(const HloModuleConfig& config) {
@@ -1333,7 +1404,8 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
       options::SlpVectorizerDisabled(module->config()),
       llvm_ir::GetCpuFastMathFlags(module->config()), pre_optimization_ir_hook,
       post_optimization_ir_hook,
-      OrcJITPostCompilationHook::Create(module.get()));
+      OrcJITPostCompilationHook::Create(module.get()),
+      module->config().debug_options().xla_cpu_jit_object_cache_dir());
   if (!jit) {
     return InternalError("Creating JIT failed: %s",
                          llvm::toString(jit.takeError()));
@@ -1437,10 +1509,36 @@ CpuCompiler::CompileLegacyCpuExecutable(std::unique_ptr<HloModule> module) {
 
   TF_RETURN_IF_ERROR(VerifyLlvmModule(*llvm_module));
 
-  // JIT compile the LLVM IR module to in-memory machine code.
-  llvm::orc::ThreadSafeModule thread_safe_module(std::move(llvm_module),
-                                                 std::move(llvm_context));
-  cantFail((*jit)->AddModule(std::move(thread_safe_module)));
+  // JIT compile the LLVM IR module to in-memory machine code. Large modules
+  // can optionally be split and compiled on multiple threads, in which case the
+  // JIT links the resulting object files.
+  const int parallel_codegen_split_count =
+      module->config().debug_options().xla_cpu_parallel_codegen_split_count();
+  int num_functions = 0;
+  for (const llvm::Function& function : llvm_module->functions()) {
+    if (!function.isDeclaration()) ++num_functions;
+  }
+  const int num_partitions =
+      std::min(parallel_codegen_split_count, num_functions);
+  if (num_partitions > 1) {
+    std::vector<llvm::orc::ThreadSafeModule> partitions =
+        SplitModuleForParallelCompilation(*llvm_module, num_partitions);
+    llvm_module.reset();
+    llvm_context.reset();
+
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(),
+                                        "xla_cpu_parallel_codegen",
+                                        partitions.size());
+    if (auto err = (*jit)->AddModulesInParallel(std::move(partitions),
+                                                &thread_pool)) {
+      return InternalError("Parallel LLVM compilation failed: %s",
+                           llvm::toString(std::move(err)));
+    }
+  } else {
+    llvm::orc::ThreadSafeModule thread_safe_module(std::move(llvm_module),
+                                                   std::move(llvm_context));
+    cantFail((*jit)->AddModule(std::move(thread_safe_module)));
+  }
 
   TF_ASSIGN_OR_RETURN(
       auto cpu_executable,
@@ -18,7 +18,9 @@ limitations under the License.
 #include <stdint.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -33,6 +35,7 @@ limitations under the License.
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/Parser/Parser.h"  // from @llvm-project
+#include "xla/cpu_function_runtime.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/mlir/runtime/transforms/compiler.h"
@@ -104,6 +107,10 @@ StatusOr<std::unique_ptr<CpuExecutable>> CpuExecutable::Create(
   return executable;
 }
 
+// Maximum number of temporary buffer arenas kept by an executable between runs,
+// which bounds the number of concurrent runs that don't allocate.
+static constexpr size_t kMaxFreeBufferArenas = 4;
+
 CpuExecutable::CpuExecutable(
     std::unique_ptr<HloModule> hlo_module,
     std::unique_ptr<HloProfilePrinterData> hlo_profile_printer_data,
@@ -115,6 +122,23 @@ CpuExecutable::CpuExecutable(
   if (assignment_) {
     buffer_assignment_ =
         std::make_shared<BufferAssignmentProto>(assignment_->ToProto());
+
+    // Temporary buffers that don't escape the run are packed in a single arena
+    // reused across runs, so that running doesn't call the allocator for them.
+    size_t arena_size = 0;
+    arena_offsets_.resize(assignment_->Allocations().size(), -1);
+    for (const BufferAllocation& allocation : assignment_->Allocations()) {
+      if (allocation.is_entry_computation_parameter() ||
+          allocation.is_constant() || allocation.is_thread_local() ||
+          allocation.maybe_live_out()) {
+        continue;
+      }
+      arena_size = RoundUpTo(arena_size, cpu_function_runtime::Align());
+      arena_offsets_[allocation.index()] = arena_size;
+      arena_size += allocation.size();
+    }
+    arena_pool_ = std::make_unique<BufferArenaPool>(
+        arena_size, cpu_function_runtime::Align(), kMaxFreeBufferArenas);
   }
   if (has_module()) {
     XlaDebugInfoManager::Get()->RegisterModule(shared_module(),
@@ -166,14 +190,22 @@ static StatusOr<MaybeOwningDeviceMemory> MemoryForAllocation(
 
 StatusOr<std::vector<MaybeOwningDeviceMemory>> CpuExecutable::CreateBufferTable(
     se::DeviceMemoryAllocator* memory_allocator, int device_ordinal,
-    absl::Span<ExecutionInput const> arguments) {
+    absl::Span<ExecutionInput const> arguments,
+    std::shared_ptr<std::byte>* temp_arena) {
   std::vector<MaybeOwningDeviceMemory> buffers(
       assignment_->Allocations().size());
   VLOG(3) << "Allocating " << assignment_->Allocations().size()
           << " allocations for module " << module().name();
+  TF_ASSIGN_OR_RETURN(*temp_arena, arena_pool_->Acquire());
   for (BufferAllocation::Index i = 0; i < assignment_->Allocations().size();
        ++i) {
     const BufferAllocation& allocation = assignment_->GetAllocation(i);
+    if (int64_t offset = arena_offsets_[i]; offset >= 0) {
+      buffers[i] = MaybeOwningDeviceMemory{
+          se::DeviceMemoryBase{temp_arena->get() + offset,
+                               static_cast<uint64_t>(allocation.size())}};
+      continue;
+    }
     TF_ASSIGN_OR_RETURN(
         buffers[i], MemoryForAllocation(allocation, arguments, memory_allocator,
                                         device_ordinal));
@@ -252,6 +284,11 @@ Status CpuExecutable::ExecuteComputeFunction(
       return status;
     }
   } else {
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+    ExecutableRunOptions onednn_run_options = *run_options;
+    onednn_run_options.set_onednn_weights_cache(&onednn_weights_cache_);
+    run_options = &onednn_run_options;
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
     XlaCustomCallStatus status;
     // For the entry computation (like all global computations), all inputs and
     // outputs are in the buffer table, and both the result pointer and args
@@ -617,10 +654,11 @@ StatusOr<ExecutionOutput> CpuExecutable::ExecuteAsyncOnStream(
       run_options->stream()->implementation());
   se::Stream* stream = run_options->stream();
   se::DeviceMemoryAllocator* memory_allocator = run_options->allocator();
+  std::shared_ptr<std::byte> temp_arena;
   TF_ASSIGN_OR_RETURN(
       std::vector<MaybeOwningDeviceMemory> buffers,
       CreateBufferTable(memory_allocator, stream->parent()->device_ordinal(),
-                        arguments));
+                        arguments, &temp_arena));
 
   TF_ASSIGN_OR_RETURN(
       ExecutionOutput result,
@@ -640,6 +678,8 @@ StatusOr<ExecutionOutput> CpuExecutable::ExecuteAsyncOnStream(
     CpuExecutable* executable;
     ServiceExecutableRunOptions run_options;
     std::shared_ptr<std::vector<MaybeOwningDeviceMemory>> task_buffers;
+    // Returned to the pool once the task is done.
+    std::shared_ptr<std::byte> temp_arena;
     HloExecutionProfile* hlo_execution_profile;
 
     Status operator()() {
@@ -651,7 +691,7 @@ StatusOr<ExecutionOutput> CpuExecutable::ExecuteAsyncOnStream(
       AsyncRunTask{this, *run_options,
                    std::make_shared<std::vector<MaybeOwningDeviceMemory>>(
                        std::move(buffers)),
-                   hlo_execution_profile});
+                   std::move(temp_arena), hlo_execution_profile});
 
   MarkToBeReleasedArguments(absl::MakeSpan(arguments), result);
   return std::move(result);
@@ -30,7 +30,9 @@ limitations under the License.
 #include "xla/runtime/executable.h"
 #include "xla/runtime/jit_executable.h"
 #include "xla/service/buffer_assignment.h"
+#include "xla/service/cpu/buffer_arena_pool.h"
 #include "xla/service/cpu/buffer_desc.h"
+#include "xla/service/cpu/onednn_primitive_cache.h"
 #include "xla/service/cpu/simple_orc_jit.h"
 #include "xla/service/cpu/xla_framework.h"
 #include "xla/service/custom_call_status_internal.h"
@@ -226,9 +228,14 @@ class CpuExecutable : public Executable {
   //
   //  - buffers_to_free: buffers whose ownership was donated by the caller that
   //    are to be freed by the caller.
+  //
+  // The temporary buffers that are not live out are placed in an arena leased
+  // from `arena_pool_`, which is returned in `temp_arena` and must be kept
+  // until the computation finished.
   StatusOr<std::vector<MaybeOwningDeviceMemory>> CreateBufferTable(
       se::DeviceMemoryAllocator* memory_allocator, int device_ordinal,
-      absl::Span<ExecutionInput const> arguments);
+      absl::Span<ExecutionInput const> arguments,
+      std::shared_ptr<std::byte>* temp_arena);
 
   // Creates an Execution output holding ScopedShapedBuffer for holding the
   // result of the computation, moving buffers out of allocated_buffers and into
@@ -251,6 +258,13 @@ class CpuExecutable : public Executable {
 
   std::shared_ptr<const BufferAssignmentProto> buffer_assignment_;
 
+  // Offsets in the temporary buffer arena of the allocations placed in it, or
+  // -1 for the allocations that are not. Empty without buffer assignment.
+  std::vector<int64_t> arena_offsets_;
+
+  // Arenas for the temporary buffers of concurrent runs.
+  std::unique_ptr<BufferArenaPool> arena_pool_;
+
   // The LLVM IR, in string format, of the unoptimized module generated for this
   // CpuExecutable. We save a string instead of an llvm::Module* because leaving
   // llvm::Module* in a singleton can cause the heap checker to emit false
@@ -268,6 +282,11 @@ class CpuExecutable : public Executable {
   // If not null, XLA Runtime is enabled.
   std::unique_ptr<XlaRuntimeCpuExecutable> xla_runtime_executable_;
 
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+  // Constant weights of the oneDNN runtime calls, prepacked on first use.
+  OneDnnWeightsCache onednn_weights_cache_;
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
+
   CpuExecutable(std::unique_ptr<HloModule> hlo_module,
                 std::unique_ptr<HloProfilePrinterData> hlo_profile_printer_data,
                 std::unique_ptr<HloProfileIndexMap> hlo_profile_index_map,
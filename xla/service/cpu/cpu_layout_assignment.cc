@@ -103,6 +103,8 @@ static bool OperandsAndResultMustHaveRowMajorLayout(
   } else if (instr.opcode() == HloOpcode::kDot) {
     return DotOperandsAndResultMustHaveRowMajorLayout(instr,
                                                       target_machine_features);
+  } else if (instr.opcode() == HloOpcode::kScatter) {
+    return PotentiallyImplementedAsRuntimeScatter(instr);
   }
   return false;
 }
@@ -0,0 +1,166 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/cpu_machine_model.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "xla/service/cpu/cpu_machine_model.pb.h"
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/threadpool.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+// Used when the cache sizes can't be read from the operating system.
+constexpr int64_t kDefaultL2CacheSize = 256 << 10;
+constexpr int64_t kDefaultL3CacheSize = 32 << 20;
+
+// Floating point operations per cycle assumed for a core, e.g. one 8-wide
+// vector FMA per cycle.
+constexpr double kFlopsPerCycle = 16;
+
+// Returns the size in bytes of the cache of cpu0 at `index` in sysfs, or
+// `default_size` if it isn't available.
+int64_t ReadCacheSize(int index, int64_t default_size) {
+  std::string contents;
+  std::string path = absl::StrCat("/sys/devices/system/cpu/cpu0/cache/index",
+                                  index, "/size");
+  if (!tsl::Env::Default()->FileExists(path).ok() ||
+      !tsl::ReadFileToString(tsl::Env::Default(), path, &contents).ok()) {
+    return default_size;
+  }
+  absl::string_view size = absl::StripAsciiWhitespace(contents);
+  int64_t multiplier = 1;
+  if (absl::ConsumeSuffix(&size, "K")) {
+    multiplier = 1 << 10;
+  } else if (absl::ConsumeSuffix(&size, "M")) {
+    multiplier = 1 << 20;
+  }
+  int64_t value;
+  if (!absl::SimpleAtoi(size, &value) || value <= 0) {
+    return default_size;
+  }
+  return value * multiplier;
+}
+
+// Returns the bandwidth in bytes per second of copying `size` bytes split
+// between `num_threads` threads, the best of a few runs.
+double MeasureCopyBandwidth(int64_t size, int num_threads) {
+  std::vector<char> src(size, 1);
+  std::vector<char> dst(size);
+  int64_t chunk_size = size / num_threads;
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "cpu_machine_model",
+                               num_threads);
+  absl::Duration best = absl::InfiniteDuration();
+  for (int run = 0; run < 3; ++run) {
+    absl::BlockingCounter counter(num_threads);
+    absl::Time start = absl::Now();
+    for (int i = 0; i < num_threads; ++i) {
+      pool.Schedule([&, i] {
+        std::memcpy(dst.data() + i * chunk_size, src.data() + i * chunk_size,
+                    chunk_size);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+    best = std::min(best, absl::Now() - start);
+  }
+  // A copy reads and writes every byte.
+  return 2.0 * chunk_size * num_threads /
+         std::max(absl::ToDoubleSeconds(best), 1e-9);
+}
+
+CpuMachineModelProto Probe() {
+  CpuMachineModelProto model;
+  model.set_num_cores(
+      std::max(1, tsl::port::NumSchedulableCPUs() /
+                      std::max(1, tsl::port::NumHyperthreadsPerCore())));
+  model.set_l2_cache_size(ReadCacheSize(2, kDefaultL2CacheSize));
+  model.set_l3_cache_size(ReadCacheSize(3, kDefaultL3CacheSize));
+  model.set_per_core_flops(tsl::port::NominalCPUFrequency() * kFlopsPerCycle);
+
+  // Stream a buffer that doesn't fit into the last level cache, so that the
+  // copy is bound by the memory bandwidth.
+  int64_t size = std::max<int64_t>(64 << 20, 4 * model.l3_cache_size());
+  model.set_per_core_memory_bandwidth(MeasureCopyBandwidth(size, 1));
+  model.set_memory_bandwidth(std::max(
+      model.per_core_memory_bandwidth(),
+      MeasureCopyBandwidth(size, static_cast<int>(model.num_cores()))));
+  VLOG(1) << "Probed CPU machine model: " << model.ShortDebugString();
+  return model;
+}
+
+}  // namespace
+
+const CpuMachineModelProto& ProbeCpuMachineModel() {
+  static const CpuMachineModelProto* model = new CpuMachineModelProto(Probe());
+  return *model;
+}
+
+StatusOr<CpuMachineModelProto> GetCpuMachineModel(absl::string_view spec) {
+  if (spec == "probe") {
+    return ProbeCpuMachineModel();
+  }
+
+  CpuMachineModelProto model;
+  TF_RETURN_IF_ERROR(
+      tsl::ReadTextProto(tsl::Env::Default(), std::string(spec), &model));
+  // Only probe if the profile is incomplete.
+  if (model.num_cores() > 0 && model.per_core_memory_bandwidth() > 0 &&
+      model.memory_bandwidth() > 0 && model.l2_cache_size() > 0 &&
+      model.l3_cache_size() > 0 && model.per_core_flops() > 0) {
+    return model;
+  }
+  const CpuMachineModelProto& probed = ProbeCpuMachineModel();
+  if (model.num_cores() <= 0) {
+    model.set_num_cores(probed.num_cores());
+  }
+  if (model.per_core_memory_bandwidth() <= 0) {
+    model.set_per_core_memory_bandwidth(probed.per_core_memory_bandwidth());
+  }
+  if (model.memory_bandwidth() <= 0) {
+    model.set_memory_bandwidth(probed.memory_bandwidth());
+  }
+  if (model.l2_cache_size() <= 0) {
+    model.set_l2_cache_size(probed.l2_cache_size());
+  }
+  if (model.l3_cache_size() <= 0) {
+    model.set_l3_cache_size(probed.l3_cache_size());
+  }
+  if (model.per_core_flops() <= 0) {
+    model.set_per_core_flops(probed.per_core_flops());
+  }
+  return model;
+}
+
+}  // namespace cpu
+}  // namespace xla
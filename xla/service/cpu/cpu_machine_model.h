@@ -0,0 +1,41 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_CPU_MACHINE_MODEL_H_
+#define XLA_SERVICE_CPU_CPU_MACHINE_MODEL_H_
+
+#include "absl/strings/string_view.h"
+#include "xla/service/cpu/cpu_machine_model.pb.h"
+#include "xla/statusor.h"
+
+namespace xla {
+namespace cpu {
+
+// Measures the properties of the host: the core count and cache sizes are
+// read from the operating system, the memory bandwidth is measured by
+// streaming a buffer larger than the last level cache from one and from all
+// cores. This takes tens of milliseconds, so the result is computed once per
+// process.
+const CpuMachineModelProto& ProbeCpuMachineModel();
+
+// Returns the machine model selected by `spec`, which is either "probe" or the
+// path of a CpuMachineModelProto in text format. Fields that are not set in
+// the file are probed.
+StatusOr<CpuMachineModelProto> GetCpuMachineModel(absl::string_view spec);
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_CPU_CPU_MACHINE_MODEL_H_
@@ -15,9 +15,11 @@ limitations under the License.
 
 #include "xla/service/cpu/cpu_runtime.h"
 
+#include <algorithm>
 #include <complex>
 #include <cstdarg>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <limits>
@@ -29,6 +31,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/base/dynamic_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_format.h"
@@ -135,7 +138,10 @@ extern const char* const kStatusIsSuccessSymbolName =
     "__xla_cpu_runtime_StatusIsSuccess";
 extern const char* const kKeyValueSortSymbolName =
     "__xla_cpu_runtime_KeyValueSort";
+extern const char* const kRadixSortSymbolName = "__xla_cpu_runtime_RadixSort";
 extern const char* const kTopKF32SymbolName = "__xla_cpu_runtime_TopKF32";
+extern const char* const kScatterAddF32SymbolName =
+    "__xla_cpu_runtime_ScatterAddF32";
 extern const char* const kTracingStartSymbolName =
     "__xla_cpu_runtime_TracingStart";
 extern const char* const kTracingEndSymbolName = "__xla_cpu_runtime_TracingEnd";
@@ -149,6 +155,10 @@ extern const char* const kPartitionIdSymbolName =
 extern const char* const kReplicaIdSymbolName = "__xla_cpu_runtime_ReplicaId";
 extern const char* const kOneDnnMatMulSymbolName =
     "__xla_cpu_runtime_OneDnnMatMul";
+extern const char* const kOneDnnConvolutionSymbolName =
+    "__xla_cpu_runtime_OneDnnConvolution";
+extern const char* const kOneDnnSoftmaxSymbolName =
+    "__xla_cpu_runtime_OneDnnSoftmax";
 
 namespace {
 
@@ -361,134 +371,178 @@ class CpuAllReduceRendezvous
  protected:
   StatusOr<std::nullptr_t> RunCollectiveOp(
       const AllReduceParticipantData& participant) override {
+    // Every participant reduces its own slice of the buffers, so there is no
+    // primary thread.
     PrimitiveType datatype = participant.buffers.front().primitive_type;
-    bool primary = InitializationBarrier();
-
-    if (primary) {
-      switch (datatype) {
-        case S8:
-          DoAllReduce<S8>(participant);
-          break;
-        case PRED:
-        case U8:
-          DoAllReduce<U8>(participant);
-          break;
-        case S16:
-          DoAllReduce<S16>(participant);
-          break;
-        case U16:
-          DoAllReduce<U16>(participant);
-          break;
-        case S32:
-          DoAllReduce<S32>(participant);
-          break;
-        case U32:
-          DoAllReduce<U32>(participant);
-          break;
-        case S64:
-          DoAllReduce<S64>(participant);
-          break;
-        case U64:
-          DoAllReduce<U64>(participant);
-          break;
-        case F16:
-          DoAllReduce<F16>(participant);
-          break;
-        case F32:
-          DoAllReduce<F32>(participant);
-          break;
-        case F64:
-          DoAllReduce<F64>(participant);
-          break;
-        case C64:
-          DoAllReduce<C64>(participant);
-          break;
-        case C128:
-          DoAllReduce<C128>(participant);
-          break;
-        default:
-          LOG(FATAL) << "Unexpected datatype;";
-      }
+    switch (datatype) {
+      case S8:
+        DoAllReduce<S8>(participant);
+        break;
+      case PRED:
+      case U8:
+        DoAllReduce<U8>(participant);
+        break;
+      case S16:
+        DoAllReduce<S16>(participant);
+        break;
+      case U16:
+        DoAllReduce<U16>(participant);
+        break;
+      case S32:
+        DoAllReduce<S32>(participant);
+        break;
+      case U32:
+        DoAllReduce<U32>(participant);
+        break;
+      case S64:
+        DoAllReduce<S64>(participant);
+        break;
+      case U64:
+        DoAllReduce<U64>(participant);
+        break;
+      case F16:
+        DoAllReduce<F16>(participant);
+        break;
+      case F32:
+        DoAllReduce<F32>(participant);
+        break;
+      case F64:
+        DoAllReduce<F64>(participant);
+        break;
+      case C64:
+        DoAllReduce<C64>(participant);
+        break;
+      case C128:
+        DoAllReduce<C128>(participant);
+        break;
+      default:
+        LOG(FATAL) << "Unexpected datatype;";
     }
     return nullptr;
   }
 
  private:
+  // Number of elements reduced at a time, so that the partial result stays in
+  // L1 while the inputs of all participants are streamed through it.
+  static constexpr int64_t kBlockSizeInBytes = 16 * 1024;
+  // Slices are aligned to cache lines to avoid false sharing between
+  // participants writing adjacent slices of the same output.
+  static constexpr int64_t kCacheLineSizeInBytes = 64;
+
+  // Fused reduce-scatter + all-gather: participant `i` of `n` reduces the
+  // `i`-th slice of each buffer over all participants and writes the result
+  // to the outputs of all participants. The Rendezvous doesn't return before
+  // all participants are done, so no extra synchronization is needed.
   template <PrimitiveType PT>
-  void DoAllReduce(AllReduceParticipantData participant) {
+  void DoAllReduce(const AllReduceParticipantData& participant) {
     using T = typename primitive_util::PrimitiveTypeToNative<PT>::type;
-    absl::MutexLock lock(&mu_);
-    CHECK(!participants_.empty());
-    ReductionKind reduction_kind = participant.reduction_kind;
-    for (const auto& p : participants_) {
-      CHECK(p.reduction_kind == reduction_kind);
-    }
-    int num_participants = participants_.size();
-
-    // participant_idx -> buffer_idx -> buffer.
-    std::vector<std::vector<absl::Span<T>>> input_buffers;
-    std::vector<std::vector<absl::Span<T>>> output_buffers;
-    input_buffers.reserve(num_participants);
-    output_buffers.reserve(num_participants);
-    const AllReduceParticipantData& first_participant = participants_.front();
-
-    int buffers_per_participant = first_participant.buffers.size();
-    for (AllReduceParticipantData& p : participants_) {
-      CHECK_EQ(p.buffers.size(), buffers_per_participant);
-
-      input_buffers.emplace_back();
-      output_buffers.emplace_back();
-      std::vector<absl::Span<T>>& participant_input_buffers =
-          input_buffers.back();
-      std::vector<absl::Span<T>>& participant_output_buffers =
-          output_buffers.back();
-      participant_input_buffers.reserve(p.buffers.size());
-      participant_output_buffers.reserve(p.buffers.size());
-
-      for (int buffer_idx = 0; buffer_idx < buffers_per_participant;
-           buffer_idx++) {
-        auto& participant_buffer = p.buffers[buffer_idx];
-        participant_input_buffers.emplace_back(
-            static_cast<T*>(participant_buffer.source_data.opaque()),
-            participant_buffer.element_count);
-        participant_output_buffers.emplace_back(
-            static_cast<T*>(participant_buffer.destination_data.opaque()),
-            participant_buffer.element_count);
-        CHECK_EQ(participant_buffer.element_count,
-                 first_participant.buffers[buffer_idx].element_count);
+    std::vector<const AllReduceParticipantData*> participants;
+    {
+      absl::MutexLock lock(&mu_);
+      CHECK(!participants_.empty());
+      participants.reserve(participants_.size());
+      for (const AllReduceParticipantData& p : participants_) {
+        participants.push_back(&p);
       }
     }
+    // Reduce in a fixed order, independent of the arrival order.
+    absl::c_sort(participants, [](const AllReduceParticipantData* a,
+                                  const AllReduceParticipantData* b) {
+      return a->device_ordinal < b->device_ordinal;
+    });
+    const int64_t num_participants = participants.size();
+    const int64_t rank =
+        absl::c_find_if(participants,
+                        [&](const AllReduceParticipantData* p) {
+                          return p->device_ordinal ==
+                                 participant.device_ordinal;
+                        }) -
+        participants.begin();
+    CHECK_LT(rank, num_participants);
+
+    const ReductionKind reduction_kind = participant.reduction_kind;
+    const int64_t buffers_per_participant = participant.buffers.size();
+    for (const AllReduceParticipantData* p : participants) {
+      CHECK(p->reduction_kind == reduction_kind);
+      CHECK_EQ(p->buffers.size(), buffers_per_participant);
+    }
 
-    for (int buffer_idx = 0; buffer_idx < buffers_per_participant;
-         buffer_idx++) {
-      int element_count = first_participant.buffers[buffer_idx].element_count;
-      for (int idx = 0; idx < element_count; idx++) {
-        T out = GetInitialValue<T>(reduction_kind);
-        for (int participant_idx = 0; participant_idx < participants_.size();
-             participant_idx++) {
-          out = PerformReductionStep<T>(
-              reduction_kind, out,
-              input_buffers[participant_idx][buffer_idx][idx]);
+    constexpr int64_t kBlockSize =
+        std::max<int64_t>(1, kBlockSizeInBytes / sizeof(T));
+    constexpr int64_t kSliceAlignment =
+        std::max<int64_t>(1, kCacheLineSizeInBytes / sizeof(T));
+    std::vector<T> accumulator(kBlockSize);
+
+    for (int64_t buffer_idx = 0; buffer_idx < buffers_per_participant;
+         ++buffer_idx) {
+      const int64_t element_count =
+          participant.buffers[buffer_idx].element_count;
+      const int64_t slice_size =
+          (element_count + num_participants * kSliceAlignment - 1) /
+          (num_participants * kSliceAlignment) * kSliceAlignment;
+      const int64_t slice_begin = std::min(rank * slice_size, element_count);
+      const int64_t slice_end =
+          std::min(slice_begin + slice_size, element_count);
+      if (slice_begin == slice_end) {
+        continue;
+      }
+
+      std::vector<const T*> inputs;
+      std::vector<T*> outputs;
+      inputs.reserve(num_participants);
+      outputs.reserve(num_participants);
+      for (const AllReduceParticipantData* p : participants) {
+        const AllReduceParticipantData::Buffer& buffer =
+            p->buffers[buffer_idx];
+        CHECK_EQ(buffer.element_count, element_count);
+        inputs.push_back(static_cast<const T*>(buffer.source_data.opaque()));
+        outputs.push_back(static_cast<T*>(buffer.destination_data.opaque()));
+      }
+
+      for (int64_t begin = slice_begin; begin < slice_end;
+           begin += kBlockSize) {
+        const int64_t size = std::min(kBlockSize, slice_end - begin);
+        std::copy_n(inputs[0] + begin, size, accumulator.data());
+        for (int64_t i = 1; i < num_participants; ++i) {
+          ReduceInto<T>(reduction_kind, accumulator.data(), inputs[i] + begin,
+                        size);
         }
-        for (int participant_idx = 0; participant_idx < participants_.size();
-             participant_idx++) {
-          output_buffers[participant_idx][buffer_idx][idx] = out;
+        // All inputs of this block have been read, so writing an output that
+        // aliases its input is safe.
+        for (T* output : outputs) {
+          std::copy_n(accumulator.data(), size, output + begin);
         }
       }
     }
   }
 
+  // Computes `acc[i] = acc[i] <reduction_kind> in[i]`. The switch is hoisted
+  // out of the loop so that the loops can be vectorized.
   template <typename T>
-  T GetInitialValue(ReductionKind reduction_kind) {
+  void ReduceInto(ReductionKind reduction_kind, T* acc, const T* in,
+                  int64_t size) {
     switch (reduction_kind) {
       case ReductionKind::SUM:
-        return static_cast<T>(0);
+        for (int64_t i = 0; i < size; ++i) {
+          acc[i] = PerformReductionStep<T>(ReductionKind::SUM, acc[i], in[i]);
+        }
+        break;
       case ReductionKind::PRODUCT:
-        return static_cast<T>(1);
+        for (int64_t i = 0; i < size; ++i) {
+          acc[i] =
+              PerformReductionStep<T>(ReductionKind::PRODUCT, acc[i], in[i]);
+        }
+        break;
       case ReductionKind::MIN:
-        return std::numeric_limits<T>::max();
+        for (int64_t i = 0; i < size; ++i) {
+          acc[i] = PerformReductionStep<T>(ReductionKind::MIN, acc[i], in[i]);
+        }
+        break;
       case ReductionKind::MAX:
-        return std::numeric_limits<T>::min();
+        for (int64_t i = 0; i < size; ++i) {
+          acc[i] = PerformReductionStep<T>(ReductionKind::MAX, acc[i], in[i]);
+        }
+        break;
     }
   }
 
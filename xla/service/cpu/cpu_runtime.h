@@ -76,7 +76,9 @@ extern const char* const kParallelForkJoinSymbolName;
 extern const char* const kPrintfToStderrSymbolName;
 extern const char* const kStatusIsSuccessSymbolName;
 extern const char* const kKeyValueSortSymbolName;
+extern const char* const kRadixSortSymbolName;
 extern const char* const kTopKF32SymbolName;
+extern const char* const kScatterAddF32SymbolName;
 extern const char* const kAllReduceSymbolName;
 extern const char* const kCollectivePermuteSymbolName;
 extern const char* const kPartitionIdSymbolName;
@@ -85,6 +87,8 @@ extern const char* const kTracingStartSymbolName;
 extern const char* const kTracingEndSymbolName;
 extern const char* const kAllToAllSymbolName;
 extern const char* const kOneDnnMatMulSymbolName;
+extern const char* const kOneDnnConvolutionSymbolName;
+extern const char* const kOneDnnSoftmaxSymbolName;
 
 // All symbol names for XLA CPU runtime functions need to start with this
 // prefix.
@@ -15,18 +15,32 @@ limitations under the License.
 #define EIGEN_USE_THREADS
 #include "xla/service/cpu/cpu_runtime.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include <random>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include "absl/strings/str_format.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "xla/array2d.h"
 #include "xla/client/local_client.h"
 #include "xla/service/cpu/runtime_custom_call_status.h"
+#include "xla/service/cpu/runtime_fork_join.h"
+#include "xla/service/cpu/runtime_key_value_sort.h"
 #include "xla/service/cpu/runtime_matmul.h"
 #include "xla/service/cpu/runtime_matmul_acl.h"
+#include "xla/service/cpu/runtime_scatter.h"
 #include "xla/service/cpu/runtime_single_threaded_matmul.h"
+#include "xla/service/cpu/runtime_topk.h"
 #include "xla/service/custom_call_status_internal.h"
 #include "xla/types.h"
 #include "tsl/platform/env.h"
@@ -180,5 +194,270 @@ TEST_F(CpuRuntimeTest, FailureStatus) {
   ASSERT_FALSE(__xla_cpu_runtime_StatusIsSuccess(&success_status));
 }
 
+// Comparator of s32 keys in the calling convention of JIT compiled functions.
+void LessThanS32(char* result, char* /*run_options*/, char** params,
+                 char** /*buffer_table*/, int64_t* /*prof_counters*/) {
+  *result = *reinterpret_cast<int32_t*>(params[0]) <
+            *reinterpret_cast<int32_t*>(params[1]);
+}
+
+TEST_F(CpuRuntimeTest, ParallelKeyValueSort) {
+  // A single row long enough to be sorted by several threads, and many short
+  // rows sorted in parallel.
+  for (auto [a, b] : {std::pair<int64_t, int64_t>{1, 300000}, {1000, 100}}) {
+    std::minstd_rand0 generator;
+    std::uniform_int_distribution<int32_t> distribution(0, 1000);
+    std::vector<int32_t> keys(a * b);
+    std::vector<int32_t> values(a * b);
+    for (int64_t i = 0; i < a * b; ++i) {
+      keys[i] = distribution(generator);
+      values[i] = i;
+    }
+
+    tsl::thread::ThreadPool pool(tsl::Env::Default(), "XLAEigen", 4);
+    Eigen::ThreadPoolDevice device(pool.AsEigenThreadPool(), pool.NumThreads());
+    ExecutableRunOptions run_options;
+    run_options.set_intra_op_thread_pool(&device);
+
+    char* buffers[] = {reinterpret_cast<char*>(keys.data()),
+                       reinterpret_cast<char*>(values.data())};
+    int32_t sizes[] = {sizeof(int32_t), sizeof(int32_t)};
+    __xla_cpu_runtime_KeyValueSort(
+        a, b, /*c=*/1, buffers, /*values_count=*/2, sizes, /*is_stable=*/true,
+        reinterpret_cast<char*>(&run_options), /*prof_counters=*/nullptr,
+        LessThanS32);
+
+    for (int64_t row = 0; row < a; ++row) {
+      for (int64_t i = row * b + 1; i < (row + 1) * b; ++i) {
+        ASSERT_LE(keys[i - 1], keys[i]);
+        // Stable: equal keys keep the order of their original positions.
+        if (keys[i - 1] == keys[i]) {
+          ASSERT_LT(values[i - 1], values[i]);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(CpuRuntimeTest, RadixSort) {
+  std::vector<float> keys = {3.0f,
+                             -0.0f,
+                             std::numeric_limits<float>::infinity(),
+                             -2.5f,
+                             0.0f,
+                             -std::numeric_limits<float>::infinity(),
+                             1e-30f,
+                             -1e30f};
+  std::vector<float> expected = keys;
+  std::sort(expected.begin(), expected.end(), std::greater<float>());
+
+  // Sort the two rows of a [2, 4] array along the major dimension.
+  std::vector<float> columns = keys;
+  __xla_cpu_runtime_RadixSort(/*a=*/1, /*b=*/2, /*c=*/4,
+                              reinterpret_cast<char*>(columns.data()),
+                              sizeof(float), cpu::kRadixSortFloatKey,
+                              /*descending=*/false, /*run_options=*/nullptr);
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(columns[i], std::min(keys[i], keys[i + 4]));
+    EXPECT_EQ(columns[i + 4], std::max(keys[i], keys[i + 4]));
+  }
+
+  __xla_cpu_runtime_RadixSort(/*a=*/1, /*b=*/keys.size(), /*c=*/1,
+                              reinterpret_cast<char*>(keys.data()),
+                              sizeof(float), cpu::kRadixSortFloatKey,
+                              /*descending=*/true, /*run_options=*/nullptr);
+  EXPECT_EQ(keys, expected);
+  // Total order: +0 sorts before -0 when descending.
+  EXPECT_FALSE(std::signbit(keys[3]));
+  EXPECT_TRUE(std::signbit(keys[4]));
+
+  std::vector<int16_t> ints = {5, -3, 0, -32768, 32767, -3, 7};
+  std::vector<int16_t> expected_ints = ints;
+  std::sort(expected_ints.begin(), expected_ints.end());
+  __xla_cpu_runtime_RadixSort(/*a=*/1, /*b=*/ints.size(), /*c=*/1,
+                              reinterpret_cast<char*>(ints.data()),
+                              sizeof(int16_t), cpu::kRadixSortSignedKey,
+                              /*descending=*/false, /*run_options=*/nullptr);
+  EXPECT_EQ(ints, expected_ints);
+}
+
+TEST_F(CpuRuntimeTest, ParallelTopK) {
+  constexpr int64_t kBatchSize = 7;
+  constexpr int64_t kInputSize = 5000;
+  std::minstd_rand0 generator;
+  // Few distinct values, to exercise the tie breaking.
+  std::uniform_int_distribution<int32_t> distribution(-100, 100);
+  std::vector<float> values(kBatchSize * kInputSize);
+  for (float& value : values) {
+    value = distribution(generator) / 4.0f;
+  }
+  values[3] = std::numeric_limits<float>::quiet_NaN();
+
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "XLAEigen", 4);
+  Eigen::ThreadPoolDevice device(pool.AsEigenThreadPool(), pool.NumThreads());
+  ExecutableRunOptions run_options;
+  run_options.set_intra_op_thread_pool(&device);
+
+  // Selected with a heap, with std::nth_element, and the whole row.
+  for (int64_t k : {1, 10, 1000, kInputSize}) {
+    std::vector<float> out_values(kBatchSize * k);
+    std::vector<int32_t> out_indices(kBatchSize * k);
+    __xla_cpu_runtime_TopKF32(kBatchSize, kInputSize, k, values.data(),
+                              out_values.data(), out_indices.data(),
+                              &run_options);
+
+    for (int64_t batch = 0; batch < kBatchSize; ++batch) {
+      const float* row = values.data() + batch * kInputSize;
+      std::vector<int32_t> expected(kInputSize);
+      std::iota(expected.begin(), expected.end(), 0);
+      std::stable_sort(expected.begin(), expected.end(),
+                       [&](int32_t i1, int32_t i2) {
+                         // NaN sorts first.
+                         if (std::isnan(row[i1]) || std::isnan(row[i2])) {
+                           return std::isnan(row[i1]) && !std::isnan(row[i2]);
+                         }
+                         return row[i1] > row[i2];
+                       });
+      for (int64_t i = 0; i < k; ++i) {
+        ASSERT_EQ(out_indices[batch * k + i], expected[i])
+            << "k=" << k << " batch=" << batch << " i=" << i;
+        ASSERT_EQ(std::memcmp(&out_values[batch * k + i], &row[expected[i]],
+                              sizeof(float)),
+                  0);
+      }
+    }
+  }
+}
+
+TEST_F(CpuRuntimeTest, ParallelScatterAdd) {
+  constexpr int64_t kNumRows = 101;
+  constexpr int64_t kNumUpdates = 2000;
+  std::minstd_rand0 generator;
+  // Some indices are out of bounds, and their updates are skipped.
+  std::uniform_int_distribution<int32_t> index_distribution(-2, kNumRows + 1);
+  std::uniform_int_distribution<int32_t> value_distribution(-100, 100);
+
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "XLAEigen", 4);
+  Eigen::ThreadPoolDevice device(pool.AsEigenThreadPool(), pool.NumThreads());
+  ExecutableRunOptions run_options;
+  run_options.set_intra_op_thread_pool(&device);
+
+  // Rows that are partitioned, and rows too small to be.
+  for (int64_t row_size : {1, 16}) {
+    for (bool sorted : {false, true}) {
+      for (bool unique : {false, true}) {
+        std::vector<int32_t> indices(kNumUpdates);
+        if (unique) {
+          std::iota(indices.begin(), indices.end(), -2);
+          std::shuffle(indices.begin(), indices.end(), generator);
+        } else {
+          for (int32_t& index : indices) {
+            index = index_distribution(generator);
+          }
+        }
+        if (sorted) {
+          std::sort(indices.begin(), indices.end());
+        }
+        // Small integers, so that the sums are exact in any order.
+        std::vector<float> updates(kNumUpdates * row_size);
+        for (float& update : updates) {
+          update = value_distribution(generator);
+        }
+        std::vector<float> output(kNumRows * row_size);
+        for (float& value : output) {
+          value = value_distribution(generator);
+        }
+
+        std::vector<float> expected = output;
+        for (int64_t i = 0; i < kNumUpdates; ++i) {
+          if (indices[i] < 0 || indices[i] >= kNumRows) continue;
+          for (int64_t j = 0; j < row_size; ++j) {
+            expected[indices[i] * row_size + j] += updates[i * row_size + j];
+          }
+        }
+
+        __xla_cpu_runtime_ScatterAddF32(
+            kNumRows, row_size, kNumUpdates, indices.data(), updates.data(),
+            output.data(), sorted, unique, &run_options);
+        EXPECT_EQ(output, expected) << "row_size=" << row_size
+                                    << " sorted=" << sorted
+                                    << " unique=" << unique;
+      }
+    }
+  }
+}
+
+constexpr int32_t kInnerPartitions = 8;
+
+// Partition functions in the calling convention of JIT compiled functions,
+// counting the calls for each index in [partition[0], partition[1]).
+void CountPartition(void* result, const void* /*run_options*/,
+                    const void** /*params*/, void** /*buffer_table*/,
+                    void* status, int64_t* partition,
+                    uint64_t* /*prof_counters*/) {
+  auto* counts = static_cast<std::atomic<int32_t>*>(result);
+  for (int64_t i = partition[0]; i < partition[1]; ++i) {
+    counts[i].fetch_add(1);
+  }
+  if (partition[0] == 3) {
+    XlaCustomCallStatusSetFailure(static_cast<XlaCustomCallStatus*>(status),
+                                  "Failed", 6);
+  }
+}
+
+// Forks `kInnerPartitions` partitions per index of its own partition.
+void NestedForkJoin(void* result, const void* run_options,
+                    const void** /*params*/, void** buffer_table, void* status,
+                    int64_t* partition, uint64_t* prof_counters) {
+  std::vector<int64_t> inner_partitions;
+  for (int64_t i = partition[0] * kInnerPartitions;
+       i < partition[1] * kInnerPartitions; ++i) {
+    inner_partitions.push_back(i);
+    inner_partitions.push_back(i + 1);
+  }
+  __xla_cpu_runtime_ParallelForkJoin(
+      result, run_options, /*params=*/nullptr, buffer_table, status,
+      prof_counters, inner_partitions.size() / 2, inner_partitions.data(),
+      /*num_partitioned_dims=*/1, reinterpret_cast<void*>(&CountPartition));
+}
+
+TEST_F(CpuRuntimeTest, ParallelForkJoin) {
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "XLAEigen", 2);
+  Eigen::ThreadPoolDevice device(pool.AsEigenThreadPool(), pool.NumThreads());
+  ExecutableRunOptions run_options;
+  run_options.set_intra_op_thread_pool(&device);
+
+  // More partitions than threads, so that they are claimed dynamically, and
+  // nested fork-joins, which must not wait for the busy workers.
+  for (bool nested : {false, true}) {
+    constexpr int32_t kNumPartitions = 16;
+    std::vector<int64_t> partitions;
+    for (int64_t i = 0; i < kNumPartitions; ++i) {
+      partitions.push_back(i);
+      partitions.push_back(i + 1);
+    }
+    const int32_t num_counts =
+        nested ? kNumPartitions * kInnerPartitions : kNumPartitions;
+    std::vector<std::atomic<int32_t>> counts(num_counts);
+    XlaCustomCallStatus status;
+    __xla_cpu_runtime_ParallelForkJoin(
+        counts.data(), &run_options, /*params=*/nullptr,
+        /*buffer_table=*/nullptr, &status, /*prof_counters=*/nullptr,
+        kNumPartitions, partitions.data(), /*num_partitioned_dims=*/1,
+        nested ? reinterpret_cast<void*>(&NestedForkJoin)
+               : reinterpret_cast<void*>(&CountPartition));
+
+    for (int32_t i = 0; i < num_counts; ++i) {
+      EXPECT_EQ(counts[i].load(), 1) << "nested=" << nested << " i=" << i;
+    }
+    std::optional<absl::string_view> message =
+        CustomCallStatusGetMessage(&status);
+    ASSERT_TRUE(message.has_value());
+    // The nested fork-join of partition 0 failed in its partition 3.
+    EXPECT_EQ(*message, nested ? "Partition 0 error: Partition 3 error: Failed"
+                               : "Partition 3 error: Failed");
+  }
+}
+
 }  // namespace
 }  // namespace xla
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/cpu/cpu_xfeed.h"
 
 #include <cstring>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <string>
@@ -24,6 +25,7 @@ limitations under the License.
 
 #include "absl/base/casts.h"
 #include "absl/cleanup/cleanup.h"
+#include "absl/functional/function_ref.h"
 #include "xla/literal.h"
 #include "xla/literal_util.h"
 #include "xla/service/cpu/cpu_runtime.h"
@@ -57,6 +59,49 @@ class CpuInfeedBuffer : public cpu::runtime::XfeedBuffer {
   char* buffer_;
 };
 
+// Calls a callback when destroyed, i.e. once the last buffer referencing it is
+// done.
+class InfeedDoneNotifier {
+ public:
+  explicit InfeedDoneNotifier(std::function<void()> on_done)
+      : on_done_(std::move(on_done)) {}
+  ~InfeedDoneNotifier() { on_done_(); }
+
+ private:
+  std::function<void()> on_done_;
+};
+
+// An infeed buffer that points to memory owned by the client.
+class CpuBorrowedInfeedBuffer : public cpu::runtime::XfeedBuffer {
+ public:
+  CpuBorrowedInfeedBuffer(const void* data, int32_t length,
+                          std::shared_ptr<InfeedDoneNotifier> notifier)
+      : data_(data), length_(length), notifier_(std::move(notifier)) {}
+
+  int32_t length() override { return length_; }
+  // The runtime only reads from infeed buffers.
+  void* data() override { return const_cast<void*>(data_); }
+  void Done(StatusOr<Shape> /*shape*/) override { delete this; }
+
+ private:
+  const void* data_;
+  int32_t length_;
+  std::shared_ptr<InfeedDoneNotifier> notifier_;
+};
+
+Status ValidateInfeedSize(int64_t size) {
+  if (size > std::numeric_limits<int32_t>::max()) {
+    return InvalidArgument("CPU infeed of %d bytes exceeds maximum of %d bytes",
+                           size, std::numeric_limits<int32_t>::max());
+  }
+
+  if (size <= 0) {
+    return InvalidArgument("Infeed shape must have positive size; got %d",
+                           size);
+  }
+  return OkStatus();
+}
+
 class CpuOutfeedBuffer : public cpu::runtime::XfeedBuffer {
  public:
   CpuOutfeedBuffer(void* destination, int32_t length)
@@ -85,15 +130,7 @@ class CpuOutfeedBuffer : public cpu::runtime::XfeedBuffer {
 // clean up the memory allocated for InfeedBuffer.
 StatusOr<cpu::runtime::XfeedBuffer*> TransferBufferToInfeedInternal(
     int64_t size, const void* source) {
-  if (size > std::numeric_limits<int32_t>::max()) {
-    return InvalidArgument("CPU infeed of %d bytes exceeds maximum of %d bytes",
-                           size, std::numeric_limits<int32_t>::max());
-  }
-
-  if (size <= 0) {
-    return InvalidArgument("Infeed shape must have positive size; got %d",
-                           size);
-  }
+  TF_RETURN_IF_ERROR(ValidateInfeedSize(size));
 
   auto size_32 = static_cast<int32_t>(size);
   auto queued_buffer = new CpuInfeedBuffer(size_32);
@@ -102,15 +139,58 @@ StatusOr<cpu::runtime::XfeedBuffer*> TransferBufferToInfeedInternal(
   return queued_buffer;
 }
 
-Status TransferBufferToInfeed(int device_ordinal, int64_t size,
-                              const void* source) {
-  TF_ASSIGN_OR_RETURN(cpu::runtime::XfeedBuffer * buffer,
-                      TransferBufferToInfeedInternal(size, source));
+// Enqueues the buffers of `literal` returned by `make_buffer`, which is called
+// with the size and address of each array in `literal`.
+Status EnqueueLiteralToInfeed(
+    int device_ordinal, const LiteralSlice& literal,
+    absl::FunctionRef<StatusOr<cpu::runtime::XfeedBuffer*>(int64_t size,
+                                                           const void* source)>
+        make_buffer) {
+  const Shape& shape = literal.shape();
+  VLOG(2) << "Transferring literal to infeed with shape: "
+          << ShapeUtil::HumanString(shape);
 
   cpu::runtime::XfeedManager* xfeed_manager =
       cpu::runtime::GetXfeedManager(device_ordinal);
-  xfeed_manager->infeed()->EnqueueBuffersAtomically({buffer});
 
+  if (!shape.IsTuple()) {
+    int64_t size = cpu::runtime::GetByteSizeRequirement(shape, sizeof(void*));
+    TF_ASSIGN_OR_RETURN(cpu::runtime::XfeedBuffer * buffer,
+                        make_buffer(size, literal.untyped_data()));
+    xfeed_manager->infeed()->EnqueueBuffersAtomically({buffer});
+    return OkStatus();
+  }
+
+  if (ShapeUtil::IsNestedTuple(shape)) {
+    return Unimplemented(
+        "Infeed with a nested tuple shape is not supported: %s",
+        ShapeUtil::HumanString(literal.shape()));
+  }
+
+  // For a tuple, we transfer each of its elements to the device and
+  // enqueue the resulting destination device addresses with the
+  // infeed manager.
+  std::vector<cpu::runtime::XfeedBuffer*> buffers;
+  buffers.reserve(ShapeUtil::TupleElementCount(shape));
+  absl::Cleanup cleanup = [&buffers]() {
+    for (cpu::runtime::XfeedBuffer* b : buffers) {
+      b->Done(Cancelled("Failed to infeed buffer to device."));
+    }
+  };
+
+  for (int64_t i = 0; i < ShapeUtil::TupleElementCount(shape); ++i) {
+    const Shape& tuple_element_shape = ShapeUtil::GetSubshape(shape, {i});
+    int64_t tuple_element_size = cpu::runtime::GetByteSizeRequirement(
+        tuple_element_shape, sizeof(void*));
+    TF_ASSIGN_OR_RETURN(
+        cpu::runtime::XfeedBuffer * buffer,
+        make_buffer(tuple_element_size, literal.untyped_data({i})));
+    buffers.push_back(buffer);
+  }
+
+  xfeed_manager->infeed()->EnqueueBuffersAtomically(buffers);
+
+  std::move(cleanup).Cancel();
   return OkStatus();
 }
 
@@ -177,48 +257,22 @@ StatusOr<Shape> TransferTupleBuffersFromOutfeed(
 
 Status TransferLiteralToInfeedOnCpu(int device_ordinal,
                                     const LiteralSlice& literal) {
-  const Shape& shape = literal.shape();
-  VLOG(2) << "Transferring literal to infeed with shape: "
-          << ShapeUtil::HumanString(shape);
-
-  if (!shape.IsTuple()) {
-    int64_t size = cpu::runtime::GetByteSizeRequirement(shape, sizeof(void*));
-    return TransferBufferToInfeed(device_ordinal, size, literal.untyped_data());
-  }
-
-  if (ShapeUtil::IsNestedTuple(shape)) {
-    return Unimplemented(
-        "Infeed with a nested tuple shape is not supported: %s",
-        ShapeUtil::HumanString(literal.shape()));
-  }
-
-  // For a tuple, we transfer each of its elements to the device and
-  // enqueue the resulting destination device addresses with the
-  // infeed manager.
-  std::vector<cpu::runtime::XfeedBuffer*> buffers;
-  buffers.reserve(ShapeUtil::TupleElementCount(shape));
-  absl::Cleanup cleanup = [&buffers]() {
-    for (cpu::runtime::XfeedBuffer* b : buffers) {
-      b->Done(Cancelled("Failed to infeed buffer to device."));
-    }
-  };
-
-  for (int64_t i = 0; i < ShapeUtil::TupleElementCount(shape); ++i) {
-    const Shape& tuple_element_shape = ShapeUtil::GetSubshape(shape, {i});
-    int64_t tuple_element_size = cpu::runtime::GetByteSizeRequirement(
-        tuple_element_shape, sizeof(void*));
-    TF_ASSIGN_OR_RETURN(cpu::runtime::XfeedBuffer * buffer,
-                        TransferBufferToInfeedInternal(
-                            tuple_element_size, literal.untyped_data({i})));
-    buffers.push_back(buffer);
-  }
-
-  cpu::runtime::XfeedManager* xfeed_manager =
-      cpu::runtime::GetXfeedManager(device_ordinal);
-  xfeed_manager->infeed()->EnqueueBuffersAtomically(buffers);
+  return EnqueueLiteralToInfeed(device_ordinal, literal,
+                                TransferBufferToInfeedInternal);
+}
 
-  std::move(cleanup).Cancel();
-  return OkStatus();
+Status TransferLiteralToInfeedOnCpuWithoutCopy(
+    int device_ordinal, const LiteralSlice& literal,
+    std::function<void()> on_done) {
+  auto notifier = std::make_shared<InfeedDoneNotifier>(std::move(on_done));
+  return EnqueueLiteralToInfeed(
+      device_ordinal, literal,
+      [&](int64_t size,
+          const void* source) -> StatusOr<cpu::runtime::XfeedBuffer*> {
+        TF_RETURN_IF_ERROR(ValidateInfeedSize(size));
+        return new CpuBorrowedInfeedBuffer(source, static_cast<int32_t>(size),
+                                           notifier);
+      });
 }
 
 Status TransferLiteralFromOutfeedOnCpu(int device_ordinal,
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_CPU_XFEED_H_
 #define XLA_SERVICE_CPU_CPU_XFEED_H_
 
+#include <functional>
 #include <vector>
 
 #include "xla/literal.h"
@@ -33,6 +34,17 @@ namespace xla {
 Status TransferLiteralToInfeedOnCpu(int device_ordinal,
                                     const LiteralSlice& literal);
 
+// Like TransferLiteralToInfeedOnCpu, but enqueues the buffers of `literal`
+// itself instead of copying them into buffers owned by the infeed queue. This
+// skips the copy on the host thread; the computation still copies each buffer
+// into the result of its infeed when it dequeues it.
+// `literal` must not be modified or destroyed until `on_done` is called, which
+// happens once all of its buffers were dequeued by the computation or dropped
+// by a reset of the infeed queue, or right away if the transfer fails.
+Status TransferLiteralToInfeedOnCpuWithoutCopy(int device_ordinal,
+                                               const LiteralSlice& literal,
+                                               std::function<void()> on_done);
+
 // Helper function to transfers from outfeed on CPU.
 Status TransferLiteralFromOutfeedOnCpu(int device_ordinal,
                                        MutableBorrowingLiteral literal);
@@ -206,15 +206,30 @@ class DotOpEmitter {
         .value_or(kDefaultTilingFactor);
   }
 
+  // Returns the (M, K, N in vector registers) tile size of the tiled GEMM.
   std::tuple<int64_t, int64_t, int64_t> GetGemmTileSize() const {
+    if (auto tile_size = options::LlvmIrGemmTileSize(hlo_module_config_)) {
+      return *tile_size;
+    }
     // Tuned for broadwell - Intel(R) Xeon(R) CPU E5-2690 v4 @ 2.60GHz
     //
     // TODO(b/80093688): Tune for other architectures and centralize this
     // information in one place.
     const std::tuple<int64_t, int64_t, int64_t> kDefaultTileSize =
         std::tuple<int64_t, int64_t, int64_t>(11, 9, 1);
-    return options::LlvmIrGemmTileSize(hlo_module_config_)
-        .value_or(kDefaultTileSize);
+    const int64_t num_registers =
+        target_machine_features_.vector_register_count(
+            *b_->GetInsertBlock()->getParent());
+    if (num_registers < 32) {
+      return kDefaultTileSize;
+    }
+    // With AVX-512's 32 vector registers the accumulator block can be two
+    // vectors wide: the tile_size_m x 2 accumulators, the two RHS vectors of
+    // the current k and one broadcast LHS element have to fit in registers.
+    constexpr int64_t kTileSizeNInVectors = 2;
+    const int64_t tile_size_m =
+        (num_registers - kTileSizeNInVectors - 1) / kTileSizeNInVectors;
+    return {tile_size_m, /*tile_size_k=*/8, kTileSizeNInVectors};
   }
 
   std::array<int64_t, 3> GetMlirGemmTileSize() const {
@@ -405,14 +420,20 @@ void DotOpEmitter::EmitTiledLlvmIrGemm() {
   std::tie(tile_size_m, tile_size_k, tile_size_n_in_vector_width) =
       GetGemmTileSize();
 
+  // Packing an LHS panel only pays off if it is reused for several register
+  // blocks along N.
+  bool pack_lhs =
+      n >= 2 * tile_size_n_in_vector_width * max_target_vector_width;
+
   EmitSmallGemm(
       /*scalar_type=*/primitive_type,
       /*m=*/m, /*k=*/k, /*n=*/n,
       /*max_vectorization_width=*/max_target_vector_width,
       /*max_vector_count=*/tile_size_n_in_vector_width,
       /*min_vectorization_width=*/std::min<int64_t>(4, max_target_vector_width),
-      /*tile_size_m=*/tile_size_m, /*tile_size_k=*/tile_size_k, /*lhs=*/lhs,
-      /*rhs=*/rhs, /*result=*/target, b_, hlo_module_config_);
+      /*tile_size_m=*/tile_size_m, /*tile_size_k=*/tile_size_k,
+      /*pack_lhs=*/pack_lhs, /*lhs=*/lhs, /*rhs=*/rhs, /*result=*/target, b_,
+      hlo_module_config_);
 }
 
 void DotOpEmitter::EmitTiledLlvmIrGemv() {
@@ -15,9 +15,11 @@ limitations under the License.
 
 #include "xla/service/cpu/elemental_ir_emitter.h"
 
+#include <limits>
 #include <string>
 
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/Module.h"
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -33,20 +35,66 @@ using xla::llvm_ir::IrArray;
 namespace xla {
 namespace cpu {
 
+llvm::Value* CpuElementalIrEmitter::EmitAtan2F32(llvm::Value* y,
+                                                 llvm::Value* x) {
+  llvm::Type* type = b()->getFloatTy();
+  auto constant = [&](double value) {
+    return llvm::ConstantFP::get(type, value);
+  };
+  llvm::Value* pi = constant(3.14159265358979323846);
+  llvm::Value* pi_over_2 = constant(1.57079632679489661923);
+  llvm::Value* pi_over_4 = constant(0.78539816339744830962);
+  llvm::Value* abs_x =
+      llvm_ir::EmitCallToIntrinsic(llvm::Intrinsic::fabs, {x}, {type}, b());
+  llvm::Value* abs_y =
+      llvm_ir::EmitCallToIntrinsic(llvm::Intrinsic::fabs, {y}, {type}, b());
+
+  // Reduce to the first octant: a = min(|x|, |y|) / max(|x|, |y|) in [0, 1],
+  // which is 0 if both are zero and 1 if both are infinite.
+  llvm::Value* y_is_larger = FCmpOGT(abs_y, abs_x);
+  llvm::Value* max_abs = Select(y_is_larger, abs_y, abs_x);
+  llvm::Value* min_abs = Select(y_is_larger, abs_x, abs_y);
+  llvm::Value* a = FDiv(min_abs, max_abs);
+  a = Select(FCmpOEQ(max_abs, constant(0.0)), constant(0.0), a);
+  a = Select(FCmpOEQ(min_abs, constant(std::numeric_limits<float>::infinity())),
+             constant(1.0), a);
+
+  // atan(a) as in Cephes' atanf, using atan(a) = pi/4 + atan((a - 1) / (a + 1))
+  // for a > tan(pi/8).
+  llvm::Value* reduce = FCmpOGT(a, constant(0.41421356237309504880));
+  llvm::Value* t = Select(
+      reduce, FDiv(FSub(a, constant(1.0)), FAdd(a, constant(1.0))), a);
+  llvm::Value* z = FMul(t, t);
+  llvm::Value* p = FAdd(FMul(constant(8.05374449538e-2), z),
+                        constant(-1.38776856032e-1));
+  p = FAdd(FMul(p, z), constant(1.99777106478e-1));
+  p = FAdd(FMul(p, z), constant(-3.33329491539e-1));
+  llvm::Value* result = FAdd(FMul(FMul(p, z), t), t);
+  result = FAdd(result, Select(reduce, pi_over_4, constant(0.0)));
+
+  // Undo the reduction. The sign bit of x distinguishes +0 and -0.
+  result = Select(y_is_larger, FSub(pi_over_2, result), result);
+  llvm::Value* x_is_negative =
+      ICmpSLT(BitCast(x, b()->getInt32Ty()), b()->getInt32(0));
+  result = Select(x_is_negative, FSub(pi, result), result);
+  result = llvm_ir::EmitCallToIntrinsic(llvm::Intrinsic::copysign, {result, y},
+                                        {type}, b());
+  return Select(FCmpUNO(x, y), FAdd(x, y), result);
+}
+
 StatusOr<llvm::Value*> CpuElementalIrEmitter::EmitAtan2(
     PrimitiveType prim_type, llvm::Value* lhs, llvm::Value* rhs,
     absl::string_view /*name*/) {
   std::string function_name;
-  bool cast_result_to_fp16 = false;
   switch (prim_type) {
+    // f16 and f32 are computed inline, which unlike a libm call doesn't keep
+    // the surrounding loop from being vectorized.
     case F16:
-      cast_result_to_fp16 = true;
-      lhs = FPCast(lhs, b()->getFloatTy());
-      rhs = FPCast(rhs, b()->getFloatTy());
-      [[fallthrough]];
+      return FPCast(EmitAtan2F32(FPCast(lhs, b()->getFloatTy()),
+                                 FPCast(rhs, b()->getFloatTy())),
+                    b()->getHalfTy());
     case F32:
-      function_name = "atan2f";
-      break;
+      return EmitAtan2F32(lhs, rhs);
     case F64:
       function_name = "atan2";
       break;
@@ -63,11 +111,7 @@ StatusOr<llvm::Value*> CpuElementalIrEmitter::EmitAtan2(
   function->setDoesNotThrow();
   function->setDoesNotAccessMemory();
   // Create an instruction to call the function.
-  llvm::Value* result = Call(function, {lhs, rhs});
-  if (cast_result_to_fp16) {
-    result = FPCast(result, b()->getHalfTy());
-  }
-  return result;
+  return Call(function, {lhs, rhs});
 }
 
 StatusOr<llvm::Value*> CpuElementalIrEmitter::EmitTanh(PrimitiveType prim_type,
@@ -53,6 +53,9 @@ class CpuElementalIrEmitter : public ElementalIrEmitter {
     return hlo_module_config_.debug_options().xla_cpu_enable_fast_min_max();
   }
 
+  // Returns atan2(y, x) for f32 operands, computed inline.
+  llvm::Value* EmitAtan2F32(llvm::Value* y, llvm::Value* x);
+
   const HloModuleConfig& hlo_module_config_;
   IrEmitter* ir_emitter_;
 };
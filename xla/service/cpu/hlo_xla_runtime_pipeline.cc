@@ -219,6 +219,8 @@ static Status CreateHloXlaPipeline(
     mlir::gml_st::GmlStCPUTilingOptions opts =
         mlir::gml_st::getDefaultCPUPipelineOptions(options.cpu_name);
     opts.matmulTileSizes = options.matmul_tile_sizes;
+    opts.lowerToMmt4d = options.enable_matmul_packing;
+    opts.vectorSize = options.vector_size;
     opts.inlineFusionClusters = false;
     mlir::gml_st::addCPUTilingPipeline(pm, opts);
   } else {
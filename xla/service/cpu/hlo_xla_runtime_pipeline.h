@@ -36,6 +36,11 @@ struct HloXlaRuntimePipelineOptions {
   bool sparse_bufferization = true;
   bool experimental_deallocation = false;
   bool enable_avx2 = true;
+  // Pack matmul operands into tiles (linalg.mmt4d) before tiling matmuls.
+  bool enable_matmul_packing = false;
+  // Number of elements of the vectors used for elementwise ops and 1D
+  // reductions, usually the number of f32 lanes of the target.
+  int64_t vector_size = 8;
   // Accelerate sparse computations with CUDA threading.
   // This is an experimental feature, so off by default.
   int32_t xla_cpu_sparse_cuda_threads = 0;
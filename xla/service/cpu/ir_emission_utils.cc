@@ -15,7 +15,11 @@ limitations under the License.
 
 #include "xla/service/cpu/ir_emission_utils.h"
 
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/layout_util.h"
 #include "xla/service/cpu/cpu_runtime.h"
 #include "xla/shape_util.h"
@@ -110,5 +114,58 @@ bool PotentiallyImplementedAsEigenConvolution(
              kernel_shape.dimensions_size() - 1;
 }
 
+bool PotentiallyImplementedAsRuntimeScatter(const HloInstruction& instr) {
+  const auto* scatter = DynCast<HloScatterInstruction>(&instr);
+  if (scatter == nullptr || scatter->scatter_operand_count() != 1) {
+    return false;
+  }
+  const Shape& operand_shape = scatter->scatter_operands()[0]->shape();
+  const Shape& indices_shape = scatter->scatter_indices()->shape();
+  const Shape& updates_shape = scatter->scatter_updates()[0]->shape();
+  if (operand_shape.element_type() != F32 ||
+      updates_shape.element_type() != F32 ||
+      indices_shape.element_type() != S32) {
+    return false;
+  }
+
+  // The combiner adds the update to the current value.
+  const HloInstruction* root = scatter->to_apply()->root_instruction();
+  if (root->opcode() != HloOpcode::kAdd ||
+      root->operand(0)->opcode() != HloOpcode::kParameter ||
+      root->operand(1)->opcode() != HloOpcode::kParameter ||
+      root->operand(0) == root->operand(1)) {
+    return false;
+  }
+
+  // The indices are a vector of row indices, optionally with a trailing index
+  // vector dimension of size 1.
+  const ScatterDimensionNumbers& dnums = scatter->scatter_dimension_numbers();
+  if (dnums.index_vector_dim() != 1 || indices_shape.rank() > 2 ||
+      (indices_shape.rank() == 2 && indices_shape.dimensions(1) != 1)) {
+    return false;
+  }
+  if (dnums.scatter_dims_to_operand_dims_size() != 1 ||
+      dnums.scatter_dims_to_operand_dims(0) != 0 ||
+      dnums.inserted_window_dims_size() != 1 ||
+      dnums.inserted_window_dims(0) != 0) {
+    return false;
+  }
+
+  // Each update is a whole row of the operand.
+  const int64_t rank = operand_shape.rank();
+  if (rank < 1 || updates_shape.rank() != rank ||
+      updates_shape.dimensions(0) != indices_shape.dimensions(0) ||
+      dnums.update_window_dims_size() != rank - 1) {
+    return false;
+  }
+  for (int64_t i = 1; i < rank; ++i) {
+    if (dnums.update_window_dims(i - 1) != i ||
+        updates_shape.dimensions(i) != operand_shape.dimensions(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace cpu
 }  // namespace xla
@@ -27,6 +27,11 @@ bool PotentiallyImplementedAsEigenConvolution(
     const HloInstruction& convolution,
     const TargetMachineFeatures& target_machine_features);
 
+// Returns true if `scatter` adds rows of f32 updates to the rows of its
+// operand given by a vector of s32 indices, which is implemented by a parallel
+// runtime call. The operand, updates and result must have row major layouts.
+bool PotentiallyImplementedAsRuntimeScatter(const HloInstruction& scatter);
+
 // Computes the minimum alignment guaranteed for a tensor of shape `shape` on
 // the target machine.
 int64_t GetMinimumAlignmentForArray(
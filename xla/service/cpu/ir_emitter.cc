@@ -24,6 +24,7 @@ limitations under the License.
 #include <map>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -63,6 +64,7 @@ limitations under the License.
 #include "xla/service/cpu/ir_emission_utils.h"
 #include "xla/service/cpu/ir_function.h"
 #include "xla/service/cpu/parallel_loop_emitter.h"
+#include "xla/service/cpu/runtime_key_value_sort.h"
 #include "xla/service/elemental_ir_emitter.h"
 #include "xla/service/llvm_ir/buffer_assignment_util.h"
 #include "xla/service/llvm_ir/dynamic_update_slice_util.h"
@@ -559,6 +561,71 @@ Status IrEmitter::HandleOutfeed(HloInstruction* outfeed) {
   return OkStatus();
 }
 
+namespace {
+// A sort that can be done by __xla_cpu_runtime_RadixSort.
+struct RadixSortParams {
+  RadixSortKeyKind key_kind;
+  bool descending;
+};
+
+// Matches sorts of a single operand whose comparator is a plain less-than or
+// greater-than comparison of its two parameters. Floating point keys are only
+// accepted with a total order comparison, under which the radix order of the
+// transformed bits is the comparison order.
+std::optional<RadixSortParams> MatchRadixSort(const HloSortInstruction* sort) {
+  if (sort->operand_count() != 1) {
+    return std::nullopt;
+  }
+  const HloInstruction* root = sort->to_apply()->root_instruction();
+  if (root->opcode() != HloOpcode::kCompare ||
+      root->operand(0)->opcode() != HloOpcode::kParameter ||
+      root->operand(1)->opcode() != HloOpcode::kParameter) {
+    return std::nullopt;
+  }
+  const auto* compare = Cast<HloCompareInstruction>(root);
+  int64_t lhs = root->operand(0)->parameter_number();
+  int64_t rhs = root->operand(1)->parameter_number();
+  if (lhs == rhs) {
+    return std::nullopt;
+  }
+  bool descending;
+  switch (compare->direction()) {
+    case ComparisonDirection::kLt:
+      descending = lhs == 1;
+      break;
+    case ComparisonDirection::kGt:
+      descending = lhs == 0;
+      break;
+    default:
+      return std::nullopt;
+  }
+
+  PrimitiveType type = sort->keys()->shape().element_type();
+  switch (type) {
+    case U8:
+    case U16:
+    case U32:
+    case U64:
+      return RadixSortParams{kRadixSortUnsignedKey, descending};
+    case S8:
+    case S16:
+    case S32:
+    case S64:
+      return RadixSortParams{kRadixSortSignedKey, descending};
+    case F16:
+    case BF16:
+    case F32:
+    case F64:
+      if (compare->type() != Comparison::Type::kFloatTotalOrder) {
+        return std::nullopt;
+      }
+      return RadixSortParams{kRadixSortFloatKey, descending};
+    default:
+      return std::nullopt;
+  }
+}
+}  // namespace
+
 Status IrEmitter::HandleSort(HloInstruction* hlo) {
   const HloSortInstruction* sort = Cast<HloSortInstruction>(hlo);
   TF_RETURN_IF_ERROR(EmitTargetAddressForOp(sort));
@@ -619,6 +686,19 @@ Status IrEmitter::HandleSort(HloInstruction* hlo) {
   }
 
   CHECK(absl::c_binary_search(thread_local_computations_, sort->to_apply()));
+  if (std::optional<RadixSortParams> radix_sort = MatchRadixSort(sort)) {
+    EmitCallToFunc(
+        runtime::kRadixSortSymbolName,
+        {b_.getInt64(higher_dimensions), b_.getInt64(sort_dimension_elements),
+         b_.getInt64(lower_dimensions),
+         PointerCast(destination_addresses[0], b_.getInt8PtrTy()),
+         b_.getInt32(ShapeUtil::ByteSizeOfPrimitiveType(keys_type)),
+         b_.getInt32(radix_sort->key_kind), b_.getInt1(radix_sort->descending),
+         GetExecutableRunOptionsArgument()},
+        b_.getVoidTy());
+    return OkStatus();
+  }
+
   llvm::Value* values = llvm_ir::EmitAllocaAtFunctionEntryWithCount(
       b_.getInt8PtrTy(), b_.getInt32(sort->operand_count()), "cc_values_alloca",
       &b_);
@@ -1945,8 +2025,45 @@ Status IrEmitter::HandleSendDone(HloInstruction* send_done) {
   return Unimplemented("Send-done is not implemented on CPU.");
 }
 
-Status IrEmitter::HandleScatter(HloInstruction*) {
-  return Unimplemented("Scatter is not implemented on CPUs.");
+Status IrEmitter::HandleScatter(HloInstruction* scatter) {
+  if (!PotentiallyImplementedAsRuntimeScatter(*scatter)) {
+    return Unimplemented("Scatter is not implemented on CPUs.");
+  }
+  const HloInstruction* operand = scatter->operand(0);
+  const HloInstruction* indices = scatter->operand(1);
+  const HloInstruction* updates = scatter->operand(2);
+  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(scatter->shape().layout()));
+  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(operand->shape().layout()));
+  TF_RET_CHECK(LayoutUtil::IsMonotonicWithDim0Major(updates->shape().layout()));
+
+  // The updates are applied in place, to a copy of the operand unless they
+  // share a buffer.
+  TF_RETURN_IF_ERROR(EmitTargetAddressForOp(scatter));
+  TF_ASSIGN_OR_RETURN(const BufferAllocation::Slice operand_slice,
+                      assignment_.GetUniqueSlice(operand, {}));
+  TF_ASSIGN_OR_RETURN(const BufferAllocation::Slice output_slice,
+                      assignment_.GetUniqueSlice(scatter, {}));
+  if (operand_slice != output_slice) {
+    TF_RETURN_IF_ERROR(EmitMemcpy(*operand, *scatter));
+  }
+
+  const Shape& operand_shape = operand->shape();
+  const int64_t num_rows = operand_shape.dimensions(0);
+  const int64_t row_size = ShapeUtil::ElementsIn(operand_shape) /
+                           std::max<int64_t>(num_rows, 1);
+  const auto& scatter_instr = *Cast<HloScatterInstruction>(scatter);
+  EmitCallToFunc(
+      runtime::kScatterAddF32SymbolName,
+      {b_.getInt64(num_rows), b_.getInt64(row_size),
+       b_.getInt64(updates->shape().dimensions(0)),
+       BitCast(GetEmittedValueFor(indices), b_.getInt32Ty()->getPointerTo()),
+       BitCast(GetEmittedValueFor(updates), b_.getFloatTy()->getPointerTo()),
+       BitCast(GetEmittedValueFor(scatter), b_.getFloatTy()->getPointerTo()),
+       b_.getInt1(scatter_instr.indices_are_sorted()),
+       b_.getInt1(scatter_instr.unique_indices()),
+       GetExecutableRunOptionsArgument()},
+      b_.getVoidTy());
+  return OkStatus();
 }
 
 Status IrEmitter::HandleSlice(HloInstruction* slice) {
@@ -2428,7 +2545,8 @@ Status IrEmitter::HandleTopK(HloInstruction* hlo) {
        b_.getInt64(input->shape().dimensions().back()), b_.getInt64(k),
        BitCast(values_ptr, b_.getFloatTy()->getPointerTo()),
        BitCast(out_values_ptr, b_.getFloatTy()->getPointerTo()),
-       BitCast(out_indices_ptr, b_.getInt32Ty()->getPointerTo())},
+       BitCast(out_indices_ptr, b_.getInt32Ty()->getPointerTo()),
+       GetExecutableRunOptionsArgument()},
       b_.getVoidTy());
 
   llvm_ir::EmitTuple(GetIrArrayFor(hlo), {out_values_ptr, out_indices_ptr},
@@ -2454,6 +2572,7 @@ Status IrEmitter::HandleOneDnnMatMul(HloInstruction* custom_call) {
   auto backend_config = typed_custom_call->backend_config<BackendConfig>();
   OneDnnMatMulConfig matmul_config;
   matmul_config.CopyFrom(backend_config->onednn_matmul_config());
+  matmul_config.set_constant_weights(rhs->opcode() == HloOpcode::kConstant);
   std::string str_config;
   matmul_config.SerializeToString(&str_config);
 
@@ -2473,6 +2592,83 @@ Status IrEmitter::HandleOneDnnMatMul(HloInstruction* custom_call) {
 
   return OkStatus();
 }
+
+Status IrEmitter::HandleOneDnnConvolution(HloInstruction* custom_call) {
+  auto typed_custom_call = Cast<HloCustomCallInstruction>(custom_call);
+  TF_ASSIGN_OR_RETURN(auto backend_config,
+                      typed_custom_call->backend_config<BackendConfig>());
+  OneDnnConvolutionConfig* conv_config =
+      backend_config.mutable_onednn_conv_config();
+  conv_config->set_constant_weights(custom_call->operand(1)->opcode() ==
+                                    HloOpcode::kConstant);
+  std::string str_config;
+  conv_config->SerializeToString(&str_config);
+
+  std::vector<StackAlloca> operand_stack_allocas;
+  for (HloInstruction* operand : custom_call->operands()) {
+    llvm_ir::IrArray operand_array(GetIrArrayFor(operand));
+    operand_stack_allocas.push_back(
+        GetAllocaAndEmitMemrefInfo(b_, operand_array));
+  }
+  // The bias is the optional third operand.
+  llvm::Value* bias = operand_stack_allocas.size() > 2
+                          ? operand_stack_allocas[2].value
+                          : llvm::ConstantPointerNull::get(b_.getPtrTy());
+
+  TF_RETURN_IF_ERROR(EmitTargetAddressForOp(custom_call));
+  llvm_ir::IrArray result_array = GetIrArrayFor(custom_call);
+  auto result_stack_alloca = GetAllocaAndEmitMemrefInfo(b_, result_array);
+
+  EmitCallToFunc(runtime::kOneDnnConvolutionSymbolName,
+                 {
+                     GetExecutableRunOptionsArgument(),
+                     operand_stack_allocas[0].value,
+                     operand_stack_allocas[1].value,
+                     bias,
+                     result_stack_alloca.value,
+                     b_.CreateGlobalStringPtr(llvm_ir::AsStringRef(str_config)),
+                     b_.getInt64(str_config.size()),
+                 },
+                 b_.getVoidTy());
+
+  for (StackAlloca& stack_alloca : operand_stack_allocas) {
+    stack_alloca.EmitLifetimeEnd();
+  }
+  result_stack_alloca.EmitLifetimeEnd();
+
+  return OkStatus();
+}
+
+Status IrEmitter::HandleOneDnnSoftmax(HloInstruction* custom_call) {
+  auto input = custom_call->operand(0);
+  llvm_ir::IrArray input_array(GetIrArrayFor(input));
+  auto input_stack_alloca = GetAllocaAndEmitMemrefInfo(b_, input_array);
+
+  TF_RETURN_IF_ERROR(EmitTargetAddressForOp(custom_call));
+  llvm_ir::IrArray result_array = GetIrArrayFor(custom_call);
+  auto result_stack_alloca = GetAllocaAndEmitMemrefInfo(b_, result_array);
+
+  auto typed_custom_call = Cast<HloCustomCallInstruction>(custom_call);
+  auto backend_config = typed_custom_call->backend_config<BackendConfig>();
+  OneDnnSoftmaxConfig softmax_config;
+  softmax_config.CopyFrom(backend_config->onednn_softmax_config());
+  std::string str_config;
+  softmax_config.SerializeToString(&str_config);
+
+  EmitCallToFunc(runtime::kOneDnnSoftmaxSymbolName,
+                 {
+                     GetExecutableRunOptionsArgument(),
+                     input_stack_alloca.value,
+                     result_stack_alloca.value,
+                     b_.CreateGlobalStringPtr(llvm_ir::AsStringRef(str_config)),
+                 },
+                 b_.getVoidTy());
+
+  input_stack_alloca.EmitLifetimeEnd();
+  result_stack_alloca.EmitLifetimeEnd();
+
+  return OkStatus();
+}
 #endif  // INTEL_MKL && ENABLE_ONEDNN_V3
 
 Status IrEmitter::HandleCustomCall(HloInstruction* custom_call) {
@@ -2489,6 +2685,12 @@ Status IrEmitter::HandleCustomCall(HloInstruction* custom_call) {
   if (custom_call->custom_call_target() == "__onednn$matmul") {
     return HandleOneDnnMatMul(custom_call);
   }
+  if (custom_call->custom_call_target() == "__onednn$convolution") {
+    return HandleOneDnnConvolution(custom_call);
+  }
+  if (custom_call->custom_call_target() == "__onednn$softmax") {
+    return HandleOneDnnSoftmax(custom_call);
+  }
 #endif  // INTEL_MKL && ENABLE_ONEDNN_V3
   absl::Span<HloInstruction* const> operands(custom_call->operands());
   llvm::Type* i8_ptr_type = b_.getInt8PtrTy();
@@ -0,0 +1,138 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/cpu/jit_object_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "xla/service/llvm_ir/llvm_util.h"
+#include "xla/status.h"
+#include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/file_statistics.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+constexpr absl::string_view kObjectExtension = ".o";
+
+// Identifies the running binary by its path, size and modification time.
+// Objects compiled by another build may call CPU runtime functions with a
+// different ABI, so they must not be reused.
+const std::string& GetBinaryIdentity() {
+  static const std::string* identity = [] {
+    tsl::Env* env = tsl::Env::Default();
+    std::string path = env->GetExecutablePath();
+    tsl::FileStatistics stat;
+    if (!env->Stat(path, &stat).ok()) {
+      return new std::string(path);
+    }
+    return new std::string(
+        absl::StrCat(path, ":", stat.length, ":", stat.mtime_nsec));
+  }();
+  return *identity;
+}
+
+// Writes `contents` to `path` through a temporary file, so that concurrent
+// readers never observe a partially written file.
+Status AtomicallyWriteFile(const std::string& path,
+                           absl::string_view contents) {
+  tsl::Env* env = tsl::Env::Default();
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return FailedPrecondition("Couldn't create a temporary file name for %s",
+                              path);
+  }
+  TF_RETURN_IF_ERROR(tsl::WriteStringToFile(env, tmp_path, contents));
+  return env->RenameFile(tmp_path, path);
+}
+
+}  // namespace
+
+std::string JitObjectCache::GetKey(const llvm::Module& module) const {
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(
+      absl::StrCat(GetBinaryIdentity(), "\n", compile_options_, "\n",
+                   llvm_ir::DumpToString(&module)));
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+std::string JitObjectCache::GetPath(absl::string_view key) const {
+  return tsl::io::JoinPath(cache_dir_, absl::StrCat(key, kObjectExtension));
+}
+
+std::unique_ptr<llvm::MemoryBuffer> JitObjectCache::getObject(
+    const llvm::Module* module) {
+  std::string key = GetKey(*module);
+  std::string path = GetPath(key);
+  {
+    absl::MutexLock lock(&mu_);
+    pending_keys_[module] = key;
+  }
+
+  tsl::Env* env = tsl::Env::Default();
+  if (!env->FileExists(path).ok()) {
+    VLOG(3) << "JIT object cache miss for " << key;
+    return nullptr;
+  }
+  std::string object;
+  if (Status status = tsl::ReadFileToString(env, path, &object);
+      !status.ok()) {
+    LOG(WARNING) << "Failed to read from the JIT object cache: " << status;
+    return nullptr;
+  }
+  VLOG(3) << "JIT object cache hit for " << key;
+  return llvm::MemoryBuffer::getMemBufferCopy(object,
+                                              module->getModuleIdentifier());
+}
+
+void JitObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                          llvm::MemoryBufferRef object) {
+  std::string key;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = pending_keys_.find(module);
+    if (it == pending_keys_.end()) {
+      return;
+    }
+    key = std::move(it->second);
+    pending_keys_.erase(it);
+  }
+
+  tsl::Env* env = tsl::Env::Default();
+  Status status = env->RecursivelyCreateDir(cache_dir_);
+  if (status.ok()) {
+    status = AtomicallyWriteFile(
+        GetPath(key),
+        absl::string_view(object.getBufferStart(), object.getBufferSize()));
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to write to the JIT object cache: " << status;
+    return;
+  }
+  VLOG(3) << "Stored " << key << " in the JIT object cache";
+}
+
+}  // namespace cpu
+}  // namespace xla
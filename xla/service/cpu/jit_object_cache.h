@@ -0,0 +1,83 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef XLA_SERVICE_CPU_JIT_OBJECT_CACHE_H_
+#define XLA_SERVICE_CPU_JIT_OBJECT_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace xla {
+namespace cpu {
+
+// An llvm::ObjectCache that persists the object files compiled by the CPU JIT
+// in a directory, so that a later process compiling the same HLO can skip LLVM
+// optimization and code generation.
+//
+// Objects are keyed by a fingerprint of the unoptimized LLVM module, of
+// `compile_options`, which must describe everything besides the module that
+// influences code generation (target, CPU features, optimization flags), and
+// of the identity of the running binary, since the objects call into the CPU
+// runtime linked into it.
+//
+// The cache directory may be shared between processes: entries are written to
+// a temporary file and atomically renamed into place.
+//
+// Thread-safe.
+class JitObjectCache : public llvm::ObjectCache {
+ public:
+  JitObjectCache(std::string cache_dir, std::string compile_options)
+      : cache_dir_(std::move(cache_dir)),
+        compile_options_(std::move(compile_options)) {}
+
+  // Returns the cached object file for `module`, or nullptr on a miss. Must be
+  // called before `module` is optimized, as it also records the key under
+  // which notifyObjectCompiled stores the object compiled from `module`.
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+  // Stores `object`, compiled from `module`, in the cache.
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+
+  // Returns the cache key of the unoptimized `module`.
+  std::string GetKey(const llvm::Module& module) const;
+
+  const std::string& cache_dir() const { return cache_dir_; }
+
+ private:
+  std::string GetPath(absl::string_view key) const;
+
+  const std::string cache_dir_;
+  const std::string compile_options_;
+
+  absl::Mutex mu_;
+  // Keys of the modules looked up and not yet compiled.
+  absl::flat_hash_map<const llvm::Module*, std::string> pending_keys_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_CPU_JIT_OBJECT_CACHE_H_
@@ -0,0 +1,95 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/cpu/jit_object_cache.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+constexpr char kIr[] = R"(
+define void @entry(ptr %arg0) {
+  ret void
+}
+)";
+
+constexpr char kOtherIr[] = R"(
+define void @entry(ptr %arg0) {
+  store i8 0, ptr %arg0
+  ret void
+}
+)";
+
+std::unique_ptr<llvm::Module> ParseModule(const char* ir,
+                                          llvm::LLVMContext& context) {
+  llvm::SMDiagnostic diagnostic;
+  std::unique_ptr<llvm::Module> module =
+      llvm::parseAssemblyString(ir, diagnostic, context);
+  CHECK(module != nullptr) << diagnostic.getMessage().str();
+  return module;
+}
+
+TEST(JitObjectCacheTest, KeyDependsOnModuleAndOptions) {
+  llvm::LLVMContext context;
+  auto module = ParseModule(kIr, context);
+  auto other_module = ParseModule(kOtherIr, context);
+
+  JitObjectCache cache("unused", "x86_64;skylake;+avx2");
+  std::string key = cache.GetKey(*module);
+  EXPECT_EQ(key, cache.GetKey(*ParseModule(kIr, context)));
+  EXPECT_NE(key, cache.GetKey(*other_module));
+
+  JitObjectCache other_cache("unused", "x86_64;skylake;+avx512f");
+  EXPECT_NE(key, other_cache.GetKey(*module));
+}
+
+TEST(JitObjectCacheTest, MissThenHit) {
+  std::string cache_dir =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "jit_object_cache");
+  llvm::LLVMContext context;
+  auto module = ParseModule(kIr, context);
+  const std::string object = "not really an object file";
+
+  JitObjectCache cache(cache_dir, "options");
+  EXPECT_EQ(cache.getObject(module.get()), nullptr);
+  cache.notifyObjectCompiled(module.get(),
+                             llvm::MemoryBufferRef(object, "object"));
+
+  // A separate instance models a restarted process sharing the directory.
+  JitObjectCache other_cache(cache_dir, "options");
+  std::unique_ptr<llvm::MemoryBuffer> hit = other_cache.getObject(module.get());
+  ASSERT_NE(hit, nullptr);
+  EXPECT_EQ(hit->getBuffer().str(), object);
+
+  // Objects compiled with other options are not reused.
+  JitObjectCache cache_with_other_options(cache_dir, "other options");
+  EXPECT_EQ(cache_with_other_options.getObject(module.get()), nullptr);
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
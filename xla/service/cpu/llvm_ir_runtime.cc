@@ -37,6 +37,12 @@ const char* const kExpV16F32SymbolName = "__xla_cpu_runtime_ExpV16F32";
 const char* const kLogV4F32SymbolName = "__xla_cpu_runtime_LogV4F32AVX";
 const char* const kLogV8F32SymbolName = "__xla_cpu_runtime_LogV8F32AVX";
 const char* const kLogV16F32SymbolName = "__xla_cpu_runtime_LogV16F32AVX";
+const char* const kSinV4F32SymbolName = "__xla_cpu_runtime_SinV4F32";
+const char* const kSinV8F32SymbolName = "__xla_cpu_runtime_SinV8F32";
+const char* const kSinV16F32SymbolName = "__xla_cpu_runtime_SinV16F32";
+const char* const kCosV4F32SymbolName = "__xla_cpu_runtime_CosV4F32";
+const char* const kCosV8F32SymbolName = "__xla_cpu_runtime_CosV8F32";
+const char* const kCosV16F32SymbolName = "__xla_cpu_runtime_CosV16F32";
 
 namespace {
 
@@ -390,6 +396,126 @@ llvm::Value* GenerateVF32Log(llvm::IRBuilder<>* b, llvm::Value* input,
                      vsl.FloatAndNot(vsl.FloatOr(is_zero_mask, is_pos_inf_mask),
                                      result_finite_or_nan));
 }
+
+// Computes sin(input) or cos(input) with the range reduction and the
+// polynomials of Cephes' sinf and cosf, which are accurate for |input| <= 8192.
+// If any lane is outside of that range (or NaN), all lanes are recomputed by
+// calling libm and the lanes outside of the range are taken from that. The
+// vectorized loops calling this are expected to take that path rarely.
+llvm::Value* GenerateVF32SinOrCos(llvm::IRBuilder<>* b, llvm::Value* input,
+                                  int32_t vector_width, bool is_cos) {
+  VectorSupportLibrary vsl(F32, vector_width, b,
+                           is_cos ? "cos_f32" : "sin_f32");
+
+  const llvm::APFloat one = GetIeeeF32(1.0);
+  const llvm::APFloat minus_half = GetIeeeF32(-0.5);
+  const llvm::APFloat four_over_pi = GetIeeeF32(1.27323954473516);
+  // pi/4 split into three parts, for extended precision modular arithmetic.
+  const llvm::APFloat cephes_DP1 = GetIeeeF32(0.78515625);
+  const llvm::APFloat cephes_DP2 = GetIeeeF32(2.4187564849853515625e-4);
+  const llvm::APFloat cephes_DP3 = GetIeeeF32(3.77489497744594108e-8);
+  const llvm::APFloat cephes_sin_p0 = GetIeeeF32(-1.9515295891E-4);
+  const llvm::APFloat cephes_sin_p1 = GetIeeeF32(8.3321608736E-3);
+  const llvm::APFloat cephes_sin_p2 = GetIeeeF32(-1.6666654611E-1);
+  const llvm::APFloat cephes_cos_p0 = GetIeeeF32(2.443315711809948E-5);
+  const llvm::APFloat cephes_cos_p1 = GetIeeeF32(-1.388731625493765E-3);
+  const llvm::APFloat cephes_cos_p2 = GetIeeeF32(4.166664568298827E-2);
+  const llvm::APFloat max_reduced_input = GetIeeeF32(8192.0);
+
+  llvm::Type* i32_vector_type =
+      llvm::VectorType::get(b->getInt32Ty(), vector_width, false);
+  auto splat_i32 = [&](int32_t v) {
+    return b->CreateVectorSplat(vector_width, b->getInt32(v));
+  };
+
+  llvm::Value* abs_input = llvm_ir::EmitCallToIntrinsic(
+      llvm::Intrinsic::fabs, {input}, {vsl.vector_type()}, b);
+
+  // j = the octant of |input|, rounded up to an even number so that y = j *
+  // pi/4 is the closest multiple of pi/2.
+  llvm::Value* j =
+      b->CreateFPToSI(vsl.Mul(four_over_pi, abs_input), i32_vector_type);
+  j = b->CreateAnd(b->CreateAdd(j, splat_i32(1)), splat_i32(~1));
+  llvm::Value* y = b->CreateSIToFP(j, vsl.vector_type());
+
+  // x = |input| - y * pi/4, in [-pi/4, pi/4].
+  llvm::Value* x = vsl.Sub(abs_input, vsl.Mul(cephes_DP1, y));
+  x = vsl.Sub(x, vsl.Mul(cephes_DP2, y));
+  x = vsl.Sub(x, vsl.Mul(cephes_DP3, y));
+  llvm::Value* z = vsl.Mul(x, x);
+
+  llvm::Value* sin_x = vsl.MulAdd(z, cephes_sin_p0, cephes_sin_p1);
+  sin_x = vsl.MulAdd(sin_x, z, cephes_sin_p2);
+  sin_x = vsl.MulAdd(vsl.Mul(sin_x, z), x, x);
+
+  llvm::Value* cos_x = vsl.MulAdd(z, cephes_cos_p0, cephes_cos_p1);
+  cos_x = vsl.MulAdd(cos_x, z, cephes_cos_p2);
+  cos_x = vsl.MulAdd(vsl.Mul(cos_x, z), z,
+                     vsl.Add(one, vsl.Mul(minus_half, z)));
+
+  // In the octants 2 and 6, sin(|input|) = +/-cos(x) and cos(|input|) =
+  // -/+sin(x). The octants 4 and 6 flip the sign of sin, the octants 2 and 4
+  // flip the sign of cos. sin is odd, cos is even.
+  llvm::Value* swap =
+      b->CreateICmpNE(b->CreateAnd(j, splat_i32(2)), splat_i32(0));
+  llvm::Value* result;
+  llvm::Value* sign_bit;
+  if (is_cos) {
+    result = b->CreateSelect(swap, sin_x, cos_x);
+    sign_bit = b->CreateShl(
+        b->CreateAnd(b->CreateAdd(j, splat_i32(2)), splat_i32(4)),
+        splat_i32(29));
+  } else {
+    result = b->CreateSelect(swap, cos_x, sin_x);
+    sign_bit = b->CreateXor(
+        b->CreateAnd(b->CreateBitCast(input, i32_vector_type),
+                     splat_i32(0x80000000)),
+        b->CreateShl(b->CreateAnd(j, splat_i32(4)), splat_i32(29)));
+  }
+  result = b->CreateBitCast(
+      b->CreateXor(b->CreateBitCast(result, i32_vector_type), sign_bit),
+      vsl.vector_type());
+
+  // Fall back to libm for large inputs, infinities and NaNs.
+  llvm::Value* out_of_range = b->CreateFCmpUGT(
+      abs_input, vsl.SplatFloat(max_reduced_input), "out_of_range");
+  llvm::BasicBlock* fast_block = b->GetInsertBlock();
+  llvm::Function* function = fast_block->getParent();
+  llvm::BasicBlock* libm_block =
+      llvm::BasicBlock::Create(b->getContext(), "libm", function);
+  llvm::BasicBlock* done_block =
+      llvm::BasicBlock::Create(b->getContext(), "done", function);
+  b->CreateCondBr(b->CreateOrReduce(out_of_range), libm_block, done_block);
+
+  b->SetInsertPoint(libm_block);
+  llvm::FunctionCallee libm_function =
+      function->getParent()->getOrInsertFunction(
+          is_cos ? "cosf" : "sinf", b->getFloatTy(), b->getFloatTy());
+  llvm::Value* libm_result = vsl.GetZeroVector();
+  for (int32_t i = 0; i < vector_width; ++i) {
+    llvm::Value* lane = b->CreateCall(
+        libm_function, {b->CreateExtractElement(input, uint64_t(i))});
+    libm_result = b->CreateInsertElement(libm_result, lane, uint64_t(i));
+  }
+  libm_result = b->CreateSelect(out_of_range, libm_result, result);
+  b->CreateBr(done_block);
+
+  b->SetInsertPoint(done_block);
+  llvm::PHINode* phi = b->CreatePHI(vsl.vector_type(), 2);
+  phi->addIncoming(result, fast_block);
+  phi->addIncoming(libm_result, libm_block);
+  return phi;
+}
+
+llvm::Value* GenerateVF32Sin(llvm::IRBuilder<>* b, llvm::Value* input,
+                             int32_t vector_width) {
+  return GenerateVF32SinOrCos(b, input, vector_width, /*is_cos=*/false);
+}
+
+llvm::Value* GenerateVF32Cos(llvm::IRBuilder<>* b, llvm::Value* input,
+                             int32_t vector_width) {
+  return GenerateVF32SinOrCos(b, input, vector_width, /*is_cos=*/true);
+}
 }  // namespace
 
 void RewriteIRRuntimeFunctions(llvm::Module* module,
@@ -416,6 +542,16 @@ void RewriteIRRuntimeFunctions(llvm::Module* module,
   rewrite_calls(kLogV4F32SymbolName, GenerateVF32Log, /*vector_width=*/4);
   rewrite_calls(kLogV8F32SymbolName, GenerateVF32Log, /*vector_width=*/8);
   rewrite_calls(kLogV16F32SymbolName, GenerateVF32Log, /*vector_width=*/16);
+
+  // Scalar calls of sin and cos are left to libm, which the vector versions
+  // call for inputs outside of their range.
+  rewrite_calls(kSinV4F32SymbolName, GenerateVF32Sin, /*vector_width=*/4);
+  rewrite_calls(kSinV8F32SymbolName, GenerateVF32Sin, /*vector_width=*/8);
+  rewrite_calls(kSinV16F32SymbolName, GenerateVF32Sin, /*vector_width=*/16);
+
+  rewrite_calls(kCosV4F32SymbolName, GenerateVF32Cos, /*vector_width=*/4);
+  rewrite_calls(kCosV8F32SymbolName, GenerateVF32Cos, /*vector_width=*/8);
+  rewrite_calls(kCosV16F32SymbolName, GenerateVF32Cos, /*vector_width=*/16);
 }
 
 }  // namespace runtime
@@ -33,6 +33,12 @@ extern const char* const kExpV16F32SymbolName;
 extern const char* const kLogV4F32SymbolName;
 extern const char* const kLogV8F32SymbolName;
 extern const char* const kLogV16F32SymbolName;
+extern const char* const kSinV4F32SymbolName;
+extern const char* const kSinV8F32SymbolName;
+extern const char* const kSinV16F32SymbolName;
+extern const char* const kCosV4F32SymbolName;
+extern const char* const kCosV8F32SymbolName;
+extern const char* const kCosV16F32SymbolName;
 
 // The following CPU runtime functions have LLVM-IR only implementations:
 //
@@ -0,0 +1,216 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+
+#include "xla/service/cpu/onednn_convolution.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define EIGEN_USE_THREADS
+
+#include "dnnl.hpp"
+#include "absl/algorithm/container.h"
+#include "absl/base/dynamic_annotations.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/executable_run_options.h"
+#include "xla/service/cpu/backend_config.pb.h"
+#include "xla/service/cpu/onednn_memory_util.h"
+#include "xla/service/cpu/onednn_primitive_cache.h"
+#include "xla/service/cpu/runtime_lightweight_check.h"
+#include "tsl/util/onednn_threadpool.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+using dnnl::algorithm;
+using dnnl::convolution_forward;
+using dnnl::engine;
+using dnnl::memory;
+using dnnl::prop_kind;
+using dnnl::reorder;
+using dnnl::stream;
+
+// A convolution primitive together with the reorder of the weights into the
+// layout picked by oneDNN, if that differs from the layout of the XLA buffer.
+struct ConvolutionPrimitive {
+  convolution_forward primitive;
+  memory::desc weights_md;
+  std::optional<reorder> weights_reorder;
+};
+
+OneDnnPrimitiveCache<ConvolutionPrimitive>& ConvolutionCache() {
+  static auto* cache = new OneDnnPrimitiveCache<ConvolutionPrimitive>();
+  return *cache;
+}
+
+// Returns a descriptor of the buffer described by `minfo` whose dimensions
+// are the buffer's dimensions permuted by `order`. Permuting the strides along
+// with the dimensions lets oneDNN read the buffer in its canonical (N, C,
+// spatial...) or (O, I, spatial...) dimension order without copying it.
+memory::desc PermutedMemDesc(const MemrefInfo& minfo,
+                             const std::vector<int64_t>& order) {
+  memory::dims dims = minfo.GetOneDnnDims();
+  memory::dims strides = minfo.GetOneDnnStrides();
+  memory::dims permuted_dims, permuted_strides;
+  for (int64_t dim : order) {
+    permuted_dims.push_back(dims[dim]);
+    permuted_strides.push_back(strides[dim]);
+  }
+  return memory::desc(permuted_dims, minfo.GetOneDnnDataType(),
+                      permuted_strides);
+}
+
+template <typename RepeatedField>
+std::vector<int64_t> DimensionOrder(int64_t major, int64_t minor,
+                                    const RepeatedField& spatial) {
+  std::vector<int64_t> order = {major, minor};
+  order.insert(order.end(), spatial.begin(), spatial.end());
+  return order;
+}
+
+template <typename RepeatedField>
+memory::dims ToDims(const RepeatedField& field) {
+  return memory::dims(field.begin(), field.end());
+}
+
+}  // namespace
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_OneDnnConvolution(
+    const void* run_options_ptr, void* input, void* kernel, void* bias,
+    void* result, void* config, int64_t config_size) {
+  const xla::ExecutableRunOptions* run_options =
+      static_cast<const xla::ExecutableRunOptions*>(run_options_ptr);
+  XLA_LIGHTWEIGHT_CHECK(run_options != nullptr);
+  XLA_LIGHTWEIGHT_CHECK(run_options->intra_op_thread_pool() != nullptr);
+  tsl::OneDnnThreadPool thread_pool(
+      run_options->intra_op_thread_pool()->getPool(), false);
+  engine& cpu_engine = GetOneDnnCpuEngine();
+#ifndef ENABLE_ONEDNN_OPENMP
+  auto onednn_stream =
+      stream(dnnl::threadpool_interop::make_stream(cpu_engine, &thread_pool));
+#else
+  auto onednn_stream = stream(cpu_engine);
+#endif  // ENABLE_ONEDNN_OPENMP
+
+  std::string config_str(static_cast<const char*>(config), config_size);
+  OneDnnConvolutionConfig conv_config;
+  conv_config.ParseFromString(config_str);
+  const bool has_bias = absl::c_linear_search(conv_config.fused_ops(),
+                                              OneDnnConvolutionConfig::BIAS);
+  const bool has_relu = absl::c_linear_search(conv_config.fused_ops(),
+                                              OneDnnConvolutionConfig::RELU);
+  XLA_LIGHTWEIGHT_CHECK(!has_bias || bias != nullptr);
+
+  MemrefInfo input_minfo(input);
+  MemrefInfo kernel_minfo(kernel);
+  MemrefInfo result_minfo(result);
+
+  auto src_md = PermutedMemDesc(
+      input_minfo,
+      DimensionOrder(conv_config.input_batch_dimension(),
+                     conv_config.input_feature_dimension(),
+                     conv_config.input_spatial_dimensions()));
+  auto user_weights_md = PermutedMemDesc(
+      kernel_minfo,
+      DimensionOrder(conv_config.kernel_output_feature_dimension(),
+                     conv_config.kernel_input_feature_dimension(),
+                     conv_config.kernel_spatial_dimensions()));
+  auto dst_md = PermutedMemDesc(
+      result_minfo,
+      DimensionOrder(conv_config.output_batch_dimension(),
+                     conv_config.output_feature_dimension(),
+                     conv_config.output_spatial_dimensions()));
+  memory::desc bias_md;
+  std::optional<MemrefInfo> bias_minfo;
+  if (has_bias) {
+    bias_minfo.emplace(bias);
+    bias_md = bias_minfo->GetOneDnnMemDesc();
+  }
+
+  std::string key = config_str;
+  AppendOneDnnMemDescKey(src_md, &key);
+  AppendOneDnnMemDescKey(user_weights_md, &key);
+  AppendOneDnnMemDescKey(bias_md, &key);
+  AppendOneDnnMemDescKey(dst_md, &key);
+  ConvolutionPrimitive conv = ConvolutionCache().GetOrCreate(key, [&] {
+    // Let oneDNN pick the weights layout, e.g. the blocked layouts used by
+    // its AVX-512 and AMX kernels.
+    memory::desc any_weights_md(user_weights_md.get_dims(),
+                                user_weights_md.get_data_type(),
+                                memory::format_tag::any);
+    dnnl::primitive_attr attr;
+    if (has_relu) {
+      dnnl::post_ops post_ops;
+      post_ops.append_eltwise(algorithm::eltwise_relu, 0.f, 0.f);
+      attr.set_post_ops(post_ops);
+    }
+    memory::dims strides = ToDims(conv_config.strides());
+    memory::dims dilations = ToDims(conv_config.dilations());
+    memory::dims padding_low = ToDims(conv_config.padding_low());
+    memory::dims padding_high = ToDims(conv_config.padding_high());
+    auto conv_pd =
+        has_bias ? convolution_forward::primitive_desc(
+                       cpu_engine, prop_kind::forward_inference,
+                       algorithm::convolution_direct, src_md, any_weights_md,
+                       bias_md, dst_md, strides, dilations, padding_low,
+                       padding_high, attr)
+                 : convolution_forward::primitive_desc(
+                       cpu_engine, prop_kind::forward_inference,
+                       algorithm::convolution_direct, src_md, any_weights_md,
+                       dst_md, strides, dilations, padding_low, padding_high,
+                       attr);
+    ConvolutionPrimitive primitive{convolution_forward(conv_pd),
+                                   conv_pd.weights_desc(), std::nullopt};
+    if (conv_pd.weights_desc() != user_weights_md) {
+      primitive.weights_reorder.emplace(reorder::primitive_desc(
+          cpu_engine, user_weights_md, cpu_engine, conv_pd.weights_desc()));
+    }
+    return primitive;
+  });
+
+  auto src_mem = memory(src_md, cpu_engine, input_minfo.Data());
+  auto weights_mem = memory(user_weights_md, cpu_engine, kernel_minfo.Data());
+  auto dst_mem = memory(dst_md, cpu_engine, result_minfo.Data());
+  if (conv.weights_reorder.has_value()) {
+    // Only constant kernels are prepacked once, others are reordered on every
+    // call.
+    weights_mem = PrepackOneDnnWeights(
+        conv_config.constant_weights() ? run_options->onednn_weights_cache()
+                                       : nullptr,
+        key, *conv.weights_reorder, weights_mem, conv.weights_md,
+        onednn_stream);
+  }
+
+  std::unordered_map<int, memory> conv_args;
+  conv_args.insert({DNNL_ARG_SRC, src_mem});
+  conv_args.insert({DNNL_ARG_WEIGHTS, weights_mem});
+  conv_args.insert({DNNL_ARG_DST, dst_mem});
+  if (has_bias) {
+    conv_args.insert(
+        {DNNL_ARG_BIAS, memory(bias_md, cpu_engine, bias_minfo->Data())});
+  }
+
+  conv.primitive.execute(onednn_stream, conv_args);
+}
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
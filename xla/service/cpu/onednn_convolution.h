@@ -0,0 +1,40 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_ONEDNN_CONVOLUTION_H_
+#define XLA_SERVICE_CPU_ONEDNN_CONVOLUTION_H_
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+
+#include <cstdint>
+
+namespace xla {
+namespace cpu {
+
+extern "C" {
+// Runs a oneDNN forward convolution described by the serialized
+// OneDnnConvolutionConfig `config` of `config_size` bytes. The size is passed
+// explicitly because the serialized dimension numbers and padding usually
+// contain zero bytes. `bias` is only read if the config has a BIAS post-op and
+// may be null otherwise.
+extern void __xla_cpu_runtime_OneDnnConvolution(
+    const void* run_options_ptr, void* input, void* kernel, void* bias,
+    void* result, void* config, int64_t config_size);
+}  // extern "C"
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
+#endif  // XLA_SERVICE_CPU_ONEDNN_CONVOLUTION_H_
@@ -20,6 +20,9 @@ limitations under the License.
 #include <algorithm>
 #include <cmath>
 #include <initializer_list>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #define EIGEN_USE_THREADS
@@ -30,6 +33,7 @@ limitations under the License.
 #include "xla/executable_run_options.h"
 #include "xla/service/cpu/backend_config.pb.h"
 #include "xla/service/cpu/onednn_memory_util.h"
+#include "xla/service/cpu/onednn_primitive_cache.h"
 #include "xla/service/cpu/runtime_lightweight_check.h"
 #include "tsl/util/onednn_threadpool.h"
 
@@ -39,7 +43,21 @@ namespace {
 using dnnl::engine;
 using dnnl::matmul;
 using dnnl::memory;
+using dnnl::reorder;
 using dnnl::stream;
+
+// A matmul primitive together with the reorder of the weights into the layout
+// picked by oneDNN, if that differs from the layout of the XLA buffer.
+struct MatMulPrimitive {
+  matmul primitive;
+  memory::desc weights_md;
+  std::optional<reorder> weights_reorder;
+};
+
+OneDnnPrimitiveCache<MatMulPrimitive>& MatMulCache() {
+  static auto* cache = new OneDnnPrimitiveCache<MatMulPrimitive>();
+  return *cache;
+}
 }  // namespace
 
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_OneDnnMatMul(
@@ -51,7 +69,7 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_OneDnnMatMul(
   XLA_LIGHTWEIGHT_CHECK(run_options->intra_op_thread_pool() != nullptr);
   tsl::OneDnnThreadPool thread_pool(
       run_options->intra_op_thread_pool()->getPool(), false);
-  engine cpu_engine(engine::kind::cpu, 0);
+  engine& cpu_engine = GetOneDnnCpuEngine();
 #ifndef ENABLE_ONEDNN_OPENMP
   auto onednn_stream =
       stream(dnnl::threadpool_interop::make_stream(cpu_engine, &thread_pool));
@@ -78,17 +96,41 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_OneDnnMatMul(
   auto weights_mem = memory(weights_md, cpu_engine, rhs_minfo.Data());
   auto dst_mem = memory(dst_md, cpu_engine, result_minfo.Data());
 
-  auto matmul_pd =
-      matmul::primitive_desc(cpu_engine, src_md, weights_md, dst_md);
-
-  auto matmul_prim = matmul(matmul_pd);
+  std::string key = config_str;
+  AppendOneDnnMemDescKey(src_md, &key);
+  AppendOneDnnMemDescKey(weights_md, &key);
+  AppendOneDnnMemDescKey(dst_md, &key);
+  MatMulPrimitive matmul_prim = MatMulCache().GetOrCreate(key, [&] {
+    // Constant weights are prepacked once into the layout oneDNN prefers.
+    // Other weights are read in place, since reordering them on every call
+    // usually costs more than the faster kernel saves.
+    memory::desc primitive_weights_md =
+        matmul_config.constant_weights()
+            ? memory::desc(weights_md.get_dims(), weights_md.get_data_type(),
+                           memory::format_tag::any)
+            : weights_md;
+    auto matmul_pd = matmul::primitive_desc(cpu_engine, src_md,
+                                            primitive_weights_md, dst_md);
+    MatMulPrimitive primitive{matmul(matmul_pd), matmul_pd.weights_desc(),
+                              std::nullopt};
+    if (matmul_pd.weights_desc() != weights_md) {
+      primitive.weights_reorder.emplace(reorder::primitive_desc(
+          cpu_engine, weights_md, cpu_engine, matmul_pd.weights_desc()));
+    }
+    return primitive;
+  });
+  if (matmul_prim.weights_reorder.has_value()) {
+    weights_mem = PrepackOneDnnWeights(
+        run_options->onednn_weights_cache(), key, *matmul_prim.weights_reorder,
+        weights_mem, matmul_prim.weights_md, onednn_stream);
+  }
 
   std::unordered_map<int, memory> matmul_args;
   matmul_args.insert({DNNL_ARG_SRC, src_mem});
   matmul_args.insert({DNNL_ARG_WEIGHTS, weights_mem});
   matmul_args.insert({DNNL_ARG_DST, dst_mem});
 
-  matmul_prim.execute(onednn_stream, matmul_args);
+  matmul_prim.primitive.execute(onednn_stream, matmul_args);
 }
 
 }  // namespace cpu
@@ -0,0 +1,69 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+
+#include "xla/service/cpu/onednn_primitive_cache.h"
+
+#include <cstdint>
+#include <string>
+
+#include "dnnl.hpp"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+
+namespace xla {
+namespace cpu {
+
+dnnl::engine& GetOneDnnCpuEngine() {
+  static auto* cpu_engine = new dnnl::engine(dnnl::engine::kind::cpu, 0);
+  return *cpu_engine;
+}
+
+void AppendOneDnnMemDescKey(const dnnl::memory::desc& md, std::string* key) {
+  absl::StrAppend(key, static_cast<int>(md.get_data_type()), "[",
+                  absl::StrJoin(md.get_dims(), ","), "]{",
+                  absl::StrJoin(md.get_strides(), ","), "};");
+}
+
+dnnl::memory PrepackOneDnnWeights(OneDnnWeightsCache* cache,
+                                  absl::string_view key,
+                                  const dnnl::reorder& reorder,
+                                  dnnl::memory weights,
+                                  const dnnl::memory::desc& packed_md,
+                                  dnnl::stream& stream) {
+  auto prepack = [&] {
+    dnnl::memory packed(packed_md, GetOneDnnCpuEngine());
+    reorder.execute(stream, weights, packed);
+    return packed;
+  };
+  if (cache == nullptr) return prepack();
+  return cache->GetOrCreate(
+      absl::StrCat(key, "@",
+                   absl::Hex(reinterpret_cast<uintptr_t>(
+                       weights.get_data_handle()))),
+      [&] {
+        dnnl::memory packed = prepack();
+        // Other threads may use the cached weights on their own streams.
+        stream.wait();
+        return packed;
+      });
+}
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
@@ -0,0 +1,99 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_ONEDNN_PRIMITIVE_CACHE_H_
+#define XLA_SERVICE_CPU_ONEDNN_PRIMITIVE_CACHE_H_
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+
+#include <string>
+#include <utility>
+
+#include "dnnl.hpp"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace xla {
+namespace cpu {
+
+// Returns the CPU engine shared by all oneDNN runtime calls. Primitives are
+// bound to the engine they were created with, so cached primitives have to
+// be created with, and executed on streams of, this engine.
+dnnl::engine& GetOneDnnCpuEngine();
+
+// Appends a description of the dimensions, strides and data type of `md` to
+// `key`.
+void AppendOneDnnMemDescKey(const dnnl::memory::desc& md, std::string* key);
+
+// A thread-safe cache of oneDNN primitives.
+//
+// Creating a primitive runs oneDNN's implementation dispatch and, for JIT
+// implementations, code generation, which can cost more than executing it on
+// small shapes. The runtime calls emitted for an HLO module see the same few
+// shapes on every execution, so they keep their primitives in a cache keyed by
+// the memory descriptors and configuration of the call. Executing a primitive
+// concurrently from several threads is safe as long as it uses the library
+// managed scratchpad, which is oneDNN's default.
+template <typename PrimitiveT>
+class OneDnnPrimitiveCache {
+ public:
+  // Returns the primitive cached for `key`, creating it with `create` on a
+  // miss.
+  template <typename CreateFn>
+  PrimitiveT GetOrCreate(absl::string_view key, CreateFn&& create) {
+    {
+      absl::ReaderMutexLock lock(&mu_);
+      auto it = primitives_.find(key);
+      if (it != primitives_.end()) return it->second;
+    }
+    // Created outside of the lock: two threads may race to create the same
+    // primitive, in which case the first one to insert it wins.
+    PrimitiveT primitive = create();
+    absl::MutexLock lock(&mu_);
+    return primitives_.try_emplace(key, std::move(primitive)).first->second;
+  }
+
+ private:
+  absl::Mutex mu_;
+  absl::flat_hash_map<std::string, PrimitiveT> primitives_
+      ABSL_GUARDED_BY(mu_);
+};
+
+// A cache of weights prepacked into the layout picked by the primitive that
+// consumes them, e.g. the blocked layouts of the AVX-512 and AMX kernels.
+//
+// Only weights that are constants of an executable are cached: their address
+// and contents are fixed for the lifetime of the executable. The cache is
+// owned by the CpuExecutable and reaches the runtime calls through
+// ExecutableRunOptions, so entries never outlive the constants they were
+// computed from.
+class OneDnnWeightsCache : public OneDnnPrimitiveCache<dnnl::memory> {};
+
+// Returns `weights` reordered by `reorder` into `packed_md`. If `cache` is not
+// null, the reorder runs once per `key` and address of `weights`, and later
+// calls return the cached result.
+dnnl::memory PrepackOneDnnWeights(OneDnnWeightsCache* cache,
+                                  absl::string_view key,
+                                  const dnnl::reorder& reorder,
+                                  dnnl::memory weights,
+                                  const dnnl::memory::desc& packed_md,
+                                  dnnl::stream& stream);
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
+#endif  // XLA_SERVICE_CPU_ONEDNN_PRIMITIVE_CACHE_H_
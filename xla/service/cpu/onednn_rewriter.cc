@@ -17,8 +17,14 @@ limitations under the License.
 
 #include "xla/service/cpu/onednn_rewriter.h"
 
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
 #include "xla/hlo/ir/dfs_hlo_visitor_with_default.h"
+#include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/service/cpu/backend_config.pb.h"
 #include "xla/service/cpu/onednn_memory_util.h"
 #include "xla/service/pattern_matcher.h"
@@ -60,6 +66,38 @@ bool IsSupportedType(xla::PrimitiveType dtype) {
   return false;
 }
 
+// Returns whether `reduce` reduces its only input along the last dimension
+// with a reduction computation that applies `opcode` to its parameters.
+bool IsLastDimReduction(const HloInstruction* reduce, HloOpcode opcode) {
+  if (reduce->opcode() != HloOpcode::kReduce || reduce->operand_count() != 2) {
+    return false;
+  }
+  const int64_t rank = reduce->operand(0)->shape().rank();
+  if (!absl::c_equal(reduce->dimensions(), std::vector<int64_t>{rank - 1})) {
+    return false;
+  }
+  const HloInstruction* root = reduce->to_apply()->root_instruction();
+  return root->opcode() == opcode &&
+         root->operand(0)->opcode() == HloOpcode::kParameter &&
+         root->operand(1)->opcode() == HloOpcode::kParameter;
+}
+
+// Returns whether `broadcast` broadcasts a value per row back along the last
+// dimension, i.e. undoes the shape change of a last dimension reduction.
+bool IsLastDimBroadcast(const HloInstruction* broadcast) {
+  std::vector<int64_t> row_dims(broadcast->shape().rank() - 1);
+  absl::c_iota(row_dims, 0);
+  return absl::c_equal(broadcast->dimensions(), row_dims);
+}
+
+bool HasFusedOp(const HloInstruction* conv,
+                OneDnnConvolutionConfig::FusionKind kind) {
+  auto backend_config = conv->backend_config<BackendConfig>();
+  return backend_config.ok() &&
+         absl::c_linear_search(
+             backend_config->onednn_conv_config().fused_ops(), kind);
+}
+
 }  // namespace
 
 class OneDnnRewriterVisitor : public DfsHloRewriteVisitor {
@@ -130,6 +168,179 @@ class OneDnnRewriterVisitor : public DfsHloRewriteVisitor {
     TF_RETURN_IF_ERROR(ReplaceInstruction(dot_instr, matmul_call));
     return OkStatus();
   }
+
+  // Rewrites forward convolutions without grouping, input dilation or window
+  // reversal into oneDNN convolution custom calls. Bias and ReLU epilogues are
+  // fused later by HandleAdd and HandleMaximum.
+  Status HandleConvolution(HloInstruction* instr) override {
+    if (instr->HasControlDependencies()) return OkStatus();
+    const Shape& lhs_shape = instr->operand(0)->shape();
+    const Shape& rhs_shape = instr->operand(1)->shape();
+    const Shape& output_shape = instr->shape();
+    const PrimitiveType dtype = output_shape.element_type();
+    if (!IsSupportedType(dtype) || lhs_shape.element_type() != dtype ||
+        rhs_shape.element_type() != dtype) {
+      return OkStatus();
+    }
+    // oneDNN supports 1D, 2D and 3D convolutions.
+    if (output_shape.rank() < 3 || output_shape.rank() > 5 ||
+        output_shape.rank() > kOneDnnMaxNDims) {
+      return OkStatus();
+    }
+    if (ShapeUtil::IsZeroElementArray(lhs_shape) ||
+        ShapeUtil::IsZeroElementArray(rhs_shape) ||
+        ShapeUtil::IsZeroElementArray(output_shape)) {
+      return OkStatus();
+    }
+    if (instr->feature_group_count() != 1 || instr->batch_group_count() != 1) {
+      return OkStatus();
+    }
+    for (const WindowDimension& dim : instr->window().dimensions()) {
+      if (dim.base_dilation() != 1 || dim.window_reversal() ||
+          dim.padding_low() < 0 || dim.padding_high() < 0) {
+        return OkStatus();
+      }
+    }
+
+    const ConvolutionDimensionNumbers& dnums =
+        instr->convolution_dimension_numbers();
+    BackendConfig backend_config;
+    OneDnnConvolutionConfig* conv_config =
+        backend_config.mutable_onednn_conv_config();
+    conv_config->set_input_batch_dimension(dnums.input_batch_dimension());
+    conv_config->set_input_feature_dimension(dnums.input_feature_dimension());
+    *conv_config->mutable_input_spatial_dimensions() =
+        dnums.input_spatial_dimensions();
+    conv_config->set_kernel_input_feature_dimension(
+        dnums.kernel_input_feature_dimension());
+    conv_config->set_kernel_output_feature_dimension(
+        dnums.kernel_output_feature_dimension());
+    *conv_config->mutable_kernel_spatial_dimensions() =
+        dnums.kernel_spatial_dimensions();
+    conv_config->set_output_batch_dimension(dnums.output_batch_dimension());
+    conv_config->set_output_feature_dimension(
+        dnums.output_feature_dimension());
+    *conv_config->mutable_output_spatial_dimensions() =
+        dnums.output_spatial_dimensions();
+    for (const WindowDimension& dim : instr->window().dimensions()) {
+      conv_config->add_strides(dim.stride());
+      conv_config->add_padding_low(dim.padding_low());
+      conv_config->add_padding_high(dim.padding_high());
+      conv_config->add_dilations(dim.window_dilation() - 1);
+    }
+
+    HloInstruction* conv_call =
+        instr->AddInstruction(HloInstruction::CreateCustomCall(
+            output_shape,
+            {instr->mutable_operand(0), instr->mutable_operand(1)},
+            "__onednn$convolution"));
+    TF_RETURN_IF_ERROR(conv_call->set_backend_config(backend_config));
+    return ReplaceInstruction(instr, conv_call);
+  }
+
+  // Fuses the addition of a per output feature bias into a oneDNN
+  // convolution that has no post-ops yet.
+  Status HandleAdd(HloInstruction* instr) override {
+    if (instr->HasControlDependencies()) return OkStatus();
+    HloInstruction *conv, *broadcast, *bias;
+    auto pattern = m::AddAnyOrder(
+        m::CustomCall(&conv, {"__onednn$convolution"}).WithOneUser(),
+        m::Broadcast(&broadcast, m::Op(&bias).WithShape(m::Shape().WithRank(1)))
+            .WithOneUser());
+    if (!Match(instr, pattern)) return OkStatus();
+    TF_ASSIGN_OR_RETURN(auto backend_config,
+                        conv->backend_config<BackendConfig>());
+    const OneDnnConvolutionConfig& conv_config =
+        backend_config.onednn_conv_config();
+    if (!conv_config.fused_ops().empty() ||
+        bias->shape().element_type() != conv->shape().element_type() ||
+        !absl::c_equal(broadcast->dimensions(),
+                       std::vector<int64_t>{
+                           conv_config.output_feature_dimension()})) {
+      return OkStatus();
+    }
+    return FuseIntoConvolution(instr, conv, OneDnnConvolutionConfig::BIAS,
+                               bias);
+  }
+
+  // Fuses max(conv, 0) into a oneDNN convolution as a ReLU post-op.
+  Status HandleMaximum(HloInstruction* instr) override {
+    if (instr->HasControlDependencies()) return OkStatus();
+    HloInstruction* conv;
+    auto pattern = m::MaximumAnyOrder(
+        m::CustomCall(&conv, {"__onednn$convolution"}).WithOneUser(),
+        m::AnyOf<HloInstruction>(m::Broadcast(m::ConstantScalar(0)),
+                                 m::ConstantEffectiveScalar(0)));
+    if (!Match(instr, pattern) ||
+        HasFusedOp(conv, OneDnnConvolutionConfig::RELU)) {
+      return OkStatus();
+    }
+    return FuseIntoConvolution(instr, conv, OneDnnConvolutionConfig::RELU);
+  }
+
+  // Matches the numerically stable softmax along the last dimension
+  //
+  //   exp(x - broadcast(reduce_max(x))) / broadcast(reduce_sum(exp(...)))
+  //
+  // and rewrites it into a oneDNN softmax custom call.
+  Status HandleDivide(HloInstruction* instr) override {
+    if (instr->HasControlDependencies()) return OkStatus();
+    HloInstruction *src, *max_src, *max_broadcast, *max_reduce, *exp,
+        *sum_src, *sum_broadcast, *sum_reduce;
+    // Softmax is invariant to the per row shift, so the initial value of the
+    // max reduction does not matter.
+    auto pattern = m::Divide(
+        m::Exp(&exp,
+               m::Subtract(m::Op(&src),
+                           m::Broadcast(&max_broadcast,
+                                        m::Reduce(&max_reduce, m::Op(&max_src),
+                                                  m::ConstantScalar())))),
+        m::Broadcast(&sum_broadcast,
+                     m::Reduce(&sum_reduce, m::Op(&sum_src),
+                               m::ConstantScalar(0))));
+    if (!Match(instr, pattern)) return OkStatus();
+    const Shape& output_shape = instr->shape();
+    if (!IsSupportedType(output_shape.element_type()) ||
+        src->shape().element_type() != output_shape.element_type() ||
+        output_shape.rank() < 1 || output_shape.rank() > kOneDnnMaxNDims ||
+        ShapeUtil::IsZeroElementArray(output_shape)) {
+      return OkStatus();
+    }
+    if (max_src != src || sum_src != exp ||
+        !IsLastDimReduction(max_reduce, HloOpcode::kMaximum) ||
+        !IsLastDimReduction(sum_reduce, HloOpcode::kAdd) ||
+        !IsLastDimBroadcast(max_broadcast) ||
+        !IsLastDimBroadcast(sum_broadcast)) {
+      return OkStatus();
+    }
+
+    HloInstruction* softmax_call =
+        instr->AddInstruction(HloInstruction::CreateCustomCall(
+            output_shape, {src}, "__onednn$softmax"));
+    BackendConfig backend_config;
+    backend_config.mutable_onednn_softmax_config()->set_axis(
+        output_shape.rank() - 1);
+    TF_RETURN_IF_ERROR(softmax_call->set_backend_config(backend_config));
+    return ReplaceInstruction(instr, softmax_call);
+  }
+
+ private:
+  // Replaces `instr` with a copy of the oneDNN convolution `conv` that also
+  // applies the post-op `kind`. A bias is passed as an additional operand.
+  Status FuseIntoConvolution(HloInstruction* instr, HloInstruction* conv,
+                             OneDnnConvolutionConfig::FusionKind kind,
+                             HloInstruction* bias = nullptr) {
+    std::vector<HloInstruction*> operands(conv->operands().begin(),
+                                          conv->operands().end());
+    if (bias != nullptr) operands.push_back(bias);
+    HloInstruction* fused_call = instr->AddInstruction(
+        conv->CloneWithNewOperands(conv->shape(), operands));
+    TF_ASSIGN_OR_RETURN(auto backend_config,
+                        conv->backend_config<BackendConfig>());
+    backend_config.mutable_onednn_conv_config()->add_fused_ops(kind);
+    TF_RETURN_IF_ERROR(fused_call->set_backend_config(backend_config));
+    return ReplaceInstruction(instr, fused_call);
+  }
 };
 
 StatusOr<bool> OneDnnRewriter::Run(
@@ -0,0 +1,99 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+
+#include "xla/service/cpu/onednn_softmax.h"
+
+#include <string>
+#include <unordered_map>
+
+#define EIGEN_USE_THREADS
+
+#include "dnnl.hpp"
+#include "absl/base/dynamic_annotations.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/executable_run_options.h"
+#include "xla/service/cpu/backend_config.pb.h"
+#include "xla/service/cpu/onednn_memory_util.h"
+#include "xla/service/cpu/onednn_primitive_cache.h"
+#include "xla/service/cpu/runtime_lightweight_check.h"
+#include "tsl/util/onednn_threadpool.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+using dnnl::algorithm;
+using dnnl::engine;
+using dnnl::memory;
+using dnnl::prop_kind;
+using dnnl::softmax_forward;
+using dnnl::stream;
+
+OneDnnPrimitiveCache<softmax_forward>& SoftmaxCache() {
+  static auto* cache = new OneDnnPrimitiveCache<softmax_forward>();
+  return *cache;
+}
+}  // namespace
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_OneDnnSoftmax(
+    const void* run_options_ptr, void* input, void* result, void* config) {
+  const xla::ExecutableRunOptions* run_options =
+      static_cast<const xla::ExecutableRunOptions*>(run_options_ptr);
+  XLA_LIGHTWEIGHT_CHECK(run_options != nullptr);
+  XLA_LIGHTWEIGHT_CHECK(run_options->intra_op_thread_pool() != nullptr);
+  tsl::OneDnnThreadPool thread_pool(
+      run_options->intra_op_thread_pool()->getPool(), false);
+  engine& cpu_engine = GetOneDnnCpuEngine();
+#ifndef ENABLE_ONEDNN_OPENMP
+  auto onednn_stream =
+      stream(dnnl::threadpool_interop::make_stream(cpu_engine, &thread_pool));
+#else
+  auto onednn_stream = stream(cpu_engine);
+#endif  // ENABLE_ONEDNN_OPENMP
+
+  MemrefInfo input_minfo(input);
+  MemrefInfo result_minfo(result);
+
+  std::string config_str(static_cast<const char*>(config));
+  OneDnnSoftmaxConfig softmax_config;
+  softmax_config.ParseFromString(config_str);
+
+  auto src_md = input_minfo.GetOneDnnMemDesc();
+  auto dst_md = result_minfo.GetOneDnnMemDesc();
+
+  std::string key = config_str;
+  AppendOneDnnMemDescKey(src_md, &key);
+  AppendOneDnnMemDescKey(dst_md, &key);
+  auto softmax_prim = SoftmaxCache().GetOrCreate(key, [&] {
+    return softmax_forward(softmax_forward::primitive_desc(
+        cpu_engine, prop_kind::forward_inference, algorithm::softmax_accurate,
+        src_md, dst_md, softmax_config.axis()));
+  });
+
+  auto src_mem = memory(src_md, cpu_engine, input_minfo.Data());
+  auto dst_mem = memory(dst_md, cpu_engine, result_minfo.Data());
+
+  std::unordered_map<int, memory> softmax_args;
+  softmax_args.insert({DNNL_ARG_SRC, src_mem});
+  softmax_args.insert({DNNL_ARG_DST, dst_mem});
+
+  softmax_prim.execute(onednn_stream, softmax_args);
+}
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
@@ -18,7 +18,9 @@ limitations under the License.
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -30,6 +32,8 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/service/cpu/backend_config.pb.h"
+#include "xla/service/cpu/cpu_machine_model.h"
+#include "xla/service/cpu/cpu_machine_model.pb.h"
 #include "xla/service/cpu/ir_emission_utils.h"
 #include "xla/service/cpu/shape_partition.h"
 #include "xla/service/cpu/target_machine_features.h"
@@ -124,6 +128,70 @@ class DefaultCostModel : public ParallelCostModel {
   const std::unique_ptr<HloCostAnalysis> cost_analysis_;
 };
 
+// Cost model based on the measured properties of the host. The run time of an
+// instruction split into n tasks is estimated as the larger of its compute and
+// memory times, plus a fixed overhead per task, and the smallest task count
+// that gets close to the best estimate is picked. Memory bound instructions
+// thus stop being split further once their tasks saturate the memory
+// bandwidth, and small instructions aren't split into tasks dominated by the
+// overhead.
+class MachineModelCostModel : public ParallelCostModel {
+ public:
+  MachineModelCostModel(const int64_t max_parallelism,
+                        CpuMachineModelProto machine_model,
+                        std::unique_ptr<HloCostAnalysis> cost_analysis)
+      : max_parallelism_(max_parallelism),
+        machine_model_(std::move(machine_model)),
+        cost_analysis_(std::move(cost_analysis)) {}
+  ~MachineModelCostModel() override {}
+
+  int64_t GetParallelTaskCount(HloInstruction* instruction) override {
+    // Transcendental functions are assumed to cost as much as this many
+    // floating point operations.
+    constexpr double kTranscendentalFlops = 10;
+    // Overhead of scheduling and joining a task.
+    constexpr double kPerTaskOverheadSeconds = 5e-6;
+    // A higher task count must improve the estimate by at least this fraction.
+    constexpr double kMinImprovement = 0.02;
+
+    const double flops =
+        cost_analysis_->flop_count(*instruction) +
+        kTranscendentalFlops * cost_analysis_->transcendental_count(*instruction);
+    const double bytes = cost_analysis_->bytes_accessed(*instruction);
+    // Working sets that fit into the last level cache aren't limited by the
+    // memory bandwidth shared between the cores.
+    const bool fits_in_cache = bytes <= machine_model_.l3_cache_size();
+    // More tasks than cores would only time-slice the same cores.
+    const int64_t max_task_count =
+        std::max<int64_t>(1, std::min(max_parallelism_,
+                                      machine_model_.num_cores()));
+
+    int64_t best_task_count = 1;
+    double best_seconds = std::numeric_limits<double>::infinity();
+    for (int64_t task_count = 1; task_count <= max_task_count; ++task_count) {
+      double bandwidth =
+          task_count * machine_model_.per_core_memory_bandwidth();
+      if (!fits_in_cache) {
+        bandwidth = std::min(bandwidth, machine_model_.memory_bandwidth());
+      }
+      const double seconds =
+          std::max(flops / (task_count * machine_model_.per_core_flops()),
+                   bytes / bandwidth) +
+          task_count * kPerTaskOverheadSeconds;
+      if (seconds < best_seconds * (1 - kMinImprovement)) {
+        best_seconds = seconds;
+        best_task_count = task_count;
+      }
+    }
+    return best_task_count;
+  }
+
+ private:
+  const int64_t max_parallelism_;
+  const CpuMachineModelProto machine_model_;
+  const std::unique_ptr<HloCostAnalysis> cost_analysis_;
+};
+
 ParallelTaskAssignment::ParallelTaskAssignment(
     const int64_t max_parallelism,
     const HloCostAnalysis::ShapeSizeFunction& shape_size, HloModule* module,
@@ -134,7 +202,21 @@ ParallelTaskAssignment::ParallelTaskAssignment(
   auto cost_analysis = std::make_unique<HloCostAnalysis>(shape_size);
   HloComputation* computation = module->entry_computation();
   Status status = computation->root_instruction()->Accept(cost_analysis.get());
-  if (status.ok()) {
+  const std::string& machine_model_spec =
+      module->config().debug_options().xla_cpu_parallel_task_machine_model();
+  StatusOr<CpuMachineModelProto> machine_model =
+      FailedPrecondition("No CPU machine model requested");
+  if (status.ok() && !machine_model_spec.empty()) {
+    machine_model = GetCpuMachineModel(machine_model_spec);
+    if (!machine_model.ok()) {
+      LOG(WARNING) << "Failed to load the CPU machine model "
+                   << machine_model_spec << ": " << machine_model.status();
+    }
+  }
+  if (status.ok() && machine_model.ok()) {
+    cost_model_ = std::make_unique<MachineModelCostModel>(
+        max_parallelism, *std::move(machine_model), std::move(cost_analysis));
+  } else if (status.ok()) {
     // Set default cost model based on 'cost_analysis'.
     cost_model_ = std::make_unique<DefaultCostModel>(
         max_parallelism, shape_size, std::move(cost_analysis));
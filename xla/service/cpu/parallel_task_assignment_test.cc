@@ -15,11 +15,17 @@ limitations under the License.
 
 #include "xla/service/cpu/parallel_task_assignment.h"
 
+#include <memory>
+#include <string>
+
 #include "xla/service/cpu/cpu_executable.h"
 #include "xla/service/cpu/target_machine_features_fake.h"
 #include "xla/test.h"
 #include "xla/tests/hlo_test_base.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/test.h"
 
 namespace xla {
 namespace {
@@ -206,5 +212,49 @@ TEST_F(ParallelTaskAssignmentTest, ConstantNotParallelized) {
   EXPECT_FALSE(changed);
 }
 
+TEST_F(ParallelTaskAssignmentTest, MachineModelLimitsMemoryBoundOperations) {
+  // 8 cores saturate the memory bandwidth of this machine.
+  std::string machine_model_path =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "cpu_machine_model.txt");
+  TF_ASSERT_OK(tsl::WriteStringToFile(tsl::Env::Default(), machine_model_path,
+                                      R"pb(
+                                        num_cores: 96
+                                        per_core_memory_bandwidth: 1e10
+                                        memory_bandwidth: 8e10
+                                        l2_cache_size: 1048576
+                                        l3_cache_size: 33554432
+                                        per_core_flops: 5e10
+                                      )pb"));
+  constexpr char hlo_string[] = R"(
+  HloModule TestTaskParallel_machine_model
+    ENTRY add {
+      large0 = f32[16777216] parameter(0)
+      large1 = f32[16777216] parameter(1)
+      large = f32[16777216] add(large0, large1)
+      small0 = f32[1024] parameter(2)
+      small1 = f32[1024] parameter(3)
+      small = f32[1024] add(small0, small1)
+      ROOT tuple = (f32[16777216], f32[1024]) tuple(large, small)
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  DebugOptions debug_options = m->config().debug_options();
+  debug_options.set_xla_cpu_parallel_task_machine_model(machine_model_path);
+  m->mutable_config().set_debug_options(debug_options);
+
+  cpu::ParallelTaskAssignment assignment(/*max_parallelism=*/96,
+                                         shape_size_func_, m.get(),
+                                         &target_machine_features_);
+  HloComputation* entry = m->entry_computation();
+  EXPECT_EQ(assignment.GetTargetParallelTaskCount(
+                entry->GetInstructionWithName("large")),
+            8);
+  EXPECT_EQ(assignment.GetTargetParallelTaskCount(
+                entry->GetInstructionWithName("small")),
+            1);
+}
+
 }  // namespace
 }  // namespace xla
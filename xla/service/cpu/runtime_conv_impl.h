@@ -15,6 +15,10 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_RUNTIME_CONV_IMPL_H_
 #define XLA_SERVICE_CPU_RUNTIME_CONV_IMPL_H_
 
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tsl/framework/convolution/eigen_spatial_convolutions.h"
 
@@ -26,6 +30,100 @@ limitations under the License.
 namespace tensorflow {
 namespace xla {
 
+// Runs `fn(first, last)` over the range [0, n), split across the threads of
+// `device` if it has any.
+template <typename Fn>
+void ParallelForConvRows(const Eigen::DefaultDevice& device, Eigen::Index n,
+                         const Eigen::TensorOpCost& cost_per_row, Fn fn) {
+  fn(0, n);
+}
+
+#if defined(EIGEN_USE_THREADS)
+template <typename Fn>
+void ParallelForConvRows(const Eigen::ThreadPoolDevice& device, Eigen::Index n,
+                         const Eigen::TensorOpCost& cost_per_row, Fn fn) {
+  device.parallelFor(n, cost_per_row, fn);
+}
+#endif
+
+// Direct depthwise convolution, where each input channel is convolved with its
+// own `kernel_filters / input_channels` filters. The generic implementation
+// extracts image patches and runs a tiny contraction for every channel, which
+// is very slow when there are many channels; here each output pixel is
+// accumulated from the kernel taps instead, with the channels innermost.
+//
+// Does not support lhs (input) dilation.
+template <typename EigenDevice, typename ScalarType>
+void EigenDepthwiseConv2DImpl(
+    const EigenDevice& device, ScalarType* out, const ScalarType* lhs,
+    const ScalarType* rhs, Eigen::Index input_batch, Eigen::Index input_x,
+    Eigen::Index input_y, Eigen::Index input_channels, Eigen::Index kernel_x,
+    Eigen::Index kernel_y, Eigen::Index kernel_filters, Eigen::Index output_x,
+    Eigen::Index output_y, Eigen::Index x_stride, Eigen::Index y_stride,
+    Eigen::Index padding_x_before, Eigen::Index padding_y_before,
+    Eigen::Index rhs_x_dilation, Eigen::Index rhs_y_dilation) {
+  // Accumulate half precision results in float, like the contraction does.
+  using AccType =
+      std::conditional_t<std::is_same_v<ScalarType, Eigen::half>, float,
+                         ScalarType>;
+  const Eigen::Index multiplier = kernel_filters / input_channels;
+
+  // Each task computes whole rows of output pixels along y.
+  auto compute_rows = [&](Eigen::Index first, Eigen::Index last) {
+    std::vector<AccType> acc(output_y * kernel_filters);
+    for (Eigen::Index row = first; row < last; ++row) {
+      const Eigen::Index b = row / output_x;
+      const Eigen::Index ox = row % output_x;
+      std::fill(acc.begin(), acc.end(), AccType(0));
+      for (Eigen::Index kx = 0; kx < kernel_x; ++kx) {
+        const Eigen::Index ix =
+            ox * x_stride + kx * rhs_x_dilation - padding_x_before;
+        if (ix < 0 || ix >= input_x) continue;
+        for (Eigen::Index oy = 0; oy < output_y; ++oy) {
+          AccType* acc_pixel = acc.data() + oy * kernel_filters;
+          for (Eigen::Index ky = 0; ky < kernel_y; ++ky) {
+            const Eigen::Index iy =
+                oy * y_stride + ky * rhs_y_dilation - padding_y_before;
+            if (iy < 0 || iy >= input_y) continue;
+            const ScalarType* in =
+                lhs + ((b * input_x + ix) * input_y + iy) * input_channels;
+            const ScalarType* filter =
+                rhs + (kx * kernel_y + ky) * kernel_filters;
+            if (multiplier == 1) {
+              for (Eigen::Index c = 0; c < input_channels; ++c) {
+                acc_pixel[c] += static_cast<AccType>(in[c]) *
+                                static_cast<AccType>(filter[c]);
+              }
+              continue;
+            }
+            for (Eigen::Index c = 0; c < input_channels; ++c) {
+              const AccType value = static_cast<AccType>(in[c]);
+              for (Eigen::Index m = 0; m < multiplier; ++m) {
+                acc_pixel[c * multiplier + m] +=
+                    value * static_cast<AccType>(filter[c * multiplier + m]);
+              }
+            }
+          }
+        }
+      }
+      ScalarType* out_row = out + row * output_y * kernel_filters;
+      for (Eigen::Index i = 0; i < output_y * kernel_filters; ++i) {
+        out_row[i] = static_cast<ScalarType>(acc[i]);
+      }
+    }
+  };
+
+  const double flops_per_row =
+      2.0 * output_y * kernel_filters * kernel_x * kernel_y;
+  const double bytes_per_row =
+      sizeof(ScalarType) * (kernel_x * input_y * input_channels +
+                            output_y * kernel_filters);
+  ParallelForConvRows(
+      device, input_batch * output_x,
+      Eigen::TensorOpCost(bytes_per_row, bytes_per_row, flops_per_row),
+      compute_rows);
+}
+
 template <typename EigenDevice, typename ScalarType>
 void EigenConv2DImpl(
     const EigenDevice& device, ScalarType* out, ScalarType* lhs,
@@ -38,6 +136,16 @@ void EigenConv2DImpl(
     Eigen::Index padding_y_after, Eigen::Index lhs_x_dilation,
     Eigen::Index lhs_y_dilation, Eigen::Index rhs_x_dilation,
     Eigen::Index rhs_y_dilation, Eigen::Index feature_group_count) {
+  if (feature_group_count > 1 && feature_group_count == input_channels &&
+      kernel_channels == 1 && lhs_x_dilation == 1 && lhs_y_dilation == 1) {
+    EigenDepthwiseConv2DImpl(device, out, lhs, rhs, input_batch, input_x,
+                             input_y, input_channels, kernel_x, kernel_y,
+                             kernel_filters, output_x, output_y, x_stride,
+                             y_stride, padding_x_before, padding_y_before,
+                             rhs_x_dilation, rhs_y_dilation);
+    return;
+  }
+
   const Eigen::TensorMap<Eigen::Tensor<const ScalarType, 4, Eigen::RowMajor>,
                          Eigen::Aligned>
       input(lhs, input_batch, input_x, input_y, input_channels);
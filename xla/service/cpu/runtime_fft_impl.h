@@ -15,7 +15,11 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_RUNTIME_FFT_IMPL_H_
 #define XLA_SERVICE_CPU_RUNTIME_FFT_IMPL_H_
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 
 #include "Eigen/Core"  // from @eigen_archive
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
@@ -52,10 +56,10 @@ void EigenFftC2C(const EigenDevice& device, Complex* out, Complex* operand,
     dims[i + 1] = fft_shape[i];
   }
   const Eigen::TensorMap<Eigen::Tensor<Complex, FFTRank + 1, Eigen::RowMajor>,
-                         Eigen::Aligned>
+                         Eigen::Unaligned>
       input(operand, dims);
   Eigen::TensorMap<Eigen::Tensor<Complex, FFTRank + 1, Eigen::RowMajor>,
-                   Eigen::Aligned>
+                   Eigen::Unaligned>
       output(out, dims);
   output.device(device) = input.template fft<Eigen::BothParts, direction>(axes);
 }
@@ -78,10 +82,10 @@ void EigenFftR2C(const EigenDevice& device, Complex* out, Real* operand,
     out_dims[i + 1] = i == FFTRank - 1 ? fft_shape[i] / 2 + 1 : fft_shape[i];
   }
   const Eigen::TensorMap<Eigen::Tensor<Real, FFTRank + 1, Eigen::RowMajor>,
-                         Eigen::Aligned>
+                         Eigen::Unaligned>
       input(operand, in_dims);
   Eigen::TensorMap<Eigen::Tensor<Complex, FFTRank + 1, Eigen::RowMajor>,
-                   Eigen::Aligned>
+                   Eigen::Unaligned>
       output(out, out_dims);
 
   // Create the axes (which are always trailing).
@@ -117,10 +121,10 @@ void EigenFftC2R(const EigenDevice& device, Real* out, Complex* operand,
     out_dims[i + 1] = fft_shape[i];
   }
   const Eigen::TensorMap<Eigen::Tensor<Complex, FFTRank + 1, Eigen::RowMajor>,
-                         Eigen::Aligned>
+                         Eigen::Unaligned>
       input(operand, in_dims);
   Eigen::TensorMap<Eigen::Tensor<Real, FFTRank + 1, Eigen::RowMajor>,
-                   Eigen::Aligned>
+                   Eigen::Unaligned>
       output(out, out_dims);
 
   // Calculate the shape of the temporary tensor for the full FFT and the
@@ -234,6 +238,88 @@ void EigenFftWithRank(const EigenDevice& device, void* out, void* operand,
   }
 }
 
+// Calls `fn(first, last)` for the batch elements [0, n), sharded over the
+// threads of the device if it has any.
+template <typename Fn>
+void ParallelForFftBatch(const Eigen::DefaultDevice& device, int64_t n,
+                         const Eigen::TensorOpCost& cost_per_batch, Fn fn) {
+  fn(0, n);
+}
+
+#if defined(EIGEN_USE_THREADS)
+template <typename Fn>
+void ParallelForFftBatch(const Eigen::ThreadPoolDevice& device, int64_t n,
+                         const Eigen::TensorOpCost& cost_per_batch, Fn fn) {
+  device.parallelFor(n, cost_per_batch, fn);
+}
+#endif
+
+// The Eigen tensor FFT transforms all lines of an axis sequentially, whatever
+// the device, so batched FFTs are sharded over the batch dimension instead:
+// each shard transforms a contiguous range of batch elements on its own
+// thread. The buffers are not necessarily aligned at shard boundaries, which
+// is why all tensor maps above are unaligned.
+template <int FFTRank, typename EigenDevice>
+void EigenFftBatched(const EigenDevice& device, void* out, void* operand,
+                     FftType fft_type, bool double_precision,
+                     int64_t input_batch, int64_t fft_length0,
+                     int64_t fft_length1, int64_t fft_length2) {
+  if (input_batch <= 1) {
+    EigenFftWithRank<FFTRank, EigenDevice>(
+        device, out, operand, fft_type, double_precision, input_batch,
+        fft_length0, fft_length1, fft_length2);
+    return;
+  }
+
+  const std::array<int64_t, 3> fft_shape = {
+      {fft_length0, fft_length1, fft_length2}};
+  int64_t fft_size = 1;
+  for (int i = 0; i < FFTRank; i++) {
+    fft_size *= fft_shape[i];
+  }
+  // Number of elements of the half spectrum of real FFTs.
+  const int64_t half_fft_size =
+      fft_size / std::max<int64_t>(fft_shape[FFTRank - 1], 1) *
+      (fft_shape[FFTRank - 1] / 2 + 1);
+
+  const int64_t real_bytes = double_precision ? sizeof(double) : sizeof(float);
+  const int64_t complex_bytes = 2 * real_bytes;
+  int64_t operand_bytes;
+  int64_t out_bytes;
+  switch (fft_type) {
+    case FftType::FFT:
+    case FftType::IFFT:
+      operand_bytes = fft_size * complex_bytes;
+      out_bytes = fft_size * complex_bytes;
+      break;
+    case FftType::RFFT:
+      operand_bytes = fft_size * real_bytes;
+      out_bytes = half_fft_size * complex_bytes;
+      break;
+    case FftType::IRFFT:
+      operand_bytes = half_fft_size * complex_bytes;
+      out_bytes = fft_size * real_bytes;
+      break;
+    default:
+      // Unsupported FFT type
+      abort();
+  }
+
+  // A radix-2 FFT of size N takes about 5 N log2(N) flops.
+  const double flops_per_batch =
+      5.0 * fft_size * std::max(1.0, std::log2(static_cast<double>(fft_size)));
+  auto compute_batches = [&](Eigen::Index first, Eigen::Index last) {
+    EigenFftWithRank<FFTRank, Eigen::DefaultDevice>(
+        Eigen::DefaultDevice(), static_cast<char*>(out) + first * out_bytes,
+        static_cast<char*>(operand) + first * operand_bytes, fft_type,
+        double_precision, last - first, fft_length0, fft_length1, fft_length2);
+  };
+  ParallelForFftBatch(
+      device, input_batch,
+      Eigen::TensorOpCost(operand_bytes, out_bytes, flops_per_batch),
+      compute_batches);
+}
+
 }  // namespace internal
 
 template <typename EigenDevice>
@@ -243,17 +329,17 @@ void EigenFftImpl(const EigenDevice& device, void* out, void* operand,
                   int64_t fft_length1, int64_t fft_length2) {
   switch (fft_rank) {
     case 1:
-      internal::EigenFftWithRank<1, EigenDevice>(device, out, operand, fft_type,
-                                                 double_precision, input_batch,
-                                                 fft_length0, 0, 0);
+      internal::EigenFftBatched<1, EigenDevice>(device, out, operand, fft_type,
+                                                double_precision, input_batch,
+                                                fft_length0, 0, 0);
       break;
     case 2:
-      internal::EigenFftWithRank<2, EigenDevice>(device, out, operand, fft_type,
-                                                 double_precision, input_batch,
-                                                 fft_length0, fft_length1, 0);
+      internal::EigenFftBatched<2, EigenDevice>(device, out, operand, fft_type,
+                                                double_precision, input_batch,
+                                                fft_length0, fft_length1, 0);
       break;
     case 3:
-      internal::EigenFftWithRank<3, EigenDevice>(
+      internal::EigenFftBatched<3, EigenDevice>(
           device, out, operand, fft_type, double_precision, input_batch,
           fft_length0, fft_length1, fft_length2);
       break;
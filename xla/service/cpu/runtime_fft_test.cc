@@ -13,9 +13,18 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#define EIGEN_USE_THREADS
 #include "xla/service/cpu/runtime_fft_impl.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/test.h"
+#include "tsl/platform/threadpool.h"
 
 TEST(FftTypeTest, MatchesProto) {
   EXPECT_EQ(::xla::FftType_ARRAYSIZE, 4);
@@ -29,3 +38,36 @@ TEST(FftTypeTest, MatchesProto) {
   EXPECT_EQ(::xla::FftType::IRFFT,
             static_cast<int32_t>(::xla::internal::FftType::IRFFT));
 }
+
+TEST(EigenFftTest, ShardedBatchMatchesSingleThreaded) {
+  tsl::thread::ThreadPool pool(tsl::Env::Default(), "XLAEigen", 4);
+  Eigen::ThreadPoolDevice device(pool.AsEigenThreadPool(), pool.NumThreads());
+
+  // Odd lengths, so that the shards don't start at aligned addresses.
+  constexpr int64_t kBatch = 7;
+  constexpr int64_t kLength0 = 3;
+  constexpr int64_t kLength1 = 5;
+  constexpr int64_t kNumFloats = 2 * kBatch * kLength0 * kLength1;
+
+  std::minstd_rand0 engine;
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  std::vector<float> operand(kNumFloats);
+  for (float& value : operand) value = distribution(engine);
+
+  for (auto fft_type :
+       {::xla::internal::FftType::FFT, ::xla::internal::FftType::IFFT,
+        ::xla::internal::FftType::RFFT, ::xla::internal::FftType::IRFFT}) {
+    std::vector<float> expected(kNumFloats, 0.0f);
+    std::vector<float> actual(kNumFloats, 0.0f);
+    ::xla::EigenFftImpl(Eigen::DefaultDevice(), expected.data(),
+                        operand.data(), fft_type, /*double_precision=*/false,
+                        /*fft_rank=*/2, kBatch, kLength0, kLength1, 0);
+    ::xla::EigenFftImpl(device, actual.data(), operand.data(), fft_type,
+                        /*double_precision=*/false, /*fft_rank=*/2, kBatch,
+                        kLength0, kLength1, 0);
+    for (int64_t i = 0; i < kNumFloats; ++i) {
+      EXPECT_NEAR(actual[i], expected[i], 1e-5)
+          << "fft_type=" << static_cast<int32_t>(fft_type) << " i=" << i;
+    }
+  }
+}
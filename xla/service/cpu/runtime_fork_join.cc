@@ -17,6 +17,15 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "absl/base/dynamic_annotations.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -29,9 +38,32 @@ limitations under the License.
 using ComputeFunctionType = void (*)(void*, const void*, const void**, void**,
                                      void*, int64_t*, uint64_t*);
 
-// Dispatches 'num_partitions - 1' calls to 'function_ptr' in parallel.
-// Calls 'function_ptr' for first partition inline.
-// Uses blocking counter to synchronize threads after parallel calls complete.
+namespace {
+
+// State shared by the threads running the partitions of one fork-join.
+//
+// Partitions are claimed dynamically from `next_partition` instead of being
+// bound to a thread up front, so threads that finish early pick up the
+// remaining partitions of a slow one. The state is reference counted because
+// workers that are scheduled only after all partitions were claimed may still
+// touch it once the fork-join returned.
+struct ForkJoinState {
+  explicit ForkJoinState(int32_t num_partitions)
+      : statuses(num_partitions), pending(num_partitions) {}
+
+  std::atomic<int32_t> next_partition{0};
+  std::vector<XlaCustomCallStatus> statuses;
+  tsl::BlockingCounter pending;
+};
+
+}  // namespace
+
+// Calls 'function_ptr' once per partition, in parallel. The partitions are
+// claimed dynamically by the calling thread and by up to 'num_partitions - 1'
+// workers of the intra-op thread pool, and the call returns as soon as all
+// partitions are done; it does not wait for workers that didn't start in time
+// to claim a partition, e.g. because the pool is busy with an enclosing
+// parallel region.
 //
 // The 'partitions' array has a total number of elements equal to
 // 'num_partitions * num_partitioned_dims * 2' (the '2' is necessary to specify
@@ -80,33 +112,38 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_ParallelForkJoin(
   // Compute partition stride in 'partitions' array.
   const int64_t stride = 2 * num_partitioned_dims;
 
-  std::vector<XlaCustomCallStatus> statuses(num_partitions);
+  auto state = std::make_shared<ForkJoinState>(num_partitions);
+
+  // Runs partitions until there are none left to claim.
+  auto run_partitions = [=](ForkJoinState& state) {
+    for (int32_t i = state.next_partition.fetch_add(1); i < num_partitions;
+         i = state.next_partition.fetch_add(1)) {
+      function(result_ptr, run_options_ptr, nullptr, buffer_table,
+               &state.statuses[i], &partitions[i * stride], prof_counters);
+      VLOG(3) << "ParallelForkJoin partition " << i << " done.";
+      state.pending.DecrementCount();
+    }
+  };
 
-  // Dispatch 'num_partitions - 1' compute functions to run in parallel.
-  tsl::BlockingCounter bc(num_partitions - 1);
-  for (int32_t i = 1; i < num_partitions; ++i) {
-    const int64_t offset = i * stride;
+  // There is no point in waking up more workers than there are threads.
+  const int32_t num_workers =
+      std::min(num_partitions - 1,
+               std::max(run_options->intra_op_thread_pool()->numThreads(), 1));
+  for (int32_t i = 0; i < num_workers; ++i) {
     run_options->intra_op_thread_pool()->enqueueNoNotification(
-        [i, function, result_ptr, run_options_ptr, buffer_table, prof_counters,
-         partitions, offset, &bc, &statuses]() {
-          function(result_ptr, run_options_ptr, nullptr, buffer_table,
-                   &statuses[i], &partitions[offset], prof_counters);
-          bc.DecrementCount();
-          VLOG(3) << "ParallelForkJoin partition " << i << " done.";
-        });
+        [state, run_partitions]() { run_partitions(*state); });
   }
 
-  // Call first compute function inline.
-  function(result_ptr, run_options_ptr, params, buffer_table, &statuses[0],
-           &partitions[0], prof_counters);
-  VLOG(3) << "ParallelForkJoin partition 0 done.";
-  bc.Wait();
+  // The calling thread takes part in the work rather than idling until the
+  // workers are done.
+  run_partitions(*state);
+  state->pending.Wait();
 
   // Collect all error messages (if any).
   std::vector<std::pair<int32_t, absl::string_view>> error_messages;
   for (int32_t i = 0; i < num_partitions; ++i) {
     std::optional<absl::string_view> msg =
-        xla::CustomCallStatusGetMessage(&statuses[i]);
+        xla::CustomCallStatusGetMessage(&state->statuses[i]);
     if (msg) {
       error_messages.emplace_back(i, *msg);
     }
@@ -12,16 +12,329 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+
 #include "xla/service/cpu/runtime_key_value_sort.h"
 
+#define EIGEN_USE_THREADS
+
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
-#include <memory>
 #include <numeric>
-#include <string>
+#include <vector>
 
 #include "absl/base/dynamic_annotations.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/executable_run_options.h"
+
+namespace {
+
+using LessThanFunction = void (*)(char*, char*, char**, char**, int64_t*);
+
+// Rows with at least this many elements are sorted by several threads if
+// there are not enough rows to keep the thread pool busy.
+constexpr int64_t kMinElementsForParallelRowSort = int64_t{1} << 15;
+
+// Rough cost of one call of the JIT compiled comparator, in cycles.
+constexpr double kComparatorCycles = 20.0;
+
+// Returns the intra-op thread pool if the sort may run on several threads.
+// The comparator updates the profile counters unsynchronized, so profiled
+// sorts stay on the calling thread.
+const Eigen::ThreadPoolDevice* GetThreadPool(char* run_options,
+                                             int64_t* prof_counters) {
+  if (run_options == nullptr || prof_counters != nullptr) return nullptr;
+  const auto* thread_pool =
+      reinterpret_cast<const xla::ExecutableRunOptions*>(run_options)
+          ->intra_op_thread_pool();
+  return thread_pool != nullptr && thread_pool->numThreads() > 1 ? thread_pool
+                                                                 : nullptr;
+}
+
+// The elements of a [a, b, c] shaped sort, see KeyValueSort below.
+struct SortedRows {
+  int64_t sort_dimension_elements;
+  int64_t sort_dimension_offset;
+  int64_t num_rows;
+
+  // Offset, in elements, of the first element of `row`. 'row' can be split
+  // into two values which index into the 'c' dimension and the 'a' dimension,
+  // respectively. 'row' % 'c' is the index into the 'c' dimension, 'row' / 'c'
+  // is the index into the 'a' dimension. When calculating the base offset, we
+  // need to multiply the index into the 'a' dimension with 'b' * 'c'.
+  // 'row' / 'c' * 'c' * 'b' = ('row' - 'row' % 'c') * 'b'.
+  int64_t BaseOffset(int64_t row) const {
+    return row % sort_dimension_offset +
+           (row - row % sort_dimension_offset) * sort_dimension_elements;
+  }
+
+  // Offset, in elements, of the `i`-th element of the row at `base_offset`.
+  int64_t ElementOffset(int64_t base_offset, int64_t i) const {
+    return base_offset + i * sort_dimension_offset;
+  }
+};
+
+// Runs `fn(first_row, last_row)` over all rows, in parallel if `thread_pool`
+// is not null. `cost_per_row` is in cycles.
+template <typename Fn>
+void ForEachRowBlock(const Eigen::ThreadPoolDevice* thread_pool,
+                     int64_t num_rows, double cost_per_row, Fn&& fn) {
+  if (thread_pool == nullptr || num_rows == 1) {
+    fn(0, num_rows);
+    return;
+  }
+  thread_pool->parallelFor(num_rows, Eigen::TensorOpCost(0, 0, cost_per_row),
+                           [&](Eigen::Index first, Eigen::Index last) {
+                             fn(first, last);
+                           });
+}
+
+// Sorts rows through the JIT compiled comparator.
+class ComparatorSort {
+ public:
+  ComparatorSort(const SortedRows& rows, char** values, int32_t values_count,
+                 int32_t* values_primitive_type_size_in_bytes, bool is_stable,
+                 char* run_options, int64_t* prof_counters,
+                 LessThanFunction less_than)
+      : rows_(rows),
+        values_(values),
+        values_count_(values_count),
+        sizes_(values_primitive_type_size_in_bytes),
+        is_stable_(is_stable),
+        run_options_(run_options),
+        prof_counters_(prof_counters),
+        less_than_(less_than) {}
+
+  // Sorts the rows [first_row, last_row) on the calling thread.
+  void SortRows(int64_t first_row, int64_t last_row) const {
+    std::vector<int64_t> indices(rows_.sort_dimension_elements);
+    std::vector<char*> comparison_values(2 * values_count_);
+    std::vector<char> reordered_values;
+    for (int64_t row = first_row; row < last_row; ++row) {
+      int64_t base_offset = rows_.BaseOffset(row);
+      std::iota(indices.begin(), indices.end(), 0);
+      Compare compare{this, base_offset, comparison_values.data()};
+      if (is_stable_) {
+        std::stable_sort(indices.begin(), indices.end(), compare);
+      } else {
+        std::sort(indices.begin(), indices.end(), compare);
+      }
+      Reorder(base_offset, indices, &reordered_values);
+    }
+  }
+
+  // Sorts the single row at `row` with all threads of `thread_pool`: chunks
+  // of the row are sorted in parallel and then merged pairwise, the merges of
+  // each round again in parallel. Merging is stable, so this is stable if the
+  // chunk sort is.
+  void SortRowInParallel(int64_t row,
+                         const Eigen::ThreadPoolDevice* thread_pool) const {
+    const int64_t n = rows_.sort_dimension_elements;
+    const int64_t base_offset = rows_.BaseOffset(row);
+    const int64_t num_chunks = std::min<int64_t>(
+        thread_pool->numThreads(), n / (kMinElementsForParallelRowSort / 2));
+
+    std::vector<int64_t> indices(n);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::vector<int64_t> bounds(num_chunks + 1);
+    for (int64_t i = 0; i <= num_chunks; ++i) {
+      bounds[i] = n * i / num_chunks;
+    }
+
+    const double chunk_cost = kComparatorCycles * (n / num_chunks) *
+                              std::log2(std::max<int64_t>(2, n / num_chunks));
+    thread_pool->parallelFor(
+        num_chunks, Eigen::TensorOpCost(0, 0, chunk_cost),
+        [&](Eigen::Index first, Eigen::Index last) {
+          std::vector<char*> comparison_values(2 * values_count_);
+          Compare compare{this, base_offset, comparison_values.data()};
+          for (Eigen::Index chunk = first; chunk < last; ++chunk) {
+            auto begin = indices.begin() + bounds[chunk];
+            auto end = indices.begin() + bounds[chunk + 1];
+            if (is_stable_) {
+              std::stable_sort(begin, end, compare);
+            } else {
+              std::sort(begin, end, compare);
+            }
+          }
+        });
+
+    std::vector<int64_t> merged(n);
+    while (bounds.size() > 2) {
+      const int64_t num_merges = (bounds.size() - 1) / 2;
+      thread_pool->parallelFor(
+          num_merges, Eigen::TensorOpCost(0, 0, kComparatorCycles * n),
+          [&](Eigen::Index first, Eigen::Index last) {
+            std::vector<char*> comparison_values(2 * values_count_);
+            Compare compare{this, base_offset, comparison_values.data()};
+            for (Eigen::Index i = first; i < last; ++i) {
+              std::merge(indices.begin() + bounds[2 * i],
+                         indices.begin() + bounds[2 * i + 1],
+                         indices.begin() + bounds[2 * i + 1],
+                         indices.begin() + bounds[2 * i + 2],
+                         merged.begin() + bounds[2 * i], compare);
+            }
+          });
+      std::vector<int64_t> next_bounds;
+      for (size_t i = 0; i < bounds.size(); i += 2) {
+        next_bounds.push_back(bounds[i]);
+      }
+      // An odd chunk out is carried over to the next round unchanged.
+      if ((bounds.size() - 1) % 2 != 0) {
+        std::copy(indices.begin() + bounds[bounds.size() - 2],
+                  indices.end(), merged.begin() + bounds[bounds.size() - 2]);
+        next_bounds.push_back(n);
+      }
+      indices.swap(merged);
+      bounds.swap(next_bounds);
+    }
+
+    std::vector<char> reordered_values;
+    Reorder(base_offset, indices, &reordered_values);
+  }
+
+ private:
+  // Compares element indices of the row at `base_offset`.
+  // `comparison_values` is scratch space for 2 * values_count pointers and
+  // must not be shared between threads.
+  struct Compare {
+    bool operator()(int64_t a, int64_t b) const {
+      for (int32_t i = 0; i < sort->values_count_; ++i) {
+        comparison_values[i * 2] =
+            sort->values_[i] +
+            sort->rows_.ElementOffset(base_offset, a) * sort->sizes_[i];
+        comparison_values[i * 2 + 1] =
+            sort->values_[i] +
+            sort->rows_.ElementOffset(base_offset, b) * sort->sizes_[i];
+      }
+      char result = 0;  // Overwritten by less_than.
+      sort->less_than_(&result, sort->run_options_, comparison_values, nullptr,
+                       sort->prof_counters_);
+      return result != 0u;
+    }
+
+    const ComparatorSort* sort;
+    int64_t base_offset;
+    char** comparison_values;
+  };
+
+  // Reorders the values of the row at `base_offset` according to the order
+  // defined by `indices`.
+  void Reorder(int64_t base_offset, const std::vector<int64_t>& indices,
+               std::vector<char>* reordered_values) const {
+    const int64_t n = rows_.sort_dimension_elements;
+    for (int32_t idx = 0; idx < values_count_; ++idx) {
+      const int64_t size = sizes_[idx];
+      reordered_values->resize(n * size);
+      for (int64_t i = 0; i < n; ++i) {
+        std::memcpy(
+            reordered_values->data() + i * size,
+            values_[idx] + rows_.ElementOffset(base_offset, indices[i]) * size,
+            size);
+      }
+      for (int64_t i = 0; i < n; ++i) {
+        std::memcpy(values_[idx] + rows_.ElementOffset(base_offset, i) * size,
+                    reordered_values->data() + i * size, size);
+      }
+    }
+  }
+
+  const SortedRows& rows_;
+  char** values_;
+  int32_t values_count_;
+  int32_t* sizes_;
+  bool is_stable_;
+  char* run_options_;
+  int64_t* prof_counters_;
+  LessThanFunction less_than_;
+};
+
+// Maps the bit pattern of a key to an unsigned integer with the same order.
+template <typename U>
+U ToRadixKey(U bits, int32_t key_kind, bool descending) {
+  constexpr U kSignBit = U{1} << (sizeof(U) * 8 - 1);
+  U key = bits;
+  switch (key_kind) {
+    case xla::cpu::kRadixSortSignedKey:
+      key = static_cast<U>(bits ^ kSignBit);
+      break;
+    case xla::cpu::kRadixSortFloatKey:
+      // Sign-magnitude to the total order of floating point numbers.
+      key = static_cast<U>((bits & kSignBit) ? ~bits : bits ^ kSignBit);
+      break;
+    default:
+      break;
+  }
+  return descending ? static_cast<U>(~key) : key;
+}
+
+// Inverse of ToRadixKey.
+template <typename U>
+U FromRadixKey(U key, int32_t key_kind, bool descending) {
+  constexpr U kSignBit = U{1} << (sizeof(U) * 8 - 1);
+  if (descending) key = static_cast<U>(~key);
+  switch (key_kind) {
+    case xla::cpu::kRadixSortSignedKey:
+      return static_cast<U>(key ^ kSignBit);
+    case xla::cpu::kRadixSortFloatKey:
+      return static_cast<U>((key & kSignBit) ? key ^ kSignBit : ~key);
+    default:
+      return key;
+  }
+}
+
+// Least significant digit first radix sort of `keys`, 8 bits per pass.
+// Passes in which all keys have the same digit are skipped.
+template <typename U>
+void RadixSort(std::vector<U>* keys, std::vector<U>* scratch) {
+  scratch->resize(keys->size());
+  for (int shift = 0; shift < static_cast<int>(sizeof(U) * 8); shift += 8) {
+    std::array<int64_t, 256> offsets = {};
+    for (U key : *keys) ++offsets[(key >> shift) & 0xff];
+    if (offsets[((*keys)[0] >> shift) & 0xff] ==
+        static_cast<int64_t>(keys->size())) {
+      continue;
+    }
+    int64_t offset = 0;
+    for (int64_t& bucket : offsets) {
+      int64_t count = bucket;
+      bucket = offset;
+      offset += count;
+    }
+    for (U key : *keys) (*scratch)[offsets[(key >> shift) & 0xff]++] = key;
+    keys->swap(*scratch);
+  }
+}
+
+template <typename U>
+void RadixSortRows(const SortedRows& rows, char* keys, int32_t key_kind,
+                   bool descending,
+                   const Eigen::ThreadPoolDevice* thread_pool) {
+  const int64_t n = rows.sort_dimension_elements;
+  U* data = reinterpret_cast<U*>(keys);
+  ForEachRowBlock(
+      thread_pool, rows.num_rows, 4.0 * sizeof(U) * n,
+      [&](int64_t first_row, int64_t last_row) {
+        std::vector<U> row_keys(n);
+        std::vector<U> scratch;
+        for (int64_t row = first_row; row < last_row; ++row) {
+          int64_t base_offset = rows.BaseOffset(row);
+          for (int64_t i = 0; i < n; ++i) {
+            row_keys[i] = ToRadixKey(data[rows.ElementOffset(base_offset, i)],
+                                     key_kind, descending);
+          }
+          RadixSort(&row_keys, &scratch);
+          for (int64_t i = 0; i < n; ++i) {
+            data[rows.ElementOffset(base_offset, i)] =
+                FromRadixKey(row_keys[i], key_kind, descending);
+          }
+        }
+      });
+}
+
+}  // namespace
 
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_KeyValueSort(
     int64_t a, int64_t b, int64_t c, char** values, int32_t values_count,
@@ -42,70 +355,49 @@ ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_KeyValueSort(
   // many rows that we need to sort. We iterate through these, calculate a
   // 'base_offset' value which points to the first element in that row, and add
   // i * c for accessing the 'i'-th element in that row.
+  //
+  // Rows are independent and sorted in parallel on the intra-op thread pool.
+  // A single long row is sorted by several threads instead.
+  SortedRows rows{/*sort_dimension_elements=*/b, /*sort_dimension_offset=*/c,
+                  /*num_rows=*/a * c};
+  if (rows.num_rows == 0 || b == 0) return;
+  ComparatorSort sort(rows, values, values_count,
+                      values_primitive_type_size_in_bytes, is_stable,
+                      run_options, prof_counters, less_than);
+  const Eigen::ThreadPoolDevice* thread_pool =
+      GetThreadPool(run_options, prof_counters);
+  if (thread_pool != nullptr && rows.num_rows == 1 &&
+      b >= kMinElementsForParallelRowSort) {
+    sort.SortRowInParallel(0, thread_pool);
+    return;
+  }
+  ForEachRowBlock(thread_pool, rows.num_rows,
+                  kComparatorCycles * b * std::log2(std::max<int64_t>(2, b)),
+                  [&](int64_t first_row, int64_t last_row) {
+                    sort.SortRows(first_row, last_row);
+                  });
+}
 
-  int64_t sort_dimension_elements = b;
-  int64_t num_iteration_elements = a * c;
-  int64_t sort_dimension_offset = c;
-
-  std::unique_ptr<int64_t[]> indices(new int64_t[sort_dimension_elements]);
-  std::unique_ptr<char*[]> comparison_values(new char*[2 * values_count]);
-  std::iota(indices.get(), indices.get() + sort_dimension_elements, 0);
-  std::unique_ptr<std::string[]> reordered_values(
-      new std::string[sort_dimension_elements]);
-  for (int64_t index = 0; index < num_iteration_elements; ++index) {
-    // If the sort should be stable, we have to reinitialize indices to iota to
-    // guarantee that we still keep the relative order in case of ties.
-    if (is_stable && index > 0) {
-      std::iota(indices.get(), indices.get() + sort_dimension_elements, 0);
-    }
-    // 'index' can be split into two values which index into the 'c' dimension
-    // and the 'a' dimension, respectively. 'index' % 'c' is the index into the
-    // 'c' dimension, 'index' / 'c' is the index into the 'a' dimension. When
-    // calculating the base offset, we need to multiply the index into the 'a'
-    // dimension with 'b' * 'c'.
-    // 'index' / 'c' * 'c' * 'b' = ('index' - 'index' % 'c') * 'b'.
-    int64_t base_offset =
-        index % sort_dimension_offset +
-        (index - index % sort_dimension_offset) * sort_dimension_elements;
-    auto compare_function = [&](int64_t a, int64_t b) -> bool {
-      for (int32_t i = 0; i < values_count; ++i) {
-        int64_t memory_index_lhs = (base_offset + a * sort_dimension_offset) *
-                                   values_primitive_type_size_in_bytes[i];
-        int64_t memory_index_rhs = (base_offset + b * sort_dimension_offset) *
-                                   values_primitive_type_size_in_bytes[i];
-        comparison_values[i * 2] = values[i] + memory_index_lhs;
-        comparison_values[i * 2 + 1] = values[i] + memory_index_rhs;
-      }
-      char result = 0;  // Overwritten by less_than.
-      less_than(&result, run_options, comparison_values.get(), nullptr,
-                prof_counters);
-      return result != 0u;
-    };
-    if (is_stable) {
-      std::stable_sort(indices.get(), indices.get() + sort_dimension_elements,
-                       compare_function);
-    } else {
-      std::sort(indices.get(), indices.get() + sort_dimension_elements,
-                compare_function);
-    }
-
-    // Reorder the values according to the order defined by 'indices'.
-    for (int32_t idx = 0; idx < values_count; ++idx) {
-      for (int64_t i = 0; i < sort_dimension_elements; ++i) {
-        int64_t memory_index =
-            (base_offset + indices[i] * sort_dimension_offset) *
-            values_primitive_type_size_in_bytes[idx];
-
-        reordered_values[i] =
-            std::string(values[idx] + memory_index,
-                        values_primitive_type_size_in_bytes[idx]);
-      }
-      for (int64_t i = 0; i < sort_dimension_elements; ++i) {
-        int64_t memory_index = (base_offset + i * sort_dimension_offset) *
-                               values_primitive_type_size_in_bytes[idx];
-        memcpy(values[idx] + memory_index, reordered_values[i].c_str(),
-               values_primitive_type_size_in_bytes[idx]);
-      }
-    }
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_RadixSort(
+    int64_t a, int64_t b, int64_t c, char* keys, int32_t key_size_in_bytes,
+    int32_t key_kind, bool descending, char* run_options) {
+  SortedRows rows{/*sort_dimension_elements=*/b, /*sort_dimension_offset=*/c,
+                  /*num_rows=*/a * c};
+  if (rows.num_rows == 0 || b == 0) return;
+  const Eigen::ThreadPoolDevice* thread_pool =
+      GetThreadPool(run_options, /*prof_counters=*/nullptr);
+  switch (key_size_in_bytes) {
+    case 1:
+      return RadixSortRows<uint8_t>(rows, keys, key_kind, descending,
+                                    thread_pool);
+    case 2:
+      return RadixSortRows<uint16_t>(rows, keys, key_kind, descending,
+                                     thread_pool);
+    case 4:
+      return RadixSortRows<uint32_t>(rows, keys, key_kind, descending,
+                                     thread_pool);
+    case 8:
+      return RadixSortRows<uint64_t>(rows, keys, key_kind, descending,
+                                     thread_pool);
   }
 }
@@ -20,6 +20,20 @@ limitations under the License.
 
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 
+namespace xla {
+namespace cpu {
+
+// How __xla_cpu_runtime_RadixSort interprets the bits of the keys.
+enum RadixSortKeyKind : int32_t {
+  kRadixSortUnsignedKey = 0,
+  kRadixSortSignedKey = 1,
+  // IEEE floating point numbers, sorted by their total order.
+  kRadixSortFloatKey = 2,
+};
+
+}  // namespace cpu
+}  // namespace xla
+
 extern "C" {
 
 // Each entry in 'values' represents a 3-dimensional shape with dimensions
@@ -41,6 +55,17 @@ extern void __xla_cpu_runtime_KeyValueSort(
     int32_t* values_primitive_type_size_in_bytes, bool is_stable,
     char* run_options, int64_t* prof_counters,
     void (*less_than)(char*, char*, char**, char**, int64_t*));
+
+// Sorts the 'b' dimension of the [a, b, c] shaped array 'keys' in place with a
+// radix sort. Used instead of __xla_cpu_runtime_KeyValueSort for sorts of a
+// single operand by a plain less-than or greater-than comparison, which don't
+// need to call a comparator. 'key_size_in_bytes' is 1, 2, 4 or 8, 'key_kind'
+// is a xla::cpu::RadixSortKeyKind and 'descending' reverses the order.
+// Rows are sorted in parallel if 'run_options' has an intra-op thread pool.
+extern void __xla_cpu_runtime_RadixSort(int64_t a, int64_t b, int64_t c,
+                                        char* keys, int32_t key_size_in_bytes,
+                                        int32_t key_kind, bool descending,
+                                        char* run_options);
 }
 
 #endif  // XLA_SERVICE_CPU_RUNTIME_KEY_VALUE_SORT_H_
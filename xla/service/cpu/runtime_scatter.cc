@@ -0,0 +1,119 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/cpu/runtime_scatter.h"
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <cstdint>
+
+#include "absl/base/dynamic_annotations.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/executable_run_options.h"
+
+namespace {
+
+// Partitioning unsorted updates by rows requires each partition to read all
+// the indices, which only pays off if rows are large enough.
+constexpr int64_t kMinRowSizeToPartitionRows = 8;
+
+void AddRow(int64_t row_size, const float* update, float* row) {
+  for (int64_t i = 0; i < row_size; ++i) {
+    row[i] += update[i];
+  }
+}
+
+// Applies the updates in [first_update, last_update) whose index is in
+// [first_row, last_row).
+void ScatterAdd(int64_t first_row, int64_t last_row, int64_t row_size,
+                int64_t first_update, int64_t last_update,
+                const int32_t* indices, const float* updates, float* output) {
+  for (int64_t i = first_update; i < last_update; ++i) {
+    const int64_t index = indices[i];
+    if (index >= first_row && index < last_row) {
+      AddRow(row_size, updates + i * row_size, output + index * row_size);
+    }
+  }
+}
+
+}  // namespace
+
+ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_ScatterAddF32(
+    int64_t num_rows, int64_t row_size, int64_t num_updates,
+    const int32_t* indices, const float* updates, float* output,
+    bool indices_are_sorted, bool unique_indices, const void* run_options_ptr) {
+  // The buffers are managed by the JIT code, so msan can't tell they are
+  // initialized.
+  ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(indices, num_updates * sizeof(int32_t));
+  ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(updates,
+                                      num_updates * row_size * sizeof(float));
+  ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(output,
+                                      num_rows * row_size * sizeof(float));
+
+  const Eigen::ThreadPoolDevice* thread_pool =
+      run_options_ptr == nullptr
+          ? nullptr
+          : static_cast<const xla::ExecutableRunOptions*>(run_options_ptr)
+                ->intra_op_thread_pool();
+  if (thread_pool == nullptr || thread_pool->numThreads() <= 1 ||
+      num_rows <= 1) {
+    ScatterAdd(0, num_rows, row_size, 0, num_updates, indices, updates,
+               output);
+    return;
+  }
+
+  const Eigen::TensorOpCost update_cost(2 * row_size * sizeof(float),
+                                        row_size * sizeof(float), row_size);
+  if (indices_are_sorted) {
+    // The updates of a range of rows are contiguous.
+    const double updates_per_row = static_cast<double>(num_updates) / num_rows;
+    thread_pool->parallelFor(
+        num_rows, update_cost * updates_per_row,
+        [&](Eigen::Index first_row, Eigen::Index last_row) {
+          const int32_t* first =
+              std::lower_bound(indices, indices + num_updates, first_row);
+          const int32_t* last =
+              std::lower_bound(first, indices + num_updates, last_row);
+          ScatterAdd(first_row, last_row, row_size, first - indices,
+                     last - indices, indices, updates, output);
+        });
+  } else if (unique_indices) {
+    // Updates don't conflict.
+    thread_pool->parallelFor(
+        num_updates, update_cost,
+        [&](Eigen::Index first_update, Eigen::Index last_update) {
+          ScatterAdd(0, num_rows, row_size, first_update, last_update,
+                     indices, updates, output);
+        });
+  } else if (row_size >= kMinRowSizeToPartitionRows) {
+    // Each partition of rows reads all the indices and applies its updates.
+    const int64_t num_partitions =
+        std::min<int64_t>(thread_pool->numThreads(), num_rows);
+    const Eigen::TensorOpCost partition_cost =
+        Eigen::TensorOpCost(num_updates * sizeof(int32_t), 0, num_updates) +
+        update_cost * (static_cast<double>(num_updates) / num_partitions);
+    thread_pool->parallelFor(
+        num_partitions, partition_cost,
+        [&](Eigen::Index first_partition, Eigen::Index last_partition) {
+          ScatterAdd(first_partition * num_rows / num_partitions,
+                     last_partition * num_rows / num_partitions, row_size, 0,
+                     num_updates, indices, updates, output);
+        });
+  } else {
+    ScatterAdd(0, num_rows, row_size, 0, num_updates, indices, updates,
+               output);
+  }
+}
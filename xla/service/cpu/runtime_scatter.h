@@ -0,0 +1,38 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_CPU_RUNTIME_SCATTER_H_
+#define XLA_SERVICE_CPU_RUNTIME_SCATTER_H_
+
+#include <stdint.h>
+
+extern "C" {
+
+// Adds each of the `num_updates` rows of `row_size` elements in `updates` to
+// the row of `output`, which has `num_rows` rows, given by `indices`.
+// Updates with out of bounds indices are skipped. Rows are updated in
+// parallel on the intra-op thread pool of `run_options_ptr`, a
+// xla::ExecutableRunOptions, if it has one, and the updates of each row are
+// applied in order, so the result does not depend on the number of threads.
+//
+// If `indices_are_sorted`, the indices must be sorted in ascending order. If
+// `unique_indices`, no two updates have the same index.
+extern void __xla_cpu_runtime_ScatterAddF32(
+    int64_t num_rows, int64_t row_size, int64_t num_updates,
+    const int32_t* indices, const float* updates, float* output,
+    bool indices_are_sorted, bool unique_indices, const void* run_options_ptr);
+}
+
+#endif  // XLA_SERVICE_CPU_RUNTIME_SCATTER_H_
@@ -15,61 +15,127 @@ limitations under the License.
 
 #include "xla/service/cpu/runtime_topk.h"
 
+#define EIGEN_USE_THREADS
+
 #include <algorithm>
 #include <cstring>
 #include <limits>
-#include <memory>
 #include <numeric>
 #include <vector>
 
 #include "absl/base/dynamic_annotations.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "xla/executable_run_options.h"
+
+namespace {
+
+// Up to this k the top elements are selected with a bounded heap, which only
+// touches the heap for the few inputs that beat its current minimum. For
+// larger k, std::nth_element followed by a sort of the selected elements is
+// faster.
+constexpr int64_t kMaxHeapSelectK = 64;
+
+// Maps `value` to an integer for which the comparison enforces the total
+// order -NaN < -Inf < -0 < +0 < +Inf < +NaN.
+inline int32_t ToTotalOrderKey(float value) {
+  uint32_t x;
+  std::memcpy(&x, &value, sizeof(x));
+  return static_cast<int32_t>(x) < 0 ? std::numeric_limits<int32_t>::max() - x
+                                     : x;
+}
+
+// Selects the top `k` of the `input_size` elements `keys` into
+// `out_indices`, in order. Ties are broken by the smaller index.
+void SelectTopK(int64_t input_size, int64_t k, const int32_t* keys,
+                std::vector<int32_t>& temp_indices, int32_t* out_indices) {
+  auto greater = [keys](int32_t i1, int32_t i2) {
+    if (keys[i1] == keys[i2]) {
+      return i1 < i2;  // Stabilize sorting.
+    }
+    return keys[i1] > keys[i2];
+  };
+
+  if (k <= kMaxHeapSelectK && k < input_size) {
+    // `heap` is a min-heap under `greater`: its front is the worst of the
+    // current top k. Later indices lose ties, so an element only enters the
+    // heap if its key is strictly larger than the key of the front.
+    temp_indices.resize(k);
+    std::iota(temp_indices.begin(), temp_indices.end(), 0);
+    std::make_heap(temp_indices.begin(), temp_indices.end(), greater);
+    for (int64_t i = k; i < input_size; ++i) {
+      if (keys[i] > keys[temp_indices.front()]) {
+        std::pop_heap(temp_indices.begin(), temp_indices.end(), greater);
+        temp_indices.back() = i;
+        std::push_heap(temp_indices.begin(), temp_indices.end(), greater);
+      }
+    }
+    std::sort_heap(temp_indices.begin(), temp_indices.end(), greater);
+  } else {
+    temp_indices.resize(input_size);
+    std::iota(temp_indices.begin(), temp_indices.end(), 0);
+    auto kth_element = temp_indices.begin() + k;
+    if (k < input_size) {
+      std::nth_element(temp_indices.begin(), kth_element, temp_indices.end(),
+                       greater);
+    }
+    std::sort(temp_indices.begin(), kth_element, greater);
+  }
+  std::copy(temp_indices.begin(), temp_indices.begin() + k, out_indices);
+}
 
 template <typename T>
-static void TopK(int64_t batch_size, int64_t input_size, int64_t k,
-                 const T* values, T* out_values, int32_t* out_indices) {
+void TopK(int64_t batch_size, int64_t input_size, int64_t k, const T* values,
+          T* out_values, int32_t* out_indices,
+          const Eigen::ThreadPoolDevice* thread_pool) {
   // 'values' is managed by the JIT code, so msan can't tell they are
   // initialized.
   ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(values,
                                       input_size * batch_size * sizeof(T));
 
-  std::vector<int32_t> temp_indices(input_size);
-  for (int64_t batch = 0; batch != batch_size; ++batch) {
-    std::iota(temp_indices.begin(), temp_indices.end(), 0);
-
-    const T* values_batch = values + batch * input_size;
-
-    auto convert_to_int = [](T value) {
-      uint32_t x;
-      std::memcpy(&x, &value, sizeof(x));
-      return static_cast<int32_t>(x) < 0
-                 ? std::numeric_limits<int32_t>::max() - x
-                 : x;
-    };
+  auto top_k_batches = [&](int64_t first_batch, int64_t last_batch) {
+    std::vector<int32_t> keys(input_size);
+    std::vector<int32_t> temp_indices;
+    for (int64_t batch = first_batch; batch != last_batch; ++batch) {
+      const T* values_batch = values + batch * input_size;
+      // A branch-free loop over the whole row, which vectorizes.
+      for (int64_t i = 0; i < input_size; ++i) {
+        keys[i] = ToTotalOrderKey(values_batch[i]);
+      }
 
-    auto kth_element = temp_indices.begin() + k;
-    std::partial_sort(temp_indices.begin(), kth_element, temp_indices.end(),
-                      [&](size_t i1, size_t i2) {
-                        // Do the comparison in integers to enforce a total
-                        // order of -NaN < -Inf < -0 < +0 < +Inf < +NaN.
-                        int32_t v1 = convert_to_int(values_batch[i1]);
-                        int32_t v2 = convert_to_int(values_batch[i2]);
-                        if (v1 == v2) {
-                          return i1 < i2;  // Stabilize sorting.
-                        }
-                        return v1 > v2;
-                      });
-
-    T* out_values_batch = out_values + batch * k;
-    int32_t* out_indices_batch = out_indices + batch * k;
-    std::copy(temp_indices.begin(), kth_element, out_indices_batch);
-    for (int64_t i = 0; i < k; i++) {
-      out_values_batch[i] = values_batch[temp_indices[i]];
+      T* out_values_batch = out_values + batch * k;
+      int32_t* out_indices_batch = out_indices + batch * k;
+      SelectTopK(input_size, k, keys.data(), temp_indices, out_indices_batch);
+      for (int64_t i = 0; i < k; i++) {
+        out_values_batch[i] = values_batch[out_indices_batch[i]];
+      }
     }
+  };
+
+  if (thread_pool == nullptr || batch_size == 1) {
+    top_k_batches(0, batch_size);
+    return;
   }
+  // Converting the keys dominates for the heap selection, a few cycles per
+  // input element.
+  thread_pool->parallelFor(
+      batch_size,
+      Eigen::TensorOpCost(input_size * sizeof(T), k * (sizeof(T) + 4),
+                          4.0 * input_size),
+      [&](Eigen::Index first, Eigen::Index last) {
+        top_k_batches(first, last);
+      });
 }
 
+}  // namespace
+
 ABSL_ATTRIBUTE_NO_SANITIZE_MEMORY void __xla_cpu_runtime_TopKF32(
     int64_t batch_size, int64_t input_size, int64_t k, const float* values,
-    float* out_values, int32_t* out_indices) {
-  TopK(batch_size, input_size, k, values, out_values, out_indices);
+    float* out_values, int32_t* out_indices, const void* run_options_ptr) {
+  const Eigen::ThreadPoolDevice* thread_pool =
+      run_options_ptr == nullptr
+          ? nullptr
+          : static_cast<const xla::ExecutableRunOptions*>(run_options_ptr)
+                ->intra_op_thread_pool();
+  TopK(batch_size, input_size, k, values, out_values, out_indices,
+       thread_pool);
 }
@@ -21,10 +21,13 @@ limitations under the License.
 extern "C" {
 
 // Calculates `batch_size` topk operations with `input_size` inputs each. The
-// outputs are written to `out_values` and `out_indices`.
+// outputs are written to `out_values` and `out_indices`. Batches are processed
+// in parallel on the intra-op thread pool of `run_options_ptr`, a
+// xla::ExecutableRunOptions, if it has one.
 extern void __xla_cpu_runtime_TopKF32(int64_t batch_size, int64_t input_size,
                                       int64_t k, const float* values,
-                                      float* out_values, int32_t* out_indices);
+                                      float* out_values, int32_t* out_indices,
+                                      const void* run_options_ptr);
 }
 
 #endif  // XLA_SERVICE_CPU_RUNTIME_TOPK_H_
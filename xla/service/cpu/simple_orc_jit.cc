@@ -22,9 +22,12 @@ limitations under the License.
 #include <cstdio>
 #include <list>
 #include <memory>
+#include <string>
 #include <system_error>  // NOLINT
 #include <utility>
+#include <vector>
 
+#include "absl/strings/string_view.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/JITSymbol.h"
 #include "llvm/ExecutionEngine/Orc/ExecutorProcessControl.h"
@@ -36,6 +39,7 @@ limitations under the License.
 #include "llvm/Support/CodeGen.h"
 #include "llvm/Support/Memory.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Host.h"
 #include "mlir/ExecutionEngine/CRunnerUtils.h"  // from @llvm-project
 #include "xla/service/cpu/cpu_runtime.h"
@@ -56,15 +60,19 @@ limitations under the License.
 #include "xla/service/cpu/runtime_single_threaded_conv3d.h"
 #include "xla/service/cpu/runtime_single_threaded_fft.h"
 #include "xla/service/cpu/runtime_single_threaded_matmul.h"
+#include "xla/service/cpu/runtime_scatter.h"
 #include "xla/service/cpu/runtime_topk.h"
 #include "xla/service/cpu/windows_compatibility.h"
+#include "tsl/platform/blocking_counter.h"
 #include "xla/service/custom_call_target_registry.h"
 #include "xla/types.h"
 #include "xla/util.h"
 #include "tsl/platform/logging.h"
 
 #if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+#include "xla/service/cpu/onednn_convolution.h"
 #include "xla/service/cpu/onednn_matmul.h"
+#include "xla/service/cpu/onednn_softmax.h"
 #endif
 
 // Provided by compiler-rt and MLIR.
@@ -283,6 +291,30 @@ bool ContiguousSectionMemoryManager::finalizeMemory(std::string* err_msg) {
   return false;
 }
 
+// Returns the object cache backed by `cache_dir`, or nullptr if `cache_dir` is
+// empty. The cache key covers all the options that influence code generation.
+std::unique_ptr<JitObjectCache> CreateObjectCache(
+    absl::string_view cache_dir, const llvm::TargetMachine& target_machine,
+    llvm::CodeGenOptLevel opt_level, bool optimize_for_size,
+    bool disable_expensive_passes, bool disable_slp_vectorizer,
+    llvm::FastMathFlags fast_math_flags) {
+  if (cache_dir.empty()) {
+    return nullptr;
+  }
+  std::string compile_options;
+  llvm::raw_string_ostream os(compile_options);
+  os << target_machine.getTargetTriple().str() << ";"
+     << target_machine.getTargetCPU() << ";"
+     << target_machine.getTargetFeatureString() << ";"
+     << static_cast<int>(opt_level) << ";" << optimize_for_size << ";"
+     << disable_expensive_passes << ";" << disable_slp_vectorizer << ";";
+  fast_math_flags.print(os);
+  os.flush();
+  VLOG(1) << "Caching JIT object files in " << cache_dir;
+  return std::make_unique<JitObjectCache>(std::string(cache_dir),
+                                          std::move(compile_options));
+}
+
 }  // namespace
 
 /*static*/ std::unique_ptr<llvm::TargetMachine>
@@ -309,12 +341,16 @@ SimpleOrcJIT::SimpleOrcJIT(
     bool disable_slp_vectorizer, llvm::FastMathFlags fast_math_flags,
     LLVMCompiler::ModuleHook pre_optimization_hook,
     LLVMCompiler::ModuleHook post_optimization_hook,
-    std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook)
+    std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+    absl::string_view object_cache_dir)
     : target_machine_(InferTargetMachineForJIT(target_options, opt_level)),
       target_triple_(target_machine_->getTargetTriple()),
       data_layout_(target_machine_->createDataLayout()),
       target_process_control_(std::move(target_process_control)),
       execution_session_(std::move(execution_session)),
+      object_cache_(CreateObjectCache(
+          object_cache_dir, *target_machine_, opt_level, optimize_for_size,
+          disable_expensive_passes, disable_slp_vectorizer, fast_math_flags)),
       object_layer_(*execution_session_,
                     []() {
                       return std::make_unique<ContiguousSectionMemoryManager>(
@@ -325,14 +361,24 @@ SimpleOrcJIT::SimpleOrcJIT(
           std::make_unique<CompilerFunctor>(
               target_machine_.get(), static_cast<int>(opt_level),
               optimize_for_size, disable_expensive_passes,
-              disable_slp_vectorizer, fast_math_flags,
-              std::move(pre_optimization_hook),
-              std::move(post_optimization_hook), std::move(post_codegen_hook))),
+              disable_slp_vectorizer, fast_math_flags, pre_optimization_hook,
+              post_optimization_hook, post_codegen_hook,
+              /*dfsan_enabled=*/false, /*dfsan_abi_list_files=*/{},
+              /*convert_to_xla_runtime_abi=*/{}, object_cache_.get())),
       main_jit_dylib_(&execution_session_->createBareJITDylib("<main>")),
       gdb_jit_event_listener_(
           llvm::JITEventListener::createGDBRegistrationListener()),
       perf_jit_event_listener_(
-          llvm::JITEventListener::createPerfJITEventListener()) {
+          llvm::JITEventListener::createPerfJITEventListener()),
+      target_options_(target_options),
+      opt_level_(opt_level),
+      optimize_for_size_(optimize_for_size),
+      disable_expensive_passes_(disable_expensive_passes),
+      disable_slp_vectorizer_(disable_slp_vectorizer),
+      fast_math_flags_(fast_math_flags),
+      pre_optimization_hook_(std::move(pre_optimization_hook)),
+      post_optimization_hook_(std::move(post_optimization_hook)),
+      post_codegen_hook_(std::move(post_codegen_hook)) {
   VLOG(1) << "CPU target: " << target_machine_->getTargetCPU().str()
           << " features: " << target_machine_->getTargetFeatureString().str();
 
@@ -386,7 +432,8 @@ llvm::Expected<std::unique_ptr<SimpleOrcJIT>> SimpleOrcJIT::Create(
     bool disable_slp_vectorizer, llvm::FastMathFlags fast_math_flags,
     LLVMCompiler::ModuleHook pre_optimization_hook,
     LLVMCompiler::ModuleHook post_optimization_hook,
-    std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook) {
+    std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+    absl::string_view object_cache_dir) {
   auto SSP = std::make_shared<llvm::orc::SymbolStringPool>();
   auto target_process_control =
       llvm::orc::SelfExecutorProcessControl::Create(std::move(SSP));
@@ -400,7 +447,8 @@ llvm::Expected<std::unique_ptr<SimpleOrcJIT>> SimpleOrcJIT::Create(
       std::move(*target_process_control), std::move(execution_session),
       target_options, opt_level, optimize_for_size, disable_expensive_passes,
       disable_slp_vectorizer, fast_math_flags, std::move(pre_optimization_hook),
-      std::move(post_optimization_hook), std::move(post_codegen_hook));
+      std::move(post_optimization_hook), std::move(post_codegen_hook),
+      object_cache_dir);
 }
 
 llvm::orc::ExecutorSymbolDef SimpleOrcJIT::ResolveRuntimeSymbol(
@@ -445,6 +493,51 @@ llvm::Error SimpleOrcJIT::AddModule(llvm::orc::ThreadSafeModule module) {
   return compile_layer_.add(*main_jit_dylib_, std::move(module));
 }
 
+llvm::Error SimpleOrcJIT::AddModulesInParallel(
+    std::vector<llvm::orc::ThreadSafeModule> modules,
+    tsl::thread::ThreadPool* thread_pool) {
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> object_files(
+      modules.size());
+  std::vector<std::string> errors(modules.size());
+
+  tsl::BlockingCounter counter(modules.size());
+  for (int i = 0; i < modules.size(); ++i) {
+    thread_pool->Schedule([&, i] {
+      std::unique_ptr<llvm::TargetMachine> target_machine =
+          InferTargetMachineForJIT(target_options_, opt_level_);
+      CompilerFunctor compiler(
+          target_machine.get(), static_cast<int>(opt_level_),
+          optimize_for_size_, disable_expensive_passes_,
+          disable_slp_vectorizer_, fast_math_flags_, pre_optimization_hook_,
+          post_optimization_hook_, post_codegen_hook_,
+          /*dfsan_enabled=*/false, /*dfsan_abi_list_files=*/{},
+          /*convert_to_xla_runtime_abi=*/{}, object_cache_.get());
+      llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> object_file =
+          modules[i].withModuleDo(
+              [&](llvm::Module& module) { return compiler(module); });
+      if (object_file) {
+        object_files[i] = std::move(*object_file);
+      } else {
+        errors[i] = llvm::toString(object_file.takeError());
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+
+  for (int i = 0; i < modules.size(); ++i) {
+    if (!errors[i].empty()) {
+      return llvm::make_error<llvm::StringError>(
+          errors[i], llvm::inconvertibleErrorCode());
+    }
+    if (auto err =
+            object_layer_.add(*main_jit_dylib_, std::move(object_files[i]))) {
+      return err;
+    }
+  }
+  return llvm::Error::success();
+}
+
 void SimpleOrcJIT::DoneCompiling() {
   // The target machine takes a non-trivial amount of memory, so once we are
   // done compiling throw it away.
@@ -520,11 +613,15 @@ bool RegisterKnownJITSymbols() {
   REGISTER_CPU_RUNTIME_SYMBOL(ReleaseOutfeedBufferAfterPopulation);
   REGISTER_CPU_RUNTIME_SYMBOL(StatusIsSuccess);
   REGISTER_CPU_RUNTIME_SYMBOL(KeyValueSort);
+  REGISTER_CPU_RUNTIME_SYMBOL(RadixSort);
   REGISTER_CPU_RUNTIME_SYMBOL(TopKF32);
+  REGISTER_CPU_RUNTIME_SYMBOL(ScatterAddF32);
   REGISTER_CPU_RUNTIME_SYMBOL(TracingStart);
   REGISTER_CPU_RUNTIME_SYMBOL(TracingEnd);
 #if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
   REGISTER_CPU_RUNTIME_SYMBOL(OneDnnMatMul);
+  REGISTER_CPU_RUNTIME_SYMBOL(OneDnnConvolution);
+  REGISTER_CPU_RUNTIME_SYMBOL(OneDnnSoftmax);
 #endif  // INTEL_MKL && ENABLE_ONEDNN_V3
 
   registry->Register("__gnu_f2h_ieee", reinterpret_cast<void*>(__gnu_f2h_ieee),
@@ -20,17 +20,21 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/Orc/Core.h"
 #include "llvm/ExecutionEngine/Orc/ExecutorProcessControl.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/Orc/SymbolStringPool.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/TargetParser/Triple.h"
 #include "xla/service/cpu/compiler_functor.h"
+#include "xla/service/cpu/jit_object_cache.h"
 #include "xla/types.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace cpu {
@@ -52,7 +56,10 @@ class SimpleOrcJIT : public llvm::JITEventListener {
   //
   // {pre,post}_optimization_hook is invoked on the module before/after all
   // LLVM IR-level optimizations.  post_codegen_hook is invoked after
-  // compiling to machine code.
+  // compiling to machine code. If `object_cache_dir` is not empty, compiled
+  // object files are cached in that directory (see JitObjectCache); modules
+  // found in the cache skip optimization, so only post_codegen_hook is invoked
+  // for them.
   SimpleOrcJIT(
       std::unique_ptr<llvm::orc::ExecutorProcessControl> target_process_control,
       std::unique_ptr<llvm::orc::ExecutionSession> execution_session,
@@ -62,7 +69,8 @@ class SimpleOrcJIT : public llvm::JITEventListener {
       llvm::FastMathFlags fast_math_flags,
       LLVMCompiler::ModuleHook pre_optimization_hook,
       LLVMCompiler::ModuleHook post_optimization_hook,
-      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook);
+      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+      absl::string_view object_cache_dir = "");
 
   static llvm::Expected<std::unique_ptr<SimpleOrcJIT>> Create(
       const llvm::TargetOptions& target_options,
@@ -71,7 +79,8 @@ class SimpleOrcJIT : public llvm::JITEventListener {
       llvm::FastMathFlags fast_math_flags,
       LLVMCompiler::ModuleHook pre_optimization_hook,
       LLVMCompiler::ModuleHook post_optimization_hook,
-      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook);
+      std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook,
+      absl::string_view object_cache_dir = "");
 
   ~SimpleOrcJIT() override;
 
@@ -81,6 +90,13 @@ class SimpleOrcJIT : public llvm::JITEventListener {
 
   llvm::Error AddModule(llvm::orc::ThreadSafeModule module);
 
+  // Compiles `modules` to object files concurrently on `thread_pool` and adds
+  // them to the JIT, which links them together when symbols are looked up.
+  // Each module must be owned by a distinct LLVM context.
+  llvm::Error AddModulesInParallel(
+      std::vector<llvm::orc::ThreadSafeModule> modules,
+      tsl::thread::ThreadPool* thread_pool);
+
   // Discards objects we no longer need once we are done compiling.
   void DoneCompiling();
 
@@ -115,6 +131,8 @@ class SimpleOrcJIT : public llvm::JITEventListener {
   const llvm::DataLayout data_layout_;
   std::unique_ptr<llvm::orc::ExecutorProcessControl> target_process_control_;
   std::unique_ptr<llvm::orc::ExecutionSession> execution_session_;
+  // Null if object files are not cached.
+  std::unique_ptr<JitObjectCache> object_cache_;
   ObjLayerT object_layer_;
   CompileLayerT compile_layer_;
   llvm::orc::JITDylib* main_jit_dylib_;
@@ -130,6 +148,18 @@ class SimpleOrcJIT : public llvm::JITEventListener {
   llvm::JITEventListener* gdb_jit_event_listener_;
 
   llvm::JITEventListener* perf_jit_event_listener_;
+
+  // Compilation options, kept to create one compiler per thread in
+  // AddModulesInParallel, as the target machine is not thread-safe.
+  const llvm::TargetOptions target_options_;
+  const llvm::CodeGenOptLevel opt_level_;
+  const bool optimize_for_size_;
+  const bool disable_expensive_passes_;
+  const bool disable_slp_vectorizer_;
+  const llvm::FastMathFlags fast_math_flags_;
+  LLVMCompiler::ModuleHook pre_optimization_hook_;
+  LLVMCompiler::ModuleHook post_optimization_hook_;
+  std::function<void(const llvm::object::ObjectFile&)> post_codegen_hook_;
 };
 
 }  // namespace cpu
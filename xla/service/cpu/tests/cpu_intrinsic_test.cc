@@ -155,7 +155,19 @@ IntrinsicTestSpec CpuUnaryIntrinsicTestCases[] = {
 
     IntrinsicTestSpec{
         HloOpcode::kLog, kTriple_android_arm, "",
-        R"(CHECK: fadd fast <4 x float> <float 0x3FBDE4A340000000, float 0x3FBDE4A340000000, float 0x3FBDE4A340000000, float 0x3FBDE4A340000000>)"}};
+        R"(CHECK: fadd fast <4 x float> <float 0x3FBDE4A340000000, float 0x3FBDE4A340000000, float 0x3FBDE4A340000000, float 0x3FBDE4A340000000>)"},
+
+    IntrinsicTestSpec{
+        HloOpcode::kSin, kTriple_x86_64, "",
+        R"(CHECK: fcmp fast {{[ou]}}gt <4 x float> %{{.*}}, <float 8.192000e+03, float 8.192000e+03, float 8.192000e+03, float 8.192000e+03>)"},
+
+    IntrinsicTestSpec{
+        HloOpcode::kSin, kTriple_x86_64, "+avx",
+        R"(CHECK: fcmp fast {{[ou]}}gt <8 x float> %{{.*}}, <float 8.192000e+03, float 8.192000e+03, float 8.192000e+03, float 8.192000e+03, float 8.192000e+03, float 8.192000e+03, float 8.192000e+03, float 8.192000e+03>)"},
+
+    IntrinsicTestSpec{
+        HloOpcode::kCos, kTriple_x86_64, "",
+        R"(CHECK: fcmp fast {{[ou]}}gt <4 x float> %{{.*}}, <float 8.192000e+03, float 8.192000e+03, float 8.192000e+03, float 8.192000e+03>)"}};
 
 INSTANTIATE_TEST_SUITE_P(CpuUnaryIntrinsicTestInstantiation,
                          CpuUnaryIntrinsicTest,
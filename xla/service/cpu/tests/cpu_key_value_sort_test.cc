@@ -58,6 +58,40 @@ CHECK: call void @__xla_cpu_runtime_KeyValueSort
                                 /*match_optimized_ir=*/true);
 }
 
+TEST_F(CpuKeyValueSortTest, RadixSortR1) {
+  const std::string hlo_text = R"(
+HloModule RadixSort
+
+compare {
+  p.0.lhs = f32[] parameter(0)
+  p.0.rhs = f32[] parameter(1)
+  ROOT gt = pred[] compare(p.0.lhs, p.0.rhs), direction=GT, type=TOTALORDER
+}
+
+ENTRY main {
+  a = f32[10] parameter(0)
+
+  ROOT result = f32[10] sort(f32[10] a), dimensions={0}, to_apply=compare
+}
+)";
+
+  std::string filecheck_pattern = R"(
+CHECK-NOT: call void @__xla_cpu_runtime_KeyValueSort
+CHECK: call void @__xla_cpu_runtime_RadixSort
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo_text));
+
+  CpuAotCompilationOptions options{
+      /*triple=*/kTargetTripleForHost, /*cpu_name=*/kTargetCpuForHost,
+      /*features=*/"",
+      /*entry_point_name=*/"entry",
+      /*relocation_model=*/CpuAotCompilationOptions::RelocationModel::Static};
+
+  CompileAheadOfTimeAndVerifyIr(std::move(module), options, filecheck_pattern,
+                                /*match_optimized_ir=*/true);
+}
+
 }  // namespace
 }  // namespace cpu
 }  // namespace xla
@@ -0,0 +1,108 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "xla/service/cpu/cpu_compiler.h"
+#include "xla/service/cpu/tests/cpu_codegen_test.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace cpu {
+namespace {
+
+class CpuParallelCodegenTest : public CpuCodegenTest {
+ protected:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = CpuCodegenTest::GetDebugOptionsForTest();
+    debug_options.set_xla_cpu_parallel_codegen_split_count(4);
+    return debug_options;
+  }
+};
+
+constexpr absl::string_view kWhileWithFusions = R"(
+HloModule module
+
+f1 {
+  f1.p0 = s32[] parameter(0)
+  ROOT f1.sum = s32[] add(f1.p0, f1.p0)
+}
+
+f2 {
+  f2.p0 = s32[] parameter(0)
+  f2.p1 = s32[] parameter(1)
+  ROOT f2.sum = s32[] add(f2.p0, f2.p1)
+}
+
+body {
+  body.p0 = s32[] parameter(0)
+  sum2 = s32[] fusion(body.p0), kind=kLoop, calls=f1
+  ROOT sum3 = s32[] fusion(sum2, body.p0), kind=kLoop, calls=f2
+}
+
+cond {
+  cond.p0 = s32[] parameter(0)
+  cond.c10 = s32[] constant(10)
+  ROOT cond.root = pred[] compare(cond.p0, cond.c10), direction=LT
+}
+
+ENTRY entry {
+  entry.c1 = s32[] constant(1)
+  ROOT entry.root = s32[] while(entry.c1), condition=cond, body=body
+}
+)";
+
+// The nested computations are emitted as internal functions that end up in
+// different partitions than the entry computation, so this checks that calls
+// across partitions are linked correctly.
+TEST_F(CpuParallelCodegenTest, WhileWithFusions) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kWhileWithFusions));
+
+  auto result = ExecuteAndTransfer(module->Clone(), {});
+
+  // 1 -> 3 -> 9 -> 27.
+  LiteralTestUtil::ExpectR0Equal(27, result);
+}
+
+TEST_F(CpuParallelCodegenTest, DumpsEachObjectFile) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kWhileWithFusions));
+  std::string output_directory =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "parallel_codegen_dump");
+  DebugOptions debug_options = module->config().debug_options();
+  debug_options.set_xla_dump_to(output_directory);
+  module->mutable_config().set_debug_options(debug_options);
+
+  auto result = ExecuteAndTransfer(std::move(module), {});
+  LiteralTestUtil::ExpectR0Equal(27, result);
+
+  // Each partition is dumped to its own object file.
+  std::vector<std::string> paths;
+  TF_ASSERT_OK(tsl::Env::Default()->GetMatchingPaths(
+      tsl::io::JoinPath(output_directory, "*.o"), &paths));
+  EXPECT_GT(paths.size(), 1);
+}
+
+}  // namespace
+}  // namespace cpu
+}  // namespace xla
@@ -660,25 +660,33 @@ class TiledSmallGemmEmitter {
   // The innermost reduction loop executes the matrix multiply in tiles of size
   // [`tile_size_m`, `tile_size_k`] from the LHS and [`tile_size_k`,
   // <vectorization width>] in the RHS.
+  //
+  // If `pack_lhs` is true, each [`tile_size_m`, K] panel of the LHS is copied
+  // into a contiguous buffer, interleaving its rows, before it is multiplied
+  // with the RHS.  The reduction loop then reads the LHS as one sequential
+  // stream instead of `tile_size_m` strided ones, which pays off when the
+  // panel is reused for several tiles along N.
   class Config {
    public:
     explicit Config(PrimitiveType scalar_type, Dimensions dims,
                     int64_t max_vectorization_width, int64_t max_vector_count,
                     int64_t min_vectorization_width, int64_t tile_size_m,
-                    int64_t tile_size_k)
+                    int64_t tile_size_k, bool pack_lhs)
         : scalar_type_(scalar_type),
           dims_(dims),
           max_vectorization_width_(max_vectorization_width),
           max_vector_count_(max_vector_count),
           min_vectorization_width_(min_vectorization_width),
           tile_size_m_(tile_size_m),
-          tile_size_k_(tile_size_k) {}
+          tile_size_k_(tile_size_k),
+          pack_lhs_(pack_lhs) {}
 
     std::string GetCacheKey() const {
       return absl::StrCat("gemm_", PrimitiveType_Name(scalar_type()), "_",
                           dims().ToString(), "_", max_vectorization_width(),
-                          "_", min_vectorization_width(), "_", tile_size_m(),
-                          "_", tile_size_k());
+                          "_", max_vector_count(), "_",
+                          min_vectorization_width(), "_", tile_size_m(), "_",
+                          tile_size_k(), pack_lhs() ? "_packed" : "");
     }
 
     PrimitiveType scalar_type() const { return scalar_type_; }
@@ -689,6 +697,7 @@ class TiledSmallGemmEmitter {
 
     int64_t tile_size_m() const { return tile_size_m_; }
     int64_t tile_size_k() const { return tile_size_k_; }
+    bool pack_lhs() const { return pack_lhs_; }
 
    private:
     PrimitiveType scalar_type_;
@@ -698,6 +707,7 @@ class TiledSmallGemmEmitter {
     int64_t min_vectorization_width_;
     int64_t tile_size_m_;
     int64_t tile_size_k_;
+    bool pack_lhs_;
   };
 
   // Creates an instance of TiledSmallGemmEmitter that matrix-multiplies
@@ -730,6 +740,12 @@ class TiledSmallGemmEmitter {
   // helpers ultimately call into `EmitTiledGemm` for emitting the
   // tiled GEMM kernel.
 
+  // Copies the LHS panel [`m_start`, `m_start` + `tile_size_m`) x [`k_start`,
+  // `k_end`) into `packed_lhs_`, laid out as [k - k_start, m - m_start].
+  void PackLhsPanel(VectorSupportLibrary* vsl, int64_t tile_size_m,
+                    llvm::Value* m_start, llvm::Value* k_start,
+                    llvm::Value* k_end);
+
   void HandleResiduesOnN();
   void HandleResiduesOnK(VectorSupportLibrary* vsl, llvm::Value* n_start,
                          llvm::Value* n_end);
@@ -759,6 +775,7 @@ class TiledSmallGemmEmitter {
   }
   int64_t tile_size_m() const { return config().tile_size_m(); }
   int64_t tile_size_k() const { return config().tile_size_k(); }
+  bool pack_lhs() const { return config().pack_lhs(); }
   PrimitiveType scalar_type() const { return config().scalar_type(); }
 
   llvm::Value* lhs_;
@@ -766,11 +783,41 @@ class TiledSmallGemmEmitter {
   llvm::Value* result_;
   Config config_;
 
+  // Scratch buffer holding one packed LHS panel, if `pack_lhs()`.
+  llvm::Value* packed_lhs_ = nullptr;
+
   llvm::IRBuilder<>* b_;
   KernelSupportLibrary ksl_;
 };
 
-void TiledSmallGemmEmitter::Emit() { HandleResiduesOnN(); }
+void TiledSmallGemmEmitter::Emit() {
+  if (pack_lhs()) {
+    packed_lhs_ = llvm_ir::EmitAllocaAtFunctionEntryWithCount(
+        llvm_ir::PrimitiveTypeToIrType(scalar_type(),
+                                       b_->GetInsertBlock()->getModule()),
+        GetInt64(tile_size_m() * dims().k()), "packed_lhs", b_);
+  }
+  HandleResiduesOnN();
+}
+
+void TiledSmallGemmEmitter::PackLhsPanel(VectorSupportLibrary* vsl,
+                                         int64_t tile_size_m,
+                                         llvm::Value* m_start,
+                                         llvm::Value* k_start,
+                                         llvm::Value* k_end) {
+  ksl_.For("pack.k", k_start, k_end, 1, [&](llvm::Value* k_i) {
+    llvm::Value* packed_offset =
+        b_->CreateMul(b_->CreateSub(k_i, k_start), GetInt64(tile_size_m));
+    for (int64_t r_m_i = 0; r_m_i < tile_size_m; r_m_i++) {
+      llvm::Value* lhs_offset = b_->CreateAdd(
+          b_->CreateMul(b_->CreateAdd(m_start, GetInt64(r_m_i)),
+                        GetInt64(dims().k())),
+          k_i);
+      vsl->StoreScalar(vsl->LoadScalar(lhs_, lhs_offset), packed_lhs_,
+                       b_->CreateAdd(packed_offset, GetInt64(r_m_i)));
+    }
+  });
+}
 
 void TiledSmallGemmEmitter::HandleResiduesOnN() {
   // We can only iterate the `n` dimension for an extent that is divisible by
@@ -924,6 +971,28 @@ void TiledSmallGemmEmitter::EmitTiledGemm(
                                /*matrix_size_along_minor_dim=*/dims().k(),
                                /*major_dim_offset=*/m_i,
                                /*tile_size_along_major_dim=*/tile_size_m);
+    if (packed_lhs_ != nullptr) {
+      PackLhsPanel(vsl, tile_size_m, m_i, k_start, k_end);
+    }
+    // Loads the [tile_size_m, tile_size_k] LHS tile at `k_i`, broadcasting
+    // each element into a vector.
+    auto load_lhs_tile = [&](llvm::Value* k_i) {
+      if (packed_lhs_ == nullptr) {
+        return lhs_memory_tile.LoadBroadcastTile(k_i, tile_size_k);
+      }
+      llvm::Value* packed_offset =
+          b_->CreateMul(b_->CreateSub(k_i, k_start), GetInt64(tile_size_m));
+      std::vector<std::vector<llvm::Value*>> lhs_tile(tile_size_m);
+      for (int64_t r_m_i = 0; r_m_i < tile_size_m; r_m_i++) {
+        for (int64_t r_k_i = 0; r_k_i < tile_size_k; r_k_i++) {
+          lhs_tile[r_m_i].push_back(vsl->LoadBroadcast(
+              packed_lhs_,
+              b_->CreateAdd(packed_offset,
+                            GetInt64(r_k_i * tile_size_m + r_m_i))));
+        }
+      }
+      return lhs_tile;
+    };
     ksl_.For(
         "dot.n", n_start, n_end, vsl->vector_size(), [&](llvm::Value* n_i) {
           TileVariable result_tile_var(vsl, result_memory_tile.LoadTile(n_i));
@@ -931,7 +1000,7 @@ void TiledSmallGemmEmitter::EmitTiledGemm(
             MemoryTile rhs_memory_tile(vsl, b_, rhs_, dims().n(), k_i,
                                        tile_size_k);
             std::vector<std::vector<llvm::Value*>> lhs_tile =
-                lhs_memory_tile.LoadBroadcastTile(k_i, tile_size_k);
+                load_lhs_tile(k_i);
             std::vector<llvm::Value*> rhs_tile = rhs_memory_tile.LoadTile(n_i);
             std::vector<llvm::Value*> result_tile = result_tile_var.Get();
             for (int64_t r_m_i = 0; r_m_i < tile_size_m; r_m_i++) {
@@ -1057,8 +1126,8 @@ void EmitColumnMajorGemv(PrimitiveType scalar_type, int64_t tile_rows,
 void EmitSmallGemm(PrimitiveType scalar_type, int64_t m, int64_t k, int64_t n,
                    int64_t max_vectorization_width, int64_t max_vector_count,
                    int64_t min_vectorization_width, int64_t tile_size_m,
-                   int64_t tile_size_k, llvm::Value* lhs, llvm::Value* rhs,
-                   llvm::Value* result, llvm::IRBuilder<>* b,
+                   int64_t tile_size_k, bool pack_lhs, llvm::Value* lhs,
+                   llvm::Value* rhs, llvm::Value* result, llvm::IRBuilder<>* b,
                    const HloModuleConfig& module_config) {
   TiledSmallGemmEmitter::Config config(
       /*scalar_type=*/scalar_type,
@@ -1066,7 +1135,8 @@ void EmitSmallGemm(PrimitiveType scalar_type, int64_t m, int64_t k, int64_t n,
       /*max_vectorization_width=*/max_vectorization_width,
       /*max_vector_count=*/max_vector_count,
       /*min_vectorization_width=*/min_vectorization_width,
-      /*tile_size_m=*/tile_size_m, /*tile_size_k=*/tile_size_k);
+      /*tile_size_m=*/tile_size_m, /*tile_size_k=*/tile_size_k,
+      /*pack_lhs=*/pack_lhs);
 
   KernelSupportLibrary::EmitAndCallOutlinedKernel(
       module_config, b, config.GetCacheKey(), lhs, rhs, result,
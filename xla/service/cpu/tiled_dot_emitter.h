@@ -38,11 +38,16 @@ void EmitColumnMajorGemv(PrimitiveType scalar_type, int64_t tile_rows,
                          llvm::IRBuilder<>* b,
                          const HloModuleConfig& module_config);
 
+// Emits a register blocked GEMM of row major matrices.  The accumulators of
+// a [`tile_size_m`, `max_vector_count` * `max_vectorization_width`] block of
+// the result are kept in registers while the K dimension is traversed,
+// unrolled by `tile_size_k`.  If `pack_lhs` is true, LHS panels are packed into
+// a contiguous buffer before they are multiplied.
 void EmitSmallGemm(PrimitiveType scalar_type, int64_t m, int64_t k, int64_t n,
                    int64_t max_vectorization_width, int64_t max_vector_count,
                    int64_t min_vectorization_width, int64_t tile_size_m,
-                   int64_t tile_size_k, llvm::Value* lhs, llvm::Value* rhs,
-                   llvm::Value* result, llvm::IRBuilder<>* b,
+                   int64_t tile_size_k, bool pack_lhs, llvm::Value* lhs,
+                   llvm::Value* rhs, llvm::Value* result, llvm::IRBuilder<>* b,
                    const HloModuleConfig& module_config);
 
 }  // namespace cpu
@@ -80,6 +80,11 @@ void XfeedQueueManager::ReleaseCurrentBuffer(int32_t length, void* data,
   current_buffer_ = nullptr;
 }
 
+int64_t XfeedQueueManager::NumEnqueuedBuffers() {
+  absl::MutexLock l(&mu_);
+  return enqueued_buffers_.size();
+}
+
 int64_t GetByteSizeRequirement(const Shape& shape, int64_t pointer_size) {
   if (shape.is_static() || shape.IsTuple()) {
     return ShapeUtil::ByteSizeOf(shape, pointer_size);
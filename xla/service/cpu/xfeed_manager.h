@@ -20,6 +20,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_CPU_XFEED_MANAGER_H_
 #define XLA_SERVICE_CPU_XFEED_MANAGER_H_
 
+#include <cstdint>
 #include <deque>
 
 #include "absl/types/span.h"
@@ -84,6 +85,11 @@ class XfeedQueueManager {
   // sanity checking purposes.
   void ReleaseCurrentBuffer(int32_t length, void* data, StatusOr<Shape> shape);
 
+  // Returns the number of enqueued buffers that the runtime has not dequeued
+  // yet. Producers can use it to bound how far they run ahead of the
+  // computation.
+  int64_t NumEnqueuedBuffers();
+
  private:
   const std::string queue_name_;
 
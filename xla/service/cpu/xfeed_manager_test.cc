@@ -17,7 +17,9 @@ limitations under the License.
 
 #include <memory>
 
+#include "xla/literal_util.h"
 #include "xla/service/cpu/cpu_runtime.h"
+#include "xla/service/cpu/cpu_xfeed.h"
 #include "xla/shape_util.h"
 #include "tsl/lib/core/status_test_util.h"
 #include "tsl/platform/env.h"
@@ -129,6 +131,42 @@ TEST_F(InfeedManagerTest, MultiThreaded) {
   ProcessNextBuffer(length);
 }
 
+TEST_F(InfeedManagerTest, NumEnqueuedBuffers) {
+  cpu::runtime::XfeedManager* xfeed = cpu::runtime::GetXfeedManager(0);
+  EXPECT_EQ(xfeed->infeed()->NumEnqueuedBuffers(), 0);
+
+  xfeed->infeed()->EnqueueBuffersAtomically(
+      {new TestInfeedBuffer(64), new TestInfeedBuffer(32)});
+  EXPECT_EQ(xfeed->infeed()->NumEnqueuedBuffers(), 2);
+  ProcessNextBuffer(64);
+  EXPECT_EQ(xfeed->infeed()->NumEnqueuedBuffers(), 1);
+  ProcessNextBuffer(32);
+  EXPECT_EQ(xfeed->infeed()->NumEnqueuedBuffers(), 0);
+}
+
+TEST_F(InfeedManagerTest, InfeedWithoutCopy) {
+  Literal literal = LiteralUtil::MakeTupleOwned(
+      LiteralUtil::CreateR1<uint8_t>({1, 2, 3, 4}),
+      LiteralUtil::CreateR1<uint8_t>({5, 6}));
+  bool done = false;
+  TF_ASSERT_OK(TransferLiteralToInfeedOnCpuWithoutCopy(
+      /*device_ordinal=*/0, literal, [&done] { done = true; }));
+
+  // The runtime reads from the buffers of the literal.
+  for (int64_t i = 0; i < 2; ++i) {
+    EXPECT_FALSE(done);
+    const Shape& shape = literal.shape().tuple_shapes(i);
+    std::string bytes = shape.SerializeAsString();
+    int32_t length = ShapeUtil::ByteSizeOf(shape);
+    void* buffer = __xla_cpu_runtime_AcquireInfeedBufferForDequeue(
+        /*run_options=*/nullptr, length, bytes.data(), bytes.size());
+    EXPECT_EQ(buffer, literal.untyped_data({i}));
+    __xla_cpu_runtime_ReleaseInfeedBufferAfterDequeue(
+        /*run_options=*/nullptr, length, buffer, bytes.data(), bytes.size());
+  }
+  EXPECT_TRUE(done);
+}
+
 TEST_F(InfeedManagerTest, OutfeedBasic) {
   TestInfeedBuffer* b = new TestInfeedBuffer(32, /*expect_shape_match=*/true);
   cpu::runtime::XfeedManager* xfeed = cpu::runtime::GetXfeedManager(0);
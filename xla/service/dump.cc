@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/dump.h"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -22,6 +23,7 @@ limitations under the License.
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
@@ -29,16 +31,19 @@ limitations under the License.
 #include "mlir/Support/FileUtilities.h"  // from @llvm-project
 #include "mlir/Transforms/LocationSnapshot.h"  // from @llvm-project
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_constant_section.h"
 #include "xla/service/hlo_graph_dumper.h"
 #include "xla/service/hlo_proto_util.h"
 #include "xla/util.h"
 #include "tsl/lib/io/zlib_compression_options.h"
 #include "tsl/lib/io/zlib_outputbuffer.h"
 #include "tsl/lib/strings/proto_serialization.h"
+#include "tsl/platform/cpu_info.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/regexp.h"
 #include "tsl/platform/status.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -62,6 +67,8 @@ struct CanonicalDebugOptions {
         dump_max_hlo_modules(opts.xla_dump_max_hlo_modules()),
         dump_module_metadata(opts.xla_dump_module_metadata()),
         dump_compress_protos(opts.xla_dump_compress_protos()),
+        dump_compress_text(opts.xla_dump_compress_text()),
+        dump_constants_separately(opts.xla_dump_hlo_constants_separately()),
         dump_hlo_metadata(!opts.xla_dump_disable_metadata()),
         dump_as_long_text(opts.xla_dump_hlo_as_long_text()),
         dump_mlir_pretty_form(opts.xla_dump_enable_mlir_pretty_form()) {
@@ -178,6 +185,8 @@ struct CanonicalDebugOptions {
   int64_t dump_max_hlo_modules;
   bool dump_module_metadata;
   bool dump_compress_protos;
+  bool dump_compress_text;
+  bool dump_constants_separately;
   bool dump_hlo_metadata;
   bool dump_as_long_text;
   bool dump_mlir_pretty_form;
@@ -205,15 +214,126 @@ class DataProducer {
   std::queue<std::function<std::string()>> produce_funcs_;
 };
 
+// A WritableFile that appends to a string, to compress blocks in memory.
+class StringWritableFile : public tsl::WritableFile {
+ public:
+  explicit StringWritableFile(std::string* data) : data_(data) {}
+
+  Status Append(absl::string_view data) override {
+    data_->append(data.data(), data.size());
+    return OkStatus();
+  }
+  Status Close() override { return OkStatus(); }
+  Status Flush() override { return OkStatus(); }
+  Status Sync() override { return OkStatus(); }
+
+ private:
+  std::string* data_;
+};
+
+// Appends the gzip member holding `data` to `*output`.
+static Status GzipCompress(absl::string_view data, std::string* output) {
+  StringWritableFile file(output);
+  auto gz_opts = tsl::io::ZlibCompressionOptions::GZIP();
+  tsl::io::ZlibOutputBuffer gz_file(&file, gz_opts.input_buffer_size,
+                                    gz_opts.output_buffer_size, gz_opts);
+  TF_RETURN_IF_ERROR(gz_file.Init());
+  TF_RETURN_IF_ERROR(gz_file.Append(data));
+  return gz_file.Close();
+}
+
+static tsl::thread::ThreadPool* GetGzipThreadPool() {
+  static tsl::thread::ThreadPool* thread_pool = new tsl::thread::ThreadPool(
+      tsl::Env::Default(), "xla_dump_gzip", tsl::port::MaxParallelism());
+  return thread_pool;
+}
+
+// Writes a gzip file made of one member per block of kBlockSize bytes, and
+// compresses the blocks in parallel. gzip readers, including gunzip and
+// tsl::io::ZlibInputStream, decode the members as the concatenation of the
+// blocks. The writer buffers at most two blocks per thread of the pool.
+class ParallelGzipWriter {
+ public:
+  explicit ParallelGzipWriter(tsl::WritableFile* file)
+      : file_(file),
+        max_pending_blocks_(2 * GetGzipThreadPool()->NumThreads()) {}
+
+  Status Append(absl::string_view data) {
+    while (!data.empty()) {
+      size_t size = std::min(data.size(), kBlockSize - buffer_.size());
+      buffer_.append(data.data(), size);
+      data.remove_prefix(size);
+      if (buffer_.size() == kBlockSize) {
+        TF_RETURN_IF_ERROR(CompressBlock());
+      }
+    }
+    return OkStatus();
+  }
+
+  Status Close() {
+    if (pending_.empty()) {
+      // Small files are compressed at once, without a thread hop.
+      std::string compressed;
+      TF_RETURN_IF_ERROR(GzipCompress(buffer_, &compressed));
+      TF_RETURN_IF_ERROR(file_->Append(compressed));
+    } else {
+      if (!buffer_.empty()) {
+        TF_RETURN_IF_ERROR(CompressBlock());
+      }
+      TF_RETURN_IF_ERROR(WritePendingBlocks(/*max_pending_blocks=*/0));
+    }
+    return file_->Close();
+  }
+
+ private:
+  static constexpr size_t kBlockSize = 1 << 20;
+
+  struct Block {
+    std::string data;
+    std::string compressed;
+    Status status;
+    absl::Notification done;
+  };
+
+  // Schedules the compression of `buffer_`.
+  Status CompressBlock() {
+    auto block = std::make_shared<Block>();
+    block->data = std::move(buffer_);
+    buffer_.clear();
+    GetGzipThreadPool()->Schedule([block] {
+      block->status = GzipCompress(block->data, &block->compressed);
+      std::string().swap(block->data);
+      block->done.Notify();
+    });
+    pending_.push(std::move(block));
+    return WritePendingBlocks(max_pending_blocks_);
+  }
+
+  // Writes the compressed blocks in order until at most `max_pending_blocks`
+  // are left.
+  Status WritePendingBlocks(size_t max_pending_blocks) {
+    while (pending_.size() > max_pending_blocks) {
+      std::shared_ptr<Block> block = std::move(pending_.front());
+      pending_.pop();
+      block->done.WaitForNotification();
+      TF_RETURN_IF_ERROR(block->status);
+      TF_RETURN_IF_ERROR(file_->Append(block->compressed));
+    }
+    return OkStatus();
+  }
+
+  tsl::WritableFile* file_;
+  const size_t max_pending_blocks_;
+  std::string buffer_;
+  std::queue<std::shared_ptr<Block>> pending_;
+};
+
 static Status WriteStringToFile(tsl::Env* env, const std::string& fname,
                                 DataProducer& data_producer, bool compressed) {
   std::unique_ptr<tsl::WritableFile> file;
   TF_RETURN_IF_ERROR(env->NewWritableFile(fname, &file));
   if (compressed) {
-    auto gz_opts = tsl::io::ZlibCompressionOptions::GZIP();
-    tsl::io::ZlibOutputBuffer gz_file(file.get(), gz_opts.input_buffer_size,
-                                      gz_opts.output_buffer_size, gz_opts);
-    TF_RETURN_IF_ERROR(gz_file.Init());
+    ParallelGzipWriter gz_file(file.get());
     while (auto next_producer = data_producer.Next()) {
       TF_RETURN_IF_ERROR(gz_file.Append(next_producer()));
     }
@@ -233,10 +353,7 @@ static Status WriteStringToFile(tsl::Env* env, const std::string& fname,
   }
   std::unique_ptr<tsl::WritableFile> file;
   TF_RETURN_IF_ERROR(env->NewWritableFile(fname, &file));
-  auto gz_opts = tsl::io::ZlibCompressionOptions::GZIP();
-  tsl::io::ZlibOutputBuffer gz_file(file.get(), gz_opts.input_buffer_size,
-                                    gz_opts.output_buffer_size, gz_opts);
-  TF_RETURN_IF_ERROR(gz_file.Init());
+  ParallelGzipWriter gz_file(file.get());
   TF_RETURN_IF_ERROR(gz_file.Append(data));
   return gz_file.Close();
 }
@@ -340,7 +457,7 @@ static absl::Mutex stdout_dump_mutex(absl::kConstInit);
 
 static std::optional<std::string> DumpToFileInDirOrStdoutImpl(
     string_view filename, string_view contents,
-    const CanonicalDebugOptions& opts) {
+    const CanonicalDebugOptions& opts, bool compress = false) {
   // Dump to stdout if that's called for.
   if (opts.dumping_to_stdout()) {
     absl::MutexLock lock(&stdout_dump_mutex);
@@ -350,12 +467,12 @@ static std::optional<std::string> DumpToFileInDirOrStdoutImpl(
   }
 
   // Otherwise, dump to a file.
-  return DumpToFileInDirImpl(filename, contents, opts);
+  return DumpToFileInDirImpl(filename, contents, opts, compress);
 }
 
 static std::optional<std::string> DumpToFileInDirOrStdoutImpl(
     string_view filename, DataProducer& data_producer,
-    const CanonicalDebugOptions& opts) {
+    const CanonicalDebugOptions& opts, bool compress = false) {
   // Dump to stdout if that's called for.
   if (opts.dumping_to_stdout()) {
     absl::MutexLock lock(&stdout_dump_mutex);
@@ -368,7 +485,7 @@ static std::optional<std::string> DumpToFileInDirOrStdoutImpl(
   }
 
   // Otherwise, dump to a file.
-  return DumpToFileInDirImpl(filename, data_producer, opts);
+  return DumpToFileInDirImpl(filename, data_producer, opts, compress);
 }
 
 // Returns whether the computation is trivial enough not to warrant dumping.
@@ -401,8 +518,13 @@ static std::vector<std::string> DumpHloModuleImpl(
     print_options.set_print_backend_config(true);
     print_options.set_print_metadata(opts.dump_hlo_metadata);
     print_options.set_print_name_after_closing_brace(true);
+    // Text dumped to stdout is never compressed.
+    const bool compress =
+        opts.dump_compress_text && !opts.dumping_to_stdout();
+    const char* extension = compress ? ".txt.gz" : ".txt";
     file_paths.push_back(DumpToFileInDirOrStdoutImpl(
-        StrCat(filename, ".txt"), module.ToString(print_options), opts));
+        StrCat(filename, extension), module.ToString(print_options), opts,
+        compress));
     if (buffer_assn) {
       DataProducer data_producer;
       data_producer.Append([&] { return buffer_assn->ToString(); });
@@ -410,13 +532,29 @@ static std::vector<std::string> DumpHloModuleImpl(
       data_producer.Append(
           [&] { return buffer_assn->hlo_live_range().ToString(); });
       file_paths.push_back(DumpToFileInDirOrStdoutImpl(
-          StrCat(filename, "-buffer-assignment.txt"), data_producer, opts));
+          StrCat(filename, "-buffer-assignment", extension), data_producer,
+          opts, compress));
     }
   }
 
   if (opts.dump_as_proto) {
     HloProto module_proto =
         buffer_assn ? MakeHloProto(module, *buffer_assn) : MakeHloProto(module);
+    if (opts.dump_constants_separately) {
+      // Constants smaller than a page gain nothing from being mapped.
+      constexpr int64_t kMinSeparateConstantBytes = 4096;
+      std::optional<std::string> constants_path =
+          GetDumpFilePath(StrCat(filename, ".hlo.pb.constants"), opts);
+      if (constants_path) {
+        Status status = WriteHloConstantSection(
+            module, kMinSeparateConstantBytes, *constants_path,
+            module_proto.mutable_hlo_module());
+        if (!status.ok()) {
+          LOG(ERROR) << "Could not write HLO constants to " << *constants_path
+                     << ": " << status;
+        }
+      }
+    }
     std::string pb;
     if (!tsl::SerializeToStringDeterministic(module_proto, &pb)) {
       pb = "Failed to serialize HLO module proto.";
@@ -424,6 +562,15 @@ static std::vector<std::string> DumpHloModuleImpl(
     file_paths.push_back(DumpToFileInDirImpl(
         StrCat(filename, opts.dump_compress_protos ? ".hlo.pb.gz" : ".hlo.pb"),
         pb, opts, opts.dump_compress_protos));
+    if (buffer_assn) {
+      std::string report_pb;
+      if (!tsl::SerializeToStringDeterministic(
+              buffer_assn->ToMemoryReportProto(), &report_pb)) {
+        report_pb = "Failed to serialize memory report proto.";
+      }
+      file_paths.push_back(DumpToFileInDirImpl(
+          StrCat(filename, "-memory-report.pb"), report_pb, opts));
+    }
   }
 
   auto render_graph = [&](RenderedGraphFormat format,
@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef XLA_SERVICE_EIGH_EXPANDER_H_
 #define XLA_SERVICE_EIGH_EXPANDER_H_
 
+#include <string>
+#include <utility>
+
 #include "absl/container/flat_hash_map.h"
 #include "xla/client/xla_builder.h"
 #include "xla/service/op_expander_pass.h"
@@ -24,6 +27,9 @@ namespace xla {
 
 class EighExpander : public OpExpanderPass {
  public:
+  explicit EighExpander(HloPredicate extra_filter = nullptr)
+      : OpExpanderPass(std::move(extra_filter)) {}
+
   absl::string_view name() const override { return "eigh_expander"; }
 
  protected:
@@ -109,6 +109,24 @@ TEST_F(GenericTransferManagerTest, TransferLiteralToDeviceInt4) {
   }
 }
 
+TEST_F(GenericTransferManagerTest, TransferTupleToDeviceOnMultipleStreams) {
+  Literal literal = LiteralUtil::MakeTupleOwned(
+      LiteralUtil::CreateR1<uint16_t>({1, 2, 3}),
+      LiteralUtil::MakeTupleOwned(LiteralUtil::CreateR1<uint16_t>({4}),
+                                  LiteralUtil::CreateR1<uint16_t>({5, 6})),
+      LiteralUtil::CreateR2<uint16_t>({{7, 8}, {9, 10}}));
+  ScopedShapedBuffer buffer = AllocateBuffer(literal.shape());
+  TF_ASSERT_OK(transfer_manager_.TransferLiteralToDeviceMultiStreamAsync(
+      &stream_.value(), literal, buffer, /*max_streams=*/2));
+  TF_ASSERT_OK(stream_->BlockHostUntilDone());
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      Literal result,
+      transfer_manager_.TransferManager::TransferLiteralFromDevice(
+          &stream_.value(), buffer));
+  EXPECT_TRUE(LiteralTestUtil::Equal(literal, result));
+}
+
 TEST_F(GenericTransferManagerTest, TransferLiteralFromDevice) {
   ScopedShapedBuffer buffer = AllocateBuffer(ShapeUtil::MakeShape(U16, {2, 2}));
 
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/gpu/all_reduce_blueconnect.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <optional>
 #include <vector>
@@ -183,11 +184,28 @@ StatusOr<std::optional<DecomposedReplicaGroups>> TryDecomposeReplicaGroups(
 //
 // When applied repeatedly, this transformation will reproduce the same pattern
 // as described in the BlueConnect paper.
+//
+// All-reduces transferring fewer than `min_decompose_bytes` are latency bound:
+// splitting them into three collectives would only add launch and
+// synchronization overhead, so they are left untouched.
 StatusOr<bool> TryDecomposeAllReduce(HloAllReduceInstruction* all_reduce,
-                                     size_t num_devices_per_host) {
+                                     size_t num_devices_per_host,
+                                     int64_t min_decompose_bytes) {
   TF_RET_CHECK(all_reduce);
   TF_RET_CHECK(!all_reduce->has_sharding());
 
+  int64_t all_reduce_bytes = 0;
+  for (const HloInstruction* operand : all_reduce->operands()) {
+    TF_RET_CHECK(operand->shape().IsArray());
+    all_reduce_bytes += ShapeUtil::ByteSizeOf(operand->shape());
+  }
+  if (all_reduce_bytes < min_decompose_bytes) {
+    VLOG(2) << "Not decomposing " << all_reduce->name() << " of "
+            << all_reduce_bytes << " bytes (threshold " << min_decompose_bytes
+            << " bytes)";
+    return false;
+  }
+
   HloComputation& computation = *all_reduce->parent();  // never null
   PrimitiveType element_type = all_reduce->operand(0)->shape().element_type();
 
@@ -258,7 +276,7 @@ StatusOr<bool> TryDecomposeAllReduce(HloAllReduceInstruction* all_reduce,
   // Try to apply decomposition recursively.
   TF_RETURN_IF_ERROR(
       TryDecomposeAllReduce(Cast<HloAllReduceInstruction>(new_all_reduce),
-                            num_devices_per_host)
+                            num_devices_per_host, min_decompose_bytes)
           .status());
   return true;
 }
@@ -297,7 +315,8 @@ StatusOr<bool> AllReduceBlueConnect::Run(
   for (HloAllReduceInstruction* all_reduce : all_reduces) {
     TF_ASSIGN_OR_RETURN(
         bool all_reduce_changed,
-        TryDecomposeAllReduce(all_reduce, num_devices_per_host_));
+        TryDecomposeAllReduce(all_reduce, num_devices_per_host_,
+                              min_decompose_bytes_));
     changed |= all_reduce_changed;
   }
 
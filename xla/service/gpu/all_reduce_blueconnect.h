@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_ALL_REDUCE_BLUECONNECT_H_
 #define XLA_SERVICE_GPU_ALL_REDUCE_BLUECONNECT_H_
 
+#include <cstddef>
+#include <cstdint>
+
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/statusor.h"
@@ -31,10 +34,17 @@ namespace xla {
 // This algorithm attempts to minimize the number of levels of network hierarchy
 // traversed for as much data transfer as possible. This implementation assumes
 // that host IDs are ordered corresponding to network hierarchy.
+//
+// The decomposition replaces one collective by three, so it only pays off once
+// the all-reduce is bandwidth bound. All-reduces (or intermediate all-reduces
+// of the recursive decomposition) smaller than `min_decompose_bytes` are left
+// as a single flat all-reduce.
 class AllReduceBlueConnect : public HloModulePass {
  public:
-  explicit AllReduceBlueConnect(size_t num_devices_per_host)
-      : num_devices_per_host_(num_devices_per_host) {}
+  explicit AllReduceBlueConnect(size_t num_devices_per_host,
+                                int64_t min_decompose_bytes = 0)
+      : num_devices_per_host_(num_devices_per_host),
+        min_decompose_bytes_(min_decompose_bytes) {}
 
   absl::string_view name() const override { return "all-reduce-blueconnect"; }
 
@@ -45,6 +55,7 @@ class AllReduceBlueConnect : public HloModulePass {
 
  private:
   size_t num_devices_per_host_;
+  int64_t min_decompose_bytes_;
 };
 
 }  // namespace xla
@@ -259,5 +259,33 @@ ENTRY %comp {
   EXPECT_THAT(pass.Run(module.get()), IsOkAndHolds(false));
 }
 
+TEST_F(AllReduceBlueConnectTest, SmallAllReduceNotDecomposed) {
+  constexpr absl::string_view hlo_string = R"(
+HloModule module
+
+%add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY %comp {
+  p0 = f32[4,4] parameter(0)
+  ROOT crs = f32[4,4] all-reduce(p0), to_apply=add
+})";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  SetModuleConfig(*module, /*replica_count=*/8);
+
+  // f32[4,4] is 64 bytes, below the decomposition threshold.
+  AllReduceBlueConnect pass(/*num_devices_per_host=*/4,
+                            /*min_decompose_bytes=*/128);
+  EXPECT_THAT(pass.Run(module.get()), IsOkAndHolds(false));
+
+  AllReduceBlueConnect permissive_pass(/*num_devices_per_host=*/4,
+                                       /*min_decompose_bytes=*/64);
+  EXPECT_THAT(permissive_pass.Run(module.get()), IsOkAndHolds(true));
+}
+
 }  // namespace
 }  // namespace xla
@@ -93,6 +93,7 @@ AutotunerCompileUtil::AutotunerCompileUtil(const AutotuneConfig& config,
   opts_.set_xla_gpu_enable_gpu2_runtime(false);
   opts_.set_xla_embed_ir_in_executable(false);
   opts_.set_xla_gpu_enable_persistent_temp_buffers(false);
+  opts_.set_xla_gpu_temp_buffer_arenas(0);
 }
 
 StatusOr<std::optional<AutotunerCompileUtil::ProfilingOutput>>
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -24,6 +25,8 @@ limitations under the License.
 
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/autotune_results.pb.h"
@@ -36,6 +39,7 @@ limitations under the License.
 #include "xla/util.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/fingerprint.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/statusor.h"
 
@@ -48,6 +52,10 @@ static absl::Mutex autotune_cache_mu(absl::kConstInit);
 static auto& autotune_cache ABSL_GUARDED_BY(autotune_cache_mu) =
     *new AutotuneCacheMap();
 
+static absl::Mutex result_store_mu(absl::kConstInit);
+static auto& result_store ABSL_GUARDED_BY(result_store_mu) =
+    *new std::shared_ptr<AutotuneResultStore>();
+
 /*static*/ Status AutotunerUtil::SerializeAutotuneResults(
     AutotuneResults* results) {
   absl::MutexLock lock(&autotune_cache_mu);
@@ -121,14 +129,70 @@ AutotuneCacheKey::AutotuneCacheKey(absl::string_view model_str,
                                    const HloInstruction& instr)
     : AutotuneCacheKey(model_str, ToCanonicalString(&instr)) {}
 
-static AutotuneResult* TryFindInCache(const AutotuneCacheKey& key) {
+static std::shared_ptr<AutotuneResultStore> GetResultStore() {
+  absl::MutexLock lock(&result_store_mu);
+  return result_store;
+}
+
+/*static*/ void AutotunerUtil::SetResultStore(
+    std::shared_ptr<AutotuneResultStore> store) {
+  absl::MutexLock lock(&result_store_mu);
+  result_store = std::move(store);
+}
+
+/*static*/ void AutotunerUtil::UseResultStoreDirectory(absl::string_view dir) {
+  absl::MutexLock lock(&result_store_mu);
+  auto* directory_store =
+      dynamic_cast<DirectoryAutotuneResultStore*>(result_store.get());
+  if (directory_store == nullptr || directory_store->dir() != dir) {
+    result_store =
+        std::make_shared<DirectoryAutotuneResultStore>(std::string(dir));
+  }
+}
+
+// Looks up `key` in the in-process cache and then in the result store. Results
+// found in the store are added to the in-process cache.
+static std::optional<AutotuneResult> TryFindInCache(
+    const AutotuneCacheKey& key) {
+  {
+    absl::MutexLock lock(&autotune_cache_mu);
+    auto it = autotune_cache.find(key);
+    if (it != autotune_cache.end()) {
+      VLOG(1) << "Autotune cache hit";
+      return it->second;
+    }
+  }
+
+  std::shared_ptr<AutotuneResultStore> store = GetResultStore();
+  if (store == nullptr) {
+    return std::nullopt;
+  }
+  StatusOr<std::optional<AutotuneResult>> stored = store->Lookup(key);
+  if (!stored.ok()) {
+    LOG(WARNING) << "Failed to look up " << key.ToString()
+                 << " in the autotune result store: " << stored.status();
+    return std::nullopt;
+  }
+  if (!stored->has_value()) {
+    return std::nullopt;
+  }
+  VLOG(1) << "Autotune result store hit";
   absl::MutexLock lock(&autotune_cache_mu);
-  auto it = autotune_cache.find(key);
-  if (it != autotune_cache.end()) {
-    VLOG(1) << "Autotune cache hit";
-    return &it->second;
+  auto [it, inserted] = autotune_cache.emplace(key, **std::move(stored));
+  return it->second;
+}
+
+// Publishes a newly measured result to the result store, if there is one.
+static void PublishResult(const AutotuneCacheKey& key,
+                          const AutotuneResult& result) {
+  std::shared_ptr<AutotuneResultStore> store = GetResultStore();
+  if (store == nullptr) {
+    return;
+  }
+  if (Status status = store->Insert(key, result); !status.ok()) {
+    LOG(WARNING) << "Failed to publish " << key.ToString()
+                 << " to the autotune result store: " << status;
   }
-  return nullptr;
 }
 
 /*static*/ AutotuneCacheKey AutotunerUtil::GetKey(
@@ -137,13 +201,19 @@ static AutotuneResult* TryFindInCache(const AutotuneCacheKey& key) {
 }
 
 /*static*/ bool AutotunerUtil::IsInCache(const AutotuneCacheKey& key) {
-  return TryFindInCache(key) != nullptr;
+  return TryFindInCache(key).has_value();
 }
 
 /*static*/ bool AutotunerUtil::AddResult(const AutotuneCacheKey& key,
                                          AutotuneResult result) {
-  absl::MutexLock lock(&autotune_cache_mu);
-  auto [_, inserted] = autotune_cache.emplace(key, std::move(result));
+  bool inserted;
+  {
+    absl::MutexLock lock(&autotune_cache_mu);
+    inserted = autotune_cache.emplace(key, result).second;
+  }
+  if (inserted) {
+    PublishResult(key, result);
+  }
   return inserted;
 }
 
@@ -151,15 +221,24 @@ static AutotuneResult* TryFindInCache(const AutotuneCacheKey& key) {
     const HloInstruction* instr, const AutotuneConfig& config,
     const AutotuneNoCacheFn& autotune_fn) {
   AutotuneCacheKey key = GetKey(instr, config);
-  if (AutotuneResult* res = TryFindInCache(key)) {
-    return *res;
+  if (std::optional<AutotuneResult> res = TryFindInCache(key)) {
+    return *std::move(res);
   }
 
   TF_ASSIGN_OR_RETURN(AutotuneResult autotune_result, autotune_fn());
 
-  absl::MutexLock lock(&autotune_cache_mu);
-  auto [it, inserted] = autotune_cache.emplace(key, autotune_result);
-  return it->second;
+  AutotuneResult result;
+  bool inserted;
+  {
+    absl::MutexLock lock(&autotune_cache_mu);
+    auto [it, emplaced] = autotune_cache.emplace(key, autotune_result);
+    result = it->second;
+    inserted = emplaced;
+  }
+  if (inserted) {
+    PublishResult(key, result);
+  }
+  return result;
 }
 
 namespace {
@@ -175,8 +254,88 @@ bool IsTextProtoPath(absl::string_view file_path) {
          absl::EndsWith(file_path, ".prototxt");
 }
 
+// Returns the key under which the result for `key` is kept in an
+// AutotuneResultStore.
+std::string GetResultStoreKey(const AutotuneCacheKey& key) {
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(
+      absl::StrCat(kVersion, "\n", key.GetModelStr(), "\n", key.GetHlo()));
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+// Returns the result of `entry` if it belongs to `key`. The device and HLO are
+// compared to guard against fingerprint collisions.
+StatusOr<std::optional<AutotuneResult>> ParseResultStoreEntry(
+    const AutotuneCacheKey& key, const std::string& serialized_entry) {
+  AutotuneResults::Entry entry;
+  if (!entry.ParseFromString(serialized_entry)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Failed to parse the stored result for ", key.ToString()));
+  }
+  if (entry.device() != key.GetModelStr() || entry.hlo() != key.GetHlo()) {
+    return std::nullopt;
+  }
+  return std::optional<AutotuneResult>(std::move(*entry.mutable_result()));
+}
+
+std::string SerializeResultStoreEntry(const AutotuneCacheKey& key,
+                                      const AutotuneResult& result) {
+  AutotuneResults::Entry entry;
+  entry.set_device(std::string(key.GetModelStr()));
+  entry.set_hlo(std::string(key.GetHlo()));
+  *entry.mutable_result() = result;
+  return entry.SerializeAsString();
+}
+
 }  // anonymous namespace
 
+StatusOr<std::optional<AutotuneResult>> DirectoryAutotuneResultStore::Lookup(
+    const AutotuneCacheKey& key) {
+  tsl::Env* env = tsl::Env::Default();
+  std::string path =
+      tsl::io::JoinPath(dir_, absl::StrCat(GetResultStoreKey(key), ".pb"));
+  if (!env->FileExists(path).ok()) {
+    return std::nullopt;
+  }
+  std::string serialized_entry;
+  TF_RETURN_IF_ERROR(tsl::ReadFileToString(env, path, &serialized_entry));
+  return ParseResultStoreEntry(key, serialized_entry);
+}
+
+Status DirectoryAutotuneResultStore::Insert(const AutotuneCacheKey& key,
+                                            const AutotuneResult& result) {
+  tsl::Env* env = tsl::Env::Default();
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(dir_));
+  std::string path =
+      tsl::io::JoinPath(dir_, absl::StrCat(GetResultStoreKey(key), ".pb"));
+  // Write through a temporary file, so that other hosts never read a partially
+  // written entry.
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return FailedPrecondition("Couldn't create a temporary file name for %s",
+                              path);
+  }
+  TF_RETURN_IF_ERROR(tsl::WriteStringToFile(
+      env, tmp_path, SerializeResultStoreEntry(key, result)));
+  return env->RenameFile(tmp_path, path);
+}
+
+StatusOr<std::optional<AutotuneResult>> KeyValueAutotuneResultStore::Lookup(
+    const AutotuneCacheKey& key) {
+  TF_ASSIGN_OR_RETURN(
+      std::optional<std::string> serialized_entry,
+      get_(absl::StrCat("autotune_result:", GetResultStoreKey(key))));
+  if (!serialized_entry.has_value()) {
+    return std::nullopt;
+  }
+  return ParseResultStoreEntry(key, *serialized_entry);
+}
+
+Status KeyValueAutotuneResultStore::Insert(const AutotuneCacheKey& key,
+                                           const AutotuneResult& result) {
+  return put_(absl::StrCat("autotune_result:", GetResultStoreKey(key)),
+              SerializeResultStoreEntry(key, result));
+}
+
 /*static*/ Status AutotunerUtil::LoadAutotuneResults(absl::string_view data,
                                                      bool as_textproto) {
   AutotuneResults results;
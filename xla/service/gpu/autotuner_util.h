@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <utility>
@@ -152,6 +153,67 @@ class AutotuneConfig {
   bool exhaustive_tiling_search_;
 };
 
+// A store of autotuning results shared between processes, e.g. between the
+// hosts of a multi-host job. Results measured by any process become visible to
+// all the others, which then don't have to autotune the same instructions
+// again.
+//
+// Implementations must be thread-safe.
+class AutotuneResultStore {
+ public:
+  virtual ~AutotuneResultStore() = default;
+
+  // Returns the result stored for `key`, or std::nullopt if there is none.
+  virtual StatusOr<std::optional<AutotuneResult>> Lookup(
+      const AutotuneCacheKey& key) = 0;
+
+  // Stores `result` for `key`. If several processes store a result for the
+  // same key, any one of them may win.
+  virtual Status Insert(const AutotuneCacheKey& key,
+                        const AutotuneResult& result) = 0;
+};
+
+// Stores each result in its own file in a directory, which is typically on
+// storage shared between hosts.
+class DirectoryAutotuneResultStore : public AutotuneResultStore {
+ public:
+  explicit DirectoryAutotuneResultStore(std::string dir)
+      : dir_(std::move(dir)) {}
+
+  StatusOr<std::optional<AutotuneResult>> Lookup(
+      const AutotuneCacheKey& key) override;
+  Status Insert(const AutotuneCacheKey& key,
+                const AutotuneResult& result) override;
+
+  const std::string& dir() const { return dir_; }
+
+ private:
+  std::string dir_;
+};
+
+// Stores results in a key-value store, e.g. the one of the PJRT distributed
+// runtime. `get` returns std::nullopt for keys that have not been set yet and
+// must not block waiting for them.
+class KeyValueAutotuneResultStore : public AutotuneResultStore {
+ public:
+  using GetCallback = std::function<StatusOr<std::optional<std::string>>(
+      const std::string& key)>;
+  using PutCallback =
+      std::function<Status(const std::string& key, const std::string& value)>;
+
+  KeyValueAutotuneResultStore(GetCallback get, PutCallback put)
+      : get_(std::move(get)), put_(std::move(put)) {}
+
+  StatusOr<std::optional<AutotuneResult>> Lookup(
+      const AutotuneCacheKey& key) override;
+  Status Insert(const AutotuneCacheKey& key,
+                const AutotuneResult& result) override;
+
+ private:
+  GetCallback get_;
+  PutCallback put_;
+};
+
 using AutotuneNoCacheFn = std::function<StatusOr<AutotuneResult>()>;
 
 struct AutotunerUtil {
@@ -252,6 +314,16 @@ struct AutotunerUtil {
 
   static void ClearAutotuneResults();
 
+  // Sets the store that autotuning results are shared through, or disables
+  // sharing if `store` is null. On a miss in the in-process cache, results are
+  // looked up in the store before autotuning, and newly measured results are
+  // published to it. Errors of the store are logged and otherwise ignored.
+  static void SetResultStore(std::shared_ptr<AutotuneResultStore> store);
+
+  // Shares autotuning results through a DirectoryAutotuneResultStore in `dir`,
+  // unless results are already shared through that directory.
+  static void UseResultStoreDirectory(absl::string_view dir);
+
   // Extracts an HLO instruction into a new HLO module replacing its operands
   // with parameter instructions.
   static std::unique_ptr<HloModule> ExtractInstructionIntoNewModule(
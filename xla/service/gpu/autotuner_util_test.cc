@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/gpu/autotuner_util.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include <gmock/gmock.h>
@@ -26,6 +27,7 @@ limitations under the License.
 #include "xla/autotune_results.pb.h"
 #include "xla/tests/hlo_test_base.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla {
 namespace gpu {
@@ -123,6 +125,32 @@ TEST_F(AutotunerUtilTest, LoadAutotuneResultsFromFile_Protobuf) {
   TF_EXPECT_OK(AutotunerUtil::LoadAutotuneResultsFromFile(kFilePath));
 }
 
+TEST_F(AutotunerUtilTest, ResultsAreSharedThroughDirectoryStore) {
+  std::string dir = GetUniqueTempFilePath("_autotune_store");
+  AutotunerUtil::UseResultStoreDirectory(dir);
+  AutotunerUtil::ClearAutotuneResults();
+
+  AutotuneCacheKey key("model", "hlo");
+  AutotuneResult result;
+  result.mutable_gemm()->set_algorithm(7);
+  EXPECT_TRUE(AutotunerUtil::AddResult(key, result));
+
+  // Clearing the in-process cache models another host sharing the directory.
+  AutotunerUtil::ClearAutotuneResults();
+  EXPECT_TRUE(AutotunerUtil::IsInCache(key));
+  EXPECT_FALSE(AutotunerUtil::IsInCache(AutotuneCacheKey("model", "other")));
+
+  DirectoryAutotuneResultStore store(dir);
+  TF_ASSERT_OK_AND_ASSIGN(std::optional<AutotuneResult> stored,
+                          store.Lookup(key));
+  ASSERT_TRUE(stored.has_value());
+  EXPECT_EQ(stored->gemm().algorithm(), 7);
+
+  AutotunerUtil::SetResultStore(nullptr);
+  AutotunerUtil::ClearAutotuneResults();
+  EXPECT_FALSE(AutotunerUtil::IsInCache(key));
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -18,6 +18,7 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "absl/algorithm/container.h"
 #include "xla/map_util.h"
 #include "xla/service/gpu/gpu_constants.h"
 #include "xla/status_macros.h"
@@ -55,6 +56,15 @@ Status BufferAllocations::TearDown(
   return status;
 }
 
+bool BufferAllocations::HasSameAddresses(
+    absl::Span<const se::DeviceMemoryBase> buffers) const {
+  return absl::c_equal(buffers_, buffers,
+                       [](const se::DeviceMemoryBase& a,
+                          const se::DeviceMemoryBase& b) {
+                         return a.IsSameAs(b);
+                       });
+}
+
 se::DeviceMemoryBase BufferAllocations::GetDeviceAddress(
     BufferAllocation::Index buffer_index) const {
   CHECK_GE(buffer_index, 0);
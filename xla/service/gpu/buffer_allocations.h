@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_BUFFER_ALLOCATIONS_H_
 #define XLA_SERVICE_GPU_BUFFER_ALLOCATIONS_H_
 
+#include <cstdint>
 #include <memory>
 #include <set>
 #include <string>
@@ -85,6 +86,19 @@ class BufferAllocations {
 
   size_t size() const { return buffers_.size(); }
 
+  // Returns true if the buffers have the same addresses as `buffers`.
+  bool HasSameAddresses(absl::Span<const se::DeviceMemoryBase> buffers) const;
+
+  // An identifier of the buffer addresses, which is equal for buffer
+  // allocations with the same addresses, so that thunks can reuse what they
+  // computed from the addresses of a previous run. 0 if unknown.
+  uint64_t addresses_id() const { return addresses_id_; }
+  void set_addresses_id(uint64_t addresses_id) {
+    addresses_id_ = addresses_id;
+  }
+
+  absl::Span<const se::DeviceMemoryBase> buffers() const { return buffers_; }
+
  private:
   // An array of device pointers that stores the address of each buffer
   // indexed by Index. Each element can point to a temporary buffer, an
@@ -92,6 +106,7 @@ class BufferAllocations {
   std::vector<se::DeviceMemoryBase> buffers_;
   int device_ordinal_;
   se::DeviceMemoryAllocator* memory_allocator_;
+  uint64_t addresses_id_ = 0;
 };
 
 }  // namespace gpu
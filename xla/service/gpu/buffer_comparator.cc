@@ -17,10 +17,14 @@ limitations under the License.
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/base/call_once.h"
 #include "absl/strings/str_replace.h"
+#include "absl/types/span.h"
 #include "xla/service/gpu/gpu_asm_opts_util.h"
 #include "xla/service/gpu/launch_dimensions.h"
 #include "xla/service/hlo_module_config.h"
@@ -1016,30 +1020,32 @@ using ComparisonKernelT =
     se::TypedKernel<se::DeviceMemory<ElementT>, se::DeviceMemory<ElementT>,
                     float, uint64_t, se::DeviceMemory<uint64_t>>;
 
-// Compares two buffers on the GPU.
+// Compares each of the `current` buffers with `expected` on the GPU, with a
+// single host synchronization.
 //
-// Returns `true` if two buffers are equal, `false` otherwise.
+// Returns, for each buffer, `true` if it is equal to `expected`, `false`
+// otherwise.
 template <typename ElementT>
-static StatusOr<bool> DeviceCompare(se::Stream* stream,
-                                    se::DeviceMemoryBase current,
-                                    se::DeviceMemoryBase expected,
-                                    const Shape& buffer_shape,
-                                    const HloModuleConfig& config,
-                                    absl::string_view kernel_name) {
+static StatusOr<std::vector<bool>> DeviceCompare(
+    se::Stream* stream, absl::Span<const se::DeviceMemoryBase> current,
+    se::DeviceMemoryBase expected, const Shape& buffer_shape,
+    const HloModuleConfig& config, absl::string_view kernel_name) {
   se::StreamExecutor* executor = stream->parent();
 
-  se::ScopedDeviceMemory<uint64_t> out_param =
-      executor->AllocateOwnedScalar<uint64_t>();
-
-  stream->ThenMemZero(out_param.ptr(), sizeof(uint64_t));
-  if (current.size() != expected.size()) {
-    return InternalError("Mismatched buffer size: %d bytes vs. %d bytes",
-                         current.size(), expected.size());
+  for (const se::DeviceMemoryBase& buffer : current) {
+    if (buffer.size() != expected.size()) {
+      return InternalError("Mismatched buffer size: %d bytes vs. %d bytes",
+                           buffer.size(), expected.size());
+    }
   }
 
-  se::DeviceMemory<ElementT> current_typed(current);
+  // One mismatch count per compared buffer.
+  se::ScopedDeviceMemory<uint64_t> out_param =
+      executor->AllocateOwnedArray<uint64_t>(current.size());
+  stream->ThenMemZero(out_param.ptr(), out_param->size());
+
   se::DeviceMemory<ElementT> expected_typed(expected);
-  uint64_t buffer_size = current_typed.ElementCount();
+  uint64_t buffer_size = expected_typed.ElementCount();
 
   absl::Span<const uint8_t> compiled_ptx = {};
   StatusOr<absl::Span<const uint8_t>> compiled_ptx_or =
@@ -1060,12 +1066,23 @@ static StatusOr<bool> DeviceCompare(se::Stream* stream,
     });
   }
 
+  // Loading the module is much more expensive than comparing small buffers,
+  // so loaded kernels are reused across comparisons.
+#if GOOGLE_CUDA
+  TF_ASSIGN_OR_RETURN(
+      std::shared_ptr<ComparisonKernelT<ElementT>> comparison_kernel,
+      (se::LoadKernelOrGetPtr<se::DeviceMemory<ElementT>,
+                              se::DeviceMemory<ElementT>, float, uint64_t,
+                              se::DeviceMemory<uint64_t>>(
+          executor, kernel_name, buffer_compare_ptx, compiled_ptx)));
+#else
   TF_ASSIGN_OR_RETURN(
       std::unique_ptr<ComparisonKernelT<ElementT>> comparison_kernel,
       (executor->CreateTypedKernel<se::DeviceMemory<ElementT>,
                                    se::DeviceMemory<ElementT>, float, uint64_t,
                                    se::DeviceMemory<uint64_t>>(
           kernel_name, buffer_compare_ptx, compiled_ptx)));
+#endif  // GOOGLE_CUDA
 
   const se::DeviceDescription& gpu_device_info =
       executor->GetDeviceDescription();
@@ -1075,17 +1092,27 @@ static StatusOr<bool> DeviceCompare(se::Stream* stream,
 
   LaunchDimensions::Dim3D thread_counts = dim.thread_counts_per_block();
   LaunchDimensions::Dim3D block_counts = dim.block_counts();
-  TF_RETURN_IF_ERROR(stream->ThenLaunch(
-      se::ThreadDim(thread_counts.x, thread_counts.y, thread_counts.z),
-      se::BlockDim(block_counts.x, block_counts.y, block_counts.z),
-      *comparison_kernel, current_typed, expected_typed,
-      static_cast<float>(kTolerance), buffer_size, out_param.cref()));
-
-  uint64_t result = -1;
-  CHECK_EQ(out_param->size(), sizeof(result));
-  stream->ThenMemcpy(&result, *out_param, sizeof(result));
+  for (size_t i = 0; i < current.size(); ++i) {
+    se::DeviceMemory<ElementT> current_typed(current[i]);
+    se::DeviceMemory<uint64_t> mismatch_count =
+        se::DeviceMemory<uint64_t>::MakeFromByteSize(
+            static_cast<uint64_t*>(out_param->opaque()) + i,
+            sizeof(uint64_t));
+    TF_RETURN_IF_ERROR(stream->ThenLaunch(
+        se::ThreadDim(thread_counts.x, thread_counts.y, thread_counts.z),
+        se::BlockDim(block_counts.x, block_counts.y, block_counts.z),
+        *comparison_kernel, current_typed, expected_typed,
+        static_cast<float>(kTolerance), buffer_size, mismatch_count));
+  }
+
+  std::vector<uint64_t> results(current.size(), -1);
+  stream->ThenMemcpy(results.data(), *out_param, out_param->size());
   TF_RETURN_IF_ERROR(stream->BlockHostUntilDone());
-  return result == 0;
+  std::vector<bool> equal(current.size());
+  for (size_t i = 0; i < current.size(); ++i) {
+    equal[i] = results[i] == 0;
+  }
+  return equal;
 }
 
 // Host side comparison code that does the same thing, but reports some of the
@@ -1142,32 +1169,42 @@ StatusOr<bool> HostCompare(se::Stream* stream, se::DeviceMemoryBase current,
 }
 
 template <typename ElementT, typename ComparisonT>
-static StatusOr<bool> CompareEqualParameterized(se::Stream* stream,
-                                                se::DeviceMemoryBase current,
-                                                se::DeviceMemoryBase expected,
-                                                const Shape& shape,
-                                                const HloModuleConfig& config,
-                                                absl::string_view kernel_name) {
+static StatusOr<std::vector<bool>> CompareEqualParameterized(
+    se::Stream* stream, absl::Span<const se::DeviceMemoryBase> current,
+    se::DeviceMemoryBase expected, const Shape& shape,
+    const HloModuleConfig& config, absl::string_view kernel_name) {
   XLA_SCOPED_LOGGING_TIMER("BufferComparator::CompareEqual");
-  TF_ASSIGN_OR_RETURN(bool result,
+  TF_ASSIGN_OR_RETURN(std::vector<bool> results,
                       DeviceCompare<ElementT>(stream, current, expected, shape,
                                               config, kernel_name));
 
-  if (result) {
-    return true;
+  // Only the buffers that don't match are copied back, to report differences.
+  for (size_t i = 0; i < current.size(); ++i) {
+    if (results[i]) continue;
+    TF_ASSIGN_OR_RETURN(bool host_return, (HostCompare<ElementT, ComparisonT>(
+                                              stream, current[i], expected)));
+    CHECK(!host_return)
+        << "Host comparison succeeded even though GPU comparison failed.";
   }
 
-  TF_ASSIGN_OR_RETURN(bool host_return, (HostCompare<ElementT, ComparisonT>(
-                                            stream, current, expected)));
-  CHECK_EQ(host_return, result)
-      << "Host comparison succeeded even though GPU comparison failed.";
-
-  return false;
+  return results;
 }
 
 StatusOr<bool> BufferComparator::CompareEqual(
     se::Stream* stream, se::DeviceMemoryBase current,
     se::DeviceMemoryBase expected) const {
+  TF_ASSIGN_OR_RETURN(std::vector<bool> results,
+                      CompareEqual(stream, absl::MakeConstSpan(&current, 1),
+                                   expected));
+  return results[0];
+}
+
+StatusOr<std::vector<bool>> BufferComparator::CompareEqual(
+    se::Stream* stream, absl::Span<const se::DeviceMemoryBase> current,
+    se::DeviceMemoryBase expected) const {
+  if (current.empty()) {
+    return std::vector<bool>();
+  }
   switch (shape_.element_type()) {
     case xla::F8E4M3FN:
       return CompareEqualParameterized<tsl::float8_e4m3fn, float>(
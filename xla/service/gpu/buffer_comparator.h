@@ -16,6 +16,9 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_BUFFER_COMPARATOR_H_
 #define XLA_SERVICE_GPU_BUFFER_COMPARATOR_H_
 
+#include <vector>
+
+#include "absl/types/span.h"
 #include "xla/service/hlo_module_config.h"
 #include "xla/shape.h"
 #include "xla/stream_executor/stream_executor.h"
@@ -43,6 +46,14 @@ class BufferComparator {
   StatusOr<bool> CompareEqual(se::Stream* stream, se::DeviceMemoryBase current,
                               se::DeviceMemoryBase expected) const;
 
+  // Compares each of the `current` buffers with `expected` as above, launching
+  // all the comparisons before a single host synchronization. The buffers are
+  // only copied to the host when they don't compare equal, to log the
+  // differences.
+  StatusOr<std::vector<bool>> CompareEqual(
+      se::Stream* stream, absl::Span<const se::DeviceMemoryBase> current,
+      se::DeviceMemoryBase expected) const;
+
  private:
   Shape shape_;
   HloModuleConfig config_;
@@ -19,6 +19,7 @@ limitations under the License.
 #include <cstdint>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "xla/primitive_util.h"
 #include "xla/service/gpu/stream_executor_util.h"
@@ -348,6 +349,37 @@ TEST_F(BufferComparatorTest, BF16) {
       comparator.CompareEqual(&stream, *lhs.ptr(), *rhs.ptr()).value());
 }
 
+TEST_F(BufferComparatorTest, CompareMany) {
+  se::Stream stream(stream_exec_);
+  stream.Init();
+
+  const std::vector<float> expected = {1, 2, 3};
+  const std::vector<std::vector<float>> candidates = {
+      {1, 2, 3}, {1, 2, 30}, {1.01, 2, 3}, {-1, 2, 3}};
+
+  se::ScopedDeviceMemory<float> expected_buffer =
+      stream_exec_->AllocateOwnedArray<float>(expected.size());
+  stream.ThenMemcpy(expected_buffer.ptr(), expected.data(),
+                    expected_buffer->size());
+  std::vector<se::ScopedDeviceMemory<float>> candidate_buffers;
+  std::vector<se::DeviceMemoryBase> candidate_memory;
+  for (const std::vector<float>& candidate : candidates) {
+    candidate_buffers.push_back(
+        stream_exec_->AllocateOwnedArray<float>(candidate.size()));
+    stream.ThenMemcpy(candidate_buffers.back().ptr(), candidate.data(),
+                      candidate_buffers.back()->size());
+    candidate_memory.push_back(*candidate_buffers.back());
+  }
+  TF_CHECK_OK(stream.BlockHostUntilDone());
+
+  BufferComparator comparator(ShapeUtil::MakeShape(F32, {3}),
+                              HloModuleConfig());
+  EXPECT_THAT(
+      comparator.CompareEqual(&stream, candidate_memory, *expected_buffer)
+          .value(),
+      ::testing::ElementsAre(true, false, true, false));
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
@@ -18,6 +18,9 @@ def get_cub_sort_kernel_types(name = ""):
         "u16",
         "u32",
         "u64",
+        "f16_b32",
+        "f32_b32",
+        "s32_b32",
         "u16_b16",
         "u16_b32",
         "u16_b64",
@@ -28,6 +28,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/hlo/ir/hlo_schedule.h"
+#include "xla/service/gpu/cublas_cudnn.h"
 #include "xla/shape.h"
 #include "xla/statusor.h"
 #include "xla/util.h"
@@ -46,7 +47,11 @@ namespace {
 // used by commands.
 bool IsCommand(const HloInstruction* inst) {
   // TODO(anlunx): Add support for conditionals and while loops.
-  return inst->opcode() == HloOpcode::kFusion;
+  if (inst->opcode() == HloOpcode::kFusion) return true;
+
+  // Legacy cuBLAS gemms are traced into nested command buffers.
+  return inst->opcode() == HloOpcode::kCustomCall &&
+         IsLegacyCublasMatmul(*inst);
 }
 
 bool IsIntermediate(const HloInstruction* inst) {
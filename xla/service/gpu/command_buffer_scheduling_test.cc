@@ -239,6 +239,50 @@ TEST_F(CommandBufferSchedulingTest, CollectCommandBufferSequence) {
   EXPECT_EQ(seq_1[1]->opcode(), HloOpcode::kFusion);
 }
 
+TEST_F(CommandBufferSchedulingTest, CollectGemmIntoCommandBufferSequence) {
+  const char* hlo = R"(
+      HloModule TestModule, is_scheduled=true
+
+      %fused_computation(param_0: f32[2,2], param_1: f32[2,2]) -> f32[2,2] {
+        %p0 = f32[2,2] parameter(0)
+        %p1 = f32[2,2] parameter(1)
+        ROOT %add = f32[2,2] add(f32[2,2] %p0, f32[2,2] %p1)
+      }
+
+      %fused_computation.1(param_0: f32[2,2], param_1: f32[2,2]) -> f32[2,2] {
+        %p0 = f32[2,2] parameter(0)
+        %p1 = f32[2,2] parameter(1)
+        ROOT %add = f32[2,2] add(f32[2,2] %p0, f32[2,2] %p1)
+      }
+
+      ENTRY %main (a: f32[2,2], b: f32[2,2]) -> f32[2,2] {
+        %a = f32[2,2] parameter(0)
+        %b = f32[2,2] parameter(1)
+        %fusion = f32[2,2] fusion(f32[2,2] %a, f32[2,2] %b), kind=kLoop, calls=%fused_computation
+        %gemm = f32[2,2] custom-call(f32[2,2] %fusion, f32[2,2] %b), custom_call_target="__cublas$gemm"
+        ROOT %fusion.1 = f32[2,2] fusion(f32[2,2] %gemm, f32[2,2] %a), kind=kLoop, calls=%fused_computation.1
+      })";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(hlo));
+
+  HloInstructionSequence seq;
+  for (HloInstruction* x : module->entry_computation()->instructions()) {
+    seq.push_back(x);
+  }
+
+  std::vector<HloInstructionSequence> command_buffer_sequences =
+      CommandBufferScheduling::CollectCommandBufferSequences(seq);
+  ASSERT_EQ(command_buffer_sequences.size(), 1);
+
+  std::vector<HloInstruction*> seq_0 =
+      command_buffer_sequences[0].instructions();
+  ASSERT_EQ(seq_0.size(), 3);
+  EXPECT_EQ(seq_0[0]->opcode(), HloOpcode::kFusion);
+  EXPECT_EQ(seq_0[1]->opcode(), HloOpcode::kCustomCall);
+  EXPECT_EQ(seq_0[2]->opcode(), HloOpcode::kFusion);
+}
+
 TEST_F(CommandBufferSchedulingTest, MoveParametersToFront) {
   const char* hlo = R"(
       HloModule TestModule, is_scheduled=true
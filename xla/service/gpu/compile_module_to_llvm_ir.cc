@@ -58,6 +58,7 @@ limitations under the License.
 #include "xla/service/gpu/ir_emitter_context.h"
 #include "xla/service/gpu/ir_emitter_unnested.h"
 #include "xla/service/gpu/metrics.h"
+#include "xla/service/gpu/nccl_group_thunk.h"
 #include "xla/service/gpu/sequential_thunk.h"
 #include "xla/service/gpu/while_thunk.h"
 #include "xla/service/hlo_dataflow_analysis.h"
@@ -153,6 +154,9 @@ void ForAllThunks(const std::function<void(Thunk*)>& fn,
       auto* sequential_thunk =
           tensorflow::down_cast<SequentialThunk*>(thunk.get());
       ForAllThunks(fn, &sequential_thunk->thunks());
+    } else if (thunk->kind() == Thunk::kNcclGroup) {
+      auto* group_thunk = tensorflow::down_cast<NcclGroupThunk*>(thunk.get());
+      ForAllThunks(fn, &group_thunk->thunks());
     } else if (thunk->kind() == Thunk::kWhile) {
       auto* while_thunk = tensorflow::down_cast<WhileThunk*>(thunk.get());
       ForAllThunks(fn, &while_thunk->condition_thunk_sequence()->thunks());
@@ -20,6 +20,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/util.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla {
 namespace gpu {
@@ -48,15 +49,12 @@ Status ConditionalThunk::ExecuteOnStream(const ExecuteParams& params) {
   auto& stream = *params.stream;
 
   // Copy the predicate value from device.
-  int32_t branch_index = -1;
-  bool pred = false;
+  TF_ASSIGN_OR_RETURN(void* host_branch_index, branch_indices_.Get(&stream));
   se::DeviceMemoryBase branch_index_address =
       params.buffer_allocations->GetDeviceAddress(branch_index_buffer_index_);
-  if (config_.branch_index_is_bool) {
-    stream.ThenMemcpy(&pred, branch_index_address, sizeof(bool));
-  } else {
-    stream.ThenMemcpy(&branch_index, branch_index_address, sizeof(int32_t));
-  }
+  stream.ThenMemcpy(host_branch_index, branch_index_address,
+                    config_.branch_index_is_bool ? sizeof(bool)
+                                                 : sizeof(int32_t));
 
   Status block_status = stream.BlockHostUntilDone();
   if (!block_status.ok()) {
@@ -64,9 +62,11 @@ Status ConditionalThunk::ExecuteOnStream(const ExecuteParams& params) {
         "Failed to retrieve branch_index value on stream %p: %s.", &stream,
         block_status.message());
   }
+  int32_t branch_index;
   if (config_.branch_index_is_bool) {
-    branch_index = pred ? 0 : 1;
+    branch_index = *static_cast<bool*>(host_branch_index) ? 0 : 1;
   } else {
+    branch_index = *static_cast<int32_t*>(host_branch_index);
     // Handle default scenario for branch_index not in [0, num_branches).
     if (branch_index < 0 || branch_index >= config_.branch_count) {
       branch_index = config_.branch_count - 1;
@@ -22,6 +22,7 @@ limitations under the License.
 #include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/service/gpu/buffer_allocations.h"
+#include "xla/service/gpu/pinned_host_buffers.h"
 #include "xla/service/gpu/sequential_thunk.h"
 #include "xla/service/gpu/thunk.h"
 #include "xla/stream_executor/stream_executor.h"
@@ -64,6 +65,8 @@ class ConditionalThunk : public Thunk {
  private:
   const ConditionalThunkConfig config_;
   BufferAllocation::Slice branch_index_buffer_index_;
+  // Pinned host memory the branch index is copied to.
+  PinnedHostBuffers branch_indices_{sizeof(int32_t)};
 };
 
 }  // namespace gpu
@@ -43,12 +43,12 @@ ConvolutionThunk::ConvolutionThunk(
       config_(std::move(config)) {}
 
 GenericConvRunner& ConvolutionThunk::GetOrCreateRunner(
-    const stream_executor::Stream* stream) {
+    stream_executor::StreamExecutor* executor) {
   absl::MutexLock lock(&mu_);
-  auto it = runner_cache_.find(stream);
+  auto it = runner_cache_.find(executor);
   if (it == runner_cache_.end()) {
     it = runner_cache_
-             .insert({stream, std::make_unique<GenericConvRunner>(config_)})
+             .insert({executor, &GetSharedConvRunner(config_, executor)})
              .first;
   }
   return *it->second;
@@ -72,7 +72,7 @@ Status ConvolutionThunk::ExecuteOnStream(const ExecuteParams& params) {
       buffer_allocations.GetDeviceAddress(scratch_buffer_);
 
   RunConvOptions opts;
-  opts.runner_cache = &GetOrCreateRunner(params.stream);
+  opts.runner_cache = &GetOrCreateRunner(params.stream->parent());
 
   TF_RETURN_IF_ERROR(RunGpuConv(config_, absl::MakeSpan(operand_se_buffers),
                                 absl::MakeSpan(result_se_buffers), scratch,
@@ -58,13 +58,15 @@ class ConvolutionThunk : public Thunk {
   std::vector<BufferAllocation::Slice> operand_buffers_;
   std::vector<BufferAllocation::Slice> result_buffers_;
   BufferAllocation::Slice scratch_buffer_;
-  GenericConvRunner& GetOrCreateRunner(const stream_executor::Stream* stream);
+  GenericConvRunner& GetOrCreateRunner(
+      stream_executor::StreamExecutor* executor);
 
   // Convolution config
   const GpuConvConfig config_;
   absl::Mutex mu_;
-  absl::flat_hash_map<const stream_executor::Stream*,
-                      std::unique_ptr<GenericConvRunner>>
+  // The runners shared with the identical convolutions, see
+  // GetSharedConvRunner, for each executor.
+  absl::flat_hash_map<stream_executor::StreamExecutor*, GenericConvRunner*>
       runner_cache_ ABSL_GUARDED_BY(mu_);
 };
 
@@ -21,23 +21,36 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "cub/device/device_radix_sort.cuh"
+#include "cub/device/device_segmented_radix_sort.cuh"
+#include "cub/iterator/counting_input_iterator.cuh"
+#include "cub/iterator/transform_input_iterator.cuh"
 
 namespace xla {
 namespace gpu {
 namespace {
 
-template <typename KeyT>
-absl::Status CubSortKeys(void* d_temp_storage, size_t& temp_bytes,
-                         const void* d_keys_in, void* d_keys_out,
-                         size_t num_items, bool descending) {
-  cudaError_t err =
-      descending
-          ? cub::DeviceRadixSort::SortKeysDescending<KeyT>(
-                d_temp_storage, temp_bytes, static_cast<const KeyT*>(d_keys_in),
-                static_cast<KeyT*>(d_keys_out), num_items)
-          : cub::DeviceRadixSort::SortKeys<KeyT>(
-                d_temp_storage, temp_bytes, static_cast<const KeyT*>(d_keys_in),
-                static_cast<KeyT*>(d_keys_out), num_items);
+// Maps a segment index to the offset of its first element, for sorting the
+// rows of a [batch_size, segment_size] array with DeviceSegmentedRadixSort
+// without materializing the offsets in device memory.
+struct SegmentOffsetOp {
+  __host__ __device__ int operator()(int segment) const {
+    return segment * segment_size;
+  }
+  int segment_size;
+};
+
+using SegmentOffsetIterator =
+    cub::TransformInputIterator<int, SegmentOffsetOp,
+                                cub::CountingInputIterator<int>>;
+
+SegmentOffsetIterator MakeSegmentOffsets(size_t num_items,
+                                         size_t batch_size) {
+  return SegmentOffsetIterator(
+      cub::CountingInputIterator<int>(0),
+      SegmentOffsetOp{static_cast<int>(num_items / batch_size)});
+}
+
+absl::Status ToStatus(cudaError_t err) {
   if (err != 0) {
     return absl::InvalidArgumentError(
         absl::StrCat("CUB error: ", cudaGetErrorString(err)));
@@ -45,28 +58,61 @@ absl::Status CubSortKeys(void* d_temp_storage, size_t& temp_bytes,
   return absl::OkStatus();
 }
 
+template <typename KeyT>
+absl::Status CubSortKeys(void* d_temp_storage, size_t& temp_bytes,
+                         const void* d_keys_in, void* d_keys_out,
+                         size_t num_items, bool descending,
+                         size_t batch_size) {
+  auto keys_in = static_cast<const KeyT*>(d_keys_in);
+  auto keys_out = static_cast<KeyT*>(d_keys_out);
+  if (batch_size > 1) {
+    SegmentOffsetIterator offsets = MakeSegmentOffsets(num_items, batch_size);
+    return ToStatus(
+        descending
+            ? cub::DeviceSegmentedRadixSort::SortKeysDescending<KeyT>(
+                  d_temp_storage, temp_bytes, keys_in, keys_out, num_items,
+                  batch_size, offsets, offsets + 1)
+            : cub::DeviceSegmentedRadixSort::SortKeys<KeyT>(
+                  d_temp_storage, temp_bytes, keys_in, keys_out, num_items,
+                  batch_size, offsets, offsets + 1));
+  }
+  return ToStatus(descending
+                      ? cub::DeviceRadixSort::SortKeysDescending<KeyT>(
+                            d_temp_storage, temp_bytes, keys_in, keys_out,
+                            num_items)
+                      : cub::DeviceRadixSort::SortKeys<KeyT>(
+                            d_temp_storage, temp_bytes, keys_in, keys_out,
+                            num_items));
+}
+
 template <typename KeyT, typename ValT>
 absl::Status CubSortPairs(void* d_temp_storage, size_t& temp_bytes,
                           const void* d_keys_in, void* d_keys_out,
                           const void* d_values_in, void* d_values_out,
-                          size_t num_items, bool descending) {
-  cudaError_t err =
-      descending
-          ? cub::DeviceRadixSort::SortPairsDescending<KeyT, ValT>(
-                d_temp_storage, temp_bytes, static_cast<const KeyT*>(d_keys_in),
-                static_cast<KeyT*>(d_keys_out),
-                static_cast<const ValT*>(d_values_in),
-                static_cast<ValT*>(d_values_out), num_items)
-          : cub::DeviceRadixSort::SortPairs<KeyT, ValT>(
-                d_temp_storage, temp_bytes, static_cast<const KeyT*>(d_keys_in),
-                static_cast<KeyT*>(d_keys_out),
-                static_cast<const ValT*>(d_values_in),
-                static_cast<ValT*>(d_values_out), num_items);
-  if (err != 0) {
-    return absl::InvalidArgumentError(
-        absl::StrCat("CUB error: ", cudaGetErrorString(err)));
+                          size_t num_items, bool descending,
+                          size_t batch_size) {
+  auto keys_in = static_cast<const KeyT*>(d_keys_in);
+  auto keys_out = static_cast<KeyT*>(d_keys_out);
+  auto values_in = static_cast<const ValT*>(d_values_in);
+  auto values_out = static_cast<ValT*>(d_values_out);
+  if (batch_size > 1) {
+    SegmentOffsetIterator offsets = MakeSegmentOffsets(num_items, batch_size);
+    return ToStatus(
+        descending
+            ? cub::DeviceSegmentedRadixSort::SortPairsDescending<KeyT, ValT>(
+                  d_temp_storage, temp_bytes, keys_in, keys_out, values_in,
+                  values_out, num_items, batch_size, offsets, offsets + 1)
+            : cub::DeviceSegmentedRadixSort::SortPairs<KeyT, ValT>(
+                  d_temp_storage, temp_bytes, keys_in, keys_out, values_in,
+                  values_out, num_items, batch_size, offsets, offsets + 1));
   }
-  return absl::OkStatus();
+  return ToStatus(
+      descending ? cub::DeviceRadixSort::SortPairsDescending<KeyT, ValT>(
+                       d_temp_storage, temp_bytes, keys_in, keys_out,
+                       values_in, values_out, num_items)
+                 : cub::DeviceRadixSort::SortPairs<KeyT, ValT>(
+                       d_temp_storage, temp_bytes, keys_in, keys_out,
+                       values_in, values_out, num_items));
 }
 
 }  // namespace
@@ -74,19 +120,20 @@ absl::Status CubSortPairs(void* d_temp_storage, size_t& temp_bytes,
 #define XLA_CUB_DEFINE_SORT_KEYS(suffix, type)                                \
   absl::Status CubSortKeys_##suffix(void* d_temp_storage, size_t& temp_bytes, \
                                     const void* d_keys_in, void* d_keys_out,  \
-                                    size_t num_items, bool descending) {      \
+                                    size_t num_items, bool descending,        \
+                                    size_t batch_size) {                      \
     return CubSortKeys<type>(d_temp_storage, temp_bytes, d_keys_in,           \
-                             d_keys_out, num_items, descending);              \
+                             d_keys_out, num_items, descending, batch_size);  \
   }
 
 #define XLA_CUB_DEFINE_SORT_PAIRS(suffix, type1, type2)                      \
   absl::Status CubSortPairs_##suffix(                                        \
       void* d_temp_storage, size_t& temp_bytes, const void* d_keys_in,       \
       void* d_keys_out, const void* d_values_in, void* d_values_out,         \
-      size_t num_items, bool descending) {                                   \
+      size_t num_items, bool descending, size_t batch_size) {                \
     return CubSortPairs<type1, type2>(d_temp_storage, temp_bytes, d_keys_in, \
                                       d_keys_out, d_values_in, d_values_out, \
-                                      num_items, descending);                \
+                                      num_items, descending, batch_size);    \
   }
 
 // Floating point types.
@@ -131,6 +178,17 @@ XLA_CUB_DEFINE_SORT_KEYS(u32, uint32_t)
 XLA_CUB_DEFINE_SORT_KEYS(u64, uint64_t)
 #endif
 
+// Pairs with a floating point or signed key and 32-bit values, e.g. argsort.
+#ifdef CUB_TYPE_F16_B32
+XLA_CUB_DEFINE_SORT_PAIRS(f16_b32, __half, uint32_t)
+#endif
+#ifdef CUB_TYPE_F32_B32
+XLA_CUB_DEFINE_SORT_PAIRS(f32_b32, float, uint32_t)
+#endif
+#ifdef CUB_TYPE_S32_B32
+XLA_CUB_DEFINE_SORT_PAIRS(s32_b32, int32_t, uint32_t)
+#endif
+
 // Pairs with 16-bit key.
 #ifdef CUB_TYPE_U16_B16
 XLA_CUB_DEFINE_SORT_PAIRS(u16_b16, uint16_t, uint16_t)
@@ -24,16 +24,21 @@ limitations under the License.
 namespace xla {
 namespace gpu {
 
+// Sorts `num_items` keys (and values). If `batch_size` is greater than one,
+// the input is a row-major [batch_size, num_items / batch_size] array and each
+// row is sorted independently. A null `d_temp_storage` only computes the
+// required `temp_bytes`.
 #define XLA_CUB_DECLARE_SORT_KEYS(suffix)                                     \
   absl::Status CubSortKeys_##suffix(void* d_temp_storage, size_t& temp_bytes, \
                                     const void* d_keys_in, void* d_keys_out,  \
-                                    size_t num_items, bool descending);
+                                    size_t num_items, bool descending,        \
+                                    size_t batch_size);
 
 #define XLA_CUB_DECLARE_SORT_PAIRS(suffix)                             \
   absl::Status CubSortPairs_##suffix(                                  \
       void* d_temp_storage, size_t& temp_bytes, const void* d_keys_in, \
       void* d_keys_out, const void* d_values_in, void* d_values_out,   \
-      size_t num_items, bool descending);
+      size_t num_items, bool descending, size_t batch_size);
 
 XLA_CUB_DECLARE_SORT_KEYS(bf16)
 XLA_CUB_DECLARE_SORT_KEYS(f16)
@@ -48,6 +53,9 @@ XLA_CUB_DECLARE_SORT_KEYS(u16)
 XLA_CUB_DECLARE_SORT_KEYS(u32)
 XLA_CUB_DECLARE_SORT_KEYS(u64)
 
+XLA_CUB_DECLARE_SORT_PAIRS(f16_b32)
+XLA_CUB_DECLARE_SORT_PAIRS(f32_b32)
+XLA_CUB_DECLARE_SORT_PAIRS(s32_b32)
 XLA_CUB_DECLARE_SORT_PAIRS(u16_b16)
 XLA_CUB_DECLARE_SORT_PAIRS(u16_b32)
 XLA_CUB_DECLARE_SORT_PAIRS(u16_b64)
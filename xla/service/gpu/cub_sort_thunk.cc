@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/gpu/cub_sort_thunk.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -29,8 +30,10 @@ limitations under the License.
 #include "xla/service/gpu/cub_sort_kernel.h"
 #include "xla/service/gpu/thunk.h"
 #include "xla/status.h"
+#include "xla/statusor.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/errors.h"
 
 namespace xla {
 namespace gpu {
@@ -40,7 +43,8 @@ namespace {
 class CubSortKeysImpl : public CubSortRunnerInterface {
  public:
   using SortKeysFn =
-      std::function<Status(void*, size_t&, const void*, void*, size_t, bool)>;
+      std::function<Status(void*, size_t&, const void*, void*, size_t, bool,
+                           size_t)>;
 
   explicit CubSortKeysImpl(SortKeysFn sort_keys_fn, PrimitiveType type)
       : sort_keys_fn_(sort_keys_fn), type_(type) {}
@@ -48,9 +52,11 @@ class CubSortKeysImpl : public CubSortRunnerInterface {
   Status Run(se::DeviceMemoryBase input_keys, se::DeviceMemoryBase input_values,
              se::DeviceMemoryBase output_keys,
              se::DeviceMemoryBase output_values, se::DeviceMemoryBase scratch,
-             bool descending) override;
+             bool descending, int64_t batch_size) override;
   Status Run(const Thunk::ExecuteParams& params,
              const CubSortThunk* thunk) override;
+  StatusOr<int64_t> GetScratchSize(int64_t num_items,
+                                   int64_t batch_size) override;
 
  private:
   SortKeysFn sort_keys_fn_;
@@ -61,13 +67,14 @@ Status CubSortKeysImpl::Run(se::DeviceMemoryBase input_keys,
                             se::DeviceMemoryBase input_values,
                             se::DeviceMemoryBase output_keys,
                             se::DeviceMemoryBase output_values,
-                            se::DeviceMemoryBase scratch, bool descending) {
+                            se::DeviceMemoryBase scratch, bool descending,
+                            int64_t batch_size) {
   size_t temp_bytes = scratch.size();
   size_t num_items = input_keys.size() * 8 / primitive_util::BitWidth(type_);
   CHECK(input_values.is_null());
   CHECK(output_values.is_null());
   return sort_keys_fn_(scratch.opaque(), temp_bytes, input_keys.opaque(),
-                       output_keys.opaque(), num_items, descending);
+                       output_keys.opaque(), num_items, descending, batch_size);
 }
 
 Status CubSortKeysImpl::Run(const Thunk::ExecuteParams& params,
@@ -75,14 +82,24 @@ Status CubSortKeysImpl::Run(const Thunk::ExecuteParams& params,
   const BufferAllocations& allocs = *params.buffer_allocations;
   return Run(allocs.GetDeviceAddress(thunk->operand(0)), se::DeviceMemoryBase(),
              allocs.GetDeviceAddress(thunk->result(0)), se::DeviceMemoryBase(),
-             allocs.GetDeviceAddress(thunk->scratch()), thunk->descending());
+             allocs.GetDeviceAddress(thunk->scratch()), thunk->descending(),
+             thunk->batch_size());
+}
+
+StatusOr<int64_t> CubSortKeysImpl::GetScratchSize(int64_t num_items,
+                                                  int64_t batch_size) {
+  size_t temp_bytes = 0;
+  TF_RETURN_IF_ERROR(sort_keys_fn_(nullptr, temp_bytes, nullptr, nullptr,
+                                   num_items, false, batch_size));
+  return temp_bytes;
 }
 
 // Template class for sorting a pair of tensors.
 class CubSortPairsImpl : public CubSortRunnerInterface {
  public:
   using SortPairsFn = std::function<Status(void*, size_t&, const void*, void*,
-                                           const void*, void*, size_t, bool)>;
+                                           const void*, void*, size_t, bool,
+                                           size_t)>;
 
   explicit CubSortPairsImpl(SortPairsFn sort_pairs_fn, PrimitiveType type)
       : sort_pairs_fn_(sort_pairs_fn), type_(type) {}
@@ -90,9 +107,11 @@ class CubSortPairsImpl : public CubSortRunnerInterface {
   Status Run(se::DeviceMemoryBase input_keys, se::DeviceMemoryBase input_values,
              se::DeviceMemoryBase output_keys,
              se::DeviceMemoryBase output_values, se::DeviceMemoryBase scratch,
-             bool descending) override;
+             bool descending, int64_t batch_size) override;
   Status Run(const Thunk::ExecuteParams& params,
              const CubSortThunk* thunk) override;
+  StatusOr<int64_t> GetScratchSize(int64_t num_items,
+                                   int64_t batch_size) override;
 
  private:
   SortPairsFn sort_pairs_fn_;
@@ -103,12 +122,14 @@ Status CubSortPairsImpl::Run(se::DeviceMemoryBase input_keys,
                              se::DeviceMemoryBase input_values,
                              se::DeviceMemoryBase output_keys,
                              se::DeviceMemoryBase output_values,
-                             se::DeviceMemoryBase scratch, bool descending) {
+                             se::DeviceMemoryBase scratch, bool descending,
+                             int64_t batch_size) {
   size_t temp_bytes = scratch.size();
   size_t num_items = input_keys.size() * 8 / primitive_util::BitWidth(type_);
   return sort_pairs_fn_(scratch.opaque(), temp_bytes, input_keys.opaque(),
                         output_keys.opaque(), input_values.opaque(),
-                        output_values.opaque(), num_items, descending);
+                        output_values.opaque(), num_items, descending,
+                        batch_size);
 }
 
 Status CubSortPairsImpl::Run(const Thunk::ExecuteParams& params,
@@ -118,7 +139,17 @@ Status CubSortPairsImpl::Run(const Thunk::ExecuteParams& params,
              allocs.GetDeviceAddress(thunk->operand(1)),
              allocs.GetDeviceAddress(thunk->result(0)),
              allocs.GetDeviceAddress(thunk->result(1)),
-             allocs.GetDeviceAddress(thunk->scratch()), thunk->descending());
+             allocs.GetDeviceAddress(thunk->scratch()), thunk->descending(),
+             thunk->batch_size());
+}
+
+StatusOr<int64_t> CubSortPairsImpl::GetScratchSize(int64_t num_items,
+                                                   int64_t batch_size) {
+  size_t temp_bytes = 0;
+  TF_RETURN_IF_ERROR(sort_pairs_fn_(nullptr, temp_bytes, nullptr, nullptr,
+                                    nullptr, nullptr, num_items, false,
+                                    batch_size));
+  return temp_bytes;
 }
 
 std::unique_ptr<CubSortRunnerInterface> CreateCubSortRunner(
@@ -160,8 +191,18 @@ std::unique_ptr<CubSortRunnerInterface> CreateCubSortRunner(
       << "Unsupported value type of the sort kernel: "
       << primitive_util::LowercasePrimitiveTypeName(value_type);
 
-  // Only unsigned integer types could be used for keys.
   switch (key_type) {
+    // Floating point and signed keys are only paired with 32-bit values, which
+    // covers sorting with S32 or U32 indices.
+    case F16:
+      CHECK_EQ(valueWidth, 32);
+      return std::make_unique<CubSortPairsImpl>(CubSortPairs_f16_b32, F16);
+    case F32:
+      CHECK_EQ(valueWidth, 32);
+      return std::make_unique<CubSortPairsImpl>(CubSortPairs_f32_b32, F32);
+    case S32:
+      CHECK_EQ(valueWidth, 32);
+      return std::make_unique<CubSortPairsImpl>(CubSortPairs_s32_b32, S32);
     case U16:
       if (valueWidth == 16) {
         return std::make_unique<CubSortPairsImpl>(CubSortPairs_u16_b16, U16);
@@ -204,23 +245,33 @@ CubSortThunk::CubSortThunk(ThunkInfo thunk_info, PrimitiveType type,
                            std::optional<PrimitiveType> value_type,
                            std::vector<BufferAllocation::Slice> operands,
                            std::vector<BufferAllocation::Slice> results,
-                           BufferAllocation::Slice scratch, bool descending)
+                           BufferAllocation::Slice scratch, bool descending,
+                           int64_t batch_size)
     : Thunk(Thunk::kCubSort, thunk_info),
       runner_(CreateCubSortRunner(type, value_type)),
       operands_(std::move(operands)),
       results_(std::move(results)),
       scratch_(scratch),
-      descending_(descending) {}
+      descending_(descending),
+      batch_size_(batch_size) {}
 
 Status RunCubSort(PrimitiveType type, std::optional<PrimitiveType> value_type,
                   se::DeviceMemoryBase input_keys,
                   se::DeviceMemoryBase input_values,
                   se::DeviceMemoryBase output_keys,
                   se::DeviceMemoryBase output_values,
-                  se::DeviceMemoryBase scratch, bool descending) {
+                  se::DeviceMemoryBase scratch, bool descending,
+                  int64_t batch_size) {
   auto runner = CreateCubSortRunner(type, value_type);
   return runner->Run(input_keys, input_values, output_keys, output_values,
-                     scratch, descending);
+                     scratch, descending, batch_size);
+}
+
+StatusOr<int64_t> GetCubSortScratchSize(PrimitiveType type,
+                                        std::optional<PrimitiveType> value_type,
+                                        int64_t num_items, int64_t batch_size) {
+  auto runner = CreateCubSortRunner(type, value_type);
+  return runner->GetScratchSize(num_items, batch_size);
 }
 
 }  // namespace gpu
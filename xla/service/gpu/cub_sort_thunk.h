@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_CUB_SORT_THUNK_H_
 #define XLA_SERVICE_GPU_CUB_SORT_THUNK_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -23,6 +24,7 @@ limitations under the License.
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/gpu/thunk.h"
 #include "xla/status.h"
+#include "xla/statusor.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/xla_data.pb.h"
 
@@ -36,9 +38,14 @@ class CubSortRunnerInterface {
                      se::DeviceMemoryBase input_values,
                      se::DeviceMemoryBase output_keys,
                      se::DeviceMemoryBase output_values,
-                     se::DeviceMemoryBase scratch, bool descending) = 0;
+                     se::DeviceMemoryBase scratch, bool descending,
+                     int64_t batch_size) = 0;
   virtual Status Run(const Thunk::ExecuteParams& params,
                      const class CubSortThunk* thunk) = 0;
+  // Returns the scratch size in bytes needed to sort `num_items` elements
+  // split into `batch_size` rows.
+  virtual StatusOr<int64_t> GetScratchSize(int64_t num_items,
+                                           int64_t batch_size) = 0;
 };
 
 class CubSortThunk : public Thunk {
@@ -47,7 +54,8 @@ class CubSortThunk : public Thunk {
                std::optional<PrimitiveType> value_type,
                std::vector<BufferAllocation::Slice> operands,
                std::vector<BufferAllocation::Slice> results,
-               BufferAllocation::Slice scratch, bool descending);
+               BufferAllocation::Slice scratch, bool descending,
+               int64_t batch_size);
 
   Status ExecuteOnStream(const ExecuteParams& params) override {
     return runner_->Run(params, this);
@@ -57,6 +65,7 @@ class CubSortThunk : public Thunk {
   BufferAllocation::Slice result(int i) const { return results_[i]; }
   BufferAllocation::Slice scratch() const { return scratch_; }
   bool descending() const { return descending_; }
+  int64_t batch_size() const { return batch_size_; }
 
  private:
   std::unique_ptr<CubSortRunnerInterface> runner_;
@@ -64,6 +73,7 @@ class CubSortThunk : public Thunk {
   std::vector<BufferAllocation::Slice> results_;
   BufferAllocation::Slice scratch_;
   bool descending_;
+  int64_t batch_size_;
 };
 
 Status RunCubSort(PrimitiveType type, std::optional<PrimitiveType> value_type,
@@ -71,7 +81,14 @@ Status RunCubSort(PrimitiveType type, std::optional<PrimitiveType> value_type,
                   se::DeviceMemoryBase input_values,
                   se::DeviceMemoryBase output_keys,
                   se::DeviceMemoryBase output_values,
-                  se::DeviceMemoryBase scratch, bool descending);
+                  se::DeviceMemoryBase scratch, bool descending,
+                  int64_t batch_size = 1);
+
+// Returns the scratch size in bytes needed by `RunCubSort` to sort `num_items`
+// keys of `type` (and values of `value_type`) split into `batch_size` rows.
+StatusOr<int64_t> GetCubSortScratchSize(PrimitiveType type,
+                                        std::optional<PrimitiveType> value_type,
+                                        int64_t num_items, int64_t batch_size);
 
 }  // namespace gpu
 }  // namespace xla
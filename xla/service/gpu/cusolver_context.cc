@@ -17,6 +17,8 @@ limitations under the License.
 
 #include <algorithm>
 #include <complex>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
 #include "xla/primitive_util.h"
@@ -291,6 +293,32 @@ Status ConvertStatus(rocblas_status status) {
 #define GpuSolverZpotrfBatched GPU_SOLVER_CAT(GPU_SOLVER_PREFIX, zpotrf_batched)
 #endif
 
+#if !TENSORFLOW_USE_ROCM
+struct SyevjInfoDeleter {
+  void operator()(syevjInfo_t info) {
+    Status status = ConvertStatus(cusolverDnDestroySyevjInfo(info));
+    if (!status.ok()) {
+      LOG(ERROR) << "cusolverDnDestroySyevjInfo failed: " << status;
+    }
+  }
+};
+
+using SyevjInfo =
+    std::unique_ptr<std::remove_pointer_t<syevjInfo_t>, SyevjInfoDeleter>;
+
+// Returns the parameters of the Jacobi method, which sorts the eigenvalues.
+StatusOr<SyevjInfo> CreateSyevjInfo(int max_sweeps, double tol) {
+  syevjInfo_t info;
+  TF_RETURN_IF_ERROR(ConvertStatus(cusolverDnCreateSyevjInfo(&info)));
+  SyevjInfo result(info);
+  TF_RETURN_IF_ERROR(ConvertStatus(cusolverDnXsyevjSetTolerance(info, tol)));
+  TF_RETURN_IF_ERROR(
+      ConvertStatus(cusolverDnXsyevjSetMaxSweeps(info, max_sweeps)));
+  TF_RETURN_IF_ERROR(ConvertStatus(cusolverDnXsyevjSetSortEig(info, 1)));
+  return result;
+}
+#endif  // !TENSORFLOW_USE_ROCM
+
 }  // namespace
 
 StatusOr<GpuSolverContext> GpuSolverContext::Create() {
@@ -415,5 +443,92 @@ Status GpuSolverContext::PotrfBatched(
       ToDevicePointer(lapack_info), batch_size));
 }
 
+Status GpuSolverContext::SyevjBatched(PrimitiveType type,
+                                      se::blas::UpperLower uplo, int n,
+                                      se::DeviceMemoryBase a,
+                                      se::DeviceMemoryBase w,
+                                      se::DeviceMemoryBase workspace, int lwork,
+                                      se::DeviceMemory<int> info,
+                                      int batch_size, int max_sweeps,
+                                      double tol) {
+#if !TENSORFLOW_USE_ROCM
+  TF_ASSIGN_OR_RETURN(SyevjInfo params, CreateSyevjInfo(max_sweeps, tol));
+  cusolverEigMode_t jobz = CUSOLVER_EIG_MODE_VECTOR;
+  cublasFillMode_t fill = GpuBlasUpperLower(uplo);
+  int* lapack_info = ToDevicePointer(info);
+  switch (type) {
+    case F32:
+      return ConvertStatus(cusolverDnSsyevjBatched(
+          handle_.get(), jobz, fill, n, static_cast<float*>(a.opaque()), n,
+          static_cast<float*>(w.opaque()),
+          static_cast<float*>(workspace.opaque()), lwork, lapack_info,
+          params.get(), batch_size));
+    case F64:
+      return ConvertStatus(cusolverDnDsyevjBatched(
+          handle_.get(), jobz, fill, n, static_cast<double*>(a.opaque()), n,
+          static_cast<double*>(w.opaque()),
+          static_cast<double*>(workspace.opaque()), lwork, lapack_info,
+          params.get(), batch_size));
+    case C64:
+      return ConvertStatus(cusolverDnCheevjBatched(
+          handle_.get(), jobz, fill, n, static_cast<cuComplex*>(a.opaque()), n,
+          static_cast<float*>(w.opaque()),
+          static_cast<cuComplex*>(workspace.opaque()), lwork, lapack_info,
+          params.get(), batch_size));
+    case C128:
+      return ConvertStatus(cusolverDnZheevjBatched(
+          handle_.get(), jobz, fill, n,
+          static_cast<cuDoubleComplex*>(a.opaque()), n,
+          static_cast<double*>(w.opaque()),
+          static_cast<cuDoubleComplex*>(workspace.opaque()), lwork,
+          lapack_info, params.get(), batch_size));
+    default:
+      return InvalidArgument("Invalid type for eigendecomposition: %s",
+                             PrimitiveType_Name(type));
+  }
+#else
+  return Unimplemented("Batched eigendecomposition is not supported on ROCm");
+#endif
+}
+
+StatusOr<int64_t> GpuSolverContext::SyevjBatchedBufferSize(
+    PrimitiveType type, se::blas::UpperLower uplo, int n, int batch_size,
+    int max_sweeps, double tol) {
+#if !TENSORFLOW_USE_ROCM
+  TF_ASSIGN_OR_RETURN(SyevjInfo params, CreateSyevjInfo(max_sweeps, tol));
+  cusolverEigMode_t jobz = CUSOLVER_EIG_MODE_VECTOR;
+  cublasFillMode_t fill = GpuBlasUpperLower(uplo);
+  int size = -1;
+  switch (type) {
+    case F32:
+      TF_RETURN_IF_ERROR(ConvertStatus(cusolverDnSsyevjBatched_bufferSize(
+          handle_.get(), jobz, fill, n, /*A=*/nullptr, n, /*W=*/nullptr, &size,
+          params.get(), batch_size)));
+      break;
+    case F64:
+      TF_RETURN_IF_ERROR(ConvertStatus(cusolverDnDsyevjBatched_bufferSize(
+          handle_.get(), jobz, fill, n, /*A=*/nullptr, n, /*W=*/nullptr, &size,
+          params.get(), batch_size)));
+      break;
+    case C64:
+      TF_RETURN_IF_ERROR(ConvertStatus(cusolverDnCheevjBatched_bufferSize(
+          handle_.get(), jobz, fill, n, /*A=*/nullptr, n, /*W=*/nullptr, &size,
+          params.get(), batch_size)));
+      break;
+    case C128:
+      TF_RETURN_IF_ERROR(ConvertStatus(cusolverDnZheevjBatched_bufferSize(
+          handle_.get(), jobz, fill, n, /*A=*/nullptr, n, /*W=*/nullptr, &size,
+          params.get(), batch_size)));
+      break;
+    default:
+      return InvalidArgument("Invalid type for eigendecomposition: %s",
+                             PrimitiveType_Name(type));
+  }
+  return size;
+#else
+  return Unimplemented("Batched eigendecomposition is not supported on ROCm");
+#endif
+}
+
 }  // namespace gpu
 }  // namespace xla
@@ -94,6 +94,26 @@ class GpuSolverContext {
                                     se::blas::UpperLower uplo, int n, int lda,
                                     int batch_size);
 
+  // Computes the eigenvalues and eigenvectors of multiple n x n Hermitian
+  // matrices with the Jacobi method.  See
+  // https://docs.nvidia.com/cuda/cusolver/index.html#cuSolverDN-lt-t-gt-syevjbatch
+  //
+  // `a` holds the batch_size column-major matrices contiguously, and is
+  // overwritten with their eigenvectors.  `w` receives the eigenvalues, in
+  // ascending order.  Only implemented with cuSolver, which requires n <= 32.
+  Status SyevjBatched(PrimitiveType type, se::blas::UpperLower uplo, int n,
+                      se::DeviceMemoryBase a, se::DeviceMemoryBase w,
+                      se::DeviceMemoryBase workspace, int lwork,
+                      se::DeviceMemory<int> info, int batch_size,
+                      int max_sweeps, double tol);
+
+  // Returns the size of the `workspace` required by SyevjBatched, in number of
+  // elements of `type`.
+  StatusOr<int64_t> SyevjBatchedBufferSize(PrimitiveType type,
+                                           se::blas::UpperLower uplo, int n,
+                                           int batch_size, int max_sweeps,
+                                           double tol);
+
  private:
   explicit GpuSolverContext(gpusolverHandle_t handle);
 
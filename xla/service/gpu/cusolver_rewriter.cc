@@ -15,13 +15,19 @@ limitations under the License.
 
 #include "xla/service/gpu/cusolver_rewriter.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <functional>
+#include <limits>
 #include <numeric>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "xla/hlo/ir/dfs_hlo_visitor_with_default.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -130,18 +136,102 @@ StatusOr<HloInstruction*> CreateCholesky(GpuSolverContext* context,
   return select;
 }
 
-// Tries to rewrite a single convolution into a call to cudnn.
+// The largest matrices supported by cuSolver's syevjBatched.
+constexpr int64_t kMaxBatchedEighSize = 32;
+
+// Options of an Eigh custom call, see EighExpander.
+struct EighOptions {
+  bool lower;
+  int64_t max_iter;
+  float tol;
+};
+
+std::optional<EighOptions> ParseEighOptions(const HloInstruction* eigh) {
+  std::vector<std::string> config_strs =
+      absl::StrSplit(eigh->raw_backend_config_string(), ',');
+  int lower;
+  int sort_eigenvalues;
+  EighOptions options;
+  if (config_strs.size() != 4 || !absl::SimpleAtoi(config_strs[0], &lower) ||
+      !absl::SimpleAtoi(config_strs[1], &sort_eigenvalues) ||
+      !absl::SimpleAtoi(config_strs[2], &options.max_iter) ||
+      !absl::SimpleAtof(config_strs[3], &options.tol)) {
+    return std::nullopt;
+  }
+  // syevj always sorts the eigenvalues, which is valid whether or not they are
+  // requested to be sorted.
+  options.lower = lower;
+  return options;
+}
+
+StatusOr<HloInstruction*> CreateBatchedEigh(GpuSolverContext* context,
+                                            HloInstruction* eigh) {
+  HloComputation* computation = eigh->parent();
+  HloInstruction* operand = eigh->mutable_operand(0);
+  std::optional<EighOptions> options = ParseEighOptions(eigh);
+  TF_RET_CHECK(options.has_value());
+
+  Shape a_shape = operand->shape();
+  PrimitiveType type = a_shape.element_type();
+  int ndim = a_shape.dimensions_size();
+  int64_t n = a_shape.dimensions(ndim - 1);
+  std::vector<int64_t> batch_dims(a_shape.dimensions().begin(),
+                                  a_shape.dimensions().end() - 2);
+  int64_t batch_size = absl::c_accumulate(batch_dims, 1, std::multiplies<>{});
+  int max_sweeps = static_cast<int>(
+      std::min<int64_t>(options->max_iter, std::numeric_limits<int>::max()));
+
+  se::blas::UpperLower uplo = options->lower ? se::blas::UpperLower::kLower
+                                             : se::blas::UpperLower::kUpper;
+  TF_ASSIGN_OR_RETURN(
+      int64_t workspace_size,
+      context->SyevjBatchedBufferSize(type, uplo, n, batch_size, max_sweeps,
+                                      options->tol));
+
+  // The matrices are passed in fortran (column-major) order, and overwritten
+  // with the eigenvectors in the same order. As the matrices are Hermitian,
+  // only the meaning of `lower` would change with a row-major layout.
+  SetFortranLayout(&a_shape);
+  Shape w_shape = ShapeUtil::GetTupleElementShape(eigh->shape(), 1);
+  LayoutUtil::SetToDefaultLayout(&w_shape);
+
+  // This call returns a tuple of (v, w, workspace, info), where info contains
+  // the convergence status of each matrix. Like the HLO expansion, we return
+  // the last iterate of matrices that did not converge and ignore it.
+  Shape call_shape = ShapeUtil::MakeTupleShape(
+      {a_shape, w_shape, ShapeUtil::MakeShape(type, {workspace_size}),
+       ShapeUtil::MakeShape(S32, batch_dims)});
+  std::string opaque = absl::StrCat(
+      static_cast<int>(type), ",", static_cast<int>(options->lower), ",", n,
+      ",", batch_size, ",", workspace_size, ",", max_sweeps, ",", options->tol);
+
+  HloInstruction* custom_call =
+      computation->AddInstruction(HloInstruction::CreateCustomCall(
+          call_shape, {operand}, kCusolverSyevjBatchedCallTarget, {a_shape},
+          opaque, CustomCallApiVersion::API_VERSION_STATUS_RETURNING));
+  custom_call->set_metadata(eigh->metadata());
+  HloInstruction* v = computation->AddInstruction(
+      HloInstruction::CreateGetTupleElement(a_shape, custom_call, 0));
+  HloInstruction* w = computation->AddInstruction(
+      HloInstruction::CreateGetTupleElement(w_shape, custom_call, 1));
+  return computation->AddInstruction(HloInstruction::CreateTuple({v, w}));
+}
+
+// Tries to rewrite a single Cholesky or Eigh into a call to cuSolver.
 StatusOr<bool> RunOnInstruction(GpuSolverContext* context,
                                 HloInstruction* instruction) {
-  if (instruction->opcode() != HloOpcode::kCholesky) {
+  HloInstruction* custom_call;
+  if (instruction->opcode() == HloOpcode::kCholesky) {
+    TF_ASSIGN_OR_RETURN(
+        custom_call, CreateCholesky(context, instruction->mutable_operand(0),
+                                    instruction->cholesky_options(),
+                                    instruction->metadata()));
+  } else if (IsBatchedEighSupported(instruction)) {
+    TF_ASSIGN_OR_RETURN(custom_call, CreateBatchedEigh(context, instruction));
+  } else {
     return false;
   }
 
-  TF_ASSIGN_OR_RETURN(
-      HloInstruction * custom_call,
-      CreateCholesky(context, instruction->mutable_operand(0),
-                     instruction->cholesky_options(), instruction->metadata()));
-
   VLOG(1) << "Replacing " << instruction->ToString() << " with "
           << custom_call->ToString();
 
@@ -152,13 +242,40 @@ StatusOr<bool> RunOnInstruction(GpuSolverContext* context,
 
 }  // namespace
 
+bool IsBatchedEighSupported(const HloInstruction* hlo) {
+  if (hlo->opcode() != HloOpcode::kCustomCall ||
+      hlo->custom_call_target() != "Eigh" || hlo->operand_count() != 1 ||
+      !ParseEighOptions(hlo).has_value()) {
+    return false;
+  }
+  const Shape& shape = hlo->operand(0)->shape();
+  if (!shape.is_static() || shape.rank() < 2) {
+    return false;
+  }
+  switch (shape.element_type()) {
+    case F32:
+    case F64:
+    case C64:
+    case C128:
+      break;
+    default:
+      return false;
+  }
+  int64_t n = shape.dimensions(shape.rank() - 1);
+  if (n <= 0 || n > kMaxBatchedEighSize) {
+    return false;
+  }
+  return ShapeUtil::ElementsIn(shape) / (n * n) <=
+         std::numeric_limits<int>::max();
+}
+
 // Rewrites the convolutions in the given computation into calls to cudnn.
 // Returns true if it made any changes.
 StatusOr<bool> GpusolverRewriter::RunOnComputation(
     HloComputation* computation) {
   std::vector<HloInstruction*> cusolver_calls;
   for (auto* hlo : computation->instructions()) {
-    if (hlo->opcode() == HloOpcode::kCholesky) {
+    if (hlo->opcode() == HloOpcode::kCholesky || IsBatchedEighSupported(hlo)) {
       cusolver_calls.push_back(hlo);
     }
   }
@@ -26,7 +26,13 @@ limitations under the License.
 namespace xla {
 namespace gpu {
 
-// Rewrites Cholesky calls into CustomCall HLOs that call into cuSolver.
+// Returns true if `hlo` is an Eigh custom call of a small enough matrix to be
+// rewritten by GpusolverRewriter into a call to cuSolver's batched Jacobi
+// eigensolver.
+bool IsBatchedEighSupported(const HloInstruction* hlo);
+
+// Rewrites Cholesky calls, and the Eigh custom calls supported by
+// IsBatchedEighSupported, into CustomCall HLOs that call into cuSolver.
 class GpusolverRewriter : public HloModulePass {
  public:
   GpusolverRewriter();
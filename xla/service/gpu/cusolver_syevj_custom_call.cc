@@ -0,0 +1,163 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Implements the kCusolverSyevjBatchedCallTarget custom call, emitted by
+// GpusolverRewriter for the eigendecomposition of small Hermitian matrices.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/primitive_util.h"
+#include "xla/service/custom_call_status.h"
+#include "xla/service/custom_call_target_registry.h"
+#include "xla/service/gpu/cusolver_context.h"
+#include "xla/service/gpu/ir_emission_utils.h"
+#include "xla/status.h"
+#include "xla/stream_executor/multi_platform_manager.h"
+#include "xla/stream_executor/platform.h"
+#include "xla/stream_executor/stream.h"
+#include "xla/stream_executor/stream_executor.h"
+#include "xla/util.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// Options encoded in the opaque string by GpusolverRewriter.
+struct SyevjBatchedOptions {
+  PrimitiveType type;
+  bool lower;
+  int n;
+  int batch_size;
+  int lwork;
+  int max_sweeps;
+  double tol;
+};
+
+StatusOr<SyevjBatchedOptions> ParseOptions(absl::string_view opaque) {
+  std::vector<absl::string_view> strs = absl::StrSplit(opaque, ',');
+  int type;
+  int lower;
+  SyevjBatchedOptions options;
+  if (strs.size() != 7 || !absl::SimpleAtoi(strs[0], &type) ||
+      !absl::SimpleAtoi(strs[1], &lower) ||
+      !absl::SimpleAtoi(strs[2], &options.n) ||
+      !absl::SimpleAtoi(strs[3], &options.batch_size) ||
+      !absl::SimpleAtoi(strs[4], &options.lwork) ||
+      !absl::SimpleAtoi(strs[5], &options.max_sweeps) ||
+      !absl::SimpleAtod(strs[6], &options.tol) ||
+      !PrimitiveType_IsValid(type)) {
+    return Internal("Unable to parse options of %s, got: %s",
+                    kCusolverSyevjBatchedCallTarget, opaque);
+  }
+  options.type = static_cast<PrimitiveType>(type);
+  options.lower = lower;
+  return options;
+}
+
+// cuSolver handles are bound to a device, and can't be used concurrently with
+// different streams: we keep one per executor, used under a lock.
+struct SolverContexts {
+  absl::Mutex mu;
+  absl::flat_hash_map<se::StreamExecutor*, GpuSolverContext> contexts
+      ABSL_GUARDED_BY(mu);
+};
+
+SolverContexts& GetSolverContexts() {
+  static auto* contexts = new SolverContexts;
+  return *contexts;
+}
+
+Status RunSyevjBatched(void* stream_handle, void** buffers,
+                       absl::string_view opaque) {
+  TF_ASSIGN_OR_RETURN(SyevjBatchedOptions options, ParseOptions(opaque));
+
+  TF_ASSIGN_OR_RETURN(se::Platform * platform,
+                      se::MultiPlatformManager::PlatformWithName("CUDA"));
+  se::StreamExecutorConfig config;
+  config.gpu_stream = stream_handle;
+  TF_ASSIGN_OR_RETURN(se::StreamExecutor * executor,
+                      platform->GetExecutor(config));
+  se::Stream* stream = executor->FindAllocatedStream(stream_handle);
+  if (!stream) {
+    return InternalError("Stream not found for: %p", stream_handle);
+  }
+
+  int64_t element_size = primitive_util::ByteWidth(options.type);
+  int64_t a_size =
+      int64_t{options.batch_size} * options.n * options.n * element_size;
+  PrimitiveType w_type =
+      primitive_util::IsComplexType(options.type)
+          ? primitive_util::ComplexComponentType(options.type)
+          : options.type;
+  int64_t w_size = int64_t{options.batch_size} * options.n *
+                   primitive_util::ByteWidth(w_type);
+  se::DeviceMemoryBase a(buffers[0], a_size);
+  se::DeviceMemoryBase v(buffers[1], a_size);
+  se::DeviceMemoryBase w(buffers[2], w_size);
+  se::DeviceMemoryBase workspace(buffers[3], options.lwork * element_size);
+  se::DeviceMemory<int> info(
+      se::DeviceMemoryBase(buffers[4], options.batch_size * sizeof(int)));
+
+  // syevj overwrites the matrices with the eigenvectors.
+  if (a.opaque() != v.opaque()) {
+    stream->ThenMemcpy(&v, a, a_size);
+  }
+
+  SolverContexts& contexts = GetSolverContexts();
+  absl::MutexLock lock(&contexts.mu);
+  auto it = contexts.contexts.find(executor);
+  if (it == contexts.contexts.end()) {
+    TF_ASSIGN_OR_RETURN(GpuSolverContext context, GpuSolverContext::Create());
+    it = contexts.contexts.emplace(executor, std::move(context)).first;
+  }
+  GpuSolverContext& context = it->second;
+  TF_RETURN_IF_ERROR(context.SetStream(stream));
+  return context.SyevjBatched(
+      options.type,
+      options.lower ? se::blas::UpperLower::kLower
+                    : se::blas::UpperLower::kUpper,
+      options.n, v, w, workspace, options.lwork, info, options.batch_size,
+      options.max_sweeps, options.tol);
+}
+
+void SyevjBatchedCustomCall(void* stream_handle, void** buffers,
+                            const char* opaque, size_t opaque_len,
+                            XlaCustomCallStatus* status) {
+  Status s = RunSyevjBatched(stream_handle, buffers,
+                             absl::string_view(opaque, opaque_len));
+  if (!s.ok()) {
+    auto msg = s.message();
+    XlaCustomCallStatusSetFailure(status, msg.data(), msg.size());
+  }
+}
+
+}  // namespace
+
+XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM(kCusolverSyevjBatchedCallTarget,
+                                         SyevjBatchedCustomCall, "CUDA");
+
+}  // namespace gpu
+}  // namespace xla
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
 #include "xla/stream_executor/scratch_allocator.h"
 #include "xla/stream_executor/stream_executor.h"
 #include "xla/types.h"
@@ -67,6 +68,11 @@ std::string FftTypeToString(se::fft::Type type) {
 
 }  // namespace
 
+/*static*/ FftPlanCache* FftPlanCache::Shared() {
+  static auto* cache = new FftPlanCache();
+  return cache;
+}
+
 FftThunk::FftThunk(ThunkInfo thunk_info, FftType fft_type,
                    absl::Span<const int64_t> fft_length,
                    const BufferAllocation::Slice& input_buffer,
@@ -89,7 +95,8 @@ Status FftThunk::ExecuteOnStream(const ExecuteParams& params) {
       buffer_allocations.GetDeviceAddress(input_buffer_), input_shape_,
       buffer_allocations.GetDeviceAddress(output_buffer_), output_shape_,
       fft_type_, fft_length_, buffer_allocations.device_ordinal(),
-      &fft_plan_cache_, params.stream, buffer_allocations.memory_allocator());
+      FftPlanCache::Shared(), params.stream,
+      buffer_allocations.memory_allocator());
 }
 
 Status RunFft(se::DeviceMemoryBase input, const Shape& input_shape,
@@ -104,8 +111,12 @@ Status RunFft(se::DeviceMemoryBase input, const Shape& input_shape,
   se::OwningScratchAllocator<2> scratch_allocator(device_ordinal,
                                                   memory_allocator);
 
-  // Get the Fft plan for the given device ordinal.
-  FftPlan* fft_plan_ptr = fft_plan_cache->GetOrCreate(device_ordinal);
+  // Get the Fft plan for the given device ordinal, type, lengths and shapes.
+  FftPlan* fft_plan_ptr = fft_plan_cache->GetOrCreate(
+      device_ordinal,
+      absl::StrCat(static_cast<int>(fft_type), ";", absl::StrJoin(fft_len, ","),
+                   ";", ShapeUtil::HumanString(input_shape), ";",
+                   ShapeUtil::HumanString(output_shape)));
 
   // CuFFT thread-safety requires that separate host threads not share plans;
   // protect each plan with a mutex.
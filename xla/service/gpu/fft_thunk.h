@@ -16,7 +16,11 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_FFT_THUNK_H_
 #define XLA_SERVICE_GPU_FFT_THUNK_H_
 
+#include <memory>
 #include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "xla/hlo/ir/hlo_instruction.h"
@@ -41,18 +45,23 @@ struct FftPlan {
 
 class FftPlanCache {
  public:
-  // Returnes Fft plan cached for the given device ordinal or creates a new one.
-  FftPlan* GetOrCreate(int device_ordinal) {
+  // Returnes Fft plan cached for the given device ordinal and plan key (which
+  // identifies the FFT type, lengths and shapes) or creates a new one.
+  FftPlan* GetOrCreate(int device_ordinal, const std::string& plan_key) {
     absl::MutexLock lock(&mu_);
-    std::unique_ptr<FftPlan>& plan = fft_plans_[device_ordinal];
+    std::unique_ptr<FftPlan>& plan = fft_plans_[{device_ordinal, plan_key}];
     if (!plan) plan = std::make_unique<FftPlan>();
     return plan.get();
   }
 
+  // Returns the cache shared by all the FFT thunks of the process, so that
+  // identical FFTs in different thunks and executables share a cuFFT plan.
+  static FftPlanCache* Shared();
+
  private:
   absl::Mutex mu_;
-  absl::flat_hash_map<int, std::unique_ptr<FftPlan>> fft_plans_
-      ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::pair<int, std::string>, std::unique_ptr<FftPlan>>
+      fft_plans_ ABSL_GUARDED_BY(mu_);
 };
 
 // This class stores everything that StreamExecutor needs to launch an FFT.
@@ -69,8 +78,8 @@ class FftThunk : public Thunk {
            const BufferAllocation::Slice& output_buffer,
            const Shape& input_shape, const Shape& output_shape);
 
-  FftThunk(const FftThunk&) = delete;             // Cannot share fft_plan_
-  FftThunk& operator=(const FftThunk&) = delete;  // Cannot share fft_plan_
+  FftThunk(const FftThunk&) = delete;
+  FftThunk& operator=(const FftThunk&) = delete;
 
   // Does the FFT for the thunk on "stream".
   Status ExecuteOnStream(const ExecuteParams& params) override;
@@ -79,8 +88,6 @@ class FftThunk : public Thunk {
   const se::fft::Type fft_type_;
   const std::vector<int64_t> fft_length_;
 
-  FftPlanCache fft_plan_cache_;
-
   const BufferAllocation::Slice input_buffer_;
   const BufferAllocation::Slice output_buffer_;
 
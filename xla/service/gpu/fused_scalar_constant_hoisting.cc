@@ -0,0 +1,111 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/fused_scalar_constant_hoisting.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/shape_util.h"
+#include "xla/statusor.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// Keep in sync with the limit of VariadicOpSplitter, so that hoisting does not
+// exceed the parameter space of the kernels.
+constexpr int64_t kMaxFusionOperands = 128;
+
+bool IsReductionInitValue(const HloInstruction* constant) {
+  for (const HloInstruction* user : constant->users()) {
+    if (user->opcode() != HloOpcode::kReduce &&
+        user->opcode() != HloOpcode::kReduceWindow) {
+      continue;
+    }
+    // The init values are the second half of the operands.
+    int64_t num_inputs = user->operand_count() / 2;
+    for (int64_t i = num_inputs; i < user->operand_count(); ++i) {
+      if (user->operand(i) == constant) return true;
+    }
+  }
+  return false;
+}
+
+StatusOr<bool> HoistScalarConstants(HloFusionInstruction* fusion) {
+  if (fusion->fusion_kind() != HloInstruction::FusionKind::kLoop &&
+      fusion->fusion_kind() != HloInstruction::FusionKind::kInput) {
+    return false;
+  }
+  if (fusion->operand_count() == 0) return false;
+
+  HloComputation* computation = fusion->parent();
+  HloComputation* fused_computation = fusion->fused_instructions_computation();
+  std::vector<HloInstruction*> constants;
+  for (HloInstruction* instr : fused_computation->MakeInstructionPostOrder()) {
+    if (instr->opcode() == HloOpcode::kConstant &&
+        ShapeUtil::IsScalar(instr->shape()) &&
+        instr != fused_computation->root_instruction() &&
+        !IsReductionInitValue(instr)) {
+      constants.push_back(instr);
+    }
+  }
+  if (constants.empty() ||
+      fusion->operand_count() + constants.size() > kMaxFusionOperands) {
+    return false;
+  }
+
+  for (HloInstruction* constant : constants) {
+    HloInstruction* hoisted =
+        computation->AddInstruction(constant->Clone(), constant->name());
+    HloInstruction* parameter = fusion->AddFusionOperand(hoisted);
+    TF_RETURN_IF_ERROR(constant->ReplaceAllUsesWith(parameter));
+    TF_RETURN_IF_ERROR(fused_computation->RemoveInstruction(constant));
+  }
+  VLOG(3) << "Hoisted " << constants.size() << " scalar constants out of "
+          << fusion->name();
+  return true;
+}
+
+}  // namespace
+
+StatusOr<bool> FusedScalarConstantHoisting::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  bool changed = false;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    for (HloInstruction* instr : computation->MakeInstructionPostOrder()) {
+      if (instr->opcode() != HloOpcode::kFusion) continue;
+      TF_ASSIGN_OR_RETURN(
+          bool hoisted,
+          HoistScalarConstants(Cast<HloFusionInstruction>(instr)));
+      changed |= hoisted;
+    }
+  }
+  return changed;
+}
+
+}  // namespace gpu
+}  // namespace xla
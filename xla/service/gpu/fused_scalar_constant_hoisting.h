@@ -0,0 +1,54 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_FUSED_SCALAR_CONSTANT_HOISTING_H_
+#define XLA_SERVICE_GPU_FUSED_SCALAR_CONSTANT_HOISTING_H_
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_pass_interface.h"
+#include "xla/statusor.h"
+
+namespace xla {
+namespace gpu {
+
+// Moves the scalar constants of loop and input fusions out of the fused
+// computations, and passes them to the fusions as operands instead.
+//
+// The kernel reuse cache only shares a kernel between fusions whose fused
+// computations print identically, and fused constants are printed with their
+// values. Once the constants are kernel arguments, fusions that differ only in
+// their scalar constants compile to a single kernel.
+//
+// Constants used as reduction init values are kept, as the emitters turn those
+// into memsets. Fusions without parameters are also kept, as they may be
+// emitted as memsets as a whole.
+class FusedScalarConstantHoisting : public HloModulePass {
+ public:
+  absl::string_view name() const override {
+    return "fused-scalar-constant-hoisting";
+  }
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_FUSED_SCALAR_CONSTANT_HOISTING_H_
@@ -0,0 +1,117 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/fused_scalar_constant_hoisting.h"
+
+#include <gtest/gtest.h>
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using FusedScalarConstantHoistingTest = HloTestBase;
+
+TEST_F(FusedScalarConstantHoistingTest, FusionsDifferingInConstantsMatch) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule m
+
+fused_computation.0 {
+  p0 = f32[128] parameter(0)
+  c0 = f32[] constant(2)
+  b0 = f32[128] broadcast(c0), dimensions={}
+  ROOT m0 = f32[128] multiply(p0, b0)
+}
+
+fused_computation.1 {
+  p0 = f32[128] parameter(0)
+  c0 = f32[] constant(3)
+  b0 = f32[128] broadcast(c0), dimensions={}
+  ROOT m0 = f32[128] multiply(p0, b0)
+}
+
+ENTRY e {
+  p = f32[128] parameter(0)
+  f0 = f32[128] fusion(p), kind=kLoop, calls=fused_computation.0
+  ROOT f1 = f32[128] fusion(f0), kind=kLoop, calls=fused_computation.1
+})"));
+
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          FusedScalarConstantHoisting().Run(module.get()));
+  EXPECT_TRUE(changed);
+
+  HloInstruction* f1 = module->entry_computation()->root_instruction();
+  HloInstruction* f0 = f1->mutable_operand(0);
+  ASSERT_EQ(f0->operand_count(), 2);
+  ASSERT_EQ(f1->operand_count(), 2);
+  EXPECT_EQ(f0->operand(1)->opcode(), HloOpcode::kConstant);
+  EXPECT_EQ(f1->operand(1)->opcode(), HloOpcode::kConstant);
+  auto print_options = HloPrintOptions::Fingerprint()
+                           .set_print_only_essential_constants(false)
+                           .set_print_operand_shape(false);
+  EXPECT_EQ(f0->fused_instructions_computation()->ToString(print_options),
+            f1->fused_instructions_computation()->ToString(print_options));
+}
+
+TEST_F(FusedScalarConstantHoistingTest, KeepsReductionInitValues) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule m
+
+add {
+  a = f32[] parameter(0)
+  b = f32[] parameter(1)
+  ROOT add = f32[] add(a, b)
+}
+
+fused_computation {
+  p0 = f32[16,128] parameter(0)
+  zero = f32[] constant(0)
+  ROOT r = f32[16] reduce(p0, zero), dimensions={1}, to_apply=add
+}
+
+ENTRY e {
+  p = f32[16,128] parameter(0)
+  ROOT f = f32[16] fusion(p), kind=kInput, calls=fused_computation
+})"));
+
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          FusedScalarConstantHoisting().Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(FusedScalarConstantHoistingTest, KeepsFusionsWithoutParameters) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule m
+
+fused_computation {
+  c = f32[] constant(1)
+  ROOT b = f32[128] broadcast(c), dimensions={}
+}
+
+ENTRY e {
+  ROOT f = f32[128] fusion(), kind=kLoop, calls=fused_computation
+})"));
+
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          FusedScalarConstantHoisting().Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
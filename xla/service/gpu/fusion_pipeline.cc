@@ -28,6 +28,7 @@ limitations under the License.
 #include "xla/service/gpu/priority_fusion.h"
 #include "xla/service/gpu/variadic_op_splitter.h"
 #include "xla/service/hlo_cost_analysis.h"
+#include "xla/service/hlo_cost_analysis_cache.h"
 #include "xla/service/hlo_cse.h"
 #include "xla/service/hlo_dce.h"
 #include "xla/service/hlo_pass_fix.h"
@@ -60,8 +61,16 @@ HloPassPipeline FusionPipeline(
       shape_size_bytes_function,
       /*per_second_rates=*/{},
       /*count_multiple_input_accesses=*/true};
+  // The fusion passes run repeatedly until a fixed point, and mostly change a
+  // few instructions at a time, so they share the cost analyses.
+  auto cost_analysis_cache = std::make_shared<HloCostAnalysisCache>(
+      [cost_analysis_options, gpu_device_info] {
+        return std::make_unique<GpuHloCostAnalysis>(cost_analysis_options,
+                                                    &gpu_device_info);
+      });
   if (debug_options.xla_gpu_enable_priority_fusion()) {
-    fusion.AddPass<GpuPriorityFusion>(gpu_device_info, cost_analysis_options);
+    fusion.AddPass<GpuPriorityFusion>(gpu_device_info, cost_analysis_options,
+                                      cost_analysis_cache);
   } else {
     fusion.AddPass<GpuInstructionFusion>(/*may_duplicate=*/false,
                                          gpu_device_info);
@@ -73,8 +82,8 @@ HloPassPipeline FusionPipeline(
   // we detect as a tiled transpose fusion.
   fusion.AddPass<HloCSE>(/*is_layout_sensitive=*/true,
                          /*only_fusion_computations=*/true);
-  fusion.AddPass<GpuMultiOutputFusion>(gpu_device_info,
-                                       shape_size_bytes_function);
+  fusion.AddPass<GpuMultiOutputFusion>(
+      gpu_device_info, shape_size_bytes_function, cost_analysis_cache);
   fusion.AddPass<HloCSE>(/*is_layout_sensitive=*/true,
                          /*only_fusion_computations=*/true);
   fusion.AddPass<HloDCE>();
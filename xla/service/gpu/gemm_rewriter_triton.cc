@@ -1067,6 +1067,12 @@ DimOrderUpdatesOrError FusionContext::AnalyzeForFusionImpl(
     return "Pads are not fused yet.";
   }
   for (const HloInstruction* operand : hlo.operands()) {
+    // S4 can only be read by the emitters, which is enough to fuse the
+    // dequantization of int4 weights into the GEMM.
+    if (hlo.opcode() == HloOpcode::kConvert &&
+        operand->shape().element_type() == S4) {
+      continue;
+    }
     if (!IsTritonSupportedDataType(operand->shape().element_type(),
                                    gpu_version)) {
       return "Unsupported input data type.";
@@ -884,6 +884,26 @@ ENTRY e {
       GmockMatch(m::Fusion(m::Parameter(), m::Parameter(), m::Parameter())));
 }
 
+TEST_F(GemmRewriterTritonTest, Int4ConvertIsFused) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(R"(
+ENTRY e {
+  p0 = bf16[16,768] parameter(0)
+  p1 = s4[768,3072] parameter(1)
+  p1c = bf16[768,3072] convert(p1)
+  p2 = bf16[3072] parameter(2)
+  b = bf16[768,3072] broadcast(p2), dimensions={1}
+  w = bf16[768,3072] multiply(p1c, b)
+  ROOT r = bf16[16,3072] dot(p0, w),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+})"));
+  const se::CudaComputeCapability cc{se::CudaComputeCapability::AMPERE, 0};
+  EXPECT_TRUE(GemmRewriterTriton(cc).Run(module.get()).value());
+  EXPECT_THAT(
+      module->entry_computation()->root_instruction(),
+      GmockMatch(m::Fusion(m::Parameter(), m::Parameter(), m::Parameter())));
+}
+
 TEST_F(GemmRewriterTritonTest,
        BinaryElementwiseOfUnsupportedBroadcastIsNotFused) {
   TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
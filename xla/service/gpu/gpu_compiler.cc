@@ -28,9 +28,11 @@ limitations under the License.
 #include <variant>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
 #include "absl/types/variant.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
@@ -76,6 +78,7 @@ limitations under the License.
 #include "xla/service/comparison_expander.h"
 #include "xla/service/conditional_canonicalizer.h"
 #include "xla/service/conditional_simplifier.h"
+#include "xla/service/conditional_to_select.h"
 #include "xla/service/convert_mover.h"
 #include "xla/service/convolution_4d_expander.h"
 #include "xla/service/convolution_pred_expander.h"
@@ -102,6 +105,7 @@ limitations under the License.
 #include "xla/service/gpu/conv_layout_normalization.h"
 #include "xla/service/gpu/copy_fusion.h"
 #include "xla/service/gpu/dot_dimension_sorter.h"
+#include "xla/service/gpu/fused_scalar_constant_hoisting.h"
 #include "xla/service/gpu/fusion_pipeline.h"
 #include "xla/service/gpu/fusion_wrapper.h"
 #include "xla/service/gpu/gemm_broadcast_folding_rewriter.h"
@@ -125,6 +129,8 @@ limitations under the License.
 #include "xla/service/gpu/loop_double_buffer_transformer.h"
 #include "xla/service/gpu/matmul_utils.h"
 #include "xla/service/gpu/metrics.h"
+#include "xla/service/gpu/model/collective_combine_threshold.h"
+#include "xla/service/gpu/model/device_profile.h"
 #include "xla/service/gpu/model/gpu_cost_model_stats_collection.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/gpu/move_copy_to_users.h"
@@ -140,6 +146,7 @@ limitations under the License.
 #include "xla/service/gpu/topk_specializer.h"
 #include "xla/service/gpu/topk_splitter.h"
 #include "xla/service/gpu/tree_reduction_rewriter.h"
+#include "xla/service/hierarchical_all_to_all_decomposer.h"
 #include "xla/service/hlo.pb.h"
 #include "xla/service/hlo_computation_deduplicator.h"
 #include "xla/service/hlo_constant_folding.h"
@@ -185,6 +192,7 @@ limitations under the License.
 #include "xla/service/while_loop_constant_sinking.h"
 #include "xla/service/while_loop_simplifier.h"
 #include "xla/service/while_loop_trip_count_annotator.h"
+#include "xla/service/while_loop_unroller.h"
 #include "xla/service/zero_sized_hlo_elimination.h"
 #include "xla/status_macros.h"
 #include "xla/stream_executor/cuda/cuda_platform_id.h"
@@ -219,6 +227,10 @@ StatusOr<AutotuneConfig> GetAutotuneConfig(
     se::StreamExecutor* stream_exec, const DebugOptions& debug_options,
     const GpuCompiler::CompileOptions& options,
     const Compiler::TargetConfig& gpu_target_config) {
+  if (!debug_options.xla_gpu_shared_autotune_cache_dir().empty()) {
+    AutotunerUtil::UseResultStoreDirectory(
+        debug_options.xla_gpu_shared_autotune_cache_dir());
+  }
   if (stream_exec) {
     return AutotuneConfig{DeviceConfig{stream_exec, options.device_allocator},
                           debug_options};
@@ -275,6 +287,12 @@ namespace {
 // Adds the HloVerifier for GPU to the given pipeline.
 void AddHloVerifier(HloPassPipeline* pipeline, HloVerifierOpts&& opts = {},
                     bool debug_only = false) {
+  // Computations are verified concurrently. The thread count is capped since
+  // every pipeline owns its verifiers, and modules rarely have enough large
+  // computations to keep more threads busy.
+  constexpr int64_t kMaxVerifierThreads = 8;
+  opts.verify_parallelism =
+      std::min<int64_t>(tsl::port::MaxParallelism(), kMaxVerifierThreads);
   std::unique_ptr<TargetVerifierMetadata> verifier_metadata =
       std::make_unique<CpuGpuVerifierMetadata>(std::move(opts));
   if (debug_only) {
@@ -438,7 +456,9 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
         /*is_spmd=*/true, /*propagate_metadata=*/false,
         hlo_module->config().allow_spmd_sharding_propagation_to_output());
     spmd_pipeline.AddPass<spmd::StatefulRngSpmdPartitioner>(
-        num_partitions, hlo_module->config().replica_count());
+        num_partitions, hlo_module->config().replica_count(),
+        debug_options.xla_gpu_threshold_for_windowed_einsum_mib(),
+        debug_options.xla_gpu_unroll_windowed_einsum());
     spmd_pipeline.AddPass<CollectivePermuteMotion>();
     TF_RETURN_IF_ERROR(spmd_pipeline.Run(hlo_module).status());
   } else {
@@ -491,10 +511,14 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
     // Scatters unsupported on XLA:GPU are eliminated.
     pipeline.AddPass<GpuScatterExpander>();
 
-    // TODO(phawkins): replace QR and Eigh decompositions with calls to
-    // cuSOLVER.
+    // TODO(phawkins): replace QR decompositions with calls to cuSOLVER.
     pipeline.AddPass<QrExpander>();
-    pipeline.AddPass<EighExpander>();
+    // Eigh decompositions supported by the solver library are rewritten
+    // into library calls later on.
+    pipeline.AddPass<EighExpander>(
+        [this, &debug_options](const HloInstruction* eigh) {
+          return !KeepEighForLibraryCall(eigh, debug_options);
+        });
 
     pipeline.AddPass<DynamicIndexSplitter>();
 
@@ -551,6 +575,42 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
 
     pipeline.AddPass<DynamicPadder>(dynamic_padder_options);
 
+    // Estimates the time of computations from the rates of the device.
+    auto device_cost_analysis_options = [&] {
+      const se::DeviceDescription& device_info =
+          gpu_target_config.device_description;
+      HloCostAnalysis::Options options;
+      options.shape_size = ShapeSizeBytesFunction();
+      options.set_flops_per_second(device_info.core_count() *
+                                   device_info.fpus_per_core() *
+                                   device_info.clock_rate_ghz() *
+                                   /*fma:*/ 2 * 1e9);
+      options.set_bytes_per_second(device_info.memory_bandwidth());
+      return options;
+    };
+
+    // Executing a conditional reads the predicate on the host, so small
+    // conditionals are cheaper to execute as selects.
+    if (debug_options.xla_gpu_conditional_to_select_overhead_us() > 0) {
+      ConditionalToSelect::PredicationOptions predication_options;
+      predication_options.cost_analysis_options =
+          device_cost_analysis_options();
+      predication_options.conditional_overhead_seconds =
+          debug_options.xla_gpu_conditional_to_select_overhead_us() * 1e-6;
+      pipeline.AddPass<ConditionalToSelect>(std::move(predication_options));
+    }
+
+    // Each iteration of a while loop reads the condition on the host, so
+    // loops with short bodies are unrolled to execute fewer iterations. The
+    // unrolled bodies are then simplified and fused across iterations.
+    if (debug_options.xla_gpu_while_loop_iteration_overhead_us() > 0) {
+      WhileLoopUnroller::PartialUnrollOptions unroll_options;
+      unroll_options.cost_analysis_options = device_cost_analysis_options();
+      unroll_options.iteration_overhead_seconds =
+          debug_options.xla_gpu_while_loop_iteration_overhead_us() * 1e-6;
+      pipeline.AddPass<WhileLoopUnroller>(std::move(unroll_options));
+    }
+
     // Build simplification pipeline.  The passes in here are run to a fixed
     // point.
     [&, &pipeline =
@@ -673,6 +733,12 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
 
     collectives_pipeline.AddPass<AllGatherBroadcastReorder>();
 
+    if (debug_options.xla_gpu_all_to_all_devices_per_node() > 1) {
+      collectives_pipeline.AddPass<HierarchicalAllToAllDecomposer>(
+          debug_options.xla_gpu_all_to_all_devices_per_node(),
+          debug_options.xla_gpu_hierarchical_all_to_all_max_bytes());
+    }
+
     // promote 16 bit integer all-reduce and reduce-scatter to 32-bit.
     const std::pair<PrimitiveType, PrimitiveType> ar_promoted_types[] = {
         {U16, U32}, {S16, S32}};
@@ -737,6 +803,11 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
   const se::DeviceDescription& gpu_device_info =
       gpu_target_config.device_description;
 
+  if (!debug_options.xla_gpu_perf_model_device_profile().empty()) {
+    TF_RETURN_IF_ERROR(LoadDeviceProfiles(
+        debug_options.xla_gpu_perf_model_device_profile()));
+  }
+
   TF_RETURN_IF_ERROR(
       FusionPipeline(debug_options, ShapeSizeBytesFunction(), gpu_device_info)
           .Run(hlo_module)
@@ -757,6 +828,12 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
   TF_RETURN_IF_ERROR(
       HorizontalFusionPipeline(gpu_device_info).Run(hlo_module).status());
 
+  if (debug_options.xla_gpu_hoist_fused_scalar_constants()) {
+    HloPassPipeline pipeline("fused-scalar-constant-hoisting");
+    pipeline.AddPass<FusedScalarConstantHoisting>();
+    TF_RETURN_IF_ERROR(pipeline.Run(hlo_module).status());
+  }
+
   if (VLOG_IS_ON(2)) {
     HloFusionStatsVisitor stats;
     TF_RETURN_IF_ERROR(hlo_module->entry_computation()->Accept(&stats));
@@ -764,16 +841,43 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
   }
 
   {
+    int64_t all_gather_combine_threshold =
+        debug_options.xla_gpu_all_gather_combine_threshold_bytes();
+    int64_t all_reduce_combine_threshold =
+        debug_options.xla_gpu_all_reduce_combine_threshold_bytes();
+    int64_t reduce_scatter_combine_threshold =
+        debug_options.xla_gpu_reduce_scatter_combine_threshold_bytes();
+    if (debug_options.xla_gpu_enable_auto_combine_thresholds()) {
+      GpuHloCostAnalysis::Options cost_analysis_options{
+          ShapeSizeBytesFunction(),
+          /*per_second_rates=*/{},
+          /*count_multiple_input_accesses=*/true};
+      TF_ASSIGN_OR_RETURN(
+          all_gather_combine_threshold,
+          ComputeCombineThresholdInBytes(
+              *hlo_module, HloOpcode::kAllGather, gpu_device_info,
+              cost_analysis_options, all_gather_combine_threshold));
+      TF_ASSIGN_OR_RETURN(
+          all_reduce_combine_threshold,
+          ComputeCombineThresholdInBytes(
+              *hlo_module, HloOpcode::kAllReduce, gpu_device_info,
+              cost_analysis_options, all_reduce_combine_threshold));
+      TF_ASSIGN_OR_RETURN(
+          reduce_scatter_combine_threshold,
+          ComputeCombineThresholdInBytes(
+              *hlo_module, HloOpcode::kReduceScatter, gpu_device_info,
+              cost_analysis_options, reduce_scatter_combine_threshold));
+    }
+
     HloPassPipeline pipeline("post-fusion optimization");
     pipeline.AddPass<AllGatherCombiner>(
-        debug_options.xla_gpu_all_gather_combine_threshold_bytes(),
+        all_gather_combine_threshold,
         /*combine_threshold_count=*/256,
         debug_options.xla_gpu_enable_all_gather_combine_by_dim());
-    pipeline.AddPass<AllReduceCombiner>(
-        debug_options.xla_gpu_all_reduce_combine_threshold_bytes(),
-        /*combine_threshold_count=*/256);
+    pipeline.AddPass<AllReduceCombiner>(all_reduce_combine_threshold,
+                                        /*combine_threshold_count=*/256);
     pipeline.AddPass<ReduceScatterCombiner>(
-        debug_options.xla_gpu_reduce_scatter_combine_threshold_bytes(),
+        reduce_scatter_combine_threshold,
         /*combine_threshold_count=*/256,
         debug_options.xla_gpu_enable_reduce_scatter_combine_by_dim());
 
@@ -784,7 +888,9 @@ Status GpuCompiler::OptimizeHloModule(HloModule* hlo_module,
     int32_t blueconnect_num_devices_per_host =
         debug_options.xla_gpu_all_reduce_blueconnect_num_devices_per_host();
     if (blueconnect_num_devices_per_host > 0) {
-      pipeline.AddPass<AllReduceBlueConnect>(blueconnect_num_devices_per_host);
+      pipeline.AddPass<AllReduceBlueConnect>(
+          blueconnect_num_devices_per_host,
+          debug_options.xla_gpu_all_reduce_blueconnect_min_decompose_bytes());
     }
 
     if (debug_options.xla_gpu_enable_while_loop_double_buffering()) {
@@ -1059,6 +1165,21 @@ StatusOr<std::unique_ptr<HloModule>> GpuCompiler::RunHloPasses(
       MaybeUploadUnoptimizedGpuSymbols(module.get(),
                                        gpu_target_config.ToProto());
 
+  // Autotuning compilations are one-off variants that aren't worth keeping.
+  std::optional<std::string> incremental_compilation_key;
+  if (module->config()
+          .debug_options()
+          .xla_gpu_enable_incremental_compilation() &&
+      !options.is_autotuning_compilation) {
+    incremental_compilation_key = IncrementalCompilationCache::GetHloKey(
+        *module, gpu_target_config.ToProto());
+    if (std::unique_ptr<HloModule> optimized_module =
+            incremental_compilation_cache_.LookupOptimizedModule(
+                *incremental_compilation_key, module->name())) {
+      return std::move(optimized_module);
+    }
+  }
+
   // We dump the post-optimization HLO in RunBackend so no need to dump it here.
   XLA_SCOPED_LOGGING_TIMER_IF(
       absl::StrCat("GpuCompiler::RunHloPasses for ", module->name()),
@@ -1091,6 +1212,10 @@ StatusOr<std::unique_ptr<HloModule>> GpuCompiler::RunHloPasses(
     TF_RETURN_IF_ERROR(
         SerializeAutotuneResultsToFile(module->config().debug_options()));
   }
+  if (incremental_compilation_key.has_value()) {
+    incremental_compilation_cache_.InsertOptimizedModule(
+        *incremental_compilation_key, *module);
+  }
 
   return std::move(module);
 }
@@ -1248,6 +1373,22 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
                                  FilenameFor(*debug_module, "", ""), "*")
                   : ".");
     }
+    // The key has to be computed before CompileTargetBinary optimizes the
+    // module in place. A hit returns before dumping, as the module was never
+    // optimized.
+    std::optional<std::string> incremental_compilation_key;
+    if (module_config.debug_options()
+            .xla_gpu_enable_incremental_compilation() &&
+        !options.is_autotuning_compilation) {
+      incremental_compilation_key = IncrementalCompilationCache::GetBinaryKey(
+          *llvm_module, gpu_version, relocatable, module_config);
+      if (std::optional<BackendCompileResult> cached =
+              incremental_compilation_cache_.LookupBinary(
+                  *incremental_compilation_key)) {
+        return *std::move(cached);
+      }
+    }
+
     StatusOr<std::pair<std::string, std::vector<uint8_t>>> result =
         CompileTargetBinary(module_config, llvm_module, gpu_version,
                             relocatable, debug_module, options);
@@ -1255,6 +1396,10 @@ GpuCompiler::CompileToTargetBinary(const HloModuleConfig& module_config,
     if (!result.ok()) {
       return result;
     }
+    if (incremental_compilation_key.has_value()) {
+      incremental_compilation_cache_.InsertBinary(*incremental_compilation_key,
+                                                  *result);
+    }
 
     const bool should_dump =
         DumpingEnabledForHloModule(debug_module ? debug_module->name() : "",
@@ -1513,6 +1658,39 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
   llvm_ir::DumpIrIfEnabled(*module, *compile_module_results.llvm_module,
                            /*optimized=*/false);
 
+  // The protos attached to the executable for debugging don't depend on the
+  // compiled kernels, so they are built on the thread pool (if any) while the
+  // kernels are compiled. Serializing large modules is not free.
+  std::shared_ptr<const BufferAssignment> buffer_assignment;
+  std::unique_ptr<BufferAssignmentProto> buffer_assignment_proto;
+  std::unique_ptr<HloProto> hlo_proto;
+  absl::Notification debug_protos_built;
+  bool building_debug_protos = false;
+  if (!options.is_autotuning_compilation) {
+    // Make it shared to be captured in the later lambda.
+    buffer_assignment = std::move(compile_module_results.buffer_assignment);
+    auto build_debug_protos = [&] {
+      buffer_assignment_proto =
+          std::make_unique<BufferAssignmentProto>(buffer_assignment->ToProto());
+      // Dump computation proto state and buffer assignment for
+      // CompiledMemoryAnalysis.
+      hlo_proto = std::make_unique<HloProto>();
+      *hlo_proto->mutable_hlo_module() = module->ToProto();
+      *hlo_proto->mutable_buffer_assignment() = *buffer_assignment_proto;
+      debug_protos_built.Notify();
+    };
+    building_debug_protos = true;
+    if (options.thread_pool != nullptr) {
+      options.thread_pool->Schedule(build_debug_protos);
+    } else {
+      build_debug_protos();
+    }
+  }
+  // The task refers to the locals above, so wait for it on all paths.
+  absl::Cleanup wait_for_debug_protos = [&] {
+    if (building_debug_protos) debug_protos_built.WaitForNotification();
+  };
+
   std::string asm_text;
   std::vector<uint8_t> binary;
   TF_ASSIGN_OR_RETURN(
@@ -1532,16 +1710,11 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
                             thunk_sequence.ToString());
   }
 
-  std::shared_ptr<const BufferAssignment> buffer_assignment;
-  std::unique_ptr<BufferAssignmentProto> buffer_assignment_proto;
+  std::move(wait_for_debug_protos).Invoke();
   std::function<std::string()> buffer_assignment_dumper = [] {
     return std::string();
   };
   if (!options.is_autotuning_compilation) {
-    // Make it shared to be captured in the later lambda.
-    buffer_assignment = std::move(compile_module_results.buffer_assignment);
-    buffer_assignment_proto =
-        std::make_unique<BufferAssignmentProto>(buffer_assignment->ToProto());
     size_t max_buffers_to_show =
         module->config().debug_options().xla_debug_buffer_assignment_show_max();
     buffer_assignment_dumper = [buffer_assignment, max_buffers_to_show] {
@@ -1549,6 +1722,9 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
     };
   }
 
+  // Read before `module` is moved into the executable.
+  const int64_t num_temp_buffer_arenas =
+      module->config().debug_options().xla_gpu_temp_buffer_arenas();
   TF_ASSIGN_OR_RETURN(
       auto gpu_executable,
       GpuExecutable::Create(GpuExecutable::Params{
@@ -1575,7 +1751,8 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
           /*debug_module=*/options.is_autotuning_compilation
               ? std::unique_ptr<HloModule>()
               : std::move(module),
-          /*enable_debug_info_manager=*/!options.is_autotuning_compilation}));
+          /*enable_debug_info_manager=*/!options.is_autotuning_compilation,
+          /*num_temp_buffer_arenas=*/num_temp_buffer_arenas}));
   if (embed_ir_in_executable) {
     DCHECK_NE("", ir_module_string_before_opt);
     gpu_executable->set_ir_module_string(ir_module_string_before_opt);
@@ -1584,11 +1761,6 @@ StatusOr<std::unique_ptr<Executable>> GpuCompiler::RunBackend(
   IncrementCompiledProgramsCount();
 
   if (!options.is_autotuning_compilation && gpu_executable->has_module()) {
-    // Dump computation proto state and buffer assignment for
-    // CompiledMemoryAnalysis.
-    auto hlo_proto = std::make_unique<HloProto>();
-    *hlo_proto->mutable_hlo_module() = gpu_executable->module().ToProto();
-    *hlo_proto->mutable_buffer_assignment() = buffer_assignment->ToProto();
     gpu_executable->set_hlo_proto(std::move(hlo_proto));
     gpu_executable->set_debug_info(buffer_assignment->GetStats().ToString());
   }
@@ -30,6 +30,7 @@ limitations under the License.
 #include "xla/service/gpu/buffer_sharing.h"
 #include "xla/service/gpu/executable.pb.h"
 #include "xla/service/gpu/gpu_executable.h"
+#include "xla/service/gpu/incremental_compilation_cache.h"
 #include "xla/service/hlo.pb.h"
 #include "xla/service/hlo_dataflow_analysis.h"
 #include "xla/service/hlo_pass_pipeline.h"
@@ -203,6 +204,14 @@ class GpuCompiler : public LLVMCompiler {
       se::dnn::VersionInfo dnn_version,
       se::DeviceMemoryAllocator* device_allocator) = 0;
 
+  // Returns true if the Eigh custom call `eigh` is kept for
+  // OptimizeHloConvolutionCanonicalization to rewrite into a solver library
+  // call, instead of being expanded into HLO.
+  virtual bool KeepEighForLibraryCall(const HloInstruction* eigh,
+                                      const DebugOptions& debug_options) const {
+    return false;
+  }
+
   virtual HloDataflowAnalysis::CanShareBuffer GetCanShareBuffer() const {
     return &FusionCanShareBufferHint;
   }
@@ -240,6 +249,10 @@ class GpuCompiler : public LLVMCompiler {
   // The size in bytes of a pointer. Used by ShapeSizeBytesFunction.
   const int64_t pointer_size_;
 
+  // Results of earlier compilations, used if
+  // --xla_gpu_enable_incremental_compilation is set.
+  IncrementalCompilationCache incremental_compilation_cache_;
+
   GpuCompiler(const GpuCompiler&) = delete;
   GpuCompiler& operator=(const GpuCompiler&) = delete;
 };
@@ -15,10 +15,16 @@ limitations under the License.
 
 #include "xla/service/gpu/gpu_conv_runner.h"
 
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/base/const_init.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/layout_util.h"
 #include "xla/service/gpu/backend_configs.pb.h"
 #include "xla/service/gpu/stream_executor_util.h"
@@ -313,8 +319,50 @@ int64_t GetVectCSize(FilterLayout layout) {
   }
 }
 
+// Returns a string identifying the cuDNN plans built for `config`.
+std::string GetConvRunnerKey(const GpuConvConfig& config) {
+  std::string key = absl::StrCat(
+      CudnnConvKindToString(config.kind), ";",
+      PrimitiveType_Name(config.input_type), ";",
+      PrimitiveType_Name(config.output_type), ";",
+      config.algorithm.ToString(), ";",
+      config.algorithm.workspace_size().value_or(0), ";",
+      config.conv_result_scale, ";", config.input_descriptor.ToString(), ";",
+      config.filter_descriptor.ToString(), ";",
+      config.output_descriptor.ToString(), ";",
+      config.conv_desc.ToProto().SerializeAsString(), ";",
+      config.bias_descriptor.ToString(), ";",
+      ShapeUtil::HumanStringWithLayout(config.input_shape), ";",
+      ShapeUtil::HumanStringWithLayout(config.filter_shape), ";",
+      ShapeUtil::HumanStringWithLayout(config.output_shape), ";",
+      config.serialized_graph);
+  if (config.fusion) {
+    absl::StrAppend(&key, ";",
+                    se::dnn::ActivationModeString(config.fusion->mode), ";",
+                    config.fusion->side_input_scale, ";",
+                    config.fusion->leakyrelu_alpha);
+  }
+  return key;
+}
+
 }  // anonymous namespace
 
+GenericConvRunner& GetSharedConvRunner(const GpuConvConfig& config,
+                                       se::StreamExecutor* executor) {
+  static absl::Mutex mu(absl::kConstInit);
+  static auto* runners ABSL_GUARDED_BY(mu) =
+      new absl::flat_hash_map<std::pair<se::StreamExecutor*, std::string>,
+                              std::unique_ptr<GenericConvRunner>>();
+
+  auto key = std::make_pair(executor, GetConvRunnerKey(config));
+  absl::MutexLock lock(&mu);
+  std::unique_ptr<GenericConvRunner>& runner = (*runners)[std::move(key)];
+  if (runner == nullptr) {
+    runner = std::make_unique<GenericConvRunner>(config);
+  }
+  return *runner;
+}
+
 StatusOr<GpuConvConfig> GetGpuConvConfig(
     const GpuConvDescriptor& desc, const absl::string_view inst_as_string) {
   GpuConvConfig config;
@@ -220,6 +220,13 @@ Status RunGpuConv(const GpuConvConfig& conv_config,
                   se::DeviceMemoryBase scratch_memory, se::Stream* stream,
                   RunConvOptions = {});
 
+// Returns the runner of `config` on `executor`, shared by all the convolutions
+// with the same config in the process, so that the cuDNN plan of identical
+// convolutions is built once across thunks and executables. Runners are thread
+// safe and live until the end of the process.
+GenericConvRunner& GetSharedConvRunner(const GpuConvConfig& config,
+                                       se::StreamExecutor* executor);
+
 // Struct to describe properties of a convolution without being tied to specific
 // IR. Will be used to help build Convolution thunks from either XLA HLO or
 // LHLO GPU dialect in MLIR.
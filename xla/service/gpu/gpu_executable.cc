@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/gpu/gpu_executable.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -26,10 +27,13 @@ limitations under the License.
 #include <variant>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "mlir/Parser/Parser.h"  // from @llvm-project
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/map_util.h"
@@ -39,11 +43,17 @@ limitations under the License.
 #include "xla/runtime/executable.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/gpu/buffer_allocations.h"
+#include "xla/service/gpu/conditional_thunk.h"
 #include "xla/service/gpu/gpu_constants.h"
+#include "xla/service/gpu/nccl_collective_thunk.h"
+#include "xla/service/gpu/nccl_group_thunk.h"
 #include "xla/service/gpu/non_atomically_upgradeable_rw_lock.h"
 #include "xla/service/gpu/runtime/executable.h"
+#include "xla/service/gpu/sequential_thunk.h"
 #include "xla/service/gpu/stream_executor_util.h"
 #include "xla/service/gpu/thunk.h"
+#include "xla/service/gpu/thunk_stream_assignment.h"
+#include "xla/service/gpu/while_thunk.h"
 #include "xla/service/hlo_parser.h"
 #include "xla/service/shaped_buffer.h"
 #include "xla/service/stream_pool.h"
@@ -104,6 +114,17 @@ StatusOr<std::unique_ptr<GpuExecutable>> GpuExecutable::Create(Params params) {
 
   if (std::holds_alternative<OwnedThunkSequence>(executable)) {
     result->thunks_ = std::move(std::get<OwnedThunkSequence>(executable));
+    int num_thunk_streams =
+        result->has_module() ? result->module_config()
+                                   .debug_options()
+                                   .xla_gpu_num_thunk_streams()
+                             : 1;
+    if (num_thunk_streams > 1) {
+      result->thunk_stream_assignment_ =
+          AssignThunkStreams(*result->thunks_, num_thunk_streams);
+      VLOG(2) << "Assigned the thunks of " << result->module_name_ << " to "
+              << result->thunk_stream_assignment_->num_streams << " streams";
+    }
     return result;
   }
 
@@ -130,6 +151,7 @@ GpuExecutable::GpuExecutable(GpuExecutable::Params params)
       output_shape_(params.output_shape),
       allocations_(std::move(params.allocations)),
       enable_persistent_temp_buffers_(params.enable_persistent_temp_buffers),
+      num_temp_buffer_arenas_(params.num_temp_buffer_arenas),
       debug_buffer_assignment_(std::move(params.debug_buffer_assignment)),
       verbose_buffer_assignment_string_dumper_(
           params.verbose_buffer_assignment_string_dumper),
@@ -197,12 +219,56 @@ namespace {
 Status MaybeSyncAndProfile(const ServiceExecutableRunOptions* run_options,
                            uint64_t start_nanos, se::Stream* stream_to_sync);
 
+// Appends the collective thunks of `thunks` to `collectives` in execution
+// order, including the ones nested in control flow and in groups.
+void CollectNcclCollectiveThunks(
+    const ThunkSequence& thunks,
+    std::vector<const NcclCollectiveThunk*>& collectives) {
+  for (const std::unique_ptr<Thunk>& thunk : thunks) {
+    if (auto* collective =
+            dynamic_cast<const NcclCollectiveThunk*>(thunk.get())) {
+      collectives.push_back(collective);
+      continue;
+    }
+    switch (thunk->kind()) {
+      case Thunk::kConditional:
+        for (const std::unique_ptr<SequentialThunk>& branch :
+             static_cast<ConditionalThunk*>(thunk.get())->branch_thunks()) {
+          CollectNcclCollectiveThunks(branch->thunks(), collectives);
+        }
+        break;
+      case Thunk::kNcclGroup:
+        CollectNcclCollectiveThunks(
+            static_cast<const NcclGroupThunk*>(thunk.get())->thunks(),
+            collectives);
+        break;
+      case Thunk::kSequential:
+        CollectNcclCollectiveThunks(
+            static_cast<const SequentialThunk*>(thunk.get())->thunks(),
+            collectives);
+        break;
+      case Thunk::kWhile: {
+        auto* while_thunk = static_cast<WhileThunk*>(thunk.get());
+        CollectNcclCollectiveThunks(
+            while_thunk->condition_thunk_sequence()->thunks(), collectives);
+        CollectNcclCollectiveThunks(
+            while_thunk->body_thunk_sequence()->thunks(), collectives);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+}
+
 Status ExecuteThunks(const std::string& module_name, ModuleIdentifier module_id,
                      const ThunkSequence& thunk_sequence,
                      const ServiceExecutableRunOptions* run_options,
                      const BufferAllocations& buffer_allocations,
                      bool block_host_until_done,
-                     bool use_highest_priority_for_async_stream) {
+                     bool use_highest_priority_for_async_stream,
+                     bool initialize_nccl_comms,
+                     const ThunkStreamAssignment* stream_assignment) {
   se::Stream* main_stream = run_options->stream();
   se::StreamExecutor* executor = main_stream->parent();
   stream_executor::StreamPriority stream_priority =
@@ -221,6 +287,30 @@ Status ExecuteThunks(const std::string& module_name, ModuleIdentifier module_id,
       async_comms_streams[i] = streams->at(i).get();
     }
   }
+
+  // Borrow the streams that the thunks are assigned to, in addition to the
+  // main stream. If they can't be borrowed, all thunks run on the main stream.
+  std::vector<StreamPool::Ptr> borrowed_streams;
+  std::vector<se::Stream*> thunk_streams = {main_stream};
+  if (stream_assignment != nullptr && stream_assignment->num_streams > 1) {
+    StatusOr<std::vector<StreamPool::Ptr>> borrowed =
+        run_options->BorrowStreams(executor->device_ordinal(),
+                                   stream_assignment->num_streams - 1);
+    if (borrowed.ok()) {
+      borrowed_streams = std::move(borrowed).value();
+      for (StreamPool::Ptr& stream : borrowed_streams) {
+        // The thunks depend on the work launched before the executable.
+        stream->ThenWaitFor(main_stream);
+        thunk_streams.push_back(stream.get());
+      }
+    } else {
+      VLOG(1) << "Running all thunks on the main stream: "
+              << borrowed.status();
+      stream_assignment = nullptr;
+    }
+  } else {
+    stream_assignment = nullptr;
+  }
   uint64_t start_nanos = tsl::Env::Default()->NowNanos();
 
   tsl::profiler::TraceMe hlo_module_activity(
@@ -236,22 +326,50 @@ Status ExecuteThunks(const std::string& module_name, ModuleIdentifier module_id,
                            module_id_str);
   });
 
-  for (const std::unique_ptr<Thunk>& thunk : thunk_sequence) {
-    // Annotate execution of this op if tracing was enabled when we started
-    // running this module.  If tracing is enabled *while* we're running the
-    // module, we won't get any data, but that's probably an OK trade-off.
-    ScopedAnnotation annotation([&] { return thunk->profile_annotation(); });
-    VLOG(2) << "Executing the thunk for " << thunk->profile_annotation();
-    if (NeedsAsyncCommsStream(*thunk)) {
-      for (se::Stream* async_stream : async_comms_streams) {
-        TF_RET_CHECK(async_stream != nullptr)
-            << "`run_options` must have a stream borrower for async thunks.";
-      }
-    }
-
+  if (initialize_nccl_comms) {
+    std::vector<const NcclCollectiveThunk*> collectives;
+    CollectNcclCollectiveThunks(thunk_sequence, collectives);
     Thunk::ExecuteParams thunk_params{*run_options, buffer_allocations,
                                       main_stream, async_comms_streams};
-    TF_RETURN_IF_ERROR(thunk->ExecuteOnStream(thunk_params));
+    TF_RETURN_IF_ERROR(NcclCollectiveThunk::InitializeCommunicators(
+        thunk_params, collectives));
+  }
+
+  {
+    // The main stream waits for the work of the borrowed streams, including
+    // when a thunk fails.
+    absl::Cleanup join_streams = [&] {
+      for (size_t i = 1; i < thunk_streams.size(); ++i) {
+        main_stream->ThenWaitFor(thunk_streams[i]);
+      }
+    };
+
+    for (size_t i = 0; i < thunk_sequence.size(); ++i) {
+      const std::unique_ptr<Thunk>& thunk = thunk_sequence[i];
+      // Annotate execution of this op if tracing was enabled when we started
+      // running this module.  If tracing is enabled *while* we're running the
+      // module, we won't get any data, but that's probably an OK trade-off.
+      ScopedAnnotation annotation([&] { return thunk->profile_annotation(); });
+      VLOG(2) << "Executing the thunk for " << thunk->profile_annotation();
+      if (NeedsAsyncCommsStream(*thunk)) {
+        for (se::Stream* async_stream : async_comms_streams) {
+          TF_RET_CHECK(async_stream != nullptr)
+              << "`run_options` must have a stream borrower for async thunks.";
+        }
+      }
+
+      se::Stream* stream = main_stream;
+      if (stream_assignment != nullptr) {
+        stream = thunk_streams[stream_assignment->streams[i]];
+        for (int wait : stream_assignment->waits[i]) {
+          stream->ThenWaitFor(thunk_streams[wait]);
+        }
+      }
+
+      Thunk::ExecuteParams thunk_params{*run_options, buffer_allocations,
+                                        stream, async_comms_streams};
+      TF_RETURN_IF_ERROR(thunk->ExecuteOnStream(thunk_params));
+    }
   }
   return MaybeSyncAndProfile(run_options, start_nanos,
                              block_host_until_done ? main_stream : nullptr);
@@ -449,6 +567,20 @@ static Status CheckAlignment(const BufferAllocation& allocation,
   return OkStatus();
 }
 
+uint64_t GpuExecutable::GetBufferAddressesId(
+    se::StreamExecutor* executor, const BufferAllocations& buffer_allocations) {
+  static std::atomic<uint64_t> next_addresses_id{1};
+
+  absl::MutexLock lock(&last_buffer_addresses_mu_);
+  BufferAddresses& last = last_buffer_addresses_[executor];
+  if (last.id == 0 || !buffer_allocations.HasSameAddresses(last.buffers)) {
+    last.buffers.assign(buffer_allocations.buffers().begin(),
+                        buffer_allocations.buffers().end());
+    last.id = next_addresses_id.fetch_add(1, std::memory_order_relaxed);
+  }
+  return last.id;
+}
+
 StatusOr<BufferAllocations> GpuExecutable::GenerateBufferAllocations(
     VariantArguments arguments,
     const GpuExecutable::BufferAllocToDeviceMemoryMap* globals,
@@ -555,6 +687,82 @@ Status GpuExecutable::PopulatePersistentTempBuffers(
   return OkStatus();
 }
 
+GpuExecutable::TempBufferArena::~TempBufferArena() {
+  // The last run using the arena may still be running.
+  if (done_event != nullptr) {
+    while (done_event->PollForStatus() == se::Event::Status::kPending) {
+      absl::SleepFor(absl::Microseconds(100));
+    }
+  }
+  for (auto& [index, buffer] : buffers) {
+    executor->Deallocate(&buffer);
+  }
+}
+
+std::unique_ptr<GpuExecutable::TempBufferArena>
+GpuExecutable::AcquireTempBufferArena(
+    const ServiceExecutableRunOptions* run_options) {
+  se::Stream* stream = run_options->stream();
+  se::StreamExecutor* executor = stream->parent();
+  std::unique_ptr<TempBufferArena> arena;
+  {
+    absl::MutexLock lock(&temp_buffer_arenas_mu_);
+    TempBufferArenaPool& pool = temp_buffer_arenas_[executor];
+    if (!pool.available.empty()) {
+      arena = std::move(pool.available.back());
+      pool.available.pop_back();
+    } else if (pool.num_arenas < num_temp_buffer_arenas_) {
+      ++pool.num_arenas;
+    } else {
+      VLOG(3) << "All " << pool.num_arenas << " temp buffer arenas of "
+              << module_name_ << " are in use";
+      return nullptr;
+    }
+  }
+
+  if (arena != nullptr) {
+    // The buffers may still be used by the previous run on another stream.
+    stream->ThenWaitFor(arena->done_event.get());
+    return arena;
+  }
+
+  // Allocate the buffers of a new arena outside of the lock, since the
+  // allocations can be slow. They are allocated from the executor, like
+  // persistent temp buffers, as the allocator of the run may not outlive the
+  // executable.
+  arena = std::make_unique<TempBufferArena>();
+  arena->executor = executor;
+  for (const BufferAllocation& allocation : allocations_) {
+    if (!allocation.IsPreallocatedTempBuffer() || allocation.size() == 0) {
+      continue;
+    }
+    se::DeviceMemoryBase buffer =
+        executor->AllocateArray<uint8_t>(allocation.size());
+    if (buffer.is_null()) {
+      VLOG(1) << "Failed to allocate " << allocation.size()
+              << " bytes for a temp buffer arena";
+      absl::MutexLock lock(&temp_buffer_arenas_mu_);
+      --temp_buffer_arenas_[executor].num_arenas;
+      return nullptr;
+    }
+    arena->buffers[allocation.index()] = buffer;
+  }
+  arena->done_event = std::make_unique<se::Event>(executor);
+  if (!arena->done_event->Init()) {
+    absl::MutexLock lock(&temp_buffer_arenas_mu_);
+    --temp_buffer_arenas_[executor].num_arenas;
+    return nullptr;
+  }
+  return arena;
+}
+
+void GpuExecutable::ReleaseTempBufferArena(
+    se::Stream* stream, std::unique_ptr<TempBufferArena> arena) {
+  stream->ThenRecordEvent(arena->done_event.get());
+  absl::MutexLock lock(&temp_buffer_arenas_mu_);
+  temp_buffer_arenas_[stream->parent()].available.push_back(std::move(arena));
+}
+
 StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStreamImpl(
     const ServiceExecutableRunOptions* run_options,
     VariantArguments arguments) {
@@ -585,6 +793,22 @@ StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStreamImpl(
     persistent_buffers_map = persistent_temp_buffers_[executor];
   }
 
+  // Otherwise lease a set of temp buffers that are reused across runs, but not
+  // by concurrent runs. It is released once the work of this run is enqueued.
+  std::unique_ptr<TempBufferArena> temp_buffer_arena;
+  if (!enable_persistent_temp_buffers_ && num_temp_buffer_arenas_ > 0) {
+    temp_buffer_arena = AcquireTempBufferArena(run_options);
+    if (temp_buffer_arena != nullptr) {
+      persistent_buffers_map = temp_buffer_arena->buffers;
+    }
+  }
+  absl::Cleanup release_temp_buffer_arena = [&] {
+    if (temp_buffer_arena != nullptr) {
+      ReleaseTempBufferArena(run_options->stream(),
+                             std::move(temp_buffer_arena));
+    }
+  };
+
   // Force synchronous execution if the allocator requires it.
   const bool block_host_until_done =
       !memory_allocator->AllowsAsynchronousDeallocation();
@@ -730,6 +954,12 @@ StatusOr<ExecutionOutput> GpuExecutable::ExecuteAsyncOnStreamImpl(
     buffers_in_result.insert(result_buffer);
   }
 
+  // Thunks reuse what they computed from the buffer addresses if they are the
+  // same as in the previous run, e.g. when temp buffers are persistent or the
+  // allocator returns the same buffers.
+  buffer_allocations.set_addresses_id(
+      GetBufferAddressesId(executor, buffer_allocations));
+
   TF_RETURN_IF_ERROR(ExecuteThunksOrXlaRuntime(
       run_options, buffer_allocations, block_host_until_done, gpu_lock));
 
@@ -770,6 +1000,14 @@ Status GpuExecutable::ExecuteThunksOrXlaRuntime(
       TF_RETURN_IF_ERROR(thunk->Initialize(executor, executable_source));
     }
 
+    bool initialize_nccl_comms = false;
+    if (has_module() && module_config()
+                            .debug_options()
+                            .xla_gpu_enable_eager_nccl_comm_init()) {
+      absl::MutexLock lock(&nccl_comms_initialized_mu_);
+      initialize_nccl_comms = nccl_comms_initialized_.insert(executor).second;
+    }
+
     return ExecuteThunks(
         module_name_, unique_id, *thunks_, run_options, buffer_allocations,
         block_host_until_done,
@@ -777,7 +1015,9 @@ Status GpuExecutable::ExecuteThunksOrXlaRuntime(
         has_module() ? module_config()
                            .debug_options()
                            .xla_gpu_enable_highest_priority_async_stream()
-                     : false);
+                     : false,
+        initialize_nccl_comms,
+        thunk_stream_assignment_ ? &*thunk_stream_assignment_ : nullptr);
   }
 
   // Match IrEmitter's temp buffer allocation for kernel launches. See
@@ -28,6 +28,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
@@ -39,11 +40,13 @@ limitations under the License.
 #include "xla/service/gpu/non_atomically_upgradeable_rw_lock.h"
 #include "xla/service/gpu/runtime/executable.h"
 #include "xla/service/gpu/thunk.h"
+#include "xla/service/gpu/thunk_stream_assignment.h"
 #include "xla/service/hlo_execution_profile.h"
 #include "xla/service/shaped_buffer.h"
 #include "xla/statusor.h"
 #include "xla/stream_executor/device_description.h"
 #include "xla/stream_executor/device_memory_allocator.h"
+#include "xla/stream_executor/event.h"
 #include "xla/stream_executor/stream_executor.h"
 
 namespace xla {
@@ -106,6 +109,11 @@ class GpuExecutable : public Executable {
 
     std::unique_ptr<HloModule> debug_module = nullptr;
     bool enable_debug_info_manager = true;
+
+    // The maximum number of sets of temp buffers kept for each executor and
+    // reused by the runs of the executable. 0 allocates the temp buffers for
+    // each run.
+    int64_t num_temp_buffer_arenas = 0;
   };
 
   // Analyze the entry function to construct buffer allocation and other output
@@ -195,6 +203,9 @@ class GpuExecutable : public Executable {
 
   const std::vector<ConstantInfo>& constants() const { return constants_; }
 
+  // Returns the thunks of an executable that doesn't use the XLA runtime.
+  const ThunkSequence& GetThunk() const { return *thunks_; }
+
   xla::EntryFunctionAttributes entry_func_attrs() const {
     return entry_func_attrs_;
   }
@@ -237,11 +248,38 @@ class GpuExecutable : public Executable {
   Status PopulatePersistentTempBuffers(se::StreamExecutor* executor)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(persistent_temp_buffers_mu_);
 
+  // A set of temp buffers reused by the runs of the executable, allocated from
+  // `executor`. They are freed once the last run using them is done.
+  struct TempBufferArena {
+    ~TempBufferArena();
+
+    se::StreamExecutor* executor = nullptr;
+    BufferAllocToDeviceMemoryMap buffers;
+    // Recorded on the stream of the last run that used the arena, after its
+    // thunks. The next run waits for it before using the buffers.
+    std::unique_ptr<se::Event> done_event;
+  };
+
+  // Leases a temp buffer arena to a run on the stream of `run_options`, which
+  // waits for the previous run using the arena. Returns null if all arenas are
+  // leased, in which case the temp buffers are allocated for the run.
+  std::unique_ptr<TempBufferArena> AcquireTempBufferArena(
+      const ServiceExecutableRunOptions* run_options);
+
+  // Returns an arena to the pool once the work enqueued on `stream` is done.
+  void ReleaseTempBufferArena(se::Stream* stream,
+                              std::unique_ptr<TempBufferArena> arena);
+
   // GpuExecutable check with either AMD's ISA version, or Nvidia's major minor
   // version for compute capability, depending on the hardware.
   Status CheckCompatibilityWithServiceExecutableRunOptions(
       const ServiceExecutableRunOptions* run_options);
 
+  // Returns the addresses id of `buffer_allocations` for a run on `executor`:
+  // the id of the previous run if the addresses are the same, or a new one.
+  uint64_t GetBufferAddressesId(se::StreamExecutor* executor,
+                                const BufferAllocations& buffer_allocations);
+
   StatusOr<BufferAllocations> GenerateBufferAllocations(
       VariantArguments arguments,
       const GpuExecutable::BufferAllocToDeviceMemoryMap* globals,
@@ -283,6 +321,10 @@ class GpuExecutable : public Executable {
   // IrEmitter (null if XLA:GPU runtime is enabled).
   OwnedThunkSequence thunks_;
 
+  // The streams that `thunks_` run on, if xla_gpu_num_thunk_streams is above
+  // one (otherwise all thunks run on the main stream).
+  std::optional<ThunkStreamAssignment> thunk_stream_assignment_;
+
   // Gpu runtime executable that encapsulates all the state for running Gpu
   // runtime custom calls implementing gpu abstraction layer (available only if
   // Xla runtime is enabled).
@@ -308,6 +350,32 @@ class GpuExecutable : public Executable {
                       BufferAllocToDeviceMemoryMap>
       persistent_temp_buffers_ ABSL_GUARDED_BY(persistent_temp_buffers_mu_);
 
+  // Temp buffer arenas that are not leased, and the number of arenas, for each
+  // executor.
+  struct TempBufferArenaPool {
+    std::vector<std::unique_ptr<TempBufferArena>> available;
+    int64_t num_arenas = 0;
+  };
+  const int64_t num_temp_buffer_arenas_;
+  absl::Mutex temp_buffer_arenas_mu_;
+  absl::flat_hash_map<se::StreamExecutor*, TempBufferArenaPool>
+      temp_buffer_arenas_ ABSL_GUARDED_BY(temp_buffer_arenas_mu_);
+
+  // The buffer addresses of the last run on each executor, and their id.
+  struct BufferAddresses {
+    std::vector<se::DeviceMemoryBase> buffers;
+    uint64_t id = 0;
+  };
+  absl::Mutex last_buffer_addresses_mu_;
+  absl::flat_hash_map<se::StreamExecutor*, BufferAddresses>
+      last_buffer_addresses_ ABSL_GUARDED_BY(last_buffer_addresses_mu_);
+
+  // Executors on which the NCCL communicators of the collective thunks were
+  // initialized ahead of the first run.
+  absl::Mutex nccl_comms_initialized_mu_;
+  absl::flat_hash_set<se::StreamExecutor*> nccl_comms_initialized_
+      ABSL_GUARDED_BY(nccl_comms_initialized_mu_);
+
   std::shared_ptr<BufferAssignmentProto> debug_buffer_assignment_;
   std::function<std::string()> verbose_buffer_assignment_string_dumper_;
 
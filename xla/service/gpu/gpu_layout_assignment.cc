@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/gpu/gpu_layout_assignment.h"
 
+#include <array>
 #include <cstddef>
 #include <initializer_list>
 #include <memory>
@@ -457,6 +458,46 @@ Status GpuLayoutAssignment::SetDotOperandLayout(
     absl::Span<const int64_t> col_dims) {
   Shape shape = instruction->operand(operand)->shape();
 
+  if (instruction->GetModule()
+          ->config()
+          .debug_options()
+          .xla_gpu_enable_cost_based_layout_assignment()) {
+    // Pick the cheapest of the supported layouts, preferring them in the same
+    // order as below on ties.
+    std::vector<Shape> candidates;
+    if (shape.has_layout()) candidates.push_back(shape);
+    Shape with_layout = shape;
+    LayoutUtil::SetToDefaultLayout(&with_layout);
+    candidates.push_back(with_layout);
+    for (auto dim_groups :
+         {std::array{batch_dims, row_dims, col_dims},
+          std::array{batch_dims, col_dims, row_dims}}) {
+      std::vector<int64_t> major_to_minor;
+      for (auto group : dim_groups) {
+        major_to_minor.insert(major_to_minor.end(), group.begin(), group.end());
+      }
+      *with_layout.mutable_layout() =
+          LayoutUtil::MakeLayoutFromMajorToMinor(major_to_minor);
+      candidates.push_back(with_layout);
+    }
+    const Shape* best = nullptr;
+    double best_cost = 0;
+    for (const Shape& candidate : candidates) {
+      if (!MatrixLayout::For(candidate, batch_dims, row_dims, col_dims).ok()) {
+        continue;
+      }
+      double cost =
+          LayoutChangeCost(instruction->operand(operand), candidate.layout());
+      if (best == nullptr || cost < best_cost) {
+        best = &candidate;
+        best_cost = cost;
+      }
+    }
+    if (best != nullptr) {
+      return SetOperandLayout(*best, instruction, operand);
+    }
+  }
+
   // First, try to use the existing layout, if present.
   if (shape.has_layout() &&
       MatrixLayout::For(shape, batch_dims, row_dims, col_dims).ok())
@@ -207,6 +207,41 @@ TEST_F(LayoutAssignmentTest, DotOperandInconsistentDimLayouts) {
                         m::Op().WithShape(F32, {6, 5, 3, 4}, {3, 2, 0, 1}))));
 }
 
+TEST_F(LayoutAssignmentTest, CostBasedDotOperandLayoutAvoidsTranspose) {
+  const char* hlo_text = R"(
+  HloModule DotLayout
+  ENTRY dot {
+    p0 = f32[5,3,2]{2,1,0} parameter(0)
+    p1 = f32[5,3,4]{2,1,0} parameter(1)
+    t = f32[5,2,3] transpose(p0), dimensions={0,2,1}
+    ROOT dot = f32[5,2,4] dot(t, p1),
+      lhs_batch_dims={0}, lhs_contracting_dims={2},
+      rhs_batch_dims={0}, rhs_contracting_dims={1}
+  })";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(hlo_text));
+  DebugOptions debug_options = module->config().debug_options();
+  debug_options.set_xla_gpu_enable_cost_based_layout_assignment(true);
+  module->mutable_config().set_debug_options(debug_options);
+
+  ComputationLayout computation_layout(
+      module->entry_computation()->ComputeProgramShape(),
+      /*ignore_layouts=*/false);
+  GpuLayoutAssignment layout_assignment(&computation_layout,
+                                        backend().default_stream_executor());
+  EXPECT_THAT(layout_assignment.Run(module.get()), IsOkAndHolds(true));
+
+  // The default layout {2,1,0} is supported for the lhs too, but it would make
+  // the transpose a physical one. With {1,2,0} it is a bitcast.
+  const HloInstruction* lhs =
+      module->entry_computation()->root_instruction()->operand(0);
+  EXPECT_THAT(lhs, GmockMatch(m::Transpose(m::Parameter(0))
+                                  .WithShape(F32, {5, 2, 3}, {1, 2, 0})));
+  EXPECT_TRUE(ShapeUtil::TransposeIsBitcast(
+      lhs->operand(0)->shape(), lhs->shape(), lhs->dimensions()));
+}
+
 TEST_F(LayoutAssignmentTest, TransposedDotLayout) {
   const char* hlo_text = R"(
   HloModule DotLayout
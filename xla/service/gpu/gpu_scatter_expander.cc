@@ -15,21 +15,163 @@ limitations under the License.
 
 #include "xla/service/gpu/gpu_scatter_expander.h"
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/primitive_util.h"
 #include "xla/statusor.h"
 
 namespace xla {
+namespace {
+
+// Returns the combiner of the `index`-th operand of a variadic scatter with
+// `num_operands` operands, or std::nullopt if that element of `combiner`
+// depends on the other operands or updates.
+std::optional<std::unique_ptr<HloComputation>> BuildElementCombiner(
+    const HloComputation& combiner, int64_t index, int64_t num_operands) {
+  const HloInstruction* element = combiner.root_instruction()->operand(index);
+
+  // Find the instructions that the element depends on.
+  absl::flat_hash_set<const HloInstruction*> reachable;
+  std::vector<const HloInstruction*> stack = {element};
+  while (!stack.empty()) {
+    const HloInstruction* instr = stack.back();
+    stack.pop_back();
+    if (!reachable.insert(instr).second) continue;
+    for (const HloInstruction* operand : instr->operands()) {
+      stack.push_back(operand);
+    }
+  }
+
+  HloComputation::Builder builder(absl::StrCat(combiner.name(), ".", index));
+  absl::flat_hash_map<const HloInstruction*, HloInstruction*> clones;
+  for (const HloInstruction* instr : combiner.MakeInstructionPostOrder()) {
+    if (!reachable.contains(instr)) continue;
+    if (instr->opcode() == HloOpcode::kParameter) {
+      int64_t number = instr->parameter_number();
+      if (number != index && number != num_operands + index) {
+        return std::nullopt;
+      }
+      clones[instr] = builder.AddInstruction(HloInstruction::CreateParameter(
+          number == index ? 0 : 1, instr->shape(), instr->name()));
+      continue;
+    }
+    std::vector<HloInstruction*> new_operands;
+    new_operands.reserve(instr->operand_count());
+    for (const HloInstruction* operand : instr->operands()) {
+      new_operands.push_back(clones.at(operand));
+    }
+    clones[instr] = builder.AddInstruction(
+        instr->CloneWithNewOperands(instr->shape(), new_operands));
+  }
+  // Both parameters are required, even if the element ignores one of them.
+  for (int64_t number : {index, num_operands + index}) {
+    const HloInstruction* parameter = combiner.parameter_instruction(number);
+    if (!clones.contains(parameter)) {
+      builder.AddInstruction(HloInstruction::CreateParameter(
+          number == index ? 0 : 1, parameter->shape(), parameter->name()));
+    }
+  }
+  return builder.Build(clones.at(element));
+}
+
+// Returns true if `element_combiner` is a commutative and associative binary
+// op of its two parameters, so that updates to repeated indices give the same
+// result in any order.
+bool IsCommutativeElementCombiner(const HloComputation& element_combiner) {
+  const HloInstruction* root = element_combiner.root_instruction();
+  switch (root->opcode()) {
+    case HloOpcode::kAdd:
+    case HloOpcode::kMultiply:
+    case HloOpcode::kMaximum:
+    case HloOpcode::kMinimum:
+    case HloOpcode::kAnd:
+    case HloOpcode::kOr:
+    case HloOpcode::kXor:
+      break;
+    default:
+      return false;
+  }
+  return element_combiner.instruction_count() == 3 &&
+         root->operand(0)->opcode() == HloOpcode::kParameter &&
+         root->operand(1)->opcode() == HloOpcode::kParameter &&
+         root->operand(0) != root->operand(1);
+}
+
+}  // namespace
 
 bool GpuScatterExpander::InstructionMatchesPattern(HloInstruction* inst) {
   // TODO(b/129698548): Scattering elements larger than 64 bits is not
   // supported by XLA:GPU.
-  // TODO(b/227486631): Variadic scatter is not yet supported by GPU.
+  // TODO(b/227486631): Variadic scatter is not yet supported by GPU, it is
+  // split into scatters or expanded by ExpandInstruction.
   return inst->opcode() == HloOpcode::kScatter &&
          (inst->shape().IsTuple() ||
           primitive_util::BitWidth(inst->shape().element_type()) > 64);
 }
 
+StatusOr<HloInstruction*> GpuScatterExpander::ExpandInstruction(
+    HloInstruction* inst) {
+  auto* scatter = Cast<HloScatterInstruction>(inst);
+  const int64_t num_operands = scatter->scatter_operand_count();
+  const HloComputation* combiner = scatter->to_apply();
+  bool splittable =
+      num_operands > 1 &&
+      combiner->root_instruction()->opcode() == HloOpcode::kTuple &&
+      absl::c_all_of(scatter->scatter_operands(), [](HloInstruction* operand) {
+        return primitive_util::BitWidth(operand->shape().element_type()) <= 64;
+      });
+
+  std::vector<std::unique_ptr<HloComputation>> element_combiners;
+  for (int64_t i = 0; splittable && i < num_operands; ++i) {
+    std::optional<std::unique_ptr<HloComputation>> element_combiner =
+        BuildElementCombiner(*combiner, i, num_operands);
+    if (!element_combiner.has_value()) {
+      splittable = false;
+    } else {
+      element_combiners.push_back(*std::move(element_combiner));
+    }
+  }
+  // A variadic scatter applies each tuple of updates atomically. With repeated
+  // indices, separate scatters may pick elements of different updates (e.g.
+  // the key of one update and the value of another), unless the order of the
+  // updates doesn't matter.
+  if (splittable && !scatter->unique_indices()) {
+    splittable = absl::c_all_of(
+        element_combiners, [](const std::unique_ptr<HloComputation>& c) {
+          return IsCommutativeElementCombiner(*c);
+        });
+  }
+  if (!splittable) {
+    return ScatterExpander::ExpandInstruction(inst);
+  }
+
+  // The scatters share the indices, and each is emitted in place.
+  HloComputation* computation = scatter->parent();
+  HloModule* module = computation->parent();
+  std::vector<HloInstruction*> results;
+  results.reserve(num_operands);
+  for (int64_t i = 0; i < num_operands; ++i) {
+    HloInstruction* operand = scatter->scatter_operands()[i];
+    results.push_back(computation->AddInstruction(HloInstruction::CreateScatter(
+        operand->shape(), operand, scatter->scatter_indices(),
+        scatter->scatter_updates()[i],
+        module->AddEmbeddedComputation(std::move(element_combiners[i])),
+        scatter->scatter_dimension_numbers(), scatter->indices_are_sorted(),
+        scatter->unique_indices())));
+  }
+  return computation->AddInstruction(HloInstruction::CreateTuple(results));
+}
+
 }  // namespace xla
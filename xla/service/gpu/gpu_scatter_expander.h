@@ -21,6 +21,13 @@ limitations under the License.
 namespace xla {
 
 // Legalizes scatters on the GPU.
+//
+// Variadic scatters whose combiner updates each operand independently, e.g.
+// the scatters updating the key and value caches at the same indices, are
+// split into one scatter per operand, which are emitted in place. This is only
+// done if the indices are unique or every element is combined with a
+// commutative and associative op, as the updates of a variadic scatter are
+// applied atomically. Other unsupported scatters are expanded into loops.
 class GpuScatterExpander : public ScatterExpander {
  public:
   // Although we pass kEliminateAllScatters, we override this behavior in
@@ -31,6 +38,8 @@ class GpuScatterExpander : public ScatterExpander {
 
  protected:
   bool InstructionMatchesPattern(HloInstruction* inst) override;
+
+  StatusOr<HloInstruction*> ExpandInstruction(HloInstruction* inst) override;
 };
 
 }  // namespace xla
@@ -0,0 +1,183 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/gpu_scatter_expander.h"
+
+#include <memory>
+
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/pattern_matcher.h"
+#include "xla/service/pattern_matcher_gmock.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+namespace m = ::xla::match;
+
+using GpuScatterExpanderTest = HloTestBase;
+
+TEST_F(GpuScatterExpanderTest, SplitsIndependentVariadicScatter) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule test_module
+
+overwrite {
+  k_old = f32[] parameter(0)
+  v_old = f32[] parameter(1)
+  k_new = f32[] parameter(2)
+  v_new = f32[] parameter(3)
+  ROOT tuple = (f32[], f32[]) tuple(k_new, v_new)
+}
+
+ENTRY main {
+  k_cache = f32[16,4] parameter(0)
+  v_cache = f32[16,4] parameter(1)
+  slots = s32[3] parameter(2)
+  k = f32[3,4] parameter(3)
+  v = f32[3,4] parameter(4)
+  ROOT scatter = (f32[16,4], f32[16,4]) scatter(k_cache, v_cache, slots, k, v),
+      update_window_dims={1}, inserted_window_dims={0},
+      scatter_dims_to_operand_dims={0}, index_vector_dim=1, unique_indices=true,
+      to_apply=overwrite
+}
+)"));
+  GpuScatterExpander pass;
+  ASSERT_TRUE(RunHloPass(&pass, module.get()).value());
+
+  const HloInstruction* root = module->entry_computation()->root_instruction();
+  const HloInstruction* k_scatter;
+  const HloInstruction* v_scatter;
+  EXPECT_THAT(
+      root,
+      GmockMatch(m::Tuple(
+          m::Scatter(&k_scatter, m::Parameter(0), m::Parameter(2),
+                     m::Parameter(3))
+              .WithShape(F32, {16, 4}),
+          m::Scatter(&v_scatter, m::Parameter(1), m::Parameter(2),
+                     m::Parameter(4))
+              .WithShape(F32, {16, 4}))));
+  for (const HloInstruction* scatter : {k_scatter, v_scatter}) {
+    EXPECT_EQ(scatter->to_apply()->num_parameters(), 2);
+    EXPECT_THAT(scatter->to_apply()->root_instruction(),
+                GmockMatch(m::Parameter(1)));
+  }
+}
+
+TEST_F(GpuScatterExpanderTest, ExpandsDependentVariadicScatter) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule test_module
+
+combiner {
+  a_old = f32[] parameter(0)
+  b_old = f32[] parameter(1)
+  a_new = f32[] parameter(2)
+  b_new = f32[] parameter(3)
+  a = f32[] add(a_old, b_new)
+  ROOT tuple = (f32[], f32[]) tuple(a, b_new)
+}
+
+ENTRY main {
+  a = f32[16] parameter(0)
+  b = f32[16] parameter(1)
+  indices = s32[3] parameter(2)
+  a_updates = f32[3] parameter(3)
+  b_updates = f32[3] parameter(4)
+  ROOT scatter = (f32[16], f32[16]) scatter(a, b, indices, a_updates,
+      b_updates),
+      update_window_dims={}, inserted_window_dims={0},
+      scatter_dims_to_operand_dims={0}, index_vector_dim=1, to_apply=combiner
+}
+)"));
+  GpuScatterExpander pass;
+  ASSERT_TRUE(RunHloPass(&pass, module.get()).value());
+
+  for (const HloInstruction* instr :
+       module->entry_computation()->instructions()) {
+    EXPECT_NE(instr->opcode(), HloOpcode::kScatter);
+  }
+}
+
+TEST_F(GpuScatterExpanderTest, SplitsCommutativeVariadicScatter) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule test_module
+
+combiner {
+  a_old = f32[] parameter(0)
+  b_old = s32[] parameter(1)
+  a_new = f32[] parameter(2)
+  b_new = s32[] parameter(3)
+  a = f32[] add(a_old, a_new)
+  b = s32[] maximum(b_new, b_old)
+  ROOT tuple = (f32[], s32[]) tuple(a, b)
+}
+
+ENTRY main {
+  a = f32[16] parameter(0)
+  b = s32[16] parameter(1)
+  indices = s32[3] parameter(2)
+  a_updates = f32[3] parameter(3)
+  b_updates = s32[3] parameter(4)
+  ROOT scatter = (f32[16], s32[16]) scatter(a, b, indices, a_updates,
+      b_updates),
+      update_window_dims={}, inserted_window_dims={0},
+      scatter_dims_to_operand_dims={0}, index_vector_dim=1, to_apply=combiner
+}
+)"));
+  GpuScatterExpander pass;
+  ASSERT_TRUE(RunHloPass(&pass, module.get()).value());
+
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              GmockMatch(m::Tuple(m::Scatter(), m::Scatter())));
+}
+
+TEST_F(GpuScatterExpanderTest, ExpandsOverwriteWithDuplicateIndices) {
+  // The indices may repeat, so the key and value written to a slot must come
+  // from the same update, which separate scatters don't guarantee.
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule test_module
+
+overwrite {
+  k_old = f32[] parameter(0)
+  v_old = f32[] parameter(1)
+  k_new = f32[] parameter(2)
+  v_new = f32[] parameter(3)
+  ROOT tuple = (f32[], f32[]) tuple(k_new, v_new)
+}
+
+ENTRY main {
+  k_cache = f32[16,4] parameter(0)
+  v_cache = f32[16,4] parameter(1)
+  slots = s32[3] constant({5, 5, 7})
+  k = f32[3,4] parameter(2)
+  v = f32[3,4] parameter(3)
+  ROOT scatter = (f32[16,4], f32[16,4]) scatter(k_cache, v_cache, slots, k, v),
+      update_window_dims={1}, inserted_window_dims={0},
+      scatter_dims_to_operand_dims={0}, index_vector_dim=1, to_apply=overwrite
+}
+)"));
+  GpuScatterExpander pass;
+  ASSERT_TRUE(RunHloPass(&pass, module.get()).value());
+
+  for (const HloInstruction* instr :
+       module->entry_computation()->instructions()) {
+    EXPECT_NE(instr->opcode(), HloOpcode::kScatter);
+  }
+}
+
+}  // namespace
+}  // namespace xla
@@ -0,0 +1,237 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/gpu/gpu_sort_rewriter.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "xla/comparison_util.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/layout_util.h"
+#include "xla/primitive_util.h"
+#include "xla/service/gpu/cub_sort_thunk.h"
+#include "xla/service/gpu/cublas_cudnn.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/statusor.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// Returns whether the cub sort kernels are instantiated for these types (see
+// CreateCubSortRunner in cub_sort_thunk.cc).
+bool IsCubSortSupported(PrimitiveType key_type,
+                        std::optional<PrimitiveType> value_type) {
+  if (!value_type.has_value()) {
+    switch (key_type) {
+      case F16:
+      case F32:
+      case F64:
+      case S8:
+      case S16:
+      case S32:
+      case S64:
+      case U8:
+      case U16:
+      case U32:
+      case U64:
+        return true;
+      default:
+        return false;
+    }
+  }
+  if (!primitive_util::IsArrayType(*value_type)) {
+    return false;
+  }
+  int value_width = primitive_util::BitWidth(*value_type);
+  switch (key_type) {
+    case F16:
+    case F32:
+    case S32:
+      return value_width == 32;
+    case U16:
+    case U32:
+    case U64:
+      return value_width == 16 || value_width == 32 || value_width == 64;
+    default:
+      return false;
+  }
+}
+
+// Returns whether the comparator orders the keys (parameters 0 and 1) in
+// descending order, or std::nullopt if it isn't a plain comparison of the keys.
+//
+// The radix sort orders floating point keys by their bits, which matches the
+// total order but not the partial order of LT/GT (e.g. for -0.0 and NaNs), so
+// floating point comparisons must use the total order.
+std::optional<bool> GetSortDirection(const HloSortInstruction* sort) {
+  const HloInstruction* root = sort->to_apply()->root_instruction();
+  if (root->opcode() != HloOpcode::kCompare) {
+    return std::nullopt;
+  }
+  auto* compare = Cast<HloCompareInstruction>(root);
+  if (primitive_util::IsFloatingPointType(
+          compare->operand(0)->shape().element_type()) &&
+      compare->type() != Comparison::Type::kFloatTotalOrder) {
+    return std::nullopt;
+  }
+  const HloInstruction* lhs = root->operand(0);
+  const HloInstruction* rhs = root->operand(1);
+  if (lhs->opcode() != HloOpcode::kParameter ||
+      rhs->opcode() != HloOpcode::kParameter) {
+    return std::nullopt;
+  }
+  int64_t lhs_index = lhs->parameter_number();
+  int64_t rhs_index = rhs->parameter_number();
+  bool keys_in_order = lhs_index == 0 && rhs_index == 1;
+  if (!keys_in_order && !(lhs_index == 1 && rhs_index == 0)) {
+    return std::nullopt;
+  }
+  switch (compare->direction()) {
+    case ComparisonDirection::kLt:
+      return !keys_in_order;
+    case ComparisonDirection::kGt:
+      return keys_in_order;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Returns whether `shape` is sorted along `dimension` one contiguous row at a
+// time, which is what the custom call expects.
+bool SortsContiguousRows(const Shape& shape, int64_t dimension) {
+  return dimension == shape.rank() - 1 && shape.has_layout() &&
+         LayoutUtil::IsMonotonicWithDim0Major(shape.layout());
+}
+
+}  // namespace
+
+StatusOr<bool> GpuSortRewriter::RunOnInstruction(HloSortInstruction* sort) {
+  if (sort->operand_count() > 2) {
+    return false;
+  }
+  const Shape& keys_shape = sort->keys()->shape();
+  std::optional<PrimitiveType> value_type;
+  if (sort->values_count() == 1) {
+    const Shape& values_shape = sort->operand(1)->shape();
+    if (!SortsContiguousRows(values_shape, sort->sort_dimension())) {
+      return false;
+    }
+    value_type = values_shape.element_type();
+  }
+  if (!SortsContiguousRows(keys_shape, sort->sort_dimension()) ||
+      !IsCubSortSupported(keys_shape.element_type(), value_type)) {
+    return false;
+  }
+
+  int64_t num_items = ShapeUtil::ElementsIn(keys_shape);
+  int64_t row_size = keys_shape.dimensions(sort->sort_dimension());
+  // Segment offsets are computed with 32-bit integers.
+  if (row_size < kSortSizeThreshold ||
+      num_items > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+  std::optional<bool> descending = GetSortDirection(sort);
+  if (!descending.has_value()) {
+    return false;
+  }
+
+  int64_t batch_size = num_items / row_size;
+  TF_ASSIGN_OR_RETURN(int64_t scratch_size,
+                      GetCubSortScratchSize(keys_shape.element_type(),
+                                            value_type, num_items, batch_size));
+
+  // The custom call returns the sorted operands followed by the scratch.
+  std::vector<Shape> shapes;
+  for (const HloInstruction* operand : sort->operands()) {
+    shapes.push_back(operand->shape());
+  }
+  shapes.push_back(
+      ShapeUtil::MakeShapeWithDescendingLayout(U8, {scratch_size}));
+
+  HloComputation* computation = sort->parent();
+  HloInstruction* custom_call =
+      computation->AddInstruction(HloInstruction::CreateCustomCall(
+          ShapeUtil::MakeTupleShape(shapes), sort->operands(),
+          kCubDeviceRadixSortTarget));
+  sort->GetModule()->SetAndUniquifyInstrName(custom_call, "cub-sort");
+  SortOptions options;
+  options.set_descending(*descending);
+  TF_RETURN_IF_ERROR(custom_call->set_backend_config(options));
+  custom_call->set_metadata(sort->metadata());
+
+  HloInstruction* replacement;
+  if (sort->values_count() == 0) {
+    replacement = computation->AddInstruction(
+        HloInstruction::CreateGetTupleElement(keys_shape, custom_call, 0));
+  } else {
+    std::vector<HloInstruction*> elements;
+    for (int i = 0; i < sort->operand_count(); ++i) {
+      elements.push_back(
+          computation->AddInstruction(HloInstruction::CreateGetTupleElement(
+              sort->operand(i)->shape(), custom_call, i)));
+    }
+    replacement =
+        computation->AddInstruction(HloInstruction::CreateTuple(elements));
+  }
+  VLOG(2) << "Rewrote " << sort->name() << " into a CUB radix sort of "
+          << batch_size << " rows of " << row_size << " elements";
+  TF_RETURN_IF_ERROR(computation->ReplaceInstruction(sort, replacement));
+  return true;
+}
+
+StatusOr<bool> GpuSortRewriter::RunOnComputation(HloComputation* computation) {
+  std::vector<HloSortInstruction*> sorts;
+  for (HloInstruction* instr : computation->instructions()) {
+    if (instr->opcode() == HloOpcode::kSort) {
+      sorts.push_back(Cast<HloSortInstruction>(instr));
+    }
+  }
+
+  bool changed = false;
+  for (HloSortInstruction* sort : sorts) {
+    TF_ASSIGN_OR_RETURN(bool result, RunOnInstruction(sort));
+    changed |= result;
+  }
+  return changed;
+}
+
+StatusOr<bool> GpuSortRewriter::Run(
+    HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  bool changed = false;
+  for (HloComputation* computation :
+       module->MakeNonfusionComputations(execution_threads)) {
+    TF_ASSIGN_OR_RETURN(bool result, RunOnComputation(computation));
+    changed |= result;
+  }
+  return changed;
+}
+
+}  // namespace gpu
+}  // namespace xla
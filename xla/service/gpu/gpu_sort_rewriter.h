@@ -0,0 +1,62 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef XLA_SERVICE_GPU_GPU_SORT_REWRITER_H_
+#define XLA_SERVICE_GPU_GPU_SORT_REWRITER_H_
+
+#include <cstdint>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_pass_interface.h"
+#include "xla/statusor.h"
+
+namespace xla {
+namespace gpu {
+
+// Rewrites sorts that cub::DeviceRadixSort can handle into a custom-call.
+//
+// Supported sorts have one operand (keys) or two operands (keys and values,
+// e.g. the iota of an argsort), a comparator that orders the keys with a
+// plain LT or GT comparison (using the total order for floating point keys),
+// and sort along the minor-most dimension of a row-major array. Sorts of multi-dimensional arrays sort each row
+// independently and are run with cub::DeviceSegmentedRadixSort.
+//
+// Like the triangular-solve rewriter, the custom-call returns a tuple of the
+// sorted operands and the temp memory needed by CUB. Its backend-config is a
+// SortOptions object.
+class GpuSortRewriter : public HloModulePass {
+ public:
+  absl::string_view name() const override { return "gpu-sort-rewriter"; }
+
+  // Rows shorter than this are sorted faster by the sort emitter, which
+  // sorts tiles of a row in shared memory.
+  static constexpr int64_t kSortSizeThreshold = 16384;
+
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(
+      HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+
+ private:
+  StatusOr<bool> RunOnInstruction(HloSortInstruction* sort);
+  StatusOr<bool> RunOnComputation(HloComputation* computation);
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_GPU_SORT_REWRITER_H_
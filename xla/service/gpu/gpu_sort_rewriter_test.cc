@@ -0,0 +1,220 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/gpu/gpu_sort_rewriter.h"
+
+#include "xla/error_spec.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/gpu/cublas_cudnn.h"
+#include "xla/service/pattern_matcher.h"
+#include "xla/service/pattern_matcher_gmock.h"
+#include "xla/tests/hlo_test_base.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+namespace m = ::xla::match;
+
+class GpuSortRewriterTest : public HloTestBase {
+ public:
+  // Checks that the root of the module is an unpacked CUB sort with the given
+  // direction.
+  void ExpectCubArgSort(HloModule* module, bool descending) {
+    const HloInstruction* custom_call;
+    ASSERT_THAT(
+        module->entry_computation()->root_instruction(),
+        GmockMatch(m::Tuple(
+            m::GetTupleElement(
+                m::CustomCall(&custom_call, {kCubDeviceRadixSortTarget}), 0),
+            m::GetTupleElement(m::CustomCall(), 1))));
+    TF_ASSERT_OK_AND_ASSIGN(SortOptions options,
+                            custom_call->backend_config<SortOptions>());
+    EXPECT_EQ(options.descending(), descending);
+  }
+};
+
+TEST_F(GpuSortRewriterTest, RewritesBatchedArgSort) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+compare {
+  p0 = f32[] parameter(0)
+  p1 = f32[] parameter(1)
+  p2 = s32[] parameter(2)
+  p3 = s32[] parameter(3)
+  ROOT lt = pred[] compare(p0, p1), direction=LT, type=TOTALORDER
+}
+
+ENTRY e {
+  keys = f32[8,32768]{1,0} parameter(0)
+  iota = s32[8,32768]{1,0} iota(), iota_dimension=1
+  ROOT sort = (f32[8,32768]{1,0}, s32[8,32768]{1,0}) sort(keys, iota),
+      dimensions={1}, is_stable=true, to_apply=compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloPass(GpuSortRewriter(), module.get()));
+  EXPECT_TRUE(changed);
+  ExpectCubArgSort(module.get(), /*descending=*/false);
+}
+
+TEST_F(GpuSortRewriterTest, RewritesSwappedComparisonAsDescending) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+compare {
+  p0 = f32[] parameter(0)
+  p1 = f32[] parameter(1)
+  p2 = s32[] parameter(2)
+  p3 = s32[] parameter(3)
+  ROOT lt = pred[] compare(p1, p0), direction=LT, type=TOTALORDER
+}
+
+ENTRY e {
+  keys = f32[4,65536]{1,0} parameter(0)
+  iota = s32[4,65536]{1,0} iota(), iota_dimension=1
+  ROOT sort = (f32[4,65536]{1,0}, s32[4,65536]{1,0}) sort(keys, iota),
+      dimensions={1}, to_apply=compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloPass(GpuSortRewriter(), module.get()));
+  EXPECT_TRUE(changed);
+  ExpectCubArgSort(module.get(), /*descending=*/true);
+}
+
+TEST_F(GpuSortRewriterTest, KeepsSortsOfShortRows) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+compare {
+  p0 = f32[] parameter(0)
+  p1 = f32[] parameter(1)
+  ROOT lt = pred[] compare(p0, p1), direction=LT
+}
+
+ENTRY e {
+  keys = f32[64,1024]{1,0} parameter(0)
+  ROOT sort = f32[64,1024]{1,0} sort(keys), dimensions={1}, to_apply=compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloPass(GpuSortRewriter(), module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(GpuSortRewriterTest, KeepsSortsAlongMajorDimension) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+compare {
+  p0 = f32[] parameter(0)
+  p1 = f32[] parameter(1)
+  ROOT lt = pred[] compare(p0, p1), direction=LT
+}
+
+ENTRY e {
+  keys = f32[32768,8]{1,0} parameter(0)
+  ROOT sort = f32[32768,8]{1,0} sort(keys), dimensions={0}, to_apply=compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloPass(GpuSortRewriter(), module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(GpuSortRewriterTest, KeepsSortsWithComparatorsOnValues) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+compare {
+  p0 = f32[] parameter(0)
+  p1 = f32[] parameter(1)
+  p2 = s32[] parameter(2)
+  p3 = s32[] parameter(3)
+  ROOT lt = pred[] compare(p2, p3), direction=LT
+}
+
+ENTRY e {
+  keys = f32[8,32768]{1,0} parameter(0)
+  values = s32[8,32768]{1,0} parameter(1)
+  ROOT sort = (f32[8,32768]{1,0}, s32[8,32768]{1,0}) sort(keys, values),
+      dimensions={1}, to_apply=compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloPass(GpuSortRewriter(), module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(GpuSortRewriterTest, KeepsFloatSortsWithoutTotalOrder) {
+  // The radix sort doesn't order -0.0, +0.0 and NaNs like LT does.
+  constexpr char kHlo[] = R"(
+HloModule m
+
+compare {
+  p0 = f32[] parameter(0)
+  p1 = f32[] parameter(1)
+  p2 = s32[] parameter(2)
+  p3 = s32[] parameter(3)
+  ROOT lt = pred[] compare(p0, p1), direction=LT
+}
+
+ENTRY e {
+  keys = f32[8,32768]{1,0} parameter(0)
+  iota = s32[8,32768]{1,0} iota(), iota_dimension=1
+  ROOT sort = (f32[8,32768]{1,0}, s32[8,32768]{1,0}) sort(keys, iota),
+      dimensions={1}, to_apply=compare
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloPass(GpuSortRewriter(), module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(GpuSortRewriterTest, BatchedArgSortMatchesReference) {
+  constexpr char kHlo[] = R"(
+HloModule m
+
+compare {
+  p0 = f32[] parameter(0)
+  p1 = f32[] parameter(1)
+  p2 = s32[] parameter(2)
+  p3 = s32[] parameter(3)
+  ROOT gt = pred[] compare(p0, p1), direction=GT, type=TOTALORDER
+}
+
+ENTRY e {
+  keys = f32[4,32768] parameter(0)
+  iota = s32[4,32768] iota(), iota_dimension=1
+  ROOT sort = (f32[4,32768], s32[4,32768]) sort(keys, iota),
+      dimensions={1}, is_stable=true, to_apply=compare
+})";
+
+  EXPECT_TRUE(RunAndCompare(kHlo, ErrorSpec{0, 0}));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -106,11 +106,28 @@ bool MayPreventVectorization(
       });
 }
 
+// Returns whether `gather` copies whole rows of its operand along the minor
+// dimension, like an embedding lookup in the form produced by
+// GatherSimplifier. The elements of an output row then come from one
+// contiguous operand row.
+bool IsRowGather(const HloInstruction& gather) {
+  const GatherDimensionNumbers& dnums = gather.gather_dimension_numbers();
+  const Shape& operand_shape = gather.operand(0)->shape();
+  const int64_t minor_dim = operand_shape.rank() - 1;
+  return minor_dim >= 0 && !dnums.offset_dims().empty() &&
+         dnums.offset_dims().Get(dnums.offset_dims_size() - 1) ==
+             gather.shape().rank() - 1 &&
+         !absl::c_linear_search(dnums.start_index_map(), minor_dim) &&
+         !absl::c_linear_search(dnums.collapsed_slice_dims(), minor_dim) &&
+         gather.gather_slice_sizes().back() ==
+             operand_shape.dimensions(minor_dim);
+}
+
 // Determines if we enable the row optimized codegen. When we have a fusion with
-// only point-wise operations, scalar broadcasting and row broadcasting, we can
-// trigger a kernel that vectorizes the row loads. This speeds up the kernel, in
-// particular on A100. The int is the number of inputs with rank `out_rank`. Its
-// value is only defined if row vectorization is enabled.
+// only point-wise operations, scalar broadcasting and row broadcasting or row
+// gathers, we can trigger a kernel that vectorizes the row loads. This speeds
+// up the kernel, in particular on A100. The int is the number of inputs with
+// rank `out_rank`. Its value is only defined if row vectorization is enabled.
 std::pair<bool /*enabled*/, int> RowVectorizationEnabled(
     const std::vector<const HloInstruction*>& fusion_roots, int64_t out_rank) {
   const auto is_row_major = [](const HloInstruction* instr) {
@@ -129,12 +146,13 @@ std::pair<bool /*enabled*/, int> RowVectorizationEnabled(
   // supported operation (or category) must be manually vetted as XLA
   // only unrolls and relies on LLVM to vectorize. But this is brittle.
   // Currently tested and supported operations:
-  // Elementwise, scalar and row broadcasting.
+  // Elementwise, scalar and row broadcasting, row gathers.
   //
   // We also detect at the same time if there is a row broadcasting
-  // operation.
+  // operation or a row gather.
   int num_big_inputs = 0;
   bool some_row_broadcasting = false;
+  bool some_row_gather = false;
   HloBfsConsumersFirstTraversal(
       {fusion_roots.front()},
       [&](const HloInstruction& producer, const HloInstruction& consumer) {
@@ -144,6 +162,13 @@ std::pair<bool /*enabled*/, int> RowVectorizationEnabled(
         if (node.IsElementwise()) {
           return TraversalResult::kVisitOperands;
         }
+        // All unrolled elements of a thread share the gathered row, so its
+        // index is loaded once and the row is read with vector loads.
+        if (node.opcode() == HloOpcode::kGather && is_row_major(&node) &&
+            IsRowGather(node)) {
+          some_row_gather = true;
+          return TraversalResult::kVisitOperands;
+        }
 
         switch (node.opcode()) {
           case HloOpcode::kConstant:
@@ -177,15 +202,64 @@ std::pair<bool /*enabled*/, int> RowVectorizationEnabled(
             return TraversalResult::kAbortTraversal;
         }
       });
-  // Trigger only when there is a row broadcasting.
-  return std::make_pair(row_vectorized && some_row_broadcasting,
-                        num_big_inputs);
+  // Trigger only when there is a row broadcasting or a row gather.
+  return std::make_pair(
+      row_vectorized && (some_row_broadcasting || some_row_gather),
+      num_big_inputs);
+}
+
+// Returns the unroll factor that lets the threads of a loop fusion access 128
+// bits of its narrowest arrays at once, or 1 if the accesses of the fusion are
+// not known to be contiguous or its arrays are 32 bits or wider.
+//
+// The unrolled elements of a thread are consecutive in the output, so their
+// accesses are contiguous for the outputs and for the inputs with the shape
+// and layout of the outputs. Other inputs may only be read by broadcasts. As
+// buffers are aligned to at least 16 bytes and each thread starts at a
+// multiple of the unroll factor, LLVM can merge the accesses into vector loads
+// and stores.
+int ComputeVectorizedUnrollFactor(
+    const std::vector<const HloInstruction*>& fusion_roots,
+    const FusionBoundaryFn& fusion_boundary_fn, const Shape& element_shape) {
+  constexpr int kMaxUnrollFactor = 16;
+  int smallest_bits = std::numeric_limits<int>::max();
+  for (const HloInstruction* root : fusion_roots) {
+    if (!ShapeUtil::EqualIgnoringElementType(root->shape(), element_shape)) {
+      return 1;
+    }
+    smallest_bits = std::min(
+        smallest_bits, primitive_util::BitWidth(root->shape().element_type()));
+  }
+  bool contiguous = !HloAnyOf(
+      fusion_roots, fusion_boundary_fn, [&](const HloInstruction& node) {
+        if (node.opcode() == HloOpcode::kParameter ||
+            node.opcode() == HloOpcode::kConstant) {
+          return false;
+        }
+        if (!node.IsElementwise() && node.opcode() != HloOpcode::kBroadcast) {
+          return true;
+        }
+        for (const HloInstruction* operand : node.operands()) {
+          bool is_input = operand->opcode() == HloOpcode::kParameter ||
+                          fusion_boundary_fn(*operand, node);
+          if (!is_input || node.opcode() == HloOpcode::kBroadcast) continue;
+          if (!ShapeUtil::EqualIgnoringElementType(operand->shape(),
+                                                   element_shape)) {
+            return true;
+          }
+          smallest_bits = std::min(
+              smallest_bits,
+              primitive_util::BitWidth(operand->shape().element_type()));
+        }
+        return false;
+      });
+  if (!contiguous || smallest_bits >= 32) return 1;
+  return std::min(128 / smallest_bits, kMaxUnrollFactor);
 }
 
 // Computes the maximum valid unroll factor for a given instruction.
-int ComputeMaxUnrollFactor(int64_t num_elements) {
-  constexpr int kMaxUnrollFactor = 4;
-  for (int i = kMaxUnrollFactor; i > 1; i /= 2) {
+int ComputeMaxUnrollFactor(int64_t num_elements, int max_unroll_factor = 4) {
+  for (int i = max_unroll_factor; i > 1; i /= 2) {
     if (num_elements % i == 0) {
       return i;
     }
@@ -488,6 +562,19 @@ const LaunchDimensionsConfig* HloFusionAnalysis::GetLoopFusionConfig() {
         return true;
       });
 
+  // Narrow types need more than the default unroll factor for 128-bit memory
+  // accesses. Row-vectorized fusions keep their unroll factor, which sets their
+  // block size.
+  if (unroll_factor > 1 && !row_vectorized) {
+    int vectorized_unroll_factor = ComputeVectorizedUnrollFactor(
+        fusion_roots_, fusion_boundary_fn_, GetElementShape());
+    if (vectorized_unroll_factor > unroll_factor) {
+      unroll_factor =
+          ComputeMaxUnrollFactor(num_elements, vectorized_unroll_factor);
+      VLOG(2) << "Vectorized unroll factor: " << unroll_factor;
+    }
+  }
+
   LaunchDimensionsConfig launch_config{unroll_factor, few_waves,
                                        row_vectorized};
   // Check that the shapes is supported.
@@ -819,6 +906,23 @@ ReductionCodegenInfo HloFusionAnalysis::ComputeReductionCodegenInfo(
                             reduction_tiling, input_shape,
                             reduction_is_race_free);
   int vector_size = vectorize ? 2 : 1;
+  if (vectorize && reduction_dimensions.is_row_reduction) {
+    // Each thread reads `reduction_tiling[kDimX]` elements per row either way,
+    // so grouping them into wider vectors doesn't add register pressure. For
+    // 16-bit (or narrower) inputs a pair of elements is only a 32-bit load;
+    // use 128-bit loads instead, as long as rows stay aligned to the vector.
+    int smallest_input_dtype_bits = SmallestInputDtypeBits();
+    if (smallest_input_dtype_bits <= 16) {
+      int64_t wide_vector_size =
+          std::min<int64_t>({128 / smallest_input_dtype_bits, 8,
+                             reduction_tiling[kDimX]});
+      while (wide_vector_size > vector_size &&
+             reduction_dimensions.dimensions[kDimX] % wide_vector_size != 0) {
+        wide_vector_size /= 2;
+      }
+      vector_size = std::max<int64_t>(vector_size, wide_vector_size);
+    }
+  }
 
   // TODO(b/283542954): Autotune num_partial_results?  This can make a big
   // difference, e.g. by affecting register spilling.
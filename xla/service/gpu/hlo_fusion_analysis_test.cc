@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "xla/service/gpu/hlo_fusion_analysis.h"
 
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/service/gpu/backend_configs.pb.h"
 #include "xla/service/gpu/gpu_device_info_for_tests.h"
 #include "xla/service/gpu/hlo_traversal.h"
@@ -94,6 +96,133 @@ TEST_F(HloFusionAnalysisTest, ReductionWithMultipleUsers) {
             HloFusionAnalysis::EmitterFusionKind::kLoop);
 }
 
+TEST_F(HloFusionAnalysisTest, RowReductionOf16BitInputsUsesWideVectors) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test_module
+
+    add {
+      p0 = f32[] parameter(0)
+      p1 = f32[] parameter(1)
+      ROOT add = f32[] add(p0, p1)
+    }
+
+    ENTRY main {
+      %p0 = bf16[1024,4096] parameter(0)
+      %convert = f32[1024,4096] convert(%p0)
+      %c0 = f32[] constant(0)
+      ROOT %reduce = f32[1024] reduce(%convert, %c0), dimensions={1},
+        to_apply=add
+    })")
+                    .value();
+
+  auto device_info = TestGpuDeviceInfo::RTXA6000DeviceInfo();
+
+  auto* root = module->entry_computation()->root_instruction();
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto analysis,
+      HloFusionAnalysis::Create(FusionBackendConfig::default_instance(), {root},
+                                DefaultFusionBoundaryFn, &device_info));
+  ASSERT_EQ(analysis.GetEmitterFusionKind(),
+            HloFusionAnalysis::EmitterFusionKind::kReduction);
+  const ReductionCodegenInfo* info = analysis.GetReductionCodegenInfo();
+  ASSERT_NE(info, nullptr);
+  // Eight bf16 elements make up one 128-bit load.
+  EXPECT_EQ(info->GetTilingScheme().GetVectorSize(), 8);
+}
+
+TEST_F(HloFusionAnalysisTest, RowGatherIsRowVectorized) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test_module
+
+    ENTRY main {
+      %table = f32[100000,128] parameter(0)
+      %indices = s32[4096,1] parameter(1)
+      ROOT %gather = f32[4096,1,128] gather(%table, %indices),
+        offset_dims={1,2}, collapsed_slice_dims={}, start_index_map={0},
+        index_vector_dim=1, slice_sizes={1,128}
+    })")
+                    .value();
+
+  auto device_info = TestGpuDeviceInfo::RTXA6000DeviceInfo();
+
+  auto* root = module->entry_computation()->root_instruction();
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto analysis,
+      HloFusionAnalysis::Create(FusionBackendConfig::default_instance(), {root},
+                                DefaultFusionBoundaryFn, &device_info));
+  ASSERT_EQ(analysis.GetEmitterFusionKind(),
+            HloFusionAnalysis::EmitterFusionKind::kLoop);
+  const LaunchDimensionsConfig* config = analysis.GetLoopFusionConfig();
+  ASSERT_NE(config, nullptr);
+  EXPECT_TRUE(config->row_vectorized);
+  EXPECT_EQ(config->unroll_factor, 4);
+}
+
+TEST_F(HloFusionAnalysisTest, NarrowElementwiseLoopUses128BitVectors) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test_module
+
+    fused_computation {
+      %p0 = bf16[8192,4096] parameter(0)
+      %p1 = bf16[] parameter(1)
+      %broadcast = bf16[8192,4096] broadcast(%p1), dimensions={}
+      ROOT %multiply = bf16[8192,4096] multiply(%p0, %broadcast)
+    }
+
+    ENTRY main {
+      %p0 = bf16[8192,4096] parameter(0)
+      %p1 = bf16[] parameter(1)
+      ROOT %fusion = bf16[8192,4096] fusion(%p0, %p1), kind=kLoop,
+        calls=fused_computation
+    })")
+                    .value();
+
+  auto device_info = TestGpuDeviceInfo::RTXA6000DeviceInfo();
+
+  auto* root = module->entry_computation()->root_instruction();
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto analysis,
+      HloFusionAnalysis::Create(Cast<HloFusionInstruction>(root),
+                                &device_info));
+  ASSERT_EQ(analysis.GetEmitterFusionKind(),
+            HloFusionAnalysis::EmitterFusionKind::kLoop);
+  const LaunchDimensionsConfig* config = analysis.GetLoopFusionConfig();
+  ASSERT_NE(config, nullptr);
+  // Eight bf16 elements make up one 128-bit access.
+  EXPECT_EQ(config->unroll_factor, 8);
+}
+
+TEST_F(HloFusionAnalysisTest, TransposedInputKeepsDefaultUnrollFactor) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test_module
+
+    fused_computation {
+      %p0 = s8[4096,8192]{0,1} parameter(0)
+      %p1 = s8[4096,8192] parameter(1)
+      %copy = s8[4096,8192] copy(%p0)
+      ROOT %add = s8[4096,8192] add(%copy, %p1)
+    }
+
+    ENTRY main {
+      %p0 = s8[4096,8192]{0,1} parameter(0)
+      %p1 = s8[4096,8192] parameter(1)
+      ROOT %fusion = s8[4096,8192] fusion(%p0, %p1), kind=kLoop,
+        calls=fused_computation
+    })")
+                    .value();
+
+  auto device_info = TestGpuDeviceInfo::RTXA6000DeviceInfo();
+
+  auto* root = module->entry_computation()->root_instruction();
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto analysis,
+      HloFusionAnalysis::Create(Cast<HloFusionInstruction>(root),
+                                &device_info));
+  const LaunchDimensionsConfig* config = analysis.GetLoopFusionConfig();
+  ASSERT_NE(config, nullptr);
+  EXPECT_EQ(config->unroll_factor, 4);
+}
+
 TEST_F(HloFusionAnalysisTest, ReductionEpilogueFusion) {
   auto module = ParseAndReturnVerifiedModule(R"(
     HloModule test_module
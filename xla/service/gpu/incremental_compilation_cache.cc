@@ -0,0 +1,140 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/gpu/incremental_compilation_cache.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "llvm/IR/Module.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/service/llvm_ir/llvm_util.h"
+#include "xla/stream_executor/device_description.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/protobuf.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+std::string FingerprintToString(absl::string_view data) {
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(data);
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+// Inserts `key` -> `value` into `map`, evicting the oldest entries recorded in
+// `keys` so that at most `max_entries` remain.
+template <typename V>
+void InsertWithEviction(absl::string_view key, V value, int64_t max_entries,
+                        absl::flat_hash_map<std::string, V>& map,
+                        std::deque<std::string>& keys) {
+  auto [it, inserted] = map.try_emplace(key, std::move(value));
+  if (!inserted) return;
+  keys.push_back(it->first);
+  while (static_cast<int64_t>(keys.size()) > max_entries) {
+    map.erase(keys.front());
+    keys.pop_front();
+  }
+}
+
+}  // namespace
+
+std::string IncrementalCompilationCache::GetHloKey(
+    const HloModule& module, const se::GpuTargetConfigProto& target_config) {
+  std::string serialized_target_config;
+  tsl::SerializeToStringDeterministic(target_config, &serialized_target_config);
+  // The module fingerprint doesn't include the module name or any unique ids,
+  // so recompiling the same computation under a new name is still a hit.
+  return FingerprintToString(absl::StrCat(
+      module.GetFingerprint128(), "\n", module.config().compilation_cache_key(),
+      "\n", serialized_target_config));
+}
+
+std::string IncrementalCompilationCache::GetBinaryKey(
+    llvm::Module& llvm_module, const se::GpuComputeCapability& gpu_version,
+    bool relocatable, const HloModuleConfig& module_config) {
+  std::string gpu_version_string = std::visit(
+      [](const auto& cc) { return cc.ToProto().SerializeAsString(); },
+      gpu_version);
+
+  // Blank out the names derived from the HLO module while printing the IR.
+  std::string module_identifier = llvm_module.getModuleIdentifier();
+  std::string source_file_name = llvm_module.getSourceFileName();
+  llvm_module.setModuleIdentifier("");
+  llvm_module.setSourceFileName("");
+  std::string llvm_ir = llvm_ir::DumpToString(&llvm_module);
+  llvm_module.setModuleIdentifier(module_identifier);
+  llvm_module.setSourceFileName(source_file_name);
+
+  return FingerprintToString(absl::StrCat(
+      gpu_version_string, "\nrelocatable=", relocatable, "\n",
+      module_config.compilation_cache_key(), "\n", llvm_ir));
+}
+
+std::unique_ptr<HloModule> IncrementalCompilationCache::LookupOptimizedModule(
+    absl::string_view key, absl::string_view name) {
+  absl::MutexLock lock(&mu_);
+  auto it = hlo_modules_.find(key);
+  if (it == hlo_modules_.end()) {
+    VLOG(2) << "Incremental compilation cache miss for HLO module " << name;
+    return nullptr;
+  }
+  VLOG(2) << "Incremental compilation cache hit for HLO module " << name;
+  // An empty suffix keeps the names of all computations and instructions.
+  std::unique_ptr<HloModule> module = it->second->Clone(/*suffix=*/"");
+  module->set_name(std::string(name));
+  return module;
+}
+
+void IncrementalCompilationCache::InsertOptimizedModule(
+    absl::string_view key, const HloModule& optimized_module) {
+  std::unique_ptr<HloModule> copy = optimized_module.Clone(/*suffix=*/"");
+  absl::MutexLock lock(&mu_);
+  InsertWithEviction(key, std::move(copy), max_hlo_modules_, hlo_modules_,
+                     hlo_module_keys_);
+}
+
+std::optional<IncrementalCompilationCache::BackendCompileResult>
+IncrementalCompilationCache::LookupBinary(absl::string_view key) {
+  absl::MutexLock lock(&mu_);
+  auto it = binaries_.find(key);
+  if (it == binaries_.end()) {
+    VLOG(3) << "Incremental compilation cache miss for binary " << key;
+    return std::nullopt;
+  }
+  VLOG(3) << "Incremental compilation cache hit for binary " << key;
+  return it->second;
+}
+
+void IncrementalCompilationCache::InsertBinary(absl::string_view key,
+                                               BackendCompileResult binary) {
+  absl::MutexLock lock(&mu_);
+  InsertWithEviction(key, std::move(binary), max_binaries_, binaries_,
+                     binary_keys_);
+}
+
+}  // namespace gpu
+}  // namespace xla
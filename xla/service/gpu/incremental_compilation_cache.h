@@ -0,0 +1,115 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef XLA_SERVICE_GPU_INCREMENTAL_COMPILATION_CACHE_H_
+#define XLA_SERVICE_GPU_INCREMENTAL_COMPILATION_CACHE_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/stream_executor/device_description.h"
+
+namespace llvm {
+class Module;
+}  // namespace llvm
+
+namespace xla {
+namespace gpu {
+
+// An in-memory cache of intermediate compilation results shared by successive
+// compilations in the same process, used when
+// --xla_gpu_enable_incremental_compilation is set.
+//
+// Workloads such as interactive notebooks and hyperparameter sweeps recompile
+// nearly identical modules over and over. Two levels of results are reused:
+//
+//  * Optimized HLO, keyed by the name-independent fingerprint of the
+//    unoptimized module and everything else that influences the HLO passes.
+//    A hit skips RunHloPasses entirely.
+//  * Compiled binaries of the LLVM modules produced by splitting the emitted
+//    IR for parallel compilation, keyed by the fingerprint of the unoptimized
+//    IR. When only part of a module changes, the partitions whose kernels are
+//    unchanged skip the LLVM pipeline and ptxas, and only the rest is
+//    re-lowered.
+//
+// Both levels hold at most a fixed number of entries and evict the oldest
+// entry first.
+//
+// Thread-safe.
+class IncrementalCompilationCache {
+ public:
+  // The PTX (or other assembly) and the binary of a compiled LLVM module, as
+  // returned by `GpuCompiler::CompileTargetBinary`.
+  using BackendCompileResult = std::pair<std::string, std::vector<uint8_t>>;
+
+  explicit IncrementalCompilationCache(int64_t max_hlo_modules = 16,
+                                       int64_t max_binaries = 1024)
+      : max_hlo_modules_(max_hlo_modules), max_binaries_(max_binaries) {}
+
+  // Returns the key for the optimized version of the unoptimized `module`
+  // compiled for the target described by `target_config`.
+  static std::string GetHloKey(const HloModule& module,
+                               const se::GpuTargetConfigProto& target_config);
+
+  // Returns the key for the binary of `llvm_module`, which must not have been
+  // optimized yet. The module identifier and source file name are not part of
+  // the key.
+  static std::string GetBinaryKey(llvm::Module& llvm_module,
+                                  const se::GpuComputeCapability& gpu_version,
+                                  bool relocatable,
+                                  const HloModuleConfig& module_config);
+
+  // Returns a copy of the optimized module stored for `key`, named `name`, or
+  // nullptr on a miss.
+  std::unique_ptr<HloModule> LookupOptimizedModule(absl::string_view key,
+                                                   absl::string_view name);
+
+  // Stores a copy of `optimized_module` for `key`.
+  void InsertOptimizedModule(absl::string_view key,
+                             const HloModule& optimized_module);
+
+  // Returns the binary stored for `key`, or std::nullopt on a miss.
+  std::optional<BackendCompileResult> LookupBinary(absl::string_view key);
+
+  // Stores `binary` for `key`.
+  void InsertBinary(absl::string_view key, BackendCompileResult binary);
+
+ private:
+  const int64_t max_hlo_modules_;
+  const int64_t max_binaries_;
+
+  absl::Mutex mu_;
+  absl::flat_hash_map<std::string, std::unique_ptr<HloModule>> hlo_modules_
+      ABSL_GUARDED_BY(mu_);
+  std::deque<std::string> hlo_module_keys_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, BackendCompileResult> binaries_
+      ABSL_GUARDED_BY(mu_);
+  std::deque<std::string> binary_keys_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_INCREMENTAL_COMPILATION_CACHE_H_
@@ -0,0 +1,156 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/gpu/incremental_compilation_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/stream_executor/device_description.pb.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr char kHlo[] = R"(
+HloModule module_a
+
+ENTRY main {
+  p0 = f32[16] parameter(0)
+  p1 = f32[16] parameter(1)
+  ROOT add = f32[16] add(p0, p1)
+})";
+
+constexpr char kRenamedHlo[] = R"(
+HloModule module_b
+
+ENTRY main {
+  p0 = f32[16] parameter(0)
+  p1 = f32[16] parameter(1)
+  ROOT add = f32[16] add(p0, p1)
+})";
+
+constexpr char kChangedHlo[] = R"(
+HloModule module_a
+
+ENTRY main {
+  p0 = f32[16] parameter(0)
+  p1 = f32[16] parameter(1)
+  ROOT multiply = f32[16] multiply(p0, p1)
+})";
+
+// Returns a module named `name` with a single empty kernel.
+std::unique_ptr<llvm::Module> CreateLlvmModule(llvm::LLVMContext& context,
+                                               const std::string& name) {
+  auto module = std::make_unique<llvm::Module>(name, context);
+  module->setSourceFileName(name);
+  llvm::Function* function = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+      llvm::GlobalValue::ExternalLinkage, "fusion", module.get());
+  llvm::IRBuilder<> builder(
+      llvm::BasicBlock::Create(context, "entry", function));
+  builder.CreateRetVoid();
+  return module;
+}
+
+using IncrementalCompilationCacheTest = HloTestBase;
+
+TEST_F(IncrementalCompilationCacheTest, HloKeyIgnoresModuleName) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  TF_ASSERT_OK_AND_ASSIGN(auto renamed,
+                          ParseAndReturnVerifiedModule(kRenamedHlo));
+  TF_ASSERT_OK_AND_ASSIGN(auto changed,
+                          ParseAndReturnVerifiedModule(kChangedHlo));
+  se::GpuTargetConfigProto target_config;
+
+  EXPECT_EQ(IncrementalCompilationCache::GetHloKey(*module, target_config),
+            IncrementalCompilationCache::GetHloKey(*renamed, target_config));
+  EXPECT_NE(IncrementalCompilationCache::GetHloKey(*module, target_config),
+            IncrementalCompilationCache::GetHloKey(*changed, target_config));
+
+  se::GpuTargetConfigProto other_target_config;
+  other_target_config.set_platform_name("other");
+  EXPECT_NE(
+      IncrementalCompilationCache::GetHloKey(*module, target_config),
+      IncrementalCompilationCache::GetHloKey(*module, other_target_config));
+}
+
+TEST_F(IncrementalCompilationCacheTest, OptimizedModuleHitIsRenamedCopy) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+  IncrementalCompilationCache cache;
+  std::string key = IncrementalCompilationCache::GetHloKey(
+      *module, se::GpuTargetConfigProto());
+
+  EXPECT_EQ(cache.LookupOptimizedModule(key, "module_b"), nullptr);
+  cache.InsertOptimizedModule(key, *module);
+
+  std::unique_ptr<HloModule> hit = cache.LookupOptimizedModule(key, "module_b");
+  ASSERT_NE(hit, nullptr);
+  EXPECT_EQ(hit->name(), "module_b");
+  EXPECT_EQ(hit->entry_computation()->root_instruction()->name(), "add");
+  EXPECT_EQ(hit->GetFingerprint128(), module->GetFingerprint128());
+}
+
+TEST_F(IncrementalCompilationCacheTest, BinaryKeyIgnoresModuleIdentifier) {
+  llvm::LLVMContext context;
+  std::unique_ptr<llvm::Module> module_a = CreateLlvmModule(context, "a");
+  std::unique_ptr<llvm::Module> module_b = CreateLlvmModule(context, "b");
+  se::GpuComputeCapability cc = se::CudaComputeCapability(8, 0);
+  HloModuleConfig config;
+
+  std::string key = IncrementalCompilationCache::GetBinaryKey(
+      *module_a, cc, /*relocatable=*/false, config);
+  EXPECT_EQ(module_a->getModuleIdentifier(), "a");
+  EXPECT_EQ(key, IncrementalCompilationCache::GetBinaryKey(
+                     *module_b, cc, /*relocatable=*/false, config));
+  EXPECT_NE(key, IncrementalCompilationCache::GetBinaryKey(
+                     *module_a, cc, /*relocatable=*/true, config));
+  EXPECT_NE(key, IncrementalCompilationCache::GetBinaryKey(
+                     *module_a, se::CudaComputeCapability(9, 0),
+                     /*relocatable=*/false, config));
+}
+
+TEST_F(IncrementalCompilationCacheTest, EvictsOldestBinary) {
+  IncrementalCompilationCache cache(/*max_hlo_modules=*/1,
+                                    /*max_binaries=*/2);
+  cache.InsertBinary("a", {"ptx_a", {1}});
+  cache.InsertBinary("b", {"ptx_b", {2}});
+  cache.InsertBinary("c", {"ptx_c", {3}});
+
+  EXPECT_FALSE(cache.LookupBinary("a").has_value());
+  std::optional<IncrementalCompilationCache::BackendCompileResult> hit =
+      cache.LookupBinary("c");
+  ASSERT_TRUE(hit.has_value());
+  EXPECT_EQ(hit->first, "ptx_c");
+  EXPECT_THAT(hit->second, ElementsAre(3));
+  EXPECT_TRUE(cache.LookupBinary("b").has_value());
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
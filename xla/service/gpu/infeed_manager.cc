@@ -15,9 +15,14 @@ limitations under the License.
 
 #include "xla/service/gpu/infeed_manager.h"
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <utility>
 
 #include "xla/shape_util.h"
+#include "xla/util.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "xla/service/gpu/xla_executor_state.h"
@@ -29,29 +34,78 @@ namespace gpu {
 
 constexpr int kMaxInfeedsInFlight = 8;
 
+// Alignment of the leaves of an infeed literal within its slot.
+constexpr int64_t kInfeedLeafAlignment = 64;
+
 InfeedManager::InfeedManager(se::StreamExecutor* executor)
     : BlockingXfeedQueue(/*max_pending_xfeeds=*/kMaxInfeedsInFlight),
-      stream_(std::make_unique<se::Stream>(executor)) {
+      executor_(executor),
+      stream_(std::make_unique<se::Stream>(executor)),
+      slots_(kMaxInfeedsInFlight) {
   stream_->Init();
+  for (int i = 0; i < kMaxInfeedsInFlight; ++i) {
+    slots_[i].ready = std::make_unique<se::Event>(executor);
+    slots_[i].ready->Init();
+    free_slots_.push_back(i);
+  }
 }
 
-static StatusOr<se::ScopedDeviceMemory<uint8_t>> CopyBufferToDevice(
-    se::Stream* stream, int64_t size, const void* source) {
-  if (size > std::numeric_limits<int32_t>::max()) {
-    return InvalidArgument("GPU infeed of %d bytes exceeds maximum of %d bytes",
-                           size, std::numeric_limits<int32_t>::max());
+InfeedManager::~InfeedManager() {
+  Status status = stream_->BlockHostUntilDone();
+  if (!status.ok()) {
+    LOG(ERROR) << "Failed to complete infeed transfers: " << status;
+  }
+  for (Slot& slot : slots_) {
+    if (slot.host_buffer != nullptr) {
+      executor_->HostMemoryDeallocate(slot.host_buffer);
+    }
   }
+}
 
-  if (size == 0) {
-    return InvalidArgument("Infeed shape needs 0 bytes");
+int InfeedManager::AcquireSlot() {
+  absl::MutexLock lock(&slots_mu_);
+  while (free_slots_.empty()) {
+    slot_released_.Wait(&slots_mu_);
   }
+  int slot = free_slots_.back();
+  free_slots_.pop_back();
+  return slot;
+}
 
-  se::StreamExecutor* executor = stream->parent();
-  se::ScopedDeviceMemory<uint8_t> buffer(
-      executor, executor->AllocateArray<uint8_t>(size));
-  stream->ThenMemcpy(buffer.ptr(), source, size);
+void InfeedManager::ReleaseSlot(int slot) {
+  absl::MutexLock lock(&slots_mu_);
+  free_slots_.push_back(slot);
+  slot_released_.Signal();
+}
+
+void InfeedManager::ThenReleaseSlot(se::Stream* stream, int slot) {
+  stream->ThenDoHostCallback([this, slot]() { ReleaseSlot(slot); });
+}
+
+Status InfeedManager::ReserveSlot(Slot& slot, int64_t size) {
+  if (size <= slot.capacity) {
+    return OkStatus();
+  }
+  // The slot is free, so nothing on the device uses its buffers anymore.
+  if (slot.host_buffer != nullptr) {
+    executor_->HostMemoryDeallocate(slot.host_buffer);
+  }
+  slot.device_buffer = se::ScopedDeviceMemory<uint8_t>();
+  slot.capacity = 0;
 
-  return std::move(buffer);
+  slot.host_buffer = executor_->HostMemoryAllocate(size);
+  if (slot.host_buffer == nullptr) {
+    return ResourceExhausted(
+        "Failed to allocate %d bytes of pinned host memory for infeed", size);
+  }
+  slot.device_buffer = se::ScopedDeviceMemory<uint8_t>(
+      executor_, executor_->AllocateArray<uint8_t>(size));
+  if (slot.device_buffer.is_null()) {
+    return ResourceExhausted(
+        "Failed to allocate %d bytes of device memory for infeed", size);
+  }
+  slot.capacity = size;
+  return OkStatus();
 }
 
 Status InfeedManager::TransferLiteralToInfeed(se::StreamExecutor* executor,
@@ -60,30 +114,63 @@ Status InfeedManager::TransferLiteralToInfeed(se::StreamExecutor* executor,
   VLOG(2) << "Transferring literal to infeed with shape: "
           << ShapeUtil::HumanString(literal_shape);
 
-  BlockUntilEnqueueSlotAvailable();
-
-  // For a tuple, we transfer each of its elements to the device and enqueue the
-  // resulting destination device addresses with the infeed manager.
-  ShapeTree<se::ScopedDeviceMemory<uint8_t>> buffer_tree(literal_shape);
-  for (auto& leaf : buffer_tree.leaves()) {
+  // For a tuple, each of its elements is placed at its own offset in the slot,
+  // and the resulting device addresses are enqueued with the infeed manager.
+  ShapeTree<int64_t> offsets(literal_shape);
+  int64_t total_size = 0;
+  for (auto& leaf : offsets.leaves()) {
     const Shape& sub_shape = ShapeUtil::GetSubshape(literal_shape, leaf.first);
     CHECK(sub_shape.IsArray()) << ShapeUtil::HumanStringWithLayout(sub_shape);
-    TF_ASSIGN_OR_RETURN(
-        leaf.second,
-        CopyBufferToDevice(stream(), ShapeUtil::ByteSizeOf(sub_shape),
-                           literal.untyped_data(leaf.first)));
+    int64_t size = ShapeUtil::ByteSizeOf(sub_shape);
+    if (size > std::numeric_limits<int32_t>::max()) {
+      return InvalidArgument(
+          "GPU infeed of %d bytes exceeds maximum of %d bytes", size,
+          std::numeric_limits<int32_t>::max());
+    }
+    if (size == 0) {
+      return InvalidArgument("Infeed shape needs 0 bytes");
+    }
+    leaf.second = total_size;
+    total_size = RoundUpTo(total_size + size, kInfeedLeafAlignment);
+  }
+
+  BlockUntilEnqueueSlotAvailable();
+
+  // Blocks until the copies out of the slot for an earlier literal complete,
+  // after which its pinned buffer can be overwritten.
+  int slot_index = AcquireSlot();
+  Slot& slot = slots_[slot_index];
+  Status reserve_status = ReserveSlot(slot, total_size);
+  if (!reserve_status.ok()) {
+    ReleaseSlot(slot_index);
+    return reserve_status;
+  }
+
+  InfeedBuffers infeed;
+  infeed.buffers = ShapeTree<se::DeviceMemoryBase>(literal_shape);
+  for (auto& leaf : infeed.buffers.leaves()) {
+    int64_t offset = offsets.element(leaf.first);
+    int64_t size = ShapeUtil::ByteSizeOf(
+        ShapeUtil::GetSubshape(literal_shape, leaf.first));
+    std::memcpy(static_cast<char*>(slot.host_buffer) + offset,
+                literal.untyped_data(leaf.first), size);
+    leaf.second = se::DeviceMemoryBase(
+        static_cast<char*>(slot.device_buffer->opaque()) + offset, size);
   }
 
-  // TODO(b/30467474): Since this stream is shared across different infeed
-  // requests, blocking on the stream might be heavy-handed. Figure out if
-  // finer-grained acknowledgement is possible.
-  Status block_status = stream()->BlockHostUntilDone();
-  if (!block_status.ok()) {
-    return InternalError("Failed to complete data transfer on stream %p: %s",
-                         stream(), block_status.message());
+  // All the leaves are transferred with a single copy, and the consumer waits
+  // for the event instead of the host blocking on the stream.
+  stream()->ThenMemcpy(slot.device_buffer.ptr(), slot.host_buffer, total_size);
+  stream()->ThenRecordEvent(slot.ready.get());
+  if (!stream()->ok()) {
+    ReleaseSlot(slot_index);
+    return InternalError("Failed to enqueue data transfer on stream %p",
+                         stream());
   }
 
-  EnqueueDestination(std::move(buffer_tree));
+  infeed.ready = slot.ready.get();
+  infeed.slot = slot_index;
+  EnqueueDestination(std::move(infeed));
   return OkStatus();
 }
 
@@ -20,7 +20,12 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_INFEED_MANAGER_H_
 #define XLA_SERVICE_GPU_INFEED_MANAGER_H_
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/literal.h"
 #include "xla/service/gpu/xfeed_queue.h"
 #include "xla/shape_tree.h"
@@ -36,26 +41,64 @@ namespace gpu {
 //
 // Current limitations:
 // * Does not handle multiple devices/replicas.
-//
-// * Buffer space on GPU is allocated on every infeed enqueue request,
-// and it does not handle the case when it runs out of
-// memory. Potential solution is to pre-allocate a fixed amount of
-// memory and block when that memory is full.
+
+// An infeed literal enqueued by the client. The device buffers of its leaves
+// live in slot `slot` of the infeed manager, and are valid once `ready` has
+// been reached on the infeed stream.
+struct InfeedBuffers {
+  ShapeTree<se::DeviceMemoryBase> buffers;
+  se::Event* ready = nullptr;
+  int slot = -1;
+};
 
 // Client-side class used to enqueue infeed buffers.
-class InfeedManager
-    : public BlockingXfeedQueue<ShapeTree<se::ScopedDeviceMemory<uint8_t>>> {
+//
+// Literals are staged through a ring of slots, each made of a pinned host
+// buffer and a device buffer that grow to the largest literal they held. The
+// client copies a literal into the pinned buffer of a free slot, and the
+// transfer to the device buffer is enqueued on a dedicated stream without
+// waiting for it. The consumer makes its stream wait for the `ready` event
+// instead of blocking the host, and hands the slot back once its copies are
+// enqueued, which frees it when they complete.
+class InfeedManager : public BlockingXfeedQueue<InfeedBuffers> {
  public:
   explicit InfeedManager(se::StreamExecutor* executor);
+  ~InfeedManager() override;
 
   Status TransferLiteralToInfeed(se::StreamExecutor* executor,
                                  const LiteralSlice& literal);
 
+  // Frees the slot of an infeed literal when the work enqueued so far on
+  // `stream` (usually the copies out of its buffers) completes.
+  void ThenReleaseSlot(se::Stream* stream, int slot);
+
  private:
+  struct Slot {
+    void* host_buffer = nullptr;
+    se::ScopedDeviceMemory<uint8_t> device_buffer;
+    int64_t capacity = 0;
+    std::unique_ptr<se::Event> ready;
+  };
+
   se::Stream* stream() const { return stream_.get(); }
 
+  // Blocks until a slot is free and returns its index.
+  int AcquireSlot();
+  void ReleaseSlot(int slot);
+
+  // Makes sure that `slot` can hold `size` bytes.
+  Status ReserveSlot(Slot& slot, int64_t size);
+
+  se::StreamExecutor* executor_;
+
   // Stream used to enqueue infeed device copies.
   std::unique_ptr<se::Stream> stream_;
+
+  std::vector<Slot> slots_;
+
+  absl::Mutex slots_mu_;
+  absl::CondVar slot_released_;
+  std::vector<int> free_slots_ ABSL_GUARDED_BY(slots_mu_);
 };
 
 // Returns the GPU infeed manager for the given stream executor,
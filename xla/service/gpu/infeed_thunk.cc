@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/gpu/infeed_thunk.h"
 
+#include "absl/cleanup/cleanup.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/gpu/buffer_allocations.h"
 #include "xla/service/gpu/infeed_manager.h"
@@ -35,14 +36,23 @@ Status InfeedThunk::ExecuteOnStream(const ExecuteParams& params) {
   const BufferAllocations& buffer_allocations = *params.buffer_allocations;
 
   VLOG(2) << "Infeeding to GPU";
-  ShapeTree<se::ScopedDeviceMemory<uint8_t>> source_buffers =
-      GetOrCreateInfeedManager(stream.parent())->BlockingGetNextDestination();
+  InfeedManager* infeed_manager = GetOrCreateInfeedManager(stream.parent());
+  InfeedBuffers infeed = infeed_manager->BlockingGetNextDestination();
+  const ShapeTree<se::DeviceMemoryBase>& source_buffers = infeed.buffers;
+
+  // The transfer to the device was enqueued on the infeed stream, and may
+  // still be in flight. The slot of the literal is reused once the copies out
+  // of it complete, so the host does not need to wait for them.
+  absl::Cleanup release_slot = [&] {
+    infeed_manager->ThenReleaseSlot(&stream, infeed.slot);
+  };
+  stream.ThenWaitFor(infeed.ready);
 
   size_t index = 0;
   for (auto& source : source_buffers.leaves()) {
     // Assert that the shapes are compatible.
     const ShapeIndex& shape_index = source.first;
-    se::ScopedDeviceMemory<uint8_t>& buffer = source.second;
+    const se::DeviceMemoryBase& buffer = source.second;
     const Shape& source_shape =
         ShapeUtil::GetSubshape(source_buffers.shape(), shape_index);
     TF_RET_CHECK(ShapeUtil::Equal(dest_slices_[index].shape, source_shape))
@@ -52,17 +62,16 @@ Status InfeedThunk::ExecuteOnStream(const ExecuteParams& params) {
         << ShapeUtil::HumanStringWithLayout(dest_slices_[index].shape);
     se::DeviceMemoryBase dest_address =
         buffer_allocations.GetDeviceAddress(dest_slices_[index++].slice);
-    stream.ThenMemcpy(&dest_address, *buffer.ptr(), buffer.ptr()->size());
+    stream.ThenMemcpy(&dest_address, buffer, buffer.size());
   }
 
   // Make sure that all dest slices have been copied into.
   CHECK_EQ(index, dest_slices_.size())
       << "Infeed did not populate all destination buffers";
 
-  Status block_status = stream.BlockHostUntilDone();
-  if (!block_status.ok()) {
-    return InternalError("Failed to complete data transfer on stream %p: %s",
-                         &stream, block_status.message());
+  if (!stream.ok()) {
+    return InternalError("Failed to enqueue data transfer on stream %p",
+                         &stream);
   }
 
   VLOG(2) << "Infeeding to GPU complete";
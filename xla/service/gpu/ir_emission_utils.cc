@@ -111,6 +111,8 @@ bool IsMatrixMultiplication(const HloInstruction& dot) {
 }
 
 const char* const kCusolverCholeskyCallTarget = "__cusolver$cholesky";
+const char* const kCusolverSyevjBatchedCallTarget =
+    "__cusolver$syevj_batched";
 
 bool IsCustomCallToCusolver(const HloInstruction& hlo) {
   if (hlo.opcode() != HloOpcode::kCustomCall) {
@@ -663,6 +665,14 @@ std::optional<TransposeDescription> FindTiledTranspose(
 }
 
 // Find 021 or 210 transpose in logical + physical transposition.
+//
+// Permutations that keep the minor-most dimension in place (e.g. the 0213
+// head shuffle in attention) don't normalize to either form and are emitted
+// by the loop emitter. Their reads and writes both stay contiguous along the
+// kept dimension, so tiling through shared memory only pays off when that
+// dimension is narrower than a memory transaction. That case would need a
+// tiling of the two swapped dimensions over vectors of the kept one, which the
+// 3D tiling scheme of the transpose emitter can't express.
 std::optional<TransposeDescription> FindTiledLogicalTranspose(
     const HloInstruction& instr) {
   if (instr.opcode() != HloOpcode::kTranspose) {
@@ -71,6 +71,12 @@ bool IsCustomCallToCusolver(const HloInstruction& hlo);
 // is a success/failure code per batch element.
 extern const char* const kCusolverCholeskyCallTarget;
 
+// Batched eigendecomposition of small Hermitian matrices. Takes a (batched)
+// matrix as input, and returns a tuple of (v, w, workspace, info), where v and
+// w are the eigenvectors and eigenvalues. Unlike Cholesky, this is a custom
+// call target registered for the CUDA platform.
+extern const char* const kCusolverSyevjBatchedCallTarget;
+
 // Returns whether unnested_hlo is an input fusion whose root is either a slice
 // or a tuple of slices. If verify_no_strides is true, returns false unless all
 // ROOT slices have no strides.
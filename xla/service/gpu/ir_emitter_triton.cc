@@ -158,6 +158,8 @@ Type TritonType(mlir::OpBuilder b, PrimitiveType t) {
       return b.getI1Type();
     case S8:
       return b.getI8Type();
+    case S4:
+      return b.getIntegerType(4);
     default:
       LOG(FATAL) << "This type is not supported yet: "
                  << primitive_util::LowercasePrimitiveTypeName(t);
@@ -165,7 +167,7 @@ Type TritonType(mlir::OpBuilder b, PrimitiveType t) {
 }
 
 Type StorageType(mlir::OpBuilder b, Type t) {
-  if (t.isInteger(1)) {
+  if (t.isInteger(1) || t.isInteger(4)) {
     return b.getI8Type();
   }
   return t;
@@ -426,22 +428,30 @@ Value EmitElementwise(ImplicitLocOpBuilder& b, absl::string_view libdevice_path,
 }
 
 Value EmitParameterLoad(ImplicitLocOpBuilder& b, Value pointer,
-                        ArrayRef<int32_t> boundary_checks) {
+                        ArrayRef<int32_t> boundary_checks,
+                        const HloInstruction& parameter) {
+  Value load;
   if (mt::isTensorPointerType(pointer.getType())) {
     std::optional<mt::PaddingOption> padding;
     if (!boundary_checks.empty()) {
       padding = mt::PaddingOption::PAD_ZERO;
     }
-    return b.create<mt::LoadOp>(pointer, boundary_checks, padding,
+    load = b.create<mt::LoadOp>(pointer, boundary_checks, padding,
                                 mt::CacheModifier::NONE,
                                 mt::EvictionPolicy::NORMAL,
                                 /*isVolatile=*/false);
+  } else {
+    load = Splat(b,
+                 b.create<mt::LoadOp>(pointer, mt::CacheModifier::NONE,
+                                      mt::EvictionPolicy::NORMAL,
+                                      /*isVolatile=*/false),
+                 {});
+  }
+  // S4 values are stored one per byte; only the low bits are significant.
+  if (parameter.shape().element_type() == S4) {
+    load = Cast(b, load, TritonType(b, S4));
   }
-  return Splat(b,
-               b.create<mt::LoadOp>(pointer, mt::CacheModifier::NONE,
-                                    mt::EvictionPolicy::NORMAL,
-                                    /*isVolatile=*/false),
-               {});
+  return load;
 }
 
 Value EmitConstant(ImplicitLocOpBuilder& b, const HloInstruction& constant) {
@@ -1351,7 +1361,8 @@ Status EmitMatMul(mlir::OpBuilder builder, absl::string_view libdevice_path,
       CHECK(values
                 .insert({iter_args_to_parameters[i],
                          EmitParameterLoad(b, iter_args[i],
-                                           iter_args_to_boundary_checks[i])})
+                                           iter_args_to_boundary_checks[i],
+                                           *iter_args_to_parameters[i])})
                 .second);
       SmallVector<Value> increments;
       for (const DimProperties& dim : side.tiled_dims) {
@@ -1464,7 +1475,8 @@ Status EmitMatMul(mlir::OpBuilder builder, absl::string_view libdevice_path,
           boundary_checks);
       CHECK(values_out
                 .insert({parameter,
-                         EmitParameterLoad(b, tensor_pointer, boundary_checks)})
+                         EmitParameterLoad(b, tensor_pointer, boundary_checks,
+                                           *parameter)})
                 .second);
     }
     TF_RETURN_IF_ERROR(EmitScope(b, libdevice_path, &analysis,
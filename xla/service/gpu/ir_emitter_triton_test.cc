@@ -1021,6 +1021,33 @@ ENTRY e {
   EXPECT_TRUE(RunAndCompare(kHloText, ErrorSpec{/*aabs=*/1e-1, /*arel=*/1e-3}));
 }
 
+TEST_F(TritonGemmLevel2Test, Int4WeightDequantizationIsFused) {
+  const std::string kHloText = R"(
+HloModule m
+
+ENTRY e {
+  p0 = bf16[16,128] parameter(0)
+  p1 = s4[128,64] parameter(1)
+  p2 = bf16[64] parameter(2)
+  c = bf16[128,64] convert(p1)
+  b = bf16[128,64] broadcast(p2), dimensions={1}
+  w = bf16[128,64] multiply(c, b)
+  ROOT d = bf16[16,64] dot(p0, w),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          GetOptimizedModule(kHloText));
+
+  // The int4 weights are read by the GEMM kernel itself.
+  EXPECT_THAT(
+      module->entry_computation()->root_instruction(),
+      GmockMatch(m::Fusion(m::Parameter(), m::Parameter(), m::Parameter())
+                     .WithFusionKind(HloInstruction::FusionKind::kCustom)));
+
+  EXPECT_TRUE(RunAndCompare(kHloText, ErrorSpec{/*aabs=*/1e-1, /*arel=*/1e-2}));
+}
+
 TEST_F(TritonGemmLevel2Test, BinaryOperationWithLargeInputsIsNotFused) {
   const std::string kHloText = R"(
 HloModule m
@@ -112,6 +112,7 @@ limitations under the License.
 #include "xla/service/gpu/nccl_all_to_all_thunk.h"
 #include "xla/service/gpu/nccl_collective_permute_thunk.h"
 #include "xla/service/gpu/nccl_collective_thunk.h"
+#include "xla/service/gpu/nccl_group_thunk.h"
 #include "xla/service/gpu/outfeed_thunk.h"
 #include "xla/service/gpu/parallel_loop_emitter.h"
 #include "xla/service/gpu/replica_id_thunk.h"
@@ -324,6 +325,52 @@ int DeriveNumWarpsFromTritonSoftmaxComputation(
   return num_warps;
 }
 
+// Number of consecutive updates a thread of a scatter with sorted indices
+// combines before it writes to the output.
+constexpr int64_t kSortedScatterUpdatesPerThread = 32;
+
+// Returns whether `scatter` is emitted by `EmitSortedScatter`: the scatter
+// indices are sorted but may repeat, and the scatter is in the canonical form
+// produced by ScatterSimplifier, with the updates ordered along their major
+// dimension.
+bool IsSortedScatter(const HloScatterInstruction& scatter) {
+  if (!scatter.indices_are_sorted() || scatter.unique_indices() ||
+      scatter.scatter_operand_count() != 1) {
+    return false;
+  }
+  const ScatterDimensionNumbers& dnums = scatter.scatter_dimension_numbers();
+  const Shape& indices_shape = scatter.scatter_indices()->shape();
+  const Shape& updates_shape = scatter.scatter_updates()[0]->shape();
+  if (indices_shape.rank() != 2 || dnums.index_vector_dim() != 1 ||
+      !dnums.inserted_window_dims().empty() ||
+      dnums.update_window_dims_size() != updates_shape.rank() - 1) {
+    return false;
+  }
+  for (int64_t i = 0; i < dnums.update_window_dims_size(); ++i) {
+    if (dnums.update_window_dims(i) != i + 1) {
+      return false;
+    }
+  }
+  for (int64_t i = 0; i < dnums.scatter_dims_to_operand_dims_size(); ++i) {
+    if (dnums.scatter_dims_to_operand_dims(i) != i) {
+      return false;
+    }
+  }
+  return updates_shape.dimensions(0) >= 2 * kSortedScatterUpdatesPerThread;
+}
+
+// Returns the shape iterated over by the scatter kernel: every element of the
+// updates, or for sorted scatters, every window element of every run of
+// `kSortedScatterUpdatesPerThread` updates.
+Shape GetScatterLoopShape(const HloScatterInstruction& scatter) {
+  Shape shape = scatter.scatter_updates()[0]->shape();
+  if (IsSortedScatter(scatter)) {
+    shape.set_dimensions(
+        0, CeilOfRatio(shape.dimensions(0), kSortedScatterUpdatesPerThread));
+  }
+  return shape;
+}
+
 }  // namespace
 
 IrEmitterUnnested::IrEmitterUnnested(IrEmitterContext* ir_emitter_context)
@@ -1044,13 +1091,20 @@ Status IrEmitterUnnested::EmitCubDeviceRadixSort(mlir::Operation* op) {
   TF_ASSIGN_OR_RETURN(BufferAllocation::Slice scratch,
                       GetAllocationSlice(radix_sort_op.getScratch()));
 
+  // Multi-dimensional inputs are sorted along their minor-most dimension.
+  const Shape keys_shape = GetShape(op->getOperand(0));
+  int64_t batch_size =
+      keys_shape.rank() > 1
+          ? ShapeUtil::ElementsIn(keys_shape) /
+                keys_shape.dimensions(keys_shape.rank() - 1)
+          : 1;
+
   auto thunk = std::make_unique<CubSortThunk>(
-      Thunk::ThunkInfo::WithProfileAnnotation(op),
-      GetShape(op->getOperand(0)).element_type(),
+      Thunk::ThunkInfo::WithProfileAnnotation(op), keys_shape.element_type(),
       radix_sort_op.getInputs().size() == 2
           ? std::optional(GetShape(op->getOperand(1)).element_type())
           : std::nullopt,
-      operands, results, scratch, radix_sort_op.getDescending());
+      operands, results, scratch, radix_sort_op.getDescending(), batch_size);
 
   AddThunkToThunkSequence(std::move(thunk));
   return OkStatus();
@@ -2278,10 +2332,11 @@ Status IrEmitterUnnested::EmitScatter(
         /*destination_value=*/scatter_op.getOutput()));
   }
 
-  const Shape& data_shape = GetShape(scatter_op.getUpdates());
+  const Shape loop_shape =
+      GetScatterLoopShape(*Cast<HloScatterInstruction>(hlo_for_lmhlo.at(op)));
   TF_ASSIGN_OR_RETURN(LaunchDimensions launch_dimensions,
                       CalculateLaunchDimensions(
-                          data_shape, ir_emitter_context_->gpu_device_info()));
+                          loop_shape, ir_emitter_context_->gpu_device_info()));
 
   // Create kernel thunk for all operands except the first one (`operand`). The
   // code generated for scatter below assumes that the input operand is already
@@ -2339,6 +2394,7 @@ Status IrEmitterUnnested::EmitScatter(
   desc.updates_shape = GetShape(scatter.getUpdates());
   desc.dim_numbers = scatter.getScatterDimensionNumbers();
   desc.unique_indices = scatter.getUniqueIndices();
+  desc.sorted_indices = IsSortedScatter(*hlo_scatter);
   desc.update_computation = hlo_scatter->called_computations().front();
   desc.output = output;
   desc.scatter_indices_gen = scatter_indices_gen;
@@ -2349,6 +2405,10 @@ Status IrEmitterUnnested::EmitScatter(
 
 Status IrEmitterUnnested::EmitScatter(
     const ScatterDescriptor& desc, const LaunchDimensions& launch_dimensions) {
+  if (desc.sorted_indices) {
+    return EmitSortedScatter(desc, launch_dimensions);
+  }
+
   auto loop_body_emitter = [&](const llvm_ir::IrArray::Index& index) -> Status {
     std::vector<llvm::Value*> raw_window_multidim;
     std::vector<llvm::Value*> input_scatter_multidim;
@@ -2482,6 +2542,134 @@ Status IrEmitterUnnested::EmitScatter(
                 desc.get_index_type(launch_dimensions.launch_bound()));
 }
 
+Status IrEmitterUnnested::EmitSortedScatter(
+    const ScatterDescriptor& desc, const LaunchDimensions& launch_dimensions) {
+  // Each thread walks a run of consecutive updates for one window element and
+  // accumulates them while they target the same index. Because the indices
+  // are sorted, every run of equal indices is written with a single atomic
+  // operation per thread instead of one per update.
+  const int64_t num_updates = desc.updates_shape.dimensions(0);
+  const int64_t index_vector_size = desc.scatter_indices_shape.dimensions(1);
+  llvm::Type* element_type = llvm_ir::PrimitiveTypeToIrType(
+      desc.updates_shape.element_type(), module_);
+  const bool indices_are_signed =
+      ShapeUtil::ElementIsSigned(desc.scatter_indices_shape);
+
+  Shape loop_shape = desc.updates_shape;
+  loop_shape.set_dimensions(
+      0, CeilOfRatio(num_updates, kSortedScatterUpdatesPerThread));
+
+  auto loop_body_emitter = [&](const llvm_ir::IrArray::Index& index) -> Status {
+    KernelSupportLibrary ksl(&b_);
+    llvm::Type* index_type = index.GetType();
+
+    llvm::Value* accumulator = llvm_ir::EmitAllocaAtFunctionEntry(
+        element_type, "scatter.accumulator", &b_);
+    llvm::Value* update_address = llvm_ir::EmitAllocaAtFunctionEntry(
+        element_type, "scatter.update", &b_);
+    llvm::Value* has_accumulator = llvm_ir::EmitAllocaAtFunctionEntry(
+        b_.getInt1Ty(), "scatter.has_accumulator", &b_);
+    Store(b_.getFalse(), has_accumulator);
+    std::vector<llvm::Value*> accumulator_index;
+    for (int64_t i = 0; i < index_vector_size; ++i) {
+      accumulator_index.push_back(llvm_ir::EmitAllocaAtFunctionEntry(
+          index_type, "scatter.accumulator_index", &b_));
+      Store(index.GetConstantWithIndexType(0), accumulator_index.back());
+    }
+
+    // Combines the accumulator into the output window at the accumulated
+    // scatter index.
+    auto write_accumulator = [&]() -> Status {
+      std::vector<llvm::Value*> output_multidim(index.multidim().begin() + 1,
+                                                index.multidim().end());
+      llvm::Value* is_in_bounds = b_.getTrue();
+      for (int64_t i = 0; i < index_vector_size; ++i) {
+        llvm::Value* scatter_index = Load(index_type, accumulator_index[i]);
+        output_multidim[i] = Add(output_multidim[i], scatter_index);
+        int64_t max_index = desc.operand_shape.dimensions(i) -
+                            desc.updates_shape.dimensions(i + 1) + 1;
+        is_in_bounds =
+            And(is_in_bounds,
+                ICmpULT(scatter_index,
+                        index.GetConstantWithIndexType(max_index)));
+      }
+      return ksl.IfWithStatus("scatter.in_bounds", is_in_bounds, [&] {
+        llvm_ir::IrArray::Index output_index(
+            output_multidim, desc.output.GetShape(), index_type);
+        llvm::Value* output_address =
+            desc.output.EmitArrayElementAddress(output_index, &b_);
+        return EmitAtomicOperationForNestedComputation(
+            &b_, *ir_emitter_context_, *desc.update_computation,
+            output_address, accumulator, desc.output.GetElementLlvmType());
+      });
+    };
+
+    llvm::Value* begin =
+        Mul(index[0],
+            index.GetConstantWithIndexType(kSortedScatterUpdatesPerThread));
+    llvm::Value* end =
+        Add(begin,
+            index.GetConstantWithIndexType(kSortedScatterUpdatesPerThread));
+    llvm::Value* num_updates_value =
+        index.GetConstantWithIndexType(num_updates);
+    end = Select(ICmpULT(end, num_updates_value), end, num_updates_value);
+
+    TF_RETURN_IF_ERROR(ksl.ForWithStatus(
+        "scatter.update", begin, end, /*step=*/1,
+        [&](llvm::Value* row) -> Status {
+          std::vector<llvm::Value*> row_index;
+          llvm::Value* same_index = Load(b_.getInt1Ty(), has_accumulator);
+          for (int64_t i = 0; i < index_vector_size; ++i) {
+            llvm_ir::IrArray::Index indices_index(
+                {row, index.GetConstantWithIndexType(i)},
+                desc.scatter_indices_shape, index_type);
+            TF_ASSIGN_OR_RETURN(llvm::Value* const loaded_scatter_index,
+                                desc.scatter_indices_gen(indices_index));
+            row_index.push_back(IntCast(loaded_scatter_index, index_type,
+                                        /*isSigned=*/indices_are_signed));
+            same_index =
+                And(same_index, ICmpEQ(row_index.back(),
+                                       Load(index_type, accumulator_index[i])));
+          }
+
+          std::vector<llvm::Value*> update_multidim = index.multidim();
+          update_multidim[0] = row;
+          TF_ASSIGN_OR_RETURN(
+              llvm::Value* const update,
+              desc.updates_gen(llvm_ir::IrArray::Index(
+                  update_multidim, desc.updates_shape, index_type)));
+
+          return ksl.IfWithStatus(
+              "scatter.same_index", same_index,
+              [&]() -> Status {
+                Store(update, update_address);
+                return CallNestedComputation(
+                    &b_, *ir_emitter_context_, *desc.update_computation,
+                    {accumulator, update_address}, accumulator);
+              },
+              [&]() -> Status {
+                TF_RETURN_IF_ERROR(ksl.IfWithStatus(
+                    "scatter.write", Load(b_.getInt1Ty(), has_accumulator),
+                    write_accumulator));
+                Store(update, accumulator);
+                for (int64_t i = 0; i < index_vector_size; ++i) {
+                  Store(row_index[i], accumulator_index[i]);
+                }
+                Store(b_.getTrue(), has_accumulator);
+                return OkStatus();
+              });
+        }));
+    return ksl.IfWithStatus("scatter.write",
+                            Load(b_.getInt1Ty(), has_accumulator),
+                            write_accumulator);
+  };
+
+  return ParallelLoopEmitter(loop_body_emitter, loop_shape, launch_dimensions,
+                             &b_)
+      .EmitLoop(desc.name,
+                desc.get_index_type(launch_dimensions.launch_bound()));
+}
+
 Status IrEmitterUnnested::EmitSort(
     mlir::Operation* op,
     const absl::flat_hash_map<const mlir::Operation*, const HloInstruction*>&
@@ -2550,8 +2738,25 @@ Status IrEmitterUnnested::EmitSort(
   // the array. To make this work, we collect all consecutive masks that are
   // smaller than our chosen power of 2 tile size, and pass them to SortInPlace.
   // Each thread then processes one tile of data.
-
-  const uint64_t kTileSize = std::min(2048ULL, 1ULL << num_stages);
+  //
+  // Use the largest tile that fits into the threads and the shared memory of a
+  // block. Sorts of many or wide operands then still combine the stages with
+  // small xor masks into one kernel, instead of launching one kernel per mask.
+  const se::DeviceDescription& device_info =
+      ir_emitter_context_->gpu_device_info();
+  int64_t bytes_per_element = 0;
+  for (int64_t i = 0; i < operands.size(); ++i) {
+    bytes_per_element += ShapeUtil::ByteSizeOfPrimitiveType(
+        GetShape(operands[i]).element_type());
+  }
+  uint64_t tile_size = std::min(2048ULL, 1ULL << num_stages);
+  while (tile_size > 2 &&
+         (tile_size / 2 > device_info.threads_per_block_limit() ||
+          tile_size * bytes_per_element >
+              device_info.shared_memory_per_block())) {
+    tile_size /= 2;
+  }
+  const uint64_t kTileSize = tile_size;
 
   // If we cannot combine several xor masks together, we don't use tiling, so we
   // calculate the standard launch dimensions for the shape. However we only
@@ -2708,7 +2913,9 @@ Status IrEmitterUnnested::EmitCollectivePermute(mlir::Operation* op) {
         /*destination_buffer=*/result_slice};
     auto thunk = std::make_unique<NcclThunkType>(
         Thunk::ThunkInfo::WithProfileAnnotation(op), collective_permute_op,
-        replica_count, partition_count, buffer);
+        replica_count, partition_count, buffer,
+        ir_emitter_context_->debug_options()
+            .xla_gpu_enable_copy_engine_collective_permute());
     async_executor = thunk->async_executor();
     AddThunkToThunkSequence(std::move(thunk));
   }
@@ -2716,6 +2923,66 @@ Status IrEmitterUnnested::EmitCollectivePermute(mlir::Operation* op) {
   return OkStatus();
 }
 
+void IrEmitterUnnested::AddNcclThunkToThunkSequence(
+    std::unique_ptr<NcclCollectiveThunk> thunk,
+    absl::Span<const NcclCollectiveThunk::Buffer> buffers) {
+  const bool groupable =
+      ir_emitter_context_->debug_options().xla_gpu_enable_nccl_group_launch() &&
+      thunk->async_executor() == nullptr &&
+      (thunk->kind() == Thunk::kNcclAllReduceStart ||
+       thunk->kind() == Thunk::kNcclReduceScatterStart ||
+       thunk->kind() == Thunk::kNcclAllGatherStart);
+  if (!groupable) {
+    nccl_group_candidate_ = nullptr;
+    AddThunkToThunkSequence(std::move(thunk));
+    return;
+  }
+
+  // The collectives of a group are launched together, so a collective can only
+  // join the group if it doesn't read or write a buffer written by the group,
+  // and doesn't write a buffer read by the group.
+  auto overlaps = [](const BufferAllocation::Slice& slice,
+                     absl::Span<const BufferAllocation::Slice> slices) {
+    return absl::c_any_of(slices, [&](const BufferAllocation::Slice& other) {
+      return slice.OverlapsWith(other);
+    });
+  };
+  const bool can_join_group =
+      nccl_group_candidate_ != nullptr && !thunk_sequence_.empty() &&
+      thunk_sequence_.back().get() == nccl_group_candidate_ &&
+      absl::c_none_of(buffers, [&](const NcclCollectiveThunk::Buffer& buffer) {
+        return overlaps(buffer.source_buffer, nccl_group_destinations_) ||
+               overlaps(buffer.destination_buffer, nccl_group_destinations_) ||
+               overlaps(buffer.destination_buffer, nccl_group_sources_);
+      });
+  if (!can_join_group) {
+    nccl_group_sources_.clear();
+    nccl_group_destinations_.clear();
+  }
+  for (const NcclCollectiveThunk::Buffer& buffer : buffers) {
+    nccl_group_sources_.push_back(buffer.source_buffer);
+    nccl_group_destinations_.push_back(buffer.destination_buffer);
+  }
+  if (!can_join_group) {
+    nccl_group_candidate_ = thunk.get();
+    AddThunkToThunkSequence(std::move(thunk));
+    return;
+  }
+
+  if (nccl_group_candidate_->kind() == Thunk::kNcclGroup) {
+    static_cast<NcclGroupThunk*>(nccl_group_candidate_)
+        ->thunks()
+        .push_back(std::move(thunk));
+    return;
+  }
+  ThunkSequence group;
+  group.push_back(std::move(thunk_sequence_.back()));
+  group.push_back(std::move(thunk));
+  thunk_sequence_.back() = std::make_unique<NcclGroupThunk>(
+      Thunk::ThunkInfo(/*op=*/nullptr), std::move(group));
+  nccl_group_candidate_ = thunk_sequence_.back().get();
+}
+
 template <typename NcclThunkType, typename OpT>
 Status IrEmitterUnnested::EmitNcclThunk(mlir::Operation* untyped_op) {
   OpT op = mlir::cast<OpT>(untyped_op);
@@ -2757,10 +3024,9 @@ Status IrEmitterUnnested::EmitNcclThunk(mlir::Operation* untyped_op) {
 
   if (should_use_nccl_thunk) {
     auto thunk = std::make_unique<NcclThunkType>(
-        Thunk::ThunkInfo::WithProfileAnnotation(op), op,
-        /*buffers=*/std::move(buffers));
+        Thunk::ThunkInfo::WithProfileAnnotation(op), op, /*buffers=*/buffers);
     async_executors_.insert({untyped_op, thunk->async_executor()});
-    AddThunkToThunkSequence(std::move(thunk));
+    AddNcclThunkToThunkSequence(std::move(thunk), buffers);
     return OkStatus();
   }
 
@@ -2978,10 +3244,11 @@ Status IrEmitterUnnested::EmitScatter(mlir::lmhlo::FusionOp fusion_op,
   CHECK_EQ(root->operand(0)->opcode(), HloOpcode::kParameter);
 
   const Shape& updates_shape = root->operand(2)->shape();
+  const auto* scatter = Cast<HloScatterInstruction>(root);
 
   TF_ASSIGN_OR_RETURN(
       LaunchDimensions launch_dimensions,
-      CalculateLaunchDimensions(updates_shape,
+      CalculateLaunchDimensions(GetScatterLoopShape(*scatter),
                                 ir_emitter_context_->gpu_device_info()));
 
   auto builder_fn = [&, this](std::vector<llvm_ir::IrArray> inputs,
@@ -3009,6 +3276,7 @@ Status IrEmitterUnnested::EmitScatter(mlir::lmhlo::FusionOp fusion_op,
     desc.updates_shape = updates_shape;
     desc.dim_numbers = dim_numbers;
     desc.unique_indices = root->unique_indices();
+    desc.sorted_indices = IsSortedScatter(*scatter);
     desc.update_computation = root->called_computations()[0];
     desc.output = outputs.back();
     TF_ASSIGN_OR_RETURN(desc.scatter_indices_gen,
@@ -208,6 +208,14 @@ class IrEmitterUnnested : public IrEmitter {
     thunk_sequence_.emplace_back(std::move(thunk));
   }
 
+  // Adds a NCCL collective thunk to the thunk sequence. If NCCL group launch
+  // is enabled, a synchronous all-reduce, reduce-scatter or all-gather that
+  // doesn't depend on the collectives emitted right before it joins their
+  // NcclGroupThunk.
+  void AddNcclThunkToThunkSequence(
+      std::unique_ptr<NcclCollectiveThunk> thunk,
+      absl::Span<const NcclCollectiveThunk::Buffer> buffers);
+
   // Load data from potentially unaligned address. If address is offset by
   // `alignment_bytes`, data is read in the unit of `alignment_bytes` to avoid
   // memory read misalignment in CUDA; otherwise, the entire data are loaded
@@ -359,6 +367,9 @@ class IrEmitterUnnested : public IrEmitter {
     Shape updates_shape;
     mlir::mhlo::ScatterDimensionNumbersAttr dim_numbers;
     bool unique_indices;
+    // The scatter indices are sorted and the scatter is emitted with
+    // `EmitSortedScatter`.
+    bool sorted_indices;
     const HloComputation* update_computation;
     llvm_ir::IrArray output;
     llvm_ir::ElementGenerator scatter_indices_gen;
@@ -371,6 +382,11 @@ class IrEmitterUnnested : public IrEmitter {
   Status EmitScatter(const ScatterDescriptor& desc,
                      const LaunchDimensions& launch_dimensions);
 
+  // Emits code for an in-place scatter with sorted indices that combines runs
+  // of updates to the same index before writing them to the output.
+  Status EmitSortedScatter(const ScatterDescriptor& desc,
+                           const LaunchDimensions& launch_dimensions);
+
   Status EmitScatter(mlir::lmhlo::FusionOp fusion_op,
                      const HloComputation* fused_computation,
                      HloFusionAnalysis& fusion_analysis);
@@ -428,6 +444,12 @@ class IrEmitterUnnested : public IrEmitter {
   // The thunk sequence this IrEmitter generates for the input computation.
   ThunkSequence thunk_sequence_;
 
+  // The last thunk of thunk_sequence_ if the next collective may be grouped
+  // with it, and the buffers read and written by its collectives.
+  Thunk* nccl_group_candidate_ = nullptr;
+  std::vector<BufferAllocation::Slice> nccl_group_sources_;
+  std::vector<BufferAllocation::Slice> nccl_group_destinations_;
+
   // Maps async start ops to their executors so done can access the thunk.
   // Executor may be null if the start op is degenerate (so not emitted).
   absl::flat_hash_map<mlir::Operation*, NcclCollectiveThunk::AsyncExecutor*>
@@ -115,6 +115,8 @@ Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
   se::StreamExecutor* executor = params.stream->parent();
   LaunchDimensions launch_dimensions;
   const se::KernelBase* kernel = nullptr;
+  std::shared_ptr<const se::KernelArgsArrayBase> kernel_args;
+  const uint64_t addresses_id = params.buffer_allocations->addresses_id();
 
   {
     absl::MutexLock lock(&mutex_);
@@ -123,9 +125,21 @@ Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
         << "Initialize() not called for StreamExecutor " << executor;
     launch_dimensions = launch_dimensions_;
     kernel = it->second.get();
+
+    auto packed = packed_args_cache_.find(executor);
+    if (addresses_id != 0 && packed != packed_args_cache_.end() &&
+        packed->second.addresses_id == addresses_id) {
+      kernel_args = packed->second.kernel_args;
+    }
   }
 
   VLOG(3) << "Launching " << kernel->name();
+  // The buffer addresses are the same as for the last launch.
+  if (kernel_args != nullptr && !VLOG_IS_ON(3)) {
+    return ExecuteKernelOnStream(*kernel, *kernel_args, launch_dimensions,
+                                 params.stream);
+  }
+
   absl::InlinedVector<se::DeviceMemoryBase, 4> buffer_args;
   for (const BufferAllocation::Slice& arg : args_) {
     se::DeviceMemoryBase buf = params.buffer_allocations->GetDeviceAddress(arg);
@@ -138,7 +152,12 @@ Status KernelThunk::ExecuteOnStream(const ExecuteParams& params) {
     PrintBufferContents(params.stream, buffer_args);
   }
 
-  return ExecuteKernelOnStream(*kernel, buffer_args, launch_dimensions,
+  kernel_args = PackKernelArgs(*kernel, buffer_args);
+  if (addresses_id != 0) {
+    absl::MutexLock lock(&mutex_);
+    packed_args_cache_[executor] = PackedArgs{addresses_id, kernel_args};
+  }
+  return ExecuteKernelOnStream(*kernel, *kernel_args, launch_dimensions,
                                params.stream);
 }
 
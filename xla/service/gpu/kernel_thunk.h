@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_GPU_KERNEL_THUNK_H_
 #define XLA_SERVICE_GPU_KERNEL_THUNK_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,6 +31,7 @@ limitations under the License.
 #include "xla/service/gpu/kernel_arguments.h"
 #include "xla/service/gpu/launch_dimensions.h"
 #include "xla/service/gpu/thunk.h"
+#include "xla/stream_executor/kernel.h"
 #include "xla/stream_executor/stream_executor.h"
 #include "xla/types.h"
 
@@ -103,12 +105,23 @@ class KernelThunk : public Thunk {
   // mlir::Value(s) corresponding to the buffer slice arguments.
   std::vector<mlir::Value> values_;
 
+  // The arguments packed for the buffer addresses of the last launch.
+  struct PackedArgs {
+    uint64_t addresses_id = 0;
+    std::shared_ptr<const se::KernelArgsArrayBase> kernel_args;
+  };
+
   mutable absl::Mutex mutex_;
 
   // Loaded kernels for each `StreamExecutor`.  Requires pointer stability of
   // values.
   absl::flat_hash_map<se::StreamExecutor*, std::unique_ptr<se::KernelBase>>
       kernel_cache_ ABSL_GUARDED_BY(mutex_);
+
+  // Packed arguments of the last launch on each `StreamExecutor`, reused while
+  // the buffer addresses don't change.
+  absl::flat_hash_map<se::StreamExecutor*, PackedArgs> packed_args_cache_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace gpu
@@ -0,0 +1,88 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/model/collective_combine_threshold.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "absl/algorithm/container.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/gpu/model/gpu_performance_model.h"
+#include "xla/shape_util.h"
+#include "tsl/platform/errors.h"
+
+namespace xla {
+namespace gpu {
+
+StatusOr<int64_t> ComputeCombineThresholdInBytes(
+    const HloModule& module, HloOpcode opcode,
+    const se::DeviceDescription& device_info,
+    const GpuHloCostAnalysis::Options& cost_analysis_options,
+    int64_t max_threshold_bytes) {
+  if (!GpuPerformanceWithCollectiveModel::IsSupportedGpu(device_info)) {
+    VLOG(1) << "Collectives are not modeled on this GPU, keeping the "
+               "combine threshold of "
+            << max_threshold_bytes << " bytes.";
+    return max_threshold_bytes;
+  }
+  const absl::Duration launch_overhead =
+      GpuPerformanceWithCollectiveModel::ComputeCollectiveLaunchOverhead(
+          device_info);
+
+  int64_t total_bytes = 0;
+  absl::Duration total_transfer_time;
+  for (const HloComputation* computation :
+       module.MakeNonfusionComputations()) {
+    auto is_collective = [&](const HloInstruction* hlo) {
+      return hlo->opcode() == opcode;
+    };
+    if (!absl::c_any_of(computation->instructions(), is_collective)) {
+      continue;
+    }
+    GpuHloCostAnalysis cost_analysis(cost_analysis_options, &device_info);
+    TF_RETURN_IF_ERROR(computation->Accept(&cost_analysis));
+    for (const HloInstruction* hlo : computation->instructions()) {
+      if (!is_collective(hlo) || cost_analysis.NumOfDevices(*hlo) <= 1) {
+        continue;
+      }
+      absl::Duration time =
+          GpuPerformanceWithCollectiveModel::ComputeCollectiveTime(
+              *hlo, &cost_analysis, device_info);
+      // Bytes are counted as in the combiners.
+      total_bytes += ShapeUtil::ByteSizeOf(hlo->shape());
+      total_transfer_time +=
+          std::max(time - launch_overhead, absl::ZeroDuration());
+    }
+  }
+  if (total_bytes == 0 || total_transfer_time <= absl::ZeroDuration()) {
+    return max_threshold_bytes;
+  }
+
+  double threshold =
+      total_bytes *
+      std::sqrt(absl::FDivDuration(launch_overhead, total_transfer_time));
+  VLOG(1) << "Combine threshold for " << HloOpcodeString(opcode) << ": "
+          << threshold << " bytes for " << total_bytes
+          << " bytes transferred in " << total_transfer_time;
+  return std::clamp<int64_t>(static_cast<int64_t>(threshold), 1,
+                             max_threshold_bytes);
+}
+
+}  // namespace gpu
+}  // namespace xla
@@ -0,0 +1,52 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_MODEL_COLLECTIVE_COMBINE_THRESHOLD_H_
+#define XLA_SERVICE_GPU_MODEL_COLLECTIVE_COMBINE_THRESHOLD_H_
+
+#include <cstdint>
+
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/statusor.h"
+#include "xla/stream_executor/device_description.h"
+
+namespace xla {
+namespace gpu {
+
+// Returns the byte threshold for combining the `opcode` collectives of
+// `module` (kAllGather, kAllReduce or kReduceScatter), at most
+// `max_threshold_bytes`.
+//
+// Combining collectives saves the launch overhead L of all but one of them,
+// but a combined collective only starts once all of its operands are ready, so
+// less of it overlaps with the computations producing them. Splitting the B
+// bytes exchanged by the collectives into buckets of b bytes costs (B / b) * L
+// for the launches and about (b / B) * T for the last bucket, which can't be
+// overlapped, where T is the transfer time of all the collectives estimated by
+// GpuPerformanceWithCollectiveModel. The cost is minimal for b = B * sqrt(L /
+// T). Returns `max_threshold_bytes` if the collectives are not modeled, e.g. on
+// GPUs older than Volta.
+StatusOr<int64_t> ComputeCombineThresholdInBytes(
+    const HloModule& module, HloOpcode opcode,
+    const se::DeviceDescription& device_info,
+    const GpuHloCostAnalysis::Options& cost_analysis_options,
+    int64_t max_threshold_bytes);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_MODEL_COLLECTIVE_COMBINE_THRESHOLD_H_
@@ -0,0 +1,138 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/model/collective_combine_threshold.h"
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/gpu_device_info_for_tests.h"
+#include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+constexpr int64_t kMaxThreshold = int64_t{1} << 30;
+
+class CollectiveCombineThresholdTest : public HloTestBase {
+ protected:
+  GpuHloCostAnalysis::Options options_{
+      [](const Shape& shape) {
+        constexpr int64_t kPointerSize = 8;
+        return ShapeUtil::ByteSizeOf(shape, kPointerSize);
+      },
+      /*per_second_rates=*/{},
+      /*count_multiple_input_accesses=*/true};
+  se::DeviceDescription device_info_{TestGpuDeviceInfo::RTXA6000DeviceInfo()};
+};
+
+TEST_F(CollectiveCombineThresholdTest, BalancesLaunchOverheadAndOverlap) {
+  constexpr absl::string_view kHlo = R"(
+HloModule m, num_partitions=8
+
+add {
+  x = f32[] parameter(0)
+  y = f32[] parameter(1)
+  ROOT add = f32[] add(x, y)
+}
+
+ENTRY entry {
+  p0 = f32[1048576] parameter(0)
+  p1 = f32[1048576] parameter(1)
+  p2 = f32[1048576] parameter(2)
+  p3 = f32[1048576] parameter(3)
+  ar0 = f32[1048576] all-reduce(p0), channel_id=1, to_apply=add
+  ar1 = f32[1048576] all-reduce(p1), channel_id=2, to_apply=add
+  ar2 = f32[1048576] all-reduce(p2), channel_id=3, to_apply=add
+  ar3 = f32[1048576] all-reduce(p3), channel_id=4, to_apply=add
+  ROOT t = (f32[1048576], f32[1048576], f32[1048576], f32[1048576])
+    tuple(ar0, ar1, ar2, ar3)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      int64_t threshold,
+      ComputeCombineThresholdInBytes(*module, HloOpcode::kAllReduce,
+                                     device_info_, options_, kMaxThreshold));
+  // Neither combining everything nor nothing.
+  EXPECT_GT(threshold, 0);
+  EXPECT_LT(threshold, 4 * 4 * 1048576);
+
+  // The flag value bounds the threshold.
+  TF_ASSERT_OK_AND_ASSIGN(
+      int64_t bounded_threshold,
+      ComputeCombineThresholdInBytes(*module, HloOpcode::kAllReduce,
+                                     device_info_, options_,
+                                     /*max_threshold_bytes=*/1024));
+  EXPECT_EQ(bounded_threshold, 1024);
+}
+
+TEST_F(CollectiveCombineThresholdTest, KeepsMaxThresholdWithoutCollectives) {
+  constexpr absl::string_view kHlo = R"(
+HloModule m, num_partitions=8
+
+ENTRY entry {
+  p0 = f32[1048576] parameter(0)
+  ROOT n = f32[1048576] negate(p0)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      int64_t threshold,
+      ComputeCombineThresholdInBytes(*module, HloOpcode::kAllGather,
+                                     device_info_, options_, kMaxThreshold));
+  EXPECT_EQ(threshold, kMaxThreshold);
+}
+
+TEST_F(CollectiveCombineThresholdTest, KeepsMaxThresholdOnUnsupportedGpu) {
+  constexpr absl::string_view kHlo = R"(
+HloModule m, num_partitions=8
+
+add {
+  x = f32[] parameter(0)
+  y = f32[] parameter(1)
+  ROOT add = f32[] add(x, y)
+}
+
+ENTRY entry {
+  p0 = f32[1048576] parameter(0)
+  p1 = f32[1048576] parameter(1)
+  ar0 = f32[1048576] all-reduce(p0), channel_id=1, to_apply=add
+  ar1 = f32[1048576] all-reduce(p1), channel_id=2, to_apply=add
+  ROOT t = (f32[1048576], f32[1048576]) tuple(ar0, ar1)
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(kHlo));
+
+  // The collective model only supports Volta and newer GPUs.
+  se::DeviceDescription pascal_device_info =
+      TestGpuDeviceInfo::RTXA6000DeviceInfo(se::CudaComputeCapability(6, 0));
+  TF_ASSERT_OK_AND_ASSIGN(
+      int64_t threshold,
+      ComputeCombineThresholdInBytes(*module, HloOpcode::kAllReduce,
+                                     pascal_device_info, options_,
+                                     kMaxThreshold));
+  EXPECT_EQ(threshold, kMaxThreshold);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
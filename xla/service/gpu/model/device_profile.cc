@@ -0,0 +1,202 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/gpu/model/device_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/hlo_op_profile.pb.h"
+#include "xla/status.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+// A registered profile, indexed for the lookups done by the cost model.
+struct CalibratedProfile {
+  absl::flat_hash_map<std::pair<PrimitiveType, HloOpcode>, int64_t>
+      clock_cycles;
+  // (bytes, bytes per second), sorted by bytes.
+  std::vector<std::pair<int64_t, double>> memory_bandwidth;
+  std::optional<absl::Duration> kernel_launch_overhead;
+};
+
+using CalibratedProfileMap =
+    absl::flat_hash_map<std::string, CalibratedProfile>;
+
+static absl::Mutex profiles_mu(absl::kConstInit);
+static auto& profiles ABSL_GUARDED_BY(profiles_mu) =
+    *new CalibratedProfileMap();
+static auto& loaded_paths ABSL_GUARDED_BY(profiles_mu) =
+    *new absl::flat_hash_set<std::string>();
+// Lets lookups skip the lock in the common case of an empty registry.
+static std::atomic<bool> has_profiles{false};
+
+CalibratedProfile IndexProfile(const HloInstructionProfileList& list) {
+  CalibratedProfile profile;
+  for (const HloInstructionProfile& entry : list.entries()) {
+    auto opcode = StringToHloOpcode(entry.instruction().opcode());
+    if (!opcode.ok()) {
+      LOG(WARNING) << "Ignoring profile of unknown opcode "
+                   << entry.instruction().opcode();
+      continue;
+    }
+    profile.clock_cycles[{entry.instruction().shape().element_type(),
+                          *opcode}] = entry.clock_cycles();
+  }
+  for (const MemoryBandwidthProfile& entry : list.memory_bandwidth()) {
+    if (entry.bytes() > 0 && entry.bytes_per_second() > 0) {
+      profile.memory_bandwidth.push_back(
+          {entry.bytes(), entry.bytes_per_second()});
+    }
+  }
+  absl::c_sort(profile.memory_bandwidth);
+  if (list.kernel_launch_overhead_ns() > 0) {
+    profile.kernel_launch_overhead =
+        absl::Nanoseconds(list.kernel_launch_overhead_ns());
+  }
+  return profile;
+}
+
+// Calls `fn` with the profile registered for `device_info` while holding the
+// registry lock, and returns its result, or std::nullopt if there is none.
+template <typename Fn>
+auto WithRegisteredProfile(const se::DeviceDescription& device_info, Fn&& fn)
+    -> std::optional<decltype(fn(std::declval<const CalibratedProfile&>()))> {
+  if (!has_profiles.load(std::memory_order_acquire)) {
+    return std::nullopt;
+  }
+  std::string key = GetDeviceProfileKey(device_info);
+  absl::ReaderMutexLock lock(&profiles_mu);
+  auto it = profiles.find(key);
+  if (it == profiles.end()) {
+    return std::nullopt;
+  }
+  return fn(it->second);
+}
+
+}  // namespace
+
+std::string GetDeviceProfileKey(const se::DeviceDescription& device_info) {
+  if (auto* ptr = std::get_if<se::CudaComputeCapability>(
+          &device_info.gpu_compute_capability())) {
+    return absl::StrCat("sm_", ptr->major, ptr->minor);
+  }
+  if (auto* ptr = std::get_if<se::RocmComputeCapability>(
+          &device_info.gpu_compute_capability())) {
+    return ptr->gfx_version();
+  }
+  return "<unknown>";
+}
+
+void RegisterDeviceProfiles(
+    const DeviceHloInstructionProfiles& device_profiles) {
+  absl::MutexLock lock(&profiles_mu);
+  for (const auto& [key, list] : device_profiles.entries()) {
+    VLOG(1) << "Registering calibrated device profile for " << key;
+    profiles[key] = IndexProfile(list);
+  }
+  has_profiles.store(!profiles.empty(), std::memory_order_release);
+}
+
+Status LoadDeviceProfiles(absl::string_view path) {
+  {
+    absl::MutexLock lock(&profiles_mu);
+    if (loaded_paths.contains(path)) {
+      return OkStatus();
+    }
+  }
+  DeviceHloInstructionProfiles device_profiles;
+  TF_RETURN_IF_ERROR(tsl::ReadTextOrBinaryProto(
+      tsl::Env::Default(), std::string(path), &device_profiles));
+  RegisterDeviceProfiles(device_profiles);
+  absl::MutexLock lock(&profiles_mu);
+  loaded_paths.insert(std::string(path));
+  return OkStatus();
+}
+
+void ClearDeviceProfilesForTesting() {
+  absl::MutexLock lock(&profiles_mu);
+  profiles.clear();
+  loaded_paths.clear();
+  has_profiles.store(false, std::memory_order_release);
+}
+
+std::optional<int64_t> FindRegisteredClockCycles(
+    const se::DeviceDescription& device_info, PrimitiveType data_type,
+    HloOpcode opcode) {
+  return WithRegisteredProfile(
+             device_info,
+             [&](const CalibratedProfile& profile) -> std::optional<int64_t> {
+               auto it = profile.clock_cycles.find({data_type, opcode});
+               if (it == profile.clock_cycles.end()) {
+                 return std::nullopt;
+               }
+               return it->second;
+             })
+      .value_or(std::nullopt);
+}
+
+float GetMemoryBandwidth(const se::DeviceDescription& device_info,
+                         int64_t num_bytes) {
+  std::optional<float> bandwidth = WithRegisteredProfile(
+      device_info, [&](const CalibratedProfile& profile) -> float {
+        const auto& curve = profile.memory_bandwidth;
+        if (curve.empty()) {
+          return device_info.memory_bandwidth();
+        }
+        // First measurement for a buffer larger than `num_bytes`.
+        auto it = absl::c_upper_bound(
+            curve,
+            std::make_pair(num_bytes, std::numeric_limits<double>::max()));
+        return it == curve.begin() ? it->second : std::prev(it)->second;
+      });
+  return bandwidth.value_or(device_info.memory_bandwidth());
+}
+
+absl::Duration GetKernelLaunchOverhead(const se::DeviceDescription& device_info,
+                                       absl::Duration default_overhead) {
+  return WithRegisteredProfile(
+             device_info,
+             [&](const CalibratedProfile& profile) {
+               return profile.kernel_launch_overhead.value_or(
+                   default_overhead);
+             })
+      .value_or(default_overhead);
+}
+
+}  // namespace gpu
+}  // namespace xla
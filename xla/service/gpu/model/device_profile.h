@@ -0,0 +1,77 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef XLA_SERVICE_GPU_MODEL_DEVICE_PROFILE_H_
+#define XLA_SERVICE_GPU_MODEL_DEVICE_PROFILE_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/hlo_op_profile.pb.h"
+#include "xla/status.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla {
+namespace gpu {
+
+// Process-wide registry of device profiles measured by `hlo_op_profiler_run`.
+//
+// The GPU cost model consults the registry before falling back to the
+// built-in profiles in hlo_op_profiles.h and to the nominal values reported by
+// `se::DeviceDescription`, so that fusion decisions can be calibrated for
+// devices that are not covered by the built-in profiles.
+
+// Returns the key under which profiles for `device_info` are stored in a
+// `DeviceHloInstructionProfiles`: "sm_<major><minor>" for CUDA devices and the
+// gfx version for ROCm devices.
+std::string GetDeviceProfileKey(const se::DeviceDescription& device_info);
+
+// Registers all entries of `profiles`, replacing previously registered
+// entries with the same key.
+void RegisterDeviceProfiles(const DeviceHloInstructionProfiles& profiles);
+
+// Reads a `DeviceHloInstructionProfiles` in text or binary proto format from
+// `path` and registers it. Loading the same path again is a no-op.
+Status LoadDeviceProfiles(absl::string_view path);
+
+// Clears the registry. Only meant for tests.
+void ClearDeviceProfilesForTesting();
+
+// Returns the registered clock cycles per element of `opcode` on `data_type`
+// for `device_info`, if any.
+std::optional<int64_t> FindRegisteredClockCycles(
+    const se::DeviceDescription& device_info, PrimitiveType data_type,
+    HloOpcode opcode);
+
+// Returns the DRAM bandwidth, in bytes per second, of a kernel accessing
+// `num_bytes` bytes: the registered measurement for the largest buffer that
+// is not larger than `num_bytes` (or the smallest one), or the nominal
+// bandwidth of the device if none were registered.
+float GetMemoryBandwidth(const se::DeviceDescription& device_info,
+                         int64_t num_bytes);
+
+// Returns the registered kernel launch overhead for `device_info`, or
+// `default_overhead` if none was registered.
+absl::Duration GetKernelLaunchOverhead(const se::DeviceDescription& device_info,
+                                       absl::Duration default_overhead);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_MODEL_DEVICE_PROFILE_H_
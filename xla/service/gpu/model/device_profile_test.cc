@@ -0,0 +1,124 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/gpu/model/device_profile.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/time/time.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/gpu_device_info_for_tests.h"
+#include "xla/service/gpu/model/hlo_op_profile.pb.h"
+#include "xla/stream_executor/device_description.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/protobuf.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+constexpr char kProfiles[] = R"pb(
+  entries {
+    key: "sm_89"
+    value {
+      entries {
+        instruction { opcode: "divide" shape { element_type: F32 } }
+        clock_cycles: 123
+      }
+      kernel_launch_overhead_ns: 2500
+      memory_bandwidth { bytes: 268435456 bytes_per_second: 2.5e11 }
+      memory_bandwidth { bytes: 67108864 bytes_per_second: 2e11 }
+    }
+  }
+)pb";
+
+class DeviceProfileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ClearDeviceProfilesForTesting();
+    ASSERT_TRUE(
+        tsl::protobuf::TextFormat::ParseFromString(kProfiles, &profiles_));
+  }
+  void TearDown() override { ClearDeviceProfilesForTesting(); }
+
+  DeviceHloInstructionProfiles profiles_;
+  se::DeviceDescription device_info_{TestGpuDeviceInfo::RTXA6000DeviceInfo()};
+};
+
+TEST_F(DeviceProfileTest, KeyMatchesBuiltInProfiles) {
+  EXPECT_EQ(GetDeviceProfileKey(device_info_), "sm_89");
+  EXPECT_EQ(GetDeviceProfileKey(TestGpuDeviceInfo::AMDMI210DeviceInfo()),
+            "gfx90a");
+}
+
+TEST_F(DeviceProfileTest, FallsBackToNominalValues) {
+  EXPECT_EQ(FindRegisteredClockCycles(device_info_, F32, HloOpcode::kDivide),
+            std::nullopt);
+  EXPECT_EQ(GetMemoryBandwidth(device_info_, 1 << 30),
+            device_info_.memory_bandwidth());
+  EXPECT_EQ(GetKernelLaunchOverhead(device_info_, absl::Microseconds(5)),
+            absl::Microseconds(5));
+}
+
+TEST_F(DeviceProfileTest, UsesRegisteredMeasurements) {
+  RegisterDeviceProfiles(profiles_);
+
+  EXPECT_THAT(FindRegisteredClockCycles(device_info_, F32, HloOpcode::kDivide),
+              Optional(Eq(123)));
+  EXPECT_EQ(FindRegisteredClockCycles(device_info_, F64, HloOpcode::kDivide),
+            std::nullopt);
+  EXPECT_EQ(GetKernelLaunchOverhead(device_info_, absl::Microseconds(5)),
+            absl::Nanoseconds(2500));
+
+  // The curve is stepwise and clamped to the measured range.
+  EXPECT_FLOAT_EQ(GetMemoryBandwidth(device_info_, 1024), 2e11);
+  EXPECT_FLOAT_EQ(GetMemoryBandwidth(device_info_, 67108864), 2e11);
+  EXPECT_FLOAT_EQ(GetMemoryBandwidth(device_info_, 100000000), 2e11);
+  EXPECT_FLOAT_EQ(GetMemoryBandwidth(device_info_, 268435456), 2.5e11);
+  EXPECT_FLOAT_EQ(GetMemoryBandwidth(device_info_, int64_t{1} << 40), 2.5e11);
+
+  // Other devices are not affected.
+  se::DeviceDescription other = TestGpuDeviceInfo::AMDMI210DeviceInfo();
+  EXPECT_EQ(GetMemoryBandwidth(other, 1 << 30), other.memory_bandwidth());
+  EXPECT_EQ(GetKernelLaunchOverhead(other, absl::Microseconds(5)),
+            absl::Microseconds(5));
+}
+
+TEST_F(DeviceProfileTest, LoadsProfilesFromFile) {
+  std::string path =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "device_profile.textproto");
+  TF_ASSERT_OK(tsl::WriteStringToFile(tsl::Env::Default(), path,
+                                      profiles_.DebugString()));
+  TF_ASSERT_OK(LoadDeviceProfiles(path));
+  EXPECT_EQ(GetKernelLaunchOverhead(device_info_, absl::Microseconds(5)),
+            absl::Nanoseconds(2500));
+
+  EXPECT_FALSE(LoadDeviceProfiles(tsl::io::JoinPath(tsl::testing::TmpDir(),
+                                                    "does_not_exist"))
+                   .ok());
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
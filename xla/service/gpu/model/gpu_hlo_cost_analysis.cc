@@ -18,15 +18,15 @@ limitations under the License.
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
-#include <variant>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
-#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/map_util.h"
@@ -34,6 +34,7 @@ limitations under the License.
 #include "xla/service/elemental_ir_emitter.h"
 #include "xla/service/gpu/backend_configs.pb.h"
 #include "xla/service/gpu/cublas_cudnn.h"
+#include "xla/service/gpu/model/device_profile.h"
 #include "xla/service/gpu/model/hlo_op_profile.pb.h"
 #include "xla/service/gpu/model/hlo_op_profiles.h"
 #include "xla/service/hlo_cost_analysis.h"
@@ -329,12 +330,12 @@ int64_t FlopsPerElement(const se::DeviceDescription* device_info,
                         const PrimitiveType type, const HloOpcode opcode) {
   std::string compute_capability = "<unknown>";
   if (device_info != nullptr) {
-    if (auto* ptr = std::get_if<stream_executor::CudaComputeCapability>(
-            &device_info->gpu_compute_capability()))
-      compute_capability = absl::StrCat("sm_", ptr->major, ptr->minor);
-    if (auto* ptr = std::get_if<stream_executor::RocmComputeCapability>(
-            &device_info->gpu_compute_capability()))
-      compute_capability = ptr->gfx_version();
+    // Profiles measured on this device take precedence over built-in ones.
+    if (std::optional<int64_t> clock_cycles =
+            FindRegisteredClockCycles(*device_info, type, opcode)) {
+      return *clock_cycles;
+    }
+    compute_capability = GetDeviceProfileKey(*device_info);
   }
 
   static const auto* all_profiles = LoadOpProfiles();
@@ -364,13 +365,14 @@ int64_t GetFlopsForElementwiseOp(const se::DeviceDescription* gpu_device_info,
                                   instr->shape());
 }
 
-Status GpuHloCostAnalysis::HandleAllReduce(const HloInstruction* allreduce) {
-  const HloModuleConfig& config = allreduce->GetModule()->config();
-  TF_ASSIGN_OR_RETURN(
-      CollectiveOpGroupMode group_mode,
-      GetCollectiveOpGroupMode(
-          allreduce->channel_id().has_value(),
-          Cast<HloAllReduceInstruction>(allreduce)->use_global_device_ids()));
+// Returns the size of the largest group of devices taking part in the
+// collective `hlo`.
+static StatusOr<int64_t> NumRanks(const HloInstruction* hlo,
+                                  bool use_global_device_ids) {
+  const HloModuleConfig& config = hlo->GetModule()->config();
+  TF_ASSIGN_OR_RETURN(CollectiveOpGroupMode group_mode,
+                      GetCollectiveOpGroupMode(hlo->channel_id().has_value(),
+                                               use_global_device_ids));
 
   // Get number of ranks for this instruction based on replica groups and mode.
   int64_t num_devices = config.num_partitions();
@@ -378,12 +380,20 @@ Status GpuHloCostAnalysis::HandleAllReduce(const HloInstruction* allreduce) {
   TF_ASSIGN_OR_RETURN(
       std::vector<int64_t> participant_counts,
       GetPariticipantCountsForReplicaGroups(
-          num_replicas, num_devices, allreduce->replica_groups(), group_mode));
+          num_replicas, num_devices, hlo->replica_groups(), group_mode));
   int64_t num_ranks = 1;
 
   for (auto count : participant_counts) {
     num_ranks = std::max(num_ranks, count);
   }
+  return num_ranks;
+}
+
+Status GpuHloCostAnalysis::HandleAllReduce(const HloInstruction* allreduce) {
+  TF_ASSIGN_OR_RETURN(
+      int64_t num_ranks,
+      NumRanks(allreduce, Cast<HloAllReduceInstruction>(allreduce)
+                              ->use_global_device_ids()));
 
   VLOG(5) << "Computing cost for " << num_ranks << " ranks in "
           << allreduce->ToString();
@@ -424,6 +434,29 @@ Status GpuHloCostAnalysis::HandleAllReduce(const HloInstruction* allreduce) {
   return OkStatus();
 }
 
+Status GpuHloCostAnalysis::HandleAllGather(const HloInstruction* hlo) {
+  return HandleSingleRingPassCollective(
+      hlo, Cast<HloAllGatherInstruction>(hlo)->use_global_device_ids());
+}
+
+Status GpuHloCostAnalysis::HandleReduceScatter(const HloInstruction* hlo) {
+  return HandleSingleRingPassCollective(
+      hlo, Cast<HloReduceScatterInstruction>(hlo)->use_global_device_ids());
+}
+
+Status GpuHloCostAnalysis::HandleSingleRingPassCollective(
+    const HloInstruction* hlo, bool use_global_device_ids) {
+  TF_ASSIGN_OR_RETURN(int64_t num_ranks,
+                      NumRanks(hlo, use_global_device_ids));
+  current_properties_[kCollNumDevicesKey] = num_ranks;
+  // Unlike an allreduce, which reduces and then gathers around the ring, the
+  // data only goes around the ring once.
+  int64_t num_intra_steps = std::max<int64_t>(1, num_ranks - 1);
+  current_properties_[kCollAlgoScaleRatioKey] =
+      (1.0 * num_ranks) / num_intra_steps;
+  return OkStatus();
+}
+
 Status GpuHloCostAnalysis::HandleElementwiseOp(const HloInstruction* hlo) {
   current_properties_[kFlopsKey] = GetFlopsForElementwiseOp(device_info_, hlo);
   return OkStatus();
@@ -53,6 +53,8 @@ class GpuHloCostAnalysis : public HloCostAnalysis {
   Status HandleElementwiseBinary(const HloInstruction* hlo) override;
 
   Status HandleAllReduce(const HloInstruction* allreduce) override;
+  Status HandleAllGather(const HloInstruction* hlo) override;
+  Status HandleReduceScatter(const HloInstruction* hlo) override;
 
   // Estimate the total size of IR accounting for both duplication
   // of producer code by consumer and the total number of basic blocks.
@@ -83,6 +85,11 @@ class GpuHloCostAnalysis : public HloCostAnalysis {
 
   bool KeyToCopyFromSubcomputation(absl::string_view key) const override;
 
+  // Sets the collective properties of an all-gather or a reduce-scatter, which
+  // take a single pass around the ring of participating devices.
+  Status HandleSingleRingPassCollective(const HloInstruction* hlo,
+                                        bool use_global_device_ids);
+
   // Some instructions create new LLVM basic blocks; with our current code
   // generation this means in the worst case doubling the IR size of a fusion
   // containing such an instruction.
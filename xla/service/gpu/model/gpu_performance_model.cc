@@ -33,6 +33,7 @@ limitations under the License.
 #include "xla/service/gpu/gpu_fusible.h"
 #include "xla/service/gpu/hlo_fusion_analysis.h"
 #include "xla/service/gpu/hlo_traversal.h"
+#include "xla/service/gpu/model/device_profile.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/stream_executor/device_description.h"
 
@@ -44,7 +45,9 @@ namespace gpu {
 
 namespace {
 
-// Estimated values in the absence of easy ways to query them.
+// Estimated values in the absence of easy ways to query them. The kernel
+// launch overhead and the memory bandwidth are replaced by measured values if
+// a calibrated device profile is registered (see device_profile.h).
 static constexpr absl::Duration kKernelLaunchOverhead = absl::Microseconds(5);
 static constexpr float kL2CacheSpeedup = 2.5;
 static constexpr float kL1CacheSpeedup = 8;
@@ -55,6 +58,10 @@ static constexpr float kL1CacheSpeedup = 8;
 // For reference, it can be up to 256 kB per SM on RTX A6000.
 static constexpr float kL1CacheSizePerSM = 2 * 1024;
 
+absl::Duration KernelLaunchOverhead(const se::DeviceDescription& device_info) {
+  return GetKernelLaunchOverhead(device_info, kKernelLaunchOverhead);
+}
+
 // Returns whether a fusion uses the parameter at the given index elementwise
 // from its root.
 bool FusionUsesParameterElementwiseFromRoot(
@@ -72,7 +79,7 @@ absl::Duration ReadTime(const se::DeviceDescription& gpu_device_info,
                         int64_t num_blocks, int64_t n_bytes_net,
                         int64_t n_bytes_total, PrimitiveType element_type,
                         bool coalesced) {
-  float bandwidth = gpu_device_info.memory_bandwidth();
+  float bandwidth = GetMemoryBandwidth(gpu_device_info, n_bytes_total);
   if (n_bytes_net < gpu_device_info.l2_cache_size()) {
     bandwidth *= kL2CacheSpeedup;
     if (n_bytes_net < kL1CacheSizePerSM * gpu_device_info.core_count()) {
@@ -257,7 +264,8 @@ GpuPerformanceModel::EstimateRunTimeForInstruction(
       cost_analysis, *device_info, launch_dimensions.num_blocks(),
       /*producer=*/instr, fusion_analysis);
   absl::Duration write_time =
-      absl::Seconds(1.0f * bytes_written / device_info->memory_bandwidth());
+      absl::Seconds(1.0f * bytes_written /
+                    GetMemoryBandwidth(*device_info, bytes_written));
   absl::Duration exec_time = std::max(compute_time, read_time + write_time);
 
   if (VLOG_IS_ON(8)) {
@@ -435,11 +443,12 @@ GpuPerformanceModel::RunTimes GpuPerformanceModel::EstimateRunTimes(
   }
 
   absl::Duration time_unfused =
-      kKernelLaunchOverhead * (fused_consumer_count + 1) +
+      KernelLaunchOverhead(*device_info) * (fused_consumer_count + 1) +
       producer_data.exec_time + producer_output_read_time_unfused;
 
   absl::Duration time_fused =
-      kKernelLaunchOverhead * fused_consumer_count + exec_time_fused;
+      KernelLaunchOverhead(*device_info) * fused_consumer_count +
+      exec_time_fused;
   // Multi-output fusion still writes the initial output of the producer.
   // For now assume that the producer's output does not need to be recomputed.
   if (multi_output) {
@@ -493,7 +502,10 @@ float GpuPerformanceWithCollectiveModel::GetNvlinkBw(
 /*static*/ bool GpuPerformanceWithCollectiveModel::InitNvml() {
 #if GOOGLE_CUDA
   void* libhandle = dlopen("libnvidia-ml.so.1", RTLD_NOW);
-  CHECK(libhandle != nullptr) << "Failed to open libnvidia-ml.so.1";
+  if (libhandle == nullptr) {
+    LOG(WARNING) << "Failed to open libnvidia-ml.so.1";
+    return false;
+  }
 
   struct SymbolEntry {
     void** functor;
@@ -536,19 +548,34 @@ GpuPerformanceWithCollectiveModel::CheckIfNvlinkSupportsP2P() {
   // Then gpu 0 will be used to query for nvlink capability, note that
   // we only look at link 0 of gpu 0 since all other links are assumed
   // to have the same capability.
-  CHECK(InitNvml()) << "NVML init failed.";
-  nvmlDevice_t nvml_device;
-  nvmlReturn_t get_device_result =
-      xla_nvmlDeviceGetHandleByIndex(0, &nvml_device);
-  CHECK(get_device_result == NVML_SUCCESS);
-
-  uint32_t supported_p2p = 0;
-
-  nvmlReturn_t nvlink_cap_result = xla_nvmlDeviceGetNvLinkCapability(
-      nvml_device, /*nvlink link number*/ 0, NVML_NVLINK_CAP_P2P_SUPPORTED,
-      &supported_p2p);
-  CHECK(nvlink_cap_result == NVML_SUCCESS);
-  CHECK(ShutdownNvml()) << "NVML shutdown failed.";
+  // The capability can't change while the process runs, so it is only queried
+  // once instead of for every collective.
+  static const uint32_t supported_p2p = [] {
+    if (!InitNvml()) {
+      LOG(WARNING) << "NVML init failed, assuming no NVLink p2p support.";
+      return uint32_t{0};
+    }
+    nvmlDevice_t nvml_device;
+    nvmlReturn_t get_device_result =
+        xla_nvmlDeviceGetHandleByIndex(0, &nvml_device);
+
+    uint32_t supported_p2p = 0;
+    if (get_device_result == NVML_SUCCESS) {
+      nvmlReturn_t nvlink_cap_result = xla_nvmlDeviceGetNvLinkCapability(
+          nvml_device, /*nvlink link number*/ 0, NVML_NVLINK_CAP_P2P_SUPPORTED,
+          &supported_p2p);
+      if (nvlink_cap_result != NVML_SUCCESS) {
+        LOG(WARNING) << "Failed to query the NVLink p2p capability.";
+        supported_p2p = 0;
+      }
+    } else {
+      LOG(WARNING) << "Failed to get the NVML handle of device 0.";
+    }
+    if (!ShutdownNvml()) {
+      LOG(WARNING) << "NVML shutdown failed.";
+    }
+    return supported_p2p;
+  }();
   return supported_p2p;
 #else
   return 0;
@@ -561,7 +588,7 @@ GpuPerformanceWithCollectiveModel::ComputeAllreduceTime(
     const se::DeviceDescription& gpu_device_info) {
   // We use nccl group call to launch multiple allreduces so launch overhead
   // only occurs once.
-  absl::Duration total_time = kKernelLaunchOverhead;
+  absl::Duration total_time = KernelLaunchOverhead(gpu_device_info);
   stream_executor::CudaComputeCapability compute_cap =
       gpu_device_info.cuda_compute_capability();
 
@@ -632,13 +659,25 @@ GpuPerformanceWithCollectiveModel::ComputeAllreduceTime(
   return total_time;
 }
 
+/*static*/ absl::Duration
+GpuPerformanceWithCollectiveModel::ComputeCollectiveLaunchOverhead(
+    const se::DeviceDescription& gpu_device_info) {
+  return KernelLaunchOverhead(gpu_device_info);
+}
+
+/*static*/ bool GpuPerformanceWithCollectiveModel::IsSupportedGpu(
+    const se::DeviceDescription& gpu_device_info) {
+  return GetMaxSysBwFromGpu(gpu_device_info.cuda_compute_capability(),
+                            kLowLatencyMaxBandwidths.data()) > 0;
+}
+
 /*static*/ absl::Duration
 GpuPerformanceWithCollectiveModel::ComputeCollectiveTime(
     const HloInstruction& instr, const GpuHloCostAnalysis* cost_analysis,
     const se::DeviceDescription& gpu_device_info) {
   if (cost_analysis->NumOfDevices(instr) == 1) {
     VLOG(8) << "Returning only kernel launch overhead for a single partition.";
-    return kKernelLaunchOverhead;
+    return KernelLaunchOverhead(gpu_device_info);
   }
 
   if (HloDataflowAnalysis::IsAsynchronousOperationDone(instr.opcode())) {
@@ -648,12 +687,15 @@ GpuPerformanceWithCollectiveModel::ComputeCollectiveTime(
   switch (instr.opcode()) {
     case HloOpcode::kAllReduce:
     case HloOpcode::kAllReduceStart:
+    case HloOpcode::kAllGather:
+    case HloOpcode::kAllGatherStart:
+    case HloOpcode::kReduceScatter:
       return ComputeAllreduceTime(instr, cost_analysis, gpu_device_info);
     default: {
       LOG(WARNING)
           << "Runtime estimate for " << instr.name()
           << " not implemented. Returning only the kernel launch time.";
-      return kKernelLaunchOverhead;
+      return KernelLaunchOverhead(gpu_device_info);
     }
   }
 }
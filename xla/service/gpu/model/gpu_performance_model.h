@@ -133,10 +133,19 @@ class GpuPerformanceWithCollectiveModel : public GpuPerformanceModel {
   // launches 640 threads.
   static constexpr int64_t kLL128NumThreads = 640;
 
+  // Returns whether the collectives running on `gpu_device_info` are modeled,
+  // i.e. whether it is a Volta, Ampere or Hopper GPU.
+  static bool IsSupportedGpu(const se::DeviceDescription& gpu_device_info);
+
   static absl::Duration ComputeCollectiveTime(
       const HloInstruction& instr, const GpuHloCostAnalysis* cost_analysis,
       const se::DeviceDescription& gpu_device_info);
 
+  // Returns the part of the collective time that doesn't depend on the size of
+  // the collective, i.e. the kernel launch overhead.
+  static absl::Duration ComputeCollectiveLaunchOverhead(
+      const se::DeviceDescription& gpu_device_info);
+
   // Returns NVLink bw in GB/s
   static float GetNvlinkBw(se::CudaComputeCapability compute_capability);
 
@@ -147,10 +156,14 @@ class GpuPerformanceWithCollectiveModel : public GpuPerformanceModel {
   static bool ShutdownNvml();
 
   // This checks if the nvlink supports direct P2P communication,
-  // If not, we will use PCIE bandwidth to estimate latency.
+  // If not, we will use PCIE bandwidth to estimate latency. NVML is only
+  // queried by the first call, and a failed query is treated as no P2P.
   static uint32_t CheckIfNvlinkSupportsP2P();
 
  private:
+  // Estimates the time of a collective running on a ring of devices, which is
+  // the algorithm NCCL uses within a node. The number of steps around the ring
+  // is accounted for by the scaling ratio of the collective.
   static absl::Duration ComputeAllreduceTime(
       const HloInstruction& instr, const GpuHloCostAnalysis* cost_analysis,
       const se::DeviceDescription& gpu_device_info);
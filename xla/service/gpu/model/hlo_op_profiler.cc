@@ -111,9 +111,9 @@ class CuptiKernelTracer {
 #endif
 
 /*static*/ std::unique_ptr<HloModule> HloOpProfiler::MakeModuleForMeasurements(
-    HloOpcode op, PrimitiveType data_type, int chain_length) {
-  constexpr int64_t kInputSize = 1;
-  const Shape shape = ShapeUtil::MakeShape(data_type, {kInputSize});
+    HloOpcode op, PrimitiveType data_type, int chain_length,
+    int64_t num_elements) {
+  const Shape shape = ShapeUtil::MakeShape(data_type, {num_elements});
   HloModuleConfig config;
   config.set_debug_options(GetDebugOptionsFromFlags());
   auto module = std::make_unique<HloModule>("module", config);
@@ -149,14 +149,43 @@ class CuptiKernelTracer {
   return module;
 }
 
+/*static*/ std::unique_ptr<HloModule> HloOpProfiler::MakeModuleWithKernelChain(
+    int num_kernels) {
+  const Shape shape = ShapeUtil::MakeShape(F32, {1});
+  HloModuleConfig config;
+  config.set_debug_options(GetDebugOptionsFromFlags());
+  auto module = std::make_unique<HloModule>("module", config);
+
+  HloComputation::Builder fusion_builder("fusion");
+  HloInstruction* pf = fusion_builder.AddInstruction(
+      HloInstruction::CreateParameter(0, shape, "pf"));
+  fusion_builder.AddInstruction(
+      HloInstruction::CreateUnary(shape, HloOpcode::kNegate, pf));
+  HloComputation* subcomp =
+      module->AddEmbeddedComputation(fusion_builder.Build());
+
+  // The fusions are not merged because HLO passes are not run.
+  HloComputation::Builder entry_builder("entry");
+  HloInstruction* last = entry_builder.AddInstruction(
+      HloInstruction::CreateParameter(0, shape, "p0"));
+  for (int i = 0; i < num_kernels; ++i) {
+    last = entry_builder.AddInstruction(HloInstruction::CreateFusion(
+        shape, HloInstruction::FusionKind::kLoop, {last}, subcomp));
+  }
+  module->AddEntryComputation(entry_builder.Build());
+  VLOG(9) << module->ToString();
+  return module;
+}
+
 StatusOr<absl::Duration> HloOpProfiler::MeasureOpChainDuration(
-    HloOpcode op, PrimitiveType data_type, int chain_length) {
+    HloOpcode op, PrimitiveType data_type, int chain_length,
+    int64_t num_elements) {
 #ifndef GOOGLE_CUDA
   return FailedPrecondition("Not built with --config=cuda");
 #endif
 
   std::unique_ptr<HloModule> module =
-      MakeModuleForMeasurements(op, data_type, chain_length);
+      MakeModuleForMeasurements(op, data_type, chain_length, num_elements);
 
   std::minstd_rand0 engine;
   // Some operations have dynamic duration that depends on the input values.
@@ -190,6 +219,31 @@ StatusOr<absl::Duration> HloOpProfiler::MeasureOpChainDuration(
   return absl::Nanoseconds(std::move(cupti_tracer).getMedianKernelTimeNs());
 }
 
+StatusOr<absl::Duration> HloOpProfiler::MeasureKernelChainWallTime(
+    int num_kernels) {
+  std::unique_ptr<HloModule> module = MakeModuleWithKernelChain(num_kernels);
+  std::minstd_rand0 engine;
+  TF_ASSIGN_OR_RETURN(std::vector<Literal> args,
+                      MakeFakeArguments(module.get(), &engine));
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<Executable> ex,
+                      runner_.CreateExecutable(std::move(module),
+                                               /*run_hlo_passes=*/false));
+  // Warmup.
+  TF_RETURN_IF_ERROR(runner_.ExecuteWithExecutable(ex.get(), args).status());
+
+  constexpr int kNumRuns = 21;
+  std::vector<absl::Duration> wall_times;
+  wall_times.reserve(kNumRuns);
+  for (int i = 0; i < kNumRuns; ++i) {
+    const absl::Time start = absl::Now();
+    TF_RETURN_IF_ERROR(runner_.ExecuteWithExecutable(ex.get(), args).status());
+    wall_times.push_back(absl::Now() - start);
+  }
+  std::nth_element(wall_times.begin(), wall_times.begin() + kNumRuns / 2,
+                   wall_times.end());
+  return wall_times[kNumRuns / 2];
+}
+
 HloOpProfiler::HloOpProfiler(HloRunner& runner)
     : runner_(runner),
       dev_info_(runner.backend().stream_executors()[0]->GetDeviceDescription()),
@@ -245,5 +299,41 @@ StatusOr<HloInstructionProfile> HloOpProfiler::MeasureClockCyclesPerOp(
   return profile;
 }
 
+StatusOr<MemoryBandwidthProfile> HloOpProfiler::MeasureMemoryBandwidth(
+    int64_t num_bytes) {
+  constexpr int64_t kElementSize = 4;
+  const int64_t num_elements = CeilOfRatio(num_bytes, kElementSize);
+  VLOG(2) << "Measuring memory bandwidth for " << num_bytes << " bytes";
+  TF_ASSIGN_OR_RETURN(
+      absl::Duration duration,
+      MeasureOpChainDuration(HloOpcode::kNegate, F32, /*chain_length=*/1,
+                             num_elements));
+  if (duration <= absl::ZeroDuration()) {
+    return FailedPrecondition("Failed to measure a %d byte copy", num_bytes);
+  }
+  // The kernel reads and writes `num_bytes` each.
+  const double bytes_per_second =
+      2.0 * num_elements * kElementSize / absl::ToDoubleSeconds(duration);
+  VLOG(3) << num_bytes << " bytes: " << duration << " = " << bytes_per_second
+          << " B/s";
+  MemoryBandwidthProfile profile;
+  profile.set_bytes(num_elements * kElementSize);
+  profile.set_bytes_per_second(bytes_per_second);
+  return profile;
+}
+
+StatusOr<absl::Duration> HloOpProfiler::MeasureKernelLaunchOverhead() {
+  constexpr int kNumKernels = 65;
+  TF_ASSIGN_OR_RETURN(absl::Duration single, MeasureKernelChainWallTime(1));
+  TF_ASSIGN_OR_RETURN(absl::Duration chain,
+                      MeasureKernelChainWallTime(kNumKernels));
+  const absl::Duration overhead = (chain - single) / (kNumKernels - 1);
+  VLOG(3) << "Kernel launch overhead: " << overhead;
+  if (overhead <= absl::ZeroDuration()) {
+    return FailedPrecondition("Failed to measure kernel launch overhead");
+  }
+  return overhead;
+}
+
 }  // namespace gpu
 }  // namespace xla
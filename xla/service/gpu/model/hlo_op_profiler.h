@@ -32,17 +32,34 @@ namespace gpu {
 
 class HloOpProfiler {
   static std::unique_ptr<HloModule> MakeModuleForMeasurements(
-      HloOpcode op, PrimitiveType data_type, int chain_length);
+      HloOpcode op, PrimitiveType data_type, int chain_length,
+      int64_t num_elements = 1);
+
+  // Returns a module running `num_kernels` dependent single-element fusions.
+  static std::unique_ptr<HloModule> MakeModuleWithKernelChain(int num_kernels);
 
   StatusOr<absl::Duration> MeasureOpChainDuration(HloOpcode op,
                                                   PrimitiveType data_type,
-                                                  int chain_length);
+                                                  int chain_length,
+                                                  int64_t num_elements = 1);
+
+  // Returns the median wall time of running a chain of `num_kernels` kernels.
+  StatusOr<absl::Duration> MeasureKernelChainWallTime(int num_kernels);
 
  public:
   explicit HloOpProfiler(HloRunner& runner);
   StatusOr<HloInstructionProfile> MeasureClockCyclesPerOp(
       HloOpcode op, PrimitiveType data_type);
 
+  // Measures the bandwidth of an elementwise kernel reading and writing
+  // buffers of `num_bytes` bytes.
+  StatusOr<MemoryBandwidthProfile> MeasureMemoryBandwidth(int64_t num_bytes);
+
+  // Measures the additional wall time it takes to run one more (trivial)
+  // kernel in an executable, which is what the performance model charges per
+  // kernel launch.
+  StatusOr<absl::Duration> MeasureKernelLaunchOverhead();
+
  private:
   HloRunner& runner_;
   const se::DeviceDescription& dev_info_;
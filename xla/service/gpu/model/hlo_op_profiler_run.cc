@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -20,8 +22,10 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "xla/debug_options_flags.h"
 #include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/device_profile.h"
 #include "xla/service/gpu/model/hlo_op_profile.pb.h"
 #include "xla/service/gpu/model/hlo_op_profiler.h"
 #include "xla/service/hlo_runner.h"
@@ -39,7 +43,9 @@ namespace gpu {
 namespace {
 
 constexpr absl::string_view kUsage = R"(
-This tool measures clock cycles per operation on GPU.
+This tool measures clock cycles per operation, memory bandwidth for a range of
+buffer sizes and kernel launch overhead on GPU. The output can be passed to
+--xla_gpu_perf_model_device_profile to calibrate the GPU performance model.
 )";
 
 void WriteOutput(const DeviceHloInstructionProfiles& literal,
@@ -108,6 +114,30 @@ int RunProfiler(int argc, char** argv) {
 
   HloInstructionProfileList instr_profiles;
 
+  auto launch_overhead = profiler.MeasureKernelLaunchOverhead();
+  if (launch_overhead.ok()) {
+    instr_profiles.set_kernel_launch_overhead_ns(
+        absl::ToInt64Nanoseconds(*launch_overhead));
+  } else {
+    LOG(ERROR) << launch_overhead.status();
+  }
+
+  // Start above the L2 cache size: the performance model accounts for cache
+  // effects separately. Devices that don't report their L2 cache size start
+  // at 1 MiB.
+  const int64_t min_bytes =
+      std::max<int64_t>(2 * dev_info.l2_cache_size(), int64_t{1} << 20);
+  const int64_t max_bytes =
+      std::min<int64_t>(int64_t{1} << 30, dev_info.device_memory_size() / 8);
+  for (int64_t bytes = min_bytes; bytes <= max_bytes; bytes *= 2) {
+    auto result = profiler.MeasureMemoryBandwidth(bytes);
+    if (result.ok()) {
+      instr_profiles.add_memory_bandwidth()->Swap(&*result);
+    } else {
+      LOG(ERROR) << result.status();
+    }
+  }
+
   for (const PrimitiveType data_type : dtypes) {
     for (const HloOpcode op : ops) {
       auto result = profiler.MeasureClockCyclesPerOp(op, data_type);
@@ -122,7 +152,9 @@ int RunProfiler(int argc, char** argv) {
   VLOG(1) << "\n" << instr_profiles.DebugString();
 
   DeviceHloInstructionProfiles device_profiles;
-  device_profiles.mutable_entries()->insert({dev_info.name(), instr_profiles});
+  // Keyed like the built-in profiles, which is what the cost model looks up.
+  device_profiles.mutable_entries()->insert(
+      {GetDeviceProfileKey(dev_info), instr_profiles});
   if (!output_file.empty()) {
     WriteOutput(device_profiles, output_file);
   }
@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "xla/service/gpu/model/hlo_op_profiler.h"
 
+#include "absl/time/time.h"
 #include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/gpu/model/hlo_op_profile.pb.h"
 #include "xla/tests/hlo_test_base.h"
 
 namespace xla {
@@ -46,6 +48,19 @@ TEST_F(HloOpProfilerTest, BasicMeasurementsAreCorrect) {
             1000);
 }
 
+TEST_F(HloOpProfilerTest, MeasuresMemoryBandwidthAndLaunchOverhead) {
+#ifndef GOOGLE_CUDA
+  GTEST_SKIP() << "Not built with --config=cuda";
+#endif
+  HloOpProfiler profiler(test_runner_);
+  MemoryBandwidthProfile bandwidth =
+      profiler.MeasureMemoryBandwidth(64 << 20).value();
+  EXPECT_EQ(bandwidth.bytes(), 64 << 20);
+  EXPECT_GT(bandwidth.bytes_per_second(), 1e10);
+  EXPECT_GT(profiler.MeasureKernelLaunchOverhead().value(),
+            absl::ZeroDuration());
+}
+
 }  // namespace
 }  // namespace gpu
 }  // namespace xla
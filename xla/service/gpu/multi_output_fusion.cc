@@ -19,6 +19,7 @@ limitations under the License.
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <vector>
 
@@ -33,6 +34,8 @@ limitations under the License.
 #include "xla/service/gpu/gpu_fusible.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/gpu/model/gpu_performance_model.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/service/hlo_cost_analysis_cache.h"
 #include "xla/service/hlo_graph_dumper.h"
 #include "xla/service/instruction_fusion.h"
 #include "xla/shape_util.h"
@@ -377,11 +380,21 @@ bool GpuMultiOutputFusion::FuseSiblings(HloInstruction* parent,
 StatusOr<bool> GpuMultiOutputFusion::DoMultiOutputFusion() {
   bool changed = false;
   RecomputeReachability();
-  GpuHloCostAnalysis cost_analysis({shape_size_function_,
+  std::optional<GpuHloCostAnalysis> owned_cost_analysis;
+  GpuHloCostAnalysis* cost_analysis;
+  if (cost_analysis_cache_ != nullptr) {
+    TF_ASSIGN_OR_RETURN(HloCostAnalysis * cached,
+                        cost_analysis_cache_->GetAnalysis(computation_));
+    cost_analysis = static_cast<GpuHloCostAnalysis*>(cached);
+  } else {
+    owned_cost_analysis.emplace(
+        GpuHloCostAnalysis::Options{shape_size_function_,
                                     /*per_second_rates=*/{},
                                     /*count_multiple_input_accesses=*/true},
-                                   &device_info_);
-  TF_RETURN_IF_ERROR(computation_->Accept(&cost_analysis));
+        &device_info_);
+    cost_analysis = &*owned_cost_analysis;
+    TF_RETURN_IF_ERROR(computation_->Accept(cost_analysis));
+  }
   std::vector<HloInstruction*> defs_before_uses =
       computation_->MakeInstructionPostOrder();
 
@@ -401,7 +414,7 @@ StatusOr<bool> GpuMultiOutputFusion::DoMultiOutputFusion() {
       continue;
     }
     // First, fuse the consumer ops of the current op, which are siblings.
-    if (FuseSiblings(/*parent=*/producer, &fusion_info_cache, &cost_analysis)) {
+    if (FuseSiblings(/*parent=*/producer, &fusion_info_cache, cost_analysis)) {
       changed = true;
     }
     // Second, perform producer-consumer multi-output fusion. This order will
@@ -409,7 +422,7 @@ StatusOr<bool> GpuMultiOutputFusion::DoMultiOutputFusion() {
     // multi-output fusion will occur before the current op in the order of
     // traversal, and hence, not get into the way of subsequent fusion attempts.
     const auto candidates = GetProducerConsumerMultiOutputFusionCandidates(
-        producer, *reachability_, &fusion_info_cache, &cost_analysis);
+        producer, *reachability_, &fusion_info_cache, cost_analysis);
     auto* consumer_for_fusion = SelectPreferredFusionCandidate(candidates);
     if (consumer_for_fusion == nullptr) {
       continue;
@@ -423,8 +436,8 @@ StatusOr<bool> GpuMultiOutputFusion::DoMultiOutputFusion() {
     changed = true;
     fusion_info_cache.Invalidate(producer);
     fusion_info_cache.Invalidate(consumer_for_fusion);
-    TF_RETURN_IF_ERROR(cost_analysis.RemoveInstruction(producer));
-    TF_RETURN_IF_ERROR(cost_analysis.RemoveInstruction(consumer_for_fusion));
+    TF_RETURN_IF_ERROR(cost_analysis->RemoveInstruction(producer));
+    TF_RETURN_IF_ERROR(cost_analysis->RemoveInstruction(consumer_for_fusion));
 
     HloInstruction* input_fusion;
     if (consumer_for_fusion->opcode() == HloOpcode::kFusion) {
@@ -450,7 +463,7 @@ StatusOr<bool> GpuMultiOutputFusion::DoMultiOutputFusion() {
       CHECK_EQ(0, producer->user_count());
       TF_CHECK_OK(computation_->RemoveInstruction(producer));
     }
-    TF_RETURN_IF_ERROR(cost_analysis.RevisitInstruction(input_fusion));
+    TF_RETURN_IF_ERROR(cost_analysis->RevisitInstruction(input_fusion));
 
     DumpFusionState(
         *input_fusion,
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <memory>
 #include <queue>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -26,6 +27,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_reachability.h"
 #include "xla/service/gpu/gpu_fusible.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
+#include "xla/service/hlo_cost_analysis_cache.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/statusor.h"
 #include "xla/stream_executor/device_description.h"
@@ -95,8 +97,11 @@ class GpuMultiOutputFusion : public HloModulePass {
  public:
   explicit GpuMultiOutputFusion(
       const se::DeviceDescription& device_info,
-      HloCostAnalysis::ShapeSizeFunction shape_size_function)
-      : device_info_(device_info), shape_size_function_(shape_size_function) {}
+      HloCostAnalysis::ShapeSizeFunction shape_size_function,
+      std::shared_ptr<HloCostAnalysisCache> cost_analysis_cache = nullptr)
+      : device_info_(device_info),
+        shape_size_function_(shape_size_function),
+        cost_analysis_cache_(std::move(cost_analysis_cache)) {}
 
   absl::string_view name() const override { return "multi_output_fusion"; }
 
@@ -125,6 +130,9 @@ class GpuMultiOutputFusion : public HloModulePass {
 
   se::DeviceDescription device_info_;
   HloCostAnalysis::ShapeSizeFunction shape_size_function_;
+  // If set, cost analyses are taken from the cache, which must create them as
+  // GpuHloCostAnalysis counting multiple input accesses.
+  std::shared_ptr<HloCostAnalysisCache> cost_analysis_cache_;
 };
 
 }  // namespace gpu
@@ -15,16 +15,24 @@ limitations under the License.
 
 #include "xla/service/gpu/nccl_collective_permute_thunk.h"
 
+#include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/types/span.h"
 #include "xla/mlir_hlo/lhlo_gpu/IR/lhlo_gpu_ops.h"
 #include "xla/service/collective_ops_utils.h"
+#include "xla/service/global_device_id.h"
 #include "xla/service/gpu/ir_emission_utils.h"
+#include "xla/service/gpu/nccl_utils.h"
+#include "xla/service/rendezvous.h"
+#include "xla/stream_executor/event.h"
 #include "xla/translate/mhlo_to_hlo/attribute_exporter.h"
 #include "xla/xla_data.pb.h"
 
@@ -110,11 +118,12 @@ Status CheckImplementable(CollectivePermuteStartOp op) {
 
 NcclCollectivePermuteStartThunk::NcclCollectivePermuteStartThunk(
     ThunkInfo thunk_info, CollectivePermuteStartOp op, int64_t replica_count,
-    int64_t partition_count, const Buffer& buffer)
+    int64_t partition_count, const Buffer& buffer, bool use_copy_engines)
     : NcclCollectiveThunk(Thunk::kNcclCollectivePermuteStart, thunk_info,
                           op.getIsSync()),
       config_(GetNcclP2PConfig(op, replica_count, partition_count)),
-      buffer_(buffer) {}
+      buffer_(buffer),
+      use_copy_engines_(use_copy_engines) {}
 
 /*static*/ NcclP2PConfig NcclCollectivePermuteStartThunk::GetNcclP2PConfig(
     CollectivePermuteStartOp op, int64_t replica_count,
@@ -162,6 +171,16 @@ Status NcclCollectivePermuteStartThunk::RunNcclCollective(
   const NcclP2PConfig::SourceTargetMapEntry source_target =
       NcclP2PConfig::GetSourceTarget(config_.id_to_source_target, current_id);
 
+  if (use_copy_engines_) {
+    TF_ASSIGN_OR_RETURN(
+        bool copied,
+        RunCopyEngineCollectivePermute(
+            copy_engine_events_, params.nccl_params, config_.config.op_id,
+            config_.config.group_mode, source_target, device_buffers[0],
+            stream, current_id));
+    if (copied) return OkStatus();
+  }
+
   return ::xla::gpu::RunCollectivePermute(source_target, device_buffers[0],
                                           stream, comm, device_string,
                                           current_id);
@@ -265,5 +284,153 @@ Status RunCollectivePermute(NcclP2PConfig::SourceTargetMapEntry source_target,
 #endif  // XLA_ENABLE_XCCL
 }
 
+StatusOr<CopyEngineCollectivePermuteEvents::Events*>
+CopyEngineCollectivePermuteEvents::Get(se::Stream& stream, int64_t op_id) {
+  absl::MutexLock lock(&mutex_);
+  std::unique_ptr<Events>& events = events_[{&stream, op_id}];
+  if (events == nullptr) {
+    auto new_events = std::make_unique<Events>();
+    for (std::unique_ptr<se::Event>* event :
+         {&new_events->ready, &new_events->sent}) {
+      *event = std::make_unique<se::Event>(stream.parent());
+      if (!(*event)->Init()) {
+        events_.erase(std::make_pair(&stream, op_id));
+        return InternalError("Failed to create a collective permute event.");
+      }
+    }
+    events = std::move(new_events);
+  }
+  return events.get();
+}
+
+#if XLA_ENABLE_XCCL
+namespace {
+
+// A participant of a collective permute running with copy engines.
+struct CopyEnginePeer {
+  int64_t id;
+  std::optional<int64_t> target;
+  se::Stream* stream;
+  se::DeviceMemoryBase destination;
+  se::Event* event;
+};
+
+using CopyEnginePeers = absl::flat_hash_map<int64_t, CopyEnginePeer>;
+
+// Returns whether the devices of all sources can write to the memory of the
+// devices of their targets, enabling peer access between them.
+bool EnablePeerAccess(const CopyEnginePeers& peers) {
+  for (const auto& [id, peer] : peers) {
+    if (!peer.target.has_value()) continue;
+    auto target = peers.find(*peer.target);
+    if (target == peers.end()) return false;
+    se::StreamExecutor* executor = peer.stream->parent();
+    se::StreamExecutor* target_executor = target->second.stream->parent();
+    if (executor == target_executor) continue;
+    if (!executor->CanEnablePeerAccessTo(target_executor)) return false;
+    Status status = executor->EnablePeerAccessTo(target_executor);
+    if (!status.ok()) {
+      VLOG(1) << "Can't run collective permute with copy engines: " << status;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+#endif  // XLA_ENABLE_XCCL
+
+StatusOr<bool> RunCopyEngineCollectivePermute(
+    CopyEngineCollectivePermuteEvents& events, const NcclExecuteParams& params,
+    int64_t op_id,
+    CollectiveOpGroupMode group_mode,
+    NcclP2PConfig::SourceTargetMapEntry source_target,
+    DeviceBufferPair& buffer, se::Stream& stream, int64_t current_id) {
+#if XLA_ENABLE_XCCL
+  TF_ASSIGN_OR_RETURN(GlobalDeviceId global_device_id,
+                      params.GetGlobalDeviceId());
+  // With a collective permute, all execution instances together form one
+  // replica group.
+  TF_ASSIGN_OR_RETURN(
+      std::vector<GlobalDeviceId> participants,
+      GetParticipatingDevices(global_device_id, *params.device_assn,
+                              /*replica_groups=*/{}, group_mode));
+  std::vector<GlobalDeviceId> local_devices;
+  if (params.gpu_global_device_ids) {
+    local_devices.reserve(params.gpu_global_device_ids->size());
+    for (const auto& entry : *params.gpu_global_device_ids) {
+      local_devices.push_back(entry.second);
+    }
+  }
+  const size_t num_local_participants = GetNumLocalParticipants(
+      participants, params.gpu_global_device_ids ? &local_devices : nullptr);
+  // Peers in other processes, possibly on other hosts, are reached with NCCL.
+  if (num_local_participants != participants.size()) return false;
+
+  TF_ASSIGN_OR_RETURN(CopyEngineCollectivePermuteEvents::Events * stream_events,
+                      events.Get(stream, op_id));
+  auto rendezvous_key = [&](int phase) {
+    return std::make_tuple(params.run_id, op_id, participants.front(), phase);
+  };
+
+  // Exchange the destination buffers once the buffers of all devices can be
+  // accessed, and check that all sources can write to their targets.
+  stream.ThenRecordEvent(stream_events->ready.get());
+  CopyEnginePeer self{current_id, source_target.target, &stream,
+                      buffer.destination_buffer, stream_events->ready.get()};
+  std::shared_ptr<std::optional<CopyEnginePeers>> peers =
+      RendezvousSingle<std::optional<CopyEnginePeers>>(
+          rendezvous_key(0), self, participants.size(),
+          [](absl::Span<const CopyEnginePeer* const> values)
+              -> std::optional<CopyEnginePeers> {
+            CopyEnginePeers peers;
+            for (const CopyEnginePeer* value : values) {
+              peers[value->id] = *value;
+            }
+            if (!EnablePeerAccess(peers)) return std::nullopt;
+            return peers;
+          });
+  // All participants take the same decision.
+  if (!peers->has_value()) return false;
+
+  VLOG(3) << absl::StreamFormat(
+      "Running collective permute with copy engines: id = %d, source_id = "
+      "%d, target_id = %d",
+      current_id, source_target.source.value_or(-1),
+      source_target.target.value_or(-1));
+  if (source_target.target) {
+    const CopyEnginePeer& target = (*peers)->at(*source_target.target);
+    stream.ThenWaitFor(target.event);
+    se::DeviceMemoryBase destination = target.destination;
+    stream.ThenMemcpy(&destination, buffer.source_buffer,
+                      buffer.source_buffer.size());
+  }
+  stream.ThenRecordEvent(stream_events->sent.get());
+
+  // The targets wait for the copies of their sources.
+  self.event = stream_events->sent.get();
+  std::shared_ptr<CopyEnginePeers> senders =
+      RendezvousSingle<CopyEnginePeers>(
+          rendezvous_key(1), self, participants.size(),
+          [](absl::Span<const CopyEnginePeer* const> values) {
+            CopyEnginePeers senders;
+            for (const CopyEnginePeer* value : values) {
+              senders[value->id] = *value;
+            }
+            return senders;
+          });
+  if (source_target.source) {
+    stream.ThenWaitFor(senders->at(*source_target.source).event);
+  } else {
+    // No one sends data to this instance, zero out the destination buffer.
+    stream.ThenMemZero(&buffer.destination_buffer,
+                       buffer.destination_buffer.size());
+  }
+  return true;
+#else   // XLA_ENABLE_XCCL
+  return false;
+#endif  // XLA_ENABLE_XCCL
+}
+
 }  // namespace gpu
 }  // namespace xla
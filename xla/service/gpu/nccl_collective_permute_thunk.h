@@ -17,14 +17,44 @@ limitations under the License.
 #define XLA_SERVICE_GPU_NCCL_COLLECTIVE_PERMUTE_THUNK_H_
 
 #include <cstdint>
+#include <memory>
+#include <utility>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/service/collective_ops_utils.h"
 #include "xla/service/gpu/nccl_collective_thunk.h"
 #include "xla/service/gpu/nccl_p2p_thunk_common.h"
+#include "xla/stream_executor/event.h"
+#include "xla/stream_executor/stream.h"
 
 namespace xla {
 namespace gpu {
 
+// Events that collective permutes running with copy engines record on the
+// streams of their participants. They are reused from one run to the next, and
+// live as long as their owner: the thunk, or the executable on the XLA runtime
+// path.
+class CopyEngineCollectivePermuteEvents {
+ public:
+  struct Events {
+    // The source buffer is ready and the destination buffer can be overwritten.
+    std::unique_ptr<se::Event> ready;
+    // The source buffer was copied to the destination buffer of the target.
+    std::unique_ptr<se::Event> sent;
+  };
+
+  // Returns the events of the collective permute `op_id` running on `stream`,
+  // creating them on the first call.
+  StatusOr<Events*> Get(se::Stream& stream, int64_t op_id);
+
+ private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::pair<se::Stream*, int64_t>, std::unique_ptr<Events>>
+      events_ ABSL_GUARDED_BY(mutex_);
+};
+
 // Thunk that performs a NCCL-based collective permute.
 class NcclCollectivePermuteStartThunk : public NcclCollectiveThunk {
  public:
@@ -47,7 +77,7 @@ class NcclCollectivePermuteStartThunk : public NcclCollectiveThunk {
                                   mlir::lmhlo_gpu::CollectivePermuteStartOp op,
                                   int64_t replica_count,
                                   int64_t partition_count,
-                                  const Buffer& buffer);
+                                  const Buffer& buffer, bool use_copy_engines);
 
  protected:
   const NcclCollectiveConfig& config() const override { return config_.config; }
@@ -57,6 +87,9 @@ class NcclCollectivePermuteStartThunk : public NcclCollectiveThunk {
  private:
   const NcclP2PConfig config_;
   const Buffer buffer_;
+  // Whether to copy the data with copy engines when all devices are local.
+  const bool use_copy_engines_;
+  CopyEngineCollectivePermuteEvents copy_engine_events_;
 };
 
 Status RunCollectivePermute(NcclP2PConfig::SourceTargetMapEntry source_target,
@@ -64,6 +97,23 @@ Status RunCollectivePermute(NcclP2PConfig::SourceTargetMapEntry source_target,
                             ncclComm_t comm, absl::string_view device_string,
                             int64_t current_id);
 
+// Runs a collective permute between the devices of this process with copy
+// engine transfers instead of NCCL kernels, leaving the SMs to the computations
+// overlapping with the collective permute. Returns false without enqueuing
+// anything if some participants are in other processes, or if a source can't
+// access the memory of its target, in which case NCCL must be used.
+//
+// The participants rendezvous twice on the host: to exchange their destination
+// buffers and the events recording that their buffers are ready, and then to
+// exchange the events recording the end of the copies. The events are taken
+// from `events`.
+StatusOr<bool> RunCopyEngineCollectivePermute(
+    CopyEngineCollectivePermuteEvents& events, const NcclExecuteParams& params,
+    int64_t op_id,
+    CollectiveOpGroupMode group_mode,
+    NcclP2PConfig::SourceTargetMapEntry source_target,
+    DeviceBufferPair& buffer, se::Stream& stream, int64_t current_id);
+
 }  // namespace gpu
 }  // namespace xla
 
@@ -22,11 +22,16 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/service/collective_ops_utils.h"
 #include "xla/service/global_device_id.h"
 #include "xla/stream_executor/gpu/gpu_activation.h"
 #include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 namespace gpu {
@@ -224,16 +229,62 @@ StatusOr<std::vector<DeviceBufferPair>> ConvertToDeviceBuffers(
   return device_buffers;
 }
 
+std::string NcclCollectiveThunk::CommunicatorKey() const {
+  return absl::StrCat(ReplicaGroupsToString(config().replica_groups), ";",
+                      CollectiveOpGroupModeToString(config().group_mode), ";",
+                      GetStreamId());
+}
+
+/*static*/ Status NcclCollectiveThunk::InitializeCommunicators(
+    const ExecuteParams& params,
+    absl::Span<const NcclCollectiveThunk* const> thunks) {
+#if XLA_ENABLE_XCCL
+  // One collective per distinct clique, in the same order on all devices.
+  std::vector<const NcclCollectiveThunk*> collectives;
+  absl::flat_hash_set<std::string> keys;
+  for (const NcclCollectiveThunk* thunk : thunks) {
+    if (keys.insert(thunk->CommunicatorKey()).second) {
+      collectives.push_back(thunk);
+    }
+  }
+  if (collectives.size() < 2) {
+    return OkStatus();
+  }
+  VLOG(1) << "Initializing " << collectives.size()
+          << " NCCL cliques concurrently on "
+          << GetDeviceString(params.nccl_params);
+
+  // Each initialization waits for the other devices of its clique, so all of
+  // them run at the same time: with fewer threads, devices could wait for
+  // cliques that other devices did not start yet.
+  std::vector<Status> statuses(collectives.size());
+  {
+    tsl::thread::ThreadPool pool(tsl::Env::Default(), "nccl_comm_init",
+                                 collectives.size());
+    for (size_t i = 0; i < collectives.size(); ++i) {
+      pool.Schedule([&, i] {
+        const NcclCollectiveThunk& thunk = *collectives[i];
+        statuses[i] =
+            LockNcclComm(params.nccl_params, thunk.config().replica_groups,
+                         thunk.config().group_mode, thunk.config().op_id,
+                         thunk.GetStreamId(),
+                         /*enable_clique_optimization=*/false)
+                .status();
+      });
+    }
+  }
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+#endif  // XLA_ENABLE_XCCL
+  return OkStatus();
+}
+
 Status NcclCollectiveThunk::ExecuteOnStream(const ExecuteParams& params) {
 #if XLA_ENABLE_XCCL
   VLOG(1) << absl::StreamFormat("Starting %s %s.", IsAsync() ? "async" : "sync",
                                 Thunk::KindToString(kind()));
-  const int64_t stream_id = GetStreamId();
-  TF_ASSIGN_OR_RETURN(
-      NcclComm::Lock comm,
-      LockNcclComm(params.nccl_params, config().replica_groups,
-                   config().group_mode, config().op_id, stream_id,
-                   /*enable_clique_optimization=*/false));
+  TF_ASSIGN_OR_RETURN(NcclComm::Lock comm, LockComm(params));
 
   // Run the collective on main stream or using the async executor.
   Status status = [&]() {
@@ -268,6 +319,21 @@ Status NcclCollectiveThunk::ExecuteOnStream(const ExecuteParams& params) {
 #endif  // XLA_ENABLE_XCCL
 }
 
+#if XLA_ENABLE_XCCL
+StatusOr<NcclComm::Lock> NcclCollectiveThunk::LockComm(
+    const ExecuteParams& params) const {
+  return LockNcclComm(params.nccl_params, config().replica_groups,
+                      config().group_mode, config().op_id, GetStreamId(),
+                      /*enable_clique_optimization=*/false);
+}
+#endif  // XLA_ENABLE_XCCL
+
+Status NcclCollectiveThunk::ExecuteOnStreamWithComm(const ExecuteParams& params,
+                                                    ncclComm_t comm) {
+  TF_RET_CHECK(!IsAsync()) << "Only synchronous collectives can be grouped";
+  return RunNcclCollective(params, *params.stream, comm);
+}
+
 std::string NcclCollectiveThunk::GetDeviceString(
     const NcclExecuteParams& nccl_params) {
   int device_ordinal = nccl_params.stream_executor->device_ordinal();
@@ -22,6 +22,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/functional/function_ref.h"
+#include "absl/types/span.h"
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "xla/service/collective_ops_utils.h"
 #include "xla/service/gpu/ir_emission_utils.h"
@@ -139,6 +140,30 @@ class NcclCollectiveThunk : public Thunk {
   AsyncExecutor* async_executor() { return async_.get(); }
   Status ExecuteOnStream(const ExecuteParams& params) override;
 
+#if XLA_ENABLE_XCCL
+  // Locks the communicator of the collective on the device of `params`.
+  StatusOr<NcclComm::Lock> LockComm(const ExecuteParams& params) const;
+#endif  // XLA_ENABLE_XCCL
+
+  // Enqueues the synchronous collective on the main stream using `comm`, which
+  // the caller must have locked. Used by NcclGroupThunk, which keeps the
+  // communicators of its collectives locked until the group ends.
+  Status ExecuteOnStreamWithComm(const ExecuteParams& params,
+                                 ncclComm_t comm);
+
+  // Identifies the cliques of the collective: collectives with the same key
+  // use the same communicators.
+  std::string CommunicatorKey() const;
+
+  // Initializes the communicators of the collective thunks concurrently, one
+  // per distinct clique, instead of one at a time on the first execution of
+  // each collective. All the devices executing the thunks must call it, with
+  // the same thunks in the same order. GpuExecutable passes all the collectives
+  // of the module, including the ones nested in control flow thunks.
+  static Status InitializeCommunicators(
+      const ExecuteParams& params,
+      absl::Span<const NcclCollectiveThunk* const> thunks);
+
  protected:
   virtual Status RunNcclCollective(const ExecuteParams& params,
                                    se::Stream& stream, ncclComm_t comm) = 0;
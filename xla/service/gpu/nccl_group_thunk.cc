@@ -0,0 +1,113 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/nccl_group_thunk.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "xla/service/gpu/nccl_collective_thunk.h"
+#include "xla/util.h"
+#include "tsl/platform/errors.h"
+#include "tsl/profiler/lib/scoped_annotation.h"
+
+#if XLA_ENABLE_XCCL
+#include "xla/service/gpu/nccl_utils.h"
+#endif  // XLA_ENABLE_XCCL
+
+namespace xla {
+namespace gpu {
+
+using ::tsl::profiler::ScopedAnnotation;
+
+NcclGroupThunk::NcclGroupThunk(ThunkInfo thunk_info, ThunkSequence thunks)
+    : Thunk(Kind::kNcclGroup, thunk_info), thunks_(std::move(thunks)) {}
+
+std::string NcclGroupThunk::ToStringExtra(int indent) const {
+  std::string result = "\n";
+  absl::StrAppend(&result, thunks().ToString(indent + 1, nullptr));
+  return result;
+}
+
+Status NcclGroupThunk::Initialize(se::StreamExecutor* executor,
+                                  ExecutableSource src) {
+  for (auto& thunk : thunks_) {
+    TF_RETURN_IF_ERROR(thunk->Initialize(executor, src));
+  }
+  return OkStatus();
+}
+
+Status NcclGroupThunk::ExecuteOnStream(const ExecuteParams& params) {
+#if XLA_ENABLE_XCCL
+  auto execute_thunks = [&]() -> Status {
+    for (const auto& thunk : thunks_) {
+      ScopedAnnotation annotation([&] { return thunk->profile_annotation(); });
+      TF_RETURN_IF_ERROR(thunk->ExecuteOnStream(params));
+    }
+    return OkStatus();
+  };
+
+  if (first_call_to_execute_) {
+    first_call_to_execute_ = false;
+    return execute_thunks();
+  }
+
+  // Lock the communicators before the group starts, and keep them locked
+  // until it ends: the collectives are only enqueued by ncclGroupEnd(), and
+  // another thread must not use the communicators in the meantime. Each
+  // communicator is locked once, even if several collectives use it.
+  absl::flat_hash_map<std::string, NcclComm::Lock> locks;
+  std::vector<ncclComm_t> comms;
+  comms.reserve(thunks_.size());
+  for (const auto& thunk : thunks_) {
+    auto* collective = static_cast<NcclCollectiveThunk*>(thunk.get());
+    std::string key = collective->CommunicatorKey();
+    auto it = locks.find(key);
+    if (it == locks.end()) {
+      TF_ASSIGN_OR_RETURN(NcclComm::Lock lock, collective->LockComm(params));
+      it = locks.emplace(std::move(key), std::move(lock)).first;
+    }
+    comms.push_back(*it->second);
+  }
+
+  VLOG(3) << "Launching " << thunks_.size() << " collectives as a group";
+  XLA_CUDA_RETURN_IF_ERROR(ncclGroupStart());
+  Status status = [&]() -> Status {
+    for (size_t i = 0; i < thunks_.size(); ++i) {
+      const auto& thunk = thunks_[i];
+      ScopedAnnotation annotation([&] { return thunk->profile_annotation(); });
+      TF_RETURN_IF_ERROR(
+          static_cast<NcclCollectiveThunk*>(thunk.get())
+              ->ExecuteOnStreamWithComm(params, comms[i]));
+    }
+    return OkStatus();
+  }();
+  // The group must be closed even if one of the collectives failed to
+  // enqueue; the first error is reported.
+  Status group_end_status = XLA_CUDA_STATUS(ncclGroupEnd());
+  TF_RETURN_IF_ERROR(status);
+  return group_end_status;
+#else   // XLA_ENABLE_XCCL
+  return Unimplemented(
+      "NCCL support is not available: this binary was not built with a CUDA "
+      "compiler, which is necessary to build the NCCL source library.");
+#endif  // XLA_ENABLE_XCCL
+}
+
+}  // namespace gpu
+}  // namespace xla
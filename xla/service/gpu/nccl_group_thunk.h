@@ -0,0 +1,60 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_NCCL_GROUP_THUNK_H_
+#define XLA_SERVICE_GPU_NCCL_GROUP_THUNK_H_
+
+#include <string>
+
+#include "xla/service/gpu/thunk.h"
+#include "xla/status.h"
+#include "xla/stream_executor/stream_executor.h"
+
+namespace xla {
+namespace gpu {
+
+// A thunk that launches a list of synchronous, mutually independent NCCL
+// collective thunks as a single NCCL group (ncclGroupStart/ncclGroupEnd), so
+// that NCCL fuses them into one launch. This amortizes the launch latency of
+// many small collectives, e.g. all-reduces of small gradient buckets.
+//
+// The first execution runs the collectives one by one, so that every
+// collective thunk can set up its communicator outside of a group. Later
+// executions lock the communicators of all collectives before the group starts
+// and release them once it ended.
+class NcclGroupThunk : public Thunk {
+ public:
+  NcclGroupThunk(ThunkInfo thunk_info, ThunkSequence thunks);
+  NcclGroupThunk(const NcclGroupThunk&) = delete;
+  NcclGroupThunk& operator=(const NcclGroupThunk&) = delete;
+
+  ThunkSequence& thunks() { return thunks_; }
+  const ThunkSequence& thunks() const { return thunks_; }
+  std::string ToStringExtra(int indent) const override;
+
+  Status Initialize(se::StreamExecutor* executor,
+                    ExecutableSource src) override;
+  Status ExecuteOnStream(const ExecuteParams& params) override;
+
+ private:
+  // The collective thunks launched as a group.
+  ThunkSequence thunks_;
+  bool first_call_to_execute_ = true;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_NCCL_GROUP_THUNK_H_
@@ -15,16 +15,38 @@ limitations under the License.
 
 #include "xla/service/gpu/nccl_p2p_thunk_common.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
 #include "mlir/IR/BuiltinAttributes.h"  // from @llvm-project
 #include "xla/service/hlo_parser.h"
+#include "xla/util.h"
 #include "xla/xla_data.pb.h"
 
 namespace xla {
 namespace gpu {
 
+std::vector<NcclP2PChunk> GetNcclP2PChunks(int64_t element_count,
+                                           int64_t element_size,
+                                           int64_t chunk_size_bytes) {
+  if (chunk_size_bytes <= 0 || element_size <= 0 ||
+      element_count * element_size <= chunk_size_bytes) {
+    return {NcclP2PChunk{0, element_count}};
+  }
+  const int64_t elements_per_chunk =
+      std::max<int64_t>(chunk_size_bytes / element_size, 1);
+  std::vector<NcclP2PChunk> chunks;
+  chunks.reserve(CeilOfRatio(element_count, elements_per_chunk));
+  for (int64_t offset = 0; offset < element_count;
+       offset += elements_per_chunk) {
+    chunks.push_back(NcclP2PChunk{
+        offset, std::min(elements_per_chunk, element_count - offset)});
+  }
+  return chunks;
+}
+
 StatusOr<std::vector<std::pair<int64_t, int64_t>>> GetSourceTargetPairs(
     mlir::DictionaryAttr frontend_attributes) {
   mlir::StringAttr src_dst_string = frontend_attributes.getAs<mlir::StringAttr>(
@@ -57,6 +57,21 @@ struct NcclP2PConfig {
   IdToSourceTargetMap id_to_source_target;
 };
 
+// A contiguous range of the elements of a point-to-point transfer.
+struct NcclP2PChunk {
+  int64_t offset;
+  int64_t count;
+};
+
+// Splits a transfer of `element_count` elements of `element_size` bytes into
+// chunks of at most `chunk_size_bytes` bytes (and at least one element). The
+// sender and the receiver issue one operation per chunk, in order and within
+// one NCCL group, so that the transfer of a chunk overlaps the one of the next.
+// A non-positive chunk size transfers all the elements at once.
+std::vector<NcclP2PChunk> GetNcclP2PChunks(int64_t element_count,
+                                           int64_t element_size,
+                                           int64_t chunk_size_bytes);
+
 // Extracts source/target pairs for send/recv from frontend attributes.
 StatusOr<std::vector<std::pair<int64_t, int64_t>>> GetSourceTargetPairs(
     mlir::DictionaryAttr frontend_attributes);
@@ -0,0 +1,69 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/nccl_p2p_thunk_common.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FieldsAre;
+
+TEST(GetNcclP2PChunksTest, NonPositiveChunkSizeTransfersAllElements) {
+  EXPECT_THAT(GetNcclP2PChunks(/*element_count=*/100, /*element_size=*/4,
+                               /*chunk_size_bytes=*/0),
+              ElementsAre(FieldsAre(0, 100)));
+  EXPECT_THAT(GetNcclP2PChunks(/*element_count=*/100, /*element_size=*/4,
+                               /*chunk_size_bytes=*/-1),
+              ElementsAre(FieldsAre(0, 100)));
+}
+
+TEST(GetNcclP2PChunksTest, TransferSmallerThanChunkIsNotSplit) {
+  EXPECT_THAT(GetNcclP2PChunks(/*element_count=*/100, /*element_size=*/4,
+                               /*chunk_size_bytes=*/400),
+              ElementsAre(FieldsAre(0, 100)));
+  EXPECT_THAT(GetNcclP2PChunks(/*element_count=*/0, /*element_size=*/0,
+                               /*chunk_size_bytes=*/16),
+              ElementsAre(FieldsAre(0, 0)));
+}
+
+TEST(GetNcclP2PChunksTest, SplitsIntoChunksOfWholeElements) {
+  // 40 bytes per chunk are 10 elements of 4 bytes, the last chunk is partial.
+  EXPECT_THAT(GetNcclP2PChunks(/*element_count=*/25, /*element_size=*/4,
+                               /*chunk_size_bytes=*/40),
+              ElementsAre(FieldsAre(0, 10), FieldsAre(10, 10),
+                          FieldsAre(20, 5)));
+  // Chunk sizes that aren't a multiple of the element size are rounded down.
+  EXPECT_THAT(GetNcclP2PChunks(/*element_count=*/6, /*element_size=*/4,
+                               /*chunk_size_bytes=*/10),
+              ElementsAre(FieldsAre(0, 2), FieldsAre(2, 2), FieldsAre(4, 2)));
+}
+
+TEST(GetNcclP2PChunksTest, ChunksHoldAtLeastOneElement) {
+  EXPECT_THAT(GetNcclP2PChunks(/*element_count=*/3, /*element_size=*/8,
+                               /*chunk_size_bytes=*/2),
+              ElementsAre(FieldsAre(0, 1), FieldsAre(1, 1), FieldsAre(2, 1)));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -97,7 +97,8 @@ Status NcclRecvThunk::RunNcclCollective(const ExecuteParams& params,
 
 Status RunRecv(NcclP2PConfig::SourceTargetMapEntry source_target,
                DeviceBufferPair& buffer, se::Stream& stream, ncclComm_t comm,
-               absl::string_view device_string, int64_t current_id) {
+               absl::string_view device_string, int64_t current_id,
+               int64_t chunk_size_bytes) {
 #if XLA_ENABLE_XCCL
   // Determine the source IDs for this instance. The source ID is the ID for
   // the peer that will copy its data to this instance. If there is no source,
@@ -122,13 +123,24 @@ Status RunRecv(NcclP2PConfig::SourceTargetMapEntry source_target,
 
   // Receive data from the source peer to the destination buffer.
   if (source_id) {
-    VLOG(3) << absl::StreamFormat(
-        "%s : Calling ncclRecv(recvbuff=%p, count=%d, peer=%d comm=%p, "
-        "stream=%p)",
-        device_string, dest_addr.opaque(), element_count, *source_id,
-        static_cast<const void*>(comm), gpu_stream);
-    XLA_CUDA_RETURN_IF_ERROR(ncclRecv(dest_addr.opaque(), element_count, dtype,
-                                      *source_id, comm, gpu_stream));
+    const int64_t element_size =
+        element_count > 0 ? dest_addr.size() / element_count : 0;
+    // The chunks are issued as one group, like the operations of the other
+    // collectives, so that NCCL launches and pipelines them together.
+    XLA_CUDA_RETURN_IF_ERROR(ncclGroupStart());
+    for (const NcclP2PChunk& chunk :
+         GetNcclP2PChunks(element_count, element_size, chunk_size_bytes)) {
+      void* chunk_addr =
+          static_cast<char*>(dest_addr.opaque()) + chunk.offset * element_size;
+      VLOG(3) << absl::StreamFormat(
+          "%s : Calling ncclRecv(recvbuff=%p, count=%d, peer=%d comm=%p, "
+          "stream=%p)",
+          device_string, chunk_addr, chunk.count, *source_id,
+          static_cast<const void*>(comm), gpu_stream);
+      XLA_CUDA_RETURN_IF_ERROR(ncclRecv(chunk_addr, chunk.count, dtype,
+                                        *source_id, comm, gpu_stream));
+    }
+    XLA_CUDA_RETURN_IF_ERROR(ncclGroupEnd());
   } else {
     // If there is no source peer, i.e. no sender to this instance, zero out
     // the destination buffer.
@@ -56,9 +56,12 @@ class NcclRecvThunk : public NcclCollectiveThunk {
   const Buffer buffer_;
 };
 
+// Transfers the buffer in chunks of at most `chunk_size_bytes` bytes if it is
+// positive, see GetNcclP2PChunks.
 Status RunRecv(NcclP2PConfig::SourceTargetMapEntry source_target,
                DeviceBufferPair& buffer, se::Stream& stream, ncclComm_t comm,
-               absl::string_view device_string, int64_t current_id);
+               absl::string_view device_string, int64_t current_id,
+               int64_t chunk_size_bytes = 0);
 
 }  // namespace gpu
 }  // namespace xla
@@ -97,7 +97,8 @@ Status NcclSendThunk::RunNcclCollective(const ExecuteParams& params,
 
 Status RunSend(NcclP2PConfig::SourceTargetMapEntry source_target,
                DeviceBufferPair& buffer, se::Stream& stream, ncclComm_t comm,
-               absl::string_view device_string, int64_t current_id) {
+               absl::string_view device_string, int64_t current_id,
+               int64_t chunk_size_bytes) {
 #if XLA_ENABLE_XCCL
   // Determine the target IDs for this instance. The target ID is the ID
   // to which this instance will copy its data.
@@ -122,13 +123,24 @@ Status RunSend(NcclP2PConfig::SourceTargetMapEntry source_target,
 
   // Send source buffer to target peer if needed.
   if (target_id) {
-    VLOG(3) << absl::StreamFormat(
-        "%s : Calling ncclSend(sendbuff=%p, count=%d, peer=%d "
-        "comm=%p, stream=%p)",
-        device_string, src_addr.opaque(), element_count, *target_id,
-        static_cast<const void*>(comm), gpu_stream);
-    XLA_CUDA_RETURN_IF_ERROR(ncclSend(src_addr.opaque(), element_count, dtype,
-                                      *target_id, comm, gpu_stream));
+    const int64_t element_size =
+        element_count > 0 ? src_addr.size() / element_count : 0;
+    // The chunks are issued as one group, like the operations of the other
+    // collectives, so that NCCL launches and pipelines them together.
+    XLA_CUDA_RETURN_IF_ERROR(ncclGroupStart());
+    for (const NcclP2PChunk& chunk :
+         GetNcclP2PChunks(element_count, element_size, chunk_size_bytes)) {
+      void* chunk_addr =
+          static_cast<char*>(src_addr.opaque()) + chunk.offset * element_size;
+      VLOG(3) << absl::StreamFormat(
+          "%s : Calling ncclSend(sendbuff=%p, count=%d, peer=%d "
+          "comm=%p, stream=%p)",
+          device_string, chunk_addr, chunk.count, *target_id,
+          static_cast<const void*>(comm), gpu_stream);
+      XLA_CUDA_RETURN_IF_ERROR(ncclSend(chunk_addr, chunk.count, dtype,
+                                        *target_id, comm, gpu_stream));
+    }
+    XLA_CUDA_RETURN_IF_ERROR(ncclGroupEnd());
   }
   return OkStatus();
 #else   // XLA_ENABLE_XCCL
@@ -54,9 +54,11 @@ limitations under the License.
 #include "xla/service/gpu/gpu_asm_opts_util.h"
 #include "xla/service/gpu/gpu_conv_padding_legalization.h"
 #include "xla/service/gpu/gpu_conv_rewriter.h"
+#include "xla/service/gpu/gpu_sort_rewriter.h"
 #include "xla/service/gpu/ir_emission_utils.h"
 #include "xla/service/gpu/llvm_gpu_backend/gpu_backend_lib.h"
 #include "xla/service/gpu/metrics.h"
+#include "xla/service/gpu/persistent_kernel_cache.h"
 #include "xla/service/gpu/target_constants.h"
 #include "xla/service/gpu/triangular_solve_rewriter.h"
 #include "xla/service/gpu/triton_autotuner.h"
@@ -195,6 +197,12 @@ Status NVPTXCompiler::OptimizeHloConvolutionCanonicalization(
   return OkStatus();
 }
 
+bool NVPTXCompiler::KeepEighForLibraryCall(
+    const HloInstruction* eigh, const DebugOptions& debug_options) const {
+  return debug_options.xla_gpu_enable_cusolver_batched_eigh() &&
+         IsBatchedEighSupported(eigh);
+}
+
 Status NVPTXCompiler::OptimizeHloPostLayoutAssignment(
     HloModule* hlo_module, se::StreamExecutor* stream_exec,
     const CompileOptions& options, const TargetConfig& gpu_target_config,
@@ -269,6 +277,10 @@ Status NVPTXCompiler::OptimizeHloPostLayoutAssignment(
   // memory.
   post_pipeline.AddPass<TriangularSolveRewriter>();
 
+  if (hlo_module->config().debug_options().xla_gpu_enable_cub_radix_sort()) {
+    post_pipeline.AddPass<GpuSortRewriter>();
+  }
+
   TF_RETURN_IF_ERROR(post_pipeline.Run(hlo_module).status());
 
   return OkStatus();
@@ -454,6 +466,32 @@ NVPTXCompiler::CompileTargetBinary(const HloModuleConfig& module_config,
     selected_module = llvm_module;
   }
 
+  se::CudaComputeCapability cc =
+      std::get<se::CudaComputeCapability>(gpu_version);
+
+  // Kernels loaded from user-provided files bypass the persistent cache, as
+  // they don't correspond to the emitted IR.
+  std::optional<PersistentKernelCache> persistent_cache;
+  std::string persistent_cache_key;
+  const std::string& persistent_cache_dir =
+      module_config.debug_options().xla_gpu_persistent_kernel_cache_dir();
+  if (!persistent_cache_dir.empty() && !loaded_module &&
+      module_config.debug_options().xla_gpu_ptx_file().empty()) {
+    persistent_cache.emplace(persistent_cache_dir);
+    persistent_cache_key = PersistentKernelCache::GetKey(
+        *selected_module, cc, relocatable, module_config.debug_options());
+    StatusOr<std::optional<PersistentKernelCache::Entry>> cached =
+        persistent_cache->Lookup(persistent_cache_key);
+    if (!cached.ok()) {
+      LOG(WARNING) << "Failed to read from the persistent kernel cache: "
+                   << cached.status();
+    } else if (cached->has_value()) {
+      PersistentKernelCache::Entry& entry = **cached;
+      return std::pair<std::string, std::vector<uint8_t>>(
+          std::move(entry.ptx), std::move(entry.cubin));
+    }
+  }
+
   std::string ptx;
   if (!(debug_module &&
         MaybeLoadPtxFromFile(module_config, debug_module, &ptx))) {
@@ -476,13 +514,26 @@ NVPTXCompiler::CompileTargetBinary(const HloModuleConfig& module_config,
   }
 
   StatusOr<std::vector<uint8_t>> maybe_cubin = CompileGpuAsmOrGetCachedResult(
-      ptx, std::get<se::CudaComputeCapability>(gpu_version), module_config,
+      ptx, cc, module_config,
       (debug_module != nullptr ? debug_module->name() : "(unknown)"),
       relocatable, options);
 
   if (maybe_cubin.status().code() == absl::StatusCode::kCancelled) {
     return maybe_cubin.status();
   }
+
+  // An empty cubin means that we fell back to the driver JIT; don't persist
+  // that, so that a later compilation with a working ptxas fills the entry.
+  if (persistent_cache.has_value() && maybe_cubin.ok() &&
+      !maybe_cubin->empty()) {
+    Status stored = persistent_cache->Insert(
+        persistent_cache_key,
+        PersistentKernelCache::Entry{ptx, *maybe_cubin});
+    if (!stored.ok()) {
+      LOG(WARNING) << "Failed to write to the persistent kernel cache: "
+                   << stored;
+    }
+  }
   return std::pair<std::string, std::vector<uint8_t>>(
       std::move(ptx), std::move(maybe_cubin.value()));
 }
@@ -506,11 +557,18 @@ StatusOr<std::vector<uint8_t>> NVPTXCompiler::CompileGpuAsmOrGetCachedResult(
   const std::string* cache_ptx = nullptr;
   CompilationCacheValue* cache_value = nullptr;
 
+  se::GpuAsmOpts ptxas_config =
+      PtxOptsFromDebugOptions(hlo_module_config.debug_options());
+  if (relocatable) {
+    ptxas_config.extra_flags.push_back("-c");
+  }
+
   {
     absl::MutexLock lock(&mutex_);
     std::tie(iter, inserted) = compilation_cache_.emplace(
         std::piecewise_construct,
-        std::forward_as_tuple(ptx, cc.major, cc.minor, relocatable),
+        std::forward_as_tuple(ptx, cc.major, cc.minor, relocatable,
+                              ptxas_config.ToTuple()),
         std::forward_as_tuple());
     cache_ptx = &iter->first.ptx;
     cache_value = &iter->second;
@@ -524,11 +582,6 @@ StatusOr<std::vector<uint8_t>> NVPTXCompiler::CompileGpuAsmOrGetCachedResult(
     if (inserted) {
       CHECK(!cache_value->compilation_done);
       if (!ptx.empty()) {
-        se::GpuAsmOpts ptxas_config =
-            PtxOptsFromDebugOptions(hlo_module_config.debug_options());
-        if (relocatable) {
-          ptxas_config.extra_flags.push_back("-c");
-        }
         uint64_t start_usecs = tsl::Env::Default()->NowMicros();
 
         bool cancel_if_reg_spill =
@@ -26,6 +26,7 @@ limitations under the License.
 #include "xla/service/gpu/gpu_compiler.h"
 #include "xla/statusor.h"
 #include "xla/stream_executor/device_description.h"
+#include "xla/stream_executor/gpu/gpu_asm_opts.h"
 #include "xla/xla.pb.h"
 #include "tsl/platform/threadpool.h"
 
@@ -44,6 +45,9 @@ class NVPTXCompiler : public GpuCompiler {
       se::dnn::VersionInfo dnn_version,
       se::DeviceMemoryAllocator* device_allocator) override;
 
+  bool KeepEighForLibraryCall(const HloInstruction* eigh,
+                              const DebugOptions& debug_options) const override;
+
   Status OptimizeHloPostLayoutAssignment(
       HloModule* hlo_module, se::StreamExecutor* stream_exec,
       const CompileOptions& options, const TargetConfig& gpu_target_config,
@@ -98,10 +102,11 @@ class NVPTXCompiler : public GpuCompiler {
       const HloModuleConfig& hlo_module_config, absl::string_view module_name,
       bool relocatable, const CompileOptions& options);
 
-  // The compilation_cache_ map is a cache from {ptx string, cc_major, cc_minor}
-  // -> cubin so we don't recompile the same ptx twice.  This is important for
-  // some interactive workflows.  (We also cache at the HLO level, but sometimes
-  // we can't realize that two modules are the same until we lower to ptx.)
+  // The compilation_cache_ map is a cache from {ptx string, cc_major, cc_minor,
+  // relocatable, ptxas options} -> cubin so we don't recompile the same ptx
+  // twice.  This is important for some interactive workflows.  (We also cache
+  // at the HLO level, but sometimes we can't realize that two modules are the
+  // same until we lower to ptx.)
   //
   // Compilation of distinct PTX happens in parallel. If more than one thread
   // attempts to compile the same PTX, the fist thread to obtain
@@ -112,25 +117,31 @@ class NVPTXCompiler : public GpuCompiler {
   // and leave compilation up to the driver.
   struct CompilationCacheKey {
     CompilationCacheKey(std::string ptx, int cc_major, int cc_minor,
-                        bool relocatable)
+                        bool relocatable,
+                        se::GpuAsmOpts::PtxOptionsTuple ptxas_options)
         : ptx(std::move(ptx)),
           cc_major(cc_major),
           cc_minor(cc_minor),
-          relocatable(relocatable) {}
+          relocatable(relocatable),
+          ptxas_options(std::move(ptxas_options)) {}
     template <typename H>
     friend H AbslHashValue(H h, const CompilationCacheKey& key) {
       return H::combine(std::move(h), key.ptx, key.cc_major, key.cc_minor,
-                        key.relocatable);
+                        key.relocatable, key.ptxas_options);
     }
     friend bool operator==(const CompilationCacheKey& a,
                            const CompilationCacheKey& b) {
       return a.cc_major == b.cc_major && a.cc_minor == b.cc_minor &&
-             a.ptx == b.ptx && a.relocatable == b.relocatable;
+             a.relocatable == b.relocatable &&
+             a.ptxas_options == b.ptxas_options && a.ptx == b.ptx;
     }
     std::string ptx;
     int cc_major;
     int cc_minor;
     bool relocatable;
+    // Modules compiled with different ptxas flags (e.g. with optimizations
+    // disabled) must not share a cubin.
+    se::GpuAsmOpts::PtxOptionsTuple ptxas_options;
   };
   struct CompilationCacheValue {
     bool compilation_done = false;
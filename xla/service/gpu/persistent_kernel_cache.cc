@@ -0,0 +1,151 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/gpu/persistent_kernel_cache.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "llvm/IR/Module.h"
+#include "xla/service/llvm_ir/llvm_util.h"
+#include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/fingerprint.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/path.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+constexpr absl::string_view kPtxExtension = ".ptx";
+constexpr absl::string_view kCubinExtension = ".cubin";
+
+// Drops the lines of the printed module that only depend on the name of the
+// HLO module it was emitted for.
+std::string StripModuleIdentity(absl::string_view llvm_ir) {
+  std::vector<absl::string_view> lines;
+  for (absl::string_view line : absl::StrSplit(llvm_ir, '\n')) {
+    if (absl::StartsWith(line, "; ModuleID = ") ||
+        absl::StartsWith(line, "source_filename = ")) {
+      continue;
+    }
+    lines.push_back(line);
+  }
+  return absl::StrJoin(lines, "\n");
+}
+
+// Writes `contents` to `path` through a temporary file, so that concurrent
+// readers never observe a partially written file.
+Status AtomicallyWriteFile(const std::string& path,
+                           absl::string_view contents) {
+  tsl::Env* env = tsl::Env::Default();
+  std::string tmp_path = path;
+  if (!env->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return FailedPrecondition("Couldn't create a temporary file name for %s",
+                              path);
+  }
+  TF_RETURN_IF_ERROR(tsl::WriteStringToFile(env, tmp_path, contents));
+  return env->RenameFile(tmp_path, path);
+}
+
+}  // namespace
+
+std::string PersistentKernelCache::GetKey(
+    const llvm::Module& llvm_module,
+    const se::CudaComputeCapability& gpu_version, bool relocatable,
+    const DebugOptions& debug_options) {
+  return GetKey(llvm_ir::DumpToString(&llvm_module), gpu_version, relocatable,
+                debug_options);
+}
+
+std::string PersistentKernelCache::GetKey(
+    absl::string_view llvm_ir, const se::CudaComputeCapability& gpu_version,
+    bool relocatable, const DebugOptions& debug_options) {
+  // Only the options that influence LLVM optimization, PTX emission or ptxas
+  // are part of the key. Everything else (dumping, autotuning, ...) must not
+  // invalidate the cache.
+  std::string options = absl::StrCat(
+      "cc=", gpu_version.major, ".", gpu_version.minor,
+      ";relocatable=", relocatable, ";ftz=", debug_options.xla_gpu_ftz(),
+      ";opt_level=", debug_options.xla_backend_optimization_level(),
+      ";disable_expensive_passes=",
+      debug_options.xla_llvm_disable_expensive_passes(),
+      ";triton_gemm=", debug_options.xla_gpu_enable_triton_gemm(),
+      ";disable_gpuasm_optimizations=",
+      debug_options.xla_gpu_disable_gpuasm_optimizations(),
+      ";asm_extra_flags=", debug_options.xla_gpu_asm_extra_flags(),
+      ";cuda_data_dir=", debug_options.xla_gpu_cuda_data_dir());
+  for (const auto& [option, value] :
+       debug_options.xla_backend_extra_options()) {
+    absl::StrAppend(&options, ";", option, "=", value);
+  }
+
+  tsl::Fprint128 fingerprint = tsl::Fingerprint128(
+      absl::StrCat(options, "\n", StripModuleIdentity(llvm_ir)));
+  return absl::StrFormat("%016x%016x", fingerprint.high64, fingerprint.low64);
+}
+
+std::string PersistentKernelCache::GetPathPrefix(absl::string_view key) const {
+  return tsl::io::JoinPath(cache_dir_, key);
+}
+
+StatusOr<std::optional<PersistentKernelCache::Entry>>
+PersistentKernelCache::Lookup(absl::string_view key) const {
+  tsl::Env* env = tsl::Env::Default();
+  std::string prefix = GetPathPrefix(key);
+  std::string ptx_path = absl::StrCat(prefix, kPtxExtension);
+  std::string cubin_path = absl::StrCat(prefix, kCubinExtension);
+
+  // The PTX file is written last, so its presence implies a complete entry.
+  if (!env->FileExists(ptx_path).ok()) {
+    VLOG(3) << "Persistent kernel cache miss for " << key;
+    return std::nullopt;
+  }
+
+  Entry entry;
+  TF_RETURN_IF_ERROR(tsl::ReadFileToString(env, ptx_path, &entry.ptx));
+  std::string cubin;
+  TF_RETURN_IF_ERROR(tsl::ReadFileToString(env, cubin_path, &cubin));
+  entry.cubin.assign(cubin.begin(), cubin.end());
+  VLOG(3) << "Persistent kernel cache hit for " << key;
+  return entry;
+}
+
+Status PersistentKernelCache::Insert(absl::string_view key,
+                                     const Entry& entry) const {
+  tsl::Env* env = tsl::Env::Default();
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(cache_dir_));
+
+  std::string prefix = GetPathPrefix(key);
+  TF_RETURN_IF_ERROR(AtomicallyWriteFile(
+      absl::StrCat(prefix, kCubinExtension),
+      absl::string_view(reinterpret_cast<const char*>(entry.cubin.data()),
+                        entry.cubin.size())));
+  TF_RETURN_IF_ERROR(
+      AtomicallyWriteFile(absl::StrCat(prefix, kPtxExtension), entry.ptx));
+  VLOG(3) << "Stored " << key << " in the persistent kernel cache";
+  return OkStatus();
+}
+
+}  // namespace gpu
+}  // namespace xla
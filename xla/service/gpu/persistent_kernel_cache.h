@@ -0,0 +1,93 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef XLA_SERVICE_GPU_PERSISTENT_KERNEL_CACHE_H_
+#define XLA_SERVICE_GPU_PERSISTENT_KERNEL_CACHE_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+#include "xla/stream_executor/device_description.h"
+#include "xla/xla.pb.h"
+
+namespace llvm {
+class Module;
+}  // namespace llvm
+
+namespace xla {
+namespace gpu {
+
+// A content-addressed, on-disk cache of compiled GPU kernels.
+//
+// Entries are keyed by a fingerprint of the unoptimized LLVM IR (which is
+// emitted per fusion and deduplicated with the fingerprints computed by
+// `KernelReuseCache`), the target compute capability and the compiler flags
+// that influence code generation. A hit lets the compiler skip both the LLVM
+// optimization pipeline and ptxas.
+//
+// The cache directory may be shared between processes: entries are written to
+// a temporary file and atomically renamed into place, so readers either see a
+// complete entry or none at all.
+//
+// Thread-safe.
+class PersistentKernelCache {
+ public:
+  struct Entry {
+    std::string ptx;
+    std::vector<uint8_t> cubin;
+  };
+
+  explicit PersistentKernelCache(std::string cache_dir)
+      : cache_dir_(std::move(cache_dir)) {}
+
+  // Returns the cache key for compiling `llvm_module` for `gpu_version` with
+  // the given options. The module identifier and source file name are not part
+  // of the key, so identical kernels emitted for differently named HLO modules
+  // map to the same entry.
+  static std::string GetKey(const llvm::Module& llvm_module,
+                            const se::CudaComputeCapability& gpu_version,
+                            bool relocatable,
+                            const DebugOptions& debug_options);
+
+  // Like above, for an already printed LLVM module.
+  static std::string GetKey(absl::string_view llvm_ir,
+                            const se::CudaComputeCapability& gpu_version,
+                            bool relocatable,
+                            const DebugOptions& debug_options);
+
+  // Returns the entry stored for `key`, or std::nullopt on a miss.
+  StatusOr<std::optional<Entry>> Lookup(absl::string_view key) const;
+
+  // Stores `entry` for `key`, replacing any existing entry.
+  Status Insert(absl::string_view key, const Entry& entry) const;
+
+  const std::string& cache_dir() const { return cache_dir_; }
+
+ private:
+  // Returns the path prefix of the files backing `key`.
+  std::string GetPathPrefix(absl::string_view key) const;
+
+  std::string cache_dir_;
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_PERSISTENT_KERNEL_CACHE_H_
@@ -0,0 +1,101 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "xla/service/gpu/persistent_kernel_cache.h"
+
+#include <optional>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "xla/stream_executor/device_description.h"
+#include "xla/xla.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr char kIr[] = R"(; ModuleID = 'module_a'
+source_filename = "module_a"
+
+define void @fusion(ptr %arg0) {
+  ret void
+}
+)";
+
+constexpr char kIrWithOtherModuleName[] = R"(; ModuleID = 'module_b'
+source_filename = "module_b"
+
+define void @fusion(ptr %arg0) {
+  ret void
+}
+)";
+
+TEST(PersistentKernelCacheTest, KeyIgnoresModuleName) {
+  se::CudaComputeCapability cc(8, 0);
+  DebugOptions options;
+  EXPECT_EQ(PersistentKernelCache::GetKey(kIr, cc, false, options),
+            PersistentKernelCache::GetKey(kIrWithOtherModuleName, cc, false,
+                                          options));
+}
+
+TEST(PersistentKernelCacheTest, KeyDependsOnTargetAndFlags) {
+  se::CudaComputeCapability cc(8, 0);
+  DebugOptions options;
+  std::string key = PersistentKernelCache::GetKey(kIr, cc, false, options);
+
+  EXPECT_NE(key, PersistentKernelCache::GetKey(
+                     kIr, se::CudaComputeCapability(9, 0), false, options));
+  EXPECT_NE(key, PersistentKernelCache::GetKey(kIr, cc, true, options));
+
+  DebugOptions ftz_options = options;
+  ftz_options.set_xla_gpu_ftz(!options.xla_gpu_ftz());
+  EXPECT_NE(key, PersistentKernelCache::GetKey(kIr, cc, false, ftz_options));
+
+  // Flags that don't influence code generation don't change the key.
+  DebugOptions dump_options = options;
+  dump_options.set_xla_dump_to("/tmp/dump");
+  EXPECT_EQ(key, PersistentKernelCache::GetKey(kIr, cc, false, dump_options));
+}
+
+TEST(PersistentKernelCacheTest, LookupMissThenHit) {
+  PersistentKernelCache cache(
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "persistent_kernel_cache"));
+  std::string key = PersistentKernelCache::GetKey(
+      kIr, se::CudaComputeCapability(8, 0), false, DebugOptions());
+
+  TF_ASSERT_OK_AND_ASSIGN(std::optional<PersistentKernelCache::Entry> miss,
+                          cache.Lookup(key));
+  EXPECT_FALSE(miss.has_value());
+
+  TF_ASSERT_OK(cache.Insert(key, {"ptx", {1, 2, 3}}));
+
+  // A separate instance models a restarted process sharing the directory.
+  PersistentKernelCache other_cache(cache.cache_dir());
+  TF_ASSERT_OK_AND_ASSIGN(std::optional<PersistentKernelCache::Entry> hit,
+                          other_cache.Lookup(key));
+  ASSERT_TRUE(hit.has_value());
+  EXPECT_EQ(hit->ptx, "ptx");
+  EXPECT_THAT(hit->cubin, ElementsAre(1, 2, 3));
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
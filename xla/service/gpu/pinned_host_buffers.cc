@@ -0,0 +1,48 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/pinned_host_buffers.h"
+
+#include "absl/synchronization/mutex.h"
+#include "xla/util.h"
+
+namespace xla {
+namespace gpu {
+
+PinnedHostBuffers::~PinnedHostBuffers() {
+  absl::MutexLock lock(&mutex_);
+  for (auto& [stream, buffer] : buffers_) {
+    buffer.executor->HostMemoryDeallocate(buffer.data);
+  }
+}
+
+StatusOr<void*> PinnedHostBuffers::Get(se::Stream* stream) {
+  absl::MutexLock lock(&mutex_);
+  auto it = buffers_.find(stream);
+  if (it != buffers_.end()) {
+    return it->second.data;
+  }
+  se::StreamExecutor* executor = stream->parent();
+  void* data = executor->HostMemoryAllocate(size_);
+  if (data == nullptr) {
+    return ResourceExhausted("Failed to allocate %d bytes of pinned host memory",
+                             size_);
+  }
+  buffers_.emplace(stream, Buffer{executor, data});
+  return data;
+}
+
+}  // namespace gpu
+}  // namespace xla
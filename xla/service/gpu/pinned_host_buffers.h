@@ -0,0 +1,62 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_PINNED_HOST_BUFFERS_H_
+#define XLA_SERVICE_GPU_PINNED_HOST_BUFFERS_H_
+
+#include <cstdint>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "xla/statusor.h"
+#include "xla/stream_executor/stream_executor.h"
+
+namespace xla {
+namespace gpu {
+
+// Small buffers of pinned host memory, one per stream, that thunks copy
+// device values to before reading them on the host (e.g. loop predicates).
+// Copies to pinned memory are plain DMAs, while copies to pageable memory are
+// staged through a driver buffer and add latency to every host round trip.
+//
+// Buffers are allocated on first use by a stream and released with this
+// object, so concurrent executions on different streams don't share them.
+class PinnedHostBuffers {
+ public:
+  explicit PinnedHostBuffers(int64_t size) : size_(size) {}
+  ~PinnedHostBuffers();
+
+  PinnedHostBuffers(const PinnedHostBuffers&) = delete;
+  PinnedHostBuffers& operator=(const PinnedHostBuffers&) = delete;
+
+  // Returns the buffer of `stream`, allocating it if needed.
+  StatusOr<void*> Get(se::Stream* stream);
+
+ private:
+  struct Buffer {
+    se::StreamExecutor* executor;
+    void* data;
+  };
+
+  const int64_t size_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<se::Stream*, Buffer> buffers_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_PINNED_HOST_BUFFERS_H_
@@ -42,8 +42,11 @@ limitations under the License.
 #include "xla/service/gpu/gpu_fusible.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/gpu/model/gpu_performance_model.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/service/hlo_cost_analysis_cache.h"
 #include "xla/service/instruction_fusion.h"
 #include "xla/shape.h"
+#include "xla/statusor.h"
 #include "xla/stream_executor/device_description.h"
 #include "xla/xla_data.pb.h"
 #include "tsl/platform/logging.h"
@@ -75,13 +78,25 @@ class GpuPriorityFusionQueue : public FusionQueue {
       HloComputation* computation,
       const GpuHloCostAnalysis::Options& cost_analysis_options,
       const se::DeviceDescription* device_info, const CanFuseCallback& can_fuse,
-      FusionProcessDumpProto* fusion_process_dump)
+      FusionProcessDumpProto* fusion_process_dump,
+      HloCostAnalysisCache* cost_analysis_cache)
       : computation_(computation),
-        cost_analysis_(cost_analysis_options, device_info),
         can_fuse_(can_fuse),
         fusion_process_dump_(fusion_process_dump) {
-    VLOG(2) << "Running full HLO cost analysis for " << computation_->name();
-    TF_CHECK_OK(computation_->Accept(&cost_analysis_));
+    if (cost_analysis_cache != nullptr) {
+      VLOG(2) << "Updating cached HLO cost analysis for "
+              << computation_->name();
+      StatusOr<HloCostAnalysis*> cached =
+          cost_analysis_cache->GetAnalysis(computation_);
+      TF_CHECK_OK(cached.status());
+      cost_analysis_ = static_cast<GpuHloCostAnalysis*>(*cached);
+    } else {
+      VLOG(2) << "Running full HLO cost analysis for " << computation_->name();
+      owned_cost_analysis_ = std::make_unique<GpuHloCostAnalysis>(
+          cost_analysis_options, device_info);
+      TF_CHECK_OK(computation_->Accept(owned_cost_analysis_.get()));
+      cost_analysis_ = owned_cost_analysis_.get();
+    }
 
     // Initializes the priority queue.
     for (auto instruction : computation->MakeInstructionPostOrder()) {
@@ -164,6 +179,16 @@ class GpuPriorityFusionQueue : public FusionQueue {
       original_producer->DetachFromOperandsAndUsers();
     }
 
+    // The fusion decisions of the fusion and of its operands may have changed:
+    // the fusion has a new body, and the operands have a new set of users (the
+    // fusion replaced the original consumer, and the original producer may be
+    // gone). All other cached decisions are still valid.
+    InvalidateCanFuseCache(fusion);
+    InvalidateCanFuseCache(original_producer);
+    for (HloInstruction* operand : fusion->operands()) {
+      InvalidateCanFuseCache(operand);
+    }
+
     // Collect the instructions whose priorities need to be updated.
     for (HloInstruction* operand : fusion->operands()) {
       if (operand == original_producer ||
@@ -189,7 +214,7 @@ class GpuPriorityFusionQueue : public FusionQueue {
       // Revisit costs of all updated ops. It's important to update cost
       // analysis before recalculating priorities.
       for (auto instruction : to_update_priority_) {
-        TF_CHECK_OK(cost_analysis_.RevisitInstruction(instruction));
+        TF_CHECK_OK(cost_analysis_->RevisitInstruction(instruction));
       }
 
       for (auto instruction : to_update_priority_) {
@@ -220,6 +245,7 @@ class GpuPriorityFusionQueue : public FusionQueue {
   void RemoveInstruction(HloInstruction* instruction) override {
     to_update_priority_.erase(instruction);
     producer_user_count_.erase(instruction);
+    InvalidateCanFuseCache(instruction);
 
     auto reverse_it = reverse_map_.find(instruction);
     if (reverse_it == reverse_map_.end()) {
@@ -242,16 +268,15 @@ class GpuPriorityFusionQueue : public FusionQueue {
     }
 
     GpuPerformanceModel::RunTimes run_times =
-        GpuPerformanceModel::EstimateRunTimes(producer, &cost_analysis_,
+        GpuPerformanceModel::EstimateRunTimes(producer, cost_analysis_,
                                               producer->users());
     return absl::ToInt64Nanoseconds(run_times.time_unfused -
                                     run_times.time_fused);
   }
 
-  FusionDecision CanFuseWithAllUsers(HloInstruction* producer) const {
-    FusionDecision result;
+  FusionDecision CanFuseWithAllUsers(HloInstruction* producer) {
     for (const auto& user : producer->users()) {
-      if (auto fusion_decision = can_fuse_(user, user->operand_index(producer));
+      if (auto fusion_decision = CanFuseCached(producer, user);
           !fusion_decision) {
         VLOG(10) << "Cannot fuse " << producer->name() << " with "
                  << user->name() << ", because: " << fusion_decision.Explain();
@@ -261,11 +286,33 @@ class GpuPriorityFusionQueue : public FusionQueue {
     return {};
   }
 
+  // Returns the result of `can_fuse_` for the pair, reusing the decision made
+  // for a previous priority computation when neither side changed since.
+  FusionDecision CanFuseCached(HloInstruction* producer,
+                               HloInstruction* consumer) {
+    auto& consumer_decisions = can_fuse_cache_[producer];
+    if (auto it = consumer_decisions.find(consumer);
+        it != consumer_decisions.end()) {
+      return it->second;
+    }
+    FusionDecision decision =
+        can_fuse_(consumer, consumer->operand_index(producer));
+    consumer_decisions.emplace(consumer, decision);
+    return decision;
+  }
+
+  // Drops the cached fusion decisions of `producer` with all its consumers.
+  void InvalidateCanFuseCache(HloInstruction* producer) {
+    can_fuse_cache_.erase(producer);
+  }
+
   // Store computation for cost analysis.
   HloComputation* computation_;
 
-  // Reference to cost model that defines priorities in the queue.
-  GpuHloCostAnalysis cost_analysis_;
+  // Reference to cost model that defines priorities in the queue, either owned
+  // by the queue or by the cost analysis cache of the pass.
+  GpuHloCostAnalysis* cost_analysis_;
+  std::unique_ptr<GpuHloCostAnalysis> owned_cost_analysis_;
 
   // The priority queue of producers, implemented as an ordered map, where a
   // key is a pair: the first element is the priority and the second element is
@@ -287,6 +334,14 @@ class GpuPriorityFusionQueue : public FusionQueue {
   // and the producer is given as the consumer's operand index.
   CanFuseCallback can_fuse_;
 
+  // Fusion decisions computed by `can_fuse_`, keyed by producer and then by
+  // consumer. Only entries of instructions affected by a fusion are dropped, so
+  // recomputing the priorities of a fusion's neighbors doesn't rerun the
+  // fusibility checks of their unchanged producer-consumer pairs.
+  absl::flat_hash_map<HloInstruction*,
+                      absl::flat_hash_map<HloInstruction*, FusionDecision>>
+      can_fuse_cache_;
+
   // The user counts of producers, used to determine whether we update their
   // priorities when fusion happens.
   absl::flat_hash_map<HloInstruction*, int64_t> producer_user_count_;
@@ -437,7 +492,7 @@ std::unique_ptr<FusionQueue> GpuPriorityFusion::GetFusionQueue(
       [this](HloInstruction* consumer, int64_t operand_index) {
         return ShouldFuse(consumer, operand_index);
       },
-      fusion_process_dump_.get()));
+      fusion_process_dump_.get(), cost_analysis_cache_.get()));
 }
 
 }  // namespace gpu
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <memory>
 #include <optional>
+#include <utility>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
@@ -31,6 +32,7 @@ limitations under the License.
 #include "xla/service/gpu/fusion_process_dump.pb.h"
 #include "xla/service/gpu/model/gpu_hlo_cost_analysis.h"
 #include "xla/service/hlo_cost_analysis.h"
+#include "xla/service/hlo_cost_analysis_cache.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/service/instruction_fusion.h"
 #include "xla/statusor.h"
@@ -42,10 +44,12 @@ class GpuPriorityFusion : public InstructionFusion {
  public:
   explicit GpuPriorityFusion(
       const se::DeviceDescription& d,
-      const GpuHloCostAnalysis::Options& cost_analysis_options)
+      const GpuHloCostAnalysis::Options& cost_analysis_options,
+      std::shared_ptr<HloCostAnalysisCache> cost_analysis_cache = nullptr)
       : InstructionFusion(GpuPriorityFusion::IsExpensive),
         device_info_(d),
-        cost_analysis_options_(cost_analysis_options) {}
+        cost_analysis_options_(cost_analysis_options),
+        cost_analysis_cache_(std::move(cost_analysis_cache)) {}
 
   absl::string_view name() const override { return "priority-fusion"; }
 
@@ -74,6 +78,10 @@ class GpuPriorityFusion : public InstructionFusion {
   // Cost model options that defines priorities in the queue.
   GpuHloCostAnalysis::Options cost_analysis_options_;
 
+  // If set, cost analyses are taken from the cache, which must create them as
+  // GpuHloCostAnalysis with `cost_analysis_options_`.
+  std::shared_ptr<HloCostAnalysisCache> cost_analysis_cache_;
+
   // Proto with structured logs of fusion decisions. Used only for debugging. If
   // null, logging is disabled.
   std::unique_ptr<FusionProcessDumpProto> fusion_process_dump_;
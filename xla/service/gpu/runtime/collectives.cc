@@ -305,10 +305,29 @@ absl::Status CollectivePermuteImpl(
         if (gpu_opts && gpu_opts->enable_mock_nccl_collectives()) {
           return NcclMockImplCommon(stream);
         }
+        auto run_collective_permute =
+            [&](NcclP2PConfig::SourceTargetMapEntry source_target,
+                DeviceBufferPair& buffer, se::Stream& stream, ncclComm_t comm,
+                absl::string_view device_string,
+                int64_t current_id) -> absl::Status {
+          if (debug_options->xla_gpu_enable_copy_engine_collective_permute()) {
+            NcclExecuteParams params(*run_options, stream.parent());
+            TF_ASSIGN_OR_RETURN(
+                bool copied,
+                RunCopyEngineCollectivePermute(
+                    collectives->copy_engine_collective_permute_events(),
+                    params, op_id,
+                    static_cast<CollectiveOpGroupMode>(group_mode),
+                    source_target, buffer, stream, current_id));
+            if (copied) return absl::OkStatus();
+          }
+          return RunCollectivePermute(source_target, buffer, stream, comm,
+                                      device_string, current_id);
+        };
         return P2PImplCommon(run_options, debug_options, stream, args,
                              group_mode, op_id, replica_group_offsets,
                              replica_group_values, source_peers, target_peers,
-                             RunCollectivePermute, GetDeviceBufferPairs,
+                             run_collective_permute, GetDeviceBufferPairs,
                              GetStreamId(is_async));
       });
 #else   // XLA_ENABLE_XCCL
@@ -337,6 +356,26 @@ XLA_RUNTIME_DEFINE_CUSTOM_CALL(
 // Send.
 //===----------------------------------------------------------------------===//
 
+#if XLA_ENABLE_XCCL
+using NcclP2PChunkedRunnerFn = absl::Status (*)(
+    NcclP2PConfig::SourceTargetMapEntry source_target, DeviceBufferPair& buffer,
+    se::Stream& stream, ncclComm_t comm, absl::string_view device_string,
+    int64_t current_id, int64_t chunk_size_bytes);
+
+// Binds the point-to-point chunk size of the debug options to `runner`.
+static auto P2PChunkedRunner(NcclP2PChunkedRunnerFn runner,
+                             const DebugOptions& debug_options) {
+  return [runner,
+          chunk_size_bytes = debug_options.xla_gpu_p2p_chunk_size_bytes()](
+             NcclP2PConfig::SourceTargetMapEntry source_target,
+             DeviceBufferPair& buffer, se::Stream& stream, ncclComm_t comm,
+             absl::string_view device_string, int64_t current_id) {
+    return runner(source_target, buffer, stream, comm, device_string,
+                  current_id, chunk_size_bytes);
+  };
+}
+#endif  // XLA_ENABLE_XCCL
+
 static absl::Status P2PSendImpl(const ServiceExecutableRunOptions* run_options,
                                 const DebugOptions* debug_options,
                                 CollectivesSupport* collectives,
@@ -357,7 +396,8 @@ static absl::Status P2PSendImpl(const ServiceExecutableRunOptions* run_options,
         return P2PImplCommon(run_options, debug_options, stream, args,
                              group_mode, op_id, replica_group_offsets,
                              replica_group_values, source_peers, target_peers,
-                             RunSend, GetSingleArgAsDeviceBufferPair,
+                             P2PChunkedRunner(RunSend, *debug_options),
+                             GetSingleArgAsDeviceBufferPair,
                              GetStreamId(is_async, kAsyncStreamP2P));
       },
       kAsyncStreamP2P);
@@ -407,7 +447,8 @@ static absl::Status P2PRecvImpl(const ServiceExecutableRunOptions* run_options,
         return P2PImplCommon(run_options, debug_options, stream, args,
                              group_mode, op_id, replica_group_offsets,
                              replica_group_values, source_peers, target_peers,
-                             RunRecv, GetSingleArgAsDeviceBufferPair,
+                             P2PChunkedRunner(RunRecv, *debug_options),
+                             GetSingleArgAsDeviceBufferPair,
                              GetStreamId(is_async, kAsyncStreamP2P));
       },
       kAsyncStreamP2P);
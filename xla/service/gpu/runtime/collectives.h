@@ -21,6 +21,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "xla/runtime/custom_call_registry.h"
+#include "xla/service/gpu/nccl_collective_permute_thunk.h"
 #include "xla/service/gpu/nccl_collective_thunk.h"
 #include "xla/stream_executor/event.h"
 
@@ -44,9 +45,16 @@ class CollectivesSupport {
   absl::Status MaybeBlockAfterFirstRun(int32_t uid, int32_t device_ordinal,
                                        se::Stream* stream);
 
+  CopyEngineCollectivePermuteEvents& copy_engine_collective_permute_events() {
+    return copy_engine_collective_permute_events_;
+  }
+
  private:
   absl::Mutex mutex_;
 
+  // Events of the collective permutes running with copy engines.
+  CopyEngineCollectivePermuteEvents copy_engine_collective_permute_events_;
+
   // Store if a particular collective operation was executed at least once. We
   // rely on unique `uid` assigned to each collective operation by the lowering
   // pass.
@@ -447,8 +447,13 @@ static absl::Status DoConv(
 #endif
   }
 
+  // Share the runner (and its cuDNN plan) with the identical convolutions,
+  // unless the algorithm was picked at run time for this one.
   RunConvOptions opts;
-  opts.runner_cache = &conv->runner;
+  opts.runner_cache =
+      runtime_autotuning
+          ? &conv->runner
+          : &GetSharedConvRunner(conv->config, run_options->stream()->parent());
 
   if (scratch_buffer_size > scratch_buffer.size()) {
     // Need to reallocate scratch buffer.
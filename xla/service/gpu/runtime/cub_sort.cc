@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/gpu/runtime/cub_sort.h"
 
+#include <cstdint>
 #include <optional>
 
 #include "absl/status/status.h"
@@ -40,12 +41,13 @@ using ::xla::runtime::FlatMemrefView;
 
 absl::Status CubDeviceRadixSortKeysImpl(
     const ServiceExecutableRunOptions* run_options, FlatMemrefView input_view,
-    FlatMemrefView output_view, FlatMemrefView scratch_view, bool descending) {
+    FlatMemrefView output_view, FlatMemrefView scratch_view, bool descending,
+    int64_t batch_size) {
 #ifdef GOOGLE_CUDA
   return RunCubSort(input_view.dtype, std::nullopt,
                     GetDeviceAddress(input_view), DeviceMemoryBase(),
                     GetDeviceAddress(output_view), DeviceMemoryBase(),
-                    GetDeviceAddress(scratch_view), descending);
+                    GetDeviceAddress(scratch_view), descending, batch_size);
 #else
   return absl::UnimplementedError("CUB is not available");
 #endif
@@ -55,13 +57,13 @@ absl::Status CubDeviceRadixSortPairsImpl(
     const ServiceExecutableRunOptions* run_options,
     FlatMemrefView input_keys_view, FlatMemrefView input_values_view,
     FlatMemrefView output_keys_view, FlatMemrefView output_values_view,
-    FlatMemrefView scratch_view, bool descending) {
+    FlatMemrefView scratch_view, bool descending, int64_t batch_size) {
 #ifdef GOOGLE_CUDA
   return RunCubSort(
       input_keys_view.dtype, input_values_view.dtype,
       GetDeviceAddress(input_keys_view), GetDeviceAddress(input_values_view),
       GetDeviceAddress(output_keys_view), GetDeviceAddress(output_values_view),
-      GetDeviceAddress(scratch_view), descending);
+      GetDeviceAddress(scratch_view), descending, batch_size);
 #else
   return absl::UnimplementedError("CUB is not available");
 #endif
@@ -77,7 +79,8 @@ XLA_RUNTIME_DEFINE_CUSTOM_CALL(
         .Arg<FlatMemrefView>()  // input
         .Arg<FlatMemrefView>()  // output
         .Arg<FlatMemrefView>()  // scratch
-        .Attr<bool>("descending"));
+        .Attr<bool>("descending")
+        .Attr<int64_t>("batch_size"));
 
 XLA_RUNTIME_DEFINE_CUSTOM_CALL(
     CubDeviceRadixSortPairs, FunctionWrapper<CubDeviceRadixSortPairsImpl>(),
@@ -89,7 +92,8 @@ XLA_RUNTIME_DEFINE_CUSTOM_CALL(
         .Arg<FlatMemrefView>()  // output_keys
         .Arg<FlatMemrefView>()  // output_values
         .Arg<FlatMemrefView>()  // scratch
-        .Attr<bool>("descending"));
+        .Attr<bool>("descending")
+        .Attr<int64_t>("batch_size"));
 
 void RegisterCubSortCustomCalls(runtime::DirectCustomCallRegistry& registry) {
   registry.Register("xla.gpu.radix_sort_keys", CubDeviceRadixSortKeys);
@@ -18,6 +18,7 @@ limitations under the License.
 #include <memory>
 #include <string_view>
 
+#include "absl/cleanup/cleanup.h"
 #include "xla/runtime/custom_call.h"
 #include "xla/runtime/executable.h"
 #include "xla/service/gpu/infeed_manager.h"
@@ -36,8 +37,16 @@ static absl::Status InfeedImpl(const ServiceExecutableRunOptions* run_options,
   VLOG(3) << "Infeeding to GPU";
 
   se::Stream* stream = run_options->stream();
-  ShapeTree<se::ScopedDeviceMemory<uint8_t>> source_buffers =
-      GetOrCreateInfeedManager(stream->parent())->BlockingGetNextDestination();
+  InfeedManager* infeed_manager = GetOrCreateInfeedManager(stream->parent());
+  InfeedBuffers infeed = infeed_manager->BlockingGetNextDestination();
+  const ShapeTree<se::DeviceMemoryBase>& source_buffers = infeed.buffers;
+
+  // Give the slot of the literal back on every exit path, once the copies
+  // enqueued so far complete.
+  absl::Cleanup release_slot = [&] {
+    infeed_manager->ThenReleaseSlot(stream, infeed.slot);
+  };
+  stream->ThenWaitFor(infeed.ready);
 
   // Check that we have correct number of arguments.
   if (args.size() != source_buffers.leaf_count())
@@ -62,15 +71,12 @@ static absl::Status InfeedImpl(const ServiceExecutableRunOptions* run_options,
     }
 
     se::DeviceMemoryBase dest_address = GetDeviceAddress(*dest);
-    se::ScopedDeviceMemory<uint8_t>& buffer = source.second;
-    stream->ThenMemcpy(&dest_address, *buffer.ptr(), buffer.ptr()->size());
+    const se::DeviceMemoryBase& buffer = source.second;
+    stream->ThenMemcpy(&dest_address, buffer, buffer.size());
 
     ++index;
   }
 
-  // TODO(ezhulenev): Make this function async?
-  TF_RETURN_IF_ERROR(stream->BlockHostUntilDone());
-
   VLOG(3) << "Infeeding to GPU complete";
 
   return absl::OkStatus();
@@ -38,8 +38,9 @@ using ::stream_executor::gpu::GpuStreamHandle;
 
 size_t NumThreads(size_t n, size_t k, size_t batch_size) {
   // Estimate number of threads per block that can run concurrently given the
-  // register footprint.
-  size_t simultaneous_threads_per_block = 512 * (16 / k);
+  // register footprint. The footprint grows with the size of the per-thread
+  // topk, which is rounded up to a power of two.
+  size_t simultaneous_threads_per_block = 512 * 16 / absl::bit_ceil(k);
   size_t threads_per_block =
       std::min(simultaneous_threads_per_block, kTopKMaxThreadsPerBlock);
   // Minimum amount of data that each thread needs to receive for the algorithm.
@@ -86,6 +87,7 @@ absl::StatusOr<void*> GetKernel(int n, int k) {
   if (k <= 4) return GetTopKKernelForK<T, 4>(n);
   if (k <= 8) return GetTopKKernelForK<T, 8>(n);
   if (k <= 16) return GetTopKKernelForK<T, 16>(n);
+  if (k <= 32) return GetTopKKernelForK<T, 32>(n);
   return absl::UnimplementedError(absl::StrCat("Unsupported K: ", k));
 }
 
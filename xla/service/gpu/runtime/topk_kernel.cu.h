@@ -77,7 +77,7 @@ __device__ __forceinline__ int Idx(int i) {
   return blockDim.x * i + threadIdx.x;
 }
 
-// TopK implements a faster TopK for K < 16.
+// TopK implements a faster TopK for K <= 32.
 //
 // To compute the final largest K elements, we shard the data threads and each
 // of them computes the top k elements for the data in its slice. When all lanes
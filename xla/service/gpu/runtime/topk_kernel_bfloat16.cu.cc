@@ -23,5 +23,6 @@ template void* GetTopKKernelForK<Eigen::bfloat16, 2>(int n);
 template void* GetTopKKernelForK<Eigen::bfloat16, 4>(int n);
 template void* GetTopKKernelForK<Eigen::bfloat16, 8>(int n);
 template void* GetTopKKernelForK<Eigen::bfloat16, 16>(int n);
+template void* GetTopKKernelForK<Eigen::bfloat16, 32>(int n);
 
 }  // namespace xla::gpu
@@ -22,5 +22,6 @@ template void* GetTopKKernelForK<float, 2>(int n);
 template void* GetTopKKernelForK<float, 4>(int n);
 template void* GetTopKKernelForK<float, 8>(int n);
 template void* GetTopKKernelForK<float, 16>(int n);
+template void* GetTopKKernelForK<float, 32>(int n);
 
 }  // namespace xla::gpu
@@ -152,7 +152,7 @@ TEST_P(TopkTest, TopKPackedNegative) {
 INSTANTIATE_TEST_SUITE_P(TopkTests, TopkTest,
                          Combine(
                              /*n_kb=*/Values(1, 8, 12, 64, 128),
-                             /*k=*/Values(1, 2, 8, 16, 7, 12),
+                             /*k=*/Values(1, 2, 8, 16, 7, 12, 32),
                              /*batch_size=*/Values(1, 16, 64, 128),
                              /*offset=*/Values(0, 7, 4)),
                          [](const auto& info) {
@@ -151,7 +151,7 @@ INSTANTIATE_TEST_SUITE_P(
     TopkTests, TopkTest,
     Combine(
         /*n_kb=*/Values(1, 8, 12, 32),
-        /*k=*/Values(1, 2, 4, 8, 16, 7, 12),
+        /*k=*/Values(1, 2, 4, 8, 16, 7, 12, 32),
         /*batch_size=*/Values(1, 16, 64, 128),
         /*dtype=*/Values(absl::string_view("f32"), "bf16")),
     [](const auto& info) {
@@ -26,12 +26,14 @@ limitations under the License.
 #include "absl/types/span.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/gpu/launch_dimensions.h"
+#include "xla/service/gpu/matmul_utils.h"
 #include "xla/service/gpu/stream_executor_util.h"
 #include "xla/status.h"
 #include "xla/stream_executor/command_buffer.h"
 #include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/kernel.h"
 #include "xla/stream_executor/launch_dim.h"
+#include "xla/stream_executor/stream.h"
 #include "xla/types.h"  // IWYU pragma: keep
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
@@ -43,6 +45,9 @@ namespace xla::gpu {
 //===----------------------------------------------------------------------===//
 
 void CommandBufferCmdSequence::Append(std::unique_ptr<CommandBufferCmd> cmd) {
+  for (const BufferAllocation::Slice& slice : cmd->buffers()) {
+    allocs_indices_.insert(slice.index());
+  }
   commands_.push_back(std::move(cmd));
 }
 
@@ -134,6 +139,10 @@ Status LaunchCmd::Record(const RecordParams& params,
       *kernel_args);
 }
 
+CommandBufferCmd::BufferUsageVector LaunchCmd::buffers() {
+  return BufferUsageVector(args_.begin(), args_.end());
+}
+
 //===----------------------------------------------------------------------===//
 // MemcpyDeviceToDeviceCmd
 //===----------------------------------------------------------------------===//
@@ -152,4 +161,100 @@ Status MemcpyDeviceToDeviceCmd::Record(const RecordParams& params,
   return command_buffer->MemcpyDeviceToDevice(&dst, src, num_bytes_);
 }
 
+CommandBufferCmd::BufferUsageVector MemcpyDeviceToDeviceCmd::buffers() {
+  return {dst_, src_};
+}
+
+//===----------------------------------------------------------------------===//
+// MemzeroCmd
+//===----------------------------------------------------------------------===//
+
+MemzeroCmd::MemzeroCmd(BufferAllocation::Slice dst) : dst_(dst) {}
+
+Status MemzeroCmd::Record(const RecordParams& params,
+                          se::CommandBuffer* command_buffer) {
+  se::DeviceMemoryBase dst = params.buffer_allocations->GetDeviceAddress(dst_);
+  VLOG(5) << "MemzeroCmd: dst=" << dst_ << " (" << dst.opaque() << ")";
+  return command_buffer->Memset(&dst, uint8_t{0}, /*num_elements=*/dst_.size());
+}
+
+CommandBufferCmd::BufferUsageVector MemzeroCmd::buffers() { return {dst_}; }
+
+//===----------------------------------------------------------------------===//
+// Memset32Cmd
+//===----------------------------------------------------------------------===//
+
+Memset32Cmd::Memset32Cmd(BufferAllocation::Slice dst, uint32_t bit_pattern)
+    : dst_(dst), bit_pattern_(bit_pattern) {}
+
+Status Memset32Cmd::Record(const RecordParams& params,
+                           se::CommandBuffer* command_buffer) {
+  se::DeviceMemoryBase dst = params.buffer_allocations->GetDeviceAddress(dst_);
+  VLOG(5) << "Memset32Cmd: dst=" << dst_ << " (" << dst.opaque()
+          << "), bit_pattern=" << bit_pattern_;
+  if (dst_.size() % sizeof(uint32_t) != 0) {
+    return absl::InternalError(
+        "Memset32Cmd destination size must be a multiple of 4 bytes");
+  }
+  return command_buffer->Memset(
+      &dst, bit_pattern_, /*num_elements=*/dst_.size() / sizeof(uint32_t));
+}
+
+CommandBufferCmd::BufferUsageVector Memset32Cmd::buffers() { return {dst_}; }
+
+//===----------------------------------------------------------------------===//
+// GemmCmd
+//===----------------------------------------------------------------------===//
+
+GemmCmd::GemmCmd(GemmConfig config, const BufferAllocation::Slice& lhs_buffer,
+                 const BufferAllocation::Slice& rhs_buffer,
+                 const BufferAllocation::Slice& output_buffer,
+                 bool deterministic)
+    : config_(std::move(config)),
+      lhs_buffer_(lhs_buffer),
+      rhs_buffer_(rhs_buffer),
+      output_buffer_(output_buffer),
+      deterministic_(deterministic) {}
+
+Status GemmCmd::Initialize(se::StreamExecutor* executor,
+                           ExecutableSource source) {
+  if (!executor->AsBlas()) {
+    return absl::InternalError("Failed to initialize BLAS support for GemmCmd");
+  }
+  return OkStatus();
+}
+
+Status GemmCmd::Record(const RecordParams& params,
+                       se::CommandBuffer* command_buffer) {
+  se::DeviceMemoryBase lhs =
+      params.buffer_allocations->GetDeviceAddress(lhs_buffer_);
+  se::DeviceMemoryBase rhs =
+      params.buffer_allocations->GetDeviceAddress(rhs_buffer_);
+  se::DeviceMemoryBase out =
+      params.buffer_allocations->GetDeviceAddress(output_buffer_);
+
+  VLOG(5) << "GemmCmd: lhs=" << lhs_buffer_ << " (" << lhs.opaque()
+          << "), rhs=" << rhs_buffer_ << " (" << rhs.opaque()
+          << "), out=" << output_buffer_ << " (" << out.opaque()
+          << "), deterministic=" << deterministic_;
+
+  // Trace gemm into a nested command buffer. On update the traced graph has
+  // the same topology as the recorded one, so the parent command buffer can
+  // patch its child node in place.
+  TF_ASSIGN_OR_RETURN(
+      se::CommandBuffer nested,
+      se::CommandBuffer::Trace(
+          command_buffer->executor(),
+          [&](se::Stream* stream) {
+            return RunGemm(config_, lhs, rhs, out, deterministic_, stream);
+          },
+          se::CommandBuffer::Mode::kNested));
+
+  return command_buffer->AddNestedCommandBuffer(nested);
+}
+
+CommandBufferCmd::BufferUsageVector GemmCmd::buffers() {
+  return {lhs_buffer_, rhs_buffer_, output_buffer_};
+}
+
 }  // namespace xla::gpu
@@ -22,10 +22,13 @@ limitations under the License.
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/types/span.h"
 #include "xla/service/buffer_assignment.h"
 #include "xla/service/gpu/buffer_allocations.h"
 #include "xla/service/gpu/launch_dimensions.h"
+#include "xla/service/gpu/matmul_utils.h"
 #include "xla/service/gpu/thunk.h"
 #include "xla/status.h"
 #include "xla/stream_executor/command_buffer.h"
@@ -44,6 +47,7 @@ namespace xla::gpu {
 class CommandBufferCmd {
  public:
   using ExecutableSource = Thunk::ExecutableSource;
+  using BufferUsageVector = absl::InlinedVector<BufferAllocation::Slice, 4>;
 
   // Run time parameters required for recording commands into the command
   // buffer. For example when we emit command buffer cmd sequence from an HLO
@@ -65,6 +69,10 @@ class CommandBufferCmd {
   virtual Status Record(const RecordParams& params,
                         se::CommandBuffer* command_buffer) = 0;
 
+  // Returns all buffers used by the cmd. These will be used to track cmd
+  // updates, thus they need to be consistent across calls to the function.
+  virtual BufferUsageVector buffers() = 0;
+
   virtual ~CommandBufferCmd() = default;
 };
 
@@ -94,8 +102,16 @@ class CommandBufferCmdSequence {
   Status Record(const CommandBufferCmd::RecordParams& params,
                 se::CommandBuffer* command_buffer);
 
+  // Returns buffer allocations indices referenced by commands in this sequence.
+  const absl::flat_hash_set<BufferAllocation::Index>& allocs_indices() const {
+    return allocs_indices_;
+  }
+
  private:
   std::vector<std::unique_ptr<CommandBufferCmd>> commands_;
+
+  // Buffer allocations indices referenced by commands in this sequence.
+  absl::flat_hash_set<BufferAllocation::Index> allocs_indices_;
 };
 
 //===----------------------------------------------------------------------===//
@@ -114,6 +130,8 @@ class LaunchCmd : public CommandBufferCmd {
   Status Record(const RecordParams& params,
                 se::CommandBuffer* command_buffer) override;
 
+  BufferUsageVector buffers() override;
+
  private:
   using OwnedKernel = std::unique_ptr<se::KernelBase>;
 
@@ -137,12 +155,78 @@ class MemcpyDeviceToDeviceCmd : public CommandBufferCmd {
   Status Record(const RecordParams& params,
                 se::CommandBuffer* command_buffer) override;
 
+  BufferUsageVector buffers() override;
+
  private:
   BufferAllocation::Slice dst_;
   BufferAllocation::Slice src_;
   int64_t num_bytes_;
 };
 
+//===----------------------------------------------------------------------===//
+// MemzeroCmd
+//===----------------------------------------------------------------------===//
+
+class MemzeroCmd : public CommandBufferCmd {
+ public:
+  explicit MemzeroCmd(BufferAllocation::Slice dst);
+
+  Status Record(const RecordParams& params,
+                se::CommandBuffer* command_buffer) override;
+
+  BufferUsageVector buffers() override;
+
+ private:
+  BufferAllocation::Slice dst_;
+};
+
+//===----------------------------------------------------------------------===//
+// Memset32Cmd
+//===----------------------------------------------------------------------===//
+
+class Memset32Cmd : public CommandBufferCmd {
+ public:
+  Memset32Cmd(BufferAllocation::Slice dst, uint32_t bit_pattern);
+
+  Status Record(const RecordParams& params,
+                se::CommandBuffer* command_buffer) override;
+
+  BufferUsageVector buffers() override;
+
+ private:
+  BufferAllocation::Slice dst_;
+  uint32_t bit_pattern_;
+};
+
+//===----------------------------------------------------------------------===//
+// GemmCmd
+//===----------------------------------------------------------------------===//
+
+// Library calls can't be recorded explicitly, so GemmCmd traces a BLAS gemm
+// into a nested command buffer and adds it to the parent command buffer.
+class GemmCmd : public CommandBufferCmd {
+ public:
+  GemmCmd(GemmConfig config, const BufferAllocation::Slice& lhs_buffer,
+          const BufferAllocation::Slice& rhs_buffer,
+          const BufferAllocation::Slice& output_buffer, bool deterministic);
+
+  Status Initialize(se::StreamExecutor* executor,
+                    ExecutableSource source) override;
+
+  Status Record(const RecordParams& params,
+                se::CommandBuffer* command_buffer) override;
+
+  BufferUsageVector buffers() override;
+
+ private:
+  const GemmConfig config_;
+  const BufferAllocation::Slice lhs_buffer_;
+  const BufferAllocation::Slice rhs_buffer_;
+  const BufferAllocation::Slice output_buffer_;
+  // Whether to run deterministically.
+  const bool deterministic_;
+};
+
 }  // namespace xla::gpu
 
 #endif  // XLA_SERVICE_GPU_RUNTIME3_COMMAND_BUFFER_CMD_H_
@@ -15,15 +15,20 @@ limitations under the License.
 
 #include "xla/service/gpu/runtime3/command_buffer_thunk.h"
 
+#include <cstddef>
 #include <memory>
 #include <utility>
 
+#include "absl/log/log.h"
 #include "absl/synchronization/mutex.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/gpu/buffer_allocations.h"
 #include "xla/service/gpu/runtime3/command_buffer_cmd.h"
 #include "xla/service/gpu/thunk.h"
 #include "xla/status.h"
 #include "xla/statusor.h"
 #include "xla/stream_executor/command_buffer.h"
+#include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/stream_executor_pimpl.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/statusor.h"
@@ -33,6 +38,31 @@ namespace xla::gpu {
 CommandBufferThunk::State::State(se::CommandBuffer command_buffer)
     : command_buffer(std::move(command_buffer)) {}
 
+bool CommandBufferThunk::State::ShouldUpdateCommandBuffer(
+    const CommandBufferCmdSequence& commands,
+    const CommandBufferCmd::RecordParams& params) {
+  bool should_update = false;
+  const BufferAllocations* allocs = params.buffer_allocations;
+
+  // We check only allocations referenced by commands in a cmd sequence, and
+  // leave every other entry default initialized (nullptr device memory).
+  for (BufferAllocation::Index index : commands.allocs_indices()) {
+    se::DeviceMemoryBase alloc = allocs->GetDeviceAddress(index);
+
+    if (recorded_allocs.size() <= static_cast<size_t>(index)) {
+      recorded_allocs.resize(index + 1);
+      should_update = true;
+    }
+
+    if (!recorded_allocs[index].IsSameAs(alloc)) {
+      recorded_allocs[index] = alloc;
+      should_update = true;
+    }
+  }
+
+  return should_update;
+}
+
 CommandBufferThunk::CommandBufferThunk(CommandBufferCmdSequence commands,
                                        ThunkInfo thunk_info)
     : Thunk(Thunk::kCommandBuffer, std::move(thunk_info)),
@@ -50,7 +80,18 @@ Status CommandBufferThunk::ExecuteOnStream(const ExecuteParams& params) {
   absl::MutexLock lock(&state->mutex);
 
   CommandBufferCmd::RecordParams record_params = {params.buffer_allocations};
-  TF_RETURN_IF_ERROR(commands_.Record(record_params, &state->command_buffer));
+
+  // Re-record commands only if some of the device addresses changed since the
+  // last execution. Recording into a finalized command buffer updates graph
+  // nodes in place, and doesn't re-instantiate the executable graph.
+  bool should_update =
+      state->ShouldUpdateCommandBuffer(commands_, record_params);
+  if (should_update ||
+      state->command_buffer.state() == se::CommandBuffer::State::kCreate) {
+    VLOG(3) << "Update command buffer on device #" << executor->device_ordinal()
+            << " by recording command buffer cmd sequence";
+    TF_RETURN_IF_ERROR(commands_.Record(record_params, &state->command_buffer));
+  }
 
   return executor->Submit(params.stream, state->command_buffer);
 }
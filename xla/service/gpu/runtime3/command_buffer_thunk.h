@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_SERVICE_GPU_RUNTIME3_COMMAND_BUFFER_THUNK_H_
 
 #include <memory>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
@@ -26,6 +27,7 @@ limitations under the License.
 #include "xla/status.h"
 #include "xla/statusor.h"
 #include "xla/stream_executor/command_buffer.h"
+#include "xla/stream_executor/device_memory.h"
 #include "xla/stream_executor/stream_executor_pimpl.h"
 
 namespace xla::gpu {
@@ -44,8 +46,27 @@ class CommandBufferThunk : public Thunk {
   struct State {
     explicit State(se::CommandBuffer command_buffer);
 
+    // Returns true if `commands` cmd sequence has to be recorded into
+    // `command_buffer` to update it (see `recorded_allocs` below).
+    bool ShouldUpdateCommandBuffer(const CommandBufferCmdSequence& commands,
+                                   const CommandBufferCmd::RecordParams& params)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex);
+
     absl::Mutex mutex;
     se::CommandBuffer command_buffer ABSL_GUARDED_BY(mutex);
+
+    // Mapping from buffer allocation index to the device memory passed at
+    // that index to the last call of `commands_.Record(...)` for
+    // `command_buffer`. We can just use a vector instead of map because
+    // `BufferAllocation::Index` is a unique identifier assigned
+    // contiguously and thus can be used as array index.
+    //
+    // If no device memory addresses changed from a previous call to
+    // `Record`, we can skip command buffer update and simply submit it for
+    // execution on a stream. All other pieces of information (like thread
+    // and block sizes) captured by commands at construction time and do not
+    // change.
+    std::vector<se::DeviceMemoryBase> recorded_allocs ABSL_GUARDED_BY(mutex);
   };
   using OwnedCommandBuffer = std::unique_ptr<State>;
 
@@ -87,6 +87,70 @@ TEST(CommandBufferThunkTest, MemcpyCmd) {
   ASSERT_EQ(dst, std::vector<int32_t>(4, 42));
 }
 
+TEST(CommandBufferThunkTest, MemzeroCmdWithUpdate) {
+  se::StreamExecutor* executor = CudaExecutor();
+
+  se::Stream stream(executor);
+  stream.Init();
+  ASSERT_TRUE(stream.ok());
+
+  int64_t length = 4;
+  int64_t byte_length = sizeof(int32_t) * length;
+
+  // Prepare arguments: a=42
+  se::DeviceMemory<int32_t> a = executor->AllocateArray<int32_t>(length, 0);
+  stream.ThenMemset32(&a, 42, byte_length);
+
+  // Prepare buffer allocations for recording command buffer.
+  BufferAllocation alloc_a(/*index=*/0, byte_length, /*color=*/0);
+  BufferAllocation::Slice slice_a(&alloc_a, 0, byte_length);
+
+  // Prepare commands sequence for constructing command buffer.
+  CommandBufferCmdSequence commands;
+  commands.Emplace<MemzeroCmd>(slice_a);
+
+  // Construct a thunk with command sequence.
+  CommandBufferThunk thunk(std::move(commands), Thunk::ThunkInfo(nullptr));
+
+  ServiceExecutableRunOptions run_options;
+  BufferAllocations allocations({a}, 0, executor->GetAllocator());
+  Thunk::ExecuteParams params(run_options, allocations, &stream, {});
+
+  // Execute command buffer thunk and verify that it zeroed the memory.
+  TF_ASSERT_OK(thunk.ExecuteOnStream(params));
+
+  std::vector<int32_t> dst(4, 1);
+  stream.ThenMemcpy(dst.data(), a, byte_length);
+  ASSERT_EQ(dst, std::vector<int32_t>(4, 0));
+
+  // Executing with the same buffers submits recorded command buffer as is.
+  stream.ThenMemset32(&a, 42, byte_length);
+  TF_ASSERT_OK(thunk.ExecuteOnStream(params));
+
+  std::fill(dst.begin(), dst.end(), 1);
+  stream.ThenMemcpy(dst.data(), a, byte_length);
+  ASSERT_EQ(dst, std::vector<int32_t>(4, 0));
+
+  // Prepare buffer allocation for updating command buffer: b=42
+  se::DeviceMemory<int32_t> b = executor->AllocateArray<int32_t>(length, 0);
+  stream.ThenMemset32(&a, 42, byte_length);
+  stream.ThenMemset32(&b, 42, byte_length);
+
+  // Update buffer allocation #0 to buffer `b`.
+  allocations = BufferAllocations({b}, 0, executor->GetAllocator());
+
+  // Thunk execution should update memset node in place.
+  TF_ASSERT_OK(thunk.ExecuteOnStream(params));
+
+  std::fill(dst.begin(), dst.end(), 1);
+  stream.ThenMemcpy(dst.data(), b, byte_length);
+  ASSERT_EQ(dst, std::vector<int32_t>(4, 0));
+
+  // Buffer `a` is not referenced by the updated command buffer.
+  stream.ThenMemcpy(dst.data(), a, byte_length);
+  ASSERT_EQ(dst, std::vector<int32_t>(4, 42));
+}
+
 TEST(CommandBufferThunkTest, LaunchCmd) {
   se::StreamExecutor* executor = CudaExecutor();
 
@@ -339,31 +339,39 @@ StatusOr<std::unique_ptr<se::KernelBase>> CreateKernel(
   return std::move(kernel_base);
 }
 
-Status ExecuteKernelOnStream(const se::KernelBase& kernel,
-                             absl::Span<const se::DeviceMemoryBase> args,
-                             const LaunchDimensions& dims, se::Stream* stream) {
+std::unique_ptr<se::KernelArgsArrayBase> PackKernelArgs(
+    const se::KernelBase& kernel, absl::Span<const se::DeviceMemoryBase> args) {
   int shared_mem_bytes = 0;
   kernel.metadata().shared_memory_bytes(&shared_mem_bytes);
   static constexpr int kKernelArgsLimit = 1024;
-  std::unique_ptr<se::KernelArgsArrayBase> kernel_args;
   // The KernelArgsArray structure requires at a minimum 48 * args.size()
   // bytes. It can be expensive to allocate, say, 48KiB, so we add
   // specializations for smaller sizes. 64 arguments are likely to fit in a
   // 4KiB page.
   if (args.size() <= 64) {
-    kernel_args = se::MakeKernelArgs<64>(args, shared_mem_bytes);
+    return se::MakeKernelArgs<64>(args, shared_mem_bytes);
   } else if (args.size() <= 256) {
-    kernel_args = se::MakeKernelArgs<256>(args, shared_mem_bytes);
-  } else {
-    kernel_args = se::MakeKernelArgs<kKernelArgsLimit>(args, shared_mem_bytes);
+    return se::MakeKernelArgs<256>(args, shared_mem_bytes);
   }
+  return se::MakeKernelArgs<kKernelArgsLimit>(args, shared_mem_bytes);
+}
+
+Status ExecuteKernelOnStream(const se::KernelBase& kernel,
+                             absl::Span<const se::DeviceMemoryBase> args,
+                             const LaunchDimensions& dims, se::Stream* stream) {
+  return ExecuteKernelOnStream(kernel, *PackKernelArgs(kernel, args), dims,
+                               stream);
+}
 
+Status ExecuteKernelOnStream(const se::KernelBase& kernel,
+                             const se::KernelArgsArrayBase& kernel_args,
+                             const LaunchDimensions& dims, se::Stream* stream) {
   LaunchDimensions::Dim3D thread_counts = dims.thread_counts_per_block();
   LaunchDimensions::Dim3D block_counts = dims.block_counts();
   return stream->parent()->Launch(
       stream, se::ThreadDim(thread_counts.x, thread_counts.y, thread_counts.z),
       se::BlockDim(block_counts.x, block_counts.y, block_counts.z), kernel,
-      *kernel_args);
+      kernel_args);
 }
 
 // Unimplemented for integers yet.
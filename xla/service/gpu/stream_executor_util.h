@@ -85,11 +85,20 @@ StatusOr<std::unique_ptr<se::KernelBase>> CreateKernel(
     absl::Span<const uint8_t> cubin_data, se::StreamExecutor* stream_exec,
     uint32_t shared_mem_bytes = 0);
 
+// Packs the arguments of a launch of `kernel`.
+std::unique_ptr<se::KernelArgsArrayBase> PackKernelArgs(
+    const se::KernelBase& kernel, absl::Span<const se::DeviceMemoryBase> args);
+
 // Runs loaded kernel on the stream with the provided arguments.
 Status ExecuteKernelOnStream(const se::KernelBase& kernel,
                              absl::Span<const se::DeviceMemoryBase> args,
                              const LaunchDimensions& dims, se::Stream* stream);
 
+// Same as above, with arguments packed by PackKernelArgs.
+Status ExecuteKernelOnStream(const se::KernelBase& kernel,
+                             const se::KernelArgsArrayBase& kernel_args,
+                             const LaunchDimensions& dims, se::Stream* stream);
+
 // Initializes `buffer` with random data on `stream`.
 // `rng_state` is an inout parameter for the pseudorandom generator state.
 // `buffer_type` determines what buffer would be filled out with.
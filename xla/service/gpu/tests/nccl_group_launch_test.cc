@@ -0,0 +1,189 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "xla/service/executable.h"
+#include "xla/service/gpu/gpu_executable.h"
+#include "xla/service/gpu/nccl_collective_thunk.h"
+#include "xla/service/gpu/nccl_group_thunk.h"
+#include "xla/service/gpu/tests/gpu_codegen_test.h"
+#include "xla/service/gpu/thunk.h"
+#include "xla/service/hlo_module_config.h"
+#include "xla/xla.pb.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+class NcclGroupLaunchTest : public GpuCodegenTest {
+ protected:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = GpuCodegenTest::GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_enable_nccl_group_launch(true);
+    // Only synchronous collectives are grouped, and thunks are only built
+    // without the XLA runtime.
+    debug_options.set_xla_gpu_enable_async_collectives(false);
+    debug_options.set_xla_gpu_enable_async_all_reduce(false);
+    debug_options.set_xla_gpu_enable_xla_runtime_executable(false);
+    // Keep the all-reduces separate.
+    debug_options.set_xla_gpu_all_reduce_combine_threshold_bytes(0);
+    return debug_options;
+  }
+
+  // Compiles `hlo` for two replicas and returns its thunk kinds. Group thunks
+  // are returned with the kinds of their collectives.
+  StatusOr<std::vector<std::pair<Thunk::Kind, std::vector<Thunk::Kind>>>>
+  GetThunkKinds(absl::string_view hlo) {
+    TF_ASSIGN_OR_RETURN(
+        auto module,
+        ParseAndReturnVerifiedModule(hlo, GetModuleConfigForTest(
+                                              /*replica_count=*/2)));
+    TF_ASSIGN_OR_RETURN(auto optimized_module,
+                        GetOptimizedModule(std::move(module)));
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<Executable> executable,
+        backend().compiler()->RunBackend(
+            std::move(optimized_module), backend().default_stream_executor(),
+            backend().default_stream_executor()->GetAllocator()));
+
+    std::vector<std::pair<Thunk::Kind, std::vector<Thunk::Kind>>> kinds;
+    for (const auto& thunk :
+         static_cast<GpuExecutable*>(executable.get())->GetThunk()) {
+      std::vector<Thunk::Kind> grouped;
+      if (thunk->kind() == Thunk::kNcclGroup) {
+        for (const auto& collective :
+             static_cast<const NcclGroupThunk&>(*thunk).thunks()) {
+          grouped.push_back(collective->kind());
+        }
+      }
+      kinds.emplace_back(thunk->kind(), std::move(grouped));
+    }
+    return kinds;
+  }
+
+  // Returns the number of thunks of `kind` in `kinds`, excluding grouped ones.
+  static int Count(
+      const std::vector<std::pair<Thunk::Kind, std::vector<Thunk::Kind>>>&
+          kinds,
+      Thunk::Kind kind) {
+    int count = 0;
+    for (const auto& [thunk_kind, grouped] : kinds) {
+      count += thunk_kind == kind;
+    }
+    return count;
+  }
+};
+
+TEST_F(NcclGroupLaunchTest, GroupsIndependentAllReduces) {
+  if (!NcclCollectiveThunk::NcclIsEnabled()) {
+    GTEST_SKIP() << "NCCL is not enabled";
+  }
+  constexpr char kHlo[] = R"(
+HloModule m
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY e {
+  p0 = f32[1024] parameter(0)
+  p1 = f32[1024] parameter(1)
+  ar0 = f32[1024] all-reduce(p0), replica_groups={}, to_apply=add
+  ar1 = f32[1024] all-reduce(p1), replica_groups={}, to_apply=add
+  ROOT tuple = (f32[1024], f32[1024]) tuple(ar0, ar1)
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto kinds, GetThunkKinds(kHlo));
+  ASSERT_EQ(Count(kinds, Thunk::kNcclGroup), 1);
+  EXPECT_EQ(Count(kinds, Thunk::kNcclAllReduceStart), 0);
+  for (const auto& [kind, grouped] : kinds) {
+    if (kind == Thunk::kNcclGroup) {
+      EXPECT_EQ(grouped, std::vector<Thunk::Kind>(
+                             2, Thunk::kNcclAllReduceStart));
+    }
+  }
+}
+
+TEST_F(NcclGroupLaunchTest, DoesNotGroupDependentAllReduces) {
+  if (!NcclCollectiveThunk::NcclIsEnabled()) {
+    GTEST_SKIP() << "NCCL is not enabled";
+  }
+  // The second all-reduce reads the result of the first one.
+  constexpr char kHlo[] = R"(
+HloModule m
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY e {
+  p0 = f32[1024] parameter(0)
+  ar0 = f32[1024] all-reduce(p0), replica_groups={}, to_apply=add
+  ROOT ar1 = f32[1024] all-reduce(ar0), replica_groups={}, to_apply=add
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto kinds, GetThunkKinds(kHlo));
+  EXPECT_EQ(Count(kinds, Thunk::kNcclGroup), 0);
+  EXPECT_EQ(Count(kinds, Thunk::kNcclAllReduceStart), 2);
+}
+
+class NcclGroupLaunchDisabledTest : public NcclGroupLaunchTest {
+ protected:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = NcclGroupLaunchTest::GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_enable_nccl_group_launch(false);
+    return debug_options;
+  }
+};
+
+TEST_F(NcclGroupLaunchDisabledTest, DoesNotGroupWithoutFlag) {
+  if (!NcclCollectiveThunk::NcclIsEnabled()) {
+    GTEST_SKIP() << "NCCL is not enabled";
+  }
+  constexpr char kHlo[] = R"(
+HloModule m
+
+add {
+  lhs = f32[] parameter(0)
+  rhs = f32[] parameter(1)
+  ROOT add = f32[] add(lhs, rhs)
+}
+
+ENTRY e {
+  p0 = f32[1024] parameter(0)
+  p1 = f32[1024] parameter(1)
+  ar0 = f32[1024] all-reduce(p0), replica_groups={}, to_apply=add
+  ar1 = f32[1024] all-reduce(p1), replica_groups={}, to_apply=add
+  ROOT tuple = (f32[1024], f32[1024]) tuple(ar0, ar1)
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto kinds, GetThunkKinds(kHlo));
+  EXPECT_EQ(Count(kinds, Thunk::kNcclGroup), 0);
+  EXPECT_EQ(Count(kinds, Thunk::kNcclAllReduceStart), 2);
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
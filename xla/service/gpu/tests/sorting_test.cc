@@ -68,6 +68,39 @@ ENTRY TestComputation {
   EXPECT_TRUE(RunAndCompareNoHloPasses(hlo_text, ErrorSpec{1e-5, 1e-5}));
 }
 
+TEST_F(SortingTest, MultiOperandSortLargerThanSharedMemory) {
+  // The operands of a 2048-element row take 64KB, more than the shared memory
+  // of a block, so the rows are sorted in smaller tiles.
+  const char* hlo_text = R"(
+HloModule TestModule
+
+compare {
+  p.0.lhs = f64[] parameter(0)
+  p.0.rhs = f64[] parameter(1)
+  p.1.lhs = f64[] parameter(2)
+  p.1.rhs = f64[] parameter(3)
+  p.2.lhs = f64[] parameter(4)
+  p.2.rhs = f64[] parameter(5)
+  p.3.lhs = f64[] parameter(6)
+  p.3.rhs = f64[] parameter(7)
+  ROOT lt = pred[] compare(p.0.lhs, p.0.rhs), direction=LT
+}
+
+ENTRY TestComputation {
+  keys = f64[4, 2048] parameter(0)
+  values.0 = f64[4, 2048] parameter(1)
+  values.1 = f64[4, 2048] parameter(2)
+  values.2 = f64[4, 2048] parameter(3)
+  ROOT sort = (f64[4, 2048], f64[4, 2048], f64[4, 2048], f64[4, 2048])
+    sort(keys, values.0, values.1, values.2), dimensions={1},
+    to_apply=compare
+}
+
+)";
+
+  EXPECT_TRUE(RunAndCompareNoHloPasses(hlo_text, ErrorSpec{1e-5, 1e-5}));
+}
+
 // Size of the radix sort tests.
 static constexpr int kRadixSortTestSize = 100;
 
@@ -0,0 +1,131 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "xla/literal.h"
+#include "xla/literal_util.h"
+#include "xla/service/executable.h"
+#include "xla/service/gpu/tests/gpu_codegen_test.h"
+#include "xla/service/maybe_owning_device_memory.h"
+#include "xla/service/service_executable_run_options.h"
+#include "xla/service/shaped_buffer.h"
+#include "xla/status_macros.h"
+#include "xla/shape_tree.h"
+#include "xla/stream_executor/device_memory_allocator.h"
+#include "xla/stream_executor/stream.h"
+#include "xla/tests/literal_test_util.h"
+#include "xla/xla.pb.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+class TempBufferArenaTest : public GpuCodegenTest {
+ protected:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = GpuCodegenTest::GetDebugOptionsForTest();
+    debug_options.set_xla_gpu_temp_buffer_arenas(2);
+    return debug_options;
+  }
+
+  // Runs `executable` on `argument` on a new stream, with an allocator that is
+  // destroyed once the run is done, and returns the result.
+  StatusOr<Literal> RunWithShortLivedAllocator(Executable* executable,
+                                               const Literal& argument) {
+    se::StreamExecutor* executor = backend().default_stream_executor();
+    se::Stream stream(executor);
+    TF_RET_CHECK(stream.Init().ok());
+    se::StreamExecutorMemoryAllocator allocator(backend().platform(),
+                                                backend().stream_executors());
+    ExecutableRunOptions run_options;
+    run_options.set_stream(&stream);
+    run_options.set_allocator(&allocator);
+    ServiceExecutableRunOptions service_run_options(
+        run_options, backend().StreamBorrowerWithPriority());
+
+    TF_ASSIGN_OR_RETURN(
+        ScopedShapedBuffer argument_buffer,
+        backend().transfer_manager()->AllocateScopedShapedBuffer(
+            argument.shape(), &allocator, executor->device_ordinal()));
+    TF_RETURN_IF_ERROR(backend().transfer_manager()->TransferLiteralToDevice(
+        &stream, argument, argument_buffer));
+    std::vector<ExecutionInput> arguments;
+    ShapeTree<MaybeOwningDeviceMemory> argument_buffers(argument.shape());
+    *argument_buffers.mutable_element({}) =
+        MaybeOwningDeviceMemory(argument_buffer.root_buffer());
+    arguments.emplace_back(std::move(argument_buffers));
+
+    TF_ASSIGN_OR_RETURN(
+        ExecutionOutput output,
+        executable->ExecuteAsyncOnStream(&service_run_options,
+                                         std::move(arguments),
+                                         /*hlo_execution_profile=*/nullptr));
+    TF_ASSIGN_OR_RETURN(Literal result,
+                        backend().transfer_manager()->TransferLiteralFromDevice(
+                            &stream, output.Result()));
+    TF_RETURN_IF_ERROR(stream.BlockHostUntilDone());
+    return result;
+  }
+};
+
+TEST_F(TempBufferArenaTest, ArenasOutliveTheAllocatorsOfTheRuns) {
+  // The result of the dot is a temp buffer.
+  const char* hlo = R"(
+    HloModule m
+
+    add {
+      x = f32[] parameter(0)
+      y = f32[] parameter(1)
+      ROOT add = f32[] add(x, y)
+    }
+
+    ENTRY e {
+      p = f32[32,32] parameter(0)
+      dot = f32[32,32] dot(p, p), lhs_contracting_dims={1},
+        rhs_contracting_dims={0}
+      zero = f32[] constant(0)
+      ROOT reduce = f32[32] reduce(dot, zero), dimensions={1}, to_apply=add
+    })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(hlo));
+  TF_ASSERT_OK_AND_ASSIGN(auto optimized_module,
+                          GetOptimizedModule(std::move(module)));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<Executable> executable,
+      backend().compiler()->RunBackend(
+          std::move(optimized_module), backend().default_stream_executor(),
+          backend().default_stream_executor()->GetAllocator()));
+
+  Literal argument = LiteralUtil::CreateFullWithDescendingLayout<float>(
+      {32, 32}, 1.0f);
+  Literal expected = LiteralUtil::CreateFullWithDescendingLayout<float>(
+      {32}, 32.0f * 32.0f);
+  // Later runs reuse the arena allocated by the first run, whose allocator is
+  // gone by then.
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(
+        Literal result, RunWithShortLivedAllocator(executable.get(), argument));
+    EXPECT_TRUE(LiteralTestUtil::Equal(expected, result));
+  }
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -67,6 +67,7 @@ Thunk::ExecuteParams::ExecuteParams(
     CASE(kNcclAllToAllDone);
     CASE(kNcclSend);
     CASE(kNcclRecv);
+    CASE(kNcclGroup);
     CASE(kFft);
     CASE(kFor);
     CASE(kGemm);
@@ -96,6 +96,7 @@ class Thunk {
     kNcclAllToAllDone,
     kNcclSend,
     kNcclRecv,
+    kNcclGroup,
     kOutfeed,
     kReplicaId,
     kPartitionId,
@@ -0,0 +1,182 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/thunk_stream_assignment.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/gpu/copy_thunk.h"
+#include "xla/service/gpu/kernel_thunk.h"
+#include "xla/service/gpu/memset_thunk.h"
+#include "xla/service/gpu/thunk.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+struct BufferUse {
+  BufferAllocation::Slice slice;
+  bool written;
+};
+
+// Returns the buffer slices accessed by `thunk`, or std::nullopt if they are
+// not known.
+std::optional<std::vector<BufferUse>> GetBufferUses(const Thunk& thunk) {
+  if (auto* kernel = dynamic_cast<const KernelThunk*>(&thunk)) {
+    std::vector<BufferUse> uses;
+    uses.reserve(kernel->arguments().size());
+    for (size_t i = 0; i < kernel->arguments().size(); ++i) {
+      uses.push_back({kernel->arguments()[i], kernel->written()[i]});
+    }
+    return uses;
+  }
+  if (auto* memzero = dynamic_cast<const MemzeroThunk*>(&thunk)) {
+    return std::vector<BufferUse>{{memzero->destination(), true}};
+  }
+  if (auto* memset = dynamic_cast<const Memset32BitValueThunk*>(&thunk)) {
+    return std::vector<BufferUse>{{memset->destination(), true}};
+  }
+  if (auto* copy = dynamic_cast<const DeviceToDeviceCopyThunk*>(&thunk)) {
+    return std::vector<BufferUse>{{copy->source(), false},
+                                  {copy->destination(), true}};
+  }
+  return std::nullopt;
+}
+
+// An access of a buffer slice by the thunk at index `thunk`.
+struct BufferAccess {
+  int thunk;
+  BufferUse use;
+};
+
+bool Contains(const BufferAllocation::Slice& slice,
+              const BufferAllocation::Slice& other) {
+  return slice.index() == other.index() && slice.offset() <= other.offset() &&
+         other.offset() + other.size() <= slice.offset() + slice.size();
+}
+
+}  // namespace
+
+ThunkStreamAssignment AssignThunkStreams(const ThunkSequence& thunks,
+                                         int num_streams) {
+  num_streams = std::max(num_streams, 1);
+  ThunkStreamAssignment assignment;
+  assignment.streams.resize(thunks.size(), 0);
+  assignment.waits.resize(thunks.size());
+
+  // The last thunk assigned to each stream, or -1.
+  std::vector<int> last_thunk(num_streams, -1);
+  // waited[s][t] is the last thunk of stream t that stream s waited for.
+  std::vector<std::vector<int>> waited(num_streams,
+                                       std::vector<int>(num_streams, -1));
+  // The accesses of each allocation by the thunks after the last one with
+  // unknown uses. An access is dropped once a later thunk writes a slice that
+  // contains it: any thunk conflicting with the access also conflicts with that
+  // write, and so already waits for the access through it. This keeps the scan
+  // of the dependencies of a thunk short, instead of comparing it with all the
+  // earlier thunks.
+  absl::flat_hash_map<BufferAllocation::Index, std::vector<BufferAccess>>
+      accesses;
+  int last_barrier = -1;
+  int next_stream = 0;
+
+  for (int j = 0; j < thunks.size(); ++j) {
+    std::optional<std::vector<BufferUse>> thunk_uses =
+        GetBufferUses(*thunks[j]);
+    std::vector<int>& waits = assignment.waits[j];
+
+    if (!thunk_uses.has_value()) {
+      // Wait for the work of all the other streams.
+      for (int t = 1; t < num_streams; ++t) {
+        if (last_thunk[t] > waited[0][t]) {
+          waits.push_back(t);
+          waited[0][t] = last_thunk[t];
+        }
+      }
+      assignment.streams[j] = 0;
+      last_thunk[0] = j;
+      last_barrier = j;
+      accesses.clear();
+      continue;
+    }
+
+    std::vector<int> deps;
+    if (last_barrier >= 0) deps.push_back(last_barrier);
+    for (const BufferUse& use : *thunk_uses) {
+      auto it = accesses.find(use.slice.index());
+      if (it == accesses.end()) continue;
+      for (const BufferAccess& access : it->second) {
+        if ((access.use.written || use.written) &&
+            access.use.slice.OverlapsWith(use.slice)) {
+          deps.push_back(access.thunk);
+        }
+      }
+    }
+    absl::c_sort(deps);
+    deps.erase(std::unique(deps.begin(), deps.end()), deps.end());
+
+    for (const BufferUse& use : *thunk_uses) {
+      std::vector<BufferAccess>& allocation_accesses =
+          accesses[use.slice.index()];
+      if (use.written) {
+        allocation_accesses.erase(
+            std::remove_if(allocation_accesses.begin(),
+                           allocation_accesses.end(),
+                           [&](const BufferAccess& access) {
+                             return Contains(use.slice, access.use.slice);
+                           }),
+            allocation_accesses.end());
+      }
+    }
+    for (const BufferUse& use : *thunk_uses) {
+      accesses[use.slice.index()].push_back({j, use});
+    }
+
+    // Continue the chain of the latest dependency that ends a chain, or start
+    // a new chain on the next stream.
+    int stream = -1;
+    for (auto it = deps.rbegin(); it != deps.rend(); ++it) {
+      if (last_thunk[assignment.streams[*it]] == *it) {
+        stream = assignment.streams[*it];
+        break;
+      }
+    }
+    if (stream == -1) {
+      stream = next_stream;
+      next_stream = (next_stream + 1) % num_streams;
+    }
+
+    for (int dep : deps) {
+      int t = assignment.streams[dep];
+      if (t != stream && dep > waited[stream][t]) {
+        if (!absl::c_linear_search(waits, t)) waits.push_back(t);
+        waited[stream][t] = last_thunk[t];
+      }
+    }
+    assignment.streams[j] = stream;
+    last_thunk[stream] = j;
+    assignment.num_streams = std::max(assignment.num_streams, stream + 1);
+  }
+  return assignment;
+}
+
+}  // namespace gpu
+}  // namespace xla
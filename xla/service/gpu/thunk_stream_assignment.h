@@ -0,0 +1,58 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_GPU_THUNK_STREAM_ASSIGNMENT_H_
+#define XLA_SERVICE_GPU_THUNK_STREAM_ASSIGNMENT_H_
+
+#include <vector>
+
+#include "xla/service/gpu/thunk.h"
+
+namespace xla {
+namespace gpu {
+
+// The streams that the thunks of a sequence run on. Stream 0 is the stream
+// the executable runs on, and the other streams are borrowed for the run.
+struct ThunkStreamAssignment {
+  // Number of streams used by the thunks.
+  int num_streams = 1;
+
+  // The stream of each thunk.
+  std::vector<int> streams;
+
+  // The streams that each thunk's stream waits for before the thunk runs,
+  // i.e. the other streams with earlier work that the thunk depends on.
+  std::vector<std::vector<int>> waits;
+};
+
+// Assigns the thunks of `thunks` to at most `num_streams` streams, so that
+// independent kernels, memsets and copies run concurrently.
+//
+// A thunk depends on an earlier one if they access overlapping buffer slices
+// and one of them writes. The buffer uses of other thunks (library calls,
+// collectives, control flow, ...) are not known: they run on stream 0 after
+// all the earlier work, and all the later thunks depend on them.
+//
+// Chains of dependent thunks stay on one stream, where the stream order
+// enforces the dependencies. Thunks that start a chain are assigned to the
+// streams in turn. A thunk only waits for another stream if it depends on work
+// of that stream that its stream has not waited for yet.
+ThunkStreamAssignment AssignThunkStreams(const ThunkSequence& thunks,
+                                         int num_streams);
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // XLA_SERVICE_GPU_THUNK_STREAM_ASSIGNMENT_H_
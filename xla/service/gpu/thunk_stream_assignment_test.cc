@@ -0,0 +1,127 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/gpu/thunk_stream_assignment.h"
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "mlir/IR/Value.h"  // from @llvm-project
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/gpu/copy_thunk.h"
+#include "xla/service/gpu/memset_thunk.h"
+#include "xla/service/gpu/sequential_thunk.h"
+#include "xla/service/gpu/thunk.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+class ThunkStreamAssignmentTest : public ::testing::Test {
+ protected:
+  BufferAllocation::Slice Slice(int64_t offset) {
+    return BufferAllocation::Slice(&allocation_, offset, 256);
+  }
+
+  void AddMemzero(int64_t offset) {
+    thunks_.push_back(std::make_unique<MemzeroThunk>(
+        Thunk::ThunkInfo(nullptr), Slice(offset), mlir::Value()));
+  }
+
+  void AddCopy(int64_t src_offset, int64_t dst_offset) {
+    thunks_.push_back(std::make_unique<DeviceToDeviceCopyThunk>(
+        Thunk::ThunkInfo(nullptr), Slice(src_offset), Slice(dst_offset),
+        /*mem_size=*/256, mlir::Value(), mlir::Value()));
+  }
+
+  // Adds a thunk whose buffer uses are not known.
+  void AddBarrier() {
+    thunks_.push_back(std::make_unique<SequentialThunk>(
+        Thunk::ThunkInfo(nullptr), ThunkSequence()));
+  }
+
+  BufferAllocation allocation_{/*index=*/0, /*size=*/1024, /*color=*/0};
+  ThunkSequence thunks_;
+};
+
+TEST_F(ThunkStreamAssignmentTest, ChainsStayOnOneStream) {
+  AddMemzero(0);
+  AddMemzero(256);
+  AddCopy(0, 512);
+  // Depends on all the thunks above, and waits for the stream of the second.
+  AddCopy(256, 0);
+
+  ThunkStreamAssignment assignment = AssignThunkStreams(thunks_, 4);
+  EXPECT_EQ(assignment.num_streams, 2);
+  EXPECT_THAT(assignment.streams, ElementsAre(0, 1, 0, 0));
+  EXPECT_THAT(assignment.waits[0], IsEmpty());
+  EXPECT_THAT(assignment.waits[1], IsEmpty());
+  EXPECT_THAT(assignment.waits[2], IsEmpty());
+  EXPECT_THAT(assignment.waits[3], ElementsAre(1));
+}
+
+TEST_F(ThunkStreamAssignmentTest, OverwrittenAccessesAreWaitedForThroughWrite) {
+  AddMemzero(0);
+  AddMemzero(256);
+  // Reads the second memzero and overwrites the first one, waiting for its
+  // stream.
+  AddCopy(256, 0);
+  // Only conflicts with the copy, which already waited for the first memzero.
+  AddMemzero(0);
+
+  ThunkStreamAssignment assignment = AssignThunkStreams(thunks_, 4);
+  EXPECT_EQ(assignment.num_streams, 2);
+  EXPECT_THAT(assignment.streams, ElementsAre(0, 1, 1, 1));
+  EXPECT_THAT(assignment.waits[2], ElementsAre(0));
+  EXPECT_THAT(assignment.waits[3], IsEmpty());
+}
+
+TEST_F(ThunkStreamAssignmentTest, ThunksWithUnknownUsesRunOnMainStream) {
+  AddMemzero(0);
+  AddMemzero(256);
+  AddBarrier();
+  AddMemzero(0);
+  AddMemzero(256);
+
+  ThunkStreamAssignment assignment = AssignThunkStreams(thunks_, 4);
+  EXPECT_EQ(assignment.num_streams, 3);
+  EXPECT_THAT(assignment.streams, ElementsAre(0, 1, 0, 0, 2));
+  EXPECT_THAT(assignment.waits[2], ElementsAre(1));
+  EXPECT_THAT(assignment.waits[3], IsEmpty());
+  EXPECT_THAT(assignment.waits[4], ElementsAre(0));
+}
+
+TEST_F(ThunkStreamAssignmentTest, SingleStream) {
+  AddMemzero(0);
+  AddMemzero(256);
+  AddBarrier();
+  AddCopy(0, 256);
+
+  ThunkStreamAssignment assignment = AssignThunkStreams(thunks_, 1);
+  EXPECT_EQ(assignment.num_streams, 1);
+  EXPECT_THAT(assignment.streams, ElementsAre(0, 0, 0, 0));
+  for (const std::vector<int>& waits : assignment.waits) {
+    EXPECT_THAT(waits, IsEmpty());
+  }
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
@@ -60,7 +60,7 @@ StatusOr<HloInstruction*> SmallBufferOptimization(
                            data_shape.ToString());
   }
   bool has_batch = data_shape.dimensions_size() == 2;
-  constexpr size_t max_k = 16;
+  constexpr size_t max_k = 32;
   constexpr size_t min_n = 1024;
   size_t n = data_shape.dimensions(has_batch ? 1 : 0);
   size_t k = topk->shape().tuple_shapes(0).dimensions(has_batch ? 1 : 0);
@@ -31,6 +31,7 @@ limitations under the License.
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
@@ -334,6 +335,51 @@ std::vector<AutotuneResult::TritonGemmKey> GetFixedMatmulAutotuneConfigs(
   return configs;
 }
 
+// Drops the configs whose tiles are larger than needed to cover the GEMM of
+// `dot`. A tile larger than a dimension (rounded up to a power of two) only
+// computes padding, so such a config never beats the one with the tile
+// clamped to the dimension, which is also part of the exhaustive search
+// space. Likewise, splitting K into chunks smaller than `block_k` only adds
+// reduction overhead.
+void PruneOversizedTilings(
+    const HloDotInstruction& dot,
+    std::vector<AutotuneResult::TritonGemmKey>& configs) {
+  const DotDimensionNumbers& dims = dot.dot_dimension_numbers();
+  const Shape& lhs_shape = dot.operand(0)->shape();
+  int64_t batch = 1;
+  for (int64_t dim : dims.lhs_batch_dimensions()) {
+    batch *= lhs_shape.dimensions(dim);
+  }
+  int64_t k = 1;
+  for (int64_t dim : dims.lhs_contracting_dimensions()) {
+    k *= lhs_shape.dimensions(dim);
+  }
+  if (batch == 0 || k == 0) {
+    return;
+  }
+  const int64_t m = ShapeUtil::ElementsIn(lhs_shape) / (batch * k);
+  const int64_t n =
+      ShapeUtil::ElementsIn(dot.operand(1)->shape()) / (batch * k);
+  auto max_tile = [](int64_t dim_size) -> int64_t {
+    return std::max<int64_t>(BLOCK_SIZES.front(),
+                             absl::bit_ceil(static_cast<uint64_t>(dim_size)));
+  };
+  const int64_t max_block_m = max_tile(m);
+  const int64_t max_block_n = max_tile(n);
+  const int64_t max_block_k = max_tile(k);
+  configs.erase(
+      std::remove_if(configs.begin(), configs.end(),
+                     [&](const AutotuneResult::TritonGemmKey& config) {
+                       return config.block_m() > max_block_m ||
+                              config.block_n() > max_block_n ||
+                              config.block_k() > max_block_k ||
+                              (config.split_k() > 1 &&
+                               config.block_k() * config.split_k() >
+                                   max_block_k);
+                     }),
+      configs.end());
+}
+
 int GetLogEveryN() { return VLOG_IS_ON(3) ? 100 : 1000; }
 
 StatusOr<std::unique_ptr<HloModule>> TritonGemmAutotuneExtractor(
@@ -814,10 +860,16 @@ std::vector<AutotuneResult::TritonGemmKey> GetPossibleMatmulAutotuneConfigs(
                                       kMaxTileSize /
                                       ShapeUtil::ElementsIn(dot.shape()))
           : 1;
-  return exhaustive_tiling_search
-             ? GetExhaustiveMatmulAutotuneConfigs(compute_capability,
-                                                  max_split_k)
-             : GetFixedMatmulAutotuneConfigs(compute_capability, max_split_k);
+  if (!exhaustive_tiling_search) {
+    return GetFixedMatmulAutotuneConfigs(compute_capability, max_split_k);
+  }
+  std::vector<AutotuneResult::TritonGemmKey> configs =
+      GetExhaustiveMatmulAutotuneConfigs(compute_capability, max_split_k);
+  const size_t num_configs = configs.size();
+  PruneOversizedTilings(dot, configs);
+  VLOG(2) << "Pruned " << num_configs - configs.size() << " of " << num_configs
+          << " exhaustive tiling configs of " << dot.name();
+  return configs;
 }
 
 StatusOr<bool> TritonAutotuner::Run(
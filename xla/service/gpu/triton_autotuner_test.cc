@@ -324,6 +324,35 @@ ENTRY e {
                            }));
 }
 
+TEST_F(TritonAutotunerTest, ExhaustiveSearchSkipsTilesLargerThanTheGemm) {
+  std::unique_ptr<VerifiedHloModule> module = ParseAndReturnVerifiedModule(R"(
+ENTRY e {
+  p0 = f32[64,100] parameter(0)
+  p1 = f32[100,4096] parameter(1)
+  ROOT r = f32[64,4096] dot(p0, p1),
+    lhs_contracting_dims={1}, rhs_contracting_dims={0}
+})")
+                                                  .value();
+  const se::CudaComputeCapability compute_capability{
+      se::CudaComputeCapability::AMPERE, /*minor=*/0};
+  const std::vector<AutotuneResult::TritonGemmKey> configs =
+      GetPossibleMatmulAutotuneConfigs(
+          *Cast<HloDotInstruction>(
+              module->entry_computation()->root_instruction()),
+          compute_capability, GetDebugOptionsForTest(),
+          /*exhaustive_tiling_search=*/true);
+  ASSERT_FALSE(configs.empty());
+  EXPECT_TRUE(std::all_of(configs.begin(), configs.end(),
+                          [](const AutotuneResult::TritonGemmKey& key) {
+                            return key.block_m() <= 64 &&
+                                   key.block_k() * key.split_k() <= 128;
+                          }));
+  EXPECT_TRUE(std::any_of(configs.begin(), configs.end(),
+                          [](const AutotuneResult::TritonGemmKey& key) {
+                            return key.block_n() == 512;
+                          }));
+}
+
 TEST_F(TritonAutotunerTest, Int8FusedGemm) {
   const std::string hlo = R"(
 HloModule module
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "xla/util.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
 
 namespace xla {
 namespace gpu {
@@ -50,23 +51,26 @@ Status WhileThunk::ExecuteOnStream(const ExecuteParams& params) {
       params.buffer_allocations->GetDeviceAddress(
           condition_result_buffer_index_);
 
+  TF_ASSIGN_OR_RETURN(void* condition_result_buffer,
+                      condition_results_.Get(&stream));
+  bool* condition_result = static_cast<bool*>(condition_result_buffer);
+
   while (true) {
     // Invoke thunk sequence for while 'condition' computation.
     VLOG(3) << "Executing condition computation";
     TF_RETURN_IF_ERROR(condition_thunk_sequence_->ExecuteOnStream(params));
 
     // Copy the result of condition computation and break the loop if 'false'.
-    bool condition_result;
-    stream.ThenMemcpy(&condition_result, condition_result_data, sizeof(bool));
-    VLOG(3) << "condition_result = " << condition_result;
+    stream.ThenMemcpy(condition_result, condition_result_data, sizeof(bool));
     Status block_status = stream.BlockHostUntilDone();
     if (!block_status.ok()) {
       return InternalError(
           "Failed to complete all kernels launched on stream %p: %s", &stream,
           block_status.message());
     }
+    VLOG(3) << "condition_result = " << *condition_result;
 
-    if (!condition_result) {
+    if (!*condition_result) {
       break;
     }
 
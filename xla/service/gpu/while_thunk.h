@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/service/gpu/buffer_allocations.h"
+#include "xla/service/gpu/pinned_host_buffers.h"
 #include "xla/service/gpu/sequential_thunk.h"
 #include "xla/service/gpu/thunk.h"
 #include "xla/stream_executor/stream_executor.h"
@@ -34,7 +35,7 @@ namespace gpu {
 // allocation:
 //   init, condition.parameter, body.parameter, body.root, while.result
 // WhileThunk synchronizes the stream to test the result of the 'condition'
-// computation.
+// computation, which is copied to pinned host memory.
 class WhileThunk : public Thunk {
  public:
   // Constructs a WhileThunk to compute while instruction 'hlo'.
@@ -58,6 +59,7 @@ class WhileThunk : public Thunk {
   const BufferAllocation::Slice condition_result_buffer_index_;
   std::unique_ptr<SequentialThunk> condition_thunk_sequence_;
   std::unique_ptr<SequentialThunk> body_thunk_sequence_;
+  PinnedHostBuffers condition_results_{sizeof(bool)};
 };
 
 }  // namespace gpu
@@ -37,6 +37,7 @@ limitations under the License.
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "xla/service/graphcycles/ordered_set.h"
 #include "tsl/platform/logging.h"
 
@@ -158,8 +159,10 @@ void GraphCycles::RemoveEdge(int32_t x, int32_t y) {
   // rank assignment remains valid after an edge deletion.
 }
 
-static bool ForwardDFS(GraphCycles::Rep* r, int32_t n, int32_t upper_bound);
-static void BackwardDFS(GraphCycles::Rep* r, int32_t n, int32_t lower_bound);
+static bool ForwardDFS(GraphCycles::Rep* r, absl::Span<const int32_t> roots,
+                       int32_t upper_bound);
+static void BackwardDFS(GraphCycles::Rep* r, absl::Span<const int32_t> roots,
+                        int32_t lower_bound);
 static void Reorder(GraphCycles::Rep* r);
 static void Sort(const Vec<Node*>&, Vec<int32_t>* delta);
 static void MoveToList(GraphCycles::Rep* r, Vec<int32_t>* src,
@@ -185,7 +188,7 @@ bool GraphCycles::InsertEdge(int32_t x, int32_t y) {
 
   // Current rank assignments are incompatible with the new edge.  Recompute.
   // We only need to consider nodes that fall in the range [ny->rank,nx->rank].
-  if (!ForwardDFS(r, y, nx->rank)) {
+  if (!ForwardDFS(r, {y}, nx->rank)) {
     // Found a cycle.  Undo the insertion and tell caller.
     nx->out.Erase(y);
     ny->in.Erase(x);
@@ -194,19 +197,22 @@ bool GraphCycles::InsertEdge(int32_t x, int32_t y) {
     ClearVisitedBits(r, r->deltaf_);
     return false;
   }
-  BackwardDFS(r, x, ny->rank);
+  BackwardDFS(r, {x}, ny->rank);
   Reorder(r);
   return true;
 }
 
-static bool ForwardDFS(GraphCycles::Rep* r, int32_t n, int32_t upper_bound) {
+// Visits the nodes reachable from `roots` with a rank lower than
+// `upper_bound` and stores them in deltaf_. Returns false if a node with rank
+// `upper_bound` is reachable.
+static bool ForwardDFS(GraphCycles::Rep* r, absl::Span<const int32_t> roots,
+                       int32_t upper_bound) {
   // Avoid recursion since stack space might be limited.
   // We instead keep a stack of nodes to visit.
   r->deltaf_.clear();
-  r->stack_.clear();
-  r->stack_.push_back(n);
+  r->stack_.assign(roots.begin(), roots.end());
   while (!r->stack_.empty()) {
-    n = r->stack_.back();
+    int32_t n = r->stack_.back();
     r->stack_.pop_back();
     Node* nn = r->nodes_[n];
     if (nn->visited) continue;
@@ -227,12 +233,14 @@ static bool ForwardDFS(GraphCycles::Rep* r, int32_t n, int32_t upper_bound) {
   return true;
 }
 
-static void BackwardDFS(GraphCycles::Rep* r, int32_t n, int32_t lower_bound) {
+// Visits the nodes that reach `roots` with a rank higher than `lower_bound` and
+// stores them in deltab_.
+static void BackwardDFS(GraphCycles::Rep* r, absl::Span<const int32_t> roots,
+                        int32_t lower_bound) {
   r->deltab_.clear();
-  r->stack_.clear();
-  r->stack_.push_back(n);
+  r->stack_.assign(roots.begin(), roots.end());
   while (!r->stack_.empty()) {
-    n = r->stack_.back();
+    int32_t n = r->stack_.back();
     r->stack_.pop_back();
     Node* nn = r->nodes_[n];
     if (nn->visited) continue;
@@ -353,7 +361,7 @@ bool GraphCycles::IsReachableNonConst(int32_t x, int32_t y) {
   }
 
   // See if x can reach y using a DFS search that is limited to y's rank
-  bool reachable = !ForwardDFS(r, x, ny->rank);
+  bool reachable = !ForwardDFS(r, {x}, ny->rank);
 
   // Clear any visited markers left by ForwardDFS.
   ClearVisitedBits(r, r->deltaf_);
@@ -397,14 +405,51 @@ std::optional<int32_t> GraphCycles::ContractEdge(int32_t a, int32_t b) {
   }
   rep_->free_nodes_.push_back(b);
 
-  rep_->nodes_[a]->out.Reserve(rep_->nodes_[a]->out.Size() + out.Size());
+  // Insert all the edges of "b" into "a" before fixing the rank assignment
+  // once, instead of reordering the graph for every edge that is inconsistent
+  // with the current ranks.
+  //
+  // Since "a" and "b" were connected by an edge, only one direction can be
+  // inconsistent: if "a" is the source of the contracted edge, predecessors of
+  // "b" may have a higher rank than "a", and if "a" is the target, successors
+  // of "b" may have a lower rank than "a".
+  Node* na = rep_->nodes_[a];
+  Vec<int32_t> inconsistent_succs;
+  Vec<int32_t> inconsistent_preds;
+  na->out.Reserve(na->out.Size() + out.Size());
   for (int32_t y : out.GetSequence()) {
-    InsertEdge(a, y);
+    if (na->out.Insert(y)) {
+      rep_->nodes_[y]->in.Insert(a);
+      if (rep_->nodes_[y]->rank < na->rank) inconsistent_succs.push_back(y);
+    }
   }
-
-  rep_->nodes_[a]->in.Reserve(rep_->nodes_[a]->in.Size() + in.Size());
+  na->in.Reserve(na->in.Size() + in.Size());
   for (int32_t y : in.GetSequence()) {
-    InsertEdge(y, a);
+    if (na->in.Insert(y)) {
+      rep_->nodes_[y]->out.Insert(a);
+      if (rep_->nodes_[y]->rank > na->rank) inconsistent_preds.push_back(y);
+    }
+  }
+  CHECK(inconsistent_succs.empty() || inconsistent_preds.empty());
+
+  if (!inconsistent_succs.empty()) {
+    // Move "a" and its predecessors after the successors and theirs.
+    int32_t lower_bound = na->rank;
+    for (int32_t y : inconsistent_succs) {
+      lower_bound = std::min(lower_bound, rep_->nodes_[y]->rank);
+    }
+    CHECK(ForwardDFS(rep_, inconsistent_succs, na->rank));
+    BackwardDFS(rep_, {a}, lower_bound);
+    Reorder(rep_);
+  } else if (!inconsistent_preds.empty()) {
+    // Move "a" and its successors after the predecessors and theirs.
+    int32_t upper_bound = na->rank;
+    for (int32_t y : inconsistent_preds) {
+      upper_bound = std::max(upper_bound, rep_->nodes_[y]->rank);
+    }
+    CHECK(ForwardDFS(rep_, {a}, upper_bound));
+    BackwardDFS(rep_, inconsistent_preds, na->rank);
+    Reorder(rep_);
   }
 
   // Note, if the swap happened it might be what originally was called "b".
@@ -17,8 +17,11 @@ limitations under the License.
 
 #include "xla/service/graphcycles/graphcycles.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <optional>
 #include <random>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
@@ -507,6 +510,46 @@ TEST_F(GraphCyclesTest, CanContractEdge) {
   EXPECT_TRUE(g_.CanContractEdge(3, 4));
 }
 
+TEST(GraphCycles, RandomizedContractEdge) {
+  std::mt19937 rng(42);
+  const int kNumNodes = 50;
+  for (int iter = 0; iter < 50; iter++) {
+    tensorflow::GraphCycles g;
+    std::vector<int32_t> nodes;
+    for (int i = 0; i < kNumNodes; i++) {
+      nodes.push_back(g.NewNode());
+    }
+    // Insert edges in random order so that ranks get reassigned.
+    std::vector<std::pair<int32_t, int32_t>> edges;
+    for (int i = 0; i < kNumNodes; i++) {
+      for (int j = i + 1; j < kNumNodes; j++) {
+        if (rng() % 8 == 0) edges.push_back({nodes[j], nodes[i]});
+      }
+    }
+    std::shuffle(edges.begin(), edges.end(), rng);
+    for (const auto &[from, to] : edges) {
+      ASSERT_TRUE(g.InsertEdge(from, to));
+    }
+
+    absl::flat_hash_set<int32_t> alive(nodes.begin(), nodes.end());
+    for (int i = 0; i < kNumNodes; i++) {
+      std::vector<std::pair<int32_t, int32_t>> candidates;
+      for (int32_t node : alive) {
+        for (int32_t succ : g.Successors(node)) {
+          candidates.push_back({node, succ});
+        }
+      }
+      if (candidates.empty()) break;
+      auto [a, b] = candidates[rng() % candidates.size()];
+      bool can_contract = g.CanContractEdge(a, b);
+      std::optional<int32_t> merged = g.ContractEdge(a, b);
+      ASSERT_EQ(can_contract, merged.has_value());
+      if (merged.has_value()) alive.erase(*merged == a ? b : a);
+      CHECK(g.CheckInvariants());
+    }
+  }
+}
+
 static void BM_StressTest(::testing::benchmark::State &state) {
   const int num_nodes = state.range(0);
 
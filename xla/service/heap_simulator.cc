@@ -46,6 +46,8 @@ limitations under the License.
 #include "xla/service/memory_space_assignment/repacking.h"
 #include "xla/status.h"
 #include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -635,6 +637,11 @@ absl::flat_hash_set<const BufferType*>
 GlobalDecreasingSizeBestFitHeap<BufferType>::GetTransitiveColocations(
     const BufferInterval& interval) const {
   absl::flat_hash_set<const BufferType*> result;
+  // Most buffers have no colocations; this is called from the temporal sort
+  // comparator, so avoid allocating a worklist for them.
+  if (interval.colocations.empty()) {
+    return result;
+  }
   std::vector<const BufferInterval*> worklist = {&interval};
   while (!worklist.empty()) {
     const BufferInterval* item = worklist.back();
@@ -1796,7 +1803,7 @@ void GlobalDecreasingSizeBestFitHeap<BufferType>::CommitChunk(
   result_.heap_size = result_.UpdatedHeapSize(chunk);
   interval_tree_.Add(buffer_interval.start, buffer_interval.end, chunk);
   for (auto colocation : GetTransitiveColocations(buffer_interval)) {
-    auto colocation_interval = buffer_intervals_[colocation];
+    const BufferInterval& colocation_interval = buffer_intervals_[colocation];
     // Create a colocation chunk with the same offset but with the correct size
     // of the colocated interval in case the colocations are of different sizes.
     Chunk colocation_chunk =
@@ -1874,10 +1881,24 @@ HeapSimulator::Result<BufferType>
 ChooseBestHeapAlgorithm<BufferType>::Finish() {
   DCHECK(!algorithms_.empty());
   std::vector<Result> results(algorithms_.size());
+  if (algorithms_.size() == 1 || num_buffers_ < kMinBuffersForParallelFinish) {
+    for (int i = 0; i < algorithms_.size(); ++i) {
+      results[i] = algorithms_[i]->Finish();
+    }
+  } else {
+    // The algorithms only share the (immutable) buffers, so they can be run
+    // concurrently. On large modules each of them takes seconds.
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(),
+                                        "choose_best_heap_algorithm",
+                                        algorithms_.size());
+    for (int i = 0; i < algorithms_.size(); ++i) {
+      thread_pool.Schedule([&, i] { results[i] = algorithms_[i]->Finish(); });
+    }
+    // The destructor of the thread pool waits for all algorithms to finish.
+  }
   int64_t min_size = INT64_MAX;
   int min_size_index = -1;
   for (int i = 0; i < algorithms_.size(); ++i) {
-    results[i] = algorithms_[i]->Finish();
     if (results[i].heap_size < min_size) {
       min_size = results[i].heap_size;
       min_size_index = i;
@@ -1885,7 +1906,7 @@ ChooseBestHeapAlgorithm<BufferType>::Finish() {
   }
 
   DCHECK_GE(min_size_index, 0);
-  return results[min_size_index];
+  return std::move(results[min_size_index]);
 }
 
 template class GlobalDecreasingSizeBestFitHeap<HloValue>;
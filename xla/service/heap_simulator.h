@@ -875,6 +875,7 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
   ~ChooseBestHeapAlgorithm() override {}
 
   void Alloc(const BufferType* buffer, int64_t size) override {
+    ++num_buffers_;
     for (auto& algorithm : algorithms_) {
       algorithm->Alloc(buffer, size);
     }
@@ -882,6 +883,7 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
 
   void ShareWith(const BufferType* buffer, const BufferType* share_with,
                  int64_t size) override {
+    ++num_buffers_;
     for (auto& algorithm : algorithms_) {
       algorithm->ShareWith(buffer, share_with, size);
     }
@@ -893,10 +895,14 @@ class ChooseBestHeapAlgorithm : public HeapAlgorithm<BufferType> {
     }
   }
 
+  // Runs the algorithms concurrently if there are at least this many buffers.
+  static constexpr int64_t kMinBuffersForParallelFinish = 1024;
+
   Result Finish() override;
 
  private:
   std::vector<std::unique_ptr<HeapAlgorithm<BufferType>>> algorithms_;
+  int64_t num_buffers_ = 0;
 };
 
 extern template class GlobalDecreasingSizeBestFitHeap<HloValue>;
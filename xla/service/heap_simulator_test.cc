@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/service/heap_simulator.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -1811,6 +1812,66 @@ TEST_F(ConstrainedGlobalDecreasingSizeBestFitHeapTest, ColocatedII) {
   EXPECT_EQ(0, result.heap_results[0].chunk_map.at(buffer_c_).offset);
 }
 
+class ChooseBestHeapAlgorithmTest : public ::testing::Test {
+ protected:
+  ChooseBestHeapAlgorithmTest() : builder_("heap_simulator_test") {
+    // Enough buffers for the algorithms to be run concurrently.
+    for (int64_t i = 0;
+         i < ChooseBestHeapAlgorithm<HloValue>::kMinBuffersForParallelFinish;
+         ++i) {
+      auto const0 = builder_.AddInstruction(
+          HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(1.0)));
+      buffers_.push_back(std::make_unique<HloValue>(i, const0, ShapeIndex{}));
+    }
+  }
+
+  // Allocates buffers of pseudo-random sizes with overlapping live ranges.
+  void Simulate(HeapAlgorithm<HloValue>& heap) {
+    for (int64_t i = 0; i < buffers_.size(); ++i) {
+      heap.Alloc(buffers_[i].get(), Size(i));
+      if (i >= 8) {
+        heap.Free(buffers_[i - 8].get(), Size(i - 8));
+      }
+    }
+    for (int64_t i = std::max<int64_t>(0, buffers_.size() - 8);
+         i < buffers_.size(); ++i) {
+      heap.Free(buffers_[i].get(), Size(i));
+    }
+  }
+
+  static int64_t Size(int64_t i) { return 16 + (i * 37) % 101; }
+
+  HloComputation::Builder builder_;
+  std::vector<std::unique_ptr<HloValue>> buffers_;
+};
+
+TEST_F(ChooseBestHeapAlgorithmTest, PicksSmallestHeap) {
+  auto algorithms =
+      std::make_unique<std::vector<std::unique_ptr<HeapAlgorithm<HloValue>>>>();
+  algorithms->push_back(
+      std::make_unique<GlobalDecreasingSizeBestFitHeap<HloValue>>(
+          /*alignment=*/1,
+          GlobalDecreasingSizeBestFitHeap<HloValue>::kSpatial));
+  algorithms->push_back(
+      std::make_unique<GlobalDecreasingSizeBestFitHeap<HloValue>>(
+          /*alignment=*/1,
+          GlobalDecreasingSizeBestFitHeap<HloValue>::kTemporal));
+  ChooseBestHeapAlgorithm<HloValue> heap(std::move(algorithms));
+  Simulate(heap);
+  const HeapSimulator::Result<HloValue> result = heap.Finish();
+
+  GlobalDecreasingSizeBestFitHeap<HloValue> spatial(
+      /*alignment=*/1, GlobalDecreasingSizeBestFitHeap<HloValue>::kSpatial);
+  Simulate(spatial);
+  GlobalDecreasingSizeBestFitHeap<HloValue> temporal(
+      /*alignment=*/1, GlobalDecreasingSizeBestFitHeap<HloValue>::kTemporal);
+  Simulate(temporal);
+  EXPECT_EQ(result.heap_size, std::min(spatial.Finish().heap_size,
+                                       temporal.Finish().heap_size));
+  ASSERT_EQ(result.heap_results.size(), 1);
+  EXPECT_EQ(result.heap_results[0].chunk_map.size(), buffers_.size());
+}
+
 class IntervalTreeTest : public ::testing::Test {};
 
 TEST_F(IntervalTreeTest, InsertAndRemove) {
@@ -0,0 +1,138 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/hierarchical_all_to_all_decomposer.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/utils/hlo_query.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
+#include "xla/xla_data.pb.h"
+
+namespace xla {
+
+int64_t HierarchicalAllToAllDecomposer::GetNumParticipants(
+    const HloAllToAllInstruction& all_to_all) const {
+  if (devices_per_node_ <= 1 || all_to_all.constrain_layout() ||
+      !all_to_all.split_dimension() || all_to_all.shape().IsTuple()) {
+    return 0;
+  }
+
+  const HloModuleConfig& config = all_to_all.GetModule()->config();
+  int64_t num_participants = all_to_all.channel_id()
+                                 ? config.num_partitions()
+                                 : config.replica_count();
+  if (!all_to_all.replica_groups().empty()) {
+    if (all_to_all.replica_groups().size() != 1) return 0;
+    const ReplicaGroup& group = all_to_all.replica_groups().front();
+    for (int64_t i = 0; i < group.replica_ids_size(); ++i) {
+      if (group.replica_ids(i) != i) return 0;
+    }
+    num_participants = group.replica_ids_size();
+  }
+
+  if (num_participants <= devices_per_node_ ||
+      num_participants % devices_per_node_ != 0) {
+    return 0;
+  }
+  const Shape& shape = all_to_all.shape();
+  if (shape.dimensions(*all_to_all.split_dimension()) % num_participants !=
+          0 ||
+      ShapeUtil::ByteSizeOf(shape) / num_participants > max_bytes_per_peer_) {
+    return 0;
+  }
+  return num_participants;
+}
+
+bool HierarchicalAllToAllDecomposer::InstructionMatchesPattern(
+    HloInstruction* instruction) {
+  auto* all_to_all = DynCast<HloAllToAllInstruction>(instruction);
+  return all_to_all != nullptr && GetNumParticipants(*all_to_all) > 0;
+}
+
+StatusOr<HloInstruction*> HierarchicalAllToAllDecomposer::ExpandInstruction(
+    HloInstruction* instruction) {
+  auto* all_to_all = Cast<HloAllToAllInstruction>(instruction);
+  HloComputation* computation = all_to_all->parent();
+  const int64_t num_participants = GetNumParticipants(*all_to_all);
+  const int64_t num_nodes = num_participants / devices_per_node_;
+  const int64_t split_dim = *all_to_all->split_dimension();
+  const Shape& shape = all_to_all->shape();
+
+  // Split the split dimension into [node, local index, message]: the block
+  // for participant q = m * L + l is at [m, l].
+  std::vector<int64_t> dims;
+  for (int64_t i = 0; i < shape.rank(); ++i) {
+    if (i != split_dim) {
+      dims.push_back(shape.dimensions(i));
+      continue;
+    }
+    dims.push_back(num_nodes);
+    dims.push_back(devices_per_node_);
+    dims.push_back(shape.dimensions(i) / num_participants);
+  }
+  Shape split_shape = ShapeUtil::MakeShape(shape.element_type(), dims);
+  HloInstruction* operand =
+      computation->AddInstruction(HloInstruction::CreateReshape(
+          split_shape, all_to_all->mutable_operand(0)));
+  all_to_all->SetupDerivedInstruction(operand);
+
+  std::vector<ReplicaGroup> intra_node_groups(num_nodes);
+  std::vector<ReplicaGroup> inter_node_groups(devices_per_node_);
+  for (int64_t m = 0; m < num_nodes; ++m) {
+    for (int64_t l = 0; l < devices_per_node_; ++l) {
+      intra_node_groups[m].add_replica_ids(m * devices_per_node_ + l);
+      inter_node_groups[l].add_replica_ids(m * devices_per_node_ + l);
+    }
+  }
+
+  // Exchanging the local index dimension within each node gathers on device
+  // (n, l) the blocks for the devices with local index l on all nodes, from
+  // all the devices of node n: [m, l'] holds the block of (n, l') for (m, l).
+  HloInstruction* intra_node =
+      computation->AddInstruction(HloInstruction::CreateAllToAll(
+          split_shape, {operand}, intra_node_groups,
+          /*constrain_layout=*/false, all_to_all->channel_id(),
+          /*split_dimension=*/split_dim + 1));
+  all_to_all->SetupDerivedInstruction(intra_node);
+
+  // Exchanging the node dimension between the devices with the same local
+  // index then leaves [m', l'] holding the block of (m', l') for (n, l), which
+  // is the original result.
+  std::optional<int64_t> inter_node_channel_id;
+  if (all_to_all->channel_id()) {
+    inter_node_channel_id = hlo_query::NextChannelId(*all_to_all->GetModule());
+  }
+  HloInstruction* inter_node =
+      computation->AddInstruction(HloInstruction::CreateAllToAll(
+          split_shape, {intra_node}, inter_node_groups,
+          /*constrain_layout=*/false, inter_node_channel_id,
+          /*split_dimension=*/split_dim));
+  all_to_all->SetupDerivedInstruction(inter_node);
+
+  HloInstruction* result = computation->AddInstruction(
+      HloInstruction::CreateReshape(shape, inter_node));
+  all_to_all->SetupDerivedInstruction(result);
+  return result;
+}
+
+}  // namespace xla
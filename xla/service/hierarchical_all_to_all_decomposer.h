@@ -0,0 +1,68 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_HIERARCHICAL_ALL_TO_ALL_DECOMPOSER_H_
+#define XLA_SERVICE_HIERARCHICAL_ALL_TO_ALL_DECOMPOSER_H_
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/service/op_expander_pass.h"
+#include "xla/statusor.h"
+
+namespace xla {
+
+// HierarchicalAllToAllDecomposer splits an array all-to-all whose participants
+// span several nodes into an all-to-all between the devices of each node,
+// followed by an all-to-all between the devices with the same index on each
+// node. With N = M * L participants on M nodes of L devices, each device then
+// exchanges messages with L - 1 local peers and M - 1 remote peers, each
+// aggregating the messages of L original peers, instead of exchanging small
+// messages with all N - 1 peers directly.
+//
+// Participant p is assumed to run on node p / `devices_per_node`, which holds
+// for the default device assignment. Only all-to-alls over a single group of
+// all the participants, in order, and with messages of at most
+// `max_bytes_per_peer` bytes per peer are decomposed: large messages are
+// bandwidth bound and gain nothing from aggregation.
+class HierarchicalAllToAllDecomposer : public OpExpanderPass {
+ public:
+  HierarchicalAllToAllDecomposer(int64_t devices_per_node,
+                                 int64_t max_bytes_per_peer)
+      : devices_per_node_(devices_per_node),
+        max_bytes_per_peer_(max_bytes_per_peer) {}
+
+  absl::string_view name() const override {
+    return "hierarchical-all-to-all-decomposer";
+  }
+
+ private:
+  bool InstructionMatchesPattern(HloInstruction* instruction) override;
+  StatusOr<HloInstruction*> ExpandInstruction(
+      HloInstruction* instruction) override;
+
+  // Returns the number of participants of the all-to-all if it can be
+  // decomposed, and 0 otherwise.
+  int64_t GetNumParticipants(const HloAllToAllInstruction& all_to_all) const;
+
+  const int64_t devices_per_node_;
+  const int64_t max_bytes_per_peer_;
+};
+
+}  // namespace xla
+
+#endif  // XLA_SERVICE_HIERARCHICAL_ALL_TO_ALL_DECOMPOSER_H_
@@ -0,0 +1,91 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/hierarchical_all_to_all_decomposer.h"
+
+#include <memory>
+
+#include <gmock/gmock.h>
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/hlo/utils/hlo_matchers.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/lib/core/status_test_util.h"
+
+namespace xla {
+namespace {
+
+using ::testing::ElementsAre;
+namespace op = xla::testing::opcode_matchers;
+using HierarchicalAllToAllDecomposerTest = HloTestBase;
+
+constexpr char kAllToAll[] = R"(
+HloModule module, num_partitions=8
+
+ENTRY entry {
+  param0 = f32[16,4] parameter(0)
+  ROOT a2a = f32[16,4] all-to-all(param0), replica_groups={{0,1,2,3,4,5,6,7}},
+    dimensions={0}, channel_id=1
+}
+)";
+
+TEST_F(HierarchicalAllToAllDecomposerTest, DecomposesAcrossNodes) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(kAllToAll));
+  HierarchicalAllToAllDecomposer decomposer(/*devices_per_node=*/4,
+                                            /*max_bytes_per_peer=*/1024);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, decomposer.Run(module.get()));
+  EXPECT_TRUE(changed);
+
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  EXPECT_THAT(root, op::Reshape(op::AllToAll(
+                        op::AllToAll(op::Reshape(op::Parameter(0))))));
+  EXPECT_THAT(root->operand(0)->shape().dimensions(),
+              ElementsAre(2, 4, 2, 4));
+
+  auto* inter_node = Cast<HloAllToAllInstruction>(root->mutable_operand(0));
+  auto* intra_node =
+      Cast<HloAllToAllInstruction>(inter_node->mutable_operand(0));
+  EXPECT_EQ(intra_node->split_dimension(), 1);
+  EXPECT_EQ(ReplicaGroupsToString(intra_node->replica_groups()),
+            "{{0,1,2,3},{4,5,6,7}}");
+  EXPECT_EQ(inter_node->split_dimension(), 0);
+  EXPECT_EQ(ReplicaGroupsToString(inter_node->replica_groups()),
+            "{{0,4},{1,5},{2,6},{3,7}}");
+  EXPECT_NE(intra_node->channel_id(), inter_node->channel_id());
+}
+
+TEST_F(HierarchicalAllToAllDecomposerTest, KeepsLargeMessages) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(kAllToAll));
+  HierarchicalAllToAllDecomposer decomposer(/*devices_per_node=*/4,
+                                            /*max_bytes_per_peer=*/16);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, decomposer.Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(HierarchicalAllToAllDecomposerTest, KeepsSingleNode) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(kAllToAll));
+  HierarchicalAllToAllDecomposer decomposer(/*devices_per_node=*/8,
+                                            /*max_bytes_per_peer=*/1024);
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, decomposer.Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+}  // namespace
+}  // namespace xla
@@ -0,0 +1,151 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/hlo_constant_section.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+
+namespace xla {
+namespace {
+
+constexpr absl::string_view kMagic = "XLACONS1";
+
+struct Entry {
+  int64_t instruction_id;
+  uint64_t offset;
+  uint64_t size;
+};
+
+constexpr uint64_t kHeaderBytes = kMagic.size() + sizeof(uint64_t);
+
+absl::string_view BytesOf(const void* data, size_t size) {
+  return absl::string_view(static_cast<const char*>(data), size);
+}
+
+}  // namespace
+
+Status WriteHloConstantSection(const HloModule& module, int64_t min_bytes,
+                               const std::string& path,
+                               HloModuleProto* proto) {
+  std::vector<const HloConstantInstruction*> constants;
+  std::vector<Entry> entries;
+  for (const HloComputation* computation : module.computations()) {
+    for (const HloInstruction* instruction : computation->instructions()) {
+      if (instruction->opcode() != HloOpcode::kConstant ||
+          !instruction->shape().IsArray() ||
+          !instruction->shape().is_static()) {
+        continue;
+      }
+      const auto* constant = Cast<HloConstantInstruction>(instruction);
+      if (!constant->HasLiteral() ||
+          constant->literal().size_bytes() < min_bytes) {
+        continue;
+      }
+      constants.push_back(constant);
+      entries.push_back(Entry{constant->unique_id(), 0,
+                              static_cast<uint64_t>(
+                                  constant->literal().size_bytes())});
+    }
+  }
+  if (constants.empty()) {
+    return OkStatus();
+  }
+
+  uint64_t offset = kHeaderBytes + entries.size() * sizeof(Entry);
+  for (Entry& entry : entries) {
+    entry.offset = RoundUpTo<uint64_t>(offset, kHloConstantSectionAlignment);
+    offset = entry.offset + entry.size;
+  }
+
+  std::unique_ptr<tsl::WritableFile> file;
+  TF_RETURN_IF_ERROR(tsl::Env::Default()->NewWritableFile(path, &file));
+  const uint64_t num_entries = entries.size();
+  TF_RETURN_IF_ERROR(file->Append(kMagic));
+  TF_RETURN_IF_ERROR(
+      file->Append(BytesOf(&num_entries, sizeof(num_entries))));
+  TF_RETURN_IF_ERROR(
+      file->Append(BytesOf(entries.data(), entries.size() * sizeof(Entry))));
+  uint64_t written = kHeaderBytes + entries.size() * sizeof(Entry);
+  for (int64_t i = 0; i < constants.size(); ++i) {
+    TF_RETURN_IF_ERROR(
+        file->Append(std::string(entries[i].offset - written, '\0')));
+    TF_RETURN_IF_ERROR(file->Append(
+        BytesOf(constants[i]->literal().untyped_data(), entries[i].size)));
+    written = entries[i].offset + entries[i].size;
+  }
+  TF_RETURN_IF_ERROR(file->Close());
+
+  absl::flat_hash_set<int64_t> written_ids;
+  for (const Entry& entry : entries) {
+    written_ids.insert(entry.instruction_id);
+  }
+  for (HloComputationProto& computation : *proto->mutable_computations()) {
+    for (HloInstructionProto& instruction :
+         *computation.mutable_instructions()) {
+      if (written_ids.contains(instruction.id())) {
+        instruction.clear_literal();
+      }
+    }
+  }
+  return OkStatus();
+}
+
+StatusOr<absl::flat_hash_map<int64_t, absl::string_view>>
+ParseHloConstantSection(absl::string_view data) {
+  if (data.size() < kHeaderBytes || data.substr(0, kMagic.size()) != kMagic) {
+    return InvalidArgument("Not an HLO constant section");
+  }
+  uint64_t num_entries;
+  std::memcpy(&num_entries, data.data() + kMagic.size(), sizeof(num_entries));
+  if (num_entries > (data.size() - kHeaderBytes) / sizeof(Entry)) {
+    return InvalidArgument("HLO constant section with %d entries is truncated",
+                           num_entries);
+  }
+  absl::flat_hash_map<int64_t, absl::string_view> constants;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    Entry entry;
+    std::memcpy(&entry, data.data() + kHeaderBytes + i * sizeof(Entry),
+                sizeof(Entry));
+    if (entry.offset > data.size() || entry.size > data.size() - entry.offset) {
+      return InvalidArgument(
+          "Data of constant %d is outside of the HLO constant section",
+          entry.instruction_id);
+    }
+    if (!constants.emplace(entry.instruction_id, data.substr(entry.offset,
+                                                             entry.size))
+             .second) {
+      return InvalidArgument("Duplicate constant %d in HLO constant section",
+                             entry.instruction_id);
+    }
+  }
+  return constants;
+}
+
+}  // namespace xla
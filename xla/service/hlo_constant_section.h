@@ -0,0 +1,57 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_HLO_CONSTANT_SECTION_H_
+#define XLA_SERVICE_HLO_CONSTANT_SECTION_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo.pb.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+
+namespace xla {
+
+// A constant section holds the raw data of the large constants of an HLO
+// module, next to a module proto in which the literals of these constants are
+// cleared. Unlike literals in protos, the data is not limited in size, can be
+// memory-mapped and needs no decoding.
+//
+// The file starts with the magic "XLACONS1", the number of constants and, for
+// each constant, its instruction id, offset in the file and size in bytes.
+// The data of each constant follows, in the layout of its shape, at offsets
+// aligned to kHloConstantSectionAlignment. All integers are 64 bits in host
+// byte order, so sections are not portable across architectures.
+inline constexpr int64_t kHloConstantSectionAlignment = 64;
+
+// Writes the data of the static array constants of `module` of at least
+// `min_bytes` bytes into a constant section at `path`, and clears the literals
+// of these constants in `proto`, which must have been created from `module`.
+// Does not create the file if there are no such constants.
+Status WriteHloConstantSection(const HloModule& module, int64_t min_bytes,
+                               const std::string& path, HloModuleProto* proto);
+
+// Parses the constant section in `data` and returns the data of each
+// constant, keyed by instruction id. The returned views point into `data`.
+StatusOr<absl::flat_hash_map<int64_t, absl::string_view>>
+ParseHloConstantSection(absl::string_view data);
+
+}  // namespace xla
+
+#endif  // XLA_SERVICE_HLO_CONSTANT_SECTION_H_
@@ -0,0 +1,113 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/hlo_cost_analysis_cache.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+#include "tsl/platform/errors.h"
+
+namespace xla {
+namespace {
+
+uint64_t InstructionSignature(const HloInstruction& instruction) {
+  // The instruction's hash covers its opcode, its shape and the shapes of its
+  // operands, and for fusions the fused root, kind and size. It doesn't print
+  // anything, so it's cheap enough to take for every instruction on each query.
+  return absl::HashOf(instruction, instruction.called_computations());
+}
+
+}  // namespace
+
+StatusOr<HloCostAnalysis*> HloCostAnalysisCache::GetAnalysis(
+    HloComputation* computation) {
+  num_instructions_visited_ = 0;
+  const HloModule* module = computation->parent();
+  if (module->unique_id() != module_id_) {
+    Clear();
+    module_id_ = module->unique_id();
+  }
+
+  CachedAnalysis& cached = analyses_[computation->unique_id()];
+  // The analysis keeps the properties of the fused instructions of removed
+  // fusions. Start over once it has seen more changes than the computation has
+  // instructions, which bounds those entries and amortizes the full analysis
+  // over the changes.
+  if (cached.analysis != nullptr &&
+      cached.num_changes > computation->instruction_count()) {
+    cached = CachedAnalysis();
+  }
+  if (cached.analysis == nullptr) {
+    cached.analysis = factory_();
+    if (Status status = computation->Accept(cached.analysis.get());
+        !status.ok()) {
+      analyses_.erase(computation->unique_id());
+      return status;
+    }
+    for (const HloInstruction* instruction : computation->instructions()) {
+      cached.signatures[instruction] = InstructionSignature(*instruction);
+    }
+    num_instructions_visited_ = computation->instruction_count();
+    return cached.analysis.get();
+  }
+
+  std::vector<HloInstruction*> post_order =
+      computation->MakeInstructionPostOrder();
+  absl::flat_hash_map<const HloInstruction*, uint64_t> signatures;
+  signatures.reserve(post_order.size());
+  for (HloInstruction* instruction : post_order) {
+    signatures[instruction] = InstructionSignature(*instruction);
+  }
+
+  // Drop the removed instructions first: their addresses may have been reused
+  // by instructions created since, which are analyzed below. The analysis only
+  // uses the addresses as keys.
+  for (const auto& [instruction, signature] : cached.signatures) {
+    if (!signatures.contains(instruction)) {
+      TF_RETURN_IF_ERROR(cached.analysis->RemoveInstruction(
+          const_cast<HloInstruction*>(instruction)));
+      ++cached.num_changes;
+    }
+  }
+  for (HloInstruction* instruction : post_order) {
+    auto it = cached.signatures.find(instruction);
+    if (it != cached.signatures.end() &&
+        it->second == signatures[instruction]) {
+      continue;
+    }
+    TF_RETURN_IF_ERROR(cached.analysis->RevisitInstruction(instruction));
+    ++num_instructions_visited_;
+    ++cached.num_changes;
+  }
+  cached.signatures = std::move(signatures);
+  return cached.analysis.get();
+}
+
+void HloCostAnalysisCache::Clear() {
+  analyses_.clear();
+  module_id_ = -1;
+}
+
+}  // namespace xla
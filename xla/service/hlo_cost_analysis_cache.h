@@ -0,0 +1,90 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_HLO_COST_ANALYSIS_CACHE_H_
+#define XLA_SERVICE_HLO_COST_ANALYSIS_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/statusor.h"
+
+namespace xla {
+
+// Keeps the cost analyses of the computations of a module, so that passes that
+// run one after the other (or repeatedly, in a fixed-point pipeline) share them
+// instead of visiting the whole graph each time.
+//
+// When an analysis is queried, only the instructions that were added or
+// changed since the previous query are revisited, and the ones that were
+// removed are dropped. An instruction is considered changed when its hash
+// changes, which covers its opcode, its shape, the shapes of its operands and
+// its called computations, and for fusions the root, kind and size of the fused
+// computation. Changes to other attributes made in place are not noticed.
+// Callers may update the returned analysis themselves with RevisitInstruction
+// and RemoveInstruction while they modify the graph.
+//
+// An analysis that has seen more changes than its computation has instructions
+// is rebuilt on the next query, so that the properties it keeps for the fused
+// instructions of removed fusions don't build up.
+//
+// The cache only holds analyses of one module at a time.
+class HloCostAnalysisCache {
+ public:
+  using Factory = std::function<std::unique_ptr<HloCostAnalysis>()>;
+
+  // `factory` creates the analyses, all of which must be of the same type and
+  // have the same options.
+  explicit HloCostAnalysisCache(Factory factory)
+      : factory_(std::move(factory)) {}
+
+  // Returns the up-to-date cost analysis of `computation`. The analysis is
+  // owned by the cache and remains valid until the next call of GetAnalysis
+  // for the same computation or for a different module, or until Clear.
+  StatusOr<HloCostAnalysis*> GetAnalysis(HloComputation* computation);
+
+  // Drops all the cached analyses.
+  void Clear();
+
+  // Returns the number of instructions that the last GetAnalysis call visited.
+  int64_t num_instructions_visited() const {
+    return num_instructions_visited_;
+  }
+
+ private:
+  struct CachedAnalysis {
+    std::unique_ptr<HloCostAnalysis> analysis;
+    // Hash of each analyzed instruction.
+    absl::flat_hash_map<const HloInstruction*, uint64_t> signatures;
+    // Number of instructions removed or revisited since the full analysis.
+    int64_t num_changes = 0;
+  };
+
+  Factory factory_;
+  int module_id_ = -1;
+  // Keyed by the unique id of the computation within the module.
+  absl::flat_hash_map<int64_t, CachedAnalysis> analyses_;
+  int64_t num_instructions_visited_ = 0;
+};
+
+}  // namespace xla
+
+#endif  // XLA_SERVICE_HLO_COST_ANALYSIS_CACHE_H_
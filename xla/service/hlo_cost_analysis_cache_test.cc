@@ -0,0 +1,121 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/hlo_cost_analysis_cache.h"
+
+#include <cstdint>
+#include <memory>
+
+#include <gtest/gtest.h>
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+#include "xla/service/hlo_cost_analysis.h"
+#include "xla/shape_util.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/statusor.h"
+
+namespace xla {
+namespace {
+
+int64_t ShapeSize(const Shape& shape) {
+  return ShapeUtil::ByteSizeOf(shape, /*pointer_size=*/8);
+}
+
+class HloCostAnalysisCacheTest : public HloTestBase {
+ protected:
+  HloCostAnalysisCache cache_{[] {
+    return std::make_unique<HloCostAnalysis>(ShapeSize);
+  }};
+};
+
+TEST_F(HloCostAnalysisCacheTest, RevisitsOnlyChangedInstructions) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule m
+
+ENTRY e {
+  p0 = f32[1024] parameter(0)
+  p1 = f32[1024] parameter(1)
+  add = f32[1024] add(p0, p1)
+  exp = f32[1024] exponential(add)
+  ROOT mul = f32[1024] multiply(exp, p1)
+})"));
+  HloComputation* entry = module->entry_computation();
+
+  TF_ASSERT_OK_AND_ASSIGN(HloCostAnalysis * analysis,
+                          cache_.GetAnalysis(entry));
+  EXPECT_EQ(cache_.num_instructions_visited(), 5);
+  EXPECT_EQ(analysis->flop_count(), 2048);
+  EXPECT_EQ(analysis->transcendental_count(), 1024);
+
+  TF_ASSERT_OK_AND_ASSIGN(HloCostAnalysis * unchanged,
+                          cache_.GetAnalysis(entry));
+  EXPECT_EQ(unchanged, analysis);
+  EXPECT_EQ(cache_.num_instructions_visited(), 0);
+
+  // Replace the transcendental with an elementwise op. Its users are not
+  // affected, as the shape of the operand is the same.
+  HloInstruction* exp = entry->GetInstructionWithName("exp");
+  HloInstruction* negate = entry->AddInstruction(HloInstruction::CreateUnary(
+      exp->shape(), HloOpcode::kNegate, exp->mutable_operand(0)));
+  TF_ASSERT_OK(entry->ReplaceInstruction(exp, negate));
+
+  TF_ASSERT_OK_AND_ASSIGN(analysis, cache_.GetAnalysis(entry));
+  EXPECT_EQ(cache_.num_instructions_visited(), 1);
+  EXPECT_EQ(analysis->flop_count(), 3072);
+  EXPECT_EQ(analysis->transcendental_count(), 0);
+
+  HloCostAnalysis fresh(ShapeSize);
+  TF_ASSERT_OK(entry->Accept(&fresh));
+  EXPECT_EQ(analysis->flop_count(), fresh.flop_count());
+  EXPECT_EQ(analysis->bytes_accessed(), fresh.bytes_accessed());
+}
+
+TEST_F(HloCostAnalysisCacheTest, RebuildsAfterManyChanges) {
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(R"(
+HloModule m
+
+ENTRY e {
+  p0 = f32[1024] parameter(0)
+  p1 = f32[1024] parameter(1)
+  add = f32[1024] add(p0, p1)
+  exp = f32[1024] exponential(add)
+  ROOT mul = f32[1024] multiply(exp, p1)
+})"));
+  HloComputation* entry = module->entry_computation();
+  TF_ASSERT_OK(cache_.GetAnalysis(entry).status());
+
+  // Each replacement removes one instruction and adds one.
+  HloInstruction* unary = entry->GetInstructionWithName("exp");
+  for (int i = 0; i < 3; ++i) {
+    HloInstruction* negate = entry->AddInstruction(HloInstruction::CreateUnary(
+        unary->shape(), HloOpcode::kNegate, unary->mutable_operand(0)));
+    TF_ASSERT_OK(entry->ReplaceInstruction(unary, negate));
+    unary = negate;
+    TF_ASSERT_OK(cache_.GetAnalysis(entry).status());
+    EXPECT_EQ(cache_.num_instructions_visited(), 1);
+  }
+
+  // The analysis has seen six changes to a computation of five instructions.
+  TF_ASSERT_OK_AND_ASSIGN(HloCostAnalysis * analysis,
+                          cache_.GetAnalysis(entry));
+  EXPECT_EQ(cache_.num_instructions_visited(), 5);
+  EXPECT_EQ(analysis->flop_count(), 3072);
+  EXPECT_EQ(analysis->transcendental_count(), 0);
+}
+
+}  // namespace
+}  // namespace xla
@@ -20,6 +20,7 @@ limitations under the License.
 #include <string>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_computation.h"
@@ -28,6 +29,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/literal.h"
 #include "xla/service/hlo_domain_map.h"
+#include "xla/service/hlo_structural_hasher.h"
 #include "xla/shape_util.h"
 #include "tsl/platform/errors.h"
 
@@ -150,9 +152,7 @@ struct CseKey {
       }
     }
 
-    for (auto c : instruction->called_computations()) {
-      h = H::combine(std::move(h), c->root_instruction()->opcode());
-    }
+    h = H::combine(std::move(h), key.called_computations_hash);
     switch (instruction->opcode()) {
       case HloOpcode::kSlice:
         return H::combine(std::move(h), instruction->slice_starts(),
@@ -211,13 +211,16 @@ struct CseKey {
     }
   }
   HloInstruction* hlo;
+  // Structural hash of the computations called by `hlo`.
+  size_t called_computations_hash;
 };
 
 }  // namespace
 
-StatusOr<bool> HloCSE::Run(
-    HloModule* module,
-    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+StatusOr<bool> HloCSE::RunOnComputation(HloComputation* computation) {
+  if (only_fusion_computations_ && !computation->IsFusionComputation()) {
+    return false;
+  }
   bool changed = false;
 
   const auto eq_instructions = [&](const HloInstruction* a,
@@ -233,9 +236,26 @@ StatusOr<bool> HloCSE::Run(
                 ? ShapeUtil::Equal(a->shape(), b->shape())
                 : ShapeUtil::Compatible(a->shape(), b->shape()));
   };
-  const auto eq_computations = [](const HloComputation* lhs,
-                                  const HloComputation* rhs) {
-    return *lhs == *rhs;
+  // Called computations are compared structurally, which is expensive for
+  // large computations called from many instructions. Their hashes and the
+  // results of the comparisons are memoized, as CSE doesn't change them.
+  HloStructuralHasher hasher;
+  absl::flat_hash_map<std::pair<const HloComputation*, const HloComputation*>,
+                      bool>
+      computations_equal;
+  const auto eq_computations = [&](const HloComputation* lhs,
+                                   const HloComputation* rhs) {
+    if (lhs == rhs) {
+      return true;
+    }
+    if (hasher.Hash(lhs) != hasher.Hash(rhs)) {
+      return false;
+    }
+    auto [it, inserted] = computations_equal.try_emplace({lhs, rhs}, false);
+    if (inserted) {
+      it->second = *lhs == *rhs;
+    }
+    return it->second;
   };
 
   auto cse_equal = [&](const CseKey& lhs, const CseKey& rhs) {
@@ -244,62 +264,56 @@ StatusOr<bool> HloCSE::Run(
         /*sharding_sensitive=*/true);
   };
 
-  for (auto* computation : module->computations(execution_threads)) {
-    if (only_fusion_computations_ && !computation->IsFusionComputation()) {
+  TF_ASSIGN_OR_RETURN(bool combined,
+                      is_layout_sensitive_
+                          ? CombineConstants<true>(computation)
+                          : CombineConstants<false>(computation));
+  changed |= combined;
+
+  // HLO instructions are grouped into equivalency classes by using the
+  // cse_equal predicate defined above. This set holds a representative
+  // instruction for each class.
+  absl::flat_hash_set<CseKey, absl::Hash<CseKey>, decltype(cse_equal)>
+      representatives(/*N=*/computation->instruction_count() + 1,
+                      absl::Hash<CseKey>{}, cse_equal);
+  for (auto instruction : computation->MakeInstructionPostOrder()) {
+    // If the instruction has zero operands (constants, parameters, etc.) skip
+    // over it.
+    if (instruction->operand_count() == 0 &&
+        instruction->opcode() != HloOpcode::kPartitionId &&
+        instruction->opcode() != HloOpcode::kReplicaId) {
+      continue;
+    }
+    // Skip instructions which have side effects.
+    if (instruction->HasSideEffect()) {
       continue;
     }
 
-    TF_ASSIGN_OR_RETURN(bool combined,
-                        is_layout_sensitive_
-                            ? CombineConstants<true>(computation)
-                            : CombineConstants<false>(computation));
-    changed |= combined;
-
-    // HLO instructions are grouped into equivalency classes by using the
-    // cse_equal predicate defined above. This set holds a representative
-    // instruction for each class.
-    absl::flat_hash_set<CseKey, absl::Hash<CseKey>, decltype(cse_equal)>
-        representatives(/*N=*/computation->instruction_count() + 1,
-                        absl::Hash<CseKey>{}, cse_equal);
-    for (auto instruction : computation->MakeInstructionPostOrder()) {
-      // If the instruction has zero operands (constants, parameters, etc.) skip
-      // over it.
-      if (instruction->operand_count() == 0 &&
-          instruction->opcode() != HloOpcode::kPartitionId &&
-          instruction->opcode() != HloOpcode::kReplicaId) {
-        continue;
-      }
-      // Skip instructions which have side effects.
-      if (instruction->HasSideEffect()) {
-        continue;
-      }
-
-      auto pair = representatives.insert(CseKey{instruction});
-      if (!pair.second) {
-        HloInstruction* equivalent_instruction = pair.first->hlo;
-        TF_RETURN_IF_ERROR(
-            instruction->ReplaceAllUsesWith(equivalent_instruction));
-        TF_RETURN_IF_ERROR(computation->RemoveInstructionAndUnusedOperands(
-            instruction, /*cleanup=*/std::nullopt,
-            ignore_control_dependencies_));
-        changed = true;
+    auto pair = representatives.insert(
+        CseKey{instruction, hasher.HashCalledComputations(instruction)});
+    if (!pair.second) {
+      HloInstruction* equivalent_instruction = pair.first->hlo;
+      TF_RETURN_IF_ERROR(
+          instruction->ReplaceAllUsesWith(equivalent_instruction));
+      TF_RETURN_IF_ERROR(computation->RemoveInstructionAndUnusedOperands(
+          instruction, /*cleanup=*/std::nullopt, ignore_control_dependencies_));
+      changed = true;
+      continue;
+    }
+    for (int64_t i = 0; i < instruction->operand_count(); ++i) {
+      HloInstruction* a = instruction->mutable_operand(i);
+      if (a->opcode() != HloOpcode::kIota) {
         continue;
       }
-      for (int64_t i = 0; i < instruction->operand_count(); ++i) {
-        HloInstruction* a = instruction->mutable_operand(i);
-        if (a->opcode() != HloOpcode::kIota) {
+      for (int64_t j = i + 1; j < instruction->operand_count(); ++j) {
+        HloInstruction* b = instruction->mutable_operand(j);
+        if (a == b || !eq_instructions(a, b)) {
           continue;
         }
-        for (int64_t j = i + 1; j < instruction->operand_count(); ++j) {
-          HloInstruction* b = instruction->mutable_operand(j);
-          if (a == b || !eq_instructions(a, b)) {
-            continue;
-          }
-          TF_RETURN_IF_ERROR(instruction->ReplaceOperandWith(j, a));
-          changed = true;
-          if (b->IsDead()) {
-            TF_RETURN_IF_ERROR(computation->RemoveInstruction(b));
-          }
+        TF_RETURN_IF_ERROR(instruction->ReplaceOperandWith(j, a));
+        changed = true;
+        if (b->IsDead()) {
+          TF_RETURN_IF_ERROR(computation->RemoveInstruction(b));
         }
       }
     }
@@ -208,6 +208,40 @@ TEST_F(HloInstructionTest, MultipleUsers) {
   EXPECT_EQ(3, visitor.NumUsers(foo));
 }
 
+TEST_F(HloInstructionTest, ManyUsers) {
+  // Exercises the users bookkeeping above and below the number of users at
+  // which instructions start to index them with a map.
+  constexpr int kNumUsers = 64;
+  HloComputation::Builder builder(TestName());
+  auto foo =
+      builder.AddInstruction(HloInstruction::CreateParameter(0, r0f32_, "foo"));
+  std::vector<HloInstruction*> users;
+  for (int i = 0; i < kNumUsers; ++i) {
+    users.push_back(builder.AddInstruction(
+        HloInstruction::CreateUnary(r0f32_, HloOpcode::kExp, foo)));
+  }
+  auto module = CreateNewVerifiedModule();
+  module->AddEntryComputation(builder.Build());
+
+  EXPECT_EQ(kNumUsers, foo->user_count());
+  for (HloInstruction* user : users) {
+    EXPECT_TRUE(user->IsUserOf(foo));
+    EXPECT_EQ(foo->users()[foo->UserId(user)], user);
+  }
+
+  // Detach all but the first user from `foo`, checking that the remaining
+  // users are still found.
+  for (int i = kNumUsers - 1; i > 0; --i) {
+    ASSERT_IS_OK(users[i]->ReplaceOperandWith(0, users[0]));
+    EXPECT_FALSE(users[i]->IsUserOf(foo));
+    EXPECT_EQ(i, foo->user_count());
+    for (int j = 0; j < i; ++j) {
+      EXPECT_EQ(foo->users()[foo->UserId(users[j])], users[j]);
+    }
+  }
+  EXPECT_EQ(kNumUsers - 1, users[0]->user_count());
+}
+
 TEST_F(HloInstructionTest, RepeatedUser) {
   // Here we have a user 'add' nodes that uses the same HLO in both operands.
   // Make sure we don't count it as two distinct users.
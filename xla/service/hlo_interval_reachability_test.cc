@@ -0,0 +1,174 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/hlo/ir/hlo_interval_reachability.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_reachability.h"
+#include "xla/test.h"
+#include "xla/tests/hlo_test_base.h"
+#include "tsl/lib/core/status_test_util.h"
+
+namespace xla {
+namespace {
+
+class HloIntervalReachabilityTest : public HloTestBase {
+ protected:
+  // Expects 'index' to agree with HloReachabilityMap on all pairs of
+  // instructions of 'computation'.
+  void ExpectMatchesReachabilityMap(const HloComputation* computation,
+                                    const HloIntervalReachability& index) {
+    auto expected = HloReachabilityMap::Build(computation);
+    for (const HloInstruction* a : computation->instructions()) {
+      for (const HloInstruction* b : computation->instructions()) {
+        EXPECT_EQ(index.IsReachable(a, b), expected->IsReachable(a, b))
+            << a->name() << " -> " << b->name();
+      }
+    }
+  }
+};
+
+TEST_F(HloIntervalReachabilityTest, MatchesReachabilityMap) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test
+
+    ENTRY entry {
+      p0 = f32[8] parameter(0)
+      p1 = f32[8] parameter(1)
+      a = f32[8] add(p0, p1)
+      n = f32[8] negate(p1)
+      e = f32[8] exponential(n)
+      m = f32[8] multiply(a, e)
+      c = f32[8] copy(e)
+      s = f32[8] sine(p0), control-predecessors={c}
+      ROOT t = (f32[8], f32[8], f32[8]) tuple(m, c, s)
+    })")
+                    .value();
+  const HloComputation* computation = module->entry_computation();
+  auto index = HloIntervalReachability::Build(computation);
+  ExpectMatchesReachabilityMap(computation, *index);
+  EXPECT_TRUE(index->IsConnected(computation->root_instruction(),
+                                 computation->parameter_instruction(1)));
+}
+
+TEST_F(HloIntervalReachabilityTest, MatchesReachabilityMapOnWideGraph) {
+  // Many independent chains joined by a few additions, so that most pairs are
+  // unordered and can only be told apart by the labels.
+  std::string hlo = "HloModule test\n\nENTRY entry {\n";
+  hlo += "  p = f32[] parameter(0)\n";
+  constexpr int kChains = 16;
+  constexpr int kLength = 8;
+  for (int c = 0; c < kChains; ++c) {
+    std::string previous = "p";
+    for (int i = 0; i < kLength; ++i) {
+      std::string name = absl::StrCat("n", c, "_", i);
+      if (i % 3 == 2 && c > 0) {
+        absl::StrAppend(&hlo, "  ", name, " = f32[] add(", previous, ", n",
+                        c - 1, "_", i - 1, ")\n");
+      } else {
+        absl::StrAppend(&hlo, "  ", name, " = f32[] negate(", previous, ")\n");
+      }
+      previous = name;
+    }
+  }
+  hlo += "  ROOT t = (";
+  for (int c = 0; c < kChains; ++c) {
+    absl::StrAppend(&hlo, c == 0 ? "" : ", ", "f32[]");
+  }
+  hlo += ") tuple(";
+  for (int c = 0; c < kChains; ++c) {
+    absl::StrAppend(&hlo, c == 0 ? "" : ", ", "n", c, "_", kLength - 1);
+  }
+  hlo += ")\n}\n";
+
+  auto module = ParseAndReturnVerifiedModule(hlo).value();
+  const HloComputation* computation = module->entry_computation();
+  auto index = HloIntervalReachability::Build(computation);
+  ExpectMatchesReachabilityMap(computation, *index);
+}
+
+TEST_F(HloIntervalReachabilityTest, UpdateAfterEdgeChanges) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test
+
+    ENTRY entry {
+      c1 = f32[] constant(1)
+      c2 = f32[] constant(2)
+      add = f32[] add(c1, c2)
+      negate = f32[] negate(c2)
+      exp = f32[] exponential(negate)
+      mul = f32[] multiply(add, exp)
+      ROOT copy = f32[] copy(exp)
+    })")
+                    .value();
+  HloComputation* computation = module->entry_computation();
+  HloInstruction* add = computation->GetInstructionWithName("add");
+  HloInstruction* exp = computation->GetInstructionWithName("exp");
+  HloInstruction* copy = computation->root_instruction();
+  auto index = HloIntervalReachability::Build(computation);
+  EXPECT_FALSE(index->IsReachable(add, copy));
+
+  // Adding a control dependency makes 'copy' reachable from 'add'.
+  TF_ASSERT_OK(add->AddControlDependencyTo(exp));
+  index->UpdateReachabilityThroughInstruction(exp);
+  EXPECT_TRUE(index->IsReachable(add, copy));
+  ExpectMatchesReachabilityMap(computation, *index);
+
+  // Removing it again leaves the labels wider than needed, but the answers
+  // are still exact.
+  TF_ASSERT_OK(add->RemoveControlDependencyTo(exp));
+  index->UpdateReachabilityThroughInstruction(exp);
+  EXPECT_FALSE(index->IsReachable(add, copy));
+  ExpectMatchesReachabilityMap(computation, *index);
+}
+
+TEST_F(HloIntervalReachabilityTest, AddAndReplaceInstructions) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test
+
+    ENTRY entry {
+      p0 = f32[28,28]{1,0} parameter(0)
+      ROOT add = f32[28,28]{1,0} add(p0, p0)
+    })")
+                    .value();
+  HloComputation* computation = module->entry_computation();
+  auto index = HloIntervalReachability::Build(computation);
+  auto* add = computation->root_instruction();
+  auto* p0 = add->operand(0);
+  EXPECT_TRUE(index->IsReachable(p0, add));
+
+  // Introduce a fusion instruction taking the place of `add`.
+  auto* fusion = computation->AddInstruction(HloInstruction::CreateFusion(
+      add->shape(), HloInstruction::FusionKind::kLoop, add));
+  EXPECT_FALSE(index->IsPresent(fusion));
+  index->UpdateReachabilityThroughInstruction(fusion);
+  EXPECT_TRUE(index->IsPresent(fusion));
+  EXPECT_TRUE(index->IsReachable(p0, fusion));
+  EXPECT_FALSE(index->IsConnected(add, fusion));
+
+  // Replace `add` with a copy of it in the index.
+  auto* copy = computation->AddInstruction(add->Clone());
+  index->Replace(add, copy);
+  EXPECT_FALSE(index->IsPresent(add));
+  EXPECT_TRUE(index->IsReachable(p0, copy));
+}
+
+}  // namespace
+}  // namespace xla
@@ -43,6 +43,62 @@ bool IsIdentifierChar(char c) {
          c == '.' || c == '_';
 }
 
+// Characters that may follow a number literal in the common cases: inside
+// literals, shapes and attribute lists.
+bool IsNumberDelimiter(char c) {
+  return c == ',' || c == ')' || c == '}' || c == ']' || c == ' ' ||
+         c == '\n' || c == '\t' || c == '\r';
+}
+
+// Scans a plain integer or floating-point literal starting at 'begin', as
+// matched by the int and float patterns of LexNumberOrPattern, and returns its
+// end. Returns nullptr if there is no such literal, or if it is not followed by
+// a delimiter (or the end of the buffer), in which case it may be part of a
+// pattern instead. '*is_decimal' is set if the literal is a floating-point one.
+const char* ScanPlainNumber(const char* begin, const char* end,
+                            bool* is_decimal) {
+  auto skip_digits = [end](const char* p) {
+    while (p != end && absl::ascii_isdigit(static_cast<unsigned char>(*p))) {
+      ++p;
+    }
+    return p;
+  };
+  const char* p = begin;
+  if (p != end && *p == '-') {
+    ++p;
+  }
+  const char* int_digits_end = skip_digits(p);
+  const bool has_int_digits = int_digits_end != p;
+  p = int_digits_end;
+  *is_decimal = false;
+  if (p != end && *p == '.') {
+    const char* frac_digits_end = skip_digits(p + 1);
+    if (!has_int_digits && frac_digits_end == p + 1) {
+      return nullptr;
+    }
+    p = frac_digits_end;
+    *is_decimal = true;
+  } else if (!has_int_digits) {
+    return nullptr;
+  }
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    const char* exp = p + 1;
+    if (exp != end && (*exp == '+' || *exp == '-')) {
+      ++exp;
+    }
+    const char* exp_digits_end = skip_digits(exp);
+    if (exp_digits_end == exp) {
+      return nullptr;
+    }
+    p = exp_digits_end;
+    *is_decimal = true;
+  }
+  if (p != end && !IsNumberDelimiter(*p)) {
+    return nullptr;
+  }
+  return p;
+}
+
 }  // namespace
 
 int HloLexer::GetNextChar() {
@@ -376,14 +432,29 @@ TokKind HloLexer::LexPercent() {
 // int ::=  [-]?[0-9]+
 // negative inf ::= '-inf'
 TokKind HloLexer::LexNumberOrPattern() {
+  // Plain numbers make up the bulk of large constants, so lex them without
+  // running the regular expressions below.
+  bool is_decimal;
+  if (const char* number_end = ScanPlainNumber(
+          token_state_.token_start, buf_.data() + buf_.size(), &is_decimal)) {
+    current_ptr_ = number_end;
+    auto slice = StringViewFromPointers(token_state_.token_start, current_ptr_);
+    if (is_decimal) {
+      CHECK(absl::SimpleAtod(slice, &token_state_.decimal_val));
+      return TokKind::kDecimal;
+    }
+    return LexInt(slice);
+  }
+
   absl::string_view consumable = StringViewFromPointers(
       token_state_.token_start, buf_.data() + buf_.size());
   static LazyRE2 float_pattern = {
       R"([-]?((\d+|\d+[.]\d*|\d*[.]\d+)([eE][+-]?\d+))|[-]?(\d+[.]\d*|\d*[.]\d+))"};
   if (RE2::Consume(&consumable, *float_pattern)) {
     current_ptr_ = consumable.data();
-    CHECK(absl::SimpleAtod(std::string(token_state_.token_start, current_ptr_),
-                           &token_state_.decimal_val));
+    CHECK(absl::SimpleAtod(
+        StringViewFromPointers(token_state_.token_start, current_ptr_),
+        &token_state_.decimal_val));
     return TokKind::kDecimal;
   }
 
@@ -414,17 +485,8 @@ TokKind HloLexer::LexNumberOrPattern() {
   static LazyRE2 int_pattern = {R"([-]?\d+)"};
   if (RE2::Consume(&consumable, *int_pattern)) {
     current_ptr_ = consumable.data();
-    auto slice = StringViewFromPointers(token_state_.token_start, current_ptr_);
-    if (absl::SimpleAtoi(slice, &token_state_.int64_val)) {
-      return TokKind::kInt;
-    }
-    uint64_t uint64_val;
-    if (absl::SimpleAtoi(slice, &uint64_val)) {
-      token_state_.int64_val = absl::bit_cast<int64_t>(uint64_val);
-      return TokKind::kInt;
-    }
-    LOG(ERROR) << "Failed to parse int literal: " << slice;
-    return TokKind::kError;
+    return LexInt(
+        StringViewFromPointers(token_state_.token_start, current_ptr_));
   }
 
   static LazyRE2 neg_inf = {"-inf"};
@@ -452,6 +514,19 @@ TokKind HloLexer::LexNumberOrPattern() {
   return TokKind::kError;
 }
 
+TokKind HloLexer::LexInt(absl::string_view slice) {
+  if (absl::SimpleAtoi(slice, &token_state_.int64_val)) {
+    return TokKind::kInt;
+  }
+  uint64_t uint64_val;
+  if (absl::SimpleAtoi(slice, &uint64_val)) {
+    token_state_.int64_val = absl::bit_cast<int64_t>(uint64_val);
+    return TokKind::kInt;
+  }
+  LOG(ERROR) << "Failed to parse int literal: " << slice;
+  return TokKind::kError;
+}
+
 std::pair<unsigned, unsigned> HloLexer::GetLineAndColumn(LocTy location) const {
   unsigned line_no = 1;
   const char* start = buf_.data();
@@ -177,6 +177,8 @@ class HloLexer {
   TokKind LexShape();
   TokKind LexConstant();
   TokKind LexNumberOrPattern();
+  // Converts the integer literal 'slice' of the current token.
+  TokKind LexInt(absl::string_view slice);
   TokKind LexString();
 
   std::optional<int64_t> LexNanPayload(absl::string_view& consumable);
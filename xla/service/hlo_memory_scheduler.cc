@@ -24,6 +24,8 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "xla/hlo/ir/dfs_hlo_visitor_with_default.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_opcode.h"
@@ -660,6 +662,115 @@ StatusOr<HloInstructionSequence> DefaultMemoryScheduler(
   }
 }
 
+MemorySchedulerAlgorithm LocalSearchMemoryScheduler(
+    MemorySchedulerAlgorithm base, int64_t max_evaluations,
+    absl::Duration time_budget) {
+  return [base = std::move(base), max_evaluations, time_budget](
+             HloComputation* computation,
+             const TuplePointsToAnalysis& points_to_analysis,
+             const HloAliasAnalysis& alias_analysis,
+             const LogicalBuffer::SizeFunction& size_function,
+             const absl::flat_hash_map<const HloComputation*, int64_t>&
+                 memory_by_computation,
+             const MemorySchedulerPostprocessor& postprocessor,
+             int64_t* peak_memory) -> StatusOr<HloInstructionSequence> {
+    int64_t base_memory;
+    TF_ASSIGN_OR_RETURN(
+        HloInstructionSequence base_sequence,
+        base(computation, points_to_analysis, alias_analysis, size_function,
+             memory_by_computation, postprocessor, &base_memory));
+    const absl::Time deadline = absl::Now() + time_budget;
+    int64_t num_evaluations = 0;
+    auto has_budget = [&] {
+      return num_evaluations < max_evaluations && absl::Now() < deadline;
+    };
+    auto simulate = [&](const HloInstructionSequence& sequence) {
+      ++num_evaluations;
+      return HeapSimulator::MinimumMemoryForComputation(
+          *computation, sequence, alias_analysis, size_function,
+          &memory_by_computation);
+    };
+
+    std::vector<HloInstruction*> order = base_sequence.instructions();
+    int64_t best_memory = base_memory;
+    absl::flat_hash_map<const HloInstruction*, int64_t> position;
+    bool positions_valid = false;
+    bool improved = true;
+    while (improved && has_budget()) {
+      improved = false;
+      for (int64_t i = 0; i < order.size() && has_budget(); ++i) {
+        if (!positions_valid) {
+          position.clear();
+          for (int64_t j = 0; j < order.size(); ++j) {
+            position[order[j]] = j;
+          }
+          positions_valid = true;
+        }
+        // The range of positions the instruction can be moved to without
+        // violating data or control dependencies.
+        const HloInstruction* instruction = order[i];
+        int64_t earliest = 0;
+        int64_t latest = order.size() - 1;
+        for (const HloInstruction* operand : instruction->operands()) {
+          earliest = std::max(earliest, position.at(operand) + 1);
+        }
+        for (const HloInstruction* pred :
+             instruction->control_predecessors()) {
+          earliest = std::max(earliest, position.at(pred) + 1);
+        }
+        for (const HloInstruction* user : instruction->users()) {
+          latest = std::min(latest, position.at(user) - 1);
+        }
+        for (const HloInstruction* succ : instruction->control_successors()) {
+          latest = std::min(latest, position.at(succ) - 1);
+        }
+        for (int64_t target : {earliest, latest}) {
+          if (target == i || !has_budget()) {
+            continue;
+          }
+          std::vector<HloInstruction*> candidate = order;
+          if (target < i) {
+            std::rotate(candidate.begin() + target, candidate.begin() + i,
+                        candidate.begin() + i + 1);
+          } else {
+            std::rotate(candidate.begin() + i, candidate.begin() + i + 1,
+                        candidate.begin() + target + 1);
+          }
+          TF_ASSIGN_OR_RETURN(int64_t memory,
+                              simulate(HloInstructionSequence(candidate)));
+          if (memory < best_memory) {
+            order = std::move(candidate);
+            best_memory = memory;
+            positions_valid = false;
+            improved = true;
+            break;
+          }
+        }
+      }
+    }
+
+    HloInstructionSequence sequence(order);
+    if (postprocessor && best_memory < base_memory) {
+      // Moves may break the constraints enforced by the postprocessor.
+      sequence = postprocessor(sequence);
+      TF_ASSIGN_OR_RETURN(best_memory, simulate(sequence));
+    }
+    VLOG(2) << "Local search refined the peak memory of "
+            << computation->name() << " from "
+            << HumanReadableNumBytes(base_memory) << " to "
+            << HumanReadableNumBytes(best_memory) << " using "
+            << num_evaluations << " simulations";
+    if (best_memory >= base_memory) {
+      best_memory = base_memory;
+      sequence = std::move(base_sequence);
+    }
+    if (peak_memory) {
+      *peak_memory = best_memory;
+    }
+    return sequence;
+  };
+}
+
 StatusOr<HloSchedule> DefaultModuleScheduler(
     const HloModule* module, const TuplePointsToAnalysis& points_to_analysis,
     const HloAliasAnalysis& alias_analysis,
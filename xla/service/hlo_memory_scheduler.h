@@ -17,6 +17,7 @@ limitations under the License.
 #define XLA_SERVICE_HLO_MEMORY_SCHEDULER_H_
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/hlo/ir/hlo_schedule.h"
@@ -106,6 +107,16 @@ StatusOr<HloInstructionSequence> DefaultMemoryScheduler(
         memory_by_computation,
     const MemorySchedulerPostprocessor& postprocessor, int64_t* peak_memory);
 
+// Returns a scheduler that runs `base` and then refines its sequence by local
+// search: single instructions are moved to the earliest or latest position
+// allowed by their dependencies, and a move is kept if it lowers the peak
+// memory according to the HeapSimulator. The search stops at a local minimum,
+// after `max_evaluations` simulated sequences, or once `time_budget` elapsed,
+// whichever comes first. The peak memory never exceeds that of `base`.
+MemorySchedulerAlgorithm LocalSearchMemoryScheduler(
+    MemorySchedulerAlgorithm base, int64_t max_evaluations,
+    absl::Duration time_budget = absl::InfiniteDuration());
+
 StatusOr<HloSchedule> DefaultModuleScheduler(
     const HloModule* module, const TuplePointsToAnalysis& points_to_analysis,
     const HloAliasAnalysis& alias_analysis,
@@ -308,6 +308,57 @@ TEST_F(HloSchedulingTest, MultiOutputFusionAccountedCorrectly) {
   EXPECT_TRUE(ordering.ExecutesBefore(exp, fusion));
 }
 
+TEST_F(HloSchedulingTest, LocalSearchImprovesBaseSchedule) {
+  const char* module_str = R"(
+HloModule test_local_search_module
+
+ENTRY root {
+  param = f32[] parameter(0)
+  early = f32[1000] broadcast(param), dimensions={}
+  temp = f32[1000] broadcast(param), dimensions={}
+  slice = f32[1] slice(temp), slice={[0:1]}
+  ROOT result = (f32[1000], f32[1]) tuple(early, slice)
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+
+  auto size_fn = [](const BufferValue& buffer) {
+    return ShapeUtil::ByteSizeOf(buffer.shape(), /*pointer_size=*/8);
+  };
+  // The post order computes "early" first, which keeps it live while "temp"
+  // is computed.
+  int64_t post_order_memory;
+  TF_ASSERT_OK(ScheduleModule(module.get(), size_fn,
+                              ComputationSchedulerToModuleScheduler(
+                                  PostOrderMemoryScheduler),
+                              /*execution_threads=*/{}, &post_order_memory)
+                   .status());
+
+  int64_t peak_memory;
+  TF_ASSERT_OK_AND_ASSIGN(
+      HloSchedule schedule,
+      ScheduleModule(module.get(), size_fn,
+                     ComputationSchedulerToModuleScheduler(
+                         LocalSearchMemoryScheduler(PostOrderMemoryScheduler,
+                                                    /*max_evaluations=*/100)),
+                     /*execution_threads=*/{}, &peak_memory));
+  TF_ASSERT_OK(module->set_schedule(schedule));
+  TF_ASSERT_OK(module->schedule().Verify());
+  EXPECT_LT(peak_memory, post_order_memory);
+  EXPECT_EQ(PeakMemoryUseOfEntryComputation(module.get(), size_fn),
+            peak_memory);
+
+  absl::flat_hash_map<std::string, const HloInstruction*> instructions_by_name;
+  for (const HloInstruction* instruction :
+       schedule.sequence(module->entry_computation()).instructions()) {
+    instructions_by_name[instruction->name()] = instruction;
+  }
+  SequentialHloOrdering ordering(schedule);
+  EXPECT_TRUE(ordering.ExecutesBefore(instructions_by_name.at("slice"),
+                                      instructions_by_name.at("early")));
+}
+
 TEST_F(HloSchedulingTest, TrivialScheduler) {
   const char* const hlo_string = R"(
 HloModule ModuleWithWhile
@@ -31,6 +31,7 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_instructions.h"
 #include "xla/hlo/ir/hlo_sharding.h"
+#include "xla/literal_util.h"
 #include "xla/service/pattern_matcher.h"
 #include "xla/service/pattern_matcher_gmock.h"
 #include "xla/shape_util.h"
@@ -2751,6 +2752,19 @@ ENTRY %some_2x3x2 () -> f32[2,3,2] {
                   "expects 3 elements in the [0]th element");
 }
 
+TEST_F(HloParserTest, ConstantNumberForms) {
+  const std::string original = R"(
+  HloModule test_module
+  ENTRY test {
+    ROOT c = f32[8] constant({1, -2, 2.5, -.5, 1., 1e3, -1.5E-2, 7
+    })
+  })";
+  TF_ASSERT_OK_AND_ASSIGN(auto module, ParseAndReturnVerifiedModule(original));
+  EXPECT_EQ(module->entry_computation()->root_instruction()->literal(),
+            LiteralUtil::CreateR1<float>(
+                {1, -2, 2.5, -0.5, 1, 1000, -0.015, 7}));
+}
+
 TEST_F(HloParserTest, ConstantF16Overflow) {
   const std::string original =
       R"(HloModule ConstantF16Overflow_module
@@ -55,6 +55,7 @@ class HloPassFix : public Pass {
                          execution_threads) override {
     RunState run_state(module);
     TF_RETURN_IF_ERROR(RunToFixPoint(module, &run_state, execution_threads));
+    RecordIterations(module, run_state.iteration);
     return !run_state.changed.empty();
   }
 
@@ -76,14 +77,28 @@ class HloPassFix : public Pass {
       if (iteration_count == kIterationLimit) {
         VLOG(1) << "Unexpectedly high number of iterations in HLO passes, "
                    "exiting fixed point loop.";
+        for (HloModule* module : module_group->modules()) {
+          RecordIterations(module, iteration_count);
+        }
         // Return false in case this is fixed point is nested.
         return false;
       }
     }
+    for (HloModule* module : module_group->modules()) {
+      RecordIterations(module, iteration_count);
+    }
     return changed;
   }
 
  private:
+  // Records the number of iterations in the metadata of the innermost running
+  // pass, which is this pass when it is run by an HloPassPipeline.
+  static void RecordIterations(HloModule* module, int64_t iterations) {
+    module->metadata()
+        ->set_current_pass_fixed_point_iterations(iterations)
+        .IgnoreError();
+  }
+
   Status RunToFixPoint(
       HloModule* module, RunState* run_state,
       const absl::flat_hash_set<absl::string_view>& execution_threads) {
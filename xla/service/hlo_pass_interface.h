@@ -140,6 +140,9 @@ class HloPassInterface {
       const absl::flat_hash_set<absl::string_view>& execution_threads) = 0;
 
   virtual bool IsPassPipeline() { return false; }
+
+  // Whether the pass is an HloComputationPass.
+  virtual bool IsComputationPass() { return false; }
 };
 
 // Base class for passes which are module-scoped.
@@ -167,6 +170,36 @@ class HloModulePass : public HloPassInterface {
   virtual void UpdateLayout(Shape* shape) {}
 };
 
+// Base class for module-scoped passes which transform each computation on its
+// own. RunOnComputation may modify the computation it is given and read the
+// computations it calls, but must not access any other computation, add or
+// remove computations, or modify module-level state other than by adding
+// instructions. HloPassPipeline relies on this to run such passes on
+// independent computations in parallel when
+// --xla_hlo_pass_pipeline_parallelism is greater than 1.
+class HloComputationPass : public HloModulePass {
+ public:
+  // Runs the pass on `computation`. Returns whether it was changed.
+  virtual StatusOr<bool> RunOnComputation(HloComputation* computation) = 0;
+
+  // Runs the pass on every computation, callees before their callers.
+  using HloPassInterface::Run;
+  StatusOr<bool> Run(HloModule* module,
+                     const absl::flat_hash_set<absl::string_view>&
+                         execution_threads) override {
+    bool changed = false;
+    for (HloComputation* computation :
+         module->MakeComputationPostOrder(execution_threads)) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed,
+                          RunOnComputation(computation));
+      changed |= computation_changed;
+    }
+    return changed;
+  }
+
+  bool IsComputationPass() override { return true; }
+};
+
 // Base class for passes which are module-group scoped. These passes cannot run
 // on an HLO module.
 class HloModuleGroupPass : public HloPassInterface {
@@ -15,22 +15,37 @@ limitations under the License.
 
 #include "xla/service/hlo_pass_pipeline.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "xla/service/dump.h"
 #include "xla/service/hlo_graph_dumper.h"
 #include "xla/service/hlo_proto_util.h"
 #include "xla/status_macros.h"
 #include "xla/types.h"
 #include "xla/util.h"
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/status.h"
+#include "tsl/platform/threadpool.h"
+#include "tsl/profiler/lib/traceme.h"
+#include "tsl/profiler/lib/traceme_encode.h"
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
 
 namespace xla {
 
@@ -121,8 +136,120 @@ void SetInstructionMetadata(HloModuleGroup& module_group) {
   }
 }
 
+// Returns the peak resident set size of the process in bytes, or 0 if the
+// platform doesn't report it.
+int64_t PeakMemoryUsage() {
+#if defined(__linux__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // ru_maxrss is in kilobytes on Linux.
+    return int64_t{usage.ru_maxrss} * 1024;
+  }
+#endif
+  return 0;
+}
+
+int64_t InstructionCount(const HloModule& module) {
+  return module.instruction_count();
+}
+
+int64_t InstructionCount(const HloModuleGroup& module_group) {
+  int64_t count = 0;
+  for (const HloModule* module : module_group.modules()) {
+    count += module->instruction_count();
+  }
+  return count;
+}
+
+// Records the statistics of the currently running pass in the metadata of the
+// module. For module groups, the instruction counts are those of the group.
+void RecordPassStatistics(HloModule& module, int64_t instruction_count_before,
+                          int64_t instruction_count_after,
+                          int64_t peak_memory_delta_bytes) {
+  TF_CHECK_OK(module.metadata()->set_current_pass_instruction_counts(
+      instruction_count_before, instruction_count_after));
+  TF_CHECK_OK(module.metadata()->set_current_pass_peak_memory_delta_bytes(
+      peak_memory_delta_bytes));
+}
+
+void RecordPassStatistics(HloModuleGroup& module_group,
+                          int64_t instruction_count_before,
+                          int64_t instruction_count_after,
+                          int64_t peak_memory_delta_bytes) {
+  for (HloModule* module : module_group.modules()) {
+    RecordPassStatistics(*module, instruction_count_before,
+                         instruction_count_after, peak_memory_delta_bytes);
+  }
+}
+
+// Returns the thread pool computation passes are run on. The pool is shared by
+// all pipelines, and each run bounds the number of threads it uses itself.
+tsl::thread::ThreadPool* GetComputationPassThreadPool() {
+  static tsl::thread::ThreadPool* pool = new tsl::thread::ThreadPool(
+      tsl::Env::Default(), "hlo_pass_pipeline", tsl::port::MaxParallelism());
+  return pool;
+}
+
 }  // namespace
 
+StatusOr<bool> HloPassPipeline::RunComputationPassInParallel(
+    HloComputationPass* pass, HloModule* module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads,
+    int parallelism) {
+  // Group the computations by their height in the call graph, i.e. the length
+  // of the longest chain of calls below them. Callees outside of
+  // `execution_threads` are not visited by the pass and don't count.
+  absl::flat_hash_map<const HloComputation*, int64_t> heights;
+  std::vector<std::vector<HloComputation*>> waves;
+  for (HloComputation* computation :
+       module->MakeComputationPostOrder(execution_threads)) {
+    int64_t height = 0;
+    for (const HloInstruction* instruction : computation->instructions()) {
+      for (const HloComputation* callee : instruction->called_computations()) {
+        auto it = heights.find(callee);
+        if (it != heights.end()) {
+          height = std::max(height, it->second + 1);
+        }
+      }
+    }
+    heights[computation] = height;
+    if (static_cast<int64_t>(waves.size()) <= height) {
+      waves.resize(height + 1);
+    }
+    waves[height].push_back(computation);
+  }
+
+  tsl::thread::ThreadPool* pool = GetComputationPassThreadPool();
+  bool changed = false;
+  for (const std::vector<HloComputation*>& wave : waves) {
+    std::vector<StatusOr<bool>> results(wave.size());
+    if (wave.size() == 1) {
+      results[0] = pass->RunOnComputation(wave[0]);
+    } else {
+      // `num_workers` workers of the shared pool pick the computations in
+      // turn, so one run uses at most `parallelism` threads.
+      const int64_t num_workers =
+          std::min<int64_t>(parallelism, wave.size());
+      std::atomic<int64_t> next = 0;
+      absl::BlockingCounter counter(num_workers);
+      for (int64_t worker = 0; worker < num_workers; ++worker) {
+        pool->Schedule([&] {
+          for (int64_t i = next++; i < wave.size(); i = next++) {
+            results[i] = pass->RunOnComputation(wave[i]);
+          }
+          counter.DecrementCount();
+        });
+      }
+      counter.Wait();
+    }
+    for (StatusOr<bool>& result : results) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed, std::move(result));
+      changed |= computation_changed;
+    }
+  }
+  return changed;
+}
+
 template <typename HloT>
 Status HloPassPipeline::RunInvariantCheckers(
     HloT* hlo, absl::string_view after_pass_name,
@@ -181,6 +308,12 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
     if (!pass->IsPassPipeline()) {
       compilation_stats_->StartPass(pass_name);
     }
+    tsl::profiler::TraceMe trace([&] {
+      return tsl::profiler::TraceMeEncode(absl::StrCat("HloPass:", pass_name),
+                                          {{"pipeline", pipeline_name}});
+    });
+    const int64_t instruction_count_before = InstructionCount(*hlo);
+    const int64_t peak_memory_before = PeakMemoryUsage();
     RecordPassStartMetadata(*hlo, pass_name, pipeline_name);
     // Embed RunHelper into lambda to enable recording of error statuses
     auto run_helper_lambda =
@@ -204,6 +337,17 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
                                        ? kPipelineEnd
                                        : passes[i + 1]->name());
     }
+    const int64_t instruction_count_after = InstructionCount(*hlo);
+    const int64_t peak_memory_delta = PeakMemoryUsage() - peak_memory_before;
+    RecordPassStatistics(*hlo, instruction_count_before,
+                         instruction_count_after, peak_memory_delta);
+    trace.AppendMetadata([&] {
+      return tsl::profiler::TraceMeEncode(
+          {{"changed", pass_changed},
+           {"instructions_before", instruction_count_before},
+           {"instructions_after", instruction_count_after},
+           {"peak_memory_delta_bytes", peak_memory_delta}});
+    });
     RecordPassEndMetadata(*hlo, pass_name, pass_changed);
     changed |= pass_changed;
     if (pass_changed) {
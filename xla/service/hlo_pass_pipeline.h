@@ -129,6 +129,17 @@ class HloPassPipeline : public HloPassInterface {
       HloT* hlo, const DebugOptions& debug_options,
       const absl::flat_hash_set<absl::string_view>& execution_threads);
 
+  // Runs `pass` on the computations of `module` using up to `parallelism`
+  // threads. Computations are processed in waves of increasing call graph
+  // height: a computation is only visited once every computation it calls has
+  // been, and computations in the same wave never call each other, so the
+  // result matches a serial run in post order. Note that instructions created
+  // concurrently may be assigned names and unique ids in a different order.
+  static StatusOr<bool> RunComputationPassInParallel(
+      HloComputationPass* pass, HloModule* module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads,
+      int parallelism);
+
   // Helpers which run the given passes on the given HLO construct. Only
   // computations with specified `execution_threads` are considered by the pass,
   // empty thread list means all `execution_threads` are considered. These
@@ -137,7 +148,18 @@ class HloPassPipeline : public HloPassInterface {
   static StatusOr<bool> RunHelper(
       HloPassInterface* pass, HloModule* module,
       const absl::flat_hash_set<absl::string_view>& execution_threads) {
-    TF_ASSIGN_OR_RETURN(bool changed, pass->Run(module, execution_threads));
+    int parallelism =
+        module->config().debug_options().xla_hlo_pass_pipeline_parallelism();
+    bool changed;
+    if (pass->IsComputationPass() && parallelism > 1 &&
+        !module->has_schedule()) {
+      TF_ASSIGN_OR_RETURN(
+          changed, RunComputationPassInParallel(
+                       static_cast<HloComputationPass*>(pass), module,
+                       execution_threads, parallelism));
+    } else {
+      TF_ASSIGN_OR_RETURN(changed, pass->Run(module, execution_threads));
+    }
     module->Cleanup();
     return changed;
   }
@@ -18,6 +18,9 @@ limitations under the License.
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_cse.h"
+#include "xla/service/hlo_dce.h"
+#include "xla/service/hlo_pass_fix.h"
 #include "xla/service/hlo_parser.h"
 #include "xla/tests/hlo_test_base.h"
 #include "xla/util.h"
@@ -400,5 +403,102 @@ TEST_F(HloPassPipelineTest, SetHloModuleMetadata) {
   }
 }
 
+TEST_F(HloPassPipelineTest, RecordsPassStatistics) {
+  const std::string module_str = R"(
+HloModule RecordsPassStatistics
+
+ENTRY main {
+  a = f32[] parameter(0)
+  dead = f32[] negate(a)
+  ROOT foo = f32[] add(a, a)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  HloPassPipeline pipeline(TestName());
+  pipeline.AddPass<HloPassFix<HloDCE>>();
+  pipeline.AddPass<FooToBarModulePass>();
+  TF_ASSERT_OK(pipeline.Run(module.get()).status());
+
+  const HloModuleMetadataProto& metadata = module->metadata()->proto();
+  ASSERT_THAT(metadata.pass_metadata(), SizeIs(3));
+  const HloPassMetadata& dce = metadata.pass_metadata(1);
+  EXPECT_THAT(dce.pass_name(), StrEq("dce"));
+  EXPECT_EQ(dce.instruction_count_before(), 3);
+  EXPECT_EQ(dce.instruction_count_after(), 2);
+  // The first iteration removes `dead`, the second one changes nothing.
+  EXPECT_EQ(dce.fixed_point_iterations(), 2);
+  EXPECT_GE(dce.peak_memory_delta_bytes(), 0);
+
+  const HloPassMetadata& foo2bar = metadata.pass_metadata(2);
+  EXPECT_THAT(foo2bar.pass_name(), StrEq("foo2bar"));
+  EXPECT_EQ(foo2bar.instruction_count_before(), 2);
+  EXPECT_EQ(foo2bar.instruction_count_after(), 2);
+  EXPECT_EQ(foo2bar.fixed_point_iterations(), 0);
+}
+
+TEST_F(HloPassPipelineTest, ParallelComputationPassMatchesSerialRun) {
+  const std::string module_str = R"(
+HloModule ParallelComputationPass
+
+add {
+  x = f32[] parameter(0)
+  y = f32[] parameter(1)
+  ROOT add = f32[] add(x, y)
+}
+
+body_a {
+  p = f32[4] parameter(0)
+  c0 = f32[] constant(1)
+  c1 = f32[] constant(1)
+  r = f32[] reduce(p, c0), dimensions={0}, to_apply=add
+  s = f32[] reduce(p, c1), dimensions={0}, to_apply=add
+  b = f32[4] broadcast(r), dimensions={}
+  ROOT sum = f32[4] add(p, b)
+}
+
+body_b {
+  p = f32[4] parameter(0)
+  n0 = f32[4] negate(p)
+  n1 = f32[4] negate(p)
+  ROOT sum = f32[4] add(n0, n1)
+}
+
+cond {
+  p = f32[4] parameter(0)
+  ROOT c = pred[] constant(false)
+}
+
+ENTRY main {
+  p0 = f32[4] parameter(0)
+  w0 = f32[4] while(p0), condition=cond, body=body_a
+  w1 = f32[4] while(w0), condition=cond, body=body_b
+  e0 = f32[4] exponential(w1)
+  e1 = f32[4] exponential(w1)
+  ROOT sum = f32[4] add(e0, e1)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> serial_module,
+                          ParseAndReturnVerifiedModule(module_str));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> parallel_module,
+                          ParseAndReturnVerifiedModule(module_str));
+  DebugOptions debug_options = parallel_module->config().debug_options();
+  debug_options.set_xla_hlo_pass_pipeline_parallelism(4);
+  parallel_module->mutable_config().set_debug_options(debug_options);
+
+  HloPassPipeline serial_pipeline(TestName());
+  serial_pipeline.AddPass<HloCSE>(/*is_layout_sensitive=*/false);
+  TF_ASSERT_OK_AND_ASSIGN(bool serial_changed,
+                          serial_pipeline.Run(serial_module.get()));
+  HloPassPipeline parallel_pipeline(TestName());
+  parallel_pipeline.AddPass<HloCSE>(/*is_layout_sensitive=*/false);
+  TF_ASSERT_OK_AND_ASSIGN(bool parallel_changed,
+                          parallel_pipeline.Run(parallel_module.get()));
+
+  EXPECT_TRUE(serial_changed);
+  EXPECT_EQ(serial_changed, parallel_changed);
+  EXPECT_EQ(serial_module->ToString(), parallel_module->ToString());
+}
+
 }  // namespace
 }  // namespace xla
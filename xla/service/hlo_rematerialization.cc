@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/hlo_rematerialization.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <iterator>
 #include <limits>
@@ -854,6 +855,9 @@ class MemoryUsageTracker {
 
   // All buffers in the computation.
   std::vector<Buffer> buffers_;
+
+  // Estimated time to execute the computation once, from the cost analysis.
+  float computation_seconds_ = 0.0f;
 };
 
 MemoryUsageTracker::MemoryUsageTracker(
@@ -927,6 +931,8 @@ MemoryUsageTracker::MemoryUsageTracker(
       item->buffers_output.push_back(
           logical_buffer_to_buffer_id[logical_buffer]);
     }
+    computation_seconds_ += std::max(
+        0.0f, options_.hlo_cost_analysis.optimal_seconds(*instruction));
   }
   XLA_VLOG_LINES(10, ToString());
   DCHECK(Check());
@@ -1820,8 +1826,8 @@ std::optional<int64_t> MemoryUsageTracker::GetCostOfHostOffload(
           << time_spent_before_next_use
           << ") between itself and next use. The memcpy out and back will take "
           << time_spent_on_copies << "s";
-  // TODO(b/293323448): Properly calculate a cost; this cost metric is not
-  // useful.
+  // The copies are completely hidden, so offloading doesn't add to the step
+  // time and the cost is only the inverse of the memory benefit.
   return memory_limit_bytes / bytes_used_by_buffers;
 }
 
@@ -1850,8 +1856,23 @@ std::optional<int64_t> MemoryUsageTracker::GetCostOfRecompute(
     return {};
   }
 
-  return RematerializationCost(candidate_items, memory_reduced,
-                               memory_limit_bytes);
+  int64_t cost = RematerializationCost(candidate_items, memory_reduced,
+                                       memory_limit_bytes);
+  if (!options_.remat_mode_config.host_offload || cost == 0 ||
+      computation_seconds_ <= 0.0f) {
+    return cost;
+  }
+  // With host offload enabled, recomputation competes with an option that
+  // doesn't add to the step time. Scale the cost by the fraction of the step
+  // time spent recomputing, so that expensive blocks (e.g. attention) are
+  // offloaded rather than recomputed when both free the same memory.
+  float recompute_seconds = 0.0f;
+  for (const Item* item : candidate_items) {
+    recompute_seconds += std::max(
+        0.0f, options_.hlo_cost_analysis.optimal_seconds(*item->instruction));
+  }
+  return cost + static_cast<int64_t>(std::ceil(
+                    cost * recompute_seconds / computation_seconds_));
 }
 
 std::tuple<std::vector<Item*>, RematStrategy, int>
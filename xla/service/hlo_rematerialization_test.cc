@@ -1230,7 +1230,7 @@ class OffloadingRematerializationTest : public RematerializationTestBase {
         transcendentals_per_second_);
     HloCostAnalysis cost_analysis(hlo_cost_analysis_options);
     HloRematerialization::RematerializationModeConfig config(
-        /*recompute=*/false, /*compress=*/false, /*host_offload=*/true);
+        /*recompute=*/recompute_, /*compress=*/false, /*host_offload=*/true);
     HloRematerialization::HostMemoryOffloadConfig host_memory_offload_config(
         kHostMemorySpaceColor, copy_to_host_speed_, copy_from_host_speed_);
     HloRematerialization::Options options(
@@ -1242,6 +1242,7 @@ class OffloadingRematerializationTest : public RematerializationTestBase {
     HloRematerialization remat(options, sizes);
     return remat.Run(module);
   }
+  void SetRecompute(bool val) { recompute_ = val; }
   void SetCopyToHostSpeed(float val) { copy_to_host_speed_ = val; }
   void SetCopyFromHostSpeed(float val) { copy_from_host_speed_ = val; }
   void SetFlopsPerSecond(float val) { flops_per_second_ = val; }
@@ -1252,6 +1253,7 @@ class OffloadingRematerializationTest : public RematerializationTestBase {
   static constexpr const int64_t kHostMemorySpaceColor{5};
 
  private:
+  bool recompute_{false};
   float copy_to_host_speed_{1.0f};
   float copy_from_host_speed_{1.0f};
   float flops_per_second_{1.0f};
@@ -1319,6 +1321,52 @@ ENTRY MyModule {
               op::Tanh(res_10_matcher));
 }
 
+TEST_F(OffloadingRematerializationTest, PrefersHiddenOffloadOverRecompute) {
+  const std::string& hlo_string = R"(
+HloModule MyModule, is_scheduled=true, entry_computation_layout={(f32[1024]{0}, f32[1024]{0})->f32[1024]{0}}
+
+ENTRY MyModule {
+  param_0 = f32[1024]{0} parameter(0)
+  param_1 = f32[1024]{0} parameter(1)
+  res_3 = f32[1024]{0} add(param_0, param_1)
+  res_4 = f32[1024]{0} tanh(res_3)
+  res_5 = f32[1024]{0} tanh(res_4)
+  res_6 = f32[1024]{0} tanh(res_5)
+  res_7 = f32[1024]{0} add(res_6, res_6)
+  res_8 = f32[1024]{0} add(res_7, res_5)
+  res_9 = f32[1024]{0} add(res_8, res_4)
+  res_10 = f32[1024]{0} add(res_9, res_3)
+  ROOT res_11 = f32[1024]{0} tanh(res_10)
+}
+)";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+
+  // Recomputing the tanh takes time, while the copies to and from the host
+  // are completely hidden, so offloading is preferred.
+  SetRecompute(true);
+  SetCopyToHostSpeed(4.0 * 1024);
+  SetCopyFromHostSpeed(4.0 * 1024);
+  SetFlopsPerSecond(2 * 1024);
+  SetTranscendentalsPerSecond(2 * 1024);
+
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloRematerialization(
+                              /*memory_limit_bytes=*/10 * 1024, module.get()));
+  ASSERT_TRUE(changed);
+
+  auto res_3_matcher = op::Add(op::Parameter(), op::Parameter());
+  auto res_4_matcher = op::Tanh(res_3_matcher);
+  auto res_4_rematted_matcher = op::AsyncCopy(
+      xla::Layout::kDefaultMemorySpace, kHostMemorySpaceColor,
+      op::AsyncCopy(kHostMemorySpaceColor, xla::Layout::kDefaultMemorySpace,
+                    res_4_matcher));
+  const HloInstruction* res_9 = FindInstruction(module.get(), "res_9");
+  ASSERT_NE(res_9, nullptr);
+  EXPECT_THAT(res_9->operand(1), res_4_rematted_matcher);
+}
+
 TEST_F(OffloadingRematerializationTest, SkipOffloadWhenBitcastIsInvolved) {
   const std::string& hlo_string = R"(
 HloModule MyModule, is_scheduled=true, entry_computation_layout={(f32[1024]{0}, f32[1024]{0})->f32[1024]{0}}
@@ -34,6 +34,13 @@ limitations under the License.
 #include "tsl/platform/logging.h"
 
 namespace xla {
+namespace {
+
+// Maximum number of streams used to transfer the arrays of a tuple-shaped
+// literal to the device.
+constexpr int kMaxTransferStreams = 4;
+
+}  // namespace
 
 HloRunner::HloRunner(se::Platform* platform, int intra_op_parallelism_threads) {
   BackendOptions backend_options;
@@ -84,8 +91,10 @@ StatusOr<ScopedShapedBuffer> HloRunner::TransferLiteralToDevice(
           backend().default_device_ordinal(), shape_representation_fn));
   TF_ASSIGN_OR_RETURN(
       auto stream, backend().BorrowStream(backend().default_stream_executor()));
-  TF_RETURN_IF_ERROR(backend().transfer_manager()->TransferLiteralToDevice(
-      stream.get(), literal, buffer));
+  TF_RETURN_IF_ERROR(
+      backend().transfer_manager()->TransferLiteralToDeviceMultiStreamAsync(
+          stream.get(), literal, buffer, kMaxTransferStreams));
+  TF_RETURN_IF_ERROR(stream->BlockHostUntilDone());
   return std::move(buffer);
 }
 
@@ -0,0 +1,61 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/hlo_structural_hasher.h"
+
+#include <cstddef>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
+
+namespace xla {
+
+size_t HloStructuralHasher::Hash(const HloComputation* computation) {
+  auto it = computation_hashes_.find(computation);
+  if (it != computation_hashes_.end()) {
+    return it->second;
+  }
+  absl::flat_hash_map<const HloInstruction*, size_t> instruction_hashes;
+  instruction_hashes.reserve(computation->instruction_count());
+  for (const HloInstruction* instruction :
+       computation->MakeInstructionPostOrder()) {
+    size_t hash = absl::HashOf(*instruction);
+    for (const HloInstruction* operand : instruction->operands()) {
+      hash = absl::HashOf(hash, instruction_hashes.at(operand));
+    }
+    if (instruction->opcode() == HloOpcode::kParameter) {
+      hash = absl::HashOf(hash, instruction->parameter_number());
+    }
+    hash = absl::HashOf(hash, HashCalledComputations(instruction));
+    instruction_hashes[instruction] = hash;
+  }
+  size_t hash = instruction_hashes.at(computation->root_instruction());
+  computation_hashes_[computation] = hash;
+  return hash;
+}
+
+size_t HloStructuralHasher::HashCalledComputations(
+    const HloInstruction* instruction) {
+  size_t hash = instruction->called_computations().size();
+  for (const HloComputation* called : instruction->called_computations()) {
+    hash = absl::HashOf(hash, Hash(called));
+  }
+  return hash;
+}
+
+}  // namespace xla
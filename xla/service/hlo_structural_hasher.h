@@ -0,0 +1,48 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_HLO_STRUCTURAL_HASHER_H_
+#define XLA_SERVICE_HLO_STRUCTURAL_HASHER_H_
+
+#include <cstddef>
+
+#include "absl/container/flat_hash_map.h"
+#include "xla/hlo/ir/hlo_computation.h"
+
+namespace xla {
+
+// Computes structural hashes of computations: the hash of an instruction
+// combines its own properties with the hashes of its operands and called
+// computations, and the hash of a computation is the hash of its root.
+// Computations that compare equal with HloComputation::operator== have the
+// same hash, so the hash can rule out most pairs before comparing them.
+//
+// Hashes are memoized, so each computation is hashed once even if it's called
+// from many places. The hasher must not outlive changes to the computations
+// it hashed; passes use one per run, or per computation they mutate.
+class HloStructuralHasher {
+ public:
+  size_t Hash(const HloComputation* computation);
+
+  // Combines the hashes of the computations called by `instruction`.
+  size_t HashCalledComputations(const HloInstruction* instruction);
+
+ private:
+  absl::flat_hash_map<const HloComputation*, size_t> computation_hashes_;
+};
+
+}  // namespace xla
+
+#endif  // XLA_SERVICE_HLO_STRUCTURAL_HASHER_H_
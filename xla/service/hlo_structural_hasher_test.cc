@@ -0,0 +1,94 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/hlo_structural_hasher.h"
+
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/tests/hlo_test_base.h"
+
+namespace xla {
+namespace {
+
+using HloStructuralHasherTest = HloTestBase;
+
+TEST_F(HloStructuralHasherTest, EqualComputationsHaveEqualHashes) {
+  auto module = ParseAndReturnVerifiedModule(R"(
+    HloModule test
+
+    add_a {
+      x = f32[] parameter(0)
+      y = f32[] parameter(1)
+      ROOT add = f32[] add(x, y)
+    }
+
+    add_b {
+      lhs = f32[] parameter(0)
+      rhs = f32[] parameter(1)
+      ROOT sum = f32[] add(lhs, rhs)
+    }
+
+    add_swapped {
+      x = f32[] parameter(1)
+      y = f32[] parameter(0)
+      ROOT add = f32[] add(x, y)
+    }
+
+    body_a {
+      p = f32[8] parameter(0)
+      c = f32[] constant(0)
+      r = f32[] reduce(p, c), dimensions={0}, to_apply=add_a
+      ROOT b = f32[8] broadcast(r), dimensions={}
+    }
+
+    body_b {
+      p = f32[8] parameter(0)
+      c = f32[] constant(0)
+      r = f32[] reduce(p, c), dimensions={0}, to_apply=add_b
+      ROOT b = f32[8] broadcast(r), dimensions={}
+    }
+
+    ENTRY entry {
+      p = f32[8] parameter(0)
+      a = f32[8] call(p), to_apply=body_a
+      b = f32[8] call(a), to_apply=body_b
+      c = f32[] constant(0)
+      ROOT r = f32[] reduce(b, c), dimensions={0}, to_apply=add_swapped
+    })")
+                    .value();
+  HloStructuralHasher hasher;
+  auto hash = [&](absl::string_view name) {
+    return hasher.Hash(FindComputation(module.get(), name));
+  };
+  EXPECT_EQ(hash("add_a"), hash("add_b"));
+  EXPECT_EQ(hash("body_a"), hash("body_b"));
+  // Parameter numbers are part of the structure.
+  EXPECT_NE(hash("add_a"), hash("add_swapped"));
+  EXPECT_NE(hash("body_a"), hash("add_a"));
+
+  // Hashes are memoized, and don't depend on the hasher.
+  EXPECT_EQ(hash("body_a"), HloStructuralHasher().Hash(
+                                FindComputation(module.get(), "body_a")));
+
+  const HloInstruction* call_a =
+      module->entry_computation()->GetInstructionWithName("a");
+  const HloInstruction* call_b =
+      module->entry_computation()->GetInstructionWithName("b");
+  EXPECT_EQ(hasher.HashCalledComputations(call_a),
+            hasher.HashCalledComputations(call_b));
+}
+
+}  // namespace
+}  // namespace xla
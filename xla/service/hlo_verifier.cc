@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/hlo_verifier.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -48,7 +49,11 @@ limitations under the License.
 #include "xla/status_macros.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/blocking_counter.h"
+#include "tsl/platform/cpu_info.h"
+#include "tsl/platform/env.h"
 #include "tsl/platform/errors.h"
+#include "tsl/platform/threadpool.h"
 
 namespace xla {
 
@@ -2726,15 +2731,6 @@ class InstructionVerifier : public DfsHloVisitorWithDefault {
   }
 
   Status Preprocess(HloInstruction* instruction) override {
-    auto [it, inserted] =
-        instructions_by_name_.emplace(instruction->name(), instruction);
-    TF_RET_CHECK(inserted) << "HLO has name that is not unique within module:\n"
-                           << instruction->ToString() << " in computation: "
-                           << instruction->parent()->name()
-                           << "\nPrevious HLO with same name:\n"
-                           << it->second->ToString() << " in computation: "
-                           << it->second->parent()->name();
-
     if (instruction->has_sharding()) {
       Status status =
           instruction->sharding().Validate(instruction->shape(), num_devices_);
@@ -2830,13 +2826,104 @@ class InstructionVerifier : public DfsHloVisitorWithDefault {
     return OkStatus();
   }
 
-  absl::flat_hash_map<std::string, const HloInstruction*> instructions_by_name_;
   const HloVerifierOpts& opts_;
   std::optional<int64_t> num_devices_;
 };
 
+// Checks that instruction names are unique within the module. This is the only
+// instruction check that needs module-wide state, so it runs serially before
+// the per-computation verifiers.
+Status VerifyInstructionNamesAreUnique(
+    const HloModule& module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  absl::flat_hash_map<absl::string_view, const HloInstruction*>
+      instructions_by_name;
+  for (const HloComputation* computation :
+       module.computations(execution_threads)) {
+    for (const HloInstruction* instruction : computation->instructions()) {
+      auto [it, inserted] =
+          instructions_by_name.emplace(instruction->name(), instruction);
+      TF_RET_CHECK(inserted)
+          << "HLO has name that is not unique within module:\n"
+          << instruction->ToString()
+          << " in computation: " << instruction->parent()->name()
+          << "\nPrevious HLO with same name:\n"
+          << it->second->ToString()
+          << " in computation: " << it->second->parent()->name();
+    }
+  }
+  return OkStatus();
+}
+
+// Runs the shape and instruction verifiers over a single computation. Every
+// call uses fresh visitors, so computations can be verified concurrently.
+Status VerifyComputation(const HloModule& module, HloComputation* computation,
+                         const TargetVerifierMetadata& target_metadata) {
+  std::unique_ptr<ShapeVerifier> shape_verifier = target_metadata.GetVerifier();
+  InstructionVerifier instruction_verifier(&module,
+                                           target_metadata.GetVerifierOpts());
+  TF_RETURN_IF_ERROR(computation->Accept(shape_verifier.get()));
+  TF_RETURN_IF_ERROR(computation->Accept(&instruction_verifier));
+  if (computation->IsAsyncComputation()) {
+    TF_RETURN_IF_ERROR(VerifyAsyncComputation(computation));
+  }
+  return OkStatus();
+}
+
+// Returns the thread pool shared by all verifiers. The verifier runs after
+// every pass of every pipeline, so it is created once for the process.
+tsl::thread::ThreadPool* GetVerifierThreadPool() {
+  static tsl::thread::ThreadPool* thread_pool = new tsl::thread::ThreadPool(
+      tsl::Env::Default(), "hlo_verifier", tsl::port::MaxParallelism());
+  return thread_pool;
+}
+
 }  // namespace
 
+Status HloVerifier::VerifyComputations(
+    const HloModule& module,
+    const absl::flat_hash_set<absl::string_view>& execution_threads) {
+  std::vector<HloComputation*> computations;
+  for (HloComputation* computation : module.computations(execution_threads)) {
+    computations.push_back(computation);
+  }
+  const int64_t parallelism = std::min<int64_t>(
+      target_metadata_->GetVerifierOpts().verify_parallelism,
+      computations.size());
+  if (parallelism <= 1) {
+    for (HloComputation* computation : computations) {
+      TF_RETURN_IF_ERROR(
+          VerifyComputation(module, computation, *target_metadata_));
+    }
+    return OkStatus();
+  }
+
+  // Every computation is verified, and the error of the first failing one in
+  // module order is reported, so the result doesn't depend on scheduling.
+  // `parallelism` workers of the shared pool pick the computations in turn,
+  // so one verifier uses at most `verify_parallelism` threads.
+  std::vector<Status> statuses(computations.size());
+  std::atomic<int64_t> next_computation = 0;
+  {
+    tsl::BlockingCounter counter(parallelism);
+    for (int64_t i = 0; i < parallelism; ++i) {
+      GetVerifierThreadPool()->Schedule([&] {
+        for (int64_t j = next_computation++; j < computations.size();
+             j = next_computation++) {
+          statuses[j] =
+              VerifyComputation(module, computations[j], *target_metadata_);
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  for (const Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return OkStatus();
+}
+
 StatusOr<bool> HloVerifier::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
@@ -2856,18 +2943,12 @@ StatusOr<bool> HloVerifier::Run(
     TF_RETURN_IF_ERROR(VerifyAsynchronousInstructionPairs(*module));
     TF_RETURN_IF_ERROR(VerifyChannels(*module));
 
+    TF_RETURN_IF_ERROR(
+        VerifyInstructionNamesAreUnique(*module, execution_threads));
+    TF_RETURN_IF_ERROR(VerifyComputations(*module, execution_threads));
+
     std::unique_ptr<ShapeVerifier> shape_verifier =
         target_metadata_->GetVerifier();
-    InstructionVerifier instruction_verifier(
-        module, target_metadata_->GetVerifierOpts());
-    for (auto* computation : module->computations(execution_threads)) {
-      TF_RETURN_IF_ERROR(computation->Accept(shape_verifier.get()));
-      TF_RETURN_IF_ERROR(computation->Accept(&instruction_verifier));
-      if (computation->IsAsyncComputation()) {
-        TF_RETURN_IF_ERROR(VerifyAsyncComputation(computation));
-      }
-    }
-
     TF_RETURN_IF_ERROR(shape_verifier->VerifyEntryComputationLayout(*module));
     TF_RETURN_IF_ERROR(VerifyEntryAndExitShapes(*module));
 
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_HLO_VERIFIER_H_
 #define XLA_SERVICE_HLO_VERIFIER_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -87,6 +88,11 @@ struct HloVerifierOpts {
     return std::move(*this);
   }
 
+  HloVerifierOpts&& WithVerifyParallelism(int64_t parallelism) {
+    verify_parallelism = parallelism;
+    return std::move(*this);
+  }
+
   bool IsLayoutSensitive() const { return layout_sensitive; }
 
   bool AllowMixedPrecision() const { return allow_mixed_precision; }
@@ -127,6 +133,11 @@ struct HloVerifierOpts {
   // Whether bitcast should have the same size, including all paddings.
   bool allow_bitcast_to_have_different_size = false;
 
+  // Maximum number of computations that are verified concurrently. Values
+  // above 1 require `instruction_can_change_layout` and `shape_size` to be
+  // thread-safe.
+  int64_t verify_parallelism = 1;
+
   HloPredicate instruction_can_change_layout;
 
   // Returns a target-specific shape size.
@@ -383,6 +394,12 @@ class HloVerifier : public HloModulePass {
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
 
  private:
+  // Runs the per-computation shape and instruction checks, using up to
+  // `verify_parallelism` threads.
+  Status VerifyComputations(
+      const HloModule& module,
+      const absl::flat_hash_set<absl::string_view>& execution_threads);
+
   // Owns verifier config.
   std::unique_ptr<TargetVerifierMetadata> target_metadata_;
 
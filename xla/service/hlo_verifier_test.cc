@@ -208,6 +208,42 @@ TEST_F(HloVerifierTest, CheckCallThreadMismatch) {
                         "computation's thread name"));
 }
 
+TEST_F(HloVerifierTest, ParallelVerificationMatchesSerialVerification) {
+  const char* const hlo_string = R"(
+  HloModule Module
+
+  callee_a {
+    pa = f32[4] parameter(0)
+    ROOT adda = f32[3] add(pa, pa)
+  }
+
+  callee_b {
+    pb = f32[4] parameter(0)
+    ROOT addb = f32[2] add(pb, pb)
+  }
+
+  ENTRY entry {
+    p0 = f32[4] parameter(0)
+    calla = f32[3] call(p0), to_apply=callee_a
+    callb = f32[2] call(p0), to_apply=callee_b
+    ROOT tuple = (f32[3], f32[2]) tuple(calla, callb)
+  }
+  )";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnUnverifiedModule(hlo_string));
+
+  HloVerifier serial_verifier(HloVerifierOpts{});
+  HloVerifier parallel_verifier(HloVerifierOpts{}.WithVerifyParallelism(4));
+  auto serial_status = serial_verifier.Run(module.get()).status();
+  ASSERT_FALSE(serial_status.ok());
+  // Run twice to also cover the reused thread pool.
+  for (int i = 0; i < 2; ++i) {
+    auto parallel_status = parallel_verifier.Run(module.get()).status();
+    ASSERT_FALSE(parallel_status.ok());
+    EXPECT_EQ(parallel_status.message(), serial_status.message());
+  }
+}
+
 TEST_F(HloVerifierTest, CheckConditionalOperandParameterShapesMismatch) {
   const char* const hlo_string = R"(
   HloModule Module
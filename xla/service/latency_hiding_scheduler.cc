@@ -497,6 +497,8 @@ void MemoryPressureTracker::Initialize(
   output_buffers_.clear();
   defined_buffers_.clear();
   live_buffers_set_.clear();
+  pressure_difference_cache_.clear();
+  pressure_difference_readers_.clear();
   for (auto* instruction : computation->instructions()) {
     auto& output_values = this->output_buffers_[instruction];
     auto& defined_values = this->defined_buffers_[instruction];
@@ -552,6 +554,7 @@ void MemoryPressureTracker::UpdateBuffers(const HloInstruction* instruction) {
         live_buffers_[info.first.value->id()] = 1;
         live_buffers_set_.insert(info.first.value->id());
         live_memory_usage_ += info.first.buffer_size;
+        InvalidatePressureDifferences(info.first.value->id());
       }
     }
   }
@@ -575,6 +578,10 @@ void MemoryPressureTracker::UpdateBuffers(const HloInstruction* instruction) {
 // scheduled.
 std::pair<int64_t, int64_t> MemoryPressureTracker::MemoryPressureDifference(
     const HloInstruction* instruction) const {
+  auto cached = pressure_difference_cache_.find(instruction);
+  if (cached != pressure_difference_cache_.end()) {
+    return cached->second;
+  }
   int64_t increase = 0;
   int64_t peak = 0;
   // Compute peak increase produced by called computations.
@@ -601,6 +608,8 @@ std::pair<int64_t, int64_t> MemoryPressureTracker::MemoryPressureDifference(
       }
       if (!live_buffers_[b.first.value->id()]) {
         increase += b.first.buffer_size;
+        pressure_difference_readers_[b.first.value->id()].push_back(
+            instruction);
       }
     }
   }
@@ -614,10 +623,24 @@ std::pair<int64_t, int64_t> MemoryPressureTracker::MemoryPressureDifference(
         if (b.first_definition == instruction) {
           increase -= b.buffer_size;
         }
+      } else {
+        pressure_difference_readers_[b.value->id()].push_back(instruction);
       }
     }
   }
-  return std::make_pair(increase, peak);
+  return pressure_difference_cache_[instruction] =
+             std::make_pair(increase, peak);
+}
+
+void MemoryPressureTracker::InvalidatePressureDifferences(HloBuffer::Id id) {
+  auto it = pressure_difference_readers_.find(id);
+  if (it == pressure_difference_readers_.end()) {
+    return;
+  }
+  for (const HloInstruction* reader : it->second) {
+    pressure_difference_cache_.erase(reader);
+  }
+  pressure_difference_readers_.erase(it);
 }
 
 DefaultSchedulerCore::ScheduleCandidate InitializeCandidate(
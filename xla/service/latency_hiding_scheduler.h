@@ -595,6 +595,9 @@ class MemoryPressureTracker {
     }
     return false;
   }
+  // Drops the memoized pressure differences that depend on the liveness of
+  // buffer 'id', after it became live.
+  void InvalidatePressureDifferences(HloBuffer::Id id);
   static bool ShouldSkipBufferReleases(const HloInstruction* instruction) {
     // Make GetTupleElement/kBitcast make alive only the tuple pointer if not
     // array shape.
@@ -627,6 +630,17 @@ class MemoryPressureTracker {
   // the user of this class.
   const absl::flat_hash_map<const HloComputation*, MemoryPressureState>&
       pressure_state_cache_;
+  // Memoized results of MemoryPressureDifference(). Buffers only become live
+  // while a computation is scheduled, so a result stays valid until one of the
+  // buffers it found dead becomes live.
+  mutable absl::flat_hash_map<const HloInstruction*,
+                              std::pair<int64_t, int64_t>>
+      pressure_difference_cache_;
+  // The instructions whose memoized pressure difference depends on each buffer
+  // that is not live yet.
+  mutable absl::flat_hash_map<HloBuffer::Id,
+                              std::vector<const HloInstruction*>>
+      pressure_difference_readers_;
   // Current memory usage delta from the initial memory of the computation.
   int64_t live_memory_usage_;
   // Initial memory pressure at the bottom of the computation.
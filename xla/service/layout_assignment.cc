@@ -548,6 +548,50 @@ const BufferLayoutConstraint* LayoutAssignment::GetBufferLayoutConstraint(
   return it == buffer_constraints_.end() ? nullptr : &it->second;
 }
 
+double LayoutAssignment::LayoutChangeCost(const HloInstruction* instruction,
+                                          const Layout& layout) const {
+  const HloInstruction* current = instruction;
+  Layout current_layout = layout;
+  while (current->shape().IsArray()) {
+    auto buffer = points_to_analysis_->GetBufferDefinedAt(current, {});
+    if (!buffer.ok()) {
+      return 0;
+    }
+    if (const BufferLayoutConstraint* constraint =
+            GetBufferLayoutConstraint(**buffer)) {
+      return Layout::Equal().MinorToMajorOnly()(constraint->layout(),
+                                                current_layout)
+                 ? 0
+                 : CopyCost(current->shape());
+    }
+    if (current->opcode() == HloOpcode::kCopy) {
+      return 0;
+    }
+    if (current != instruction && current->user_count() > 1) {
+      // The other users may want other layouts, so assume the default one.
+      return Layout::Equal().MinorToMajorOnly()(
+                 LayoutUtil::GetDefaultLayoutForShape(current->shape()),
+                 current_layout)
+                 ? 0
+                 : CopyCost(current->shape());
+    }
+    if (current->opcode() == HloOpcode::kTranspose) {
+      // The transpose is a bitcast if its operand has the permuted layout.
+      std::vector<int64_t> minor_to_major;
+      minor_to_major.reserve(current_layout.minor_to_major_size());
+      for (int64_t dim : current_layout.minor_to_major()) {
+        minor_to_major.push_back(current->dimensions(dim));
+      }
+      current_layout = LayoutUtil::MakeLayout(minor_to_major);
+    } else if (!current->IsElementwise() || current->operand_count() != 1) {
+      // Other producers can compute their result in any layout.
+      return 0;
+    }
+    current = current->operand(0);
+  }
+  return 0;
+}
+
 const ShapeLayout* LayoutAssignment::LayoutConstraints::OperandLayout(
     const HloInstruction* instruction, int64_t operand_no) const {
   if (const auto* constraint =
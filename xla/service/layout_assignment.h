@@ -514,6 +514,23 @@ class LayoutAssignment : public HloModulePass {
   virtual bool InstructionCanChangeLayoutInstance(
       const HloInstruction* instruction);
 
+  // Estimates the cost of giving the array-shaped `instruction` the given
+  // layout, based on the layouts constrained so far. The layout is followed
+  // back through transposes and elementwise unary operations, which become
+  // bitcasts when their operand has the matching layout, to the first
+  // constrained or shared producer. The cost is zero if that producer can have
+  // the matching layout, and the cost of copying it otherwise. Backends use it
+  // to choose among the layouts they support for an operand.
+  double LayoutChangeCost(const HloInstruction* instruction,
+                          const Layout& layout) const;
+
+  // Returns the estimated cost of copying an array of `shape` into another
+  // layout. Backends can override it with their performance model.
+  virtual double CopyCost(const Shape& shape) const {
+    // The copy reads and writes the whole array.
+    return 2.0 * ShapeUtil::ByteSizeOfElements(shape);
+  }
+
  private:
   // Initializes the layout assignment object for a new Run() call.
   Status Init(HloModule* module);
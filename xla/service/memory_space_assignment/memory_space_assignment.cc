@@ -588,7 +588,7 @@ GetEvictionsMap(std::vector<MemorySpaceAssignment::Allocation*>& allocations) {
 
 void ProcessBuffersProducedInAlternateMemory(
     MemorySpaceAssignment::AllocationSequence& allocations,
-    const HloLiveRange& hlo_live_range) {
+    const HloLiveRange& hlo_live_range, int64_t max_resident_use_distance) {
   std::vector<MemorySpaceAssignment::Allocation*> allocations_in_raw_pointers =
       GetAllocationSequenceInRawPointers(allocations);
   // For all parent allocations produced in alternate memory, create a map from
@@ -604,20 +604,30 @@ void ProcessBuffersProducedInAlternateMemory(
   XLA_LOG_LINES(2, AllocationSequenceToString(allocations, true));
   // Process all buffers produced in the alternate memory:
   // 1. Make the buffer short lived.
-  // 2. Service immediate use if any.
+  // 2. Service uses that follow the definition (or the previous such use)
+  //    within `max_resident_use_distance` directly.
   // 3. If buffer is also used later get or create an immediate eviction.
   // 4. For every later use prefetch just in time from the eviction.
+  max_resident_use_distance = std::max<int64_t>(max_resident_use_distance, 1);
   for (auto allocation : allocations_in_raw_pointers) {
     if (!allocation->is_copy_allocation() &&
         allocation->is_in_alternate_mem()) {
       std::vector<HloUse> uses = allocation->uses();  // Create a copy of uses.
-      allocation->clear_uses();                       // Clear old uses.
+      absl::c_stable_sort(uses, [&](const HloUse& a, const HloUse& b) {
+        return GetUseTime(a, hlo_live_range) < GetUseTime(b, hlo_live_range);
+      });
+      allocation->clear_uses();  // Clear old uses.
       // Make buffer short lived.
       allocation->set_end_time(allocation->start_time() + 1);
+      int64_t last_resident_time = allocation->start_time();
+      bool resident = true;
       for (const HloUse& use : uses) {
         int64_t use_time = GetUseTime(use, hlo_live_range);
-        if (allocation->start_time() + 1 == use_time) {
+        resident &= use_time - last_resident_time <= max_resident_use_distance;
+        if (resident) {
           allocation->AddUse(use);
+          allocation->set_end_time(std::max(allocation->end_time(), use_time));
+          last_resident_time = use_time;
           continue;
         }
         if (!evictions_map.contains(allocation)) {
@@ -648,7 +658,7 @@ void ProcessBuffersProducedInAlternateMemory(
 
 void TransformAllocationSequenceToSpill(
     MemorySpaceAssignment::AllocationSequence& allocations,
-    const HloLiveRange& hlo_live_range) {
+    const HloLiveRange& hlo_live_range, int64_t max_resident_use_distance) {
   VLOG(2) << "InstructionSchedule before transform\n";
   XLA_LOG_LINES(2, InstructionScheduleToString(hlo_live_range));
   VLOG(2) << "AllocationSequence before transform\n";
@@ -656,7 +666,8 @@ void TransformAllocationSequenceToSpill(
   ProcessPrefetchesToAlternateMemory(allocations, hlo_live_range);
   VLOG(2) << "AllocationSequence after processing prefetches\n";
   XLA_LOG_LINES(2, AllocationSequenceToString(allocations, true));
-  ProcessBuffersProducedInAlternateMemory(allocations, hlo_live_range);
+  ProcessBuffersProducedInAlternateMemory(allocations, hlo_live_range,
+                                          max_resident_use_distance);
   VLOG(2) << "AllocationSequence after processing buffers produced in kAlt\n";
   XLA_LOG_LINES(2, AllocationSequenceToString(allocations, true));
   SortAllocationSequence(allocations);
@@ -8036,7 +8047,9 @@ Status MemorySpaceAssignment::Process(const HloLiveRange& hlo_live_range) {
   // needed.
   absl::flat_hash_set<const Allocation*> needed_allocations;
   if (options_.always_spill_to_default_memory) {
-    TransformAllocationSequenceToSpill(allocations_, hlo_live_range);
+    TransformAllocationSequenceToSpill(
+        allocations_, hlo_live_range,
+        options_.always_spill_max_resident_use_distance);
   }
   for (auto& allocation : allocations_) {
     allocation->MarkIfNeeded(needed_allocations);
@@ -1558,6 +1558,17 @@ struct Options {
   // Option to always spill buffers from alternate memory to default memory
   // and prefetching back to alternate memory(if needed) just in time for use.
   bool always_spill_to_default_memory = false;
+
+  // When always_spill_to_default_memory is true, buffers produced in the
+  // alternate memory keep serving the uses that follow their definition, or
+  // their previous such use, within this many logical time steps. Only the
+  // uses after a longer gap are served from the eviction. This suits an
+  // alternate memory that holds the working set, backed by a large default
+  // memory (e.g. device memory backed by pinned host memory): short-lived
+  // buffers stay resident, and long-lived ones like activations kept for the
+  // backward pass are offloaded and prefetched back. Values below 1 mean only
+  // the immediately following use is served from the alternate memory.
+  int64_t always_spill_max_resident_use_distance = 1;
 };
 
 // A struct representing an asynchronous copy with its logical start and end
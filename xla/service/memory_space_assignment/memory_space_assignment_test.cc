@@ -794,6 +794,54 @@ ENTRY entry {
   EXPECT_EQ(negate0->name(), "negate0");
 }
 
+TEST_P(MemorySpaceAssignmentTest, AlwaysSpillKeepsNearbyUsesResidentTest) {
+  // negate0 is used two steps after it is defined, at add_near, and again much
+  // later, at add0. With always_spill_max_resident_use_distance set to 2, the
+  // nearby use keeps reading negate0 from alternate memory, and only the far
+  // use is served by a prefetch from the eviction.
+  absl::string_view hlo_string = R"(
+HloModule module, is_scheduled=true
+
+ENTRY entry {
+  p0 = f32[2,3]{1,0} parameter(0)
+  p1 = f32[2,3]{1,0} parameter(1)
+  negate0 = f32[2,3]{1,0} negate(p0)
+  negate1 = f32[2,3]{1,0} negate(negate0)
+  add_near = f32[2,3]{1,0} add(negate1, negate0)
+  negate2 = f32[2,3]{1,0} negate(add_near)
+  negate3 = f32[2,3]{1,0} negate(negate2)
+  negate4 = f32[2,3]{1,0} negate(negate3)
+  negate5 = f32[2,3]{1,0} negate(negate4)
+  negate6 = f32[2,3]{1,0} negate(negate5)
+  add0 = f32[2,3]{1,0} add(negate6, negate0)
+  ROOT add1 = f32[2,3]{1,0} add(add0, p1)
+}
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  Options options = DefaultMemorySpaceOptions();
+  options.always_spill_to_default_memory = true;
+  options.always_spill_max_resident_use_distance = 2;
+  AssignMemorySpace(module.get(), options);
+
+  const HloInstruction* add_near = FindInstruction(module.get(), "add_near");
+  const HloInstruction* negate0 = add_near->operand(1);
+  EXPECT_EQ(negate0->name(), "negate0");
+  EXPECT_EQ(negate0->shape().layout().memory_space(), kAlternateMemorySpace);
+
+  const HloInstruction* add0 = FindInstruction(module.get(), "add0");
+  const HloInstruction* prefetch_done = add0->operand(1);
+  EXPECT_THAT(prefetch_done, op::CopyDone());
+  EXPECT_EQ(prefetch_done->shape().layout().memory_space(),
+            kAlternateMemorySpace);
+  const HloInstruction* eviction_done = prefetch_done->operand(0)->operand(0);
+  EXPECT_THAT(eviction_done, op::CopyDone());
+  EXPECT_EQ(eviction_done->shape().layout().memory_space(),
+            kDefaultMemorySpace);
+  EXPECT_EQ(eviction_done->operand(0)->operand(0), negate0);
+}
+
 TEST_P(MemorySpaceAssignmentTest, AlwaysSpillEvictionTest) {
   // tanh0 buffer is produced in alternate memory and it has two uses that are
   // sufficiently far apart for an eviction to be scheduled. When the
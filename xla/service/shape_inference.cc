@@ -957,11 +957,10 @@ ShapeInference::InferDegenerateDimensionBroadcastShape(HloOpcode operation,
         ShapeUtil::HumanString(rhs));
   }
 
-  if (lhs.rank() == rhs.rank()) {
+  if (lhs.rank() == rhs.rank() && !broadcast_dimensions.empty()) {
     std::vector<int64_t> identity_dims(lhs.rank());
     std::iota(identity_dims.begin(), identity_dims.end(), 0);
-    if (!broadcast_dimensions.empty() &&
-        broadcast_dimensions != identity_dims) {
+    if (broadcast_dimensions != identity_dims) {
       return InvalidArgument(
           "Broadcast dimensions field must either be not set or be the "
           "identity on binary operations with operands of the same rank.");
@@ -1018,10 +1017,16 @@ ShapeInference::InferDegenerateDimensionBroadcastShape(HloOpcode operation,
   TF_DCHECK_OK(ShapeUtil::ValidateShapeWithOptionalLayout(lhs));
   TF_DCHECK_OK(ShapeUtil::ValidateShapeWithOptionalLayout(rhs));
 
-  TF_RETURN_IF_ERROR(ExpectArray(
-      lhs, absl::StrCat("lhs of binary operation ", HloOpcodeString(opcode))));
-  TF_RETURN_IF_ERROR(ExpectArray(
-      rhs, absl::StrCat("rhs of binary operation ", HloOpcodeString(opcode))));
+  // Only build the error messages when they are needed, this is called for
+  // every binary op built.
+  if (!lhs.IsArray()) {
+    return ExpectArray(lhs, absl::StrCat("lhs of binary operation ",
+                                         HloOpcodeString(opcode)));
+  }
+  if (!rhs.IsArray()) {
+    return ExpectArray(rhs, absl::StrCat("rhs of binary operation ",
+                                         HloOpcodeString(opcode)));
+  }
   switch (opcode) {
     case HloOpcode::kAdd:
     case HloOpcode::kMaximum:
@@ -3061,6 +3061,15 @@ StatusOr<bool> ShardingPropagation::Run(
         already_inferred_from_shard_group;
     absl::flat_hash_set<const HloInstruction*> already_inferred_from_operands;
     absl::flat_hash_set<const HloInstruction*> already_inferred_from_users;
+    // Computations with instructions that may infer a new sharding. The
+    // inference of an instruction only depends on the shardings of its
+    // neighbors, so a computation is revisited only after the caches above
+    // were cleared for some of its instructions.
+    absl::flat_hash_set<const HloComputation*> dirty_computations;
+    for (const HloComputation* computation :
+         module->computations(execution_threads)) {
+      dirty_computations.insert(computation);
+    }
     bool changed_last_iter = true;
     const bool may_merge_partial = is_spmd_ && aggressiveness > 0;
     while (changed_last_iter) {
@@ -3068,28 +3077,36 @@ StatusOr<bool> ShardingPropagation::Run(
       int64_t inferred_from_shard_group_counter = 0;
       int64_t inferred_from_operand_counter = 0;
       int64_t inferred_from_user_counter = 0;
+      int64_t computation_counter = 0;
       int64_t instruction_counter = 0;
       int64_t already_sharded_counter = 0;
       for (const HloComputation* computation :
            module->computations(execution_threads)) {
+        if (!dirty_computations.erase(computation)) {
+          continue;
+        }
         VLOG(2) << "Consider computation: " << computation->name();
         std::vector<HloInstruction*> instructions =
             computation->MakeInstructionPostOrder();
 
+        ++computation_counter;
         instruction_counter += instructions.size();
         already_sharded_counter += absl::c_count_if(
             instructions,
             [](const HloInstruction* inst) { return inst->has_sharding(); });
         auto clear_cache = [&](HloInstruction* hlo,
                                HloInstruction* hlo_for_users = nullptr) {
+          dirty_computations.insert(hlo->parent());
           for (auto operand : hlo->operands()) {
             already_inferred_from_users.erase(operand);
+            dirty_computations.insert(operand->parent());
           }
           if (hlo_for_users == nullptr) {
             hlo_for_users = hlo;
           }
           for (auto user : hlo_for_users->users()) {
             already_inferred_from_operands.erase(user);
+            dirty_computations.insert(user->parent());
           }
           if (instruction_to_shard_group_id.contains(hlo)) {
             const int64_t shard_group_id =
@@ -3101,6 +3118,7 @@ StatusOr<bool> ShardingPropagation::Run(
             for (HloInstruction* member : shard_group) {
               if (member != hlo) {
                 already_inferred_from_shard_group.erase(member);
+                dirty_computations.insert(member->parent());
               }
             }
           }
@@ -3234,7 +3252,8 @@ StatusOr<bool> ShardingPropagation::Run(
         }
       }
       VLOG(1) << "Sharding propagation iteration " << iterations << ";"
-              << "\n  total instructions: " << instruction_counter
+              << "\n  computations visited: " << computation_counter
+              << "\n  instructions visited: " << instruction_counter
               << "\n  instructions already sharded: " << already_sharded_counter
               << "\n  shardings inferred from shard group: "
               << inferred_from_shard_group_counter
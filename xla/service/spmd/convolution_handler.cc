@@ -907,6 +907,206 @@ StatusOr<HloInstruction*> PartitionConvolutionBaseCase(
   return nullptr;
 }
 
+// Partitions a convolution whose LHS is another spatially partitioned
+// convolution by exchanging the halo of the producer's input once for both
+// convolutions, instead of once per convolution. The producer is evaluated on
+// a wider window that also covers the halo needed by `conv`, and the values
+// outside of the producer's output are masked to zero to emulate the padding
+// of `conv`. Returns nullptr if the pair can't be fused or if recomputing the
+// producer on the halo is estimated to be too expensive.
+StatusOr<HloInstruction*> PartitionConvolutionChainWithFusedHalo(
+    PartitionedHlo producer_lhs, PartitionedHlo producer_rhs,
+    PartitionedHlo rhs, const HloInstruction* producer,
+    const HloInstruction* conv, HloInstruction* partition_id, SpmdBuilder* b) {
+  // Maximum fraction of the producer's output that can be recomputed on the
+  // halo.
+  constexpr double kMaxRecomputationRatio = 0.25;
+
+  TF_RET_CHECK(conv->opcode() == HloOpcode::kConvolution);
+  if (producer->opcode() != HloOpcode::kConvolution ||
+      producer->user_count() != 1 || !producer->has_sharding()) {
+    return nullptr;
+  }
+  const HloSharding& sharding = conv->sharding();
+  if (sharding.IsTileMaximal() || sharding.ReplicateOnLastTileDim() ||
+      !sharding.subgroup_types().empty() || producer->sharding() != sharding) {
+    return nullptr;
+  }
+  const auto& dnums = conv->convolution_dimension_numbers();
+  const auto& producer_dnums = producer->convolution_dimension_numbers();
+  if (producer_dnums.SerializeAsString() != dnums.SerializeAsString() ||
+      dnums.input_batch_dimension() != dnums.output_batch_dimension() ||
+      dnums.input_feature_dimension() != dnums.output_feature_dimension() ||
+      ShardCountAtDim(sharding, dnums.output_feature_dimension()) > 1) {
+    return nullptr;
+  }
+  for (const HloInstruction* c : {producer, conv}) {
+    if (c->feature_group_count() != 1 || c->batch_group_count() != 1) {
+      return nullptr;
+    }
+  }
+
+  const int64_t rank = conv->shape().rank();
+  std::vector<int64_t> ones(rank, 1);
+  Window composite_window = window_util::MakeWindow(ones);
+  double recomputation = 1.0;
+  bool has_partitioned_spatial_dim = false;
+  for (int64_t i = 0; i < dnums.input_spatial_dimensions_size(); ++i) {
+    const int64_t dim = dnums.input_spatial_dimensions(i);
+    if (dnums.output_spatial_dimensions(i) != dim) {
+      return nullptr;
+    }
+    const WindowDimension& wd1 = producer->window().dimensions(i);
+    const WindowDimension& wd2 = conv->window().dimensions(i);
+    for (const WindowDimension* wd : {&wd1, &wd2}) {
+      if (wd->stride() != 1 || wd->base_dilation() != 1 ||
+          wd->window_dilation() != 1 || wd->window_reversal() ||
+          wd->padding_low() < 0 || wd->padding_high() < 0) {
+        return nullptr;
+      }
+    }
+    const int64_t shard_count = ShardCountAtDim(sharding, dim);
+    if (shard_count == 1) {
+      continue;
+    }
+    const int64_t size = producer->operand(0)->shape().dimensions(dim);
+    const int64_t shard_size = size / shard_count;
+    if (producer->shape().dimensions(dim) != size ||
+        conv->shape().dimensions(dim) != size || size % shard_count != 0 ||
+        wd1.padding_low() + wd2.padding_low() > shard_size ||
+        wd1.padding_high() + wd2.padding_high() > shard_size) {
+      return nullptr;
+    }
+    has_partitioned_spatial_dim = true;
+    recomputation *= static_cast<double>(shard_size + wd2.size() - 1) /
+                     static_cast<double>(shard_size);
+    WindowDimension* composite = composite_window.mutable_dimensions(dim);
+    composite->set_size(wd1.size() + wd2.size() - 1);
+    composite->set_padding_low(wd1.padding_low() + wd2.padding_low());
+    composite->set_padding_high(wd1.padding_high() + wd2.padding_high());
+  }
+  if (!has_partitioned_spatial_dim ||
+      recomputation - 1.0 > kMaxRecomputationRatio) {
+    return nullptr;
+  }
+
+  // Exchange the halo of the producer's input for both convolutions at once.
+  PartitionedHlo lhs = producer_lhs.Reshard(sharding);
+  auto zero = b->AddInstruction(HloInstruction::CreateConstant(
+      LiteralUtil::Zero(producer_lhs.hlo()->shape().element_type())));
+  auto resharded = lhs.ReshardAsWindowedInput(composite_window, sharding, zero);
+  if (!resharded.has_value() ||
+      resharded->dynamic_slice_index_on_output.has_value()) {
+    return nullptr;
+  }
+
+  Window producer_window = producer->window();
+  Window conv_window = conv->window();
+  for (int64_t i = 0; i < dnums.input_spatial_dimensions_size(); ++i) {
+    const int64_t dim = dnums.input_spatial_dimensions(i);
+    if (ShardCountAtDim(sharding, dim) == 1) {
+      continue;
+    }
+    const WindowDimension& shard_wd = resharded->shard_window.dimensions(dim);
+    WindowDimension* wd1 = producer_window.mutable_dimensions(i);
+    wd1->set_padding_low(shard_wd.padding_low());
+    wd1->set_padding_high(shard_wd.padding_high());
+    WindowDimension* wd2 = conv_window.mutable_dimensions(i);
+    wd2->set_padding_low(0);
+    wd2->set_padding_high(0);
+  }
+
+  auto make_conv = [&](const HloInstruction* original, HloInstruction* lhs_hlo,
+                       HloInstruction* rhs_hlo,
+                       const Window& window) -> StatusOr<HloInstruction*> {
+    TF_ASSIGN_OR_RETURN(
+        Shape shape,
+        ShapeInference::InferConvolveShape(
+            lhs_hlo->shape(), rhs_hlo->shape(), /*feature_group_count=*/1,
+            /*batch_group_count=*/1, window, dnums,
+            /*preferred_element_type=*/original->shape().element_type()));
+    *shape.mutable_layout() = original->shape().layout();
+    return b->AddInstruction(HloInstruction::CreateConvolve(
+        shape, lhs_hlo, rhs_hlo, /*feature_group_count=*/1,
+        /*batch_group_count=*/1, window, dnums, original->precision_config()));
+  };
+
+  // Compute the producer on its shard extended by the halo of `conv`.
+  TF_ASSIGN_OR_RETURN(
+      HloInstruction* extended,
+      make_conv(producer, resharded->sharded_input,
+                producer_rhs.Reshard(HloSharding::Replicate()).hlo(),
+                producer_window));
+
+  // Zero out the elements outside of the producer's output, which stand for
+  // the padding of `conv`.
+  auto ordinals = MakeTiledPartitionOrdinals(sharding, partition_id, b);
+  Shape pred_shape = ShapeUtil::ChangeElementType(extended->shape(), PRED);
+  Shape s32_shape = ShapeUtil::ChangeElementType(extended->shape(), S32);
+  HloInstruction* in_bounds = nullptr;
+  for (int64_t i = 0; i < dnums.input_spatial_dimensions_size(); ++i) {
+    const int64_t dim = dnums.input_spatial_dimensions(i);
+    const int64_t shard_count = ShardCountAtDim(sharding, dim);
+    if (shard_count == 1) {
+      continue;
+    }
+    const int64_t size = producer->shape().dimensions(dim);
+    const int64_t padding_low = conv->window().dimensions(i).padding_low();
+    auto shard_size = b->AddInstruction(HloInstruction::CreateConstant(
+        LiteralUtil::CreateR0<int32_t>(size / shard_count)));
+    auto offset = b->AddInstruction(HloInstruction::CreateBinary(
+        ordinals[dim]->shape(), HloOpcode::kMultiply, ordinals[dim],
+        shard_size));
+    offset = b->AddInstruction(HloInstruction::CreateBinary(
+        offset->shape(), HloOpcode::kSubtract, offset,
+        b->AddInstruction(HloInstruction::CreateConstant(
+            LiteralUtil::CreateR0<int32_t>(padding_low)))));
+    auto index = b->AddInstruction(HloInstruction::CreateBinary(
+        s32_shape, HloOpcode::kAdd,
+        b->AddInstruction(HloInstruction::CreateIota(s32_shape, dim)),
+        b->AddInstruction(
+            HloInstruction::CreateBroadcast(s32_shape, offset, {}))));
+    auto lower = b->AddInstruction(HloInstruction::CreateCompare(
+        pred_shape, index,
+        b->AddInstruction(HloInstruction::CreateBroadcast(
+            s32_shape,
+            b->AddInstruction(HloInstruction::CreateConstant(
+                LiteralUtil::Zero(S32))),
+            {})),
+        ComparisonDirection::kGe));
+    auto upper = b->AddInstruction(HloInstruction::CreateCompare(
+        pred_shape, index,
+        b->AddInstruction(HloInstruction::CreateBroadcast(
+            s32_shape,
+            b->AddInstruction(HloInstruction::CreateConstant(
+                LiteralUtil::CreateR0<int32_t>(size))),
+            {})),
+        ComparisonDirection::kLt));
+    auto dim_in_bounds = b->AddInstruction(HloInstruction::CreateBinary(
+        pred_shape, HloOpcode::kAnd, lower, upper));
+    in_bounds = in_bounds == nullptr
+                    ? dim_in_bounds
+                    : b->AddInstruction(HloInstruction::CreateBinary(
+                          pred_shape, HloOpcode::kAnd, in_bounds,
+                          dim_in_bounds));
+  }
+  auto output_zero = b->AddInstruction(HloInstruction::CreateBroadcast(
+      extended->shape(),
+      b->AddInstruction(HloInstruction::CreateConstant(
+          LiteralUtil::Zero(extended->shape().element_type()))),
+      {}));
+  auto masked = b->AddInstruction(HloInstruction::CreateTernary(
+      extended->shape(), HloOpcode::kSelect, in_bounds, extended, output_zero));
+
+  TF_ASSIGN_OR_RETURN(
+      HloInstruction* result,
+      make_conv(conv, masked, rhs.Reshard(HloSharding::Replicate()).hlo(),
+                conv_window));
+  TF_RET_CHECK(ShapeUtil::Compatible(
+      result->shape(), MakePartitionedShape(conv->shape(), sharding)));
+  return result;
+}
+
 StatusOr<std::unique_ptr<HloInstruction>> CreateShardedConvolution(
     const HloInstruction& conv,
     const dot_as_convolution_util::DotConvolutionDimsInfo& dot_dnums,
@@ -1076,6 +1276,25 @@ Status SpmdPartitioningVisitor::HandleConvolution(HloInstruction* hlo) {
     }
   };
 
+  const HloInstruction* producer = hlo->operand(0);
+  if (options_.fuse_conv_halo_exchanges &&
+      producer->opcode() == HloOpcode::kConvolution &&
+      !convolutions_with_fused_producer_.contains(producer)) {
+    TF_ASSIGN_OR_RETURN(
+        HloInstruction * fused,
+        PartitionConvolutionChainWithFusedHalo(
+            GetPartitionedHlo(producer->operand(0)),
+            GetPartitionedHlo(producer->operand(1)),
+            GetPartitionedHlo(hlo->operand(1)), producer, hlo, partition_id_,
+            &b_));
+    if (fused != nullptr) {
+      // The halo exchange of the producer becomes dead and is removed by DCE.
+      convolutions_with_fused_producer_.insert(hlo);
+      SetPartitionedHlo(hlo, [&] { return fused; });
+      return OkStatus();
+    }
+  }
+
   return HandleDotHelper(hlo, mapping, create_sharded_conv);
 }
 
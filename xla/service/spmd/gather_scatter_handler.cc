@@ -17,6 +17,7 @@ limitations under the License.
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#include <optional>
 #include <vector>
 
 #include "absl/algorithm/container.h"
@@ -554,6 +555,188 @@ StatusOr<HloInstruction*> PartitionGatherTrivialSlicedOperandDimensions(
   return nullptr;
 }
 
+// Returns the index dimension that the indices of a gather are only tiled on,
+// if the operand is tiled only on trivially sliced dimensions, both shardings
+// tile the same number of devices without replication, and the tiled index
+// dimension is a pass-through dimension that is evenly partitioned.
+std::optional<int64_t> GatherIndexDimensionForRoutingToOperandShards(
+    const HloGatherInstruction* gather, const PartitionedHlo& operand,
+    const PartitionedHlo& indices, absl::Span<const int64_t> slice_sizes) {
+  const HloSharding& operand_sharding = operand.sharding();
+  const HloSharding& indices_sharding = indices.sharding();
+  if (operand_sharding.IsTileMaximal() || indices_sharding.IsTileMaximal() ||
+      operand_sharding.NumTiles() !=
+          operand_sharding.tile_assignment().num_elements() ||
+      indices_sharding.NumTiles() !=
+          indices_sharding.tile_assignment().num_elements() ||
+      operand_sharding.NumTiles() != indices_sharding.NumTiles()) {
+    return std::nullopt;
+  }
+  const GatherDimensionNumbers& dnums = gather->gather_dimension_numbers();
+  std::optional<std::vector<int64_t>> trivial_slice_dims =
+      GatherScatterOperandPartitionedOnTrivialSliceDims(
+          operand, dnums.start_index_map(), slice_sizes);
+  if (!trivial_slice_dims) {
+    return std::nullopt;
+  }
+  for (int64_t i = 0; i < operand.rank(); ++i) {
+    if (operand_sharding.tile_assignment().dim(i) != 1 &&
+        !absl::c_linear_search(*trivial_slice_dims, i)) {
+      return std::nullopt;
+    }
+  }
+  std::optional<int64_t> index_dim;
+  for (int64_t i = 0; i < indices.rank(); ++i) {
+    if (indices_sharding.tile_assignment().dim(i) == 1) {
+      continue;
+    }
+    if (index_dim || i == dnums.index_vector_dim()) {
+      return std::nullopt;
+    }
+    index_dim = i;
+  }
+  if (!index_dim || indices.base_shape().dimensions(*index_dim) %
+                            indices_sharding.NumTiles() !=
+                        0) {
+    return std::nullopt;
+  }
+  return index_dim;
+}
+
+// Partition a Gather when its operand is sliced in trivially sliced dimensions
+// (e.g. the rows of an embedding table) and the indices are sliced in a
+// pass-through dimension over the same devices. Every partition sends its
+// indices to the partitions owning the operand shards, which gather the rows
+// they own with the others masked out, and the results are sent back to the
+// partitions that own the indices with an all-to-all and summed. Unlike
+// PartitionGatherTrivialSlicedOperandDimensions, the operand is not replicated
+// and the output stays partitioned like the indices instead of being
+// all-reduced. Each partition still materializes the full-size masked gather
+// of all the indices before the all-to-all, so the peak memory is the same as
+// that method's; the win is the all-to-all moving 1/n of the data an all-reduce
+// would.
+StatusOr<HloInstruction*> PartitionGatherTrivialSlicedOperandWithIndexAllToAll(
+    const HloGatherInstruction* gather, PartitionedHlo& operand,
+    PartitionedHlo& indices, const Shape& output_shape,
+    const HloSharding& output_sharding, absl::Span<const int64_t> batch_dims,
+    absl::Span<const int64_t> slice_sizes, SpmdPartitioningVisitor* visitor) {
+  std::optional<int64_t> index_dim =
+      GatherIndexDimensionForRoutingToOperandShards(gather, operand, indices,
+                                                    slice_sizes);
+  if (!index_dim) {
+    return nullptr;
+  }
+  SpmdBuilder* b = visitor->builder();
+  const GatherDimensionNumbers& dnums = gather->gather_dimension_numbers();
+  std::vector<int64_t> start_index_map(dnums.start_index_map().begin(),
+                                       dnums.start_index_map().end());
+  std::vector<int64_t> trivial_slice_dims =
+      *GatherScatterOperandPartitionedOnTrivialSliceDims(
+          operand, start_index_map, slice_sizes);
+  // The output dimension that the sliced index dimension passes through to.
+  int64_t output_dim = -1;
+  int64_t batch_dim_index = 0;
+  for (int64_t i = 0; i < indices.rank(); ++i) {
+    if (i == dnums.index_vector_dim()) {
+      continue;
+    }
+    if (i == *index_dim) {
+      output_dim = batch_dims[batch_dim_index];
+      break;
+    }
+    ++batch_dim_index;
+  }
+  const HloSharding indices_sharding = indices.sharding();
+  const int64_t num_shards = indices_sharding.NumTiles();
+
+  // The partitions ordered by the shard of the indices they own, which is the
+  // order of the pieces of the output in the all-to-all.
+  std::vector<std::vector<int64_t>> groups(1);
+  groups[0].resize(num_shards);
+  indices_sharding.tile_assignment().Each(
+      [&](absl::Span<const int64_t> tile_index, int64_t device) {
+        groups[0][tile_index[*index_dim]] = device;
+      });
+
+  // Send all the indices to every operand shard, then clamp them to the rows
+  // of the local shard as in PartitionGatherTrivialSlicedOperandDimensions.
+  PartitionedHlo all_indices = indices.Replicate();
+  HloInstruction* indices_min;
+  HloInstruction* indices_max;
+  std::tie(indices_min, indices_max) =
+      IndexBoundsForGatherScatterOperandPartitionedOnTrivialSliceDims(
+          operand, all_indices, operand.state().partition_id, start_index_map,
+          trivial_slice_dims, dnums.index_vector_dim(), b);
+  const Shape& indices_shape = all_indices.hlo()->shape();
+  auto adjusted_indices = b->AddInstruction(HloInstruction::CreateTernary(
+      indices_shape, HloOpcode::kClamp, indices_min, all_indices.hlo(),
+      indices_max));
+  adjusted_indices = b->AddInstruction(HloInstruction::CreateBinary(
+      indices_shape, HloOpcode::kSubtract, adjusted_indices, indices_min));
+  auto local_gather = b->AddInstruction(HloInstruction::CreateGather(
+      output_shape, operand.hlo(), adjusted_indices, dnums, slice_sizes,
+      gather->indices_are_sorted()));
+
+  // Mask out the rows owned by other shards.
+  auto filter = b->AddInstruction(HloInstruction::CreateCompare(
+      ShapeUtil::ChangeElementType(indices_shape, PRED), all_indices.hlo(),
+      indices_min, ComparisonDirection::kLt));
+  filter = b->AddInstruction(HloInstruction::CreateBinary(
+      filter->shape(), HloOpcode::kOr, filter,
+      b->AddInstruction(HloInstruction::CreateCompare(
+          ShapeUtil::ChangeElementType(indices_shape, PRED), all_indices.hlo(),
+          indices_max, ComparisonDirection::kGt))));
+  if (dnums.index_vector_dim() < indices.rank()) {
+    std::vector<int64_t> reduced_filter_dims;
+    for (int64_t i = 0; i < filter->shape().rank(); ++i) {
+      if (i != dnums.index_vector_dim()) {
+        reduced_filter_dims.push_back(filter->shape().dimensions(i));
+      }
+    }
+    filter = b->AddInstruction(HloInstruction::CreateReduce(
+        ShapeUtil::MakeShape(PRED, reduced_filter_dims), filter,
+        CreateR0WithType(PRED, false, b), {dnums.index_vector_dim()},
+        MakeBinaryAdd(PRED, indices.state().module)));
+  }
+  auto broadcast_filter = b->AddInstruction(HloInstruction::CreateBroadcast(
+      ShapeUtil::ChangeElementType(output_shape, PRED), filter, batch_dims));
+  auto filtered = b->AddInstruction(HloInstruction::CreateTernary(
+      output_shape, HloOpcode::kSelect, broadcast_filter,
+      CreateZero(output_shape, b), local_gather));
+
+  // Send the rows gathered for each shard of the indices back to its owner,
+  // and sum the pieces received from all the operand shards.
+  auto all_to_all =
+      operand.state().collective_ops_creator.create_cross_partition_all_to_all(
+          b, {filtered}, groups, (*operand.state().next_channel_id)++,
+          output_dim);
+  std::vector<int64_t> split_dims;
+  for (int64_t i = 0; i < output_shape.rank(); ++i) {
+    if (i == output_dim) {
+      split_dims.push_back(num_shards);
+      split_dims.push_back(output_shape.dimensions(i) / num_shards);
+    } else {
+      split_dims.push_back(output_shape.dimensions(i));
+    }
+  }
+  const PrimitiveType element_type = output_shape.element_type();
+  auto split = b->AddInstruction(HloInstruction::CreateReshape(
+      ShapeUtil::MakeShape(element_type, split_dims), all_to_all));
+  const HloSharding passthrough_sharding = hlo_sharding_util::
+      GatherOutputShardingFromIndexIndexPassthroughDimensions(indices_sharding,
+                                                              gather);
+  auto pgather = b->AddInstruction(HloInstruction::CreateReduce(
+      MakePartitionedShape(output_shape, passthrough_sharding), split,
+      CreateZero(ShapeUtil::MakeScalarShape(element_type), b), {output_dim},
+      MakeBinaryAdd(element_type, operand.state().module)));
+  pgather->set_sharding(passthrough_sharding);
+  VLOG(5) << "[Gather partitioning]: Partitioned as trivial operand "
+             "batch_dim slice with index all-to-all";
+  return PartitionedHlo(pgather, output_shape, operand.state())
+      .Reshard(output_sharding)
+      .hlo();
+}
+
 // Partition a gather over a indices dimensions that are cosidered parallel
 // (which means that the indices access the operand in a monotonically
 // increasing way across the respective operand dimension referenced by the
@@ -692,6 +875,8 @@ GatherPartitionMethods() {
            "PartitionGatherIndexParallelDimensions"},
           {PartitionGatherOperandPassthroughDimensions,
            "PartitionGatherOperandPassthroughDimensions"},
+          {PartitionGatherTrivialSlicedOperandWithIndexAllToAll,
+           "PartitionGatherTrivialSlicedOperandWithIndexAllToAll"},
           {PartitionGatherTrivialSlicedOperandDimensions,
            "PartitionGatherTrivialSlicedOperandDimensions"},
           {PartitionGatherIndexPassthroughDimensions,
@@ -735,6 +920,19 @@ int64_t GatherPartitionMethodCostModel(
                         ShapeSizeInBytes(indices.base_shape()),
                     max_potential_output_shape_size);
   }
+  if (partition_method ==
+      PartitionGatherTrivialSlicedOperandWithIndexAllToAll) {
+    // Same memory as the trivial sliced operand method, which is listed after
+    // it: both build the full-size masked gather on every partition. Only the
+    // collective differs, with the output all-to-all'ed instead of
+    // all-reduced.
+    return !GatherIndexDimensionForRoutingToOperandShards(gather, operand,
+                                                          indices, slice_sizes)
+               ? INT64_MAX
+               : ShapeSizeInBytes(operand.hlo()->shape()) +
+                     ShapeSizeInBytes(output_shape) +
+                     ShapeSizeInBytes(indices.base_shape());
+  }
   if (partition_method == PartitionGatherTrivialSlicedOperandDimensions) {
     auto trivial_slice_dims = GatherScatterOperandPartitionedOnTrivialSliceDims(
         operand, gather->gather_dimension_numbers().start_index_map(),
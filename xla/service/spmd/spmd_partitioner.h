@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_SERVICE_SPMD_SPMD_PARTITIONER_H_
 #define XLA_SERVICE_SPMD_SPMD_PARTITIONER_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -81,6 +82,10 @@ struct SpmdPartitionerOptions {
   // Whether to skip checking the numbers and shardings of windowed einsum's
   // users.
   bool skip_checking_windowed_einsum_users = false;
+
+  // Whether to exchange the halo of two consecutive spatially partitioned
+  // convolutions once, recomputing the first one on the halo of the second.
+  bool fuse_conv_halo_exchanges = true;
 };
 
 // Class to wrap the computation builder to capture information during SPMD
@@ -339,9 +344,12 @@ class PartitionedHlo {
     };
     // Use absl::node_hash_map for pointer stability.
     absl::node_hash_map<HloInstruction*, PerHloCache> per_hlo_cache;
-    // Caches for nested partitioning of grouped sharding. Each string key
-    // represents a unique way of grouping devices.
-    absl::flat_hash_map<std::string, std::unique_ptr<ReshardCache>>
+    // Caches for nested partitioning of grouped sharding. Each key represents a
+    // unique way of grouping devices. The device groups are used as the key
+    // directly: formatting them as a string dominated the cost of creating
+    // per-group partitioning states on large topologies.
+    absl::flat_hash_map<std::vector<std::vector<int64_t>>,
+                        std::unique_ptr<ReshardCache>>
         groupd_caches;
   };
   struct PartitioningState {
@@ -647,6 +655,11 @@ class SpmdPartitioningVisitor : public DfsHloVisitorWithDefault {
  private:
   PartitionedHlo::ReshardCache reshard_cache_;
 
+  // Convolutions partitioned together with their producer convolution. They are
+  // not fused again with their own users, which would need the partitioned
+  // producer again and keep its halo exchange alive.
+  absl::flat_hash_set<const HloInstruction*> convolutions_with_fused_producer_;
+
   // Mapping from the instruction in the original computation to the new SPMD
   // partitioned instruction.
   ConstHloInstructionMap<PartitionedHlo> partitioned_instructions_;
@@ -1187,6 +1187,51 @@ ENTRY entry {
                     op::Shape("f32[128,56,112,64]")));
 }
 
+TEST_P(SpmdPartitioningTest, ConsecutiveConvolutionsExchangeHaloOnce) {
+  absl::string_view hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %lhs = f32[1,16,16,8] parameter(0)
+  %lhs.copy = f32[1,16,16,8] copy(%lhs), sharding={devices=[1,2,1,1]0,1}
+  %rhs0 = f32[3,3,8,8] parameter(1), sharding={replicated}
+  %rhs1 = f32[3,3,8,8] parameter(2), sharding={replicated}
+  %conv0 = f32[1,16,16,8] convolution(%lhs.copy, %rhs0),
+    window={size=3x3 pad=1_1x1_1}, dim_labels=b01f_01io->b01f,
+    sharding={devices=[1,2,1,1]0,1}
+  ROOT %conv1 = f32[1,16,16,8] convolution(%conv0, %rhs1),
+    window={size=3x3 pad=1_1x1_1}, dim_labels=b01f_01io->b01f,
+    sharding={devices=[1,2,1,1]0,1}
+})";
+
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          PartitionComputation(hlo_string, /*num_devices=*/2));
+  VLOG(1) << module->ToString();
+
+  // The first convolution is computed on its shard extended by the halo of the
+  // second one, so a single halo of size 2 is exchanged on each side.
+  const auto root = module->entry_computation()->root_instruction();
+  auto left_halo =
+      AllOf(op::CollectivePermute(op::Slice()), op::Shape("f32[1,2,16,8]"));
+  auto right_halo =
+      AllOf(op::CollectivePermute(op::Slice()), op::Shape("f32[1,2,16,8]"));
+  auto conv0 = AllOf(
+      op::Convolution(op::Select(_, op::Concatenate(left_halo, _, right_halo),
+                                 op::Broadcast()),
+                      op::Parameter(1)),
+      op::Shape("f32[1,10,16,8]"));
+  EXPECT_THAT(root, AllOf(op::Convolution(
+                              op::Select(op::And(), conv0, op::Broadcast()),
+                              op::Parameter(2)),
+                          op::Shape("f32[1,8,16,8]")));
+  EXPECT_EQ(absl::c_count_if(module->entry_computation()->instructions(),
+                             [](const HloInstruction* hlo) {
+                               return hlo->opcode() ==
+                                      HloOpcode::kCollectivePermute;
+                             }),
+            2);
+}
+
 TEST_P(SpmdPartitioningTest, ConvolutionLhsTiledRhsReplicatedNeedReshard) {
   absl::string_view hlo_string = R"(
 HloModule module
@@ -7427,6 +7472,32 @@ ENTRY entry {
   EXPECT_THAT(root, AllOf(op::AllReduce(masked), op::Shape("f32[2,3,9]")));
 }
 
+TEST_P(SpmdPartitioningTest,
+       GatherPartitionedOnTrivialSliceDimsWithPartitionedIndices) {
+  absl::string_view hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %input = f32[16,9] parameter(0), sharding={devices=[2,1]0,1}
+  %indices = s32[4,3] parameter(1), sharding={devices=[2,1]1,0}
+  ROOT %gather = f32[4,3,9] gather(%input, %indices), offset_dims={2},
+    collapsed_slice_dims={0}, start_index_map={0}, index_vector_dim=2,
+    slice_sizes={1,9}, sharding={devices=[2,1,1]1,0}
+})";
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          PartitionComputation(hlo_string, /*num_devices=*/2));
+  VLOG(1) << module->ToString();
+  // The rows gathered from the local shard are sent back to the owners of the
+  // indices instead of being all-reduced.
+  auto gather = AllOf(op::Gather(op::Parameter(0), op::Subtract()),
+                      op::Shape("f32[4,3,9]"));
+  auto masked = op::Select(op::Broadcast(), op::Broadcast(), gather);
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  EXPECT_THAT(
+      root, AllOf(op::Reduce(op::Reshape(op::AllToAll(masked)), op::Constant()),
+                  op::Shape("f32[2,3,9]")));
+}
+
 TEST_P(SpmdPartitioningTest, UnpartitionedScatter) {
   absl::string_view hlo_string = R"(
 HloModule module
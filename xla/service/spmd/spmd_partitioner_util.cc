@@ -24,7 +24,6 @@ limitations under the License.
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
-#include "absl/strings/str_join.h"
 #include "xla/comparison_util.h"
 #include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_computation.h"
@@ -1979,13 +1978,7 @@ PartitionedHlo::PartitioningState CreatePerGroupPartitioningState(
       state.collective_ops_creator, device_groups);
   result.partition_id =
       GetInGroupPartitionId(state.partition_id, device_groups, b);
-  // Create a string key for the groups.
-  std::vector<std::string> per_group_strings(device_groups.size());
-  for (int64_t i = 0; i < per_group_strings.size(); ++i) {
-    per_group_strings[i] = absl::StrJoin(device_groups[i], ",");
-  }
-  auto& grouped_cache =
-      state.reshard_cache->groupd_caches[absl::StrJoin(per_group_strings, ";")];
+  auto& grouped_cache = state.reshard_cache->groupd_caches[device_groups];
   if (!grouped_cache) {
     grouped_cache = std::make_unique<PartitionedHlo::ReshardCache>();
   }
@@ -38,7 +38,8 @@ class StatefulRngSpmdPartitionerTest : public HloTestBase {
  public:
   StatusOr<std::unique_ptr<HloModule>> PartitionComputation(
       absl::string_view hlo_module, int64_t num_partitions,
-      std::function<void(HloPassPipeline &pipeline)> add_passes = nullptr) {
+      std::function<void(HloPassPipeline &pipeline)> add_passes = nullptr,
+      int64_t threshold_for_windowed_einsum_mib = 100000) {
     TF_ASSIGN_OR_RETURN(
         auto module, ParseAndReturnVerifiedModule(
                          hlo_module, GetModuleConfigForTest(
@@ -52,7 +53,8 @@ class StatefulRngSpmdPartitionerTest : public HloTestBase {
     }
     pass.AddPass<ShardingPropagation>(/*is_spmd=*/true);
     pass.AddPass<StatefulRngSpmdPartitioner>(num_partitions,
-                                             /*num_replicas=*/1);
+                                             /*num_replicas=*/1,
+                                             threshold_for_windowed_einsum_mib);
     pass.AddPass<HloVerifier>(/*layout_sensitive=*/false,
                               /*allow_mixed_precision=*/false);
     TF_RETURN_IF_ERROR(pass.Run(module.get()).status());
@@ -116,6 +118,38 @@ ENTRY entry {
   VerifyNoAllReduce(module.get());
 }
 
+TEST_F(StatefulRngSpmdPartitionerTest, WindowedEinsumThreshold) {
+  absl::string_view hlo_string = R"(
+HloModule module
+
+ENTRY entry {
+  %p0 = f32[2048,2,3264]{2,1,0} parameter(0), sharding={devices=[1,1,2]0,1}
+  %p1 = f32[2,3264,2176]{2,1,0} parameter(1), sharding={devices=[2,1,1]0,1}
+  ROOT %dot.224 = f32[2048,2176]{1,0} dot(f32[2048,2,3264]{2,1,0} %p0, f32[2,3264,2176]{2,1,0} %p1), lhs_contracting_dims={1,2}, rhs_contracting_dims={0,1}, sharding={devices=[1,2]0,1}
+}
+)";
+
+  auto has_while = [](HloModule *module) {
+    for (HloInstruction *hlo : module->entry_computation()->instructions()) {
+      if (hlo->opcode() == HloOpcode::kWhile) return true;
+    }
+    return false;
+  };
+
+  // Windowed einsum is disabled by default.
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          PartitionComputation(hlo_string,
+                                               /*num_partitions=*/2));
+  EXPECT_FALSE(has_while(module.get()));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      module, PartitionComputation(hlo_string, /*num_partitions=*/2,
+                                   /*add_passes=*/nullptr,
+                                   /*threshold_for_windowed_einsum_mib=*/0));
+  XLA_VLOG_LINES(1, module->ToString());
+  EXPECT_TRUE(has_while(module.get()));
+}
+
 }  // namespace
 }  // namespace spmd
 }  // namespace xla
@@ -17,52 +17,105 @@ limitations under the License.
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace xla {
 
+std::unique_ptr<se::Stream> StreamPool::CreateStream(
+    se::StreamExecutor* executor, se::StreamPriority priority) {
+  auto stream = std::make_unique<se::Stream>(executor);
+  stream->SetPriority(priority);
+  VLOG(1) << "Set stream priority to: "
+          << se::StreamPriorityToString(priority);
+  stream->Init();
+  VLOG(1) << stream->DebugStreamPointers() << " StreamPool created new stream";
+  return stream;
+}
+
+std::unique_ptr<se::Stream> StreamPool::PopStream(se::StreamPriority priority) {
+  auto it = streams_with_pri_.find(priority);
+  if (it == streams_with_pri_.end()) return nullptr;
+
+  std::vector<std::unique_ptr<se::Stream>>& streams = it->second;
+  while (!streams.empty()) {
+    // Re-use an existing stream from the pool.
+    std::unique_ptr<se::Stream> stream = std::move(streams.back());
+    streams.pop_back();
+    if (stream->ok()) {
+      VLOG(1) << stream->DebugStreamPointers()
+              << " StreamPool reusing existing stream with priority: "
+              << se::StreamPriorityToString(priority);
+      return stream;
+    }
+    VLOG(1) << stream->DebugStreamPointers()
+            << " stream was not ok, StreamPool deleting with priority: "
+            << se::StreamPriorityToString(priority);
+  }
+  return nullptr;
+}
+
 StreamPool::Ptr StreamPool::BorrowStream(se::StreamExecutor* executor,
                                          se::StreamPriority priority) {
   std::unique_ptr<se::Stream> stream;
-
   {
     absl::MutexLock lock(&mu_);
-    if (streams_with_pri_.find(priority) == streams_with_pri_.end()) {
-      stream = nullptr;
-    } else {
-      while (!streams_with_pri_[priority].empty() && !stream) {
-        // Re-use an existing stream from the pool.
-        stream = std::move(streams_with_pri_[priority].back());
-        streams_with_pri_[priority].pop_back();
-        if (stream->ok()) {
-          VLOG(1) << stream->DebugStreamPointers()
-                  << " StreamPool reusing existing stream with priority: "
-                  << se::StreamPriorityToString(priority);
-        } else {
-          VLOG(1) << stream->DebugStreamPointers()
-                  << " stream was not ok, StreamPool deleting with priority: "
-                  << se::StreamPriorityToString(priority);
-          stream = nullptr;
-        }
-      }
-    }
+    stream = PopStream(priority);
   }
 
-  if (!stream) {
-    // Create a new stream.
-    stream = std::make_unique<se::Stream>(executor);
-    stream->SetPriority(priority);
-    VLOG(1) << "Set stream priority to: "
-            << se::StreamPriorityToString(priority);
-    stream->Init();
-    VLOG(1) << stream->DebugStreamPointers()
-            << " StreamPool created new stream";
-  }
+  // Create a new stream outside of the lock.
+  if (!stream) stream = CreateStream(executor, priority);
 
   // Return the stream wrapped in Ptr, which has our special deleter semantics.
   PtrDeleter deleter = {this};
   return Ptr(stream.release(), deleter);
 }
 
+std::vector<StreamPool::Ptr> StreamPool::BorrowStreams(
+    se::StreamExecutor* executor, int num_streams,
+    se::StreamPriority priority) {
+  std::vector<std::unique_ptr<se::Stream>> streams;
+  streams.reserve(num_streams);
+  {
+    absl::MutexLock lock(&mu_);
+    while (static_cast<int>(streams.size()) < num_streams) {
+      std::unique_ptr<se::Stream> stream = PopStream(priority);
+      if (!stream) break;
+      streams.push_back(std::move(stream));
+    }
+  }
+
+  // Create the missing streams outside of the lock.
+  while (static_cast<int>(streams.size()) < num_streams) {
+    streams.push_back(CreateStream(executor, priority));
+  }
+
+  std::vector<Ptr> ptrs;
+  ptrs.reserve(num_streams);
+  for (std::unique_ptr<se::Stream>& stream : streams) {
+    ptrs.push_back(Ptr(stream.release(), PtrDeleter{this}));
+  }
+  return ptrs;
+}
+
+void StreamPool::PrewarmStreams(se::StreamExecutor* executor, int num_streams,
+                                se::StreamPriority priority) {
+  int num_available;
+  {
+    absl::MutexLock lock(&mu_);
+    num_available = streams_with_pri_[priority].size();
+  }
+
+  std::vector<std::unique_ptr<se::Stream>> streams;
+  for (int i = num_available; i < num_streams; ++i) {
+    streams.push_back(CreateStream(executor, priority));
+  }
+
+  absl::MutexLock lock(&mu_);
+  for (std::unique_ptr<se::Stream>& stream : streams) {
+    if (stream->ok()) streams_with_pri_[priority].push_back(std::move(stream));
+  }
+}
+
 void StreamPool::ReturnStream(se::Stream* stream) {
   if (stream->ok()) {
     VLOG(1) << stream->DebugStreamPointers()
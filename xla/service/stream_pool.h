@@ -48,7 +48,34 @@ class StreamPool {
   Ptr BorrowStream(se::StreamExecutor* executor,
                    se::StreamPriority priority = se::StreamPriority::Default);
 
+  // Returns `num_streams` distinct streams from the pool, creating new streams
+  // if not enough are available. Takes the pool lock only once.
+  //
+  // This method is thread-safe.
+  std::vector<Ptr> BorrowStreams(
+      se::StreamExecutor* executor, int num_streams,
+      se::StreamPriority priority = se::StreamPriority::Default);
+
+  // Creates streams with the given priority until the pool holds at least
+  // `num_streams` available streams of that priority, so that latency
+  // critical work (e.g. async collectives on high priority streams) doesn't
+  // have to create streams when it first borrows them.
+  //
+  // This method is thread-safe.
+  void PrewarmStreams(
+      se::StreamExecutor* executor, int num_streams,
+      se::StreamPriority priority = se::StreamPriority::Default);
+
  private:
+  // Creates and initializes a new stream with the given priority.
+  static std::unique_ptr<se::Stream> CreateStream(se::StreamExecutor* executor,
+                                                  se::StreamPriority priority);
+
+  // Pops an ok stream with the given priority from the pool, deleting streams
+  // that are not ok. Returns nullptr if there are no such streams.
+  std::unique_ptr<se::Stream> PopStream(se::StreamPriority priority)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Puts a pointer to a stream back into the pool, leaving it free
   // for future use. Streams that have previously encountered errors
   // are deleted, and not returned to the pool.
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/service/stream_pool.h"
 
 #include <memory>
+#include <vector>
 
 #include "xla/stream_executor/stream_executor.h"
 #include "xla/test_helpers.h"
@@ -166,5 +167,43 @@ TEST_F(StreamPoolTest, BadStreamAfterReturnDiscarded) {
   // The check that stream2->ok() serves as a good-enough check.
 }
 
+TEST_F(StreamPoolTest, BorrowStreams) {
+  std::unique_ptr<se::StreamExecutor> executor = NewStreamExecutor();
+  StreamPool pool;
+
+  // Borrow and return one stream, so that the pool has a single stream.
+  se::Stream* stream1_ptr = pool.BorrowStream(executor.get()).get();
+
+  // Borrow three streams, one from the pool and two new ones.
+  std::vector<StreamPool::Ptr> streams =
+      pool.BorrowStreams(executor.get(), /*num_streams=*/3);
+  ASSERT_EQ(streams.size(), 3);
+  EXPECT_EQ(streams[0].get(), stream1_ptr);
+  EXPECT_NE(streams[1].get(), streams[0].get());
+  EXPECT_NE(streams[2].get(), streams[0].get());
+  EXPECT_NE(streams[2].get(), streams[1].get());
+  for (const StreamPool::Ptr& stream : streams) {
+    EXPECT_TRUE(stream->ok());
+  }
+}
+
+TEST_F(StreamPoolTest, PrewarmStreams) {
+  std::unique_ptr<se::StreamExecutor> executor = NewStreamExecutor();
+  StreamPool pool;
+
+  pool.PrewarmStreams(executor.get(), /*num_streams=*/2);
+  std::vector<StreamPool::Ptr> streams =
+      pool.BorrowStreams(executor.get(), /*num_streams=*/2);
+  se::Stream* stream1_ptr = streams[0].get();
+  se::Stream* stream2_ptr = streams[1].get();
+  streams.clear();
+
+  // Prewarming a pool that already has enough streams is a no-op.
+  pool.PrewarmStreams(executor.get(), /*num_streams=*/2);
+  streams = pool.BorrowStreams(executor.get(), /*num_streams=*/2);
+  EXPECT_THAT((std::vector<se::Stream*>{streams[0].get(), streams[1].get()}),
+              ::testing::UnorderedElementsAre(stream1_ptr, stream2_ptr));
+}
+
 }  // namespace
 }  // namespace xla
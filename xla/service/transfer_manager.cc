@@ -15,11 +15,14 @@ limitations under the License.
 
 #include "xla/service/transfer_manager.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/algorithm/container.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/strings/str_cat.h"
 #include "xla/service/compiler.h"
@@ -90,6 +93,66 @@ Status TransferManager::TransferLiteralToDevice(
   return substream->BlockHostUntilDone();
 }
 
+Status TransferManager::TransferLiteralToDeviceMultiStreamAsync(
+    se::Stream* stream, const LiteralSlice& literal,
+    const ShapedBuffer& device_buffer, int max_streams,
+    const TransferMetadata* transfer_metadata) {
+  TF_RET_CHECK(max_streams > 0);
+  TF_RET_CHECK(
+      ShapeUtil::Compatible(literal.shape(), device_buffer.on_device_shape()));
+  TF_RET_CHECK(stream->parent()->device_ordinal() ==
+               device_buffer.device_ordinal());
+
+  struct Leaf {
+    ShapeIndex index;
+    int64_t size;
+  };
+  std::vector<Leaf> leaves;
+  ShapeUtil::ForEachSubshape(
+      device_buffer.on_device_shape(),
+      [&](const Shape& device_subshape, const ShapeIndex& index) {
+        if (device_subshape.IsArray()) {
+          leaves.push_back({index, GetByteSizeRequirement(device_subshape)});
+        }
+      });
+  if (leaves.size() <= 1 || max_streams == 1) {
+    return TransferLiteralToDeviceAsync(stream, literal, device_buffer,
+                                        transfer_metadata);
+  }
+
+  TF_RETURN_IF_ERROR(WriteTupleIndexTablesAsync(stream, device_buffer));
+
+  const int num_streams = std::min<int64_t>(max_streams, leaves.size());
+  std::vector<se::Stream*> substreams;
+  std::vector<int64_t> stream_bytes(num_streams, 0);
+  absl::Cleanup cleanup = [&]() {
+    for (se::Stream* substream : substreams) {
+      stream->ThenWaitFor(substream);
+      stream->ReturnSubStream(substream);
+    }
+  };
+  for (int i = 0; i < num_streams; ++i) {
+    substreams.push_back(stream->GetOrCreateSubStream());
+    substreams.back()->ThenWaitFor(stream);
+  }
+
+  absl::c_stable_sort(leaves, [](const Leaf& a, const Leaf& b) {
+    return a.size > b.size;
+  });
+  for (const Leaf& leaf : leaves) {
+    const int i = absl::c_min_element(stream_bytes) - stream_bytes.begin();
+    stream_bytes[i] += leaf.size;
+    ShapedBuffer leaf_buffer(
+        ShapeUtil::GetSubshape(device_buffer.on_device_shape(), leaf.index),
+        device_buffer.device_ordinal());
+    leaf_buffer.set_buffer(device_buffer.buffer(leaf.index), /*index=*/{});
+    TF_RETURN_IF_ERROR(TransferLiteralToDeviceAsync(
+        substreams[i], LiteralSlice(literal, leaf.index), leaf_buffer,
+        transfer_metadata));
+  }
+  return OkStatus();
+}
+
 StatusOr<Literal> TransferManager::TransferArrayFromDevice(
     se::Stream* stream, const Shape& shape, const se::DeviceMemoryBase& source,
     const TransferMetadata* transfer_metadata) {
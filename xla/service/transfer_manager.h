@@ -150,6 +150,20 @@ class TransferManager {
                                         nullptr);
   }
 
+  // Like TransferLiteralToDeviceAsync, but spreads the transfers of the arrays
+  // of a tuple-shaped literal over up to `max_streams` substreams of `stream`,
+  // so that large tuples are not transferred one array at a time on a single
+  // stream. Arrays are assigned largest first to the least loaded substream.
+  //
+  // The transfers start after the work already enqueued on `stream`, and work
+  // enqueued on `stream` after this returns waits for all of them, so callers
+  // can wait for completion on `stream` (e.g. with an event or
+  // BlockHostUntilDone) as with TransferLiteralToDeviceAsync.
+  Status TransferLiteralToDeviceMultiStreamAsync(
+      se::Stream* stream, const LiteralSlice& literal,
+      const ShapedBuffer& device_buffer, int max_streams,
+      const TransferMetadata* transfer_metadata = nullptr);
+
   // Convenience methods for transferring an array to or from the device at a
   // known address. This avoids having to construct a ShapedBuffer just to
   // transfer an array at a known address.
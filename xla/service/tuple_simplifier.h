@@ -26,7 +26,7 @@ namespace xla {
 
 // A pass which simplifies patterns of Tuple and GetTupleElement instructions in
 // the module.
-class TupleSimplifier : public HloModulePass {
+class TupleSimplifier : public HloComputationPass {
  public:
   TupleSimplifier() : TupleSimplifier(/*exclude_entry_computation=*/false) {}
   explicit TupleSimplifier(bool exclude_entry_computation);
@@ -35,11 +35,8 @@ class TupleSimplifier : public HloModulePass {
 
   // Run tuple simplification on the given computation. Returns whether the
   // computation was changed.
-  using HloPassInterface::Run;
   using HloPassInterface::RunOnModuleGroup;
-  StatusOr<bool> Run(
-      HloModule* module,
-      const absl::flat_hash_set<absl::string_view>& execution_threads) override;
+  StatusOr<bool> RunOnComputation(HloComputation* computation) override;
 
  private:
   // When set, this pipeline stage will perform optimization of all computations
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
+#include "xla/hlo/evaluator/hlo_evaluation_plan.h"
 #include "xla/hlo/evaluator/hlo_evaluator.h"
 #include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
@@ -484,6 +485,39 @@ optional<int64_t> ComputeWhileLoopTripCount(const HloInstruction* while_op,
   auto* while_cond_root = while_cond->root_instruction();
   auto* while_cond_indvar = NonConstantOperand(while_cond_root);
 
+  // Lower the condition and the induction variable update once when possible,
+  // so that each iteration only runs a few kernels instead of cloning and
+  // evaluating instructions.
+  StatusOr<HloEvaluationPlan> cond_plan =
+      HloEvaluationPlan::Compile(while_cond_root, {while_cond_indvar});
+  StatusOr<HloEvaluationPlan> indvar_update_plan =
+      HloEvaluationPlan::Compile(while_body_indvar_update, {while_body_indvar});
+  if (cond_plan.ok() && indvar_update_plan.ok()) {
+    Literal cond_result;
+    Literal indvar_next_val;
+    for (int64_t trip_count = 0; trip_count != max_brute_force_iters + 1;
+         ++trip_count) {
+      if (Status status = cond_plan->Evaluate({&indvar_iter_val}, &cond_result);
+          !status.ok()) {
+        VLOG(2) << "Couldn't evaluate while cond: " << status;
+        return nullopt;
+      }
+      if (!cond_result.Get<bool>({})) {
+        VLOG(2) << "Loop has static trip count of " << trip_count;
+        return trip_count;
+      }
+      if (Status status = indvar_update_plan->Evaluate({&indvar_iter_val},
+                                                       &indvar_next_val);
+          !status.ok()) {
+        VLOG(2) << "Couldn't evaluate induction variable update: " << status;
+        return nullopt;
+      }
+      std::swap(indvar_iter_val, indvar_next_val);
+    }
+    VLOG(2) << "Loop has unknown trip count.";
+    return nullopt;
+  }
+
   for (int64_t trip_count = 0; trip_count != max_brute_force_iters + 1;
        ++trip_count) {
     StatusOr<Literal> result = evaluator.EvaluateWithSubstitutions(
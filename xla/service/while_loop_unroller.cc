@@ -42,6 +42,7 @@ limitations under the License.
 #include "xla/primitive_util.h"
 #include "xla/service/async_op_canonicalizer.h"
 #include "xla/service/call_inliner.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/flatten_call_graph.h"
 #include "xla/service/hlo_cse.h"
 #include "xla/service/hlo_pass_fix.h"
@@ -133,12 +134,79 @@ UnrollSingleIterationOfTrivialLoop(HloInstruction* while_op,
   return while_body_clone;
 }
 
+// Partially unrolls a loop with a known trip count: the first
+// `trip_count % unroll_factor` iterations are peeled off, and the new body
+// calls the original body `unroll_factor` times. The condition only depends on the
+// induction variable, so it is evaluated once every `unroll_factor` iterations.
+static Status PartiallyUnrollTrivialLoop(HloInstruction* while_op,
+                                         const int64_t indvar_idx,
+                                         const int64_t init_value,
+                                         const int64_t trip_count,
+                                         const int64_t unroll_factor) {
+  HloModule* module = while_op->GetModule();
+  HloComputation* computation = while_op->parent();
+  HloComputation* body = while_op->while_body();
+
+  HloInstruction* loop_init = while_op->mutable_operand(0);
+  for (int64_t i = init_value; i < init_value + trip_count % unroll_factor;
+       ++i) {
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<HloComputation> peeled_body,
+        UnrollSingleIterationOfTrivialLoop(while_op, indvar_idx, i));
+    loop_init = computation->AddInstruction(HloInstruction::CreateCall(
+        while_op->shape(), {loop_init},
+        module->AddEmbeddedComputation(std::move(peeled_body))));
+  }
+
+  HloComputation::Builder builder(
+      absl::StrCat(body->name(), ".unrolled_", unroll_factor));
+  HloInstruction* loop_state = builder.AddInstruction(
+      HloInstruction::CreateParameter(0, while_op->shape(), "loop_state"));
+  for (int64_t i = 0; i < unroll_factor; ++i) {
+    loop_state = builder.AddInstruction(
+        HloInstruction::CreateCall(while_op->shape(), {loop_state}, body));
+  }
+  while_op->set_while_body(
+      module->AddEmbeddedComputation(builder.Build(loop_state)));
+  TF_RETURN_IF_ERROR(while_op->ReplaceOperandWith(0, loop_init));
+
+  StatusOr<WhileLoopBackendConfig> config =
+      while_op->backend_config<WhileLoopBackendConfig>();
+  if (config.ok() && config->has_known_trip_count()) {
+    config->mutable_known_trip_count()->set_n(trip_count / unroll_factor);
+    TF_RETURN_IF_ERROR(while_op->set_backend_config(*config));
+  }
+  return OkStatus();
+}
+
+StatusOr<int64_t> WhileLoopUnroller::ChoosePartialUnrollFactor(
+    const HloInstruction* while_op, int64_t trip_count) const {
+  const PartialUnrollOptions& options = *partial_unroll_options_;
+  HloCostAnalysis cost_analysis(options.cost_analysis_options);
+  TF_RETURN_IF_ERROR(while_op->while_body()->Accept(&cost_analysis));
+  const float body_seconds = cost_analysis.optimal_seconds();
+
+  const int64_t max_unroll_factor = std::min<int64_t>(
+      {trip_count, options.max_unroll_factor,
+       options.max_unrolled_instruction_count /
+           while_op->while_body()->instruction_count()});
+  int64_t unroll_factor = 1;
+  while (unroll_factor < max_unroll_factor &&
+         options.iteration_overhead_seconds >
+             options.max_overhead_fraction *
+                 (options.iteration_overhead_seconds +
+                  unroll_factor * body_seconds)) {
+    ++unroll_factor;
+  }
+  VLOG(3) << "Body of " << while_op->name() << " takes " << body_seconds
+          << "s, unroll factor " << unroll_factor;
+  return unroll_factor;
+}
+
 StatusOr<bool> WhileLoopUnroller::Run(
     HloModule* module,
     const absl::flat_hash_set<absl::string_view>& execution_threads) {
-  // TODO(b/288130138) For now, we only support full unrolling. Will add partial
-  // unrolling if needed.
-  if (unroll_factor_ != -1) {
+  if (unroll_factor_ != -1 && unroll_factor_ < 2) {
     return false;
   }
   XLA_VLOG_LINES(3, "WhileLoopUnroller::Run(), before:\n" + module->ToString());
@@ -261,11 +329,6 @@ StatusOr<bool> WhileLoopUnroller::Run(
   for (HloInstruction* while_op : while_ops) {
     VLOG(3) << "Trying to unroll " << while_op->ToShortString();
     bool unrolled_current_loop = false;
-    int64_t unroll_factor_current_loop = unroll_factor_;
-
-    // TODO(b/288130138) For now, we only support full unrolling. Will add
-    // partial unrolling if needed.
-    CHECK_EQ(unroll_factor_current_loop, -1);
 
     std::optional<int64_t> indvar_tuple_idx =
         GetLoopInductionVarTupleIdx(while_op);
@@ -293,31 +356,50 @@ StatusOr<bool> WhileLoopUnroller::Run(
 
     VLOG(3) << "Loop trip count " << trip_count.value();
 
-    // TODO(b/291628533): Extract this to the unroller config. We only unroll
-    // loops up to a threshold.
-    if (trip_count > kUnrollTripCountThreshold) {
+    std::optional<int64_t> init_value =
+        LiteralUtil::LiteralAsScalarInt64(indvar_iter_val);
+    // Init value must be int64_t at this point since we found the trip count.
+    CHECK(init_value.has_value());
+
+    // TODO(b/291628533): Extract this to the unroller config. We only fully
+    // unroll loops up to a threshold, and don't fully unroll loops that
+    // increase the instruction count by more than kUnrollExpandFactorThreshold.
+    const bool can_fully_unroll =
+        trip_count <= kUnrollTripCountThreshold &&
+        trip_count.value() * while_op->while_body()->instruction_count() <=
+            kUnrollExpandFactorThreshold;
+
+    int64_t partial_unroll_factor = 1;
+    if (unroll_factor_ != -1 && unroll_factor_ < trip_count) {
+      partial_unroll_factor = unroll_factor_;
+    } else if (!can_fully_unroll && partial_unroll_options_.has_value()) {
+      TF_ASSIGN_OR_RETURN(
+          partial_unroll_factor,
+          ChoosePartialUnrollFactor(while_op, trip_count.value()));
+    }
+    if (partial_unroll_factor > 1 && partial_unroll_factor < trip_count) {
+      VLOG(3) << "Partially unrolling while instruction "
+              << while_op->ToShortString() << " by " << partial_unroll_factor;
+      TF_RETURN_IF_ERROR(PartiallyUnrollTrivialLoop(
+          while_op, *indvar_tuple_idx, init_value.value(), trip_count.value(),
+          partial_unroll_factor));
+      TF_RETURN_IF_ERROR(
+          AsyncOpCanonicalizer().Run(module, execution_threads).status());
+      TF_RETURN_IF_ERROR(
+          FlattenCallGraph().Run(module, execution_threads).status());
+      changed = true;
       continue;
     }
 
-    unroll_factor_current_loop = trip_count.value();
-
-    // TODO(b/291628533): Extract this to the unroller config. We don't unroll
-    // loops that increase the instruction count by more than
-    // kUnrollExpandFactorThreshold.
-    if (trip_count.value() * while_op->while_body()->instruction_count() >
-        kUnrollExpandFactorThreshold) {
-      VLOG(3) << "Not attempting to unroll due to instruction count increase "
-                 "explosion.";
+    if (!can_fully_unroll && partial_unroll_factor < trip_count) {
+      VLOG(3) << "Not attempting to fully unroll due to the trip count or "
+                 "instruction count increase explosion.";
       VLOG(3) << "New instruction count: "
               << trip_count.value() *
                      while_op->while_body()->instruction_count();
       continue;
     }
-
-    std::optional<int64_t> init_value =
-        LiteralUtil::LiteralAsScalarInt64(indvar_iter_val);
-    // Init value must be int64_t at this point since we found the trip count.
-    CHECK(init_value.has_value());
+    const int64_t unroll_factor_current_loop = trip_count.value();
 
     unrolled_current_loop = true;
     VLOG(3) << "Unrolling while instruction " << while_op->ToShortString()
@@ -17,11 +17,15 @@ limitations under the License.
 #define XLA_SERVICE_WHILE_LOOP_UNROLLER_H_
 
 #include <cstdint>
+#include <optional>
+#include <utility>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "xla/hlo/ir/hlo_instruction.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/hlo_cost_analysis.h"
 #include "xla/service/hlo_pass_interface.h"
 #include "xla/statusor.h"
 
@@ -30,7 +34,13 @@ namespace xla {
 // This pass unrolls while loops with the given unrolling factor. The value of
 // unroll_factor = -1 will fully unroll the loop.
 //
-// TODO(b/288130138): Currently, we `only` support full unrolling.
+// Partially unrolled loops execute `unroll_factor` iterations of the original
+// body per iteration, after peeling off the first `trip_count % unroll_factor`
+// iterations. A factor larger than the trip count fully unrolls the loop.
+//
+// If partial unroll options are given, loops that are too large to be fully
+// unrolled are partially unrolled by a factor chosen from the estimated time
+// of their body and the overhead of an iteration.
 //
 // The trip count for loops is calculated based on
 // `MatchTrivialLoopTripCount` function in
@@ -41,9 +51,28 @@ class WhileLoopUnroller : public HloModulePass {
  public:
   ~WhileLoopUnroller() override = default;
 
+  struct PartialUnrollOptions {
+    // Used to estimate the time the body of a loop takes. The per second rates
+    // must be set.
+    HloCostAnalysis::Options cost_analysis_options;
+    // The time an iteration takes on top of the time of its body, e.g. to read
+    // the loop condition on the host.
+    float iteration_overhead_seconds = 0;
+    // Loops are unrolled until the overhead is at most this fraction of the
+    // time of an iteration.
+    float max_overhead_fraction = 0.1;
+    // Code size budget: the maximum number of instructions in an unrolled body.
+    int64_t max_unrolled_instruction_count = 800;
+    int64_t max_unroll_factor = 16;
+  };
+
   // Default unroll_factor of -1 indicates full unrolling
   explicit WhileLoopUnroller(int64_t unroll_factor = -1)
       : unroll_factor_(unroll_factor) {}
+  // Fully unrolls small loops and partially unrolls the other ones.
+  explicit WhileLoopUnroller(PartialUnrollOptions partial_unroll_options)
+      : unroll_factor_(-1),
+        partial_unroll_options_(std::move(partial_unroll_options)) {}
 
   absl::string_view name() const override { return "while_loop_unroller"; }
 
@@ -53,7 +82,13 @@ class WhileLoopUnroller : public HloModulePass {
       const absl::flat_hash_set<absl::string_view>& execution_threads) override;
 
  private:
+  // Returns the factor to partially unroll `while_op` by, or 1 if the loop
+  // should not be unrolled.
+  StatusOr<int64_t> ChoosePartialUnrollFactor(const HloInstruction* while_op,
+                                              int64_t trip_count) const;
+
   int64_t unroll_factor_;
+  std::optional<PartialUnrollOptions> partial_unroll_options_;
 };
 
 }  // namespace xla
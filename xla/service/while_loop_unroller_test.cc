@@ -22,12 +22,17 @@ limitations under the License.
 #include <utility>
 
 #include <gtest/gtest.h>
+#include "absl/algorithm/container.h"
 #include "absl/log/log.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 #include "absl/types/span.h"
+#include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_opcode.h"
 #include "xla/literal.h"
+#include "xla/shape.h"
+#include "xla/shape_util.h"
 #include "xla/tests/hlo_test_base.h"
 #include "xla/tests/literal_test_util.h"
 #include "xla/tests/verified_hlo_module.h"
@@ -37,6 +42,15 @@ namespace {
 
 class WhileLoopUnrollerTest : public HloTestBase {
  protected:
+  // Counts the adds of the loop state arrays, one per iteration.
+  static int64_t CountArrayAdds(const HloComputation* computation) {
+    return absl::c_count_if(
+        computation->instructions(), [](const HloInstruction* instr) {
+          return instr->opcode() == HloOpcode::kAdd &&
+                 !ShapeUtil::IsScalar(instr->shape());
+        });
+  }
+
   [[nodiscard]] std::unique_ptr<VerifiedHloModule> MakeModuleWithSimpleLoop(
       int num_iters);
   [[nodiscard]] std::unique_ptr<VerifiedHloModule>
@@ -425,7 +439,52 @@ TEST_F(WhileLoopUnrollerTest, LoopWithControlDep) {
 
 TEST_F(WhileLoopUnrollerTest, SimpleLoopPartialUnroll) {
   auto m = MakeModuleWithSimpleLoop(/*num_iters=*/5);
-  EXPECT_FALSE(WhileLoopUnroller(/*unroll_factor=*/3).Run(m.get()).value());
+  Literal expected = ExecuteAndTransfer(m->Clone(), {});
+  EXPECT_TRUE(WhileLoopUnroller(/*unroll_factor=*/3).Run(m.get()).value());
+
+  // Two iterations are peeled off, and the body executes three iterations.
+  const HloInstruction* while_op = FindInstruction(m.get(), HloOpcode::kWhile);
+  ASSERT_NE(while_op, nullptr);
+  EXPECT_EQ(CountArrayAdds(while_op->while_body()), 3);
+  EXPECT_EQ(CountArrayAdds(m->entry_computation()), 2);
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, ExecuteAndTransfer(
+                                                   std::move(m), {})));
+}
+
+TEST_F(WhileLoopUnrollerTest, SimpleLoopPartialUnrollFactorAboveTripCount) {
+  UnrollAndCompare(MakeModuleWithSimpleLoop(/*num_iters=*/5), {},
+                   /*unroll_factor=*/8);
+}
+
+TEST_F(WhileLoopUnrollerTest, PartialUnrollFactorFromCostModel) {
+  auto m = MakeModuleWithSimpleLoop(/*num_iters=*/1000);
+  Literal expected = ExecuteAndTransfer(m->Clone(), {});
+
+  EXPECT_FALSE(WhileLoopUnroller().Run(m->Clone().get()).value());
+
+  WhileLoopUnroller::PartialUnrollOptions options;
+  options.cost_analysis_options.shape_size = [](const Shape& shape) {
+    return ShapeUtil::ByteSizeOf(shape, /*pointer_size=*/8);
+  };
+  options.cost_analysis_options.set_flops_per_second(1e12);
+  options.cost_analysis_options.set_bytes_per_second(1e11);
+  options.iteration_overhead_seconds = 1e-5;
+  options.max_unroll_factor = 16;
+  EXPECT_TRUE(WhileLoopUnroller(options).Run(m.get()).value());
+
+  // The overhead dominates the tiny body, so the factor is the largest one.
+  const HloInstruction* while_op = FindInstruction(m.get(), HloOpcode::kWhile);
+  ASSERT_NE(while_op, nullptr);
+  EXPECT_EQ(CountArrayAdds(while_op->while_body()), 16);
+  EXPECT_EQ(CountArrayAdds(m->entry_computation()), 1000 % 16);
+  EXPECT_TRUE(LiteralTestUtil::Equal(expected, ExecuteAndTransfer(
+                                                   std::move(m), {})));
+
+  // Without overhead, the loop is not unrolled.
+  options.iteration_overhead_seconds = 0;
+  EXPECT_FALSE(WhileLoopUnroller(options)
+                   .Run(MakeModuleWithSimpleLoop(/*num_iters=*/1000).get())
+                   .value());
 }
 
 TEST_F(WhileLoopUnrollerTest, IndirectBodyInc) {
@@ -0,0 +1,283 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/xla_compile_lib.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
+#include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/IR/DialectRegistry.h"  // from @llvm-project
+#include "mlir/Parser/Parser.h"  // from @llvm-project
+#include "stablehlo/dialect/Register.h"  // from @stablehlo
+#include "xla/autotune_results.pb.h"
+#include "xla/debug_options_flags.h"
+#include "xla/mlir_hlo/mhlo/IR/hlo_ops.h"
+#include "xla/pjrt/mlir_to_hlo.h"
+#include "xla/service/compiler.h"
+#include "xla/service/cpu/cpu_compiler.h"
+#include "xla/service/cpu/cpu_executable.h"
+#include "xla/status.h"
+#include "xla/statusor.h"
+#include "xla/tools/hlo_module_loader.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/protobuf.h"
+#include "tsl/platform/threadpool.h"
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#include "xla/service/gpu/executable.pb.h"
+#include "xla/service/gpu/gpu_compiler.h"
+#endif
+#if GOOGLE_CUDA
+#include "xla/service/gpu/nvptx_compiler.h"
+#elif TENSORFLOW_USE_ROCM
+#include "xla/service/gpu/amdgpu_compiler.h"
+#endif
+
+namespace xla {
+namespace xla_compile {
+
+StatusOr<std::string> AotCompileCpuExecutable(
+    cpu::CpuCompiler& cpu_compiler, std::unique_ptr<HloModule> hlo_module) {
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<cpu::CpuExecutable> cpu_executable,
+      cpu_compiler.CompileXlaRuntimeCpuExecutable(std::move(hlo_module)));
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<AotCompilationResult> aot_result,
+                      cpu_compiler.Export(cpu_executable.get()));
+  TF_ASSIGN_OR_RETURN(std::string result, aot_result->SerializeAsString());
+  return result;
+}
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+StatusOr<std::string> AotCompileGpuExecutable(
+    gpu::GpuCompiler& gpu_compiler, std::unique_ptr<HloModule> hlo_module,
+    const Compiler::TargetConfig& target_config) {
+  Compiler::CompileOptions compile_options;
+  compile_options.target_config = target_config;
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<HloModule> module_after_opt,
+      gpu_compiler.RunHloPasses(std::move(hlo_module),
+                                /*stream_exec=*/nullptr, compile_options));
+
+  auto module_group =
+      std::make_unique<HloModuleGroup>(std::move(module_after_opt));
+  AotCompilationOptions aot_options(gpu_compiler.PlatformId());
+  aot_options.set_target_config(target_config);
+  TF_ASSIGN_OR_RETURN(
+      std::vector<std::unique_ptr<AotCompilationResult>> aot_results,
+      gpu_compiler.CompileAheadOfTime(std::move(module_group), aot_options));
+  TF_ASSIGN_OR_RETURN(std::string result, aot_results[0]->SerializeAsString());
+  return result;
+}
+
+StatusOr<Compiler::TargetConfig> LoadGpuTargetConfig(
+    const std::string& gpu_target_config_path) {
+  std::string gpu_target_config_string;
+  TF_RETURN_IF_ERROR(tsl::ReadFileToString(tsl::Env::Default(),
+                                           gpu_target_config_path,
+                                           &gpu_target_config_string));
+  stream_executor::GpuTargetConfigProto gpu_target_config_proto;
+
+  if (!tsl::protobuf::TextFormat::ParseFromString(gpu_target_config_string,
+                                                  &gpu_target_config_proto)) {
+    return FailedPrecondition("Failed to parse GpuTargetConfigProto");
+  }
+
+  return Compiler::TargetConfig(gpu_target_config_proto);
+}
+#endif
+
+xla::StatusOr<std::unique_ptr<HloModule>> LoadModule(
+    const std::string& module_path) {
+  auto format = std::string(tsl::io::Extension(module_path));
+  if (format == "hlo" || format == "txt") {
+    return LoadModuleFromFile(
+        module_path, hlo_module_loader_details::Config(),
+        /*format=*/"hlo", [&](HloModuleConfig* c) {}, nullptr);
+  }
+  std::string module_string;
+  TF_RETURN_IF_ERROR(
+      tsl::ReadFileToString(tsl::Env::Default(), module_path, &module_string));
+
+  mlir::DialectRegistry dialects;
+  // TODO(b/248362914): Register all required dialects.
+  dialects.insert<mlir::arith::ArithDialect>();
+  dialects.insert<mlir::mhlo::MhloDialect>();
+  dialects.insert<mlir::func::FuncDialect>();
+  mlir::stablehlo::registerAllDialects(dialects);
+
+  // Parse MHLO module.
+  auto threading = mlir::MLIRContext::Threading::DISABLED;
+  auto ctx = std::make_unique<mlir::MLIRContext>(dialects, threading);
+  mlir::OwningOpRef<mlir::ModuleOp> module =
+      mlir::parseSourceString<mlir::ModuleOp>(module_string, ctx.get());
+
+  // Convert Mhlo to Hlo Module.
+  XlaComputation xla_computation;
+  TF_RETURN_IF_ERROR(
+      MlirToXlaComputation(*module, xla_computation, false, false));
+  HloModuleProto hlo_module_proto = xla_computation.proto();
+
+  TF_ASSIGN_OR_RETURN(ProgramShape shape, xla_computation.GetProgramShape());
+  DebugOptions debug_options = DefaultDebugOptionsIgnoringFlags();
+  HloModuleConfig config(shape);
+  config.set_debug_options(debug_options);
+  return HloModule::CreateFromProto(hlo_module_proto, config);
+}
+
+StatusOr<std::vector<CompilationJob>> ParseManifest(
+    const std::string& manifest_path,
+    const std::string& default_gpu_target_config_path) {
+  std::string manifest;
+  TF_RETURN_IF_ERROR(
+      tsl::ReadFileToString(tsl::Env::Default(), manifest_path, &manifest));
+  std::vector<CompilationJob> jobs;
+  int line_number = 0;
+  for (absl::string_view line : absl::StrSplit(manifest, '\n')) {
+    ++line_number;
+    std::vector<std::string> fields =
+        absl::StrSplit(line, absl::ByAnyChar(" \t\r"), absl::SkipEmpty());
+    if (fields.empty() || fields[0][0] == '#') continue;
+    if (fields.size() != 2 && fields.size() != 3) {
+      return InvalidArgument("Malformed line %d in manifest %s: %s",
+                             line_number, manifest_path, line);
+    }
+    jobs.push_back({std::move(fields[0]), std::move(fields[1]),
+                    fields.size() == 3 ? std::move(fields[2])
+                                       : default_gpu_target_config_path});
+  }
+  return jobs;
+}
+
+xla::Status CompileModules(const std::vector<CompilationJob>& jobs,
+                           const std::string& platform,
+                           const std::string& autotune_results_path,
+                           int num_threads) {
+  std::function<StatusOr<std::string>(std::unique_ptr<HloModule>,
+                                       const CompilationJob&)>
+      compile;
+  cpu::CpuCompiler cpu_compiler;
+#if GOOGLE_CUDA
+  gpu::NVPTXCompiler gpu_compiler;
+#elif TENSORFLOW_USE_ROCM
+  gpu::AMDGPUCompiler gpu_compiler;
+#endif
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  absl::flat_hash_map<std::string, Compiler::TargetConfig> gpu_target_configs;
+#endif
+  if (platform == "cpu") {
+    compile = [&](std::unique_ptr<HloModule> hlo_module,
+                  const CompilationJob& job) {
+      return AotCompileCpuExecutable(cpu_compiler, std::move(hlo_module));
+    };
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  } else if (platform == "gpu") {
+    // Parse each GpuTargetConfig once, before any compilation starts.
+    for (const CompilationJob& job : jobs) {
+      if (gpu_target_configs.contains(job.gpu_target_config_path)) continue;
+      TF_ASSIGN_OR_RETURN(Compiler::TargetConfig gpu_target_config,
+                          LoadGpuTargetConfig(job.gpu_target_config_path));
+      gpu_target_configs.emplace(job.gpu_target_config_path,
+                                 std::move(gpu_target_config));
+    }
+
+    if (!autotune_results_path.empty()) {
+      TF_RETURN_IF_ERROR(gpu::AutotunerUtil::LoadAutotuneResultsFromFile(
+          autotune_results_path));
+    }
+    compile = [&](std::unique_ptr<HloModule> hlo_module,
+                  const CompilationJob& job) {
+      return AotCompileGpuExecutable(
+          gpu_compiler, std::move(hlo_module),
+          gpu_target_configs.at(job.gpu_target_config_path));
+    };
+#endif
+  } else {
+    return Unimplemented("platform %s not supported", platform);
+  }
+
+  auto compile_job = [&](const CompilationJob& job) -> xla::Status {
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> hlo_module,
+                        LoadModule(job.module_path));
+
+    // Run AOT compilation.
+    TF_ASSIGN_OR_RETURN(std::string result,
+                        compile(std::move(hlo_module), job));
+
+    return tsl::WriteStringToFile(tsl::Env::Default(), job.output_path,
+                                  result);
+  };
+
+  std::vector<xla::Status> statuses(jobs.size());
+  if (num_threads <= 1 || jobs.size() <= 1) {
+    for (int i = 0; i < jobs.size(); ++i) {
+      statuses[i] = compile_job(jobs[i]);
+    }
+  } else {
+    // The destructor of the thread pool waits for all scheduled jobs.
+    tsl::thread::ThreadPool thread_pool(tsl::Env::Default(), "xla_compile",
+                                        num_threads);
+    for (int i = 0; i < jobs.size(); ++i) {
+      thread_pool.Schedule([&, i] { statuses[i] = compile_job(jobs[i]); });
+    }
+  }
+
+  xla::Status result;
+  int num_failed = 0;
+  for (int i = 0; i < jobs.size(); ++i) {
+    if (statuses[i].ok()) continue;
+    ++num_failed;
+    LOG(ERROR) << "Compilation of " << jobs[i].module_path
+               << " failed: " << statuses[i];
+    if (result.ok()) result = statuses[i];
+  }
+  if (num_failed > 1) {
+    return Internal("%d of %d modules failed to compile, first error: %s",
+                    num_failed, jobs.size(), result.ToString());
+  }
+  return result;
+}
+
+xla::Status XlaCompileMain(const std::string& module_path,
+                           const std::string& output_path,
+                           const std::string& platform,
+                           const std::string& gpu_target_config_path,
+                           const std::string& autotune_results_path) {
+  return CompileModules({{module_path, output_path, gpu_target_config_path}},
+                        platform, autotune_results_path, /*num_threads=*/1);
+}
+
+xla::Status XlaCompileBatchMain(const std::string& manifest_path,
+                                const std::string& platform,
+                                const std::string& gpu_target_config_path,
+                                const std::string& autotune_results_path,
+                                int num_threads) {
+  TF_ASSIGN_OR_RETURN(std::vector<CompilationJob> jobs,
+                      ParseManifest(manifest_path, gpu_target_config_path));
+  LOG(INFO) << "Compiling " << jobs.size() << " modules on " << num_threads
+            << " threads";
+  return CompileModules(jobs, platform, autotune_results_path, num_threads);
+}
+
+}  // end namespace xla_compile
+}  // end namespace xla
@@ -0,0 +1,71 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_SERVICE_XLA_COMPILE_LIB_H_
+#define XLA_SERVICE_XLA_COMPILE_LIB_H_
+
+#include <string>
+#include <vector>
+
+#include "xla/status.h"
+#include "xla/statusor.h"
+
+namespace xla {
+namespace xla_compile {
+
+// A module to compile, and where to write the result.
+struct CompilationJob {
+  std::string module_path;
+  std::string output_path;
+  std::string gpu_target_config_path;
+};
+
+// Reads the manifest at `manifest_path`. Each line is
+// '<module_file> <output_file> [<gpu_target_config>]', where the GPU target
+// config defaults to `default_gpu_target_config_path`. Empty lines and lines
+// starting with '#' are ignored.
+StatusOr<std::vector<CompilationJob>> ParseManifest(
+    const std::string& manifest_path,
+    const std::string& default_gpu_target_config_path);
+
+// Compiles `jobs` on `num_threads` threads. All modules share one compiler
+// instance, so the process-wide state (LLVM initialization, the loaded
+// autotune results and the compiler's caches) is set up only once. A failing
+// module doesn't stop the others; the error of the first one is returned.
+Status CompileModules(const std::vector<CompilationJob>& jobs,
+                      const std::string& platform,
+                      const std::string& autotune_results_path,
+                      int num_threads);
+
+// Compiles the module at `module_path` and writes the serialized
+// AotCompilationResult to `output_path`.
+Status XlaCompileMain(const std::string& module_path,
+                      const std::string& output_path,
+                      const std::string& platform,
+                      const std::string& gpu_target_config_path,
+                      const std::string& autotune_results_path);
+
+// Compiles the modules listed in the manifest at `manifest_path`, see
+// ParseManifest and CompileModules.
+Status XlaCompileBatchMain(const std::string& manifest_path,
+                           const std::string& platform,
+                           const std::string& gpu_target_config_path,
+                           const std::string& autotune_results_path,
+                           int num_threads);
+
+}  // namespace xla_compile
+}  // namespace xla
+
+#endif  // XLA_SERVICE_XLA_COMPILE_LIB_H_
@@ -0,0 +1,97 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/service/xla_compile_lib.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tsl/lib/core/status_test_util.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
+#include "tsl/platform/status_matchers.h"
+#include "tsl/platform/statusor.h"
+#include "tsl/platform/test.h"
+
+namespace xla {
+namespace xla_compile {
+namespace {
+
+using ::testing::HasSubstr;
+using ::tsl::testing::StatusIs;
+
+std::string WriteManifest(const std::string& name,
+                          const std::string& contents) {
+  std::string path = tsl::io::JoinPath(tsl::testing::TmpDir(), name);
+  TF_CHECK_OK(tsl::WriteStringToFile(tsl::Env::Default(), path, contents));
+  return path;
+}
+
+TEST(XlaCompileLibTest, ParseManifest) {
+  std::string path = WriteManifest("manifest.txt", R"(# A comment.
+a.mlir a.out
+
+  # An indented comment.
+b.hlo	b.out   b_target_config.txt
+)");
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<CompilationJob> jobs,
+                          ParseManifest(path, "default_target_config.txt"));
+  ASSERT_EQ(jobs.size(), 2);
+  EXPECT_EQ(jobs[0].module_path, "a.mlir");
+  EXPECT_EQ(jobs[0].output_path, "a.out");
+  EXPECT_EQ(jobs[0].gpu_target_config_path, "default_target_config.txt");
+  EXPECT_EQ(jobs[1].module_path, "b.hlo");
+  EXPECT_EQ(jobs[1].output_path, "b.out");
+  EXPECT_EQ(jobs[1].gpu_target_config_path, "b_target_config.txt");
+}
+
+TEST(XlaCompileLibTest, ParseManifestRejectsMalformedLines) {
+  std::string missing_output =
+      WriteManifest("missing_output.txt", "a.mlir a.out\nb.mlir\n");
+  EXPECT_THAT(
+      ParseManifest(missing_output, "").status(),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("line 2")));
+
+  std::string extra_field = WriteManifest(
+      "extra_field.txt", "# A comment.\na.mlir a.out config.txt extra\n");
+  EXPECT_THAT(
+      ParseManifest(extra_field, "").status(),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("line 2")));
+}
+
+TEST(XlaCompileLibTest, CompileModulesCompilesTheOthersWhenOneFails) {
+  std::string module_path = tsl::io::JoinPath(
+      tsl::testing::XlaSrcRoot(), "service", "xla_aot_compile_test.hlo");
+  std::string output_path =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "xla_aot_compile_test.out");
+  std::vector<CompilationJob> jobs = {
+      {tsl::io::JoinPath(tsl::testing::TmpDir(), "missing.hlo"),
+       tsl::io::JoinPath(tsl::testing::TmpDir(), "missing.out"), ""},
+      {module_path, output_path, ""},
+  };
+
+  EXPECT_FALSE(CompileModules(jobs, "cpu", /*autotune_results_path=*/"",
+                              /*num_threads=*/2)
+                   .ok());
+  // The failure of the first module doesn't stop the second one.
+  TF_EXPECT_OK(tsl::Env::Default()->FileExists(output_path));
+}
+
+}  // namespace
+}  // namespace xla_compile
+}  // namespace xla
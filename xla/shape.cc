@@ -36,8 +36,9 @@ namespace xla {
 Shape::Shape() = default;
 Shape::~Shape() = default;
 Shape::Shape(const Shape&) = default;
-Shape::Shape(Shape&&) = default;
+Shape::Shape(Shape&&) noexcept = default;
 Shape& Shape::operator=(const Shape&) = default;
+Shape& Shape::operator=(Shape&&) noexcept = default;
 
 Shape::Shape(const ShapeProto& shape_proto) {
   set_element_type(shape_proto.element_type());
@@ -158,6 +159,11 @@ Shape* Shape::add_tuple_shapes() {
 }
 
 bool Shape::Equal::operator()(const Shape& lhs, const Shape& rhs) {
+  // Shapes are frequently compared with themselves, e.g. when checking the
+  // shape of an instruction against the shape of its only operand.
+  if (&lhs == &rhs) {
+    return true;
+  }
   if (lhs.IsTuple()) {
     return rhs.IsTuple() &&
            absl::c_equal(
@@ -220,12 +226,10 @@ bool Shape::Equal::operator()(const Shape& lhs, const Shape& rhs) {
   }
 
   if (!ignore_dynamic_dimension_) {
-    for (int i = 0; i < lhs.rank(); ++i) {
-      if (lhs.is_dynamic_dimension(i) != rhs.is_dynamic_dimension(i)) {
-        VLOG(3)
-            << "CompareShapes: lhs and rhs have different dynamic dimensions.";
-        return false;
-      }
+    if (lhs.dynamic_dimensions() != rhs.dynamic_dimensions()) {
+      VLOG(3)
+          << "CompareShapes: lhs and rhs have different dynamic dimensions.";
+      return false;
     }
   }
   return true;
@@ -241,6 +245,7 @@ ProgramShape::~ProgramShape() = default;
 ProgramShape::ProgramShape(const ProgramShape&) = default;
 ProgramShape::ProgramShape(ProgramShape&&) = default;
 ProgramShape& ProgramShape::operator=(const ProgramShape&) = default;
+ProgramShape& ProgramShape::operator=(ProgramShape&&) = default;
 
 ProgramShape::ProgramShape(const ProgramShapeProto& program_shape_proto) {
   for (const ShapeProto& shape_proto : program_shape_proto.parameters()) {
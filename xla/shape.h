@@ -42,8 +42,11 @@ class Shape {
   Shape();
   ~Shape();
   Shape(const Shape&);
-  Shape(Shape&&);
+  // Moves are noexcept so that containers of shapes, e.g. the tuple shapes,
+  // move their elements instead of copying them when they grow.
+  Shape(Shape&&) noexcept;
   Shape& operator=(const Shape&);
+  Shape& operator=(Shape&&) noexcept;
 
   // Construct a shape from a ShapeProto.
   explicit Shape(const ShapeProto& shape_proto);
@@ -331,6 +334,7 @@ class ProgramShape {
   ProgramShape(const ProgramShape&);
   ProgramShape(ProgramShape&&);
   ProgramShape& operator=(const ProgramShape&);
+  ProgramShape& operator=(ProgramShape&&);
 
   // Creates a ProgramShape from a ProgramShapeProto protobuf.
   explicit ProgramShape(const ProgramShapeProto& program_shape_proto);
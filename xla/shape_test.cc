@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "xla/shape.h"
 
+#include <type_traits>
+#include <utility>
+
 #include "absl/hash/hash_testing.h"
 #include "xla/layout.h"
 #include "xla/shape_util.h"
@@ -103,6 +106,29 @@ TEST_F(ShapeTest, EqualityTest) {
             ShapeUtil::MakeShapeWithDenseLayout(F32, {23, 44}, {1, 0}));
 }
 
+TEST_F(ShapeTest, EqualityWithDynamicDimensions) {
+  Shape dynamic_matrix = matrix_;
+  dynamic_matrix.set_dynamic_dimension(1, true);
+  EXPECT_EQ(matrix_, matrix_);
+  EXPECT_NE(matrix_, dynamic_matrix);
+  EXPECT_TRUE(
+      Shape::Equal().IgnoreDynamicDimension()(matrix_, dynamic_matrix));
+}
+
+TEST_F(ShapeTest, MoveLeavesContentsInDestination) {
+  static_assert(std::is_nothrow_move_constructible_v<Shape>);
+  static_assert(std::is_nothrow_move_assignable_v<Shape>);
+
+  Shape tuple = nested_tuple_;
+  Shape moved;
+  moved = std::move(tuple);
+  EXPECT_EQ(moved, nested_tuple_);
+
+  Shape matrix = matrix_;
+  Shape moved_matrix(std::move(matrix));
+  EXPECT_EQ(moved_matrix, matrix_);
+}
+
 TEST_F(ShapeTest, IsStatic) {
   EXPECT_TRUE(opaque_.is_static());
   EXPECT_TRUE(token_.is_static());
@@ -1835,29 +1835,55 @@ struct ParallelState {
     const Shape& shape, absl::Span<const int64_t> base,
     absl::Span<const int64_t> count, absl::Span<const int64_t> incr,
     const ForEachParallelVisitorFunction& visitor_function) {
+  // Each task visits a range of consecutive indexes, so that the scheduling
+  // overhead is amortized over many cheap visits. A few chunks per thread
+  // balance the load when visits have different costs.
+  static constexpr int64_t kChunksPerThread = 4;
+
   ForEachState s(shape, base, count, incr);
-  ParallelState pstate(s.CalculateNumSteps());
   if (s.IsZeroElementArray()) {
-    return pstate.status;
+    return OkStatus();
   }
-  // Allows handling R0 arrays, such that the visitor function will be called
-  // once with the proper empty indexes.
-  int64_t n = -1;
-  while (n < s.rank) {
-    auto indexes_copy = s.indexes;
-    pstate.pool->Schedule([indexes_copy, &visitor_function, &pstate] {
+  // This works for R0 arrays as well, which are visited once with the proper
+  // empty indexes.
+  const int64_t num_steps = s.CalculateNumSteps();
+  const int64_t max_num_chunks =
+      kChunksPerThread * GetForEachIndexParallelThreadCount();
+  const int64_t num_chunks = std::min(num_steps, max_num_chunks);
+  const int64_t chunk_size = CeilOfRatio(num_steps, num_chunks);
+  ParallelState pstate(num_chunks);
+  for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+    pstate.pool->Schedule([&, chunk] {
       const int thread_id = pstate.pool->CurrentThreadId();
-      StatusOr<bool> result = visitor_function(indexes_copy, thread_id);
-      if (!result.ok()) {
+      const int64_t begin = chunk * chunk_size;
+      const int64_t end = std::min(begin + chunk_size, num_steps);
+
+      // Finds the indexes of step `begin`, in minor to major order.
+      ForEachState chunk_state(shape, base, count, incr);
+      int64_t step = begin;
+      for (int64_t n = 0; n < chunk_state.rank && step > 0; ++n) {
+        const int64_t dim = chunk_state.minor_to_major[n];
+        const int64_t dim_steps =
+            count[dim] == 0 ? 1 : 1 + (count[dim] - 1) / incr[dim];
+        chunk_state.indexes[dim] = base[dim] + (step % dim_steps) * incr[dim];
+        step /= dim_steps;
+      }
+
+      Status status;
+      for (int64_t i = begin; i < end && status.ok(); ++i) {
+        StatusOr<bool> result =
+            visitor_function(chunk_state.indexes_span, thread_id);
+        status = result.status();
+        chunk_state.IncrementDim();
+      }
+      if (!status.ok()) {
         absl::MutexLock lock(&pstate.mu);
         if (pstate.status.ok()) {
-          pstate.status = result.status();
+          pstate.status = status;
         }
       }
       pstate.TaskComplete();
     });
-    // Increments dimensions in minor to major order.
-    n = s.IncrementDim();
   }
 
   pstate.Wait();
@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/shape_util.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <numeric>
 #include <optional>
@@ -26,6 +27,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
+#include "xla/index_util.h"
 #include "xla/layout.h"
 #include "xla/layout_util.h"
 #include "xla/shape.h"
@@ -738,6 +740,39 @@ TEST(ShapeUtilTest, ForEachIndexParallel_DimensionPinnedWithZeros) {
   }
 }
 
+TEST(ShapeUtilTest, ForEachIndexParallel_VisitsSameIndexesAsForEachIndex) {
+  // Enough indexes to be split in many chunks, with a non-default layout and
+  // increments that don't divide the counts.
+  Shape shape =
+      ShapeUtil::MakeShapeWithDenseLayout(F32, {37, 5, 29}, {0, 2, 1});
+  std::vector<int64_t> base = {1, 0, 2};
+  std::vector<int64_t> count = {35, 5, 26};
+  std::vector<int64_t> incr = {2, 1, 3};
+
+  auto linear_index = [&](absl::Span<const int64_t> indexes) {
+    return IndexUtil::MultidimensionalIndexToLinearIndex(shape, indexes);
+  };
+
+  std::vector<std::atomic<int>> visits(ShapeUtil::ElementsIn(shape));
+  ShapeUtil::ForEachIndexParallel(
+      shape, base, count, incr,
+      [&](absl::Span<const int64_t> indexes, int) -> StatusOr<bool> {
+        ++visits[linear_index(indexes)];
+        return true;
+      });
+
+  std::vector<int> expected_visits(visits.size());
+  ShapeUtil::ForEachIndex(
+      shape, base, count, incr,
+      [&](absl::Span<const int64_t> indexes) -> StatusOr<bool> {
+        ++expected_visits[linear_index(indexes)];
+        return true;
+      });
+  for (int64_t i = 0; i < visits.size(); ++i) {
+    EXPECT_EQ(visits[i], expected_visits[i]) << i;
+  }
+}
+
 TEST(ShapeUtilTest, ForEachIndexParallel_WithSkips) {
   Shape shape = ShapeUtil::MakeShape(F32, {10, 10});
   int64_t output[10][10] = {};
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/stream_executor/command_buffer.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -88,6 +89,12 @@ tsl::Status CommandBuffer::MemcpyDeviceToDevice(DeviceMemoryBase* dst,
   return implementation_->MemcpyDeviceToDevice(dst, src, size);
 }
 
+tsl::Status CommandBuffer::Memset(DeviceMemoryBase* dst,
+                                  BitPattern bit_pattern,
+                                  size_t num_elements) {
+  return implementation_->Memset(dst, bit_pattern, num_elements);
+}
+
 CommandBuffer::Mode CommandBuffer::mode() const {
   return implementation_->mode();
 }
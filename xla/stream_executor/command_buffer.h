@@ -16,9 +16,11 @@ limitations under the License.
 #ifndef XLA_STREAM_EXECUTOR_COMMAND_BUFFER_H_
 #define XLA_STREAM_EXECUTOR_COMMAND_BUFFER_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <tuple>
+#include <variant>
 
 #include "absl/functional/any_invocable.h"
 #include "xla/stream_executor/kernel.h"
@@ -70,6 +72,10 @@ class CommandBuffer {
   //
   enum class Mode { kPrimary, kNested };
 
+  // Bit pattern for memset commands. Element size is defined by the type of
+  // the stored value.
+  using BitPattern = std::variant<uint8_t, uint16_t, uint32_t>;
+
   //===--------------------------------------------------------------------===//
   // Command buffer constructors
   //===--------------------------------------------------------------------===//
@@ -105,6 +111,11 @@ class CommandBuffer {
   tsl::Status MemcpyDeviceToDevice(DeviceMemoryBase* dst,
                                    const DeviceMemoryBase& src, uint64_t size);
 
+  // Adds a memset command to the command buffer that fills `num_elements`
+  // elements of the size of `bit_pattern` type starting at `dst`.
+  tsl::Status Memset(DeviceMemoryBase* dst, BitPattern bit_pattern,
+                     size_t num_elements);
+
   // Finalizes command buffer and makes it executable. Once command buffer is
   // finalized no commands can be added to it.
   tsl::Status Finalize();
@@ -181,6 +181,53 @@ TEST(CudaCommandBufferTest, LaunchNestedCommandBuffer) {
   ASSERT_EQ(dst, expected);
 }
 
+TEST(CudaCommandBufferTest, MemsetAndUpdate) {
+  Platform* platform = MultiPlatformManager::PlatformWithName("CUDA").value();
+  StreamExecutor* executor = platform->ExecutorForDevice(0).value();
+
+  Stream stream(executor);
+  stream.Init();
+  ASSERT_TRUE(stream.ok());
+
+  int64_t length = 4;
+  int64_t byte_length = sizeof(int32_t) * length;
+
+  DeviceMemory<int32_t> a = executor->AllocateArray<int32_t>(length, 0);
+  DeviceMemory<int32_t> b = executor->AllocateArray<int32_t>(length, 0);
+
+  // Create a command buffer with a single memset command.
+  auto cmd_buffer = CommandBuffer::Create(executor).value();
+  ASSERT_TRUE(cmd_buffer.Memset(&a, uint32_t{42}, length).ok());
+  ASSERT_TRUE(cmd_buffer.Finalize().ok());
+
+  ASSERT_TRUE(executor->Submit(&stream, cmd_buffer).ok());
+
+  // Copy `a` data back to host.
+  std::vector<int32_t> dst(4, 0);
+  stream.ThenMemcpy(dst.data(), a, byte_length);
+
+  std::vector<int32_t> expected = {42, 42, 42, 42};
+  ASSERT_EQ(dst, expected);
+
+  // Update command buffer to write into `b` buffer and copy it into `a`.
+  stream.ThenMemZero(&a, byte_length);
+  ASSERT_TRUE(cmd_buffer.Update().ok());
+  ASSERT_TRUE(cmd_buffer.Memset(&b, uint32_t{42}, length).ok());
+  ASSERT_TRUE(cmd_buffer.Finalize().ok());
+
+  ASSERT_TRUE(executor->Submit(&stream, cmd_buffer).ok());
+
+  // Copy `b` data back to host.
+  std::fill(dst.begin(), dst.end(), 0);
+  stream.ThenMemcpy(dst.data(), b, byte_length);
+  ASSERT_EQ(dst, expected);
+
+  // Buffer `a` was not touched by the updated command buffer.
+  std::fill(dst.begin(), dst.end(), 1);
+  stream.ThenMemcpy(dst.data(), a, byte_length);
+  ASSERT_EQ(dst, std::vector<int32_t>(4, 0));
+}
+
 //===----------------------------------------------------------------------===//
 // Performance benchmarks below
 //===----------------------------------------------------------------------===//
@@ -24,6 +24,7 @@ limitations under the License.
 #include <set>
 #include <string>
 #include <utility>
+#include <variant>
 
 #include "absl/base/casts.h"
 #include "absl/base/const_init.h"
@@ -814,6 +815,94 @@ GpuDriver::GraphNodeGetType(CUgraphNode node) {
   return ::tsl::OkStatus();
 }
 
+/* static */ tsl::Status GpuDriver::GraphExecMemcpyD2DNodeSetParams(
+    GpuContext* context, CUgraphExec exec, CUgraphNode node,
+    CUdeviceptr gpu_dst, CUdeviceptr gpu_src, uint64_t size) {
+  VLOG(2) << "Set memcpy d2d node params " << node << " in graph executable "
+          << exec << "; dst: " << reinterpret_cast<void*>(gpu_dst)
+          << "; src: " << reinterpret_cast<void*>(gpu_src) << "; size: " << size
+          << "; context: " << context->context();
+
+  CUDA_MEMCPY3D params;
+  memset(&params, 0, sizeof(params));
+
+  params.srcMemoryType = CU_MEMORYTYPE_DEVICE;
+  params.srcDevice = gpu_src;
+  params.dstMemoryType = CU_MEMORYTYPE_DEVICE;
+  params.dstDevice = gpu_dst;
+  params.WidthInBytes = size;
+  params.Height = 1;
+  params.Depth = 1;
+
+  RETURN_IF_CUDA_RES_ERROR(
+      cuGraphExecMemcpyNodeSetParams(exec, node, &params, context->context()),
+      "Failed to set memcpy d2d node params");
+
+  return ::tsl::OkStatus();
+}
+
+// Converts memset bit pattern into the element size and the 32-bit value
+// expected by the CUDA memset node parameters.
+static CUDA_MEMSET_NODE_PARAMS MemsetNodeParams(
+    CUdeviceptr dst, std::variant<uint8_t, uint16_t, uint32_t> bit_pattern,
+    uint64_t num_elements) {
+  CUDA_MEMSET_NODE_PARAMS params;
+  memset(&params, 0, sizeof(params));
+
+  params.dst = dst;
+  params.elementSize = std::visit(
+      [](auto value) { return static_cast<unsigned int>(sizeof(value)); },
+      bit_pattern);
+  params.value =
+      std::visit([](auto value) { return static_cast<unsigned int>(value); },
+                 bit_pattern);
+  params.width = num_elements;
+  params.height = 1;
+  params.pitch = 0;
+
+  return params;
+}
+
+/* static */ tsl::Status GpuDriver::GraphAddMemsetNode(
+    GpuContext* context, CUgraphNode* node, CUgraph graph,
+    absl::Span<CUgraphNode> deps, CUdeviceptr dst,
+    std::variant<uint8_t, uint16_t, uint32_t> bit_pattern,
+    uint64_t num_elements) {
+  VLOG(2) << "Add memset node to a graph " << graph
+          << "; dst: " << reinterpret_cast<void*>(dst)
+          << "; num_elements: " << num_elements
+          << "; context: " << context->context() << "; deps: " << deps.size();
+
+  CUDA_MEMSET_NODE_PARAMS params =
+      MemsetNodeParams(dst, bit_pattern, num_elements);
+
+  RETURN_IF_CUDA_RES_ERROR(
+      cuGraphAddMemsetNode(node, graph, deps.data(), deps.size(), &params,
+                           context->context()),
+      "Failed to add memset node to a CUDA graph");
+
+  return ::tsl::OkStatus();
+}
+
+/* static */ tsl::Status GpuDriver::GraphExecMemsetNodeSetParams(
+    GpuContext* context, CUgraphExec exec, CUgraphNode node, CUdeviceptr dst,
+    std::variant<uint8_t, uint16_t, uint32_t> bit_pattern,
+    uint64_t num_elements) {
+  VLOG(2) << "Set memset node params " << node << " in graph executable "
+          << exec << "; dst: " << reinterpret_cast<void*>(dst)
+          << "; num_elements: " << num_elements
+          << "; context: " << context->context();
+
+  CUDA_MEMSET_NODE_PARAMS params =
+      MemsetNodeParams(dst, bit_pattern, num_elements);
+
+  RETURN_IF_CUDA_RES_ERROR(
+      cuGraphExecMemsetNodeSetParams(exec, node, &params, context->context()),
+      "Failed to set memset node params");
+
+  return ::tsl::OkStatus();
+}
+
 /* static */ tsl::Status GpuDriver::GraphAddChildNode(
     CUgraphNode* node, CUgraph graph, absl::Span<CUgraphNode> deps,
     CUgraph child) {
@@ -827,6 +916,18 @@ GpuDriver::GraphNodeGetType(CUgraphNode node) {
   return ::tsl::OkStatus();
 }
 
+/* static */ tsl::Status GpuDriver::GraphExecChildNodeSetParams(
+    CUgraphExec exec, CUgraphNode node, CUgraph child) {
+  VLOG(2) << "Set child node params " << node << " in graph executable "
+          << exec << " to " << child;
+
+  RETURN_IF_CUDA_RES_ERROR(
+      cuGraphExecChildGraphNodeSetParams(exec, node, child),
+      "Failed to set CUDA graph child node params");
+
+  return ::tsl::OkStatus();
+}
+
 /* static */ tsl::Status GpuDriver::LaunchKernel(
     GpuContext* context, absl::string_view kernel_name, CUfunction function,
     unsigned int grid_dim_x, unsigned int grid_dim_y, unsigned int grid_dim_z,
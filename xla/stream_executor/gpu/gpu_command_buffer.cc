@@ -16,6 +16,7 @@ limitations under the License.
 #include "xla/stream_executor/gpu/gpu_command_buffer.h"
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 
@@ -198,6 +199,13 @@ tsl::Status GpuCommandBuffer::AddNestedCommandBuffer(
         node, graph_, {}, GpuCommandBuffer::Cast(&nested)->graph());
   }
 
+  // Updates child graph node in the executable graph.
+  if (state_ == State::kUpdate) {
+    GpuGraphNodeHandle node = nodes_[node_update_idx_++];
+    return GpuDriver::GraphExecChildNodeSetParams(
+        exec_, node, GpuCommandBuffer::Cast(&nested)->graph());
+  }
+
   return UnsupportedStateError(state_);
 }
 
@@ -214,6 +222,38 @@ tsl::Status GpuCommandBuffer::MemcpyDeviceToDevice(DeviceMemoryBase* dst,
                                             AsDevicePtr(src), size);
   }
 
+  // Updates memcpy node in the executable graph.
+  if (state_ == State::kUpdate) {
+    GpuGraphNodeHandle node = nodes_[node_update_idx_++];
+    return GpuDriver::GraphExecMemcpyD2DNodeSetParams(
+        parent_->gpu_context(), exec_, node, AsDevicePtr(*dst),
+        AsDevicePtr(src), size);
+  }
+
+  return UnsupportedStateError(state_);
+}
+
+tsl::Status GpuCommandBuffer::Memset(DeviceMemoryBase* dst,
+                                     CommandBuffer::BitPattern bit_pattern,
+                                     size_t num_elements) {
+  TF_RETURN_IF_ERROR(CheckNotFinalized());
+
+  // Adds a new memset node to the graph under construction.
+  if (state_ == State::kCreate) {
+    GpuGraphNodeHandle* node = &nodes_.emplace_back();
+    return GpuDriver::GraphAddMemsetNode(parent_->gpu_context(), node, graph_,
+                                         {}, AsDevicePtr(*dst), bit_pattern,
+                                         num_elements);
+  }
+
+  // Updates memset node in the executable graph.
+  if (state_ == State::kUpdate) {
+    GpuGraphNodeHandle node = nodes_[node_update_idx_++];
+    return GpuDriver::GraphExecMemsetNodeSetParams(
+        parent_->gpu_context(), exec_, node, AsDevicePtr(*dst), bit_pattern,
+        num_elements);
+  }
+
   return UnsupportedStateError(state_);
 }
 
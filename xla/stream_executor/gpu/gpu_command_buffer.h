@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef XLA_STREAM_EXECUTOR_GPU_GPU_COMMAND_BUFFER_H_
 #define XLA_STREAM_EXECUTOR_GPU_GPU_COMMAND_BUFFER_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 #include <vector>
@@ -52,6 +53,10 @@ class GpuCommandBuffer : public internal::CommandBufferInterface {
                                    const DeviceMemoryBase& src,
                                    uint64_t size) override;
 
+  tsl::Status Memset(DeviceMemoryBase* dst,
+                     CommandBuffer::BitPattern bit_pattern,
+                     size_t num_elements) override;
+
   tsl::Status Finalize() override;
   tsl::Status Update() override;
 
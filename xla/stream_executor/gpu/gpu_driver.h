@@ -21,6 +21,7 @@ limitations under the License.
 #include <stddef.h>
 
 #include <cstdint>
+#include <variant>
 
 #include "xla/stream_executor/device_options.h"
 #include "xla/stream_executor/gpu/gpu_types.h"
@@ -451,6 +452,27 @@ class GpuDriver {
                                            GpuDevicePtr gpu_dst,
                                            GpuDevicePtr gpu_src, uint64_t size);
 
+  // Sets the parameters for a memcpy node in the given graph exec.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g26186d58858ab32ccc7425b53786cce5
+  static tsl::Status GraphExecMemcpyD2DNodeSetParams(
+      GpuContext* context, GpuGraphExecHandle exec, GpuGraphNodeHandle node,
+      GpuDevicePtr gpu_dst, GpuDevicePtr gpu_src, uint64_t size);
+
+  // Creates a memset node and adds it to a graph.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g89dc8fc3743392777c0daa2c4aca40d3
+  static tsl::Status GraphAddMemsetNode(
+      GpuContext* context, GpuGraphNodeHandle* node, GpuGraphHandle graph,
+      absl::Span<GpuGraphNodeHandle> deps, GpuDevicePtr dst,
+      std::variant<uint8_t, uint16_t, uint32_t> bit_pattern,
+      uint64_t num_elements);
+
+  // Sets the parameters for a memset node in the given graph exec.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g5df5be09a0b7b3513e740ebbbcd59739
+  static tsl::Status GraphExecMemsetNodeSetParams(
+      GpuContext* context, GpuGraphExecHandle exec, GpuGraphNodeHandle node,
+      GpuDevicePtr dst, std::variant<uint8_t, uint16_t, uint32_t> bit_pattern,
+      uint64_t num_elements);
+
   // Creates a child graph node and adds it to a graph.
   // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1gde52afbcf91a8c79d4d7efbe0e3b6844
   static tsl::Status GraphAddChildNode(GpuGraphNodeHandle* node,
@@ -458,6 +480,13 @@ class GpuDriver {
                                        absl::Span<GpuGraphNodeHandle> deps,
                                        GpuGraphHandle child);
 
+  // Sets the parameters for a child graph node in the given graph exec. Graph
+  // topology of the `child` must match the one used to create the node.
+  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g8f2d9893f6b899f992db1a2942ec03ff
+  static tsl::Status GraphExecChildNodeSetParams(GpuGraphExecHandle exec,
+                                                 GpuGraphNodeHandle node,
+                                                 GpuGraphHandle child);
+
   // Loads ptx_contents with the CUDA driver's PTX JIT and stores the resulting
   // handle in "module". Any error logs that are produced are logged internally.
   // (supported on CUDA only)
@@ -252,35 +252,64 @@ static tsl::Status ReinitializeRedzone(Stream* stream, DeviceMemoryBase redzone,
   return ::tsl::OkStatus();
 }
 
-// Check redzones around the user allocation.
-//
-// Precondition: the memory pointed out by out_param is zeroed.
-static tsl::StatusOr<RedzoneCheckStatus> CheckRedzonesForBuffer(
-    Stream* stream, DeviceMemoryBase memory,
-    const DeviceMemory<uint64_t>& out_param,
-    const ComparisonKernelT& comparison_kernel, int64_t user_allocation_size,
-    uint64_t redzone_size, uint8_t redzone_pattern) {
-  StreamExecutor* executor = stream->parent();
+namespace {
+// The parts of an allocation made by RedzoneAllocator::AllocateBytes.
+struct RedzonedBuffer {
+  DeviceMemory<uint8_t> lhs_redzone;
+  DeviceMemory<uint8_t> user_allocation;
+  // Includes the slop needed to align the redzone.
+  DeviceMemory<uint8_t> rhs_redzone;
+};
+}  // namespace
+
+static RedzonedBuffer SplitRedzonedBuffer(StreamExecutor* executor,
+                                          DeviceMemoryBase memory,
+                                          int64_t user_allocation_size,
+                                          uint64_t redzone_size) {
   int64_t rhs_slop =
       RoundUpToNearest<int64_t>(user_allocation_size, kRhsRedzoneAlign) -
       user_allocation_size;
   CHECK_EQ(memory.size(), user_allocation_size + rhs_slop + 2 * redzone_size);
 
   DeviceMemory<uint8_t> buffer_uint8(memory);
-  DeviceMemory<uint8_t> lhs_redzone =
+  return RedzonedBuffer{
       executor->GetSubBuffer(&buffer_uint8, 0,
-                             /*element_count=*/redzone_size);
-  DeviceMemory<uint8_t> user_allocation =
+                             /*element_count=*/redzone_size),
       executor->GetSubBuffer(&buffer_uint8, redzone_size,
-                             /*element_count=*/user_allocation_size);
-  DeviceMemory<uint8_t> rhs_redzone =
+                             /*element_count=*/user_allocation_size),
       executor->GetSubBuffer(&buffer_uint8, redzone_size + user_allocation_size,
-                             /*element_count=*/redzone_size + rhs_slop);
+                             /*element_count=*/redzone_size + rhs_slop)};
+}
+
+// Enqueues the checkers for both redzones around the user allocation, which
+// increment out_param on mismatch.
+static tsl::Status RunRedzoneCheckers(
+    Stream* stream, const RedzonedBuffer& buffer, uint8_t redzone_pattern,
+    const DeviceMemory<uint64_t>& out_param,
+    const ComparisonKernelT& comparison_kernel) {
+  TF_RETURN_IF_ERROR(RunRedzoneChecker(stream, buffer.lhs_redzone,
+                                       redzone_pattern, out_param,
+                                       comparison_kernel));
+  return RunRedzoneChecker(stream, buffer.rhs_redzone, redzone_pattern,
+                           out_param, comparison_kernel);
+}
 
-  TF_RETURN_IF_ERROR(RunRedzoneChecker(stream, lhs_redzone, redzone_pattern,
-                                       out_param, comparison_kernel));
-  TF_RETURN_IF_ERROR(RunRedzoneChecker(stream, rhs_redzone, redzone_pattern,
-                                       out_param, comparison_kernel));
+// Check redzones around the user allocation.
+//
+// Precondition: the memory pointed out by out_param is zeroed.
+static tsl::StatusOr<RedzoneCheckStatus> CheckRedzonesForBuffer(
+    Stream* stream, DeviceMemoryBase memory,
+    const DeviceMemory<uint64_t>& out_param,
+    const ComparisonKernelT& comparison_kernel, int64_t user_allocation_size,
+    uint64_t redzone_size, uint8_t redzone_pattern) {
+  RedzonedBuffer buffer = SplitRedzonedBuffer(
+      stream->parent(), memory, user_allocation_size, redzone_size);
+  const DeviceMemory<uint8_t>& lhs_redzone = buffer.lhs_redzone;
+  const DeviceMemory<uint8_t>& user_allocation = buffer.user_allocation;
+  const DeviceMemory<uint8_t>& rhs_redzone = buffer.rhs_redzone;
+
+  TF_RETURN_IF_ERROR(RunRedzoneCheckers(stream, buffer, redzone_pattern,
+                                        out_param, comparison_kernel));
   int64_t result;
   CHECK_EQ(out_param.size(), sizeof(result));
   stream->ThenMemcpy(&result, out_param, sizeof(result));
@@ -344,6 +373,25 @@ tsl::StatusOr<RedzoneCheckStatus> RedzoneAllocator::CheckRedzones() const {
           "redzone_checker", redzone_checker_ptx, compiled_ptx)));
 #endif  // GOOGLE_CUDA
 
+  // Check all buffers with a single host synchronization. Redzone failures
+  // are rare, so only when one is detected are the buffers checked one by one
+  // to find the failing redzone.
+  for (const auto& buf_and_size : allocated_buffers_) {
+    TF_RETURN_IF_ERROR(RunRedzoneCheckers(
+        stream_,
+        SplitRedzonedBuffer(executor, *buf_and_size.first, buf_and_size.second,
+                            redzone_size_),
+        redzone_pattern_, out_param.cref(), *loaded_kernel));
+  }
+  uint64_t num_mismatches;
+  stream_->ThenMemcpy(&num_mismatches, out_param.cref(),
+                      sizeof(num_mismatches));
+  TF_RETURN_IF_ERROR(stream_->BlockHostUntilDone());
+  if (num_mismatches == 0) {
+    return RedzoneCheckStatus::OK();
+  }
+
+  stream_->ThenMemZero(out_param.ptr(), sizeof(uint64_t));
   for (const auto& buf_and_size : allocated_buffers_) {
     TF_ASSIGN_OR_RETURN(
         RedzoneCheckStatus redzone_status,
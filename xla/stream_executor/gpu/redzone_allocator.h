@@ -91,6 +91,9 @@ class RedzoneAllocator : public ScratchAllocator {
   // Reinitializes redzones to the expected value, so that the same buffer
   // can be reused for multiple checks.
   //
+  // The redzones of all buffers are checked on the device with a single host
+  // synchronization, unless a mismatch is found.
+  //
   // Returns:
   //
   //  - RedzoneCheckStatus::OK() if everything went well.
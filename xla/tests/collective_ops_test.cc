@@ -766,6 +766,45 @@ XLA_TEST_F(CollectiveOpsTest, CollectivePermute_Rotate) {
                                      results[3]));
 }
 
+XLA_TEST_F(CollectiveOpsTest,
+           DISABLED_ON_CPU(CollectivePermute_CopyEngines)) {
+  const char* const kModuleStr = R"(
+  HloModule test
+  ENTRY test_computation {
+    replica = u32[] replica-id()
+    ten = u32[] constant(10)
+    sum = u32[] add(replica, ten)
+    p = u32[2] broadcast(sum), dimensions={}
+    permute = u32[2] collective-permute(p), source_target_pairs={{0,1}, {1,2}, {2,3}}
+    ROOT copy = u32[2] copy(permute)
+  }
+  )";
+  const int64_t kNumReplicas = 4;
+  SKIP_TEST_IF_NUM_DEVICES_LESS_THAN(kNumReplicas)
+
+  HloModuleConfig config =
+      GetModuleConfigForTest(/*replica_count=*/kNumReplicas);
+  DebugOptions debug_options = GetDebugOptionsForTest();
+  debug_options.set_xla_gpu_enable_copy_engine_collective_permute(true);
+  config.set_debug_options(debug_options);
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kModuleStr, config));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::vector<Literal> results,
+                          ExecuteReplicated(std::move(module), {}, kNumReplicas,
+                                            /*use_threads=*/true));
+  ASSERT_EQ(results.size(), kNumReplicas);
+  // Nothing writes to replica 0, so it is memzero'ed.
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<uint32_t>({0, 0}),
+                                     results[0]));
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<uint32_t>({10, 10}),
+                                     results[1]));
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<uint32_t>({11, 11}),
+                                     results[2]));
+  EXPECT_TRUE(LiteralTestUtil::Equal(LiteralUtil::CreateR1<uint32_t>({12, 12}),
+                                     results[3]));
+}
+
 XLA_TEST_F(CollectiveOpsTest, DISABLED_ON_CPU(AsyncCollectivePermute)) {
   const absl::string_view kModuleStr = R"(
       HloModule test
@@ -1625,6 +1664,47 @@ XLA_TEST_F(CollectiveOpsTest, AllReduceBFloat16Min) {
   }
 }
 
+XLA_TEST_F(CollectiveOpsTest, AllReduceMaxNegativeFloatLargeBuffer) {
+  // Large enough to be split into several slices and blocks per participant.
+  const char* const kModuleStr = R"(
+  HloModule test
+
+  max {
+    a = f32[] parameter(0)
+    b = f32[] parameter(1)
+    ROOT max.2 = f32[] maximum(a, b)
+  }
+
+  ENTRY test_computation {
+    id32 = u32[] replica-id()
+    id = f32[] convert(id32)
+    id2 = f32[10007] broadcast(id), dimensions={}
+    iota = f32[10007] iota(), iota_dimension=0
+    sum = f32[10007] add(iota, id2)
+    neg = f32[10007] negate(sum)
+    ROOT cp = f32[10007] all-reduce(neg), replica_groups={}, to_apply=max
+  }
+  )";
+  const int64_t kNumReplicas = 2;
+  HloModuleConfig config =
+      GetModuleConfigForTest(/*replica_count=*/kNumReplicas);
+  TF_ASSERT_OK_AND_ASSIGN(auto module,
+                          ParseAndReturnVerifiedModule(kModuleStr, config));
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<Literal> results,
+      ExecuteReplicated(std::move(module), {}, kNumReplicas,
+                        /*use_threads=*/true, /*run_hlo_passes=*/true));
+  ASSERT_EQ(results.size(), kNumReplicas);
+  std::vector<float> expected(10007);
+  for (int i = 0; i < expected.size(); ++i) {
+    expected[i] = -static_cast<float>(i);
+  }
+  for (const Literal& result : results) {
+    LiteralTestUtil::ExpectR1Equal<float>(expected, result);
+  }
+}
+
 XLA_TEST_F(CollectiveOpsTest, DISABLED_ON_CPU(AllGather_8BitFloat)) {
   const char* const kModuleStr = R"(
   HloModule test
@@ -1821,6 +1821,23 @@ ENTRY main {
   EXPECT_TRUE(RunAndCompare(hlo_string, ErrorSpec{4e-3, 4e-3}));
 }
 
+XLA_TEST_F(DotOperationTextTest, CpuTiledSmallGemmWithResidues) {
+  // Small enough for the tiled LLVM IR GEMM on CPU, with residues along all
+  // three dimensions and enough columns for the LHS panels to be packed.
+  absl::string_view hlo_string =
+      R"(
+HloModule CpuTiledSmallGemmWithResidues
+
+ENTRY main {
+  lhs = f32[31,61] parameter(0)
+  rhs = f32[61,77] parameter(1)
+  ROOT dot = f32[31,77] dot(lhs, rhs), lhs_contracting_dims={1}, rhs_contracting_dims={0}
+}
+)";
+
+  EXPECT_TRUE(RunAndCompare(hlo_string, ErrorSpec{4e-3, 4e-3}));
+}
+
 XLA_TEST_F(DotOperationTextTest, S32IotaDot) {
   absl::string_view hlo_string =
       R"(
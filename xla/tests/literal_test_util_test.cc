@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "absl/strings/str_join.h"
 #include "xla/literal.h"
+#include "xla/literal_comparison.h"
 #include "xla/test_helpers.h"
 #include "tsl/platform/env.h"
 #include "tsl/platform/logging.h"
@@ -184,6 +185,40 @@ TEST(LiteralTestUtilTest, NearComparatorR1) {
   EXPECT_TRUE(LiteralTestUtil::Near(a, b, ErrorSpec{0.0001}));
 }
 
+TEST(LiteralTestUtilTest, NearComparatorLargeR1) {
+  // Large enough to be compared in parallel blocks.
+  std::vector<float> values(3 << 20, 1.0f);
+  auto a = LiteralUtil::CreateR1<float>(values);
+  values[12345] = 2.0f;
+  values[(2 << 20) + 17] = 3.0f;
+  auto b = LiteralUtil::CreateR1<float>(values);
+  EXPECT_TRUE(LiteralTestUtil::Near(a, a, ErrorSpec{0.0001}));
+
+  Status status =
+      literal_comparison::Near(a, b, ErrorSpec{0.0001},
+                               /*detailed_message=*/false, nullptr);
+  ASSERT_FALSE(status.ok());
+  EXPECT_THAT(status.message(), ::testing::HasSubstr("Mismatch count 2 "));
+  EXPECT_THAT(status.message(), ::testing::HasSubstr("{2097169}"));
+  EXPECT_THAT(status.message(), ::testing::HasSubstr("{12345}"));
+}
+
+TEST(LiteralTestUtilTest, NearComparatorStopsAfterMaxMismatches) {
+  std::vector<float> values(3 << 20, 1.0f);
+  auto a = LiteralUtil::CreateR1<float>(values);
+  for (int i = 0; i < values.size(); i += 2) {
+    values[i] = 2.0f;
+  }
+  auto b = LiteralUtil::CreateR1<float>(values);
+  ErrorSpec error(0.0001);
+  error.max_mismatches = 10;
+
+  Status status = literal_comparison::Near(a, b, error,
+                                           /*detailed_message=*/false, nullptr);
+  ASSERT_FALSE(status.ok());
+  EXPECT_THAT(status.message(), ::testing::HasSubstr("Comparison stopped"));
+}
+
 TEST(LiteralTestUtilTest, NearComparatorR1Complex64) {
   auto a = LiteralUtil::CreateR1<complex64>({{0.0, 1.0},
                                              {0.1, 1.1},
@@ -0,0 +1,107 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+
+#include <utility>
+
+#include "xla/literal.h"
+#include "xla/shape_util.h"
+#include "xla/test.h"
+#include "xla/test_helpers.h"
+#include "xla/tests/hlo_test_base.h"
+#include "xla/tests/test_macros.h"
+#include "tsl/platform/cpu_info.h"
+
+namespace xla {
+namespace cpu {
+
+class ConvolutionTest : public HloTestBase {
+ protected:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = HloTestBase::GetDebugOptionsForTest();
+    debug_options.set_xla_cpu_enable_onednn_rewriter(true);
+    return debug_options;
+  }
+};
+
+TEST_F(ConvolutionTest, Simple2DTestF32) {
+  const char* convolution_module_str = R"(
+  HloModule convolution.test.f32
+
+  ENTRY convolution.test.f32 {
+    arg.0 = f32[1,22,22,8] parameter(0)
+    arg.1 = f32[3,3,8,16] parameter(1)
+    ROOT convolution.0 = f32[1,11,11,16] convolution(arg.0, arg.1), window={size=3x3 stride=2x2 pad=1_1x1_1}, dim_labels=b01f_01io->b01f
+  })";
+
+  EXPECT_TRUE(RunAndCompare(convolution_module_str, ErrorSpec{1e-4, 1e-4}));
+}
+
+TEST_F(ConvolutionTest, Dilated2DTestF32NCHW) {
+  const char* convolution_module_str = R"(
+  HloModule convolution.test.nchw
+
+  ENTRY convolution.test.nchw {
+    arg.0 = f32[2,4,16,16] parameter(0)
+    arg.1 = f32[8,4,3,3] parameter(1)
+    ROOT convolution.0 = f32[2,8,12,12] convolution(arg.0, arg.1), window={size=3x3 rhs_dilate=2x2}, dim_labels=bf01_oi01->bf01
+  })";
+
+  EXPECT_TRUE(RunAndCompare(convolution_module_str, ErrorSpec{1e-4, 1e-4}));
+}
+
+TEST_F(ConvolutionTest, BiasAndReluTestF32) {
+  const char* convolution_module_str = R"(
+  HloModule convolution.test.bias.relu
+
+  ENTRY convolution.test.bias.relu {
+    arg.0 = f32[1,16,16,8] parameter(0)
+    arg.1 = f32[3,3,8,16] parameter(1)
+    arg.2 = f32[16] parameter(2)
+    convolution.0 = f32[1,16,16,16] convolution(arg.0, arg.1), window={size=3x3 pad=1_1x1_1}, dim_labels=b01f_01io->b01f
+    broadcast.0 = f32[1,16,16,16] broadcast(arg.2), dimensions={3}
+    add.0 = f32[1,16,16,16] add(convolution.0, broadcast.0)
+    constant.0 = f32[] constant(0)
+    broadcast.1 = f32[1,16,16,16] broadcast(constant.0), dimensions={}
+    ROOT maximum.0 = f32[1,16,16,16] maximum(add.0, broadcast.1)
+  })";
+
+  EXPECT_TRUE(RunAndCompare(convolution_module_str, ErrorSpec{1e-4, 1e-4}));
+}
+
+TEST_F(ConvolutionTest, Simple2DTestBF16) {
+  using tsl::port::TestCPUFeature;
+  if (!TestCPUFeature(tsl::port::CPUFeature::AVX512_BF16) &&
+      !TestCPUFeature(tsl::port::CPUFeature::AMX_BF16)) {
+    GTEST_SKIP() << "CPU does not support BF16.";
+  }
+
+  const char* convolution_module_str = R"(
+  HloModule convolution.test.bf16
+
+  ENTRY convolution.test.bf16 {
+    arg.0 = bf16[1,22,22,8] parameter(0)
+    arg.1 = bf16[3,3,8,16] parameter(1)
+    ROOT convolution.0 = bf16[1,11,11,16] convolution(arg.0, arg.1), window={size=3x3 stride=2x2 pad=1_1x1_1}, dim_labels=b01f_01io->b01f
+  })";
+
+  EXPECT_TRUE(RunAndCompare(convolution_module_str, ErrorSpec{1e-2, 1e-2}));
+}
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
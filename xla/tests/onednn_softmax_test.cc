@@ -0,0 +1,75 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#if defined(INTEL_MKL) && defined(ENABLE_ONEDNN_V3)
+
+#include <utility>
+
+#include "xla/literal.h"
+#include "xla/shape_util.h"
+#include "xla/test.h"
+#include "xla/test_helpers.h"
+#include "xla/tests/hlo_test_base.h"
+#include "xla/tests/test_macros.h"
+#include "tsl/platform/cpu_info.h"
+
+namespace xla {
+namespace cpu {
+
+class SoftmaxTest : public HloTestBase {
+ protected:
+  DebugOptions GetDebugOptionsForTest() override {
+    DebugOptions debug_options = HloTestBase::GetDebugOptionsForTest();
+    debug_options.set_xla_cpu_enable_onednn_rewriter(true);
+    return debug_options;
+  }
+};
+
+TEST_F(SoftmaxTest, SoftmaxTestF32) {
+  const char* softmax_module_str = R"(
+  HloModule softmax.test.f32
+
+  max_computation {
+    p.0 = f32[] parameter(0)
+    p.1 = f32[] parameter(1)
+    ROOT maximum.0 = f32[] maximum(p.0, p.1)
+  }
+
+  add_computation {
+    p.0 = f32[] parameter(0)
+    p.1 = f32[] parameter(1)
+    ROOT add.0 = f32[] add(p.0, p.1)
+  }
+
+  ENTRY softmax.test.f32 {
+    arg.0 = f32[16,128,1024] parameter(0)
+    constant.0 = f32[] constant(-inf)
+    reduce.0 = f32[16,128] reduce(arg.0, constant.0), dimensions={2}, to_apply=max_computation
+    broadcast.0 = f32[16,128,1024] broadcast(reduce.0), dimensions={0,1}
+    subtract.0 = f32[16,128,1024] subtract(arg.0, broadcast.0)
+    exponential.0 = f32[16,128,1024] exponential(subtract.0)
+    constant.1 = f32[] constant(0)
+    reduce.1 = f32[16,128] reduce(exponential.0, constant.1), dimensions={2}, to_apply=add_computation
+    broadcast.1 = f32[16,128,1024] broadcast(reduce.1), dimensions={0,1}
+    ROOT divide.0 = f32[16,128,1024] divide(exponential.0, broadcast.1)
+  })";
+
+  EXPECT_TRUE(RunAndCompare(softmax_module_str, ErrorSpec{1e-4, 1e-4}));
+}
+
+}  // namespace cpu
+}  // namespace xla
+
+#endif  // INTEL_MKL && ENABLE_ONEDNN_V3
@@ -928,6 +928,48 @@ ENTRY main {
   RunTest(hlo_text, &operand, &scatter_indices, &updates);
 }
 
+XLA_TEST_F(ScatterTest, SortedIndicesWithRepeatedRows) {
+  const std::string hlo_text = R"(
+HloModule SortedIndicesWithRepeatedRows
+
+add_s32 (lhs: s32[], rhs: s32[]) -> s32[] {
+  lhs = s32[] parameter(0)
+  rhs = s32[] parameter(1)
+  ROOT add = s32[] add(s32[] lhs, s32[] rhs)
+}
+
+ENTRY main {
+  operand = s32[16,8] parameter(0)
+  indices = s32[200] parameter(1)
+  updates = s32[200,8] parameter(2)
+  ROOT scatter = s32[16,8] scatter(operand, indices, updates),
+      to_apply=add_s32,
+      update_window_dims={1},
+      inserted_window_dims={0},
+      scatter_dims_to_operand_dims={0},
+      index_vector_dim=1,
+      indices_are_sorted=true
+}
+)";
+  Literal operand(ShapeUtil::MakeShape(S32, {16, 8}));
+  Literal scatter_indices(ShapeUtil::MakeShape(S32, {200}));
+  Literal updates(ShapeUtil::MakeShape(S32, {200, 8}));
+  for (int i = 0; i < 16; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      operand.Set({i, j}, i * j);
+    }
+  }
+  // Runs of equal indices cross the boundaries between the updates combined by
+  // one GPU thread, and the last runs are out of bounds.
+  for (int i = 0; i < 200; ++i) {
+    scatter_indices.Set({i}, i / 11);
+    for (int j = 0; j < 8; ++j) {
+      updates.Set({i, j}, i + j);
+    }
+  }
+  RunTest(hlo_text, &operand, &scatter_indices, &updates);
+}
+
 // Test min/max/add scatters with edge-case values.
 class ScatterEdgeCaseTestP
     : public ScatterTest,
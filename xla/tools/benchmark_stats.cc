@@ -0,0 +1,164 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tools/benchmark_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "xla/tools/run_hlo_module.pb.h"
+#include "tsl/platform/protobuf.h"
+
+namespace xla {
+namespace {
+
+// Returns the continued fraction of the regularized incomplete beta function
+// I_x(a, b), evaluated with the modified Lentz method.
+double IncompleteBetaContinuedFraction(double a, double b, double x) {
+  constexpr int kMaxIterations = 300;
+  constexpr double kEpsilon = 1e-14;
+  constexpr double kTiny = 1e-300;
+  double c = 1.0;
+  double d = 1.0 - (a + b) * x / (a + 1.0);
+  if (std::abs(d) < kTiny) d = kTiny;
+  d = 1.0 / d;
+  double result = d;
+  for (int m = 1; m <= kMaxIterations; ++m) {
+    // Even step.
+    double numerator = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+    d = 1.0 + numerator * d;
+    if (std::abs(d) < kTiny) d = kTiny;
+    c = 1.0 + numerator / c;
+    if (std::abs(c) < kTiny) c = kTiny;
+    d = 1.0 / d;
+    result *= d * c;
+    // Odd step.
+    numerator = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+    d = 1.0 + numerator * d;
+    if (std::abs(d) < kTiny) d = kTiny;
+    c = 1.0 + numerator / c;
+    if (std::abs(c) < kTiny) c = kTiny;
+    d = 1.0 / d;
+    const double delta = d * c;
+    result *= delta;
+    if (std::abs(delta - 1.0) < kEpsilon) break;
+  }
+  return result;
+}
+
+// Returns the regularized incomplete beta function I_x(a, b).
+double RegularizedIncompleteBeta(double a, double b, double x) {
+  if (x <= 0.0) return 0.0;
+  if (x >= 1.0) return 1.0;
+  const double log_front = std::lgamma(a + b) - std::lgamma(a) -
+                           std::lgamma(b) + a * std::log(x) +
+                           b * std::log1p(-x);
+  // The continued fraction converges quickly for x < (a + 1) / (a + b + 2);
+  // use the symmetry I_x(a, b) = 1 - I_{1-x}(b, a) otherwise.
+  if (x < (a + 1.0) / (a + b + 2.0)) {
+    return std::exp(log_front) * IncompleteBetaContinuedFraction(a, b, x) / a;
+  }
+  return 1.0 - std::exp(log_front) *
+                   IncompleteBetaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+void MeanAndVariance(absl::Span<const double> values, double* mean,
+                     double* variance) {
+  *mean = 0.0;
+  for (double value : values) *mean += value;
+  *mean /= values.size();
+  *variance = 0.0;
+  for (double value : values) {
+    *variance += (value - *mean) * (value - *mean);
+  }
+  *variance = values.size() > 1 ? *variance / (values.size() - 1) : 0.0;
+}
+
+}  // namespace
+
+RunHloModuleTimingSummary SummarizeTimings(absl::Span<const double> times) {
+  RunHloModuleTimingSummary summary;
+  if (times.empty()) return summary;
+  std::vector<double> sorted(times.begin(), times.end());
+  std::sort(sorted.begin(), sorted.end());
+  auto percentile = [&](double p) {
+    int64_t rank = static_cast<int64_t>(std::ceil(p * sorted.size()));
+    return sorted[std::clamp<int64_t>(rank - 1, 0, sorted.size() - 1)];
+  };
+  double mean, variance;
+  MeanAndVariance(times, &mean, &variance);
+  summary.set_mean(mean);
+  summary.set_stddev(std::sqrt(variance));
+  summary.set_min(sorted.front());
+  summary.set_p50(percentile(0.5));
+  summary.set_p90(percentile(0.9));
+  summary.set_p99(percentile(0.99));
+  return summary;
+}
+
+double WelchTTestPValue(absl::Span<const double> a,
+                        absl::Span<const double> b) {
+  if (a.size() < 2 || b.size() < 2) return 1.0;
+  double mean_a, variance_a, mean_b, variance_b;
+  MeanAndVariance(a, &mean_a, &variance_a);
+  MeanAndVariance(b, &mean_b, &variance_b);
+  const double se_a = variance_a / a.size();
+  const double se_b = variance_b / b.size();
+  if (se_a + se_b == 0.0) return mean_a == mean_b ? 1.0 : 0.0;
+  const double t = (mean_a - mean_b) / std::sqrt(se_a + se_b);
+  // Welch-Satterthwaite approximation of the degrees of freedom.
+  const double df =
+      (se_a + se_b) * (se_a + se_b) /
+      (se_a * se_a / (a.size() - 1) + se_b * se_b / (b.size() - 1));
+  return RegularizedIncompleteBeta(df / 2.0, 0.5, df / (df + t * t));
+}
+
+std::string CompareBenchmarks(const RunHloModuleBenchmark& baseline,
+                              const RunHloModuleBenchmark& test,
+                              double significance_level) {
+  std::string out = absl::StrFormat(
+      "Comparison of %s (%d iterations) against baseline %s (%d "
+      "iterations):\n",
+      test.runner(), test.compute_times_size(), baseline.runner(),
+      baseline.compute_times_size());
+  auto compare = [&](absl::string_view name,
+                     const tsl::protobuf::RepeatedField<double>& a,
+                     const tsl::protobuf::RepeatedField<double>& b) {
+    const double p50_a = SummarizeTimings(a).p50();
+    const double p50_b = SummarizeTimings(b).p50();
+    const double change =
+        p50_a == 0.0 ? 0.0 : 100.0 * (p50_b - p50_a) / p50_a;
+    const double p_value = WelchTTestPValue(a, b);
+    absl::StrAppendFormat(
+        &out, "  %-20s p50 %.6gs -> %.6gs (%+.2f%%), p-value %.3g%s\n", name,
+        p50_a, p50_b, change, p_value,
+        p_value < significance_level ? " (significant)" : "");
+  };
+  compare("transfer to device:", baseline.transfer_to_device_times(),
+          test.transfer_to_device_times());
+  compare("compute:", baseline.compute_times(), test.compute_times());
+  compare("transfer from device:", baseline.transfer_from_device_times(),
+          test.transfer_from_device_times());
+  return out;
+}
+
+}  // namespace xla
@@ -0,0 +1,44 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TOOLS_BENCHMARK_STATS_H_
+#define XLA_TOOLS_BENCHMARK_STATS_H_
+
+#include <string>
+
+#include "absl/types/span.h"
+#include "xla/tools/run_hlo_module.pb.h"
+
+namespace xla {
+
+// Returns the mean, standard deviation, minimum and nearest-rank percentiles
+// of the given times. Returns an empty summary if there are no times.
+RunHloModuleTimingSummary SummarizeTimings(absl::Span<const double> times);
+
+// Returns the two-sided p-value of Welch's t-test for the hypothesis that the
+// samples `a` and `b` have the same mean. Returns 1 if either sample has fewer
+// than two values.
+double WelchTTestPValue(absl::Span<const double> a, absl::Span<const double> b);
+
+// Returns a human-readable comparison of the median times of two benchmarks of
+// the same module, e.g. with different flags. A change is reported as
+// significant if its p-value is below `significance_level`.
+std::string CompareBenchmarks(const RunHloModuleBenchmark& baseline,
+                              const RunHloModuleBenchmark& test,
+                              double significance_level = 0.05);
+
+}  // namespace xla
+
+#endif  // XLA_TOOLS_BENCHMARK_STATS_H_
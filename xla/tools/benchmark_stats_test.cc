@@ -0,0 +1,85 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tools/benchmark_stats.h"
+
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "xla/tools/run_hlo_module.pb.h"
+
+namespace xla {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+TEST(BenchmarkStatsTest, SummarizeTimings) {
+  std::vector<double> times;
+  for (int i = 100; i >= 1; --i) {
+    times.push_back(i);
+  }
+  RunHloModuleTimingSummary summary = SummarizeTimings(times);
+  EXPECT_DOUBLE_EQ(summary.mean(), 50.5);
+  EXPECT_DOUBLE_EQ(summary.min(), 1);
+  EXPECT_DOUBLE_EQ(summary.p50(), 50);
+  EXPECT_DOUBLE_EQ(summary.p90(), 90);
+  EXPECT_DOUBLE_EQ(summary.p99(), 99);
+  EXPECT_NEAR(summary.stddev(), 29.011, 1e-3);
+
+  EXPECT_DOUBLE_EQ(SummarizeTimings({}).p50(), 0);
+  EXPECT_DOUBLE_EQ(SummarizeTimings({3}).p99(), 3);
+}
+
+TEST(BenchmarkStatsTest, WelchTTestPValue) {
+  // Reference values computed by numerically integrating the density of the
+  // t-distribution.
+  EXPECT_NEAR(WelchTTestPValue({1, 2, 3, 4, 5}, {2, 4, 6, 8, 10.5}), 0.111054,
+              1e-6);
+  EXPECT_NEAR(WelchTTestPValue({10.1, 10.2, 9.9, 10.0, 10.05, 9.95},
+                               {10.3, 10.4, 10.2, 10.35, 10.25, 10.5}),
+              0.000712093, 1e-9);
+  EXPECT_DOUBLE_EQ(WelchTTestPValue({1, 2, 3}, {1, 2, 3}), 1);
+  EXPECT_DOUBLE_EQ(WelchTTestPValue({1}, {2, 3}), 1);
+  EXPECT_DOUBLE_EQ(WelchTTestPValue({1, 1}, {2, 2}), 0);
+}
+
+TEST(BenchmarkStatsTest, CompareBenchmarks) {
+  RunHloModuleBenchmark baseline;
+  baseline.set_runner("CPU");
+  RunHloModuleBenchmark test = baseline;
+  for (double time : {10.1, 10.2, 9.9, 10.0, 10.05, 9.95}) {
+    baseline.add_compute_times(time);
+    baseline.add_transfer_to_device_times(1);
+    baseline.add_transfer_from_device_times(1);
+  }
+  for (double time : {10.3, 10.4, 10.2, 10.35, 10.25, 10.5}) {
+    test.add_compute_times(time);
+    test.add_transfer_to_device_times(1);
+    test.add_transfer_from_device_times(1);
+  }
+  std::string comparison = CompareBenchmarks(baseline, test);
+  EXPECT_THAT(comparison, HasSubstr("compute:"));
+  EXPECT_THAT(comparison,
+              HasSubstr("(+3.00%), p-value 0.000712 (significant)"));
+  EXPECT_THAT(comparison, HasSubstr("(+0.00%), p-value 1\n"));
+
+  EXPECT_THAT(CompareBenchmarks(baseline, baseline),
+              Not(HasSubstr("significant")));
+}
+
+}  // namespace
+}  // namespace xla
@@ -0,0 +1,321 @@
+/* Copyright 2023 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// A tool for measuring the compile time of HLO passes. See kUsage for details.
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "xla/debug_options_flags.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/service/algebraic_simplifier.h"
+#include "xla/service/buffer_assignment.h"
+#include "xla/service/compilation_stats.h"
+#include "xla/service/copy_insertion.h"
+#include "xla/service/hlo_cse.h"
+#include "xla/service/hlo_dce.h"
+#include "xla/service/hlo_ordering.h"
+#include "xla/service/hlo_pass_pipeline.h"
+#include "xla/service/layout_assignment.h"
+#include "xla/service/tuple_simplifier.h"
+#include "xla/shape_util.h"
+#include "xla/status.h"
+#include "xla/tools/hlo_module_loader.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/init_main.h"
+#include "tsl/platform/logging.h"
+#include "tsl/util/command_line_flags.h"
+
+namespace xla {
+namespace {
+
+const char* const kUsage = R"(
+This tool runs HLO passes on a corpus of HLO modules, e.g. dumped with
+--xla_dump_to, and reports the wall time and the peak memory of each pass. It
+is meant to catch compile-time regressions and passes that scale superlinearly
+with the size of the module.
+
+The passes run in the order given by --passes in one HloPassPipeline per
+module, followed by buffer assignment. Each module is loaded again for every
+repetition, and the fastest repetition of each pass is reported. Peak memory is
+the growth of the resident set size of the process during the pass, and is
+only available on Linux.
+
+Usage:
+
+  bazel run compile_benchmarks -- \
+    --passes=algsimp,cse,layout-assignment --repetitions=3 \
+    path/to/module1.hlo path/to/module2.pb
+)";
+
+using PassFactory = std::function<void(HloModule*, HloPassPipeline*)>;
+
+// Returns the passes that can be benchmarked, by name.
+const std::map<std::string, PassFactory>& PassFactories() {
+  static const auto* factories = new std::map<std::string, PassFactory>{
+      {"algsimp",
+       [](HloModule*, HloPassPipeline* pipeline) {
+         pipeline->AddPass<AlgebraicSimplifier>(AlgebraicSimplifierOptions());
+       }},
+      {"cse",
+       [](HloModule*, HloPassPipeline* pipeline) {
+         pipeline->AddPass<HloCSE>(/*is_layout_sensitive=*/false);
+       }},
+      {"dce",
+       [](HloModule*, HloPassPipeline* pipeline) {
+         pipeline->AddPass<HloDCE>();
+       }},
+      {"tuple-simplifier",
+       [](HloModule*, HloPassPipeline* pipeline) {
+         pipeline->AddPass<TupleSimplifier>();
+       }},
+      {"layout-assignment",
+       [](HloModule* module, HloPassPipeline* pipeline) {
+         pipeline->AddPass<LayoutAssignment>(
+             module->mutable_entry_computation_layout());
+       }},
+      {"copy-insertion",
+       [](HloModule*, HloPassPipeline* pipeline) {
+         pipeline->AddPass<CopyInsertion>();
+       }},
+  };
+  return *factories;
+}
+
+// Returns the value in bytes of the given field of /proc/self/status, e.g.
+// VmRSS, or -1 if it is not available.
+int64_t ReadProcStatusBytes(absl::string_view field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    absl::string_view value = line;
+    if (!absl::ConsumePrefix(&value, field) ||
+        !absl::ConsumePrefix(&value, ":")) {
+      continue;
+    }
+    int64_t kilobytes;
+    if (absl::ConsumeSuffix(&value, "kB") &&
+        absl::SimpleAtoi(absl::StripAsciiWhitespace(value), &kilobytes)) {
+      return kilobytes * 1024;
+    }
+    return -1;
+  }
+  return -1;
+}
+
+// Resets the peak resident set size (VmHWM) of the process to its current
+// resident set size.
+void ResetPeakResidentSetSize() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+}
+
+// The fastest run of a pass on a module, and its peak memory.
+struct PassResult {
+  std::string name;
+  double duration_ms = 0;
+  int64_t peak_memory_bytes = -1;
+};
+
+// Records the duration and the peak memory of each pass run by an
+// HloPassPipeline.
+class PassProfiler : public CompilationStats {
+ public:
+  void StartPass(absl::string_view pass_name) override {
+    ResetPeakResidentSetSize();
+    start_rss_bytes_ = ReadProcStatusBytes("VmRSS");
+    start_micros_ = tsl::Env::Default()->NowMicros();
+  }
+
+  void EndPass(absl::string_view pass_name) override {
+    const uint64_t end_micros = tsl::Env::Default()->NowMicros();
+    const int64_t peak_rss_bytes = ReadProcStatusBytes("VmHWM");
+    PassResult result;
+    result.name = std::string(pass_name);
+    result.duration_ms = (end_micros - start_micros_) / 1000.0;
+    if (peak_rss_bytes >= 0 && start_rss_bytes_ >= 0) {
+      result.peak_memory_bytes =
+          std::max<int64_t>(peak_rss_bytes - start_rss_bytes_, 0);
+    }
+    results_.push_back(std::move(result));
+  }
+
+  void CompilationReport() override {}
+
+  int GetPassesSize() override { return results_.size(); }
+
+  void RecordPassError(absl::string_view pass_name,
+                       absl::string_view err) override {
+    LOG(ERROR) << "Pass " << pass_name << " failed: " << err;
+  }
+
+  std::vector<PassResult>& results() { return results_; }
+
+ private:
+  std::vector<PassResult> results_;
+  int64_t start_rss_bytes_ = -1;
+  uint64_t start_micros_ = 0;
+};
+
+// Loads the module in `path` and runs `passes` and buffer assignment on it,
+// returning the result of each pass in order.
+StatusOr<std::vector<PassResult>> ProfileModule(
+    const std::string& path, const std::string& format,
+    const std::vector<std::string>& passes, bool run_buffer_assignment) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
+                      LoadModuleFromFile(path, {}, format));
+  PassProfiler profiler;
+  HloPassPipeline pipeline("compile-benchmarks", &profiler);
+  for (const std::string& pass : passes) {
+    PassFactories().at(pass)(module.get(), &pipeline);
+  }
+  TF_RETURN_IF_ERROR(pipeline.Run(module.get()).status());
+
+  if (run_buffer_assignment) {
+    constexpr absl::string_view kBufferAssignment = "buffer-assignment";
+    profiler.StartPass(kBufferAssignment);
+    TF_RETURN_IF_ERROR(
+        BufferAssigner::Run(
+            module.get(), std::make_unique<DependencyHloOrdering>(module.get()),
+            [](const BufferValue& buffer) {
+              return ShapeUtil::ByteSizeOf(buffer.shape(), sizeof(void*));
+            },
+            [](LogicalBuffer::Color) { return 1; },
+            /*allocate_buffers_for_constants=*/true)
+            .status());
+    profiler.EndPass(kBufferAssignment);
+  }
+  return std::move(profiler.results());
+}
+
+// Prints the results of the fastest repetition of each pass on each module,
+// and the total time and the maximum peak memory of each pass over all
+// modules.
+void PrintReport(
+    const std::vector<std::pair<std::string, std::vector<PassResult>>>&
+        module_results) {
+  auto format_bytes = [](int64_t bytes) {
+    return bytes < 0 ? std::string("n/a")
+                     : absl::StrFormat("%.1fMiB", bytes / 1048576.0);
+  };
+  std::vector<std::string> pass_order;
+  absl::flat_hash_map<std::string, PassResult> totals;
+  std::cout << "Module, pass, time (ms), peak memory\n";
+  for (const auto& [path, results] : module_results) {
+    for (const PassResult& result : results) {
+      std::cout << absl::StrFormat("%s, %s, %.3f, %s\n", path, result.name,
+                                   result.duration_ms,
+                                   format_bytes(result.peak_memory_bytes));
+      auto [it, inserted] = totals.try_emplace(result.name);
+      if (inserted) {
+        it->second.name = result.name;
+        pass_order.push_back(result.name);
+      }
+      it->second.duration_ms += result.duration_ms;
+      it->second.peak_memory_bytes =
+          std::max(it->second.peak_memory_bytes, result.peak_memory_bytes);
+    }
+  }
+  std::cout << "\nPass, total time (ms), max peak memory\n";
+  for (const std::string& name : pass_order) {
+    const PassResult& total = totals.at(name);
+    std::cout << absl::StrFormat("%s, %.3f, %s\n", name, total.duration_ms,
+                                 format_bytes(total.peak_memory_bytes));
+  }
+}
+
+}  // namespace
+}  // namespace xla
+
+int main(int argc, char** argv) {
+  std::string passes_flag =
+      "algsimp,cse,dce,tuple-simplifier,layout-assignment,copy-insertion";
+  std::string format;
+  int repetitions = 1;
+  bool run_buffer_assignment = true;
+  std::vector<tsl::Flag> flag_list = {
+      tsl::Flag("passes", &passes_flag,
+                absl::StrCat("Comma-separated passes to run, in order. Valid "
+                             "passes: ",
+                             absl::StrJoin(xla::PassFactories(), ",",
+                                           [](std::string* out,
+                                              const auto& entry) {
+                                             out->append(entry.first);
+                                           }))),
+      tsl::Flag("format", &format,
+                "The format of the input files: hlo|pb|pbtxt. By default, "
+                "guessed from the file extensions."),
+      tsl::Flag("repetitions", &repetitions,
+                "The number of times each module is compiled."),
+      tsl::Flag("buffer_assignment", &run_buffer_assignment,
+                "Whether to run buffer assignment after the passes."),
+  };
+  xla::AppendDebugOptionsFlags(&flag_list);
+  const std::string kUsageString =
+      absl::StrCat(xla::kUsage, "\n\n", tsl::Flags::Usage(argv[0], flag_list));
+  bool parse_ok = tsl::Flags::Parse(&argc, argv, flag_list);
+  tsl::port::InitMain(kUsageString.c_str(), &argc, &argv);
+  if (!parse_ok || argc < 2) {
+    LOG(QFATAL) << kUsageString;
+  }
+
+  std::vector<std::string> passes =
+      absl::StrSplit(passes_flag, ',', absl::SkipEmpty());
+  for (const std::string& pass : passes) {
+    QCHECK(xla::PassFactories().contains(pass)) << "Unknown pass: " << pass;
+  }
+  QCHECK_GT(repetitions, 0);
+
+  std::vector<std::pair<std::string, std::vector<xla::PassResult>>>
+      module_results;
+  for (int i = 1; i < argc; ++i) {
+    std::vector<xla::PassResult> fastest;
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+      std::vector<xla::PassResult> results =
+          xla::ProfileModule(argv[i], format, passes, run_buffer_assignment)
+              .value();
+      if (fastest.empty()) {
+        fastest = std::move(results);
+        continue;
+      }
+      for (int j = 0; j < results.size(); ++j) {
+        if (results[j].duration_ms < fastest[j].duration_ms) {
+          fastest[j] = std::move(results[j]);
+        }
+      }
+    }
+    module_results.emplace_back(argv[i], std::move(fastest));
+  }
+  xla::PrintReport(module_results);
+  return 0;
+}
@@ -17,19 +17,33 @@ limitations under the License.
 
 #include "xla/tools/hlo_module_loader.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 #include "xla/debug_options_flags.h"
+#include "xla/hlo/ir/hlo_casting_utils.h"
 #include "xla/hlo/ir/hlo_computation.h"
 #include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_instructions.h"
+#include "xla/literal.h"
+#include "xla/service/hlo_constant_section.h"
 #include "xla/service/hlo_parser.h"
+#include "tsl/lib/io/random_inputstream.h"
+#include "tsl/lib/io/zlib_compression_options.h"
+#include "tsl/lib/io/zlib_inputstream.h"
 #include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/file_system.h"
 #include "tsl/platform/logging.h"
 #include "tsl/platform/path.h"
 #include "tsl/platform/protobuf.h"
@@ -45,6 +59,157 @@ Status OverrideConfig(const hlo_module_loader_details::Config& ovr_config,
   return OkStatus();
 }
 
+// Constant literals of at least this many serialized bytes are converted
+// before the rest of the module is built.
+constexpr size_t kMinDetachedLiteralBytes = 1 << 20;
+
+// Maps (computation name, instruction name) to the literal of a constant.
+using DetachedLiterals =
+    absl::flat_hash_map<std::pair<std::string, std::string>, Literal>;
+
+// Converts the large constant literals of `proto` and clears them from the
+// proto one at a time, so that the data of each constant is held once instead
+// of twice while the module is built.
+StatusOr<DetachedLiterals> DetachLargeLiterals(HloModuleProto* proto) {
+  DetachedLiterals literals;
+  for (HloComputationProto& computation : *proto->mutable_computations()) {
+    for (HloInstructionProto& instruction :
+         *computation.mutable_instructions()) {
+      if (instruction.opcode() != "constant" || !instruction.has_literal() ||
+          instruction.literal().ByteSizeLong() < kMinDetachedLiteralBytes) {
+        continue;
+      }
+      TF_ASSIGN_OR_RETURN(Literal literal,
+                          Literal::CreateFromProto(instruction.literal()));
+      instruction.clear_literal();
+      literals.emplace(std::make_pair(computation.name(), instruction.name()),
+                       std::move(literal));
+    }
+  }
+  return literals;
+}
+
+// Attaches the literals returned by DetachLargeLiterals to the constants of
+// the module built from the proto.
+Status AttachLiterals(DetachedLiterals literals, HloModule* module) {
+  for (HloComputation* computation : module->computations()) {
+    for (HloInstruction* instruction : computation->instructions()) {
+      if (instruction->opcode() != HloOpcode::kConstant) continue;
+      auto it = literals.find(
+          std::make_pair(computation->name(), instruction->name()));
+      if (it == literals.end()) continue;
+      Cast<HloConstantInstruction>(instruction)
+          ->SetLiteral(std::move(it->second));
+      literals.erase(it);
+    }
+  }
+  TF_RET_CHECK(literals.empty())
+      << literals.size() << " detached literals have no matching constant";
+  return OkStatus();
+}
+
+// Converts the data of the constants in the constant section `section` into
+// literals, using the shapes of the matching constants of `proto`.
+StatusOr<DetachedLiterals> ReadConstantSection(const HloModuleProto& proto,
+                                               absl::string_view section) {
+  TF_ASSIGN_OR_RETURN(auto data, ParseHloConstantSection(section));
+  DetachedLiterals literals;
+  for (const HloComputationProto& computation : proto.computations()) {
+    for (const HloInstructionProto& instruction : computation.instructions()) {
+      auto it = data.find(instruction.id());
+      if (it == data.end()) continue;
+      TF_RET_CHECK(instruction.opcode() == "constant" &&
+                   !instruction.has_literal())
+          << instruction.name() << " has data in the constant section";
+      Literal literal(Shape(instruction.shape()));
+      TF_RET_CHECK(literal.size_bytes() == it->second.size())
+          << "Constant section holds " << it->second.size() << " bytes for "
+          << instruction.name() << ", expected " << literal.size_bytes();
+      std::memcpy(literal.untyped_data(), it->second.data(),
+                  it->second.size());
+      literals.emplace(std::make_pair(computation.name(), instruction.name()),
+                       std::move(literal));
+      data.erase(it);
+    }
+  }
+  TF_RET_CHECK(data.empty())
+      << data.size() << " constants of the section are not in the module";
+  return literals;
+}
+
+// Parses `data` as a binary HloSnapshot, HloProto or HloModuleProto.
+Status ParseBinaryHloSnapshot(const void* data, size_t size,
+                              HloSnapshot* proto) {
+  if (size > std::numeric_limits<int>::max()) {
+    return InvalidArgument(
+        "HLO protobuf binary of %d bytes exceeds the protobuf size limit",
+        size);
+  }
+  if (!proto->ParseFromArray(data, size) &&
+      !proto->mutable_hlo()->ParseFromArray(data, size) &&
+      !proto->mutable_hlo()->mutable_hlo_module()->ParseFromArray(data,
+                                                                  size)) {
+    return InvalidArgument("Failed to parse input as HLO protobuf binary");
+  }
+  return OkStatus();
+}
+
+// Builds the module held by `proto`. The proto's large constants are moved
+// into the module, so it must not be used afterwards. `external_literals` are
+// the literals of the constants whose data is not in the proto.
+StatusOr<std::unique_ptr<HloModule>> CreateModuleFromSnapshot(
+    HloSnapshot* proto, const DebugOptions& debug_options,
+    const hlo_module_loader_details::Config& ovr_config,
+    const std::function<void(HloModuleConfig*)>& config_modifier_hook,
+    DetachedLiterals external_literals = {}) {
+  HloModuleProto* module_proto = proto->mutable_hlo()->mutable_hlo_module();
+  TF_ASSIGN_OR_RETURN(
+      HloModuleConfig config,
+      HloModule::CreateModuleConfigFromProto(*module_proto, debug_options));
+  TF_RETURN_IF_ERROR(OverrideConfig(ovr_config, &config));
+  if (config_modifier_hook) {
+    config_modifier_hook(&config);
+  }
+  TF_ASSIGN_OR_RETURN(DetachedLiterals literals,
+                      DetachLargeLiterals(module_proto));
+  for (auto& [key, literal] : external_literals) {
+    literals.emplace(key, std::move(literal));
+  }
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<HloModule> module,
+                      HloModule::CreateFromProto(*module_proto, config));
+  TF_RETURN_IF_ERROR(AttachLiterals(std::move(literals), module.get()));
+  return std::move(module);
+}
+
+// Returns whether `path` is a gzip file, as written by dumps compressed with
+// --xla_dump_compress_protos or --xla_dump_compress_text, and strips the .gz
+// extension from `*path` if so.
+bool StripGzipExtension(std::string* path) {
+  if (tsl::io::Extension(*path) != "gz") return false;
+  path->resize(path->size() - 3);
+  return true;
+}
+
+// Reads the gzip file at `path` into `*data`. The file can hold several
+// members, which are decompressed one after the other.
+Status ReadGzipFileToString(const std::string& path, std::string* data) {
+  std::unique_ptr<tsl::RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(tsl::Env::Default()->NewRandomAccessFile(path, &file));
+  tsl::io::RandomAccessInputStream input_stream(file.get());
+  auto options = tsl::io::ZlibCompressionOptions::GZIP();
+  tsl::io::ZlibInputStream gz_stream(&input_stream, options.input_buffer_size,
+                                     options.output_buffer_size, options);
+  constexpr int64_t kChunkSize = 16 << 20;
+  data->clear();
+  tsl::tstring chunk;
+  while (true) {
+    Status status = gz_stream.ReadNBytes(kChunkSize, &chunk);
+    data->append(chunk.data(), chunk.size());
+    if (tsl::errors::IsOutOfRange(status)) return OkStatus();
+    TF_RETURN_IF_ERROR(status);
+  }
+}
+
 }  // namespace
 
 std::string StripLogHeaders(const std::string& hlo_string) {
@@ -85,11 +250,8 @@ StatusOr<std::unique_ptr<HloModule>> LoadModuleFromData(
   } else {
     HloSnapshot proto;
     if (format == "pb") {
-      if (!proto.ParseFromString(data) &&
-          !proto.mutable_hlo()->ParseFromString(data) &&
-          !proto.mutable_hlo()->mutable_hlo_module()->ParseFromString(data)) {
-        return InvalidArgument("Failed to parse input as HLO protobuf binary");
-      }
+      TF_RETURN_IF_ERROR(
+          ParseBinaryHloSnapshot(data.data(), data.size(), &proto));
       if (buffer_assignment_proto != nullptr) {
         if (proto.hlo().has_buffer_assignment()) {
           *buffer_assignment_proto = proto.hlo().buffer_assignment();
@@ -112,15 +274,10 @@ StatusOr<std::unique_ptr<HloModule>> LoadModuleFromData(
           "or pbtxt",
           format);
     }
-    TF_ASSIGN_OR_RETURN(HloModuleConfig config,
-                        HloModule::CreateModuleConfigFromProto(
-                            proto.hlo().hlo_module(), debug_options));
-    TF_RETURN_IF_ERROR(OverrideConfig(ovr_config, &config));
-    if (config_modifier_hook) {
-      config_modifier_hook(&config);
-    }
-    TF_ASSIGN_OR_RETURN(
-        module, HloModule::CreateFromProto(proto.hlo().hlo_module(), config));
+    TF_ASSIGN_OR_RETURN(module,
+                        CreateModuleFromSnapshot(&proto, debug_options,
+                                                 ovr_config,
+                                                 config_modifier_hook));
   }
   return std::move(module);
 }
@@ -131,10 +288,62 @@ StatusOr<std::unique_ptr<HloModule>> LoadModuleFromFile(
     const std::function<void(HloModuleConfig*)>& config_modifier_hook,
     BufferAssignmentProto* buffer_assignment_proto) {
   std::string data;
+  std::string uncompressed_path = path;
+  const bool compressed = StripGzipExtension(&uncompressed_path);
   if (format.empty()) {
-    format = std::string(tsl::io::Extension(path));
+    format = std::string(tsl::io::Extension(uncompressed_path));
+  }
+  if (compressed) {
+    TF_RETURN_IF_ERROR(ReadGzipFileToString(path, &data));
+  }
+  if (format == "pb") {
+    std::unique_ptr<tsl::ReadOnlyMemoryRegion> region;
+    HloSnapshot proto;
+    if (compressed) {
+      TF_RETURN_IF_ERROR(
+          ParseBinaryHloSnapshot(data.data(), data.size(), &proto));
+      std::string().swap(data);
+    } else {
+      // Parse straight from a read-only mapping of the file instead of
+      // reading it into a string first, so the serialized module never
+      // occupies heap memory.
+      TF_RETURN_IF_ERROR(
+          tsl::Env::Default()->NewReadOnlyMemoryRegionFromFile(path, &region));
+      TF_RETURN_IF_ERROR(
+          ParseBinaryHloSnapshot(region->data(), region->length(), &proto));
+      region.reset();
+    }
+    if (buffer_assignment_proto != nullptr) {
+      if (!proto.hlo().has_buffer_assignment()) {
+        return InvalidArgument(
+            "Expected buffer assignment in HLO protobuf binary.");
+      }
+      *buffer_assignment_proto = proto.hlo().buffer_assignment();
+    }
+    // Modules dumped with --xla_dump_hlo_constants_separately keep the data
+    // of their large constants in a section next to the proto.
+    DetachedLiterals external_literals;
+    const std::string constants_path =
+        absl::StrCat(uncompressed_path, ".constants");
+    if (tsl::Env::Default()->FileExists(constants_path).ok()) {
+      TF_RETURN_IF_ERROR(tsl::Env::Default()->NewReadOnlyMemoryRegionFromFile(
+          constants_path, &region));
+      TF_ASSIGN_OR_RETURN(
+          external_literals,
+          ReadConstantSection(
+              proto.hlo().hlo_module(),
+              absl::string_view(static_cast<const char*>(region->data()),
+                                region->length())));
+      region.reset();
+    }
+    return CreateModuleFromSnapshot(&proto, GetDebugOptionsFromFlags(),
+                                    ovr_config, config_modifier_hook,
+                                    std::move(external_literals));
+  }
+  if (!compressed) {
+    TF_RETURN_IF_ERROR(
+        tsl::ReadFileToString(tsl::Env::Default(), path, &data));
   }
-  TF_RETURN_IF_ERROR(tsl::ReadFileToString(tsl::Env::Default(), path, &data));
   return LoadModuleFromData(data, format, ovr_config, config_modifier_hook,
                             buffer_assignment_proto);
 }
@@ -174,10 +383,17 @@ StatusOr<std::unique_ptr<RunHloModuleIterationLiterals>> LoadInputFromData(
 StatusOr<std::unique_ptr<RunHloModuleIterationLiterals>> LoadInputFromFile(
     const std::string& path, std::string format) {
   std::string data;
+  std::string uncompressed_path = path;
+  const bool compressed = StripGzipExtension(&uncompressed_path);
   if (format.empty()) {
-    format = std::string(tsl::io::Extension(path));
+    format = std::string(tsl::io::Extension(uncompressed_path));
+  }
+  if (compressed) {
+    TF_RETURN_IF_ERROR(ReadGzipFileToString(path, &data));
+  } else {
+    TF_RETURN_IF_ERROR(
+        tsl::ReadFileToString(tsl::Env::Default(), path, &data));
   }
-  TF_RETURN_IF_ERROR(tsl::ReadFileToString(tsl::Env::Default(), path, &data));
   return LoadInputFromData(data, format);
 }
 
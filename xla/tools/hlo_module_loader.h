@@ -69,6 +69,8 @@ StatusOr<std::unique_ptr<HloModule>> LoadModuleFromData(
 // 2) A hlo text dump, the string should be in HloModule::ToString() format
 //    (with a .hlo or .txt extension). A text file can also contain log headers,
 //    which will be stripped.
+// Files with an additional .gz extension (e.g. .hlo.pb.gz or .txt.gz, as
+// written by compressed dumps) are decompressed first.
 // If the format is specified (not empty), it overrides the one guessed from the
 // file extension. The ovr_config data can be used to override certain fields of
 // the HloModuleConfig.
@@ -95,6 +97,7 @@ StatusOr<std::unique_ptr<RunHloModuleIterationLiterals>> LoadInputFromData(
 // The file must be one of the following:
 // 1) A binary proto (with .pb extension)
 // 2) A text proto (with a .pbtxt extension)
+// Files with an additional .gz extension are decompressed first.
 // If the format is specified (not empty), it overrides the one guessed from the
 // file extension.
 StatusOr<std::unique_ptr<RunHloModuleIterationLiterals>> LoadInputFromFile(
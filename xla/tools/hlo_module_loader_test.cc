@@ -15,10 +15,22 @@ limitations under the License.
 
 #include "xla/tools/hlo_module_loader.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "xla/hlo/ir/hlo_computation.h"
+#include "xla/hlo/ir/hlo_instruction.h"
+#include "xla/hlo/ir/hlo_module.h"
+#include "xla/literal_util.h"
+#include "xla/service/hlo_constant_section.h"
 #include "xla/tests/hlo_test_base.h"
 #include "tsl/lib/core/status_test_util.h"
+#include "tsl/lib/io/zlib_compression_options.h"
+#include "tsl/lib/io/zlib_outputbuffer.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/path.h"
 #include "tsl/platform/test.h"
 
 namespace xla {
@@ -46,5 +58,96 @@ I0521 12:04:45.883483    1509 service.cc:186] }
   EXPECT_NE(FindInstruction(hlo_module.get(), "rooty"), nullptr);
 }
 
+TEST_F(HloModuleLoaderTest, LoadsBinaryProtoWithLargeConstant) {
+  // Large enough for the constant to be converted ahead of the module.
+  std::vector<float> values(1 << 19);
+  for (int i = 0; i < values.size(); ++i) {
+    values[i] = i;
+  }
+  auto module = CreateNewVerifiedModule();
+  HloComputation::Builder builder(TestName());
+  HloInstruction* large = builder.AddInstruction(HloInstruction::CreateConstant(
+      LiteralUtil::CreateR1<float>(values)));
+  HloInstruction* small = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR0<float>(2.0f)));
+  builder.AddInstruction(HloInstruction::CreateTuple({large, small}));
+  module->AddEntryComputation(builder.Build());
+
+  std::string path =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "large_constant.pb");
+  HloProto proto;
+  *proto.mutable_hlo_module() = module->ToProto();
+  TF_ASSERT_OK(tsl::WriteBinaryProto(tsl::Env::Default(), path, proto));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> loaded,
+                          LoadModuleFromFile(path));
+  const HloInstruction* root = loaded->entry_computation()->root_instruction();
+  EXPECT_EQ(root->operand(0)->literal(), LiteralUtil::CreateR1<float>(values));
+  EXPECT_EQ(root->operand(1)->literal(), LiteralUtil::CreateR0<float>(2.0f));
+}
+
+TEST_F(HloModuleLoaderTest, LoadsBinaryProtoWithConstantSection) {
+  std::vector<float> values(1024);
+  for (int i = 0; i < values.size(); ++i) {
+    values[i] = i;
+  }
+  auto module = CreateNewVerifiedModule();
+  HloComputation::Builder builder(TestName());
+  HloInstruction* small = builder.AddInstruction(HloInstruction::CreateConstant(
+      LiteralUtil::CreateR2<float>({{1, 2}, {3, 4}})));
+  HloInstruction* separate = builder.AddInstruction(
+      HloInstruction::CreateConstant(LiteralUtil::CreateR1<float>(values)));
+  builder.AddInstruction(HloInstruction::CreateTuple({small, separate}));
+  module->AddEntryComputation(builder.Build());
+
+  std::string path =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "constant_section.pb");
+  HloProto proto;
+  *proto.mutable_hlo_module() = module->ToProto();
+  TF_ASSERT_OK(WriteHloConstantSection(*module, /*min_bytes=*/1024,
+                                       absl::StrCat(path, ".constants"),
+                                       proto.mutable_hlo_module()));
+  TF_ASSERT_OK(tsl::WriteBinaryProto(tsl::Env::Default(), path, proto));
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> loaded,
+                          LoadModuleFromFile(path));
+  const HloInstruction* root = loaded->entry_computation()->root_instruction();
+  EXPECT_EQ(root->operand(0)->literal(),
+            LiteralUtil::CreateR2<float>({{1, 2}, {3, 4}}));
+  EXPECT_EQ(root->operand(1)->literal(), LiteralUtil::CreateR1<float>(values));
+}
+
+TEST_F(HloModuleLoaderTest, LoadsGzipTextWithSeveralMembers) {
+  const std::string hlo_string = R"(
+HloModule gzip_text
+
+ENTRY entry {
+  p0 = f32[4]{0} parameter(0)
+  ROOT negate = f32[4]{0} negate(p0)
+}
+)";
+  // Compressed dumps are written as one gzip member per block.
+  std::string path =
+      tsl::io::JoinPath(tsl::testing::TmpDir(), "gzip_text.txt.gz");
+  std::unique_ptr<tsl::WritableFile> file;
+  TF_ASSERT_OK(tsl::Env::Default()->NewWritableFile(path, &file));
+  const size_t split = hlo_string.size() / 2;
+  for (absl::string_view block :
+       {absl::string_view(hlo_string).substr(0, split),
+        absl::string_view(hlo_string).substr(split)}) {
+    auto options = tsl::io::ZlibCompressionOptions::GZIP();
+    tsl::io::ZlibOutputBuffer gz_file(file.get(), options.input_buffer_size,
+                                      options.output_buffer_size, options);
+    TF_ASSERT_OK(gz_file.Init());
+    TF_ASSERT_OK(gz_file.Append(block));
+    TF_ASSERT_OK(gz_file.Close());
+  }
+  TF_ASSERT_OK(file->Close());
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> hlo_module,
+                          LoadModuleFromFile(path));
+  EXPECT_NE(FindInstruction(hlo_module.get(), "negate"), nullptr);
+}
+
 }  // namespace
 }  // namespace xla
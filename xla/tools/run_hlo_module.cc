@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/tools/run_hlo_module.h"
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -31,13 +32,17 @@ limitations under the License.
 #include "xla/service/hlo.pb.h"
 #include "xla/service/hlo_verifier.h"
 #include "xla/tests/test_utils.h"
+#include "xla/tools/benchmark_stats.h"
 #include "xla/tools/hlo_control_flow_flattening.h"
 #include "xla/tools/hlo_module_loader.h"
 #include "xla/tools/prepare_reference_module.h"
 #include "xla/tools/run_hlo_module.pb.h"
 #include "xla/util.h"
 #include "xla/xla_data.pb.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/errors.h"
 #include "tsl/platform/path.h"
+#include "tsl/platform/protobuf.h"
 #include "tsl/platform/status.h"
 
 namespace xla {
@@ -118,8 +123,117 @@ StatusOr<Literal> ExecuteWithRunner(
 
   return std::move(result_status).value();
 }
+
+// Benchmarks `module` on the test runner, writes the results to
+// options.benchmark_output_file and compares them with
+// options.benchmark_baseline_file, if set.
+Status RunBenchmark(std::unique_ptr<HloModule> module,
+                    absl::Span<const Literal> args,
+                    HloRunnerInterface* runner,
+                    const RunHloModuleOptions& options) {
+  auto* hlo_runner = dynamic_cast<HloRunner*>(runner);
+  if (hlo_runner == nullptr) {
+    return Unimplemented("Benchmarking is not supported with runner %s",
+                         runner->Name());
+  }
+  TF_ASSIGN_OR_RETURN(
+      RunHloModuleBenchmark benchmark,
+      BenchmarkHloModule(std::move(module), args, hlo_runner, options));
+  auto print = [](absl::string_view name,
+                  const RunHloModuleTimingSummary& summary) {
+    std::cerr << absl::StrFormat(
+        "  %-22s mean %.6gs, stddev %.3gs, min %.6gs, p50 %.6gs, p90 %.6gs, "
+        "p99 %.6gs\n",
+        name, summary.mean(), summary.stddev(), summary.min(), summary.p50(),
+        summary.p90(), summary.p99());
+  };
+  std::cerr << "Benchmark of " << options.benchmark_iterations
+            << " iterations with runner " << benchmark.runner() << ":\n";
+  print("transfer to device:", benchmark.transfer_to_device());
+  print("compute:", benchmark.compute());
+  print("transfer from device:", benchmark.transfer_from_device());
+
+  tsl::Env* env = tsl::Env::Default();
+  if (!options.benchmark_output_file.empty()) {
+    std::string json;
+    tsl::protobuf::util::JsonPrintOptions print_options;
+    print_options.add_whitespace = true;
+    auto status = tsl::protobuf::util::MessageToJsonString(benchmark, &json,
+                                                           print_options);
+    if (!status.ok()) {
+      return InternalError("Failed to serialize benchmark results: %s",
+                           std::string(status.message()));
+    }
+    TF_RETURN_IF_ERROR(
+        tsl::WriteStringToFile(env, options.benchmark_output_file, json));
+    std::cerr << "Wrote benchmark results to " << options.benchmark_output_file
+              << "\n";
+  }
+  if (!options.benchmark_baseline_file.empty()) {
+    std::string json;
+    TF_RETURN_IF_ERROR(
+        tsl::ReadFileToString(env, options.benchmark_baseline_file, &json));
+    RunHloModuleBenchmark baseline;
+    auto status = tsl::protobuf::util::JsonStringToMessage(json, &baseline);
+    if (!status.ok()) {
+      return InvalidArgument("Failed to parse benchmark results in %s: %s",
+                             options.benchmark_baseline_file,
+                             std::string(status.message()));
+    }
+    std::cerr << CompareBenchmarks(baseline, benchmark);
+  }
+  return OkStatus();
+}
 }  // namespace
 
+StatusOr<RunHloModuleBenchmark> BenchmarkHloModule(
+    std::unique_ptr<HloModule> module, absl::Span<const Literal> args,
+    HloRunner* runner, const RunHloModuleOptions& options) {
+  TF_RET_CHECK(options.benchmark_iterations > 0);
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<Executable> executable,
+                      runner->CreateExecutable(std::move(module),
+                                               options.run_test_hlo_passes));
+  RunHloModuleBenchmark benchmark;
+  benchmark.set_runner(runner->Name());
+  benchmark.set_warmup_iterations(options.benchmark_warmup_iterations);
+
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+  };
+  const int num_runs =
+      options.benchmark_warmup_iterations + options.benchmark_iterations;
+  for (int i = 0; i < num_runs; ++i) {
+    const auto start = Clock::now();
+    TF_ASSIGN_OR_RETURN(std::vector<ScopedShapedBuffer> arguments,
+                        runner->TransferLiteralsToDevice(args));
+    const auto transferred = Clock::now();
+    ExecutionProfile profile;
+    TF_ASSIGN_OR_RETURN(
+        ExecutionOutput output,
+        runner->ExecuteWithDeviceBuffers(executable.get(), arguments,
+                                         &profile));
+    const auto executed = Clock::now();
+    TF_RETURN_IF_ERROR(
+        runner->TransferLiteralFromDevice(output.Result()).status());
+    const auto end = Clock::now();
+    if (i < options.benchmark_warmup_iterations) continue;
+
+    benchmark.add_transfer_to_device_times(seconds(transferred - start));
+    // Prefer the execution time measured by the device, if any.
+    benchmark.add_compute_times(profile.compute_time_ns() > 0
+                                    ? profile.compute_time_ns() / 1e9
+                                    : seconds(executed - transferred));
+    benchmark.add_transfer_from_device_times(seconds(end - executed));
+  }
+  *benchmark.mutable_transfer_to_device() =
+      SummarizeTimings(benchmark.transfer_to_device_times());
+  *benchmark.mutable_compute() = SummarizeTimings(benchmark.compute_times());
+  *benchmark.mutable_transfer_from_device() =
+      SummarizeTimings(benchmark.transfer_from_device_times());
+  return benchmark;
+}
+
 Status RunAndCompare(
     std::unique_ptr<HloModule> test_module,
     const BufferAssignmentProto* buffer_assignment_proto,
@@ -194,6 +308,11 @@ Status RunAndCompare(
                                reference_module_modifier_hook));
   }
 
+  if (options.benchmark_iterations > 0) {
+    TF_RETURN_IF_ERROR(
+        RunBenchmark(test_module->Clone(), args, test_runner, options));
+  }
+
   TF_ASSIGN_OR_RETURN(
       auto test_result,
       ExecuteWithRunner(std::move(test_module), buffer_assignment_proto, args,
@@ -21,8 +21,11 @@ limitations under the License.
 #include <random>
 #include <string>
 
+#include "absl/types/span.h"
 #include "xla/hlo/ir/hlo_module.h"
+#include "xla/literal.h"
 #include "xla/service/hlo_runner.h"
+#include "xla/statusor.h"
 #include "xla/tools/run_hlo_module.pb.h"
 #include "tsl/platform/status.h"
 
@@ -55,8 +58,28 @@ struct RunHloModuleOptions {
   std::string input_literals_file;
   bool random_init_input_literals{true};
   bool force_fake_data{false};
+  // If positive, the module is also compiled once and executed
+  // benchmark_warmup_iterations + benchmark_iterations times on the test
+  // platform, and the timings of the last benchmark_iterations runs are
+  // reported.
+  int benchmark_iterations{0};
+  int benchmark_warmup_iterations{1};
+  // If not empty, the benchmark results are written to this file as JSON.
+  std::string benchmark_output_file;
+  // If not empty, the benchmark results are compared against the benchmark
+  // results in this JSON file, e.g. written by a run with other flags.
+  std::string benchmark_baseline_file;
 };
 
+// Compiles `module` once with `runner` and executes it
+// options.benchmark_warmup_iterations + options.benchmark_iterations times,
+// timing the transfer of `args` to the device, the execution and the transfer
+// of the result from the device of each of the last
+// options.benchmark_iterations runs.
+StatusOr<RunHloModuleBenchmark> BenchmarkHloModule(
+    std::unique_ptr<HloModule> module, absl::Span<const Literal> args,
+    HloRunner* runner, const RunHloModuleOptions& options);
+
 // Runs test_module on the platform with the name
 // 'test_platform_name', and if 'reference_platform_name' is non-empty, it also
 // runs it on the platform with the name 'reference_platform_name' and compares
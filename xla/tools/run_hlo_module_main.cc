@@ -130,6 +130,21 @@ int main(int argc, char** argv) {
       tsl::Flag("different_random_seeds", &different_random_seeds,
                 "Whether each iteration should use a different random seed for "
                 "the HloModuleConfig."),
+      tsl::Flag("benchmark_iterations", &opts.benchmark_iterations,
+                "If positive, the module is compiled once and run this many "
+                "times on the test platform after the warmup iterations, and "
+                "the p50/p90/p99 of the transfer to device, compute and "
+                "transfer from device times are reported."),
+      tsl::Flag("benchmark_warmup_iterations",
+                &opts.benchmark_warmup_iterations,
+                "The number of untimed runs before the benchmark iterations."),
+      tsl::Flag("benchmark_output_file", &opts.benchmark_output_file,
+                "A file to write the benchmark results to, as JSON."),
+      tsl::Flag("benchmark_baseline_file", &opts.benchmark_baseline_file,
+                "A file with benchmark results written by a previous run, "
+                "e.g. with different flags. The results of this run are "
+                "compared against them, with a Welch's t-test for each "
+                "timing."),
   };
   xla::AppendDebugOptionsFlags(&flag_list);
   // The usage string includes the message at the top of the file, the
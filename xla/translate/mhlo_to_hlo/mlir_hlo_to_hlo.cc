@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -41,10 +42,12 @@ limitations under the License.
 #include "mlir/Dialect/MemRef/IR/MemRef.h"  // from @llvm-project
 #include "mlir/Dialect/Shape/IR/Shape.h"  // from @llvm-project
 #include "mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/IR/AsmState.h"  // from @llvm-project
 #include "mlir/IR/Attributes.h"  // from @llvm-project
 #include "mlir/IR/BuiltinAttributes.h"  // from @llvm-project
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "mlir/IR/BuiltinTypes.h"  // from @llvm-project
+#include "mlir/IR/DialectResourceBlobManager.h"  // from @llvm-project
 #include "mlir/IR/Location.h"  // from @llvm-project
 #include "mlir/IR/MLIRContext.h"  // from @llvm-project
 #include "mlir/IR/Matchers.h"  // from @llvm-project
@@ -155,13 +158,62 @@ bool IsBoundedOrStatic(mlir::Type ty) {
   return true;
 }
 
+// Returns whether the elements of `type` are stored by MLIR in the same format
+// as in XLA literals. Predicates are stored as bits and 4-bit types as bytes
+// in MLIR.
+static bool HasLiteralStorageFormat(xla::PrimitiveType type) {
+  return xla::primitive_util::IsArrayType(type) && type != xla::PRED &&
+         !xla::primitive_util::Is4BitType(type);
+}
+
+// Creates a literal by copying `data`, the row-major elements of `shape`, at
+// once.
+static StatusOr<xla::Literal> CreateLiteralFromRawData(
+    const xla::Shape& shape, llvm::ArrayRef<char> data,
+    const xla::Layout& layout) {
+  xla::Literal literal(xla::ShapeUtil::MakeShapeWithDescendingLayout(
+      shape.element_type(), shape.dimensions()));
+  if (data.size() != literal.size_bytes()) {
+    return tsl::errors::InvalidArgument(
+        "Constant of shape ", xla::ShapeUtil::HumanString(shape), " has ",
+        data.size(), " bytes of data, expected ", literal.size_bytes());
+  }
+  std::memcpy(literal.untyped_data(), data.data(), data.size());
+  if (layout.minor_to_major().empty() ||
+      layout == literal.shape().layout()) {
+    return literal;
+  }
+  return literal.Relayout(layout);
+}
+
 StatusOr<xla::Literal> CreateArrayLiteralFromAttr(mlir::ElementsAttr attr,
                                                   xla::Layout layout) {
+  xla::Shape shape = xla::TypeToShape(attr.getShapedType());
+
+  // Constants stored as resource blobs (e.g. large weights) are not uniqued
+  // in the context, copy them without materializing an attribute.
+  if (auto resource_attr = attr.dyn_cast<mlir::DenseResourceElementsAttr>()) {
+    mlir::AsmResourceBlob* blob = resource_attr.getRawHandle().getBlob();
+    if (blob == nullptr) {
+      return tsl::errors::InvalidArgument(
+          "Dense resource ", resource_attr.getRawHandle().getKey().str(),
+          " has no data");
+    }
+    if (!HasLiteralStorageFormat(shape.element_type())) {
+      return tsl::errors::Unimplemented(
+          "Dense resources of type ",
+          xla::PrimitiveType_Name(shape.element_type()), " are not supported");
+    }
+    return CreateLiteralFromRawData(shape, blob->getData(), layout);
+  }
+
   auto dense_attr = attr.dyn_cast<mlir::DenseElementsAttr>();
   if (!dense_attr)
     return tsl::errors::Unimplemented("Only dense elements attr are supported");
 
-  xla::Shape shape = xla::TypeToShape(dense_attr.getType());
+  if (!dense_attr.isSplat() && HasLiteralStorageFormat(shape.element_type())) {
+    return CreateLiteralFromRawData(shape, dense_attr.getRawData(), layout);
+  }
 
   return xla::primitive_util::PrimitiveTypeSwitch<StatusOr<xla::Literal>>(
       [&](auto primitive_type_constant) -> StatusOr<xla::Literal> {
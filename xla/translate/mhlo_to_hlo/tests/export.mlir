@@ -908,9 +908,12 @@ func.func public @main(%arg0: tensor<16x256xbf16>, %arg1: tensor<i32>, %arg2: te
 // CHECK-DAG:   [[ARG1:%.*]] = s32[] parameter(1)
 // CHECK-DAG:   [[ARG2:%.*]] = s32[16,256] parameter(2)
 // CHECK-DAG:   [[ARG3:%.*]] = bf16[] parameter(3)
-// CHECK-DAG:   [[VAL0:%.*]] = (bf16[16,256], s32[16,256]) sort(bf16[16,256] [[ARG0]], s32[16,256] [[ARG2]])
-// CHECK-DAG:   [[VAL1:%.*]] = s32[16,256] get-tuple-element((bf16[16,256], s32[16,256]) [[VAL0]])
-// CHECK-DAG:   [[VAL2:%.*]] = s32[16,4] slice(s32[16,256] [[VAL1]])
+// CHECK-DAG:   [[RESHAPE0:%.*]] = bf16[16,2,128] reshape
+// CHECK-DAG:   [[RESHAPE1:%.*]] = s32[16,2,128] reshape
+// CHECK-DAG:   [[WINDOWS:%.*]] = (bf16[16,128], s32[16,128]) reduce(bf16[16,2,128] [[RESHAPE0]], s32[16,2,128] [[RESHAPE1]], bf16[] [[ARG3]], s32[] [[ARG1]]), dimensions={1}
+// CHECK-DAG:   [[VAL0:%.*]] = (bf16[16,128], s32[16,128]) sort(
+// CHECK-DAG:   [[VAL1:%.*]] = s32[16,128] get-tuple-element((bf16[16,128], s32[16,128]) [[VAL0]])
+// CHECK-DAG:   [[VAL2:%.*]] = s32[16,4] slice(s32[16,128] [[VAL1]])
 
 // -----
 
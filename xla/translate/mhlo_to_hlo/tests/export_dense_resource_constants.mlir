@@ -0,0 +1,19 @@
+// RUN: xla-translate -mlir-hlo-to-hlo-text %s | FileCheck %s
+
+// CHECK-LABEL: ENTRY
+func.func @main() -> (tensor<2xf32>, tensor<2x2xi16>) {
+  // CHECK: f32[2] constant({1, 2})
+  %0 = mhlo.constant dense_resource<weights> : tensor<2xf32>
+  // CHECK: s16[2,2] constant({ { 1, 2 }, { 3, 4 } })
+  %1 = mhlo.constant dense_resource<table> : tensor<2x2xi16>
+  func.return %0, %1 : tensor<2xf32>, tensor<2x2xi16>
+}
+
+{-#
+  dialect_resources: {
+    builtin: {
+      weights: "0x040000000000803F00000040",
+      table: "0x020000000100020003000400"
+    }
+  }
+#-}
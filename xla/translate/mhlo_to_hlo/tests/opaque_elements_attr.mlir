@@ -1,6 +1,6 @@
 // RUN: not xla-translate -split-input-file -mlir-hlo-to-hlo-text %s 2>&1 | FileCheck %s
 
-// CHECK: Only dense elements attr are supported
+// CHECK: Dense resource __elided__ has no data
 func.func @main() {
   %0 = "mhlo.constant"() {value = dense_resource<__elided__> : tensor<4xf32>} : () -> tensor<4xf32>
   func.return